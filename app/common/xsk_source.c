@@ -0,0 +1,325 @@
+/*
+ * Copyright 2026 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file    xsk_source.c
+ * @brief   Receive the Ethernet frames of a network device with AF_XDP
+ * @author  Didier Barvaux <didier@barvaux.org>
+ */
+
+#include "xsk_source.h"
+
+#include <xdp/xsk.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <assert.h>
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+
+
+/** The number of frames in the UMEM, all of them owned by the fill ring */
+#define XSK_SOURCE_FRAMES_NR  XSK_RING_PROD__DEFAULT_NUM_DESCS
+
+/** The size of one frame in the UMEM */
+#define XSK_SOURCE_FRAME_SIZE  XSK_UMEM__DEFAULT_FRAME_SIZE
+
+
+/** An AF_XDP socket bound to one RX queue of a network device */
+struct xsk_source
+{
+	void *area;                 /**< The memory shared with the kernel */
+	struct xsk_umem *umem;      /**< The UMEM built on the shared memory */
+	struct xsk_ring_prod fill;  /**< The frames given to the kernel */
+	struct xsk_ring_cons comp;  /**< The completion ring, unused for RX */
+	struct xsk_ring_cons rx;    /**< The frames received from the kernel */
+	struct xsk_socket *xsk;     /**< The AF_XDP socket */
+
+	/** The UMEM addresses of the frames of the last burst */
+	uint64_t addrs[XSK_SOURCE_FRAMES_NR];
+	/** The number of frames in the last burst */
+	size_t addrs_nr;
+
+	/** The last error */
+	char errbuf[XSK_SOURCE_ERRBUF_SIZE];
+};
+
+
+static bool xsk_source_fill(struct xsk_source *const source,
+                            const uint64_t addrs[],
+                            const size_t addrs_nr)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
+
+/**
+ * @brief Open an AF_XDP socket on one RX queue of a network device
+ *
+ * The default XDP program of libxdp is attached to the network device if
+ * it has no XDP program yet: the frames of the RX queue are no longer given
+ * to the kernel network stack while the socket is open. The kernel uses
+ * zero-copy mode if the driver of the network device supports it, copy mode
+ * otherwise.
+ *
+ * @param ifname       The name of the network device
+ * @param queue_id     The RX queue of the network device
+ * @param[out] errbuf  The error message in case of failure, at least
+ *                     \ref XSK_SOURCE_ERRBUF_SIZE bytes
+ * @return             The AF_XDP socket in case of success,
+ *                     NULL in case of failure
+ */
+struct xsk_source * xsk_source_open(const char *const ifname,
+                                    const unsigned int queue_id,
+                                    char *const errbuf)
+{
+	const size_t area_len = XSK_SOURCE_FRAMES_NR * XSK_SOURCE_FRAME_SIZE;
+	struct xsk_socket_config config;
+	struct xsk_source *source;
+	size_t i;
+	int ret;
+
+	source = calloc(1, sizeof(struct xsk_source));
+	if(source == NULL)
+	{
+		snprintf(errbuf, XSK_SOURCE_ERRBUF_SIZE, "failed to allocate memory "
+		         "for the AF_XDP socket");
+		goto error;
+	}
+
+	/* the UMEM shall be aligned on a page */
+	ret = posix_memalign(&source->area, getpagesize(), area_len);
+	if(ret != 0)
+	{
+		snprintf(errbuf, XSK_SOURCE_ERRBUF_SIZE, "failed to allocate %zu bytes "
+		         "for the UMEM: %s (%d)", area_len, strerror(ret), ret);
+		goto free_source;
+	}
+
+	ret = xsk_umem__create(&source->umem, source->area, area_len,
+	                       &source->fill, &source->comp, NULL);
+	if(ret != 0)
+	{
+		snprintf(errbuf, XSK_SOURCE_ERRBUF_SIZE, "failed to create the UMEM: "
+		         "%s (%d)", strerror(-ret), -ret);
+		goto free_area;
+	}
+
+	/* receive only, no TX ring */
+	memset(&config, 0, sizeof(struct xsk_socket_config));
+	config.rx_size = XSK_RING_CONS__DEFAULT_NUM_DESCS;
+	config.tx_size = XSK_RING_PROD__DEFAULT_NUM_DESCS;
+	ret = xsk_socket__create(&source->xsk, ifname, queue_id, source->umem,
+	                         &source->rx, NULL, &config);
+	if(ret != 0)
+	{
+		snprintf(errbuf, XSK_SOURCE_ERRBUF_SIZE, "failed to bind an AF_XDP "
+		         "socket to queue %u of '%s': %s (%d)", queue_id, ifname,
+		         strerror(-ret), -ret);
+		goto delete_umem;
+	}
+
+	/* give all the frames to the kernel */
+	for(i = 0; i < XSK_SOURCE_FRAMES_NR; i++)
+	{
+		source->addrs[i] = i * XSK_SOURCE_FRAME_SIZE;
+	}
+	if(!xsk_source_fill(source, source->addrs, XSK_SOURCE_FRAMES_NR))
+	{
+		snprintf(errbuf, XSK_SOURCE_ERRBUF_SIZE, "failed to give the frames "
+		         "of the UMEM to the kernel");
+		goto delete_socket;
+	}
+	source->addrs_nr = 0;
+
+	return source;
+
+delete_socket:
+	xsk_socket__delete(source->xsk);
+delete_umem:
+	xsk_umem__delete(source->umem);
+free_area:
+	free(source->area);
+free_source:
+	free(source);
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Close the AF_XDP socket
+ *
+ * @param source  The AF_XDP socket
+ */
+void xsk_source_close(struct xsk_source *const source)
+{
+	xsk_socket__delete(source->xsk);
+	xsk_umem__delete(source->umem);
+	free(source->area);
+	free(source);
+}
+
+
+/**
+ * @brief Receive one burst of frames
+ *
+ * The frames point into the UMEM: they are valid until the next call to
+ * \ref xsk_source_release, that shall be called before receiving the next
+ * burst.
+ *
+ * @param source       The AF_XDP socket
+ * @param[out] frames  The received Ethernet frames
+ * @param max_nr       The maximum number of frames to receive
+ * @param timeout      The time to wait for frames (in milliseconds)
+ * @return             The number of received frames, 0 if the timeout
+ *                     expired, -1 in case of error
+ *                     (see \ref xsk_source_geterr)
+ */
+int xsk_source_recv(struct xsk_source *const source,
+                    struct rohc_buf frames[],
+                    const size_t max_nr,
+                    const int timeout)
+{
+	struct pollfd pollfd;
+	struct timespec now;
+	struct rohc_ts arrival_time;
+	uint32_t idx;
+	size_t burst_max;
+	size_t frames_nr;
+	size_t i;
+	int ret;
+
+	if(source->addrs_nr > 0)
+	{
+		snprintf(source->errbuf, XSK_SOURCE_ERRBUF_SIZE, "the frames of the "
+		         "previous burst were not released");
+		goto error;
+	}
+
+	burst_max = (max_nr < XSK_SOURCE_FRAMES_NR ? max_nr : XSK_SOURCE_FRAMES_NR);
+	frames_nr = xsk_ring_cons__peek(&source->rx, burst_max, &idx);
+	if(frames_nr == 0)
+	{
+		/* wait for the kernel to fill some frames */
+		pollfd.fd = xsk_socket__fd(source->xsk);
+		pollfd.events = POLLIN;
+		ret = poll(&pollfd, 1, timeout);
+		if(ret < 0 && errno != EINTR)
+		{
+			snprintf(source->errbuf, XSK_SOURCE_ERRBUF_SIZE, "failed to wait "
+			         "for frames: %s (%d)", strerror(errno), errno);
+			goto error;
+		}
+		else if(ret <= 0)
+		{
+			return 0;
+		}
+		frames_nr = xsk_ring_cons__peek(&source->rx, burst_max, &idx);
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	arrival_time.sec = now.tv_sec;
+	arrival_time.nsec = now.tv_nsec;
+
+	/* the frames are given in place, they are released with the burst */
+	for(i = 0; i < frames_nr; i++)
+	{
+		const struct xdp_desc *const desc =
+			xsk_ring_cons__rx_desc(&source->rx, idx + i);
+		const uint64_t addr = xsk_umem__add_offset_to_addr(desc->addr);
+
+		frames[i] = (struct rohc_buf)
+			rohc_buf_init_full(xsk_umem__get_data(source->area, addr), desc->len,
+			                   arrival_time);
+		source->addrs[i] = xsk_umem__extract_addr(desc->addr);
+	}
+	xsk_ring_cons__release(&source->rx, frames_nr);
+	source->addrs_nr = frames_nr;
+
+	return frames_nr;
+
+error:
+	return -1;
+}
+
+
+/**
+ * @brief Give the frames of the last burst back to the kernel
+ *
+ * @param source  The AF_XDP socket
+ */
+void xsk_source_release(struct xsk_source *const source)
+{
+	/* all the frames are owned by the fill ring or by the last burst, so
+	 * there is always room in the fill ring */
+	const bool filled =
+		xsk_source_fill(source, source->addrs, source->addrs_nr);
+	assert(filled);
+	(void) filled;
+	source->addrs_nr = 0;
+}
+
+
+/**
+ * @brief Get the message of the last error
+ *
+ * @param source  The AF_XDP socket
+ * @return        The message of the last error
+ */
+const char * xsk_source_geterr(const struct xsk_source *const source)
+{
+	return source->errbuf;
+}
+
+
+/**
+ * @brief Give some frames of the UMEM to the kernel through the fill ring
+ *
+ * @param source    The AF_XDP socket
+ * @param addrs     The UMEM addresses of the frames
+ * @param addrs_nr  The number of frames
+ * @return          true if the frames were given to the kernel,
+ *                  false if the fill ring has not enough room
+ */
+static bool xsk_source_fill(struct xsk_source *const source,
+                            const uint64_t addrs[],
+                            const size_t addrs_nr)
+{
+	uint32_t idx;
+	size_t i;
+
+	if(addrs_nr == 0)
+	{
+		return true;
+	}
+	if(xsk_ring_prod__reserve(&source->fill, addrs_nr, &idx) != addrs_nr)
+	{
+		return false;
+	}
+	for(i = 0; i < addrs_nr; i++)
+	{
+		*xsk_ring_prod__fill_addr(&source->fill, idx + i) = addrs[i];
+	}
+	xsk_ring_prod__submit(&source->fill, addrs_nr);
+
+	return true;
+}
@@ -0,0 +1,67 @@
+/*
+ * Copyright 2026 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file    xsk_source.h
+ * @brief   Receive the Ethernet frames of a network device with AF_XDP
+ * @author  Didier Barvaux <didier@barvaux.org>
+ *
+ * The frames of one RX queue of a network device are redirected by XDP to
+ * an AF_XDP socket, before the kernel network stack sees them. They are
+ * received in a memory area shared with the kernel (the UMEM) and given to
+ * the tools as network buffers that point into that area, so that they are
+ * (de)compressed without any copy.
+ */
+
+#ifndef ROHC_APP_XSK_SOURCE_H
+#define ROHC_APP_XSK_SOURCE_H
+
+#include <rohc/rohc_buf.h>
+
+#include <stddef.h>
+
+
+/** The size of the buffer for the error messages */
+#define XSK_SOURCE_ERRBUF_SIZE  256U
+
+
+/** An AF_XDP socket bound to one RX queue of a network device */
+struct xsk_source;
+
+
+struct xsk_source * xsk_source_open(const char *const ifname,
+                                    const unsigned int queue_id,
+                                    char *const errbuf)
+	__attribute__((warn_unused_result, nonnull(1, 3)));
+
+void xsk_source_close(struct xsk_source *const source)
+	__attribute__((nonnull(1)));
+
+int xsk_source_recv(struct xsk_source *const source,
+                    struct rohc_buf frames[],
+                    const size_t max_nr,
+                    const int timeout)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
+void xsk_source_release(struct xsk_source *const source)
+	__attribute__((nonnull(1)));
+
+const char * xsk_source_geterr(const struct xsk_source *const source)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+#endif
@@ -40,12 +40,16 @@
 #include <assert.h>
 #include <stdarg.h>
 #include <limits.h>
+#include <math.h>
 
 /* includes for network headers */
 #include <ip.h> /* for IPv4 checksum */
 #include <protocols/ipv4.h>
+#include <protocols/ipv6.h>
 #include <protocols/udp.h>
 #include <protocols/rtp.h>
+#include <protocols/tcp.h>
+#include <protocols/esp.h>
 
 /* include for the PCAP library */
 #if HAVE_PCAP_PCAP_H == 1
@@ -66,16 +70,115 @@ for ./configure ? If yes, check configure output and config.log"
 /** The length (in bytes) of the Ethernet header */
 #define ETHER_HDR_LEN  14
 
+/** The maximum length (in bytes) of one generated packet */
+#define GEN_PACKET_MAX_LEN  256
+
+/** The IP protocol number used by the flows without transport header */
+#define GEN_IPPROTO_NONE  253
+
+
+/** The profiles of the generated flows */
+typedef enum
+{
+	GEN_PROFILE_RTP = 0,  /**< IP/UDP/RTP flows */
+	GEN_PROFILE_UDP = 1,  /**< IP/UDP flows */
+	GEN_PROFILE_TCP = 2,  /**< IP/TCP flows */
+	GEN_PROFILE_ESP = 3,  /**< IP/ESP flows */
+	GEN_PROFILE_IP  = 4,  /**< IP-only flows */
+	GEN_PROFILE_MAX = 5,  /**< The number of profiles */
+} gen_profile_t;
+
+/** The names of the profiles on the command line */
+static const char *const gen_profile_names[GEN_PROFILE_MAX] =
+{
+	[GEN_PROFILE_RTP] = "rtp",
+	[GEN_PROFILE_UDP] = "udp",
+	[GEN_PROFILE_TCP] = "tcp",
+	[GEN_PROFILE_ESP] = "esp",
+	[GEN_PROFILE_IP]  = "ip",
+};
+
+/** The length (in bytes) of the payload of the packets of every profile */
+static const size_t gen_profile_payload_lens[GEN_PROFILE_MAX] =
+{
+	[GEN_PROFILE_RTP] = 20,
+	[GEN_PROFILE_UDP] = 40,
+	[GEN_PROFILE_TCP] = 100,
+	[GEN_PROFILE_ESP] = 60,
+	[GEN_PROFILE_IP]  = 40,
+};
+
+
+/** The parameters of the generated flows */
+struct gen_params
+{
+	/** The number of concurrent flows */
+	size_t flows_nr;
+	/** The relative weight of every profile in the mix of flows */
+	unsigned int profile_weights[GEN_PROFILE_MAX];
+	/** The percentage of IPv6 flows */
+	unsigned int ipv6_percent;
+	/** The exponent of the Zipf popularity of flows, 0 for uniform */
+	double zipf_exponent;
+	/** The number of packets between two flow replacements, 0 for none */
+	unsigned long churn;
+	/** The number of consecutive packets sent on the same flow */
+	unsigned long burst;
+	/** The seed of the pseudo-random generator */
+	uint64_t seed;
+};
+
+
+/** One generated flow */
+struct gen_flow
+{
+	unsigned long id;        /**< The identifier the headers are derived from */
+	gen_profile_t profile;   /**< The profile of the flow */
+	bool is_ipv6;            /**< Whether the flow is IPv6 or IPv4 */
+	unsigned long packets_nr;  /**< The number of packets sent on the flow */
+};
+
 
 /* prototypes of private functions */
 static void usage(void);
+static bool parse_profiles(const char *const list,
+                           unsigned int weights[GEN_PROFILE_MAX])
+	__attribute__((warn_unused_result, nonnull(1, 2)));
 static bool build_stream(const char *const filename,
                          const char *const stream_type,
                          const unsigned long max_packets,
                          const int use_large_cid,
                          const size_t wlsb_width,
-                         const size_t max_contexts)
-	__attribute__((warn_unused_result, nonnull(1, 2)));
+                         const size_t max_contexts,
+                         const struct gen_params *const params)
+	__attribute__((warn_unused_result, nonnull(1, 2, 7)));
+
+static double * gen_popularity_new(const size_t flows_nr,
+                                   const double exponent)
+	__attribute__((warn_unused_result));
+static size_t gen_pick_flow(const double *const popularity,
+                            const size_t flows_nr,
+                            uint64_t *const rand_state)
+	__attribute__((warn_unused_result, nonnull(1, 3)));
+static void gen_flow_init(struct gen_flow *const flow,
+                          const unsigned long id,
+                          const struct gen_params *const params,
+                          uint64_t *const rand_state)
+	__attribute__((nonnull(1, 3, 4)));
+static void gen_build_packet(const struct gen_flow *const flow,
+                             const unsigned long counter,
+                             struct rohc_buf *const packet)
+	__attribute__((nonnull(1, 3)));
+static uint16_t gen_l4_checksum(const uint8_t *const ip,
+                                const bool is_ipv6,
+                                const uint8_t protocol,
+                                const uint8_t *const l4,
+                                const size_t l4_len)
+	__attribute__((warn_unused_result, nonnull(1, 4)));
+static uint64_t gen_rand(uint64_t *const rand_state)
+	__attribute__((warn_unused_result, nonnull(1)));
+static double gen_rand_unit(uint64_t *const rand_state)
+	__attribute__((warn_unused_result, nonnull(1)));
 
 static void print_rohc_traces(void *const priv_ctxt,
                               const rohc_trace_level_t level,
@@ -119,6 +222,15 @@ int main(int argc, char *argv[])
 	char *cid_type = NULL;
 	int max_contexts = ROHC_SMALL_CID_MAX + 1;
 	int wlsb_width = 4;
+	struct gen_params params = {
+		.flows_nr = 1,
+		.profile_weights = { [GEN_PROFILE_RTP] = 1 },
+		.ipv6_percent = 0,
+		.zipf_exponent = 0.0,
+		.churn = 0,
+		.burst = 1,
+		.seed = 1,
+	};
 	int is_failure = 1;
 	int use_large_cid;
 	int args_used;
@@ -172,6 +284,84 @@ int main(int argc, char *argv[])
 			wlsb_width = atoi(argv[1]);
 			args_used++;
 		}
+		else if(!strcmp(*argv, "--flows"))
+		{
+			/* get the number of concurrent flows to generate */
+			const int flows_nr = (argc > 1 ? atoi(argv[1]) : 0);
+			if(flows_nr < 1)
+			{
+				fprintf(stderr, "the number of flows shall be at least 1\n");
+				goto error;
+			}
+			params.flows_nr = flows_nr;
+			args_used++;
+		}
+		else if(!strcmp(*argv, "--profiles"))
+		{
+			/* get the mix of profiles of the flows */
+			if(argc <= 1 || !parse_profiles(argv[1], params.profile_weights))
+			{
+				fprintf(stderr, "invalid list of profiles, expected a comma-"
+				        "separated list of rtp, udp, tcp, esp or ip with optional "
+				        "':WEIGHT' suffixes\n");
+				goto error;
+			}
+			args_used++;
+		}
+		else if(!strcmp(*argv, "--ipv6"))
+		{
+			/* get the percentage of IPv6 flows */
+			const int ipv6_percent = (argc > 1 ? atoi(argv[1]) : -1);
+			if(ipv6_percent < 0 || ipv6_percent > 100)
+			{
+				fprintf(stderr, "the percentage of IPv6 flows shall be between "
+				        "0 and 100\n");
+				goto error;
+			}
+			params.ipv6_percent = ipv6_percent;
+			args_used++;
+		}
+		else if(!strcmp(*argv, "--zipf"))
+		{
+			/* get the exponent of the Zipf popularity of flows */
+			params.zipf_exponent = (argc > 1 ? strtod(argv[1], NULL) : -1.0);
+			if(params.zipf_exponent < 0.0 || !isfinite(params.zipf_exponent))
+			{
+				fprintf(stderr, "the Zipf exponent shall be a positive number\n");
+				goto error;
+			}
+			args_used++;
+		}
+		else if(!strcmp(*argv, "--churn"))
+		{
+			/* get the number of packets between two flow replacements */
+			const int churn = (argc > 1 ? atoi(argv[1]) : -1);
+			if(churn < 0)
+			{
+				fprintf(stderr, "the churn shall be a positive number\n");
+				goto error;
+			}
+			params.churn = churn;
+			args_used++;
+		}
+		else if(!strcmp(*argv, "--burst"))
+		{
+			/* get the number of consecutive packets on the same flow */
+			const int burst = (argc > 1 ? atoi(argv[1]) : 0);
+			if(burst < 1)
+			{
+				fprintf(stderr, "the burst length shall be at least 1\n");
+				goto error;
+			}
+			params.burst = burst;
+			args_used++;
+		}
+		else if(!strcmp(*argv, "--seed"))
+		{
+			/* get the seed of the pseudo-random generator */
+			params.seed = (argc > 1 ? strtoull(argv[1], NULL, 0) : 0);
+			args_used++;
+		}
 		else if(stream_type == NULL)
 		{
 			/* get the type of the stream to perform */
@@ -273,7 +463,7 @@ int main(int argc, char *argv[])
 
 	/* test ROHC compression/decompression with the packets from the file */
 	if(!build_stream(filename, stream_type, max_packets,
-	                 use_large_cid, wlsb_width, max_contexts))
+	                 use_large_cid, wlsb_width, max_contexts, &params))
 	{
 		fprintf(stderr, "failed to build stream\n");
 		goto error;
@@ -307,6 +497,22 @@ static void usage(void)
 	       "      --max-contexts NUM  The maximum number of ROHC contexts to\n"
 	       "                          simultaneously use during the test\n"
 	       "      --wlsb-width NUM    The width of the WLSB window to use\n"
+	       "Flow options:\n"
+	       "      --flows NUM         The number of concurrent flows\n"
+	       "                          (default: 1)\n"
+	       "      --profiles LIST     The comma-separated mix of profiles of the\n"
+	       "                          flows among rtp, udp, tcp, esp and ip,\n"
+	       "                          every profile may be followed by ':WEIGHT'\n"
+	       "                          (default: rtp)\n"
+	       "      --ipv6 PERCENT      The percentage of IPv6 flows (default: 0)\n"
+	       "      --zipf EXPONENT     Pick the flows with a Zipf distribution of\n"
+	       "                          the given exponent (default: 0, uniform)\n"
+	       "      --churn NUM         Replace one flow by a new one every NUM\n"
+	       "                          packets (default: 0, never)\n"
+	       "      --burst NUM         The number of consecutive packets sent on\n"
+	       "                          the same flow (default: 1)\n"
+	       "      --seed NUM          The seed of the pseudo-random generator\n"
+	       "                          (default: 1)\n"
 	       "Mandatory parameters:\n"
 	       "  MAX                     The number of packets to generate\n"
 	       "  OUTPUT                  The name of the output file with the\n"
@@ -318,20 +524,104 @@ static void usage(void)
 	       "  rohc_gen_stream comp 500 rohc.pcap    Generate 500 RTP packets,\n"
 	       "                                        compress them, then store\n"
 	       "                                        them in file rohc.pcap\n"
+	       "  rohc_gen_stream --cid-type largecid --max-contexts 16384 \\\n"
+	       "    --flows 16384 --profiles rtp:2,udp,tcp --ipv6 50 --zipf 1.0 \\\n"
+	       "    --churn 1000 comp 1000000 mix.pcap\n"
+	       "                          Generate 1000000 packets from 16384 flows\n"
+	       "                          of mixed profiles, compress them, then\n"
+	       "                          store them in file mix.pcap\n"
 	       "\n"
 	       "Report bugs to <" PACKAGE_BUGREPORT ">.\n");
 }
 
 
+/**
+ * @brief Parse the mix of profiles of the flows
+ *
+ * The list is a comma-separated list of profile names, every name may be
+ * followed by a colon and a weight, eg. 'rtp:3,udp,tcp:2'. The weight is 1
+ * by default.
+ *
+ * @param list     The mix of profiles given on the command line
+ * @param weights  OUT: The relative weight of every profile
+ * @return         true if the list is valid, false otherwise
+ */
+static bool parse_profiles(const char *const list,
+                           unsigned int weights[GEN_PROFILE_MAX])
+{
+	unsigned int weights_sum = 0;
+	const char *item = list;
+	size_t profile;
+
+	memset(weights, 0, sizeof(unsigned int) * GEN_PROFILE_MAX);
+
+	while(*item != '\0')
+	{
+		const size_t item_len = strcspn(item, ",");
+		const size_t name_len = strcspn(item, ":,");
+		unsigned long weight = 1;
+
+		for(profile = 0; profile < GEN_PROFILE_MAX; profile++)
+		{
+			if(strlen(gen_profile_names[profile]) == name_len &&
+			   !strncmp(item, gen_profile_names[profile], name_len))
+			{
+				break;
+			}
+		}
+		if(profile == GEN_PROFILE_MAX)
+		{
+			goto error;
+		}
+
+		if(name_len < item_len)
+		{
+			char *weight_end;
+
+			weight = strtoul(item + name_len + 1, &weight_end, 10);
+			if(weight_end != (item + item_len) || weight > 1000)
+			{
+				goto error;
+			}
+		}
+		weights[profile] += weight;
+		weights_sum += weight;
+
+		item += item_len;
+		if(*item == ',')
+		{
+			item++;
+		}
+	}
+
+	if(weights_sum == 0)
+	{
+		goto error;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
 /**
  * @brief Build an (un)compressed stream
  *
+ * The packets are picked among a set of concurrent flows: a flow is chosen,
+ * then a burst of packets is sent on it before the next flow is chosen. The
+ * flows are chosen uniformly, or according to their rank in a Zipf
+ * distribution. Every \e churn packets, a random flow is replaced by a new
+ * one. The same parameters always produce the same stream.
+ *
  * @param filename       The name of the PCAP file to output the stream
  * @param stream_type    The type of stream to generate: uncomp or comp
  * @param max_packets    The number of packets to generate
  * @param use_large_cid  Whether the compressor shall use large CIDs
  * @param max_contexts   The maximum number of ROHC contexts to use
  * @param wlsb_width     The width of the WLSB window to use
+ * @param params         The parameters of the generated flows
  * @return               true in case of success,
  *                       false in case of failure
  */
@@ -340,7 +630,8 @@ static bool build_stream(const char *const filename,
                          const unsigned long max_packets,
                          const int use_large_cid,
                          const size_t wlsb_width,
-                         const size_t max_contexts)
+                         const size_t max_contexts,
+                         const struct gen_params *const params)
 {
 	const rohc_cid_type_t cid_type =
 		(use_large_cid ? ROHC_LARGE_CID : ROHC_SMALL_CID);
@@ -350,6 +641,13 @@ static bool build_stream(const char *const filename,
 	pcap_t *pcap;
 	pcap_dumper_t *dumper;
 
+	struct gen_flow *flows;
+	double *popularity;
+	uint64_t rand_state;
+	unsigned long next_flow_id;
+	unsigned long burst_left = 0;
+	size_t flow_idx = 0;
+
 	unsigned long counter;
 
 	struct rohc_comp *comp = NULL;
@@ -357,12 +655,33 @@ static bool build_stream(const char *const filename,
 	printf("generate %lu %s packets in '%s'...\n", max_packets, stream_type,
 	       filename);
 
+	/* create the flows, the seed shall never be zero for the generator */
+	rand_state = (params->seed != 0 ? params->seed : 1);
+	flows = calloc(params->flows_nr, sizeof(struct gen_flow));
+	if(flows == NULL)
+	{
+		fprintf(stderr, "failed to allocate memory for %zu flows\n",
+		        params->flows_nr);
+		goto error;
+	}
+	for(next_flow_id = 0; next_flow_id < params->flows_nr; next_flow_id++)
+	{
+		gen_flow_init(&flows[next_flow_id], next_flow_id, params, &rand_state);
+	}
+	popularity = gen_popularity_new(params->flows_nr, params->zipf_exponent);
+	if(popularity == NULL)
+	{
+		fprintf(stderr, "failed to allocate memory for %zu flows\n",
+		        params->flows_nr);
+		goto free_flows;
+	}
+
 	/* create a PCAP context for output */
 	pcap = pcap_open_dead(DLT_EN10MB, 0 /* infinite snaplen */);
 	if(pcap == NULL)
 	{
 		fprintf(stderr, "failed to create a pcap context\n");
-		goto error;
+		goto free_popularity;
 	}
 
 	/* open the PCAP dump file */
@@ -419,25 +738,17 @@ static bool build_stream(const char *const filename,
 	/* build the stream, and save it in the PCAP dump */
 	for(counter = 1; counter <= max_packets; counter++)
 	{
-		const size_t payload_len = 20;
-		const size_t packet_len = sizeof(struct ipv4_hdr) +
-		                          sizeof(struct udphdr) +
-		                          sizeof(struct rtphdr) +
-		                          payload_len;
-		uint8_t buffer[ETHER_HDR_LEN + packet_len];
+		uint8_t buffer[ETHER_HDR_LEN + GEN_PACKET_MAX_LEN];
 		struct rohc_buf packet =
-			rohc_buf_init_empty(buffer, ETHER_HDR_LEN + packet_len);
+			rohc_buf_init_empty(buffer, ETHER_HDR_LEN + GEN_PACKET_MAX_LEN);
 
-		const size_t rohc_max_len = packet_len * 2;
+		const size_t rohc_max_len = GEN_PACKET_MAX_LEN * 2;
 		uint8_t output[ETHER_HDR_LEN + rohc_max_len];
 		struct rohc_buf rohc_packet =
 			rohc_buf_init_empty(output, ETHER_HDR_LEN + rohc_max_len);
 
 		struct pcap_pkthdr header = { .ts = { .tv_sec = 0, .tv_usec = 0 } };
-		struct ipv4_hdr *ipv4;
-		struct udphdr *udp;
-		struct rtphdr *rtp;
-		size_t i;
+		struct gen_flow *flow;
 
 		/* skip the Ethernet header, it will be written later */
 		packet.len += ETHER_HDR_LEN;
@@ -445,55 +756,18 @@ static bool build_stream(const char *const filename,
 		rohc_packet.len += ETHER_HDR_LEN;
 		rohc_buf_pull(&rohc_packet, ETHER_HDR_LEN);
 
-		/* build IPv4 header */
-		packet.len += sizeof(struct ipv4_hdr);
-		ipv4 = (struct ipv4_hdr *) rohc_buf_data(packet);
-		ipv4->version = 4;
-		ipv4->ihl = 5;
-		ipv4->tos = 0;
-		ipv4->tot_len = htons(packet.len);
-		ipv4->id = htons(42 + counter);
-		ipv4->frag_off = 0;
-		ipv4->ttl = 64;
-		ipv4->protocol = IPPROTO_UDP;
-		ipv4->check = 0;
-		ipv4->saddr = htonl(0xc0a80001);
-		ipv4->daddr = htonl(0xc0a80002);
-		ipv4->check = ip_fast_csum((uint8_t *) ipv4, ipv4->ihl);
-		rohc_buf_pull(&packet, sizeof(struct ipv4_hdr));
-
-		/* build UDP header */
-		packet.len += sizeof(struct udphdr);
-		udp = (struct udphdr *) rohc_buf_data(packet);
-		udp->source = htons(1234);
-		udp->dest = htons(1234);
-		udp->len = htons(packet.len);
-		udp->check = 0; /* UDP checksum disabled */
-		rohc_buf_pull(&packet, sizeof(struct udphdr));
-
-		/* build RTP header */
-		packet.len += sizeof(struct rtphdr);
-		rtp = (struct rtphdr *) rohc_buf_data(packet);
-		rtp->version = 2;
-		rtp->padding = 0;
-		rtp->extension = 0;
-		rtp->cc = 0;
-		rtp->m = 0;
-		rtp->pt = 0x72; /* speex */
-		rtp->sn = htons(counter);
-		rtp->timestamp = htonl(500000 + counter * 160);
-		rtp->ssrc = htonl(0x42424242);
-		rohc_buf_pull(&packet, sizeof(struct rtphdr));
-
-		/* build RTP payload */
-		for(i = 0; i < payload_len; i++)
-		{
-			rohc_buf_byte_at(packet, i) = i % 0xff;
-		}
-		packet.len += payload_len;
-		rohc_buf_pull(&packet, payload_len);
-
-		rohc_buf_push(&packet, packet_len);
+		/* choose the flow of the packet once the previous burst is over */
+		if(burst_left == 0)
+		{
+			flow_idx = gen_pick_flow(popularity, params->flows_nr, &rand_state);
+			burst_left = params->burst;
+		}
+		burst_left--;
+		flow = &flows[flow_idx];
+		flow->packets_nr++;
+
+		/* build the headers and the payload of the flow */
+		gen_build_packet(flow, flow->packets_nr, &packet);
 
 		if(strcmp(stream_type, "comp") == 0)
 		{
@@ -523,14 +797,41 @@ static bool build_stream(const char *const filename,
 			/* build Linux cooked header */
 			rohc_buf_push(&packet, ETHER_HDR_LEN);
 			memset(rohc_buf_data(packet), 0, ETHER_HDR_LEN);
-			rohc_buf_byte_at(packet, ETHER_HDR_LEN - 2) = 0x80;
-			rohc_buf_byte_at(packet, ETHER_HDR_LEN - 1) = 0x00;
+			if(flow->is_ipv6)
+			{
+				rohc_buf_byte_at(packet, ETHER_HDR_LEN - 2) = 0x86;
+				rohc_buf_byte_at(packet, ETHER_HDR_LEN - 1) = 0xdd;
+			}
+			else
+			{
+				rohc_buf_byte_at(packet, ETHER_HDR_LEN - 2) = 0x80;
+				rohc_buf_byte_at(packet, ETHER_HDR_LEN - 1) = 0x00;
+			}
 
 			/* write the packet in the PCAP dump */
 			header.caplen = packet.len;
 			header.len = packet.len;
 			pcap_dump((u_char *) dumper, &header, rohc_buf_data(packet));
 		}
+
+		/* replace one random flow by a new one from time to time */
+		if(params->churn > 0 && (counter % params->churn) == 0)
+		{
+			const size_t replaced_idx = gen_rand(&rand_state) % params->flows_nr;
+
+			gen_flow_init(&flows[replaced_idx], next_flow_id, params, &rand_state);
+			next_flow_id++;
+			if(replaced_idx == flow_idx)
+			{
+				burst_left = 0;
+			}
+		}
+	}
+
+	if(params->flows_nr > 1 || params->churn > 0)
+	{
+		printf("%lu flows used, %zu concurrent flows\n", next_flow_id,
+		       params->flows_nr);
 	}
 
 	is_success = true;
@@ -544,11 +845,368 @@ close_dumper:
 	pcap_dump_close(dumper);
 close_pcap:
 	pcap_close(pcap);
+free_popularity:
+	free(popularity);
+free_flows:
+	free(flows);
 error:
 	return is_success;
 }
 
 
+/**
+ * @brief Compute the cumulative popularity of the flows
+ *
+ * The flow at index i has the weight 1/(i+1)^exponent, so that the exponent 0
+ * gives the same popularity to all flows.
+ *
+ * @param flows_nr  The number of concurrent flows
+ * @param exponent  The exponent of the Zipf distribution
+ * @return          The cumulative distribution of the flows (to be freed),
+ *                  NULL if the memory cannot be allocated
+ */
+static double * gen_popularity_new(const size_t flows_nr,
+                                   const double exponent)
+{
+	double *popularity;
+	double sum = 0.0;
+	size_t i;
+
+	popularity = malloc(sizeof(double) * flows_nr);
+	if(popularity == NULL)
+	{
+		goto error;
+	}
+
+	for(i = 0; i < flows_nr; i++)
+	{
+		sum += pow(i + 1, -exponent);
+		popularity[i] = sum;
+	}
+	for(i = 0; i < flows_nr; i++)
+	{
+		popularity[i] /= sum;
+	}
+
+error:
+	return popularity;
+}
+
+
+/**
+ * @brief Pick the flow of the next packet
+ *
+ * @param popularity  The cumulative distribution of the flows
+ * @param flows_nr    The number of concurrent flows
+ * @param rand_state  The state of the pseudo-random generator
+ * @return            The index of the chosen flow
+ */
+static size_t gen_pick_flow(const double *const popularity,
+                            const size_t flows_nr,
+                            uint64_t *const rand_state)
+{
+	const double value = gen_rand_unit(rand_state);
+	size_t low = 0;
+	size_t high = flows_nr - 1;
+
+	/* search for the first flow whose cumulative popularity exceeds the
+	 * random value */
+	while(low < high)
+	{
+		const size_t middle = low + (high - low) / 2;
+
+		if(popularity[middle] > value)
+		{
+			high = middle;
+		}
+		else
+		{
+			low = middle + 1;
+		}
+	}
+
+	return low;
+}
+
+
+/**
+ * @brief Initialize one new flow
+ *
+ * The profile and the IP version of the flow are chosen randomly according
+ * to the parameters of the stream.
+ *
+ * @param flow        The flow to initialize
+ * @param id          The identifier of the flow
+ * @param params      The parameters of the generated flows
+ * @param rand_state  The state of the pseudo-random generator
+ */
+static void gen_flow_init(struct gen_flow *const flow,
+                          const unsigned long id,
+                          const struct gen_params *const params,
+                          uint64_t *const rand_state)
+{
+	unsigned int weights_sum = 0;
+	unsigned int value;
+	size_t profile;
+
+	for(profile = 0; profile < GEN_PROFILE_MAX; profile++)
+	{
+		weights_sum += params->profile_weights[profile];
+	}
+	value = gen_rand(rand_state) % weights_sum;
+	for(profile = 0; value >= params->profile_weights[profile]; profile++)
+	{
+		value -= params->profile_weights[profile];
+	}
+
+	flow->id = id;
+	flow->profile = profile;
+	flow->is_ipv6 = ((gen_rand(rand_state) % 100) < params->ipv6_percent);
+	flow->packets_nr = 0;
+}
+
+
+/**
+ * @brief Build the next packet of one flow
+ *
+ * The addresses, ports, SSRC and SPI of the flow are derived from its
+ * identifier, the fields that change from packet to packet are derived from
+ * the number of packets already sent on the flow.
+ *
+ * @param flow     The flow of the packet
+ * @param counter  The number of the packet in the flow, starting at 1
+ * @param packet   The empty buffer to build the packet in
+ */
+static void gen_build_packet(const struct gen_flow *const flow,
+                             const unsigned long counter,
+                             struct rohc_buf *const packet)
+{
+	const size_t payload_len = gen_profile_payload_lens[flow->profile];
+	const size_t ip_hdr_len =
+		(flow->is_ipv6 ? sizeof(struct ipv6_hdr) : sizeof(struct ipv4_hdr));
+	const uint32_t addr_id = (uint32_t) (flow->id << 8);
+	size_t l4_hdr_len;
+	uint8_t protocol;
+	uint8_t *ip;
+	uint8_t *l4;
+	size_t i;
+
+	switch(flow->profile)
+	{
+		case GEN_PROFILE_RTP:
+			l4_hdr_len = sizeof(struct udphdr) + sizeof(struct rtphdr);
+			protocol = IPPROTO_UDP;
+			break;
+		case GEN_PROFILE_UDP:
+			l4_hdr_len = sizeof(struct udphdr);
+			protocol = IPPROTO_UDP;
+			break;
+		case GEN_PROFILE_TCP:
+			l4_hdr_len = sizeof(struct tcphdr);
+			protocol = IPPROTO_TCP;
+			break;
+		case GEN_PROFILE_ESP:
+			l4_hdr_len = sizeof(struct esphdr);
+			protocol = IPPROTO_ESP;
+			break;
+		case GEN_PROFILE_IP:
+		default:
+			l4_hdr_len = 0;
+			protocol = GEN_IPPROTO_NONE;
+			break;
+	}
+	assert((ip_hdr_len + l4_hdr_len + payload_len) <= GEN_PACKET_MAX_LEN);
+
+	packet->len = ip_hdr_len + l4_hdr_len + payload_len;
+	ip = rohc_buf_data(*packet);
+	l4 = ip + ip_hdr_len;
+
+	/* build IP header */
+	if(flow->is_ipv6)
+	{
+		struct ipv6_hdr *const ipv6 = (struct ipv6_hdr *) ip;
+
+		ipv6->version_tc_flow = htonl(6U << 28);
+		ipv6->plen = htons(l4_hdr_len + payload_len);
+		ipv6->nh = protocol;
+		ipv6->hl = 64;
+		ipv6->saddr.u32[0] = htonl(0x20010db8);
+		ipv6->saddr.u32[1] = 0;
+		ipv6->saddr.u32[2] = 0;
+		ipv6->saddr.u32[3] = htonl(0x00000001 + addr_id);
+		ipv6->daddr.u32[0] = htonl(0x20010db8);
+		ipv6->daddr.u32[1] = 0;
+		ipv6->daddr.u32[2] = 0;
+		ipv6->daddr.u32[3] = htonl(0x00000002);
+	}
+	else
+	{
+		struct ipv4_hdr *const ipv4 = (struct ipv4_hdr *) ip;
+
+		ipv4->version = 4;
+		ipv4->ihl = 5;
+		ipv4->tos = 0;
+		ipv4->tot_len = htons(packet->len);
+		ipv4->id = htons(42 + counter);
+		ipv4->frag_off = 0;
+		ipv4->ttl = 64;
+		ipv4->protocol = protocol;
+		ipv4->check = 0;
+		ipv4->saddr = htonl(0xc0a80001 + addr_id);
+		ipv4->daddr = htonl(0xc0a80002);
+		ipv4->check = ip_fast_csum((uint8_t *) ipv4, ipv4->ihl);
+	}
+
+	/* build payload */
+	for(i = 0; i < payload_len; i++)
+	{
+		l4[l4_hdr_len + i] = i % 0xff;
+	}
+
+	/* build transport headers */
+	if(flow->profile == GEN_PROFILE_RTP || flow->profile == GEN_PROFILE_UDP)
+	{
+		struct udphdr *const udp = (struct udphdr *) l4;
+
+		/* only the RTP flows use the destination port reserved for RTP */
+		udp->source = htons(1234 + flow->id);
+		udp->dest = htons(flow->profile == GEN_PROFILE_RTP ? 1234 : 4321);
+		udp->len = htons(l4_hdr_len + payload_len);
+		udp->check = 0;
+
+		if(flow->profile == GEN_PROFILE_RTP)
+		{
+			struct rtphdr *const rtp = (struct rtphdr *) (udp + 1);
+
+			rtp->version = 2;
+			rtp->padding = 0;
+			rtp->extension = 0;
+			rtp->cc = 0;
+			rtp->m = 0;
+			rtp->pt = 0x72; /* speex */
+			rtp->sn = htons(counter);
+			rtp->timestamp = htonl(500000 + counter * 160);
+			rtp->ssrc = htonl(0x42424242 + flow->id);
+		}
+
+		/* UDP checksum is disabled for IPv4, but mandatory for IPv6 */
+		if(flow->is_ipv6)
+		{
+			udp->check = gen_l4_checksum(ip, flow->is_ipv6, protocol, l4,
+			                             l4_hdr_len + payload_len);
+			if(udp->check == 0)
+			{
+				udp->check = 0xffff;
+			}
+		}
+	}
+	else if(flow->profile == GEN_PROFILE_TCP)
+	{
+		struct tcphdr *const tcp = (struct tcphdr *) l4;
+
+		tcp->src_port = htons(1234 + flow->id);
+		tcp->dst_port = htons(80);
+		tcp->seq_num = htonl(0x10000000 + (counter - 1) * payload_len);
+		tcp->ack_num = htonl(0x20000000);
+		tcp->res_flags = 0;
+		tcp->data_offset = sizeof(struct tcphdr) / 4;
+		tcp->rsf_flags = RSF_NONE;
+		tcp->psh_flag = 1;
+		tcp->ack_flag = 1;
+		tcp->urg_flag = 0;
+		tcp->ecn_flags = 0;
+		tcp->window = htons(0xffff);
+		tcp->checksum = 0;
+		tcp->urg_ptr = 0;
+		tcp->checksum = gen_l4_checksum(ip, flow->is_ipv6, protocol, l4,
+		                                l4_hdr_len + payload_len);
+	}
+	else if(flow->profile == GEN_PROFILE_ESP)
+	{
+		struct esphdr *const esp = (struct esphdr *) l4;
+
+		esp->spi = htonl(0x1000 + flow->id);
+		esp->sn = htonl(counter);
+	}
+}
+
+
+/**
+ * @brief Compute the UDP or TCP checksum of one packet
+ *
+ * @param ip        The IP header of the packet
+ * @param is_ipv6   Whether the IP header is IPv6 or IPv4
+ * @param protocol  The protocol of the transport header
+ * @param l4        The transport header of the packet
+ * @param l4_len    The length of the transport header and its payload
+ * @return          The checksum in network byte order
+ */
+static uint16_t gen_l4_checksum(const uint8_t *const ip,
+                                const bool is_ipv6,
+                                const uint8_t protocol,
+                                const uint8_t *const l4,
+                                const size_t l4_len)
+{
+	/* the addresses of the pseudo-header are contiguous in both versions */
+	const size_t addrs_offset = (is_ipv6 ? 8 : 12);
+	const size_t addrs_len = (is_ipv6 ? 32 : 8);
+	uint32_t sum = protocol + l4_len;
+	uint16_t checksum;
+	size_t i;
+
+	for(i = 0; i < addrs_len; i += 2)
+	{
+		sum += (ip[addrs_offset + i] << 8) | ip[addrs_offset + i + 1];
+	}
+	for(i = 0; (i + 1) < l4_len; i += 2)
+	{
+		sum += (l4[i] << 8) | l4[i + 1];
+	}
+	if(i < l4_len)
+	{
+		sum += l4[i] << 8;
+	}
+	while((sum >> 16) != 0)
+	{
+		sum = (sum & 0xffff) + (sum >> 16);
+	}
+	checksum = htons(~sum & 0xffff);
+
+	return checksum;
+}
+
+
+/**
+ * @brief Get the next number of the pseudo-random generator
+ *
+ * The generator is a xorshift64* generator, so that the same seed always
+ * produces the same stream whatever the platform.
+ *
+ * @param rand_state  The state of the pseudo-random generator, never zero
+ * @return            The next pseudo-random number
+ */
+static uint64_t gen_rand(uint64_t *const rand_state)
+{
+	*rand_state ^= *rand_state >> 12;
+	*rand_state ^= *rand_state << 25;
+	*rand_state ^= *rand_state >> 27;
+
+	return (*rand_state * 0x2545f4914f6cdd1dULL);
+}
+
+
+/**
+ * @brief Get the next number of the pseudo-random generator in [0, 1)
+ *
+ * @param rand_state  The state of the pseudo-random generator, never zero
+ * @return            The next pseudo-random number in [0, 1)
+ */
+static double gen_rand_unit(uint64_t *const rand_state)
+{
+	return ((gen_rand(rand_state) >> 11) * (1.0 / 9007199254740992.0));
+}
+
+
 /**
  * @brief Callback to print traces of the ROHC library
  *
@@ -0,0 +1,234 @@
+#!/bin/sh
+#
+# Copyright 2026 Didier Barvaux
+#
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License as published by the Free Software Foundation; either
+# version 2.1 of the License, or (at your option) any later version.
+#
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this library; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+#
+
+#
+# file:        rohc_perf_suite.sh
+# description: Run the whole performance suite of the ROHC library and write
+#              all its results in one JSON file, so that the performances may
+#              be compared from one commit or release to the other: the
+#              benchmarks of the building blocks, the performance tool over
+#              some captures of the non-regression tests, the benchmark of
+#              the context churn, and the scaling over several threads. Run
+#              by 'make perf-suite'.
+#
+
+# the captures of the non-regression tests that cover the main profiles: the
+# RTP, UDP and ESP profiles of RFC3095, the TCP profile of RFC6846, and the
+# list compression of the IPv6 extension headers
+PERF_CAPTURES="
+	rfc3095/inputs/ipv4/udp/rtp/video3
+	rfc3095/inputs/ipv6/udp/rtp/video2
+	rfc3095/inputs/ipv4/udp
+	rfc3095/inputs/ipv4/esp
+	rfc6846/inputs/ipv4/tcp/snaketrap-hptcp
+	rfc6846/inputs/ipv6/tcp/uk6x
+	rfc3095/inputs/ipv6ext/udp
+	rfc3095/inputs/ipv6ext/icmp-variable-ipv6ext
+	rfc6846/inputs/ipv6ext/ipv6ext/tcp
+"
+PERF_REPEAT=20
+# the capture compressed by 1, 2, 4... threads up to the number of CPUs
+PERF_SCALING_CAPTURE="rfc6846/inputs/ipv4/tcp/snaketrap-hptcp"
+PERF_CHURN_FLOWS=100000
+
+usage()
+{
+	echo "rohc_perf_suite.sh bench-dir performance-app-dir non-regression-dir json-file"
+}
+
+
+# print the lines of the given file as the items of one JSON array
+json_lines_array()
+{
+	printf '  "%s": [' "$1"
+	awk '{ printf("%s\n    %s", (NR == 1 ? "" : ","), $0) }
+	     END { if(NR > 0) { printf("\n  ") } }' "$2"
+	printf ']'
+}
+
+
+# print the JSON documents of the given files as the items of one JSON array
+json_files_array()
+{
+	name="$1"
+	shift
+	printf '  "%s": [' "${name}"
+	awk 'FNR == 1 { printf("%s", (NR == 1 ? "" : ",")) }
+	     { printf("\n      %s", $0) }
+	     END { if(NR > 0) { printf("\n  ") } }' "$@" | \
+		sed -e 's/^      {$/    {/' -e 's/^      }/    }/'
+	printf ']'
+}
+
+
+# convert the tab-separated output of one benchmark of the building blocks
+# in JSON objects, one per line: the header line gives the names of the
+# fields, the missing values are given as '-'
+tsv_to_json()
+{
+	awk -F '\t' '
+		/^# / {
+			sub(/^# /, "");
+			for(i = 1; i <= NF; i++) {
+				names[i] = $i;
+			}
+			next;
+		}
+		{
+			printf("{");
+			for(i = 1; i <= NF; i++) {
+				if($i == "-") {
+					value = "null";
+				} else if($i ~ /^-?[0-9]+(\.[0-9]+)?$/) {
+					value = $i;
+				} else {
+					value = "\"" $i "\"";
+				}
+				printf("%s \"%s\": %s", (i == 1 ? "" : ","), names[i], value);
+			}
+			printf(" }\n");
+		}'
+}
+
+
+bench_dir="$1"
+app_dir="$2"
+test_dir="$3"
+json_file="$4"
+if [ -z "${bench_dir}" ] || [ -z "${app_dir}" ] || [ -z "${test_dir}" ] || \
+   [ -z "${json_file}" ] ; then
+	usage
+	exit 1
+fi
+for bin in "${bench_dir}/rohc_bench" "${bench_dir}/rohc_wlsb_bench" \
+           "${app_dir}/rohc_test_performance" "${app_dir}/rohc_test_churn" ; do
+	if [ ! -x "${bin}" ] ; then
+		echo "${bin} executable not found" >&2
+		exit 1
+	fi
+done
+if [ ! -d "${test_dir}" ] ; then
+	echo "${test_dir} directory not found" >&2
+	exit 1
+fi
+perf_bin="${app_dir}/rohc_test_performance"
+
+work_dir=$( mktemp -d ) || exit $?
+trap 'rm -rf "${work_dir}"' EXIT
+
+# the benchmarks of the building blocks: CRC, SDVL, W-LSB, TCP SACK...
+echo "run the benchmarks of the building blocks"
+"${bench_dir}/rohc_bench" > "${work_dir}/micro.tsv" || exit $?
+tsv_to_json < "${work_dir}/micro.tsv" > "${work_dir}/micro.json"
+echo "run the benchmarks of the W-LSB window widths"
+"${bench_dir}/rohc_wlsb_bench" > "${work_dir}/wlsb.tsv" || exit $?
+tsv_to_json < "${work_dir}/wlsb.tsv" > "${work_dir}/wlsb.json"
+
+# the compression of the captures, and the decompression of their ROHC
+# packets, with both types of CIDs: the ROHC packets cannot be replayed
+# through the same decompressor, so they are decompressed only once, and
+# the captures whose ROHC packets need the feedback of the non-regression
+# tests to be decompressed are skipped
+captures_nr=0
+for capture in ${PERF_CAPTURES} ; do
+	if [ ! -f "${test_dir}/${capture}/source.pcap" ] ; then
+		echo "skip missing capture ${capture}" >&2
+		continue
+	fi
+	for cid_type in smallcid largecid ; do
+		for action in comp decomp ; do
+			if [ "${action}" = "comp" ] ; then
+				flow="${test_dir}/${capture}/source.pcap"
+				repeat=${PERF_REPEAT}
+			else
+				flow="${test_dir}/${capture}/rohc_maxcontexts0_wlsb4_${cid_type}.pcap"
+				repeat=1
+			fi
+			captures_nr=$(( captures_nr + 1 ))
+			capture_json="${work_dir}/capture.$( printf '%03d' ${captures_nr} ).json"
+			echo "run ${action} test with ${capture} (${cid_type})"
+			${perf_bin} --repeat ${repeat} --json "${capture_json}" \
+				${action} ${cid_type} "${flow}" >/dev/null 2>&1
+			ret=$?
+			if [ ${ret} -ne 0 ] && [ "${action}" = "comp" ] ; then
+				exit ${ret}
+			elif [ ${ret} -ne 0 ] ; then
+				echo "skip decomp test with ${capture} (${cid_type}): failed" >&2
+				rm -f "${capture_json}"
+			fi
+		done
+	done
+done
+if [ ${captures_nr} -eq 0 ] ; then
+	echo "no capture found in ${test_dir}" >&2
+	exit 1
+fi
+
+# the creation and destruction of many contexts
+: > "${work_dir}/churn.json"
+for cid_type in smallcid largecid ; do
+	echo "run churn test (${cid_type})"
+	"${app_dir}/rohc_test_churn" --flows ${PERF_CHURN_FLOWS} ${cid_type} \
+		> "${work_dir}/churn.txt" || exit $?
+	awk -v cid_type=${cid_type} '$1 ~ /^[0-9]+$/ && NF == 6 {
+		printf("{ \"cid_type\": \"%s\", \"max_cid\": %s, " \
+		       "\"comp_flows_per_second\": %s, " \
+		       "\"decomp_flows_per_second\": %s, " \
+		       "\"flows_per_second\": %s, \"comp_ns_per_flow\": %s, " \
+		       "\"decomp_ns_per_flow\": %s }\n",
+		       cid_type, $1, $2, $3, $4, $5, $6);
+	}' "${work_dir}/churn.txt" >> "${work_dir}/churn.json"
+done
+
+# the scaling of the compression over 1, 2, 4... threads
+cpus_nr=$( getconf _NPROCESSORS_ONLN 2>/dev/null || echo 1 )
+threads_nr=1
+while [ ${threads_nr} -le ${cpus_nr} ] ; do
+	echo "run scaling test with ${threads_nr} threads"
+	${perf_bin} --threads ${threads_nr} \
+		--json "${work_dir}/scaling.$( printf '%03d' ${threads_nr} ).json" \
+		comp largecid "${test_dir}/${PERF_SCALING_CAPTURE}/source.pcap" \
+		>/dev/null 2>&1 || exit $?
+	threads_nr=$(( threads_nr * 2 ))
+done
+
+# gather all the results in one JSON file, the version of the library is
+# given by the performance tool
+first_capture="${work_dir}/capture.001.json"
+{
+	echo "{"
+	sed -n -e 's/^  "library_version": \(.*\),$/  "library_version": \1,/p' \
+	       -e 's/^  "git_ref": \(.*\),$/  "git_ref": \1,/p' "${first_capture}"
+	echo "  \"date\": \"$( date -u '+%Y-%m-%dT%H:%M:%SZ' )\","
+	echo "  \"machine\": \"$( uname -m )\","
+	echo "  \"cpus\": ${cpus_nr},"
+	json_lines_array "micro" "${work_dir}/micro.json"
+	echo ","
+	json_lines_array "wlsb" "${work_dir}/wlsb.json"
+	echo ","
+	json_files_array "captures" "${work_dir}"/capture.*.json
+	echo ","
+	json_lines_array "churn" "${work_dir}/churn.json"
+	echo ","
+	json_files_array "scaling" "${work_dir}"/scaling.*.json
+	echo ""
+	echo "}"
+} > "${json_file}" || exit $?
+
+echo "results written in ${json_file}"
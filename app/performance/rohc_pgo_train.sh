@@ -0,0 +1,118 @@
+#!/bin/sh
+#
+# Copyright 2026 Didier Barvaux
+#
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License as published by the Free Software Foundation; either
+# version 2.1 of the License, or (at your option) any later version.
+#
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this library; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+#
+
+#
+# file:        rohc_pgo_train.sh
+# description: Train the instrumented ROHC library for the profile-guided
+#              optimization: compress and decompress some representative
+#              captures of the non-regression tests with the performance
+#              tool. Run by 'make pgo'.
+#
+
+# the captures that exercise the compression hot paths of the library with
+# real traffic: the RTP, UDP, ESP and IP-only profiles of RFC3095 and the TCP
+# profile of RFC6846
+PGO_CAPTURES="
+	rfc3095/inputs/ipv4/udp/rtp/bug1265304
+	rfc3095/inputs/ipv4/udp/rtp/video3
+	rfc3095/inputs/ipv6/udp/rtp/video2
+	rfc3095/inputs/ipv4/udp
+	rfc3095/inputs/ipv4/esp
+	rfc3095/inputs/ipv4/icmp
+	rfc6846/inputs/ipv4/tcp/snaketrap-hptcp
+	rfc6846/inputs/ipv4/tcp/wlsb-ack-only-for-r-mode
+	rfc6846/inputs/ipv6/tcp/uk6x
+"
+# the mix of profiles of the generated streams, that also train the
+# decompression: the ROHC packets of the non-regression tests are built by
+# two compressors at once, so they cannot be replayed through only one
+# decompressor
+PGO_PROFILES="rtp:4,udp:2,tcp:3,esp,ip"
+PGO_PACKETS=20000
+PGO_REPEAT=20
+
+usage()
+{
+	echo "rohc_pgo_train.sh performance-app-dir non-regression-dir work-dir [nr-repeat]"
+}
+
+
+app_dir="$1"
+test_dir="$2"
+work_dir="$3"
+test_repeat="$4"
+if [ -z "${app_dir}" ] || [ -z "${test_dir}" ] || [ -z "${work_dir}" ] ; then
+	usage
+	exit 1
+fi
+test_bin="${app_dir}/rohc_test_performance"
+gen_bin="${app_dir}/rohc_gen_stream"
+for bin in "${test_bin}" "${gen_bin}" ; do
+	if [ ! -x "${bin}" ] ; then
+		echo "${bin} executable not found" >&2
+		exit 1
+	fi
+done
+if [ ! -d "${test_dir}" ] ; then
+	echo "${test_dir} directory not found" >&2
+	exit 1
+fi
+if [ ! -d "${work_dir}" ] ; then
+	echo "${work_dir} directory not found" >&2
+	exit 1
+fi
+if [ -z "${test_repeat}" ] ; then
+	test_repeat=${PGO_REPEAT}
+fi
+
+# compress real traffic
+for capture in ${PGO_CAPTURES} ; do
+	if [ ! -f "${test_dir}/${capture}/source.pcap" ] ; then
+		echo "skip missing capture ${capture}" >&2
+		continue
+	fi
+	for cid_type in smallcid largecid ; do
+		echo "train compression with ${capture} (${cid_type})"
+		${test_bin} --repeat ${test_repeat} comp ${cid_type} \
+			"${test_dir}/${capture}/source.pcap" >/dev/null 2>&1 || exit $?
+	done
+done
+
+# compress and decompress many concurrent flows of mixed profiles
+for cid_type in smallcid largecid ; do
+	if [ "${cid_type}" = "smallcid" ] ; then
+		max_contexts=16
+	else
+		max_contexts=1024
+	fi
+	flows=$(( max_contexts / 2 ))
+	echo "train compression and decompression with ${flows} flows (${cid_type})"
+	${gen_bin} --flows ${flows} --profiles ${PGO_PROFILES} --ipv6 30 --zipf 1 \
+		uncomp ${PGO_PACKETS} "${work_dir}/uncomp_${cid_type}.pcap" \
+		>/dev/null 2>&1 || exit $?
+	${gen_bin} --flows ${flows} --profiles ${PGO_PROFILES} --ipv6 30 --zipf 1 \
+		--cid-type ${cid_type} --max-contexts ${max_contexts} \
+		comp ${PGO_PACKETS} "${work_dir}/comp_${cid_type}.pcap" \
+		>/dev/null 2>&1 || exit $?
+	${test_bin} --repeat 5 --max-contexts ${max_contexts} comp ${cid_type} \
+		"${work_dir}/uncomp_${cid_type}.pcap" >/dev/null 2>&1 || exit $?
+	${test_bin} --repeat 5 --max-contexts ${max_contexts} decomp ${cid_type} \
+		"${work_dir}/comp_${cid_type}.pcap" >/dev/null 2>&1 || exit $?
+	rm -f "${work_dir}/uncomp_${cid_type}.pcap" "${work_dir}/comp_${cid_type}.pcap"
+done
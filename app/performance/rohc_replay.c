@@ -0,0 +1,775 @@
+/*
+ * Copyright 2026 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file    rohc_replay.c
+ * @brief   Replay a recorded ROHC workload with timing
+ * @author  Didier Barvaux <didier@barvaux.org>
+ *
+ * Introduction
+ * ------------
+ *
+ * The program replays the workload recorded from a compressor or from a
+ * decompressor (see rohc_comp_set_recorder() and rohc_decomp_set_recorder())
+ * against the build of the library it is linked with, and measures the time
+ * spent in the library. A performance problem seen in production may so be
+ * reproduced, and bisected, without the original traffic.
+ *
+ * Details
+ * -------
+ *
+ * The whole recording is loaded in memory first, and the truncated inputs
+ * are completed with zeroes, so that the replay measures the library only.
+ * Then, for every repetition, the program creates one compressor or one
+ * decompressor with the recorded configuration and gives it the recorded
+ * inputs in order, with their recorded arrival times:
+ *
+ *                   +-------------------------+
+ *   recording ----> | compressor/decompressor | ----> discarded
+ *                   +-------------------------+
+ *                ^                               ^
+ *                |-------------------------------|
+ *                          measured time
+ *
+ * Output
+ * ------
+ *
+ * For every repetition, the program outputs the number of inputs, the number
+ * of failed inputs, the time spent per input on average and at worst, and
+ * the number of inputs per second.
+ */
+
+#include "config.h" /* for HAVE_*_H and PACKAGE_BUGREPORT */
+
+/* system includes */
+#include <time.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+/* ROHC includes */
+#include <rohc/rohc.h>
+#include <rohc/rohc_comp.h>
+#include <rohc/rohc_decomp.h>
+#include <rohc_record.h>
+
+
+/** The maximal size for the ROHC and IP packets */
+#define MAX_ROHC_SIZE  (64 * 1024)
+
+
+/** One input of the recording, ready to be replayed */
+struct replay_input
+{
+	uint8_t type;         /**< The kind of input, see rohc_record_event_type */
+	uint32_t cid;         /**< The CID chosen by the application, if any */
+	struct rohc_ts time;  /**< The arrival time of the input */
+	uint8_t *data;        /**< The bytes of the input */
+	size_t len;           /**< The length of the input */
+};
+
+
+/** The recording loaded in memory */
+struct replay_recording
+{
+	struct rohc_record_hdr hdr;    /**< The configuration of the instance */
+	struct replay_input *inputs;   /**< The inputs in their recorded order */
+	size_t inputs_nr;              /**< The number of inputs */
+	uint8_t *data;                 /**< The bytes of all the inputs */
+	size_t truncated_nr;           /**< The number of truncated inputs */
+};
+
+
+/** The results of one replay */
+struct replay_result
+{
+	unsigned long inputs_nr;    /**< The number of inputs replayed */
+	unsigned long failures_nr;  /**< The number of inputs that failed */
+	uint64_t total_ns;          /**< The time spent in the library */
+	uint64_t max_ns;            /**< The longest time spent on one input */
+};
+
+
+/* prototypes of private functions */
+static void usage(void);
+static bool load_recording(const char *const filename,
+                           struct replay_recording *const recording)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static void free_recording(struct replay_recording *const recording)
+	__attribute__((nonnull(1)));
+static struct rohc_comp *
+	create_comp(const struct rohc_record_hdr *const hdr)
+	__attribute__((warn_unused_result, nonnull(1)));
+static struct rohc_decomp *
+	create_decomp(const struct rohc_record_hdr *const hdr)
+	__attribute__((warn_unused_result, nonnull(1)));
+static bool replay(const struct replay_recording *const recording,
+                   struct replay_result *const result)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static rohc_status_t replay_comp_input(struct rohc_comp *const comp,
+                                       const struct replay_input *const input)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static uint64_t replay_now_ns(void)
+	__attribute__((warn_unused_result));
+
+static void print_rohc_traces(void *const priv_ctxt,
+                              const rohc_trace_level_t level,
+                              const rohc_trace_entity_t entity,
+                              const int profile,
+                              const char *const format,
+                              ...)
+	__attribute__((format(printf, 5, 6), nonnull(5)));
+
+static int gen_false_random_num(const struct rohc_comp *const comp,
+                                void *const user_context)
+	__attribute__((nonnull(1)));
+
+
+/** Whether the application runs in verbose mode or not */
+static bool is_verbose = false;
+
+
+/**
+ * @brief Main function for the ROHC replay application
+ *
+ * @param argc The number of program arguments
+ * @param argv The program arguments
+ * @return     The unix return code:
+ *              \li 0 in case of success,
+ *              \li 1 in case of failure
+ */
+int main(int argc, char *argv[])
+{
+	struct replay_recording recording;
+	unsigned long repeats_nr = 1;
+	char *filename = NULL;
+	int is_failure = 1;
+	int args_used;
+	unsigned long i;
+
+	/* parse program arguments, print the help message in case of failure */
+	if(argc <= 1)
+	{
+		usage();
+		goto error;
+	}
+
+	for(argc--, argv++; argc > 0; argc -= args_used, argv += args_used)
+	{
+		args_used = 1;
+
+		if(!strcmp(*argv, "-v") || !strcmp(*argv, "--version"))
+		{
+			/* print version */
+			printf("rohc_replay version %s\n", rohc_version());
+			goto error;
+		}
+		else if(!strcmp(*argv, "-h") || !strcmp(*argv, "--help"))
+		{
+			/* print help */
+			usage();
+			goto error;
+		}
+		else if(!strcmp(*argv, "--verbose"))
+		{
+			/* enable verbose mode */
+			is_verbose = true;
+		}
+		else if(!strcmp(*argv, "--repeat"))
+		{
+			/* get the number of replays */
+			const int repeats = (argc > 1 ? atoi(argv[1]) : 0);
+			if(repeats < 1)
+			{
+				fprintf(stderr, "the number of replays shall be at least 1\n");
+				goto error;
+			}
+			repeats_nr = repeats;
+			args_used++;
+		}
+		else if(filename == NULL)
+		{
+			/* get the name of the recording */
+			filename = argv[0];
+		}
+		else
+		{
+			/* do not accept more than one argument without option name */
+			usage();
+			goto error;
+		}
+	}
+
+	if(filename == NULL)
+	{
+		fprintf(stderr, "missing recording\n");
+		usage();
+		goto error;
+	}
+
+	/* load the whole recording before measuring anything */
+	if(!load_recording(filename, &recording))
+	{
+		fprintf(stderr, "failed to load the recording '%s'\n", filename);
+		goto error;
+	}
+	printf("%s: %zu inputs recorded from a %s with %s CIDs and MAX_CID %u",
+	       filename, recording.inputs_nr,
+	       (recording.hdr.entity == ROHC_RECORD_COMP ?
+	        "compressor" : "decompressor"),
+	       (recording.hdr.cid_type == ROHC_SMALL_CID ? "small" : "large"),
+	       recording.hdr.max_cid);
+	if(recording.truncated_nr > 0)
+	{
+		printf(", %zu inputs completed with zeroes", recording.truncated_nr);
+	}
+	printf("\n");
+
+	/* replay the recording */
+	printf("%6s %10s %10s %12s %12s %14s\n", "replay", "inputs", "failures",
+	       "ns/input", "max ns", "inputs/s");
+	for(i = 0; i < repeats_nr; i++)
+	{
+		struct replay_result result;
+		double ns_per_input;
+
+		if(!replay(&recording, &result))
+		{
+			fprintf(stderr, "replay #%lu failed\n", i + 1);
+			goto free_recording;
+		}
+		ns_per_input = ((double) result.total_ns) / result.inputs_nr;
+
+		printf("%6lu %10lu %10lu %12.1f %12llu %14.0f\n", i + 1,
+		       result.inputs_nr, result.failures_nr, ns_per_input,
+		       (unsigned long long) result.max_ns, 1e9 / ns_per_input);
+		fflush(stdout);
+	}
+
+	is_failure = 0;
+
+free_recording:
+	free_recording(&recording);
+error:
+	return is_failure;
+}
+
+
+/**
+ * @brief Print usage of the replay application
+ */
+static void usage(void)
+{
+	printf("Replay a ROHC workload recorded from a compressor or from a\n"
+	       "decompressor, and measure the time spent in the library\n"
+	       "\n"
+	       "Usage: rohc_replay [General options]\n"
+	       "   or: rohc_replay [Replay options] RECORDING\n"
+	       "\n"
+	       "Options:\n"
+	       "General options:\n"
+	       "  -h, --help                Print this usage and exit\n"
+	       "  -v, --version             Print the application version and exit\n"
+	       "      --verbose             Print the traces of the library\n"
+	       "Replay options:\n"
+	       "      --repeat NUM          The number of times the recording is\n"
+	       "                            replayed, every time with a new\n"
+	       "                            instance (default: 1)\n"
+	       "Mandatory parameters:\n"
+	       "  RECORDING                 The file that holds the recording\n"
+	       "\n"
+	       "Examples:\n"
+	       "  rohc_replay comp.rec      Replay the workload once\n"
+	       "  rohc_replay --repeat 10 comp.rec\n"
+	       "                            Replay the workload 10 times to\n"
+	       "                            measure the variations\n"
+	       "\n"
+	       "Report bugs to <" PACKAGE_BUGREPORT ">.\n");
+}
+
+
+/**
+ * @brief Load a whole recording in memory
+ *
+ * The truncated inputs are completed with zeroes.
+ *
+ * @param filename   The name of the file that holds the recording
+ * @param recording  OUT: The recording
+ * @return           true if the recording was loaded, false otherwise
+ */
+static bool load_recording(const char *const filename,
+                           struct replay_recording *const recording)
+{
+	struct rohc_record_event event;
+	size_t data_len = 0;
+	size_t i;
+	FILE *file;
+
+	memset(recording, 0, sizeof(struct replay_recording));
+
+	file = fopen(filename, "rb");
+	if(file == NULL)
+	{
+		fprintf(stderr, "failed to open '%s'\n", filename);
+		goto error;
+	}
+
+	/* check the header */
+	if(fread(&recording->hdr, sizeof(struct rohc_record_hdr), 1, file) != 1)
+	{
+		fprintf(stderr, "recording too short for its header\n");
+		goto close_file;
+	}
+	if(recording->hdr.magic != ROHC_RECORD_MAGIC ||
+	   recording->hdr.version != ROHC_RECORD_VERSION)
+	{
+		fprintf(stderr, "not a recording of version %u\n", ROHC_RECORD_VERSION);
+		goto close_file;
+	}
+	if(recording->hdr.entity != ROHC_RECORD_COMP &&
+	   recording->hdr.entity != ROHC_RECORD_DECOMP)
+	{
+		fprintf(stderr, "recording of unknown entity %u\n",
+		        recording->hdr.entity);
+		goto close_file;
+	}
+	if(recording->hdr.profiles_nr > ROHC_RECORD_PROFILES_MAX)
+	{
+		fprintf(stderr, "recording with too many profiles\n");
+		goto close_file;
+	}
+
+	/* count the inputs and their bytes first */
+	while(fread(&event, sizeof(struct rohc_record_event), 1, file) == 1)
+	{
+		if(event.len > event.orig_len || event.orig_len > MAX_ROHC_SIZE ||
+		   (event.type != ROHC_RECORD_PKT && event.type != ROHC_RECORD_FEEDBACK))
+		{
+			fprintf(stderr, "malformed input #%zu\n", recording->inputs_nr + 1);
+			goto close_file;
+		}
+		if(fseek(file, event.len, SEEK_CUR) != 0)
+		{
+			fprintf(stderr, "truncated input #%zu\n", recording->inputs_nr + 1);
+			goto close_file;
+		}
+		recording->inputs_nr++;
+		data_len += event.orig_len;
+	}
+	if(recording->inputs_nr == 0)
+	{
+		fprintf(stderr, "recording without any input\n");
+		goto close_file;
+	}
+
+	/* then load them */
+	recording->inputs = calloc(recording->inputs_nr,
+	                           sizeof(struct replay_input));
+	recording->data = calloc(1, data_len);
+	if(recording->inputs == NULL || recording->data == NULL)
+	{
+		fprintf(stderr, "no memory for the %zu inputs\n", recording->inputs_nr);
+		goto free_recording;
+	}
+	if(fseek(file, sizeof(struct rohc_record_hdr), SEEK_SET) != 0)
+	{
+		fprintf(stderr, "failed to rewind the recording\n");
+		goto free_recording;
+	}
+	data_len = 0;
+	for(i = 0; i < recording->inputs_nr; i++)
+	{
+		struct replay_input *const input = &recording->inputs[i];
+
+		if(fread(&event, sizeof(struct rohc_record_event), 1, file) != 1)
+		{
+			fprintf(stderr, "failed to read input #%zu\n", i + 1);
+			goto free_recording;
+		}
+		input->type = event.type;
+		input->cid = event.cid;
+		input->time.sec = event.sec;
+		input->time.nsec = event.nsec;
+		input->data = recording->data + data_len;
+		input->len = event.orig_len;
+		if(event.len > 0 && fread(input->data, event.len, 1, file) != 1)
+		{
+			fprintf(stderr, "failed to read input #%zu\n", i + 1);
+			goto free_recording;
+		}
+		if((event.flags & ROHC_RECORD_TRUNCATED) != 0)
+		{
+			recording->truncated_nr++;
+		}
+		data_len += event.orig_len;
+	}
+
+	fclose(file);
+
+	return true;
+
+free_recording:
+	free_recording(recording);
+close_file:
+	fclose(file);
+error:
+	return false;
+}
+
+
+/**
+ * @brief Release the memory of a recording
+ *
+ * @param recording  The recording
+ */
+static void free_recording(struct replay_recording *const recording)
+{
+	free(recording->data);
+	recording->data = NULL;
+	free(recording->inputs);
+	recording->inputs = NULL;
+}
+
+
+/**
+ * @brief Create a compressor with the recorded configuration
+ *
+ * @param hdr  The header of the recording
+ * @return     The compressor, NULL in case of failure
+ */
+static struct rohc_comp *
+	create_comp(const struct rohc_record_hdr *const hdr)
+{
+	struct rohc_comp *comp;
+	size_t i;
+
+	comp = rohc_comp_new2(hdr->cid_type, hdr->max_cid, gen_false_random_num,
+	                      NULL);
+	if(comp == NULL)
+	{
+		fprintf(stderr, "cannot create the compressor\n");
+		goto error;
+	}
+	if(!rohc_comp_set_traces_cb2(comp, print_rohc_traces, NULL))
+	{
+		fprintf(stderr, "failed to set the callback for traces on "
+		        "compressor\n");
+		goto free_comp;
+	}
+	for(i = 0; i < hdr->profiles_nr; i++)
+	{
+		if(!rohc_comp_enable_profile(comp, hdr->profiles[i]))
+		{
+			fprintf(stderr, "failed to enable the compression profile "
+			        "0x%04x\n", hdr->profiles[i]);
+			goto free_comp;
+		}
+	}
+	if(!rohc_comp_set_features(comp, hdr->features))
+	{
+		fprintf(stderr, "failed to enable the compression features 0x%x\n",
+		        hdr->features);
+		goto free_comp;
+	}
+	if(!rohc_comp_set_wlsb_window_width(comp, hdr->param))
+	{
+		fprintf(stderr, "failed to set the W-LSB window width %u\n",
+		        hdr->param);
+		goto free_comp;
+	}
+	if(!rohc_comp_set_mrru(comp, hdr->mrru))
+	{
+		fprintf(stderr, "failed to set the MRRU %u\n", hdr->mrru);
+		goto free_comp;
+	}
+
+	return comp;
+
+free_comp:
+	rohc_comp_free(comp);
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Create a decompressor with the recorded configuration
+ *
+ * @param hdr  The header of the recording
+ * @return     The decompressor, NULL in case of failure
+ */
+static struct rohc_decomp *
+	create_decomp(const struct rohc_record_hdr *const hdr)
+{
+	struct rohc_decomp *decomp;
+	size_t i;
+
+	decomp = rohc_decomp_new2(hdr->cid_type, hdr->max_cid, hdr->param);
+	if(decomp == NULL)
+	{
+		fprintf(stderr, "cannot create the decompressor\n");
+		goto error;
+	}
+	if(!rohc_decomp_set_traces_cb2(decomp, print_rohc_traces, NULL))
+	{
+		fprintf(stderr, "failed to set the callback for traces on "
+		        "decompressor\n");
+		goto free_decomp;
+	}
+	for(i = 0; i < hdr->profiles_nr; i++)
+	{
+		if(!rohc_decomp_enable_profile(decomp, hdr->profiles[i]))
+		{
+			fprintf(stderr, "failed to enable the decompression profile "
+			        "0x%04x\n", hdr->profiles[i]);
+			goto free_decomp;
+		}
+	}
+	if(!rohc_decomp_set_features(decomp, hdr->features))
+	{
+		fprintf(stderr, "failed to enable the decompression features 0x%x\n",
+		        hdr->features);
+		goto free_decomp;
+	}
+	if(!rohc_decomp_set_mrru(decomp, hdr->mrru))
+	{
+		fprintf(stderr, "failed to set the MRRU %u\n", hdr->mrru);
+		goto free_decomp;
+	}
+
+	return decomp;
+
+free_decomp:
+	rohc_decomp_free(decomp);
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Replay the recording once with a new instance
+ *
+ * @param recording  The recording
+ * @param result     OUT: The results of the replay
+ * @return           true in case of success, false otherwise
+ */
+static bool replay(const struct replay_recording *const recording,
+                   struct replay_result *const result)
+{
+	struct rohc_comp *comp = NULL;
+	struct rohc_decomp *decomp = NULL;
+	size_t i;
+
+	memset(result, 0, sizeof(struct replay_result));
+
+	if(recording->hdr.entity == ROHC_RECORD_COMP)
+	{
+		comp = create_comp(&recording->hdr);
+		if(comp == NULL)
+		{
+			goto error;
+		}
+	}
+	else
+	{
+		decomp = create_decomp(&recording->hdr);
+		if(decomp == NULL)
+		{
+			goto error;
+		}
+	}
+
+	for(i = 0; i < recording->inputs_nr; i++)
+	{
+		const struct replay_input *const input = &recording->inputs[i];
+		rohc_status_t status;
+		uint64_t start_ns;
+		uint64_t elapsed_ns;
+
+		if(comp != NULL)
+		{
+			start_ns = replay_now_ns();
+			status = replay_comp_input(comp, input);
+			elapsed_ns = replay_now_ns() - start_ns;
+		}
+		else
+		{
+			uint8_t decomp_buffer[MAX_ROHC_SIZE];
+			const struct rohc_buf rohc_packet =
+				rohc_buf_init_full(input->data, input->len, input->time);
+			struct rohc_buf decomp_packet =
+				rohc_buf_init_empty(decomp_buffer, MAX_ROHC_SIZE);
+
+			start_ns = replay_now_ns();
+			status = rohc_decompress3(decomp, rohc_packet, &decomp_packet,
+			                          NULL, NULL);
+			elapsed_ns = replay_now_ns() - start_ns;
+		}
+
+		result->inputs_nr++;
+		if(status != ROHC_STATUS_OK)
+		{
+			if(is_verbose)
+			{
+				fprintf(stderr, "input #%zu failed: %s\n", i + 1,
+				        rohc_strerror(status));
+			}
+			result->failures_nr++;
+		}
+		result->total_ns += elapsed_ns;
+		if(elapsed_ns > result->max_ns)
+		{
+			result->max_ns = elapsed_ns;
+		}
+	}
+
+	if(comp != NULL)
+	{
+		rohc_comp_free(comp);
+	}
+	if(decomp != NULL)
+	{
+		rohc_decomp_free(decomp);
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Replay one input of a compressor
+ *
+ * The packets are compressed, their segments are retrieved if they are too
+ * large for the MRRU. The feedback is delivered to the compressor.
+ *
+ * @param comp   The ROHC compressor
+ * @param input  The input to replay
+ * @return       The status of the compression,
+ *               ROHC_STATUS_OK if the feedback was delivered,
+ *               ROHC_STATUS_ERROR if it was not
+ */
+static rohc_status_t replay_comp_input(struct rohc_comp *const comp,
+                                       const struct replay_input *const input)
+{
+	const struct rohc_buf data =
+		rohc_buf_init_full(input->data, input->len, input->time);
+	uint8_t rohc_buffer[MAX_ROHC_SIZE];
+	struct rohc_buf rohc_packet =
+		rohc_buf_init_empty(rohc_buffer, MAX_ROHC_SIZE);
+	rohc_status_t status;
+
+	if(input->type == ROHC_RECORD_FEEDBACK)
+	{
+		return (rohc_comp_deliver_feedback2(comp, data) ?
+		        ROHC_STATUS_OK : ROHC_STATUS_ERROR);
+	}
+
+	if(input->cid == ROHC_RECORD_NO_CID)
+	{
+		status = rohc_compress4(comp, data, &rohc_packet);
+	}
+	else
+	{
+		status = rohc_compress_with_cid(comp, input->cid, data, &rohc_packet);
+	}
+	while(status == ROHC_STATUS_SEGMENT)
+	{
+		rohc_packet.offset = 0;
+		rohc_packet.len = 0;
+		status = rohc_comp_get_segment2(comp, &rohc_packet);
+	}
+
+	return status;
+}
+
+
+/**
+ * @brief Get the current time in nanoseconds
+ *
+ * @return  The current time of the monotonic clock
+ */
+static uint64_t replay_now_ns(void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return ((uint64_t) now.tv_sec) * 1000000000U + now.tv_nsec;
+}
+
+
+/**
+ * @brief Callback to print traces of the ROHC library
+ *
+ * @param priv_ctxt  An optional private context, may be NULL
+ * @param level      The priority level of the trace
+ * @param entity     The entity that emitted the trace among:
+ *                    \li ROHC_TRACE_COMP
+ *                    \li ROHC_TRACE_DECOMP
+ * @param profile    The ID of the ROHC compression/decompression profile
+ *                   the trace is related to
+ * @param format     The format string of the trace
+ */
+static void print_rohc_traces(void *const priv_ctxt __attribute__((unused)),
+                              const rohc_trace_level_t level,
+                              const rohc_trace_entity_t entity __attribute__((unused)),
+                              const int profile __attribute__((unused)),
+                              const char *const format,
+                              ...)
+{
+	if(is_verbose)
+	{
+		const char *level_descrs[] =
+		{
+			[ROHC_TRACE_DEBUG]   = "DEBUG",
+			[ROHC_TRACE_INFO]    = "INFO",
+			[ROHC_TRACE_WARNING] = "WARNING",
+			[ROHC_TRACE_ERROR]   = "ERROR"
+		};
+		va_list args;
+		fprintf(stderr, "[%s] ", level_descrs[level]);
+		va_start(args, format);
+		vfprintf(stderr, format, args);
+		va_end(args);
+	}
+}
+
+
+/**
+ * @brief Generate a false random number for replaying the workload
+ *
+ * The Sequence Numbers of the new flows are so the same at every replay.
+ *
+ * @param comp          The ROHC compressor
+ * @param user_context  Should always be NULL
+ * @return              Always 0
+ */
+static int gen_false_random_num(const struct rohc_comp *const comp,
+                                void *const user_context)
+{
+	assert(comp != NULL);
+	assert(user_context == NULL);
+	return 0;
+}
+
@@ -0,0 +1,1432 @@
+/*
+ * Copyright 2026 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file    test_channel.c
+ * @brief   ROHC benchmark through a simulated lossy channel with feedback
+ * @author  Didier Barvaux <didier@barvaux.org>
+ *
+ * Introduction
+ * ------------
+ *
+ * The program takes a flow of IP packets as input (in the PCAP format) and
+ * sends it through a compressor and a decompressor linked by a simulated
+ * channel. The feedback generated by the decompressor goes back to the
+ * compressor through a simulated feedback channel. Both channels may lose,
+ * delay and reorder the packets.
+ *
+ * Details
+ * -------
+ *
+ * The simulation advances one tick per IP packet: at every tick, the program
+ * first delivers to the compressor the feedback that reached it, then
+ * compresses one IP packet, and finally delivers to the decompressor the ROHC
+ * packets that reached it. The delays are expressed in ticks, and a tick
+ * lasts the interval given with the --interval option, so that the clock of
+ * the (de)compressor follows the simulation.
+ *
+ *            +------------+   forward channel    +--------------+
+ *   IP  ---> | compressor | -------------------> | decompressor | ---> IP
+ *            +------------+  loss/delay/reorder  +--------------+
+ *                  ^                                     |
+ *                  |           feedback channel          |
+ *                  +-------------------------------------+
+ *                                loss/delay
+ *
+ * Checks
+ * ------
+ *
+ * The program checks that every packet successfully decompressed is the
+ * original one.
+ *
+ * Output
+ * ------
+ *
+ * The program outputs the time spent per packet by the compressor and by the
+ * decompressor, the size of the ROHC headers compared with the uncompressed
+ * headers, the statistics of both channels, and how long the decompressor
+ * took to recover from every context damage, ie. from the first packet that
+ * failed to be decompressed until the next one successfully decompressed.
+ */
+
+#include "config.h" /* for HAVE_*_H and PACKAGE_BUGREPORT */
+
+/* system includes */
+#if HAVE_WINSOCK2_H == 1
+#  include <winsock2.h> /* for ntohs() on Windows */
+#endif
+#if HAVE_ARPA_INET_H == 1
+#  include <arpa/inet.h> /* for ntohs() on Linux */
+#endif
+#include <time.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+/* includes for network headers */
+#include <protocols/ipv4.h>
+#include <protocols/ipv6.h>
+
+/* ROHC includes */
+#include <rohc/rohc.h>
+#include <rohc/rohc_comp.h>
+#include <rohc/rohc_decomp.h>
+
+/* include for the replay of the PCAP captures */
+#include "pcap_mmap.h"
+
+
+/** The maximal size for the ROHC and IP packets */
+#define MAX_ROHC_SIZE  (5 * 1024)
+
+/** The length of the Linux Cooked Sockets header */
+#define LINUX_COOKED_HDR_LEN  16U
+
+/** The length (in bytes) of the Ethernet header */
+#define ETHER_HDR_LEN  14U
+
+/** The minimum Ethernet length (in bytes) */
+#define ETHER_FRAME_MIN_LEN  60U
+
+/** The maximum delay (in ticks) of the simulated channels */
+#define CHAN_DELAY_MAX  10000U
+
+
+/** The parameters of the simulation */
+struct chan_params
+{
+	rohc_cid_type_t cid_type;   /**< The type of CIDs */
+	size_t max_contexts;        /**< The maximum number of contexts */
+	rohc_mode_t mode;           /**< The mode of the decompressor */
+	size_t repeat_nr;           /**< The number of times to send the flow */
+	double loss;                /**< The loss rate of the forward channel (%) */
+	size_t delay;               /**< The delay of the forward channel (ticks) */
+	double reorder;             /**< The reordering rate of the forward channel (%) */
+	size_t reorder_depth;       /**< The maximum extra delay of reordered packets */
+	double feedback_loss;       /**< The loss rate of the feedback channel (%) */
+	size_t feedback_delay;      /**< The delay of the feedback channel (ticks) */
+	uint64_t interval_us;       /**< The duration of one tick (microseconds) */
+	bool use_rate_limits;       /**< Whether to change the feedback rate limits */
+	size_t rate_limits[6];      /**< The feedback rate limits k, n, k1, n1, k2, n2 */
+	uint64_t seed;              /**< The seed of the pseudo-random generator */
+};
+
+
+/** The flow of packets loaded in memory before the simulation */
+struct chan_packets
+{
+	struct pcap_mmap capture;  /**< The capture mapped in memory */
+	struct rohc_buf *bufs;     /**< The packets, pointing into the capture */
+	size_t bufs_nr;            /**< The number of packets */
+};
+
+
+/** One packet in transit on a simulated channel */
+struct chan_item
+{
+	uint64_t due;       /**< The tick when the packet reaches its destination */
+	uint64_t seq;       /**< The order of the packet on the channel */
+	size_t packet_idx;  /**< The index of the original IP packet */
+	size_t len;         /**< The length of the packet */
+	uint8_t *data;      /**< The data of the packet */
+};
+
+
+/** One simulated channel */
+struct chan_queue
+{
+	struct chan_item *items;   /**< The packets in transit */
+	uint8_t *arena;            /**< The data of the packets in transit */
+	size_t items_max;          /**< The maximum number of packets in transit */
+	size_t items_nr;           /**< The number of packets in transit */
+	uint64_t next_seq;         /**< The order of the next packet */
+	unsigned long sent_nr;     /**< The number of packets sent */
+	unsigned long lost_nr;     /**< The number of packets lost */
+	unsigned long delayed_nr;  /**< The number of packets reordered */
+	unsigned long overflows_nr; /**< The packets dropped because of no room */
+};
+
+
+/** The results of the simulation */
+struct chan_stats
+{
+	unsigned long comp_nr;        /**< The number of compressed packets */
+	uint64_t comp_ns;             /**< The time spent by the compressor */
+	unsigned long decomp_nr;      /**< The number of packets given to the decompressor */
+	uint64_t decomp_ns;           /**< The time spent by the decompressor */
+	unsigned long decomp_ok_nr;   /**< The number of packets decompressed */
+	unsigned long decomp_bad_nr;  /**< The packets decompressed with errors */
+	unsigned long feedback_ok_nr; /**< The feedback accepted by the compressor */
+	unsigned long feedback_ko_nr; /**< The feedback rejected by the compressor */
+	uint64_t uncomp_hdr_bytes;    /**< The bytes of uncompressed headers */
+	uint64_t comp_hdr_bytes;      /**< The bytes of compressed headers */
+	uint64_t uncomp_bytes;        /**< The bytes of uncompressed packets */
+	uint64_t comp_bytes;          /**< The bytes of compressed packets */
+	unsigned long damages_nr;     /**< The number of context damages */
+	unsigned long damaged_nr;     /**< The packets that failed to be decompressed */
+	uint64_t recovery_ticks;      /**< The total duration of the recoveries */
+	uint64_t recovery_ticks_max;  /**< The longest recovery */
+	unsigned long recovery_pkts_max; /**< The most packets failed in one damage */
+	bool is_damaged;              /**< Whether the context is damaged at the end */
+	rohc_mode_t comp_mode;        /**< The mode of the compressor at the end */
+};
+
+
+/* prototypes of private functions */
+static void usage(void);
+static bool parse_rate_limits(const char *const list,
+                              size_t rate_limits[6])
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static bool load_packets(const char *const filename,
+                         struct chan_packets *const packets)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static void free_packets(struct chan_packets *const packets)
+	__attribute__((nonnull(1)));
+static bool run_simulation(const struct chan_params *const params,
+                           const struct chan_packets *const packets,
+                           struct chan_stats *const stats)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+static void print_stats(const struct chan_params *const params,
+                        const struct chan_queue *const forward,
+                        const struct chan_queue *const feedback,
+                        const struct chan_stats *const stats)
+	__attribute__((nonnull(1, 2, 3, 4)));
+
+static bool chan_queue_init(struct chan_queue *const queue,
+                            const size_t items_max)
+	__attribute__((warn_unused_result, nonnull(1)));
+static void chan_queue_free(struct chan_queue *const queue)
+	__attribute__((nonnull(1)));
+static void chan_queue_send(struct chan_queue *const queue,
+                            const uint64_t now,
+                            const size_t delay,
+                            const double loss,
+                            const double reorder,
+                            const size_t reorder_depth,
+                            const size_t packet_idx,
+                            const struct rohc_buf packet,
+                            uint64_t *const rand_state)
+	__attribute__((nonnull(1, 9)));
+static bool chan_queue_recv(struct chan_queue *const queue,
+                            const uint64_t now,
+                            struct chan_item *const item)
+	__attribute__((warn_unused_result, nonnull(1, 3)));
+
+static uint64_t chan_now_ns(void)
+	__attribute__((warn_unused_result));
+static uint64_t chan_rand(uint64_t *const rand_state)
+	__attribute__((warn_unused_result, nonnull(1)));
+static bool chan_rand_percent(uint64_t *const rand_state, const double percent)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+static void print_rohc_traces(void *const priv_ctxt,
+                              const rohc_trace_level_t level,
+                              const rohc_trace_entity_t entity,
+                              const int profile,
+                              const char *const format,
+                              ...)
+	__attribute__((format(printf, 5, 6), nonnull(5)));
+
+static int gen_false_random_num(const struct rohc_comp *const comp,
+                                void *const user_context)
+	__attribute__((nonnull(1)));
+
+static bool rohc_comp_rtp_cb(const unsigned char *const ip,
+                             const unsigned char *const udp,
+                             const unsigned char *const payload,
+                             const unsigned int payload_size,
+                             void *const rtp_private)
+	__attribute__((warn_unused_result));
+
+
+/** Whether the application runs in verbose mode or not */
+static bool is_verbose = false;
+
+
+/**
+ * @brief Main function for the ROHC channel benchmark
+ *
+ * @param argc The number of program arguments
+ * @param argv The program arguments
+ * @return     The unix return code:
+ *              \li 0 in case of success,
+ *              \li 1 in case of failure
+ */
+int main(int argc, char *argv[])
+{
+	struct chan_params params = {
+		.max_contexts = ROHC_SMALL_CID_MAX + 1,
+		.mode = ROHC_O_MODE,
+		.repeat_nr = 1,
+		.loss = 0.0,
+		.delay = 0,
+		.reorder = 0.0,
+		.reorder_depth = 3,
+		.feedback_loss = 0.0,
+		.feedback_delay = 0,
+		.interval_us = 20000,
+		.use_rate_limits = false,
+		.seed = 1,
+	};
+	struct chan_packets packets;
+	struct chan_stats stats;
+	char *cid_type_name = NULL;
+	char *filename = NULL;
+	int is_failure = 1;
+	int args_used;
+
+	/* parse program arguments, print the help message in case of failure */
+	if(argc <= 1)
+	{
+		usage();
+		goto error;
+	}
+
+	for(argc--, argv++; argc > 0; argc -= args_used, argv += args_used)
+	{
+		args_used = 1;
+
+		if(!strcmp(*argv, "-v") || !strcmp(*argv, "--version"))
+		{
+			/* print version */
+			printf("rohc_test_channel version %s\n", rohc_version());
+			goto error;
+		}
+		else if(!strcmp(*argv, "-h") || !strcmp(*argv, "--help"))
+		{
+			/* print help */
+			usage();
+			goto error;
+		}
+		else if(!strcmp(*argv, "--verbose"))
+		{
+			/* enable verbose mode */
+			is_verbose = true;
+		}
+		else if(argc <= 1 && !strncmp(*argv, "--", 2))
+		{
+			/* all the other options take one argument */
+			fprintf(stderr, "option %s requires an argument\n", *argv);
+			goto error;
+		}
+		else if(!strcmp(*argv, "--mode"))
+		{
+			/* get the mode of the decompressor */
+			if(!strcmp(argv[1], "u") || !strcmp(argv[1], "U"))
+			{
+				params.mode = ROHC_U_MODE;
+			}
+			else if(!strcmp(argv[1], "o") || !strcmp(argv[1], "O"))
+			{
+				params.mode = ROHC_O_MODE;
+			}
+			else
+			{
+				fprintf(stderr, "invalid mode '%s', only 'u' and 'o' "
+				        "expected\n", argv[1]);
+				goto error;
+			}
+			args_used++;
+		}
+		else if(!strcmp(*argv, "--max-contexts"))
+		{
+			/* get the maximum number of contexts */
+			const int max_contexts = atoi(argv[1]);
+			if(max_contexts < 1 || (size_t) max_contexts > (ROHC_LARGE_CID_MAX + 1))
+			{
+				fprintf(stderr, "the maximum number of contexts shall be between "
+				        "1 and %u\n", ROHC_LARGE_CID_MAX + 1);
+				goto error;
+			}
+			params.max_contexts = max_contexts;
+			args_used++;
+		}
+		else if(!strcmp(*argv, "--repeat"))
+		{
+			/* get the number of times to send the flow */
+			const int repeat_nr = atoi(argv[1]);
+			if(repeat_nr < 1)
+			{
+				fprintf(stderr, "the number of repetitions shall be at least 1\n");
+				goto error;
+			}
+			params.repeat_nr = repeat_nr;
+			args_used++;
+		}
+		else if(!strcmp(*argv, "--loss") || !strcmp(*argv, "--reorder") ||
+		        !strcmp(*argv, "--feedback-loss"))
+		{
+			/* get the loss or reordering rate of one channel */
+			const double percent = strtod(argv[1], NULL);
+			if(!(percent >= 0.0 && percent <= 100.0))
+			{
+				fprintf(stderr, "the rate of option %s shall be between 0 and "
+				        "100\n", *argv);
+				goto error;
+			}
+			if(!strcmp(*argv, "--loss"))
+			{
+				params.loss = percent;
+			}
+			else if(!strcmp(*argv, "--reorder"))
+			{
+				params.reorder = percent;
+			}
+			else
+			{
+				params.feedback_loss = percent;
+			}
+			args_used++;
+		}
+		else if(!strcmp(*argv, "--delay") || !strcmp(*argv, "--feedback-delay") ||
+		        !strcmp(*argv, "--reorder-depth"))
+		{
+			/* get the delay of one channel */
+			const int delay = atoi(argv[1]);
+			if(delay < 0 || delay > (int) CHAN_DELAY_MAX)
+			{
+				fprintf(stderr, "the delay of option %s shall be between 0 and "
+				        "%u\n", *argv, CHAN_DELAY_MAX);
+				goto error;
+			}
+			if(!strcmp(*argv, "--delay"))
+			{
+				params.delay = delay;
+			}
+			else if(!strcmp(*argv, "--feedback-delay"))
+			{
+				params.feedback_delay = delay;
+			}
+			else
+			{
+				params.reorder_depth = delay;
+			}
+			args_used++;
+		}
+		else if(!strcmp(*argv, "--interval"))
+		{
+			/* get the duration of one tick */
+			const int interval_us = atoi(argv[1]);
+			if(interval_us < 1)
+			{
+				fprintf(stderr, "the interval shall be at least 1 microsecond\n");
+				goto error;
+			}
+			params.interval_us = interval_us;
+			args_used++;
+		}
+		else if(!strcmp(*argv, "--rate-limits"))
+		{
+			/* get the rate limits of the feedback */
+			if(!parse_rate_limits(argv[1], params.rate_limits))
+			{
+				fprintf(stderr, "invalid rate limits, expected K,N,K1,N1,K2,N2\n");
+				goto error;
+			}
+			params.use_rate_limits = true;
+			args_used++;
+		}
+		else if(!strcmp(*argv, "--seed"))
+		{
+			/* get the seed of the pseudo-random generator */
+			params.seed = strtoull(argv[1], NULL, 0);
+			args_used++;
+		}
+		else if(cid_type_name == NULL)
+		{
+			/* get the type of CID to use within the ROHC library */
+			cid_type_name = argv[0];
+		}
+		else if(filename == NULL)
+		{
+			/* get the name of the file that contains the flow */
+			filename = argv[0];
+		}
+		else
+		{
+			/* do not accept more than 2 arguments without option name */
+			usage();
+			goto error;
+		}
+	}
+
+	/* check CID type */
+	if(cid_type_name == NULL || filename == NULL)
+	{
+		fprintf(stderr, "missing CID type or flow\n");
+		usage();
+		goto error;
+	}
+	else if(!strcmp(cid_type_name, "smallcid"))
+	{
+		params.cid_type = ROHC_SMALL_CID;
+		if(params.max_contexts > (ROHC_SMALL_CID_MAX + 1))
+		{
+			fprintf(stderr, "the maximum number of contexts shall be at most %u "
+			        "with small CIDs\n", ROHC_SMALL_CID_MAX + 1);
+			goto error;
+		}
+	}
+	else if(!strcmp(cid_type_name, "largecid"))
+	{
+		params.cid_type = ROHC_LARGE_CID;
+	}
+	else
+	{
+		fprintf(stderr, "invalid CID type '%s', only 'smallcid' and 'largecid' "
+		        "expected\n", cid_type_name);
+		goto error;
+	}
+
+	/* load the flow of IP packets in memory */
+	if(!load_packets(filename, &packets))
+	{
+		fprintf(stderr, "failed to load the packets of '%s'\n", filename);
+		goto error;
+	}
+	if(packets.bufs_nr == 0)
+	{
+		fprintf(stderr, "no packet in '%s'\n", filename);
+		goto free_packets;
+	}
+
+	/* run the simulation */
+	if(!run_simulation(&params, &packets, &stats))
+	{
+		fprintf(stderr, "simulation failed\n");
+		goto free_packets;
+	}
+
+	is_failure = 0;
+
+free_packets:
+	free_packets(&packets);
+error:
+	return is_failure;
+}
+
+
+/**
+ * @brief Print usage of the channel benchmark application
+ */
+static void usage(void)
+{
+	printf("Benchmark the ROHC library through a simulated lossy channel with\n"
+	       "feedback\n"
+	       "\n"
+	       "Usage: rohc_test_channel [General options]\n"
+	       "   or: rohc_test_channel [Channel options] CID_TYPE FLOW\n"
+	       "\n"
+	       "Options:\n"
+	       "General options:\n"
+	       "  -h, --help              Print this usage and exit\n"
+	       "  -v, --version           Print the application version and exit\n"
+	       "      --verbose           Print the traces of the library\n"
+	       "ROHC options:\n"
+	       "      --mode MODE         The mode of the decompressor among 'u'\n"
+	       "                          and 'o' (default: o)\n"
+	       "      --max-contexts NUM  The maximum number of ROHC contexts\n"
+	       "                          (default: 16)\n"
+	       "      --rate-limits K,N,K1,N1,K2,N2\n"
+	       "                          The rate limits of the feedback of the\n"
+	       "                          decompressor\n"
+	       "Channel options:\n"
+	       "      --loss PERCENT      The loss rate of the forward channel\n"
+	       "      --delay NUM         The delay (in packets) of the forward\n"
+	       "                          channel\n"
+	       "      --reorder PERCENT   The rate of packets that the forward\n"
+	       "                          channel delays more than the others\n"
+	       "      --reorder-depth NUM The maximum extra delay (in packets) of\n"
+	       "                          the reordered packets (default: 3)\n"
+	       "      --feedback-loss PERCENT\n"
+	       "                          The loss rate of the feedback channel\n"
+	       "      --feedback-delay NUM\n"
+	       "                          The delay (in packets) of the feedback\n"
+	       "                          channel\n"
+	       "      --interval USEC     The time between two packets, in\n"
+	       "                          microseconds (default: 20000)\n"
+	       "      --repeat NUM        Send the flow NUM times in a row\n"
+	       "      --seed NUM          The seed of the pseudo-random generator\n"
+	       "                          (default: 1)\n"
+	       "Mandatory parameters:\n"
+	       "  CID_TYPE                The type of CID to use among 'smallcid'\n"
+	       "                          and 'largecid'\n"
+	       "  FLOW                    The flow of IP packets to send (in PCAP\n"
+	       "                          format)\n"
+	       "\n"
+	       "Examples:\n"
+	       "  rohc_test_channel --loss 1 --delay 5 --feedback-delay 5 \\\n"
+	       "    smallcid voip.pcap    Send the VoIP stream through a channel\n"
+	       "                          that loses 1%% of the packets, with a\n"
+	       "                          round-trip time of 10 packets\n"
+	       "  rohc_test_channel --mode u --loss 5 --reorder 2 --repeat 10 \\\n"
+	       "    smallcid voip.pcap    Compare with the unidirectional mode on a\n"
+	       "                          channel that loses and reorders packets\n"
+	       "\n"
+	       "Report bugs to <" PACKAGE_BUGREPORT ">.\n");
+}
+
+
+/**
+ * @brief Parse the rate limits of the feedback
+ *
+ * @param list         The comma-separated list of the 6 rate limits
+ * @param rate_limits  OUT: The rate limits k, n, k1, n1, k2, n2
+ * @return             true if the list is valid, false otherwise
+ */
+static bool parse_rate_limits(const char *const list,
+                              size_t rate_limits[6])
+{
+	const char *item = list;
+	size_t i;
+
+	for(i = 0; i < 6; i++)
+	{
+		char *item_end;
+
+		rate_limits[i] = strtoul(item, &item_end, 10);
+		if(item_end == item ||
+		   (i < 5 && *item_end != ',') ||
+		   (i == 5 && *item_end != '\0'))
+		{
+			goto error;
+		}
+		item = item_end + 1;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Load the whole flow of IP packets in memory
+ *
+ * The capture is mapped in memory and the packets point into the mapping,
+ * they are never copied.
+ *
+ * @param filename  The name of the PCAP file that contains the packets
+ * @param packets   OUT: the packets loaded in memory, to release with
+ *                  \ref free_packets
+ * @return          true if the packets were successfully loaded,
+ *                  false otherwise
+ */
+static bool load_packets(const char *const filename,
+                         struct chan_packets *const packets)
+{
+	const struct rohc_ts arrival_time = { .sec = 0, .nsec = 0 };
+	char errbuf[PCAP_MMAP_ERRBUF_SIZE];
+	size_t link_len;
+	struct rohc_buf frame;
+	size_t wire_len;
+	size_t bufs_max = 0;
+
+	packets->bufs = NULL;
+	packets->bufs_nr = 0;
+
+	/* map the PCAP file that contains the stream */
+	if(!pcap_mmap_open(&packets->capture, filename, errbuf))
+	{
+		fprintf(stderr, "failed to open the pcap file: %s\n", errbuf);
+		goto error;
+	}
+
+	/* link layer in the capture must be Ethernet */
+	if(packets->capture.linktype == PCAP_MMAP_LINKTYPE_ETHERNET)
+	{
+		link_len = ETHER_HDR_LEN;
+	}
+	else if(packets->capture.linktype == PCAP_MMAP_LINKTYPE_LINUX_SLL)
+	{
+		link_len = LINUX_COOKED_HDR_LEN;
+	}
+	else if(packets->capture.linktype == PCAP_MMAP_LINKTYPE_RAW)
+	{
+		link_len = 0;
+	}
+	else
+	{
+		fprintf(stderr, "link layer type %u not supported in capture "
+		        "(supported = %u, %u, %u)\n", packets->capture.linktype,
+		        PCAP_MMAP_LINKTYPE_ETHERNET, PCAP_MMAP_LINKTYPE_LINUX_SLL,
+		        PCAP_MMAP_LINKTYPE_RAW);
+		goto close_input;
+	}
+
+	/* for each packet in the dump */
+	while(pcap_mmap_next(&packets->capture, &frame, &wire_len))
+	{
+		const unsigned long num_packet = packets->bufs_nr + 1;
+		const uint8_t *const packet = rohc_buf_data(frame);
+		size_t len;
+
+		/* check Ethernet frame length */
+		if(wire_len <= link_len || wire_len != frame.len ||
+		   (wire_len - link_len) > MAX_ROHC_SIZE)
+		{
+			fprintf(stderr, "packet %lu: bad PCAP packet (len = %zu, caplen = "
+			        "%zu)\n", num_packet, wire_len, frame.len);
+			goto free_packets;
+		}
+
+		/* skip the link layer header */
+		len = frame.len - link_len;
+
+		/* check for padding after the IP packet in the Ethernet payload */
+		if(link_len == ETHER_HDR_LEN && wire_len == ETHER_FRAME_MIN_LEN)
+		{
+			const uint8_t *const ip = packet + link_len;
+			const uint8_t ip_version = (ip[0] >> 4) & 0x0f;
+			size_t tot_len;
+
+			/* determine the total length of the IP packet */
+			if(ip_version == 4) /* IPv4 */
+			{
+				const struct ipv4_hdr *const ipv4 = (struct ipv4_hdr *) ip;
+				tot_len = ntohs(ipv4->tot_len);
+			}
+			else if(ip_version == 6) /* IPv6 */
+			{
+				const struct ipv6_hdr *const ipv6 = (struct ipv6_hdr *) ip;
+				tot_len = sizeof(struct ipv6_hdr) + ntohs(ipv6->plen);
+			}
+			else /* unknown IP version */
+			{
+				fprintf(stderr, "packet %lu: bad IP version (0x%x) "
+				        "in packet\n", num_packet, ip_version);
+				goto free_packets;
+			}
+
+			/* update the length of the IP packet if padding is present */
+			if(tot_len < len)
+			{
+				len = tot_len;
+			}
+		}
+
+		/* make room for the new packet */
+		if(packets->bufs_nr >= bufs_max)
+		{
+			const size_t new_max = (bufs_max == 0 ? 1024 : bufs_max * 2);
+			struct rohc_buf *const new_bufs =
+				realloc(packets->bufs, new_max * sizeof(struct rohc_buf));
+			if(new_bufs == NULL)
+			{
+				fprintf(stderr, "failed to allocate memory for %zu packets\n",
+				        new_max);
+				goto free_packets;
+			}
+			packets->bufs = new_bufs;
+			bufs_max = new_max;
+		}
+
+		/* point the packet into the mapping */
+		packets->bufs[packets->bufs_nr] = (struct rohc_buf)
+			rohc_buf_init_full(rohc_buf_data(frame) + link_len, len, arrival_time);
+		packets->bufs_nr++;
+	}
+
+	return true;
+
+free_packets:
+	free(packets->bufs);
+	packets->bufs = NULL;
+	packets->bufs_nr = 0;
+close_input:
+	pcap_mmap_close(&packets->capture);
+error:
+	return false;
+}
+
+
+/**
+ * @brief Release the packets loaded in memory
+ *
+ * @param packets  The packets loaded by \ref load_packets
+ */
+static void free_packets(struct chan_packets *const packets)
+{
+	free(packets->bufs);
+	packets->bufs = NULL;
+	pcap_mmap_close(&packets->capture);
+	packets->bufs_nr = 0;
+}
+
+
+/**
+ * @brief Run the compressor and the decompressor through the simulated
+ *        channels
+ *
+ * @param params   The parameters of the simulation
+ * @param packets  The IP packets to send
+ * @param stats    OUT: The results of the simulation
+ * @return         true in case of success, false otherwise
+ */
+static bool run_simulation(const struct chan_params *const params,
+                           const struct chan_packets *const packets,
+                           struct chan_stats *const stats)
+{
+	const uint64_t total_nr = packets->bufs_nr * params->repeat_nr;
+	/* at every tick, the forward channel delivers at most one packet per
+	 * possible delay, and every delivered packet may generate feedback */
+	const size_t forward_max = params->delay + params->reorder_depth + 1;
+	const size_t feedback_max =
+		(params->feedback_delay + 1) * (params->reorder_depth + 1);
+	uint64_t rand_state = (params->seed != 0 ? params->seed : 1);
+	struct chan_queue forward;
+	struct chan_queue feedback;
+	struct rohc_comp *comp;
+	struct rohc_decomp *decomp;
+	uint64_t damage_tick = 0;
+	unsigned long damage_pkts = 0;
+	uint64_t tick;
+	bool is_success = false;
+
+	memset(stats, 0, sizeof(struct chan_stats));
+
+	/* create the simulated channels */
+	if(!chan_queue_init(&forward, forward_max))
+	{
+		fprintf(stderr, "failed to create the forward channel\n");
+		goto error;
+	}
+	if(!chan_queue_init(&feedback, feedback_max))
+	{
+		fprintf(stderr, "failed to create the feedback channel\n");
+		goto free_forward;
+	}
+
+	/* create the compressor */
+	comp = rohc_comp_new2(params->cid_type, params->max_contexts - 1,
+	                      gen_false_random_num, NULL);
+	if(comp == NULL)
+	{
+		fprintf(stderr, "cannot create the compressor\n");
+		goto free_feedback;
+	}
+	if(!rohc_comp_set_traces_cb2(comp, print_rohc_traces, NULL))
+	{
+		fprintf(stderr, "failed to set the callback for traces on "
+		        "compressor\n");
+		goto free_comp;
+	}
+	if(!rohc_comp_enable_profiles(comp, ROHC_PROFILE_UNCOMPRESSED,
+	                              ROHC_PROFILE_UDP, ROHC_PROFILE_IP,
+	                              ROHC_PROFILE_UDPLITE, ROHC_PROFILE_RTP,
+	                              ROHC_PROFILE_ESP, ROHC_PROFILE_TCP, -1))
+	{
+		fprintf(stderr, "failed to enable the compression profiles\n");
+		goto free_comp;
+	}
+	if(!rohc_comp_set_rtp_detection_cb(comp, rohc_comp_rtp_cb, NULL))
+	{
+		fprintf(stderr, "failed to set RTP detection callback on compressor\n");
+		goto free_comp;
+	}
+
+	/* create the decompressor */
+	decomp = rohc_decomp_new2(params->cid_type, params->max_contexts - 1,
+	                          params->mode);
+	if(decomp == NULL)
+	{
+		fprintf(stderr, "cannot create the decompressor\n");
+		goto free_comp;
+	}
+	if(!rohc_decomp_set_traces_cb2(decomp, print_rohc_traces, NULL))
+	{
+		fprintf(stderr, "failed to set the callback for traces on "
+		        "decompressor\n");
+		goto free_decomp;
+	}
+	if(!rohc_decomp_enable_profiles(decomp, ROHC_PROFILE_UNCOMPRESSED,
+	                                ROHC_PROFILE_UDP, ROHC_PROFILE_IP,
+	                                ROHC_PROFILE_UDPLITE, ROHC_PROFILE_RTP,
+	                                ROHC_PROFILE_ESP, ROHC_PROFILE_TCP, -1))
+	{
+		fprintf(stderr, "failed to enable the decompression profiles\n");
+		goto free_decomp;
+	}
+	if(params->use_rate_limits &&
+	   !rohc_decomp_set_rate_limits(decomp, params->rate_limits[0],
+	                                params->rate_limits[1],
+	                                params->rate_limits[2],
+	                                params->rate_limits[3],
+	                                params->rate_limits[4],
+	                                params->rate_limits[5]))
+	{
+		fprintf(stderr, "failed to set the feedback rate limits\n");
+		goto free_decomp;
+	}
+
+	/* one packet is sent at every tick, then the channels are drained */
+	for(tick = 0; tick < total_nr || forward.items_nr > 0 ||
+	              feedback.items_nr > 0; tick++)
+	{
+		const uint64_t now_us = tick * params->interval_us;
+		const struct rohc_ts now = {
+			.sec = now_us / 1000000U,
+			.nsec = (now_us % 1000000U) * 1000U
+		};
+		struct chan_item item;
+
+		/* deliver the feedback that reached the compressor */
+		while(chan_queue_recv(&feedback, tick, &item))
+		{
+			const struct rohc_buf feedback_pkt =
+				rohc_buf_init_full(item.data, item.len, now);
+			uint64_t start_ns;
+			bool is_ok;
+
+			start_ns = chan_now_ns();
+			is_ok = rohc_comp_deliver_feedback2(comp, feedback_pkt);
+			stats->comp_ns += chan_now_ns() - start_ns;
+			if(is_ok)
+			{
+				stats->feedback_ok_nr++;
+			}
+			else
+			{
+				stats->feedback_ko_nr++;
+			}
+		}
+
+		/* compress the next IP packet, then send it on the forward channel */
+		if(tick < total_nr)
+		{
+			const size_t packet_idx = tick % packets->bufs_nr;
+			struct rohc_buf ip_packet = packets->bufs[packet_idx];
+			uint8_t rohc_buffer[MAX_ROHC_SIZE];
+			struct rohc_buf rohc_packet =
+				rohc_buf_init_empty(rohc_buffer, MAX_ROHC_SIZE);
+			rohc_comp_last_packet_info2_t info;
+			rohc_status_t status;
+			uint64_t start_ns;
+
+			ip_packet.time = now;
+			start_ns = chan_now_ns();
+			status = rohc_compress4(comp, ip_packet, &rohc_packet);
+			stats->comp_ns += chan_now_ns() - start_ns;
+			if(status != ROHC_STATUS_OK)
+			{
+				fprintf(stderr, "packet #%" PRIu64 ": compression failed\n",
+				        tick + 1);
+				goto free_decomp;
+			}
+			stats->comp_nr++;
+
+			/* account for the size of the headers */
+			info.version_major = 0;
+			info.version_minor = 0;
+			if(!rohc_comp_get_last_packet_info2(comp, &info))
+			{
+				fprintf(stderr, "packet #%" PRIu64 ": cannot get stats about "
+				        "the last compressed packet\n", tick + 1);
+				goto free_decomp;
+			}
+			stats->uncomp_hdr_bytes += info.header_last_uncomp_size;
+			stats->comp_hdr_bytes += info.header_last_comp_size;
+			stats->uncomp_bytes += info.total_last_uncomp_size;
+			stats->comp_bytes += info.total_last_comp_size;
+			stats->comp_mode = info.context_mode;
+
+			chan_queue_send(&forward, tick, params->delay, params->loss,
+			                params->reorder, params->reorder_depth, packet_idx,
+			                rohc_packet, &rand_state);
+		}
+
+		/* decompress the ROHC packets that reached the decompressor, then send
+		 * the feedback on the feedback channel */
+		while(chan_queue_recv(&forward, tick, &item))
+		{
+			const struct rohc_buf rohc_packet =
+				rohc_buf_init_full(item.data, item.len, now);
+			const struct rohc_buf *const orig = &packets->bufs[item.packet_idx];
+			uint8_t ip_buffer[MAX_ROHC_SIZE];
+			struct rohc_buf ip_packet = rohc_buf_init_empty(ip_buffer, MAX_ROHC_SIZE);
+			uint8_t feedback_buffer[MAX_ROHC_SIZE];
+			struct rohc_buf feedback_send =
+				rohc_buf_init_empty(feedback_buffer, MAX_ROHC_SIZE);
+			rohc_status_t status;
+			uint64_t start_ns;
+
+			start_ns = chan_now_ns();
+			status = rohc_decompress3(decomp, rohc_packet, &ip_packet, NULL,
+			                          &feedback_send);
+			stats->decomp_ns += chan_now_ns() - start_ns;
+			stats->decomp_nr++;
+
+			if(status == ROHC_STATUS_OK)
+			{
+				stats->decomp_ok_nr++;
+				if(ip_packet.len != orig->len ||
+				   memcmp(rohc_buf_data(ip_packet), rohc_buf_data(*orig),
+				          orig->len) != 0)
+				{
+					stats->decomp_bad_nr++;
+				}
+
+				/* the context is repaired */
+				if(stats->is_damaged)
+				{
+					const uint64_t recovery_ticks = tick - damage_tick;
+
+					stats->recovery_ticks += recovery_ticks;
+					if(recovery_ticks > stats->recovery_ticks_max)
+					{
+						stats->recovery_ticks_max = recovery_ticks;
+					}
+					if(damage_pkts > stats->recovery_pkts_max)
+					{
+						stats->recovery_pkts_max = damage_pkts;
+					}
+					stats->is_damaged = false;
+				}
+			}
+			else
+			{
+				/* the context is damaged, or still damaged */
+				if(!stats->is_damaged)
+				{
+					stats->is_damaged = true;
+					stats->damages_nr++;
+					damage_tick = tick;
+					damage_pkts = 0;
+				}
+				stats->damaged_nr++;
+				damage_pkts++;
+			}
+
+			if(feedback_send.len > 0)
+			{
+				chan_queue_send(&feedback, tick, params->feedback_delay,
+				                params->feedback_loss, 0.0, 0, 0, feedback_send,
+				                &rand_state);
+			}
+		}
+	}
+
+	print_stats(params, &forward, &feedback, stats);
+	is_success = true;
+
+free_decomp:
+	rohc_decomp_free(decomp);
+free_comp:
+	rohc_comp_free(comp);
+free_feedback:
+	chan_queue_free(&feedback);
+free_forward:
+	chan_queue_free(&forward);
+error:
+	return is_success;
+}
+
+
+/**
+ * @brief Print the results of the simulation
+ *
+ * @param params    The parameters of the simulation
+ * @param forward   The forward channel
+ * @param feedback  The feedback channel
+ * @param stats     The results of the simulation
+ */
+static void print_stats(const struct chan_params *const params,
+                        const struct chan_queue *const forward,
+                        const struct chan_queue *const feedback,
+                        const struct chan_stats *const stats)
+{
+	const double interval_ms = params->interval_us / 1000.0;
+	const unsigned long recoveries_nr =
+		stats->damages_nr - (stats->is_damaged ? 1 : 0);
+
+	printf("compressor:\n");
+	printf("  packets:             %lu\n", stats->comp_nr);
+	printf("  time per packet:     %.1f ns\n",
+	       stats->comp_nr == 0 ? 0.0 : ((double) stats->comp_ns) / stats->comp_nr);
+	printf("  packets per second:  %.0f\n",
+	       stats->comp_ns == 0 ? 0.0 : stats->comp_nr * 1e9 / stats->comp_ns);
+	printf("  final mode:          %s\n",
+	       stats->comp_mode == ROHC_O_MODE ? "O-mode" :
+	       (stats->comp_mode == ROHC_R_MODE ? "R-mode" : "U-mode"));
+	printf("  header bytes:        %" PRIu64 " -> %" PRIu64 " (%.1f%%)\n",
+	       stats->uncomp_hdr_bytes, stats->comp_hdr_bytes,
+	       stats->uncomp_hdr_bytes == 0 ? 0.0 :
+	       stats->comp_hdr_bytes * 100.0 / stats->uncomp_hdr_bytes);
+	printf("  header per packet:   %.2f -> %.2f bytes\n",
+	       stats->comp_nr == 0 ? 0.0 :
+	       ((double) stats->uncomp_hdr_bytes) / stats->comp_nr,
+	       stats->comp_nr == 0 ? 0.0 :
+	       ((double) stats->comp_hdr_bytes) / stats->comp_nr);
+	printf("  packet bytes:        %" PRIu64 " -> %" PRIu64 " (%.1f%%)\n",
+	       stats->uncomp_bytes, stats->comp_bytes,
+	       stats->uncomp_bytes == 0 ? 0.0 :
+	       stats->comp_bytes * 100.0 / stats->uncomp_bytes);
+	printf("  feedback accepted:   %lu\n", stats->feedback_ok_nr);
+	printf("  feedback rejected:   %lu\n", stats->feedback_ko_nr);
+
+	printf("forward channel:\n");
+	printf("  packets sent:        %lu\n", forward->sent_nr);
+	printf("  packets lost:        %lu\n", forward->lost_nr + forward->overflows_nr);
+	printf("  packets reordered:   %lu\n", forward->delayed_nr);
+
+	printf("decompressor:\n");
+	printf("  packets:             %lu\n", stats->decomp_nr);
+	printf("  time per packet:     %.1f ns\n",
+	       stats->decomp_nr == 0 ? 0.0 :
+	       ((double) stats->decomp_ns) / stats->decomp_nr);
+	printf("  packets per second:  %.0f\n",
+	       stats->decomp_ns == 0 ? 0.0 : stats->decomp_nr * 1e9 / stats->decomp_ns);
+	printf("  packets successful:  %lu\n", stats->decomp_ok_nr);
+	printf("  packets failed:      %lu\n", stats->damaged_nr);
+	printf("  packets corrupted:   %lu\n", stats->decomp_bad_nr);
+
+	printf("feedback channel:\n");
+	printf("  feedback sent:       %lu\n", feedback->sent_nr);
+	printf("  feedback lost:       %lu\n", feedback->lost_nr + feedback->overflows_nr);
+
+	printf("context damages:\n");
+	printf("  damages:             %lu\n", stats->damages_nr);
+	printf("  unrecovered at end:  %s\n", stats->is_damaged ? "yes" : "no");
+	if(stats->damages_nr > 0)
+	{
+		printf("  mean failed packets: %.1f\n",
+		       ((double) stats->damaged_nr) / stats->damages_nr);
+	}
+	if(recoveries_nr > 0)
+	{
+		printf("  mean recovery:       %.1f ms (%.1f packet intervals)\n",
+		       stats->recovery_ticks * interval_ms / recoveries_nr,
+		       ((double) stats->recovery_ticks) / recoveries_nr);
+		printf("  max recovery:        %.1f ms (%" PRIu64 " packet intervals)\n",
+		       stats->recovery_ticks_max * interval_ms,
+		       stats->recovery_ticks_max);
+		printf("  max failed packets:  %lu\n", stats->recovery_pkts_max);
+	}
+}
+
+
+/**
+ * @brief Create one simulated channel
+ *
+ * @param queue      The channel to create
+ * @param items_max  The maximum number of packets in transit
+ * @return           true in case of success, false otherwise
+ */
+static bool chan_queue_init(struct chan_queue *const queue,
+                            const size_t items_max)
+{
+	size_t i;
+
+	memset(queue, 0, sizeof(struct chan_queue));
+	queue->items_max = items_max;
+
+	queue->items = calloc(items_max, sizeof(struct chan_item));
+	if(queue->items == NULL)
+	{
+		goto error;
+	}
+	queue->arena = malloc(items_max * MAX_ROHC_SIZE);
+	if(queue->arena == NULL)
+	{
+		goto free_items;
+	}
+	for(i = 0; i < items_max; i++)
+	{
+		queue->items[i].data = queue->arena + i * MAX_ROHC_SIZE;
+	}
+
+	return true;
+
+free_items:
+	free(queue->items);
+error:
+	return false;
+}
+
+
+/**
+ * @brief Destroy one simulated channel
+ *
+ * @param queue  The channel to destroy
+ */
+static void chan_queue_free(struct chan_queue *const queue)
+{
+	free(queue->arena);
+	free(queue->items);
+}
+
+
+/**
+ * @brief Send one packet on one simulated channel
+ *
+ * @param queue          The channel
+ * @param now            The current tick
+ * @param delay          The delay of the channel (in ticks)
+ * @param loss           The loss rate of the channel (in percent)
+ * @param reorder        The reordering rate of the channel (in percent)
+ * @param reorder_depth  The maximum extra delay of reordered packets
+ * @param packet_idx     The index of the original IP packet
+ * @param packet         The packet to send
+ * @param rand_state     The state of the pseudo-random generator
+ */
+static void chan_queue_send(struct chan_queue *const queue,
+                            const uint64_t now,
+                            const size_t delay,
+                            const double loss,
+                            const double reorder,
+                            const size_t reorder_depth,
+                            const size_t packet_idx,
+                            const struct rohc_buf packet,
+                            uint64_t *const rand_state)
+{
+	struct chan_item *item;
+	uint64_t due = now + delay;
+
+	queue->sent_nr++;
+
+	if(chan_rand_percent(rand_state, loss))
+	{
+		queue->lost_nr++;
+		return;
+	}
+	if(reorder_depth > 0 && chan_rand_percent(rand_state, reorder))
+	{
+		due += 1 + (chan_rand(rand_state) % reorder_depth);
+		queue->delayed_nr++;
+	}
+	if(queue->items_nr >= queue->items_max || packet.len > MAX_ROHC_SIZE)
+	{
+		queue->overflows_nr++;
+		return;
+	}
+
+	item = &queue->items[queue->items_nr];
+	item->due = due;
+	item->seq = queue->next_seq;
+	item->packet_idx = packet_idx;
+	item->len = packet.len;
+	memcpy(item->data, rohc_buf_data(packet), packet.len);
+	queue->next_seq++;
+	queue->items_nr++;
+}
+
+
+/**
+ * @brief Receive the next packet that reached the end of one simulated
+ *        channel
+ *
+ * The packets are received in the order of their arrival, then in the order
+ * they were sent.
+ *
+ * @param queue  The channel
+ * @param now    The current tick
+ * @param item   OUT: The received packet, valid until the next packet is
+ *               sent on the channel
+ * @return       true if a packet was received, false if none reached the
+ *               end of the channel yet
+ */
+static bool chan_queue_recv(struct chan_queue *const queue,
+                            const uint64_t now,
+                            struct chan_item *const item)
+{
+	size_t best = queue->items_nr;
+	size_t i;
+
+	for(i = 0; i < queue->items_nr; i++)
+	{
+		const struct chan_item *const cur = &queue->items[i];
+
+		if(cur->due <= now &&
+		   (best == queue->items_nr ||
+		    cur->due < queue->items[best].due ||
+		    (cur->due == queue->items[best].due &&
+		     cur->seq < queue->items[best].seq)))
+		{
+			best = i;
+		}
+	}
+	if(best == queue->items_nr)
+	{
+		return false;
+	}
+
+	/* swap the received packet with the last one, so that its buffer stays
+	 * valid until the next packet is sent */
+	queue->items_nr--;
+	*item = queue->items[best];
+	queue->items[best] = queue->items[queue->items_nr];
+	queue->items[queue->items_nr] = *item;
+
+	return true;
+}
+
+
+/**
+ * @brief Get the current time of the monotonic clock
+ *
+ * @return  The current time (in nanoseconds)
+ */
+static uint64_t chan_now_ns(void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return ((uint64_t) now.tv_sec) * 1000000000U + now.tv_nsec;
+}
+
+
+/**
+ * @brief Get the next number of the pseudo-random generator
+ *
+ * The generator is a xorshift64* generator, so that the same seed always
+ * produces the same simulation whatever the platform.
+ *
+ * @param rand_state  The state of the pseudo-random generator, never zero
+ * @return            The next pseudo-random number
+ */
+static uint64_t chan_rand(uint64_t *const rand_state)
+{
+	*rand_state ^= *rand_state >> 12;
+	*rand_state ^= *rand_state << 25;
+	*rand_state ^= *rand_state >> 27;
+
+	return (*rand_state * 0x2545f4914f6cdd1dULL);
+}
+
+
+/**
+ * @brief Draw an event of the given probability
+ *
+ * @param rand_state  The state of the pseudo-random generator, never zero
+ * @param percent     The probability of the event (in percent)
+ * @return            true if the event occurs, false otherwise
+ */
+static bool chan_rand_percent(uint64_t *const rand_state, const double percent)
+{
+	if(percent <= 0.0)
+	{
+		return false;
+	}
+
+	return ((chan_rand(rand_state) >> 11) * (100.0 / 9007199254740992.0) <
+	        percent);
+}
+
+
+/**
+ * @brief Callback to print traces of the ROHC library
+ *
+ * @param priv_ctxt  An optional private context, may be NULL
+ * @param level      The priority level of the trace
+ * @param entity     The entity that emitted the trace among:
+ *                    \li ROHC_TRACE_COMP
+ *                    \li ROHC_TRACE_DECOMP
+ * @param profile    The ID of the ROHC compression/decompression profile
+ *                   the trace is related to
+ * @param format     The format string of the trace
+ */
+static void print_rohc_traces(void *const priv_ctxt __attribute__((unused)),
+                              const rohc_trace_level_t level,
+                              const rohc_trace_entity_t entity __attribute__((unused)),
+                              const int profile __attribute__((unused)),
+                              const char *const format,
+                              ...)
+{
+	if(is_verbose)
+	{
+		const char *level_descrs[] =
+		{
+			[ROHC_TRACE_DEBUG]   = "DEBUG",
+			[ROHC_TRACE_INFO]    = "INFO",
+			[ROHC_TRACE_WARNING] = "WARNING",
+			[ROHC_TRACE_ERROR]   = "ERROR"
+		};
+		va_list args;
+		fprintf(stderr, "[%s] ", level_descrs[level]);
+		va_start(args, format);
+		vfprintf(stderr, format, args);
+		va_end(args);
+	}
+}
+
+
+/**
+ * @brief Generate a false random number for testing the ROHC library
+ *
+ * @param comp          The ROHC compressor
+ * @param user_context  Should always be NULL
+ * @return              Always 0
+ */
+static int gen_false_random_num(const struct rohc_comp *const comp,
+                                void *const user_context)
+{
+	assert(comp != NULL);
+	assert(user_context == NULL);
+	return 0;
+}
+
+
+/**
+ * @brief The RTP detection callback
+ *
+ * @param ip           The innermost IP packet
+ * @param udp          The UDP header of the packet
+ * @param payload      The UDP payload of the packet
+ * @param payload_size The size of the UDP payload (in bytes)
+ * @return             true if the packet is an RTP packet, false otherwise
+ */
+static bool rohc_comp_rtp_cb(const unsigned char *const ip __attribute__((unused)),
+                             const unsigned char *const udp,
+                             const unsigned char *const payload __attribute__((unused)),
+                             const unsigned int payload_size __attribute__((unused)),
+                             void *const rtp_private __attribute__((unused)))
+{
+	const size_t default_rtp_ports_nr = 5;
+	unsigned int default_rtp_ports[] = { 1234, 36780, 33238, 5020, 5002 };
+	uint16_t udp_dport;
+	bool is_rtp = false;
+	size_t i;
+
+	if(udp == NULL)
+	{
+		return false;
+	}
+
+	/* get the UDP destination port */
+	memcpy(&udp_dport, udp + 2, sizeof(uint16_t));
+
+	/* is the UDP destination port in the list of ports reserved for RTP
+	 * traffic by default (for compatibility reasons) */
+	for(i = 0; i < default_rtp_ports_nr; i++)
+	{
+		if(ntohs(udp_dport) == default_rtp_ports[i])
+		{
+			is_rtp = true;
+			break;
+		}
+	}
+
+	return is_rtp;
+}
+
@@ -0,0 +1,924 @@
+/*
+ * Copyright 2026 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file    test_churn.c
+ * @brief   ROHC context churn benchmark
+ * @author  Didier Barvaux <didier@barvaux.org>
+ *
+ * Introduction
+ * ------------
+ *
+ * The program measures how many new flows per second the ROHC library is
+ * able to handle when flows constantly appear and disappear, as on a mobile
+ * edge router.
+ *
+ * Details
+ * -------
+ *
+ * For every MAX_CID value, the program defines one compressor and one
+ * decompressor and sends them the packets of short-lived flows back to back.
+ * The flows are synthetic: every flow sends a few packets, then the next flow
+ * starts. All the contexts are used first without measuring anything, so
+ * that every new flow then forces the compressor to recycle its least
+ * recently used context.
+ *
+ * Every generation of MAX_CID + 1 flows uses the next profile of the list
+ * given with the --profiles option, so that the IR packet of a new flow
+ * redefines the profile of the decompression context it replaces: the
+ * decompressor then destroys the old context and creates a new one. With
+ * a single profile, the decompressor re-initializes its contexts instead.
+ *
+ *                   +------------+            +--------------+
+ *   new flows ----> | compressor | ---------> | decompressor | ----> IP
+ *                   +------------+            +--------------+
+ *                ^                  ^      ^                    ^
+ *                |------------------|      |--------------------|
+ *                 compression time          decompression time
+ *
+ * Checks
+ * ------
+ *
+ * The program checks for the status of the (de)compression process and that
+ * every decompressed packet is the original one.
+ *
+ * Output
+ * ------
+ *
+ * For every MAX_CID value, the program outputs the number of new flows per
+ * second that the compressor, the decompressor and both together are able
+ * to handle, along with the time spent per flow.
+ */
+
+#include "config.h" /* for HAVE_*_H and PACKAGE_BUGREPORT */
+
+/* system includes */
+#if HAVE_WINSOCK2_H == 1
+#  include <winsock2.h> /* for htons() on Windows */
+#endif
+#if HAVE_ARPA_INET_H == 1
+#  include <arpa/inet.h> /* for htons() on Linux */
+#endif
+#include <time.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+/* includes for network headers */
+#include <ip.h> /* for IPv4 checksum */
+#include <protocols/ipv4.h>
+#include <protocols/udp.h>
+#include <protocols/rtp.h>
+#include <protocols/esp.h>
+
+/* ROHC includes */
+#include <rohc/rohc.h>
+#include <rohc/rohc_comp.h>
+#include <rohc/rohc_decomp.h>
+
+
+/** The maximal size for the ROHC and IP packets */
+#define MAX_ROHC_SIZE  (5 * 1024)
+
+/** The length (in bytes) of the payload of the generated packets */
+#define CHURN_PAYLOAD_LEN  20U
+
+/** The IP protocol number used by the flows without transport header */
+#define CHURN_IPPROTO_NONE  253
+
+/** The maximum number of profiles in the mix of flows */
+#define CHURN_PROFILES_MAX  4U
+
+/** The maximum number of MAX_CID values to test */
+#define CHURN_MAX_CIDS_MAX  16U
+
+
+/** The profiles of the generated flows */
+typedef enum
+{
+	CHURN_PROFILE_RTP = 0,  /**< IPv4/UDP/RTP flows */
+	CHURN_PROFILE_UDP = 1,  /**< IPv4/UDP flows */
+	CHURN_PROFILE_ESP = 2,  /**< IPv4/ESP flows */
+	CHURN_PROFILE_IP  = 3,  /**< IPv4-only flows */
+} churn_profile_t;
+
+/** The names of the profiles on the command line */
+static const char *const churn_profile_names[CHURN_PROFILES_MAX] =
+{
+	[CHURN_PROFILE_RTP] = "rtp",
+	[CHURN_PROFILE_UDP] = "udp",
+	[CHURN_PROFILE_ESP] = "esp",
+	[CHURN_PROFILE_IP]  = "ip",
+};
+
+
+/** The parameters of the benchmark */
+struct churn_params
+{
+	rohc_cid_type_t cid_type;      /**< The type of CIDs */
+	unsigned long flows_nr;        /**< The number of new flows to measure */
+	unsigned long packets_nr;      /**< The number of packets per flow */
+	churn_profile_t profiles[CHURN_PROFILES_MAX]; /**< The mix of profiles */
+	size_t profiles_nr;            /**< The number of profiles in the mix */
+};
+
+
+/** The results of the benchmark for one MAX_CID value */
+struct churn_result
+{
+	unsigned long flows_nr;    /**< The number of new flows measured */
+	unsigned long packets_nr;  /**< The number of packets measured */
+	uint64_t comp_ns;          /**< The time spent to compress */
+	uint64_t decomp_ns;        /**< The time spent to decompress */
+};
+
+
+/* prototypes of private functions */
+static void usage(void);
+static bool parse_profiles(const char *const list,
+                           struct churn_params *const params)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static bool parse_max_cids(const char *const list,
+                           size_t max_cids[CHURN_MAX_CIDS_MAX],
+                           size_t *const max_cids_nr)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+static bool test_churn(const struct churn_params *const params,
+                       const size_t max_cid,
+                       struct churn_result *const result)
+	__attribute__((warn_unused_result, nonnull(1, 3)));
+static bool churn_flow(struct rohc_comp *const comp,
+                       struct rohc_decomp *const decomp,
+                       const struct churn_params *const params,
+                       const unsigned long flow_id,
+                       const churn_profile_t profile,
+                       struct churn_result *const result)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 6)));
+static void churn_build_packet(const unsigned long flow_id,
+                               const churn_profile_t profile,
+                               const unsigned long counter,
+                               struct rohc_buf *const packet)
+	__attribute__((nonnull(4)));
+static uint64_t churn_now_ns(void)
+	__attribute__((warn_unused_result));
+
+static void print_rohc_traces(void *const priv_ctxt,
+                              const rohc_trace_level_t level,
+                              const rohc_trace_entity_t entity,
+                              const int profile,
+                              const char *const format,
+                              ...)
+	__attribute__((format(printf, 5, 6), nonnull(5)));
+
+static int gen_false_random_num(const struct rohc_comp *const comp,
+                                void *const user_context)
+	__attribute__((nonnull(1)));
+
+static bool rohc_comp_rtp_cb(const unsigned char *const ip,
+                             const unsigned char *const udp,
+                             const unsigned char *const payload,
+                             const unsigned int payload_size,
+                             void *const rtp_private)
+	__attribute__((warn_unused_result));
+
+
+/** Whether the application runs in verbose mode or not */
+static bool is_verbose = false;
+
+
+/**
+ * @brief Main function for the ROHC churn benchmark
+ *
+ * @param argc The number of program arguments
+ * @param argv The program arguments
+ * @return     The unix return code:
+ *              \li 0 in case of success,
+ *              \li 1 in case of failure
+ */
+int main(int argc, char *argv[])
+{
+	struct churn_params params = {
+		.flows_nr = 100000,
+		.packets_nr = 3,
+		.profiles = { CHURN_PROFILE_UDP, CHURN_PROFILE_RTP },
+		.profiles_nr = 2,
+	};
+	size_t max_cids[CHURN_MAX_CIDS_MAX];
+	size_t max_cids_nr = 0;
+	const char *max_cids_list = NULL;
+	char *cid_type_name = NULL;
+	int is_failure = 1;
+	int args_used;
+	size_t i;
+
+	/* parse program arguments, print the help message in case of failure */
+	if(argc <= 1)
+	{
+		usage();
+		goto error;
+	}
+
+	for(argc--, argv++; argc > 0; argc -= args_used, argv += args_used)
+	{
+		args_used = 1;
+
+		if(!strcmp(*argv, "-v") || !strcmp(*argv, "--version"))
+		{
+			/* print version */
+			printf("rohc_test_churn version %s\n", rohc_version());
+			goto error;
+		}
+		else if(!strcmp(*argv, "-h") || !strcmp(*argv, "--help"))
+		{
+			/* print help */
+			usage();
+			goto error;
+		}
+		else if(!strcmp(*argv, "--verbose"))
+		{
+			/* enable verbose mode */
+			is_verbose = true;
+		}
+		else if(!strcmp(*argv, "--max-cids"))
+		{
+			/* get the MAX_CID values to test */
+			if(argc <= 1)
+			{
+				usage();
+				goto error;
+			}
+			max_cids_list = argv[1];
+			args_used++;
+		}
+		else if(!strcmp(*argv, "--flows"))
+		{
+			/* get the number of new flows to measure */
+			const int flows_nr = (argc > 1 ? atoi(argv[1]) : 0);
+			if(flows_nr < 1)
+			{
+				fprintf(stderr, "the number of flows shall be at least 1\n");
+				goto error;
+			}
+			params.flows_nr = flows_nr;
+			args_used++;
+		}
+		else if(!strcmp(*argv, "--packets-per-flow"))
+		{
+			/* get the number of packets sent on every flow */
+			const int packets_nr = (argc > 1 ? atoi(argv[1]) : 0);
+			if(packets_nr < 1)
+			{
+				fprintf(stderr, "the number of packets per flow shall be at "
+				        "least 1\n");
+				goto error;
+			}
+			params.packets_nr = packets_nr;
+			args_used++;
+		}
+		else if(!strcmp(*argv, "--profiles"))
+		{
+			/* get the profiles of the flows */
+			if(argc <= 1 || !parse_profiles(argv[1], &params))
+			{
+				fprintf(stderr, "invalid list of profiles, expected a comma-"
+				        "separated list of at most %u profiles among rtp, udp, "
+				        "esp and ip\n", CHURN_PROFILES_MAX);
+				goto error;
+			}
+			args_used++;
+		}
+		else if(cid_type_name == NULL)
+		{
+			/* get the type of CID to use within the ROHC library */
+			cid_type_name = argv[0];
+		}
+		else
+		{
+			/* do not accept more than one argument without option name */
+			usage();
+			goto error;
+		}
+	}
+
+	/* check CID type */
+	if(cid_type_name == NULL)
+	{
+		fprintf(stderr, "missing CID type: smallcid or largecid\n");
+		usage();
+		goto error;
+	}
+	else if(!strcmp(cid_type_name, "smallcid"))
+	{
+		params.cid_type = ROHC_SMALL_CID;
+		if(max_cids_list == NULL)
+		{
+			max_cids_list = "15";
+		}
+	}
+	else if(!strcmp(cid_type_name, "largecid"))
+	{
+		params.cid_type = ROHC_LARGE_CID;
+		if(max_cids_list == NULL)
+		{
+			max_cids_list = "15,255,4095,16383";
+		}
+	}
+	else
+	{
+		fprintf(stderr, "invalid CID type '%s', only 'smallcid' and 'largecid' "
+		        "expected\n", cid_type_name);
+		goto error;
+	}
+
+	/* check the MAX_CID values */
+	if(!parse_max_cids(max_cids_list, max_cids, &max_cids_nr))
+	{
+		fprintf(stderr, "invalid list of MAX_CID values, expected a comma-"
+		        "separated list of at most %u values\n", CHURN_MAX_CIDS_MAX);
+		goto error;
+	}
+	for(i = 0; i < max_cids_nr; i++)
+	{
+		const size_t cid_max = (params.cid_type == ROHC_SMALL_CID ?
+		                        ROHC_SMALL_CID_MAX : ROHC_LARGE_CID_MAX);
+		if(max_cids[i] > cid_max)
+		{
+			fprintf(stderr, "MAX_CID %zu is too large for %s, it shall be at "
+			        "most %zu\n", max_cids[i], cid_type_name, cid_max);
+			goto error;
+		}
+	}
+
+	/* run the benchmark for every MAX_CID value */
+	printf("%lu new flows of %lu packets per MAX_CID value\n",
+	       params.flows_nr, params.packets_nr);
+	printf("%9s %15s %15s %15s %14s %14s\n", "MAX_CID", "comp flows/s",
+	       "decomp flows/s", "both flows/s", "comp ns/flow", "decomp ns/flow");
+	for(i = 0; i < max_cids_nr; i++)
+	{
+		struct churn_result result;
+		double comp_ns_per_flow;
+		double decomp_ns_per_flow;
+
+		if(!test_churn(&params, max_cids[i], &result))
+		{
+			fprintf(stderr, "benchmark failed for MAX_CID %zu\n", max_cids[i]);
+			goto error;
+		}
+		comp_ns_per_flow = ((double) result.comp_ns) / result.flows_nr;
+		decomp_ns_per_flow = ((double) result.decomp_ns) / result.flows_nr;
+
+		printf("%9zu %15.0f %15.0f %15.0f %14.1f %14.1f\n", max_cids[i],
+		       1e9 / comp_ns_per_flow, 1e9 / decomp_ns_per_flow,
+		       1e9 / (comp_ns_per_flow + decomp_ns_per_flow),
+		       comp_ns_per_flow, decomp_ns_per_flow);
+		fflush(stdout);
+	}
+
+	is_failure = 0;
+
+error:
+	return is_failure;
+}
+
+
+/**
+ * @brief Print usage of the churn benchmark application
+ */
+static void usage(void)
+{
+	printf("Benchmark the ROHC library with flows that constantly appear and\n"
+	       "disappear\n"
+	       "\n"
+	       "Usage: rohc_test_churn [General options]\n"
+	       "   or: rohc_test_churn [Benchmark options] CID_TYPE\n"
+	       "\n"
+	       "Options:\n"
+	       "General options:\n"
+	       "  -h, --help                Print this usage and exit\n"
+	       "  -v, --version             Print the application version and exit\n"
+	       "      --verbose             Print the traces of the library\n"
+	       "Benchmark options:\n"
+	       "      --max-cids LIST       The comma-separated MAX_CID values to\n"
+	       "                            test (default: 15 for smallcid,\n"
+	       "                            15,255,4095,16383 for largecid)\n"
+	       "      --flows NUM           The number of new flows measured for\n"
+	       "                            every MAX_CID value (default: 100000)\n"
+	       "      --packets-per-flow NUM\n"
+	       "                            The number of packets sent on every\n"
+	       "                            flow (default: 3)\n"
+	       "      --profiles LIST       The comma-separated profiles that the\n"
+	       "                            successive generations of flows use\n"
+	       "                            among rtp, udp, esp and ip\n"
+	       "                            (default: udp,rtp)\n"
+	       "Mandatory parameters:\n"
+	       "  CID_TYPE                  The type of CID to use among 'smallcid'\n"
+	       "                            and 'largecid'\n"
+	       "\n"
+	       "Examples:\n"
+	       "  rohc_test_churn largecid  Measure the new flows per second with\n"
+	       "                            large CIDs and several MAX_CID values\n"
+	       "  rohc_test_churn --max-cids 1023 --profiles rtp largecid\n"
+	       "                            Measure the new RTP flows per second\n"
+	       "                            with 1024 contexts\n"
+	       "\n"
+	       "Report bugs to <" PACKAGE_BUGREPORT ">.\n");
+}
+
+
+/**
+ * @brief Parse the profiles of the successive generations of flows
+ *
+ * @param list    The comma-separated list of profiles
+ * @param params  OUT: The parameters of the benchmark
+ * @return        true if the list is valid, false otherwise
+ */
+static bool parse_profiles(const char *const list,
+                           struct churn_params *const params)
+{
+	const char *item = list;
+	size_t profile;
+
+	params->profiles_nr = 0;
+
+	while(*item != '\0')
+	{
+		const size_t item_len = strcspn(item, ",");
+
+		for(profile = 0; profile < CHURN_PROFILES_MAX; profile++)
+		{
+			if(strlen(churn_profile_names[profile]) == item_len &&
+			   !strncmp(item, churn_profile_names[profile], item_len))
+			{
+				break;
+			}
+		}
+		if(profile == CHURN_PROFILES_MAX ||
+		   params->profiles_nr >= CHURN_PROFILES_MAX)
+		{
+			goto error;
+		}
+		params->profiles[params->profiles_nr] = profile;
+		params->profiles_nr++;
+
+		item += item_len;
+		if(*item == ',')
+		{
+			item++;
+		}
+	}
+
+	if(params->profiles_nr == 0)
+	{
+		goto error;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Parse the MAX_CID values to test
+ *
+ * @param list         The comma-separated list of MAX_CID values
+ * @param max_cids     OUT: The MAX_CID values
+ * @param max_cids_nr  OUT: The number of MAX_CID values
+ * @return             true if the list is valid, false otherwise
+ */
+static bool parse_max_cids(const char *const list,
+                           size_t max_cids[CHURN_MAX_CIDS_MAX],
+                           size_t *const max_cids_nr)
+{
+	const char *item = list;
+
+	*max_cids_nr = 0;
+
+	while(*item != '\0')
+	{
+		char *item_end;
+		unsigned long max_cid;
+
+		if(*max_cids_nr >= CHURN_MAX_CIDS_MAX)
+		{
+			goto error;
+		}
+		max_cid = strtoul(item, &item_end, 10);
+		if(item_end == item || (*item_end != ',' && *item_end != '\0'))
+		{
+			goto error;
+		}
+		max_cids[*max_cids_nr] = max_cid;
+		(*max_cids_nr)++;
+
+		item = item_end;
+		if(*item == ',')
+		{
+			item++;
+		}
+	}
+
+	if((*max_cids_nr) == 0)
+	{
+		goto error;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Measure the new flows per second for one MAX_CID value
+ *
+ * @param params   The parameters of the benchmark
+ * @param max_cid  The MAX_CID value of the compressor and decompressor
+ * @param result   OUT: The results of the benchmark
+ * @return         true in case of success, false otherwise
+ */
+static bool test_churn(const struct churn_params *const params,
+                       const size_t max_cid,
+                       struct churn_result *const result)
+{
+	const unsigned long contexts_nr = max_cid + 1;
+	struct churn_result warmup = { .flows_nr = 0 };
+	struct rohc_comp *comp;
+	struct rohc_decomp *decomp;
+	unsigned long flow_id;
+	bool is_success = false;
+
+	memset(result, 0, sizeof(struct churn_result));
+
+	/* create the compressor */
+	comp = rohc_comp_new2(params->cid_type, max_cid, gen_false_random_num, NULL);
+	if(comp == NULL)
+	{
+		fprintf(stderr, "cannot create the compressor\n");
+		goto error;
+	}
+	if(!rohc_comp_set_traces_cb2(comp, print_rohc_traces, NULL))
+	{
+		fprintf(stderr, "failed to set the callback for traces on "
+		        "compressor\n");
+		goto free_comp;
+	}
+	if(!rohc_comp_enable_profiles(comp, ROHC_PROFILE_UNCOMPRESSED,
+	                              ROHC_PROFILE_UDP, ROHC_PROFILE_IP,
+	                              ROHC_PROFILE_RTP, ROHC_PROFILE_ESP, -1))
+	{
+		fprintf(stderr, "failed to enable the compression profiles\n");
+		goto free_comp;
+	}
+	if(!rohc_comp_set_rtp_detection_cb(comp, rohc_comp_rtp_cb, NULL))
+	{
+		fprintf(stderr, "failed to set RTP detection callback on compressor\n");
+		goto free_comp;
+	}
+
+	/* create the decompressor */
+	decomp = rohc_decomp_new2(params->cid_type, max_cid, ROHC_U_MODE);
+	if(decomp == NULL)
+	{
+		fprintf(stderr, "cannot create the decompressor\n");
+		goto free_comp;
+	}
+	if(!rohc_decomp_set_traces_cb2(decomp, print_rohc_traces, NULL))
+	{
+		fprintf(stderr, "failed to set the callback for traces on "
+		        "decompressor\n");
+		goto free_decomp;
+	}
+	if(!rohc_decomp_enable_profiles(decomp, ROHC_PROFILE_UNCOMPRESSED,
+	                                ROHC_PROFILE_UDP, ROHC_PROFILE_IP,
+	                                ROHC_PROFILE_RTP, ROHC_PROFILE_ESP, -1))
+	{
+		fprintf(stderr, "failed to enable the decompression profiles\n");
+		goto free_decomp;
+	}
+
+	/* use all the contexts first, so that every measured flow recycles one;
+	 * every generation of flows switches to the next profile */
+	for(flow_id = 0; flow_id < (contexts_nr + params->flows_nr); flow_id++)
+	{
+		const size_t generation = flow_id / contexts_nr;
+		const churn_profile_t profile =
+			params->profiles[generation % params->profiles_nr];
+
+		if(!churn_flow(comp, decomp, params, flow_id, profile,
+		               flow_id < contexts_nr ? &warmup : result))
+		{
+			fprintf(stderr, "flow #%lu failed\n", flow_id);
+			goto free_decomp;
+		}
+	}
+
+	is_success = true;
+
+free_decomp:
+	rohc_decomp_free(decomp);
+free_comp:
+	rohc_comp_free(comp);
+error:
+	return is_success;
+}
+
+
+/**
+ * @brief Send the packets of one flow through the compressor and the
+ *        decompressor
+ *
+ * @param comp     The ROHC compressor
+ * @param decomp   The ROHC decompressor
+ * @param params   The parameters of the benchmark
+ * @param flow_id  The identifier of the flow
+ * @param profile  The profile of the flow
+ * @param result   IN/OUT: The results to update
+ * @return         true in case of success, false otherwise
+ */
+static bool churn_flow(struct rohc_comp *const comp,
+                       struct rohc_decomp *const decomp,
+                       const struct churn_params *const params,
+                       const unsigned long flow_id,
+                       const churn_profile_t profile,
+                       struct churn_result *const result)
+{
+	uint8_t ip_buffer[MAX_ROHC_SIZE];
+	uint8_t rohc_buffer[MAX_ROHC_SIZE];
+	uint8_t decomp_buffer[MAX_ROHC_SIZE];
+	unsigned long counter;
+	bool is_success = false;
+
+	for(counter = 1; counter <= params->packets_nr; counter++)
+	{
+		struct rohc_buf ip_packet =
+			rohc_buf_init_empty(ip_buffer, MAX_ROHC_SIZE);
+		struct rohc_buf rohc_packet =
+			rohc_buf_init_empty(rohc_buffer, MAX_ROHC_SIZE);
+		struct rohc_buf decomp_packet =
+			rohc_buf_init_empty(decomp_buffer, MAX_ROHC_SIZE);
+		rohc_status_t status;
+		uint64_t start_ns;
+		uint64_t comp_end_ns;
+		uint64_t decomp_end_ns;
+
+		churn_build_packet(flow_id, profile, counter, &ip_packet);
+
+		start_ns = churn_now_ns();
+		status = rohc_compress4(comp, ip_packet, &rohc_packet);
+		comp_end_ns = churn_now_ns();
+		if(status != ROHC_STATUS_OK)
+		{
+			fprintf(stderr, "packet #%lu of flow #%lu: compression failed\n",
+			        counter, flow_id);
+			goto error;
+		}
+		status = rohc_decompress3(decomp, rohc_packet, &decomp_packet,
+		                          NULL, NULL);
+		decomp_end_ns = churn_now_ns();
+		if(status != ROHC_STATUS_OK)
+		{
+			fprintf(stderr, "packet #%lu of flow #%lu: decompression failed\n",
+			        counter, flow_id);
+			goto error;
+		}
+
+		/* the decompressed packet shall be the original one */
+		if(decomp_packet.len != ip_packet.len ||
+		   memcmp(rohc_buf_data(decomp_packet), rohc_buf_data(ip_packet),
+		          ip_packet.len) != 0)
+		{
+			fprintf(stderr, "packet #%lu of flow #%lu: decompressed packet "
+			        "differs from the original one\n", counter, flow_id);
+			goto error;
+		}
+
+		result->packets_nr++;
+		result->comp_ns += comp_end_ns - start_ns;
+		result->decomp_ns += decomp_end_ns - comp_end_ns;
+	}
+	result->flows_nr++;
+
+	is_success = true;
+
+error:
+	return is_success;
+}
+
+
+/**
+ * @brief Build one packet of one flow
+ *
+ * The addresses, ports, SSRC and SPI of the flow are derived from its
+ * identifier, so that every flow uses its own context.
+ *
+ * @param flow_id  The identifier of the flow
+ * @param profile  The profile of the flow
+ * @param counter  The number of the packet in the flow, starting at 1
+ * @param packet   The empty buffer to build the packet in
+ */
+static void churn_build_packet(const unsigned long flow_id,
+                               const churn_profile_t profile,
+                               const unsigned long counter,
+                               struct rohc_buf *const packet)
+{
+	struct ipv4_hdr *const ipv4 = (struct ipv4_hdr *) rohc_buf_data(*packet);
+	uint8_t *const l4 = (uint8_t *) (ipv4 + 1);
+	size_t l4_hdr_len;
+	uint8_t protocol;
+	size_t i;
+
+	switch(profile)
+	{
+		case CHURN_PROFILE_RTP:
+			l4_hdr_len = sizeof(struct udphdr) + sizeof(struct rtphdr);
+			protocol = IPPROTO_UDP;
+			break;
+		case CHURN_PROFILE_UDP:
+			l4_hdr_len = sizeof(struct udphdr);
+			protocol = IPPROTO_UDP;
+			break;
+		case CHURN_PROFILE_ESP:
+			l4_hdr_len = sizeof(struct esphdr);
+			protocol = IPPROTO_ESP;
+			break;
+		case CHURN_PROFILE_IP:
+		default:
+			l4_hdr_len = 0;
+			protocol = CHURN_IPPROTO_NONE;
+			break;
+	}
+	packet->len = sizeof(struct ipv4_hdr) + l4_hdr_len + CHURN_PAYLOAD_LEN;
+
+	/* build IPv4 header, the flows differ by their source address */
+	ipv4->version = 4;
+	ipv4->ihl = 5;
+	ipv4->tos = 0;
+	ipv4->tot_len = htons(packet->len);
+	ipv4->id = htons(counter);
+	ipv4->frag_off = 0;
+	ipv4->ttl = 64;
+	ipv4->protocol = protocol;
+	ipv4->check = 0;
+	ipv4->saddr = htonl(0x0a000000 + (uint32_t) flow_id);
+	ipv4->daddr = htonl(0xc0a80002);
+	ipv4->check = ip_fast_csum((uint8_t *) ipv4, ipv4->ihl);
+
+	/* build transport headers */
+	if(profile == CHURN_PROFILE_RTP || profile == CHURN_PROFILE_UDP)
+	{
+		struct udphdr *const udp = (struct udphdr *) l4;
+
+		/* only the RTP flows use the destination port reserved for RTP */
+		udp->source = htons(1024 + (flow_id % 60000));
+		udp->dest = htons(profile == CHURN_PROFILE_RTP ? 1234 : 4321);
+		udp->len = htons(l4_hdr_len + CHURN_PAYLOAD_LEN);
+		udp->check = 0; /* UDP checksum disabled */
+
+		if(profile == CHURN_PROFILE_RTP)
+		{
+			struct rtphdr *const rtp = (struct rtphdr *) (udp + 1);
+
+			rtp->version = 2;
+			rtp->padding = 0;
+			rtp->extension = 0;
+			rtp->cc = 0;
+			rtp->m = 0;
+			rtp->pt = 0x72; /* speex */
+			rtp->sn = htons(counter);
+			rtp->timestamp = htonl(counter * 160);
+			rtp->ssrc = htonl((uint32_t) flow_id);
+		}
+	}
+	else if(profile == CHURN_PROFILE_ESP)
+	{
+		struct esphdr *const esp = (struct esphdr *) l4;
+
+		esp->spi = htonl((uint32_t) flow_id);
+		esp->sn = htonl(counter);
+	}
+
+	/* build payload */
+	for(i = 0; i < CHURN_PAYLOAD_LEN; i++)
+	{
+		l4[l4_hdr_len + i] = i % 0xff;
+	}
+}
+
+
+/**
+ * @brief Get the current time of the monotonic clock
+ *
+ * @return  The current time (in nanoseconds)
+ */
+static uint64_t churn_now_ns(void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return ((uint64_t) now.tv_sec) * 1000000000U + now.tv_nsec;
+}
+
+
+/**
+ * @brief Callback to print traces of the ROHC library
+ *
+ * @param priv_ctxt  An optional private context, may be NULL
+ * @param level      The priority level of the trace
+ * @param entity     The entity that emitted the trace among:
+ *                    \li ROHC_TRACE_COMP
+ *                    \li ROHC_TRACE_DECOMP
+ * @param profile    The ID of the ROHC compression/decompression profile
+ *                   the trace is related to
+ * @param format     The format string of the trace
+ */
+static void print_rohc_traces(void *const priv_ctxt __attribute__((unused)),
+                              const rohc_trace_level_t level,
+                              const rohc_trace_entity_t entity __attribute__((unused)),
+                              const int profile __attribute__((unused)),
+                              const char *const format,
+                              ...)
+{
+	if(level >= ROHC_TRACE_WARNING || is_verbose)
+	{
+		const char *level_descrs[] =
+		{
+			[ROHC_TRACE_DEBUG]   = "DEBUG",
+			[ROHC_TRACE_INFO]    = "INFO",
+			[ROHC_TRACE_WARNING] = "WARNING",
+			[ROHC_TRACE_ERROR]   = "ERROR"
+		};
+		va_list args;
+		fprintf(stderr, "[%s] ", level_descrs[level]);
+		va_start(args, format);
+		vfprintf(stderr, format, args);
+		va_end(args);
+	}
+}
+
+
+/**
+ * @brief Generate a false random number for testing the ROHC library
+ *
+ * @param comp          The ROHC compressor
+ * @param user_context  Should always be NULL
+ * @return              Always 0
+ */
+static int gen_false_random_num(const struct rohc_comp *const comp,
+                                void *const user_context)
+{
+	assert(comp != NULL);
+	assert(user_context == NULL);
+	return 0;
+}
+
+
+/**
+ * @brief The RTP detection callback
+ *
+ * @param ip           The innermost IP packet
+ * @param udp          The UDP header of the packet
+ * @param payload      The UDP payload of the packet
+ * @param payload_size The size of the UDP payload (in bytes)
+ * @return             true if the packet is an RTP packet, false otherwise
+ */
+static bool rohc_comp_rtp_cb(const unsigned char *const ip __attribute__((unused)),
+                             const unsigned char *const udp,
+                             const unsigned char *const payload __attribute__((unused)),
+                             const unsigned int payload_size __attribute__((unused)),
+                             void *const rtp_private __attribute__((unused)))
+{
+	uint16_t udp_dport;
+
+	if(udp == NULL)
+	{
+		return false;
+	}
+
+	/* get the UDP destination port */
+	memcpy(&udp_dport, udp + 2, sizeof(uint16_t));
+
+	return (ntohs(udp_dport) == 1234);
+}
+
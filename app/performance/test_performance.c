@@ -32,9 +32,11 @@
  * Details
  * -------
  *
- * The program defines one (de)compressor and sends the flow of packets
- * through it. The time elapsed during the (de)compression of every packet
- * is determined. See the figure below.
+ * The program loads the whole flow of packets in memory first, so that
+ * reading the capture and parsing the link layer are not measured. It then
+ * defines one (de)compressor and sends the flow of packets through it, once
+ * or several times (see the --repeat option). The time elapsed during the
+ * (de)compression of every packet is determined. See the figure below.
  *
  *                            +----------------+
  *                            |                |
@@ -53,14 +55,63 @@
  * Output
  * ------
  *
- * The program outputs the time elapsed for (de)compression all packets, the
- * number of (de)compressed packets and the average elapsed time per packet.
+ * The program outputs the number of (de)compressed packets, the average
+ * time elapsed per packet, and the median, 90th percentile, 99th percentile
+ * and maximum time elapsed per packet for every type of ROHC packet. With
+ * the --json option, the same figures are written in JSON format along with
+ * the version of the library, so that continuous integration may compare
+ * them between two runs.
+ *
+ * Scalability
+ * -----------
+ *
+ * With the --threads option, the program runs several threads at once. Every
+ * thread is pinned to one CPU and (de)compresses the whole flow of packets
+ * with its own (de)compressor. The program then outputs the number of packets
+ * processed per second by all the threads together, and the time and CPU
+ * cycles spent per packet by every thread. A library that scales well shows
+ * the same cost per packet whatever the number of threads, as long as there
+ * are enough CPUs: a higher cost reveals some state shared between the
+ * (de)compressors, or some false sharing between them.
+ *
+ * Hardware counters
+ * -----------------
+ *
+ * With the --counters option, the program counts some hardware events of
+ * the CPU during the (de)compression on Linux, without the external perf
+ * tool: instructions, cycles, L1 data cache misses, last level cache misses
+ * and branch misses. They are output per packet, along with the number of
+ * instructions per cycle, to check the impact of a change of the data layout
+ * of the library. Only the events of the user space are counted, so that
+ * the default perf_event_paranoid setting is enough.
+ *
+ * Live traffic
+ * ------------
+ *
+ * With the --af-xdp option, the program does not load a capture but receives
+ * the Ethernet frames of one RX queue of a network device with an AF_XDP
+ * socket. The frames are (de)compressed in place in the memory shared with
+ * the kernel, without any copy, until the number of packets given with the
+ * --count option is reached. The program then also outputs the number of
+ * packets processed per second.
  */
 
+#define _GNU_SOURCE /* for pthread_setaffinity_np() */
+
 #include "config.h" /* for HAVE_*_H */
 
 /* system includes */
 #include <unistd.h>
+#include <pthread.h>
+#if defined(__linux__) && HAVE_LINUX_PERF_EVENT_H == 1
+#  include <linux/perf_event.h>
+#  include <sys/syscall.h> /* for __NR_perf_event_open */
+#  include <sys/ioctl.h>
+#  define PERF_HAVE_COUNTERS 1
+#endif
+#if defined(__x86_64__) || defined(__i386__)
+#  include <x86intrin.h> /* for __rdtsc() */
+#endif
 #if HAVE_WINSOCK2_H == 1
 #  include <winsock2.h> /* for ntohs() on Windows */
 #endif
@@ -71,19 +122,11 @@
 #include <errno.h>
 #include <stdarg.h>
 #include <stdint.h>
+#include <inttypes.h>
+#include <stdlib.h>
 #include <string.h>
 #include <assert.h>
 
-/* include for the PCAP library */
-#if HAVE_PCAP_PCAP_H == 1
-#  include <pcap/pcap.h>
-#elif HAVE_PCAP_H == 1
-#  include <pcap.h>
-#else
-#  error "pcap.h header not found, did you specified --enable-rohc-tests \
-for ./configure ? If yes, check configure output and config.log"
-#endif
-
 /* includes for network headers */
 #include <protocols/ipv4.h>
 #include <protocols/ipv6.h>
@@ -93,6 +136,14 @@ for ./configure ? If yes, check configure output and config.log"
 #include <rohc/rohc_comp.h>
 #include <rohc/rohc_decomp.h>
 
+/* include for the replay of the PCAP captures */
+#include "pcap_mmap.h"
+
+/* include for the AF_XDP capture */
+#if ROHC_WITH_AF_XDP == 1
+#  include "xsk_source.h"
+#endif
+
 
 /** The application version */
 #define APP_VERSION "ROHC performance test application, version 0.1"
@@ -109,32 +160,261 @@ for ./configure ? If yes, check configure output and config.log"
 /** The minimum Ethernet length (in bytes) */
 #define ETHER_FRAME_MIN_LEN  60U
 
+/** The number of bits of the value that select the bucket within a power of 2 */
+#define PERF_HISTO_SUB_BITS  5U
+
+/** The number of buckets of one latency histogram */
+#define PERF_HISTO_BUCKETS_NR  ((32U - PERF_HISTO_SUB_BITS + 1U) << \
+                                PERF_HISTO_SUB_BITS)
+
+#if ROHC_WITH_AF_XDP == 1
+/** The maximum number of frames received at once with AF_XDP */
+#  define PERF_XSK_BURST_MAX  64U
+/** The time (in milliseconds) to wait for frames with AF_XDP */
+#  define PERF_XSK_TIMEOUT  1000
+/** The EtherType of the ROHC packets */
+#  define PERF_ETHERTYPE_ROHC  0x22f1U
+#endif
+
+
+/** The flow of packets loaded in memory before the test */
+struct perf_packets
+{
+	struct pcap_mmap capture;  /**< The capture mapped in memory */
+	struct rohc_buf *bufs;     /**< The packets, pointing into the capture */
+	size_t bufs_nr;            /**< The number of packets */
+};
+
+
+/**
+ * @brief The histogram of the time elapsed per packet
+ *
+ * The values below 32 ns have one bucket each, then every power of 2 is
+ * divided in 32 buckets of equal width, so that the percentiles are known
+ * within 3%.
+ */
+struct perf_histo
+{
+	uint64_t buckets[PERF_HISTO_BUCKETS_NR]; /**< The packets per bucket */
+	uint64_t packets_nr;  /**< The number of packets */
+	uint64_t total_ns;    /**< The cumulative time elapsed */
+	uint64_t max_ns;      /**< The longest time elapsed */
+};
+
+
+/** The histograms of the time elapsed per packet, per ROHC packet type */
+struct perf_latency
+{
+	struct perf_histo packet_types[ROHC_PACKET_MAX]; /**< Indexed by packet type */
+};
+
+
+/** The summary of the time elapsed per packet */
+struct perf_summary
+{
+	uint64_t packets_nr;  /**< The number of packets */
+	double mean_ns;       /**< The mean time elapsed */
+	uint64_t p50_ns;      /**< The median time elapsed */
+	uint64_t p90_ns;      /**< The 90th percentile of the time elapsed */
+	uint64_t p99_ns;      /**< The 99th percentile of the time elapsed */
+	uint64_t max_ns;      /**< The longest time elapsed */
+};
+
+
+/** The hardware events counted during the (de)compression */
+typedef enum
+{
+	PERF_COUNTER_INSTRUCTIONS  = 0, /**< The instructions retired */
+	PERF_COUNTER_CYCLES        = 1, /**< The CPU cycles */
+	PERF_COUNTER_L1D_MISSES    = 2, /**< The L1 data cache read misses */
+	PERF_COUNTER_LLC_MISSES    = 3, /**< The last level cache misses */
+	PERF_COUNTER_BRANCH_MISSES = 4, /**< The mispredicted branches */
+	PERF_COUNTERS_NR           = 5, /**< The number of hardware events */
+} perf_counter_t;
+
+
+/** The hardware counters of one thread */
+struct perf_counters
+{
+	bool is_enabled;                    /**< Whether to count the events */
+	int fds[PERF_COUNTERS_NR];          /**< The counters, -1 if not opened */
+	bool is_counted[PERF_COUNTERS_NR];  /**< Whether the events were counted */
+	uint64_t values[PERF_COUNTERS_NR];  /**< The number of events */
+};
+
+
+/** The time spent by one thread to (de)compress the flow of packets */
+struct perf_timing
+{
+	uint64_t start_ns;  /**< When the thread started to (de)compress */
+	uint64_t end_ns;    /**< When the thread stopped to (de)compress */
+	uint64_t cycles;    /**< The CPU cycles spent, 0 if not available */
+	struct perf_counters counters; /**< The hardware events, if asked for */
+};
+
+
+/** One thread of the multi-threaded performance test */
+struct perf_thread
+{
+	pthread_t thread;             /**< The thread */
+	size_t cpu;                   /**< The CPU the thread is pinned on */
+	pthread_barrier_t *barrier;   /**< To start all the threads at once */
+
+	bool is_comp;                 /**< Whether to test compression or not */
+	bool is_verbose;              /**< Whether to be verbose or not */
+	const struct perf_packets *packets; /**< The packets to (de)compress */
+	size_t repeat_nr;             /**< The number of times to replay them */
+	rohc_cid_type_t cid_type;     /**< The type of CIDs to use */
+	size_t wlsb_width;            /**< The width of the WLSB window */
+	size_t max_contexts;          /**< The maximum number of contexts */
+
+	int status;                   /**< The result of the test */
+	unsigned long packet_count;   /**< The number of (de)compressed packets */
+	struct perf_timing timing;    /**< The time spent by the thread */
+	struct perf_latency latency;  /**< The time spent per packet */
+};
+
 
 static void usage(void);
 
+static bool load_packets(const char *const filename,
+                         const bool is_comp,
+                         struct perf_packets *const packets)
+	__attribute__((warn_unused_result, nonnull(1, 3)));
+static void free_packets(struct perf_packets *const packets)
+	__attribute__((nonnull(1)));
+
+static int test_threaded_perfs(const bool is_comp,
+                               const bool is_verbose,
+                               const struct perf_packets *const packets,
+                               const size_t repeat_nr,
+                               const rohc_cid_type_t cid_type,
+                               const size_t wlsb_width,
+                               const size_t max_contexts,
+                               const size_t threads_nr,
+                               struct perf_latency *const latency,
+                               struct perf_timing *const timing,
+                               unsigned long *packet_count);
+static void * run_perf_thread(void *const arg)
+	__attribute__((nonnull(1)));
+
+static struct rohc_comp * perf_create_comp(const bool *const is_verbose,
+                                           const rohc_cid_type_t cid_type,
+                                           const size_t wlsb_width,
+                                           const size_t max_contexts)
+	__attribute__((warn_unused_result, nonnull(1)));
+static struct rohc_decomp * perf_create_decomp(const bool *const is_verbose,
+                                               const rohc_cid_type_t cid_type,
+                                               const size_t max_contexts)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+#if ROHC_WITH_AF_XDP == 1
+static int test_xsk_perfs(const bool is_comp,
+                          const bool is_verbose,
+                          const char *const ifname,
+                          const unsigned int queue_id,
+                          const unsigned long count,
+                          const rohc_cid_type_t cid_type,
+                          const size_t wlsb_width,
+                          const size_t max_contexts,
+                          struct perf_latency *const latency,
+                          struct perf_timing *const timing,
+                          unsigned long *packet_count)
+	__attribute__((nonnull(3, 9, 10, 11)));
+static bool perf_xsk_frame_to_packet(const bool is_comp,
+                                     struct rohc_buf *const frame)
+	__attribute__((warn_unused_result, nonnull(2)));
+#endif
+
 static int test_compression_perfs(const bool is_verbose,
-                                  char *filename,
+                                  const struct perf_packets *const packets,
+                                  const size_t repeat_nr,
                                   const rohc_cid_type_t cid_type,
                                   const size_t wlsb_width,
                                   const size_t max_contexts,
+                                  pthread_barrier_t *const barrier,
+                                  struct perf_latency *const latency,
+                                  struct perf_timing *const timing,
                                   unsigned long *packet_count);
 static int time_compress_packet(struct rohc_comp *comp,
                                 unsigned long num_packet,
-                                struct pcap_pkthdr header,
-                                unsigned char *packet,
-                                size_t link_len);
+                                const struct rohc_buf ip_packet,
+                                struct perf_latency *const latency);
 
 static int test_decompression_perfs(const bool is_verbose,
-                                    char *filename,
+                                    const struct perf_packets *const packets,
+                                    const size_t repeat_nr,
                                     const rohc_cid_type_t cid_type,
                                     const size_t max_contexts,
+                                    pthread_barrier_t *const barrier,
+                                    struct perf_latency *const latency,
+                                    struct perf_timing *const timing,
                                     unsigned long *packet_count);
 static int time_decompress_packet(struct rohc_decomp *decomp,
                                   unsigned long num_packet,
-                                  struct pcap_pkthdr header,
-                                  unsigned char *packet,
-                                  size_t link_len,
-                                  const struct rohc_ts arrival_time);
+                                  const struct rohc_buf rohc_packet,
+                                  struct perf_latency *const latency);
+
+static void perf_timing_start(struct perf_timing *const timing)
+	__attribute__((nonnull(1)));
+static void perf_timing_stop(struct perf_timing *const timing)
+	__attribute__((nonnull(1)));
+static uint64_t perf_now_ns(void)
+	__attribute__((warn_unused_result));
+static uint64_t perf_now_cycles(void)
+	__attribute__((warn_unused_result));
+
+static void perf_counters_start(struct perf_counters *const counters)
+	__attribute__((nonnull(1)));
+static void perf_counters_stop(struct perf_counters *const counters)
+	__attribute__((nonnull(1)));
+static void perf_counters_merge(struct perf_counters *const counters,
+                                const struct perf_counters *const other)
+	__attribute__((nonnull(1, 2)));
+static void print_counters(const struct perf_counters *const counters,
+                           const unsigned long packet_count)
+	__attribute__((nonnull(1)));
+
+static void perf_latency_add(struct perf_latency *const latency,
+                             const rohc_packet_t packet_type,
+                             const uint64_t duration_ns)
+	__attribute__((nonnull(1)));
+static void perf_latency_merge(struct perf_latency *const latency,
+                               const struct perf_latency *const other)
+	__attribute__((nonnull(1, 2)));
+static void perf_latency_summarize(const struct perf_histo histos[],
+                                   const size_t histos_nr,
+                                   struct perf_summary *const summary)
+	__attribute__((nonnull(1, 3)));
+static size_t perf_histo_get_bucket(const uint64_t duration_ns)
+	__attribute__((warn_unused_result, const));
+static uint64_t perf_histo_get_bucket_max(const size_t bucket)
+	__attribute__((warn_unused_result, const));
+
+static void print_latency(const struct perf_latency *const latency)
+	__attribute__((nonnull(1)));
+static bool write_json_report(const char *const json_filename,
+                              const char *const test_type,
+                              const char *const cid_type_name,
+                              const char *const filename,
+                              const size_t repeat_nr,
+                              const size_t threads_nr,
+                              const unsigned long packet_count,
+                              const struct perf_timing *const timing,
+                              const struct perf_latency *const latency)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4, 8, 9)));
+static void print_json_string(FILE *const out, const char *const str)
+	__attribute__((nonnull(1, 2)));
+static void print_json_summary(FILE *const out,
+                               const struct perf_summary *const summary)
+	__attribute__((nonnull(1, 2)));
+
+static void print_comp_stage_cycles(const struct rohc_comp *const comp,
+                                    const unsigned long packet_count)
+	__attribute__((nonnull(1)));
+static void print_decomp_stage_cycles(const struct rohc_decomp *const decomp,
+                                      const unsigned long packet_count)
+	__attribute__((nonnull(1)));
 
 static void print_rohc_traces(void *const is_verbose__,
                               const rohc_trace_level_t level,
@@ -170,11 +450,20 @@ int main(int argc, char *argv[])
 	int max_contexts = ROHC_SMALL_CID_MAX + 1;
 	char *cid_type_name = NULL;
 	int wlsb_width = 4;
+	int threads_nr = 0; /* no thread by default */
+	int repeat_nr = 1; /* replay the capture once by default */
 	char *test_type = NULL; /* the name of the test to perform */
 	char *filename = NULL; /* the name of the PCAP capture used as input */
+	char *json_filename = NULL; /* the name of the JSON report, if any */
+	int xsk_queue = -1; /* capture the packets from a file by default */
+	long count = 1000000; /* the number of packets to receive with AF_XDP */
+	struct perf_packets packets;
+	struct perf_latency *latency;
+	struct perf_timing timing;
 	rohc_cid_type_t cid_type;
 	unsigned long packet_count = 0;
 	bool is_verbose = false; /* set to quiet mode by default */
+	bool with_counters = false; /* no hardware counter by default */
 	int status = 1;
 	int ret;
 
@@ -218,6 +507,106 @@ int main(int argc, char *argv[])
 			argv++;
 			argc--;
 		}
+		else if(!strcmp(*argv, "--threads"))
+		{
+			/* get the number of threads the test should run */
+			if(argc <= 1)
+			{
+				fprintf(stderr, "option --threads takes one argument\n\n");
+				usage();
+				goto error;
+			}
+			threads_nr = atoi(argv[1]);
+			if(threads_nr <= 0)
+			{
+				fprintf(stderr, "invalid number of threads %d: should be a "
+				        "positive number\n", threads_nr);
+				goto error;
+			}
+			argv++;
+			argc--;
+		}
+		else if(!strcmp(*argv, "--json"))
+		{
+			/* get the name of the file where to write the JSON report */
+			if(argc <= 1)
+			{
+				fprintf(stderr, "option --json takes one argument\n\n");
+				usage();
+				goto error;
+			}
+			json_filename = argv[1];
+			argv++;
+			argc--;
+		}
+		else if(!strcmp(*argv, "--counters"))
+		{
+			/* count the hardware events during the test */
+			with_counters = true;
+		}
+		else if(!strcmp(*argv, "--repeat"))
+		{
+			/* get the number of times the capture should be replayed */
+			if(argc <= 1)
+			{
+				fprintf(stderr, "option --repeat takes one argument\n\n");
+				usage();
+				goto error;
+			}
+			repeat_nr = atoi(argv[1]);
+			if(repeat_nr <= 0)
+			{
+				fprintf(stderr, "invalid number of repetitions %d: should be a "
+				        "positive number\n", repeat_nr);
+				goto error;
+			}
+			argv++;
+			argc--;
+		}
+		else if(!strcmp(*argv, "--af-xdp"))
+		{
+			/* get the RX queue of the network device to capture with AF_XDP */
+			if(argc <= 1)
+			{
+				fprintf(stderr, "option --af-xdp takes one argument\n\n");
+				usage();
+				goto error;
+			}
+#if ROHC_WITH_AF_XDP == 1
+			xsk_queue = atoi(argv[1]);
+			if(xsk_queue < 0)
+			{
+				fprintf(stderr, "invalid RX queue %d: should be a positive "
+				        "number or zero\n", xsk_queue);
+				goto error;
+			}
+#else
+			fprintf(stderr, "option --af-xdp requires a performance tool "
+			        "built with the --enable-af-xdp configure option\n");
+			goto error;
+#endif
+			argv++;
+			argc--;
+		}
+		else if(!strcmp(*argv, "--count"))
+		{
+			/* get the number of packets to receive with AF_XDP */
+			if(argc <= 1)
+			{
+				fprintf(stderr, "option --count takes one argument\n\n");
+				usage();
+				goto error;
+			}
+			count = atol(argv[1]);
+			if(count <= 0)
+			{
+				fprintf(stderr, "invalid number of packets %ld: should be a "
+				        "positive number\n", count);
+				goto error;
+			}
+			argv++;
+			argc--;
+		}
 		else if(test_type == 0)
 		{
 			/* get the name of the test */
@@ -292,38 +681,126 @@ int main(int argc, char *argv[])
 		goto error;
 	}
 
-	if(strcmp(test_type, "comp") == 0)
+	if(strcmp(test_type, "comp") != 0 && strcmp(test_type, "decomp") != 0)
 	{
-		/* test ROHC compression with the packets from the capture */
-		ret = test_compression_perfs(is_verbose, filename, cid_type, wlsb_width,
-		                             max_contexts, &packet_count);
+		fprintf(stderr, "unexpected test type '%s'\n", test_type);
+		goto error;
 	}
-	else if(strcmp(test_type, "decomp") == 0)
+
+	/* live traffic is received once, by one single thread */
+	if(xsk_queue >= 0 && (threads_nr > 0 || repeat_nr > 1))
 	{
-		/* test ROHC decompression with the packets from the capture */
-		ret = test_decompression_perfs(is_verbose, filename, cid_type,
-		                               max_contexts, &packet_count);
+		fprintf(stderr, "options --threads and --repeat cannot be used with "
+		        "option --af-xdp\n");
+		goto error;
 	}
-	else
+
+	/* the time elapsed per packet, too large for the stack */
+	latency = calloc(1, sizeof(struct perf_latency));
+	if(latency == NULL)
 	{
-		fprintf(stderr, "unexpected test type '%s'\n", test_type);
+		fprintf(stderr, "failed to allocate memory for latency histograms\n");
 		goto error;
 	}
 
+	/* load all the packets in memory before the test, unless they are
+	 * received from the network device */
+	memset(&packets, 0, sizeof(struct perf_packets));
+	if(xsk_queue < 0 &&
+	   !load_packets(filename, strcmp(test_type, "comp") == 0, &packets))
+	{
+		fprintf(stderr, "failed to load the packets from '%s'\n", filename);
+		goto free_latency;
+	}
+
+	memset(&timing, 0, sizeof(struct perf_timing));
+	timing.counters.is_enabled = with_counters;
+
+	if(xsk_queue >= 0)
+	{
+#if ROHC_WITH_AF_XDP == 1
+		/* test ROHC (de)compression with the packets from the network device */
+		ret = test_xsk_perfs(strcmp(test_type, "comp") == 0, is_verbose,
+		                     filename, xsk_queue, count, cid_type, wlsb_width,
+		                     max_contexts, latency, &timing, &packet_count);
+#else
+		assert(0);
+		ret = 1;
+#endif
+	}
+	else if(threads_nr > 0)
+	{
+		/* test ROHC (de)compression with several threads at once */
+		ret = test_threaded_perfs(strcmp(test_type, "comp") == 0, is_verbose,
+		                          &packets, repeat_nr, cid_type, wlsb_width,
+		                          max_contexts, threads_nr, latency, &timing,
+		                          &packet_count);
+	}
+	else if(strcmp(test_type, "comp") == 0)
+	{
+		/* test ROHC compression with the packets from the capture */
+		ret = test_compression_perfs(is_verbose, &packets, repeat_nr, cid_type,
+		                             wlsb_width, max_contexts, NULL, latency,
+		                             &timing, &packet_count);
+	}
+	else
+	{
+		/* test ROHC decompression with the packets from the capture */
+		ret = test_decompression_perfs(is_verbose, &packets, repeat_nr, cid_type,
+		                               max_contexts, NULL, latency, &timing,
+		                               &packet_count);
+	}
+
 	/* check test status */
 	if(ret != 0)
 	{
 		fprintf(stderr, "performance test failed, see above error(s)\n");
-		goto error;
+		goto free_packets;
 	}
 
 	/* print performance statistics */
 	fprintf(stderr, "%scompression: %lu packets\n",
 	        (strcmp(test_type, "comp") == 0 ? "" : "de"), packet_count);
+	if(threads_nr == 0 && packet_count > 0)
+	{
+		fprintf(stderr, "%scompression: %.1f ns per packet",
+		        (strcmp(test_type, "comp") == 0 ? "" : "de"),
+		        ((double) (timing.end_ns - timing.start_ns)) / packet_count);
+		if(timing.cycles > 0)
+		{
+			fprintf(stderr, ", %.1f cycles per packet",
+			        ((double) timing.cycles) / packet_count);
+		}
+		fprintf(stderr, "\n");
+	}
+	if(xsk_queue >= 0 && timing.end_ns > timing.start_ns)
+	{
+		/* the time elapsed includes the wait for the packets */
+		fprintf(stderr, "%scompression: %.0f packets per second received\n",
+		        (strcmp(test_type, "comp") == 0 ? "" : "de"),
+		        ((double) packet_count) * 1e9 / (timing.end_ns - timing.start_ns));
+	}
+	if(with_counters)
+	{
+		print_counters(&timing.counters, packet_count);
+	}
+	print_latency(latency);
+
+	/* write the JSON report if asked for */
+	if(json_filename != NULL &&
+	   !write_json_report(json_filename, test_type, cid_type_name, filename,
+	                      repeat_nr, threads_nr, packet_count, &timing, latency))
+	{
+		goto free_packets;
+	}
 
 	/* everything went fine */
 	status = 0;
 
+free_packets:
+	free_packets(&packets);
+free_latency:
+	free(latency);
 error:
 	return status;
 }
@@ -339,6 +816,8 @@ static void usage(void)
 		"\n"
 		"Usage: rohc_test_performance [General options]\n"
 		"   or: rohc_test_performance [ROHC options] ACTION CID_TYPE FLOW\n"
+		"   or: rohc_test_performance [ROHC options] --af-xdp QUEUE ACTION\n"
+		"                             CID_TYPE DEVICE\n"
 		"\n"
 		"Options:\n"
 		"Mandatory parameters:\n"
@@ -348,6 +827,8 @@ static void usage(void)
 		"                    large CID test with 'largecid'\n"
 		"  FLOW              A flow of Ethernet frames to (de)compress\n"
 		"                    (in PCAP format)\n"
+		"  DEVICE            The network device to receive the Ethernet\n"
+		"                    frames from (with --af-xdp only)\n"
 		"General options:\n"
 		"  -h, --help              Print application usage and exit\n"
 		"  -v, --version           Print version information and exit\n"
@@ -356,326 +837,527 @@ static void usage(void)
 		"      --wlsb-width NUM    The width of the WLSB window to use\n"
 		"      --max-contexts NUM  The maximum number of ROHC contexts to\n"
 		"                          simultaneously use during the test\n"
+		"      --threads NUM       Run the test on NUM threads pinned to\n"
+		"                          different CPUs, every thread with its\n"
+		"                          own (de)compressor\n"
+		"      --repeat NUM        Replay the packets of the capture NUM\n"
+		"                          times in a row\n"
+		"      --json FILE         Write the results of the test in JSON\n"
+		"                          format in FILE ('-' for the standard\n"
+		"                          output)\n"
+		"      --counters          Count the instructions, cycles, cache\n"
+		"                          misses and branch misses per packet\n"
+		"                          with the hardware counters (Linux only)\n"
+		"      --af-xdp QUEUE      Receive the Ethernet frames of the RX\n"
+		"                          queue QUEUE of DEVICE with AF_XDP and\n"
+		"                          (de)compress them in place, the frames\n"
+		"                          are not received by the system anymore\n"
+		"                          (IP packets for compression, ROHC\n"
+		"                          packets with EtherType 0x22f1 for\n"
+		"                          decompression, others are ignored)\n"
+		"      --count NUM         Stop after NUM packets received with\n"
+		"                          AF_XDP (default: 1000000)\n"
 		"\n"
 		"Examples:\n"
 		"  rohc_test_performance comp smallcid voip.pcap     test compression performances with small CIDs on the given VoIP stream\n"
 		"  rohc_test_performance decomp largecid a.pcap      test decompression performances with large CIDs on the given stream\n"
+		"  rohc_test_performance --threads 4 comp smallcid voip.pcap\n"
+		"                                                    test how compression scales on 4 CPUs\n"
+		"  rohc_test_performance --repeat 100 comp smallcid voip.pcap\n"
+		"                                                    test compression performances on 100 replays of the stream\n"
+		"  rohc_test_performance --counters comp smallcid voip.pcap\n"
+		"                                                    test compression performances and count cache misses\n"
+		"  rohc_test_performance --af-xdp 0 comp smallcid eth0\n"
+		"                                                    test compression performances on the traffic of the 1st RX queue of eth0\n"
 		"\n"
 		"Report bugs to <" PACKAGE_BUGREPORT ">.\n");
 }
 
 
 /**
- * @brief Test the compression performance of the ROHC library
- *        with a flow of IP packets
+ * @brief Test the performance of the ROHC library with several threads
+ *
+ * Every thread is pinned to one CPU, and (de)compresses the whole flow of
+ * packets with its own (de)compressor. All the threads start to (de)compress
+ * at once, once all the (de)compressors are created.
  *
+ * @param is_comp       Whether to test compression or decompression
  * @param is_verbose    Whether the test is run in verbose mode or not
- * @param filename      The name of the PCAP file that contains the IP packets
- * @param cid_type      The type of CIDs the compressor shall use
+ * @param packets       The packets to (de)compress
+ * @param repeat_nr     The number of times every thread replays the packets
+ * @param cid_type      The type of CIDs the (de)compressors shall use
  * @param wlsb_width    The width of the WLSB window to use
  * @param max_contexts  The maximum number of ROHC contexts to use
- * @param packet_count  OUT: the number of compressed packets, undefined if
- *                      compression failed
+ * @param threads_nr    The number of threads to run
+ * @param latency       OUT: the time elapsed per packet in all the threads
+ * @param timing        OUT: the time spent by all the threads together
+ * @param packet_count  OUT: the number of packets (de)compressed by all the
+ *                      threads, undefined if (de)compression failed
  * @return              0 in case of success, 1 otherwise
  */
-static int test_compression_perfs(const bool is_verbose,
-                                  char *filename,
-                                  const rohc_cid_type_t cid_type,
-                                  const size_t wlsb_width,
-                                  const size_t max_contexts,
-                                  unsigned long *packet_count)
+static int test_threaded_perfs(const bool is_comp,
+                               const bool is_verbose,
+                               const struct perf_packets *const packets,
+                               const size_t repeat_nr,
+                               const rohc_cid_type_t cid_type,
+                               const size_t wlsb_width,
+                               const size_t max_contexts,
+                               const size_t threads_nr,
+                               struct perf_latency *const latency,
+                               struct perf_timing *const timing,
+                               unsigned long *packet_count)
 {
-	pcap_t *handle;
-	char errbuf[PCAP_ERRBUF_SIZE];
-	int link_layer_type;
-	size_t link_len;
-	struct pcap_pkthdr header;
-	unsigned char *packet;
-	struct rohc_comp *comp;
+	struct perf_thread *threads;
+	pthread_barrier_t barrier;
+	long cpus_nr;
+	uint64_t start_ns = UINT64_MAX;
+	uint64_t end_ns = 0;
+	size_t threads_created;
+	size_t i;
 	int is_failure = 1;
 	int ret;
 
-	assert(max_contexts > 0);
-
-	/* open the PCAP file that contains the stream */
-	handle = pcap_open_offline(filename, errbuf);
-	if(handle == NULL)
-	{
-		fprintf(stderr, "failed to open the pcap file: %s\n", errbuf);
-		goto exit;
-	}
-
-	/* link layer in the capture must be Ethernet */
-	link_layer_type = pcap_datalink(handle);
-	if(link_layer_type != DLT_EN10MB &&
-	   link_layer_type != DLT_LINUX_SLL &&
-	   link_layer_type != DLT_RAW)
-	{
-		fprintf(stderr, "link layer type %d not supported in capture "
-		        "(supported = %d, %d, %d)\n", link_layer_type,
-		        DLT_EN10MB, DLT_LINUX_SLL, DLT_RAW);
-		goto close_input;
-	}
+	assert(threads_nr > 0);
 
-	if(link_layer_type == DLT_EN10MB)
+	cpus_nr = sysconf(_SC_NPROCESSORS_ONLN);
+	if(cpus_nr <= 0)
 	{
-		link_len = ETHER_HDR_LEN;
+		cpus_nr = 1;
 	}
-	else if(link_layer_type == DLT_LINUX_SLL)
+	if(threads_nr > ((size_t) cpus_nr))
 	{
-		link_len = LINUX_COOKED_HDR_LEN;
+		fprintf(stderr, "warning: %zu threads for %ld CPUs, some threads will "
+		        "share the same CPU\n", threads_nr, cpus_nr);
 	}
-	else /* DLT_RAW */
+
+	threads = calloc(threads_nr, sizeof(struct perf_thread));
+	if(threads == NULL)
 	{
-		link_len = 0;
+		fprintf(stderr, "failed to allocate memory for %zu threads\n", threads_nr);
+		goto exit;
 	}
 
-	/* create ROHC compressor */
-	comp = rohc_comp_new2(cid_type, max_contexts - 1, gen_false_random_num, NULL);
-	if(comp == NULL)
+	ret = pthread_barrier_init(&barrier, NULL, threads_nr);
+	if(ret != 0)
 	{
-		fprintf(stderr, "cannot create the ROHC compressor\n");
-		goto close_input;
+		fprintf(stderr, "failed to create the barrier for threads: %s (%d)\n",
+		        strerror(ret), ret);
+		goto free_threads;
 	}
 
-	/* set the callback for traces */
-	if(!rohc_comp_set_traces_cb2(comp, print_rohc_traces, (void *) &is_verbose))
+	/* start all the threads */
+	for(threads_created = 0; threads_created < threads_nr; threads_created++)
 	{
-		fprintf(stderr, "failed to set the callback for traces\n");
-		goto free_compresssor;
+		struct perf_thread *const thread = &threads[threads_created];
+
+		thread->cpu = threads_created % cpus_nr;
+		thread->barrier = &barrier;
+		thread->is_comp = is_comp;
+		thread->is_verbose = is_verbose;
+		thread->packets = packets;
+		thread->repeat_nr = repeat_nr;
+		thread->cid_type = cid_type;
+		thread->wlsb_width = wlsb_width;
+		thread->max_contexts = max_contexts;
+		thread->timing.counters.is_enabled = timing->counters.is_enabled;
+		thread->status = 1;
+
+		ret = pthread_create(&thread->thread, NULL, run_perf_thread, thread);
+		if(ret != 0)
+		{
+			fprintf(stderr, "failed to create thread #%zu: %s (%d)\n",
+			        threads_created + 1, strerror(ret), ret);
+			break;
+		}
 	}
-
-	/* activate all the compression profiles */
-	if(!rohc_comp_enable_profiles(comp, ROHC_PROFILE_UNCOMPRESSED,
-	                              ROHC_PROFILE_RTP, ROHC_PROFILE_UDP,
-	                              ROHC_PROFILE_IP, ROHC_PROFILE_UDPLITE,
-	                              ROHC_PROFILE_ESP, ROHC_PROFILE_TCP, -1))
+	if(threads_created < threads_nr)
 	{
-		fprintf(stderr, "failed to enable the compression profiles\n");
-		goto free_compresssor;
+		/* the threads already created wait at the barrier for the missing
+		 * ones: the program cannot recover from that */
+		exit(1);
 	}
 
-	/* set the WLSB window width on compressor */
-	if(!rohc_comp_set_wlsb_window_width(comp, wlsb_width))
+	/* wait for all the threads to finish */
+	for(i = 0; i < threads_nr; i++)
 	{
-		fprintf(stderr, "failed to set the WLSB window width on compressor\n");
-		goto free_compresssor;
+		pthread_join(threads[i].thread, NULL);
 	}
 
-	/* set UDP ports dedicated to RTP traffic */
-	if(!rohc_comp_set_rtp_detection_cb(comp, rohc_comp_rtp_cb, NULL))
+	/* print the performance of every thread */
+	*packet_count = 0;
+	timing->cycles = 0;
+	for(i = 0; i < PERF_COUNTERS_NR; i++)
 	{
-		fprintf(stderr, "failed to set the RTP detection callback on compressor\n");
-		goto free_compresssor;
+		timing->counters.is_counted[i] = timing->counters.is_enabled;
+		timing->counters.values[i] = 0;
 	}
+	for(i = 0; i < threads_nr; i++)
+	{
+		const struct perf_thread *const thread = &threads[i];
+		const uint64_t elapsed_ns = thread->timing.end_ns - thread->timing.start_ns;
 
-	fflush(stderr);
+		if(thread->status != 0)
+		{
+			fprintf(stderr, "thread #%zu failed\n", i + 1);
+			goto destroy_barrier;
+		}
 
-	/* for each packet in the dump */
-	*packet_count = 0;
-	while((packet = (unsigned char *) pcap_next(handle, &header)) != NULL)
-	{
-		(*packet_count)++;
-		if((*packet_count) != 0 && ((*packet_count) % 100000) == 0)
+		fprintf(stderr, "thread #%zu (CPU %zu): %lu packets, %.1f ns per packet",
+		        i + 1, thread->cpu, thread->packet_count,
+		        thread->packet_count == 0 ? 0.0 :
+		        ((double) elapsed_ns) / thread->packet_count);
+		if(thread->timing.cycles > 0)
 		{
-			fprintf(stderr, "compression: packet #%lu\r", *packet_count);
-			fflush(stderr);
+			fprintf(stderr, ", %.1f cycles per packet",
+			        thread->packet_count == 0 ? 0.0 :
+			        ((double) thread->timing.cycles) / thread->packet_count);
 		}
+		fprintf(stderr, "\n");
 
-		/* compress the IP packet */
-		ret = time_compress_packet(comp, *packet_count,
-		                           header, packet, link_len);
-		if(ret != 0)
+		*packet_count += thread->packet_count;
+		timing->cycles += thread->timing.cycles;
+		perf_counters_merge(&timing->counters, &thread->timing.counters);
+		perf_latency_merge(latency, &thread->latency);
+		if(thread->timing.start_ns < start_ns)
 		{
-			fprintf(stderr, "packet %lu: performance test failed\n",
-			        *packet_count);
-			goto free_compresssor;
+			start_ns = thread->timing.start_ns;
+		}
+		if(thread->timing.end_ns > end_ns)
+		{
+			end_ns = thread->timing.end_ns;
 		}
 	}
 
+	/* print the performance of all the threads together */
+	timing->start_ns = start_ns;
+	timing->end_ns = end_ns;
+	fprintf(stderr, "%zu threads: %lu packets in %.3f seconds, %.0f packets "
+	        "per second\n", threads_nr, *packet_count, (end_ns - start_ns) / 1e9,
+	        end_ns == start_ns ? 0.0 :
+	        ((double) *packet_count) * 1e9 / (end_ns - start_ns));
+
 	/* everything went fine */
 	is_failure = 0;
 
-free_compresssor:
-	rohc_comp_free(comp);
-close_input:
-	pcap_close(handle);
+destroy_barrier:
+	pthread_barrier_destroy(&barrier);
+free_threads:
+	free(threads);
 exit:
 	return is_failure;
 }
 
 
 /**
- * @brief Determine the time required to compress the given IP packet
- *        with the given compressor
+ * @brief Run the performance test in one thread
  *
- * @param comp          The compressor to use to compress the IP packet
- * @param num_packet    A number affected to the IP packet to compress
- *                      (traces only)
- * @param header        The PCAP header for the packet
- * @param packet        The packet to compress (link layer included)
- * @param link_len      The length of the link layer header before IP data
- * @return              0 if compression is successful, 1 otherwise
+ * @param arg  The thread, see \ref perf_thread
+ * @return     Always NULL, the result of the test is stored in the thread
  */
-static int time_compress_packet(struct rohc_comp *comp,
-                                unsigned long num_packet,
-                                struct pcap_pkthdr header,
-                                unsigned char *packet,
-                                size_t link_len)
+static void * run_perf_thread(void *const arg)
 {
-	/* the buffer that will contain the initial uncompressed packet */
-	const struct rohc_ts arrival_time = { .sec = 0, .nsec = 0 };
-	struct rohc_buf ip_packet =
-		rohc_buf_init_full(packet, header.caplen, arrival_time);
-
-	/* the buffer that will contain the compressed ROHC packet */
-	uint8_t rohc_buffer[MAX_ROHC_SIZE];
-	struct rohc_buf rohc_packet =
-		rohc_buf_init_empty(rohc_buffer, MAX_ROHC_SIZE);
-
-	int is_failure = 1;
-	rohc_status_t status;
-
-	/* check Ethernet frame length */
-	if(header.len <= link_len || header.len != header.caplen)
-	{
-		fprintf(stderr, "packet %lu: bad PCAP packet (len = %u, caplen = %u)\n",
-		        num_packet, header.len, header.caplen);
-		goto error;
-	}
-
-	/* skip the link layer header */
-	rohc_buf_pull(&ip_packet, link_len);
+	struct perf_thread *const thread = arg;
 
-	/* check for padding after the IP packet in the Ethernet payload */
-	if(link_len == ETHER_HDR_LEN && header.len == ETHER_FRAME_MIN_LEN)
+#ifdef __linux__
 	{
-		uint8_t ip_version;
-		uint16_t tot_len;
-
-		/* determine the total length of the IP packet */
-		ip_version = (rohc_buf_byte(ip_packet) >> 4) & 0x0f;
-		if(ip_version == 4) /* IPv4 */
-		{
-			struct ipv4_hdr *ip;
-
-			ip = (struct ipv4_hdr *) rohc_buf_data(ip_packet);
-			tot_len = ntohs(ip->tot_len);
-		}
-		else if(ip_version == 6) /* IPv6 */
-		{
-			struct ipv6_hdr *ip;
-
-			ip = (struct ipv6_hdr *) rohc_buf_data(ip_packet);
-			tot_len = sizeof(struct ipv6_hdr) + ntohs(ip->plen);
-		}
-		else /* unknown IP version */
-		{
-			fprintf(stderr, "packet %lu: bad IP version (0x%x) "
-			        "in packet\n", num_packet, ip_version);
-			goto error;
-		}
+		cpu_set_t cpuset;
+		int ret;
 
-		/* update the length of the IP packet if padding is present */
-		if(tot_len < ip_packet.len)
+		/* pin the thread on its CPU */
+		CPU_ZERO(&cpuset);
+		CPU_SET(thread->cpu, &cpuset);
+		ret = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset);
+		if(ret != 0)
 		{
-			fprintf(stderr, "packet %lu: the Ethernet frame has %zu "
-			        "bytes of padding after the %u-byte IP packet!\n",
-			        num_packet, ip_packet.len - tot_len, tot_len);
-			ip_packet.len = tot_len;
+			fprintf(stderr, "warning: failed to pin thread on CPU %zu: %s (%d)\n",
+			        thread->cpu, strerror(ret), ret);
 		}
 	}
+#endif
 
-	/* compress the packet */
-	status = rohc_compress4(comp, ip_packet, &rohc_packet);
-	if(status != ROHC_STATUS_OK)
+	if(thread->is_comp)
 	{
-		fprintf(stderr, "packet %lu: compression failed\n", num_packet);
-		goto error;
+		thread->status =
+			test_compression_perfs(thread->is_verbose, thread->packets,
+			                       thread->repeat_nr, thread->cid_type,
+			                       thread->wlsb_width,
+			                       thread->max_contexts, thread->barrier,
+			                       &thread->latency, &thread->timing,
+			                       &thread->packet_count);
+	}
+	else
+	{
+		thread->status =
+			test_decompression_perfs(thread->is_verbose, thread->packets,
+			                         thread->repeat_nr, thread->cid_type,
+			                         thread->max_contexts, thread->barrier,
+			                         &thread->latency, &thread->timing,
+			                         &thread->packet_count);
 	}
 
-	/* everything went fine */
-	is_failure = 0;
-
-error:
-	return is_failure;
+	return NULL;
 }
 
 
 /**
- * @brief Test the decompression performance of the ROHC library
- *        with a flow of IP packets
+ * @brief Load all the packets of a capture in memory
  *
- * @param is_verbose    Whether the test is run in verbose mode or not
- * @param filename      The name of the PCAP file that contains the ROHC packets
- * @param cid_type      The type of CIDs the decompressor shall use
- * @param max_contexts  The maximum number of ROHC contexts to use
- * @param packet_count  OUT: the number of decompressed packets, undefined if
- *                      decompression failed
- * @return              0 in case of success, 1 otherwise
+ * The link layer header and the Ethernet padding are removed from the
+ * packets, so that the test measures the (de)compression only. The capture
+ * is mapped in memory and the packets point into the mapping, in the order
+ * of the capture: loading even huge captures costs page faults only, the
+ * packets are never copied.
+ *
+ * @param filename  The name of the PCAP file that contains the packets
+ * @param is_comp   Whether the packets are IP packets to compress, or ROHC
+ *                  packets to decompress
+ * @param packets   OUT: the packets loaded in memory, to release with
+ *                  \ref free_packets
+ * @return          true if the packets were successfully loaded,
+ *                  false otherwise
  */
-static int test_decompression_perfs(const bool is_verbose,
-                                    char *filename,
-                                    const rohc_cid_type_t cid_type,
-                                    const size_t max_contexts,
-                                    unsigned long *packet_count)
+static bool load_packets(const char *const filename,
+                         const bool is_comp,
+                         struct perf_packets *const packets)
 {
 	const struct rohc_ts arrival_time = { .sec = 0, .nsec = 0 };
-	pcap_t *handle;
-	char errbuf[PCAP_ERRBUF_SIZE];
-	int link_layer_type;
+	char errbuf[PCAP_MMAP_ERRBUF_SIZE];
 	size_t link_len;
-	struct pcap_pkthdr header;
-	unsigned char *packet;
-	struct rohc_decomp *decomp;
-	int is_failure = 1;
-	int ret;
+	struct rohc_buf frame;
+	size_t wire_len;
+	size_t bufs_max = 0;
 
-	assert(max_contexts > 0);
+	packets->bufs = NULL;
+	packets->bufs_nr = 0;
 
-	/* open the PCAP file that contains the stream */
-	handle = pcap_open_offline(filename, errbuf);
-	if(handle == NULL)
+	/* map the PCAP file that contains the stream */
+	if(!pcap_mmap_open(&packets->capture, filename, errbuf))
 	{
 		fprintf(stderr, "failed to open the pcap file: %s\n", errbuf);
-		goto exit;
+		goto error;
 	}
 
 	/* link layer in the capture must be Ethernet */
-	link_layer_type = pcap_datalink(handle);
-	if(link_layer_type != DLT_EN10MB &&
-	   link_layer_type != DLT_LINUX_SLL &&
-	   link_layer_type != DLT_RAW)
-	{
-		fprintf(stderr, "link layer type %d not supported in capture "
-		        "(supported = %d, %d, %d)\n", link_layer_type,
-		        DLT_EN10MB, DLT_LINUX_SLL, DLT_RAW);
-		goto close_input;
-	}
-
-	if(link_layer_type == DLT_EN10MB)
+	if(packets->capture.linktype == PCAP_MMAP_LINKTYPE_ETHERNET)
 	{
 		link_len = ETHER_HDR_LEN;
 	}
-	else if(link_layer_type == DLT_LINUX_SLL)
+	else if(packets->capture.linktype == PCAP_MMAP_LINKTYPE_LINUX_SLL)
 	{
 		link_len = LINUX_COOKED_HDR_LEN;
 	}
-	else /* DLT_RAW */
+	else if(packets->capture.linktype == PCAP_MMAP_LINKTYPE_RAW)
 	{
 		link_len = 0;
 	}
+	else
+	{
+		fprintf(stderr, "link layer type %u not supported in capture "
+		        "(supported = %u, %u, %u)\n", packets->capture.linktype,
+		        PCAP_MMAP_LINKTYPE_ETHERNET, PCAP_MMAP_LINKTYPE_LINUX_SLL,
+		        PCAP_MMAP_LINKTYPE_RAW);
+		goto close_input;
+	}
+
+	/* for each packet in the dump */
+	while(pcap_mmap_next(&packets->capture, &frame, &wire_len))
+	{
+		const unsigned long num_packet = packets->bufs_nr + 1;
+		const uint8_t *const packet = rohc_buf_data(frame);
+		size_t len;
+
+		/* check Ethernet frame length */
+		if(wire_len <= link_len || wire_len != frame.len)
+		{
+			fprintf(stderr, "packet %lu: bad PCAP packet (len = %zu, caplen = "
+			        "%zu)\n", num_packet, wire_len, frame.len);
+			goto free_packets;
+		}
+
+		/* skip the link layer header */
+		len = frame.len - link_len;
+
+		/* check for padding after the IP packet in the Ethernet payload */
+		if(is_comp && link_len == ETHER_HDR_LEN &&
+		   wire_len == ETHER_FRAME_MIN_LEN)
+		{
+			const uint8_t *const ip = packet + link_len;
+			const uint8_t ip_version = (ip[0] >> 4) & 0x0f;
+			uint16_t tot_len;
+
+			/* determine the total length of the IP packet */
+			if(ip_version == 4) /* IPv4 */
+			{
+				const struct ipv4_hdr *const ipv4 = (struct ipv4_hdr *) ip;
+				tot_len = ntohs(ipv4->tot_len);
+			}
+			else if(ip_version == 6) /* IPv6 */
+			{
+				const struct ipv6_hdr *const ipv6 = (struct ipv6_hdr *) ip;
+				tot_len = sizeof(struct ipv6_hdr) + ntohs(ipv6->plen);
+			}
+			else /* unknown IP version */
+			{
+				fprintf(stderr, "packet %lu: bad IP version (0x%x) "
+				        "in packet\n", num_packet, ip_version);
+				goto free_packets;
+			}
+
+			/* update the length of the IP packet if padding is present */
+			if(tot_len < len)
+			{
+				fprintf(stderr, "packet %lu: the Ethernet frame has %zu "
+				        "bytes of padding after the %u-byte IP packet!\n",
+				        num_packet, len - tot_len, tot_len);
+				len = tot_len;
+			}
+		}
+
+		/* make room for the new packet */
+		if(packets->bufs_nr >= bufs_max)
+		{
+			const size_t new_max = (bufs_max == 0 ? 1024 : bufs_max * 2);
+			struct rohc_buf *const new_bufs =
+				realloc(packets->bufs, new_max * sizeof(struct rohc_buf));
+			if(new_bufs == NULL)
+			{
+				fprintf(stderr, "failed to allocate memory for %zu packets\n",
+				        new_max);
+				goto free_packets;
+			}
+			packets->bufs = new_bufs;
+			bufs_max = new_max;
+		}
+
+		/* point the packet into the mapping */
+		packets->bufs[packets->bufs_nr] = (struct rohc_buf)
+			rohc_buf_init_full(rohc_buf_data(frame) + link_len, len, arrival_time);
+		packets->bufs_nr++;
+	}
+
+	return true;
+
+free_packets:
+	free(packets->bufs);
+	packets->bufs = NULL;
+	packets->bufs_nr = 0;
+close_input:
+	pcap_mmap_close(&packets->capture);
+error:
+	return false;
+}
+
+
+/**
+ * @brief Release the packets loaded in memory
+ *
+ * @param packets  The packets loaded by \ref load_packets
+ */
+static void free_packets(struct perf_packets *const packets)
+{
+	free(packets->bufs);
+	packets->bufs = NULL;
+	pcap_mmap_close(&packets->capture);
+	packets->bufs_nr = 0;
+}
+
+
+/**
+ * @brief Create the ROHC compressor for the test
+ *
+ * All the compression profiles are enabled.
+ *
+ * @param is_verbose    Whether the test is run in verbose mode or not
+ * @param cid_type      The type of CIDs the compressor shall use
+ * @param wlsb_width    The width of the WLSB window to use
+ * @param max_contexts  The maximum number of ROHC contexts to use
+ * @return              The new compressor, NULL in case of error
+ */
+static struct rohc_comp * perf_create_comp(const bool *const is_verbose,
+                                           const rohc_cid_type_t cid_type,
+                                           const size_t wlsb_width,
+                                           const size_t max_contexts)
+{
+	struct rohc_comp *comp;
+
+	assert(max_contexts > 0);
+
+	/* create ROHC compressor */
+	comp = rohc_comp_new2(cid_type, max_contexts - 1, gen_false_random_num, NULL);
+	if(comp == NULL)
+	{
+		fprintf(stderr, "cannot create the ROHC compressor\n");
+		goto error;
+	}
+
+	/* set the callback for traces */
+	if(!rohc_comp_set_traces_cb2(comp, print_rohc_traces, (void *) is_verbose))
+	{
+		fprintf(stderr, "failed to set the callback for traces\n");
+		goto free_compresssor;
+	}
+
+	/* activate all the compression profiles */
+	if(!rohc_comp_enable_profiles(comp, ROHC_PROFILE_UNCOMPRESSED,
+	                              ROHC_PROFILE_RTP, ROHC_PROFILE_UDP,
+	                              ROHC_PROFILE_IP, ROHC_PROFILE_UDPLITE,
+	                              ROHC_PROFILE_ESP, ROHC_PROFILE_TCP, -1))
+	{
+		fprintf(stderr, "failed to enable the compression profiles\n");
+		goto free_compresssor;
+	}
+
+	/* set the WLSB window width on compressor */
+	if(!rohc_comp_set_wlsb_window_width(comp, wlsb_width))
+	{
+		fprintf(stderr, "failed to set the WLSB window width on compressor\n");
+		goto free_compresssor;
+	}
+
+	/* set UDP ports dedicated to RTP traffic */
+	if(!rohc_comp_set_rtp_detection_cb(comp, rohc_comp_rtp_cb, NULL))
+	{
+		fprintf(stderr, "failed to set the RTP detection callback on compressor\n");
+		goto free_compresssor;
+	}
+
+	return comp;
+
+free_compresssor:
+	rohc_comp_free(comp);
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Create the ROHC decompressor for the test
+ *
+ * The decompressor runs in U-mode with all the decompression profiles.
+ *
+ * @param is_verbose    Whether the test is run in verbose mode or not
+ * @param cid_type      The type of CIDs the decompressor shall use
+ * @param max_contexts  The maximum number of ROHC contexts to use
+ * @return              The new decompressor, NULL in case of error
+ */
+static struct rohc_decomp * perf_create_decomp(const bool *const is_verbose,
+                                               const rohc_cid_type_t cid_type,
+                                               const size_t max_contexts)
+{
+	struct rohc_decomp *decomp;
+
+	assert(max_contexts > 0);
 
 	/* create ROHC decompressor */
 	decomp = rohc_decomp_new2(cid_type, max_contexts - 1, ROHC_U_MODE);
 	if(decomp == NULL)
 	{
 		fprintf(stderr, "cannot create the ROHC decompressor\n");
-		goto close_input;
+		goto error;
 	}
 
 	/* set trace callback for decompressor in verbose mode */
-	if(!rohc_decomp_set_traces_cb2(decomp, print_rohc_traces, (void *) &is_verbose))
+	if(!rohc_decomp_set_traces_cb2(decomp, print_rohc_traces, (void *) is_verbose))
 	{
 		fprintf(stderr, "cannot set trace callback for decompressor\n");
 		goto free_decompressor;
@@ -691,96 +1373,1289 @@ static int test_decompression_perfs(const bool is_verbose,
 		goto free_decompressor;
 	}
 
+	return decomp;
+
+free_decompressor:
+	rohc_decomp_free(decomp);
+error:
+	return NULL;
+}
+
+
+#if ROHC_WITH_AF_XDP == 1
+
+/**
+ * @brief Test the performance of the ROHC library with the live traffic of
+ *        a network device
+ *
+ * The Ethernet frames of one RX queue of the network device are received
+ * in bursts with an AF_XDP socket, then (de)compressed in place in the UMEM
+ * shared with the kernel. The frames that cannot be (de)compressed are
+ * ignored.
+ *
+ * @param is_comp       Whether to test compression or decompression
+ * @param is_verbose    Whether the test is run in verbose mode or not
+ * @param ifname        The name of the network device
+ * @param queue_id      The RX queue of the network device
+ * @param count         The number of packets to (de)compress
+ * @param cid_type      The type of CIDs the (de)compressor shall use
+ * @param wlsb_width    The width of the WLSB window to use
+ * @param max_contexts  The maximum number of ROHC contexts to use
+ * @param latency       OUT: the time elapsed per packet
+ * @param timing        OUT: the time spent to receive and (de)compress
+ * @param packet_count  OUT: the number of (de)compressed packets, undefined
+ *                      if (de)compression failed
+ * @return              0 in case of success, 1 otherwise
+ */
+static int test_xsk_perfs(const bool is_comp,
+                          const bool is_verbose,
+                          const char *const ifname,
+                          const unsigned int queue_id,
+                          const unsigned long count,
+                          const rohc_cid_type_t cid_type,
+                          const size_t wlsb_width,
+                          const size_t max_contexts,
+                          struct perf_latency *const latency,
+                          struct perf_timing *const timing,
+                          unsigned long *packet_count)
+{
+	char errbuf[XSK_SOURCE_ERRBUF_SIZE];
+	struct rohc_buf frames[PERF_XSK_BURST_MAX];
+	struct xsk_source *source;
+	struct rohc_comp *comp = NULL;
+	struct rohc_decomp *decomp = NULL;
+	int is_failure = 1;
+	int frames_nr;
+	int i;
+	int ret;
+
+	/* bind an AF_XDP socket to the RX queue of the network device */
+	source = xsk_source_open(ifname, queue_id, errbuf);
+	if(source == NULL)
+	{
+		fprintf(stderr, "failed to open network device '%s': %s\n", ifname,
+		        errbuf);
+		goto exit;
+	}
+
+	/* create ROHC (de)compressor */
+	if(is_comp)
+	{
+		comp = perf_create_comp(&is_verbose, cid_type, wlsb_width, max_contexts);
+		if(comp == NULL)
+		{
+			goto close_source;
+		}
+	}
+	else
+	{
+		decomp = perf_create_decomp(&is_verbose, cid_type, max_contexts);
+		if(decomp == NULL)
+		{
+			goto close_source;
+		}
+	}
+
 	fflush(stderr);
+	perf_timing_start(timing);
 
-	/* for each packet in the dump */
+	/* for each burst of frames, until enough packets were (de)compressed */
 	*packet_count = 0;
-	while((packet = (unsigned char *) pcap_next(handle, &header)) != NULL)
+	while((*packet_count) < count)
 	{
-		(*packet_count)++;
-		if((*packet_count) != 0 && ((*packet_count) % 100000) == 0)
+		frames_nr = xsk_source_recv(source, frames, PERF_XSK_BURST_MAX,
+		                            PERF_XSK_TIMEOUT);
+		if(frames_nr < 0)
 		{
-			fprintf(stderr, "decompression: packet #%lu\r", *packet_count);
-			fflush(stderr);
+			fprintf(stderr, "failed to receive frames: %s\n",
+			        xsk_source_geterr(source));
+			goto free_rohc;
 		}
 
-		/* decompress the ROHC packet */
-		ret = time_decompress_packet(decomp, *packet_count,
-		                             header, packet, link_len, arrival_time);
-		if(ret != 0)
+		for(i = 0; i < frames_nr && (*packet_count) < count; i++)
 		{
-			fprintf(stderr, "packet %lu: performance test failed\n",
-			        *packet_count);
-			goto free_decompressor;
+			/* skip the frames that do not carry an IP or ROHC packet */
+			if(!perf_xsk_frame_to_packet(is_comp, &frames[i]))
+			{
+				continue;
+			}
+
+			(*packet_count)++;
+			if(((*packet_count) % 100000) == 0)
+			{
+				fprintf(stderr, "%scompression: packet #%lu\r",
+				        (is_comp ? "" : "de"), *packet_count);
+				fflush(stderr);
+			}
+
+			/* (de)compress the packet in place in the UMEM */
+			if(is_comp)
+			{
+				ret = time_compress_packet(comp, *packet_count, frames[i], latency);
+			}
+			else
+			{
+				ret = time_decompress_packet(decomp, *packet_count, frames[i],
+				                             latency);
+			}
+			if(ret != 0)
+			{
+				fprintf(stderr, "packet %lu: performance test failed\n",
+				        *packet_count);
+				xsk_source_release(source);
+				goto free_rohc;
+			}
 		}
+
+		xsk_source_release(source);
+	}
+
+	perf_timing_stop(timing);
+
+	/* print the CPU cycles spent in every stage of (de)compression */
+	if(is_comp)
+	{
+		print_comp_stage_cycles(comp, *packet_count);
+	}
+	else
+	{
+		print_decomp_stage_cycles(decomp, *packet_count);
 	}
 
 	/* everything went fine */
 	is_failure = 0;
 
-free_decompressor:
-	rohc_decomp_free(decomp);
-close_input:
-	pcap_close(handle);
+free_rohc:
+	if(comp != NULL)
+	{
+		rohc_comp_free(comp);
+	}
+	if(decomp != NULL)
+	{
+		rohc_decomp_free(decomp);
+	}
+close_source:
+	xsk_source_close(source);
 exit:
 	return is_failure;
 }
 
 
 /**
- * @brief Determine the time required to decompress the given ROHC packet
- *        with the given decompressor
+ * @brief Get the IP or ROHC packet carried by one received Ethernet frame
  *
- * @param decomp        The decompressor to use to decompress the ROHC packet
- * @param num_packet    A number affected to the ROHC packet to decompress
- *                      (traces only)
- * @param header        The PCAP header for the packet
- * @param packet        The packet to decompress (link layer included)
- * @param link_len      The length of the link layer header before ROHC data
- * @return              0 if decompression is successful, 1 otherwise
+ * @param is_comp    Whether the frame shall carry an IP packet to compress
+ *                   or a ROHC packet to decompress
+ * @param[in,out] frame  The Ethernet frame, the IP or ROHC packet if true
+ *                       is returned
+ * @return           true if the frame carries the expected packet,
+ *                   false if the frame shall be ignored
  */
-static int time_decompress_packet(struct rohc_decomp *decomp,
-                                  unsigned long num_packet,
-                                  struct pcap_pkthdr header,
-                                  unsigned char *packet,
-                                  size_t link_len,
-                                  const struct rohc_ts arrival_time)
+static bool perf_xsk_frame_to_packet(const bool is_comp,
+                                     struct rohc_buf *const frame)
 {
-	/* the buffer that will contain the compressed ROHC packet */
-	struct rohc_buf rohc_packet =
-		rohc_buf_init_full(packet, header.caplen, arrival_time);
+	uint16_t ethertype;
 
-	/* the buffer that will contain the uncompressed packet */
-	uint8_t ip_buffer[MAX_ROHC_SIZE];
-	struct rohc_buf ip_packet = rohc_buf_init_empty(ip_buffer, MAX_ROHC_SIZE);
+	if(frame->len <= ETHER_HDR_LEN)
+	{
+		return false;
+	}
+	memcpy(&ethertype, rohc_buf_data_at(*frame, 12), sizeof(uint16_t));
+	ethertype = ntohs(ethertype);
 
-	int is_failure = 1;
-	rohc_status_t status;
+	if(!is_comp)
+	{
+		if(ethertype != PERF_ETHERTYPE_ROHC)
+		{
+			return false;
+		}
+		rohc_buf_pull(frame, ETHER_HDR_LEN);
+	}
+	else if(ethertype == 0x0800 || ethertype == 0x86dd)
+	{
+		const bool is_ipv4 = (ethertype == 0x0800);
+		const size_t ip_hdr_len =
+			(is_ipv4 ? sizeof(struct ipv4_hdr) : sizeof(struct ipv6_hdr));
+		size_t tot_len;
+
+		rohc_buf_pull(frame, ETHER_HDR_LEN);
+		if(frame->len < ip_hdr_len)
+		{
+			return false;
+		}
 
-	/* check Ethernet frame length */
-	if(header.len <= link_len || header.len != header.caplen)
+		/* remove the Ethernet padding after the IP packet */
+		if(is_ipv4)
+		{
+			const struct ipv4_hdr *const ipv4 =
+				(struct ipv4_hdr *) rohc_buf_data(*frame);
+			tot_len = ntohs(ipv4->tot_len);
+		}
+		else
+		{
+			const struct ipv6_hdr *const ipv6 =
+				(struct ipv6_hdr *) rohc_buf_data(*frame);
+			tot_len = sizeof(struct ipv6_hdr) + ntohs(ipv6->plen);
+		}
+		if(tot_len > frame->len)
+		{
+			return false;
+		}
+		frame->len = tot_len;
+	}
+	else
 	{
-		fprintf(stderr, "packet %lu: bad PCAP packet (len = %u, caplen = %u)\n",
-		        num_packet, header.len, header.caplen);
-		goto error;
+		return false;
 	}
 
-	/* skip the link layer header */
-	rohc_buf_pull(&rohc_packet, link_len);
+	return true;
+}
+
+#endif /* ROHC_WITH_AF_XDP */
 
-	/* decompress the packet */
-	status = rohc_decompress3(decomp, rohc_packet, &ip_packet, NULL, NULL);
-	if(status != ROHC_STATUS_OK)
+
+/**
+ * @brief Test the compression performance of the ROHC library
+ *        with a flow of IP packets
+ *
+ * @param is_verbose    Whether the test is run in verbose mode or not
+ * @param packets       The IP packets to compress
+ * @param repeat_nr     The number of times to compress the IP packets
+ * @param cid_type      The type of CIDs the compressor shall use
+ * @param wlsb_width    The width of the WLSB window to use
+ * @param max_contexts  The maximum number of ROHC contexts to use
+ * @param barrier       The barrier to wait for before compressing, so that
+ *                      all the threads start at once, NULL if no thread
+ * @param latency       OUT: the time elapsed per packet
+ * @param timing        OUT: the time spent to compress, NULL if not required
+ * @param packet_count  OUT: the number of compressed packets, undefined if
+ *                      compression failed
+ * @return              0 in case of success, 1 otherwise
+ */
+static int test_compression_perfs(const bool is_verbose,
+                                  const struct perf_packets *const packets,
+                                  const size_t repeat_nr,
+                                  const rohc_cid_type_t cid_type,
+                                  const size_t wlsb_width,
+                                  const size_t max_contexts,
+                                  pthread_barrier_t *const barrier,
+                                  struct perf_latency *const latency,
+                                  struct perf_timing *const timing,
+                                  unsigned long *packet_count)
+{
+	struct rohc_comp *comp;
+	bool barrier_reached = false;
+	size_t repeat;
+	size_t i;
+	int is_failure = 1;
+	int ret;
+
+	/* create ROHC compressor */
+	comp = perf_create_comp(&is_verbose, cid_type, wlsb_width, max_contexts);
+	if(comp == NULL)
 	{
-		fprintf(stderr, "packet %lu: decompression failed\n", num_packet);
-		goto error;
+		goto exit;
 	}
 
-	/* everything went fine */
-	is_failure = 0;
+	fflush(stderr);
 
-error:
-	return is_failure;
+	/* wait for the other threads, then start the timer */
+	if(barrier != NULL)
+	{
+		pthread_barrier_wait(barrier);
+		barrier_reached = true;
+	}
+	if(timing != NULL)
+	{
+		perf_timing_start(timing);
+	}
+
+	/* for each packet in the dump, as many times as requested */
+	*packet_count = 0;
+	for(repeat = 0; repeat < repeat_nr; repeat++)
+	{
+		for(i = 0; i < packets->bufs_nr; i++)
+		{
+			(*packet_count)++;
+			if(barrier == NULL && ((*packet_count) % 100000) == 0)
+			{
+				fprintf(stderr, "compression: packet #%lu\r", *packet_count);
+				fflush(stderr);
+			}
+
+			/* compress the IP packet */
+			ret = time_compress_packet(comp, *packet_count, packets->bufs[i],
+			                           latency);
+			if(ret != 0)
+			{
+				fprintf(stderr, "packet %lu: performance test failed\n",
+				        *packet_count);
+				goto free_compresssor;
+			}
+		}
+	}
+
+	if(timing != NULL)
+	{
+		perf_timing_stop(timing);
+	}
+
+	/* print the CPU cycles spent in every stage of compression */
+	if(barrier == NULL)
+	{
+		print_comp_stage_cycles(comp, *packet_count);
+	}
+
+	/* everything went fine */
+	is_failure = 0;
+
+free_compresssor:
+	rohc_comp_free(comp);
+exit:
+	/* do not let the other threads wait forever */
+	if(barrier != NULL && !barrier_reached)
+	{
+		pthread_barrier_wait(barrier);
+	}
+	return is_failure;
+}
+
+
+/**
+ * @brief Determine the time required to compress the given IP packet
+ *        with the given compressor
+ *
+ * @param comp          The compressor to use to compress the IP packet
+ * @param num_packet    A number affected to the IP packet to compress
+ *                      (traces only)
+ * @param ip_packet     The IP packet to compress
+ * @param latency       OUT: the time elapsed per packet
+ * @return              0 if compression is successful, 1 otherwise
+ */
+static int time_compress_packet(struct rohc_comp *comp,
+                                unsigned long num_packet,
+                                const struct rohc_buf ip_packet,
+                                struct perf_latency *const latency)
+{
+	/* the buffer that will contain the compressed ROHC packet */
+	uint8_t rohc_buffer[MAX_ROHC_SIZE];
+	struct rohc_buf rohc_packet =
+		rohc_buf_init_empty(rohc_buffer, MAX_ROHC_SIZE);
+
+	rohc_comp_last_packet_info2_t last_packet_info;
+	int is_failure = 1;
+	rohc_status_t status;
+	uint64_t start_ns;
+	uint64_t end_ns;
+
+	/* compress the packet */
+	start_ns = perf_now_ns();
+	status = rohc_compress4(comp, ip_packet, &rohc_packet);
+	end_ns = perf_now_ns();
+	if(status != ROHC_STATUS_OK)
+	{
+		fprintf(stderr, "packet %lu: compression failed\n", num_packet);
+		goto error;
+	}
+
+	/* record the time elapsed for the type of the ROHC packet */
+	last_packet_info.version_major = 0;
+	last_packet_info.version_minor = 0;
+	if(!rohc_comp_get_last_packet_info2(comp, &last_packet_info))
+	{
+		fprintf(stderr, "packet %lu: cannot get stats about the last "
+		        "compressed packet\n", num_packet);
+		goto error;
+	}
+	perf_latency_add(latency, last_packet_info.packet_type, end_ns - start_ns);
+
+	/* everything went fine */
+	is_failure = 0;
+
+error:
+	return is_failure;
+}
+
+
+/**
+ * @brief Test the decompression performance of the ROHC library
+ *        with a flow of IP packets
+ *
+ * @param is_verbose    Whether the test is run in verbose mode or not
+ * @param packets       The ROHC packets to decompress
+ * @param repeat_nr     The number of times to decompress the ROHC packets
+ * @param cid_type      The type of CIDs the decompressor shall use
+ * @param max_contexts  The maximum number of ROHC contexts to use
+ * @param barrier       The barrier to wait for before decompressing, so that
+ *                      all the threads start at once, NULL if no thread
+ * @param latency       OUT: the time elapsed per packet
+ * @param timing        OUT: the time spent to decompress, NULL if not required
+ * @param packet_count  OUT: the number of decompressed packets, undefined if
+ *                      decompression failed
+ * @return              0 in case of success, 1 otherwise
+ */
+static int test_decompression_perfs(const bool is_verbose,
+                                    const struct perf_packets *const packets,
+                                    const size_t repeat_nr,
+                                    const rohc_cid_type_t cid_type,
+                                    const size_t max_contexts,
+                                    pthread_barrier_t *const barrier,
+                                    struct perf_latency *const latency,
+                                    struct perf_timing *const timing,
+                                    unsigned long *packet_count)
+{
+	struct rohc_decomp *decomp;
+	bool barrier_reached = false;
+	size_t repeat;
+	size_t i;
+	int is_failure = 1;
+	int ret;
+
+	/* create ROHC decompressor */
+	decomp = perf_create_decomp(&is_verbose, cid_type, max_contexts);
+	if(decomp == NULL)
+	{
+		goto exit;
+	}
+
+	fflush(stderr);
+
+	/* wait for the other threads, then start the timer */
+	if(barrier != NULL)
+	{
+		pthread_barrier_wait(barrier);
+		barrier_reached = true;
+	}
+	if(timing != NULL)
+	{
+		perf_timing_start(timing);
+	}
+
+	/* for each packet in the dump, as many times as requested */
+	*packet_count = 0;
+	for(repeat = 0; repeat < repeat_nr; repeat++)
+	{
+		for(i = 0; i < packets->bufs_nr; i++)
+		{
+			(*packet_count)++;
+			if(barrier == NULL && ((*packet_count) % 100000) == 0)
+			{
+				fprintf(stderr, "decompression: packet #%lu\r", *packet_count);
+				fflush(stderr);
+			}
+
+			/* decompress the ROHC packet */
+			ret = time_decompress_packet(decomp, *packet_count, packets->bufs[i],
+			                             latency);
+			if(ret != 0)
+			{
+				fprintf(stderr, "packet %lu: performance test failed\n",
+				        *packet_count);
+				goto free_decompressor;
+			}
+		}
+	}
+
+	if(timing != NULL)
+	{
+		perf_timing_stop(timing);
+	}
+
+	/* print the CPU cycles spent in every stage of decompression */
+	if(barrier == NULL)
+	{
+		print_decomp_stage_cycles(decomp, *packet_count);
+	}
+
+	/* everything went fine */
+	is_failure = 0;
+
+free_decompressor:
+	rohc_decomp_free(decomp);
+exit:
+	/* do not let the other threads wait forever */
+	if(barrier != NULL && !barrier_reached)
+	{
+		pthread_barrier_wait(barrier);
+	}
+	return is_failure;
+}
+
+
+/**
+ * @brief Determine the time required to decompress the given ROHC packet
+ *        with the given decompressor
+ *
+ * @param decomp        The decompressor to use to decompress the ROHC packet
+ * @param num_packet    A number affected to the ROHC packet to decompress
+ *                      (traces only)
+ * @param rohc_packet   The ROHC packet to decompress
+ * @param latency       OUT: the time elapsed per packet
+ * @return              0 if decompression is successful, 1 otherwise
+ */
+static int time_decompress_packet(struct rohc_decomp *decomp,
+                                  unsigned long num_packet,
+                                  const struct rohc_buf rohc_packet,
+                                  struct perf_latency *const latency)
+{
+	/* the buffer that will contain the uncompressed packet */
+	uint8_t ip_buffer[MAX_ROHC_SIZE];
+	struct rohc_buf ip_packet = rohc_buf_init_empty(ip_buffer, MAX_ROHC_SIZE);
+
+	rohc_decomp_last_packet_info_t last_packet_info;
+	int is_failure = 1;
+	rohc_status_t status;
+	uint64_t start_ns;
+	uint64_t end_ns;
+
+	/* decompress the packet */
+	start_ns = perf_now_ns();
+	status = rohc_decompress3(decomp, rohc_packet, &ip_packet, NULL, NULL);
+	end_ns = perf_now_ns();
+	if(status != ROHC_STATUS_OK)
+	{
+		fprintf(stderr, "packet %lu: decompression failed\n", num_packet);
+		goto error;
+	}
+
+	/* record the time elapsed for the type of the ROHC packet */
+	last_packet_info.version_major = 0;
+	last_packet_info.version_minor = 1;
+	if(!rohc_decomp_get_last_packet_info(decomp, &last_packet_info))
+	{
+		fprintf(stderr, "packet %lu: cannot get stats about the last "
+		        "decompressed packet\n", num_packet);
+		goto error;
+	}
+	perf_latency_add(latency, last_packet_info.packet_type, end_ns - start_ns);
+
+	/* everything went fine */
+	is_failure = 0;
+
+error:
+	return is_failure;
+}
+
+
+/**
+ * @brief Start to measure the time spent to (de)compress
+ *
+ * @param timing  The time spent to (de)compress
+ */
+static void perf_timing_start(struct perf_timing *const timing)
+{
+	if(timing->counters.is_enabled)
+	{
+		perf_counters_start(&timing->counters);
+	}
+	timing->cycles = perf_now_cycles();
+	timing->start_ns = perf_now_ns();
+}
+
+
+/**
+ * @brief Stop to measure the time spent to (de)compress
+ *
+ * @param timing  The time spent to (de)compress
+ */
+static void perf_timing_stop(struct perf_timing *const timing)
+{
+	timing->end_ns = perf_now_ns();
+	timing->cycles = perf_now_cycles() - timing->cycles;
+	if(timing->counters.is_enabled)
+	{
+		perf_counters_stop(&timing->counters);
+	}
+}
+
+
+/**
+ * @brief Get the current time of the monotonic clock
+ *
+ * @return  The current time (in nanoseconds)
+ */
+static uint64_t perf_now_ns(void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return ((uint64_t) now.tv_sec) * 1000000000U + now.tv_nsec;
+}
+
+
+/**
+ * @brief Get the current value of the CPU cycle counter
+ *
+ * @return  The current value of the time-stamp counter on x86,
+ *          always 0 on the other architectures
+ */
+static uint64_t perf_now_cycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#else
+	return 0;
+#endif
+}
+
+
+/**
+ * @brief Open and start the hardware counters of the calling thread
+ *
+ * The events that the CPU or the kernel do not support are not counted.
+ * The counters are independent of each other, so that the kernel may
+ * multiplex them if the CPU has not enough hardware counters: the values
+ * are then scaled by \ref perf_counters_stop.
+ *
+ * @param counters  The hardware counters
+ */
+static void perf_counters_start(struct perf_counters *const counters)
+{
+#ifdef PERF_HAVE_COUNTERS
+	const struct
+	{
+		uint32_t type;
+		uint64_t config;
+	} events[PERF_COUNTERS_NR] = {
+		[PERF_COUNTER_INSTRUCTIONS] =
+			{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+		[PERF_COUNTER_CYCLES] =
+			{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+		[PERF_COUNTER_L1D_MISSES] =
+			{ PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D |
+			                      (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+			                      (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+		[PERF_COUNTER_LLC_MISSES] =
+			{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+		[PERF_COUNTER_BRANCH_MISSES] =
+			{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+	};
+	bool is_one_opened = false;
+	size_t i;
+
+	for(i = 0; i < PERF_COUNTERS_NR; i++)
+	{
+		struct perf_event_attr attr;
+
+		memset(&attr, 0, sizeof(struct perf_event_attr));
+		attr.size = sizeof(struct perf_event_attr);
+		attr.type = events[i].type;
+		attr.config = events[i].config;
+		attr.disabled = 1;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		attr.read_format =
+			PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+		/* count the events of the calling thread on any CPU */
+		counters->fds[i] = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+		counters->is_counted[i] = false;
+		counters->values[i] = 0;
+		if(counters->fds[i] >= 0)
+		{
+			is_one_opened = true;
+		}
+	}
+	if(!is_one_opened)
+	{
+		fprintf(stderr, "warning: no hardware counter available: %s (%d), "
+		        "check /proc/sys/kernel/perf_event_paranoid\n", strerror(errno),
+		        errno);
+	}
+
+	for(i = 0; i < PERF_COUNTERS_NR; i++)
+	{
+		if(counters->fds[i] >= 0)
+		{
+			ioctl(counters->fds[i], PERF_EVENT_IOC_RESET, 0);
+			ioctl(counters->fds[i], PERF_EVENT_IOC_ENABLE, 0);
+		}
+	}
+#else
+	size_t i;
+
+	fprintf(stderr, "warning: no hardware counter available on this "
+	        "platform\n");
+	for(i = 0; i < PERF_COUNTERS_NR; i++)
+	{
+		counters->fds[i] = -1;
+		counters->is_counted[i] = false;
+		counters->values[i] = 0;
+	}
+#endif
+}
+
+
+/**
+ * @brief Stop, read and close the hardware counters of the calling thread
+ *
+ * @param counters  The hardware counters, unused if the platform has no
+ *                  hardware counter
+ */
+static void perf_counters_stop(struct perf_counters *const counters
+                               __attribute__((unused)))
+{
+#ifdef PERF_HAVE_COUNTERS
+	size_t i;
+
+	for(i = 0; i < PERF_COUNTERS_NR; i++)
+	{
+		if(counters->fds[i] >= 0)
+		{
+			ioctl(counters->fds[i], PERF_EVENT_IOC_DISABLE, 0);
+		}
+	}
+
+	for(i = 0; i < PERF_COUNTERS_NR; i++)
+	{
+		/* the value, the time enabled and the time running */
+		uint64_t data[3];
+
+		if(counters->fds[i] < 0)
+		{
+			continue;
+		}
+		if(read(counters->fds[i], data, sizeof(data)) == sizeof(data) &&
+		   data[2] > 0)
+		{
+			/* scale the value if the counter was multiplexed */
+			counters->values[i] = (data[2] >= data[1] ? data[0] :
+			                       (uint64_t) (((double) data[0]) * data[1] / data[2]));
+			counters->is_counted[i] = true;
+		}
+		close(counters->fds[i]);
+		counters->fds[i] = -1;
+	}
+#endif
+}
+
+
+/**
+ * @brief Add the hardware events counted in one thread to another one
+ *
+ * An event is counted only if it was counted in all the threads.
+ *
+ * @param counters  The hardware counters to update
+ * @param other     The hardware counters to add
+ */
+static void perf_counters_merge(struct perf_counters *const counters,
+                                const struct perf_counters *const other)
+{
+	size_t i;
+
+	for(i = 0; i < PERF_COUNTERS_NR; i++)
+	{
+		counters->is_counted[i] = (counters->is_counted[i] && other->is_counted[i]);
+		counters->values[i] += other->values[i];
+	}
+}
+
+
+/**
+ * @brief Print the hardware events counted per packet
+ *
+ * @param counters      The hardware counters
+ * @param packet_count  The number of (de)compressed packets
+ */
+static void print_counters(const struct perf_counters *const counters,
+                           const unsigned long packet_count)
+{
+	const char *const names[PERF_COUNTERS_NR] = {
+		[PERF_COUNTER_INSTRUCTIONS] = "instructions",
+		[PERF_COUNTER_CYCLES] = "cycles",
+		[PERF_COUNTER_L1D_MISSES] = "L1d misses",
+		[PERF_COUNTER_LLC_MISSES] = "LLC misses",
+		[PERF_COUNTER_BRANCH_MISSES] = "branch misses",
+	};
+	size_t i;
+
+	fprintf(stderr, "hardware counters per packet:\n");
+	for(i = 0; i < PERF_COUNTERS_NR; i++)
+	{
+		if(!counters->is_counted[i])
+		{
+			fprintf(stderr, "  %-16s %12s\n", names[i], "n/a");
+		}
+		else
+		{
+			fprintf(stderr, "  %-16s %12.2f\n", names[i],
+			        packet_count == 0 ? 0.0 :
+			        ((double) counters->values[i]) / packet_count);
+		}
+	}
+	if(counters->is_counted[PERF_COUNTER_INSTRUCTIONS] &&
+	   counters->is_counted[PERF_COUNTER_CYCLES] &&
+	   counters->values[PERF_COUNTER_CYCLES] > 0)
+	{
+		fprintf(stderr, "  %-16s %12.2f\n", "IPC",
+		        ((double) counters->values[PERF_COUNTER_INSTRUCTIONS]) /
+		        counters->values[PERF_COUNTER_CYCLES]);
+	}
+}
+
+
+/**
+ * @brief Record the time elapsed for one packet
+ *
+ * @param latency      The histograms of the time elapsed per packet
+ * @param packet_type  The type of the ROHC packet
+ * @param duration_ns  The time elapsed (in nanoseconds)
+ */
+static void perf_latency_add(struct perf_latency *const latency,
+                             const rohc_packet_t packet_type,
+                             const uint64_t duration_ns)
+{
+	struct perf_histo *const histo = &latency->packet_types[packet_type];
+
+	assert(packet_type < ROHC_PACKET_MAX);
+	histo->buckets[perf_histo_get_bucket(duration_ns)]++;
+	histo->packets_nr++;
+	histo->total_ns += duration_ns;
+	if(duration_ns > histo->max_ns)
+	{
+		histo->max_ns = duration_ns;
+	}
+}
+
+
+/**
+ * @brief Add the time elapsed per packet in one thread to another one
+ *
+ * @param latency  The histograms to update
+ * @param other    The histograms to add
+ */
+static void perf_latency_merge(struct perf_latency *const latency,
+                               const struct perf_latency *const other)
+{
+	size_t type;
+	size_t bucket;
+
+	for(type = 0; type < ROHC_PACKET_MAX; type++)
+	{
+		struct perf_histo *const histo = &latency->packet_types[type];
+		const struct perf_histo *const other_histo = &other->packet_types[type];
+
+		for(bucket = 0; bucket < PERF_HISTO_BUCKETS_NR; bucket++)
+		{
+			histo->buckets[bucket] += other_histo->buckets[bucket];
+		}
+		histo->packets_nr += other_histo->packets_nr;
+		histo->total_ns += other_histo->total_ns;
+		if(other_histo->max_ns > histo->max_ns)
+		{
+			histo->max_ns = other_histo->max_ns;
+		}
+	}
+}
+
+
+/**
+ * @brief Summarize one histogram or the sum of several histograms
+ *
+ * The percentiles are the upper bounds of the buckets that contain them.
+ *
+ * @param histos     The histograms to summarize
+ * @param histos_nr  The number of histograms
+ * @param summary    OUT: The summary of the histograms
+ */
+static void perf_latency_summarize(const struct perf_histo histos[],
+                                   const size_t histos_nr,
+                                   struct perf_summary *const summary)
+{
+	/* the percentiles to compute, in thousandths */
+	const unsigned int ranks[3] = { 500, 900, 990 };
+	uint64_t percentiles[3] = { 0, 0, 0 };
+	uint64_t packets_nr = 0;
+	uint64_t total_ns = 0;
+	uint64_t max_ns = 0;
+	uint64_t cumul = 0;
+	size_t rank = 0;
+	size_t bucket;
+	size_t i;
+
+	for(i = 0; i < histos_nr; i++)
+	{
+		packets_nr += histos[i].packets_nr;
+		total_ns += histos[i].total_ns;
+		if(histos[i].max_ns > max_ns)
+		{
+			max_ns = histos[i].max_ns;
+		}
+	}
+
+	/* walk the buckets until the packets of all the percentiles are found */
+	for(bucket = 0; bucket < PERF_HISTO_BUCKETS_NR && rank < 3; bucket++)
+	{
+		for(i = 0; i < histos_nr; i++)
+		{
+			cumul += histos[i].buckets[bucket];
+		}
+		while(rank < 3 && cumul > 0 &&
+		      cumul * 1000 >= packets_nr * ranks[rank])
+		{
+			const uint64_t bucket_max = perf_histo_get_bucket_max(bucket);
+			percentiles[rank] = (bucket_max < max_ns ? bucket_max : max_ns);
+			rank++;
+		}
+	}
+
+	summary->packets_nr = packets_nr;
+	summary->mean_ns = (packets_nr == 0 ? 0.0 : ((double) total_ns) / packets_nr);
+	summary->p50_ns = percentiles[0];
+	summary->p90_ns = percentiles[1];
+	summary->p99_ns = percentiles[2];
+	summary->max_ns = max_ns;
+}
+
+
+/**
+ * @brief Get the bucket of the histogram for the given time elapsed
+ *
+ * @param duration_ns  The time elapsed (in nanoseconds)
+ * @return             The index of the bucket
+ */
+static size_t perf_histo_get_bucket(const uint64_t duration_ns)
+{
+	const uint64_t max_ns = (((uint64_t) 1) << 32) - 1;
+	const uint64_t value = (duration_ns > max_ns ? max_ns : duration_ns);
+	size_t msb;
+
+	/* one bucket per value for the smallest values */
+	if(value < (1U << PERF_HISTO_SUB_BITS))
+	{
+		return value;
+	}
+
+	/* otherwise, the power of 2 selects a group of buckets and the next
+	 * most significant bits select the bucket within the group */
+	msb = 63 - __builtin_clzll(value);
+	return (((msb - PERF_HISTO_SUB_BITS + 1) << PERF_HISTO_SUB_BITS) +
+	        ((value >> (msb - PERF_HISTO_SUB_BITS)) &
+	         ((1U << PERF_HISTO_SUB_BITS) - 1)));
+}
+
+
+/**
+ * @brief Get the largest time elapsed recorded in the given bucket
+ *
+ * @param bucket  The index of the bucket
+ * @return        The largest time elapsed of the bucket (in nanoseconds)
+ */
+static uint64_t perf_histo_get_bucket_max(const size_t bucket)
+{
+	const size_t group = bucket >> PERF_HISTO_SUB_BITS;
+	const size_t sub = bucket & ((1U << PERF_HISTO_SUB_BITS) - 1);
+	uint64_t width;
+
+	if(group == 0)
+	{
+		return bucket;
+	}
+	width = ((uint64_t) 1) << (group - 1);
+
+	return (((1U << PERF_HISTO_SUB_BITS) + sub + 1) * width - 1);
+}
+
+
+/**
+ * @brief Print the time elapsed per packet, for every type of ROHC packet
+ *
+ * @param latency  The histograms of the time elapsed per packet
+ */
+static void print_latency(const struct perf_latency *const latency)
+{
+	struct perf_summary summary;
+	size_t type;
+
+	fprintf(stderr, "time per packet (ns):\n");
+	fprintf(stderr, "  %-16s %10s %10s %10s %10s %10s %10s\n", "packet type",
+	        "packets", "mean", "p50", "p90", "p99", "max");
+	for(type = 0; type < ROHC_PACKET_MAX; type++)
+	{
+		if(latency->packet_types[type].packets_nr == 0)
+		{
+			continue;
+		}
+		perf_latency_summarize(&latency->packet_types[type], 1, &summary);
+		fprintf(stderr, "  %-16s %10" PRIu64 " %10.1f %10" PRIu64 " %10" PRIu64
+		        " %10" PRIu64 " %10" PRIu64 "\n", rohc_get_packet_descr(type),
+		        summary.packets_nr, summary.mean_ns, summary.p50_ns,
+		        summary.p90_ns, summary.p99_ns, summary.max_ns);
+	}
+	perf_latency_summarize(latency->packet_types, ROHC_PACKET_MAX, &summary);
+	fprintf(stderr, "  %-16s %10" PRIu64 " %10.1f %10" PRIu64 " %10" PRIu64
+	        " %10" PRIu64 " %10" PRIu64 "\n", "all", summary.packets_nr,
+	        summary.mean_ns, summary.p50_ns, summary.p90_ns, summary.p99_ns,
+	        summary.max_ns);
+}
+
+
+/**
+ * @brief Write the results of the test in JSON format
+ *
+ * @param json_filename  The name of the file where to write the results,
+ *                       '-' for the standard output
+ * @param test_type      The name of the test: 'comp' or 'decomp'
+ * @param cid_type_name  The type of CIDs: 'smallcid' or 'largecid'
+ * @param filename       The name of the PCAP capture used as input
+ * @param repeat_nr      The number of times the capture was replayed
+ * @param threads_nr     The number of threads, 0 if no thread
+ * @param packet_count   The number of (de)compressed packets
+ * @param timing         The time spent to (de)compress all the packets
+ * @param latency        The histograms of the time elapsed per packet
+ * @return               true if the results were successfully written,
+ *                       false otherwise
+ */
+static bool write_json_report(const char *const json_filename,
+                              const char *const test_type,
+                              const char *const cid_type_name,
+                              const char *const filename,
+                              const size_t repeat_nr,
+                              const size_t threads_nr,
+                              const unsigned long packet_count,
+                              const struct perf_timing *const timing,
+                              const struct perf_latency *const latency)
+{
+	const uint64_t elapsed_ns = timing->end_ns - timing->start_ns;
+	const char *git_ref = PACKAGE_REVNO;
+	struct perf_summary summary;
+	bool is_first = true;
+	FILE *out;
+	size_t type;
+
+	if(!strcmp(json_filename, "-"))
+	{
+		out = stdout;
+	}
+	else
+	{
+		out = fopen(json_filename, "w");
+		if(out == NULL)
+		{
+			fprintf(stderr, "failed to open '%s': %s (%d)\n", json_filename,
+			        strerror(errno), errno);
+			goto error;
+		}
+	}
+
+	/* the git revision is prefixed by a tilde in the version string */
+	if(git_ref[0] == '~')
+	{
+		git_ref++;
+	}
+
+	fprintf(out, "{\n");
+	fprintf(out, "  \"library_version\": ");
+	print_json_string(out, rohc_version());
+	fprintf(out, ",\n  \"git_ref\": ");
+	print_json_string(out, git_ref);
+	fprintf(out, ",\n  \"test\": ");
+	print_json_string(out, test_type);
+	fprintf(out, ",\n  \"cid_type\": ");
+	print_json_string(out, cid_type_name);
+	fprintf(out, ",\n  \"capture\": ");
+	print_json_string(out, filename);
+	fprintf(out, ",\n  \"repeat\": %zu,\n", repeat_nr);
+	fprintf(out, "  \"threads\": %zu,\n", threads_nr);
+	fprintf(out, "  \"packets\": %lu,\n", packet_count);
+	fprintf(out, "  \"elapsed_ns\": %" PRIu64 ",\n", elapsed_ns);
+	fprintf(out, "  \"packets_per_second\": %.1f,\n",
+	        elapsed_ns == 0 ? 0.0 : ((double) packet_count) * 1e9 / elapsed_ns);
+	if(timing->cycles > 0 && packet_count > 0)
+	{
+		fprintf(out, "  \"cycles_per_packet\": %.1f,\n",
+		        ((double) timing->cycles) / packet_count);
+	}
+	else
+	{
+		fprintf(out, "  \"cycles_per_packet\": null,\n");
+	}
+	if(timing->counters.is_enabled && packet_count > 0)
+	{
+		const char *const names[PERF_COUNTERS_NR] = {
+			[PERF_COUNTER_INSTRUCTIONS] = "instructions",
+			[PERF_COUNTER_CYCLES] = "cycles",
+			[PERF_COUNTER_L1D_MISSES] = "l1d_misses",
+			[PERF_COUNTER_LLC_MISSES] = "llc_misses",
+			[PERF_COUNTER_BRANCH_MISSES] = "branch_misses",
+		};
+
+		fprintf(out, "  \"counters_per_packet\": {");
+		for(type = 0; type < PERF_COUNTERS_NR; type++)
+		{
+			fprintf(out, "%s \"%s\": ", type == 0 ? "" : ",", names[type]);
+			if(timing->counters.is_counted[type])
+			{
+				fprintf(out, "%.2f",
+				        ((double) timing->counters.values[type]) / packet_count);
+			}
+			else
+			{
+				fprintf(out, "null");
+			}
+		}
+		fprintf(out, " },\n");
+	}
+	else
+	{
+		fprintf(out, "  \"counters_per_packet\": null,\n");
+	}
+	fprintf(out, "  \"latency_ns\": {\n");
+	fprintf(out, "    \"all\": ");
+	perf_latency_summarize(latency->packet_types, ROHC_PACKET_MAX, &summary);
+	print_json_summary(out, &summary);
+	fprintf(out, ",\n    \"packet_types\": {");
+	for(type = 0; type < ROHC_PACKET_MAX; type++)
+	{
+		if(latency->packet_types[type].packets_nr == 0)
+		{
+			continue;
+		}
+		fprintf(out, "%s\n      ", is_first ? "" : ",");
+		print_json_string(out, rohc_get_packet_descr(type));
+		fprintf(out, ": ");
+		perf_latency_summarize(&latency->packet_types[type], 1, &summary);
+		print_json_summary(out, &summary);
+		is_first = false;
+	}
+	fprintf(out, "\n    }\n");
+	fprintf(out, "  }\n");
+	fprintf(out, "}\n");
+
+	if(out == stdout)
+	{
+		fflush(stdout);
+	}
+	else if(fclose(out) != 0)
+	{
+		fprintf(stderr, "failed to write '%s': %s (%d)\n", json_filename,
+		        strerror(errno), errno);
+		goto error;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Print one string in JSON format
+ *
+ * @param out  The stream where to print the string
+ * @param str  The string to print
+ */
+static void print_json_string(FILE *const out, const char *const str)
+{
+	const char *c;
+
+	fputc('"', out);
+	for(c = str; *c != '\0'; c++)
+	{
+		if(*c == '"' || *c == '\\')
+		{
+			fprintf(out, "\\%c", *c);
+		}
+		else if(((unsigned char) *c) < 0x20)
+		{
+			fprintf(out, "\\u%04x", (unsigned int) *c);
+		}
+		else
+		{
+			fputc(*c, out);
+		}
+	}
+	fputc('"', out);
+}
+
+
+/**
+ * @brief Print the summary of the time elapsed per packet in JSON format
+ *
+ * @param out      The stream where to print the summary
+ * @param summary  The summary to print
+ */
+static void print_json_summary(FILE *const out,
+                               const struct perf_summary *const summary)
+{
+	fprintf(out, "{ \"packets\": %" PRIu64 ", \"mean\": %.1f, "
+	        "\"p50\": %" PRIu64 ", \"p90\": %" PRIu64 ", \"p99\": %" PRIu64 ", "
+	        "\"max\": %" PRIu64 " }", summary->packets_nr, summary->mean_ns,
+	        summary->p50_ns, summary->p90_ns, summary->p99_ns, summary->max_ns);
+}
+
+
+/**
+ * @brief Print the CPU cycles spent in every stage of compression
+ *
+ * Nothing is printed if the library was built without the accounting of
+ * the CPU cycles (configure option --enable-stage-cycles).
+ *
+ * @param comp          The compressor that compressed the packets
+ * @param packet_count  The number of compressed packets
+ */
+static void print_comp_stage_cycles(const struct rohc_comp *const comp,
+                                    const unsigned long packet_count)
+{
+	uint64_t cycles[ROHC_COMP_STAGE_MAX];
+	uint64_t total = 0;
+	int stage;
+
+	for(stage = 0; stage < ROHC_COMP_STAGE_MAX; stage++)
+	{
+		if(!rohc_comp_get_stage_cycles(comp, stage, &cycles[stage]))
+		{
+			return;
+		}
+		total += cycles[stage];
+	}
+
+	fprintf(stderr, "compression stages (cycles per packet):\n");
+	for(stage = 0; stage < ROHC_COMP_STAGE_MAX; stage++)
+	{
+		fprintf(stderr, "  %-16s %10.1f  %5.1f%%\n",
+		        rohc_comp_get_stage_descr(stage),
+		        packet_count == 0 ? 0.0 : ((double) cycles[stage]) / packet_count,
+		        total == 0 ? 0.0 : ((double) cycles[stage]) * 100 / total);
+	}
+}
+
+
+/**
+ * @brief Print the CPU cycles spent in every stage of decompression
+ *
+ * Nothing is printed if the library was built without the accounting of
+ * the CPU cycles (configure option --enable-stage-cycles).
+ *
+ * @param decomp        The decompressor that decompressed the packets
+ * @param packet_count  The number of decompressed packets
+ */
+static void print_decomp_stage_cycles(const struct rohc_decomp *const decomp,
+                                      const unsigned long packet_count)
+{
+	uint64_t cycles[ROHC_DECOMP_STAGE_MAX];
+	uint64_t total = 0;
+	int stage;
+
+	for(stage = 0; stage < ROHC_DECOMP_STAGE_MAX; stage++)
+	{
+		if(!rohc_decomp_get_stage_cycles(decomp, stage, &cycles[stage]))
+		{
+			return;
+		}
+		total += cycles[stage];
+	}
+
+	fprintf(stderr, "decompression stages (cycles per packet):\n");
+	for(stage = 0; stage < ROHC_DECOMP_STAGE_MAX; stage++)
+	{
+		fprintf(stderr, "  %-16s %10.1f  %5.1f%%\n",
+		        rohc_decomp_get_stage_descr(stage),
+		        packet_count == 0 ? 0.0 : ((double) cycles[stage]) / packet_count,
+		        total == 0 ? 0.0 : ((double) cycles[stage]) * 100 / total);
+	}
 }
 
 
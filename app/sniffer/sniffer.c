@@ -31,10 +31,22 @@
  *   the ROHC library with them. The packets are compressed, then decompressed,
  *   and finally compared with the original IP packets.
  *
+ *   The packets are captured in a large ring buffer shared with the kernel
+ *   (PACKET_MMAP TPACKET_V3 on Linux, set up by libpcap). All the packets of
+ *   the blocks filled by the kernel are tested at once, without copying them
+ *   out of the ring buffer.
+ *
+ *   With the --workers option, the packets are fanned out by flow to several
+ *   worker threads, every thread with its own compressor/decompressor couple.
+ *   The packets of one flow are always tested by the same worker, in their
+ *   capture order. The capture thread copies every packet in the queue of
+ *   its worker, so that the blocks of the ring buffer are released quickly.
+ *
  * Statistics:
  *   Some statistics are gathered during the tests. There are printed on the
  *   console. More stats should be added. A better way to export them remains to
- *   be added too.
+ *   be added too. With several workers, every worker gathers its own stats,
+ *   they are merged when printed.
  *
  * Post-mortem bug analysis:
  *   The program stops (assertion) if compression/decompression/comparison
@@ -64,9 +76,11 @@
 #include <syslog.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <sys/time.h>
 #include <fcntl.h>
 #include <limits.h>
 #include <linux/if.h>
+#include <pthread.h>
 
 /* include for the PCAP library */
 #if HAVE_PCAP_PCAP_H == 1
@@ -83,6 +97,11 @@ for ./configure ? If yes, check configure output and config.log"
 #include <rohc/rohc_comp.h>
 #include <rohc/rohc_decomp.h>
 
+/* include for the AF_XDP capture */
+#if ROHC_WITH_AF_XDP == 1
+#  include "xsk_source.h"
+#endif
+
 
 
 /** Return the smaller value from the two */
@@ -105,6 +124,24 @@ for ./configure ? If yes, check configure output and config.log"
 /** The minimum Ethernet length (in bytes) */
 #define ETHER_FRAME_MIN_LEN  60U
 
+/** The default size (in MiB) of the capture ring buffer */
+#define SNIFFER_CAPTURE_BUFFER_SIZE  64
+
+/** The time (in milliseconds) the kernel waits for a block of the capture
+ *  ring buffer to fill before delivering it partially filled */
+#define SNIFFER_CAPTURE_TIMEOUT  100
+
+/** The maximum number of worker threads */
+#define SNIFFER_WORKERS_MAX  64
+
+/** The number of packets that may wait in the queue of one worker thread */
+#define SNIFFER_WORKER_QUEUE_LEN  512U
+
+#if ROHC_WITH_AF_XDP == 1
+/** The maximum number of frames received at once with AF_XDP */
+#  define SNIFFER_XSK_BURST_MAX  64U
+#endif
+
 
 /** Some statistics collected by the sniffer */
 struct sniffer_stats_t
@@ -158,6 +195,75 @@ struct sniffer_stats_t
 };
 
 
+/** The state of one capture, shared by all the captured packets */
+struct sniffer_capture
+{
+	struct rohc_comp *comp;       /**< The ROHC compressor */
+	struct rohc_decomp *decomp;   /**< The ROHC decompressor */
+	pcap_t *handle;               /**< The PCAP handle of the capture */
+	size_t link_len_src;          /**< The length of the link layer header */
+	struct rohc_buf feedback_send; /**< The feedback to piggyback */
+	struct sniffer_stats_t *stats; /**< The statistics to update */
+	pcap_dumper_t **dumpers;      /**< The PCAP dumpers, one per context */
+	int worker_id;                /**< The worker thread, -1 if none */
+
+	unsigned int nb_ok;           /**< The number of successful tests */
+	unsigned int nb_bad;          /**< The number of bad packets */
+	unsigned int nb_internal_err; /**< The number of internal errors */
+	unsigned int err_comp;        /**< The number of compression errors */
+	unsigned int err_decomp;      /**< The number of decompression errors */
+	unsigned int nb_ref;          /**< The number of comparison errors */
+};
+
+
+/** One packet copied in the queue of a worker thread */
+struct sniffer_slot
+{
+	struct pcap_pkthdr header;  /**< The PCAP header of the packet */
+	uint8_t *data;              /**< The packet, grown on demand */
+	size_t data_max;            /**< The size of the packet buffer */
+};
+
+
+/**
+ * @brief One worker thread that tests the packets of some flows
+ *
+ * The capture thread fills the queue, the worker thread empties it. Every
+ * slot of the queue is owned by one of them at a time, the lock only
+ * protects the head and the tail of the queue.
+ */
+struct sniffer_worker
+{
+	pthread_t thread;             /**< The worker thread */
+	int id;                       /**< The index of the worker */
+	bool is_started;              /**< Whether the thread was created */
+
+	struct sniffer_capture capture; /**< The state of the capture */
+	struct sniffer_stats_t stats; /**< The statistics of the worker */
+	pthread_mutex_t stats_lock;   /**< Held while one packet is tested */
+	pcap_dumper_t *dumpers[ROHC_LARGE_CID_MAX + 1]; /**< One per context */
+	uint8_t feedback_send_buffer[MAX_ROHC_SIZE]; /**< For feedback_send */
+
+	pthread_mutex_t queue_lock;      /**< Protects the head and the tail */
+	pthread_cond_t queue_not_empty;  /**< Signaled by the capture thread */
+	pthread_cond_t queue_not_full;   /**< Signaled by the worker thread */
+	size_t queue_head;               /**< The next packet to test */
+	size_t queue_tail;               /**< The next free slot */
+	bool is_stopping;                /**< Whether to stop once empty */
+	struct sniffer_slot slots[SNIFFER_WORKER_QUEUE_LEN]; /**< The queue */
+};
+
+
+/** The state of the capture thread in worker mode */
+struct sniffer_dispatcher
+{
+	struct sniffer_worker *workers;  /**< The worker threads */
+	size_t workers_nr;               /**< The number of worker threads */
+	size_t link_len_src;             /**< The length of the link layer header */
+	unsigned long packets_nr;        /**< The number of captured packets */
+};
+
+
 /* prototypes of private functions */
 
 static void usage(void);
@@ -167,8 +273,60 @@ static void sniffer_print_stats(int signum);
 static bool sniff(const rohc_cid_type_t cid_type,
                   const size_t max_contexts,
                   const int enabled_profiles[],
-                  const char *const device_name)
+                  const char *const device_name,
+                  const int capture_buffer_size,
+                  const int xsk_queue,
+                  const int workers_nr)
 	__attribute__((warn_unused_result, nonnull(4)));
+static struct rohc_comp * sniffer_create_comp(const rohc_cid_type_t cid_type,
+                                              const size_t max_contexts,
+                                              const int enabled_profiles[])
+	__attribute__((warn_unused_result, nonnull(3)));
+static struct rohc_decomp * sniffer_create_decomp(const rohc_cid_type_t cid_type,
+                                                  const size_t max_contexts,
+                                                  const int enabled_profiles[])
+	__attribute__((warn_unused_result, nonnull(3)));
+static void sniff_packet(u_char *const user,
+                         const struct pcap_pkthdr *const header,
+                         const u_char *const packet)
+	__attribute__((nonnull(1, 2, 3)));
+static void sniffer_test_packet(struct sniffer_capture *const capture,
+                                const struct pcap_pkthdr *const header,
+                                const u_char *const packet)
+	__attribute__((nonnull(1, 2, 3)));
+static void sniffer_print_progress(const unsigned long packets_nr);
+#if ROHC_WITH_AF_XDP == 1
+static bool sniff_xsk_burst(struct xsk_source *const source,
+                            pcap_handler callback,
+                            u_char *const user)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+#endif
+
+static struct sniffer_worker * sniffer_workers_start(const size_t workers_nr,
+                                                     const rohc_cid_type_t cid_type,
+                                                     const size_t max_contexts,
+                                                     const int enabled_profiles[],
+                                                     pcap_t *const handle,
+                                                     const size_t link_len_src)
+	__attribute__((warn_unused_result, nonnull(4, 5)));
+static void sniffer_workers_stop(struct sniffer_worker *const workers,
+                                 const size_t workers_nr,
+                                 const size_t max_contexts)
+	__attribute__((nonnull(1)));
+static void * sniffer_worker_run(void *const arg)
+	__attribute__((nonnull(1)));
+static void sniff_dispatch(u_char *const user,
+                           const struct pcap_pkthdr *const header,
+                           const u_char *const packet)
+	__attribute__((nonnull(1, 2, 3)));
+static uint32_t sniffer_flow_hash(const u_char *const packet,
+                                  const size_t len,
+                                  const size_t link_len)
+	__attribute__((warn_unused_result, nonnull(1)));
+static void sniffer_merge_stats(struct sniffer_stats_t *const stats,
+                                const struct sniffer_stats_t *const other)
+	__attribute__((nonnull(1, 2)));
+
 static int compress_decompress(struct rohc_comp *comp,
                                struct rohc_decomp *decomp,
                                struct pcap_pkthdr header,
@@ -176,6 +334,7 @@ static int compress_decompress(struct rohc_comp *comp,
                                size_t link_len_src,
                                pcap_t *handle,
                                pcap_dumper_t *dumpers[],
+                               const int worker_id,
                                struct rohc_buf *const feedback_send,
                                unsigned int *const cid,
                                struct sniffer_stats_t *stats);
@@ -228,6 +387,11 @@ static bool do_print_stat;
 /** The PCAP dumpers */
 static pcap_dumper_t *sniffer_dumpers[ROHC_LARGE_CID_MAX + 1] = { 0 };
 
+/** The worker threads, NULL if the packets are tested by the capture thread */
+static struct sniffer_worker *sniffer_workers = NULL;
+/** The number of worker threads */
+static size_t sniffer_workers_nr = 0;
+
 /** The maximum number of traces to keep */
 #define MAX_LAST_TRACES  5000
 /** The maximum length of a trace */
@@ -239,6 +403,8 @@ static char last_traces[MAX_LAST_TRACES][MAX_LAST_TRACES + 1];
 static int last_traces_first;
 /** The index of the last trace */
 static int last_traces_last;
+/** The lock for the last traces, shared by the worker threads */
+static pthread_mutex_t last_traces_lock = PTHREAD_MUTEX_INITIALIZER;
 
 /** Whether to print traces on stderr or not */
 static bool do_print_stderr = true;
@@ -275,6 +441,9 @@ int main(int argc, char *argv[])
 	char *cid_type_name = NULL;
 	char *device_name = NULL;
 	int max_contexts = ROHC_SMALL_CID_MAX + 1;
+	int capture_buffer_size = SNIFFER_CAPTURE_BUFFER_SIZE;
+	int xsk_queue = -1;
+	int workers_nr = 0;
 	rohc_cid_type_t cid_type;
 	int args_used;
 	int ret;
@@ -366,6 +535,37 @@ int main(int argc, char *argv[])
 			max_contexts = atoi(argv[1]);
 			args_used++;
 		}
+		else if(!strcmp(*argv, "--capture-buffer"))
+		{
+			/* get the size (in MiB) of the capture ring buffer */
+			capture_buffer_size = atoi(argv[1]);
+			args_used++;
+		}
+		else if(!strcmp(*argv, "--workers"))
+		{
+			/* get the number of worker threads */
+			workers_nr = atoi(argv[1]);
+			args_used++;
+		}
+		else if(!strcmp(*argv, "--af-xdp"))
+		{
+#if ROHC_WITH_AF_XDP == 1
+			/* capture the given RX queue of the device with AF_XDP */
+			xsk_queue = atoi(argv[1]);
+			if(xsk_queue < 0)
+			{
+				SNIFFER_LOG(LOG_WARNING, "the RX queue for AF_XDP should be "
+				            "positive or zero");
+				usage();
+				goto error;
+			}
+			args_used++;
+#else
+			SNIFFER_LOG(LOG_WARNING, "option --af-xdp requires a sniffer built "
+			            "with the --enable-af-xdp configure option");
+			goto error;
+#endif
+		}
 		else if(!strcmp(*argv, "--disable"))
 		{
 			/* disable the given ROHC profile */
@@ -457,6 +657,24 @@ int main(int argc, char *argv[])
 		goto error;
 	}
 
+	/* the capture ring buffer shall be at least 1 MiB and less than 1 GiB */
+	if(capture_buffer_size < 1 || capture_buffer_size >= 1024)
+	{
+		SNIFFER_LOG(LOG_WARNING, "the size of the capture buffer should be "
+		            "between 1 and 1023 MiB");
+		usage();
+		goto error;
+	}
+
+	/* the packets are tested by the capture thread or by 1 to 64 workers */
+	if(workers_nr < 0 || workers_nr > SNIFFER_WORKERS_MAX)
+	{
+		SNIFFER_LOG(LOG_WARNING, "the number of worker threads should be "
+		            "between 0 and %d", SNIFFER_WORKERS_MAX);
+		usage();
+		goto error;
+	}
+
 	/* --pidfile cannot be used in foreground mode */
 	if(pidfilename != NULL && !is_daemon)
 	{
@@ -530,7 +748,8 @@ int main(int argc, char *argv[])
 	}
 
 	/* test ROHC compression/decompression with the packets from the file */
-	if(!sniff(cid_type, max_contexts, enabled_profiles, device_name))
+	if(!sniff(cid_type, max_contexts, enabled_profiles, device_name,
+	          capture_buffer_size, xsk_queue, workers_nr))
 	{
 		goto error;
 	}
@@ -587,6 +806,15 @@ static void usage(void)
 	       "                          simultaneously use during the test\n"
 	       "      --disable PROFILE   A ROHC profile to disable\n"
 	       "                          (may be specified several times)\n"
+	       "      --capture-buffer SIZE  The size (in MiB) of the capture\n"
+	       "                          ring buffer (default: 64)\n"
+	       "      --af-xdp QUEUE      Capture the given RX queue of DEVICE\n"
+	       "                          with AF_XDP instead of libpcap, the\n"
+	       "                          captured frames are not received by\n"
+	       "                          the system anymore\n"
+	       "      --workers NUM       Test the packets in NUM threads, the\n"
+	       "                          packets of one flow in the same thread\n"
+	       "                          (default: 0, test in the capture thread)\n"
 	       "      --verbose           Make the test more verbose\n"
 	       "      --stat              Print statistics at regular interval of time\n"
 	       "\n"
@@ -596,6 +824,11 @@ static void usage(void)
 	       "  rohc_sniffer -m 450 largecid wlan0  compress traffic from\n"
 	       "                                      wlan0 with large CIDs, no\n"
 	       "                                      more than 450 streams\n"
+	       "  rohc_sniffer --af-xdp 0 smallcid eth0  compress traffic from\n"
+	       "                                      the 1st RX queue of eth0\n"
+	       "                                      with AF_XDP\n"
+	       "  rohc_sniffer --workers 8 largecid eth0  compress traffic from\n"
+	       "                                      eth0 in 8 threads\n"
 	       "\n"
 	       "Report bugs to <" PACKAGE_BUGREPORT ">.\n");
 }
@@ -639,6 +872,18 @@ static void sniffer_interrupt(int signum)
 				pcap_dump_close(sniffer_dumpers[j]);
 			}
 		}
+		for(i = 0; (size_t) i < sniffer_workers_nr; i++)
+		{
+			for(j = 0; j <= ROHC_LARGE_CID_MAX; j++)
+			{
+				if(sniffer_workers[i].dumpers[j] != NULL)
+				{
+					SNIFFER_LOG(LOG_INFO, "close dump file for context with ID %zu "
+					            "of worker #%d", j, i);
+					pcap_dump_close(sniffer_workers[i].dumpers[j]);
+				}
+			}
+		}
 
 		/* print last debug traces */
 		if(last_traces_first == -1 || last_traces_last == -1)
@@ -719,10 +964,25 @@ static unsigned long long compute_percent(const unsigned long value,
 static void sniffer_print_stats(int signum __attribute__((unused)))
 {
 	unsigned long total;
+	size_t worker;
 	int i;
 
 	SNIFFER_LOG(LOG_INFO, "dump ROHC sniffer statistics...");
 
+	/* merge the statistics of the worker threads, every worker is between
+	 * two packets */
+	if(sniffer_workers_nr > 0)
+	{
+		memset(&sniffer_stats, 0, sizeof(struct sniffer_stats_t));
+		sniffer_stats.comp_unit_size = 1;
+		for(worker = 0; worker < sniffer_workers_nr; worker++)
+		{
+			pthread_mutex_lock(&sniffer_workers[worker].stats_lock);
+			sniffer_merge_stats(&sniffer_stats, &sniffer_workers[worker].stats);
+			pthread_mutex_unlock(&sniffer_workers[worker].stats_lock);
+		}
+	}
+
 	/* general */
 	SNIFFER_LOG(LOG_INFO, "general:");
 	SNIFFER_LOG(LOG_INFO, "  total packets: %lu packets",
@@ -883,53 +1143,115 @@ static void sniffer_print_stats(int signum __attribute__((unused)))
  *
  * @param cid_type          The type of CIDs that the compressor shall use
  * @param max_contexts      The maximum number of ROHC contexts to use
- * @param enabled_profiles  The ROHC profiles to enable
- * @param device_name       The name of the network device
- * @return                  Whether the sniffer setup was OK
+ * @param enabled_profiles     The ROHC profiles to enable
+ * @param device_name          The name of the network device
+ * @param capture_buffer_size  The size (in MiB) of the capture ring buffer
+ * @param xsk_queue            The RX queue of the network device to capture
+ *                             with AF_XDP, -1 to capture with libpcap
+ * @param workers_nr           The number of worker threads, 0 to test the
+ *                             packets in the capture thread
+ * @return                     Whether the sniffer setup was OK
  */
 static bool sniff(const rohc_cid_type_t cid_type,
                   const size_t max_contexts,
                   const int enabled_profiles[],
-                  const char *const device_name)
+                  const char *const device_name,
+                  const int capture_buffer_size,
+                  const int xsk_queue,
+                  const int workers_nr)
 {
 	char errbuf[PCAP_ERRBUF_SIZE];
 	pcap_t *handle;
+#if ROHC_WITH_AF_XDP == 1
+	struct xsk_source *source = NULL;
+	char xsk_errbuf[XSK_SOURCE_ERRBUF_SIZE];
+#endif
 	int link_layer_type_src;
 	int link_len_src;
-	struct pcap_pkthdr header;
-	unsigned char *packet;
 
-	struct rohc_comp *comp;
-	struct rohc_decomp *decomp;
+	struct rohc_comp *comp = NULL;
+	struct rohc_decomp *decomp = NULL;
 
 	uint8_t feedback_send_buffer[MAX_ROHC_SIZE];
-	struct rohc_buf feedback_send =
-		rohc_buf_init_empty(feedback_send_buffer, MAX_ROHC_SIZE);
+	struct sniffer_capture capture;
+	struct sniffer_dispatcher dispatcher;
+	pcap_handler callback;
+	u_char *user;
 
 	int ret;
 	unsigned int i;
 
-	/* statistics */
-	unsigned int nb_ok = 0;
-	unsigned int nb_bad = 0;
-	unsigned int nb_internal_err = 0;
-	unsigned int err_comp = 0;
-	unsigned int err_decomp = 0;
-	unsigned int nb_ref = 0;
-
 	/* init status */
 	bool status = false;
 
 	assert(device_name != NULL);
 
-	/* open the network device */
-	handle = pcap_open_live(device_name, DEV_MTU, 0, 0, errbuf);
+#if ROHC_WITH_AF_XDP == 1
+	if(xsk_queue >= 0)
+	{
+		/* bind an AF_XDP socket to the RX queue of the network device: the
+		 * Ethernet frames are received in the UMEM shared with the kernel and
+		 * are (de)compressed in place, libpcap is only used to dump them */
+		source = xsk_source_open(device_name, xsk_queue, xsk_errbuf);
+		if(source == NULL)
+		{
+			SNIFFER_LOG(LOG_WARNING, "failed to open network device '%s': %s",
+			            device_name, xsk_errbuf);
+			goto error;
+		}
+		handle = pcap_open_dead(DLT_EN10MB, DEV_MTU);
+		if(handle == NULL)
+		{
+			SNIFFER_LOG(LOG_WARNING, "failed to create the PCAP handle for the "
+			            "dump files");
+			xsk_source_close(source);
+			goto error;
+		}
+		SNIFFER_LOG(LOG_INFO, "capture packets on RX queue %d with AF_XDP",
+		            xsk_queue);
+		goto capture_opened;
+	}
+#else
+	assert(xsk_queue < 0);
+#endif
+
+	/* open the network device: the packets are captured in a large ring
+	 * buffer shared with the kernel, the blocks of the ring buffer are
+	 * delivered once filled or once the timeout expired */
+	handle = pcap_create(device_name, errbuf);
 	if(handle == NULL)
 	{
 		SNIFFER_LOG(LOG_WARNING, "failed to open network device '%s': %s",
 		            device_name, errbuf);
 		goto error;
 	}
+	if(pcap_set_snaplen(handle, DEV_MTU) != 0 ||
+	   pcap_set_promisc(handle, 0) != 0 ||
+	   pcap_set_timeout(handle, SNIFFER_CAPTURE_TIMEOUT) != 0 ||
+	   pcap_set_buffer_size(handle, capture_buffer_size * 1024 * 1024) != 0)
+	{
+		SNIFFER_LOG(LOG_WARNING, "failed to configure the capture on network "
+		            "device '%s'", device_name);
+		goto close_input;
+	}
+	ret = pcap_activate(handle);
+	if(ret < 0)
+	{
+		SNIFFER_LOG(LOG_WARNING, "failed to open network device '%s': %s",
+		            device_name, pcap_geterr(handle));
+		goto close_input;
+	}
+	else if(ret > 0)
+	{
+		SNIFFER_LOG(LOG_WARNING, "network device '%s' opened with warning: %s",
+		            device_name, pcap_geterr(handle));
+	}
+	SNIFFER_LOG(LOG_INFO, "capture packets in a %d MiB ring buffer",
+	            capture_buffer_size);
+
+#if ROHC_WITH_AF_XDP == 1
+capture_opened:
+#endif
 
 	/* link layer in the source dump must be Ethernet */
 	link_layer_type_src = pcap_datalink(handle);
@@ -956,12 +1278,152 @@ static bool sniff(const rohc_cid_type_t cid_type,
 		link_len_src = 0;
 	}
 
+	/* reset the PCAP dumpers (used to save sniffed packets in several PCAP
+	 * files, one per Context ID) */
+	bzero(sniffer_dumpers, sizeof(pcap_dumper_t *) * max_contexts);
+
+	if(workers_nr > 0)
+	{
+		/* the packets are tested by the worker threads, the capture thread
+		 * only dispatches them */
+		sniffer_workers = sniffer_workers_start(workers_nr, cid_type,
+		                                        max_contexts, enabled_profiles,
+		                                        handle, link_len_src);
+		if(sniffer_workers == NULL)
+		{
+			goto close_input;
+		}
+		sniffer_workers_nr = workers_nr;
+
+		memset(&dispatcher, 0, sizeof(struct sniffer_dispatcher));
+		dispatcher.workers = sniffer_workers;
+		dispatcher.workers_nr = workers_nr;
+		dispatcher.link_len_src = link_len_src;
+		callback = sniff_dispatch;
+		user = (u_char *) &dispatcher;
+		SNIFFER_LOG(LOG_INFO, "test packets in %d worker threads", workers_nr);
+	}
+	else
+	{
+		/* create the ROHC compressor and decompressor */
+		comp = sniffer_create_comp(cid_type, max_contexts, enabled_profiles);
+		if(comp == NULL)
+		{
+			goto close_input;
+		}
+		decomp = sniffer_create_decomp(cid_type, max_contexts, enabled_profiles);
+		if(decomp == NULL)
+		{
+			goto destroy_comp;
+		}
+
+		/* the state shared by all the captured packets */
+		memset(&capture, 0, sizeof(struct sniffer_capture));
+		capture.comp = comp;
+		capture.decomp = decomp;
+		capture.handle = handle;
+		capture.link_len_src = link_len_src;
+		capture.feedback_send = (struct rohc_buf)
+			rohc_buf_init_empty(feedback_send_buffer, MAX_ROHC_SIZE);
+		capture.stats = &sniffer_stats;
+		capture.dumpers = sniffer_dumpers;
+		capture.worker_id = -1;
+		callback = sniff_packet;
+		user = (u_char *) &capture;
+	}
+
+	SNIFFER_LOG(LOG_INFO, "ROHC sniffer successfully started");
+	SNIFFER_LOG(LOG_INFO, "start processing captured packets");
+
+	/* for each block of sniffed packets */
+	sniffer_stats.total_packets = 0;
+	while(!stop_program)
+	{
+#if ROHC_WITH_AF_XDP == 1
+		if(source != NULL)
+		{
+			/* test all the frames received at once, in place in the UMEM */
+			if(!sniff_xsk_burst(source, callback, user))
+			{
+				break;
+			}
+			continue;
+		}
+#endif
+
+		/* test all the packets of the blocks delivered by the kernel at once,
+		 * in place in the ring buffer */
+		ret = pcap_dispatch(handle, -1, callback, user);
+		if(ret == PCAP_ERROR)
+		{
+			SNIFFER_LOG(LOG_WARNING, "failed to capture packets: %s",
+			            pcap_geterr(handle));
+			break;
+		}
+	}
+
+	if(stop_program)
+	{
+		SNIFFER_LOG(LOG_INFO, "program stopped by signal");
+		status = true;
+	}
+
+	if(workers_nr > 0)
+	{
+		/* test the packets still queued, then stop the worker threads */
+		sniffer_workers_stop(sniffer_workers, sniffer_workers_nr, max_contexts);
+		sniffer_workers = NULL;
+		sniffer_workers_nr = 0;
+		goto close_input;
+	}
+
+	/* close PCAP dumpers */
+	for(i = 0; i < max_contexts; i++)
+	{
+		if(sniffer_dumpers[i] != NULL)
+		{
+			SNIFFER_LOG(LOG_INFO, "close dump file for context with ID %u", i);
+			pcap_dump_close(sniffer_dumpers[i]);
+		}
+	}
+
+	rohc_decomp_free(decomp);
+destroy_comp:
+	rohc_comp_free(comp);
+close_input:
+	pcap_close(handle);
+#if ROHC_WITH_AF_XDP == 1
+	if(source != NULL)
+	{
+		xsk_source_close(source);
+	}
+#endif
+error:
+	return status;
+}
+
+
+/**
+ * @brief Create one ROHC compressor for the sniffer
+ *
+ * @param cid_type          The type of CIDs that the compressor shall use
+ * @param max_contexts      The maximum number of ROHC contexts to use
+ * @param enabled_profiles  The ROHC profiles to enable
+ * @return                  The new compressor, NULL in case of error
+ */
+static struct rohc_comp * sniffer_create_comp(const rohc_cid_type_t cid_type,
+                                              const size_t max_contexts,
+                                              const int enabled_profiles[])
+{
+	struct rohc_comp *comp;
+	unsigned int i;
+
 	/* create the ROHC compressor */
 	comp = rohc_comp_new2(cid_type, max_contexts - 1, gen_false_random_num, NULL);
 	if(comp == NULL)
 	{
 		SNIFFER_LOG(LOG_WARNING, "failed to create the ROHC compressor");
-		goto close_input;
+		goto error;
 	}
 
 	/* set the callback for traces on compressor */
@@ -997,12 +1459,38 @@ static bool sniff(const rohc_cid_type_t cid_type,
 		goto destroy_comp;
 	}
 
+	return comp;
+
+destroy_comp:
+	rohc_comp_free(comp);
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Create one ROHC decompressor for the sniffer
+ *
+ * The decompressor runs in bi-directional mode.
+ *
+ * @param cid_type          The type of CIDs that the decompressor shall use
+ * @param max_contexts      The maximum number of ROHC contexts to use
+ * @param enabled_profiles  The ROHC profiles to enable
+ * @return                  The new decompressor, NULL in case of error
+ */
+static struct rohc_decomp * sniffer_create_decomp(const rohc_cid_type_t cid_type,
+                                                  const size_t max_contexts,
+                                                  const int enabled_profiles[])
+{
+	struct rohc_decomp *decomp;
+	unsigned int i;
+
 	/* create the decompressor (bi-directional mode) */
 	decomp = rohc_decomp_new2(cid_type, max_contexts - 1, ROHC_O_MODE);
 	if(decomp == NULL)
 	{
 		SNIFFER_LOG(LOG_WARNING, "failed to create the decompressor");
-		goto destroy_comp;
+		goto error;
 	}
 
 	/* set the callback for traces on decompressor */
@@ -1031,119 +1519,611 @@ static bool sniff(const rohc_cid_type_t cid_type,
 		}
 	}
 
-	/* reset the PCAP dumpers (used to save sniffed packets in several PCAP
-	 * files, one per Context ID) */
-	bzero(sniffer_dumpers, sizeof(pcap_dumper_t *) * max_contexts);
+	return decomp;
 
-	SNIFFER_LOG(LOG_INFO, "ROHC sniffer successfully started");
-	SNIFFER_LOG(LOG_INFO, "start processing captured packets");
+destroy_decomp:
+	rohc_decomp_free(decomp);
+error:
+	return NULL;
+}
 
-	/* for each sniffed packet */
-	sniffer_stats.total_packets = 0;
-	while(!stop_program)
+
+/**
+ * @brief Test the ROHC library with one sniffed packet
+ *
+ * Called by libpcap for every packet of the blocks of the capture ring buffer
+ * when there is no worker thread.
+ *
+ * @param user    The state of the capture
+ * @param header  The PCAP header of the packet
+ * @param packet  The packet, in the capture ring buffer
+ */
+static void sniff_packet(u_char *const user,
+                         const struct pcap_pkthdr *const header,
+                         const u_char *const packet)
+{
+	struct sniffer_capture *const capture = (struct sniffer_capture *) user;
+
+	sniffer_test_packet(capture, header, packet);
+	sniffer_print_progress(sniffer_stats.total_packets);
+}
+
+
+/**
+ * @brief Print the progress of the capture on the console
+ *
+ * Statistics are also printed every 1000 packets with the --stat option.
+ *
+ * @param packets_nr  The number of captured packets
+ */
+static void sniffer_print_progress(const unsigned long packets_nr)
+{
+	if(!is_daemon && (packets_nr == 1 || (packets_nr % 100) == 0))
 	{
-		unsigned int cid = 0;
+		if(packets_nr > 1)
+		{
+			printf("\r");
+		}
+		printf("packet #%lu", packets_nr);
+		fflush(stdout);
 
-		/* try to capture a packet */
-		packet = (unsigned char *) pcap_next(handle, &header);
-		if(packet == NULL)
+		if(do_print_stat && (packets_nr % 1000) == 0)
 		{
-			/* no packet captured, re-try */
-			continue;
+			sigset_t sigset;
+			sigset_t old_sigset;
+
+			/* SIGUSR1 prints the stats too: do not merge them twice at once */
+			sigemptyset(&sigset);
+			sigaddset(&sigset, SIGUSR1);
+			pthread_sigmask(SIG_BLOCK, &sigset, &old_sigset);
+
+			printf("\n\n");
+			fprintf(stderr, "================================================\n");
+			sniffer_print_stats(SIGUSR1);
+			fprintf(stderr, "================================================\n");
+			fprintf(stderr, "\n");
+			fflush(stderr);
+
+			pthread_sigmask(SIG_SETMASK, &old_sigset, NULL);
 		}
+	}
+}
 
-		sniffer_stats.total_packets++;
 
-		if(!is_daemon &&
-		   (sniffer_stats.total_packets == 1 || (sniffer_stats.total_packets % 100) == 0))
-		{
-			if(sniffer_stats.total_packets > 1)
-			{
-				printf("\r");
-			}
-			printf("packet #%lu", sniffer_stats.total_packets);
-			fflush(stdout);
+/**
+ * @brief Test the ROHC library with one sniffed packet
+ *
+ * The program dies if the packet is not correctly compressed and
+ * decompressed.
+ *
+ * @param capture  The state of the capture
+ * @param header   The PCAP header of the packet
+ * @param packet   The packet
+ */
+static void sniffer_test_packet(struct sniffer_capture *const capture,
+                                const struct pcap_pkthdr *const header,
+                                const u_char *const packet)
+{
+	unsigned int cid = 0;
+	int ret;
 
-			if(do_print_stat && (sniffer_stats.total_packets % 1000) == 0)
-			{
-				printf("\n\n");
-				fprintf(stderr, "================================================\n");
-				sniffer_print_stats(SIGUSR1);
-				fprintf(stderr, "================================================\n");
-				fprintf(stderr, "\n");
-				fflush(stderr);
-			}
+	capture->stats->total_packets++;
+
+	/* compress & decompress from compressor to decompressor */
+	ret = compress_decompress(capture->comp, capture->decomp, *header,
+	                          (unsigned char *) packet, capture->link_len_src,
+	                          capture->handle, capture->dumpers,
+	                          capture->worker_id, &capture->feedback_send, &cid,
+	                          capture->stats);
+	if(ret == -1)
+	{
+		capture->err_comp++;
+	}
+	else if(ret == -2)
+	{
+		capture->err_decomp++;
+	}
+	else if(ret == 0)
+	{
+		capture->nb_ref++;
+	}
+	else if(ret == 1)
+	{
+		capture->nb_ok++;
+	}
+	else if(ret == -3)
+	{
+		capture->nb_bad++;
+		capture->stats->bad_packets++;
+	}
+	else
+	{
+		capture->nb_internal_err++;
+	}
+
+	/* in case of problem (ignore bad packets), just die! */
+	if(ret != 1 && ret != -3)
+	{
+		SNIFFER_LOG(LOG_WARNING, "packet #%lu, CID %u: stats OK, ERR(COMP), "
+		            "ERR(DECOMP), ERR(REF), ERR(BAD), ERR(INTERNAL)  =  "
+		            "%u  %u  %u  %u  %u  %u", capture->stats->total_packets,
+		            cid, capture->nb_ok, capture->err_comp, capture->err_decomp,
+		            capture->nb_ref, capture->nb_bad, capture->nb_internal_err);
+
+		/* last debug traces are recorded in SIGABRT handler */
+		assert(0);
+	}
+}
+
+
+#if ROHC_WITH_AF_XDP == 1
+
+/**
+ * @brief Test the ROHC library with one burst of frames received with AF_XDP
+ *
+ * The frames are given in place in the UMEM to the callback, then given back
+ * to the kernel.
+ *
+ * @param source    The AF_XDP socket
+ * @param callback  The function to call for every frame
+ * @param user      The state of the capture, given to the callback
+ * @return          true if the burst was received (or if the timeout expired),
+ *                  false in case of error
+ */
+static bool sniff_xsk_burst(struct xsk_source *const source,
+                            pcap_handler callback,
+                            u_char *const user)
+{
+	struct rohc_buf frames[SNIFFER_XSK_BURST_MAX];
+	struct pcap_pkthdr header;
+	int frames_nr;
+	int i;
+
+	frames_nr = xsk_source_recv(source, frames, SNIFFER_XSK_BURST_MAX,
+	                            SNIFFER_CAPTURE_TIMEOUT);
+	if(frames_nr < 0)
+	{
+		SNIFFER_LOG(LOG_WARNING, "failed to capture packets: %s",
+		            xsk_source_geterr(source));
+		return false;
+	}
+	else if(frames_nr == 0)
+	{
+		return true;
+	}
+
+	/* the frames of the burst share the same timestamp */
+	gettimeofday(&header.ts, NULL);
+	for(i = 0; i < frames_nr; i++)
+	{
+		header.caplen = frames[i].len;
+		header.len = frames[i].len;
+		callback(user, &header, rohc_buf_data(frames[i]));
+	}
+	xsk_source_release(source);
+
+	return true;
+}
+
+#endif /* ROHC_WITH_AF_XDP */
+
+
+/**
+ * @brief Start the worker threads
+ *
+ * Every worker thread gets its own compressor/decompressor couple, its own
+ * statistics and its own PCAP dumpers. The signals are handled by the capture
+ * thread only.
+ *
+ * @param workers_nr        The number of worker threads
+ * @param cid_type          The type of CIDs that the compressors shall use
+ * @param max_contexts      The maximum number of ROHC contexts per worker
+ * @param enabled_profiles  The ROHC profiles to enable
+ * @param handle            The PCAP handle of the capture, for the dumpers
+ * @param link_len_src      The length of the link layer header
+ * @return                  The worker threads, NULL in case of error
+ */
+static struct sniffer_worker * sniffer_workers_start(const size_t workers_nr,
+                                                     const rohc_cid_type_t cid_type,
+                                                     const size_t max_contexts,
+                                                     const int enabled_profiles[],
+                                                     pcap_t *const handle,
+                                                     const size_t link_len_src)
+{
+	struct sniffer_worker *workers;
+	sigset_t sigset;
+	sigset_t old_sigset;
+	size_t i;
+	int ret;
+
+	/* too large for the stack */
+	workers = calloc(workers_nr, sizeof(struct sniffer_worker));
+	if(workers == NULL)
+	{
+		SNIFFER_LOG(LOG_WARNING, "failed to allocate memory for %zu worker "
+		            "threads", workers_nr);
+		goto error;
+	}
+
+	/* the worker threads inherit the signal mask of the capture thread */
+	sigfillset(&sigset);
+	pthread_sigmask(SIG_BLOCK, &sigset, &old_sigset);
+
+	for(i = 0; i < workers_nr; i++)
+	{
+		struct sniffer_worker *const worker = &workers[i];
+
+		worker->id = i;
+		pthread_mutex_init(&worker->stats_lock, NULL);
+		pthread_mutex_init(&worker->queue_lock, NULL);
+		pthread_cond_init(&worker->queue_not_empty, NULL);
+		pthread_cond_init(&worker->queue_not_full, NULL);
+		worker->stats.comp_unit_size = 1;
+
+		worker->capture.comp =
+			sniffer_create_comp(cid_type, max_contexts, enabled_profiles);
+		if(worker->capture.comp == NULL)
+		{
+			goto stop_workers;
+		}
+		worker->capture.decomp =
+			sniffer_create_decomp(cid_type, max_contexts, enabled_profiles);
+		if(worker->capture.decomp == NULL)
+		{
+			goto stop_workers;
 		}
+		worker->capture.handle = handle;
+		worker->capture.link_len_src = link_len_src;
+		worker->capture.feedback_send = (struct rohc_buf)
+			rohc_buf_init_empty(worker->feedback_send_buffer, MAX_ROHC_SIZE);
+		worker->capture.stats = &worker->stats;
+		worker->capture.dumpers = worker->dumpers;
+		worker->capture.worker_id = i;
 
-		/* compress & decompress from compressor to decompressor */
-		ret = compress_decompress(comp, decomp, header, packet,
-		                          link_len_src, handle, sniffer_dumpers,
-		                          &feedback_send, &cid, &sniffer_stats);
-		if(ret == -1)
+		ret = pthread_create(&worker->thread, NULL, sniffer_worker_run, worker);
+		if(ret != 0)
 		{
-			err_comp++;
+			SNIFFER_LOG(LOG_WARNING, "failed to create worker thread #%zu: "
+			            "%s (%d)", i, strerror(ret), ret);
+			goto stop_workers;
 		}
-		else if(ret == -2)
+		worker->is_started = true;
+	}
+
+	pthread_sigmask(SIG_SETMASK, &old_sigset, NULL);
+
+	return workers;
+
+stop_workers:
+	pthread_sigmask(SIG_SETMASK, &old_sigset, NULL);
+	sniffer_workers_stop(workers, workers_nr, max_contexts);
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Stop the worker threads once they tested all their queued packets
+ *
+ * @param workers       The worker threads
+ * @param workers_nr    The number of worker threads
+ * @param max_contexts  The maximum number of ROHC contexts per worker
+ */
+static void sniffer_workers_stop(struct sniffer_worker *const workers,
+                                 const size_t workers_nr,
+                                 const size_t max_contexts)
+{
+	size_t i;
+	size_t j;
+
+	for(i = 0; i < workers_nr; i++)
+	{
+		struct sniffer_worker *const worker = &workers[i];
+
+		if(worker->is_started)
 		{
-			err_decomp++;
+			pthread_mutex_lock(&worker->queue_lock);
+			worker->is_stopping = true;
+			pthread_cond_signal(&worker->queue_not_empty);
+			pthread_mutex_unlock(&worker->queue_lock);
+			pthread_join(worker->thread, NULL);
 		}
-		else if(ret == 0)
+	}
+
+	for(i = 0; i < workers_nr; i++)
+	{
+		struct sniffer_worker *const worker = &workers[i];
+
+		/* close PCAP dumpers */
+		for(j = 0; j < max_contexts; j++)
 		{
-			nb_ref++;
+			if(worker->dumpers[j] != NULL)
+			{
+				SNIFFER_LOG(LOG_INFO, "close dump file for context with ID %zu "
+				            "of worker #%zu", j, i);
+				pcap_dump_close(worker->dumpers[j]);
+			}
 		}
-		else if(ret == 1)
+
+		if(worker->capture.decomp != NULL)
 		{
-			nb_ok++;
+			rohc_decomp_free(worker->capture.decomp);
 		}
-		else if(ret == -3)
+		if(worker->capture.comp != NULL)
 		{
-			nb_bad++;
-			sniffer_stats.bad_packets++;
+			rohc_comp_free(worker->capture.comp);
 		}
-		else
+		for(j = 0; j < SNIFFER_WORKER_QUEUE_LEN; j++)
 		{
-			nb_internal_err++;
+			free(worker->slots[j].data);
 		}
+		pthread_cond_destroy(&worker->queue_not_full);
+		pthread_cond_destroy(&worker->queue_not_empty);
+		pthread_mutex_destroy(&worker->queue_lock);
+		pthread_mutex_destroy(&worker->stats_lock);
+	}
 
-		/* in case of problem (ignore bad packets), just die! */
-		if(ret != 1 && ret != -3)
+	free(workers);
+}
+
+
+/**
+ * @brief Test the packets queued for one worker thread, until stopped
+ *
+ * @param arg  The worker thread
+ * @return     Always NULL
+ */
+static void * sniffer_worker_run(void *const arg)
+{
+	struct sniffer_worker *const worker = (struct sniffer_worker *) arg;
+
+	while(1)
+	{
+		struct sniffer_slot *slot;
+
+		/* wait for one packet */
+		pthread_mutex_lock(&worker->queue_lock);
+		while(worker->queue_head == worker->queue_tail && !worker->is_stopping)
 		{
-			SNIFFER_LOG(LOG_WARNING, "packet #%lu, CID %u: stats OK, ERR(COMP), "
-			            "ERR(DECOMP), ERR(REF), ERR(BAD), ERR(INTERNAL)  =  "
-			            "%u  %u  %u  %u  %u  %u", sniffer_stats.total_packets,
-			            cid, nb_ok, err_comp, err_decomp, nb_ref, nb_bad,
-			            nb_internal_err);
+			pthread_cond_wait(&worker->queue_not_empty, &worker->queue_lock);
+		}
+		if(worker->queue_head == worker->queue_tail)
+		{
+			/* stopping and no more packet */
+			pthread_mutex_unlock(&worker->queue_lock);
+			break;
+		}
+		pthread_mutex_unlock(&worker->queue_lock);
+
+		/* test the packet, the stats are consistent between two packets */
+		slot = &worker->slots[worker->queue_head % SNIFFER_WORKER_QUEUE_LEN];
+		pthread_mutex_lock(&worker->stats_lock);
+		sniffer_test_packet(&worker->capture, &slot->header, slot->data);
+		pthread_mutex_unlock(&worker->stats_lock);
+
+		/* give the slot back to the capture thread */
+		pthread_mutex_lock(&worker->queue_lock);
+		worker->queue_head++;
+		pthread_cond_signal(&worker->queue_not_full);
+		pthread_mutex_unlock(&worker->queue_lock);
+	}
+
+	return NULL;
+}
+
+
+/**
+ * @brief Give one sniffed packet to the worker thread of its flow
+ *
+ * Called by libpcap for every packet of the blocks of the capture ring buffer
+ * when there are worker threads. The packet is copied in the queue of the
+ * worker, waiting for room if the worker is late.
+ *
+ * @param user    The state of the capture thread
+ * @param header  The PCAP header of the packet
+ * @param packet  The packet, in the capture ring buffer
+ */
+static void sniff_dispatch(u_char *const user,
+                           const struct pcap_pkthdr *const header,
+                           const u_char *const packet)
+{
+	struct sniffer_dispatcher *const dispatcher =
+		(struct sniffer_dispatcher *) user;
+	const uint32_t hash =
+		sniffer_flow_hash(packet, header->caplen, dispatcher->link_len_src);
+	struct sniffer_worker *const worker =
+		&dispatcher->workers[hash % dispatcher->workers_nr];
+	struct sniffer_slot *slot;
+
+	/* wait for one free slot */
+	pthread_mutex_lock(&worker->queue_lock);
+	while((worker->queue_tail - worker->queue_head) >= SNIFFER_WORKER_QUEUE_LEN)
+	{
+		pthread_cond_wait(&worker->queue_not_full, &worker->queue_lock);
+	}
+	pthread_mutex_unlock(&worker->queue_lock);
 
-			/* last debug traces are recorded in SIGABRT handler */
+	/* copy the packet out of the capture ring buffer, the buffer of the slot
+	 * is kept from one packet to the next one */
+	slot = &worker->slots[worker->queue_tail % SNIFFER_WORKER_QUEUE_LEN];
+	if(header->caplen > slot->data_max)
+	{
+		uint8_t *const data = realloc(slot->data, header->caplen);
+		if(data == NULL)
+		{
+			SNIFFER_LOG(LOG_WARNING, "failed to allocate memory for one packet "
+			            "of %u bytes", header->caplen);
 			assert(0);
+			return;
 		}
+		slot->data = data;
+		slot->data_max = header->caplen;
 	}
+	memcpy(slot->data, packet, header->caplen);
+	slot->header = *header;
 
-	if(stop_program)
+	/* give the slot to the worker thread */
+	pthread_mutex_lock(&worker->queue_lock);
+	worker->queue_tail++;
+	pthread_cond_signal(&worker->queue_not_empty);
+	pthread_mutex_unlock(&worker->queue_lock);
+
+	dispatcher->packets_nr++;
+	sniffer_print_progress(dispatcher->packets_nr);
+}
+
+
+/**
+ * @brief Compute the hash of the flow of one sniffed packet
+ *
+ * The flow is identified by the IP addresses, the IP protocol and the TCP,
+ * UDP or UDP-Lite ports if any. The packets that are not IP belong to
+ * flow 0.
+ *
+ * @param packet    The packet (link layer included)
+ * @param len       The length of the packet
+ * @param link_len  The length of the link layer header
+ * @return          The hash of the flow
+ */
+static uint32_t sniffer_flow_hash(const u_char *const packet,
+                                  const size_t len,
+                                  const size_t link_len)
+{
+	const u_char *const ip = packet + link_len;
+	const u_char *key;
+	size_t key_len;
+	size_t ports_offset;
+	uint8_t protocol;
+	uint32_t hash = 2166136261U; /* FNV-1a */
+	size_t i;
+
+	if(len < link_len + sizeof(struct ip))
 	{
-		SNIFFER_LOG(LOG_INFO, "program stopped by signal");
+		return 0;
 	}
 
-	status = true;
+	if(((ip[0] >> 4) & 0x0f) == 4)
+	{
+		const struct ip *const ipv4 = (struct ip *) ip;
 
-	/* close PCAP dumpers */
-	for(i = 0; i < max_contexts; i++)
+		/* the addresses, the ports are in the first fragment only */
+		key = (u_char *) &ipv4->ip_src;
+		key_len = 2 * sizeof(struct in_addr);
+		protocol = ipv4->ip_p;
+		ports_offset = ipv4->ip_hl * 4U;
+		if((ntohs(ipv4->ip_off) & IP_OFFMASK) != 0)
+		{
+			ports_offset = len;
+		}
+	}
+	else if(((ip[0] >> 4) & 0x0f) == 6 && len >= link_len + sizeof(struct ip6_hdr))
 	{
-		if(sniffer_dumpers[i] != NULL)
+		const struct ip6_hdr *const ipv6 = (struct ip6_hdr *) ip;
+
+		/* the addresses, the ports if there is no extension header */
+		key = (u_char *) &ipv6->ip6_src;
+		key_len = 2 * sizeof(struct in6_addr);
+		protocol = ipv6->ip6_nxt;
+		ports_offset = sizeof(struct ip6_hdr);
+	}
+	else
+	{
+		return 0;
+	}
+
+	for(i = 0; i < key_len; i++)
+	{
+		hash = (hash ^ key[i]) * 16777619U;
+	}
+	hash = (hash ^ protocol) * 16777619U;
+	if((protocol == IPPROTO_TCP || protocol == IPPROTO_UDP ||
+	    protocol == IPPROTO_UDPLITE) &&
+	   len >= link_len + ports_offset + 4)
+	{
+		for(i = 0; i < 4; i++)
 		{
-			SNIFFER_LOG(LOG_INFO, "close dump file for context with ID %u", i);
-			pcap_dump_close(sniffer_dumpers[i]);
+			hash = (hash ^ ip[ports_offset + i]) * 16777619U;
 		}
 	}
 
-destroy_decomp:
-	rohc_decomp_free(decomp);
-destroy_comp:
-	rohc_comp_free(comp);
-close_input:
-	pcap_close(handle);
-error:
-	return status;
+	return hash;
+}
+
+
+/**
+ * @brief Add the statistics of one worker thread to the merged statistics
+ *
+ * @param stats  IN/OUT: The merged statistics
+ * @param other  The statistics of the worker thread
+ */
+static void sniffer_merge_stats(struct sniffer_stats_t *const stats,
+                                const struct sniffer_stats_t *const other)
+{
+	unsigned long long pre_bytes;
+	unsigned long long post_bytes;
+	size_t i;
+
+	/* the volumes are counted in the largest unit of all the workers */
+	pre_bytes = ((unsigned long long) stats->comp_pre_nr_units) *
+	            stats->comp_unit_size + stats->comp_pre_nr_bytes +
+	            ((unsigned long long) other->comp_pre_nr_units) *
+	            other->comp_unit_size + other->comp_pre_nr_bytes;
+	post_bytes = ((unsigned long long) stats->comp_post_nr_units) *
+	             stats->comp_unit_size + stats->comp_post_nr_bytes +
+	             ((unsigned long long) other->comp_post_nr_units) *
+	             other->comp_unit_size + other->comp_post_nr_bytes;
+	stats->comp_unit_size = max(stats->comp_unit_size, other->comp_unit_size);
+	if(stats->comp_unit_size == 1)
+	{
+		stats->comp_pre_nr_units = 0;
+		stats->comp_pre_nr_bytes = pre_bytes;
+		stats->comp_post_nr_units = 0;
+		stats->comp_post_nr_bytes = post_bytes;
+	}
+	else
+	{
+		stats->comp_pre_nr_units = pre_bytes / stats->comp_unit_size;
+		stats->comp_pre_nr_bytes = pre_bytes % stats->comp_unit_size;
+		stats->comp_post_nr_units = post_bytes / stats->comp_unit_size;
+		stats->comp_post_nr_bytes = post_bytes % stats->comp_unit_size;
+	}
+	stats->comp_pre_nr_hdr_bytes += other->comp_pre_nr_hdr_bytes;
+	stats->comp_post_nr_hdr_bytes += other->comp_post_nr_hdr_bytes;
+
+	for(i = 0; i <= ROHC_PROFILE_UDPLITE; i++)
+	{
+		stats->comp_nr_pkts_per_profile[i] += other->comp_nr_pkts_per_profile[i];
+	}
+	for(i = 0; i <= ROHC_R_MODE; i++)
+	{
+		stats->comp_nr_pkts_per_mode[i] += other->comp_nr_pkts_per_mode[i];
+	}
+	for(i = 0; i <= ROHC_COMP_STATE_SO; i++)
+	{
+		stats->comp_nr_pkts_per_state[i] += other->comp_nr_pkts_per_state[i];
+	}
+	for(i = 0; i < ROHC_PACKET_MAX; i++)
+	{
+		stats->comp_nr_pkts_per_pkt_type[i] += other->comp_nr_pkts_per_pkt_type[i];
+	}
+	stats->comp_nr_reused_cid += other->comp_nr_reused_cid;
+
+	stats->total_packets += other->total_packets;
+	stats->bad_packets += other->bad_packets;
+
+	stats->nr_lost_packets += other->nr_lost_packets;
+	stats->nr_loss_bursts += other->nr_loss_bursts;
+	stats->max_loss_burst_len =
+		max(stats->max_loss_burst_len, other->max_loss_burst_len);
+	if(stats->min_loss_burst_len == 0 ||
+	   (other->min_loss_burst_len != 0 &&
+	    other->min_loss_burst_len < stats->min_loss_burst_len))
+	{
+		stats->min_loss_burst_len = other->min_loss_burst_len;
+	}
+
+	stats->nr_misordered_packets += other->nr_misordered_packets;
+	stats->nr_duplicated_packets += other->nr_duplicated_packets;
 }
 
 
@@ -1158,6 +2138,8 @@ error:
  * @param link_len_src   The length of the link layer header before IP data
  * @param handle         The PCAP handler that sniffed the packet
  * @param dumpers        The PCAP dumpers, one per context
+ * @param worker_id      The worker thread, -1 if none (dump file names)
+ * @param feedback_send  IN/OUT: the feedback to piggyback
  * @param cid            OUT: the CID used for the last packet
  * @param stats          IN/OUT: The sniffer stats
  * @return               1 if the process is successful
@@ -1175,6 +2157,7 @@ static int compress_decompress(struct rohc_comp *comp,
                                size_t link_len_src,
                                pcap_t *handle,
                                pcap_dumper_t *dumpers[],
+                               const int worker_id,
                                struct rohc_buf *const feedback_send,
                                unsigned int *const cid,
                                struct sniffer_stats_t *stats)
@@ -1265,25 +2248,36 @@ static int compress_decompress(struct rohc_comp *comp,
 	status = rohc_compress4(comp, ip_packet, &rohc_packet);
 	if(status != ROHC_STATUS_OK)
 	{
+		char dump_filename[1024];
 		pcap_dumper_t *dumper;
 
 		SNIFFER_LOG(LOG_WARNING, "compression failed");
 		ret = -1;
 		rohc_buf_push(&ip_packet, link_len_src);
 
+		/* every worker thread has its own dump files */
+		if(worker_id < 0)
+		{
+			snprintf(dump_filename, 1024, "./dump_stream_default.pcap");
+		}
+		else
+		{
+			snprintf(dump_filename, 1024, "./dump_stream_worker%d_default.pcap",
+			         worker_id);
+		}
+
 		/* open the new dumper */
-		dumper = pcap_dump_open(handle, "./dump_stream_default.pcap");
+		dumper = pcap_dump_open(handle, dump_filename);
 		if(dumper == NULL)
 		{
 			SNIFFER_LOG(LOG_WARNING, "failed to open new dump file '%s'",
-			            "./dump_stream_default.pcap");
+			            dump_filename);
 			assert(0);
 			goto error;
 		}
 
 		/* dump the IP packet */
-		SNIFFER_LOG(LOG_INFO, "dump packet in file '%s'",
-		            "./dump_stream_default.pcap");
+		SNIFFER_LOG(LOG_INFO, "dump packet in file '%s'", dump_filename);
 		pcap_dump((u_char *) dumper, &header, packet);
 
 		SNIFFER_LOG(LOG_INFO, "close dump file");
@@ -1371,8 +2365,17 @@ static int compress_decompress(struct rohc_comp *comp,
 	{
 		char dump_filename[1024];
 
-		snprintf(dump_filename, 1024, "./dump_stream_cid_%u.pcap",
-		         comp_last_packet_info.context_id);
+		/* every worker thread has its own dump files */
+		if(worker_id < 0)
+		{
+			snprintf(dump_filename, 1024, "./dump_stream_cid_%u.pcap",
+			         comp_last_packet_info.context_id);
+		}
+		else
+		{
+			snprintf(dump_filename, 1024, "./dump_stream_worker%d_cid_%u.pcap",
+			         worker_id, comp_last_packet_info.context_id);
+		}
 		/* TODO: check result */
 
 		/* close the previous dumper and remove its file if one was opened */
@@ -1730,6 +2733,8 @@ static void print_rohc_traces(void *const priv_ctxt __attribute__((unused)),
 		}
 	}
 
+	/* the worker threads share the last traces */
+	pthread_mutex_lock(&last_traces_lock);
 	if(last_traces_last == -1)
 	{
 		last_traces_last = 0;
@@ -1760,6 +2765,7 @@ static void print_rohc_traces(void *const priv_ctxt __attribute__((unused)),
 	{
 		last_traces_first = (last_traces_first + 1) % MAX_LAST_TRACES;
 	}
+	pthread_mutex_unlock(&last_traces_lock);
 }
 
 
@@ -24,6 +24,18 @@
  *
  * The program takes a flow of IP packets as input (in the PCAP format) and
  * generate some ROHC compression statistics with them.
+ *
+ * The statistics are either printed packet per packet, or aggregated in a
+ * snapshot in the OpenMetrics text format that monitoring systems like
+ * Prometheus may scrape (with the textfile collector of node_exporter for
+ * example).
+ *
+ * With the --workers option, the flows are spread over several threads, each
+ * with its own compressor. The packets of one flow are always compressed by
+ * the same thread, in their order of capture. Every thread writes the
+ * statistics of its packets in a temporary file, the files are printed one
+ * after the other once the capture is over: the output is the same from one
+ * run to the other for a given number of threads.
  */
 
 #include "config.h" /* for HAVE_*_H */
@@ -32,6 +44,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <errno.h>
 #if HAVE_WINSOCK2_H == 1
 #  include <winsock2.h> /* for ntohs() on Windows */
 #endif
@@ -41,6 +54,7 @@
 #include <assert.h>
 #include <time.h> /* for time(2) */
 #include <stdarg.h>
+#include <pthread.h>
 
 /* includes for network headers */
 #include <protocols/ipv4.h>
@@ -74,6 +88,63 @@ for ./configure ? If yes, check configure output and config.log"
 /** The minimum Ethernet length (in bytes) */
 #define ETHER_FRAME_MIN_LEN  60U
 
+/** The maximum number of worker threads */
+#define STATS_WORKERS_MAX  64
+
+/** The number of packets that may wait in the queue of one worker thread */
+#define STATS_WORKER_QUEUE_LEN  512U
+
+/** The size (in bytes) of the output buffer of one worker thread */
+#define STATS_WORKER_OUTPUT_LEN  (1024U * 1024U)
+
+
+/** The statistics of one compressor or of several merged compressors */
+struct comp_stats
+{
+	rohc_comp_general_info_t info;  /**< The general information */
+	rohc_packet_stats_t packets;    /**< The packets per profile and type */
+	rohc_latency_stats_t latency;   /**< The latency of compression */
+};
+
+
+/** One packet copied in the queue of a worker thread */
+struct stats_slot
+{
+	unsigned long num_packet;   /**< The number of the packet in the capture */
+	struct pcap_pkthdr header;  /**< The PCAP header of the packet */
+	uint8_t *data;              /**< The packet, grown on demand */
+	size_t data_max;            /**< The size of the packet buffer */
+};
+
+
+/**
+ * @brief One worker thread that compresses the packets of some flows
+ *
+ * The main thread fills the queue, the worker thread empties it. Every slot
+ * of the queue is owned by one of them at a time, the lock only protects the
+ * head and the tail of the queue.
+ */
+struct stats_worker
+{
+	pthread_t thread;             /**< The worker thread */
+	bool is_started;              /**< Whether the thread was created */
+
+	struct rohc_comp *comp;       /**< The compressor of the worker */
+	int link_len;                 /**< The length of the link layer header */
+	FILE *output;                 /**< The temporary file for the statistics
+	                                   of every packet, NULL if aggregated */
+	bool is_failure;              /**< Whether one packet failed to be
+	                                   compressed, the next ones are skipped */
+
+	pthread_mutex_t queue_lock;      /**< Protects the head and the tail */
+	pthread_cond_t queue_not_empty;  /**< Signaled by the main thread */
+	pthread_cond_t queue_not_full;   /**< Signaled by the worker thread */
+	size_t queue_head;               /**< The next packet to compress */
+	size_t queue_tail;               /**< The next free slot */
+	bool is_stopping;                /**< Whether to stop once empty */
+	struct stats_slot slots[STATS_WORKER_QUEUE_LEN]; /**< The queue */
+};
+
 
 /** Whether to run the tool in verbose mode or not */
 static bool is_verbose = false;
@@ -83,12 +154,74 @@ static bool is_verbose = false;
 static void usage(void);
 static int generate_comp_stats_all(const rohc_cid_type_t cid_type,
                                    const unsigned int max_contexts,
-                                   const char *filename);
+                                   const char *filename,
+                                   const char *const metrics_filename,
+                                   const unsigned long metrics_interval,
+                                   const size_t workers_nr);
 static int generate_comp_stats_one(struct rohc_comp *comp,
                                    const unsigned long num_packet,
                                    const struct pcap_pkthdr header,
                                    const unsigned char *packet,
-                                   const int link_len);
+                                   const int link_len,
+                                   FILE *const stats_out);
+static struct rohc_comp * create_comp(const rohc_cid_type_t cid_type,
+                                      const unsigned int max_contexts,
+                                      const bool with_latency)
+	__attribute__((warn_unused_result));
+
+static struct stats_worker * stats_workers_start(const size_t workers_nr,
+                                                 const rohc_cid_type_t cid_type,
+                                                 const unsigned int max_contexts,
+                                                 const int link_len,
+                                                 const bool print_stats)
+	__attribute__((warn_unused_result));
+static bool stats_workers_stop(struct stats_worker *const workers,
+                               const size_t workers_nr,
+                               struct comp_stats *const stats)
+	__attribute__((nonnull(1)));
+static void * stats_worker_run(void *const arg)
+	__attribute__((nonnull(1)));
+static bool stats_dispatch(struct stats_worker *const workers,
+                           const size_t workers_nr,
+                           const unsigned long num_packet,
+                           const struct pcap_pkthdr *const header,
+                           const unsigned char *const packet,
+                           const int link_len)
+	__attribute__((warn_unused_result, nonnull(1, 4, 5)));
+static uint32_t stats_flow_hash(const unsigned char *const packet,
+                                const size_t len,
+                                const size_t link_len)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+static bool get_comp_stats(const struct rohc_comp *const comp,
+                           struct comp_stats *const stats)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static void merge_comp_stats(struct comp_stats *const stats,
+                             const struct comp_stats *const other)
+	__attribute__((nonnull(1, 2)));
+static void merge_latency_summary(rohc_latency_summary_t *const summary,
+                                  const rohc_latency_summary_t *const other)
+	__attribute__((nonnull(1, 2)));
+static bool write_openmetrics(const struct comp_stats *const stats,
+                              const char *const filename,
+                              const double duration)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static bool print_openmetrics(FILE *const out,
+                              const struct comp_stats *const stats,
+                              const double duration)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static void print_openmetrics_family(FILE *const out,
+                                     const char *const name,
+                                     const char *const type,
+                                     const char *const unit,
+                                     const char *const help)
+	__attribute__((nonnull(1, 2, 3, 5)));
+static void print_openmetrics_summary(FILE *const out,
+                                      const char *const name,
+                                      const char *const label_name,
+                                      const char *const label_value,
+                                      const rohc_latency_summary_t summary)
+	__attribute__((nonnull(1, 2)));
 static void print_rohc_traces(void *const priv_ctxt,
                               const rohc_trace_level_t level,
                               const rohc_trace_entity_t entity,
@@ -121,6 +254,9 @@ int main(int argc, char *argv[])
 {
 	char *cid_type_name = NULL;
 	char *source_filename = NULL;
+	char *metrics_filename = NULL;
+	int metrics_interval = 0;
+	int workers_nr = 0;
 	int status = 1;
 	int max_contexts = ROHC_SMALL_CID_MAX + 1;
 	size_t max_possible_contexts = ROHC_SMALL_CID_MAX + 1;
@@ -161,6 +297,42 @@ int main(int argc, char *argv[])
 			max_contexts = atoi(argv[1]);
 			args_used++;
 		}
+		else if(!strcmp(*argv, "--openmetrics"))
+		{
+			/* get the name of the file where to write the metrics snapshot */
+			if(argc <= 1)
+			{
+				fprintf(stderr, "option --openmetrics takes one argument\n\n");
+				usage();
+				goto error;
+			}
+			metrics_filename = argv[1];
+			args_used++;
+		}
+		else if(!strcmp(*argv, "--metrics-interval"))
+		{
+			/* get the number of packets between two metrics snapshots */
+			if(argc <= 1)
+			{
+				fprintf(stderr, "option --metrics-interval takes one argument\n\n");
+				usage();
+				goto error;
+			}
+			metrics_interval = atoi(argv[1]);
+			args_used++;
+		}
+		else if(!strcmp(*argv, "--workers"))
+		{
+			/* get the number of worker threads */
+			if(argc <= 1)
+			{
+				fprintf(stderr, "option --workers takes one argument\n\n");
+				usage();
+				goto error;
+			}
+			workers_nr = atoi(argv[1]);
+			args_used++;
+		}
 		else if(cid_type_name == NULL)
 		{
 			/* get the type of CID to use within the ROHC library */
@@ -214,6 +386,38 @@ int main(int argc, char *argv[])
 		goto error;
 	}
 
+	/* the interval between metrics snapshots should be valid */
+	if(metrics_interval < 0)
+	{
+		fprintf(stderr, "the number of packets between two metrics snapshots "
+		        "should be positive\n\n");
+		usage();
+		goto error;
+	}
+	else if(metrics_interval > 0 && metrics_filename == NULL)
+	{
+		fprintf(stderr, "option --metrics-interval requires option "
+		        "--openmetrics\n\n");
+		usage();
+		goto error;
+	}
+
+	/* the number of worker threads should be valid */
+	if(workers_nr < 0 || workers_nr > STATS_WORKERS_MAX)
+	{
+		fprintf(stderr, "the number of worker threads should be between 0 and "
+		        "%d\n\n", STATS_WORKERS_MAX);
+		usage();
+		goto error;
+	}
+	else if(workers_nr > 0 && metrics_interval > 0)
+	{
+		fprintf(stderr, "option --metrics-interval cannot be used with option "
+		        "--workers\n\n");
+		usage();
+		goto error;
+	}
+
 	/* the source filename is mandatory */
 	if(source_filename == NULL)
 	{
@@ -223,7 +427,9 @@ int main(int argc, char *argv[])
 	}
 
 	/* generate ROHC compression statistics with the packets from the file */
-	status = generate_comp_stats_all(cid_type, max_contexts, source_filename);
+	status = generate_comp_stats_all(cid_type, max_contexts, source_filename,
+	                                 metrics_filename, metrics_interval,
+	                                 workers_nr);
 
 error:
 	return status;
@@ -255,6 +461,20 @@ static void usage(void)
 	       "The shell script rohc_stats.sh could be used to generate a HTML\n"
 	       "report.\n"
 	       "\n"
+	       "With the --openmetrics option, the rohc_stats tool rather writes\n"
+	       "a snapshot of the aggregated statistics in the OpenMetrics text\n"
+	       "format: packets and bytes per profile and per packet type, number\n"
+	       "of contexts, throughput over the capture, and latency of the\n"
+	       "compression. The snapshot is replaced atomically, so that the\n"
+	       "textfile collector of node_exporter may export it to Prometheus.\n"
+	       "\n"
+	       "With the --workers option, the flows are spread over several\n"
+	       "threads, each with its own compressor. The statistics of the\n"
+	       "packets are printed thread after thread once the capture is over,\n"
+	       "the packets of one flow in their order of capture. The snapshot\n"
+	       "merges the statistics of all the threads: its latency quantiles\n"
+	       "are the largest ones of the threads.\n"
+	       "\n"
 	       "Usage: rohc_stats [OPTIONS] CID_TYPE FLOW\n"
 	       "\n"
 	       "Options:\n"
@@ -263,16 +483,32 @@ static void usage(void)
 	       "      --verbose           Be more verbose\n"
 	       "      --max-contexts NUM  The maximum number of ROHC contexts to\n"
 	       "                          simultaneously use during the test\n"
+	       "      --openmetrics FILE  Write a snapshot of the statistics in\n"
+	       "                          the OpenMetrics format in FILE ('-' for\n"
+	       "                          the standard output) instead of the\n"
+	       "                          statistics of every packet\n"
+	       "      --metrics-interval NUM\n"
+	       "                          Also write the snapshot every NUM\n"
+	       "                          packets, not only at the end of FLOW\n"
+	       "      --workers NUM       Compress the flows in NUM threads, the\n"
+	       "                          packets of one flow in the same thread,\n"
+	       "                          with --max-contexts contexts per thread\n"
 	       "\n"
 	       "With:\n"
 	       "  CID_TYPE                The type of CID to use among 'smallcid'\n"
 	       "                          and 'largecid'\n"
 	       "  FLOW                    The flow of Ethernet frames to compress\n"
-	       "                          (in PCAP format)\n"
+	       "                          (in PCAP format, '-' for the standard\n"
+	       "                          input)\n"
 	       "\n"
 	       "Examples:\n"
 	       "  rohc_stats smallcid /tmp/rtp.pcap   Generate statistics\n"
 	       "  rohc_stats largecid ~/lan.pcap      Generate statistics\n"
+	       "  rohc_stats --workers 8 largecid ~/lan.pcap\n"
+	       "                                      Generate statistics faster\n"
+	       "  tcpdump -i eth0 -w - | rohc_stats --openmetrics rohc.prom \\\n"
+	       "    --metrics-interval 1000 largecid -\n"
+	       "                                      Export live statistics\n"
 	       "\n"
 	       "Report bugs to <" PACKAGE_BUGREPORT ">.\n");
 }
@@ -281,26 +517,41 @@ static void usage(void)
 /**
  * @brief Generate ROHC compression statistics with a flow of IP packets
  *
- * @param cid_type       The type of CIDs the compressor shall use
- * @param max_contexts   The maximum number of ROHC contexts to use
- * @param filename       The name of the PCAP file that contains the IP packets
- * @return               0 in case of success,
- *                       1 in case of failure
+ * @param cid_type          The type of CIDs the compressor shall use
+ * @param max_contexts      The maximum number of ROHC contexts to use
+ * @param filename          The name of the PCAP file that contains the IP
+ *                          packets
+ * @param metrics_filename  The name of the file where to write the snapshot
+ *                          of the statistics in the OpenMetrics format, NULL
+ *                          to print the statistics of every packet instead
+ * @param metrics_interval  The number of packets between two snapshots,
+ *                          0 to write the snapshot at the end only
+ * @param workers_nr        The number of worker threads, 0 to compress the
+ *                          packets in the main thread
+ * @return                  0 in case of success,
+ *                          1 in case of failure
  */
 static int generate_comp_stats_all(const rohc_cid_type_t cid_type,
                                    const unsigned int max_contexts,
-                                   const char *filename)
+                                   const char *filename,
+                                   const char *const metrics_filename,
+                                   const unsigned long metrics_interval,
+                                   const size_t workers_nr)
 {
 	char errbuf[PCAP_ERRBUF_SIZE];
 	pcap_t *handle;
 	int link_layer_type;
 	int link_len;
 
-	struct rohc_comp *comp;
+	struct rohc_comp *comp = NULL;
+	struct stats_worker *workers = NULL;
+	struct comp_stats stats;
 
 	unsigned long num_packet;
 	struct pcap_pkthdr header;
 	unsigned char *packet;
+	struct timeval first_ts = { .tv_sec = 0, .tv_usec = 0 };
+	double duration = 0.0;
 
 	int is_failure = 1;
 
@@ -341,12 +592,152 @@ static int generate_comp_stats_all(const rohc_cid_type_t cid_type,
 	/* initialize the random generator */
 	srand(time(NULL));
 
-	/* create the ROHC compressor */
+	/* create the ROHC compressor, or one per worker thread */
+	if(workers_nr > 0)
+	{
+		workers = stats_workers_start(workers_nr, cid_type, max_contexts,
+		                              link_len, metrics_filename == NULL);
+		if(workers == NULL)
+		{
+			goto close_input;
+		}
+	}
+	else
+	{
+		comp = create_comp(cid_type, max_contexts, metrics_filename != NULL);
+		if(comp == NULL)
+		{
+			goto close_input;
+		}
+	}
+
+	/* output the statistics columns names */
+	if(metrics_filename == NULL)
+	{
+		printf("STAT\t"
+		       "\"packet number\"\t"
+		       "\"context mode\"\t"
+		       "\"context mode (string)\"\t"
+		       "\"context state\"\t"
+		       "\"context state (string)\"\t"
+		       "\"packet type\"\t"
+		       "\"packet type (string)\"\t"
+		       "\"uncompressed packet size (bytes)\"\t"
+		       "\"uncompressed header size (bytes)\"\t"
+		       "\"compressed packet size (bytes)\"\t"
+		       "\"compressed header size (bytes)\"\n");
+		fflush(stdout);
+	}
+
+	/* for each packet extracted from the PCAP file */
+	num_packet = 0;
+	while((packet = (unsigned char *) pcap_next(handle, &header)) != NULL)
+	{
+		int ret;
+
+		num_packet++;
+
+		/* the throughput is computed over the time covered by the capture */
+		if(num_packet == 1)
+		{
+			first_ts = header.ts;
+		}
+		duration = (header.ts.tv_sec - first_ts.tv_sec) +
+		           (header.ts.tv_usec - first_ts.tv_usec) / 1e6;
+
+		/* give the packet to the worker thread of its flow */
+		if(workers != NULL)
+		{
+			if(!stats_dispatch(workers, workers_nr, num_packet, &header, packet,
+			                   link_len))
+			{
+				goto destroy_comp;
+			}
+			continue;
+		}
+
+		/* compress the packet and generate statistics */
+		ret = generate_comp_stats_one(comp, num_packet, header, packet, link_len,
+		                              metrics_filename == NULL ? stdout : NULL);
+		if(ret != 0)
+		{
+			fprintf(stderr, "packet %lu: failed to compress or generate stats "
+			        "for packet\n", num_packet);
+			goto destroy_comp;
+		}
+		fflush(stdout);
+
+		/* write a snapshot of the statistics from time to time */
+		if(metrics_interval > 0 && (num_packet % metrics_interval) == 0 &&
+		   (!get_comp_stats(comp, &stats) ||
+		    !write_openmetrics(&stats, metrics_filename, duration)))
+		{
+			goto destroy_comp;
+		}
+	}
+
+	/* wait for the worker threads to compress all their packets, then print
+	 * the statistics of their packets and merge their statistics */
+	if(workers != NULL)
+	{
+		const bool is_ok = stats_workers_stop(workers, workers_nr, &stats);
+
+		workers = NULL;
+		if(!is_ok)
+		{
+			goto close_input;
+		}
+	}
+	else if(metrics_filename != NULL && !get_comp_stats(comp, &stats))
+	{
+		goto destroy_comp;
+	}
+
+	/* write the final snapshot of the statistics */
+	if(metrics_filename != NULL &&
+	   !write_openmetrics(&stats, metrics_filename, duration))
+	{
+		goto destroy_comp;
+	}
+
+	/* everything went fine */
+	is_failure = 0;
+
+destroy_comp:
+	if(workers != NULL)
+	{
+		(void) stats_workers_stop(workers, workers_nr, NULL);
+	}
+	if(comp != NULL)
+	{
+		rohc_comp_free(comp);
+	}
+close_input:
+	pcap_close(handle);
+error:
+	return is_failure;
+}
+
+
+/**
+ * @brief Create one ROHC compressor
+ *
+ * @param cid_type      The type of CIDs the compressor shall use
+ * @param max_contexts  The maximum number of ROHC contexts to use
+ * @param with_latency  Whether to record the latency of compression
+ * @return              The compressor, NULL in case of error
+ */
+static struct rohc_comp * create_comp(const rohc_cid_type_t cid_type,
+                                      const unsigned int max_contexts,
+                                      const bool with_latency)
+{
+	struct rohc_comp *comp;
+
 	comp = rohc_comp_new2(cid_type, max_contexts - 1, gen_random_num, NULL);
 	if(comp == NULL)
 	{
 		fprintf(stderr, "cannot create the ROHC compressor\n");
-		goto close_input;
+		goto error;
 	}
 
 	/* set the callback for traces on compressor */
@@ -373,48 +764,397 @@ static int generate_comp_stats_all(const rohc_cid_type_t cid_type,
 		goto destroy_comp;
 	}
 
-	/* output the statistics columns names */
-	printf("STAT\t"
-	       "\"packet number\"\t"
-	       "\"context mode\"\t"
-	       "\"context mode (string)\"\t"
-	       "\"context state\"\t"
-	       "\"context state (string)\"\t"
-	       "\"packet type\"\t"
-	       "\"packet type (string)\"\t"
-	       "\"uncompressed packet size (bytes)\"\t"
-	       "\"uncompressed header size (bytes)\"\t"
-	       "\"compressed packet size (bytes)\"\t"
-	       "\"compressed header size (bytes)\"\n");
-	fflush(stdout);
+	/* record the latency of compression for the metrics snapshot */
+	if(with_latency && !rohc_comp_set_features(comp, ROHC_COMP_FEATURE_LATENCY))
+	{
+		fprintf(stderr, "failed to enable the latency statistics\n");
+		goto destroy_comp;
+	}
 
-	/* for each packet extracted from the PCAP file */
-	num_packet = 0;
-	while((packet = (unsigned char *) pcap_next(handle, &header)) != NULL)
+	return comp;
+
+destroy_comp:
+	rohc_comp_free(comp);
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Start the worker threads
+ *
+ * Every worker thread gets its own compressor and, if the statistics of every
+ * packet are printed, its own temporary file with a large buffer to print
+ * them.
+ *
+ * @param workers_nr    The number of worker threads
+ * @param cid_type      The type of CIDs that the compressors shall use
+ * @param max_contexts  The maximum number of ROHC contexts per worker
+ * @param link_len      The length of the link layer header
+ * @param print_stats   Whether to print the statistics of every packet, or
+ *                      to aggregate them in the metrics snapshot
+ * @return              The worker threads, NULL in case of error
+ */
+static struct stats_worker * stats_workers_start(const size_t workers_nr,
+                                                 const rohc_cid_type_t cid_type,
+                                                 const unsigned int max_contexts,
+                                                 const int link_len,
+                                                 const bool print_stats)
+{
+	struct stats_worker *workers;
+	size_t i;
+	int ret;
+
+	/* too large for the stack */
+	workers = calloc(workers_nr, sizeof(struct stats_worker));
+	if(workers == NULL)
 	{
-		int ret;
+		fprintf(stderr, "failed to allocate memory for %zu worker threads\n",
+		        workers_nr);
+		goto error;
+	}
 
-		num_packet++;
+	for(i = 0; i < workers_nr; i++)
+	{
+		struct stats_worker *const worker = &workers[i];
 
-		/* compress the packet and generate statistics */
-		ret = generate_comp_stats_one(comp, num_packet, header, packet, link_len);
+		pthread_mutex_init(&worker->queue_lock, NULL);
+		pthread_cond_init(&worker->queue_not_empty, NULL);
+		pthread_cond_init(&worker->queue_not_full, NULL);
+		worker->link_len = link_len;
+
+		worker->comp = create_comp(cid_type, max_contexts, !print_stats);
+		if(worker->comp == NULL)
+		{
+			goto stop_workers;
+		}
+		if(print_stats)
+		{
+			worker->output = tmpfile();
+			if(worker->output == NULL)
+			{
+				fprintf(stderr, "failed to create a temporary file for worker "
+				        "thread #%zu: %s (%d)\n", i, strerror(errno), errno);
+				goto stop_workers;
+			}
+			setvbuf(worker->output, NULL, _IOFBF, STATS_WORKER_OUTPUT_LEN);
+		}
+
+		ret = pthread_create(&worker->thread, NULL, stats_worker_run, worker);
 		if(ret != 0)
+		{
+			fprintf(stderr, "failed to create worker thread #%zu: %s (%d)\n",
+			        i, strerror(ret), ret);
+			goto stop_workers;
+		}
+		worker->is_started = true;
+	}
+
+	return workers;
+
+stop_workers:
+	(void) stats_workers_stop(workers, workers_nr, NULL);
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Stop the worker threads once they compressed all their packets
+ *
+ * If requested, the statistics of the packets of every worker thread are
+ * printed on the standard output, one worker thread after the other, and the
+ * statistics of their compressors are merged.
+ *
+ * @param workers     The worker threads
+ * @param workers_nr  The number of worker threads
+ * @param[out] stats  The merged statistics of the compressors, NULL to
+ *                    discard the statistics
+ * @return            true if all the packets were successfully compressed
+ *                    and their statistics printed, false otherwise
+ */
+static bool stats_workers_stop(struct stats_worker *const workers,
+                               const size_t workers_nr,
+                               struct comp_stats *const stats)
+{
+	bool is_ok = (stats != NULL);
+	size_t i;
+	size_t j;
+
+	for(i = 0; i < workers_nr; i++)
+	{
+		struct stats_worker *const worker = &workers[i];
+
+		if(worker->is_started)
+		{
+			pthread_mutex_lock(&worker->queue_lock);
+			worker->is_stopping = true;
+			pthread_cond_signal(&worker->queue_not_empty);
+			pthread_mutex_unlock(&worker->queue_lock);
+			pthread_join(worker->thread, NULL);
+		}
+	}
+
+	if(stats != NULL)
+	{
+		memset(stats, 0, sizeof(struct comp_stats));
+	}
+	for(i = 0; i < workers_nr; i++)
+	{
+		struct stats_worker *const worker = &workers[i];
+
+		if(is_ok && worker->is_failure)
+		{
+			is_ok = false;
+		}
+
+		/* print the statistics of the packets of the worker */
+		if(is_ok && worker->output != NULL)
+		{
+			uint8_t buf[STATS_WORKER_OUTPUT_LEN / 16];
+			size_t len;
+
+			rewind(worker->output);
+			while((len = fread(buf, 1, sizeof(buf), worker->output)) > 0)
+			{
+				fwrite(buf, 1, len, stdout);
+			}
+			if(ferror(worker->output) || fflush(stdout) != 0)
+			{
+				fprintf(stderr, "failed to print the statistics of worker thread "
+				        "#%zu\n", i);
+				is_ok = false;
+			}
+		}
+
+		/* merge the statistics of the compressor of the worker */
+		if(is_ok && worker->comp != NULL)
+		{
+			struct comp_stats worker_stats;
+
+			if(!get_comp_stats(worker->comp, &worker_stats))
+			{
+				is_ok = false;
+			}
+			else
+			{
+				merge_comp_stats(stats, &worker_stats);
+			}
+		}
+
+		if(worker->output != NULL)
+		{
+			fclose(worker->output);
+		}
+		if(worker->comp != NULL)
+		{
+			rohc_comp_free(worker->comp);
+		}
+		for(j = 0; j < STATS_WORKER_QUEUE_LEN; j++)
+		{
+			free(worker->slots[j].data);
+		}
+		pthread_cond_destroy(&worker->queue_not_full);
+		pthread_cond_destroy(&worker->queue_not_empty);
+		pthread_mutex_destroy(&worker->queue_lock);
+	}
+
+	free(workers);
+
+	return is_ok;
+}
+
+
+/**
+ * @brief Compress the packets queued for one worker thread, until stopped
+ *
+ * @param arg  The worker thread
+ * @return     Always NULL
+ */
+static void * stats_worker_run(void *const arg)
+{
+	struct stats_worker *const worker = (struct stats_worker *) arg;
+
+	while(1)
+	{
+		struct stats_slot *slot;
+
+		/* wait for one packet */
+		pthread_mutex_lock(&worker->queue_lock);
+		while(worker->queue_head == worker->queue_tail && !worker->is_stopping)
+		{
+			pthread_cond_wait(&worker->queue_not_empty, &worker->queue_lock);
+		}
+		if(worker->queue_head == worker->queue_tail)
+		{
+			/* stopping and no more packet */
+			pthread_mutex_unlock(&worker->queue_lock);
+			break;
+		}
+		pthread_mutex_unlock(&worker->queue_lock);
+
+		/* compress the packet, skip it if one packet failed before */
+		slot = &worker->slots[worker->queue_head % STATS_WORKER_QUEUE_LEN];
+		if(!worker->is_failure &&
+		   generate_comp_stats_one(worker->comp, slot->num_packet, slot->header,
+		                           slot->data, worker->link_len,
+		                           worker->output) != 0)
 		{
 			fprintf(stderr, "packet %lu: failed to compress or generate stats "
-			        "for packet\n", num_packet);
-			goto destroy_comp;
+			        "for packet\n", slot->num_packet);
+			worker->is_failure = true;
 		}
+
+		/* give the slot back to the main thread */
+		pthread_mutex_lock(&worker->queue_lock);
+		worker->queue_head++;
+		pthread_cond_signal(&worker->queue_not_full);
+		pthread_mutex_unlock(&worker->queue_lock);
 	}
 
-	/* everything went fine */
-	is_failure = 0;
+	return NULL;
+}
+
+
+/**
+ * @brief Give one packet to the worker thread of its flow
+ *
+ * The packet is copied in the queue of the worker, waiting for room if the
+ * worker is late.
+ *
+ * @param workers     The worker threads
+ * @param workers_nr  The number of worker threads
+ * @param num_packet  The number of the packet in the capture
+ * @param header      The PCAP header of the packet
+ * @param packet      The packet (link layer included)
+ * @param link_len    The length of the link layer header
+ * @return            true if the packet was queued, false otherwise
+ */
+static bool stats_dispatch(struct stats_worker *const workers,
+                           const size_t workers_nr,
+                           const unsigned long num_packet,
+                           const struct pcap_pkthdr *const header,
+                           const unsigned char *const packet,
+                           const int link_len)
+{
+	const uint32_t hash = stats_flow_hash(packet, header->caplen, link_len);
+	struct stats_worker *const worker = &workers[hash % workers_nr];
+	struct stats_slot *slot;
+
+	/* wait for one free slot */
+	pthread_mutex_lock(&worker->queue_lock);
+	while((worker->queue_tail - worker->queue_head) >= STATS_WORKER_QUEUE_LEN)
+	{
+		pthread_cond_wait(&worker->queue_not_full, &worker->queue_lock);
+	}
+	pthread_mutex_unlock(&worker->queue_lock);
+
+	/* copy the packet, the buffer of the slot is kept from one packet to the
+	 * next one */
+	slot = &worker->slots[worker->queue_tail % STATS_WORKER_QUEUE_LEN];
+	if(header->caplen > slot->data_max)
+	{
+		uint8_t *const data = realloc(slot->data, header->caplen);
+		if(data == NULL)
+		{
+			fprintf(stderr, "packet %lu: failed to allocate memory for %u bytes\n",
+			        num_packet, header->caplen);
+			goto error;
+		}
+		slot->data = data;
+		slot->data_max = header->caplen;
+	}
+	memcpy(slot->data, packet, header->caplen);
+	slot->header = *header;
+	slot->num_packet = num_packet;
+
+	/* give the slot to the worker thread */
+	pthread_mutex_lock(&worker->queue_lock);
+	worker->queue_tail++;
+	pthread_cond_signal(&worker->queue_not_empty);
+	pthread_mutex_unlock(&worker->queue_lock);
+
+	return true;
 
-destroy_comp:
-	rohc_comp_free(comp);
-close_input:
-	pcap_close(handle);
 error:
-	return is_failure;
+	return false;
+}
+
+
+/**
+ * @brief Compute the hash of the flow of one packet
+ *
+ * The flow is identified by the IP addresses, the IP protocol and the TCP,
+ * UDP or UDP-Lite ports if any. The packets that are not IP belong to
+ * flow 0.
+ *
+ * @param packet    The packet (link layer included)
+ * @param len       The length of the packet
+ * @param link_len  The length of the link layer header
+ * @return          The hash of the flow
+ */
+static uint32_t stats_flow_hash(const unsigned char *const packet,
+                                const size_t len,
+                                const size_t link_len)
+{
+	const unsigned char *const ip = packet + link_len;
+	const unsigned char *key;
+	size_t key_len;
+	size_t ports_offset;
+	uint8_t protocol;
+	uint32_t hash = 2166136261U; /* FNV-1a */
+	size_t i;
+
+	if(len < link_len + sizeof(struct ipv4_hdr))
+	{
+		return 0;
+	}
+
+	if(((ip[0] >> 4) & 0x0f) == 4)
+	{
+		const struct ipv4_hdr *const ipv4 = (struct ipv4_hdr *) ip;
+
+		/* the addresses, the ports are in the first fragment only */
+		key = (unsigned char *) &ipv4->saddr;
+		key_len = 2 * sizeof(uint32_t);
+		protocol = ipv4->protocol;
+		ports_offset = ipv4->ihl * 4U;
+		if((ntohs(ipv4->frag_off) & IPV4_OFFMASK) != 0)
+		{
+			ports_offset = len;
+		}
+	}
+	else if(((ip[0] >> 4) & 0x0f) == 6 && len >= link_len + sizeof(struct ipv6_hdr))
+	{
+		const struct ipv6_hdr *const ipv6 = (struct ipv6_hdr *) ip;
+
+		/* the addresses, the ports if there is no extension header */
+		key = (unsigned char *) &ipv6->saddr;
+		key_len = 2 * sizeof(struct ipv6_addr);
+		protocol = ipv6->nh;
+		ports_offset = sizeof(struct ipv6_hdr);
+	}
+	else
+	{
+		return 0;
+	}
+
+	for(i = 0; i < key_len; i++)
+	{
+		hash = (hash ^ key[i]) * 16777619U;
+	}
+	hash = (hash ^ protocol) * 16777619U;
+	if((protocol == IPPROTO_TCP || protocol == IPPROTO_UDP ||
+	    protocol == IPPROTO_UDPLITE) &&
+	   len >= link_len + ports_offset + 4)
+	{
+		for(i = 0; i < 4; i++)
+		{
+			hash = (hash ^ ip[ports_offset + i]) * 16777619U;
+		}
+	}
+
+	return hash;
 }
 
 
@@ -427,6 +1167,8 @@ error:
  * @param header      The PCAP header for the packet
  * @param packet      The packet to compress (link layer included)
  * @param link_len    The length of the link layer header before IP data
+ * @param stats_out   The stream where to print the statistics of the packet,
+ *                    NULL not to print them
  * @return            0 in case of success,
  *                    1 in case of failure
  */
@@ -434,7 +1176,8 @@ static int generate_comp_stats_one(struct rohc_comp *comp,
                                    const unsigned long num_packet,
                                    const struct pcap_pkthdr header,
                                    const unsigned char *packet,
-                                   const int link_len)
+                                   const int link_len,
+                                   FILE *const stats_out)
 {
 	struct rohc_ts arrival_time = { .sec = 0, .nsec = 0 };
 	struct rohc_buf ip_packet =
@@ -491,6 +1234,12 @@ static int generate_comp_stats_one(struct rohc_comp *comp,
 		goto error;
 	}
 
+	/* the statistics of the packet are aggregated in the metrics snapshot */
+	if(stats_out == NULL)
+	{
+		goto skip;
+	}
+
 	/* get some statistics about the last compressed packet */
 	last_packet_info.version_major = 0;
 	last_packet_info.version_minor = 0;
@@ -502,20 +1251,20 @@ static int generate_comp_stats_one(struct rohc_comp *comp,
 	}
 
 	/* output some statistics about the last compressed packet */
-	printf("STAT\t%lu\t%d\t%s\t%d\t%s\t%d\t%s\t%lu\t%lu\t%lu\t%lu\n",
-	       num_packet,
-	       last_packet_info.context_mode,
-	       rohc_get_mode_descr(last_packet_info.context_mode),
-	       last_packet_info.context_state,
-	       rohc_comp_get_state_descr(last_packet_info.context_state),
-	       last_packet_info.packet_type,
-	       rohc_get_packet_descr(last_packet_info.packet_type),
-	       last_packet_info.total_last_uncomp_size,
-	       last_packet_info.header_last_uncomp_size,
-	       last_packet_info.total_last_comp_size,
-	       last_packet_info.header_last_comp_size);
-	fflush(stdout);
-
+	fprintf(stats_out, "STAT\t%lu\t%d\t%s\t%d\t%s\t%d\t%s\t%lu\t%lu\t%lu\t%lu\n",
+	        num_packet,
+	        last_packet_info.context_mode,
+	        rohc_get_mode_descr(last_packet_info.context_mode),
+	        last_packet_info.context_state,
+	        rohc_comp_get_state_descr(last_packet_info.context_state),
+	        last_packet_info.packet_type,
+	        rohc_get_packet_descr(last_packet_info.packet_type),
+	        last_packet_info.total_last_uncomp_size,
+	        last_packet_info.header_last_uncomp_size,
+	        last_packet_info.total_last_comp_size,
+	        last_packet_info.header_last_comp_size);
+
+skip:
 	return 0;
 
 error:
@@ -523,6 +1272,434 @@ error:
 }
 
 
+/**
+ * @brief Write a snapshot of the compression statistics in OpenMetrics format
+ *
+ * The snapshot is first written in a temporary file that then replaces the
+ * previous snapshot, so that a reader never sees a partial snapshot.
+ *
+ * @param stats     The statistics of the compressor(s)
+ * @param filename  The name of the file where to write the snapshot,
+ *                  '-' for the standard output
+ * @param duration  The time covered by the capture so far (in seconds)
+ * @return          true if the snapshot was successfully written,
+ *                  false otherwise
+ */
+static bool write_openmetrics(const struct comp_stats *const stats,
+                              const char *const filename,
+                              const double duration)
+{
+	char tmp_filename[1024];
+	FILE *out;
+	int ret;
+
+	if(!strcmp(filename, "-"))
+	{
+		if(!print_openmetrics(stdout, stats, duration))
+		{
+			goto error;
+		}
+		fflush(stdout);
+		return true;
+	}
+
+	ret = snprintf(tmp_filename, sizeof(tmp_filename), "%s.tmp", filename);
+	if(ret < 0 || ((size_t) ret) >= sizeof(tmp_filename))
+	{
+		fprintf(stderr, "metrics filename '%s' is too long\n", filename);
+		goto error;
+	}
+
+	out = fopen(tmp_filename, "w");
+	if(out == NULL)
+	{
+		fprintf(stderr, "failed to open '%s': %s (%d)\n", tmp_filename,
+		        strerror(errno), errno);
+		goto error;
+	}
+	if(!print_openmetrics(out, stats, duration))
+	{
+		goto close_file;
+	}
+	if(fclose(out) != 0)
+	{
+		fprintf(stderr, "failed to write '%s': %s (%d)\n", tmp_filename,
+		        strerror(errno), errno);
+		goto remove_file;
+	}
+
+	if(rename(tmp_filename, filename) != 0)
+	{
+		fprintf(stderr, "failed to rename '%s' to '%s': %s (%d)\n",
+		        tmp_filename, filename, strerror(errno), errno);
+		goto remove_file;
+	}
+
+	return true;
+
+close_file:
+	fclose(out);
+remove_file:
+	remove(tmp_filename);
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get the statistics of one compressor
+ *
+ * @param comp        The ROHC compressor
+ * @param[out] stats  The statistics of the compressor
+ * @return            true if the statistics were successfully retrieved,
+ *                    false otherwise
+ */
+static bool get_comp_stats(const struct rohc_comp *const comp,
+                           struct comp_stats *const stats)
+{
+	stats->info.version_major = 0;
+	stats->info.version_minor = 0;
+	if(!rohc_comp_get_general_info(comp, &stats->info))
+	{
+		fprintf(stderr, "failed to get general information about the "
+		        "compressor\n");
+		goto error;
+	}
+	stats->packets.version_major = 0;
+	stats->packets.version_minor = 0;
+	if(!rohc_comp_get_packet_stats(comp, &stats->packets))
+	{
+		fprintf(stderr, "failed to get the packet statistics of the "
+		        "compressor\n");
+		goto error;
+	}
+	stats->latency.version_major = 0;
+	stats->latency.version_minor = 0;
+	if(!rohc_comp_get_latency_stats(comp, &stats->latency))
+	{
+		fprintf(stderr, "failed to get the latency statistics of the "
+		        "compressor\n");
+		goto error;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Add the statistics of one compressor to the merged statistics
+ *
+ * @param stats  IN/OUT: The merged statistics
+ * @param other  The statistics of one compressor
+ */
+static void merge_comp_stats(struct comp_stats *const stats,
+                             const struct comp_stats *const other)
+{
+	size_t i;
+
+	stats->info.contexts_nr += other->info.contexts_nr;
+	stats->info.packets_nr += other->info.packets_nr;
+	stats->info.uncomp_bytes_nr += other->info.uncomp_bytes_nr;
+	stats->info.comp_bytes_nr += other->info.comp_bytes_nr;
+
+	for(i = 0; i < ROHC_PROFILE_MAX; i++)
+	{
+		stats->packets.profiles[i].packets_nr += other->packets.profiles[i].packets_nr;
+		stats->packets.profiles[i].uncomp_bytes_nr +=
+			other->packets.profiles[i].uncomp_bytes_nr;
+		stats->packets.profiles[i].comp_bytes_nr +=
+			other->packets.profiles[i].comp_bytes_nr;
+		merge_latency_summary(&stats->latency.profiles[i],
+		                      &other->latency.profiles[i]);
+	}
+	for(i = 0; i < ROHC_PACKET_MAX; i++)
+	{
+		stats->packets.packet_types[i].packets_nr +=
+			other->packets.packet_types[i].packets_nr;
+		stats->packets.packet_types[i].uncomp_bytes_nr +=
+			other->packets.packet_types[i].uncomp_bytes_nr;
+		stats->packets.packet_types[i].comp_bytes_nr +=
+			other->packets.packet_types[i].comp_bytes_nr;
+		merge_latency_summary(&stats->latency.packet_types[i],
+		                      &other->latency.packet_types[i]);
+	}
+	merge_latency_summary(&stats->latency.all, &other->latency.all);
+}
+
+
+/**
+ * @brief Add the latency summary of one compressor to the merged summary
+ *
+ * The percentiles of several histograms cannot be merged exactly: the
+ * largest percentiles are kept.
+ *
+ * @param summary  IN/OUT: The merged latency summary
+ * @param other    The latency summary of one compressor
+ */
+static void merge_latency_summary(rohc_latency_summary_t *const summary,
+                                  const rohc_latency_summary_t *const other)
+{
+	summary->packets_nr += other->packets_nr;
+	summary->total_ns += other->total_ns;
+	if(other->max_ns > summary->max_ns)
+	{
+		summary->max_ns = other->max_ns;
+	}
+	if(other->p50_ns > summary->p50_ns)
+	{
+		summary->p50_ns = other->p50_ns;
+	}
+	if(other->p99_ns > summary->p99_ns)
+	{
+		summary->p99_ns = other->p99_ns;
+	}
+	if(other->p999_ns > summary->p999_ns)
+	{
+		summary->p999_ns = other->p999_ns;
+	}
+}
+
+
+/**
+ * @brief Print the compression statistics in OpenMetrics format
+ *
+ * Only the profiles and the packet types that were used are printed.
+ *
+ * @param out       The stream where to print the statistics
+ * @param stats     The statistics of the compressor(s)
+ * @param duration  The time covered by the capture so far (in seconds)
+ * @return          true if the statistics were successfully printed,
+ *                  false otherwise
+ */
+static bool print_openmetrics(FILE *const out,
+                              const struct comp_stats *const stats,
+                              const double duration)
+{
+	size_t i;
+
+	/* aggregated statistics */
+	print_openmetrics_family(out, "rohc_comp_packets", "counter", NULL,
+	                         "The number of packets compressed");
+	fprintf(out, "rohc_comp_packets_total %lu\n", stats->info.packets_nr);
+	print_openmetrics_family(out, "rohc_comp_uncompressed_bytes", "counter",
+	                         "bytes", "The number of bytes before compression");
+	fprintf(out, "rohc_comp_uncompressed_bytes_total %lu\n",
+	        stats->info.uncomp_bytes_nr);
+	print_openmetrics_family(out, "rohc_comp_compressed_bytes", "counter",
+	                         "bytes", "The number of bytes after compression");
+	fprintf(out, "rohc_comp_compressed_bytes_total %lu\n", stats->info.comp_bytes_nr);
+	print_openmetrics_family(out, "rohc_comp_contexts", "gauge", NULL,
+	                         "The number of contexts in use");
+	fprintf(out, "rohc_comp_contexts %zu\n", stats->info.contexts_nr);
+
+	/* throughput over the time covered by the capture */
+	print_openmetrics_family(out, "rohc_comp_capture_duration_seconds", "gauge",
+	                         "seconds", "The time covered by the capture");
+	fprintf(out, "rohc_comp_capture_duration_seconds %.6f\n", duration);
+	print_openmetrics_family(out, "rohc_comp_uncompressed_throughput_bytes_per_second",
+	                         "gauge", NULL, "The mean throughput before "
+	                         "compression over the capture");
+	fprintf(out, "rohc_comp_uncompressed_throughput_bytes_per_second %.3f\n",
+	        duration > 0 ? stats->info.uncomp_bytes_nr / duration : 0.0);
+	print_openmetrics_family(out, "rohc_comp_compressed_throughput_bytes_per_second",
+	                         "gauge", NULL, "The mean throughput after "
+	                         "compression over the capture");
+	fprintf(out, "rohc_comp_compressed_throughput_bytes_per_second %.3f\n",
+	        duration > 0 ? stats->info.comp_bytes_nr / duration : 0.0);
+
+	/* distribution of packets and bytes per profile */
+	print_openmetrics_family(out, "rohc_comp_profile_packets", "counter", NULL,
+	                         "The number of packets compressed per profile");
+	for(i = 0; i < ROHC_PROFILE_MAX; i++)
+	{
+		if(stats->packets.profiles[i].packets_nr > 0)
+		{
+			fprintf(out, "rohc_comp_profile_packets_total{profile=\"%s\"} %lu\n",
+			        rohc_get_profile_descr(i), stats->packets.profiles[i].packets_nr);
+		}
+	}
+	print_openmetrics_family(out, "rohc_comp_profile_uncompressed_bytes",
+	                         "counter", "bytes", "The number of bytes before "
+	                         "compression per profile");
+	for(i = 0; i < ROHC_PROFILE_MAX; i++)
+	{
+		if(stats->packets.profiles[i].packets_nr > 0)
+		{
+			fprintf(out, "rohc_comp_profile_uncompressed_bytes_total"
+			        "{profile=\"%s\"} %lu\n", rohc_get_profile_descr(i),
+			        stats->packets.profiles[i].uncomp_bytes_nr);
+		}
+	}
+	print_openmetrics_family(out, "rohc_comp_profile_compressed_bytes",
+	                         "counter", "bytes", "The number of bytes after "
+	                         "compression per profile");
+	for(i = 0; i < ROHC_PROFILE_MAX; i++)
+	{
+		if(stats->packets.profiles[i].packets_nr > 0)
+		{
+			fprintf(out, "rohc_comp_profile_compressed_bytes_total"
+			        "{profile=\"%s\"} %lu\n", rohc_get_profile_descr(i),
+			        stats->packets.profiles[i].comp_bytes_nr);
+		}
+	}
+
+	/* distribution of packets and bytes per packet type */
+	print_openmetrics_family(out, "rohc_comp_packet_type_packets", "counter",
+	                         NULL, "The number of packets compressed per "
+	                         "packet type");
+	for(i = 0; i < ROHC_PACKET_MAX; i++)
+	{
+		if(stats->packets.packet_types[i].packets_nr > 0)
+		{
+			fprintf(out, "rohc_comp_packet_type_packets_total"
+			        "{packet_type=\"%s\"} %lu\n", rohc_get_packet_descr(i),
+			        stats->packets.packet_types[i].packets_nr);
+		}
+	}
+	print_openmetrics_family(out, "rohc_comp_packet_type_uncompressed_bytes",
+	                         "counter", "bytes", "The number of bytes before "
+	                         "compression per packet type");
+	for(i = 0; i < ROHC_PACKET_MAX; i++)
+	{
+		if(stats->packets.packet_types[i].packets_nr > 0)
+		{
+			fprintf(out, "rohc_comp_packet_type_uncompressed_bytes_total"
+			        "{packet_type=\"%s\"} %lu\n", rohc_get_packet_descr(i),
+			        stats->packets.packet_types[i].uncomp_bytes_nr);
+		}
+	}
+	print_openmetrics_family(out, "rohc_comp_packet_type_compressed_bytes",
+	                         "counter", "bytes", "The number of bytes after "
+	                         "compression per packet type");
+	for(i = 0; i < ROHC_PACKET_MAX; i++)
+	{
+		if(stats->packets.packet_types[i].packets_nr > 0)
+		{
+			fprintf(out, "rohc_comp_packet_type_compressed_bytes_total"
+			        "{packet_type=\"%s\"} %lu\n", rohc_get_packet_descr(i),
+			        stats->packets.packet_types[i].comp_bytes_nr);
+		}
+	}
+
+	/* latency of the compression */
+	print_openmetrics_family(out, "rohc_comp_latency_seconds", "summary",
+	                         "seconds", "The time spent to compress one packet");
+	print_openmetrics_summary(out, "rohc_comp_latency_seconds", NULL, NULL,
+	                          stats->latency.all);
+	print_openmetrics_family(out, "rohc_comp_profile_latency_seconds",
+	                         "summary", "seconds", "The time spent to compress "
+	                         "one packet per profile");
+	for(i = 0; i < ROHC_PROFILE_MAX; i++)
+	{
+		if(stats->latency.profiles[i].packets_nr > 0)
+		{
+			print_openmetrics_summary(out, "rohc_comp_profile_latency_seconds",
+			                          "profile", rohc_get_profile_descr(i),
+			                          stats->latency.profiles[i]);
+		}
+	}
+	print_openmetrics_family(out, "rohc_comp_packet_type_latency_seconds",
+	                         "summary", "seconds", "The time spent to compress "
+	                         "one packet per packet type");
+	for(i = 0; i < ROHC_PACKET_MAX; i++)
+	{
+		if(stats->latency.packet_types[i].packets_nr > 0)
+		{
+			print_openmetrics_summary(out, "rohc_comp_packet_type_latency_seconds",
+			                          "packet_type", rohc_get_packet_descr(i),
+			                          stats->latency.packet_types[i]);
+		}
+	}
+
+	fprintf(out, "# EOF\n");
+
+	return (ferror(out) == 0);
+}
+
+
+/**
+ * @brief Print the metadata of one OpenMetrics metric family
+ *
+ * @param out   The stream where to print the metadata
+ * @param name  The name of the metric family
+ * @param type  The type of the metric family
+ * @param unit  The unit of the metric family, NULL if none
+ * @param help  The description of the metric family
+ */
+static void print_openmetrics_family(FILE *const out,
+                                     const char *const name,
+                                     const char *const type,
+                                     const char *const unit,
+                                     const char *const help)
+{
+	fprintf(out, "# TYPE %s %s\n", name, type);
+	if(unit != NULL)
+	{
+		fprintf(out, "# UNIT %s %s\n", name, unit);
+	}
+	fprintf(out, "# HELP %s %s\n", name, help);
+}
+
+
+/**
+ * @brief Print one latency summary in OpenMetrics format
+ *
+ * The percentiles computed by the library are exported as the quantiles of
+ * an OpenMetrics summary.
+ *
+ * @param out          The stream where to print the summary
+ * @param name         The name of the metric family
+ * @param label_name   The name of the label that identifies the summary,
+ *                     NULL if none
+ * @param label_value  The value of the label
+ * @param summary      The latency summary to print
+ */
+static void print_openmetrics_summary(FILE *const out,
+                                      const char *const name,
+                                      const char *const label_name,
+                                      const char *const label_value,
+                                      const rohc_latency_summary_t summary)
+{
+	const struct
+	{
+		const char *const name;
+		const uint64_t value_ns;
+	} quantiles[] = {
+		{ "0.5", summary.p50_ns },
+		{ "0.99", summary.p99_ns },
+		{ "0.999", summary.p999_ns },
+	};
+	char label[256] = "";
+	size_t i;
+
+	if(label_name != NULL)
+	{
+		snprintf(label, sizeof(label), "%s=\"%s\",", label_name, label_value);
+	}
+
+	for(i = 0; i < sizeof(quantiles) / sizeof(quantiles[0]); i++)
+	{
+		fprintf(out, "%s{%squantile=\"%s\"} %.9f\n", name, label,
+		        quantiles[i].name, quantiles[i].value_ns / 1e9);
+	}
+	if(label_name != NULL)
+	{
+		/* remove the trailing comma for the samples without quantile */
+		label[strlen(label) - 1] = '\0';
+		fprintf(out, "%s_sum{%s} %.9f\n", name, label, summary.total_ns / 1e9);
+		fprintf(out, "%s_count{%s} %lu\n", name, label, summary.packets_nr);
+	}
+	else
+	{
+		fprintf(out, "%s_sum %.9f\n", name, summary.total_ns / 1e9);
+		fprintf(out, "%s_count %lu\n", name, summary.packets_nr);
+	}
+}
+
+
 /**
  * @brief Callback to print traces of the ROHC library
  *
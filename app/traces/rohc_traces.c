@@ -0,0 +1,250 @@
+/*
+ * Copyright 2026 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   rohc_traces.c
+ * @brief  ROHC binary traces decoder
+ * @author Didier Barvaux <didier@barvaux.org>
+ *
+ * The program takes a file of binary trace records as input, as got with
+ * rohc_comp_get_trace_records() or rohc_decomp_get_trace_records() and
+ * written as is, and prints them in a human-readable form.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include <rohc.h>
+#include <rohc_packets.h>
+#include <rohc_comp.h>
+#include <rohc_decomp.h>
+
+
+static void usage(void);
+static int decode_traces(const char *const filename);
+static void print_record(const size_t num,
+                         const struct rohc_trace_record *const record);
+
+
+int main(int argc, char *argv[])
+{
+	char *source_filename = NULL;
+	int status = 1;
+	int args_used;
+
+	/* parse program arguments, print the help message in case of failure */
+	if(argc <= 1)
+	{
+		usage();
+		goto error;
+	}
+
+	for(argc--, argv++; argc > 0; argc -= args_used, argv += args_used)
+	{
+		args_used = 1;
+
+		if(!strcmp(*argv, "-h") || !strcmp(*argv, "--help"))
+		{
+			/* print help */
+			usage();
+			goto error;
+		}
+		else if(!strcmp(*argv, "-v") || !strcmp(*argv, "--version"))
+		{
+			/* print version */
+			printf("rohc_traces version %s\n", rohc_version());
+			goto error;
+		}
+		else if(source_filename == NULL)
+		{
+			/* get the name of the file that contains the trace records */
+			source_filename = argv[0];
+		}
+		else
+		{
+			/* do not accept more than one filename without option name */
+			usage();
+			goto error;
+		}
+	}
+
+	/* the source filename is mandatory */
+	if(source_filename == NULL)
+	{
+		fprintf(stderr, "source filename is mandatory\n");
+		usage();
+		goto error;
+	}
+
+	status = decode_traces(source_filename);
+
+error:
+	return status;
+}
+
+
+/**
+ * @brief Print usage of the binary traces decoder
+ */
+static void usage(void)
+{
+	printf("The ROHC traces tool prints the binary trace records of ROHC\n"
+	       "compressors and decompressors\n"
+	       "\n"
+	       "The records are read from a file that contains the records got\n"
+	       "with rohc_comp_get_trace_records() or\n"
+	       "rohc_decomp_get_trace_records(), written as is on the same\n"
+	       "host. One line is printed for every record:\n\n"
+	       "  * record number\n\n"
+	       "  * packet arrival time (seconds.nanoseconds)\n\n"
+	       "  * event\n\n"
+	       "  * CID\n\n"
+	       "  * profile\n\n"
+	       "  * packet type\n\n"
+	       "  * SN\n\n"
+	       "  * arguments of the event\n\n"
+	       "\n"
+	       "Usage: rohc_traces [OPTIONS] FILE\n"
+	       "\n"
+	       "Options:\n"
+	       "  -v, --version           Print version information and exit\n"
+	       "  -h, --help              Print this usage and exit\n");
+}
+
+
+/**
+ * @brief Print all the trace records of the given file
+ *
+ * @param filename  The name of the file that contains the trace records
+ * @return          0 in case of success, 1 otherwise
+ */
+static int decode_traces(const char *const filename)
+{
+	struct rohc_trace_record record;
+	size_t num = 0;
+	FILE *file;
+	int status = 1;
+
+	file = fopen(filename, "rb");
+	if(file == NULL)
+	{
+		fprintf(stderr, "failed to open file '%s'\n", filename);
+		goto error;
+	}
+
+	while(fread(&record, sizeof(struct rohc_trace_record), 1, file) == 1)
+	{
+		num++;
+		print_record(num, &record);
+	}
+	if(ferror(file))
+	{
+		fprintf(stderr, "failed to read record #%zu from file '%s'\n",
+		        num + 1, filename);
+		goto close_file;
+	}
+
+	status = 0;
+
+close_file:
+	fclose(file);
+error:
+	return status;
+}
+
+
+/**
+ * @brief Print one trace record
+ *
+ * @param num     The number of the record in the file
+ * @param record  The trace record
+ */
+static void print_record(const size_t num,
+                         const struct rohc_trace_record *const record)
+{
+	printf("%zu\t%" PRIu64 ".%09" PRIu64 "\t", num,
+	       record->time / UINT64_C(1000000000),
+	       record->time % UINT64_C(1000000000));
+
+	switch(record->event)
+	{
+		case ROHC_TRACE_EVENT_COMP_PKT:
+			printf("COMP_PKT");
+			break;
+		case ROHC_TRACE_EVENT_COMP_STATE:
+			printf("COMP_STATE");
+			break;
+		case ROHC_TRACE_EVENT_COMP_MODE:
+			printf("COMP_MODE");
+			break;
+		case ROHC_TRACE_EVENT_COMP_FEEDBACK:
+			printf("COMP_FEEDBACK");
+			break;
+		case ROHC_TRACE_EVENT_DECOMP_PKT:
+			printf("DECOMP_PKT");
+			break;
+		case ROHC_TRACE_EVENT_DECOMP_FAILURE:
+			printf("DECOMP_FAILURE");
+			break;
+		default:
+			printf("UNKNOWN(%u)", record->event);
+			break;
+	}
+
+	printf("\tCID %" PRIu32 "\t%s\t%s\tSN %" PRIu32 "\t", record->cid,
+	       rohc_get_profile_descr(record->profile),
+	       rohc_get_packet_descr(record->packet_type), record->sn);
+
+	switch(record->event)
+	{
+		case ROHC_TRACE_EVENT_COMP_PKT:
+			printf("%" PRIu32 " bytes -> %" PRIu32 " bytes, state %s\n",
+			       record->args[1], record->args[0],
+			       rohc_comp_get_state_descr(record->args[2]));
+			break;
+		case ROHC_TRACE_EVENT_COMP_STATE:
+			printf("%s -> %s\n", rohc_comp_get_state_descr(record->args[0]),
+			       rohc_comp_get_state_descr(record->args[1]));
+			break;
+		case ROHC_TRACE_EVENT_COMP_MODE:
+			printf("%s -> %s\n", rohc_get_mode_descr(record->args[0]),
+			       rohc_get_mode_descr(record->args[1]));
+			break;
+		case ROHC_TRACE_EVENT_COMP_FEEDBACK:
+			printf("FEEDBACK-%" PRIu32 ", %" PRIu32 " bytes, %s\n",
+			       record->args[0], record->args[1],
+			       record->args[2] ? "handled" : "rejected");
+			break;
+		case ROHC_TRACE_EVENT_DECOMP_PKT:
+			printf("%" PRIu32 " bytes -> %" PRIu32 " bytes, state %s\n",
+			       record->args[0], record->args[1],
+			       rohc_decomp_get_state_descr(record->args[2]));
+			break;
+		case ROHC_TRACE_EVENT_DECOMP_FAILURE:
+			printf("%s, %" PRIu32 " bytes, state %s\n",
+			       rohc_strerror(record->args[0]), record->args[1],
+			       rohc_decomp_get_state_descr(record->args[2]));
+			break;
+		default:
+			printf("%" PRIu32 " %" PRIu32 " %" PRIu32 "\n", record->args[0],
+			       record->args[1], record->args[2]);
+			break;
+	}
+}
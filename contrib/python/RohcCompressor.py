@@ -36,7 +36,7 @@ from rohc import ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, \
                  rohc_comp_set_rtp_detection_cb, rohc_compress4, \
                  rohc_comp_deliver_feedback2, rohc_get_profile_descr, \
                  gen_false_random_num, print_rohc_traces, rohc_comp_rtp_cb, \
-                 rohc_ts, rohc_buf
+                 rohc_compress_list, rohc_ts, rohc_buf
 
 
 class RohcCompressor(object):
@@ -51,7 +51,7 @@ class RohcCompressor(object):
     verbose = None
 
     _buf_max_len = 0xffff * 2
-    _buf = b""
+    _buf = None
 
     def __init__(self, cid_type=ROHC_SMALL_CID, cid_max=ROHC_SMALL_CID_MAX, \
                  wlsb_width=4, profiles=[ROHC_PROFILE_UNCOMPRESSED], verbose=False):
@@ -100,19 +100,18 @@ class RohcCompressor(object):
             return None
 
         # create the output buffers
-        self._buf = b""
-        for _ in range(0, self._buf_max_len):
-            self._buf += b'\x00'
+        self._buf = bytearray(self._buf_max_len)
 
     def compress(self, uncomp_pkt):
         """ Compress the given uncompressed packet
 
         Keyword arguments:
-        uncomp_pkt -- the uncompressed packet (str)
+        uncomp_pkt -- the uncompressed packet (bytes or any object that
+                      supports the buffer protocol, not copied)
 
         Return tuple (return_code, compressed_packet):
         status   -- a value among ROHC_STATUS_*
-        comp_pkt -- the compressed packet (str) or None wrt status_code
+        comp_pkt -- the compressed packet (bytes) or None wrt status_code
         """
 
         status = ROHC_STATUS_ERROR
@@ -120,10 +119,11 @@ class RohcCompressor(object):
         timestamp = rohc_ts(0, 0)
 
         # create the input buffer for the uncompressed packet
-        if isinstance(uncomp_pkt, bytes) is not True:
-            raise TypeError("compress(): argument 'uncomp_pkt' shall be "\
-                            "'bytes' not '%s'" % type(uncomp_pkt))
-        uncomp_pkt_len = len(uncomp_pkt)
+        try:
+            uncomp_pkt_len = memoryview(uncomp_pkt).nbytes
+        except TypeError:
+            raise TypeError("compress(): argument 'uncomp_pkt' shall support "\
+                            "the buffer protocol, not '%s'" % type(uncomp_pkt))
         buf_uncomp = rohc_buf(uncomp_pkt, uncomp_pkt_len, timestamp)
         if buf_uncomp is None:
             return (status, None)
@@ -138,7 +138,23 @@ class RohcCompressor(object):
         if status != ROHC_STATUS_OK:
             return (status, None)
 
-        return (status, self._buf[:buf_comp.len])
+        return (status, bytes(memoryview(self._buf)[:buf_comp.len]))
+
+    def compress_batch(self, uncomp_pkts):
+        """ Compress the given list of uncompressed packets at once
+
+        The packets are compressed in C without holding the GIL: the
+        compressor shall not be used by several threads at the same time.
+
+        Keyword arguments:
+        uncomp_pkts -- the list of uncompressed packets (bytes or any object
+                       that supports the buffer protocol, not copied)
+
+        Return the list of tuples (return_code, compressed_packet), one per
+        uncompressed packet, as returned by compress().
+        """
+
+        return rohc_compress_list(self.comp, uncomp_pkts)
 
     def deliver_feedback(self, feedback):
         """ Deliver the given feedback packet to the ROHC compressor
@@ -153,10 +169,12 @@ class RohcCompressor(object):
         timestamp = rohc_ts(0, 0)
 
         # create the buffer for the feedback data
-        if isinstance(feedback, bytes) is not True:
-            raise TypeError("compress(): argument 'feedback' shall be "\
-                            "'bytes' not '%s'" % type(feedback))
-        feedback_len = len(feedback)
+        try:
+            feedback_len = memoryview(feedback).nbytes
+        except TypeError:
+            raise TypeError("deliver_feedback(): argument 'feedback' shall "\
+                            "support the buffer protocol, not '%s'" % \
+                            type(feedback))
         buf_feedback = rohc_buf(feedback, feedback_len, timestamp)
         if buf_feedback is None:
             return False
@@ -34,7 +34,7 @@ from rohc import ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, \
                  rohc_decomp_new2, rohc_decomp_set_traces_cb2, \
                  rohc_decomp_enable_profile, rohc_decompress3, \
                  rohc_get_profile_descr, print_rohc_traces, \
-                 rohc_ts, rohc_buf
+                 rohc_decompress_list, rohc_ts, rohc_buf
 from struct import pack
 
 
@@ -50,9 +50,9 @@ class RohcDecompressor(object):
     verbose = None
 
     _buf_max_len = 0xffff
-    _buf1 = b""
-    _buf2 = b""
-    _buf3 = b""
+    _buf1 = None
+    _buf2 = None
+    _buf3 = None
 
     def __init__(self, cid_type=ROHC_SMALL_CID, cid_max=ROHC_SMALL_CID_MAX, \
                  mode=ROHC_U_MODE, profiles=[ROHC_PROFILE_UNCOMPRESSED], \
@@ -91,37 +91,33 @@ class RohcDecompressor(object):
                 return None
 
         # create the output buffers
-        self._buf1 = b""
-        for _ in range(0, self._buf_max_len):
-            self._buf1 += b'\0'
-        self._buf2 = b""
-        for _ in range(0, self._buf_max_len):
-            self._buf2 += b'\0'
-        self._buf3 = b""
-        for _ in range(0, self._buf_max_len):
-            self._buf3 += b'\0'
+        self._buf1 = bytearray(self._buf_max_len)
+        self._buf2 = bytearray(self._buf_max_len)
+        self._buf3 = bytearray(self._buf_max_len)
 
     def decompress(self, comp_pkt):
         """ Decompress the given compressed ROHC packet
 
         Keyword arguments:
-        comp_pkt -- the compressed ROHC packet (str)
+        comp_pkt -- the compressed ROHC packet (bytes or any object that
+                    supports the buffer protocol, not copied)
 
         Return tuple:
         status           -- a value among ROHC_STATUS_*
-        decomp_pkt       -- the decompressed packet (str) or None wrt status_code
-        feedback_recv    -- the feedback (str) received with the compressed packet
-        feedback_to_send -- the feedback (str) to send with the associated compressor
+        decomp_pkt       -- the decompressed packet (bytes) or None wrt status_code
+        feedback_recv    -- the feedback (bytes) received with the compressed packet
+        feedback_to_send -- the feedback (bytes) to send with the associated compressor
         """
 
         status = ROHC_STATUS_ERROR
         timestamp = rohc_ts(0, 0)
 
         # create the input buffer for the compressed ROHC packet
-        if isinstance(comp_pkt, bytes) is not True:
-            raise TypeError("compress(): argument 'comp_pkt' shall be "\
-                            "'bytes' not '%s'" % type(comp_pkt))
-        comp_pkt_len = len(comp_pkt)
+        try:
+            comp_pkt_len = memoryview(comp_pkt).nbytes
+        except TypeError:
+            raise TypeError("decompress(): argument 'comp_pkt' shall support "\
+                            "the buffer protocol, not '%s'" % type(comp_pkt))
         buf_comp = rohc_buf(comp_pkt, comp_pkt_len, timestamp)
         if buf_comp is None:
             return (status, None, None, None)
@@ -145,7 +141,27 @@ class RohcDecompressor(object):
         if status != ROHC_STATUS_OK:
             return (status, None, None, None)
 
-        return (status, self._buf1[:buf_decomp.len], \
-                self._buf2[:buf_feedback_recv.len], \
-                self._buf3[:buf_feedback_to_send.len])
+        return (status, bytes(memoryview(self._buf1)[:buf_decomp.len]), \
+                bytes(memoryview(self._buf2)[:buf_feedback_recv.len]), \
+                bytes(memoryview(self._buf3)[:buf_feedback_to_send.len]))
+
+    def decompress_batch(self, comp_pkts):
+        """ Decompress the given list of compressed ROHC packets at once
+
+        The packets are decompressed in C without holding the GIL: the
+        decompressor shall not be used by several threads at the same time.
+
+        Keyword arguments:
+        comp_pkts -- the list of compressed ROHC packets (bytes or any object
+                     that supports the buffer protocol, not copied)
+
+        Return tuple:
+        results          -- the list of tuples (status, decomp_pkt), one per
+                            ROHC packet, as returned by decompress()
+        feedback_recv    -- the feedback (bytes) received with all the packets
+        feedback_to_send -- the feedback (bytes) to send with the associated
+                            compressor for all the packets
+        """
+
+        return rohc_decompress_list(self.decomp, comp_pkts)
 
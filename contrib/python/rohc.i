@@ -58,9 +58,22 @@
    }
 };
 
-%typemap(in) (uint8_t *data, size_t max_len) %{
-   $1 = PyBytes_AsString($input);
-   $2 = PyBytes_Size($input);
+/* the network buffers point into any Python object that supports the buffer
+ * protocol (bytes, bytearray, memoryview, numpy array...) without copy: the
+ * object shall stay alive and shall not be resized while the network buffer
+ * is used, and it shall be writable if the network buffer is an output */
+%typemap(in) (uint8_t *data, size_t max_len) (Py_buffer view) %{
+   if(PyObject_GetBuffer($input, &view, PyBUF_WRITABLE) != 0)
+   {
+      PyErr_Clear();
+      if(PyObject_GetBuffer($input, &view, PyBUF_SIMPLE) != 0)
+      {
+         SWIG_fail;
+      }
+   }
+   $1 = (uint8_t *) view.buf;
+   $2 = view.len;
+   PyBuffer_Release(&view);
 %}
 %include "rohc/rohc_buf.h"
 %extend rohc_buf
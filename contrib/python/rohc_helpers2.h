@@ -56,5 +56,392 @@ bool rohc_comp_add_rtp_port(const unsigned int new_port)
 }
 
 
+#if !defined(SWIG) && PY_MAJOR_VERSION < 3
+
+/* the batch calls rely on the buffer protocol of Python 3 */
+
+PyObject * rohc_compress_list(struct rohc_comp *const comp,
+                              PyObject *const uncomp_pkts)
+{
+	PyErr_SetString(PyExc_NotImplementedError, "batch compression requires "
+	                "Python 3");
+	return NULL;
+}
+
+PyObject * rohc_decompress_list(struct rohc_decomp *const decomp,
+                                PyObject *const rohc_pkts)
+{
+	PyErr_SetString(PyExc_NotImplementedError, "batch decompression requires "
+	                "Python 3");
+	return NULL;
+}
+
+#else
+
+#ifndef SWIG
+
+/**
+ * The room reserved for every packet of a batch in addition to the length of
+ * the packet to (de)compress: the ROHC header of IR packets is larger than
+ * the uncompressed headers, and the uncompressed headers are larger than the
+ * ROHC header of the other packets
+ */
+#define ROHC_BATCH_EXTRA_LEN 1024U
+
+
+/**
+ * @brief Get the packets of a Python sequence without copying them
+ *
+ * Every packet shall support the buffer protocol (bytes, bytearray,
+ * memoryview, numpy array...). The network buffers point into the Python
+ * objects: the views shall be released with \ref rohc_release_views once
+ * the network buffers are not used anymore.
+ *
+ * @param seq           The sequence of packets, as given by PySequence_Fast
+ * @param[out] views    The buffer views of the packets
+ * @param[out] pkts     The network buffers that point into the packets
+ * @param[out] pkts_len The total length of the packets
+ * @return              The number of packets in case of success,
+ *                      -1 in case of error (a Python exception is set)
+ */
+static Py_ssize_t rohc_get_views(PyObject *const seq,
+                                 Py_buffer views[],
+                                 struct rohc_buf pkts[],
+                                 size_t *const pkts_len)
+{
+	const struct rohc_ts arrival_time = { .sec = 0, .nsec = 0 };
+	const Py_ssize_t pkts_nr = PySequence_Fast_GET_SIZE(seq);
+	Py_ssize_t i;
+
+	*pkts_len = 0;
+	for(i = 0; i < pkts_nr; i++)
+	{
+		PyObject *const pkt = PySequence_Fast_GET_ITEM(seq, i);
+
+		if(PyObject_GetBuffer(pkt, &views[i], PyBUF_SIMPLE) != 0)
+		{
+			goto release_views;
+		}
+		pkts[i] = (struct rohc_buf)
+			rohc_buf_init_full((uint8_t *) views[i].buf, views[i].len, arrival_time);
+		*pkts_len += views[i].len;
+	}
+
+	return pkts_nr;
+
+release_views:
+	while(i > 0)
+	{
+		i--;
+		PyBuffer_Release(&views[i]);
+	}
+	return -1;
+}
+
+
+/**
+ * @brief Release the views given by \ref rohc_get_views
+ *
+ * @param views     The buffer views of the packets
+ * @param views_nr  The number of views
+ */
+static void rohc_release_views(Py_buffer views[], const Py_ssize_t views_nr)
+{
+	Py_ssize_t i;
+
+	for(i = 0; i < views_nr; i++)
+	{
+		PyBuffer_Release(&views[i]);
+	}
+}
+
+
+/**
+ * @brief Build the Python list of (status, packet) tuples of a batch
+ *
+ * @param pkts      The resulting packets
+ * @param statuses  The statuses of the packets
+ * @param pkts_nr   The number of packets
+ * @return          The list in case of success,
+ *                  NULL in case of error (a Python exception is set)
+ */
+static PyObject * rohc_build_results(const struct rohc_buf pkts[],
+                                     const rohc_status_t statuses[],
+                                     const Py_ssize_t pkts_nr)
+{
+	PyObject *results;
+	Py_ssize_t i;
+
+	results = PyList_New(pkts_nr);
+	if(results == NULL)
+	{
+		goto error;
+	}
+	for(i = 0; i < pkts_nr; i++)
+	{
+		PyObject *result;
+
+		if(statuses[i] == ROHC_STATUS_OK)
+		{
+			result = Py_BuildValue("(iy#)", statuses[i], rohc_buf_data(pkts[i]),
+			                       (Py_ssize_t) pkts[i].len);
+		}
+		else
+		{
+			result = Py_BuildValue("(iO)", statuses[i], Py_None);
+		}
+		if(result == NULL)
+		{
+			goto free_results;
+		}
+		PyList_SET_ITEM(results, i, result);
+	}
+
+	return results;
+
+free_results:
+	Py_DECREF(results);
+error:
+	return NULL;
+}
+
+#endif /* !SWIG */
+
+
+/**
+ * @brief Compress a list of packets at once
+ *
+ * The uncompressed packets are not copied: any object that supports the
+ * buffer protocol may be given. The whole list is compressed in C with
+ * \ref rohc_compress_batch without holding the GIL, so the compressor shall
+ * not be used by another Python thread at the same time.
+ *
+ * @param comp         The ROHC compressor
+ * @param uncomp_pkts  The sequence of uncompressed packets
+ * @return             The list of (status, ROHC packet) tuples, the ROHC
+ *                     packet being None if the status is not ROHC_STATUS_OK,
+ *                     NULL in case of error (a Python exception is set)
+ */
+PyObject * rohc_compress_list(struct rohc_comp *const comp,
+                              PyObject *const uncomp_pkts)
+{
+	PyObject *seq;
+	Py_ssize_t pkts_nr;
+	Py_buffer *views;
+	struct rohc_buf *uncomp_bufs;
+	struct rohc_buf *rohc_bufs;
+	rohc_status_t *statuses;
+	uint8_t *arena;
+	size_t uncomp_len;
+	size_t arena_offset;
+	size_t done_nr;
+	PyObject *results = NULL;
+	Py_ssize_t i;
+
+	seq = PySequence_Fast(uncomp_pkts, "the packets shall be given as a "
+	                      "sequence");
+	if(seq == NULL)
+	{
+		goto error;
+	}
+	pkts_nr = PySequence_Fast_GET_SIZE(seq);
+
+	views = PyMem_Calloc(pkts_nr + 1, sizeof(Py_buffer));
+	uncomp_bufs = PyMem_Calloc(pkts_nr + 1, sizeof(struct rohc_buf));
+	rohc_bufs = PyMem_Calloc(pkts_nr + 1, sizeof(struct rohc_buf));
+	statuses = PyMem_Calloc(pkts_nr + 1, sizeof(rohc_status_t));
+	if(views == NULL || uncomp_bufs == NULL || rohc_bufs == NULL ||
+	   statuses == NULL)
+	{
+		PyErr_NoMemory();
+		goto free_arrays;
+	}
+
+	if(rohc_get_views(seq, views, uncomp_bufs, &uncomp_len) < 0)
+	{
+		goto free_arrays;
+	}
+
+	/* all the ROHC packets are written in one arena */
+	arena = PyMem_Malloc(uncomp_len + pkts_nr * ROHC_BATCH_EXTRA_LEN + 1);
+	if(arena == NULL)
+	{
+		PyErr_NoMemory();
+		goto release_views;
+	}
+	for(i = 0, arena_offset = 0; i < pkts_nr; i++)
+	{
+		const size_t max_len = uncomp_bufs[i].len + ROHC_BATCH_EXTRA_LEN;
+		rohc_bufs[i] = (struct rohc_buf)
+			rohc_buf_init_empty(arena + arena_offset, max_len);
+		arena_offset += max_len;
+	}
+
+	/* the processing of the batch stops after every packet that needs ROHC
+	 * segmentation, the ROHC segments are not retrieved */
+	Py_BEGIN_ALLOW_THREADS
+	for(done_nr = 0; done_nr < (size_t) pkts_nr; )
+	{
+		const size_t nr = rohc_compress_batch(comp, uncomp_bufs + done_nr,
+		                                      rohc_bufs + done_nr,
+		                                      statuses + done_nr,
+		                                      pkts_nr - done_nr);
+		if(nr == 0)
+		{
+			break;
+		}
+		done_nr += nr;
+	}
+	Py_END_ALLOW_THREADS
+	if(done_nr < (size_t) pkts_nr)
+	{
+		PyErr_SetString(PyExc_ValueError, "failed to compress the packets");
+		goto free_arena;
+	}
+
+	results = rohc_build_results(rohc_bufs, statuses, pkts_nr);
+
+free_arena:
+	PyMem_Free(arena);
+release_views:
+	rohc_release_views(views, pkts_nr);
+free_arrays:
+	PyMem_Free(statuses);
+	PyMem_Free(rohc_bufs);
+	PyMem_Free(uncomp_bufs);
+	PyMem_Free(views);
+	Py_DECREF(seq);
+error:
+	return results;
+}
+
+
+/**
+ * @brief Decompress a list of ROHC packets at once
+ *
+ * The ROHC packets are not copied: any object that supports the buffer
+ * protocol may be given. The whole list is decompressed in C with
+ * \ref rohc_decompress_batch without holding the GIL, so the decompressor
+ * shall not be used by another Python thread at the same time.
+ *
+ * @param decomp     The ROHC decompressor
+ * @param rohc_pkts  The sequence of ROHC packets
+ * @return           The tuple (results, feedback_recv, feedback_to_send):
+ *                   the list of (status, decompressed packet) tuples, the
+ *                   decompressed packet being None if the status is not
+ *                   ROHC_STATUS_OK, and the feedback received and to send
+ *                   for the whole list,
+ *                   NULL in case of error (a Python exception is set)
+ */
+PyObject * rohc_decompress_list(struct rohc_decomp *const decomp,
+                                PyObject *const rohc_pkts)
+{
+	PyObject *seq;
+	Py_ssize_t pkts_nr;
+	Py_buffer *views;
+	struct rohc_buf *rohc_bufs;
+	struct rohc_buf *uncomp_bufs;
+	rohc_status_t *statuses;
+	uint8_t *arena;
+	struct rohc_buf rcvd_feedback;
+	struct rohc_buf feedback_send;
+	size_t feedback_max_len;
+	size_t rohc_len;
+	size_t arena_offset;
+	bool is_ok;
+	PyObject *results;
+	PyObject *ret = NULL;
+	Py_ssize_t i;
+
+	seq = PySequence_Fast(rohc_pkts, "the packets shall be given as a "
+	                      "sequence");
+	if(seq == NULL)
+	{
+		goto error;
+	}
+	pkts_nr = PySequence_Fast_GET_SIZE(seq);
+	if(pkts_nr == 0)
+	{
+		Py_DECREF(seq);
+		return Py_BuildValue("([]y#y#)", "", (Py_ssize_t) 0, "", (Py_ssize_t) 0);
+	}
+
+	views = PyMem_Calloc(pkts_nr + 1, sizeof(Py_buffer));
+	rohc_bufs = PyMem_Calloc(pkts_nr + 1, sizeof(struct rohc_buf));
+	uncomp_bufs = PyMem_Calloc(pkts_nr + 1, sizeof(struct rohc_buf));
+	statuses = PyMem_Calloc(pkts_nr + 1, sizeof(rohc_status_t));
+	if(views == NULL || rohc_bufs == NULL || uncomp_bufs == NULL ||
+	   statuses == NULL)
+	{
+		PyErr_NoMemory();
+		goto free_arrays;
+	}
+
+	if(rohc_get_views(seq, views, rohc_bufs, &rohc_len) < 0)
+	{
+		goto free_arrays;
+	}
+
+	/* all the decompressed packets and the feedback of the whole list are
+	 * written in one arena, the feedback cannot be larger than the ROHC
+	 * packets */
+	feedback_max_len = rohc_len;
+	arena = PyMem_Malloc(rohc_len + pkts_nr * ROHC_BATCH_EXTRA_LEN +
+	                     2 * feedback_max_len + 1);
+	if(arena == NULL)
+	{
+		PyErr_NoMemory();
+		goto release_views;
+	}
+	for(i = 0, arena_offset = 0; i < pkts_nr; i++)
+	{
+		const size_t max_len = rohc_bufs[i].len + ROHC_BATCH_EXTRA_LEN;
+		uncomp_bufs[i] = (struct rohc_buf)
+			rohc_buf_init_empty(arena + arena_offset, max_len);
+		arena_offset += max_len;
+	}
+	rcvd_feedback = (struct rohc_buf)
+		rohc_buf_init_empty(arena + arena_offset, feedback_max_len);
+	arena_offset += feedback_max_len;
+	feedback_send = (struct rohc_buf)
+		rohc_buf_init_empty(arena + arena_offset, feedback_max_len);
+
+	Py_BEGIN_ALLOW_THREADS
+	is_ok = rohc_decompress_batch(decomp, rohc_bufs, uncomp_bufs, statuses,
+	                              pkts_nr, &rcvd_feedback, &feedback_send);
+	Py_END_ALLOW_THREADS
+	if(!is_ok)
+	{
+		PyErr_SetString(PyExc_ValueError, "failed to decompress the packets");
+		goto free_arena;
+	}
+
+	results = rohc_build_results(uncomp_bufs, statuses, pkts_nr);
+	if(results == NULL)
+	{
+		goto free_arena;
+	}
+	ret = Py_BuildValue("(Ny#y#)", results, rohc_buf_data(rcvd_feedback),
+	                    (Py_ssize_t) rcvd_feedback.len,
+	                    rohc_buf_data(feedback_send),
+	                    (Py_ssize_t) feedback_send.len);
+
+free_arena:
+	PyMem_Free(arena);
+release_views:
+	rohc_release_views(views, pkts_nr);
+free_arrays:
+	PyMem_Free(statuses);
+	PyMem_Free(uncomp_bufs);
+	PyMem_Free(rohc_bufs);
+	PyMem_Free(views);
+	Py_DECREF(seq);
+error:
+	return ret;
+}
+
+#endif /* PY_MAJOR_VERSION >= 3 */
+
+
 #endif /* ROHC_HELPERS2_H */
 
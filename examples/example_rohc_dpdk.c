@@ -0,0 +1,948 @@
+/*
+ * Copyright 2026 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file     example_rohc_dpdk.c
+ * @brief    A program that (de)compresses the bursts of packets of a DPDK port
+ * @author   Didier Barvaux <didier@barvaux.org>
+ */
+
+/**
+ * @example example_rohc_dpdk.c
+ *
+ * How to compress or decompress the bursts of mbufs received on a DPDK port.
+ *
+ * The Ethernet frames received on the first DPDK port are compressed
+ * (IPv4 and IPv6 frames) or decompressed (ROHC frames with EtherType
+ * 0x22f1), then sent back on the same port. Two integrations are shown:
+ *  - in place (the default): the headers of every packet are (de)compressed
+ *    with \ref rohc_compress_header or \ref rohc_decompress_header, then
+ *    rewritten in front of the payload in the mbuf itself thanks to the
+ *    mbuf headroom; the payload is never copied,
+ *  - in batch (option --batch): the whole burst is (de)compressed at once
+ *    with \ref rohc_compress_batch or \ref rohc_decompress_batch into new
+ *    mbufs.
+ *
+ * The number of (de)compressed packets per second is printed every second.
+ *
+ * Usage: example_rohc_dpdk [EAL options] -- [--batch] comp|decomp
+ */
+
+/* system includes */
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <signal.h>
+#include <time.h>
+#include <inttypes.h>
+
+/* DPDK includes */
+#include <rte_eal.h>
+#include <rte_ethdev.h>
+#include <rte_mbuf.h>
+#include <rte_ether.h>
+#include <rte_cycles.h>
+#include <rte_byteorder.h>
+
+/* includes required to use the ROHC library */
+#include <rohc/rohc.h>
+#include <rohc/rohc_comp.h>
+#include <rohc/rohc_decomp.h>
+
+
+/** The maximum number of packets received, processed and sent at once */
+#define BURST_SIZE 32U
+
+/** The number of descriptors of the RX and TX rings of the port */
+#define RING_SIZE 1024U
+
+/** The number of mbufs in the pool and the size of the per-core cache */
+#define MBUFS_NR       8191U
+#define MBUFS_CACHE_NR  256U
+
+/** The EtherType of the Ethernet frames that carry ROHC packets */
+#define ETHER_TYPE_ROHC 0x22f1
+
+/** The maximum CID, both sides shall use the same CID type and MAX_CID */
+#define EXAMPLE_MAX_CID 1023U
+
+/** The maximum length (in bytes) of the compressed or uncompressed headers */
+#define HEADERS_MAX_LEN 512U
+
+
+/** The statistics of the program */
+struct example_stats
+{
+	uint64_t received;    /**< The number of received frames */
+	uint64_t processed;   /**< The number of (de)compressed packets */
+	uint64_t ignored;     /**< The number of ignored frames */
+	uint64_t failed;      /**< The number of packets that failed */
+	uint64_t sent;        /**< The number of sent frames */
+};
+
+
+static int port_init(const uint16_t port, struct rte_mempool *const pool)
+	__attribute__((warn_unused_result, nonnull(2)));
+
+static struct rohc_comp * create_compressor(void)
+	__attribute__((warn_unused_result));
+static struct rohc_decomp * create_decompressor(void)
+	__attribute__((warn_unused_result));
+
+static bool frame_is_usable(const struct rte_mbuf *const mbuf,
+                            const uint16_t ether_type)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+static uint16_t comp_burst_inplace(struct rohc_comp *const comp,
+                                   struct rte_mbuf *pkts[],
+                                   const uint16_t pkts_nr,
+                                   const struct rohc_ts arrival_time,
+                                   struct example_stats *const stats)
+	__attribute__((warn_unused_result, nonnull(1, 2, 5)));
+static uint16_t decomp_burst_inplace(struct rohc_decomp *const decomp,
+                                     struct rte_mbuf *pkts[],
+                                     const uint16_t pkts_nr,
+                                     const struct rohc_ts arrival_time,
+                                     struct example_stats *const stats)
+	__attribute__((warn_unused_result, nonnull(1, 2, 5)));
+static bool rewrite_headers(struct rte_mbuf *const mbuf,
+                            const size_t old_hdrs_len,
+                            const size_t payload_len,
+                            const struct rohc_buf new_hdrs,
+                            const uint16_t ether_type)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+static uint16_t comp_burst_batch(struct rohc_comp *const comp,
+                                 struct rte_mempool *const pool,
+                                 struct rte_mbuf *pkts[],
+                                 const uint16_t pkts_nr,
+                                 const struct rohc_ts arrival_time,
+                                 struct example_stats *const stats)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 6)));
+static uint16_t decomp_burst_batch(struct rohc_decomp *const decomp,
+                                   struct rte_mempool *const pool,
+                                   struct rte_mbuf *pkts[],
+                                   const uint16_t pkts_nr,
+                                   const struct rohc_ts arrival_time,
+                                   struct example_stats *const stats)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 6)));
+
+static int gen_random_num(const struct rohc_comp *const comp,
+                          void *const user_context);
+
+static void stop_on_signal(int signum);
+
+
+/** Whether the program shall stop */
+static volatile sig_atomic_t stop_program = 0;
+
+
+/**
+ * @brief The main entry point for the program
+ *
+ * @param argc  The number of arguments given to the program
+ * @param argv  The table of arguments given to the program
+ * @return      0 in case of success, 1 otherwise
+ */
+int main(int argc, char **argv)
+{
+	struct example_stats stats;
+	struct rte_mempool *pool;
+	struct rohc_comp *compressor = NULL;
+	struct rohc_decomp *decompressor = NULL;
+	bool do_comp = false;
+	bool do_batch = false;
+	const uint16_t port = 0;
+	uint64_t start_cycles;
+	uint64_t last_cycles;
+	uint64_t last_processed;
+	uint64_t hz;
+	double duration;
+	int args_used;
+	int i;
+	int status = 1;
+
+	/* initialize the DPDK environment, EAL options come first */
+	args_used = rte_eal_init(argc, argv);
+	if(args_used < 0)
+	{
+		fprintf(stderr, "failed to initialize the DPDK environment\n");
+		goto error;
+	}
+	argc -= args_used;
+	argv += args_used;
+
+	/* parse the options of the program */
+	for(i = 1; i < argc; i++)
+	{
+		if(strcmp(argv[i], "--batch") == 0)
+		{
+			do_batch = true;
+		}
+		else if(strcmp(argv[i], "comp") == 0)
+		{
+			do_comp = true;
+		}
+		else if(strcmp(argv[i], "decomp") != 0)
+		{
+			fprintf(stderr, "unexpected argument '%s'\n", argv[i]);
+			fprintf(stderr, "usage: example_rohc_dpdk [EAL options] -- "
+			        "[--batch] comp|decomp\n");
+			goto cleanup_eal;
+		}
+	}
+
+	if(rte_eth_dev_count_avail() == 0)
+	{
+		fprintf(stderr, "no DPDK port available\n");
+		goto cleanup_eal;
+	}
+
+	/* the mbufs shall keep the default headroom for the in-place rewriting
+	 * of the headers */
+	pool = rte_pktmbuf_pool_create("rohc_mbufs", MBUFS_NR, MBUFS_CACHE_NR, 0,
+	                               RTE_MBUF_DEFAULT_BUF_SIZE, rte_socket_id());
+	if(pool == NULL)
+	{
+		fprintf(stderr, "failed to create the pool of mbufs\n");
+		goto cleanup_eal;
+	}
+
+	if(port_init(port, pool) != 0)
+	{
+		fprintf(stderr, "failed to initialize port %u\n", port);
+		goto free_pool;
+	}
+
+	/* create the ROHC compressor or decompressor */
+	if(do_comp)
+	{
+		compressor = create_compressor();
+		if(compressor == NULL)
+		{
+			goto stop_port;
+		}
+	}
+	else
+	{
+		decompressor = create_decompressor();
+		if(decompressor == NULL)
+		{
+			goto stop_port;
+		}
+	}
+
+	signal(SIGINT, stop_on_signal);
+	signal(SIGTERM, stop_on_signal);
+
+	printf("%s the frames of port %u %s, press Ctrl+C to stop\n",
+	       do_comp ? "compress" : "decompress", port,
+	       do_batch ? "in batch" : "in place");
+
+	memset(&stats, 0, sizeof(struct example_stats));
+	hz = rte_get_timer_hz();
+	start_cycles = rte_get_timer_cycles();
+	last_cycles = start_cycles;
+	last_processed = 0;
+
+	while(!stop_program)
+	{
+		struct rte_mbuf *pkts[BURST_SIZE];
+		struct rohc_ts arrival_time;
+		struct timespec now;
+		uint64_t cur_cycles;
+		uint16_t rx_nr;
+		uint16_t tx_nr;
+		uint16_t pkts_nr;
+		uint16_t j;
+
+		rx_nr = rte_eth_rx_burst(port, 0, pkts, BURST_SIZE);
+		if(rx_nr > 0)
+		{
+			stats.received += rx_nr;
+
+			/* all the packets of one burst share the same arrival time */
+			clock_gettime(CLOCK_MONOTONIC, &now);
+			arrival_time.sec = now.tv_sec;
+			arrival_time.nsec = now.tv_nsec;
+
+			/* (de)compress the burst, the packets to send are put at the
+			 * beginning of the array */
+			if(do_comp && do_batch)
+			{
+				pkts_nr = comp_burst_batch(compressor, pool, pkts, rx_nr,
+				                           arrival_time, &stats);
+			}
+			else if(do_comp)
+			{
+				pkts_nr = comp_burst_inplace(compressor, pkts, rx_nr,
+				                             arrival_time, &stats);
+			}
+			else if(do_batch)
+			{
+				pkts_nr = decomp_burst_batch(decompressor, pool, pkts, rx_nr,
+				                             arrival_time, &stats);
+			}
+			else
+			{
+				pkts_nr = decomp_burst_inplace(decompressor, pkts, rx_nr,
+				                               arrival_time, &stats);
+			}
+
+			tx_nr = rte_eth_tx_burst(port, 0, pkts, pkts_nr);
+			stats.sent += tx_nr;
+			for(j = tx_nr; j < pkts_nr; j++)
+			{
+				rte_pktmbuf_free(pkts[j]);
+			}
+		}
+
+		/* print the rate every second */
+		cur_cycles = rte_get_timer_cycles();
+		if((cur_cycles - last_cycles) >= hz)
+		{
+			duration = ((double) (cur_cycles - last_cycles)) / hz;
+			printf("%.3f Mpps (%" PRIu64 " received, %" PRIu64 " ignored, "
+			       "%" PRIu64 " failed, %" PRIu64 " sent)\n",
+			       (stats.processed - last_processed) / duration / 1e6,
+			       stats.received, stats.ignored, stats.failed, stats.sent);
+			last_cycles = cur_cycles;
+			last_processed = stats.processed;
+		}
+	}
+
+	duration = ((double) (rte_get_timer_cycles() - start_cycles)) / hz;
+	printf("\n%" PRIu64 " packets %s in %.3f seconds: %.3f Mpps\n",
+	       stats.processed, do_comp ? "compressed" : "decompressed", duration,
+	       (duration > 0 ? stats.processed / duration / 1e6 : 0));
+
+	status = 0;
+
+	if(compressor != NULL)
+	{
+		rohc_comp_free(compressor);
+	}
+	if(decompressor != NULL)
+	{
+		rohc_decomp_free(decompressor);
+	}
+stop_port:
+	rte_eth_dev_stop(port);
+	rte_eth_dev_close(port);
+free_pool:
+	rte_mempool_free(pool);
+cleanup_eal:
+	rte_eal_cleanup();
+error:
+	return status;
+}
+
+
+/**
+ * @brief Configure and start one DPDK port with one RX and one TX queue
+ *
+ * @param port  The DPDK port
+ * @param pool  The pool of mbufs for the received frames
+ * @return      0 in case of success, a negative value otherwise
+ */
+static int port_init(const uint16_t port, struct rte_mempool *const pool)
+{
+	struct rte_eth_conf port_conf;
+	int ret;
+
+	memset(&port_conf, 0, sizeof(struct rte_eth_conf));
+	ret = rte_eth_dev_configure(port, 1, 1, &port_conf);
+	if(ret != 0)
+	{
+		return ret;
+	}
+
+	ret = rte_eth_rx_queue_setup(port, 0, RING_SIZE, rte_eth_dev_socket_id(port),
+	                             NULL, pool);
+	if(ret < 0)
+	{
+		return ret;
+	}
+	ret = rte_eth_tx_queue_setup(port, 0, RING_SIZE, rte_eth_dev_socket_id(port),
+	                             NULL);
+	if(ret < 0)
+	{
+		return ret;
+	}
+
+	ret = rte_eth_dev_start(port);
+	if(ret < 0)
+	{
+		return ret;
+	}
+
+	/* receive all the traffic of the link */
+	return rte_eth_promiscuous_enable(port);
+}
+
+
+/**
+ * @brief Create the ROHC compressor
+ *
+ * @return  The ROHC compressor in case of success, NULL otherwise
+ */
+static struct rohc_comp * create_compressor(void)
+{
+	struct rohc_comp *compressor;
+
+	compressor = rohc_comp_new2(ROHC_LARGE_CID, EXAMPLE_MAX_CID,
+	                            gen_random_num, NULL);
+	if(compressor == NULL)
+	{
+		fprintf(stderr, "failed create the ROHC compressor\n");
+		goto error;
+	}
+
+	if(!rohc_comp_enable_profiles(compressor, ROHC_PROFILE_UNCOMPRESSED,
+	                              ROHC_PROFILE_UDP, ROHC_PROFILE_IP,
+	                              ROHC_PROFILE_ESP, ROHC_PROFILE_TCP, -1))
+	{
+		fprintf(stderr, "failed to enable the compression profiles\n");
+		goto release_compressor;
+	}
+
+	return compressor;
+
+release_compressor:
+	rohc_comp_free(compressor);
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Create the ROHC decompressor
+ *
+ * @return  The ROHC decompressor in case of success, NULL otherwise
+ */
+static struct rohc_decomp * create_decompressor(void)
+{
+	struct rohc_decomp *decompressor;
+
+	decompressor = rohc_decomp_new2(ROHC_LARGE_CID, EXAMPLE_MAX_CID,
+	                                ROHC_U_MODE);
+	if(decompressor == NULL)
+	{
+		fprintf(stderr, "failed create the ROHC decompressor\n");
+		goto error;
+	}
+
+	if(!rohc_decomp_enable_profiles(decompressor, ROHC_PROFILE_UNCOMPRESSED,
+	                                ROHC_PROFILE_UDP, ROHC_PROFILE_IP,
+	                                ROHC_PROFILE_ESP, ROHC_PROFILE_TCP, -1))
+	{
+		fprintf(stderr, "failed to enable the decompression profiles\n");
+		goto release_decompressor;
+	}
+
+	return decompressor;
+
+release_decompressor:
+	rohc_decomp_free(decompressor);
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Whether the given Ethernet frame shall be (de)compressed
+ *
+ * @param mbuf        The Ethernet frame
+ * @param ether_type  The expected EtherType, both IPv4 and IPv6 if 0
+ * @return            true if the frame shall be (de)compressed,
+ *                    false if it shall be ignored
+ */
+static bool frame_is_usable(const struct rte_mbuf *const mbuf,
+                            const uint16_t ether_type)
+{
+	const struct rte_ether_hdr *eth_hdr;
+	uint16_t frame_type;
+
+	/* the headers are parsed and rewritten in the first segment only */
+	if(!rte_pktmbuf_is_contiguous(mbuf) || mbuf->data_len <= RTE_ETHER_HDR_LEN)
+	{
+		return false;
+	}
+
+	eth_hdr = rte_pktmbuf_mtod(mbuf, const struct rte_ether_hdr *);
+	frame_type = rte_be_to_cpu_16(eth_hdr->ether_type);
+	if(ether_type != 0)
+	{
+		return (frame_type == ether_type);
+	}
+	return (frame_type == RTE_ETHER_TYPE_IPV4 ||
+	        frame_type == RTE_ETHER_TYPE_IPV6);
+}
+
+
+/**
+ * @brief Compress the headers of a burst of frames in place
+ *
+ * The ROHC header of every IP packet is computed with
+ * \ref rohc_compress_header, then written in the mbuf just in front of the
+ * payload, that is never copied.
+ *
+ * @param comp          The ROHC compressor
+ * @param[in,out] pkts  IN:  The received Ethernet frames
+ *                      OUT: The compressed frames to send
+ * @param pkts_nr       The number of received Ethernet frames
+ * @param arrival_time  The arrival time of the frames
+ * @param stats         The statistics of the program
+ * @return              The number of compressed frames to send
+ */
+static uint16_t comp_burst_inplace(struct rohc_comp *const comp,
+                                   struct rte_mbuf *pkts[],
+                                   const uint16_t pkts_nr,
+                                   const struct rohc_ts arrival_time,
+                                   struct example_stats *const stats)
+{
+	uint16_t out_nr = 0;
+	uint16_t i;
+
+	for(i = 0; i < pkts_nr; i++)
+	{
+		struct rte_mbuf *const mbuf = pkts[i];
+		uint8_t rohc_hdr_buf[HEADERS_MAX_LEN];
+		struct rohc_buf rohc_hdr =
+			rohc_buf_init_empty(rohc_hdr_buf, HEADERS_MAX_LEN);
+		struct rohc_buf ip_packet;
+		size_t payload_offset;
+		size_t payload_len;
+		rohc_status_t status;
+
+		if(!frame_is_usable(mbuf, 0))
+		{
+			stats->ignored++;
+			rte_pktmbuf_free(mbuf);
+			continue;
+		}
+
+		ip_packet = (struct rohc_buf)
+			rohc_buf_init_full(rte_pktmbuf_mtod_offset(mbuf, uint8_t *,
+			                                           RTE_ETHER_HDR_LEN),
+			                   mbuf->data_len - RTE_ETHER_HDR_LEN, arrival_time);
+		status = rohc_compress_header(comp, ip_packet, &rohc_hdr,
+		                              &payload_offset, &payload_len);
+		if(status != ROHC_STATUS_OK ||
+		   !rewrite_headers(mbuf, RTE_ETHER_HDR_LEN + payload_offset,
+		                    payload_len, rohc_hdr, ETHER_TYPE_ROHC))
+		{
+			stats->failed++;
+			rte_pktmbuf_free(mbuf);
+			continue;
+		}
+
+		stats->processed++;
+		pkts[out_nr] = mbuf;
+		out_nr++;
+	}
+
+	return out_nr;
+}
+
+
+/**
+ * @brief Decompress the headers of a burst of frames in place
+ *
+ * The uncompressed headers of every ROHC packet are computed with
+ * \ref rohc_decompress_header, then written in the mbuf just in front of the
+ * payload, that is never copied: the uncompressed headers being larger than
+ * the ROHC header, they are rewritten in the headroom of the mbuf.
+ *
+ * @param decomp        The ROHC decompressor
+ * @param[in,out] pkts  IN:  The received Ethernet frames
+ *                      OUT: The decompressed frames to send
+ * @param pkts_nr       The number of received Ethernet frames
+ * @param arrival_time  The arrival time of the frames
+ * @param stats         The statistics of the program
+ * @return              The number of decompressed frames to send
+ */
+static uint16_t decomp_burst_inplace(struct rohc_decomp *const decomp,
+                                     struct rte_mbuf *pkts[],
+                                     const uint16_t pkts_nr,
+                                     const struct rohc_ts arrival_time,
+                                     struct example_stats *const stats)
+{
+	uint16_t out_nr = 0;
+	uint16_t i;
+
+	for(i = 0; i < pkts_nr; i++)
+	{
+		struct rte_mbuf *const mbuf = pkts[i];
+		uint8_t ip_hdrs_buf[HEADERS_MAX_LEN];
+		struct rohc_buf ip_hdrs =
+			rohc_buf_init_empty(ip_hdrs_buf, HEADERS_MAX_LEN);
+		struct rohc_buf rohc_packet;
+		size_t payload_offset;
+		size_t payload_len;
+		rohc_status_t status;
+
+		if(!frame_is_usable(mbuf, ETHER_TYPE_ROHC))
+		{
+			stats->ignored++;
+			rte_pktmbuf_free(mbuf);
+			continue;
+		}
+
+		rohc_packet = (struct rohc_buf)
+			rohc_buf_init_full(rte_pktmbuf_mtod_offset(mbuf, uint8_t *,
+			                                           RTE_ETHER_HDR_LEN),
+			                   mbuf->data_len - RTE_ETHER_HDR_LEN, arrival_time);
+		status = rohc_decompress_header(decomp, rohc_packet, &ip_hdrs,
+		                                &payload_offset, &payload_len,
+		                                NULL, NULL);
+		if(status == ROHC_STATUS_OK && rohc_buf_is_empty(ip_hdrs))
+		{
+			/* feedback-only packet, nothing to send */
+			stats->ignored++;
+			rte_pktmbuf_free(mbuf);
+			continue;
+		}
+		if(status != ROHC_STATUS_OK ||
+		   !rewrite_headers(mbuf, RTE_ETHER_HDR_LEN + payload_offset,
+		                    payload_len, ip_hdrs,
+		                    (rohc_buf_byte(ip_hdrs) >> 4) == 6 ?
+		                    RTE_ETHER_TYPE_IPV6 : RTE_ETHER_TYPE_IPV4))
+		{
+			stats->failed++;
+			rte_pktmbuf_free(mbuf);
+			continue;
+		}
+
+		stats->processed++;
+		pkts[out_nr] = mbuf;
+		out_nr++;
+	}
+
+	return out_nr;
+}
+
+
+/**
+ * @brief Replace the headers of an Ethernet frame, the payload left in place
+ *
+ * The Ethernet addresses of the frame are kept, the EtherType is replaced.
+ * The new headers may be larger than the old ones as long as the headroom
+ * of the mbuf is large enough.
+ *
+ * @param mbuf          The Ethernet frame
+ * @param old_hdrs_len  The length of the headers to remove, Ethernet included
+ * @param payload_len   The length of the payload that follows the headers,
+ *                      the Ethernet padding is removed
+ * @param new_hdrs      The headers to put in front of the payload,
+ *                      Ethernet excluded
+ * @param ether_type    The new EtherType of the Ethernet frame
+ * @return              true if the headers were replaced,
+ *                      false if the headroom of the mbuf is too small
+ */
+static bool rewrite_headers(struct rte_mbuf *const mbuf,
+                            const size_t old_hdrs_len,
+                            const size_t payload_len,
+                            const struct rohc_buf new_hdrs,
+                            const uint16_t ether_type)
+{
+	struct rte_ether_hdr eth_hdr;
+	struct rte_ether_hdr *new_eth_hdr;
+	char *new_hdrs_data;
+
+	memcpy(&eth_hdr, rte_pktmbuf_mtod(mbuf, struct rte_ether_hdr *),
+	       sizeof(struct rte_ether_hdr));
+
+	/* remove the old headers and the Ethernet padding */
+	if(rte_pktmbuf_adj(mbuf, old_hdrs_len) == NULL)
+	{
+		return false;
+	}
+	if(mbuf->data_len > payload_len &&
+	   rte_pktmbuf_trim(mbuf, mbuf->data_len - payload_len) != 0)
+	{
+		return false;
+	}
+
+	/* put the new headers in the space freed by the old headers and in the
+	 * headroom of the mbuf */
+	new_hdrs_data = rte_pktmbuf_prepend(mbuf, RTE_ETHER_HDR_LEN + new_hdrs.len);
+	if(new_hdrs_data == NULL)
+	{
+		return false;
+	}
+	new_eth_hdr = (struct rte_ether_hdr *) new_hdrs_data;
+	rte_ether_addr_copy(&eth_hdr.dst_addr, &new_eth_hdr->dst_addr);
+	rte_ether_addr_copy(&eth_hdr.src_addr, &new_eth_hdr->src_addr);
+	new_eth_hdr->ether_type = rte_cpu_to_be_16(ether_type);
+	memcpy(new_hdrs_data + RTE_ETHER_HDR_LEN, rohc_buf_data(new_hdrs),
+	       new_hdrs.len);
+
+	return true;
+}
+
+
+/**
+ * @brief Compress a burst of frames at once into new mbufs
+ *
+ * @param comp          The ROHC compressor
+ * @param pool          The pool of mbufs for the compressed frames
+ * @param[in,out] pkts  IN:  The received Ethernet frames
+ *                      OUT: The compressed frames to send
+ * @param pkts_nr       The number of received Ethernet frames
+ * @param arrival_time  The arrival time of the frames
+ * @param stats         The statistics of the program
+ * @return              The number of compressed frames to send
+ */
+static uint16_t comp_burst_batch(struct rohc_comp *const comp,
+                                 struct rte_mempool *const pool,
+                                 struct rte_mbuf *pkts[],
+                                 const uint16_t pkts_nr,
+                                 const struct rohc_ts arrival_time,
+                                 struct example_stats *const stats)
+{
+	struct rte_mbuf *ip_mbufs[BURST_SIZE];
+	struct rte_mbuf *rohc_mbufs[BURST_SIZE];
+	struct rohc_buf ip_packets[BURST_SIZE];
+	struct rohc_buf rohc_packets[BURST_SIZE];
+	rohc_status_t statuses[BURST_SIZE];
+	uint16_t ip_nr = 0;
+	uint16_t out_nr = 0;
+	size_t processed_nr;
+	uint16_t i;
+
+	/* keep the IP packets only */
+	for(i = 0; i < pkts_nr; i++)
+	{
+		if(!frame_is_usable(pkts[i], 0))
+		{
+			stats->ignored++;
+			rte_pktmbuf_free(pkts[i]);
+			continue;
+		}
+		ip_packets[ip_nr] = (struct rohc_buf)
+			rohc_buf_init_full(rte_pktmbuf_mtod_offset(pkts[i], uint8_t *,
+			                                           RTE_ETHER_HDR_LEN),
+			                   pkts[i]->data_len - RTE_ETHER_HDR_LEN,
+			                   arrival_time);
+		ip_mbufs[ip_nr] = pkts[i];
+		ip_nr++;
+	}
+	if(ip_nr == 0)
+	{
+		goto out;
+	}
+
+	/* the ROHC packets are built just after the room for the Ethernet
+	 * header in new mbufs */
+	if(rte_pktmbuf_alloc_bulk(pool, rohc_mbufs, ip_nr) != 0)
+	{
+		stats->failed += ip_nr;
+		for(i = 0; i < ip_nr; i++)
+		{
+			rte_pktmbuf_free(ip_mbufs[i]);
+		}
+		goto out;
+	}
+	for(i = 0; i < ip_nr; i++)
+	{
+		rohc_packets[i] = (struct rohc_buf)
+			rohc_buf_init_empty(rte_pktmbuf_mtod_offset(rohc_mbufs[i], uint8_t *,
+			                                            RTE_ETHER_HDR_LEN),
+			                    rte_pktmbuf_tailroom(rohc_mbufs[i]) -
+			                    RTE_ETHER_HDR_LEN);
+	}
+
+	/* ROHC segmentation is not enabled, so the whole burst is processed */
+	processed_nr = rohc_compress_batch(comp, ip_packets, rohc_packets, statuses,
+	                                   ip_nr);
+
+	for(i = 0; i < ip_nr; i++)
+	{
+		struct rte_ether_hdr *eth_hdr;
+
+		if(i >= processed_nr || statuses[i] != ROHC_STATUS_OK)
+		{
+			stats->failed++;
+			rte_pktmbuf_free(rohc_mbufs[i]);
+			rte_pktmbuf_free(ip_mbufs[i]);
+			continue;
+		}
+
+		eth_hdr = (struct rte_ether_hdr *)
+			rte_pktmbuf_append(rohc_mbufs[i],
+			                   RTE_ETHER_HDR_LEN + rohc_packets[i].len);
+		memcpy(eth_hdr, rte_pktmbuf_mtod(ip_mbufs[i], struct rte_ether_hdr *),
+		       sizeof(struct rte_ether_hdr));
+		eth_hdr->ether_type = rte_cpu_to_be_16(ETHER_TYPE_ROHC);
+		rte_pktmbuf_free(ip_mbufs[i]);
+
+		stats->processed++;
+		pkts[out_nr] = rohc_mbufs[i];
+		out_nr++;
+	}
+
+out:
+	return out_nr;
+}
+
+
+/**
+ * @brief Decompress a burst of frames at once into new mbufs
+ *
+ * @param decomp        The ROHC decompressor
+ * @param pool          The pool of mbufs for the decompressed frames
+ * @param[in,out] pkts  IN:  The received Ethernet frames
+ *                      OUT: The decompressed frames to send
+ * @param pkts_nr       The number of received Ethernet frames
+ * @param arrival_time  The arrival time of the frames
+ * @param stats         The statistics of the program
+ * @return              The number of decompressed frames to send
+ */
+static uint16_t decomp_burst_batch(struct rohc_decomp *const decomp,
+                                   struct rte_mempool *const pool,
+                                   struct rte_mbuf *pkts[],
+                                   const uint16_t pkts_nr,
+                                   const struct rohc_ts arrival_time,
+                                   struct example_stats *const stats)
+{
+	struct rte_mbuf *rohc_mbufs[BURST_SIZE];
+	struct rte_mbuf *ip_mbufs[BURST_SIZE];
+	struct rohc_buf rohc_packets[BURST_SIZE];
+	struct rohc_buf ip_packets[BURST_SIZE];
+	rohc_status_t statuses[BURST_SIZE];
+	uint16_t rohc_nr = 0;
+	uint16_t out_nr = 0;
+	uint16_t i;
+
+	/* keep the ROHC packets only */
+	for(i = 0; i < pkts_nr; i++)
+	{
+		if(!frame_is_usable(pkts[i], ETHER_TYPE_ROHC))
+		{
+			stats->ignored++;
+			rte_pktmbuf_free(pkts[i]);
+			continue;
+		}
+		rohc_packets[rohc_nr] = (struct rohc_buf)
+			rohc_buf_init_full(rte_pktmbuf_mtod_offset(pkts[i], uint8_t *,
+			                                           RTE_ETHER_HDR_LEN),
+			                   pkts[i]->data_len - RTE_ETHER_HDR_LEN,
+			                   arrival_time);
+		rohc_mbufs[rohc_nr] = pkts[i];
+		rohc_nr++;
+	}
+	if(rohc_nr == 0)
+	{
+		goto out;
+	}
+
+	/* the IP packets are built just after the room for the Ethernet header
+	 * in new mbufs */
+	if(rte_pktmbuf_alloc_bulk(pool, ip_mbufs, rohc_nr) != 0)
+	{
+		stats->failed += rohc_nr;
+		for(i = 0; i < rohc_nr; i++)
+		{
+			rte_pktmbuf_free(rohc_mbufs[i]);
+		}
+		goto out;
+	}
+	for(i = 0; i < rohc_nr; i++)
+	{
+		ip_packets[i] = (struct rohc_buf)
+			rohc_buf_init_empty(rte_pktmbuf_mtod_offset(ip_mbufs[i], uint8_t *,
+			                                            RTE_ETHER_HDR_LEN),
+			                    rte_pktmbuf_tailroom(ip_mbufs[i]) -
+			                    RTE_ETHER_HDR_LEN);
+	}
+
+	if(!rohc_decompress_batch(decomp, rohc_packets, ip_packets, statuses,
+	                          rohc_nr, NULL, NULL))
+	{
+		for(i = 0; i < rohc_nr; i++)
+		{
+			statuses[i] = ROHC_STATUS_ERROR;
+		}
+	}
+
+	for(i = 0; i < rohc_nr; i++)
+	{
+		struct rte_ether_hdr *eth_hdr;
+
+		if(statuses[i] != ROHC_STATUS_OK || rohc_buf_is_empty(ip_packets[i]))
+		{
+			/* failure or feedback-only packet */
+			if(statuses[i] != ROHC_STATUS_OK)
+			{
+				stats->failed++;
+			}
+			else
+			{
+				stats->ignored++;
+			}
+			rte_pktmbuf_free(ip_mbufs[i]);
+			rte_pktmbuf_free(rohc_mbufs[i]);
+			continue;
+		}
+
+		eth_hdr = (struct rte_ether_hdr *)
+			rte_pktmbuf_append(ip_mbufs[i], RTE_ETHER_HDR_LEN + ip_packets[i].len);
+		memcpy(eth_hdr, rte_pktmbuf_mtod(rohc_mbufs[i], struct rte_ether_hdr *),
+		       sizeof(struct rte_ether_hdr));
+		eth_hdr->ether_type =
+			rte_cpu_to_be_16((rohc_buf_byte(ip_packets[i]) >> 4) == 6 ?
+			                 RTE_ETHER_TYPE_IPV6 : RTE_ETHER_TYPE_IPV4);
+		rte_pktmbuf_free(rohc_mbufs[i]);
+
+		stats->processed++;
+		pkts[out_nr] = ip_mbufs[i];
+		out_nr++;
+	}
+
+out:
+	return out_nr;
+}
+
+
+/**
+ * @brief Generate a random number
+ *
+ * @param comp          The ROHC compressor
+ * @param user_context  Should always be NULL
+ * @return              A random number
+ */
+static int gen_random_num(const struct rohc_comp *const comp,
+                          void *const user_context)
+{
+	return rand();
+}
+
+
+/**
+ * @brief Stop the program on SIGINT or SIGTERM
+ *
+ * @param signum  The received signal
+ */
+static void stop_on_signal(int signum)
+{
+	stop_program = 1;
+}
+
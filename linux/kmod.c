@@ -52,6 +52,10 @@ EXPORT_SYMBOL_GPL(rohc_get_profile_descr);
 EXPORT_SYMBOL_GPL(rohc_get_packet_descr);
 EXPORT_SYMBOL_GPL(rohc_get_ext_descr);
 EXPORT_SYMBOL_GPL(rohc_get_packet_type);
+EXPORT_SYMBOL_GPL(rohc_alloc_set_steady_state);
+EXPORT_SYMBOL_GPL(rohc_alloc_get_stats);
+EXPORT_SYMBOL_GPL(rohc_alloc_set_allocator);
+EXPORT_SYMBOL_GPL(rohc_alloc_set_numa_allocator);
 
 EXPORT_SYMBOL_GPL(rohc_buf_is_malformed);
 EXPORT_SYMBOL_GPL(rohc_buf_is_empty);
@@ -74,36 +78,95 @@ EXPORT_SYMBOL_GPL(rohc_buf_reset);
 EXPORT_SYMBOL_GPL(rohc_comp_new2);
 EXPORT_SYMBOL_GPL(rohc_comp_free);
 EXPORT_SYMBOL_GPL(rohc_compress4);
+EXPORT_SYMBOL_GPL(rohc_compress_batch);
+EXPORT_SYMBOL_GPL(rohc_compress_iov);
+EXPORT_SYMBOL_GPL(rohc_compress_with_cid);
+EXPORT_SYMBOL_GPL(rohc_compress_header);
+EXPORT_SYMBOL_GPL(rohc_compress_inplace);
 EXPORT_SYMBOL_GPL(rohc_comp_force_contexts_reinit);
+EXPORT_SYMBOL_GPL(rohc_comp_set_reinit_pacing);
+EXPORT_SYMBOL_GPL(rohc_comp_reset);
 
 /* segment */
 EXPORT_SYMBOL_GPL(rohc_comp_get_segment2);
+EXPORT_SYMBOL_GPL(rohc_comp_get_segment_iov);
 
 /* feedback */
 EXPORT_SYMBOL_GPL(rohc_comp_deliver_feedback2);
+EXPORT_SYMBOL_GPL(rohc_comp_deliver_feedback_batch);
+EXPORT_SYMBOL_GPL(rohc_comp_enqueue_feedback);
+EXPORT_SYMBOL_GPL(rohc_comp_attach_decomp);
 
 /* statistics */
 EXPORT_SYMBOL_GPL(rohc_comp_get_state_descr);
 EXPORT_SYMBOL_GPL(rohc_comp_get_general_info);
+EXPORT_SYMBOL_GPL(rohc_comp_get_next_ctxt_stats);
+EXPORT_SYMBOL_GPL(rohc_comp_get_packet_stats);
+EXPORT_SYMBOL_GPL(rohc_comp_get_latency_stats);
+EXPORT_SYMBOL_GPL(rohc_comp_get_stage_cycles);
+EXPORT_SYMBOL_GPL(rohc_comp_get_stage_descr);
+EXPORT_SYMBOL_GPL(rohc_comp_get_memory_usage);
 EXPORT_SYMBOL_GPL(rohc_comp_get_last_packet_info2);
 
+/* groups of compressors */
+EXPORT_SYMBOL_GPL(rohc_comp_group_new);
+EXPORT_SYMBOL_GPL(rohc_comp_group_free);
+EXPORT_SYMBOL_GPL(rohc_comp_group_get_shard);
+EXPORT_SYMBOL_GPL(rohc_comp_group_steer);
+EXPORT_SYMBOL_GPL(rohc_comp_group_deliver_feedback);
+
+/* shared configurations of compressors */
+EXPORT_SYMBOL_GPL(rohc_comp_config_new);
+EXPORT_SYMBOL_GPL(rohc_comp_config_free);
+EXPORT_SYMBOL_GPL(rohc_comp_config_enable_profile);
+EXPORT_SYMBOL_GPL(rohc_comp_config_set_wlsb_window_width);
+EXPORT_SYMBOL_GPL(rohc_comp_config_set_ctxts_prealloc);
+EXPORT_SYMBOL_GPL(rohc_comp_config_set_numa_node);
+EXPORT_SYMBOL_GPL(rohc_comp_config_set_periodic_refreshes);
+EXPORT_SYMBOL_GPL(rohc_comp_config_set_mrru);
+EXPORT_SYMBOL_GPL(rohc_comp_config_set_rtp_detection_cb);
+EXPORT_SYMBOL_GPL(rohc_comp_new_from_config);
+
+/* migration of contexts */
+EXPORT_SYMBOL_GPL(rohc_comp_ctxt_export);
+EXPORT_SYMBOL_GPL(rohc_comp_ctxt_import);
+EXPORT_SYMBOL_GPL(rohc_comp_ctxt_export_free);
+
+/* snapshots */
+EXPORT_SYMBOL_GPL(rohc_comp_snapshot);
+EXPORT_SYMBOL_GPL(rohc_comp_restore);
+
 /* configuration */
 EXPORT_SYMBOL_GPL(rohc_comp_profile_enabled);
 EXPORT_SYMBOL_GPL(rohc_comp_enable_profile);
 EXPORT_SYMBOL_GPL(rohc_comp_disable_profile);
 EXPORT_SYMBOL_GPL(rohc_comp_enable_profiles);
 EXPORT_SYMBOL_GPL(rohc_comp_disable_profiles);
+EXPORT_SYMBOL_GPL(rohc_comp_register_profile);
 EXPORT_SYMBOL_GPL(rohc_comp_set_mrru);
 EXPORT_SYMBOL_GPL(rohc_comp_get_mrru);
+EXPORT_SYMBOL_GPL(rohc_comp_set_rru_slots);
 EXPORT_SYMBOL_GPL(rohc_comp_get_max_cid);
 EXPORT_SYMBOL_GPL(rohc_comp_get_cid_type);
 EXPORT_SYMBOL_GPL(rohc_comp_set_wlsb_window_width);
 EXPORT_SYMBOL_GPL(rohc_comp_set_periodic_refreshes);
+EXPORT_SYMBOL_GPL(rohc_comp_set_periodic_refreshes_time);
+EXPORT_SYMBOL_GPL(rohc_comp_set_ctxt_idle_timeout);
+EXPORT_SYMBOL_GPL(rohc_comp_set_profile_failure_timeout);
+EXPORT_SYMBOL_GPL(rohc_comp_set_ctxts_prealloc);
+EXPORT_SYMBOL_GPL(rohc_comp_prewarm_ctxts);
 EXPORT_SYMBOL_GPL(rohc_comp_set_traces_cb2);
+EXPORT_SYMBOL_GPL(rohc_comp_set_trace_level);
+EXPORT_SYMBOL_GPL(rohc_comp_set_trace_ring);
+EXPORT_SYMBOL_GPL(rohc_comp_get_trace_records);
 EXPORT_SYMBOL_GPL(rohc_comp_set_features);
+EXPORT_SYMBOL_GPL(rohc_comp_set_recorder);
 
 /* RTP-specific configuration */
 EXPORT_SYMBOL_GPL(rohc_comp_set_rtp_detection_cb);
+EXPORT_SYMBOL_GPL(rohc_comp_add_rtp_ports);
+EXPORT_SYMBOL_GPL(rohc_comp_remove_rtp_ports);
+EXPORT_SYMBOL_GPL(rohc_comp_set_rtp_min_sequential);
 
 
 /*
@@ -112,29 +175,78 @@ EXPORT_SYMBOL_GPL(rohc_comp_set_rtp_detection_cb);
 
 /* general */
 EXPORT_SYMBOL_GPL(rohc_decomp_new2);
+EXPORT_SYMBOL_GPL(rohc_decomp_new_on_node);
 EXPORT_SYMBOL_GPL(rohc_decomp_free);
+EXPORT_SYMBOL_GPL(rohc_decomp_reset);
 EXPORT_SYMBOL_GPL(rohc_decompress3);
+EXPORT_SYMBOL_GPL(rohc_decompress_batch);
+EXPORT_SYMBOL_GPL(rohc_decomp_prefetch);
+EXPORT_SYMBOL_GPL(rohc_decompress_inplace);
+EXPORT_SYMBOL_GPL(rohc_decompress_header);
+EXPORT_SYMBOL_GPL(rohc_decomp_set_stream_framing);
+EXPORT_SYMBOL_GPL(rohc_decompress_stream);
 
 /* statistics */
 EXPORT_SYMBOL_GPL(rohc_decomp_get_state_descr);
 EXPORT_SYMBOL_GPL(rohc_decomp_get_general_info);
+EXPORT_SYMBOL_GPL(rohc_decomp_get_packet_stats);
+EXPORT_SYMBOL_GPL(rohc_decomp_get_latency_stats);
+EXPORT_SYMBOL_GPL(rohc_decomp_get_stage_cycles);
+EXPORT_SYMBOL_GPL(rohc_decomp_get_stage_descr);
+EXPORT_SYMBOL_GPL(rohc_decomp_get_memory_usage);
 EXPORT_SYMBOL_GPL(rohc_decomp_get_context_info);
 EXPORT_SYMBOL_GPL(rohc_decomp_get_last_packet_info);
 
+/* groups of decompressors */
+EXPORT_SYMBOL_GPL(rohc_decomp_group_new);
+EXPORT_SYMBOL_GPL(rohc_decomp_group_free);
+EXPORT_SYMBOL_GPL(rohc_decomp_group_get_worker);
+EXPORT_SYMBOL_GPL(rohc_decomp_group_push);
+EXPORT_SYMBOL_GPL(rohc_decomp_group_decompress);
+EXPORT_SYMBOL_GPL(rohc_decomp_group_pull_feedback);
+
+/* snapshots */
+EXPORT_SYMBOL_GPL(rohc_decomp_snapshot);
+EXPORT_SYMBOL_GPL(rohc_decomp_restore);
+
+/* journal of context updates */
+EXPORT_SYMBOL_GPL(rohc_decomp_set_journal_cb);
+EXPORT_SYMBOL_GPL(rohc_decomp_journal_apply);
+
+/* deferred and coalesced feedback */
+EXPORT_SYMBOL_GPL(rohc_decomp_flush_feedback);
+EXPORT_SYMBOL_GPL(rohc_decomp_set_feedback_coalescing);
+EXPORT_SYMBOL_GPL(rohc_decomp_set_feedback_budget);
+EXPORT_SYMBOL_GPL(rohc_decomp_set_feedback_cb);
+
 /* configuration */
 EXPORT_SYMBOL_GPL(rohc_decomp_profile_enabled);
 EXPORT_SYMBOL_GPL(rohc_decomp_enable_profile);
 EXPORT_SYMBOL_GPL(rohc_decomp_disable_profile);
 EXPORT_SYMBOL_GPL(rohc_decomp_enable_profiles);
 EXPORT_SYMBOL_GPL(rohc_decomp_disable_profiles);
+EXPORT_SYMBOL_GPL(rohc_decomp_register_profile);
 EXPORT_SYMBOL_GPL(rohc_decomp_get_cid_type);
 EXPORT_SYMBOL_GPL(rohc_decomp_get_max_cid);
 EXPORT_SYMBOL_GPL(rohc_decomp_set_mrru);
 EXPORT_SYMBOL_GPL(rohc_decomp_get_mrru);
 EXPORT_SYMBOL_GPL(rohc_decomp_set_rate_limits);
 EXPORT_SYMBOL_GPL(rohc_decomp_get_rate_limits);
+EXPORT_SYMBOL_GPL(rohc_decomp_set_crc_repair_budget);
+EXPORT_SYMBOL_GPL(rohc_decomp_get_crc_repair_budget);
+EXPORT_SYMBOL_GPL(rohc_decomp_set_reorder_window);
+EXPORT_SYMBOL_GPL(rohc_decomp_get_reorder_window);
+EXPORT_SYMBOL_GPL(rohc_decomp_set_contexts_pool);
+EXPORT_SYMBOL_GPL(rohc_decomp_get_contexts_pool);
+EXPORT_SYMBOL_GPL(rohc_decomp_prewarm_contexts);
+EXPORT_SYMBOL_GPL(rohc_decomp_set_ctxt_idle_timeout);
+EXPORT_SYMBOL_GPL(rohc_decomp_set_clock);
 EXPORT_SYMBOL_GPL(rohc_decomp_set_prtt);
 EXPORT_SYMBOL_GPL(rohc_decomp_get_prtt);
 EXPORT_SYMBOL_GPL(rohc_decomp_set_traces_cb2);
+EXPORT_SYMBOL_GPL(rohc_decomp_set_trace_level);
+EXPORT_SYMBOL_GPL(rohc_decomp_set_trace_ring);
+EXPORT_SYMBOL_GPL(rohc_decomp_get_trace_records);
 EXPORT_SYMBOL_GPL(rohc_decomp_set_features);
+EXPORT_SYMBOL_GPL(rohc_decomp_set_recorder);
 
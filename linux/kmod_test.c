@@ -261,16 +261,35 @@ int rohc_couple_init_phase1(struct rohc_couple *couple, int index)
 		goto free_compressor;
 	}
 
-	/* activate all the compression profiles */
+	/* activate all the compression profiles built in the library */
 	is_ok = rohc_comp_enable_profiles(couple->comp,
-			ROHC_PROFILE_UNCOMPRESSED, ROHC_PROFILE_RTP,
-			ROHC_PROFILE_UDP, ROHC_PROFILE_ESP, ROHC_PROFILE_IP,
-			ROHC_PROFILE_TCP, ROHC_PROFILE_UDPLITE, -1);
+#if ROHC_WITH_PROFILE_UNCOMPRESSED == 1
+			ROHC_PROFILE_UNCOMPRESSED,
+#endif
+#if ROHC_WITH_PROFILE_RTP == 1
+			ROHC_PROFILE_RTP,
+#endif
+#if ROHC_WITH_PROFILE_UDP == 1
+			ROHC_PROFILE_UDP,
+#endif
+#if ROHC_WITH_PROFILE_ESP == 1
+			ROHC_PROFILE_ESP,
+#endif
+#if ROHC_WITH_PROFILE_IP == 1
+			ROHC_PROFILE_IP,
+#endif
+#if ROHC_WITH_PROFILE_TCP == 1
+			ROHC_PROFILE_TCP,
+#endif
+#if ROHC_WITH_PROFILE_UDPLITE == 1
+			ROHC_PROFILE_UDPLITE,
+#endif
+			-1);
 	if (!is_ok) {
 		rohc_err("\tfailed to enabled all compression profiles\n");
 		goto free_compressor;
 	}
-	rohc_info("\tUncompressed, RTP, UDP, ESP, IP, TCP and UDP-Lite profiles enabled for ROHC compressor successfully set\n");
+	rohc_info("\tall the profiles built in the library enabled for ROHC compressor successfully set\n");
 
 	/* set UDP ports dedicated to RTP traffic */
 	if (!rohc_comp_set_rtp_detection_cb(couple->comp, rohc_comp_rtp_cb,
@@ -334,16 +353,35 @@ int rohc_couple_init_phase2(struct rohc_couple *couple, int index)
 		goto free_decompressor;
 	}
 
-	/* activate all the decompression profiles */
+	/* activate all the decompression profiles built in the library */
 	is_ok = rohc_decomp_enable_profiles(couple->decomp,
-			ROHC_PROFILE_UNCOMPRESSED, ROHC_PROFILE_RTP,
-			ROHC_PROFILE_UDP, ROHC_PROFILE_ESP, ROHC_PROFILE_IP,
-			ROHC_PROFILE_TCP, ROHC_PROFILE_UDPLITE, -1);
+#if ROHC_WITH_PROFILE_UNCOMPRESSED == 1
+			ROHC_PROFILE_UNCOMPRESSED,
+#endif
+#if ROHC_WITH_PROFILE_RTP == 1
+			ROHC_PROFILE_RTP,
+#endif
+#if ROHC_WITH_PROFILE_UDP == 1
+			ROHC_PROFILE_UDP,
+#endif
+#if ROHC_WITH_PROFILE_ESP == 1
+			ROHC_PROFILE_ESP,
+#endif
+#if ROHC_WITH_PROFILE_IP == 1
+			ROHC_PROFILE_IP,
+#endif
+#if ROHC_WITH_PROFILE_TCP == 1
+			ROHC_PROFILE_TCP,
+#endif
+#if ROHC_WITH_PROFILE_UDPLITE == 1
+			ROHC_PROFILE_UDPLITE,
+#endif
+			-1);
 	if (!is_ok) {
 		rohc_err("\tfailed to enabled all decompression profiles\n");
 		goto free_decompressor;
 	}
-	rohc_info("\tUncompressed, RTP, UDP, ESP, IP, TCP and UDP-Lite profiles enabled for ROHC decompressor successfully set\n");
+	rohc_info("\tall the profiles built in the library enabled for ROHC decompressor successfully set\n");
 
 	/* allocate memory for the ROHC packet generated from IP packet and
 	 * init all the related lengths and pointers
@@ -0,0 +1,1060 @@
+/*
+ * Copyright 2026 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/**
+ * @file    kmod_tunnel.c
+ * @brief   A module for the Linux kernel that creates a ROHC tunnel device
+ * @author  Didier Barvaux <didier@barvaux.org>
+ *
+ * The module creates one virtual network device named rohc%d. The IP packets
+ * routed through the device are compressed and sent in UDP datagrams to the
+ * remote end of the tunnel. The UDP datagrams received from the remote end
+ * are decompressed and delivered by the device. Packets are (de)compressed
+ * from and to socket buffers, without any copy to or from userspace.
+ *
+ * Example of a tunnel between 192.168.0.1 and 192.168.0.2:
+ *
+ *   host1# insmod rohc.ko
+ *   host1# insmod rohc_tunnel.ko remote_addr=192.168.0.2
+ *   host1# ip addr add 10.0.0.1 peer 10.0.0.2 dev rohc0
+ *   host1# ip link set rohc0 up
+ *
+ *   host2# insmod rohc.ko
+ *   host2# insmod rohc_tunnel.ko remote_addr=192.168.0.1
+ *   host2# ip addr add 10.0.0.2 peer 10.0.0.1 dev rohc0
+ *   host2# ip link set rohc0 up
+ *
+ * The device has one transmit queue per possible CPU and one compressor
+ * shard per transmit queue (see rohc_comp_group_new()): the CID space of the
+ * tunnel is split between the shards, every flow is steered to the queue of
+ * the shard that owns its context, and the shards compress packets in
+ * parallel without any lock.
+ *
+ * The compressor and the decompressor work in Unidirectional mode, unless
+ * the omode parameter is set: the decompressor then sends its feedback in
+ * standalone datagrams, and the feedback received from the remote end is
+ * enqueued for the shards from the receive path without taking any lock of
+ * the transmit path. Both ends shall use the same MTU and the same CIDs.
+ *
+ * The received datagrams are queued on the CPU that received them, then
+ * decompressed by the NAPI instance of that CPU in bursts of
+ * ROHC_TUNNEL_BATCH_MAX packets (see rohc_decompress_batch()) and given to
+ * the network stack as lists (see netif_receive_skb_list()).
+ */
+
+#include <linux/module.h>
+#include <linux/netdevice.h>
+#include <linux/percpu.h>
+#include <linux/skbuff.h>
+#include <linux/etherdevice.h>
+#include <linux/if_arp.h>
+#include <linux/inet.h>
+#include <linux/ip.h>
+#include <linux/udp.h>
+#include <linux/random.h>
+#include <linux/timekeeping.h>
+#include <net/ip.h>
+#include <net/route.h>
+#include <net/udp.h>
+#include <net/udp_tunnel.h>
+
+#include "config.h"
+#include "rohc.h"
+#include "rohc_comp.h"
+#include "rohc_decomp.h"
+
+
+/** The default UDP port of the ROHC tunnel, on both ends */
+#define ROHC_TUNNEL_DEFAULT_PORT  5555
+
+/** The default MTU of the ROHC tunnel device */
+#define ROHC_TUNNEL_DEFAULT_MTU  1400
+
+/** The maximal MTU of the ROHC tunnel device */
+#define ROHC_TUNNEL_MAX_MTU  (0xffff - sizeof(struct iphdr) - \
+			      sizeof(struct udphdr))
+
+/**
+ * @brief The room for the ROHC headers that are larger than the headers they
+ *        compress (IR packets, segments...) and for the Add-CID octets
+ */
+#define ROHC_TUNNEL_MAX_OVERHEAD  128
+
+/** The maximal size of the feedback generated for one ROHC packet */
+#define ROHC_TUNNEL_MAX_FEEDBACK  64
+
+/** The maximal number of ROHC packets decompressed in one burst */
+#define ROHC_TUNNEL_BATCH_MAX  32
+
+/** The maximal number of ROHC packets queued per CPU for decompression */
+#define ROHC_TUNNEL_QUEUE_MAX  1000
+
+
+/** Custom pr_info() macro for the module */
+#define rohc_info(format, ...) \
+	pr_info("[%s] " format, THIS_MODULE->name, ##__VA_ARGS__)
+
+/** Custom pr_err() macro for the module */
+#define rohc_err(format, ...) \
+	pr_err("[%s] " format, THIS_MODULE->name, ##__VA_ARGS__)
+
+
+/** The IPv4 address of the remote end of the tunnel */
+static char *remote_addr;
+module_param(remote_addr, charp, 0444);
+MODULE_PARM_DESC(remote_addr, "IPv4 address of the remote end of the tunnel");
+
+/** The UDP port of the local end of the tunnel */
+static ushort local_port = ROHC_TUNNEL_DEFAULT_PORT;
+module_param(local_port, ushort, 0444);
+MODULE_PARM_DESC(local_port, "UDP port of the local end of the tunnel");
+
+/** The UDP port of the remote end of the tunnel */
+static ushort remote_port = ROHC_TUNNEL_DEFAULT_PORT;
+module_param(remote_port, ushort, 0444);
+MODULE_PARM_DESC(remote_port, "UDP port of the remote end of the tunnel");
+
+/** Whether the tunnel uses large CIDs or small CIDs */
+static bool large_cid;
+module_param(large_cid, bool, 0444);
+MODULE_PARM_DESC(large_cid, "Use large CIDs instead of small CIDs");
+
+/** The largest CID used by the tunnel */
+static ushort max_cid = ROHC_SMALL_CID_MAX;
+module_param(max_cid, ushort, 0444);
+MODULE_PARM_DESC(max_cid, "Largest CID used by the tunnel");
+
+/** Whether the tunnel works in Bidirectional Optimistic mode */
+static bool omode;
+module_param(omode, bool, 0444);
+MODULE_PARM_DESC(omode, "Work in Bidirectional Optimistic mode");
+
+
+/** The receive path of the ROHC tunnel on one CPU */
+struct rohc_tunnel_cell {
+	/** The ROHC packets received on the CPU, waiting for decompression */
+	struct sk_buff_head queue;
+	/** The NAPI instance that decompresses the ROHC packets */
+	struct napi_struct napi;
+	/** The ROHC tunnel */
+	struct rohc_tunnel *tunnel;
+
+	/** The ROHC packets of the current burst */
+	struct sk_buff *rohc_skbs[ROHC_TUNNEL_BATCH_MAX];
+	/** The IP packets of the current burst */
+	struct sk_buff *ip_skbs[ROHC_TUNNEL_BATCH_MAX];
+	/** The data of the ROHC packets of the current burst */
+	struct rohc_buf rohc_packets[ROHC_TUNNEL_BATCH_MAX];
+	/** The data of the IP packets of the current burst */
+	struct rohc_buf ip_packets[ROHC_TUNNEL_BATCH_MAX];
+	/** The statuses of the decompression of the current burst */
+	rohc_status_t statuses[ROHC_TUNNEL_BATCH_MAX];
+};
+
+
+/** The ROHC tunnel, stored in the private area of the network device */
+struct rohc_tunnel {
+	/** The network device of the tunnel */
+	struct net_device *dev;
+
+	/** The UDP socket that carries the ROHC packets */
+	struct socket *sock;
+	/** The IPv4 address of the remote end of the tunnel */
+	__be32 remote_addr;
+	/** The UDP port of the local end of the tunnel */
+	__be16 local_port;
+	/** The UDP port of the remote end of the tunnel */
+	__be16 remote_port;
+
+	/**
+	 * @brief The ROHC compressor shards of the tunnel
+	 *
+	 * Every shard is used by the transmit path of one queue of the device,
+	 * that the network stack serializes.
+	 */
+	struct rohc_comp_group *comp_group;
+
+	/**
+	 * @brief The lock that serializes the receive paths on the decompressor
+	 *
+	 * The lock also serializes the delivery of feedback to the compressor
+	 * shards, since their feedback queues accept one producer at a time.
+	 */
+	spinlock_t decomp_lock;
+	/** The ROHC decompressor of the tunnel */
+	struct rohc_decomp *decomp;
+	/** The feedback received for the compressor shards in one burst */
+	unsigned char rcvd_feedback[ROHC_TUNNEL_MAX_FEEDBACK *
+				    ROHC_TUNNEL_BATCH_MAX];
+	/** The feedback to send to the remote compressor for one burst */
+	unsigned char feedback_send[ROHC_TUNNEL_MAX_FEEDBACK *
+				    ROHC_TUNNEL_BATCH_MAX];
+
+	/** The receive paths of the tunnel, one per CPU */
+	struct rohc_tunnel_cell __percpu *cells;
+};
+
+
+/** The network device of the ROHC tunnel created by the module */
+static struct net_device *rohc_tunnel_dev;
+
+
+/**
+ * @brief Generate a random number for the ROHC compressor
+ *
+ * @param comp          The ROHC compressor
+ * @param user_context  Should always be NULL
+ * @return              A random number
+ */
+static int rohc_tunnel_gen_random_num(const struct rohc_comp *const comp,
+				      void *const user_context)
+{
+	return get_random_u32();
+}
+
+
+/**
+ * @brief Get the current time for the ROHC (de)compressor
+ *
+ * @return  The current time
+ */
+static struct rohc_ts rohc_tunnel_get_time(void)
+{
+	struct timespec64 now;
+	struct rohc_ts time;
+
+	ktime_get_ts64(&now);
+	time.sec = now.tv_sec;
+	time.nsec = now.tv_nsec;
+
+	return time;
+}
+
+
+/**
+ * @brief Find the route to the remote end of the tunnel
+ *
+ * The socket of the tunnel is not used by the transmit path, so that it may
+ * be released before the device is unregistered.
+ *
+ * @param tunnel    The ROHC tunnel
+ * @param[out] fl4  The flow of the route
+ * @return          The route in case of success, NULL otherwise
+ */
+static struct rtable *rohc_tunnel_route(struct rohc_tunnel *tunnel,
+					struct flowi4 *fl4)
+{
+	struct rtable *rt;
+
+	rt = ip_route_output_ports(dev_net(tunnel->dev), fl4, NULL,
+				   tunnel->remote_addr, 0,
+				   tunnel->remote_port, tunnel->local_port,
+				   IPPROTO_UDP, 0, 0);
+	if (IS_ERR(rt)) {
+		tunnel->dev->stats.tx_carrier_errors++;
+		return NULL;
+	}
+	if (rt->dst.dev == tunnel->dev) {
+		/* the remote end shall not be reached through the tunnel */
+		tunnel->dev->stats.collisions++;
+		ip_rt_put(rt);
+		return NULL;
+	}
+
+	return rt;
+}
+
+
+/**
+ * @brief Allocate a socket buffer for a ROHC packet
+ *
+ * @param rt   The route to the remote end of the tunnel
+ * @param len  The maximal length of the ROHC packet
+ * @return     The socket buffer with enough headroom for the UDP, IPv4 and
+ *             link-layer headers, NULL if the allocation failed
+ */
+static struct sk_buff *rohc_tunnel_alloc_skb(const struct rtable *rt,
+					     const size_t len)
+{
+	const size_t headroom = LL_RESERVED_SPACE(rt->dst.dev) +
+				sizeof(struct iphdr) + sizeof(struct udphdr);
+	struct sk_buff *skb;
+
+	skb = alloc_skb(headroom + len, GFP_ATOMIC);
+	if (skb != NULL)
+		skb_reserve(skb, headroom);
+
+	return skb;
+}
+
+
+/**
+ * @brief Send one ROHC packet to the remote end of the tunnel
+ *
+ * The UDP and IPv4 headers are pushed in the headroom of the socket buffer.
+ *
+ * @param tunnel    The ROHC tunnel
+ * @param rohc_skb  The ROHC packet, consumed by the function
+ * @param rt        The route to the remote end, consumed by the function
+ * @param fl4       The flow of the route
+ * @return          0 in case of success, non-zero otherwise
+ */
+static int rohc_tunnel_send(struct rohc_tunnel *tunnel,
+			    struct sk_buff *rohc_skb,
+			    struct rtable *rt,
+			    const struct flowi4 *fl4)
+{
+	struct net *net = dev_net(tunnel->dev);
+	struct udphdr *udph;
+	struct iphdr *iph;
+
+	/* add the UDP header in the headroom */
+	udph = (struct udphdr *) skb_push(rohc_skb, sizeof(struct udphdr));
+	skb_reset_transport_header(rohc_skb);
+	udph->source = tunnel->local_port;
+	udph->dest = tunnel->remote_port;
+	udph->len = htons(rohc_skb->len);
+	udph->check = 0;
+	udp_set_csum(false, rohc_skb, fl4->saddr, fl4->daddr, rohc_skb->len);
+
+	/* add the IPv4 header in the headroom, its length and its checksum are
+	 * computed by ip_local_out() */
+	iph = (struct iphdr *) skb_push(rohc_skb, sizeof(struct iphdr));
+	skb_reset_network_header(rohc_skb);
+	iph->version = 4;
+	iph->ihl = sizeof(struct iphdr) >> 2;
+	iph->tos = 0;
+	iph->frag_off = 0;
+	iph->ttl = ip4_dst_hoplimit(&rt->dst);
+	iph->protocol = IPPROTO_UDP;
+	iph->saddr = fl4->saddr;
+	iph->daddr = fl4->daddr;
+	ip_select_ident(net, rohc_skb, NULL);
+
+	memset(IPCB(rohc_skb), 0, sizeof(*IPCB(rohc_skb)));
+	rohc_skb->protocol = htons(ETH_P_IP);
+	rohc_skb->dev = rt->dst.dev;
+	skb_dst_set(rohc_skb, &rt->dst);
+
+	return net_xmit_eval(ip_local_out(net, NULL, rohc_skb));
+}
+
+
+/**
+ * @brief Select the transmit queue of one IP packet
+ *
+ * Every queue of the device has its own compressor shard, the packet is
+ * given to the queue of the shard that owns the context of its flow.
+ *
+ * @param dev     The network device of the tunnel
+ * @param skb     The IP packet to compress
+ * @param sb_dev  The subordinate device, unused
+ * @return        The index of the transmit queue
+ */
+static u16 rohc_tunnel_select_queue(struct net_device *dev,
+				    struct sk_buff *skb,
+				    struct net_device *sb_dev)
+{
+	struct rohc_tunnel *tunnel = netdev_priv(dev);
+	const struct rohc_buf ip_packet =
+		rohc_buf_init_full(skb->data, skb_headlen(skb),
+				   rohc_tunnel_get_time());
+	size_t shard_idx;
+
+	if (!rohc_comp_group_steer(tunnel->comp_group, ip_packet, &shard_idx))
+		return 0;
+
+	return shard_idx;
+}
+
+
+/**
+ * @brief Compress one IP packet and send it to the remote end of the tunnel
+ *
+ * The ROHC packet is built in a new socket buffer, with enough headroom for
+ * the UDP, IPv4 and link-layer headers. The IP packet is compressed from the
+ * data of the socket buffer given by the network stack, by the compressor
+ * shard of the transmit queue.
+ *
+ * @param skb  The IP packet to compress
+ * @param dev  The network device of the tunnel
+ * @return     Always NETDEV_TX_OK, packets that cannot be sent are dropped
+ */
+static netdev_tx_t rohc_tunnel_xmit(struct sk_buff *skb,
+				    struct net_device *dev)
+{
+	struct rohc_tunnel *tunnel = netdev_priv(dev);
+	struct rohc_comp *comp;
+	struct sk_buff *rohc_skb;
+	struct rohc_buf ip_packet;
+	struct rohc_buf rohc_packet;
+	rohc_status_t status;
+	struct flowi4 fl4;
+	struct rtable *rt;
+	unsigned int len;
+
+	comp = rohc_comp_group_get_shard(tunnel->comp_group,
+					 skb_get_queue_mapping(skb));
+	if (comp == NULL || skb_linearize(skb) != 0)
+		goto error;
+
+	rt = rohc_tunnel_route(tunnel, &fl4);
+	if (rt == NULL)
+		goto error;
+
+	/* compress the IP packet directly in the new socket buffer */
+	rohc_skb = rohc_tunnel_alloc_skb(rt, skb->len + ROHC_TUNNEL_MAX_OVERHEAD);
+	if (rohc_skb == NULL)
+		goto free_route;
+
+	ip_packet = (struct rohc_buf)
+		rohc_buf_init_full(skb->data, skb->len, rohc_tunnel_get_time());
+	rohc_packet = (struct rohc_buf)
+		rohc_buf_init_empty(skb_tail_pointer(rohc_skb),
+				    skb_tailroom(rohc_skb));
+	status = rohc_compress4(comp, ip_packet, &rohc_packet);
+	if (status != ROHC_STATUS_OK)
+		goto free_rohc_skb;
+	skb_put(rohc_skb, rohc_packet.len);
+
+	len = skb->len;
+	consume_skb(skb);
+	if (rohc_tunnel_send(tunnel, rohc_skb, rt, &fl4) != 0) {
+		dev->stats.tx_errors++;
+	} else {
+		dev->stats.tx_packets++;
+		dev->stats.tx_bytes += len;
+	}
+
+	return NETDEV_TX_OK;
+
+free_rohc_skb:
+	kfree_skb(rohc_skb);
+free_route:
+	ip_rt_put(rt);
+error:
+	dev->stats.tx_errors++;
+	dev->stats.tx_dropped++;
+	kfree_skb(skb);
+	return NETDEV_TX_OK;
+}
+
+
+/**
+ * @brief Send the feedback of the decompressor to the remote end
+ *
+ * The feedback is sent in a standalone datagram: a ROHC packet made of
+ * feedback only.
+ *
+ * @param tunnel    The ROHC tunnel
+ * @param feedback  The feedback to send
+ */
+static void rohc_tunnel_send_feedback(struct rohc_tunnel *tunnel,
+				      const struct rohc_buf feedback)
+{
+	struct sk_buff *rohc_skb;
+	struct flowi4 fl4;
+	struct rtable *rt;
+
+	rt = rohc_tunnel_route(tunnel, &fl4);
+	if (rt == NULL)
+		return;
+
+	rohc_skb = rohc_tunnel_alloc_skb(rt, feedback.len);
+	if (rohc_skb == NULL) {
+		ip_rt_put(rt);
+		return;
+	}
+	memcpy(skb_put(rohc_skb, feedback.len), rohc_buf_data(feedback),
+	       feedback.len);
+
+	rohc_tunnel_send(tunnel, rohc_skb, rt, &fl4);
+}
+
+
+/**
+ * @brief Queue one ROHC packet received from the remote end of the tunnel
+ *
+ * Called by the UDP stack for every datagram received on the socket of the
+ * tunnel. The ROHC packet is queued on the current CPU, and the NAPI
+ * instance of the CPU is scheduled to decompress it.
+ *
+ * @param sk   The UDP socket of the tunnel
+ * @param skb  The UDP datagram, starting with the UDP header
+ * @return     0 if the datagram was consumed,
+ *             a positive value to give it back to the UDP stack
+ */
+static int rohc_tunnel_rcv(struct sock *sk, struct sk_buff *skb)
+{
+	struct rohc_tunnel *tunnel = rcu_dereference_sk_user_data(sk);
+	struct rohc_tunnel_cell *cell;
+	struct net_device *dev;
+
+	if (tunnel == NULL)
+		return 1;
+	dev = tunnel->dev;
+
+	if (!netif_running(dev))
+		goto error;
+	if (skb_linearize(skb) != 0 ||
+	    !pskb_may_pull(skb, sizeof(struct udphdr)))
+		goto error;
+	__skb_pull(skb, sizeof(struct udphdr));
+
+	/* the queue is only used by the CPU in softirq context */
+	cell = this_cpu_ptr(tunnel->cells);
+	if (skb_queue_len(&cell->queue) >= ROHC_TUNNEL_QUEUE_MAX)
+		goto error;
+	__skb_queue_tail(&cell->queue, skb);
+	if (skb_queue_len(&cell->queue) == 1)
+		napi_schedule(&cell->napi);
+
+	return 0;
+
+error:
+	dev->stats.rx_errors++;
+	dev->stats.rx_dropped++;
+	kfree_skb(skb);
+	return 0;
+}
+
+
+/**
+ * @brief Decompress one burst of ROHC packets
+ *
+ * The burst is decompressed with only one acquisition of the lock of the
+ * decompressor, and the feedback of the whole burst is delivered to the
+ * compressor shards and sent to the remote end at once.
+ *
+ * @param cell     The receive path of the tunnel on the current CPU
+ * @param pkts_nr  The number of ROHC packets in the burst
+ * @param list     The list of IP packets to give to the network stack
+ */
+static void rohc_tunnel_decomp_burst(struct rohc_tunnel_cell *cell,
+				     const size_t pkts_nr,
+				     struct list_head *list)
+{
+	struct rohc_tunnel *tunnel = cell->tunnel;
+	struct net_device *dev = tunnel->dev;
+	struct rohc_buf rcvd_feedback;
+	struct rohc_buf feedback_send;
+	size_t i;
+
+	rcvd_feedback = (struct rohc_buf)
+		rohc_buf_init_empty(tunnel->rcvd_feedback,
+				    sizeof(tunnel->rcvd_feedback));
+	feedback_send = (struct rohc_buf)
+		rohc_buf_init_empty(tunnel->feedback_send,
+				    sizeof(tunnel->feedback_send));
+
+	spin_lock_bh(&tunnel->decomp_lock);
+	if (!rohc_decompress_batch(tunnel->decomp, cell->rohc_packets,
+				   cell->ip_packets, cell->statuses, pkts_nr,
+				   omode ? &rcvd_feedback : NULL,
+				   omode ? &feedback_send : NULL)) {
+		for (i = 0; i < pkts_nr; i++)
+			cell->statuses[i] = ROHC_STATUS_ERROR;
+	}
+	if (omode) {
+		/* the shards dequeue the feedback at their next compression,
+		 * without any lock shared with the receive path */
+		if (rcvd_feedback.len > 0 &&
+		    !rohc_comp_group_deliver_feedback(tunnel->comp_group,
+						      rcvd_feedback))
+			dev->stats.rx_frame_errors++;
+		if (feedback_send.len > 0)
+			rohc_tunnel_send_feedback(tunnel, feedback_send);
+	}
+	spin_unlock_bh(&tunnel->decomp_lock);
+
+	for (i = 0; i < pkts_nr; i++) {
+		struct sk_buff *ip_skb = cell->ip_skbs[i];
+
+		consume_skb(cell->rohc_skbs[i]);
+		if (cell->statuses[i] != ROHC_STATUS_OK) {
+			dev->stats.rx_errors++;
+			dev->stats.rx_dropped++;
+			kfree_skb(ip_skb);
+			continue;
+		}
+		if (cell->ip_packets[i].len == 0) {
+			/* feedback-only packet or non-final segment */
+			kfree_skb(ip_skb);
+			continue;
+		}
+		skb_put(ip_skb, cell->ip_packets[i].len);
+
+		skb_reset_network_header(ip_skb);
+		if ((ip_skb->data[0] >> 4) == 4) {
+			ip_skb->protocol = htons(ETH_P_IP);
+		} else if ((ip_skb->data[0] >> 4) == 6) {
+			ip_skb->protocol = htons(ETH_P_IPV6);
+		} else {
+			dev->stats.rx_errors++;
+			dev->stats.rx_dropped++;
+			kfree_skb(ip_skb);
+			continue;
+		}
+		ip_skb->dev = dev;
+		ip_skb->pkt_type = PACKET_HOST;
+
+		dev->stats.rx_packets++;
+		dev->stats.rx_bytes += ip_skb->len;
+		list_add_tail(&ip_skb->list, list);
+	}
+}
+
+
+/**
+ * @brief Decompress the ROHC packets queued on one CPU
+ *
+ * The NAPI poll function: the queued ROHC packets are decompressed in bursts
+ * directly in new socket buffers, then all the IP packets of the poll are
+ * given to the network stack at once. The remote end does not send IP
+ * packets larger than the MTU.
+ *
+ * @param napi    The NAPI instance of the CPU
+ * @param budget  The maximal number of ROHC packets to decompress
+ * @return        The number of ROHC packets decompressed
+ */
+static int rohc_tunnel_poll(struct napi_struct *napi, int budget)
+{
+	struct rohc_tunnel_cell *cell =
+		container_of(napi, struct rohc_tunnel_cell, napi);
+	struct net_device *dev = cell->tunnel->dev;
+	const struct rohc_ts arrival_time = rohc_tunnel_get_time();
+	LIST_HEAD(list);
+	int done = 0;
+
+	while (done < budget) {
+		struct sk_buff *skb;
+		size_t pkts_nr = 0;
+
+		/* prepare one burst of ROHC packets */
+		while (pkts_nr < ROHC_TUNNEL_BATCH_MAX &&
+		       (done + pkts_nr) < (size_t) budget) {
+			struct sk_buff *ip_skb;
+
+			skb = __skb_dequeue(&cell->queue);
+			if (skb == NULL)
+				break;
+			ip_skb = napi_alloc_skb(napi,
+						dev->mtu + ROHC_TUNNEL_MAX_OVERHEAD);
+			if (ip_skb == NULL) {
+				dev->stats.rx_dropped++;
+				kfree_skb(skb);
+				done++;
+				continue;
+			}
+
+			cell->rohc_skbs[pkts_nr] = skb;
+			cell->ip_skbs[pkts_nr] = ip_skb;
+			cell->rohc_packets[pkts_nr] = (struct rohc_buf)
+				rohc_buf_init_full(skb->data, skb->len,
+						   arrival_time);
+			cell->ip_packets[pkts_nr] = (struct rohc_buf)
+				rohc_buf_init_empty(skb_tail_pointer(ip_skb),
+						    skb_tailroom(ip_skb));
+			pkts_nr++;
+		}
+		if (pkts_nr == 0)
+			break;
+
+		rohc_tunnel_decomp_burst(cell, pkts_nr, &list);
+		done += pkts_nr;
+	}
+
+	netif_receive_skb_list(&list);
+	if (done < budget)
+		napi_complete_done(napi, done);
+
+	return done;
+}
+
+
+/**
+ * @brief Start the network device of the tunnel
+ *
+ * @param dev  The network device of the tunnel
+ * @return     Always 0
+ */
+static int rohc_tunnel_open(struct net_device *dev)
+{
+	struct rohc_tunnel *tunnel = netdev_priv(dev);
+	int cpu;
+
+	for_each_possible_cpu(cpu)
+		napi_enable(&per_cpu_ptr(tunnel->cells, cpu)->napi);
+	netif_tx_start_all_queues(dev);
+	return 0;
+}
+
+
+/**
+ * @brief Stop the network device of the tunnel
+ *
+ * @param dev  The network device of the tunnel
+ * @return     Always 0
+ */
+static int rohc_tunnel_stop(struct net_device *dev)
+{
+	struct rohc_tunnel *tunnel = netdev_priv(dev);
+	int cpu;
+
+	netif_tx_stop_all_queues(dev);
+	for_each_possible_cpu(cpu) {
+		struct rohc_tunnel_cell *cell = per_cpu_ptr(tunnel->cells, cpu);
+
+		napi_disable(&cell->napi);
+		skb_queue_purge(&cell->queue);
+	}
+	return 0;
+}
+
+
+/** The operations of the network device of the tunnel */
+static const struct net_device_ops rohc_tunnel_netdev_ops = {
+	.ndo_open = rohc_tunnel_open,
+	.ndo_stop = rohc_tunnel_stop,
+	.ndo_start_xmit = rohc_tunnel_xmit,
+	.ndo_select_queue = rohc_tunnel_select_queue,
+};
+
+
+/**
+ * @brief Set up the network device of the tunnel
+ *
+ * The device is a point-to-point IP device without link-layer header, like
+ * the IPIP or GRE tunnels.
+ *
+ * @param dev  The network device of the tunnel
+ */
+static void rohc_tunnel_setup(struct net_device *dev)
+{
+	dev->netdev_ops = &rohc_tunnel_netdev_ops;
+	dev->type = ARPHRD_NONE;
+	dev->flags = IFF_POINTOPOINT | IFF_NOARP | IFF_MULTICAST;
+	dev->hard_header_len = 0;
+	dev->addr_len = 0;
+	dev->mtu = ROHC_TUNNEL_DEFAULT_MTU;
+	dev->min_mtu = IPV4_MIN_MTU;
+	dev->max_mtu = ROHC_TUNNEL_MAX_MTU;
+	dev->tx_queue_len = 1000;
+}
+
+
+/**
+ * @brief Create the ROHC compressor shards and decompressor of the tunnel
+ *
+ * @param tunnel     The ROHC tunnel
+ * @param shards_nr  The number of compressor shards
+ * @return           0 in case of success, non-zero otherwise
+ */
+static int rohc_tunnel_init_rohc(struct rohc_tunnel *tunnel,
+				 const unsigned int shards_nr)
+{
+	const rohc_cid_type_t cid_type =
+		(large_cid ? ROHC_LARGE_CID : ROHC_SMALL_CID);
+	const rohc_mode_t mode = (omode ? ROHC_O_MODE : ROHC_U_MODE);
+	unsigned int i;
+	bool is_ok;
+
+	/* create the compressor shards, one range of CIDs per shard */
+	tunnel->comp_group = rohc_comp_group_new(cid_type, max_cid, shards_nr,
+						 rohc_tunnel_gen_random_num,
+						 NULL);
+	if (tunnel->comp_group == NULL) {
+		rohc_err("\tcannot create the ROHC compressor shards\n");
+		goto error;
+	}
+
+	/* activate all the compression profiles built in the library */
+	for (i = 0; i < shards_nr; i++) {
+		is_ok = rohc_comp_enable_profiles(
+			rohc_comp_group_get_shard(tunnel->comp_group, i),
+#if ROHC_WITH_PROFILE_UNCOMPRESSED == 1
+			ROHC_PROFILE_UNCOMPRESSED,
+#endif
+#if ROHC_WITH_PROFILE_RTP == 1
+			ROHC_PROFILE_RTP,
+#endif
+#if ROHC_WITH_PROFILE_UDP == 1
+			ROHC_PROFILE_UDP,
+#endif
+#if ROHC_WITH_PROFILE_ESP == 1
+			ROHC_PROFILE_ESP,
+#endif
+#if ROHC_WITH_PROFILE_IP == 1
+			ROHC_PROFILE_IP,
+#endif
+#if ROHC_WITH_PROFILE_TCP == 1
+			ROHC_PROFILE_TCP,
+#endif
+#if ROHC_WITH_PROFILE_UDPLITE == 1
+			ROHC_PROFILE_UDPLITE,
+#endif
+			-1);
+		if (!is_ok) {
+			rohc_err("\tfailed to enable the compression profiles\n");
+			goto free_compressor;
+		}
+	}
+
+	/* create the decompressor */
+	tunnel->decomp = rohc_decomp_new2(cid_type, max_cid, mode);
+	if (tunnel->decomp == NULL) {
+		rohc_err("\tcannot create the ROHC decompressor\n");
+		goto free_compressor;
+	}
+
+	/* activate all the decompression profiles built in the library */
+	is_ok = rohc_decomp_enable_profiles(tunnel->decomp,
+#if ROHC_WITH_PROFILE_UNCOMPRESSED == 1
+			ROHC_PROFILE_UNCOMPRESSED,
+#endif
+#if ROHC_WITH_PROFILE_RTP == 1
+			ROHC_PROFILE_RTP,
+#endif
+#if ROHC_WITH_PROFILE_UDP == 1
+			ROHC_PROFILE_UDP,
+#endif
+#if ROHC_WITH_PROFILE_ESP == 1
+			ROHC_PROFILE_ESP,
+#endif
+#if ROHC_WITH_PROFILE_IP == 1
+			ROHC_PROFILE_IP,
+#endif
+#if ROHC_WITH_PROFILE_TCP == 1
+			ROHC_PROFILE_TCP,
+#endif
+#if ROHC_WITH_PROFILE_UDPLITE == 1
+			ROHC_PROFILE_UDPLITE,
+#endif
+			-1);
+	if (!is_ok) {
+		rohc_err("\tfailed to enable the decompression profiles\n");
+		goto free_decompressor;
+	}
+	spin_lock_init(&tunnel->decomp_lock);
+
+	return 0;
+
+free_decompressor:
+	rohc_decomp_free(tunnel->decomp);
+free_compressor:
+	rohc_comp_group_free(tunnel->comp_group);
+error:
+	return 1;
+}
+
+
+/**
+ * @brief Open the UDP socket of the tunnel
+ *
+ * @param tunnel  The ROHC tunnel
+ * @return        0 in case of success, a negative error code otherwise
+ */
+static int rohc_tunnel_init_sock(struct rohc_tunnel *tunnel)
+{
+	struct udp_tunnel_sock_cfg tunnel_cfg;
+	struct udp_port_cfg udp_cfg;
+	int ret;
+
+	memset(&udp_cfg, 0, sizeof(udp_cfg));
+	udp_cfg.family = AF_INET;
+	udp_cfg.local_ip.s_addr = htonl(INADDR_ANY);
+	udp_cfg.local_udp_port = tunnel->local_port;
+	ret = udp_sock_create(&init_net, &udp_cfg, &tunnel->sock);
+	if (ret < 0)
+		return ret;
+
+	memset(&tunnel_cfg, 0, sizeof(tunnel_cfg));
+	tunnel_cfg.sk_user_data = tunnel;
+	tunnel_cfg.encap_type = 1;
+	tunnel_cfg.encap_rcv = rohc_tunnel_rcv;
+	setup_udp_tunnel_sock(&init_net, tunnel->sock, &tunnel_cfg);
+
+	return 0;
+}
+
+
+/**
+ * @brief Create the receive paths of the tunnel, one per CPU
+ *
+ * @param tunnel  The ROHC tunnel
+ * @return        0 in case of success, a negative error code otherwise
+ */
+static int rohc_tunnel_init_cells(struct rohc_tunnel *tunnel)
+{
+	int cpu;
+
+	tunnel->cells = alloc_percpu(struct rohc_tunnel_cell);
+	if (tunnel->cells == NULL)
+		return -ENOMEM;
+
+	for_each_possible_cpu(cpu) {
+		struct rohc_tunnel_cell *cell = per_cpu_ptr(tunnel->cells, cpu);
+
+		skb_queue_head_init(&cell->queue);
+		cell->tunnel = tunnel;
+		netif_napi_add(tunnel->dev, &cell->napi, rohc_tunnel_poll);
+	}
+
+	return 0;
+}
+
+
+/**
+ * @brief Destroy the receive paths of the tunnel
+ *
+ * @param tunnel  The ROHC tunnel
+ */
+static void rohc_tunnel_free_cells(struct rohc_tunnel *tunnel)
+{
+	int cpu;
+
+	for_each_possible_cpu(cpu) {
+		struct rohc_tunnel_cell *cell = per_cpu_ptr(tunnel->cells, cpu);
+
+		netif_napi_del(&cell->napi);
+		skb_queue_purge(&cell->queue);
+	}
+	free_percpu(tunnel->cells);
+}
+
+
+/**
+ * @brief The entry point of the kernel module
+ *
+ * @return  0 in case of success, a negative error code otherwise
+ */
+int __init rohc_tunnel_init(void)
+{
+	struct rohc_tunnel *tunnel;
+	unsigned int shards_nr;
+	int ret = -EINVAL;
+
+	rohc_info("loading ROHC tunnel module...\n");
+
+	if (remote_addr == NULL) {
+		rohc_err("parameter remote_addr is mandatory\n");
+		goto error;
+	}
+	if ((large_cid && max_cid > ROHC_LARGE_CID_MAX) ||
+	    (!large_cid && max_cid > ROHC_SMALL_CID_MAX)) {
+		rohc_err("parameter max_cid is too large for the type of CIDs\n");
+		goto error;
+	}
+
+	/* one compressor shard and one transmit queue per CPU, but at least
+	 * one CID per shard */
+	shards_nr = min_t(unsigned int, num_possible_cpus(), max_cid + 1);
+
+	ret = -ENOMEM;
+	rohc_tunnel_dev = alloc_netdev_mqs(sizeof(struct rohc_tunnel), "rohc%d",
+					   NET_NAME_UNKNOWN, rohc_tunnel_setup,
+					   shards_nr, 1);
+	if (rohc_tunnel_dev == NULL) {
+		rohc_err("failed to allocate the network device\n");
+		goto error;
+	}
+	tunnel = netdev_priv(rohc_tunnel_dev);
+	tunnel->dev = rohc_tunnel_dev;
+	tunnel->local_port = htons(local_port);
+	tunnel->remote_port = htons(remote_port);
+	if (!in4_pton(remote_addr, -1, (u8 *) &tunnel->remote_addr, -1, NULL)) {
+		rohc_err("parameter remote_addr is not a valid IPv4 address\n");
+		ret = -EINVAL;
+		goto free_dev;
+	}
+
+	if (rohc_tunnel_init_rohc(tunnel, shards_nr) != 0) {
+		rohc_err("failed to create the ROHC compressor/decompressor\n");
+		goto free_dev;
+	}
+
+	ret = rohc_tunnel_init_cells(tunnel);
+	if (ret != 0) {
+		rohc_err("failed to create the receive paths\n");
+		goto free_rohc;
+	}
+
+	ret = register_netdev(rohc_tunnel_dev);
+	if (ret != 0) {
+		rohc_err("failed to register the network device\n");
+		goto free_cells;
+	}
+
+	ret = rohc_tunnel_init_sock(tunnel);
+	if (ret != 0) {
+		rohc_err("failed to open the UDP socket on port %u\n",
+			 local_port);
+		goto unregister_dev;
+	}
+
+	rohc_info("ROHC tunnel %s to %pI4:%u successfully created with %u compressor shards\n",
+		  rohc_tunnel_dev->name, &tunnel->remote_addr, remote_port,
+		  shards_nr);
+
+	return 0;
+
+unregister_dev:
+	unregister_netdev(rohc_tunnel_dev);
+free_cells:
+	rohc_tunnel_free_cells(tunnel);
+free_rohc:
+	rohc_decomp_free(tunnel->decomp);
+	rohc_comp_group_free(tunnel->comp_group);
+free_dev:
+	free_netdev(rohc_tunnel_dev);
+error:
+	return ret;
+}
+
+
+/**
+ * @brief The exit point of the kernel module
+ */
+void __exit rohc_tunnel_exit(void)
+{
+	struct rohc_tunnel *tunnel = netdev_priv(rohc_tunnel_dev);
+
+	rohc_info("unloading ROHC tunnel module...\n");
+
+	/* stop the receive path, then the transmit path */
+	udp_tunnel_sock_release(tunnel->sock);
+	synchronize_net();
+	unregister_netdev(rohc_tunnel_dev);
+
+	rohc_tunnel_free_cells(tunnel);
+	rohc_decomp_free(tunnel->decomp);
+	rohc_comp_group_free(tunnel->comp_group);
+	free_netdev(rohc_tunnel_dev);
+
+	rohc_info("ROHC tunnel module successfully unloaded\n");
+}
+
+
+MODULE_VERSION(PACKAGE_VERSION PACKAGE_REVNO);
+MODULE_LICENSE("GPL");
+MODULE_AUTHOR("Didier Barvaux");
+MODULE_DESCRIPTION("ROHC tunnel device based on " PACKAGE_NAME " "
+	PACKAGE_VERSION PACKAGE_REVNO " (" PACKAGE_URL ")");
+
+module_init(rohc_tunnel_init);
+module_exit(rohc_tunnel_exit);
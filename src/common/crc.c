@@ -30,6 +30,7 @@
  */
 
 #include "crc.h"
+#include "rohc_cpu.h"
 #include "protocols/ip_numbers.h"
 #include "protocols/ip.h"
 #include "protocols/ipv4.h"
@@ -42,6 +43,25 @@
 #include <stdlib.h>
 #include <assert.h>
 
+/* FCS-32 is computed by the kernel CRC-32 library in kernel mode, and with
+ * the carry-less multiplication or CRC-32 instructions of the CPU in user
+ * space if the CPU supports them */
+#if defined(__KERNEL__)
+#  include <linux/crc32.h>
+#elif defined(__GNUC__) && defined(__x86_64__)
+#  define ROHC_CRC_FCS32_PCLMUL 1
+#  include <immintrin.h>
+#elif defined(__GNUC__) && defined(__aarch64__) && defined(__linux__)
+#  define ROHC_CRC_FCS32_ARMV8 1
+#  include <string.h>
+#  include <arm_acle.h>
+#  if defined(__clang__)
+#    define ROHC_CRC_FCS32_ARMV8_TARGET "crc"
+#  else
+#    define ROHC_CRC_FCS32_ARMV8_TARGET "+crc"
+#  endif
+#endif
+
 
 /**
  * @brief The pre-computed table for 32-bit Frame Check Sequence (FCS)
@@ -121,10 +141,504 @@ static const uint32_t crc_table_fcs32[256] =
 };
 
 
+/**
+ * @brief The pre-computed table for the 3-bit CRC
+ *
+ *   C(x) = 1 + x + x^3
+ *
+ * See RFC 3095, section 5.9.1
+ */
+const uint8_t rohc_crc_table_3[256] =
+{
+	0x00, 0x06, 0x01, 0x07, 0x02, 0x04, 0x03, 0x05,
+	0x04, 0x02, 0x05, 0x03, 0x06, 0x00, 0x07, 0x01,
+	0x05, 0x03, 0x04, 0x02, 0x07, 0x01, 0x06, 0x00,
+	0x01, 0x07, 0x00, 0x06, 0x03, 0x05, 0x02, 0x04,
+	0x07, 0x01, 0x06, 0x00, 0x05, 0x03, 0x04, 0x02,
+	0x03, 0x05, 0x02, 0x04, 0x01, 0x07, 0x00, 0x06,
+	0x02, 0x04, 0x03, 0x05, 0x00, 0x06, 0x01, 0x07,
+	0x06, 0x00, 0x07, 0x01, 0x04, 0x02, 0x05, 0x03,
+	0x03, 0x05, 0x02, 0x04, 0x01, 0x07, 0x00, 0x06,
+	0x07, 0x01, 0x06, 0x00, 0x05, 0x03, 0x04, 0x02,
+	0x06, 0x00, 0x07, 0x01, 0x04, 0x02, 0x05, 0x03,
+	0x02, 0x04, 0x03, 0x05, 0x00, 0x06, 0x01, 0x07,
+	0x04, 0x02, 0x05, 0x03, 0x06, 0x00, 0x07, 0x01,
+	0x00, 0x06, 0x01, 0x07, 0x02, 0x04, 0x03, 0x05,
+	0x01, 0x07, 0x00, 0x06, 0x03, 0x05, 0x02, 0x04,
+	0x05, 0x03, 0x04, 0x02, 0x07, 0x01, 0x06, 0x00,
+	0x06, 0x00, 0x07, 0x01, 0x04, 0x02, 0x05, 0x03,
+	0x02, 0x04, 0x03, 0x05, 0x00, 0x06, 0x01, 0x07,
+	0x03, 0x05, 0x02, 0x04, 0x01, 0x07, 0x00, 0x06,
+	0x07, 0x01, 0x06, 0x00, 0x05, 0x03, 0x04, 0x02,
+	0x01, 0x07, 0x00, 0x06, 0x03, 0x05, 0x02, 0x04,
+	0x05, 0x03, 0x04, 0x02, 0x07, 0x01, 0x06, 0x00,
+	0x04, 0x02, 0x05, 0x03, 0x06, 0x00, 0x07, 0x01,
+	0x00, 0x06, 0x01, 0x07, 0x02, 0x04, 0x03, 0x05,
+	0x05, 0x03, 0x04, 0x02, 0x07, 0x01, 0x06, 0x00,
+	0x01, 0x07, 0x00, 0x06, 0x03, 0x05, 0x02, 0x04,
+	0x00, 0x06, 0x01, 0x07, 0x02, 0x04, 0x03, 0x05,
+	0x04, 0x02, 0x05, 0x03, 0x06, 0x00, 0x07, 0x01,
+	0x02, 0x04, 0x03, 0x05, 0x00, 0x06, 0x01, 0x07,
+	0x06, 0x00, 0x07, 0x01, 0x04, 0x02, 0x05, 0x03,
+	0x07, 0x01, 0x06, 0x00, 0x05, 0x03, 0x04, 0x02,
+	0x03, 0x05, 0x02, 0x04, 0x01, 0x07, 0x00, 0x06
+};
+
+
+/**
+ * @brief The pre-computed table for the 7-bit CRC
+ *
+ *   C(x) = 1 + x + x^2 + x^3 + x^6 + x^7
+ *
+ * See RFC 3095, section 5.9.1
+ */
+const uint8_t rohc_crc_table_7[256] =
+{
+	0x00, 0x40, 0x73, 0x33, 0x15, 0x55, 0x66, 0x26,
+	0x2a, 0x6a, 0x59, 0x19, 0x3f, 0x7f, 0x4c, 0x0c,
+	0x54, 0x14, 0x27, 0x67, 0x41, 0x01, 0x32, 0x72,
+	0x7e, 0x3e, 0x0d, 0x4d, 0x6b, 0x2b, 0x18, 0x58,
+	0x5b, 0x1b, 0x28, 0x68, 0x4e, 0x0e, 0x3d, 0x7d,
+	0x71, 0x31, 0x02, 0x42, 0x64, 0x24, 0x17, 0x57,
+	0x0f, 0x4f, 0x7c, 0x3c, 0x1a, 0x5a, 0x69, 0x29,
+	0x25, 0x65, 0x56, 0x16, 0x30, 0x70, 0x43, 0x03,
+	0x45, 0x05, 0x36, 0x76, 0x50, 0x10, 0x23, 0x63,
+	0x6f, 0x2f, 0x1c, 0x5c, 0x7a, 0x3a, 0x09, 0x49,
+	0x11, 0x51, 0x62, 0x22, 0x04, 0x44, 0x77, 0x37,
+	0x3b, 0x7b, 0x48, 0x08, 0x2e, 0x6e, 0x5d, 0x1d,
+	0x1e, 0x5e, 0x6d, 0x2d, 0x0b, 0x4b, 0x78, 0x38,
+	0x34, 0x74, 0x47, 0x07, 0x21, 0x61, 0x52, 0x12,
+	0x4a, 0x0a, 0x39, 0x79, 0x5f, 0x1f, 0x2c, 0x6c,
+	0x60, 0x20, 0x13, 0x53, 0x75, 0x35, 0x06, 0x46,
+	0x79, 0x39, 0x0a, 0x4a, 0x6c, 0x2c, 0x1f, 0x5f,
+	0x53, 0x13, 0x20, 0x60, 0x46, 0x06, 0x35, 0x75,
+	0x2d, 0x6d, 0x5e, 0x1e, 0x38, 0x78, 0x4b, 0x0b,
+	0x07, 0x47, 0x74, 0x34, 0x12, 0x52, 0x61, 0x21,
+	0x22, 0x62, 0x51, 0x11, 0x37, 0x77, 0x44, 0x04,
+	0x08, 0x48, 0x7b, 0x3b, 0x1d, 0x5d, 0x6e, 0x2e,
+	0x76, 0x36, 0x05, 0x45, 0x63, 0x23, 0x10, 0x50,
+	0x5c, 0x1c, 0x2f, 0x6f, 0x49, 0x09, 0x3a, 0x7a,
+	0x3c, 0x7c, 0x4f, 0x0f, 0x29, 0x69, 0x5a, 0x1a,
+	0x16, 0x56, 0x65, 0x25, 0x03, 0x43, 0x70, 0x30,
+	0x68, 0x28, 0x1b, 0x5b, 0x7d, 0x3d, 0x0e, 0x4e,
+	0x42, 0x02, 0x31, 0x71, 0x57, 0x17, 0x24, 0x64,
+	0x67, 0x27, 0x14, 0x54, 0x72, 0x32, 0x01, 0x41,
+	0x4d, 0x0d, 0x3e, 0x7e, 0x58, 0x18, 0x2b, 0x6b,
+	0x33, 0x73, 0x40, 0x00, 0x26, 0x66, 0x55, 0x15,
+	0x19, 0x59, 0x6a, 0x2a, 0x0c, 0x4c, 0x7f, 0x3f
+};
+
+
+/**
+ * @brief The pre-computed table for the 8-bit CRC
+ *
+ *   C(x) = 1 + x + x^2 + x^8
+ *
+ * See RFC 3095, section 5.9.1
+ */
+const uint8_t rohc_crc_table_8[256] =
+{
+	0x00, 0x91, 0xe3, 0x72, 0x07, 0x96, 0xe4, 0x75,
+	0x0e, 0x9f, 0xed, 0x7c, 0x09, 0x98, 0xea, 0x7b,
+	0x1c, 0x8d, 0xff, 0x6e, 0x1b, 0x8a, 0xf8, 0x69,
+	0x12, 0x83, 0xf1, 0x60, 0x15, 0x84, 0xf6, 0x67,
+	0x38, 0xa9, 0xdb, 0x4a, 0x3f, 0xae, 0xdc, 0x4d,
+	0x36, 0xa7, 0xd5, 0x44, 0x31, 0xa0, 0xd2, 0x43,
+	0x24, 0xb5, 0xc7, 0x56, 0x23, 0xb2, 0xc0, 0x51,
+	0x2a, 0xbb, 0xc9, 0x58, 0x2d, 0xbc, 0xce, 0x5f,
+	0x70, 0xe1, 0x93, 0x02, 0x77, 0xe6, 0x94, 0x05,
+	0x7e, 0xef, 0x9d, 0x0c, 0x79, 0xe8, 0x9a, 0x0b,
+	0x6c, 0xfd, 0x8f, 0x1e, 0x6b, 0xfa, 0x88, 0x19,
+	0x62, 0xf3, 0x81, 0x10, 0x65, 0xf4, 0x86, 0x17,
+	0x48, 0xd9, 0xab, 0x3a, 0x4f, 0xde, 0xac, 0x3d,
+	0x46, 0xd7, 0xa5, 0x34, 0x41, 0xd0, 0xa2, 0x33,
+	0x54, 0xc5, 0xb7, 0x26, 0x53, 0xc2, 0xb0, 0x21,
+	0x5a, 0xcb, 0xb9, 0x28, 0x5d, 0xcc, 0xbe, 0x2f,
+	0xe0, 0x71, 0x03, 0x92, 0xe7, 0x76, 0x04, 0x95,
+	0xee, 0x7f, 0x0d, 0x9c, 0xe9, 0x78, 0x0a, 0x9b,
+	0xfc, 0x6d, 0x1f, 0x8e, 0xfb, 0x6a, 0x18, 0x89,
+	0xf2, 0x63, 0x11, 0x80, 0xf5, 0x64, 0x16, 0x87,
+	0xd8, 0x49, 0x3b, 0xaa, 0xdf, 0x4e, 0x3c, 0xad,
+	0xd6, 0x47, 0x35, 0xa4, 0xd1, 0x40, 0x32, 0xa3,
+	0xc4, 0x55, 0x27, 0xb6, 0xc3, 0x52, 0x20, 0xb1,
+	0xca, 0x5b, 0x29, 0xb8, 0xcd, 0x5c, 0x2e, 0xbf,
+	0x90, 0x01, 0x73, 0xe2, 0x97, 0x06, 0x74, 0xe5,
+	0x9e, 0x0f, 0x7d, 0xec, 0x99, 0x08, 0x7a, 0xeb,
+	0x8c, 0x1d, 0x6f, 0xfe, 0x8b, 0x1a, 0x68, 0xf9,
+	0x82, 0x13, 0x61, 0xf0, 0x85, 0x14, 0x66, 0xf7,
+	0xa8, 0x39, 0x4b, 0xda, 0xaf, 0x3e, 0x4c, 0xdd,
+	0xa6, 0x37, 0x45, 0xd4, 0xa1, 0x30, 0x42, 0xd3,
+	0xb4, 0x25, 0x57, 0xc6, 0xb3, 0x22, 0x50, 0xc1,
+	0xba, 0x2b, 0x59, 0xc8, 0xbd, 0x2c, 0x5e, 0xcf
+};
+
+
+/**
+ * @brief The pre-computed tables for the 3-bit CRC computed 4 bytes at a time
+ *
+ * Table k gives the CRC of one byte followed by k+1 zero bytes, so the CRC
+ * of 4 bytes is the XOR of one lookup in each table and one lookup in
+ * \ref rohc_crc_table_3 (slicing-by-4).
+ */
+static const uint8_t crc_slices_3[3][256] =
+{
+	{
+		0x00, 0x03, 0x06, 0x05, 0x01, 0x02, 0x07, 0x04,
+		0x02, 0x01, 0x04, 0x07, 0x03, 0x00, 0x05, 0x06,
+		0x04, 0x07, 0x02, 0x01, 0x05, 0x06, 0x03, 0x00,
+		0x06, 0x05, 0x00, 0x03, 0x07, 0x04, 0x01, 0x02,
+		0x05, 0x06, 0x03, 0x00, 0x04, 0x07, 0x02, 0x01,
+		0x07, 0x04, 0x01, 0x02, 0x06, 0x05, 0x00, 0x03,
+		0x01, 0x02, 0x07, 0x04, 0x00, 0x03, 0x06, 0x05,
+		0x03, 0x00, 0x05, 0x06, 0x02, 0x01, 0x04, 0x07,
+		0x07, 0x04, 0x01, 0x02, 0x06, 0x05, 0x00, 0x03,
+		0x05, 0x06, 0x03, 0x00, 0x04, 0x07, 0x02, 0x01,
+		0x03, 0x00, 0x05, 0x06, 0x02, 0x01, 0x04, 0x07,
+		0x01, 0x02, 0x07, 0x04, 0x00, 0x03, 0x06, 0x05,
+		0x02, 0x01, 0x04, 0x07, 0x03, 0x00, 0x05, 0x06,
+		0x00, 0x03, 0x06, 0x05, 0x01, 0x02, 0x07, 0x04,
+		0x06, 0x05, 0x00, 0x03, 0x07, 0x04, 0x01, 0x02,
+		0x04, 0x07, 0x02, 0x01, 0x05, 0x06, 0x03, 0x00,
+		0x03, 0x00, 0x05, 0x06, 0x02, 0x01, 0x04, 0x07,
+		0x01, 0x02, 0x07, 0x04, 0x00, 0x03, 0x06, 0x05,
+		0x07, 0x04, 0x01, 0x02, 0x06, 0x05, 0x00, 0x03,
+		0x05, 0x06, 0x03, 0x00, 0x04, 0x07, 0x02, 0x01,
+		0x06, 0x05, 0x00, 0x03, 0x07, 0x04, 0x01, 0x02,
+		0x04, 0x07, 0x02, 0x01, 0x05, 0x06, 0x03, 0x00,
+		0x02, 0x01, 0x04, 0x07, 0x03, 0x00, 0x05, 0x06,
+		0x00, 0x03, 0x06, 0x05, 0x01, 0x02, 0x07, 0x04,
+		0x04, 0x07, 0x02, 0x01, 0x05, 0x06, 0x03, 0x00,
+		0x06, 0x05, 0x00, 0x03, 0x07, 0x04, 0x01, 0x02,
+		0x00, 0x03, 0x06, 0x05, 0x01, 0x02, 0x07, 0x04,
+		0x02, 0x01, 0x04, 0x07, 0x03, 0x00, 0x05, 0x06,
+		0x01, 0x02, 0x07, 0x04, 0x00, 0x03, 0x06, 0x05,
+		0x03, 0x00, 0x05, 0x06, 0x02, 0x01, 0x04, 0x07,
+		0x05, 0x06, 0x03, 0x00, 0x04, 0x07, 0x02, 0x01,
+		0x07, 0x04, 0x01, 0x02, 0x06, 0x05, 0x00, 0x03
+	},
+	{
+		0x00, 0x07, 0x03, 0x04, 0x06, 0x01, 0x05, 0x02,
+		0x01, 0x06, 0x02, 0x05, 0x07, 0x00, 0x04, 0x03,
+		0x02, 0x05, 0x01, 0x06, 0x04, 0x03, 0x07, 0x00,
+		0x03, 0x04, 0x00, 0x07, 0x05, 0x02, 0x06, 0x01,
+		0x04, 0x03, 0x07, 0x00, 0x02, 0x05, 0x01, 0x06,
+		0x05, 0x02, 0x06, 0x01, 0x03, 0x04, 0x00, 0x07,
+		0x06, 0x01, 0x05, 0x02, 0x00, 0x07, 0x03, 0x04,
+		0x07, 0x00, 0x04, 0x03, 0x01, 0x06, 0x02, 0x05,
+		0x05, 0x02, 0x06, 0x01, 0x03, 0x04, 0x00, 0x07,
+		0x04, 0x03, 0x07, 0x00, 0x02, 0x05, 0x01, 0x06,
+		0x07, 0x00, 0x04, 0x03, 0x01, 0x06, 0x02, 0x05,
+		0x06, 0x01, 0x05, 0x02, 0x00, 0x07, 0x03, 0x04,
+		0x01, 0x06, 0x02, 0x05, 0x07, 0x00, 0x04, 0x03,
+		0x00, 0x07, 0x03, 0x04, 0x06, 0x01, 0x05, 0x02,
+		0x03, 0x04, 0x00, 0x07, 0x05, 0x02, 0x06, 0x01,
+		0x02, 0x05, 0x01, 0x06, 0x04, 0x03, 0x07, 0x00,
+		0x07, 0x00, 0x04, 0x03, 0x01, 0x06, 0x02, 0x05,
+		0x06, 0x01, 0x05, 0x02, 0x00, 0x07, 0x03, 0x04,
+		0x05, 0x02, 0x06, 0x01, 0x03, 0x04, 0x00, 0x07,
+		0x04, 0x03, 0x07, 0x00, 0x02, 0x05, 0x01, 0x06,
+		0x03, 0x04, 0x00, 0x07, 0x05, 0x02, 0x06, 0x01,
+		0x02, 0x05, 0x01, 0x06, 0x04, 0x03, 0x07, 0x00,
+		0x01, 0x06, 0x02, 0x05, 0x07, 0x00, 0x04, 0x03,
+		0x00, 0x07, 0x03, 0x04, 0x06, 0x01, 0x05, 0x02,
+		0x02, 0x05, 0x01, 0x06, 0x04, 0x03, 0x07, 0x00,
+		0x03, 0x04, 0x00, 0x07, 0x05, 0x02, 0x06, 0x01,
+		0x00, 0x07, 0x03, 0x04, 0x06, 0x01, 0x05, 0x02,
+		0x01, 0x06, 0x02, 0x05, 0x07, 0x00, 0x04, 0x03,
+		0x06, 0x01, 0x05, 0x02, 0x00, 0x07, 0x03, 0x04,
+		0x07, 0x00, 0x04, 0x03, 0x01, 0x06, 0x02, 0x05,
+		0x04, 0x03, 0x07, 0x00, 0x02, 0x05, 0x01, 0x06,
+		0x05, 0x02, 0x06, 0x01, 0x03, 0x04, 0x00, 0x07
+	},
+	{
+		0x00, 0x05, 0x07, 0x02, 0x03, 0x06, 0x04, 0x01,
+		0x06, 0x03, 0x01, 0x04, 0x05, 0x00, 0x02, 0x07,
+		0x01, 0x04, 0x06, 0x03, 0x02, 0x07, 0x05, 0x00,
+		0x07, 0x02, 0x00, 0x05, 0x04, 0x01, 0x03, 0x06,
+		0x02, 0x07, 0x05, 0x00, 0x01, 0x04, 0x06, 0x03,
+		0x04, 0x01, 0x03, 0x06, 0x07, 0x02, 0x00, 0x05,
+		0x03, 0x06, 0x04, 0x01, 0x00, 0x05, 0x07, 0x02,
+		0x05, 0x00, 0x02, 0x07, 0x06, 0x03, 0x01, 0x04,
+		0x04, 0x01, 0x03, 0x06, 0x07, 0x02, 0x00, 0x05,
+		0x02, 0x07, 0x05, 0x00, 0x01, 0x04, 0x06, 0x03,
+		0x05, 0x00, 0x02, 0x07, 0x06, 0x03, 0x01, 0x04,
+		0x03, 0x06, 0x04, 0x01, 0x00, 0x05, 0x07, 0x02,
+		0x06, 0x03, 0x01, 0x04, 0x05, 0x00, 0x02, 0x07,
+		0x00, 0x05, 0x07, 0x02, 0x03, 0x06, 0x04, 0x01,
+		0x07, 0x02, 0x00, 0x05, 0x04, 0x01, 0x03, 0x06,
+		0x01, 0x04, 0x06, 0x03, 0x02, 0x07, 0x05, 0x00,
+		0x05, 0x00, 0x02, 0x07, 0x06, 0x03, 0x01, 0x04,
+		0x03, 0x06, 0x04, 0x01, 0x00, 0x05, 0x07, 0x02,
+		0x04, 0x01, 0x03, 0x06, 0x07, 0x02, 0x00, 0x05,
+		0x02, 0x07, 0x05, 0x00, 0x01, 0x04, 0x06, 0x03,
+		0x07, 0x02, 0x00, 0x05, 0x04, 0x01, 0x03, 0x06,
+		0x01, 0x04, 0x06, 0x03, 0x02, 0x07, 0x05, 0x00,
+		0x06, 0x03, 0x01, 0x04, 0x05, 0x00, 0x02, 0x07,
+		0x00, 0x05, 0x07, 0x02, 0x03, 0x06, 0x04, 0x01,
+		0x01, 0x04, 0x06, 0x03, 0x02, 0x07, 0x05, 0x00,
+		0x07, 0x02, 0x00, 0x05, 0x04, 0x01, 0x03, 0x06,
+		0x00, 0x05, 0x07, 0x02, 0x03, 0x06, 0x04, 0x01,
+		0x06, 0x03, 0x01, 0x04, 0x05, 0x00, 0x02, 0x07,
+		0x03, 0x06, 0x04, 0x01, 0x00, 0x05, 0x07, 0x02,
+		0x05, 0x00, 0x02, 0x07, 0x06, 0x03, 0x01, 0x04,
+		0x02, 0x07, 0x05, 0x00, 0x01, 0x04, 0x06, 0x03,
+		0x04, 0x01, 0x03, 0x06, 0x07, 0x02, 0x00, 0x05
+	}
+};
+
+
+/**
+ * @brief The pre-computed tables for the 7-bit CRC computed 4 bytes at a time
+ *
+ * Table k gives the CRC of one byte followed by k+1 zero bytes, so the CRC
+ * of 4 bytes is the XOR of one lookup in each table and one lookup in
+ * \ref rohc_crc_table_7 (slicing-by-4).
+ */
+static const uint8_t crc_slices_7[3][256] =
+{
+	{
+		0x00, 0x45, 0x79, 0x3c, 0x01, 0x44, 0x78, 0x3d,
+		0x02, 0x47, 0x7b, 0x3e, 0x03, 0x46, 0x7a, 0x3f,
+		0x04, 0x41, 0x7d, 0x38, 0x05, 0x40, 0x7c, 0x39,
+		0x06, 0x43, 0x7f, 0x3a, 0x07, 0x42, 0x7e, 0x3b,
+		0x08, 0x4d, 0x71, 0x34, 0x09, 0x4c, 0x70, 0x35,
+		0x0a, 0x4f, 0x73, 0x36, 0x0b, 0x4e, 0x72, 0x37,
+		0x0c, 0x49, 0x75, 0x30, 0x0d, 0x48, 0x74, 0x31,
+		0x0e, 0x4b, 0x77, 0x32, 0x0f, 0x4a, 0x76, 0x33,
+		0x10, 0x55, 0x69, 0x2c, 0x11, 0x54, 0x68, 0x2d,
+		0x12, 0x57, 0x6b, 0x2e, 0x13, 0x56, 0x6a, 0x2f,
+		0x14, 0x51, 0x6d, 0x28, 0x15, 0x50, 0x6c, 0x29,
+		0x16, 0x53, 0x6f, 0x2a, 0x17, 0x52, 0x6e, 0x2b,
+		0x18, 0x5d, 0x61, 0x24, 0x19, 0x5c, 0x60, 0x25,
+		0x1a, 0x5f, 0x63, 0x26, 0x1b, 0x5e, 0x62, 0x27,
+		0x1c, 0x59, 0x65, 0x20, 0x1d, 0x58, 0x64, 0x21,
+		0x1e, 0x5b, 0x67, 0x22, 0x1f, 0x5a, 0x66, 0x23,
+		0x20, 0x65, 0x59, 0x1c, 0x21, 0x64, 0x58, 0x1d,
+		0x22, 0x67, 0x5b, 0x1e, 0x23, 0x66, 0x5a, 0x1f,
+		0x24, 0x61, 0x5d, 0x18, 0x25, 0x60, 0x5c, 0x19,
+		0x26, 0x63, 0x5f, 0x1a, 0x27, 0x62, 0x5e, 0x1b,
+		0x28, 0x6d, 0x51, 0x14, 0x29, 0x6c, 0x50, 0x15,
+		0x2a, 0x6f, 0x53, 0x16, 0x2b, 0x6e, 0x52, 0x17,
+		0x2c, 0x69, 0x55, 0x10, 0x2d, 0x68, 0x54, 0x11,
+		0x2e, 0x6b, 0x57, 0x12, 0x2f, 0x6a, 0x56, 0x13,
+		0x30, 0x75, 0x49, 0x0c, 0x31, 0x74, 0x48, 0x0d,
+		0x32, 0x77, 0x4b, 0x0e, 0x33, 0x76, 0x4a, 0x0f,
+		0x34, 0x71, 0x4d, 0x08, 0x35, 0x70, 0x4c, 0x09,
+		0x36, 0x73, 0x4f, 0x0a, 0x37, 0x72, 0x4e, 0x0b,
+		0x38, 0x7d, 0x41, 0x04, 0x39, 0x7c, 0x40, 0x05,
+		0x3a, 0x7f, 0x43, 0x06, 0x3b, 0x7e, 0x42, 0x07,
+		0x3c, 0x79, 0x45, 0x00, 0x3d, 0x78, 0x44, 0x01,
+		0x3e, 0x7b, 0x47, 0x02, 0x3f, 0x7a, 0x46, 0x03
+	},
+	{
+		0x00, 0x10, 0x20, 0x30, 0x40, 0x50, 0x60, 0x70,
+		0x73, 0x63, 0x53, 0x43, 0x33, 0x23, 0x13, 0x03,
+		0x15, 0x05, 0x35, 0x25, 0x55, 0x45, 0x75, 0x65,
+		0x66, 0x76, 0x46, 0x56, 0x26, 0x36, 0x06, 0x16,
+		0x2a, 0x3a, 0x0a, 0x1a, 0x6a, 0x7a, 0x4a, 0x5a,
+		0x59, 0x49, 0x79, 0x69, 0x19, 0x09, 0x39, 0x29,
+		0x3f, 0x2f, 0x1f, 0x0f, 0x7f, 0x6f, 0x5f, 0x4f,
+		0x4c, 0x5c, 0x6c, 0x7c, 0x0c, 0x1c, 0x2c, 0x3c,
+		0x54, 0x44, 0x74, 0x64, 0x14, 0x04, 0x34, 0x24,
+		0x27, 0x37, 0x07, 0x17, 0x67, 0x77, 0x47, 0x57,
+		0x41, 0x51, 0x61, 0x71, 0x01, 0x11, 0x21, 0x31,
+		0x32, 0x22, 0x12, 0x02, 0x72, 0x62, 0x52, 0x42,
+		0x7e, 0x6e, 0x5e, 0x4e, 0x3e, 0x2e, 0x1e, 0x0e,
+		0x0d, 0x1d, 0x2d, 0x3d, 0x4d, 0x5d, 0x6d, 0x7d,
+		0x6b, 0x7b, 0x4b, 0x5b, 0x2b, 0x3b, 0x0b, 0x1b,
+		0x18, 0x08, 0x38, 0x28, 0x58, 0x48, 0x78, 0x68,
+		0x5b, 0x4b, 0x7b, 0x6b, 0x1b, 0x0b, 0x3b, 0x2b,
+		0x28, 0x38, 0x08, 0x18, 0x68, 0x78, 0x48, 0x58,
+		0x4e, 0x5e, 0x6e, 0x7e, 0x0e, 0x1e, 0x2e, 0x3e,
+		0x3d, 0x2d, 0x1d, 0x0d, 0x7d, 0x6d, 0x5d, 0x4d,
+		0x71, 0x61, 0x51, 0x41, 0x31, 0x21, 0x11, 0x01,
+		0x02, 0x12, 0x22, 0x32, 0x42, 0x52, 0x62, 0x72,
+		0x64, 0x74, 0x44, 0x54, 0x24, 0x34, 0x04, 0x14,
+		0x17, 0x07, 0x37, 0x27, 0x57, 0x47, 0x77, 0x67,
+		0x0f, 0x1f, 0x2f, 0x3f, 0x4f, 0x5f, 0x6f, 0x7f,
+		0x7c, 0x6c, 0x5c, 0x4c, 0x3c, 0x2c, 0x1c, 0x0c,
+		0x1a, 0x0a, 0x3a, 0x2a, 0x5a, 0x4a, 0x7a, 0x6a,
+		0x69, 0x79, 0x49, 0x59, 0x29, 0x39, 0x09, 0x19,
+		0x25, 0x35, 0x05, 0x15, 0x65, 0x75, 0x45, 0x55,
+		0x56, 0x46, 0x76, 0x66, 0x16, 0x06, 0x36, 0x26,
+		0x30, 0x20, 0x10, 0x00, 0x70, 0x60, 0x50, 0x40,
+		0x43, 0x53, 0x63, 0x73, 0x03, 0x13, 0x23, 0x33
+	},
+	{
+		0x00, 0x54, 0x5b, 0x0f, 0x45, 0x11, 0x1e, 0x4a,
+		0x79, 0x2d, 0x22, 0x76, 0x3c, 0x68, 0x67, 0x33,
+		0x01, 0x55, 0x5a, 0x0e, 0x44, 0x10, 0x1f, 0x4b,
+		0x78, 0x2c, 0x23, 0x77, 0x3d, 0x69, 0x66, 0x32,
+		0x02, 0x56, 0x59, 0x0d, 0x47, 0x13, 0x1c, 0x48,
+		0x7b, 0x2f, 0x20, 0x74, 0x3e, 0x6a, 0x65, 0x31,
+		0x03, 0x57, 0x58, 0x0c, 0x46, 0x12, 0x1d, 0x49,
+		0x7a, 0x2e, 0x21, 0x75, 0x3f, 0x6b, 0x64, 0x30,
+		0x04, 0x50, 0x5f, 0x0b, 0x41, 0x15, 0x1a, 0x4e,
+		0x7d, 0x29, 0x26, 0x72, 0x38, 0x6c, 0x63, 0x37,
+		0x05, 0x51, 0x5e, 0x0a, 0x40, 0x14, 0x1b, 0x4f,
+		0x7c, 0x28, 0x27, 0x73, 0x39, 0x6d, 0x62, 0x36,
+		0x06, 0x52, 0x5d, 0x09, 0x43, 0x17, 0x18, 0x4c,
+		0x7f, 0x2b, 0x24, 0x70, 0x3a, 0x6e, 0x61, 0x35,
+		0x07, 0x53, 0x5c, 0x08, 0x42, 0x16, 0x19, 0x4d,
+		0x7e, 0x2a, 0x25, 0x71, 0x3b, 0x6f, 0x60, 0x34,
+		0x08, 0x5c, 0x53, 0x07, 0x4d, 0x19, 0x16, 0x42,
+		0x71, 0x25, 0x2a, 0x7e, 0x34, 0x60, 0x6f, 0x3b,
+		0x09, 0x5d, 0x52, 0x06, 0x4c, 0x18, 0x17, 0x43,
+		0x70, 0x24, 0x2b, 0x7f, 0x35, 0x61, 0x6e, 0x3a,
+		0x0a, 0x5e, 0x51, 0x05, 0x4f, 0x1b, 0x14, 0x40,
+		0x73, 0x27, 0x28, 0x7c, 0x36, 0x62, 0x6d, 0x39,
+		0x0b, 0x5f, 0x50, 0x04, 0x4e, 0x1a, 0x15, 0x41,
+		0x72, 0x26, 0x29, 0x7d, 0x37, 0x63, 0x6c, 0x38,
+		0x0c, 0x58, 0x57, 0x03, 0x49, 0x1d, 0x12, 0x46,
+		0x75, 0x21, 0x2e, 0x7a, 0x30, 0x64, 0x6b, 0x3f,
+		0x0d, 0x59, 0x56, 0x02, 0x48, 0x1c, 0x13, 0x47,
+		0x74, 0x20, 0x2f, 0x7b, 0x31, 0x65, 0x6a, 0x3e,
+		0x0e, 0x5a, 0x55, 0x01, 0x4b, 0x1f, 0x10, 0x44,
+		0x77, 0x23, 0x2c, 0x78, 0x32, 0x66, 0x69, 0x3d,
+		0x0f, 0x5b, 0x54, 0x00, 0x4a, 0x1e, 0x11, 0x45,
+		0x76, 0x22, 0x2d, 0x79, 0x33, 0x67, 0x68, 0x3c
+	}
+};
+
+
+/**
+ * @brief The pre-computed tables for the 8-bit CRC computed 4 bytes at a time
+ *
+ * Table k gives the CRC of one byte followed by k+1 zero bytes, so the CRC
+ * of 4 bytes is the XOR of one lookup in each table and one lookup in
+ * \ref rohc_crc_table_8 (slicing-by-4).
+ */
+static const uint8_t crc_slices_8[3][256] =
+{
+	{
+		0x00, 0x6d, 0xda, 0xb7, 0x75, 0x18, 0xaf, 0xc2,
+		0xea, 0x87, 0x30, 0x5d, 0x9f, 0xf2, 0x45, 0x28,
+		0x15, 0x78, 0xcf, 0xa2, 0x60, 0x0d, 0xba, 0xd7,
+		0xff, 0x92, 0x25, 0x48, 0x8a, 0xe7, 0x50, 0x3d,
+		0x2a, 0x47, 0xf0, 0x9d, 0x5f, 0x32, 0x85, 0xe8,
+		0xc0, 0xad, 0x1a, 0x77, 0xb5, 0xd8, 0x6f, 0x02,
+		0x3f, 0x52, 0xe5, 0x88, 0x4a, 0x27, 0x90, 0xfd,
+		0xd5, 0xb8, 0x0f, 0x62, 0xa0, 0xcd, 0x7a, 0x17,
+		0x54, 0x39, 0x8e, 0xe3, 0x21, 0x4c, 0xfb, 0x96,
+		0xbe, 0xd3, 0x64, 0x09, 0xcb, 0xa6, 0x11, 0x7c,
+		0x41, 0x2c, 0x9b, 0xf6, 0x34, 0x59, 0xee, 0x83,
+		0xab, 0xc6, 0x71, 0x1c, 0xde, 0xb3, 0x04, 0x69,
+		0x7e, 0x13, 0xa4, 0xc9, 0x0b, 0x66, 0xd1, 0xbc,
+		0x94, 0xf9, 0x4e, 0x23, 0xe1, 0x8c, 0x3b, 0x56,
+		0x6b, 0x06, 0xb1, 0xdc, 0x1e, 0x73, 0xc4, 0xa9,
+		0x81, 0xec, 0x5b, 0x36, 0xf4, 0x99, 0x2e, 0x43,
+		0xa8, 0xc5, 0x72, 0x1f, 0xdd, 0xb0, 0x07, 0x6a,
+		0x42, 0x2f, 0x98, 0xf5, 0x37, 0x5a, 0xed, 0x80,
+		0xbd, 0xd0, 0x67, 0x0a, 0xc8, 0xa5, 0x12, 0x7f,
+		0x57, 0x3a, 0x8d, 0xe0, 0x22, 0x4f, 0xf8, 0x95,
+		0x82, 0xef, 0x58, 0x35, 0xf7, 0x9a, 0x2d, 0x40,
+		0x68, 0x05, 0xb2, 0xdf, 0x1d, 0x70, 0xc7, 0xaa,
+		0x97, 0xfa, 0x4d, 0x20, 0xe2, 0x8f, 0x38, 0x55,
+		0x7d, 0x10, 0xa7, 0xca, 0x08, 0x65, 0xd2, 0xbf,
+		0xfc, 0x91, 0x26, 0x4b, 0x89, 0xe4, 0x53, 0x3e,
+		0x16, 0x7b, 0xcc, 0xa1, 0x63, 0x0e, 0xb9, 0xd4,
+		0xe9, 0x84, 0x33, 0x5e, 0x9c, 0xf1, 0x46, 0x2b,
+		0x03, 0x6e, 0xd9, 0xb4, 0x76, 0x1b, 0xac, 0xc1,
+		0xd6, 0xbb, 0x0c, 0x61, 0xa3, 0xce, 0x79, 0x14,
+		0x3c, 0x51, 0xe6, 0x8b, 0x49, 0x24, 0x93, 0xfe,
+		0xc3, 0xae, 0x19, 0x74, 0xb6, 0xdb, 0x6c, 0x01,
+		0x29, 0x44, 0xf3, 0x9e, 0x5c, 0x31, 0x86, 0xeb
+	},
+	{
+		0x00, 0xd0, 0x61, 0xb1, 0xc2, 0x12, 0xa3, 0x73,
+		0x45, 0x95, 0x24, 0xf4, 0x87, 0x57, 0xe6, 0x36,
+		0x8a, 0x5a, 0xeb, 0x3b, 0x48, 0x98, 0x29, 0xf9,
+		0xcf, 0x1f, 0xae, 0x7e, 0x0d, 0xdd, 0x6c, 0xbc,
+		0xd5, 0x05, 0xb4, 0x64, 0x17, 0xc7, 0x76, 0xa6,
+		0x90, 0x40, 0xf1, 0x21, 0x52, 0x82, 0x33, 0xe3,
+		0x5f, 0x8f, 0x3e, 0xee, 0x9d, 0x4d, 0xfc, 0x2c,
+		0x1a, 0xca, 0x7b, 0xab, 0xd8, 0x08, 0xb9, 0x69,
+		0x6b, 0xbb, 0x0a, 0xda, 0xa9, 0x79, 0xc8, 0x18,
+		0x2e, 0xfe, 0x4f, 0x9f, 0xec, 0x3c, 0x8d, 0x5d,
+		0xe1, 0x31, 0x80, 0x50, 0x23, 0xf3, 0x42, 0x92,
+		0xa4, 0x74, 0xc5, 0x15, 0x66, 0xb6, 0x07, 0xd7,
+		0xbe, 0x6e, 0xdf, 0x0f, 0x7c, 0xac, 0x1d, 0xcd,
+		0xfb, 0x2b, 0x9a, 0x4a, 0x39, 0xe9, 0x58, 0x88,
+		0x34, 0xe4, 0x55, 0x85, 0xf6, 0x26, 0x97, 0x47,
+		0x71, 0xa1, 0x10, 0xc0, 0xb3, 0x63, 0xd2, 0x02,
+		0xd6, 0x06, 0xb7, 0x67, 0x14, 0xc4, 0x75, 0xa5,
+		0x93, 0x43, 0xf2, 0x22, 0x51, 0x81, 0x30, 0xe0,
+		0x5c, 0x8c, 0x3d, 0xed, 0x9e, 0x4e, 0xff, 0x2f,
+		0x19, 0xc9, 0x78, 0xa8, 0xdb, 0x0b, 0xba, 0x6a,
+		0x03, 0xd3, 0x62, 0xb2, 0xc1, 0x11, 0xa0, 0x70,
+		0x46, 0x96, 0x27, 0xf7, 0x84, 0x54, 0xe5, 0x35,
+		0x89, 0x59, 0xe8, 0x38, 0x4b, 0x9b, 0x2a, 0xfa,
+		0xcc, 0x1c, 0xad, 0x7d, 0x0e, 0xde, 0x6f, 0xbf,
+		0xbd, 0x6d, 0xdc, 0x0c, 0x7f, 0xaf, 0x1e, 0xce,
+		0xf8, 0x28, 0x99, 0x49, 0x3a, 0xea, 0x5b, 0x8b,
+		0x37, 0xe7, 0x56, 0x86, 0xf5, 0x25, 0x94, 0x44,
+		0x72, 0xa2, 0x13, 0xc3, 0xb0, 0x60, 0xd1, 0x01,
+		0x68, 0xb8, 0x09, 0xd9, 0xaa, 0x7a, 0xcb, 0x1b,
+		0x2d, 0xfd, 0x4c, 0x9c, 0xef, 0x3f, 0x8e, 0x5e,
+		0xe2, 0x32, 0x83, 0x53, 0x20, 0xf0, 0x41, 0x91,
+		0xa7, 0x77, 0xc6, 0x16, 0x65, 0xb5, 0x04, 0xd4
+	},
+	{
+		0x00, 0x8c, 0xd9, 0x55, 0x73, 0xff, 0xaa, 0x26,
+		0xe6, 0x6a, 0x3f, 0xb3, 0x95, 0x19, 0x4c, 0xc0,
+		0x0d, 0x81, 0xd4, 0x58, 0x7e, 0xf2, 0xa7, 0x2b,
+		0xeb, 0x67, 0x32, 0xbe, 0x98, 0x14, 0x41, 0xcd,
+		0x1a, 0x96, 0xc3, 0x4f, 0x69, 0xe5, 0xb0, 0x3c,
+		0xfc, 0x70, 0x25, 0xa9, 0x8f, 0x03, 0x56, 0xda,
+		0x17, 0x9b, 0xce, 0x42, 0x64, 0xe8, 0xbd, 0x31,
+		0xf1, 0x7d, 0x28, 0xa4, 0x82, 0x0e, 0x5b, 0xd7,
+		0x34, 0xb8, 0xed, 0x61, 0x47, 0xcb, 0x9e, 0x12,
+		0xd2, 0x5e, 0x0b, 0x87, 0xa1, 0x2d, 0x78, 0xf4,
+		0x39, 0xb5, 0xe0, 0x6c, 0x4a, 0xc6, 0x93, 0x1f,
+		0xdf, 0x53, 0x06, 0x8a, 0xac, 0x20, 0x75, 0xf9,
+		0x2e, 0xa2, 0xf7, 0x7b, 0x5d, 0xd1, 0x84, 0x08,
+		0xc8, 0x44, 0x11, 0x9d, 0xbb, 0x37, 0x62, 0xee,
+		0x23, 0xaf, 0xfa, 0x76, 0x50, 0xdc, 0x89, 0x05,
+		0xc5, 0x49, 0x1c, 0x90, 0xb6, 0x3a, 0x6f, 0xe3,
+		0x68, 0xe4, 0xb1, 0x3d, 0x1b, 0x97, 0xc2, 0x4e,
+		0x8e, 0x02, 0x57, 0xdb, 0xfd, 0x71, 0x24, 0xa8,
+		0x65, 0xe9, 0xbc, 0x30, 0x16, 0x9a, 0xcf, 0x43,
+		0x83, 0x0f, 0x5a, 0xd6, 0xf0, 0x7c, 0x29, 0xa5,
+		0x72, 0xfe, 0xab, 0x27, 0x01, 0x8d, 0xd8, 0x54,
+		0x94, 0x18, 0x4d, 0xc1, 0xe7, 0x6b, 0x3e, 0xb2,
+		0x7f, 0xf3, 0xa6, 0x2a, 0x0c, 0x80, 0xd5, 0x59,
+		0x99, 0x15, 0x40, 0xcc, 0xea, 0x66, 0x33, 0xbf,
+		0x5c, 0xd0, 0x85, 0x09, 0x2f, 0xa3, 0xf6, 0x7a,
+		0xba, 0x36, 0x63, 0xef, 0xc9, 0x45, 0x10, 0x9c,
+		0x51, 0xdd, 0x88, 0x04, 0x22, 0xae, 0xfb, 0x77,
+		0xb7, 0x3b, 0x6e, 0xe2, 0xc4, 0x48, 0x1d, 0x91,
+		0x46, 0xca, 0x9f, 0x13, 0x35, 0xb9, 0xec, 0x60,
+		0xa0, 0x2c, 0x79, 0xf5, 0xd3, 0x5f, 0x0a, 0x86,
+		0x4b, 0xc7, 0x92, 0x1e, 0x38, 0xb4, 0xe1, 0x6d,
+		0xad, 0x21, 0x74, 0xf8, 0xde, 0x52, 0x07, 0x8b
+	}
+};
+
+
 /**
  * Prototypes of private functions
  */
 
+#if !defined(__KERNEL__)
+static uint32_t crc_calc_fcs32_table(const uint8_t *const data,
+                                     const size_t length,
+                                     const uint32_t init_val)
+	__attribute__((nonnull(1), warn_unused_result, pure));
+#endif
+#if defined(ROHC_CRC_FCS32_PCLMUL)
+static uint32_t crc_calc_fcs32_pclmul(const uint8_t *data,
+                                      size_t length,
+                                      const uint32_t init_val)
+	__attribute__((target("pclmul,sse4.1"), nonnull(1), warn_unused_result,
+	               pure));
+#elif defined(ROHC_CRC_FCS32_ARMV8)
+static uint32_t crc_calc_fcs32_armv8(const uint8_t *data,
+                                     size_t length,
+                                     const uint32_t init_val)
+	__attribute__((target(ROHC_CRC_FCS32_ARMV8_TARGET), nonnull(1),
+	               warn_unused_result, pure));
+#endif
+
 static uint8_t ipv6_ext_calc_crc_static(const uint8_t *const ip,
                                         const rohc_crc_type_t crc_type,
                                         const uint8_t init_val,
@@ -140,11 +654,6 @@ static uint8_t * ipv6_get_first_extension(const uint8_t *const ip,
 	__attribute__((warn_unused_result, nonnull(1, 2)));
 
 
-static bool rohc_crc_get_polynom(const rohc_crc_type_t crc_type,
-                                 uint8_t *const polynom)
-	__attribute__((nonnull(2), warn_unused_result));
-
-
 static inline uint8_t crc_calc_8(const uint8_t *const buf,
                                  const size_t size,
                                  const uint8_t init_val,
@@ -168,59 +677,6 @@ static inline uint8_t crc_calc_3(const uint8_t *const buf,
  */
 
 
-/**
- * @brief Initialize a CRC table given a 256-byte table and the CRC type to use
- *
- * @param table     IN/OUT: The 256-byte table to initialize
- * @param crc_type  The type of CRC to initialize the table for
- * @return          true in case of success, false in case of failure
- */
-bool rohc_crc_init_table(uint8_t *const table,
-                         const rohc_crc_type_t crc_type)
-{
-	uint8_t crc;
-	uint8_t polynom;
-	bool is_fine;
-	int i, j;
-
-	/* sanity check */
-	assert(table != NULL);
-
-	/* determine the polynom to use */
-	is_fine = rohc_crc_get_polynom(crc_type, &polynom);
-	if(is_fine != true)
-	{
-		goto error;
-	}
-
-	/* fill the CRC table */
-	for(i = 0; i < 256; i++)
-	{
-		crc = i;
-
-		for(j = 0; j < 8; j++)
-		{
-			if(crc & 1)
-			{
-				crc = (crc >> 1) ^ polynom;
-			}
-			else
-			{
-				crc = crc >> 1;
-			}
-		}
-
-		table[i] = crc;
-	}
-
-	/* everything went fine */
-	return true;
-
-error:
-	return false;
-}
-
-
 /**
  * @brief Calculate the checksum for the given data.
  *
@@ -264,7 +720,12 @@ uint8_t crc_calculate(const rohc_crc_type_t crc_type,
 
 
 /**
- * @brief Optimized CRC FCS-32 calculation using a table
+ * @brief Optimized CRC FCS-32 calculation
+ *
+ * The implementation is selected at runtime: carry-less multiplication
+ * (PCLMULQDQ) on x86-64 CPUs and CRC-32 instructions on ARMv8 CPUs that
+ * support them, the kernel CRC-32 library in kernel mode, and a lookup
+ * table otherwise.
  *
  * @param data      The data to compute the CRC for
  * @param length    The size of the data
@@ -275,15 +736,30 @@ uint32_t crc_calc_fcs32(const uint8_t *const data,
                         const size_t length,
                         const uint32_t init_val)
 {
+#if defined(__KERNEL__)
+	/* FCS-32 is the little-endian CRC-32 of the kernel library */
+	return crc32_le(init_val, data, length);
+#else
 	uint32_t crc = init_val;
-	size_t i;
+	size_t len_done = 0;
 
-	for(i = 0; i < length; i++)
+#  if defined(ROHC_CRC_FCS32_PCLMUL)
+	/* fold 16-byte blocks with carry-less multiplications, there shall be
+	 * at least 64 bytes; the remaining bytes are handled with the table */
+	if(length >= 64 && rohc_cpu_has(ROHC_CPU_FEATURE_X86_PCLMUL))
 	{
-		crc = (crc >> 8) ^ crc_table_fcs32[(crc ^ data[i]) & 0xff];
+		len_done = length & ~((size_t) 15);
+		crc = crc_calc_fcs32_pclmul(data, len_done, crc);
 	}
+#  elif defined(ROHC_CRC_FCS32_ARMV8)
+	if(rohc_cpu_has(ROHC_CPU_FEATURE_ARMV8_CRC32))
+	{
+		return crc_calc_fcs32_armv8(data, length, crc);
+	}
+#  endif
 
-	return crc;
+	return crc_calc_fcs32_table(data + len_done, length - len_done, crc);
+#endif
 }
 
 
@@ -658,7 +1134,9 @@ uint8_t rtp_compute_crc_static(const uint8_t *const outer_ip,
 	crc = crc_calculate(crc_type, (uint8_t *)(&rtp->ssrc), 4,
 	                    crc, crc_table);
 
-	/* TODO: CSRC identifiers */
+	/* CSRC identifiers */
+	crc = crc_calculate(crc_type, (uint8_t *)(rtp + 1),
+	                    rtp->cc * sizeof(uint32_t), crc, crc_table);
 
 	return crc;
 }
@@ -707,6 +1185,187 @@ uint8_t rtp_compute_crc_dynamic(const uint8_t *const outer_ip,
  * Private functions
  */
 
+#if !defined(__KERNEL__)
+
+/**
+ * @brief CRC FCS-32 calculation using a table
+ *
+ * @param data      The data to compute the CRC for
+ * @param length    The size of the data
+ * @param init_val  The initial value of the CRC
+ * @return          The 32-bit CRC
+ */
+static uint32_t crc_calc_fcs32_table(const uint8_t *const data,
+                                     const size_t length,
+                                     const uint32_t init_val)
+{
+	uint32_t crc = init_val;
+	size_t i;
+
+	for(i = 0; i < length; i++)
+	{
+		crc = (crc >> 8) ^ crc_table_fcs32[(crc ^ data[i]) & 0xff];
+	}
+
+	return crc;
+}
+
+#endif /* !__KERNEL__ */
+
+#if defined(ROHC_CRC_FCS32_PCLMUL)
+
+/**
+ * @brief CRC FCS-32 calculation using carry-less multiplications
+ *
+ * Four 128-bit accumulators are folded 64 bytes at a time, then folded into
+ * one 128-bit value that is reduced to the 32-bit CRC with a Barrett
+ * reduction. The constants are the bit-reflected ones for the FCS-32
+ * polynomial given in "Fast CRC Computation for Generic Polynomials Using
+ * PCLMULQDQ Instruction" (Intel, 2009).
+ *
+ * @param data      The data to compute the CRC for
+ * @param length    The size of the data, a multiple of 16 bytes that is at
+ *                  least 64 bytes
+ * @param init_val  The initial value of the CRC
+ * @return          The 32-bit CRC
+ */
+static uint32_t crc_calc_fcs32_pclmul(const uint8_t *data,
+                                      size_t length,
+                                      const uint32_t init_val)
+{
+	/* x^(4*128+32) mod P and x^(4*128-32) mod P, bit-reflected */
+	const __m128i k1k2 = _mm_set_epi64x(0x01c6e41596, 0x0154442bd4);
+	/* x^(128+32) mod P and x^(128-32) mod P, bit-reflected */
+	const __m128i k3k4 = _mm_set_epi64x(0x00ccaa009e, 0x01751997d0);
+	/* x^64 mod P, bit-reflected */
+	const __m128i k5 = _mm_set_epi64x(0, 0x0163cd6124);
+	/* the polynomial P and the Barrett constant u = x^64 / P, bit-reflected */
+	const __m128i poly = _mm_set_epi64x(0x01f7011641, 0x01db710641);
+	const __m128i mask32 = _mm_setr_epi32(~0, 0, ~0, 0);
+	__m128i x1, x2, x3, x4;
+	__m128i y1, y2, y3, y4;
+
+	assert(length >= 64);
+	assert((length % 16) == 0);
+
+	x1 = _mm_loadu_si128((const __m128i *) (data + 0x00));
+	x2 = _mm_loadu_si128((const __m128i *) (data + 0x10));
+	x3 = _mm_loadu_si128((const __m128i *) (data + 0x20));
+	x4 = _mm_loadu_si128((const __m128i *) (data + 0x30));
+	x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(init_val));
+	data += 64;
+	length -= 64;
+
+	/* fold 64 bytes at a time */
+	while(length >= 64)
+	{
+		y1 = _mm_clmulepi64_si128(x1, k1k2, 0x00);
+		y2 = _mm_clmulepi64_si128(x2, k1k2, 0x00);
+		y3 = _mm_clmulepi64_si128(x3, k1k2, 0x00);
+		y4 = _mm_clmulepi64_si128(x4, k1k2, 0x00);
+		x1 = _mm_clmulepi64_si128(x1, k1k2, 0x11);
+		x2 = _mm_clmulepi64_si128(x2, k1k2, 0x11);
+		x3 = _mm_clmulepi64_si128(x3, k1k2, 0x11);
+		x4 = _mm_clmulepi64_si128(x4, k1k2, 0x11);
+		x1 = _mm_xor_si128(_mm_xor_si128(x1, y1),
+		                   _mm_loadu_si128((const __m128i *) (data + 0x00)));
+		x2 = _mm_xor_si128(_mm_xor_si128(x2, y2),
+		                   _mm_loadu_si128((const __m128i *) (data + 0x10)));
+		x3 = _mm_xor_si128(_mm_xor_si128(x3, y3),
+		                   _mm_loadu_si128((const __m128i *) (data + 0x20)));
+		x4 = _mm_xor_si128(_mm_xor_si128(x4, y4),
+		                   _mm_loadu_si128((const __m128i *) (data + 0x30)));
+		data += 64;
+		length -= 64;
+	}
+
+	/* fold the 4 accumulators into one */
+	y1 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+	x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+	x1 = _mm_xor_si128(_mm_xor_si128(x1, y1), x2);
+	y1 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+	x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+	x1 = _mm_xor_si128(_mm_xor_si128(x1, y1), x3);
+	y1 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+	x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+	x1 = _mm_xor_si128(_mm_xor_si128(x1, y1), x4);
+
+	/* fold the remaining 16-byte blocks */
+	while(length >= 16)
+	{
+		y1 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+		x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+		x1 = _mm_xor_si128(_mm_xor_si128(x1, y1),
+		                   _mm_loadu_si128((const __m128i *) data));
+		data += 16;
+		length -= 16;
+	}
+
+	/* fold 128 bits to 64 bits */
+	x2 = _mm_clmulepi64_si128(x1, k3k4, 0x10);
+	x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+	x2 = _mm_srli_si128(x1, 4);
+	x1 = _mm_and_si128(x1, mask32);
+	x1 = _mm_clmulepi64_si128(x1, k5, 0x00);
+	x1 = _mm_xor_si128(x1, x2);
+
+	/* Barrett reduction to 32 bits */
+	x2 = _mm_and_si128(x1, mask32);
+	x2 = _mm_clmulepi64_si128(x2, poly, 0x10);
+	x2 = _mm_and_si128(x2, mask32);
+	x2 = _mm_clmulepi64_si128(x2, poly, 0x00);
+	x1 = _mm_xor_si128(x1, x2);
+
+	return _mm_extract_epi32(x1, 1);
+}
+
+#elif defined(ROHC_CRC_FCS32_ARMV8)
+
+/**
+ * @brief CRC FCS-32 calculation using the ARMv8 CRC-32 instructions
+ *
+ * @param data      The data to compute the CRC for
+ * @param length    The size of the data
+ * @param init_val  The initial value of the CRC
+ * @return          The 32-bit CRC
+ */
+static uint32_t crc_calc_fcs32_armv8(const uint8_t *data,
+                                     size_t length,
+                                     const uint32_t init_val)
+{
+	uint32_t crc = init_val;
+
+	/* align data on 8 bytes */
+	while(length > 0 && (((uintptr_t) data) & 7) != 0)
+	{
+		crc = __crc32b(crc, *data);
+		data++;
+		length--;
+	}
+
+	/* 8 bytes at a time */
+	while(length >= 8)
+	{
+		uint64_t word;
+		memcpy(&word, data, sizeof(uint64_t));
+		crc = __crc32d(crc, word);
+		data += 8;
+		length -= 8;
+	}
+
+	/* remaining bytes */
+	while(length > 0)
+	{
+		crc = __crc32b(crc, *data);
+		data++;
+		length--;
+	}
+
+	return crc;
+}
+
+#endif
+
 /**
  * @brief Compute the CRC-STATIC part of IPv6 extensions
  *
@@ -724,20 +1383,30 @@ static uint8_t ipv6_ext_calc_crc_static(const uint8_t *const ip,
                                         const uint8_t *const crc_table)
 {
 	uint8_t crc = init_val;
+	const uint8_t *first_ext;
 	const uint8_t *ext;
 	uint8_t ext_type;
 
 	assert(ip != NULL);
 
-	ext = ipv6_get_first_extension(ip, &ext_type);
-	while(ext != NULL)
+	/* AH is not part of the known extension chain (see rohc_is_ipv6_opt()),
+	 * so the chain is contiguous: locate its end, then compute the CRC over
+	 * the whole chain at once instead of extension per extension */
+	first_ext = ipv6_get_first_extension(ip, &ext_type);
+	if(first_ext != NULL)
 	{
-		if(ext_type != ROHC_IPPROTO_AH)
+		const uint8_t *chain_end;
+
+		ext = first_ext;
+		do
 		{
-			crc = crc_calculate(crc_type, ext, ip_get_extension_size(ext),
-			                    crc, crc_table);
+			chain_end = ext + ip_get_extension_size(ext);
+			ext = ip_get_next_ext_from_ext(ext, &ext_type);
 		}
-		ext = ip_get_next_ext_from_ext(ext, &ext_type);
+		while(ext != NULL);
+
+		crc = crc_calculate(crc_type, first_ext, chain_end - first_ext,
+		                    crc, crc_table);
 	}
 
 	return crc;
@@ -781,46 +1450,6 @@ static uint8_t ipv6_ext_calc_crc_dyn(const uint8_t *const ip,
 }
 
 
-/**
- * @brief Get the polynom for the given CRC type
- *
- * @param crc_type The CRC type
- * @param polynom  IN/OUT: the polynom for the requested CRC type
- * @return         true in case of success, false otherwise
- */
-static bool rohc_crc_get_polynom(const rohc_crc_type_t crc_type,
-                                 uint8_t *const polynom)
-{
-	/* sanity check */
-	assert(polynom != NULL);
-
-	/* determine the polynom for CRC */
-	switch(crc_type)
-	{
-		case ROHC_CRC_TYPE_3:
-			*polynom = 0x6;
-			break;
-		case ROHC_CRC_TYPE_7:
-			*polynom = 0x79;
-			break;
-		case ROHC_CRC_TYPE_8:
-			*polynom = 0xe0;
-			break;
-		case ROHC_CRC_TYPE_NONE:
-		default:
-			/* unknown CRC type, should not happen */
-			assert(0);
-			goto error;
-	}
-
-	/* everything went fine */
-	return true;
-
-error:
-	return false;
-}
-
-
 /**
  * @brief Get the first extension in an IPv6 packet
  *
@@ -853,7 +1482,10 @@ static uint8_t * ipv6_get_first_extension(const uint8_t *const ip,
 
 
 /**
- * @brief Optimized CRC-8 calculation using a table
+ * @brief Optimized CRC-8 calculation using tables
+ *
+ * The data is processed 4 bytes at a time with the slicing-by-4 tables if
+ * the given table is the shared one, then byte per byte with the given table.
  *
  * @param buf        The data to compute the CRC for
  * @param size       The size of the data
@@ -867,9 +1499,23 @@ static inline uint8_t crc_calc_8(const uint8_t *const buf,
                                  const uint8_t *const crc_table)
 {
 	uint8_t crc = init_val;
-	size_t i;
+	size_t i = 0;
 
-	for(i = 0; i < size; i++)
+	/* 4 bytes at a time, only if the given table is the shared one that the
+	 * slicing-by-4 tables were computed from */
+	if(crc_table == rohc_crc_table_8)
+	{
+		for(; (size - i) >= 4; i += 4)
+		{
+			crc = crc_slices_8[2][buf[i] ^ crc] ^
+			      crc_slices_8[1][buf[i + 1]] ^
+			      crc_slices_8[0][buf[i + 2]] ^
+			      crc_table[buf[i + 3]];
+		}
+	}
+
+	/* remaining bytes */
+	for(; i < size; i++)
 	{
 		crc = crc_table[buf[i] ^ crc];
 	}
@@ -879,7 +1525,10 @@ static inline uint8_t crc_calc_8(const uint8_t *const buf,
 
 
 /**
- * @brief Optimized CRC-7 calculation using a table
+ * @brief Optimized CRC-7 calculation using tables
+ *
+ * The data is processed 4 bytes at a time with the slicing-by-4 tables if
+ * the given table is the shared one, then byte per byte with the given table.
  *
  * @param buf        The data to compute the CRC for
  * @param size       The size of the data
@@ -893,9 +1542,23 @@ static inline uint8_t crc_calc_7(const uint8_t *const buf,
                                  const uint8_t *const crc_table)
 {
 	uint8_t crc = init_val;
-	size_t i;
+	size_t i = 0;
 
-	for(i = 0; i < size; i++)
+	/* 4 bytes at a time, only if the given table is the shared one that the
+	 * slicing-by-4 tables were computed from */
+	if(crc_table == rohc_crc_table_7)
+	{
+		for(; (size - i) >= 4; i += 4)
+		{
+			crc = crc_slices_7[2][buf[i] ^ (crc & 127)] ^
+			      crc_slices_7[1][buf[i + 1]] ^
+			      crc_slices_7[0][buf[i + 2]] ^
+			      crc_table[buf[i + 3]];
+		}
+	}
+
+	/* remaining bytes */
+	for(; i < size; i++)
 	{
 		crc = crc_table[buf[i] ^ (crc & 127)];
 	}
@@ -905,7 +1568,10 @@ static inline uint8_t crc_calc_7(const uint8_t *const buf,
 
 
 /**
- * @brief Optimized CRC-3 calculation using a table
+ * @brief Optimized CRC-3 calculation using tables
+ *
+ * The data is processed 4 bytes at a time with the slicing-by-4 tables if
+ * the given table is the shared one, then byte per byte with the given table.
  *
  * @param buf        The data to compute the CRC for
  * @param size       The size of the data
@@ -919,9 +1585,23 @@ static inline uint8_t crc_calc_3(const uint8_t *const buf,
                                  const uint8_t *const crc_table)
 {
 	uint8_t crc = init_val;
-	size_t i;
+	size_t i = 0;
+
+	/* 4 bytes at a time, only if the given table is the shared one that the
+	 * slicing-by-4 tables were computed from */
+	if(crc_table == rohc_crc_table_3)
+	{
+		for(; (size - i) >= 4; i += 4)
+		{
+			crc = crc_slices_3[2][buf[i] ^ (crc & 7)] ^
+			      crc_slices_3[1][buf[i + 1]] ^
+			      crc_slices_3[0][buf[i + 2]] ^
+			      crc_table[buf[i + 3]];
+		}
+	}
 
-	for(i = 0; i < size; i++)
+	/* remaining bytes */
+	for(; i < size; i++)
 	{
 		crc = crc_table[buf[i] ^ (crc & 7)];
 	}
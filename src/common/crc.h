@@ -62,13 +62,37 @@ typedef enum
 } rohc_crc_type_t;
 
 
+/**
+ * @brief The CRC computed on the CRC-STATIC fields, cached by one context
+ *
+ * The CRC of the UO* packets is computed on the CRC-STATIC fields first,
+ * then on the CRC-DYNAMIC fields. The CRC-STATIC fields may only change
+ * with IR, IR-DYN packets or with extension 3, so the state of the CRC
+ * after the CRC-STATIC fields may be computed once and re-used for all the
+ * other packets.
+ */
+struct rohc_crc_static_cache
+{
+	/** The CRC computed on the CRC-STATIC fields, indexed by CRC type */
+	uint8_t crc[ROHC_CRC_TYPE_8 + 1];
+	/** Whether the cached CRC is valid or not, indexed by CRC type */
+	bool is_valid[ROHC_CRC_TYPE_8 + 1];
+};
+
+
 /*
- * Function prototypes.
+ * Pre-computed tables for fast CRC computation, shared by all the
+ * compressors and decompressors
  */
 
-bool rohc_crc_init_table(uint8_t *const table,
-                         const rohc_crc_type_t crc_type)
-	__attribute__((nonnull(1), warn_unused_result));
+extern const uint8_t rohc_crc_table_3[256];
+extern const uint8_t rohc_crc_table_7[256];
+extern const uint8_t rohc_crc_table_8[256];
+
+
+/*
+ * Function prototypes.
+ */
 
 uint8_t crc_calculate(const rohc_crc_type_t crc_type,
                       const uint8_t *const data,
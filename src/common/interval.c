@@ -29,6 +29,42 @@
 #include <assert.h>
 
 
+/**
+ * @brief The shift parameter for RTP TS, indexed by k
+ *
+ * p = 0 if k <= 2, p = 2^(k-2) - 1 otherwise. See 4.5.4 in the RFC 3095.
+ */
+const int32_t rohc_interval_p_rtp_ts[32 + 1] =
+{
+	0, 0, 0,
+	(1 << 1) - 1, (1 << 2) - 1, (1 << 3) - 1, (1 << 4) - 1, (1 << 5) - 1,
+	(1 << 6) - 1, (1 << 7) - 1, (1 << 8) - 1, (1 << 9) - 1, (1 << 10) - 1,
+	(1 << 11) - 1, (1 << 12) - 1, (1 << 13) - 1, (1 << 14) - 1,
+	(1 << 15) - 1, (1 << 16) - 1, (1 << 17) - 1, (1 << 18) - 1,
+	(1 << 19) - 1, (1 << 20) - 1, (1 << 21) - 1, (1 << 22) - 1,
+	(1 << 23) - 1, (1 << 24) - 1, (1 << 25) - 1, (1 << 26) - 1,
+	(1 << 27) - 1, (1 << 28) - 1, (1 << 29) - 1, (1 << 30) - 1,
+};
+
+
+/**
+ * @brief The shift parameter for RTP and ESP SN, indexed by k
+ *
+ * p = 1 if k <= 4, p = 2^(k-5) - 1 otherwise. See 4.5.1 in the RFC 3095.
+ */
+const int32_t rohc_interval_p_rtp_sn[32 + 1] =
+{
+	1, 1, 1, 1, 1,
+	(1 << 0) - 1, (1 << 1) - 1, (1 << 2) - 1, (1 << 3) - 1, (1 << 4) - 1,
+	(1 << 5) - 1, (1 << 6) - 1, (1 << 7) - 1, (1 << 8) - 1, (1 << 9) - 1,
+	(1 << 10) - 1, (1 << 11) - 1, (1 << 12) - 1, (1 << 13) - 1,
+	(1 << 14) - 1, (1 << 15) - 1, (1 << 16) - 1, (1 << 17) - 1,
+	(1 << 18) - 1, (1 << 19) - 1, (1 << 20) - 1, (1 << 21) - 1,
+	(1 << 22) - 1, (1 << 23) - 1, (1 << 24) - 1, (1 << 25) - 1,
+	(1 << 26) - 1, (1 << 27) - 1,
+};
+
+
 /**
  * @brief The f function as defined in LSB encoding for 8-bit fields
  *
@@ -122,6 +122,15 @@ struct rohc_interval32
 };
 
 
+/*
+ * Pre-computed shift parameters for the fields whose shift parameter depends
+ * on the number k of transmitted bits, indexed by k
+ */
+
+extern const int32_t rohc_interval_p_rtp_ts[32 + 1];
+extern const int32_t rohc_interval_p_rtp_sn[32 + 1];
+
+
 /*
  * Public function prototypes:
  */
@@ -159,54 +168,22 @@ static inline int32_t rohc_interval_compute_p(const size_t k,
 {
 	int32_t computed_p;
 
-	/* determine the real p value to use */
-	switch(p)
+	assert(k <= 32);
+	assert(p != ROHC_LSB_SHIFT_VAR);
+
+	/* determine the real p value to use: most fields use the given p value,
+	 * the others get it from the table of their field family */
+	if(p == ROHC_LSB_SHIFT_RTP_TS)
+	{
+		computed_p = rohc_interval_p_rtp_ts[k];
+	}
+	else if(p == ROHC_LSB_SHIFT_RTP_SN || p == ROHC_LSB_SHIFT_ESP_SN)
+	{
+		computed_p = rohc_interval_p_rtp_sn[k];
+	}
+	else
 	{
-		case ROHC_LSB_SHIFT_RTP_TS: /* special computation for RTP TS encoding */
-		{
-			if(k <= 2)
-			{
-				computed_p = 0;
-			}
-			else
-			{
-				computed_p = (1 << (k - 2)) - 1;
-			}
-		}
-		break;
-
-		/* special computation for RTP and ESP SN encoding */
-		case ROHC_LSB_SHIFT_RTP_SN:
-		case ROHC_LSB_SHIFT_ESP_SN:
-		{
-			if(k <= 4)
-			{
-				computed_p = 1;
-			}
-			else
-			{
-				computed_p = (1 << (k - 5)) - 1;
-			}
-		}
-		break;
-
-		case ROHC_LSB_SHIFT_VAR:
-			assert(0); /* should not happen */
-			computed_p = p;
-			break;
-
-		case ROHC_LSB_SHIFT_SN:
-		case ROHC_LSB_SHIFT_IP_ID:
-		case ROHC_LSB_SHIFT_TCP_TTL:
-		case ROHC_LSB_SHIFT_TCP_SN:
-		case ROHC_LSB_SHIFT_TCP_SEQ_SCALED:
-		case ROHC_LSB_SHIFT_TCP_WINDOW:
-		case ROHC_LSB_SHIFT_TCP_TS_3B:
-		case ROHC_LSB_SHIFT_TCP_TS_4B:
-		default: /* otherwise: use the p value given as parameter */
-		{
-			computed_p = p;
-		}
+		computed_p = p;
 	}
 
 	return computed_p;
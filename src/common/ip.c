@@ -362,19 +362,10 @@ unsigned short ip_get_extension_size(const uint8_t *const ext)
  */
 unsigned short ip_get_total_extension_size(const struct ip_packet *const ip)
 {
-	uint8_t *ext;
-	uint8_t next_hdr_type;
-	unsigned short total_ext_size = 0;
-
-	/* TODO: not very performant */
-	ext = ip_get_next_ext_from_ip(ip, &next_hdr_type);
-	while(ext != NULL)
-	{
-		total_ext_size += ip_get_extension_size(ext);
-		ext = ip_get_next_ext_from_ext(ext, &next_hdr_type);
-	}
-
-	return total_ext_size;
+	/* the extension headers were walked once when the packet was created:
+	 * they lie between the next header and the next layer (both are equal
+	 * for IPv4 and both are NULL for malformed packets) */
+	return (ip->nl.data - ip->nh.data);
 }
 
 
@@ -1051,8 +1042,7 @@ error:
 static bool ext_get_next_layer(const struct net_hdr *const nh,
                                struct net_hdr *const nl)
 {
-	uint8_t ext_types_count[ROHC_IPPROTO_MAX + 1] = { 0 };
-	unsigned int ext_type;
+	uint8_t ext_types[IP_MAX_EXTS];
 	size_t remain_len = nh->len;
 	size_t ext_nr = 0;
 
@@ -1063,11 +1053,28 @@ static bool ext_get_next_layer(const struct net_hdr *const nh,
 	/* parse packet until all extension headers are parsed */
 	while(rohc_is_ipv6_opt(nl->proto))
 	{
-		if(ext_types_count[nl->proto] >= 255)
+		size_t same_type_nr = 0;
+		size_t i;
+
+		/* RFC 2460 §4.1 reads:
+		 *   Each extension header should occur at most once, except for the
+		 *   Destination Options header which should occur at most twice (once
+		 *   before a Routing header and once before the upper-layer header).
+		 * So a longer chain necessarily repeats one extension type too much. */
+		if(ext_nr >= IP_MAX_EXTS)
 		{
 			return false;
 		}
-		ext_types_count[nl->proto]++;
+		for(i = 0; i < ext_nr; i++)
+		{
+			same_type_nr += (ext_types[i] == nl->proto);
+		}
+		if((nl->proto == ROHC_IPPROTO_DSTOPTS && same_type_nr >= 2) ||
+		   (nl->proto != ROHC_IPPROTO_DSTOPTS && same_type_nr >= 1))
+		{
+			return false;
+		}
+		ext_types[ext_nr] = nl->proto;
 		ext_nr++;
 
 		/* RFC 2460 §4 reads:
@@ -1087,19 +1094,6 @@ static bool ext_get_next_layer(const struct net_hdr *const nh,
 	}
 	nl->len = remain_len;
 
-	/* RFC 2460 §4.1 reads:
-	 *   Each extension header should occur at most once, except for the Destination
-	 *   Options header which should occur at most twice (once before a Routing
-	 *   header and once before the upper-layer header). */
-	for(ext_type = 0; ext_type <= ROHC_IPPROTO_MAX; ext_type++)
-	{
-		if((ext_type == ROHC_IPPROTO_DSTOPTS && ext_types_count[ext_type] > 2) ||
-		   (ext_type != ROHC_IPPROTO_DSTOPTS && ext_types_count[ext_type] > 1))
-		{
-			return false;
-		}
-	}
-
 	return true;
 }
 
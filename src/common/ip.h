@@ -34,8 +34,10 @@
 #include <stdint.h>
 #ifdef __KERNEL__
 #  include <linux/types.h>
+#  include <linux/string.h>
 #else
 #  include <stdbool.h>
+#  include <string.h>
 #endif
 
 
@@ -65,6 +67,15 @@ typedef enum
 } ip_version;
 
 
+/**
+ * @brief The maximum number of extension headers in a well-formed IPv6 chain
+ *
+ * Every one of the 9 known extension types may occur once, except the
+ * Destination Options header that may occur twice (RFC 2460 §4.1).
+ */
+#define IP_MAX_EXTS  10U
+
+
 /** A network header */
 struct net_hdr
 {
@@ -180,99 +191,44 @@ static inline uint16_t ip_fast_csum(const uint8_t *iph,
 
 #else
 
-static inline uint16_t from32to16(const uint32_t x)
-	__attribute__((warn_unused_result, const));
-
-static inline uint16_t from32to16(const uint32_t x)
-{
-	uint32_t y;
-	/* add up 16-bit and 16-bit for 16+c bit */
-	y = (x & 0xffff) + (x >> 16);
-	/* add up carry.. */
-	y = (y & 0xffff) + (y >> 16);
-	return y;
-}
-
 static inline uint16_t ip_fast_csum(const uint8_t *const iph,
                                     const size_t ihl)
 	__attribute__((nonnull(1), warn_unused_result, pure));
 
 /**
- *  This is a version of ip_compute_csum() optimized for IP headers,
- *  which always checksum on 4 octet boundaries.
+ * @brief This is a version of ip_compute_csum() optimized for IP headers,
+ *        which always checksum on 4 octet boundaries.
+ *
+ * The 32-bit words are added in a 64-bit accumulator, so that carries never
+ * need to be handled in the loop, and they are loaded with memcpy() so that
+ * unaligned IP headers are correctly handled on all architectures. The
+ * one's complement sum being independent of the byte order, the result may
+ * be stored in the header as is.
+ *
+ * @param iph The IPv4 header
+ * @param ihl The length of the IPv4 header (in 32-bit words)
+ * @return    The IPv4 checksum
  */
 static inline uint16_t ip_fast_csum(const uint8_t *const iph,
                                     const size_t ihl)
 {
-	const uint8_t *buff = iph;
-	size_t len = ihl * 4;
-	bool odd;
-	size_t count;
-	uint32_t result = 0;
+	uint64_t sum = 0;
+	size_t i;
 
-	if(len == 0)
-	{
-		goto out;
-	}
-	odd = 1 & (uintptr_t) buff;
-	if(odd)
-	{
-#ifdef __LITTLE_ENDIAN
-		result = *buff;
-#else
-		result += (*buff << 8);
-#endif
-		len--;
-		buff++;
-	}
-	count = len >> 1; /* nr of 16-bit words.. */
-	if(count)
+	for(i = 0; i < ihl; i++)
 	{
-		if(2 & (uintptr_t) buff)
-		{
-			result += *(uint16_t *) buff;
-			count--;
-			len -= 2;
-			buff += 2;
-		}
-		count >>= 1; /* nr of 32-bit words.. */
-		if(count)
-		{
-			uint32_t carry = 0;
-			do
-			{
-				uint32_t word = *(uint32_t *) buff;
-				count--;
-				buff += sizeof(uint32_t);
-				result += carry;
-				result += word;
-				carry = (word > result);
-			}
-			while(count);
-			result += carry;
-			result = (result & 0xffff) + (result >> 16);
-		}
-		if(len & 2)
-		{
-			result += *(uint16_t *) buff;
-			buff += 2;
-		}
+		uint32_t word;
+		memcpy(&word, iph + i * sizeof(uint32_t), sizeof(uint32_t));
+		sum += word;
 	}
-	if(len & 1)
-	{
-#ifdef __LITTLE_ENDIAN
-		result += *buff;
-#else
-		result += (*buff << 8);
-#endif
-	}
-	result = from32to16(result);
-	if(odd)
-	{
-		result = ((result >> 8) & 0xff) | ((result & 0xff) << 8);
-	}
-out:
-	return ~result;
+
+	/* fold the 64-bit sum into 16 bits */
+	sum = (sum & 0xffffffff) + (sum >> 32);
+	sum = (sum & 0xffffffff) + (sum >> 32);
+	sum = (sum & 0xffff) + (sum >> 16);
+	sum = (sum & 0xffff) + (sum >> 16);
+
+	return (uint16_t) ~sum;
 }
 
 
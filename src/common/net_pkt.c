@@ -26,16 +26,45 @@
 #include "net_pkt.h"
 
 #include "protocols/ip_numbers.h"
+#include "protocols/ip.h"
 #include "rohc_traces_internal.h"
 
 
+static void net_pkt_compute_keys(struct net_pkt *const packet)
+	__attribute__((nonnull(1)));
+
+static rohc_ctxt_key_t net_pkt_hash_final(uint32_t hash)
+	__attribute__((warn_unused_result, const));
+
+static bool net_pkt_has_ports_or_spi(const struct net_pkt *const packet)
+	__attribute__((warn_unused_result, nonnull(1), pure));
+
+static void net_pkt_build_flow(struct net_pkt *const packet)
+	__attribute__((nonnull(1)));
+
+static size_t net_pkt_pack_ip(uint8_t *const data,
+                              const struct ip_packet *const ip)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
+static uint32_t net_pkt_hash_ip(uint32_t hash,
+                                const struct ip_packet *const ip)
+	__attribute__((warn_unused_result, nonnull(2), pure));
+
+static inline uint32_t net_pkt_hash_word(const uint32_t hash,
+                                         const uint32_t word)
+	__attribute__((warn_unused_result, const));
+
+
 /**
  * @brief Parse a network packet
  *
  * @param[out] packet    The parsed packet
  * @param data           The data to parse
+ * @param[out] hdrs      The storage for the description of all the headers,
+ *                       NULL not to describe them
  * @param trace_cb       The function to call for printing traces
  * @param trace_cb_priv  An optional private context, may be NULL
+ * @param trace_level    The lowest level of the traces to print
  * @param trace_entity   The entity that emits the traces
  * @return               true if the packet was successfully parsed,
  *                       false if a problem occurred (a malformed packet is
@@ -43,18 +72,26 @@
  */
 bool net_pkt_parse(struct net_pkt *const packet,
                    const struct rohc_buf data,
+                   struct net_pkt_hdrs *const hdrs,
                    rohc_trace_callback2_t trace_cb,
                    void *const trace_cb_priv,
+                   const rohc_trace_level_t trace_level,
                    rohc_trace_entity_t trace_entity)
 {
 	packet->data = rohc_buf_data(data);
 	packet->len = data.len;
 	packet->ip_hdr_nr = 0;
+	packet->hdrs = NULL;
 	packet->key = 0;
+	packet->ip_key = 0;
+	packet->hosts_key = 0;
+	packet->flow.len = 0;
+	packet->flow.ip_len = 0;
 
 	/* traces */
 	packet->trace_callback = trace_cb;
 	packet->trace_callback_priv = trace_cb_priv;
+	packet->trace_level = trace_level;
 
 	/* create the outer IP packet from raw data */
 	if(!ip_create(&packet->outer_ip, rohc_buf_data(data), data.len))
@@ -81,26 +118,6 @@ bool net_pkt_parse(struct net_pkt *const packet,
 		}
 	}
 
-	/* build the hash key for the packet */
-	if(ip_get_version(&packet->outer_ip) == IPV4)
-	{
-		packet->key ^= ipv4_get_saddr(&packet->outer_ip);
-		packet->key ^= ipv4_get_daddr(&packet->outer_ip);
-	}
-	else if(ip_get_version(&packet->outer_ip) == IPV6)
-	{
-		const struct ipv6_addr *const saddr = ipv6_get_saddr(&packet->outer_ip);
-		const struct ipv6_addr *const daddr = ipv6_get_daddr(&packet->outer_ip);
-		packet->key ^= saddr->u32[0];
-		packet->key ^= saddr->u32[1];
-		packet->key ^= saddr->u32[2];
-		packet->key ^= saddr->u32[3];
-		packet->key ^= daddr->u32[0];
-		packet->key ^= daddr->u32[1];
-		packet->key ^= daddr->u32[2];
-		packet->key ^= daddr->u32[3];
-	}
-
 	/* get the transport protocol */
 	packet->transport = &packet->outer_ip.nl;
 
@@ -136,6 +153,17 @@ bool net_pkt_parse(struct net_pkt *const packet,
 		packet->transport = &packet->inner_ip.nl;
 	}
 
+	/* describe all the headers once for the profiles */
+	if(hdrs != NULL)
+	{
+		net_pkt_parse_hdrs(hdrs, packet->outer_ip.data, packet->outer_ip.size);
+		packet->hdrs = hdrs;
+	}
+
+	/* build the hash keys and the identity of the flow of the packet */
+	net_pkt_compute_keys(packet);
+	net_pkt_build_flow(packet);
+
 	return true;
 
 error:
@@ -171,3 +199,382 @@ size_t net_pkt_get_payload_offset(const struct net_pkt *const packet)
 	return payload_offset;
 }
 
+
+/**
+ * @brief Describe the IP headers, their extensions and the transport header
+ *
+ * The headers are walked once: the IP headers while they tunnel another IP
+ * header, and the IPv6 extension headers of every IPv6 header. The walk stops
+ * at the first truncated or malformed header, and beyond the limits of
+ * \e ROHC_TCP_MAX_IP_HDRS IP headers and \e ROHC_TCP_MAX_IP_EXT_HDRS
+ * extension headers per IP header; the description is incomplete then.
+ *
+ * The walk never reads beyond the given length, so it may describe the
+ * headers at the beginning of a packet split in several buffers.
+ *
+ * @param[out] hdrs  The description of the headers
+ * @param data       The outer IP header
+ * @param len        The length (in bytes) of the outer IP header and its payload
+ */
+void net_pkt_parse_hdrs(struct net_pkt_hdrs *const hdrs,
+                        const uint8_t *const data,
+                        const size_t len)
+{
+	const uint8_t *remain_data = data;
+	size_t remain_len = len;
+	uint8_t next_proto;
+
+	hdrs->is_complete = false;
+	hdrs->transport_proto = 0;
+	hdrs->ip_nr = 0;
+	hdrs->transport = NULL;
+	hdrs->transport_len = 0;
+
+	if(remain_data == NULL)
+	{
+		goto incomplete;
+	}
+
+	do
+	{
+		struct net_pkt_ip *const ip = &(hdrs->ip[hdrs->ip_nr]);
+
+		if(remain_len < sizeof(struct ip_hdr))
+		{
+			goto incomplete;
+		}
+		ip->data = remain_data;
+		ip->len = remain_len;
+		ip->version = ((const struct ip_hdr *) remain_data)->version;
+		ip->exts_nr = 0;
+		ip->exts_len = 0;
+
+		if(ip->version == IPV4)
+		{
+			const struct ipv4_hdr *const ipv4 = (struct ipv4_hdr *) remain_data;
+
+			if(remain_len < sizeof(struct ipv4_hdr))
+			{
+				goto incomplete;
+			}
+			ip->hdr_len = ipv4->ihl * sizeof(uint32_t);
+			if(ip->hdr_len < sizeof(struct ipv4_hdr) || remain_len < ip->hdr_len)
+			{
+				goto incomplete;
+			}
+			next_proto = ipv4->protocol;
+			remain_data += ip->hdr_len;
+			remain_len -= ip->hdr_len;
+		}
+		else if(ip->version == IPV6)
+		{
+			const struct ipv6_hdr *const ipv6 = (struct ipv6_hdr *) remain_data;
+
+			if(remain_len < sizeof(struct ipv6_hdr))
+			{
+				goto incomplete;
+			}
+			ip->hdr_len = sizeof(struct ipv6_hdr);
+			next_proto = ipv6->nh;
+			remain_data += ip->hdr_len;
+			remain_len -= ip->hdr_len;
+
+			while(rohc_is_ipv6_opt(next_proto))
+			{
+				const struct ipv6_opt *const opt = (struct ipv6_opt *) remain_data;
+				struct net_pkt_ext *const ext = &(ip->exts[ip->exts_nr]);
+
+				if(ip->exts_nr >= ROHC_TCP_MAX_IP_EXT_HDRS ||
+				   remain_len < 2 || remain_len < ipv6_opt_get_length(opt))
+				{
+					goto incomplete;
+				}
+				ext->offset = ip->hdr_len + ip->exts_len;
+				ext->len = ipv6_opt_get_length(opt);
+				ext->type = next_proto;
+				next_proto = opt->next_header;
+				remain_data += ext->len;
+				remain_len -= ext->len;
+				ip->exts_len += ext->len;
+				ip->exts_nr++;
+			}
+		}
+		else
+		{
+			goto incomplete;
+		}
+		ip->next_proto = next_proto;
+		hdrs->ip_nr++;
+	}
+	while(rohc_is_tunneling(next_proto) && hdrs->ip_nr < ROHC_TCP_MAX_IP_HDRS);
+
+	if(rohc_is_tunneling(next_proto))
+	{
+		goto incomplete;
+	}
+
+	hdrs->is_complete = true;
+	hdrs->transport_proto = next_proto;
+	hdrs->transport = remain_data;
+	hdrs->transport_len = remain_len;
+
+incomplete:
+	return;
+}
+
+
+/**
+ * @brief Compute the keys that help finding the context of a packet
+ *
+ * The profiles do not compare the same fields to find the context of a
+ * packet, so the packet gets one key per set of fields (see
+ * \ref net_pkt::key, \ref net_pkt::ip_key and \ref net_pkt::hosts_key):
+ * two packets that one profile gives to the same context shall always get
+ * the same key for this profile.
+ *
+ * The key of the flow is not symmetric, so both directions of one flow get
+ * different keys. The ports are not hashed for IP fragments, because only
+ * the first fragment transports them: all the fragments of one flow shall
+ * get the same key.
+ *
+ * @param packet  The parsed packet to compute the keys for
+ */
+static void net_pkt_compute_keys(struct net_pkt *const packet)
+{
+	const struct net_hdr *const transport = packet->transport;
+	uint32_t hash = 0;
+
+	/* the outer IP addresses in any order */
+	if(ip_get_version(&packet->outer_ip) == IPV4)
+	{
+		packet->hosts_key = ipv4_get_saddr(&packet->outer_ip) ^
+		                    ipv4_get_daddr(&packet->outer_ip);
+	}
+	else if(ip_get_version(&packet->outer_ip) == IPV6)
+	{
+		const struct ipv6_addr *const saddr = ipv6_get_saddr(&packet->outer_ip);
+		const struct ipv6_addr *const daddr = ipv6_get_daddr(&packet->outer_ip);
+		size_t i;
+
+		for(i = 0; i < 4; i++)
+		{
+			packet->hosts_key ^= saddr->u32[i] ^ daddr->u32[i];
+		}
+	}
+
+	/* the addresses of all the IP headers and the transport protocol */
+	hash = net_pkt_hash_ip(hash, &packet->outer_ip);
+	if(packet->ip_hdr_nr > 1)
+	{
+		hash = net_pkt_hash_ip(hash, &packet->inner_ip);
+	}
+	hash = net_pkt_hash_word(hash, transport->proto);
+	packet->ip_key = net_pkt_hash_final(hash);
+
+	/* the 2 ports or the SPI are the first 4 bytes of the header */
+	if(net_pkt_has_ports_or_spi(packet))
+	{
+		const uint32_t ports_or_spi =
+			(((uint32_t) transport->data[0]) << 24) |
+			(((uint32_t) transport->data[1]) << 16) |
+			(((uint32_t) transport->data[2]) << 8) |
+			((uint32_t) transport->data[3]);
+		hash = net_pkt_hash_word(hash, ports_or_spi);
+		packet->key = net_pkt_hash_final(hash);
+	}
+	else
+	{
+		packet->key = packet->ip_key;
+	}
+}
+
+
+/**
+ * @brief Spread the bits of the given hash over the whole key
+ *
+ * The final avalanche of bits of MurmurHash3.
+ *
+ * @param hash  The hash of all the words
+ * @return      The key
+ */
+static rohc_ctxt_key_t net_pkt_hash_final(uint32_t hash)
+{
+	hash ^= hash >> 16;
+	hash *= 0x85ebca6bU;
+	hash ^= hash >> 13;
+	hash *= 0xc2b2ae35U;
+	hash ^= hash >> 16;
+
+	return hash;
+}
+
+
+/**
+ * @brief Whether the ports or the SPI identify the flow of the packet
+ *
+ * The 2 ports of UDP, UDP-Lite and TCP or the SPI of ESP are the first 4 bytes
+ * of the transport header. They are ignored for IP fragments, because only the
+ * first fragment transports them.
+ *
+ * @param packet  The parsed packet
+ * @return        true if the first 4 bytes of the transport header identify
+ *                the flow, false otherwise
+ */
+static bool net_pkt_has_ports_or_spi(const struct net_pkt *const packet)
+{
+	const struct net_hdr *const transport = packet->transport;
+
+	if(transport->data == NULL || transport->len < sizeof(uint32_t))
+	{
+		return false;
+	}
+
+	switch(transport->proto)
+	{
+		case ROHC_IPPROTO_UDP:
+		case ROHC_IPPROTO_UDPLITE:
+		case ROHC_IPPROTO_TCP:
+		case ROHC_IPPROTO_ESP:
+			return (!ip_is_fragment(&packet->outer_ip) &&
+			        (packet->ip_hdr_nr <= 1 ||
+			         !ip_is_fragment(&packet->inner_ip)));
+		default:
+			return false;
+	}
+}
+
+
+/**
+ * @brief Build the identity of the flow of the packet
+ *
+ * @param packet  The parsed packet to build the flow identity for
+ *
+ * @see net_pkt_flow
+ */
+static void net_pkt_build_flow(struct net_pkt *const packet)
+{
+	struct net_pkt_flow *const flow = &packet->flow;
+	size_t len;
+
+	len = net_pkt_pack_ip(flow->data, &packet->outer_ip);
+	if(packet->ip_hdr_nr > 1)
+	{
+		len += net_pkt_pack_ip(flow->data + len, &packet->inner_ip);
+	}
+	flow->ip_len = len;
+
+	if(net_pkt_has_ports_or_spi(packet))
+	{
+		memcpy(flow->data + len, packet->transport->data, sizeof(uint32_t));
+		len += sizeof(uint32_t);
+	}
+	flow->len = len;
+}
+
+
+/**
+ * @brief Pack the fields that identify the flow in the given IP header
+ *
+ * @param[out] data  The buffer to pack the fields in
+ * @param ip         The IP header to pack the fields of
+ * @return           The length (in bytes) of the packed fields
+ */
+static size_t net_pkt_pack_ip(uint8_t *const data,
+                              const struct ip_packet *const ip)
+{
+	const ip_version version = ip_get_version(ip);
+	size_t len = 0;
+
+	data[len] = version;
+	len++;
+
+	if(version == IPV4)
+	{
+		memcpy(data + len, &ip->header.v4.saddr, sizeof(uint32_t));
+		len += sizeof(uint32_t);
+		memcpy(data + len, &ip->header.v4.daddr, sizeof(uint32_t));
+		len += sizeof(uint32_t);
+		data[len] = ip->nl.proto;
+		len++;
+	}
+	else if(version == IPV6)
+	{
+		const uint32_t flow_label = ip_get_flow_label(ip);
+
+		memcpy(data + len, &ip->header.v6.saddr, sizeof(struct ipv6_addr));
+		len += sizeof(struct ipv6_addr);
+		memcpy(data + len, &ip->header.v6.daddr, sizeof(struct ipv6_addr));
+		len += sizeof(struct ipv6_addr);
+		data[len] = (flow_label >> 16) & 0xff;
+		data[len + 1] = (flow_label >> 8) & 0xff;
+		data[len + 2] = flow_label & 0xff;
+		len += 3;
+		data[len] = ip->nl.proto;
+		len++;
+	}
+
+	return len;
+}
+
+
+/**
+ * @brief Hash the addresses of the given IP header
+ *
+ * Malformed and unknown IP headers are ignored.
+ *
+ * @param hash  The current hash
+ * @param ip    The IP header to hash the addresses of
+ * @return      The updated hash
+ */
+static uint32_t net_pkt_hash_ip(uint32_t hash,
+                                const struct ip_packet *const ip)
+{
+	if(ip_get_version(ip) == IPV4)
+	{
+		hash = net_pkt_hash_word(hash, ipv4_get_saddr(ip));
+		hash = net_pkt_hash_word(hash, ipv4_get_daddr(ip));
+	}
+	else if(ip_get_version(ip) == IPV6)
+	{
+		const struct ipv6_addr *const saddr = ipv6_get_saddr(ip);
+		const struct ipv6_addr *const daddr = ipv6_get_daddr(ip);
+		size_t i;
+
+		for(i = 0; i < 4; i++)
+		{
+			hash = net_pkt_hash_word(hash, saddr->u32[i]);
+		}
+		for(i = 0; i < 4; i++)
+		{
+			hash = net_pkt_hash_word(hash, daddr->u32[i]);
+		}
+	}
+
+	return hash;
+}
+
+
+/**
+ * @brief Mix one 32-bit word into the given hash
+ *
+ * The mixing step of MurmurHash3: the order of the words matters, so that
+ * swapping the source and destination addresses changes the hash.
+ *
+ * @param hash  The current hash
+ * @param word  The word to mix into the hash
+ * @return      The updated hash
+ */
+static inline uint32_t net_pkt_hash_word(const uint32_t hash,
+                                         const uint32_t word)
+{
+	uint32_t k = word * 0xcc9e2d51U;
+	uint32_t h;
+
+	k = (k << 15) | (k >> 17);
+	k *= 0x1b873593U;
+
+	h = hash ^ k;
+	h = (h << 13) | (h >> 19);
+
+	return (h * 5U + 0xe6546b64U);
+}
@@ -28,6 +28,7 @@
 
 #include <rohc/rohc_buf.h>
 #include "ip.h"
+#include "protocols/tcp.h" /* for ROHC_TCP_MAX_IP_HDRS and ROHC_TCP_MAX_IP_EXT_HDRS */
 #include "rohc_traces.h"
 
 
@@ -35,6 +36,82 @@
 typedef uint32_t rohc_ctxt_key_t;
 
 
+/**
+ * @brief The maximum length of the identity of a flow
+ *
+ * Version, addresses, IPv6 Flow Label and next protocol of two IP headers,
+ * then ports or SPI.
+ */
+#define NET_PKT_FLOW_MAX_LEN  (2U * (1U + 32U + 3U + 1U) + 4U)
+
+/**
+ * @brief The identity of the flow of a network packet
+ *
+ * The fields that identify the flow the packet belongs to are packed
+ * canonically, so that two packets of the same flow get byte-identical
+ * identities: the version, the addresses, the IPv6 Flow Label and the next
+ * protocol of the outer and inner IP headers, then the ports of UDP, UDP-Lite
+ * and TCP or the SPI of ESP. The ports and the SPI are omitted for IP
+ * fragments as for \ref net_pkt::key.
+ */
+struct net_pkt_flow
+{
+	uint8_t len;     /**< The length (in bytes) of the identity, 0 if none */
+	uint8_t ip_len;  /**< The length (in bytes) of the IP part of the identity */
+	uint8_t data[NET_PKT_FLOW_MAX_LEN];  /**< The packed identity */
+};
+
+
+/** One IPv6 extension header of a parsed network packet */
+struct net_pkt_ext
+{
+	uint16_t offset;  /**< The offset (in bytes) from the beginning of its IP header */
+	uint16_t len;     /**< The length (in bytes) of the extension header */
+	uint8_t type;     /**< The protocol type of the extension header */
+};
+
+
+/** One IP header of a parsed network packet, with its extension headers */
+struct net_pkt_ip
+{
+	const uint8_t *data;  /**< The beginning of the IP header */
+	size_t len;           /**< The length (in bytes) of the IP header and its payload */
+	uint16_t hdr_len;     /**< The length (in bytes) of the IP header, extensions excluded */
+	uint16_t exts_len;    /**< The length (in bytes) of all the extension headers */
+	uint8_t version;      /**< The version of the IP header */
+	uint8_t next_proto;   /**< The protocol type after the extension headers */
+	uint8_t exts_nr;      /**< The number of IPv6 extension headers */
+	/** The IPv6 extension headers */
+	struct net_pkt_ext exts[ROHC_TCP_MAX_IP_EXT_HDRS];
+};
+
+
+/**
+ * @brief The headers of a network packet, parsed once
+ *
+ * The IP headers, their IPv6 extension headers and the location of the
+ * transport header are described while the packet is parsed, so that the
+ * profiles read them instead of parsing the packet again.
+ *
+ * The description is too large for the stack, so it is stored by the caller
+ * of \ref net_pkt_parse, eg. once per compressor.
+ */
+struct net_pkt_hdrs
+{
+	/** Whether all the headers up to the transport header were described:
+	 *  false if one header is truncated or malformed, if the IP version is
+	 *  unknown, or if there are more IP headers or extension headers than
+	 *  described here */
+	bool is_complete;
+	uint8_t transport_proto;   /**< The protocol of the transport header */
+	size_t ip_nr;              /**< The number of described IP headers */
+	const uint8_t *transport;  /**< The transport header if complete */
+	size_t transport_len;      /**< The length (in bytes) of the transport data */
+	/** The IP headers */
+	struct net_pkt_ip ip[ROHC_TCP_MAX_IP_HDRS];
+};
+
+
 /** One network packet */
 struct net_pkt
 {
@@ -47,24 +124,100 @@ struct net_pkt
 
 	struct net_hdr *transport;   /**< The transport layer of the packet if any */
 
-	rohc_ctxt_key_t key;         /**< The hash key of the packet */
+	/** All the headers described in one pass, NULL if not described */
+	const struct net_pkt_hdrs *hdrs;
+
+	/** The hash key of the flow of the packet: the addresses of all the IP
+	 *  headers, the transport protocol, and the ports or the SPI if any */
+	rohc_ctxt_key_t key;
+	/** The hash key of the IP headers of the packet: the addresses of all
+	 *  the IP headers and the transport protocol */
+	rohc_ctxt_key_t ip_key;
+	/** The key of the hosts of the packet: the outer IP addresses XOR'ed,
+	 *  so that both directions between two hosts get the same key */
+	rohc_ctxt_key_t hosts_key;
+	struct net_pkt_flow flow;    /**< The identity of the flow of the packet */
 
 	/** The callback function used to manage traces */
 	rohc_trace_callback2_t trace_callback;
 	/** The private context of the callback function used to manage traces */
 	void *trace_callback_priv;
+	/** The lowest level of the traces passed to the callback function */
+	rohc_trace_level_t trace_level;
 };
 
 
 bool net_pkt_parse(struct net_pkt *const packet,
                    const struct rohc_buf data,
+                   struct net_pkt_hdrs *const hdrs,
                    rohc_trace_callback2_t trace_cb,
                    void *const trace_cb_priv,
+                   const rohc_trace_level_t trace_level,
                    rohc_trace_entity_t trace_entity)
 	__attribute__((warn_unused_result, nonnull(1)));
 
+void net_pkt_parse_hdrs(struct net_pkt_hdrs *const hdrs,
+                        const uint8_t *const data,
+                        const size_t len)
+	__attribute__((nonnull(1)));
+
 size_t net_pkt_get_payload_offset(const struct net_pkt *const packet)
 	__attribute__((warn_unused_result, nonnull(1)));
 
+
+/**
+ * @brief Get the description of one IP header of the given packet
+ *
+ * @param packet  The parsed packet
+ * @param pos     The position of the IP header, 0 for the outer one
+ * @return        The description of the IP header with all its extension
+ *                headers, NULL if the IP header was not described
+ */
+static inline const struct net_pkt_ip * net_pkt_get_ip_desc(const struct net_pkt *const packet,
+                                                             const size_t pos)
+{
+	if(packet->hdrs == NULL || pos >= packet->hdrs->ip_nr)
+	{
+		return NULL;
+	}
+	return &(packet->hdrs->ip[pos]);
+}
+
+
+/**
+ * @brief Whether two flow identities are the same
+ *
+ * One comparison of the lengths and of the packed fields at once.
+ *
+ * @param flow1  The first flow identity
+ * @param flow2  The second flow identity
+ * @return       true if both identities are the same and not empty,
+ *               false otherwise
+ */
+static inline bool net_pkt_flow_is_same(const struct net_pkt_flow *const flow1,
+                                        const struct net_pkt_flow *const flow2)
+{
+	return (flow1->len != 0 &&
+	        memcmp(flow1, flow2, 2 + flow1->len) == 0);
+}
+
+
+/**
+ * @brief Whether the IP parts of two flow identities are the same
+ *
+ * The ports and the SPI are ignored.
+ *
+ * @param flow1  The first flow identity
+ * @param flow2  The second flow identity
+ * @return       true if the IP parts of both identities are the same and not
+ *               empty, false otherwise
+ */
+static inline bool net_pkt_flow_is_same_ip(const struct net_pkt_flow *const flow1,
+                                           const struct net_pkt_flow *const flow2)
+{
+	return (flow1->ip_len != 0 &&
+	        memcmp(&flow1->ip_len, &flow2->ip_len, 1 + flow1->ip_len) == 0);
+}
+
 #endif
 
@@ -32,10 +32,10 @@
 #include <stdint.h>
 #include <assert.h>
 
+#include "config.h" /* for WORDS_BIGENDIAN and ROHC_SMALL_CONTEXTS */
+#include "rohc_bit_ops.h" /* for ROHC_BIT_FORMAT */
 #ifdef __KERNEL__
 #  include <endian.h>
-#else
-#  include "config.h" /* for WORDS_BIGENDIAN */
 #endif
 
 
@@ -53,18 +53,28 @@
  * @brief The maximum number of IP headers supported by the TCP profile
  *
  * The limit value was chosen arbitrarily. It should handle most real-life case
- * without hurting performances nor memory footprint.
+ * without hurting performances nor memory footprint. Small contexts handle
+ * one IP tunnel at most.
  */
-#define ROHC_TCP_MAX_IP_HDRS        10U
+#if ROHC_SMALL_CONTEXTS == 1
+#  define ROHC_TCP_MAX_IP_HDRS       2U
+#else
+#  define ROHC_TCP_MAX_IP_HDRS      10U
+#endif
 
 
 /**
  * @brief The maximum number of IP extension header supported by the TCP profile
  *
  * The limit value was chosen arbitrarily. It should handle most real-life case
- * without hurting performances nor memory footprint.
+ * without hurting performances nor memory footprint. Every extension header
+ * takes up to 2 KB in the TCP contexts, small contexts handle 4 of them.
  */
-#define ROHC_TCP_MAX_IP_EXT_HDRS    20U
+#if ROHC_SMALL_CONTEXTS == 1
+#  define ROHC_TCP_MAX_IP_EXT_HDRS   4U
+#else
+#  define ROHC_TCP_MAX_IP_EXT_HDRS  20U
+#endif
 
 
 /**
@@ -557,25 +567,14 @@ typedef struct
  * Send LSBs of sequence number
  * See RFC4996 page 81
  */
-typedef struct
-{
-#if WORDS_BIGENDIAN == 1
-	uint8_t discriminator:6;    /**< '101110'                               [  6 ] */
-	uint8_t seq_num1:2;         /**< lsb(18, 65535)                         [ 18 ] */
-	uint16_t seq_num2;          /**< sequel of \e seq_num1                  [  - ] */
-	uint8_t msn:4;              /**< lsb(4, 4)                              [  4 ] */
-	uint8_t psh_flag:1;         /**< irregular(1)                           [  1 ] */
-	uint8_t header_crc:3;       /**< crc3(THIS.UVALUE, THIS.ULENGTH)        [  3 ] */
-#else
-	uint8_t seq_num1:2;
-	uint8_t discriminator:6;
-	uint16_t seq_num2;
-	uint8_t header_crc:3;
-	uint8_t psh_flag:1;
-	uint8_t msn:4;
-#endif
-	/* irregular chain                                                      [ VARIABLE ] */
-} __attribute__((packed)) rnd_1_t;
+#define RND_1_FIELDS(DISCR, FIELD) \
+	DISCR(0x2e, 6)          /* '101110'                               [  6 ] */ \
+	FIELD(seq_num, 18)      /* lsb(18, 65535)                         [ 18 ] */ \
+	FIELD(msn, 4)           /* lsb(4, 4)                              [  4 ] */ \
+	FIELD(psh_flag, 1)      /* irregular(1)                           [  1 ] */ \
+	FIELD(header_crc, 3)    /* crc3(THIS.UVALUE, THIS.ULENGTH)        [  3 ] */ \
+	                        /* irregular chain                        [ VARIABLE ] */
+ROHC_BIT_FORMAT(rnd_1, RND_1_FIELDS)
 
 
 /**
@@ -584,23 +583,14 @@ typedef struct
  * Send scaled sequence number LSBs
  * See RFC4996 page 81
  */
-typedef struct
-{
-#if WORDS_BIGENDIAN == 1
-	uint8_t discriminator:4;    /**< '1100'                                 [ 4 ] */
-	uint8_t seq_num_scaled:4;   /**< lsb(4, 7)                              [ 4 ] */
-	uint8_t msn:4;              /**< lsb(4, 4)                              [ 4 ] */
-	uint8_t psh_flag:1;         /**< irregular(1)                           [ 1 ] */
-	uint8_t header_crc:3;       /**< crc3(THIS.UVALUE, THIS.ULENGTH)        [ 3 ] */
-#else
-	uint8_t seq_num_scaled:4;
-	uint8_t discriminator:4;
-	uint8_t header_crc:3;
-	uint8_t psh_flag:1;
-	uint8_t msn:4;
-#endif
-	/* irregular chain                                                      [ VARIABLE ] */
-} __attribute__((packed)) rnd_2_t;
+#define RND_2_FIELDS(DISCR, FIELD) \
+	DISCR(0x0c, 4)          /* '1100'                                 [  4 ] */ \
+	FIELD(seq_num_scaled, 4)/* lsb(4, 7)                              [  4 ] */ \
+	FIELD(msn, 4)           /* lsb(4, 4)                              [  4 ] */ \
+	FIELD(psh_flag, 1)      /* irregular(1)                           [  1 ] */ \
+	FIELD(header_crc, 3)    /* crc3(THIS.UVALUE, THIS.ULENGTH)        [  3 ] */ \
+	                        /* irregular chain                        [ VARIABLE ] */
+ROHC_BIT_FORMAT(rnd_2, RND_2_FIELDS)
 
 
 /**
@@ -609,25 +599,14 @@ typedef struct
  * Send acknowledgment number LSBs
  * See RFC4996 page 81
  */
-typedef struct
-{
-#if WORDS_BIGENDIAN == 1
-	uint16_t discriminator:1;   /**< '0'                                    [  4 ] */
-	uint8_t ack_num1:7;         /**< lsb(15, 8191)                          [ 15 ] */
-	uint8_t ack_num2;           /**< sequel of \e ack_num1                  [  - ] */
-	uint8_t msn:4;              /**< lsb(4, 4)                              [  4 ] */
-	uint8_t psh_flag:1;         /**< irregular(1)                           [  1 ] */
-	uint8_t header_crc:3;       /**< crc3(THIS.UVALUE, THIS.ULENGTH)        [  3 ] */
-#else
-	uint8_t ack_num1:7;
-	uint8_t discriminator:1;
-	uint8_t ack_num2:8;
-	uint8_t header_crc:3;
-	uint8_t psh_flag:1;
-	uint8_t msn:4;
-#endif
-	/* irregular chain                                                      [ VARIABLE ] */
-} __attribute__((packed)) rnd_3_t;
+#define RND_3_FIELDS(DISCR, FIELD) \
+	DISCR(0x00, 1)          /* '0'                                    [  1 ] */ \
+	FIELD(ack_num, 15)      /* lsb(15, 8191)                          [ 15 ] */ \
+	FIELD(msn, 4)           /* lsb(4, 4)                              [  4 ] */ \
+	FIELD(psh_flag, 1)      /* irregular(1)                           [  1 ] */ \
+	FIELD(header_crc, 3)    /* crc3(THIS.UVALUE, THIS.ULENGTH)        [  3 ] */ \
+	                        /* irregular chain                        [ VARIABLE ] */
+ROHC_BIT_FORMAT(rnd_3, RND_3_FIELDS)
 
 
 /**
@@ -636,23 +615,14 @@ typedef struct
  * Send acknowlegment number scaled
  * See RFC4996 page 81
  */
-typedef struct
-{
-#if WORDS_BIGENDIAN == 1
-	uint8_t discriminator:4;    /**< '1101'                                 [ 4 ] */
-	uint8_t ack_num_scaled:4;   /**< lsb(4, 3)                              [ 4 ] */
-	uint8_t msn:4;              /**< lsb(4, 4)                              [ 4 ] */
-	uint8_t psh_flag:1;         /**< irregular(1)                           [ 1 ] */
-	uint8_t header_crc:3;       /**< crc3(THIS.UVALUE, THIS.ULENGTH)        [ 3 ] */
-#else
-	uint8_t ack_num_scaled:4;
-	uint8_t discriminator:4;
-	uint8_t header_crc:3;
-	uint8_t psh_flag:1;
-	uint8_t msn:4;
-#endif
-	/* irregular chain                                                      [ VARIABLE ] */
-} __attribute__((packed)) rnd_4_t;
+#define RND_4_FIELDS(DISCR, FIELD) \
+	DISCR(0x0d, 4)          /* '1101'                                 [  4 ] */ \
+	FIELD(ack_num_scaled, 4)/* lsb(4, 3)                              [  4 ] */ \
+	FIELD(msn, 4)           /* lsb(4, 4)                              [  4 ] */ \
+	FIELD(psh_flag, 1)      /* irregular(1)                           [  1 ] */ \
+	FIELD(header_crc, 3)    /* crc3(THIS.UVALUE, THIS.ULENGTH)        [  3 ] */ \
+	                        /* irregular chain                        [ VARIABLE ] */
+ROHC_BIT_FORMAT(rnd_4, RND_4_FIELDS)
 
 
 /**
@@ -661,31 +631,15 @@ typedef struct
  * Send ACK and sequence number
  * See RFC4996 page 82
  */
-typedef struct
-{
-#if WORDS_BIGENDIAN == 1
-	uint8_t discriminator:3;    /**< '100'                                  [  3 ] */
-	uint8_t psh_flag:1;         /**< irregular(1)                           [  1 ] */
-	uint8_t msn:4;              /**< lsb(4, 4)                              [  4 ] */
-	uint32_t header_crc:3;      /**< crc3(THIS.UVALUE, THIS.ULENGTH)        [  3 ] */
-	uint32_t seq_num1:5;        /**< lsb(14, 8191)                          [ 14 ] */
-	uint32_t seq_num2:8;        /**< sequel of \e seq_num1                  [  - ] */
-	uint32_t seq_num3:1;        /**< sequel of \e seq_num1 and \e seq_num2  [  - ] */
-	uint32_t ack_num1:7;        /**< lsb(15, 8191)                          [ 15 ] */
-	uint32_t ack_num2:8;        /**< sequel of \e ack_num1                  [  - ] */
-#else
-	uint8_t msn:4;
-	uint8_t psh_flag:1;
-	uint8_t discriminator:3;
-	uint8_t seq_num1:5;
-	uint8_t header_crc:3;
-	uint8_t seq_num2;
-	uint8_t ack_num1:7;
-	uint8_t seq_num3:1;
-	uint8_t ack_num2;
-#endif
-	/* irregular chain                                                      [ VARIABLE ] */
-} __attribute__((packed)) rnd_5_t;
+#define RND_5_FIELDS(DISCR, FIELD) \
+	DISCR(0x04, 3)          /* '100'                                  [  3 ] */ \
+	FIELD(psh_flag, 1)      /* irregular(1)                           [  1 ] */ \
+	FIELD(msn, 4)           /* lsb(4, 4)                              [  4 ] */ \
+	FIELD(header_crc, 3)    /* crc3(THIS.UVALUE, THIS.ULENGTH)        [  3 ] */ \
+	FIELD(seq_num, 14)      /* lsb(14, 8191)                          [ 14 ] */ \
+	FIELD(ack_num, 15)      /* lsb(15, 8191)                          [ 15 ] */ \
+	                        /* irregular chain                        [ VARIABLE ] */
+ROHC_BIT_FORMAT(rnd_5, RND_5_FIELDS)
 
 
 /**
@@ -694,27 +648,15 @@ typedef struct
  * Send both ACK and scaled sequence number LSBs
  * See RFC4996 page 82
  */
-typedef struct
-{
-#if WORDS_BIGENDIAN == 1
-	uint8_t discriminator:4;    /**< '1010'                                 [ 4 ] */
-	uint8_t header_crc:3;       /**< crc3(THIS.UVALUE, THIS.ULENGTH)        [ 3 ] */
-	uint8_t psh_flag:1;         /**< irregular(1)                           [ 1 ] */
-#else
-	uint8_t psh_flag:1;
-	uint8_t header_crc:3;
-	uint8_t discriminator:4;
-#endif
-	uint16_t ack_num;           /**< lsb(16, 16383)                         [ 16 ] */
-#if WORDS_BIGENDIAN == 1
-	uint8_t msn:4;              /**< lsb(4, 4)                              [ 4 ] */
-	uint8_t seq_num_scaled:4;   /**< lsb(4, 7)                              [ 4 ] */
-#else
-	uint8_t seq_num_scaled:4;
-	uint8_t msn:4;
-#endif
-	/* irregular chain                                                      [ VARIABLE ] */
-} __attribute__((packed)) rnd_6_t;
+#define RND_6_FIELDS(DISCR, FIELD) \
+	DISCR(0x0a, 4)          /* '1010'                                 [  4 ] */ \
+	FIELD(header_crc, 3)    /* crc3(THIS.UVALUE, THIS.ULENGTH)        [  3 ] */ \
+	FIELD(psh_flag, 1)      /* irregular(1)                           [  1 ] */ \
+	FIELD(ack_num, 16)      /* lsb(16, 16383)                         [ 16 ] */ \
+	FIELD(msn, 4)           /* lsb(4, 4)                              [  4 ] */ \
+	FIELD(seq_num_scaled, 4)/* lsb(4, 7)                              [  4 ] */ \
+	                        /* irregular chain                        [ VARIABLE ] */
+ROHC_BIT_FORMAT(rnd_6, RND_6_FIELDS)
 
 
 /**
@@ -723,29 +665,15 @@ typedef struct
  * Send ACK and window
  * See RFC4996 page 82
  */
-typedef struct
-{
-#if WORDS_BIGENDIAN == 1
-	uint8_t discriminator:6;    /**< '101111'                               [ 6 ] */
-	uint8_t ack_num1:2;         /**< lsb(18, 65535)                         [ 18 ] */
-	uint16_t ack_num2;          /**< sequel of \e ack_num1                  [ - ]*/
-#else
-	uint8_t ack_num1:2;
-	uint8_t discriminator:6;
-	uint16_t ack_num2;
-#endif
-	uint16_t window;            /**< irregular(16)                          [ 16 ] */
-#if WORDS_BIGENDIAN == 1
-	uint8_t msn:4;              /**< lsb(4, 4)                              [ 4 ] */
-	uint8_t psh_flag:1;         /**< irregular(1)                           [ 1 ] */
-	uint8_t header_crc:3;       /**< crc3(THIS.UVALUE, THIS.ULENGTH)        [ 3 ] */
-#else
-	uint8_t header_crc:3;
-	uint8_t psh_flag:1;
-	uint8_t msn:4;
-#endif
-	/* irregular chain                                                      [ VARIABLE ] */
-} __attribute__((packed)) rnd_7_t;
+#define RND_7_FIELDS(DISCR, FIELD) \
+	DISCR(0x2f, 6)          /* '101111'                               [  6 ] */ \
+	FIELD(ack_num, 18)      /* lsb(18, 65535)                         [ 18 ] */ \
+	FIELD(window, 16)       /* irregular(16)                          [ 16 ] */ \
+	FIELD(msn, 4)           /* lsb(4, 4)                              [  4 ] */ \
+	FIELD(psh_flag, 1)      /* irregular(1)                           [  1 ] */ \
+	FIELD(header_crc, 3)    /* crc3(THIS.UVALUE, THIS.ULENGTH)        [  3 ] */ \
+	                        /* irregular chain                        [ VARIABLE ] */
+ROHC_BIT_FORMAT(rnd_7, RND_7_FIELDS)
 
 
 /**
@@ -754,35 +682,20 @@ typedef struct
  * Can send LSBs of TTL, RSF flags, change ECN behavior and options list
  * See RFC4996 page 82
  */
-typedef struct
-{
-#if WORDS_BIGENDIAN == 1
-	uint8_t discriminator:5;    /**< '10110'                                [ 5 ] */
-	uint8_t rsf_flags:2;        /**< rsf_index_enc                          [ 2 ] */
-	uint8_t list_present:1;     /**< irregular(1)                           [ 1 ] */
-	uint16_t header_crc:7;      /**< crc7(THIS.UVALUE, THIS.ULENGTH)        [ 7 ] */
-	uint16_t msn1:1;            /**< lsb(4, 4)                              [ 4 ] */
-	uint16_t msn2:3;            /**< sequel of \e msn1                      [ - ] */
-	uint16_t psh_flag:1;        /**< irregular(1)                           [ 1 ] */
-	uint16_t ttl_hopl:3;        /**< lsb(3, 3)                              [ 3 ] */
-	uint16_t ecn_used:1;        /**< one_bit_choice                         [ 1 ] */
-#else
-	uint8_t list_present:1;
-	uint8_t rsf_flags:2;
-	uint8_t discriminator:5;
-	uint8_t msn1:1;
-	uint8_t header_crc:7;
-	uint8_t ecn_used:1;
-	uint8_t ttl_hopl:3;
-	uint8_t psh_flag:1;
-	uint8_t msn2:3;
-#endif
-	uint16_t seq_num;           /**< lsb(16, 65535)                         [ 16 ] */
-	uint16_t ack_num;           /**< lsb(16, 16383)                         [ 16 ] */
-	uint8_t options[0];         /**< tcp_list_presence_enc(list_present.CVALUE)
-	                                                                        [ VARIABLE ] */
-	/* irregular chain                                                      [ VARIABLE ] */
-} __attribute__((packed)) rnd_8_t;
+#define RND_8_FIELDS(DISCR, FIELD) \
+	DISCR(0x16, 5)          /* '10110'                                [  5 ] */ \
+	FIELD(rsf_flags, 2)     /* rsf_index_enc                          [  2 ] */ \
+	FIELD(list_present, 1)  /* irregular(1)                           [  1 ] */ \
+	FIELD(header_crc, 7)    /* crc7(THIS.UVALUE, THIS.ULENGTH)        [  7 ] */ \
+	FIELD(msn, 4)           /* lsb(4, 4)                              [  4 ] */ \
+	FIELD(psh_flag, 1)      /* irregular(1)                           [  1 ] */ \
+	FIELD(ttl_hopl, 3)      /* lsb(3, 3)                              [  3 ] */ \
+	FIELD(ecn_used, 1)      /* one_bit_choice                         [  1 ] */ \
+	FIELD(seq_num, 16)      /* lsb(16, 65535)                         [ 16 ] */ \
+	FIELD(ack_num, 16)      /* lsb(16, 16383)                         [ 16 ] */ \
+	                        /* tcp_list_presence_enc(list_present)    [ VARIABLE ] */ \
+	                        /* irregular chain                        [ VARIABLE ] */
+ROHC_BIT_FORMAT(rnd_8, RND_8_FIELDS)
 
 
 /**
@@ -791,27 +704,15 @@ typedef struct
  * Send LSBs of sequence number
  * See RFC4996 page 83
  */
-typedef struct
-{
-#if WORDS_BIGENDIAN == 1
-	uint8_t discriminator:4;    /**< '1010'                                 [ 4 ] */
-	uint8_t ip_id:4;            /**< ip_id_lsb(ip_id_behavior.UVALUE, 4, 3) [ 4 ] */
-#else
-	uint8_t ip_id:4;
-	uint8_t discriminator:4;
-#endif
-	uint16_t seq_num;           /**< lsb(16, 32767)                         [ 16 ] */
-#if WORDS_BIGENDIAN == 1
-	uint8_t msn:4;              /**< lsb(4, 4)                              [ 4 ] */
-	uint8_t psh_flag:1;         /**< irregular(1)                           [ 1 ] */
-	uint8_t header_crc:3;       /**< crc3(THIS.UVALUE, THIS.ULENGTH)        [ 3 ] */
-#else
-	uint8_t header_crc:3;
-	uint8_t psh_flag:1;
-	uint8_t msn:4;
-#endif
-	/* irregular chain                                                      [ VARIABLE ] */
-} __attribute__((packed)) seq_1_t;
+#define SEQ_1_FIELDS(DISCR, FIELD) \
+	DISCR(0x0a, 4)          /* '1010'                                 [  4 ] */ \
+	FIELD(ip_id, 4)         /* ip_id_lsb(ip_id_behavior.UVALUE, 4, 3) [  4 ] */ \
+	FIELD(seq_num, 16)      /* lsb(16, 32767)                         [ 16 ] */ \
+	FIELD(msn, 4)           /* lsb(4, 4)                              [  4 ] */ \
+	FIELD(psh_flag, 1)      /* irregular(1)                           [  1 ] */ \
+	FIELD(header_crc, 3)    /* crc3(THIS.UVALUE, THIS.ULENGTH)        [  3 ] */ \
+	                        /* irregular chain                        [ VARIABLE ] */
+ROHC_BIT_FORMAT(seq_1, SEQ_1_FIELDS)
 
 
 /**
@@ -820,27 +721,15 @@ typedef struct
  * Send scaled sequence number LSBs
  * See RFC4996 page 83
  */
-typedef struct
-{
-#if WORDS_BIGENDIAN == 1
-	uint16_t discriminator:5;   /**< '11010'                                [ 5 ] */
-	uint16_t ip_id1:3;          /**< ip_id_lsb(ip_id_behavior.UVALUE, 7, 3) [ 7 ] */
-	uint16_t ip_id2:4;          /**< sequel of ip_id1                       [ - ] */
-	uint16_t seq_num_scaled:4;  /**< lsb(4, 7)                              [ 4 ] */
-	uint8_t msn:4;              /**< lsb(4, 4)                              [ 4 ] */
-	uint8_t psh_flag:1;         /**< irregular(1)                           [ 1 ] */
-	uint8_t header_crc:3;       /**< crc3(THIS.UVALUE, THIS.ULENGTH)        [ 3 ] */
-#else
-	uint8_t ip_id1:3;
-	uint8_t discriminator:5;
-	uint8_t seq_num_scaled:4;
-	uint8_t ip_id2:4;
-	uint8_t header_crc:3;
-	uint8_t psh_flag:1;
-	uint8_t msn:4;
-#endif
-	/* irregular chain                                                      [ VARIABLE ] */
-} __attribute__((packed)) seq_2_t;
+#define SEQ_2_FIELDS(DISCR, FIELD) \
+	DISCR(0x1a, 5)          /* '11010'                                [  5 ] */ \
+	FIELD(ip_id, 7)         /* ip_id_lsb(ip_id_behavior.UVALUE, 7, 3) [  7 ] */ \
+	FIELD(seq_num_scaled, 4)/* lsb(4, 7)                              [  4 ] */ \
+	FIELD(msn, 4)           /* lsb(4, 4)                              [  4 ] */ \
+	FIELD(psh_flag, 1)      /* irregular(1)                           [  1 ] */ \
+	FIELD(header_crc, 3)    /* crc3(THIS.UVALUE, THIS.ULENGTH)        [  3 ] */ \
+	                        /* irregular chain                        [ VARIABLE ] */
+ROHC_BIT_FORMAT(seq_2, SEQ_2_FIELDS)
 
 
 /**
@@ -849,27 +738,15 @@ typedef struct
  * Send acknowledgment number LSBs
  * See RFC4996 page 83
  */
-typedef struct
-{
-#if WORDS_BIGENDIAN == 1
-	uint8_t discriminator:4;    /**< '1001'                                 [  4 ] */
-	uint8_t ip_id:4;            /**< ip_id_lsb(ip_id_behavior.UVALUE, 4, 3) [  4 ] */
-#else
-	uint8_t ip_id:4;
-	uint8_t discriminator:4;
-#endif
-	uint16_t ack_num;           /**< lsb(16, 16383)                         [ 16 ] */
-#if WORDS_BIGENDIAN == 1
-	uint8_t msn:4;              /**< lsb(4, 4)                              [  4 ] */
-	uint8_t psh_flag:1;         /**< irregular(1)                           [  1 ] */
-	uint8_t header_crc:3;       /**< crc3(THIS.UVALUE, THIS.ULENGTH)        [  3 ] */
-#else
-	uint8_t header_crc:3;
-	uint8_t psh_flag:1;
-	uint8_t msn:4;
-#endif
-	/* irregular chain                                                      [ VARIABLE ] */
-} __attribute__((packed)) seq_3_t;
+#define SEQ_3_FIELDS(DISCR, FIELD) \
+	DISCR(0x09, 4)          /* '1001'                                 [  4 ] */ \
+	FIELD(ip_id, 4)         /* ip_id_lsb(ip_id_behavior.UVALUE, 4, 3) [  4 ] */ \
+	FIELD(ack_num, 16)      /* lsb(16, 16383)                         [ 16 ] */ \
+	FIELD(msn, 4)           /* lsb(4, 4)                              [  4 ] */ \
+	FIELD(psh_flag, 1)      /* irregular(1)                           [  1 ] */ \
+	FIELD(header_crc, 3)    /* crc3(THIS.UVALUE, THIS.ULENGTH)        [  3 ] */ \
+	                        /* irregular chain                        [ VARIABLE ] */
+ROHC_BIT_FORMAT(seq_3, SEQ_3_FIELDS)
 
 
 /**
@@ -878,25 +755,15 @@ typedef struct
  * Send scaled acknowledgment number scaled
  * See RFC4996 page 84
  */
-typedef struct
-{
-#if WORDS_BIGENDIAN == 1
-	uint8_t discriminator:1;    /**< '0'                                    [ 1 ] */
-	uint8_t ack_num_scaled:4;   /**< lsb(4, 3)                              [ 4 ] */
-	uint8_t ip_id:3;            /**< ip_id_lsb(ip_id_behavior.UVALUE, 3, 1) [ 3 ] */
-	uint8_t msn:4;              /**< lsb(4, 4)                              [ 4 ] */
-	uint8_t psh_flag:1;         /**< irregular(1)                           [ 1 ] */
-	uint8_t header_crc:3;       /**< crc3(THIS.UVALUE, THIS.ULENGTH)        [ 3 ] */
-#else
-	uint8_t ip_id:3;
-	uint8_t ack_num_scaled:4;
-	uint8_t discriminator:1;
-	uint8_t header_crc:3;
-	uint8_t psh_flag:1;
-	uint8_t msn:4;
-#endif
-	/* irregular chain                                                      [ VARIABLE ] */
-} __attribute__((packed)) seq_4_t;
+#define SEQ_4_FIELDS(DISCR, FIELD) \
+	DISCR(0x00, 1)          /* '0'                                    [  1 ] */ \
+	FIELD(ack_num_scaled, 4)/* lsb(4, 3)                              [  4 ] */ \
+	FIELD(ip_id, 3)         /* ip_id_lsb(ip_id_behavior.UVALUE, 3, 1) [  3 ] */ \
+	FIELD(msn, 4)           /* lsb(4, 4)                              [  4 ] */ \
+	FIELD(psh_flag, 1)      /* irregular(1)                           [  1 ] */ \
+	FIELD(header_crc, 3)    /* crc3(THIS.UVALUE, THIS.ULENGTH)        [  3 ] */ \
+	                        /* irregular chain                        [ VARIABLE ] */
+ROHC_BIT_FORMAT(seq_4, SEQ_4_FIELDS)
 
 
 /**
@@ -905,28 +772,16 @@ typedef struct
  * Send ACK and sequence number
  * See RFC4996 page 84
  */
-typedef struct
-{
-#if WORDS_BIGENDIAN == 1
-	uint8_t discriminator:4;    /**< '1000'                                 [  4 ] */
-	uint8_t ip_id:4;            /**< ip_id_lsb(ip_id_behavior.UVALUE, 4, 3) [  4 ] */
-#else
-	uint8_t ip_id:4;
-	uint8_t discriminator:4;
-#endif
-	uint16_t ack_num;           /**< lsb(16, 16383)                         [ 16 ] */
-	uint16_t seq_num;           /**< lsb(16, 32767)                         [ 16 ] */
-#if WORDS_BIGENDIAN == 1
-	uint8_t msn:4;              /**< lsb(4, 4)                              [  4 ] */
-	uint8_t psh_flag:1;         /**< irregular(1)                           [  1 ] */
-	uint8_t header_crc:3;       /**< crc3(THIS.UVALUE, THIS.ULENGTH)        [  3 ] */
-#else
-	uint8_t header_crc:3;
-	uint8_t psh_flag:1;
-	uint8_t msn:4;
-#endif
-	/* irregular chain                                                      [ VARIABLE ] */
-} __attribute__((packed)) seq_5_t;
+#define SEQ_5_FIELDS(DISCR, FIELD) \
+	DISCR(0x08, 4)          /* '1000'                                 [  4 ] */ \
+	FIELD(ip_id, 4)         /* ip_id_lsb(ip_id_behavior.UVALUE, 4, 3) [  4 ] */ \
+	FIELD(ack_num, 16)      /* lsb(16, 16383)                         [ 16 ] */ \
+	FIELD(seq_num, 16)      /* lsb(16, 32767)                         [ 16 ] */ \
+	FIELD(msn, 4)           /* lsb(4, 4)                              [  4 ] */ \
+	FIELD(psh_flag, 1)      /* irregular(1)                           [  1 ] */ \
+	FIELD(header_crc, 3)    /* crc3(THIS.UVALUE, THIS.ULENGTH)        [  3 ] */ \
+	                        /* irregular chain                        [ VARIABLE ] */
+ROHC_BIT_FORMAT(seq_5, SEQ_5_FIELDS)
 
 
 /**
@@ -935,31 +790,16 @@ typedef struct
  * Send both ACK and scaled sequence number LSBs
  * See RFC4996 page 84
  */
-typedef struct
-{
-#if WORDS_BIGENDIAN == 1
-	uint16_t discriminator:5;   /**< '11011'                                [  5 ] */
-	uint16_t seq_num_scaled1:3; /**< lsb(4, 7)                              [  4 ] */
-	uint16_t seq_num_scaled2:1; /**< sequel of \e seq_num_scaled1           [  4 ] */
-	uint16_t ip_id:7;           /**< ip_id_lsb(ip_id_behavior.UVALUE, 7, 3) [  7 ] */
-#else
-	uint8_t seq_num_scaled1:3;
-	uint8_t discriminator:5;
-	uint8_t ip_id:7;
-	uint8_t seq_num_scaled2:1;
-#endif
-	uint16_t ack_num;           /**< lsb(16, 16383)                         [ 16 ] */
-#if WORDS_BIGENDIAN == 1
-	uint8_t msn:4;              /**< lsb(4, 4)                              [ 4 ] */
-	uint8_t psh_flag:1;         /**< irregular(1)                           [ 1 ] */
-	uint8_t header_crc:3;       /**< crc3(THIS.UVALUE, THIS.ULENGTH)        [ 3 ] */
-#else
-	uint8_t header_crc:3;
-	uint8_t psh_flag:1;
-	uint8_t msn:4;
-#endif
-	/* irregular chain                                                      [ VARIABLE ] */
-} __attribute__((packed)) seq_6_t;
+#define SEQ_6_FIELDS(DISCR, FIELD) \
+	DISCR(0x1b, 5)          /* '11011'                                [  5 ] */ \
+	FIELD(seq_num_scaled, 4)/* lsb(4, 7)                              [  4 ] */ \
+	FIELD(ip_id, 7)         /* ip_id_lsb(ip_id_behavior.UVALUE, 7, 3) [  7 ] */ \
+	FIELD(ack_num, 16)      /* lsb(16, 16383)                         [ 16 ] */ \
+	FIELD(msn, 4)           /* lsb(4, 4)                              [  4 ] */ \
+	FIELD(psh_flag, 1)      /* irregular(1)                           [  1 ] */ \
+	FIELD(header_crc, 3)    /* crc3(THIS.UVALUE, THIS.ULENGTH)        [  3 ] */ \
+	                        /* irregular chain                        [ VARIABLE ] */
+ROHC_BIT_FORMAT(seq_6, SEQ_6_FIELDS)
 
 
 /**
@@ -968,31 +808,16 @@ typedef struct
  * Send ACK and window
  * See RFC4996 page 85
  */
-typedef struct
-{
-#if WORDS_BIGENDIAN == 1
-	uint8_t discriminator:4;    /**< '1100'                                 [  4 ] */
-	uint8_t window1:4;          /**< lsb(15, 16383)                         [ 15 ] */
-	uint8_t window2;            /**< sequel of \e window1                   [  - ] */
-	uint8_t window3:3;          /**< sequel of \e window1 and \e window2    [  - ] */
-	uint8_t ip_id:5;            /**< ip_id_lsb(ip_id_behavior.UVALUE, 5, 3) [  5 ] */
-	uint16_t ack_num;           /**< lsb(16, 32767)                         [ 16 ] */
-	uint8_t msn:4;              /**< lsb(4, 4)                              [  4 ] */
-	uint8_t psh_flag:1;         /**< irregular(1)                           [  1 ] */
-	uint8_t header_crc:3;       /**< crc3(THIS.UVALUE, THIS.ULENGTH)        [  3 ] */
-#else
-	uint8_t window1:4;
-	uint8_t discriminator:4;
-	uint8_t window2;
-	uint8_t ip_id:5;
-	uint8_t window3:3;
-	uint16_t ack_num;
-	uint8_t header_crc:3;
-	uint8_t psh_flag:1;
-	uint8_t msn:4;
-#endif
-	/* irregular chain                                                      [ VARIABLE ] */
-} __attribute__((packed)) seq_7_t;
+#define SEQ_7_FIELDS(DISCR, FIELD) \
+	DISCR(0x0c, 4)          /* '1100'                                 [  4 ] */ \
+	FIELD(window, 15)       /* lsb(15, 16383)                         [ 15 ] */ \
+	FIELD(ip_id, 5)         /* ip_id_lsb(ip_id_behavior.UVALUE, 5, 3) [  5 ] */ \
+	FIELD(ack_num, 16)      /* lsb(16, 32767)                         [ 16 ] */ \
+	FIELD(msn, 4)           /* lsb(4, 4)                              [  4 ] */ \
+	FIELD(psh_flag, 1)      /* irregular(1)                           [  1 ] */ \
+	FIELD(header_crc, 3)    /* crc3(THIS.UVALUE, THIS.ULENGTH)        [  3 ] */ \
+	                        /* irregular chain                        [ VARIABLE ] */
+ROHC_BIT_FORMAT(seq_7, SEQ_7_FIELDS)
 
 
 /**
@@ -1001,41 +826,21 @@ typedef struct
  * Can send LSBs of TTL, RSF flags, change ECN behavior, and options list
  * See RFC4996 page 85
  */
-typedef struct
-{
-#if WORDS_BIGENDIAN == 1
-	uint8_t discriminator:4;    /**< '1011'                                 [  4 ] */
-	uint8_t ip_id:4;            /**< ip_id_lsb(ip_id_behavior.UVALUE, 4, 3) [  4 ] */
-	uint8_t list_present:1;     /**< irregular(1)                           [  1 ] */
-	uint8_t header_crc:7;       /**< crc7(THIS.UVALUE, THIS.ULENGTH)        [  7 ] */
-	uint8_t msn:4;              /**< lsb(4, 4)                              [  4 ] */
-	uint8_t psh_flag:1;         /**< irregular(1)                           [  1 ] */
-	uint8_t ttl_hopl:3;         /**< lsb(3, 3)                              [  3 ] */
-	uint8_t ecn_used:1;         /**< one_bit_choice                         [  1 ] */
-	uint8_t ack_num1:7;         /**< lsb(15, 8191)                          [ 15 ] */
-	uint8_t ack_num2;           /**< sequel of \e ack_num1                  [  - ] */
-	uint8_t rsf_flags:2;        /**< rsf_index_enc                          [  2 ] */
-	uint8_t seq_num1:6;         /**< lsb(14, 8191)                          [ 14 ] */
-	uint8_t seq_num2;           /**< sequel of \e seq_num1                  [  - ] */
-#else
-	uint8_t ip_id:4;
-	uint8_t discriminator:4;
-	uint8_t header_crc:7;
-	uint8_t list_present:1;
-	uint8_t ttl_hopl:3;
-	uint8_t psh_flag:1;
-	uint8_t msn:4;
-	uint8_t ack_num1:7;
-	uint8_t ecn_used:1;
-	uint8_t ack_num2;
-	uint8_t seq_num1:6;
-	uint8_t rsf_flags:2;
-	uint8_t seq_num2:8;
-#endif
-	uint8_t options[0];       /**< tcp_list_presence_enc(list_present.CVALUE)
-	                                                                      [ VARIABLE ] */
-	/* irregular chain                                                    [ VARIABLE ] */
-} __attribute__((packed)) seq_8_t;
+#define SEQ_8_FIELDS(DISCR, FIELD) \
+	DISCR(0x0b, 4)          /* '1011'                                 [  4 ] */ \
+	FIELD(ip_id, 4)         /* ip_id_lsb(ip_id_behavior.UVALUE, 4, 3) [  4 ] */ \
+	FIELD(list_present, 1)  /* irregular(1)                           [  1 ] */ \
+	FIELD(header_crc, 7)    /* crc7(THIS.UVALUE, THIS.ULENGTH)        [  7 ] */ \
+	FIELD(msn, 4)           /* lsb(4, 4)                              [  4 ] */ \
+	FIELD(psh_flag, 1)      /* irregular(1)                           [  1 ] */ \
+	FIELD(ttl_hopl, 3)      /* lsb(3, 3)                              [  3 ] */ \
+	FIELD(ecn_used, 1)      /* one_bit_choice                         [  1 ] */ \
+	FIELD(ack_num, 15)      /* lsb(15, 8191)                          [ 15 ] */ \
+	FIELD(rsf_flags, 2)     /* rsf_index_enc                          [  2 ] */ \
+	FIELD(seq_num, 14)      /* lsb(14, 8191)                          [ 14 ] */ \
+	                        /* tcp_list_presence_enc(list_present)    [ VARIABLE ] */ \
+	                        /* irregular chain                        [ VARIABLE ] */
+ROHC_BIT_FORMAT(seq_8, SEQ_8_FIELDS)
 
 
 
@@ -33,8 +33,11 @@ extern "C"
 #endif
 
 #include <stdlib.h>
-#ifndef __KERNEL__
+#ifdef __KERNEL__
+#  include <linux/types.h>
+#else
 #  include <inttypes.h>
+#  include <stdbool.h>
 #endif
 
 
@@ -236,6 +239,238 @@ typedef enum
 } rohc_profile_t;
 
 
+/**
+ * @brief The memory used by one ROHC compressor or decompressor
+ *
+ * The structure is used by the \ref rohc_comp_get_memory_usage and
+ * \ref rohc_decomp_get_memory_usage functions to report the number of bytes
+ * that one instance allocated. The bytes of the W-LSB windows and of the
+ * tables of list compression are a part of the bytes of the contexts.
+ *
+ * Versioning works as for \ref rohc_comp_general_info_t.
+ *
+ * Supported versions:
+ *  - major 0 and minor = 0 contains: version_major, version_minor,
+ *    total_bytes, instance_bytes, contexts_nr, contexts_bytes,
+ *    profiles_bytes, wlsb_bytes, lists_bytes, and rru_bytes.
+ *
+ * @ingroup rohc
+ *
+ * @see rohc_comp_get_memory_usage
+ * @see rohc_decomp_get_memory_usage
+ */
+typedef struct
+{
+	/** The major version of this structure */
+	unsigned short version_major;
+	/** The minor version of this structure */
+	unsigned short version_minor;
+	/** The total number of bytes used by the instance and its contexts */
+	size_t total_bytes;
+	/** The bytes used by the instance itself: its main structure, its arrays
+	 *  of contexts and the buffers shared by all its contexts */
+	size_t instance_bytes;
+	/** The number of contexts, including the released ones kept for re-use */
+	size_t contexts_nr;
+	/** The bytes used by all the contexts */
+	size_t contexts_bytes;
+	/** The bytes used by the contexts of every profile, indexed by profile ID */
+	size_t profiles_bytes[ROHC_PROFILE_MAX];
+	/** The bytes of the contexts used by the W-LSB encoding windows, or by the
+	 *  LSB decoding references for the decompressor */
+	size_t wlsb_bytes;
+	/** The bytes of the contexts used by the tables of list compression */
+	size_t lists_bytes;
+	/** The bytes used by the buffer for Reconstructed Reception Units */
+	size_t rru_bytes;
+} __attribute__((packed)) rohc_memory_usage_t;
+
+
+
+/**
+ * @brief The prototype of the callback that writes the records of a snapshot
+ *
+ * The callback is called once per record while a compressor or a
+ * decompressor is saved, so that the snapshot may be streamed to a file or
+ * a socket without holding it in memory as a whole.
+ *
+ * @param priv  The private context given by the user with the callback
+ * @param data  The bytes of the snapshot to write
+ * @param len   The number of bytes to write
+ * @return      true if all the bytes were written, false to abort
+ *
+ * @ingroup rohc
+ *
+ * @see rohc_comp_snapshot
+ * @see rohc_decomp_snapshot
+ */
+typedef bool (*rohc_snapshot_write_t)(void *const priv,
+                                      const uint8_t *const data,
+                                      const size_t len);
+
+/**
+ * @brief The prototype of the callback that reads the records of a snapshot
+ *
+ * @param priv  The private context given by the user with the callback
+ * @param data  The buffer where to store the bytes read from the snapshot
+ * @param len   The number of bytes to read
+ * @return      true if exactly \e len bytes were read, false to abort
+ *
+ * @ingroup rohc
+ *
+ * @see rohc_comp_restore
+ * @see rohc_decomp_restore
+ */
+typedef bool (*rohc_snapshot_read_t)(void *const priv,
+                                     uint8_t *const data,
+                                     const size_t len);
+
+/**
+ * @brief The prototype of the callback that writes a recording of workload
+ *
+ * The callback is called with the bytes of the recording in order, the
+ * recording is the concatenation of all of them. The bytes of one input are
+ * given in the thread that (de)compresses, while the input is processed: the
+ * callback shall be fast, typically by appending the bytes to a buffer that
+ * is written to a file by another thread.
+ *
+ * @param priv  The private context given by the user with the callback
+ * @param data  The bytes of the recording to write
+ * @param len   The number of bytes to write
+ * @return      true if all the bytes were written, false to stop recording
+ *
+ * @ingroup rohc
+ *
+ * @see rohc_comp_set_recorder
+ * @see rohc_decomp_set_recorder
+ */
+typedef bool (*rohc_record_write_t)(void *const priv,
+                                    const uint8_t *const data,
+                                    const size_t len);
+
+
+
+/**
+ * @brief The behaviour of the library when it allocates memory
+ *
+ * Once all its contexts are created, a compressor or a decompressor shall
+ * not allocate memory anymore: it runs in steady state. The accounting of the
+ * allocations helps to detect the regressions that allocate memory on the
+ * paths of compression or decompression. It is available only if the library
+ * was built with the --enable-alloc-check option of the configure script.
+ *
+ * @ingroup rohc
+ *
+ * @see rohc_alloc_set_steady_state
+ */
+typedef enum
+{
+	/** Not in steady state, the allocations are expected */
+	ROHC_ALLOC_STEADY_OFF    = 0,
+	/** In steady state, count the allocations as unexpected */
+	ROHC_ALLOC_STEADY_REPORT = 1,
+	/** In steady state, abort the program on the first allocation */
+	ROHC_ALLOC_STEADY_ABORT  = 2,
+
+} rohc_alloc_steady_t;
+
+
+/**
+ * @brief The statistics about the memory allocations of the library
+ *
+ * The structure is used by the \ref rohc_alloc_get_stats function. The
+ * statistics are global to the library: they cover all the compressors and
+ * decompressors of the program.
+ *
+ * Versioning works as for \ref rohc_comp_general_info_t.
+ *
+ * Supported versions:
+ *  - major 0 and minor = 0 contains: version_major, version_minor,
+ *    allocs_nr, frees_nr and steady_allocs_nr.
+ *
+ * @ingroup rohc
+ *
+ * @see rohc_alloc_get_stats
+ */
+typedef struct
+{
+	/* API version */
+	unsigned short version_major;  /**< The major version of the structure */
+	unsigned short version_minor;  /**< The minor version of the structure */
+	/* statistics */
+	unsigned long allocs_nr;        /**< The number of memory allocations */
+	unsigned long frees_nr;         /**< The number of memory releases */
+	unsigned long steady_allocs_nr; /**< The number of allocations in steady state */
+} __attribute__((packed)) rohc_alloc_stats_t;
+
+
+/**
+ * @brief The prototype of the allocation function of a custom allocator
+ *
+ * @param size    The number of bytes to allocate
+ * @param opaque  The private context given to \ref rohc_alloc_set_allocator
+ * @return        The allocated memory, NULL in case of failure
+ *
+ * @ingroup rohc
+ *
+ * @see rohc_alloc_set_allocator
+ */
+typedef void * (*rohc_alloc_malloc_t)(const size_t size, void *const opaque);
+
+
+/**
+ * @brief The prototype of the zeroed allocation function of a custom allocator
+ *
+ * @param nmemb   The number of elements to allocate
+ * @param size    The size of one element
+ * @param opaque  The private context given to \ref rohc_alloc_set_allocator
+ * @return        The allocated memory filled with zeroes,
+ *                NULL in case of failure
+ *
+ * @ingroup rohc
+ *
+ * @see rohc_alloc_set_allocator
+ */
+typedef void * (*rohc_alloc_calloc_t)(const size_t nmemb,
+                                      const size_t size,
+                                      void *const opaque);
+
+
+/**
+ * @brief The prototype of the release function of a custom allocator
+ *
+ * @param ptr     The memory to release, never NULL
+ * @param opaque  The private context given to \ref rohc_alloc_set_allocator
+ *
+ * @ingroup rohc
+ *
+ * @see rohc_alloc_set_allocator
+ */
+typedef void (*rohc_alloc_free_t)(void *const ptr, void *const opaque);
+
+
+/** No NUMA node given, the memory may be placed on any node */
+#define ROHC_NUMA_NO_NODE  (-1)
+
+
+/**
+ * @brief The prototype of the NUMA-aware allocation function of a custom
+ *        allocator
+ *
+ * @param size       The number of bytes to allocate
+ * @param numa_node  The NUMA node to place the memory on,
+ *                   never \ref ROHC_NUMA_NO_NODE
+ * @param opaque     The private context given to \ref rohc_alloc_set_allocator
+ * @return           The allocated memory, NULL in case of failure
+ *
+ * @ingroup rohc
+ *
+ * @see rohc_alloc_set_numa_allocator
+ */
+typedef void * (*rohc_alloc_malloc_node_t)(const size_t size,
+                                           const int numa_node,
+                                           void *const opaque);
+
 
 /*
  * Prototypes of public functions
@@ -253,6 +488,22 @@ const char * ROHC_EXPORT rohc_get_mode_descr(const rohc_mode_t mode)
 const char * ROHC_EXPORT rohc_get_profile_descr(const rohc_profile_t profile)
 	__attribute__((warn_unused_result, const));
 
+bool ROHC_EXPORT rohc_alloc_set_steady_state(const rohc_alloc_steady_t steady)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_alloc_get_stats(rohc_alloc_stats_t *const stats)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_alloc_set_allocator(const rohc_alloc_malloc_t malloc_fn,
+                                          const rohc_alloc_calloc_t calloc_fn,
+                                          const rohc_alloc_free_t free_fn,
+                                          void *const opaque)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT
+	rohc_alloc_set_numa_allocator(const rohc_alloc_malloc_node_t malloc_node_fn)
+	__attribute__((warn_unused_result));
+
 
 
 #undef ROHC_EXPORT /* do not pollute outside this header */
@@ -0,0 +1,433 @@
+/*
+ * Copyright 2026 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   rohc_alloc.c
+ * @brief  Memory allocations of the library
+ * @author Didier Barvaux <didier@barvaux.org>
+ */
+
+/* the wrappers call the functions of the system */
+#define ROHC_ALLOC_NO_WRAPPERS
+#include "rohc_alloc.h"
+#include "rohc.h"
+
+#ifdef __KERNEL__
+#  include <linux/string.h>
+#else
+#  include <string.h>
+#endif
+
+/** The allocation function of the custom allocator, NULL for the system */
+static rohc_alloc_malloc_t rohc_alloc_malloc_fn = NULL;
+/** The zeroed allocation function of the custom allocator, may be NULL */
+static rohc_alloc_calloc_t rohc_alloc_calloc_fn = NULL;
+/** The NUMA-aware allocation function of the custom allocator, may be NULL */
+static rohc_alloc_malloc_node_t rohc_alloc_malloc_node_fn = NULL;
+/** The release function of the custom allocator, NULL for the system */
+static rohc_alloc_free_t rohc_alloc_free_fn = NULL;
+/** The private context given to the functions of the custom allocator */
+static void *rohc_alloc_opaque = NULL;
+
+/** The number of memory allocations */
+static unsigned long rohc_alloc_allocs_nr = 0;
+/** The number of memory releases */
+static unsigned long rohc_alloc_frees_nr = 0;
+/** The number of memory allocations in steady state */
+static unsigned long rohc_alloc_steady_allocs_nr = 0;
+/** The behaviour of the library when it allocates memory */
+static rohc_alloc_steady_t rohc_alloc_steady = ROHC_ALLOC_STEADY_OFF;
+
+
+#if defined(ROHC_ALLOC_CHECK) && !defined(__KERNEL__)
+static void rohc_alloc_count(void);
+#endif
+
+
+/**
+ * @brief Allocate memory
+ *
+ * @param size  The number of bytes to allocate
+ * @return      The allocated memory, NULL in case of failure
+ */
+void * rohc_alloc_malloc(const size_t size)
+{
+#if defined(ROHC_ALLOC_CHECK) && !defined(__KERNEL__)
+	rohc_alloc_count();
+#endif
+	if(rohc_alloc_malloc_fn != NULL)
+	{
+		return rohc_alloc_malloc_fn(size, rohc_alloc_opaque);
+	}
+	return malloc(size);
+}
+
+
+/**
+ * @brief Allocate zeroed memory
+ *
+ * If the custom allocator has no zeroed allocation function, the memory is
+ * allocated with its allocation function, then zeroed.
+ *
+ * @param nmemb  The number of elements to allocate
+ * @param size   The size of one element
+ * @return       The allocated memory, NULL in case of failure
+ */
+void * rohc_alloc_calloc(const size_t nmemb, const size_t size)
+{
+	void *ptr;
+
+#if defined(ROHC_ALLOC_CHECK) && !defined(__KERNEL__)
+	rohc_alloc_count();
+#endif
+	if(rohc_alloc_malloc_fn == NULL)
+	{
+		return calloc(nmemb, size);
+	}
+	if(rohc_alloc_calloc_fn != NULL)
+	{
+		return rohc_alloc_calloc_fn(nmemb, size, rohc_alloc_opaque);
+	}
+
+	if(size != 0 && nmemb > (((size_t) -1) / size))
+	{
+		return NULL;
+	}
+	ptr = rohc_alloc_malloc_fn(nmemb * size, rohc_alloc_opaque);
+	if(ptr != NULL)
+	{
+		memset(ptr, 0, nmemb * size);
+	}
+	return ptr;
+}
+
+
+/**
+ * @brief Allocate memory on the given NUMA node
+ *
+ * The memory is placed on the NUMA node by the NUMA-aware allocation
+ * function of the custom allocator if any, by kmalloc_node() for the Linux
+ * kernel module. Otherwise the node is only a hint: the operating system
+ * places the memory on the node of the thread that touches it first.
+ *
+ * @param size       The number of bytes to allocate
+ * @param numa_node  The NUMA node, \ref ROHC_NUMA_NO_NODE for any node
+ * @return           The allocated memory, NULL in case of failure
+ */
+void * rohc_alloc_malloc_node(const size_t size, const int numa_node)
+{
+	if(numa_node == ROHC_NUMA_NO_NODE)
+	{
+		return rohc_alloc_malloc(size);
+	}
+#if defined(ROHC_ALLOC_CHECK) && !defined(__KERNEL__)
+	rohc_alloc_count();
+#endif
+	if(rohc_alloc_malloc_node_fn != NULL)
+	{
+		return rohc_alloc_malloc_node_fn(size, numa_node, rohc_alloc_opaque);
+	}
+	if(rohc_alloc_malloc_fn != NULL)
+	{
+		return rohc_alloc_malloc_fn(size, rohc_alloc_opaque);
+	}
+#ifdef __KERNEL__
+	return kmalloc_node(size, GFP_ATOMIC, numa_node);
+#else
+	return malloc(size);
+#endif
+}
+
+
+/**
+ * @brief Allocate zeroed memory on the given NUMA node
+ *
+ * See \ref rohc_alloc_malloc_node for the placement of the memory.
+ *
+ * @param nmemb      The number of elements to allocate
+ * @param size       The size of one element
+ * @param numa_node  The NUMA node, \ref ROHC_NUMA_NO_NODE for any node
+ * @return           The allocated memory, NULL in case of failure
+ */
+void * rohc_alloc_calloc_node(const size_t nmemb,
+                              const size_t size,
+                              const int numa_node)
+{
+	void *ptr;
+
+	if(numa_node == ROHC_NUMA_NO_NODE)
+	{
+		return rohc_alloc_calloc(nmemb, size);
+	}
+	if(size != 0 && nmemb > (((size_t) -1) / size))
+	{
+		return NULL;
+	}
+	ptr = rohc_alloc_malloc_node(nmemb * size, numa_node);
+	if(ptr != NULL)
+	{
+		memset(ptr, 0, nmemb * size);
+	}
+	return ptr;
+}
+
+
+/**
+ * @brief Release memory
+ *
+ * @param ptr  The memory to release, may be NULL
+ */
+void rohc_alloc_free(void *const ptr)
+{
+	if(ptr == NULL)
+	{
+		return;
+	}
+#if defined(ROHC_ALLOC_CHECK) && !defined(__KERNEL__)
+	__atomic_add_fetch(&rohc_alloc_frees_nr, 1, __ATOMIC_RELAXED);
+#endif
+	if(rohc_alloc_free_fn != NULL)
+	{
+		rohc_alloc_free_fn(ptr, rohc_alloc_opaque);
+	}
+	else
+	{
+		free(ptr);
+	}
+}
+
+
+#if defined(ROHC_ALLOC_CHECK) && !defined(__KERNEL__)
+
+/**
+ * @brief Account for one memory allocation
+ *
+ * Abort the program if the library allocates memory in steady state and the
+ * \ref ROHC_ALLOC_STEADY_ABORT behaviour was requested.
+ */
+static void rohc_alloc_count(void)
+{
+	const rohc_alloc_steady_t steady =
+		__atomic_load_n(&rohc_alloc_steady, __ATOMIC_RELAXED);
+
+	__atomic_add_fetch(&rohc_alloc_allocs_nr, 1, __ATOMIC_RELAXED);
+	if(steady != ROHC_ALLOC_STEADY_OFF)
+	{
+		__atomic_add_fetch(&rohc_alloc_steady_allocs_nr, 1, __ATOMIC_RELAXED);
+		if(steady == ROHC_ALLOC_STEADY_ABORT)
+		{
+			abort();
+		}
+	}
+}
+
+#endif /* ROHC_ALLOC_CHECK */
+
+
+/**
+ * @brief Set the allocator used for all the memory of the library
+ *
+ * By default, the library allocates its memory with the malloc(3), calloc(3)
+ * and free(3) functions of the system (kmalloc() and kfree() for the Linux
+ * kernel module). Give other functions to place the compressors, the
+ * decompressors and their contexts in some specific memory, eg. hugepages or
+ * memory local to one NUMA node.
+ *
+ * The allocator is global to the library: it covers all the compressors and
+ * decompressors of the program. It shall be set before the first compressor
+ * or decompressor is created, or once all of them are destroyed, since the
+ * memory allocated by one allocator cannot be released by another one. The
+ * function is not thread-safe.
+ *
+ * The NUMA-aware allocation function is reset, see
+ * \ref rohc_alloc_set_numa_allocator.
+ *
+ * @param malloc_fn  The allocation function,
+ *                   NULL to go back to the functions of the system
+ * @param calloc_fn  The zeroed allocation function, NULL to zero the memory
+ *                   given by the allocation function
+ * @param free_fn    The release function, NULL if and only if the
+ *                   allocation function is NULL
+ * @param opaque     The private context given to the functions
+ * @return           true if the allocator was set,
+ *                   false if the functions are inconsistent
+ *
+ * @ingroup rohc
+ */
+bool rohc_alloc_set_allocator(const rohc_alloc_malloc_t malloc_fn,
+                              const rohc_alloc_calloc_t calloc_fn,
+                              const rohc_alloc_free_t free_fn,
+                              void *const opaque)
+{
+	if((malloc_fn == NULL) != (free_fn == NULL))
+	{
+		goto error;
+	}
+	if(malloc_fn == NULL && calloc_fn != NULL)
+	{
+		goto error;
+	}
+
+	rohc_alloc_malloc_fn = malloc_fn;
+	rohc_alloc_calloc_fn = calloc_fn;
+	rohc_alloc_malloc_node_fn = NULL;
+	rohc_alloc_free_fn = free_fn;
+	rohc_alloc_opaque = opaque;
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Set the NUMA-aware allocation function of the custom allocator
+ *
+ * The compressors and decompressors created with a NUMA node (see
+ * \ref rohc_comp_config_set_numa_node and \ref rohc_decomp_new_on_node)
+ * allocate their contexts and the arrays of contexts with the given function,
+ * so that they are placed on the NUMA node of the core that uses them. The
+ * memory is released with the release function of the custom allocator.
+ *
+ * The function shall be called after \ref rohc_alloc_set_allocator, with the
+ * same restrictions.
+ *
+ * @param malloc_node_fn  The NUMA-aware allocation function, NULL to use the
+ *                        allocation function of the custom allocator
+ * @return                true if the function was set,
+ *                        false if no custom allocator was set
+ *
+ * @ingroup rohc
+ *
+ * @see rohc_alloc_set_allocator
+ */
+bool rohc_alloc_set_numa_allocator(const rohc_alloc_malloc_node_t malloc_node_fn)
+{
+	if(malloc_node_fn != NULL && rohc_alloc_malloc_fn == NULL)
+	{
+		goto error;
+	}
+
+	rohc_alloc_malloc_node_fn = malloc_node_fn;
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Enter or leave the steady state of the library
+ *
+ * Once all its contexts are created, a compressor or a decompressor shall
+ * not allocate memory anymore. Call the function with
+ * \ref ROHC_ALLOC_STEADY_REPORT to count the allocations done from now on
+ * (see \ref rohc_alloc_get_stats), or with \ref ROHC_ALLOC_STEADY_ABORT to
+ * abort the program on the first one, so that a debugger or a core dump
+ * shows the culprit. Call it with \ref ROHC_ALLOC_STEADY_OFF before creating
+ * or destroying compressors, decompressors or contexts again.
+ *
+ * The steady state is global to the library: it covers all the compressors
+ * and decompressors of the program.
+ *
+ * The allocations are accounted only if the library was built with the
+ * --enable-alloc-check option of the configure script.
+ *
+ * @param steady  The behaviour of the library when it allocates memory
+ * @return        true in case of success,
+ *                false if the library was built without the accounting of
+ *                allocations or if the behaviour is unknown
+ *
+ * @ingroup rohc
+ *
+ * @see rohc_alloc_get_stats
+ */
+bool rohc_alloc_set_steady_state(const rohc_alloc_steady_t steady)
+{
+	if(steady != ROHC_ALLOC_STEADY_OFF &&
+	   steady != ROHC_ALLOC_STEADY_REPORT &&
+	   steady != ROHC_ALLOC_STEADY_ABORT)
+	{
+		goto error;
+	}
+
+	__atomic_store_n(&rohc_alloc_steady, steady, __ATOMIC_RELAXED);
+#if defined(ROHC_ALLOC_CHECK) && !defined(__KERNEL__)
+	return true;
+#endif
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get the statistics about the memory allocations of the library
+ *
+ * Get the number of allocations and releases of memory done by the library
+ * since the program started, and the number of allocations done in steady
+ * state (see \ref rohc_alloc_set_steady_state).
+ *
+ * To use the function, call it with a pointer on a pre-allocated
+ * \ref rohc_alloc_stats_t structure with the \e version_major and
+ * \e version_minor fields set to one of the following supported versions:
+ *  - Major 0, minor 0
+ *
+ * See the \ref rohc_alloc_stats_t structure for details about fields that
+ * are supported in the above versions.
+ *
+ * The allocations are accounted only if the library was built with the
+ * --enable-alloc-check option of the configure script.
+ *
+ * @param[in,out] stats  The structure where to store the statistics
+ * @return               true in case of success,
+ *                       false if the library was built without the accounting
+ *                       of allocations or if the structure is invalid
+ *
+ * @ingroup rohc
+ *
+ * @see rohc_alloc_stats_t
+ * @see rohc_alloc_set_steady_state
+ */
+bool rohc_alloc_get_stats(rohc_alloc_stats_t *const stats)
+{
+	if(stats == NULL)
+	{
+		goto error;
+	}
+
+	/* check compatibility version */
+	if(stats->version_major != 0 || stats->version_minor != 0)
+	{
+		goto error;
+	}
+
+	/* all the counters remain zero without the accounting of allocations */
+	stats->allocs_nr = __atomic_load_n(&rohc_alloc_allocs_nr, __ATOMIC_RELAXED);
+	stats->frees_nr = __atomic_load_n(&rohc_alloc_frees_nr, __ATOMIC_RELAXED);
+	stats->steady_allocs_nr =
+		__atomic_load_n(&rohc_alloc_steady_allocs_nr, __ATOMIC_RELAXED);
+#if defined(ROHC_ALLOC_CHECK) && !defined(__KERNEL__)
+	return true;
+#endif
+
+error:
+	return false;
+}
@@ -0,0 +1,70 @@
+/*
+ * Copyright 2026 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   rohc_alloc.h
+ * @brief  Memory allocations of the library
+ * @author Didier Barvaux <didier@barvaux.org>
+ *
+ * The malloc(3), calloc(3) and free(3) functions are replaced by wrappers
+ * that call the allocator given to rohc_alloc_set_allocator(), or the
+ * functions of the system if none was given. The header shall be included
+ * by every source file that allocates memory.
+ *
+ * The memory of the contexts and of their arrays is allocated with
+ * rohc_alloc_malloc_node() or rohc_alloc_calloc_node(), so that it is placed
+ * on the NUMA node of the compressor or decompressor that uses it.
+ *
+ * If the --enable-alloc-check option was given to the configure script, the
+ * wrappers also count the allocations and check them against the steady
+ * state of the library (see rohc_alloc_set_steady_state()).
+ */
+
+#ifndef ROHC_COMMON_ALLOC_H
+#define ROHC_COMMON_ALLOC_H
+
+/* declare the system functions before they are replaced */
+#include <stdlib.h>
+
+void * rohc_alloc_malloc(const size_t size)
+	__attribute__((warn_unused_result, malloc));
+
+void * rohc_alloc_calloc(const size_t nmemb, const size_t size)
+	__attribute__((warn_unused_result, malloc));
+
+void * rohc_alloc_malloc_node(const size_t size, const int numa_node)
+	__attribute__((warn_unused_result, malloc));
+
+void * rohc_alloc_calloc_node(const size_t nmemb,
+                              const size_t size,
+                              const int numa_node)
+	__attribute__((warn_unused_result, malloc));
+
+void rohc_alloc_free(void *const ptr);
+
+#ifndef ROHC_ALLOC_NO_WRAPPERS
+/* the functions are macros for the Linux kernel module */
+#  undef malloc
+#  undef calloc
+#  undef free
+#  define malloc(size)         rohc_alloc_malloc(size)
+#  define calloc(nmemb, size)  rohc_alloc_calloc((nmemb), (size))
+#  define free(ptr)            rohc_alloc_free(ptr)
+#endif
+
+#endif
@@ -34,6 +34,10 @@
 #  include "config.h" /* for WORDS_BIGENDIAN */
 #endif
 
+#include <stdint.h>
+#include <stddef.h>
+#include <assert.h>
+
 
 /*
  * GET_BIT_n(x) macros: extract the (n+1) th bit from byte x starting from
@@ -181,5 +185,199 @@
 	            (base)->ts, (base)->ts_nr, \
 	            (bits), (bits_nr), 32)
 
-#endif
 
+/*
+ * Bit writer: pack several bit fields in one register, then write all the
+ * resulting bytes at once
+ */
+
+/** A writer that packs bit fields, most significant bit first */
+struct rohc_bit_writer
+{
+	uint64_t bits;   /**< The bits packed so far, right-aligned */
+	size_t bits_nr;  /**< The number of bits packed so far */
+};
+
+
+/**
+ * @brief Start packing new bit fields
+ *
+ * @param writer  The bit writer to initialize
+ */
+static inline void rohc_bit_writer_init(struct rohc_bit_writer *const writer)
+{
+	writer->bits = 0;
+	writer->bits_nr = 0;
+}
+
+
+/**
+ * @brief Pack the given number of LSB of a value after the bits already packed
+ *
+ * @param writer   The bit writer
+ * @param value    The value to pack, only its \e bits_nr LSB are used
+ * @param bits_nr  The number of bits to pack, at most 32
+ */
+static inline void rohc_bit_writer_put(struct rohc_bit_writer *const writer,
+                                       const uint32_t value,
+                                       const size_t bits_nr)
+{
+	assert(bits_nr > 0 && bits_nr <= 32);
+	assert((writer->bits_nr + bits_nr) <= 64);
+
+	writer->bits <<= bits_nr;
+	writer->bits |= value & (0xffffffffU >> (32 - bits_nr));
+	writer->bits_nr += bits_nr;
+}
+
+
+/**
+ * @brief Write all the packed bits in network byte order
+ *
+ * @param writer  The bit writer, its packed bits must fill whole bytes
+ * @param dest    The buffer to write the bytes to
+ * @return        The number of bytes written
+ */
+static inline size_t rohc_bit_writer_flush(const struct rohc_bit_writer *const writer,
+                                           uint8_t *const dest)
+{
+	const size_t bytes_nr = writer->bits_nr / 8;
+	size_t i;
+
+	assert((writer->bits_nr % 8) == 0);
+
+	/* the number of bytes is known at compile time for every packet format,
+	 * so the loop is fully unrolled into a fixed sequence of stores */
+	for(i = 0; i < bytes_nr; i++)
+	{
+		dest[i] = (writer->bits >> ((bytes_nr - 1 - i) * 8)) & 0xff;
+	}
+
+	return bytes_nr;
+}
+
+
+/*
+ * Bit reader: load all the bytes of a packet format in one register, then
+ * extract the bit fields from it
+ */
+
+/** A reader that extracts bit fields, most significant bit first */
+struct rohc_bit_reader
+{
+	uint64_t bits;   /**< The loaded bits, right-aligned */
+	size_t bits_nr;  /**< The number of loaded bits not extracted yet */
+};
+
+
+/**
+ * @brief Load the given bytes in network byte order
+ *
+ * @param reader    The bit reader to initialize
+ * @param src       The bytes to extract bit fields from
+ * @param bytes_nr  The number of bytes to load, at most 8
+ */
+static inline void rohc_bit_reader_init(struct rohc_bit_reader *const reader,
+                                        const uint8_t *const src,
+                                        const size_t bytes_nr)
+{
+	size_t i;
+
+	assert(bytes_nr <= 8);
+
+	/* the number of bytes is known at compile time for every packet format,
+	 * so the loop is fully unrolled into a fixed sequence of loads */
+	reader->bits = 0;
+	for(i = 0; i < bytes_nr; i++)
+	{
+		reader->bits = (reader->bits << 8) | src[i];
+	}
+	reader->bits_nr = bytes_nr * 8;
+}
+
+
+/**
+ * @brief Extract the given number of bits after the bits already extracted
+ *
+ * @param reader   The bit reader
+ * @param bits_nr  The number of bits to extract, at most 32
+ * @return         The extracted bits
+ */
+static inline uint32_t rohc_bit_reader_get(struct rohc_bit_reader *const reader,
+                                           const size_t bits_nr)
+{
+	assert(bits_nr > 0 && bits_nr <= 32);
+	assert(bits_nr <= reader->bits_nr);
+
+	reader->bits_nr -= bits_nr;
+
+	return (reader->bits >> reader->bits_nr) & (0xffffffffU >> (32 - bits_nr));
+}
+
+
+/*
+ * Bit formats: describe a packet format once as a list of fixed-size bit
+ * fields, then generate the code that writes it and the code that reads it
+ *
+ * The list is a macro that takes two macro names as parameters and calls
+ * DISCR(value, bits_nr) for the discriminator, then FIELD(name, bits_nr) for
+ * every field, most significant bit first. ROHC_BIT_FORMAT(name, list) then
+ * generates:
+ *  - the struct name that holds the value of every field,
+ *  - the name_len constant, the length of the format in bytes,
+ *  - the name_write() function that writes the format with the bit writer,
+ *  - the name_read() function that reads the format with the bit reader.
+ */
+
+#define ROHC_BIT_FORMAT_DISCR_MEMBER(value, bits_nr) \
+	uint32_t discriminator;
+#define ROHC_BIT_FORMAT_FIELD_MEMBER(name, bits_nr) \
+	uint32_t name;
+
+#define ROHC_BIT_FORMAT_DISCR_BITS(value, bits_nr) \
+	+ (bits_nr)
+#define ROHC_BIT_FORMAT_FIELD_BITS(name, bits_nr) \
+	+ (bits_nr)
+
+#define ROHC_BIT_FORMAT_DISCR_PUT(value, bits_nr) \
+	rohc_bit_writer_put(&writer, (value), (bits_nr));
+#define ROHC_BIT_FORMAT_FIELD_PUT(name, bits_nr) \
+	rohc_bit_writer_put(&writer, fields->name, (bits_nr));
+
+#define ROHC_BIT_FORMAT_DISCR_GET(value, bits_nr) \
+	fields->discriminator = rohc_bit_reader_get(&reader, (bits_nr)); \
+	assert(fields->discriminator == (value));
+#define ROHC_BIT_FORMAT_FIELD_GET(name, bits_nr) \
+	fields->name = rohc_bit_reader_get(&reader, (bits_nr));
+
+#define ROHC_BIT_FORMAT(name, list) \
+	struct name \
+	{ \
+		list(ROHC_BIT_FORMAT_DISCR_MEMBER, ROHC_BIT_FORMAT_FIELD_MEMBER) \
+	}; \
+	\
+	enum \
+	{ \
+		name##_len = \
+			(0 list(ROHC_BIT_FORMAT_DISCR_BITS, ROHC_BIT_FORMAT_FIELD_BITS)) / 8 \
+	}; \
+	\
+	static inline size_t name##_write(const struct name *const fields, \
+	                                  uint8_t *const dest) \
+	{ \
+		struct rohc_bit_writer writer; \
+		rohc_bit_writer_init(&writer); \
+		list(ROHC_BIT_FORMAT_DISCR_PUT, ROHC_BIT_FORMAT_FIELD_PUT) \
+		return rohc_bit_writer_flush(&writer, dest); \
+	} \
+	\
+	static inline void name##_read(const uint8_t *const src, \
+	                               struct name *const fields) \
+	{ \
+		struct rohc_bit_reader reader; \
+		rohc_bit_reader_init(&reader, src, name##_len); \
+		list(ROHC_BIT_FORMAT_DISCR_GET, ROHC_BIT_FORMAT_FIELD_GET) \
+		assert(reader.bits_nr == 0); \
+	}
+
+#endif
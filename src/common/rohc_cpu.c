@@ -0,0 +1,72 @@
+/*
+ * Copyright 2016 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   rohc_cpu.c
+ * @brief  Detect the features of the running CPU
+ * @author Didier Barvaux <didier@barvaux.org>
+ */
+
+#include "rohc_cpu.h"
+
+#if !defined(__KERNEL__) && defined(__GNUC__) && \
+    defined(__aarch64__) && defined(__linux__)
+#  include <sys/auxv.h>
+#  include <asm/hwcap.h>
+#endif
+
+
+/** The features of the running CPU, see \ref rohc_cpu_feature_t */
+unsigned int rohc_cpu_features = 0;
+
+
+/**
+ * @brief Detect the features of the running CPU
+ *
+ * The detection is performed only once, the next calls do nothing. The
+ * specific implementations are never used in kernel mode: the kernel
+ * libraries are used instead.
+ */
+void rohc_cpu_init(void)
+{
+	unsigned int features = ROHC_CPU_FEATURE_DETECTED;
+
+	if(rohc_cpu_has(ROHC_CPU_FEATURE_DETECTED))
+	{
+		return;
+	}
+
+#if !defined(__KERNEL__) && defined(__GNUC__) && defined(__x86_64__)
+	__builtin_cpu_init();
+	if(__builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse4.1"))
+	{
+		features |= ROHC_CPU_FEATURE_X86_PCLMUL;
+	}
+#elif !defined(__KERNEL__) && defined(__GNUC__) && \
+      defined(__aarch64__) && defined(__linux__)
+	if((getauxval(AT_HWCAP) & HWCAP_CRC32) != 0)
+	{
+		features |= ROHC_CPU_FEATURE_ARMV8_CRC32;
+	}
+#endif
+
+	/* all the features are recorded at once, so concurrent calls only
+	 * store the same value */
+	rohc_cpu_features = features;
+}
+
@@ -0,0 +1,79 @@
+/*
+ * Copyright 2016 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   rohc_cpu.h
+ * @brief  Detect the features of the running CPU
+ * @author Didier Barvaux <didier@barvaux.org>
+ *
+ * The library is built for a generic CPU, but some of its hot kernels (CRC,
+ * checksums...) have versions for specific instruction sets. The features
+ * of the running CPU are detected once by \ref rohc_cpu_init when the first
+ * compressor or decompressor is created, then the kernels test them with
+ * \ref rohc_cpu_has to select the best implementation.
+ */
+
+#ifndef ROHC_COMMON_CPU_H
+#define ROHC_COMMON_CPU_H
+
+#ifdef __KERNEL__
+#  include <linux/types.h>
+#else
+#  include <stdbool.h>
+#endif
+
+
+/** The CPU features that the library may take advantage of */
+typedef enum
+{
+	/** Whether the CPU features were detected or not */
+	ROHC_CPU_FEATURE_DETECTED  = (1 << 0),
+	/** x86-64: carry-less multiplication (PCLMULQDQ) and SSE4.1 */
+	ROHC_CPU_FEATURE_X86_PCLMUL = (1 << 1),
+	/** ARMv8: CRC-32 instructions */
+	ROHC_CPU_FEATURE_ARMV8_CRC32 = (1 << 2),
+
+} rohc_cpu_feature_t;
+
+
+/** The features of the running CPU, see \ref rohc_cpu_feature_t */
+extern unsigned int rohc_cpu_features;
+
+
+void rohc_cpu_init(void);
+
+
+static inline bool rohc_cpu_has(const rohc_cpu_feature_t feature)
+	__attribute__((warn_unused_result, pure));
+
+/**
+ * @brief Whether the running CPU supports the given feature or not
+ *
+ * CPU features are not available before \ref rohc_cpu_init is called, so
+ * the generic implementations are used until then.
+ *
+ * @param feature  The CPU feature to test
+ * @return         true if the CPU supports the feature, false otherwise
+ */
+static inline bool rohc_cpu_has(const rohc_cpu_feature_t feature)
+{
+	return ((rohc_cpu_features & feature) != 0);
+}
+
+#endif
+
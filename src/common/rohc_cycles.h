@@ -0,0 +1,141 @@
+/*
+ * Copyright 2026 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   rohc_cycles.h
+ * @brief  Accounting of the CPU cycles spent in the stages of (de)compression
+ * @author Didier Barvaux <didier@barvaux.org>
+ *
+ * The cycles are accounted only if the --enable-stage-cycles option was given
+ * to the configure script. Without it, the macros below are removed at build
+ * time and the stages cost nothing.
+ *
+ * The cycles are read from the time-stamp counter on x86, from the virtual
+ * counter on ARM64, and from the monotonic clock (in nanoseconds) on the
+ * other architectures and in the Linux kernel.
+ *
+ * The stages shall not be nested, except for the CRC stage: the cycles spent
+ * to compute a CRC are removed from the stage that computes it, so that every
+ * stage accounts for its own work only.
+ */
+
+#ifndef ROHC_COMMON_CYCLES_H
+#define ROHC_COMMON_CYCLES_H
+
+#ifdef ROHC_STAGE_CYCLES
+
+#ifdef __KERNEL__
+#  include <linux/types.h>
+#  include <linux/ktime.h>
+#  include <linux/timekeeping.h>
+#else
+#  include <stdint.h>
+#  if defined(__x86_64__) || defined(__i386__)
+#    include <x86intrin.h>
+#  elif !defined(__aarch64__)
+#    include <time.h>
+#  endif
+#endif
+
+
+/**
+ * @brief The CPU cycles spent in the stages of a (de)compressor
+ *
+ * @param stages_nr  The number of stages
+ */
+#define ROHC_STAGE_CYCLES_DEFINE(stages_nr) \
+	struct \
+	{ \
+		uint64_t total[stages_nr]; /**< The cycles spent in every stage */ \
+		uint64_t start;            /**< When the current stage started */ \
+		uint64_t crc_start;        /**< When the current CRC started */ \
+		size_t cur;                /**< The current stage */ \
+	}
+
+
+static inline uint64_t rohc_cycles_now(void)
+	__attribute__((warn_unused_result));
+
+/**
+ * @brief Get the current value of the cycle counter
+ *
+ * @return  The current value of the cycle counter
+ */
+static inline uint64_t rohc_cycles_now(void)
+{
+#if defined(__KERNEL__)
+	return ktime_get_ns();
+#elif defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#elif defined(__aarch64__)
+	uint64_t cnt;
+
+	__asm__ __volatile__("isb; mrs %0, cntvct_el0" : "=r" (cnt) :: "memory");
+
+	return cnt;
+#else
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return ((uint64_t) now.tv_sec) * 1000000000U + now.tv_nsec;
+#endif
+}
+
+
+/** Start one stage of the (de)compression */
+#define rohc_cycles_begin(cycles, stage) \
+	do { \
+		(cycles)->cur = (stage); \
+		(cycles)->start = rohc_cycles_now(); \
+	} while(0)
+
+/** Stop one stage of the (de)compression */
+#define rohc_cycles_end(cycles, stage) \
+	do { \
+		(cycles)->total[stage] += rohc_cycles_now() - (cycles)->start; \
+	} while(0)
+
+/** Start the computation of one CRC within the current stage */
+#define rohc_cycles_crc_begin(cycles) \
+	do { \
+		(cycles)->crc_start = rohc_cycles_now(); \
+	} while(0)
+
+/** Stop the computation of one CRC, and remove it from the current stage */
+#define rohc_cycles_crc_end(cycles, crc_stage) \
+	do { \
+		const uint64_t _crc_cycles = rohc_cycles_now() - (cycles)->crc_start; \
+		(cycles)->total[crc_stage] += _crc_cycles; \
+		(cycles)->total[(cycles)->cur] -= _crc_cycles; \
+	} while(0)
+
+#else /* !ROHC_STAGE_CYCLES */
+
+#define rohc_cycles_begin(cycles, stage) \
+	do { } while(0)
+#define rohc_cycles_end(cycles, stage) \
+	do { } while(0)
+#define rohc_cycles_crc_begin(cycles) \
+	do { } while(0)
+#define rohc_cycles_crc_end(cycles, crc_stage) \
+	do { } while(0)
+
+#endif /* ROHC_STAGE_CYCLES */
+
+#endif
@@ -31,6 +31,7 @@
  */
 
 #include <stdlib.h> /* for free(3) */
+#include "rohc_alloc.h"
 
 
 /*
@@ -116,6 +116,8 @@
  */
 
 #include "rohc.h"
+#include "rohc_packets.h"
+#include "rohc_alloc.h"
 
 
 /**
@@ -131,5 +133,35 @@ struct rohc_medium
 };
 
 
+/**
+ * @brief The memory used by one (de)compression context
+ *
+ * @see rohc_memory_usage_t
+ */
+struct rohc_ctxt_mem
+{
+	size_t bytes;        /**< The bytes of the whole context */
+	size_t wlsb_bytes;   /**< The part used by W-LSB windows or references */
+	size_t lists_bytes;  /**< The part used by tables of list compression */
+};
+
+
+/**
+ * @brief Account for one packet in the given packet counters
+ *
+ * @param counters    The counters of the profile or of the packet type
+ * @param uncomp_len  The length of the uncompressed packet
+ * @param comp_len    The length of the compressed packet
+ */
+static inline void rohc_packet_counters_add(rohc_packet_counters_t *const counters,
+                                            const size_t uncomp_len,
+                                            const size_t comp_len)
+{
+	counters->packets_nr++;
+	counters->uncomp_bytes_nr += uncomp_len;
+	counters->comp_bytes_nr += comp_len;
+}
+
+
 #endif
 
@@ -0,0 +1,237 @@
+/*
+ * Copyright 2026 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   rohc_latency.c
+ * @brief  Histograms of the processing time of the ROHC packets
+ * @author Didier Barvaux <didier@barvaux.org>
+ */
+
+#include "rohc_latency.h"
+
+#ifndef __KERNEL__
+#  include <string.h>
+#endif
+#include <assert.h>
+
+
+static size_t rohc_latency_get_bucket(const uint64_t duration_ns)
+	__attribute__((warn_unused_result, const));
+
+static uint64_t rohc_latency_get_bucket_max(const size_t bucket)
+	__attribute__((warn_unused_result, const));
+
+static void rohc_latency_histo_add(struct rohc_latency_histo *const histo,
+                                   const size_t bucket,
+                                   const uint64_t duration_ns)
+	__attribute__((nonnull(1)));
+
+static void rohc_latency_summarize(const struct rohc_latency_histo histos[],
+                                   const size_t histos_nr,
+                                   rohc_latency_summary_t *const summary)
+	__attribute__((nonnull(1, 3)));
+
+
+/**
+ * @brief Record the processing time of one packet
+ *
+ * @param latency      The histograms of the (de)compressor
+ * @param profile_id   The profile of the packet
+ * @param packet_type  The type of the packet
+ * @param duration_ns  The processing time of the packet (in nanoseconds)
+ */
+void rohc_latency_add(struct rohc_latency *const latency,
+                      const rohc_profile_t profile_id,
+                      const rohc_packet_t packet_type,
+                      const uint64_t duration_ns)
+{
+	const size_t bucket = rohc_latency_get_bucket(duration_ns);
+
+	assert(profile_id < ROHC_PROFILE_MAX);
+	rohc_latency_histo_add(&latency->profiles[profile_id], bucket, duration_ns);
+	assert(packet_type < ROHC_PACKET_MAX);
+	rohc_latency_histo_add(&latency->packet_types[packet_type], bucket,
+	                       duration_ns);
+}
+
+
+/**
+ * @brief Summarize the histograms of a (de)compressor
+ *
+ * @param latency  The histograms of the (de)compressor, NULL if the latency
+ *                 was never recorded
+ * @param stats    OUT: The summaries of the histograms
+ */
+void rohc_latency_get_stats(const struct rohc_latency *const latency,
+                            rohc_latency_stats_t *const stats)
+{
+	size_t i;
+
+	if(latency == NULL)
+	{
+		memset(&stats->all, 0, sizeof(rohc_latency_summary_t));
+		memset(stats->profiles, 0,
+		       sizeof(rohc_latency_summary_t) * ROHC_PROFILE_MAX);
+		memset(stats->packet_types, 0,
+		       sizeof(rohc_latency_summary_t) * ROHC_PACKET_MAX);
+		return;
+	}
+
+	/* every packet is recorded in the histogram of its profile, so the
+	 * histograms of the profiles together describe all the packets */
+	rohc_latency_summarize(latency->profiles, ROHC_PROFILE_MAX, &stats->all);
+	for(i = 0; i < ROHC_PROFILE_MAX; i++)
+	{
+		rohc_latency_summarize(&latency->profiles[i], 1, &stats->profiles[i]);
+	}
+	for(i = 0; i < ROHC_PACKET_MAX; i++)
+	{
+		rohc_latency_summarize(&latency->packet_types[i], 1,
+		                       &stats->packet_types[i]);
+	}
+}
+
+
+/**
+ * @brief Get the bucket of the histogram for the given processing time
+ *
+ * @param duration_ns  The processing time (in nanoseconds)
+ * @return             The index of the bucket
+ */
+static size_t rohc_latency_get_bucket(const uint64_t duration_ns)
+{
+	const uint64_t max_ns = (((uint64_t) 1) << 32) - 1;
+	const uint64_t value = (duration_ns > max_ns ? max_ns : duration_ns);
+	size_t msb;
+
+	/* one bucket per value for the smallest values */
+	if(value < (1U << ROHC_LATENCY_SUB_BITS))
+	{
+		return value;
+	}
+
+	/* otherwise, the power of 2 selects a group of buckets and the next
+	 * most significant bits select the bucket within the group */
+	msb = 63 - __builtin_clzll(value);
+	return (((msb - ROHC_LATENCY_SUB_BITS + 1) << ROHC_LATENCY_SUB_BITS) +
+	        ((value >> (msb - ROHC_LATENCY_SUB_BITS)) &
+	         ((1U << ROHC_LATENCY_SUB_BITS) - 1)));
+}
+
+
+/**
+ * @brief Get the largest processing time recorded in the given bucket
+ *
+ * @param bucket  The index of the bucket
+ * @return        The largest processing time of the bucket (in nanoseconds)
+ */
+static uint64_t rohc_latency_get_bucket_max(const size_t bucket)
+{
+	const size_t group = bucket >> ROHC_LATENCY_SUB_BITS;
+	const size_t sub = bucket & ((1U << ROHC_LATENCY_SUB_BITS) - 1);
+	uint64_t width;
+
+	if(group == 0)
+	{
+		return bucket;
+	}
+	width = ((uint64_t) 1) << (group - 1);
+
+	return (((1U << ROHC_LATENCY_SUB_BITS) + sub + 1) * width - 1);
+}
+
+
+/**
+ * @brief Record the processing time of one packet in the given histogram
+ *
+ * @param histo        The histogram
+ * @param bucket       The bucket of the processing time
+ * @param duration_ns  The processing time (in nanoseconds)
+ */
+static void rohc_latency_histo_add(struct rohc_latency_histo *const histo,
+                                   const size_t bucket,
+                                   const uint64_t duration_ns)
+{
+	histo->buckets[bucket]++;
+	histo->packets_nr++;
+	histo->total_ns += duration_ns;
+	if(duration_ns > histo->max_ns)
+	{
+		histo->max_ns = duration_ns;
+	}
+}
+
+
+/**
+ * @brief Summarize one histogram or the sum of several histograms
+ *
+ * The histograms are summed bucket per bucket on the fly, so that no
+ * temporary histogram is required.
+ *
+ * @param histos     The histograms to summarize
+ * @param histos_nr  The number of histograms
+ * @param summary    OUT: The summary of the histograms
+ */
+static void rohc_latency_summarize(const struct rohc_latency_histo histos[],
+                                   const size_t histos_nr,
+                                   rohc_latency_summary_t *const summary)
+{
+	/* the percentiles to compute, in thousandths */
+	const unsigned int ranks[3] = { 500, 990, 999 };
+	uint64_t percentiles[3] = { 0, 0, 0 };
+	uint64_t packets_nr = 0;
+	uint64_t total_ns = 0;
+	uint64_t max_ns = 0;
+	uint64_t cumul = 0;
+	size_t rank = 0;
+	size_t bucket;
+	size_t i;
+
+	for(i = 0; i < histos_nr; i++)
+	{
+		packets_nr += histos[i].packets_nr;
+		total_ns += histos[i].total_ns;
+		if(histos[i].max_ns > max_ns)
+		{
+			max_ns = histos[i].max_ns;
+		}
+	}
+
+	/* walk the buckets until the packets of all the percentiles are found */
+	for(bucket = 0; bucket < ROHC_LATENCY_BUCKETS_NR && rank < 3; bucket++)
+	{
+		for(i = 0; i < histos_nr; i++)
+		{
+			cumul += histos[i].buckets[bucket];
+		}
+		while(rank < 3 && cumul > 0 &&
+		      cumul * 1000 >= packets_nr * ranks[rank])
+		{
+			const uint64_t bucket_max = rohc_latency_get_bucket_max(bucket);
+			percentiles[rank] = (bucket_max < max_ns ? bucket_max : max_ns);
+			rank++;
+		}
+	}
+
+	summary->packets_nr = packets_nr;
+	summary->total_ns = total_ns;
+	summary->max_ns = max_ns;
+	summary->p50_ns = percentiles[0];
+	summary->p99_ns = percentiles[1];
+	summary->p999_ns = percentiles[2];
+}
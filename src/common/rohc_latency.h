@@ -0,0 +1,106 @@
+/*
+ * Copyright 2026 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   rohc_latency.h
+ * @brief  Histograms of the processing time of the ROHC packets
+ * @author Didier Barvaux <didier@barvaux.org>
+ *
+ * The processing times are recorded in log-linear histograms: the values
+ * below 8 ns have one bucket each, then every power of 2 is divided in 8
+ * buckets of equal width. The width of a bucket is thus 12.5% of its lower
+ * bound at most, whatever the magnitude of the value. Values of 2^32 ns
+ * (about 4 seconds) and more are recorded in the last bucket.
+ */
+
+#ifndef ROHC_COMMON_LATENCY_H
+#define ROHC_COMMON_LATENCY_H
+
+#include "rohc_packets.h"
+
+#ifdef __KERNEL__
+#  include <linux/types.h>
+#  include <linux/ktime.h>
+#  include <linux/timekeeping.h>
+#else
+#  include <stdint.h>
+#  include <time.h>
+#endif
+
+
+/** The number of bits of the value that select the bucket within a power of 2 */
+#define ROHC_LATENCY_SUB_BITS  3U
+
+/** The number of buckets of one latency histogram */
+#define ROHC_LATENCY_BUCKETS_NR  ((32U - ROHC_LATENCY_SUB_BITS + 1U) << \
+                                  ROHC_LATENCY_SUB_BITS)
+
+
+/** The histogram of the processing time of some ROHC packets */
+struct rohc_latency_histo
+{
+	uint64_t buckets[ROHC_LATENCY_BUCKETS_NR]; /**< The number of packets per bucket */
+	uint64_t packets_nr;  /**< The number of packets */
+	uint64_t total_ns;    /**< The cumulative processing time */
+	uint64_t max_ns;      /**< The longest processing time */
+};
+
+
+/** The histograms of the processing time per profile and per packet type */
+struct rohc_latency
+{
+	/** The histograms of every profile, indexed by profile ID */
+	struct rohc_latency_histo profiles[ROHC_PROFILE_MAX];
+	/** The histograms of every packet type, indexed by packet type */
+	struct rohc_latency_histo packet_types[ROHC_PACKET_MAX];
+};
+
+
+void rohc_latency_add(struct rohc_latency *const latency,
+                      const rohc_profile_t profile_id,
+                      const rohc_packet_t packet_type,
+                      const uint64_t duration_ns)
+	__attribute__((nonnull(1)));
+
+void rohc_latency_get_stats(const struct rohc_latency *const latency,
+                            rohc_latency_stats_t *const stats)
+	__attribute__((nonnull(2)));
+
+
+static inline uint64_t rohc_latency_now(void)
+	__attribute__((warn_unused_result));
+
+/**
+ * @brief Get the current time of the monotonic clock
+ *
+ * @return  The current time (in nanoseconds)
+ */
+static inline uint64_t rohc_latency_now(void)
+{
+#ifdef __KERNEL__
+	return ktime_get_ns();
+#else
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return ((uint64_t) now.tv_sec) * 1000000000U + now.tv_nsec;
+#endif
+}
+
+#endif
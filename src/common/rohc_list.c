@@ -24,6 +24,7 @@
  */
 
 #include "rohc_list.h"
+#include "rohc_debug.h"
 
 #include <stdlib.h>
 #ifndef __KERNEL__
@@ -35,7 +36,8 @@
 static bool rohc_list_item_update(struct rohc_list_item *const list_item,
                                   const uint8_t item_type,
                                   const uint8_t *const item_data,
-                                  const size_t item_len)
+                                  const size_t item_len,
+                                  const uint64_t item_digest)
 	__attribute__((warn_unused_result, nonnull(1, 3)));
 
 
@@ -130,6 +132,200 @@ void rohc_list_item_reset(struct rohc_list_item *const list_item)
 
 	/* no data yet */
 	list_item->length = 0;
+	list_item->digest = 0;
+}
+
+
+/**
+ * @brief Free the memory allocated for the data of the given list item
+ *
+ * @param list_item  The item to free the data of
+ */
+void rohc_list_item_free(struct rohc_list_item *const list_item)
+{
+	assert(list_item != NULL);
+
+	zfree(list_item->data);
+	list_item->data_max_len = 0;
+	list_item->length = 0;
+	list_item->digest = 0;
+}
+
+
+/**
+ * @brief Compute the fingerprint of the given item data
+ *
+ * The fingerprint covers the item type, the item length and the item data
+ * but its first byte: the first byte of an IPv6 extension header is the
+ * Next Header field that the comparisons of items ignore. Two items with
+ * different fingerprints are different, two items with the same fingerprint
+ * shall be compared to be sure they are equal.
+ *
+ * @param item_type  The type of the item
+ * @param item_data  The item data
+ * @param item_len   The length (in bytes) of the item data
+ * @return           The 64-bit fingerprint of the item
+ */
+uint64_t rohc_list_item_digest(const uint8_t item_type,
+                               const uint8_t *const item_data,
+                               const size_t item_len)
+{
+	const uint64_t prime = 0x100000001b3ULL;
+	uint64_t digest = 0xcbf29ce484222325ULL;
+	size_t i;
+
+	digest = (digest ^ item_type) * prime;
+	digest = (digest ^ item_len) * prime;
+
+	/* hash 8 bytes at a time, then the remaining bytes one by one */
+	for(i = 1; (i + sizeof(uint64_t)) <= item_len; i += sizeof(uint64_t))
+	{
+		uint64_t word;
+		memcpy(&word, item_data + i, sizeof(uint64_t));
+		digest = (digest ^ word) * prime;
+		digest ^= digest >> 29;
+	}
+	for(; i < item_len; i++)
+	{
+		digest = (digest ^ item_data[i]) * prime;
+	}
+
+	return digest;
+}
+
+
+/**
+ * @brief Save one list in a snapshot
+ *
+ * @param list         The list to save
+ * @param trans_table  The translation table the items of the list belong to
+ * @param write_cb     The callback used to write the snapshot
+ * @param priv         The private context given to the callback
+ * @return             true if the list was saved, false if the callback failed
+ */
+bool rohc_list_snapshot(const struct rohc_list *const list,
+                        const struct rohc_list_item *const trans_table,
+                        const rohc_snapshot_write_t write_cb,
+                        void *const priv)
+{
+	struct rohc_list_snapshot record;
+	size_t i;
+
+	assert(list->items_nr <= ROHC_LIST_ITEMS_MAX);
+
+	memset(&record, 0, sizeof(struct rohc_list_snapshot));
+	record.counter = (list->counter > UINT32_MAX ? UINT32_MAX : list->counter);
+	record.id = list->id;
+	record.items_nr = list->items_nr;
+	for(i = 0; i < list->items_nr; i++)
+	{
+		assert(list->items[i] >= trans_table);
+		assert(list->items[i] < (trans_table + ROHC_LIST_MAX_ITEM));
+		record.items[i] = list->items[i] - trans_table;
+	}
+
+	return write_cb(priv, (uint8_t *) &record, sizeof(struct rohc_list_snapshot));
+}
+
+
+/**
+ * @brief Restore one list from its record in a snapshot
+ *
+ * @param list         The list to restore
+ * @param trans_table  The translation table the items of the list belong to
+ * @param record       The record of the list read from the snapshot
+ * @return             true if the list was restored,
+ *                     false if the record is malformed
+ */
+bool rohc_list_restore(struct rohc_list *const list,
+                       struct rohc_list_item *const trans_table,
+                       const struct rohc_list_snapshot *const record)
+{
+	size_t i;
+
+	if(record->items_nr > ROHC_LIST_ITEMS_MAX)
+	{
+		return false;
+	}
+
+	rohc_list_reset(list);
+	list->id = record->id;
+	list->items_nr = record->items_nr;
+	list->counter = record->counter;
+	for(i = 0; i < list->items_nr; i++)
+	{
+		if(record->items[i] >= ROHC_LIST_MAX_ITEM)
+		{
+			return false;
+		}
+		list->items[i] = &(trans_table[record->items[i]]);
+	}
+
+	return true;
+}
+
+
+/**
+ * @brief Save one item of a translation table in a snapshot
+ *
+ * @param item      The item to save
+ * @param write_cb  The callback used to write the snapshot
+ * @param priv      The private context given to the callback
+ * @return          true if the item was saved, false if the callback failed
+ */
+bool rohc_list_item_snapshot(const struct rohc_list_item *const item,
+                             const rohc_snapshot_write_t write_cb,
+                             void *const priv)
+{
+	struct rohc_list_item_snapshot record;
+
+	assert(item->length <= ROHC_LIST_ITEM_DATA_MAX);
+
+	memset(&record, 0, sizeof(struct rohc_list_item_snapshot));
+	record.digest = item->digest;
+	record.counter = (item->counter > UINT32_MAX ? UINT32_MAX : item->counter);
+	record.length = item->length;
+	record.type = item->type;
+	record.known = item->known;
+
+	return (write_cb(priv, (uint8_t *) &record,
+	                 sizeof(struct rohc_list_item_snapshot)) &&
+	        (item->length == 0 || write_cb(priv, item->data, item->length)));
+}
+
+
+/**
+ * @brief Restore one item of a translation table from a snapshot
+ *
+ * The data of the item follows its record in the snapshot. The memory of
+ * the item shall be large enough for the data.
+ *
+ * @param item     The item to restore
+ * @param record   The record of the item already read from the snapshot
+ * @param read_cb  The callback used to read the snapshot
+ * @param priv     The private context given to the callback
+ * @return         true if the item was restored,
+ *                 false if the callback failed
+ */
+bool rohc_list_item_restore(struct rohc_list_item *const item,
+                            const struct rohc_list_item_snapshot *const record,
+                            const rohc_snapshot_read_t read_cb,
+                            void *const priv)
+{
+	assert(record->length <= item->data_max_len);
+
+	rohc_list_item_reset(item);
+	if(record->length > 0 && !read_cb(priv, item->data, record->length))
+	{
+		return false;
+	}
+	item->type = record->type;
+	item->known = !!record->known;
+	item->counter = record->counter;
+	item->length = record->length;
+	item->digest = record->digest;
+
+	return true;
 }
 
 
@@ -151,13 +347,17 @@ int rohc_list_item_update_if_changed(rohc_list_item_cmp cmp_item,
                                      const uint8_t *const item_data,
                                      const size_t item_len)
 {
+	const uint64_t digest = rohc_list_item_digest(item_type, item_data, item_len);
 	int status;
 
 	assert(list_item != NULL);
 
-	if(!cmp_item(list_item, item_type, item_data, item_len))
+	/* compare the whole items only if their fingerprints match */
+	if(digest != list_item->digest ||
+	   !cmp_item(list_item, item_type, item_data, item_len))
 	{
-		if(rohc_list_item_update(list_item, item_type, item_data, item_len))
+		if(rohc_list_item_update(list_item, item_type, item_data, item_len,
+		                         digest))
 		{
 			status = 1;
 		}
@@ -178,29 +378,44 @@ int rohc_list_item_update_if_changed(rohc_list_item_cmp cmp_item,
 /**
  * @brief Update the content the given compressed item
  *
- * @param list_item  The item to update
- * @param item_type  The type of the item to update
- * @param item_data  The data to update item with
- * @param item_len   The data length (in bytes)
- * @return           true if the update was successful, false otherwise
+ * @param list_item    The item to update
+ * @param item_type    The type of the item to update
+ * @param item_data    The data to update item with
+ * @param item_len     The data length (in bytes)
+ * @param item_digest  The fingerprint of the data, see \ref rohc_list_item_digest
+ * @return             true if the update was successful, false otherwise
  */
 static bool rohc_list_item_update(struct rohc_list_item *const list_item,
                                   const uint8_t item_type,
                                   const uint8_t *const item_data,
-                                  const size_t item_len)
+                                  const size_t item_len,
+                                  const uint64_t item_digest)
 {
 	assert(list_item != NULL);
 
 	rohc_list_item_reset(list_item);
 
-	/* record new data for the item */
+	/* record new data for the item, grow the memory for the item data if
+	 * the new data is larger than all the previous ones */
 	if(item_len > ROHC_LIST_ITEM_DATA_MAX)
 	{
 		return false;
 	}
+	if(item_len > list_item->data_max_len)
+	{
+		uint8_t *const data = malloc(item_len);
+		if(data == NULL)
+		{
+			return false;
+		}
+		free(list_item->data);
+		list_item->data = data;
+		list_item->data_max_len = item_len;
+	}
 	memcpy(list_item->data, item_data, item_len);
 	list_item->length = item_len;
 	list_item->type = item_type;
+	list_item->digest = item_digest;
 
 	return true;
 }
@@ -26,14 +26,21 @@
 #ifndef ROHC_COMMON_LIST_H
 #define ROHC_COMMON_LIST_H
 
+#include "config.h" /* for ROHC_SMALL_CONTEXTS */
+#include "rohc.h" /* for rohc_snapshot_write_t and rohc_snapshot_read_t */
 #include "protocols/ipv6.h"
 #include "protocols/ip_numbers.h"
 
 #include <stdlib.h>
 
 
-/** The maximum number of items in compressed lists */
-#define ROHC_LIST_MAX_ITEM  16U
+/** The maximum number of items in compressed lists, small contexts keep
+ *  only the items whose indexes fit in the 4-bit XI format */
+#if ROHC_SMALL_CONTEXTS == 1
+#  define ROHC_LIST_MAX_ITEM  8U
+#else
+#  define ROHC_LIST_MAX_ITEM  16U
+#endif
 #if ROHC_LIST_MAX_ITEM <= 7
 #  error "translation table must be larger enough for indexes stored on 3 bits"
 #endif
@@ -46,7 +53,7 @@ typedef enum
 	RTHDR  = ROHC_IPPROTO_ROUTING,  /**< Routing header */
 	AH     = ROHC_IPPROTO_AH,       /**< AH header */
 	DEST   = ROHC_IPPROTO_DSTOPTS,  /**< Destination header */
-	/* CSRC lists not supported yet */
+	/* the CSRC items have no type, they use type 0 */
 } ext_header_version;
 
 
@@ -97,8 +104,14 @@ struct rohc_list_item
 
 	/** The length of the item data (in bytes) */
 	size_t length;
-	/** The item data */
-	uint8_t data[ROHC_LIST_ITEM_DATA_MAX];
+	/** The length (in bytes) of the memory allocated for the item data */
+	size_t data_max_len;
+	/** The item data, allocated at the length of the largest data that was
+	 *  recorded in the item since most items are far smaller than
+	 *  \ref ROHC_LIST_ITEM_DATA_MAX */
+	uint8_t *data;
+	/** The fingerprint of the item data, see \ref rohc_list_item_digest */
+	uint64_t digest;
 };
 
 
@@ -111,6 +124,36 @@ typedef bool (*rohc_list_item_cmp) (const struct rohc_list_item *const item,
 
 
 
+/**
+ * @brief One item of a translation table in a snapshot
+ *
+ * The record is followed by the data of the item.
+ */
+struct rohc_list_item_snapshot
+{
+	uint64_t digest;   /**< The fingerprint of the item data */
+	uint32_t counter;  /**< How many times the item was transmitted */
+	uint16_t length;   /**< The length (in bytes) of the item data */
+	uint8_t type;      /**< The type of the item */
+	uint8_t known;     /**< Whether the item is known by the other side */
+} __attribute__((packed));
+
+
+/**
+ * @brief One list in a snapshot
+ *
+ * The items of the list are given by their indexes in the translation table.
+ */
+struct rohc_list_snapshot
+{
+	uint32_t counter;                     /**< How many times the list was
+	                                           transmitted */
+	uint16_t id;                          /**< The gen_id of the list */
+	uint8_t items_nr;                     /**< The number of items */
+	uint8_t items[ROHC_LIST_ITEMS_MAX];   /**< The indexes of the items */
+} __attribute__((packed));
+
+
 /**
  * Functions prototypes
  */
@@ -129,6 +172,36 @@ bool rohc_list_supersede(const struct rohc_list *const large,
 void rohc_list_item_reset(struct rohc_list_item *const list_item)
 	__attribute__((nonnull(1)));
 
+void rohc_list_item_free(struct rohc_list_item *const list_item)
+	__attribute__((nonnull(1)));
+
+uint64_t rohc_list_item_digest(const uint8_t item_type,
+                               const uint8_t *const item_data,
+                               const size_t item_len)
+	__attribute__((warn_unused_result, nonnull(2), pure));
+
+bool rohc_list_snapshot(const struct rohc_list *const list,
+                        const struct rohc_list_item *const trans_table,
+                        const rohc_snapshot_write_t write_cb,
+                        void *const priv)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+
+bool rohc_list_restore(struct rohc_list *const list,
+                       struct rohc_list_item *const trans_table,
+                       const struct rohc_list_snapshot *const record)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+
+bool rohc_list_item_snapshot(const struct rohc_list_item *const item,
+                             const rohc_snapshot_write_t write_cb,
+                             void *const priv)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
+bool rohc_list_item_restore(struct rohc_list_item *const item,
+                            const struct rohc_list_item_snapshot *const record,
+                            const rohc_snapshot_read_t read_cb,
+                            void *const priv)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+
 int rohc_list_item_update_if_changed(rohc_list_item_cmp cmp_item,
                                      struct rohc_list_item *const list_item,
                                      const uint8_t item_type,
@@ -26,6 +26,8 @@
 #ifndef ROHC_PACKETS_H
 #define ROHC_PACKETS_H
 
+#include <rohc/rohc.h> /* for ROHC_PROFILE_MAX */
+
 #ifdef __cplusplus
 extern "C"
 {
@@ -114,6 +116,119 @@ typedef enum
 } rohc_ext_t;
 
 
+/**
+ * @brief The counters of the ROHC packets of one profile or one packet type
+ *
+ * @ingroup rohc
+ *
+ * @see rohc_packet_stats_t
+ */
+typedef struct
+{
+	/** The number of packets */
+	unsigned long packets_nr;
+	/** The number of uncompressed bytes of the packets */
+	unsigned long uncomp_bytes_nr;
+	/** The number of compressed bytes of the packets */
+	unsigned long comp_bytes_nr;
+} __attribute__((packed)) rohc_packet_counters_t;
+
+
+/**
+ * @brief The counters of ROHC packets per profile and per packet type
+ *
+ * The structure is used by the \ref rohc_comp_get_packet_stats and
+ * \ref rohc_decomp_get_packet_stats functions to report, in one call, how
+ * many packets and bytes every profile and every packet type accounted for.
+ * Only the packets successfully compressed or decompressed are counted.
+ *
+ * Versioning works as for \ref rohc_comp_general_info_t.
+ *
+ * Supported versions:
+ *  - major 0 and minor = 0 contains: version_major, version_minor,
+ *    profiles, and packet_types.
+ *
+ * @ingroup rohc
+ *
+ * @see rohc_comp_get_packet_stats
+ * @see rohc_decomp_get_packet_stats
+ */
+typedef struct
+{
+	/** The major version of this structure */
+	unsigned short version_major;
+	/** The minor version of this structure */
+	unsigned short version_minor;
+	/** The counters of every profile, indexed by profile ID */
+	rohc_packet_counters_t profiles[ROHC_PROFILE_MAX];
+	/** The counters of every packet type, indexed by packet type */
+	rohc_packet_counters_t packet_types[ROHC_PACKET_MAX];
+} __attribute__((packed)) rohc_packet_stats_t;
+
+
+/**
+ * @brief The latency of the ROHC packets of one profile or one packet type
+ *
+ * The percentiles are the upper bounds of the buckets of the histogram that
+ * contain them, so they overestimate the real latency by 12.5% at most.
+ *
+ * @ingroup rohc
+ *
+ * @see rohc_latency_stats_t
+ */
+typedef struct
+{
+	/** The number of packets */
+	unsigned long packets_nr;
+	/** The cumulative processing time of the packets (in nanoseconds) */
+	uint64_t total_ns;
+	/** The longest processing time of one packet (in nanoseconds) */
+	uint64_t max_ns;
+	/** The median processing time (in nanoseconds) */
+	uint64_t p50_ns;
+	/** The 99th percentile of the processing time (in nanoseconds) */
+	uint64_t p99_ns;
+	/** The 99.9th percentile of the processing time (in nanoseconds) */
+	uint64_t p999_ns;
+} __attribute__((packed)) rohc_latency_summary_t;
+
+
+/**
+ * @brief The latency of ROHC packets per profile and per packet type
+ *
+ * The structure is used by the \ref rohc_comp_get_latency_stats and
+ * \ref rohc_decomp_get_latency_stats functions to report the processing time
+ * of the packets, from the entry of the (de)compression function to its exit.
+ * The processing times are recorded only when the latency feature is enabled
+ * (see \ref ROHC_COMP_FEATURE_LATENCY and \ref ROHC_DECOMP_FEATURE_LATENCY)
+ * and only for the packets successfully compressed or decompressed.
+ *
+ * Versioning works as for \ref rohc_comp_general_info_t.
+ *
+ * Supported versions:
+ *  - major 0 and minor = 0 contains: version_major, version_minor, all,
+ *    profiles, and packet_types.
+ *
+ * @ingroup rohc
+ *
+ * @see rohc_comp_get_latency_stats
+ * @see rohc_decomp_get_latency_stats
+ */
+typedef struct
+{
+	/** The major version of this structure */
+	unsigned short version_major;
+	/** The minor version of this structure */
+	unsigned short version_minor;
+	/** The latency of all the packets */
+	rohc_latency_summary_t all;
+	/** The latency of every profile, indexed by profile ID */
+	rohc_latency_summary_t profiles[ROHC_PROFILE_MAX];
+	/** The latency of every packet type, indexed by packet type */
+	rohc_latency_summary_t packet_types[ROHC_PACKET_MAX];
+} __attribute__((packed)) rohc_latency_stats_t;
+
+
 /*
  * Prototypes of public functions
  */
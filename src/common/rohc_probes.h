@@ -0,0 +1,69 @@
+/*
+ * Copyright 2026 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   rohc_probes.h
+ * @brief  USDT probes on the key events of the ROHC library
+ * @author Didier Barvaux <didier@barvaux.org>
+ *
+ * The probes are built in the library if the --enable-usdt-probes option was
+ * given to the configure script. They are then visible by tools like
+ * bpftrace or perf with the 'rohc' provider, for example:
+ *
+ *   bpftrace -e 'usdt:/usr/lib/librohc.so:rohc:comp_state_change
+ *                { printf("CID %d: %d -> %d\n", arg1, arg2, arg3); }'
+ *
+ * A probe is a single no-op instruction as long as no tool is attached to
+ * it. Without the configure option, or for the Linux kernel module, the
+ * probes are removed at build time.
+ *
+ * The first argument of every probe is the compressor or the decompressor,
+ * the second one is the CID of the context. See the probe points for the
+ * other arguments.
+ */
+
+#ifndef ROHC_COMMON_PROBES_H
+#define ROHC_COMMON_PROBES_H
+
+#if defined(ROHC_USDT_PROBES) && !defined(__KERNEL__)
+
+#include <sys/sdt.h>
+
+#define rohc_probe2(name, arg1, arg2) \
+	DTRACE_PROBE2(rohc, name, arg1, arg2)
+#define rohc_probe3(name, arg1, arg2, arg3) \
+	DTRACE_PROBE3(rohc, name, arg1, arg2, arg3)
+#define rohc_probe4(name, arg1, arg2, arg3, arg4) \
+	DTRACE_PROBE4(rohc, name, arg1, arg2, arg3, arg4)
+#define rohc_probe5(name, arg1, arg2, arg3, arg4, arg5) \
+	DTRACE_PROBE5(rohc, name, arg1, arg2, arg3, arg4, arg5)
+
+#else
+
+#define rohc_probe2(name, arg1, arg2) \
+	do { } while(0)
+#define rohc_probe3(name, arg1, arg2, arg3) \
+	do { } while(0)
+#define rohc_probe4(name, arg1, arg2, arg3, arg4) \
+	do { } while(0)
+#define rohc_probe5(name, arg1, arg2, arg3, arg4, arg5) \
+	do { } while(0)
+
+#endif
+
+#endif
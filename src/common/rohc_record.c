@@ -0,0 +1,95 @@
+/*
+ * Copyright 2026 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   rohc_record.c
+ * @brief  The recordings of workloads
+ * @author Didier Barvaux <didier@barvaux.org>
+ */
+
+#include "rohc_record.h"
+#include "rohc_utils.h"
+
+
+/**
+ * @brief Record one input of a compressor or a decompressor
+ *
+ * The event record is written, then the bytes of the input. The input is
+ * truncated to the maximum length of the recorder if any.
+ *
+ * @param recorder  The recorder, it shall be recording
+ * @param type      The kind of input
+ * @param cid       The CID chosen by the application for the input,
+ *                  \ref ROHC_RECORD_NO_CID if none
+ * @param input     The buffers of the input, the first one gives the time
+ * @param input_nr  The number of buffers of the input
+ * @return          true if the input was recorded,
+ *                  false if the callback failed to write it
+ */
+bool rohc_record_event(const struct rohc_recorder *const recorder,
+                       const enum rohc_record_event_type type,
+                       const uint32_t cid,
+                       const struct rohc_buf input[],
+                       const size_t input_nr)
+{
+	struct rohc_record_event event;
+	size_t remain_len;
+	size_t i;
+
+	event.type = type;
+	event.flags = 0;
+	event.reserved = 0;
+	event.cid = cid;
+	event.sec = input[0].time.sec;
+	event.nsec = input[0].time.nsec;
+	event.orig_len = 0;
+	for(i = 0; i < input_nr; i++)
+	{
+		event.orig_len += input[i].len;
+	}
+	event.len = event.orig_len;
+	if(recorder->max_len > 0 && event.len > recorder->max_len)
+	{
+		event.len = recorder->max_len;
+		event.flags |= ROHC_RECORD_TRUNCATED;
+	}
+
+	if(!recorder->write_cb(recorder->priv, (const uint8_t *) &event,
+	                       sizeof(struct rohc_record_event)))
+	{
+		goto error;
+	}
+	remain_len = event.len;
+	for(i = 0; i < input_nr && remain_len > 0; i++)
+	{
+		const size_t len = rohc_min(input[i].len, remain_len);
+
+		if(len > 0 &&
+		   !recorder->write_cb(recorder->priv, rohc_buf_data(input[i]), len))
+		{
+			goto error;
+		}
+		remain_len -= len;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
@@ -0,0 +1,134 @@
+/*
+ * Copyright 2026 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   rohc_record.h
+ * @brief  The binary format of the recordings of workloads
+ * @author Didier Barvaux <didier@barvaux.org>
+ *
+ * A recording is the exact sequence of the inputs given to one compressor or
+ * one decompressor, so that the workload may be replayed against another
+ * build of the library. It is a stream of records written one after the
+ * other:
+ *  \li one header that identifies the format and holds the configuration
+ *      of the instance when the recording started,
+ *  \li one event record per input: the packets given to the compressor or
+ *      to the decompressor, and the feedback given to the compressor. Every
+ *      event record is followed by the bytes of the input, possibly
+ *      truncated to the length given when the recording started.
+ *
+ * The records are stored in the byte order of the host, like the snapshots:
+ * a recording is meant to be replayed on the same kind of host. The version
+ * shall be increased whenever the format changes.
+ */
+
+#ifndef ROHC_COMMON_RECORD_H
+#define ROHC_COMMON_RECORD_H
+
+#include "rohc.h"
+#include "rohc_buf.h"
+
+#include <stdint.h>
+
+
+/** The magic number at the beginning of every recording ("ROHR") */
+#define ROHC_RECORD_MAGIC         0x524f4852U
+
+/** The version of the format of recordings */
+#define ROHC_RECORD_VERSION       1U
+
+/** The maximum number of enabled profiles in the header of a recording */
+#define ROHC_RECORD_PROFILES_MAX  16U
+
+/** The CID of the packets whose context was not chosen by the application */
+#define ROHC_RECORD_NO_CID        0xffffffffU
+
+/** The flag of the event records whose input was truncated */
+#define ROHC_RECORD_TRUNCATED     0x01U
+
+
+/** The kind of instance a recording was taken from */
+enum rohc_record_entity
+{
+	ROHC_RECORD_COMP   = 0,  /**< A ROHC compressor */
+	ROHC_RECORD_DECOMP = 1,  /**< A ROHC decompressor */
+};
+
+
+/** The kind of input of one event record */
+enum rohc_record_event_type
+{
+	ROHC_RECORD_PKT      = 0,  /**< A packet to (de)compress */
+	ROHC_RECORD_FEEDBACK = 1,  /**< Feedback delivered to the compressor */
+};
+
+
+/** The header of one recording */
+struct rohc_record_hdr
+{
+	uint32_t magic;        /**< Always \ref ROHC_RECORD_MAGIC */
+	uint8_t version;       /**< The version of the format */
+	uint8_t entity;        /**< The kind of instance, see rohc_record_entity */
+	uint8_t cid_type;      /**< The type of CIDs of the instance */
+	uint8_t profiles_nr;   /**< The number of enabled profiles */
+	uint16_t max_cid;      /**< The MAX_CID of the instance */
+	uint16_t param;        /**< The width of the W-LSB windows for a
+	                            compressor, the operation mode for a
+	                            decompressor */
+	uint32_t features;     /**< The features of the instance */
+	uint32_t mrru;         /**< The MRRU of the instance */
+	uint16_t profiles[ROHC_RECORD_PROFILES_MAX]; /**< The enabled profiles */
+} __attribute__((packed));
+
+
+/** The record of one input of a recording */
+struct rohc_record_event
+{
+	uint8_t type;       /**< The kind of input, see rohc_record_event_type */
+	uint8_t flags;      /**< \ref ROHC_RECORD_TRUNCATED or 0 */
+	uint16_t reserved;  /**< Always 0 */
+	uint32_t cid;       /**< The CID chosen by the application for the
+	                         packet, \ref ROHC_RECORD_NO_CID if none */
+	uint32_t sec;       /**< The arrival time of the input (seconds) */
+	uint32_t nsec;      /**< The arrival time of the input (nanoseconds) */
+	uint32_t orig_len;  /**< The length of the input */
+	uint32_t len;       /**< The number of bytes of the input that follow */
+} __attribute__((packed));
+
+
+/** The recorder of the inputs of one compressor or decompressor */
+struct rohc_recorder
+{
+	/** The callback that writes the recording, NULL if not recording */
+	rohc_record_write_t write_cb;
+	/** The private context of the callback */
+	void *priv;
+	/** The maximum number of bytes recorded per input, 0 for all of them */
+	size_t max_len;
+};
+
+
+bool rohc_record_event(const struct rohc_recorder *const recorder,
+                       const enum rohc_record_event_type type,
+                       const uint32_t cid,
+                       const struct rohc_buf input[],
+                       const size_t input_nr)
+	__attribute__((warn_unused_result, nonnull(1, 4)));
+
+#endif
+
@@ -0,0 +1,106 @@
+/*
+ * Copyright 2026 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   rohc_seqlock.h
+ * @brief  Sequence lock between one writer and readers of other threads
+ * @author Didier Barvaux <didier@barvaux.org>
+ *
+ * The writer never waits: it makes the sequence number odd before it updates
+ * the protected data with plain stores, and even again afterwards. A reader
+ * copies the protected data, then copies it again if the sequence number was
+ * odd or changed meanwhile. The readers never write the sequence number, so
+ * they may read from a const object.
+ */
+
+#ifndef ROHC_COMMON_SEQLOCK_H
+#define ROHC_COMMON_SEQLOCK_H
+
+#ifdef __KERNEL__
+#  include <linux/types.h>
+#else
+#  include <stdbool.h>
+#endif
+
+
+/** The sequence number of a sequence lock, odd while the writer writes */
+typedef unsigned int rohc_seqlock_t;
+
+
+/**
+ * @brief Start updating the data protected by the sequence lock
+ *
+ * @param seq  The sequence lock, only written by the calling thread
+ */
+static inline void rohc_seqlock_write_begin(rohc_seqlock_t *const seq)
+{
+	__atomic_store_n(seq, (*seq) + 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+
+/**
+ * @brief Stop updating the data protected by the sequence lock
+ *
+ * @param seq  The sequence lock, only written by the calling thread
+ */
+static inline void rohc_seqlock_write_end(rohc_seqlock_t *const seq)
+{
+	__atomic_store_n(seq, (*seq) + 1, __ATOMIC_RELEASE);
+}
+
+
+/**
+ * @brief Start reading the data protected by the sequence lock
+ *
+ * Wait for the writer to stop updating the data if it is doing so.
+ *
+ * @param seq  The sequence lock
+ * @return     The sequence number to give to \ref rohc_seqlock_read_retry
+ */
+static inline rohc_seqlock_t rohc_seqlock_read_begin(const rohc_seqlock_t *const seq)
+{
+	rohc_seqlock_t start;
+
+	do
+	{
+		start = __atomic_load_n(seq, __ATOMIC_ACQUIRE);
+	}
+	while((start & 1) != 0);
+
+	return start;
+}
+
+
+/**
+ * @brief Whether the data read since \ref rohc_seqlock_read_begin shall be
+ *        read again
+ *
+ * @param seq    The sequence lock
+ * @param start  The sequence number given by \ref rohc_seqlock_read_begin
+ * @return       true if the writer updated the data meanwhile,
+ *               false if the data read is consistent
+ */
+static inline bool rohc_seqlock_read_retry(const rohc_seqlock_t *const seq,
+                                           const rohc_seqlock_t start)
+{
+	__atomic_thread_fence(__ATOMIC_ACQUIRE);
+	return (__atomic_load_n(seq, __ATOMIC_RELAXED) != start);
+}
+
+#endif
@@ -0,0 +1,220 @@
+/*
+ * Copyright 2026 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   rohc_slab.c
+ * @brief  Preallocated objects of one given size
+ * @author Didier Barvaux <didier@barvaux.org>
+ */
+
+#include "rohc_slab.h"
+#include "rohc_alloc.h"
+
+#ifndef __KERNEL__
+#  include <string.h>
+#endif
+#include <stdlib.h>
+
+
+/**
+ * @brief Allocate one object with its header from the system
+ *
+ * @param size       The size of the object
+ * @param numa_node  The NUMA node to place the object on
+ * @return           The header of the object, NULL in case of failure
+ */
+static struct rohc_slab_obj * rohc_slab_new_obj(const size_t size,
+                                                const int numa_node)
+{
+	struct rohc_slab_obj *obj;
+
+	if(size > (((size_t) -1) - sizeof(struct rohc_slab_obj)))
+	{
+		return NULL;
+	}
+	obj = rohc_alloc_malloc_node(sizeof(struct rohc_slab_obj) + size, numa_node);
+	if(obj != NULL)
+	{
+		obj->next = NULL;
+		obj->size = size;
+	}
+
+	return obj;
+}
+
+
+/**
+ * @brief Create a slab with the given number of free objects
+ *
+ * The objects allocated in advance are filled with zeroes, so that their
+ * pages are mapped before they are used. The slab shall be released with
+ * \ref rohc_slab_fini, even if its creation failed.
+ *
+ * @param[out] slab  The slab to create
+ * @param obj_size   The size of the objects
+ * @param objs_nr    The number of objects to allocate in advance, 0 for none
+ * @param numa_node  The NUMA node to place the objects on
+ * @return           true if all the objects were allocated,
+ *                   false if the system ran out of memory
+ */
+bool rohc_slab_init(struct rohc_slab *const slab,
+                    const size_t obj_size,
+                    const size_t objs_nr,
+                    const int numa_node)
+{
+	slab->free_objs = NULL;
+	slab->free_nr = 0;
+	slab->objs_nr = 0;
+	slab->obj_size = obj_size;
+
+	return rohc_slab_reserve(slab, obj_size, objs_nr, numa_node);
+}
+
+
+/**
+ * @brief Make the slab hold at least the given number of free objects
+ *
+ * The slab keeps up to that many free objects from now on. The new objects
+ * are filled with zeroes, so that their pages are mapped before they are
+ * used. If the objects of the slab have another size, the free objects are
+ * released first.
+ *
+ * @param slab       The slab
+ * @param obj_size   The size of the objects
+ * @param objs_nr    The number of free objects
+ * @param numa_node  The NUMA node to place the new objects on
+ * @return           true if all the objects were allocated,
+ *                   false if the system ran out of memory
+ */
+bool rohc_slab_reserve(struct rohc_slab *const slab,
+                       const size_t obj_size,
+                       const size_t objs_nr,
+                       const int numa_node)
+{
+	if(slab->obj_size != obj_size)
+	{
+		rohc_slab_fini(slab);
+		slab->obj_size = obj_size;
+	}
+	if(slab->objs_nr < objs_nr)
+	{
+		slab->objs_nr = objs_nr;
+	}
+
+	while(slab->free_nr < objs_nr)
+	{
+		struct rohc_slab_obj *const obj = rohc_slab_new_obj(obj_size, numa_node);
+
+		if(obj == NULL)
+		{
+			return false;
+		}
+		memset(obj + 1, 0, obj_size);
+		obj->next = slab->free_objs;
+		slab->free_objs = obj;
+		slab->free_nr++;
+	}
+
+	return true;
+}
+
+
+/**
+ * @brief Release the free objects of the slab
+ *
+ * The objects given by the slab and not given back yet stay valid. The slab
+ * keeps no object anymore: the objects given back later are released to the
+ * system.
+ *
+ * @param slab  The slab to release
+ */
+void rohc_slab_fini(struct rohc_slab *const slab)
+{
+	while(slab->free_objs != NULL)
+	{
+		struct rohc_slab_obj *const obj = slab->free_objs;
+
+		slab->free_objs = obj->next;
+		free(obj);
+	}
+	slab->free_nr = 0;
+	slab->objs_nr = 0;
+}
+
+
+/**
+ * @brief Take one object from the slab
+ *
+ * The content of the object is undefined.
+ *
+ * @param slab       The slab, NULL to allocate the object from the system
+ * @param size       The size of the object
+ * @param numa_node  The NUMA node to place the object on if it is allocated
+ *                   from the system
+ * @return           The object, NULL if the system ran out of memory
+ */
+void * rohc_slab_alloc(struct rohc_slab *const slab,
+                       const size_t size,
+                       const int numa_node)
+{
+	struct rohc_slab_obj *obj;
+
+	if(slab != NULL && slab->free_objs != NULL && size == slab->obj_size)
+	{
+		obj = slab->free_objs;
+		slab->free_objs = obj->next;
+		slab->free_nr--;
+	}
+	else
+	{
+		obj = rohc_slab_new_obj(size, numa_node);
+		if(obj == NULL)
+		{
+			return NULL;
+		}
+	}
+
+	return (obj + 1);
+}
+
+
+/**
+ * @brief Give back one object to the slab
+ *
+ * @param slab  The slab, NULL to release the object to the system
+ * @param obj   The object given by \ref rohc_slab_alloc, may be NULL
+ */
+void rohc_slab_free(struct rohc_slab *const slab, void *const obj)
+{
+	if(obj != NULL)
+	{
+		struct rohc_slab_obj *const hdr = ((struct rohc_slab_obj *) obj) - 1;
+
+		if(slab != NULL && hdr->size == slab->obj_size &&
+		   slab->free_nr < slab->objs_nr)
+		{
+			hdr->next = slab->free_objs;
+			slab->free_objs = hdr;
+			slab->free_nr++;
+		}
+		else
+		{
+			free(hdr);
+		}
+	}
+}
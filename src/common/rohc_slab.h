@@ -0,0 +1,86 @@
+/*
+ * Copyright 2026 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   rohc_slab.h
+ * @brief  Preallocated objects of one given size
+ * @author Didier Barvaux <didier@barvaux.org>
+ *
+ * A slab keeps a stack of objects of the same size allocated in advance, so
+ * that taking one object costs no memory allocation. When the slab is empty,
+ * or when the object is larger than the objects of the slab, the object is
+ * allocated from the system.
+ *
+ * Every object carries a small header with its size: an object may be given
+ * back to any slab, it is kept only if it has the size of the objects of the
+ * slab and if the slab is not full, it is released to the system otherwise.
+ * Objects may thus move from one owner to another one safely.
+ */
+
+#ifndef ROHC_COMMON_SLAB_H
+#define ROHC_COMMON_SLAB_H
+
+#ifdef __KERNEL__
+#  include <linux/types.h>
+#else
+#  include <stdbool.h>
+#  include <stddef.h>
+#endif
+
+
+/** The header in front of every object given by a slab */
+struct rohc_slab_obj
+{
+	struct rohc_slab_obj *next;  /**< The next free object of the slab */
+	size_t size;                 /**< The size of the object */
+} __attribute__((aligned(16)));
+
+
+/** A slab of objects of one given size */
+struct rohc_slab
+{
+	struct rohc_slab_obj *free_objs;  /**< The stack of the free objects */
+	size_t free_nr;                   /**< The number of free objects */
+	size_t objs_nr;                   /**< The maximum number of free objects */
+	size_t obj_size;                  /**< The size of the objects */
+};
+
+
+bool rohc_slab_init(struct rohc_slab *const slab,
+                    const size_t obj_size,
+                    const size_t objs_nr,
+                    const int numa_node)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+bool rohc_slab_reserve(struct rohc_slab *const slab,
+                       const size_t obj_size,
+                       const size_t objs_nr,
+                       const int numa_node)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+void rohc_slab_fini(struct rohc_slab *const slab)
+	__attribute__((nonnull(1)));
+
+void * rohc_slab_alloc(struct rohc_slab *const slab,
+                       const size_t size,
+                       const int numa_node)
+	__attribute__((warn_unused_result));
+
+void rohc_slab_free(struct rohc_slab *const slab, void *const obj);
+
+#endif
@@ -0,0 +1,75 @@
+/*
+ * Copyright 2016 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   rohc_snapshot.h
+ * @brief  The binary format of the snapshots of compressors and decompressors
+ * @author Didier Barvaux <didier@barvaux.org>
+ *
+ * A snapshot is a stream of records written one after the other, so that it
+ * never needs to be held in memory as a whole:
+ *  \li one header that identifies the format and the instance,
+ *  \li one record per context: a generic part followed by the data of the
+ *      profile, whose layout is the profile's own business,
+ *  \li one end record, ie. a context record with the profile ID
+ *      \ref ROHC_SNAPSHOT_END and nothing else.
+ *
+ * The records are stored in the byte order of the host and the profile data
+ * mirrors the structures of the library: a snapshot is meant to be restored
+ * by the same build of the library, on the same kind of host. The version
+ * shall be increased whenever the format changes.
+ */
+
+#ifndef ROHC_COMMON_SNAPSHOT_H
+#define ROHC_COMMON_SNAPSHOT_H
+
+#include <stdint.h>
+
+
+/** The magic number at the beginning of every snapshot ("ROHC") */
+#define ROHC_SNAPSHOT_MAGIC    0x524f4843U
+
+/** The version of the format of snapshots */
+#define ROHC_SNAPSHOT_VERSION  1U
+
+/** The profile ID of the record that ends the snapshot */
+#define ROHC_SNAPSHOT_END      0xffffU
+
+
+/** The kind of instance a snapshot was taken from */
+enum rohc_snapshot_entity
+{
+	ROHC_SNAPSHOT_COMP   = 0,  /**< A ROHC compressor */
+	ROHC_SNAPSHOT_DECOMP = 1,  /**< A ROHC decompressor */
+};
+
+
+/** The header of one snapshot */
+struct rohc_snapshot_hdr
+{
+	uint32_t magic;     /**< Always \ref ROHC_SNAPSHOT_MAGIC */
+	uint8_t version;    /**< The version of the format */
+	uint8_t entity;     /**< The kind of instance, see rohc_snapshot_entity */
+	uint8_t cid_type;   /**< The type of CIDs of the instance */
+	uint8_t reserved;   /**< Always 0 */
+	uint16_t max_cid;   /**< The MAX_CID of the instance */
+	uint16_t reserved2; /**< Always 0 */
+} __attribute__((packed));
+
+#endif
+
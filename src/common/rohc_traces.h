@@ -34,6 +34,8 @@ extern "C"
 {
 #endif
 
+#include <stdint.h>
+
 
 /**
  * @brief A general profile number used for traces not related to a specific
@@ -132,6 +134,68 @@ typedef void (*rohc_trace_callback2_t) (void *const priv_ctxt,
 #endif
 
 
+
+/**
+ * @brief The events recorded in the binary trace rings
+ *
+ * The meaning of the \e args of a \ref rohc_trace_record depends on the
+ * event, it is given for every event below.
+ *
+ * @ingroup rohc
+ *
+ * @see rohc_trace_record
+ */
+typedef enum
+{
+	/** One packet was compressed:
+	 *  args = ROHC length, uncompressed length, context state */
+	ROHC_TRACE_EVENT_COMP_PKT        = 0,
+	/** The state of one compression context changed: args = old, new state */
+	ROHC_TRACE_EVENT_COMP_STATE      = 1,
+	/** The mode of one compression context changed: args = old, new mode */
+	ROHC_TRACE_EVENT_COMP_MODE       = 2,
+	/** One feedback was delivered to the compressor:
+	 *  args = feedback type (1 or 2), feedback length, success */
+	ROHC_TRACE_EVENT_COMP_FEEDBACK   = 3,
+	/** One packet was decompressed:
+	 *  args = ROHC length, uncompressed length, context state */
+	ROHC_TRACE_EVENT_DECOMP_PKT      = 4,
+	/** One packet failed to be decompressed:
+	 *  args = status, ROHC length, context state */
+	ROHC_TRACE_EVENT_DECOMP_FAILURE  = 5,
+
+	ROHC_TRACE_EVENT_MAX             /**< The number of events */
+} rohc_trace_event_t;
+
+
+/**
+ * @brief One fixed-size binary trace record
+ *
+ * Binary trace records are written by the compressors and decompressors in
+ * rings enabled with \ref rohc_comp_set_trace_ring and
+ * \ref rohc_decomp_set_trace_ring. They are much cheaper than the traces
+ * given to \ref rohc_trace_callback2_t since nothing is formatted, so they
+ * may stay enabled in production for post-mortem debugging.
+ *
+ * @ingroup rohc
+ *
+ * @see rohc_trace_event_t
+ * @see rohc_comp_get_trace_records
+ * @see rohc_decomp_get_trace_records
+ */
+struct rohc_trace_record
+{
+	uint64_t time;        /**< The arrival time of the packet (in ns) */
+	uint32_t cid;         /**< The CID of the context */
+	uint32_t sn;          /**< The SN of the packet for the decompressor, the
+	                           number of packets of the context for the
+	                           compressor */
+	uint8_t event;        /**< The event, see \ref rohc_trace_event_t */
+	uint8_t packet_type;  /**< The type of the ROHC packet */
+	uint16_t profile;     /**< The profile of the context */
+	uint32_t args[3];     /**< The arguments of the event */
+};
+
 #ifdef __cplusplus
 }
 #endif
@@ -28,8 +28,12 @@
 
 #include "rohc_traces_internal.h"
 #include "rohc_utils.h"
+#include "rohc_alloc.h"
 
 #include <stdio.h> /* for snprintf(3) */
+#ifndef __KERNEL__
+#  include <string.h>
+#endif
 #include <assert.h>
 
 
@@ -50,8 +54,9 @@ void rohc_dump_packet(const rohc_trace_callback2_t trace_cb,
                       const char *const descr,
                       const struct rohc_buf packet)
 {
-	/* leave early if no trace callback was defined */
-	if(trace_cb == NULL)
+	/* leave early if no trace callback was defined or if the trace level was
+	 * removed at build time */
+	if(trace_cb == NULL || trace_level < ROHC_TRACE_MIN_LEVEL)
 	{
 		return;
 	}
@@ -82,8 +87,9 @@ void rohc_dump_buf(const rohc_trace_callback2_t trace_cb,
                    const uint8_t *const packet,
                    const size_t length)
 {
-	/* leave early if no trace callback was defined */
-	if(trace_cb == NULL)
+	/* leave early if no trace callback was defined or if the trace level was
+	 * removed at build time */
+	if(trace_cb == NULL || trace_level < ROHC_TRACE_MIN_LEVEL)
 	{
 		return;
 	}
@@ -138,3 +144,108 @@ void rohc_dump_buf(const rohc_trace_callback2_t trace_cb,
 	}
 }
 
+
+/**
+ * @brief Enable or disable the given ring of binary traces
+ *
+ * @param ring        The ring of binary traces
+ * @param records_nr  The number of records of the ring, a power of 2,
+ *                    0 to disable the ring
+ * @return            true if the ring was successfully (re)configured,
+ *                    false if the number of records is not a power of 2 or
+ *                    memory is missing
+ */
+bool rohc_trace_ring_init(struct rohc_trace_ring *const ring,
+                          const size_t records_nr)
+{
+	struct rohc_trace_record *records = NULL;
+
+	if((records_nr & (records_nr - 1)) != 0)
+	{
+		goto error;
+	}
+	if(records_nr > 0)
+	{
+		records = calloc(records_nr, sizeof(struct rohc_trace_record));
+		if(records == NULL)
+		{
+			goto error;
+		}
+	}
+
+	rohc_trace_ring_free(ring);
+	ring->records = records;
+	ring->mask = (records_nr > 0 ? records_nr - 1 : 0);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Release the records of the given ring of binary traces
+ *
+ * @param ring  The ring of binary traces
+ */
+void rohc_trace_ring_free(struct rohc_trace_ring *const ring)
+{
+	free(ring->records);
+	ring->records = NULL;
+	ring->mask = 0;
+	ring->head = 0;
+}
+
+
+/**
+ * @brief Copy the most recent records of the given ring of binary traces
+ *
+ * The function may be called from another thread than the owner of the ring
+ * without any lock: the records that the owner overwrote during the copy are
+ * discarded.
+ *
+ * @param ring         The ring of binary traces
+ * @param[out] records  The records, the oldest one first
+ * @param max_nr        The maximum number of records to copy
+ * @return              The number of records copied
+ */
+size_t rohc_trace_ring_read(const struct rohc_trace_ring *const ring,
+                            struct rohc_trace_record *const records,
+                            const size_t max_nr)
+{
+	const size_t size = ring->mask + 1;
+	size_t head;
+	size_t first;
+	size_t safe_first;
+	size_t nr;
+	size_t i;
+
+	if(ring->records == NULL)
+	{
+		return 0;
+	}
+
+	/* the newest records, at most one ring */
+	head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+	nr = rohc_min(rohc_min(head, size), max_nr);
+	first = head - nr;
+	for(i = 0; i < nr; i++)
+	{
+		records[i] = ring->records[(first + i) & ring->mask];
+	}
+
+	/* drop the records that were overwritten during the copy, the owner
+	 * might be writing the record at index head */
+	head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+	safe_first = (head >= size ? head + 1 - size : 0);
+	if(safe_first > first)
+	{
+		const size_t lost_nr = rohc_min(safe_first - first, nr);
+		memmove(records, records + lost_nr,
+		        (nr - lost_nr) * sizeof(struct rohc_trace_record));
+		nr -= lost_nr;
+	}
+
+	return nr;
+}
@@ -37,11 +37,22 @@
 #include <assert.h>
 
 
+/**
+ * @brief The lowest level of the traces built in the library
+ *
+ * Traces below that level are removed by the compiler since their condition
+ * is always false. Set with the --with-min-trace-level configure option.
+ */
+#ifndef ROHC_TRACE_MIN_LEVEL
+#  define ROHC_TRACE_MIN_LEVEL  ROHC_TRACE_DEBUG
+#endif
+
+
 /** Print information depending on the debug level (internal usage) */
 #define __rohc_print(trace_cb, trace_cb_priv, \
                      level, entity, profile, format, ...) \
 	do { \
-		if(trace_cb != NULL) { \
+		if((level) >= ROHC_TRACE_MIN_LEVEL && trace_cb != NULL) { \
 			trace_cb(trace_cb_priv, level, entity, profile, \
 			         "[%s:%d %s()] " format "\n", \
 			         __FILE__, __LINE__, __FUNCTION__, ##__VA_ARGS__); \
@@ -51,10 +62,12 @@
 /** Print information depending on the debug level */
 #define rohc_print(entity_struct, level, entity, profile, format, ...) \
 	do { \
-		__rohc_print((entity_struct)->trace_callback, \
-		             (entity_struct)->trace_callback_priv, \
-		             level, entity, profile, \
-		             format, ##__VA_ARGS__); \
+		if((level) >= (entity_struct)->trace_level) { \
+			__rohc_print((entity_struct)->trace_callback, \
+			             (entity_struct)->trace_callback_priv, \
+			             level, entity, profile, \
+			             format, ##__VA_ARGS__); \
+		} \
 	} while(0)
 
 /** Print debug messages prefixed with the function name */
@@ -98,6 +111,98 @@
 	} while(0)
 
 
+/**
+ * @brief The ring of binary trace records of one compressor or decompressor
+ *
+ * Only the owner of the ring writes records and the \e head index. Other
+ * threads may copy the records without any lock with
+ * \ref rohc_trace_ring_read, the records overwritten during the copy are
+ * discarded.
+ */
+struct rohc_trace_ring
+{
+	/** The records, NULL if the ring is disabled */
+	struct rohc_trace_record *records;
+	/** The number of records minus 1 (the number is a power of 2) */
+	size_t mask;
+	/** The index of the next record to write (free-running) */
+	size_t head;
+	/** The arrival time (in ns) of the packet being handled */
+	uint64_t time;
+};
+
+
+/**
+ * @brief Set the arrival time of the packet being handled by the ring owner
+ *
+ * @param ring  The ring of binary traces
+ * @param time  The arrival time of the packet
+ */
+static inline void rohc_trace_ring_set_time(struct rohc_trace_ring *const ring,
+                                            const struct rohc_ts time)
+{
+	ring->time = time.sec * 1000000000ULL + time.nsec;
+}
+
+
+/**
+ * @brief Record one event in the given ring of binary traces
+ *
+ * @param ring         The ring of binary traces
+ * @param event        The event to record
+ * @param cid          The CID of the context
+ * @param profile      The profile of the context
+ * @param packet_type  The type of the ROHC packet
+ * @param sn           The SN of the packet
+ * @param arg0         The 1st argument of the event
+ * @param arg1         The 2nd argument of the event
+ * @param arg2         The 3rd argument of the event
+ */
+static inline void rohc_trace_ring_add(struct rohc_trace_ring *const ring,
+                                       const rohc_trace_event_t event,
+                                       const size_t cid,
+                                       const int profile,
+                                       const int packet_type,
+                                       const uint32_t sn,
+                                       const uint32_t arg0,
+                                       const uint32_t arg1,
+                                       const uint32_t arg2)
+{
+	struct rohc_trace_record *record;
+
+	if(ring->records == NULL)
+	{
+		return;
+	}
+
+	record = &ring->records[ring->head & ring->mask];
+	record->time = ring->time;
+	record->cid = cid;
+	record->sn = sn;
+	record->event = event;
+	record->packet_type = packet_type;
+	record->profile = profile;
+	record->args[0] = arg0;
+	record->args[1] = arg1;
+	record->args[2] = arg2;
+
+	/* publish the record to the readers */
+	__atomic_store_n(&ring->head, ring->head + 1, __ATOMIC_RELEASE);
+}
+
+bool rohc_trace_ring_init(struct rohc_trace_ring *const ring,
+                          const size_t records_nr)
+	__attribute__((nonnull(1), warn_unused_result));
+
+void rohc_trace_ring_free(struct rohc_trace_ring *const ring)
+	__attribute__((nonnull(1)));
+
+size_t rohc_trace_ring_read(const struct rohc_trace_ring *const ring,
+                            struct rohc_trace_record *const records,
+                            const size_t max_nr)
+	__attribute__((nonnull(1, 2), warn_unused_result));
+
+
 void rohc_dump_packet(const rohc_trace_callback2_t trace_cb,
                       void *const trace_cb_priv,
                       const rohc_trace_entity_t trace_entity,
@@ -44,6 +44,62 @@ typedef enum
 } rohc_sdvl_max_value_t;
 
 
+/**
+ * @brief The number of SDVL bytes required for a number of bits
+ *
+ * Indexed by the number of bits to encode (0 to 29).
+ */
+static const uint8_t rohc_sdvl_len_by_bits[ROHC_SDVL_MAX_BITS_IN_4_BYTES + 1] =
+{
+	1, 1, 1, 1, 1, 1, 1, 1,            /*  0 to  7 bits */
+	2, 2, 2, 2, 2, 2, 2,               /*  8 to 14 bits */
+	3, 3, 3, 3, 3, 3, 3,               /* 15 to 21 bits */
+	4, 4, 4, 4, 4, 4, 4, 4,            /* 22 to 29 bits */
+};
+
+/** The number of useful bits in 1 to 4 SDVL bytes (indexed by length) */
+static const uint8_t rohc_sdvl_bits_by_len[5] =
+{
+	0,
+	ROHC_SDVL_MAX_BITS_IN_1_BYTE,
+	ROHC_SDVL_MAX_BITS_IN_2_BYTES,
+	ROHC_SDVL_MAX_BITS_IN_3_BYTES,
+	ROHC_SDVL_MAX_BITS_IN_4_BYTES,
+};
+
+/** The bit pattern of the first SDVL byte (indexed by length) */
+static const uint8_t rohc_sdvl_prefix_by_len[5] = { 0x00, 0x00, 0x80, 0xc0, 0xe0 };
+
+/** The mask of the value bits in 1 to 4 SDVL bytes (indexed by length) */
+static const uint32_t rohc_sdvl_mask_by_len[5] =
+{
+	0,
+	ROHC_SDVL_MAX_VALUE_IN_1_BYTE,
+	ROHC_SDVL_MAX_VALUE_IN_2_BYTES,
+	ROHC_SDVL_MAX_VALUE_IN_3_BYTES,
+	ROHC_SDVL_MAX_VALUE_IN_4_BYTES,
+};
+
+/**
+ * @brief The length of a SDVL field given the 3 first bits of its first byte
+ *
+ * Bit patterns 0xx, 10x, 110 and 111 respectively give 1, 2, 3 and 4 bytes.
+ */
+static const uint8_t rohc_sdvl_len_by_prefix[8] = { 1, 1, 1, 1, 2, 2, 3, 4 };
+
+
+/**
+ * @brief Find out the number of bits of the value, at least 1
+ *
+ * @param value  The value
+ * @return       The number of bits from the most significant bit set
+ */
+static inline size_t sdvl_value_bits_nr(const uint32_t value)
+{
+	return (32 - __builtin_clz(value | 1));
+}
+
+
 /**
  * @brief Can the given value be encoded with SDVL?
  *
@@ -133,32 +189,15 @@ size_t sdvl_get_min_len(const size_t nr_min_required,
  */
 size_t sdvl_get_encoded_len(const uint32_t value)
 {
-	size_t size;
+	const size_t bits_nr = sdvl_value_bits_nr(value);
 
-	/* find the length for SDVL-encoding */
-	if(value <= ROHC_SDVL_MAX_VALUE_IN_1_BYTE)
-	{
-		size = 1;
-	}
-	else if(value <= ROHC_SDVL_MAX_VALUE_IN_2_BYTES)
-	{
-		size = 2;
-	}
-	else if(value <= ROHC_SDVL_MAX_VALUE_IN_3_BYTES)
-	{
-		size = 3;
-	}
-	else if(value <= ROHC_SDVL_MAX_VALUE_IN_4_BYTES)
+	/* value is too large for SDVL-encoding */
+	if(bits_nr > ROHC_SDVL_MAX_BITS_IN_4_BYTES)
 	{
-		size = 4;
-	}
-	else
-	{
-		/* value is too large for SDVL-encoding */
-		size = 5;
+		return 5;
 	}
 
-	return size;
+	return rohc_sdvl_len_by_bits[bits_nr];
 }
 
 
@@ -183,68 +222,37 @@ bool sdvl_encode(uint8_t *const sdvl_bytes,
                  const uint32_t value,
                  const size_t bits_nr)
 {
+	size_t len;
+	uint32_t word;
+	size_t i;
+
 	/* encoding 0 bit is an error */
 	assert(bits_nr > 0);
 
-	/* encode the value according to the number of available bits */
-	if(bits_nr <= ROHC_SDVL_MAX_BITS_IN_1_BYTE)
+	if(bits_nr > ROHC_SDVL_MAX_BITS_IN_4_BYTES)
 	{
-		*sdvl_bytes_nr = 1;
-		if(sdvl_bytes_max_nr < (*sdvl_bytes_nr))
-		{
-			/* number of bytes needed is too large for buffer */
-			goto error;
-		}
-
-		/* bit pattern 0 */
-		sdvl_bytes[0] = value & 0x7f;
+		/* number of bytes needed is too large (value must be < 2^29) */
+		goto error;
 	}
-	else if(bits_nr <= ROHC_SDVL_MAX_BITS_IN_2_BYTES)
-	{
-		*sdvl_bytes_nr = 2;
-		if(sdvl_bytes_max_nr < (*sdvl_bytes_nr))
-		{
-			/* number of bytes needed is too large for buffer */
-			goto error;
-		}
 
-		/* 2 = bit pattern 10 */
-		sdvl_bytes[0] = ((2 << 6) | ((value >> 8) & 0x3f)) & 0xff;
-		sdvl_bytes[1] = value & 0xff;
-	}
-	else if(bits_nr <= ROHC_SDVL_MAX_BITS_IN_3_BYTES)
+	/* the number of available bits gives the length of the SDVL field */
+	len = rohc_sdvl_len_by_bits[bits_nr];
+	*sdvl_bytes_nr = len;
+	if(sdvl_bytes_max_nr < len)
 	{
-		*sdvl_bytes_nr = 3;
-		if(sdvl_bytes_max_nr < (*sdvl_bytes_nr))
-		{
-			/* number of bytes needed is too large for buffer */
-			goto error;
-		}
-
-		/* 6 = bit pattern 110 */
-		sdvl_bytes[0] = ((6 << 5) | ((value >> 16) & 0x1f)) & 0xff;
-		sdvl_bytes[1] = (value >> 8) & 0xff;
-		sdvl_bytes[2] = value & 0xff;
+		/* number of bytes needed is too large for buffer */
+		goto error;
 	}
-	else if(bits_nr <= ROHC_SDVL_MAX_BITS_IN_4_BYTES)
-	{
-		*sdvl_bytes_nr = 4;
-		if(sdvl_bytes_max_nr < (*sdvl_bytes_nr))
-		{
-			/* number of bytes needed is too large for buffer */
-			goto error;
-		}
 
-		/* 7 = bit pattern 111 */
-		sdvl_bytes[0] = ((7 << 5) | ((value >> 24) & 0x1f)) & 0xff;
-		sdvl_bytes[1] = (value >> 16) & 0xff;
-		sdvl_bytes[2] = (value >> 8) & 0xff;
-		sdvl_bytes[3] = value & 0xff;
-	}
-	else
+	/* bit pattern and value bits, aligned on the first byte */
+	word = (((uint32_t) rohc_sdvl_prefix_by_len[len]) << 24) |
+	       ((value & rohc_sdvl_mask_by_len[len]) << ((4 - len) * 8));
+
+	/* write them in network byte order, never beyond the SDVL field since
+	 * some callers do not know the real free space of their buffer */
+	for(i = 0; i < len; i++)
 	{
-		/* number of bytes needed is too large (value must be < 2^29) */
-		goto error;
+		sdvl_bytes[i] = (word >> (24 - i * 8)) & 0xff;
 	}
 
 	return true;
@@ -273,33 +281,17 @@ bool sdvl_encode_full(uint8_t *const sdvl_bytes,
                       size_t *const sdvl_bytes_nr,
                       const uint32_t value)
 {
-	size_t bits_nr;
+	const size_t value_bits_nr = sdvl_value_bits_nr(value);
 
-	/* find the number of bits for SDVL-encoding */
-	if(value <= ROHC_SDVL_MAX_VALUE_IN_1_BYTE)
-	{
-		bits_nr = ROHC_SDVL_MAX_BITS_IN_1_BYTE;
-	}
-	else if(value <= ROHC_SDVL_MAX_VALUE_IN_2_BYTES)
-	{
-		bits_nr = ROHC_SDVL_MAX_BITS_IN_2_BYTES;
-	}
-	else if(value <= ROHC_SDVL_MAX_VALUE_IN_3_BYTES)
-	{
-		bits_nr = ROHC_SDVL_MAX_BITS_IN_3_BYTES;
-	}
-	else if(value <= ROHC_SDVL_MAX_VALUE_IN_4_BYTES)
-	{
-		bits_nr = ROHC_SDVL_MAX_BITS_IN_4_BYTES;
-	}
-	else
+	if(value_bits_nr > ROHC_SDVL_MAX_BITS_IN_4_BYTES)
 	{
 		/* value is too large for SDVL-encoding */
 		goto error;
 	}
 
-	return sdvl_encode(sdvl_bytes, sdvl_bytes_max_nr, sdvl_bytes_nr,
-	                   value, bits_nr);
+	/* use all the bits of the SDVL field */
+	return sdvl_encode(sdvl_bytes, sdvl_bytes_max_nr, sdvl_bytes_nr, value,
+	                   rohc_sdvl_bits_by_len[rohc_sdvl_len_by_bits[value_bits_nr]]);
 
 error:
 	return false;
@@ -324,6 +316,8 @@ size_t sdvl_decode(const uint8_t *const data,
                    size_t *const bits_nr)
 {
 	size_t sdvl_len;
+	uint32_t decoded;
+	size_t i;
 
 	if(length < 1)
 	{
@@ -331,49 +325,71 @@ size_t sdvl_decode(const uint8_t *const data,
 		goto error;
 	}
 
-	if(!GET_BIT_7(data)) /* bit == 0 */
+	/* the bit pattern of the first byte gives the length of the field */
+	sdvl_len = rohc_sdvl_len_by_prefix[data[0] >> 5];
+	if(length < sdvl_len)
 	{
-		*value = GET_BIT_0_6(data);
-		*bits_nr = ROHC_SDVL_MAX_BITS_IN_1_BYTE;
-		sdvl_len = 1;
+		/* packet too small to decode SDVL field */
+		goto error;
 	}
-	else if(GET_BIT_6_7(data) == (0x8 >> 2)) /* bits == 0b10 */
+
+	/* read all 4 bytes at once if possible */
+	if(length >= 4)
 	{
-		if(length < 2)
-		{
-			/* packet too small to decode SDVL field */
-			goto error;
-		}
-		*value = (GET_BIT_0_5(data) << 8 | GET_BIT_0_7(data + 1));
-		*bits_nr = ROHC_SDVL_MAX_BITS_IN_2_BYTES;
-		sdvl_len = 2;
+		decoded = (((uint32_t) data[0]) << 24) | (((uint32_t) data[1]) << 16) |
+		          (((uint32_t) data[2]) << 8) | ((uint32_t) data[3]);
+		decoded >>= (4 - sdvl_len) * 8;
 	}
-	else if(GET_BIT_5_7(data) == (0xc >> 1)) /* bits == 0b110 */
+	else
 	{
-		if(length < 3)
+		decoded = 0;
+		for(i = 0; i < sdvl_len; i++)
 		{
-			/* packet too small to decode SDVL field */
-			goto error;
+			decoded = (decoded << 8) | data[i];
 		}
-		*value = (GET_BIT_0_4(data) << 16 |
-		          GET_BIT_0_7(data + 1) << 8 |
-		          GET_BIT_0_7(data + 2));
-		*bits_nr = ROHC_SDVL_MAX_BITS_IN_3_BYTES;
-		sdvl_len = 3;
 	}
-	else /* bits == 0b111 */
+	*value = decoded & rohc_sdvl_mask_by_len[sdvl_len];
+	*bits_nr = rohc_sdvl_bits_by_len[sdvl_len];
+
+	return sdvl_len;
+
+error:
+	return 0;
+}
+
+
+/**
+ * @brief Decode several consecutive Self-Describing Variable-Length (SDVL)
+ *        values
+ *
+ * See 4.5.6 in the RFC 3095 for details about SDVL encoding.
+ *
+ * @param data       The SDVL data to decode
+ * @param length     The maximum data length available (in bytes)
+ * @param values     OUT: The decoded values
+ * @param bits_nrs   OUT: The numbers of useful bits of the decoded values
+ * @param fields_nr  The number of consecutive SDVL fields to decode
+ * @return           The number of bytes used by all the SDVL fields,
+ *                   0 in case of problem
+ */
+size_t sdvl_decode_batch(const uint8_t *const data,
+                         const size_t length,
+                         uint32_t *const values,
+                         size_t *const bits_nrs,
+                         const size_t fields_nr)
+{
+	size_t sdvl_len = 0;
+	size_t i;
+
+	for(i = 0; i < fields_nr; i++)
 	{
-		if(length < 4)
+		const size_t field_len = sdvl_decode(data + sdvl_len, length - sdvl_len,
+		                                     &values[i], &bits_nrs[i]);
+		if(field_len == 0)
 		{
-			/* packet too small to decode SDVL field */
 			goto error;
 		}
-		*value = (GET_BIT_0_4(data) << 24 |
-		          GET_BIT_0_7(data + 1) << 16 |
-		          GET_BIT_0_7(data + 2) << 8 |
-		          GET_BIT_0_7(data + 3));
-		*bits_nr = ROHC_SDVL_MAX_BITS_IN_4_BYTES;
-		sdvl_len = 4;
+		sdvl_len += field_len;
 	}
 
 	return sdvl_len;
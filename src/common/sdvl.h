@@ -89,5 +89,12 @@ size_t sdvl_decode(const uint8_t *const data,
                    size_t *const bits_nr)
 	__attribute__((warn_unused_result, nonnull(1, 3, 4)));
 
+size_t sdvl_decode_batch(const uint8_t *const data,
+                         const size_t length,
+                         uint32_t *const values,
+                         size_t *const bits_nrs,
+                         const size_t fields_nr)
+	__attribute__((warn_unused_result, nonnull(1, 3, 4)));
+
 #endif
 
@@ -241,6 +241,24 @@ int main(int argc, char *argv[])
 		CHECK(strcmp(rohc_get_ext_descr(ROHC_EXT_NONE + 1), unknown) == 0);
 	}
 
+	/* rohc_alloc_set_allocator() */
+	{
+		const rohc_alloc_malloc_t malloc_fn = (rohc_alloc_malloc_t) 0x1;
+		const rohc_alloc_calloc_t calloc_fn = (rohc_alloc_calloc_t) 0x1;
+		const rohc_alloc_free_t free_fn = (rohc_alloc_free_t) 0x1;
+		const rohc_alloc_malloc_node_t malloc_node_fn =
+			(rohc_alloc_malloc_node_t) 0x1;
+
+		CHECK(rohc_alloc_set_allocator(malloc_fn, NULL, NULL, NULL) == false);
+		CHECK(rohc_alloc_set_allocator(NULL, NULL, free_fn, NULL) == false);
+		CHECK(rohc_alloc_set_allocator(NULL, calloc_fn, NULL, NULL) == false);
+		CHECK(rohc_alloc_set_allocator(NULL, NULL, NULL, NULL) == true);
+
+		/* rohc_alloc_set_numa_allocator() */
+		CHECK(rohc_alloc_set_numa_allocator(malloc_node_fn) == false);
+		CHECK(rohc_alloc_set_numa_allocator(NULL) == true);
+	}
+
 	/* rohc_get_packet_type() */
 	{
 		const char *const packet_type_names[ROHC_PACKET_MAX] = {
@@ -485,6 +503,31 @@ int main(int argc, char *argv[])
 		CHECK(rohc_buf_is_empty(rbuf2) == true);
 	}
 
+	/* rohc_alloc_set_steady_state() and rohc_alloc_get_stats() */
+	{
+		rohc_alloc_stats_t stats;
+		memset(&stats, 0, sizeof(rohc_alloc_stats_t));
+		CHECK(rohc_alloc_set_steady_state(ROHC_ALLOC_STEADY_ABORT + 1) == false);
+		CHECK(rohc_alloc_get_stats(NULL) == false);
+		stats.version_major = 0xffff;
+		CHECK(rohc_alloc_get_stats(&stats) == false);
+		stats.version_major = 0;
+		stats.version_minor = 0xffff;
+		CHECK(rohc_alloc_get_stats(&stats) == false);
+		stats.version_minor = 0;
+		/* true only if the library was built with --enable-alloc-check */
+		if(rohc_alloc_get_stats(&stats))
+		{
+			CHECK(stats.steady_allocs_nr == 0);
+			CHECK(rohc_alloc_set_steady_state(ROHC_ALLOC_STEADY_OFF) == true);
+		}
+		else
+		{
+			CHECK(stats.allocs_nr == 0);
+			CHECK(rohc_alloc_set_steady_state(ROHC_ALLOC_STEADY_OFF) == false);
+		}
+	}
+
 	/* test succeeds */
 	trace(verbose, "all tests are successful\n");
 	is_failure = 0;
@@ -0,0 +1,264 @@
+/*
+ * Copyright 2016 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file    test_crc.c
+ * @brief   Test the CRC computations
+ * @author  Didier Barvaux <didier@barvaux.org>
+ */
+
+#include "crc.h"
+#include "rohc_cpu.h"
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+
+
+/** Print trace on stdout only in verbose mode */
+#define trace(is_verbose, format, ...) \
+	do { \
+		if(is_verbose) { \
+			printf(format, ##__VA_ARGS__); \
+		} \
+	} while(0)
+
+/** Improved assert() */
+#define CHECK(condition) \
+	do { \
+		trace(verbose, "test '%s'\n", #condition); \
+		fflush(stdout); \
+		assert(condition); \
+	} while(0)
+
+
+/**
+ * @brief Compute the CRC FCS-32 bit per bit
+ *
+ * @param data      The data to compute the CRC for
+ * @param length    The size of the data
+ * @param init_val  The initial value of the CRC
+ * @return          The 32-bit CRC
+ */
+static uint32_t fcs32_bitwise(const uint8_t *const data,
+                              const size_t length,
+                              const uint32_t init_val)
+{
+	uint32_t crc = init_val;
+
+	for(size_t i = 0; i < length; i++)
+	{
+		crc ^= data[i];
+		for(size_t j = 0; j < 8; j++)
+		{
+			crc = (crc >> 1) ^ ((crc & 1) ? 0xedb88320U : 0);
+		}
+	}
+
+	return crc;
+}
+
+
+/**
+ * @brief Compute the CRC-3, CRC-7 or CRC-8 byte per byte
+ *
+ * @param crc_type   The CRC type
+ * @param data       The data to compute the CRC for
+ * @param length     The size of the data
+ * @param init_val   The initial value of the CRC
+ * @param crc_table  The pre-computed table for the CRC type
+ * @return           The CRC
+ */
+static uint8_t crc_bytewise(const rohc_crc_type_t crc_type,
+                            const uint8_t *const data,
+                            const size_t length,
+                            const uint8_t init_val,
+                            const uint8_t *const crc_table)
+{
+	const uint8_t mask = (crc_type == ROHC_CRC_TYPE_8 ? 0xff :
+	                      ((1U << crc_type) - 1));
+	uint8_t crc = init_val;
+
+	for(size_t i = 0; i < length; i++)
+	{
+		crc = crc_table[data[i] ^ (crc & mask)];
+	}
+
+	return crc;
+}
+
+
+/**
+ * @brief Test the CRC computations
+ *
+ * @param argc  The number of command line arguments
+ * @param argv  The command line arguments
+ * @return      0 if test succeeds, non-zero if test fails
+ */
+int main(int argc, char *argv[])
+{
+	bool verbose; /* whether to run in verbose mode or not */
+	int is_failure = 1; /* test fails by default */
+	uint8_t data[2048 + 16];
+	uint32_t seed = 0x12345678;
+
+	/* do we run in verbose mode ? */
+	if(argc == 1)
+	{
+		/* no argument, run in silent mode */
+		verbose = false;
+	}
+	else if(argc == 2 && strcmp(argv[1], "verbose") == 0)
+	{
+		/* run in verbose mode */
+		verbose = true;
+	}
+	else
+	{
+		/* invalid usage */
+		printf("test the CRC computations\n");
+		printf("usage: %s [verbose]\n", argv[0]);
+		goto error;
+	}
+
+	/* pseudo-random data */
+	for(size_t i = 0; i < sizeof(data); i++)
+	{
+		seed = seed * 1103515245 + 12345;
+		data[i] = (seed >> 16) & 0xff;
+	}
+
+	/* crc_calculate() against the byte per byte computation, for all header
+	 * lengths with misaligned data and all initial values */
+	{
+		const rohc_crc_type_t crc_types[] =
+			{ ROHC_CRC_TYPE_3, ROHC_CRC_TYPE_7, ROHC_CRC_TYPE_8 };
+		const uint8_t *const crc_tables[] =
+			{ rohc_crc_table_3, rohc_crc_table_7, rohc_crc_table_8 };
+
+		for(size_t type = 0; type < 3; type++)
+		{
+			for(size_t offset = 0; offset < 4; offset++)
+			{
+				for(size_t len = 0; len <= 128; len++)
+				{
+					for(unsigned int init_val = 0; init_val <= 0xff; init_val++)
+					{
+						const uint8_t exp_crc =
+							crc_bytewise(crc_types[type], data + offset, len, init_val,
+							             crc_tables[type]);
+
+						if(crc_calculate(crc_types[type], data + offset, len, init_val,
+						                 crc_tables[type]) != exp_crc)
+						{
+							printf("CRC-%d failed for %zu bytes at offset %zu with "
+							       "initial value 0x%02x\n", crc_types[type], len,
+							       offset, init_val);
+							goto error;
+						}
+					}
+				}
+			}
+		}
+	}
+
+	/* crc_calculate() with tables given by the caller: a copy of the shared
+	 * table and a table of another CRC shall be used as given */
+	{
+		uint8_t crc_table_copy[256];
+		uint8_t crc_table_other[256];
+
+		memcpy(crc_table_copy, rohc_crc_table_8, sizeof(crc_table_copy));
+		for(size_t i = 0; i < sizeof(crc_table_other); i++)
+		{
+			crc_table_other[i] = (uint8_t) (rohc_crc_table_8[i] ^ (i * 7));
+		}
+
+		for(size_t len = 0; len <= 128; len++)
+		{
+			trace(verbose, "test CRC-8 on %zu bytes with caller tables\n", len);
+			CHECK(crc_calculate(ROHC_CRC_TYPE_8, data, len, CRC_INIT_8,
+			                    crc_table_copy) ==
+			      crc_calculate(ROHC_CRC_TYPE_8, data, len, CRC_INIT_8,
+			                    rohc_crc_table_8));
+			CHECK(crc_calculate(ROHC_CRC_TYPE_8, data, len, CRC_INIT_8,
+			                    crc_table_other) ==
+			      crc_bytewise(ROHC_CRC_TYPE_8, data, len, CRC_INIT_8,
+			                   crc_table_other));
+			CHECK(crc_calculate(ROHC_CRC_TYPE_7, data, len, CRC_INIT_7,
+			                    crc_table_other) ==
+			      crc_bytewise(ROHC_CRC_TYPE_7, data, len, CRC_INIT_7,
+			                   crc_table_other));
+		}
+	}
+
+	/* FCS-32 is tested with the generic implementation first, then with the
+	 * implementation selected for the running CPU */
+	for(size_t pass = 0; pass < 2; pass++)
+	{
+		if(pass == 0)
+		{
+			rohc_cpu_features = ROHC_CPU_FEATURE_DETECTED;
+		}
+		else
+		{
+			rohc_cpu_features = 0;
+			rohc_cpu_init();
+		}
+		trace(verbose, "test FCS-32 with CPU features 0x%x\n", rohc_cpu_features);
+
+		/* well-known check value of CRC-32: "123456789" */
+		CHECK((crc_calc_fcs32((const uint8_t *) "123456789", 9,
+		                      CRC_INIT_FCS32) ^ 0xffffffff) == 0xcbf43926);
+
+		/* crc_calc_fcs32() against the bitwise computation, for all lengths up
+		 * to 2048 bytes with misaligned data and different initial values */
+		for(size_t offset = 0; offset < 16; offset += 3)
+		{
+			for(size_t len = 0; len <= 2048; len++)
+			{
+				const uint32_t init_val = (len % 2) ? CRC_INIT_FCS32 : (seed ^ len);
+				const uint32_t exp_crc = fcs32_bitwise(data + offset, len, init_val);
+
+				if(crc_calc_fcs32(data + offset, len, init_val) != exp_crc)
+				{
+					printf("crc_calc_fcs32() failed for %zu bytes at offset %zu\n",
+					       len, offset);
+					goto error;
+				}
+			}
+		}
+
+		/* CRC computed in several parts */
+		{
+			uint32_t crc = CRC_INIT_FCS32;
+			crc = crc_calc_fcs32(data, 100, crc);
+			crc = crc_calc_fcs32(data + 100, 7, crc);
+			crc = crc_calc_fcs32(data + 107, 1500, crc);
+			CHECK(crc == fcs32_bitwise(data, 1607, CRC_INIT_FCS32));
+		}
+	}
+
+	/* test succeeds */
+	trace(verbose, "all tests are successful\n");
+	is_failure = 0;
+
+error:
+	return is_failure;
+}
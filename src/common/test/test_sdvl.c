@@ -262,6 +262,46 @@ int main(int argc, char *argv[])
 		}
 	}
 
+	/* sdvl_decode_batch() */
+	{
+		const uint32_t values[] = { 0x7f, 0x3fff, 0x1fffff, 0x1fffffff, 0 };
+		const size_t values_nr = sizeof(values) / sizeof(uint32_t);
+		const size_t exp_bits[] = { 7, 14, 21, 29, 7 };
+		uint8_t sdvl_bytes[4 * 5];
+		size_t sdvl_bytes_nr = 0;
+		uint32_t decoded_values[5];
+		size_t useful_bits_nrs[5];
+		size_t i;
+
+		for(i = 0; i < values_nr; i++)
+		{
+			size_t field_len;
+			CHECK(sdvl_encode_full(sdvl_bytes + sdvl_bytes_nr,
+			                       sizeof(sdvl_bytes) - sdvl_bytes_nr,
+			                       &field_len, values[i]));
+			sdvl_bytes_nr += field_len;
+		}
+		CHECK(sdvl_bytes_nr == 11);
+
+		CHECK(sdvl_decode_batch(sdvl_bytes, sdvl_bytes_nr, decoded_values,
+		                        useful_bits_nrs, values_nr) == sdvl_bytes_nr);
+		for(i = 0; i < values_nr; i++)
+		{
+			CHECK(decoded_values[i] == values[i]);
+			CHECK(useful_bits_nrs[i] == exp_bits[i]);
+		}
+
+		/* truncated last field */
+		CHECK(sdvl_decode_batch(sdvl_bytes, sdvl_bytes_nr - 1, decoded_values,
+		                        useful_bits_nrs, values_nr) == 0);
+		/* truncated 4-byte field */
+		CHECK(sdvl_decode_batch(sdvl_bytes, 8, decoded_values,
+		                        useful_bits_nrs, values_nr) == 0);
+		/* no field at all */
+		CHECK(sdvl_decode_batch(sdvl_bytes, 0, decoded_values,
+		                        useful_bits_nrs, 0) == 0);
+	}
+
 	/* test succeeds */
 	trace(verbose, "all tests are successful\n");
 	is_failure = 0;
@@ -70,6 +70,21 @@ static bool c_esp_create(struct rohc_comp_ctxt *const context,
                          const struct net_pkt *const packet)
 	__attribute__((warn_unused_result, nonnull(1, 2)));
 
+static size_t c_esp_get_body_size(const struct rohc_comp *const comp)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+static bool c_esp_restore(struct rohc_comp_ctxt *const context,
+                          const rohc_snapshot_read_t read_cb,
+                          void *const priv)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
+static void c_esp_init_handlers(struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt)
+	__attribute__((nonnull(1)));
+
+static void c_esp_get_mem(const struct rohc_comp_ctxt *const context,
+                          struct rohc_ctxt_mem *const mem)
+	__attribute__((nonnull(1, 2)));
+
 static bool c_esp_check_profile(const struct rohc_comp *const comp,
                                 const struct net_pkt *const packet)
 	__attribute__((warn_unused_result, nonnull(1, 2)));
@@ -147,21 +162,55 @@ static bool c_esp_create(struct rohc_comp_ctxt *const context,
 	rohc_comp_debug(context, "initialize context(SN) = hdr(SN) of first "
 	                "packet = %u", rfc3095_ctxt->sn);
 
-	/* create the ESP part of the profile context */
-	esp_context = malloc(sizeof(struct sc_esp_context));
-	if(esp_context == NULL)
-	{
-		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
-		           "no memory for the ESP part of the profile context");
-		goto clean;
-	}
-	rfc3095_ctxt->specific = esp_context;
+	/* the ESP part of the profile context follows the generic part in
+	 * the body of the context */
+	esp_context = rfc3095_ctxt->specific;
 
 	/* initialize the ESP part of the profile context */
 	memcpy(&(esp_context->old_esp), esp, sizeof(struct esphdr));
 
 	/* init the ESP-specific variables and functions */
 	rfc3095_ctxt->next_header_len = sizeof(struct esphdr);
+	rfc3095_ctxt->is_SO_decision_cacheable = true;
+	c_esp_init_handlers(rfc3095_ctxt);
+
+	return true;
+
+quit:
+	return false;
+}
+
+
+/**
+ * @brief Restore one ESP context from a snapshot
+ *
+ * @param context  The compression context
+ * @param read_cb  The callback used to read the snapshot
+ * @param priv     The private context given to the callback
+ * @return         true if the context was successfully restored,
+ *                 false if the snapshot does not match the context
+ */
+static bool c_esp_restore(struct rohc_comp_ctxt *const context,
+                          const rohc_snapshot_read_t read_cb,
+                          void *const priv)
+{
+	if(!rohc_comp_rfc3095_restore(context, read_cb, priv))
+	{
+		return false;
+	}
+	c_esp_init_handlers(context->specific);
+
+	return true;
+}
+
+
+/**
+ * @brief Set the ESP-specific handlers of one context
+ *
+ * @param rfc3095_ctxt  The generic part of the context
+ */
+static void c_esp_init_handlers(struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt)
+{
 	rfc3095_ctxt->encode_uncomp_fields = NULL;
 	rfc3095_ctxt->decide_state = rohc_comp_rfc3095_decide_state;
 	rfc3095_ctxt->decide_FO_packet = c_ip_decide_FO_packet;
@@ -176,13 +225,37 @@ static bool c_esp_create(struct rohc_comp_ctxt *const context,
 	rfc3095_ctxt->code_uo_remainder = NULL;
 	rfc3095_ctxt->compute_crc_static = esp_compute_crc_static;
 	rfc3095_ctxt->compute_crc_dynamic = esp_compute_crc_dynamic;
+}
 
-	return true;
 
-clean:
-	rohc_comp_rfc3095_destroy(context);
-quit:
-	return false;
+/**
+ * @brief Get the size of the body of one ESP context
+ *
+ * The body holds the generic part of the context followed by the
+ * ESP part.
+ *
+ * @param comp  The ROHC compressor
+ * @return      The size of the body of one ESP context
+ */
+static size_t c_esp_get_body_size(const struct rohc_comp *const comp)
+{
+	return (rohc_comp_rfc3095_get_body_size(comp) + sizeof(struct sc_esp_context));
+}
+
+
+/**
+ * @brief Get the memory used by one ESP context
+ *
+ * @param context   The compression context
+ * @param[out] mem  The memory used by the profile-specific part of the context
+ */
+static void c_esp_get_mem(const struct rohc_comp_ctxt *const context,
+                          struct rohc_ctxt_mem *const mem)
+{
+	rohc_comp_rfc3095_get_mem(context, mem);
+
+	/* the ESP-specific part of the context */
+	mem->bytes += sizeof(struct sc_esp_context);
 }
 
 
@@ -250,14 +323,14 @@ bad_profile:
  * @brief Check if the IP/ESP packet belongs to the context
  *
  * Conditions are:
+ *  - the security parameters index of the ESP header must match the one in
+ *    the context
  *  - the number of IP headers must be the same as in context
  *  - IP version of the two IP headers must be the same as in context
  *  - IP packets must not be fragmented
  *  - the source and destination addresses of the two IP headers must match the
  *    ones in the context
  *  - the transport protocol must be ESP
- *  - the security parameters index of the ESP header must match the one in
- *    the context
  *  - IPv6 only: the Flow Label of the two IP headers must match the ones the
  *    context
  *
@@ -278,18 +351,25 @@ static bool c_esp_check_context(const struct rohc_comp_ctxt *const context,
 		(struct sc_esp_context *) rfc3095_ctxt->specific;
 	const struct esphdr *const esp = (struct esphdr *) packet->transport->data;
 
-	/* first, check the same parameters as for the IP-only profile */
-	if(!c_ip_check_context(context, packet))
+	/* the flow that created the context is recognized at once */
+	if(net_pkt_flow_is_same(&context->flow, &packet->flow))
 	{
-		goto bad_context;
+		return true;
 	}
 
-	/* in addition, check Security parameters index (SPI) */
+	/* first, check the Security parameters index (SPI): the contexts of the
+	 * other SAs between the same gateways differ by their SPI only */
 	if(esp_context->old_esp.spi != esp->spi)
 	{
 		goto bad_context;
 	}
 
+	/* then, check the same parameters as for the IP-only profile */
+	if(!c_ip_check_context(context, packet))
+	{
+		goto bad_context;
+	}
+
 	return true;
 
 bad_context:
@@ -456,12 +536,19 @@ const struct rohc_comp_profile c_esp_profile =
 {
 	.id             = ROHC_PROFILE_ESP, /* profile ID (see 8 in RFC 3095) */
 	.protocol       = ROHC_IPPROTO_ESP, /* IP protocol */
+	.key_type       = ROHC_COMP_KEY_FLOW, /* fields of the context key */
 	.create         = c_esp_create,     /* profile handlers */
 	.destroy        = rohc_comp_rfc3095_destroy,
+	.get_body_size  = c_esp_get_body_size,
+	.body_only      = true,
+	.get_mem        = c_esp_get_mem,
 	.check_profile  = c_esp_check_profile,
 	.check_context  = c_esp_check_context,
 	.encode         = c_esp_encode,
 	.reinit_context = rohc_comp_reinit_context,
 	.feedback       = rohc_comp_rfc3095_feedback,
+	.set_wlsb_width = rohc_comp_rfc3095_set_wlsb_width,
+	.snapshot       = rohc_comp_rfc3095_snapshot,
+	.restore        = c_esp_restore,
 };
 
@@ -42,6 +42,13 @@
 static bool rohc_ip_ctxt_create(struct rohc_comp_ctxt *const context,
                                 const struct net_pkt *const packet)
 	__attribute__((warn_unused_result, nonnull(1, 2)));
+static bool c_ip_restore(struct rohc_comp_ctxt *const context,
+                         const rohc_snapshot_read_t read_cb,
+                         void *const priv)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
+static void c_ip_init_handlers(struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt)
+	__attribute__((nonnull(1)));
 
 
 /*
@@ -78,11 +85,8 @@ static bool rohc_ip_ctxt_create(struct rohc_comp_ctxt *const context,
 	                rfc3095_ctxt->sn);
 
 	/* init the IP-only-specific variables and functions */
-	rfc3095_ctxt->decide_FO_packet = c_ip_decide_FO_packet;
-	rfc3095_ctxt->decide_SO_packet = c_ip_decide_SO_packet;
-	rfc3095_ctxt->decide_extension = decide_extension;
-	rfc3095_ctxt->get_next_sn = c_ip_get_next_sn;
-	rfc3095_ctxt->code_ir_remainder = c_ip_code_ir_remainder;
+	rfc3095_ctxt->is_SO_decision_cacheable = true;
+	c_ip_init_handlers(rfc3095_ctxt);
 
 	return true;
 
@@ -91,6 +95,44 @@ error:
 }
 
 
+/**
+ * @brief Restore one IP-only context from a snapshot
+ *
+ * @param context  The compression context
+ * @param read_cb  The callback used to read the snapshot
+ * @param priv     The private context given to the callback
+ * @return         true if the context was successfully restored,
+ *                 false if the snapshot does not match the context
+ */
+static bool c_ip_restore(struct rohc_comp_ctxt *const context,
+                         const rohc_snapshot_read_t read_cb,
+                         void *const priv)
+{
+	if(!rohc_comp_rfc3095_restore(context, read_cb, priv))
+	{
+		return false;
+	}
+	c_ip_init_handlers(context->specific);
+
+	return true;
+}
+
+
+/**
+ * @brief Set the IP-only-specific handlers of one context
+ *
+ * @param rfc3095_ctxt  The generic part of the context
+ */
+static void c_ip_init_handlers(struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt)
+{
+	rfc3095_ctxt->decide_FO_packet = c_ip_decide_FO_packet;
+	rfc3095_ctxt->decide_SO_packet = c_ip_decide_SO_packet;
+	rfc3095_ctxt->decide_extension = decide_extension;
+	rfc3095_ctxt->get_next_sn = c_ip_get_next_sn;
+	rfc3095_ctxt->code_ir_remainder = c_ip_code_ir_remainder;
+}
+
+
 /**
  * @brief Check if an IP packet belongs to the context.
  *
@@ -124,6 +166,13 @@ bool c_ip_check_context(const struct rohc_comp_ctxt *const context,
 	bool same_src2;
 	bool same_dest2;
 
+	/* the IP headers of the flow that created the context are recognized at
+	 * once, other IP headers are compared field by field */
+	if(net_pkt_flow_is_same_ip(&context->flow, &packet->flow))
+	{
+		return true;
+	}
+
 	rfc3095_ctxt = (struct rohc_comp_rfc3095_ctxt *) context->specific;
 	outer_ip_flags = &rfc3095_ctxt->outer_ip_flags;
 	inner_ip_flags = &rfc3095_ctxt->inner_ip_flags;
@@ -508,12 +557,19 @@ const struct rohc_comp_profile c_ip_profile =
 {
 	.id             = ROHC_PROFILE_IP,     /* profile ID (see 5 in RFC 3843) */
 	.protocol       = 0,                   /* IP protocol */
+	.key_type       = ROHC_COMP_KEY_IP,    /* fields of the context key */
 	.create         = rohc_ip_ctxt_create, /* profile handlers */
 	.destroy        = rohc_comp_rfc3095_destroy,
+	.get_body_size  = rohc_comp_rfc3095_get_body_size,
+	.body_only      = true,
+	.get_mem        = rohc_comp_rfc3095_get_mem,
 	.check_profile  = rohc_comp_rfc3095_check_profile,
 	.check_context  = c_ip_check_context,
 	.encode         = rohc_comp_rfc3095_encode,
 	.reinit_context = rohc_comp_reinit_context,
 	.feedback       = rohc_comp_rfc3095_feedback,
+	.set_wlsb_width = rohc_comp_rfc3095_set_wlsb_width,
+	.snapshot       = rohc_comp_rfc3095_snapshot,
+	.restore        = c_ip_restore,
 };
 
@@ -29,6 +29,7 @@
 
 #include "c_rtp.h"
 #include "c_udp.h"
+#include "schemes/comp_list_csrc.h"
 #include "rohc_traces_internal.h"
 #include "rohc_packets.h"
 #include "rohc_utils.h"
@@ -54,8 +55,26 @@
 static bool c_rtp_create(struct rohc_comp_ctxt *const context,
                          const struct net_pkt *const packet)
 	__attribute__((warn_unused_result, nonnull(1, 2)));
+static size_t c_rtp_get_body_size(const struct rohc_comp *const comp)
+	__attribute__((warn_unused_result, nonnull(1)));
+static void c_rtp_get_mem(const struct rohc_comp_ctxt *const context,
+                          struct rohc_ctxt_mem *const mem)
+	__attribute__((nonnull(1, 2)));
+static void c_rtp_set_wlsb_width(struct rohc_comp_ctxt *const context,
+                                 const size_t width)
+	__attribute__((nonnull(1)));
 static void c_rtp_destroy(struct rohc_comp_ctxt *const context)
 	__attribute__((nonnull(1)));
+static bool c_rtp_snapshot(const struct rohc_comp_ctxt *const context,
+                           const rohc_snapshot_write_t write_cb,
+                           void *const priv)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static bool c_rtp_restore(struct rohc_comp_ctxt *const context,
+                          const rohc_snapshot_read_t read_cb,
+                          void *const priv)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static void c_rtp_init_handlers(struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt)
+	__attribute__((nonnull(1)));
 
 static bool c_rtp_check_profile(const struct rohc_comp *const comp,
                                 const struct net_pkt *const packet)
@@ -147,15 +166,9 @@ static bool c_rtp_create(struct rohc_comp_ctxt *const context,
 	rohc_comp_debug(context, "initialize context(SN) = hdr(SN) of first "
 	                "packet = %u", rfc3095_ctxt->sn);
 
-	/* create the RTP part of the profile context */
-	rtp_context = malloc(sizeof(struct sc_rtp_context));
-	if(rtp_context == NULL)
-	{
-		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
-		           "no memory for the RTP part of the profile context");
-		goto clean;
-	}
-	rfc3095_ctxt->specific = rtp_context;
+	/* the RTP part of the profile context follows the generic part in the
+	 * body of the context, the W-LSB windows for TS follow the RTP part */
+	rtp_context = rfc3095_ctxt->specific;
 
 	/* initialize the RTP part of the profile context */
 	rtp_context->udp_checksum_change_count = 0;
@@ -165,14 +178,17 @@ static bool c_rtp_create(struct rohc_comp_ctxt *const context,
 	rtp_context->rtp_padding_change_count = 0;
 	rtp_context->rtp_extension_change_count = 0;
 	memcpy(&rtp_context->old_rtp, rtp, sizeof(struct rtphdr));
-	if(!c_create_sc(&rtp_context->ts_sc,
-	                context->compressor->wlsb_window_width,
-	                context->compressor->trace_callback,
-	                context->compressor->trace_callback_priv))
-	{
-		rohc_comp_warn(context, "cannot create scaled RTP Timestamp encoding");
-		goto clean;
-	}
+	rohc_comp_list_csrc_new(&rtp_context->csrc_comp, &rtp_context->csrc_mem,
+	                        context->compressor->list_trans_nr,
+	                        context->compressor->trace_callback,
+	                        context->compressor->trace_callback_priv,
+	                        context->compressor->trace_level,
+	                        context->profile->id);
+	c_init_sc(&rtp_context->ts_sc, context->compressor->wlsb_window_width,
+	          (uint8_t *) (rtp_context + 1),
+	          context->compressor->trace_callback,
+	          context->compressor->trace_callback_priv,
+	          context->compressor->trace_level);
 
 	/* init the RTP-specific temporary variables */
 	rtp_context->tmp.send_rtp_dynamic = -1;
@@ -185,9 +201,107 @@ static bool c_rtp_create(struct rohc_comp_ctxt *const context,
 	rtp_context->tmp.rtp_pt_changed = 0;
 	rtp_context->tmp.padding_bit_changed = false;
 	rtp_context->tmp.extension_bit_changed = false;
+	rtp_context->tmp.send_csrc_list = false;
 
 	/* init the RTP-specific variables and functions */
 	rfc3095_ctxt->next_header_len = sizeof(struct udphdr) + sizeof(struct rtphdr);
+	c_rtp_init_handlers(rfc3095_ctxt);
+
+	return true;
+
+quit:
+	return false;
+}
+
+
+/**
+ * @brief Save one RTP context in a snapshot
+ *
+ * The generic part of the context is saved with the RTP part, the list of
+ * CSRC identifiers follows.
+ *
+ * @param context   The RTP compression context
+ * @param write_cb  The callback used to write the snapshot
+ * @param priv      The private context given to the callback
+ * @return          true if the context was successfully saved,
+ *                  false if the callback failed
+ */
+static bool c_rtp_snapshot(const struct rohc_comp_ctxt *const context,
+                           const rohc_snapshot_write_t write_cb,
+                           void *const priv)
+{
+	const struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt = context->specific;
+	const struct sc_rtp_context *const rtp_context = rfc3095_ctxt->specific;
+
+	return (rohc_comp_rfc3095_snapshot(context, write_cb, priv) &&
+	        rohc_comp_list_snapshot(&rtp_context->csrc_comp, write_cb, priv));
+}
+
+
+/**
+ * @brief Restore one RTP context from a snapshot
+ *
+ * The W-LSB encoding objects for TS_SCALED and unscaled TS are moved to the
+ * new body like the ones of the generic part.
+ *
+ * @param context  The RTP compression context
+ * @param read_cb  The callback used to read the snapshot
+ * @param priv     The private context given to the callback
+ * @return         true if the context was successfully restored,
+ *                 false if the snapshot does not match the context
+ */
+static bool c_rtp_restore(struct rohc_comp_ctxt *const context,
+                          const rohc_snapshot_read_t read_cb,
+                          void *const priv)
+{
+	const struct rohc_comp *const comp = context->compressor;
+	struct rohc_comp_rfc3095_ctxt *rfc3095_ctxt;
+	struct sc_rtp_context *rtp_context;
+
+	if(!rohc_comp_rfc3095_restore(context, read_cb, priv))
+	{
+		goto error;
+	}
+	rfc3095_ctxt = context->specific;
+	rtp_context = rfc3095_ctxt->specific;
+	c_rtp_init_handlers(rfc3095_ctxt);
+
+	rohc_comp_list_csrc_new(&rtp_context->csrc_comp, &rtp_context->csrc_mem,
+	                        comp->list_trans_nr, comp->trace_callback,
+	                        comp->trace_callback_priv, comp->trace_level,
+	                        context->profile->id);
+	rtp_context->csrc_comp.may_alloc =
+		((comp->features & ROHC_COMP_FEATURE_NO_ALLOC) == 0);
+	if(!c_restore_sc(&rtp_context->ts_sc, comp->wlsb_window_width,
+	                 (uint8_t *) (rtp_context + 1), comp->trace_callback,
+	                 comp->trace_callback_priv, comp->trace_level))
+	{
+		rohc_comp_warn(context, "malformed RTP context in snapshot: W-LSB "
+		               "windows for TS do not match their width of %zu entries",
+		               comp->wlsb_window_width);
+		goto destroy;
+	}
+	if(!rohc_comp_list_restore(&rtp_context->csrc_comp, read_cb, priv))
+	{
+		goto destroy;
+	}
+
+	return true;
+
+destroy:
+	c_rtp_destroy(context);
+error:
+	return false;
+}
+
+
+/**
+ * @brief Set the RTP-specific handlers of one context
+ *
+ * @param rfc3095_ctxt  The generic part of the context
+ */
+static void c_rtp_init_handlers(struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt)
+{
 	rfc3095_ctxt->encode_uncomp_fields = rtp_encode_uncomp_fields;
 	rfc3095_ctxt->decide_state = rtp_decide_state;
 	rfc3095_ctxt->decide_FO_packet = c_rtp_decide_FO_packet;
@@ -202,13 +316,64 @@ static bool c_rtp_create(struct rohc_comp_ctxt *const context,
 	rfc3095_ctxt->code_uo_remainder = udp_code_uo_remainder;
 	rfc3095_ctxt->compute_crc_static = rtp_compute_crc_static;
 	rfc3095_ctxt->compute_crc_dynamic = rtp_compute_crc_dynamic;
+}
 
-	return true;
 
-clean:
-	rohc_comp_rfc3095_destroy(context);
-quit:
-	return false;
+/**
+ * @brief Get the size of the body of one RTP context
+ *
+ * The body holds the generic part of the context, the RTP part and the
+ * W-LSB encoding objects for TS_SCALED and unscaled TS.
+ *
+ * @param comp  The ROHC compressor
+ * @return      The size of the body of one RTP context
+ */
+static size_t c_rtp_get_body_size(const struct rohc_comp *const comp)
+{
+	return (rohc_comp_rfc3095_get_body_size(comp) +
+	        sizeof(struct sc_rtp_context) +
+	        c_wlsb_size(comp->wlsb_window_width) * 2);
+}
+
+
+/**
+ * @brief Get the memory used by one RTP context
+ *
+ * @param context   The compression context
+ * @param[out] mem  The memory used by the profile-specific part of the context
+ */
+static void c_rtp_get_mem(const struct rohc_comp_ctxt *const context,
+                          struct rohc_ctxt_mem *const mem)
+{
+	/* the W-LSB encoding objects for TS_SCALED and unscaled TS */
+	const size_t ts_wlsb_bytes =
+		c_wlsb_size(context->compressor->wlsb_window_width) * 2;
+
+	rohc_comp_rfc3095_get_mem(context, mem);
+
+	/* the RTP-specific part of the context */
+	mem->bytes += sizeof(struct sc_rtp_context) + ts_wlsb_bytes;
+	mem->wlsb_bytes += ts_wlsb_bytes;
+	mem->lists_bytes += sizeof(struct list_comp) + sizeof(struct list_comp_mem);
+}
+
+
+/**
+ * @brief Change the number of entries that the W-LSB windows of one RTP
+ *        context keep
+ *
+ * @param context  The RTP compression context
+ * @param width    The new number of entries of the W-LSB windows
+ */
+static void c_rtp_set_wlsb_width(struct rohc_comp_ctxt *const context,
+                                 const size_t width)
+{
+	const struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt = context->specific;
+	struct sc_rtp_context *const rtp_context = rfc3095_ctxt->specific;
+
+	rohc_comp_rfc3095_set_wlsb_width(context, width);
+	c_wlsb_set_width(rtp_context->ts_sc.ts_scaled_wlsb, width);
+	c_wlsb_set_width(rtp_context->ts_sc.ts_unscaled_wlsb, width);
 }
 
 
@@ -231,7 +396,7 @@ static void c_rtp_destroy(struct rohc_comp_ctxt *const context)
 	assert(rfc3095_ctxt->specific != NULL);
 	rtp_context = (struct sc_rtp_context *) rfc3095_ctxt->specific;
 
-	c_destroy_sc(&rtp_context->ts_sc);
+	rohc_comp_list_csrc_free(&rtp_context->csrc_comp);
 	rohc_comp_rfc3095_destroy(context);
 }
 
@@ -250,6 +415,9 @@ static void c_rtp_destroy(struct rohc_comp_ctxt *const context)
  *  \li the inner IP payload is at least 8-byte long for UDP header
  *  \li the UDP Length field and the UDP payload match
  *  \li the UDP payload is at least 12-byte long for RTP header
+ *  \li the UDP payload is large enough for the CSRC identifiers
+ *  \li the translation table of the CSRC list may hold all the CSRC
+ *      identifiers
  *  \li the UDP ports are in the list of RTP ports or the user-defined RTP
  *      callback function detected one RTP packet
  *
@@ -271,6 +439,7 @@ static bool c_rtp_check_profile(const struct rohc_comp *const comp,
 	const struct udphdr *udp_header;
 	const uint8_t *udp_payload;
 	unsigned int udp_payload_size;
+	const struct rtphdr *rtp;
 	bool udp_check;
 
 	/* check that:
@@ -302,8 +471,6 @@ static bool c_rtp_check_profile(const struct rohc_comp *const comp,
 	/* check if the IP/UDP packet is a RTP packet */
 	if(comp->rtp_callback != NULL)
 	{
-		const struct rtphdr *rtp;
-
 		/* check if the IP/UDP packet is a RTP packet with the user callback
 		   dedicated to RTP stream detection: if the RTP callback returns 1,
 		   consider that the packet matches the RTP profile */
@@ -332,16 +499,20 @@ static bool c_rtp_check_profile(const struct rohc_comp *const comp,
 
 		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 		           "RTP packet detected by the RTP callback");
-
-		/* RTP packets with one or more CSRC items cannot be compressed by the
-		 * RTP profile for the moment */
-		rtp = (struct rtphdr *) udp_payload;
-		if(rtp->cc != 0)
+	}
+	else if(comp->rtp_detect != NULL)
+	{
+		/* check if the IP/UDP packet is a RTP packet with the built-in RTP
+		   detection: UDP destination port reserved for RTP, sane RTP header
+		   and RTP stream in sequence for long enough */
+		if(!rohc_comp_rtp_detect(comp, packet, (uint8_t *) udp_header,
+		                         udp_payload, udp_payload_size))
 		{
-			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			           "compression of CSRC items is not supported yet by RTP profile");
 			goto bad_profile;
 		}
+
+		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "RTP packet detected by the built-in RTP detection");
 	}
 	else
 	{
@@ -351,6 +522,26 @@ static bool c_rtp_check_profile(const struct rohc_comp *const comp,
 		goto bad_profile;
 	}
 
+	/* UDP payload shall be large enough for the CSRC identifiers */
+	rtp = (struct rtphdr *) udp_payload;
+	if(udp_payload_size < (sizeof(struct rtphdr) + rtp->cc * sizeof(uint32_t)))
+	{
+		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "UDP payload too short for the %u CSRC identifiers", rtp->cc);
+		goto bad_profile;
+	}
+#if ROHC_SMALL_CONTEXTS == 1
+	/* the translation table of the CSRC list of small contexts is too small
+	 * for the largest CSRC lists */
+	if(rtp->cc > ROHC_LIST_MAX_ITEM)
+	{
+		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "too many CSRC identifiers (%u) for the translation table of "
+		           "%u items", rtp->cc, ROHC_LIST_MAX_ITEM);
+		goto bad_profile;
+	}
+#endif
+
 	return true;
 
 bad_profile:
@@ -398,8 +589,10 @@ static bool c_rtp_check_context(const struct rohc_comp_ctxt *const context,
 	const struct rtphdr *const rtp = (struct rtphdr *) (udp + 1);
 	bool udp_check;
 
-	/* check IP and UDP headers */
-	udp_check = c_udp_check_context(context, packet);
+	/* check IP and UDP headers, at once for the flow that created the
+	 * context */
+	udp_check = (net_pkt_flow_is_same(&context->flow, &packet->flow) ||
+	             c_udp_check_context(context, packet));
 	if(!udp_check)
 	{
 		goto bad_context;
@@ -449,6 +642,13 @@ static rohc_packet_t c_rtp_decide_FO_packet(const struct rohc_comp_ctxt *context
 		rohc_comp_debug(context, "choose packet IR-DYN because UDP checksum "
 		                "behavior changed");
 	}
+	else if(rtp_context->tmp.send_csrc_list)
+	{
+		/* TODO: could be UOR-2 with extension 3 and CSRC=1 */
+		packet = ROHC_PACKET_IR_DYN;
+		rohc_comp_debug(context, "choose packet IR-DYN because some bits shall "
+		                "be sent for the list of CSRC identifiers");
+	}
 	else if(rtp_context->rtp_version_change_count < MAX_IR_COUNT)
 	{
 		packet = ROHC_PACKET_IR_DYN;
@@ -858,6 +1058,27 @@ static int c_rtp_encode(struct rohc_comp_ctxt *const context,
 	udp = (struct udphdr *) uncomp_pkt->transport->data;
 	rtp = (struct rtphdr *) (udp + 1);
 
+	/* does the list of CSRC identifiers change? */
+	{
+		bool list_struct_changed;
+		bool list_content_changed;
+
+		rtp_context->csrc_comp.may_alloc =
+			((context->compressor->features & ROHC_COMP_FEATURE_NO_ALLOC) == 0);
+		if(!detect_csrc_changes(&rtp_context->csrc_comp, rtp,
+		                        &list_struct_changed, &list_content_changed))
+		{
+			rohc_comp_warn(context, "failed to detect changes in the list of CSRC "
+			               "identifiers");
+			size = -1;
+			goto quit;
+		}
+		rtp_context->tmp.send_csrc_list =
+			(list_struct_changed || list_content_changed);
+	}
+	rfc3095_ctxt->next_header_len = sizeof(struct udphdr) + sizeof(struct rtphdr) +
+	                                rtp->cc * sizeof(uint32_t);
+
 	/* how many UDP/RTP fields changed? */
 	rtp_context->tmp.send_rtp_dynamic = rtp_changed_rtp_dynamic(context, udp, rtp);
 
@@ -887,6 +1108,7 @@ static int c_rtp_encode(struct rohc_comp_ctxt *const context,
 			rtp_context->old_rtp.extension = rtp->extension;
 		}
 	}
+	rohc_list_update_context(&rtp_context->csrc_comp);
 
 quit:
 	return size;
@@ -1133,7 +1355,8 @@ static size_t rtp_code_static_rtp_part(const struct rohc_comp_ctxt *const contex
 
 \endverbatim
  *
- * Parts 6 & 9 are not supported yet. The TIS flag in part 7 is not supported.
+ * Part 6 is one zero byte if the list of CSRC identifiers is unchanged.
+ * Part 9 is not supported yet. The TIS flag in part 7 is not supported.
  *
  * @param context     The compression context
  * @param next_header The UDP/RTP headers
@@ -1208,11 +1431,25 @@ static size_t rtp_code_dynamic_rtp_part(const struct rohc_comp_ctxt *const conte
 	                dest[counter + nr_written + 3]);
 	nr_written += 4;
 
-	/* part 6 not supported yet  but the field is mandatory,
-	   so add a zero byte */
-	dest[counter + nr_written] = 0x00;
-	rohc_comp_debug(context, "Generic CSRC list not supported yet, put a 0x00 byte");
-	nr_written++;
+	/* part 6 */
+	if(rtp_context->tmp.send_csrc_list)
+	{
+		/* the list encoding cannot fail, its fields are bounded by the
+		 * translation table */
+		const int ret = rohc_list_encode(&rtp_context->csrc_comp, dest,
+		                                 counter + nr_written);
+		assert(ret > 0);
+		rohc_comp_debug(context, "CSRC list: send %zu bytes",
+		                ret - (counter + nr_written));
+		nr_written = ret - counter;
+	}
+	else
+	{
+		/* no need to send any CSRC bit, write a zero byte in packet */
+		dest[counter + nr_written] = 0x00;
+		rohc_comp_debug(context, "CSRC list: no bit to send");
+		nr_written++;
+	}
 
 	/* parts 7, 8 & 9 */
 	if(rx_byte)
@@ -1352,11 +1589,11 @@ static int rtp_changed_rtp_dynamic(const struct rohc_comp_ctxt *const context,
 		 * required). */
 	}
 
-	/* check RTP CSRC Counter and CSRC field */
-	if(rtp->cc != rtp_context->old_rtp.cc)
+	/* check RTP CSRC Counter and CSRC list */
+	if(rtp_context->tmp.send_csrc_list)
 	{
-		rohc_comp_debug(context, "RTP CC field changed (0x%x -> 0x%x)",
-		                rtp_context->old_rtp.cc, rtp->cc);
+		rohc_comp_debug(context, "RTP CC field or CSRC list changed (CC 0x%x -> "
+		                "0x%x)", rtp_context->old_rtp.cc, rtp->cc);
 		fields += 2;
 	}
 
@@ -1478,12 +1715,19 @@ const struct rohc_comp_profile c_rtp_profile =
 {
 	.id             = ROHC_PROFILE_RTP, /* profile ID */
 	.protocol       = ROHC_IPPROTO_UDP, /* IP protocol */
+	.key_type       = ROHC_COMP_KEY_FLOW, /* fields of the context key */
 	.create         = c_rtp_create,     /* profile handlers */
 	.destroy        = c_rtp_destroy,
+	.get_body_size  = c_rtp_get_body_size,
+	.body_only      = true,
+	.get_mem        = c_rtp_get_mem,
 	.check_profile  = c_rtp_check_profile,
 	.check_context  = c_rtp_check_context,
 	.encode         = c_rtp_encode,
 	.reinit_context = rohc_comp_reinit_context,
 	.feedback       = rohc_comp_rfc3095_feedback,
+	.set_wlsb_width = c_rtp_set_wlsb_width,
+	.snapshot       = c_rtp_snapshot,
+	.restore        = c_rtp_restore,
 };
 
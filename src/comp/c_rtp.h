@@ -31,6 +31,7 @@
 
 #include "rohc_comp_rfc3095.h"
 #include "schemes/comp_scaled_rtp_ts.h"
+#include "schemes/comp_list.h"
 #include "protocols/udp.h"
 #include "protocols/rtp.h"
 
@@ -70,6 +71,9 @@ struct rtp_tmp_vars
 
 	/// Whether the Payload Type (PT) field changed or not
 	int rtp_pt_changed;
+
+	/** Whether the list of CSRC identifiers shall be sent or not */
+	bool send_csrc_list;
 };
 
 
@@ -124,6 +128,11 @@ struct sc_rtp_context
 
 	/// Structure to encode the TS field
 	struct ts_sc_comp ts_sc;
+
+	/** The compression context for the list of CSRC identifiers */
+	struct list_comp csrc_comp;
+	/** The memory for the lists and items of the CSRC compression context */
+	struct list_comp_mem csrc_mem;
 };
 
 
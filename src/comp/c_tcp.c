@@ -46,6 +46,7 @@
 
 #include <assert.h>
 #include <stdlib.h>
+#include <stddef.h> /* for offsetof() */
 #ifdef __KERNEL__
 #  include <endian.h>
 #else
@@ -59,6 +60,19 @@
 	rohc_comp_debug(context, "Compressed format choice LINE %d", __LINE__ )
 
 
+/** The number of 16-bit words in the fixed part of the TCP header */
+#define TCP_HDR_WORDS_NR  (sizeof(struct tcphdr) / sizeof(uint16_t))
+
+/* The bits of the change mask of the TCP header, one per 16-bit word */
+#define TCP_HDR_CHANGED_PORTS     0x0003U /**< The source/destination ports */
+#define TCP_HDR_CHANGED_SEQ_NUM   0x000cU /**< The sequence number */
+#define TCP_HDR_CHANGED_ACK_NUM   0x0030U /**< The acknowledgment number */
+#define TCP_HDR_CHANGED_FLAGS     0x0040U /**< The data offset and flags */
+#define TCP_HDR_CHANGED_WINDOW    0x0080U /**< The window */
+#define TCP_HDR_CHANGED_CHECKSUM  0x0100U /**< The checksum */
+#define TCP_HDR_CHANGED_URG_PTR   0x0200U /**< The urgent pointer */
+
+
 /**
  * @brief Define the TCP-specific temporary variables in the profile
  *        compression context.
@@ -76,8 +90,6 @@ struct tcp_tmp_variables
 	/** Whether at least one of the dynamic part of the IPv6 extensions changed
 	 * in the current packet */
 	bool is_ipv6_exts_list_dyn_changed;
-	/** The new number of IP extensions headers (for every IP header) */
-	size_t ip_exts_nr[ROHC_TCP_MAX_IP_HDRS];
 
 	/* the length of the TCP payload (headers and options excluded) */
 	size_t payload_len;
@@ -158,6 +170,10 @@ struct tcp_tmp_variables
 	bool tcp_urg_flag_present;
 	bool tcp_urg_flag_changed;
 
+	/** The 16-bit words of the TCP header that changed since the previous
+	 *  packet, see the TCP_HDR_CHANGED_* masks */
+	uint16_t tcp_hdr_changed;
+
 	/** Whether the ecn_used flag changed or not */
 	bool ecn_used_changed;
 };
@@ -294,6 +310,9 @@ struct sc_tcp_context
 
 	uint32_t tcp_last_seq_num;
 
+	/** The memory block that stores all the W-LSB encoding objects */
+	uint8_t *wlsb_mem;
+
 	uint16_t msn;               /**< The Master Sequence Number (MSN) */
 	struct c_wlsb *msn_wlsb;    /**< The W-LSB decoding context for MSN */
 
@@ -321,6 +340,8 @@ struct sc_tcp_context
 	size_t ack_deltas_next;
 	uint16_t ack_deltas_width[20];
 	uint16_t ack_stride;
+	/** The number of ACK deltas of the sliding window equal to ack_stride */
+	size_t ack_stride_count;
 	uint32_t ack_num_scaled;
 	uint16_t ack_num_residue;
 	size_t ack_num_scaling_nr;
@@ -335,7 +356,13 @@ struct sc_tcp_context
 	///        compression of packet
 	struct tcp_tmp_variables tmp;
 
+	/** Whether the IP contexts were cloned from the context of another flow,
+	 *  the last IP-ID of that flow is then the reference of the first packet */
+	bool is_cloned;
+
 	size_t ip_contexts_nr;
+	/** The IP contexts, only the used ones are saved in snapshots, so they
+	 *  shall stay at the end of the structure */
 	ip_context_t ip_contexts[ROHC_TCP_MAX_IP_HDRS];
 };
 
@@ -347,10 +374,38 @@ struct sc_tcp_context
 static bool c_tcp_create(struct rohc_comp_ctxt *const context,
                          const struct net_pkt *const packet)
 	__attribute__((warn_unused_result, nonnull(1, 2)));
+static bool c_tcp_clone(struct rohc_comp_ctxt *const context,
+                        const struct rohc_comp_ctxt *const src_ctxt,
+                        const struct net_pkt *const packet)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+static void c_tcp_create_tcp(struct rohc_comp_ctxt *const context,
+                             const struct net_pkt_hdrs *const hdrs)
+	__attribute__((nonnull(1, 2)));
 
 static void c_tcp_destroy(struct rohc_comp_ctxt *const context)
 	__attribute__((nonnull(1)));
 
+static void c_tcp_get_mem(const struct rohc_comp_ctxt *const context,
+                          struct rohc_ctxt_mem *const mem)
+	__attribute__((nonnull(1, 2)));
+
+static size_t c_tcp_get_body_size(const struct rohc_comp *const comp)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+static void c_tcp_create_wlsb(struct rohc_comp_ctxt *const context)
+	__attribute__((nonnull(1)));
+static bool c_tcp_snapshot(const struct rohc_comp_ctxt *const context,
+                           const rohc_snapshot_write_t write_cb,
+                           void *const priv)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static bool c_tcp_restore(struct rohc_comp_ctxt *const context,
+                          const rohc_snapshot_read_t read_cb,
+                          void *const priv)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static void c_tcp_set_wlsb_width(struct rohc_comp_ctxt *const context,
+                                 const size_t width)
+	__attribute__((nonnull(1)));
+
 static bool c_tcp_check_profile(const struct rohc_comp *const comp,
                                 const struct net_pkt *const packet)
 	__attribute__((warn_unused_result, nonnull(1, 2)));
@@ -371,25 +426,18 @@ static uint16_t c_tcp_get_next_msn(const struct rohc_comp_ctxt *const context)
 	__attribute__((warn_unused_result, nonnull(1)));
 
 static bool rohc_comp_tcp_are_ipv6_exts_acceptable(const struct rohc_comp *const comp,
-                                                   uint8_t *const next_proto,
-                                                   const uint8_t *const exts,
-                                                   const size_t max_exts_len,
-                                                   size_t *const exts_len)
-	__attribute__((warn_unused_result, nonnull(1, 2, 3, 5)));
+                                                   const struct net_pkt_ip *const ip)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
 
 static bool tcp_detect_changes(struct rohc_comp_ctxt *const context,
                                const struct net_pkt *const uncomp_pkt,
                                ip_context_t **const ip_inner_context,
                                const struct tcphdr **const tcp)
 	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4)));
-static bool tcp_detect_changes_ipv6_exts(struct rohc_comp_ctxt *const context,
+static void tcp_detect_changes_ipv6_exts(struct rohc_comp_ctxt *const context,
                                          ip_context_t *const ip_context,
-                                         uint8_t *const protocol,
-                                         const uint8_t *const exts,
-                                         const size_t max_exts_len,
-                                         size_t *const exts_nr,
-                                         size_t *const exts_len)
-	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4, 6, 7)));
+                                         const struct net_pkt_ip *const ip)
+	__attribute__((nonnull(1, 2, 3)));
 
 static void tcp_decide_state(struct rohc_comp_ctxt *const context)
 	__attribute__((nonnull(1)));
@@ -404,6 +452,9 @@ static bool tcp_encode_uncomp_ip_fields(struct rohc_comp_ctxt *const context,
 static bool tcp_encode_uncomp_tcp_fields(struct rohc_comp_ctxt *const context,
                                          const struct tcphdr *const tcp)
 	__attribute__((warn_unused_result, nonnull(1, 2)));
+static uint16_t tcp_hdr_get_changes(const struct tcphdr *const old_tcp,
+                                    const struct tcphdr *const new_tcp)
+	__attribute__((warn_unused_result, nonnull(1, 2), pure));
 
 static rohc_packet_t tcp_decide_packet(struct rohc_comp_ctxt *const context,
                                        const ip_context_t *const ip_inner_context,
@@ -430,10 +481,15 @@ static rohc_packet_t tcp_decide_FO_SO_packet_rnd(const struct rohc_comp_ctxt *co
                                                  const struct tcphdr *const tcp,
                                                  const bool crc7_at_least)
 	__attribute__((warn_unused_result, nonnull(1, 2)));
+static rohc_packet_t tcp_decide_FO_SO_packet_cheap(const struct rohc_comp_ctxt *const context,
+                                                   const ip_context_t *const ip_inner_context,
+                                                   const struct tcphdr *const tcp,
+                                                   const bool crc7_at_least)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
 
 /* static chain */
 static int tcp_code_static_part(struct rohc_comp_ctxt *const context,
-                                const struct ip_packet *const ip,
+                                const struct net_pkt *const uncomp_pkt,
                                 uint8_t *const rohc_pkt,
                                 const size_t rohc_pkt_max_len)
 	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
@@ -461,7 +517,7 @@ static int tcp_code_static_tcp_part(const struct rohc_comp_ctxt *const context,
 
 /* dynamic chain */
 static int tcp_code_dyn_part(struct rohc_comp_ctxt *const context,
-                             const struct ip_packet *const ip,
+                             const struct net_pkt *const uncomp_pkt,
                              uint8_t *const rohc_pkt,
                              const size_t rohc_pkt_max_len,
                              size_t *const parsed_len)
@@ -493,7 +549,7 @@ static int tcp_code_dynamic_tcp_part(const struct rohc_comp_ctxt *const context,
 
 /* irregular chain */
 static int tcp_code_irreg_chain(struct rohc_comp_ctxt *const context,
-                                const struct ip_packet *const ip,
+                                const struct net_pkt *const uncomp_pkt,
                                 const uint8_t ip_inner_ecn,
                                 const struct tcphdr *const tcp,
                                 uint8_t *const rohc_pkt,
@@ -535,7 +591,7 @@ static int tcp_code_irregular_tcp_part(const struct rohc_comp_ctxt *const contex
 
 /* IR and CO packets */
 static int code_IR_packet(struct rohc_comp_ctxt *const context,
-                          const struct ip_packet *const ip,
+                          const struct net_pkt *const uncomp_pkt,
                           uint8_t *const rohc_pkt,
                           const size_t rohc_pkt_max_len,
                           const rohc_packet_t packet_type,
@@ -543,7 +599,7 @@ static int code_IR_packet(struct rohc_comp_ctxt *const context,
 	__attribute__((warn_unused_result, nonnull(1, 2, 3, 6)));
 
 static int code_CO_packet(struct rohc_comp_ctxt *const context,
-                          const struct ip_packet *ip,
+                          const struct net_pkt *const uncomp_pkt,
                           uint8_t *const rohc_pkt,
                           const size_t rohc_pkt_max_len,
                           const rohc_packet_t packet_type,
@@ -743,7 +799,8 @@ static int c_tcp_build_co_common(const struct rohc_comp_ctxt *const context,
  * Misc functions
  */
 
-static tcp_ip_id_behavior_t tcp_detect_ip_id_behavior(const uint16_t last_ip_id,
+static tcp_ip_id_behavior_t tcp_detect_ip_id_behavior(const tcp_ip_id_behavior_t last_behavior,
+                                                      const uint16_t last_ip_id,
                                                       const uint16_t new_ip_id)
 	__attribute__((warn_unused_result, const));
 
@@ -811,15 +868,11 @@ static bool c_tcp_create(struct rohc_comp_ctxt *const context,
                          const struct net_pkt *const packet)
 {
 	const struct rohc_comp *const comp = context->compressor;
+	const struct net_pkt_hdrs *const hdrs = packet->hdrs;
 	struct sc_tcp_context *tcp_context;
-	const uint8_t *remain_data = packet->outer_ip.data;
-	size_t remain_len = packet->outer_ip.size;
-	const struct tcphdr *tcp;
-	uint8_t proto;
-	size_t i;
 
 	/* create the TCP part of the profile context */
-	tcp_context = malloc(sizeof(struct sc_tcp_context));
+	tcp_context = rohc_comp_ctxt_body_alloc(context, c_tcp_get_body_size(comp));
 	if(tcp_context == NULL)
 	{
 		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
@@ -829,16 +882,17 @@ static bool c_tcp_create(struct rohc_comp_ctxt *const context,
 	memset(tcp_context, 0, sizeof(struct sc_tcp_context));
 	context->specific = tcp_context;
 
-	/* create contexts for IP headers and their extensions */
-	tcp_context->ip_contexts_nr = 0;
-	do
+	/* create contexts for IP headers and their extensions (described and
+	 * checked while checking profile) */
+	assert(hdrs->is_complete);
+	for(tcp_context->ip_contexts_nr = 0;
+	    tcp_context->ip_contexts_nr < hdrs->ip_nr;
+	    tcp_context->ip_contexts_nr++)
 	{
-		const struct ip_hdr *const ip = (struct ip_hdr *) remain_data;
+		const struct net_pkt_ip *const ip = &(hdrs->ip[tcp_context->ip_contexts_nr]);
 		ip_context_t *const ip_context =
 			&(tcp_context->ip_contexts[tcp_context->ip_contexts_nr]);
 
-		/* retrieve IP version */
-		assert(remain_len >= sizeof(struct ip_hdr));
 		rohc_comp_debug(context, "found IPv%d", ip->version);
 		ip_context->version = ip->version;
 		ip_context->ctxt.vx.version = ip->version;
@@ -847,59 +901,35 @@ static bool c_tcp_create(struct rohc_comp_ctxt *const context,
 		{
 			case IPV4:
 			{
-				const struct ipv4_hdr *const ipv4 = (struct ipv4_hdr *) remain_data;
-
-				assert(remain_len >= sizeof(struct ipv4_hdr));
-				proto = ipv4->protocol;
+				const struct ipv4_hdr *const ipv4 = (struct ipv4_hdr *) ip->data;
 
 				ip_context->ctxt.v4.last_ip_id = rohc_ntoh16(ipv4->id);
 				rohc_comp_debug(context, "IP-ID 0x%04x", ip_context->ctxt.v4.last_ip_id);
 				ip_context->ctxt.v4.last_ip_id_behavior = IP_ID_BEHAVIOR_SEQ;
 				ip_context->ctxt.v4.ip_id_behavior = IP_ID_BEHAVIOR_SEQ;
-				ip_context->ctxt.v4.protocol = proto;
+				ip_context->ctxt.v4.protocol = ip->next_proto;
 				ip_context->ctxt.v4.dscp = ipv4->dscp;
 				ip_context->ctxt.v4.df = ipv4->df;
 				ip_context->ctxt.v4.ttl_hopl = ipv4->ttl;
 				ip_context->ctxt.v4.src_addr = ipv4->saddr;
 				ip_context->ctxt.v4.dst_addr = ipv4->daddr;
-
-				remain_data += sizeof(struct ipv4_hdr);
-				remain_len -= sizeof(struct ipv4_hdr);
 				break;
 			}
 			case IPV6:
 			{
-				const struct ipv6_hdr *const ipv6 = (struct ipv6_hdr *) remain_data;
-
-				assert(remain_len >= sizeof(struct ipv6_hdr));
-				proto = ipv6->nh;
+				const struct ipv6_hdr *const ipv6 = (struct ipv6_hdr *) ip->data;
 
 				ip_context->ctxt.v6.ip_id_behavior = IP_ID_BEHAVIOR_RAND;
-				ip_context->ctxt.v6.dscp = remain_data[1];
+				ip_context->ctxt.v6.dscp = ip->data[1];
 				ip_context->ctxt.v6.ttl_hopl = ipv6->hl;
 				ip_context->ctxt.v6.flow_label = ipv6_get_flow_label(ipv6);
 				memcpy(ip_context->ctxt.v6.src_addr, &ipv6->saddr,
 				       sizeof(struct ipv6_addr));
 				memcpy(ip_context->ctxt.v6.dest_addr, &ipv6->daddr,
 				       sizeof(struct ipv6_addr));
-
-				remain_data += sizeof(struct ipv6_hdr);
-				remain_len -= sizeof(struct ipv6_hdr);
-
-				rohc_comp_debug(context, "parse IPv6 extension headers");
-				while(rohc_is_ipv6_opt(proto))
-				{
-					const struct ipv6_opt *const ipv6_opt = (struct ipv6_opt *) remain_data;
-					size_t opt_len;
-					assert(remain_len >= sizeof(struct ipv6_opt));
-					opt_len = ipv6_opt_get_length(ipv6_opt);
-					rohc_comp_debug(context, "  IPv6 extension header is %zu-byte long",
-					                opt_len);
-					remain_data += opt_len;
-					remain_len -= opt_len;
-					proto = ipv6_opt->next_header;
-				}
-				ip_context->ctxt.v6.next_header = proto;
+				rohc_comp_debug(context, "  %u bytes of %u IPv6 extension headers",
+				                ip->exts_len, ip->exts_nr);
+				ip_context->ctxt.v6.next_header = ip->next_proto;
 				break;
 			}
 			default:
@@ -907,21 +937,144 @@ static bool c_tcp_create(struct rohc_comp_ctxt *const context,
 				goto free_context;
 			}
 		}
+	}
+
+	/* create context for TCP header */
+	c_tcp_create_tcp(context, hdrs);
+
+	return true;
+
+free_context:
+	rohc_comp_ctxt_body_free(context, tcp_context);
+error:
+	return false;
+}
+
+
+/**
+ * @brief Create a new TCP context from the context of another TCP flow
+ *
+ * The flows are between the same hosts: the IP contexts of the other flow are
+ * copied, then the fields that may differ, ie. the addresses of the inner IP
+ * headers and the fields that change from packet to packet, are updated with
+ * the given packet. The first packet of the new flow thus detects the IP-ID
+ * behavior from the last IP-ID of the other flow instead of guessing a
+ * sequential behavior. The TCP part is initialized as in \ref c_tcp_create.
+ *
+ * The IR packet is sent as for any other new context: the decompressor does
+ * not know the new CID yet.
+ *
+ * @param context   The compression context
+ * @param src_ctxt  The context of the other flow between the same hosts
+ * @param packet    The IP/TCP packet given to initialize the new context
+ * @return          true if successful,
+ *                  false if the context cannot be cloned
+ */
+static bool c_tcp_clone(struct rohc_comp_ctxt *const context,
+                        const struct rohc_comp_ctxt *const src_ctxt,
+                        const struct net_pkt *const packet)
+{
+	const struct rohc_comp *const comp = context->compressor;
+	const struct sc_tcp_context *const src_tcp_context = src_ctxt->specific;
+	const struct net_pkt_hdrs *const hdrs = packet->hdrs;
+	struct sc_tcp_context *tcp_context;
+	size_t i;
+
+	/* the IP headers shall be the same, without any IPv6 extension header */
+	assert(hdrs->is_complete);
+	if(src_tcp_context->ip_contexts_nr != hdrs->ip_nr)
+	{
+		goto error;
+	}
+	for(i = 0; i < hdrs->ip_nr; i++)
+	{
+		const struct net_pkt_ip *const ip = &(hdrs->ip[i]);
+		const ip_context_t *const src_ip_context = &(src_tcp_context->ip_contexts[i]);
+
+		if(src_ip_context->version != ip->version ||
+		   src_ip_context->opts_nr != 0 || ip->exts_nr != 0)
+		{
+			goto error;
+		}
+	}
 
-		tcp_context->ip_contexts_nr++;
+	/* create the TCP part of the profile context */
+	tcp_context = rohc_comp_ctxt_body_alloc(context, c_tcp_get_body_size(comp));
+	if(tcp_context == NULL)
+	{
+		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
+		           "no memory for the TCP part of the profile context");
+		goto error;
 	}
-	while(rohc_is_tunneling(proto) && tcp_context->ip_contexts_nr < ROHC_TCP_MAX_IP_HDRS);
+	memset(tcp_context, 0, sizeof(struct sc_tcp_context));
+	context->specific = tcp_context;
 
-	/* profile cannot handle the packet if it bypasses internal limit of IP headers */
-	if(rohc_is_tunneling(proto))
+	/* copy the contexts of IP headers, then update the fields that differ */
+	for(tcp_context->ip_contexts_nr = 0;
+	    tcp_context->ip_contexts_nr < hdrs->ip_nr;
+	    tcp_context->ip_contexts_nr++)
 	{
-		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		           "too many IP headers for TCP profile (%u headers max)",
-		           ROHC_TCP_MAX_IP_HDRS);
-		goto free_context;
+		const struct net_pkt_ip *const ip = &(hdrs->ip[tcp_context->ip_contexts_nr]);
+		ip_context_t *const ip_context =
+			&(tcp_context->ip_contexts[tcp_context->ip_contexts_nr]);
+
+		ip_context->version = ip->version;
+		memcpy(&ip_context->ctxt,
+		       &src_tcp_context->ip_contexts[tcp_context->ip_contexts_nr].ctxt,
+		       sizeof(ip_context->ctxt));
+
+		if(ip->version == IPV4)
+		{
+			const struct ipv4_hdr *const ipv4 = (struct ipv4_hdr *) ip->data;
+
+			ip_context->ctxt.v4.protocol = ip->next_proto;
+			ip_context->ctxt.v4.dscp = ipv4->dscp;
+			ip_context->ctxt.v4.df = ipv4->df;
+			ip_context->ctxt.v4.ttl_hopl = ipv4->ttl;
+			ip_context->ctxt.v4.src_addr = ipv4->saddr;
+			ip_context->ctxt.v4.dst_addr = ipv4->daddr;
+		}
+		else
+		{
+			const struct ipv6_hdr *const ipv6 = (struct ipv6_hdr *) ip->data;
+
+			ip_context->ctxt.v6.dscp = ip->data[1];
+			ip_context->ctxt.v6.ttl_hopl = ipv6->hl;
+			ip_context->ctxt.v6.flow_label = ipv6_get_flow_label(ipv6);
+			memcpy(ip_context->ctxt.v6.src_addr, &ipv6->saddr,
+			       sizeof(struct ipv6_addr));
+			memcpy(ip_context->ctxt.v6.dest_addr, &ipv6->daddr,
+			       sizeof(struct ipv6_addr));
+			ip_context->ctxt.v6.next_header = ip->next_proto;
+		}
 	}
+	tcp_context->is_cloned = true;
 
 	/* create context for TCP header */
+	c_tcp_create_tcp(context, hdrs);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Initialize the TCP part of a new TCP context
+ *
+ * @param context  The compression context
+ * @param hdrs     The headers of the IP/TCP packet given to initialize the
+ *                 new context
+ */
+static void c_tcp_create_tcp(struct rohc_comp_ctxt *const context,
+                             const struct net_pkt_hdrs *const hdrs)
+{
+	const struct rohc_comp *const comp = context->compressor;
+	struct sc_tcp_context *const tcp_context = context->specific;
+	const struct tcphdr *tcp;
+	size_t i;
+
 	tcp_context->tcp_seq_num_change_count = 0;
 	tcp_context->ttl_hopl_change_count = 0;
 	tcp_context->tcp_window_change_count = 0;
@@ -931,173 +1084,355 @@ static bool c_tcp_create(struct rohc_comp_ctxt *const context,
 	tcp_context->tcp_last_seq_num = -1;
 
 	/* TCP header begins just after the IP headers */
-	assert(remain_len >= sizeof(struct tcphdr));
-	tcp = (struct tcphdr *) remain_data;
+	assert(hdrs->transport_len >= sizeof(struct tcphdr));
+	tcp = (struct tcphdr *) hdrs->transport;
 	memcpy(&(tcp_context->old_tcphdr), tcp, sizeof(struct tcphdr));
 
-	/* MSN */
-	tcp_context->msn_wlsb =
-		c_create_wlsb(16, comp->wlsb_window_width, ROHC_LSB_SHIFT_TCP_SN);
-	if(tcp_context->msn_wlsb == NULL)
+	/* TCP sequence and acknowledgment (ACK) numbers */
+	tcp_context->seq_num = rohc_ntoh32(tcp->seq_num);
+	tcp_context->ack_num = rohc_ntoh32(tcp->ack_num);
+
+	/* W-LSB encoding objects for MSN, IP-ID, TTL/HL, TCP fields and options */
+	c_tcp_create_wlsb(context);
+
+	/* init the Master Sequence Number to a random value */
+	tcp_context->msn = comp->random_cb(comp, comp->random_cb_ctxt) & 0xffff;
+	rohc_comp_debug(context, "MSN = 0x%04x / %u", tcp_context->msn, tcp_context->msn);
+
+	tcp_context->ack_stride = 0;
+	tcp_context->ack_stride_count = 20; /* the sliding window is zeroed */
+
+	/* init the last list of TCP options */
+	tcp_context->tcp_opts.structure_nr_trans = 0;
+	tcp_context->tcp_opts.structure_nr = 0;
+	tcp_context->tcp_opts.last_opts_len = 0;
+	// Initialize TCP options list index used
+	for(i = 0; i <= MAX_TCP_OPTION_INDEX; i++)
 	{
-		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
-		           "failed to create W-LSB context for MSN");
-		goto free_context;
+		tcp_context->tcp_opts.list[i].used = false;
 	}
 
+	/* no TCP option Timestamp received yet */
+	tcp_context->tcp_opts.is_timestamp_init = false;
+}
+
+
+/**
+ * @brief Destroy the TCP context
+ *
+ * @param context  The TCP compression context to destroy
+ */
+static void c_tcp_destroy(struct rohc_comp_ctxt *const context)
+{
+	struct sc_tcp_context *const tcp_context = context->specific;
+
+	rohc_comp_ctxt_body_free(context, tcp_context);
+}
+
+
+/**
+ * @brief Get the size of the body of one TCP context
+ *
+ * The body holds the TCP context followed by the memory block of its W-LSB
+ * encoding objects.
+ *
+ * @param comp  The ROHC compressor
+ * @return      The size of the body of one TCP context
+ */
+static size_t c_tcp_get_body_size(const struct rohc_comp *const comp)
+{
+	return (sizeof(struct sc_tcp_context) +
+	        c_wlsb_size(comp->wlsb_window_width) * 8 + c_wlsb_size(4) * 2);
+}
+
+
+/**
+ * @brief Get the memory used by one TCP context
+ *
+ * @param context   The TCP compression context
+ * @param[out] mem  The memory used by the profile-specific part of the context
+ */
+static void c_tcp_get_mem(const struct rohc_comp_ctxt *const context,
+                          struct rohc_ctxt_mem *const mem)
+{
+	/* the memory block of the W-LSB encoding objects, see c_tcp_create_wlsb */
+	mem->wlsb_bytes = c_wlsb_size(context->compressor->wlsb_window_width) * 8 +
+	                  c_wlsb_size(4) * 2;
+
+	/* the context of the list of TCP options is embedded in the context */
+	mem->lists_bytes = sizeof(struct c_tcp_opts_ctxt);
+
+	mem->bytes = c_tcp_get_body_size(context->compressor);
+}
+
+
+/**
+ * @brief Create the W-LSB encoding objects of the TCP context
+ *
+ * All the W-LSB encoding objects of the context are stored in one single
+ * memory block, in the order they are used when encoding the packets. The
+ * memory block follows the TCP context in the body of the context.
+ *
+ * @param context  The TCP compression context
+ */
+static void c_tcp_create_wlsb(struct rohc_comp_ctxt *const context)
+{
+	struct sc_tcp_context *const tcp_context = context->specific;
+	const size_t width = context->compressor->wlsb_window_width;
+	const size_t wlsb_size = c_wlsb_size(width);
+	const size_t wlsb_scaled_size = c_wlsb_size(4);
+	uint8_t *mem;
+
+	tcp_context->wlsb_mem = (uint8_t *) (tcp_context + 1);
+	mem = tcp_context->wlsb_mem;
+
+	/* MSN */
+	tcp_context->msn_wlsb = c_init_wlsb(mem, 16, width, ROHC_LSB_SHIFT_TCP_SN);
+	mem += wlsb_size;
+
 	/* IP-ID offset */
-	tcp_context->ip_id_wlsb =
-		c_create_wlsb(16, comp->wlsb_window_width, ROHC_LSB_SHIFT_VAR);
-	if(tcp_context->ip_id_wlsb == NULL)
-	{
-		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
-		           "failed to create W-LSB context for IP-ID offset");
-		goto free_wlsb_msn;
-	}
+	tcp_context->ip_id_wlsb = c_init_wlsb(mem, 16, width, ROHC_LSB_SHIFT_VAR);
+	mem += wlsb_size;
 
 	/* innermost IPv4 TTL or IPv6 Hop Limit */
 	tcp_context->ttl_hopl_wlsb =
-		c_create_wlsb(8, comp->wlsb_window_width, ROHC_LSB_SHIFT_TCP_TTL);
-	if(tcp_context->ttl_hopl_wlsb == NULL)
-	{
-		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
-		           "failed to create W-LSB context for innermost IPv4 TTL or "
-		           "IPv6 Hop Limit");
-		goto free_wlsb_ip_id;
-	}
+		c_init_wlsb(mem, 8, width, ROHC_LSB_SHIFT_TCP_TTL);
+	mem += wlsb_size;
 
 	/* TCP window */
 	tcp_context->window_wlsb =
-		c_create_wlsb(16, comp->wlsb_window_width, ROHC_LSB_SHIFT_TCP_WINDOW);
-	if(tcp_context->window_wlsb == NULL)
-	{
-		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
-		           "failed to create W-LSB context for TCP window");
-		goto free_wlsb_ttl_hopl;
-	}
+		c_init_wlsb(mem, 16, width, ROHC_LSB_SHIFT_TCP_WINDOW);
+	mem += wlsb_size;
 
 	/* TCP sequence number */
-	tcp_context->seq_num = rohc_ntoh32(tcp->seq_num);
-	tcp_context->seq_wlsb =
-		c_create_wlsb(32, comp->wlsb_window_width, ROHC_LSB_SHIFT_VAR);
-	if(tcp_context->seq_wlsb == NULL)
+	tcp_context->seq_wlsb = c_init_wlsb(mem, 32, width, ROHC_LSB_SHIFT_VAR);
+	mem += wlsb_size;
+	tcp_context->seq_scaled_wlsb = c_init_wlsb(mem, 32, 4, 7);
+	mem += wlsb_scaled_size;
+
+	/* TCP acknowledgment (ACK) number */
+	tcp_context->ack_wlsb = c_init_wlsb(mem, 32, width, ROHC_LSB_SHIFT_VAR);
+	mem += wlsb_size;
+	tcp_context->ack_scaled_wlsb = c_init_wlsb(mem, 32, 4, 3);
+	mem += wlsb_scaled_size;
+
+	/* TCP option Timestamp (request and reply) */
+	tcp_context->tcp_opts.ts_req_wlsb =
+		c_init_wlsb(mem, 32, width, ROHC_LSB_SHIFT_VAR);
+	mem += wlsb_size;
+	tcp_context->tcp_opts.ts_reply_wlsb =
+		c_init_wlsb(mem, 32, width, ROHC_LSB_SHIFT_VAR);
+	mem += wlsb_size;
+
+	assert(mem == tcp_context->wlsb_mem + wlsb_size * 8 + wlsb_scaled_size * 2);
+}
+
+
+/**
+ * @brief Save the TCP context in a snapshot
+ *
+ * The TCP context is saved as it is in memory, without the IP contexts and
+ * the IP extension header contexts that are not used, followed by the memory
+ * block of its W-LSB encoding objects.
+ * Both are preceded by their full lengths, so that a snapshot from another
+ * build or with another W-LSB window width is detected at restoration.
+ *
+ * @param context   The TCP compression context
+ * @param write_cb  The callback used to write the snapshot
+ * @param priv      The private context given to the callback
+ * @return          true if the context was successfully written,
+ *                  false if the callback failed
+ */
+static bool c_tcp_snapshot(const struct rohc_comp_ctxt *const context,
+                           const rohc_snapshot_write_t write_cb,
+                           void *const priv)
+{
+	const struct sc_tcp_context *const tcp_context = context->specific;
+	const size_t width = context->compressor->wlsb_window_width;
+	const uint32_t lens[2] =
 	{
-		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
-		           "failed to create W-LSB context for TCP sequence number");
-		goto free_wlsb_window;
-	}
-	tcp_context->seq_scaled_wlsb = c_create_wlsb(32, 4, 7);
-	if(tcp_context->seq_scaled_wlsb == NULL)
+		sizeof(struct sc_tcp_context),
+		c_wlsb_size(width) * 8 + c_wlsb_size(4) * 2,
+	};
+
+	size_t i;
+
+	if(!write_cb(priv, (const uint8_t *) lens, sizeof(lens)) ||
+	   !write_cb(priv, (const uint8_t *) tcp_context,
+	             offsetof(struct sc_tcp_context, ip_contexts)))
 	{
-		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
-		           "failed to create W-LSB context for TCP scaled sequence "
-		           "number");
-		goto free_wlsb_seq;
+		goto error;
 	}
-
-	/* TCP acknowledgment (ACK) number */
-	tcp_context->ack_num = rohc_ntoh32(tcp->ack_num);
-	tcp_context->ack_wlsb =
-		c_create_wlsb(32, comp->wlsb_window_width, ROHC_LSB_SHIFT_VAR);
-	if(tcp_context->ack_wlsb == NULL)
+	for(i = 0; i < tcp_context->ip_contexts_nr; i++)
 	{
-		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
-		           "failed to create W-LSB context for TCP ACK number");
-		goto free_wlsb_seq_scaled;
+		const ip_context_t *const ip_context = &(tcp_context->ip_contexts[i]);
+
+		if(!write_cb(priv, (const uint8_t *) ip_context,
+		             offsetof(ip_context_t, opts) +
+		             ip_context->opts_nr * sizeof(ip_option_context_t)))
+		{
+			goto error;
+		}
 	}
-	tcp_context->ack_scaled_wlsb = c_create_wlsb(32, 4, 3);
-	if(tcp_context->ack_scaled_wlsb == NULL)
+	if(!write_cb(priv, tcp_context->wlsb_mem, lens[1]))
 	{
-		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
-		           "failed to create W-LSB context for TCP scaled ACK number");
-		goto free_wlsb_ack;
+		goto error;
 	}
 
-	/* init the Master Sequence Number to a random value */
-	tcp_context->msn = comp->random_cb(comp, comp->random_cb_ctxt) & 0xffff;
-	rohc_comp_debug(context, "MSN = 0x%04x / %u", tcp_context->msn, tcp_context->msn);
+	return true;
 
-	tcp_context->ack_stride = 0;
+error:
+	return false;
+}
 
-	/* init the last list of TCP options */
-	tcp_context->tcp_opts.structure_nr_trans = 0;
-	tcp_context->tcp_opts.structure_nr = 0;
-	// Initialize TCP options list index used
-	for(i = 0; i <= MAX_TCP_OPTION_INDEX; i++)
+
+/**
+ * @brief Restore the TCP context from a snapshot
+ *
+ * The W-LSB encoding objects of the saved context are moved to the new
+ * memory block, at the same offsets. Their windows are checked against the
+ * width configured for the compressor before they are used again.
+ *
+ * @param context  The TCP compression context
+ * @param read_cb  The callback used to read the snapshot
+ * @param priv     The private context given to the callback
+ * @return         true if the context was successfully restored,
+ *                 false if the snapshot does not match the context
+ */
+static bool c_tcp_restore(struct rohc_comp_ctxt *const context,
+                          const rohc_snapshot_read_t read_cb,
+                          void *const priv)
+{
+	const size_t width = context->compressor->wlsb_window_width;
+	const size_t wlsb_mem_len = c_wlsb_size(width) * 8 + c_wlsb_size(4) * 2;
+	struct c_wlsb **wlsb_ptrs[10];
+	struct sc_tcp_context *tcp_context;
+	uint32_t lens[2];
+	size_t offset;
+	size_t i;
+
+	if(!read_cb(priv, (uint8_t *) lens, sizeof(lens)))
 	{
-		tcp_context->tcp_opts.list[i].used = false;
+		goto error;
+	}
+	if(lens[0] != sizeof(struct sc_tcp_context) || lens[1] != wlsb_mem_len)
+	{
+		rohc_comp_warn(context, "TCP context in snapshot does not match the "
+		               "compressor: %u/%u bytes instead of %zu/%zu bytes",
+		               lens[0], lens[1], sizeof(struct sc_tcp_context),
+		               wlsb_mem_len);
+		goto error;
 	}
 
-	/* no TCP option Timestamp received yet */
-	tcp_context->tcp_opts.is_timestamp_init = false;
-	/* TCP option Timestamp (request) */
-	tcp_context->tcp_opts.ts_req_wlsb =
-		c_create_wlsb(32, comp->wlsb_window_width, ROHC_LSB_SHIFT_VAR);
-	if(tcp_context->tcp_opts.ts_req_wlsb == NULL)
+	tcp_context = rohc_comp_ctxt_body_alloc(context,
+	                                        c_tcp_get_body_size(context->compressor));
+	if(tcp_context == NULL)
 	{
-		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
-		           "failed to create W-LSB context for TCP option Timestamp "
-		           "request");
-		goto free_wlsb_ack_scaled;
+		goto error;
 	}
-	/* TCP option Timestamp (reply) */
-	tcp_context->tcp_opts.ts_reply_wlsb =
-		c_create_wlsb(32, comp->wlsb_window_width, ROHC_LSB_SHIFT_VAR);
-	if(tcp_context->tcp_opts.ts_reply_wlsb == NULL)
+	memset(tcp_context, 0, sizeof(struct sc_tcp_context));
+	if(!read_cb(priv, (uint8_t *) tcp_context,
+	            offsetof(struct sc_tcp_context, ip_contexts)))
 	{
-		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
-		           "failed to create W-LSB context for TCP option Timestamp "
-		           "reply");
-		goto free_wlsb_opt_ts_req;
+		goto free_context;
+	}
+	if(tcp_context->ip_contexts_nr > ROHC_TCP_MAX_IP_HDRS)
+	{
+		rohc_comp_warn(context, "malformed TCP context in snapshot: %zu IP "
+		               "contexts", tcp_context->ip_contexts_nr);
+		goto free_context;
+	}
+	for(i = 0; i < tcp_context->ip_contexts_nr; i++)
+	{
+		ip_context_t *const ip_context = &(tcp_context->ip_contexts[i]);
+
+		if(!read_cb(priv, (uint8_t *) ip_context, offsetof(ip_context_t, opts)))
+		{
+			goto free_context;
+		}
+		if(ip_context->opts_nr > ROHC_TCP_MAX_IP_EXT_HDRS)
+		{
+			rohc_comp_warn(context, "malformed TCP context in snapshot: %zu IP "
+			               "extension headers", ip_context->opts_nr);
+			goto free_context;
+		}
+		if(!read_cb(priv, (uint8_t *) ip_context->opts,
+		            ip_context->opts_nr * sizeof(ip_option_context_t)))
+		{
+			goto free_context;
+		}
+	}
+	tcp_context->wlsb_mem = (uint8_t *) (tcp_context + 1);
+	if(!read_cb(priv, tcp_context->wlsb_mem, wlsb_mem_len))
+	{
+		goto free_context;
 	}
 
+	/* the W-LSB objects are at the same offsets in the new memory block as
+	 * in c_tcp_create_wlsb(), their windows shall match the configured
+	 * widths */
+	wlsb_ptrs[0] = &tcp_context->msn_wlsb;
+	wlsb_ptrs[1] = &tcp_context->ip_id_wlsb;
+	wlsb_ptrs[2] = &tcp_context->ttl_hopl_wlsb;
+	wlsb_ptrs[3] = &tcp_context->window_wlsb;
+	wlsb_ptrs[4] = &tcp_context->seq_wlsb;
+	wlsb_ptrs[5] = &tcp_context->seq_scaled_wlsb;
+	wlsb_ptrs[6] = &tcp_context->ack_wlsb;
+	wlsb_ptrs[7] = &tcp_context->ack_scaled_wlsb;
+	wlsb_ptrs[8] = &tcp_context->tcp_opts.ts_req_wlsb;
+	wlsb_ptrs[9] = &tcp_context->tcp_opts.ts_reply_wlsb;
+	for(i = 0, offset = 0; i < 10; i++)
+	{
+		const size_t wlsb_width = ((i == 5 || i == 7) ? 4 : width);
+
+		*(wlsb_ptrs[i]) = (struct c_wlsb *) (tcp_context->wlsb_mem + offset);
+		if(!c_wlsb_relocate(*(wlsb_ptrs[i]), wlsb_width))
+		{
+			rohc_comp_warn(context, "malformed TCP context in snapshot: W-LSB "
+			               "window #%zu does not match its width of %zu entries",
+			               i + 1, wlsb_width);
+			goto free_context;
+		}
+		offset += c_wlsb_size(wlsb_width);
+	}
+	assert(offset == wlsb_mem_len);
+
+	context->specific = tcp_context;
+
 	return true;
 
-free_wlsb_opt_ts_req:
-	c_destroy_wlsb(tcp_context->tcp_opts.ts_req_wlsb);
-free_wlsb_ack_scaled:
-	c_destroy_wlsb(tcp_context->ack_scaled_wlsb);
-free_wlsb_ack:
-	c_destroy_wlsb(tcp_context->ack_wlsb);
-free_wlsb_seq_scaled:
-	c_destroy_wlsb(tcp_context->seq_scaled_wlsb);
-free_wlsb_seq:
-	c_destroy_wlsb(tcp_context->seq_wlsb);
-free_wlsb_window:
-	c_destroy_wlsb(tcp_context->window_wlsb);
-free_wlsb_ttl_hopl:
-	c_destroy_wlsb(tcp_context->ttl_hopl_wlsb);
-free_wlsb_ip_id:
-	c_destroy_wlsb(tcp_context->ip_id_wlsb);
-free_wlsb_msn:
-	c_destroy_wlsb(tcp_context->msn_wlsb);
 free_context:
-	free(tcp_context);
+	rohc_comp_ctxt_body_free(context, tcp_context);
 error:
 	return false;
 }
 
 
 /**
- * @brief Destroy the TCP context
+ * @brief Change the number of entries that the W-LSB windows of the TCP
+ *        context keep
  *
- * @param context  The TCP compression context to destroy
+ * The windows of the scaled sequence and acknowledgment numbers are smaller
+ * than the other ones, they are only narrowed below their own width.
+ *
+ * @param context  The TCP compression context
+ * @param width    The new number of entries of the W-LSB windows
  */
-static void c_tcp_destroy(struct rohc_comp_ctxt *const context)
+static void c_tcp_set_wlsb_width(struct rohc_comp_ctxt *const context,
+                                 const size_t width)
 {
 	struct sc_tcp_context *const tcp_context = context->specific;
 
-	c_destroy_wlsb(tcp_context->tcp_opts.ts_reply_wlsb);
-	c_destroy_wlsb(tcp_context->tcp_opts.ts_req_wlsb);
-	c_destroy_wlsb(tcp_context->ack_scaled_wlsb);
-	c_destroy_wlsb(tcp_context->ack_wlsb);
-	c_destroy_wlsb(tcp_context->seq_scaled_wlsb);
-	c_destroy_wlsb(tcp_context->seq_wlsb);
-	c_destroy_wlsb(tcp_context->window_wlsb);
-	c_destroy_wlsb(tcp_context->ip_id_wlsb);
-	c_destroy_wlsb(tcp_context->ttl_hopl_wlsb);
-	c_destroy_wlsb(tcp_context->msn_wlsb);
-	free(tcp_context);
+	c_wlsb_set_width(tcp_context->msn_wlsb, width);
+	c_wlsb_set_width(tcp_context->ip_id_wlsb, width);
+	c_wlsb_set_width(tcp_context->ttl_hopl_wlsb, width);
+	c_wlsb_set_width(tcp_context->window_wlsb, width);
+	c_wlsb_set_width(tcp_context->seq_wlsb, width);
+	c_wlsb_set_width(tcp_context->seq_scaled_wlsb, width);
+	c_wlsb_set_width(tcp_context->ack_wlsb, width);
+	c_wlsb_set_width(tcp_context->ack_scaled_wlsb, width);
+	c_wlsb_set_width(tcp_context->tcp_opts.ts_req_wlsb, width);
+	c_wlsb_set_width(tcp_context->tcp_opts.ts_reply_wlsb, width);
 }
 
 
@@ -1126,66 +1461,46 @@ static void c_tcp_destroy(struct rohc_comp_ctxt *const context)
 static bool c_tcp_check_profile(const struct rohc_comp *const comp,
                                 const struct net_pkt *const packet)
 {
-	/* TODO: should avoid code duplication by using net_pkt as
-	 * rohc_comp_rfc3095_check_profile() does */
+	const struct net_pkt_hdrs *const hdrs = packet->hdrs;
 	const uint8_t *remain_data;
 	size_t remain_len;
-	size_t ip_hdrs_nr;
+	size_t ip_hdr_pos;
 	uint8_t next_proto;
 	const struct tcphdr *tcp_header;
 
 	assert(comp != NULL);
 	assert(packet != NULL);
+	assert(hdrs != NULL);
 
-	remain_data = packet->outer_ip.data;
-	remain_len = packet->outer_ip.size;
-
-	/* check that the the versions of IP headers are 4 or 6 and that IP headers
-	 * are not IP fragments */
-	ip_hdrs_nr = 0;
-	do
+	/* check that the IP headers described while parsing the packet are
+	 * acceptable and that they are not IP fragments */
+	for(ip_hdr_pos = 0; ip_hdr_pos < hdrs->ip_nr; ip_hdr_pos++)
 	{
-		const struct ip_hdr *const ip = (struct ip_hdr *) remain_data;
-
-		/* check minimal length for IP version */
-		if(remain_len < sizeof(struct ip_hdr))
-		{
-			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			           "failed to determine the version of IP header #%zu",
-			           ip_hdrs_nr + 1);
-			goto bad_profile;
-		}
+		const struct net_pkt_ip *const ip = &(hdrs->ip[ip_hdr_pos]);
 
 		if(ip->version == IPV4)
 		{
-			const struct ipv4_hdr *const ipv4 = (struct ipv4_hdr *) remain_data;
+			const struct ipv4_hdr *const ipv4 = (struct ipv4_hdr *) ip->data;
 			const size_t ipv4_min_words_nr = sizeof(struct ipv4_hdr) / sizeof(uint32_t);
 
 			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "found IPv4");
-			if(remain_len < sizeof(struct ipv4_hdr))
-			{
-				rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-				           "uncompressed packet too short for IP header #%zu",
-				           ip_hdrs_nr + 1);
-				goto bad_profile;
-			}
 
 			/* IPv4 options are not supported by the TCP profile */
 			if(ipv4->ihl != ipv4_min_words_nr)
 			{
 				rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 				           "IP packet #%zu is not supported by the profile: "
-				           "IP options are not accepted", ip_hdrs_nr + 1);
+				           "IP options are not accepted", ip_hdr_pos + 1);
 				goto bad_profile;
 			}
 
 			/* IPv4 total length shall be correct */
-			if(rohc_ntoh16(ipv4->tot_len) != remain_len)
+			if(rohc_ntoh16(ipv4->tot_len) != ip->len)
 			{
 				rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 				           "IP packet #%zu is not supported by the profile: total "
-				           "length is %u while it shall be %zu", ip_hdrs_nr + 1,
-				           rohc_ntoh16(ipv4->tot_len), remain_len);
+				           "length is %u while it shall be %zu", ip_hdr_pos + 1,
+				           rohc_ntoh16(ipv4->tot_len), ip->len);
 				goto bad_profile;
 			}
 
@@ -1193,85 +1508,65 @@ static bool c_tcp_check_profile(const struct rohc_comp *const comp,
 			if(ipv4_is_fragment(ipv4))
 			{
 				rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-				           "IP packet #%zu is fragmented", ip_hdrs_nr + 1);
+				           "IP packet #%zu is fragmented", ip_hdr_pos + 1);
 				goto bad_profile;
 			}
 
 			/* check if the checksum of the IPv4 header is correct */
 			if((comp->features & ROHC_COMP_FEATURE_NO_IP_CHECKSUMS) == 0 &&
-			   ip_fast_csum(remain_data, ipv4_min_words_nr) != 0)
+			   ip_fast_csum(ip->data, ipv4_min_words_nr) != 0)
 			{
 				rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 				           "IP packet #%zu is not correct (bad checksum)",
-				           ip_hdrs_nr + 1);
+				           ip_hdr_pos + 1);
 				goto bad_profile;
 			}
-
-			next_proto = ipv4->protocol;
-			remain_data += sizeof(struct ipv4_hdr);
-			remain_len -= sizeof(struct ipv4_hdr);
 		}
-		else if(ip->version == IPV6)
+		else
 		{
-			const struct ipv6_hdr *const ipv6 = (struct ipv6_hdr *) remain_data;
-			size_t ipv6_exts_len;
+			const struct ipv6_hdr *const ipv6 = (struct ipv6_hdr *) ip->data;
 
+			assert(ip->version == IPV6);
 			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "found IPv6");
-			if(remain_len < sizeof(struct ipv6_hdr))
-			{
-				rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-				           "uncompressed packet too short for IP header #%zu",
-				           ip_hdrs_nr + 1);
-				goto bad_profile;
-			}
-			next_proto = ipv6->nh;
-			remain_data += sizeof(struct ipv6_hdr);
-			remain_len -= sizeof(struct ipv6_hdr);
 
 			/* payload length shall be correct */
-			if(rohc_ntoh16(ipv6->plen) != remain_len)
+			if(rohc_ntoh16(ipv6->plen) != (ip->len - ip->hdr_len))
 			{
 				rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 				           "IP packet #%zu is not supported by the profile: payload "
-				           "length is %u while it shall be %zu", ip_hdrs_nr + 1,
-				           rohc_ntoh16(ipv6->plen), remain_len);
+				           "length is %u while it shall be %zu", ip_hdr_pos + 1,
+				           rohc_ntoh16(ipv6->plen), ip->len - ip->hdr_len);
 				goto bad_profile;
 			}
 
-			/* reject packets with malformed IPv6 extension headers or IPv6
-			 * extension headers that are not compatible with the TCP profile */
-			if(!rohc_comp_tcp_are_ipv6_exts_acceptable(comp, &next_proto,
-			                                           remain_data, remain_len,
-			                                           &ipv6_exts_len))
+			/* reject packets with IPv6 extension headers that are not compatible
+			 * with the TCP profile */
+			if(!rohc_comp_tcp_are_ipv6_exts_acceptable(comp, ip))
 			{
 				rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 				           "IP packet #%zu is not supported by the profile: "
-				           "malformed or incompatible IPv6 extension headers "
-				           "detected", ip_hdrs_nr + 1);
+				           "incompatible IPv6 extension headers detected",
+				           ip_hdr_pos + 1);
 				goto bad_profile;
 			}
-			remain_data += ipv6_exts_len;
-			remain_len -= ipv6_exts_len;
 		}
-		else
-		{
-			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			           "unsupported version %u for header #%zu",
-			           ip->version, ip_hdrs_nr + 1);
-			goto bad_profile;
-		}
-		ip_hdrs_nr++;
 	}
-	while(rohc_is_tunneling(next_proto) && ip_hdrs_nr < ROHC_TCP_MAX_IP_HDRS);
 
-	/* profile cannot handle the packet if it bypasses internal limit of IP headers */
-	if(rohc_is_tunneling(next_proto))
+	/* profile cannot handle the packet if one header is truncated or malformed,
+	 * if the IP version is unknown, or if the packet bypasses internal limits
+	 * of IP headers or IPv6 extension headers */
+	if(!hdrs->is_complete)
 	{
 		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		           "too many IP headers for TCP profile (%u headers max)",
-		           ROHC_TCP_MAX_IP_HDRS);
+		           "malformed IP header #%zu, or too many IP headers (%u max) "
+		           "or IPv6 extension headers (%u max) for TCP profile",
+		           hdrs->ip_nr + 1, ROHC_TCP_MAX_IP_HDRS,
+		           ROHC_TCP_MAX_IP_EXT_HDRS);
 		goto bad_profile;
 	}
+	next_proto = hdrs->transport_proto;
+	remain_data = hdrs->transport;
+	remain_len = hdrs->transport_len;
 
 	/* check that the transport protocol is TCP */
 	if(next_proto != ROHC_IPPROTO_TCP)
@@ -1324,70 +1619,40 @@ bad_profile:
 /**
  * @brief Whether IPv6 extension headers are acceptable for TCP profile or not
  *
- * TCP options are acceptable if:
- *  - the last IPv6 extension header is not truncated,
- *  - no more than \e ROHC_TCP_MAX_IP_EXT_HDRS extension headers are present,
+ * The extension headers were described while parsing the packet, so they are
+ * neither truncated nor more than \e ROHC_TCP_MAX_IP_EXT_HDRS. They are
+ * acceptable if:
+ *  - they are Hop-by-Hop, Routing or Destination options only,
+ *  - the Hop-by-Hop extension header, if any, is the very first one,
  *  - each extension header is present only once (except Destination that may
  *    occur twice).
  *
- * @param comp                The ROHC compressor
- * @param[in,out] next_proto  in: the protocol type of the first extension header
- *                            out: the protocol type of the transport header
- * @param exts                The beginning of the IPv6 extension headers
- * @param max_exts_len        The maximum length (in bytes) of the extension headers
- * @param[out] exts_len       The length (in bytes) of the IPv6 extension headers
- * @return                    true if the IPv6 extension headers are acceptable,
- *                            false if they are not
+ * @param comp  The ROHC compressor
+ * @param ip    The IPv6 header described with its extension headers
+ * @return      true if the IPv6 extension headers are acceptable,
+ *              false if they are not
  *
  * @see ROHC_TCP_MAX_IP_EXT_HDRS
  */
 static bool rohc_comp_tcp_are_ipv6_exts_acceptable(const struct rohc_comp *const comp,
-                                                   uint8_t *const next_proto,
-                                                   const uint8_t *const exts,
-                                                   const size_t max_exts_len,
-                                                   size_t *const exts_len)
+                                                   const struct net_pkt_ip *const ip)
 {
-	uint8_t ipv6_ext_types_count[ROHC_IPPROTO_MAX + 1] = { 0 };
-	const uint8_t *remain_data = exts;
-	size_t remain_len = max_exts_len;
-	size_t ipv6_ext_nr;
-
-	(*exts_len) = 0;
+	size_t hopopts_nr = 0;
+	size_t routing_nr = 0;
+	size_t dstopts_nr = 0;
+	size_t ext_pos;
 
-	ipv6_ext_nr = 0;
-	while(rohc_is_ipv6_opt(*next_proto) && ipv6_ext_nr < ROHC_TCP_MAX_IP_EXT_HDRS)
+	for(ext_pos = 0; ext_pos < ip->exts_nr; ext_pos++)
 	{
-		size_t ext_len;
+		const struct net_pkt_ext *const ext = &(ip->exts[ext_pos]);
 
 		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		           "  found extension header #%zu of type %u",
-		           ipv6_ext_nr + 1, *next_proto);
+		           "  found %u-byte extension header #%zu of type %u",
+		           ext->len, ext_pos + 1, ext->type);
 
-		switch(*next_proto)
+		switch(ext->type)
 		{
 			case ROHC_IPPROTO_HOPOPTS: /* IPv6 Hop-by-Hop options */
-			case ROHC_IPPROTO_ROUTING: /* IPv6 routing header */
-			case ROHC_IPPROTO_DSTOPTS: /* IPv6 destination options */
-			{
-				const struct ipv6_opt *const ipv6_opt =
-					(struct ipv6_opt *) remain_data;
-
-				if(remain_len < (sizeof(ipv6_opt) - 1))
-				{
-					rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-					           "packet too short for IPv6 extension header");
-					goto bad_exts;
-				}
-
-				ext_len = ipv6_opt_get_length(ipv6_opt);
-				if(remain_len < ext_len)
-				{
-					rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-					           "packet too short for IPv6 extension header");
-					goto bad_exts;
-				}
-				(*next_proto) = ipv6_opt->next_header;
-
 				/* RFC 2460 §4 reads:
 				 *   The Hop-by-Hop Options header, when present, must
 				 *   immediately follow the IPv6 header.
@@ -1395,16 +1660,22 @@ static bool rohc_comp_tcp_are_ipv6_exts_acceptable(const struct rohc_comp *const
 				 *   The same action [ie. reject packet] should be taken if a
 				 *   node encounters a Next Header value of zero in any header other
 				 *   than an IPv6 header. */
-				if((*next_proto) == ROHC_IPPROTO_HOPOPTS && ipv6_ext_nr != 0)
+				if(ext_pos != 0)
 				{
 					rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 					           "malformed IPv6 header: the Hop-By-Hop extension "
 					           "header should be the very first extension header, "
-					           "not the #%zu one", ipv6_ext_nr + 1);
+					           "not the #%zu one", ext_pos + 1);
 					goto bad_exts;
 				}
+				hopopts_nr++;
+				break;
+			case ROHC_IPPROTO_ROUTING: /* IPv6 routing header */
+				routing_nr++;
+				break;
+			case ROHC_IPPROTO_DSTOPTS: /* IPv6 destination options */
+				dstopts_nr++;
 				break;
-			}
 			// case ROHC_IPPROTO_ESP : ???
 			case ROHC_IPPROTO_GRE:  /* TODO: GRE not yet supported */
 			case ROHC_IPPROTO_MINE: /* TODO: MINE not yet supported */
@@ -1413,62 +1684,31 @@ static bool rohc_comp_tcp_are_ipv6_exts_acceptable(const struct rohc_comp *const
 			{
 				rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 				           "malformed IPv6 header: unsupported IPv6 extension "
-				           "header %u detected", *next_proto);
+				           "header %u detected", ext->type);
 				goto bad_exts;
 			}
 		}
-		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		           "  extension header is %zu-byte long", ext_len);
-		remain_data += ext_len;
-		remain_len -= ext_len;
-
-		ipv6_ext_nr++;
-		(*exts_len) += ext_len;
-		if(ipv6_ext_types_count[*next_proto] >= 255)
-		{
-			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			           "too many IPv6 extension header of type 0x%02x", *next_proto);
-			goto bad_exts;
-		}
-		ipv6_ext_types_count[*next_proto]++;
-	}
-
-	/* profile cannot handle the packet if it bypasses internal limit of
-	 * IPv6 extension headers */
-	if(ipv6_ext_nr > ROHC_TCP_MAX_IP_EXT_HDRS)
-	{
-		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		           "IP header got too many IPv6 extension headers for TCP profile "
-		           "(%u headers max)", ROHC_TCP_MAX_IP_EXT_HDRS);
-		goto bad_exts;
 	}
 
 	/* RFC 2460 §4.1 reads:
 	 *   Each extension header should occur at most once, except for the
 	 *   Destination Options header which should occur at most twice (once
 	 *   before a Routing header and once before the upper-layer header). */
+	if(dstopts_nr > 2)
 	{
-		unsigned int ext_type;
-
-		for(ext_type = 0; ext_type <= ROHC_IPPROTO_MAX; ext_type++)
-		{
-			if(ext_type == ROHC_IPPROTO_DSTOPTS && ipv6_ext_types_count[ext_type] > 2)
-			{
-				rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-				           "malformed IPv6 header: the Destination extension "
-				           "header should occur at most twice, but it was "
-				           "found %u times", ipv6_ext_types_count[ext_type]);
-				goto bad_exts;
-			}
-			else if(ext_type != ROHC_IPPROTO_DSTOPTS && ipv6_ext_types_count[ext_type] > 1)
-			{
-				rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-				           "malformed IPv6 header: the extension header of type "
-				           "%u header should occur at most once, but it was found "
-				           "%u times", ext_type, ipv6_ext_types_count[ext_type]);
-				goto bad_exts;
-			}
-		}
+		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "malformed IPv6 header: the Destination extension header "
+		           "should occur at most twice, but it was found %zu times",
+		           dstopts_nr);
+		goto bad_exts;
+	}
+	if(hopopts_nr > 1 || routing_nr > 1)
+	{
+		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "malformed IPv6 header: the Hop-by-Hop and Routing extension "
+		           "headers should occur at most once, but they were found %zu "
+		           "and %zu times", hopopts_nr, routing_nr);
+		goto bad_exts;
 	}
 
 	return true;
@@ -1508,24 +1748,40 @@ static bool c_tcp_check_context(const struct rohc_comp_ctxt *const context,
                                 const struct net_pkt *const packet)
 {
 	struct sc_tcp_context *const tcp_context = context->specific;
-	const uint8_t *remain_data = packet->outer_ip.data;
-	size_t remain_len = packet->outer_ip.size;
+	const struct net_pkt_hdrs *const hdrs = packet->hdrs;
 	size_t ip_hdr_pos;
-	uint8_t next_proto = ROHC_IPPROTO_IPIP;
 	const struct tcphdr *tcp;
 	bool is_tcp_same;
 
-	/* parse the IP headers (lengths already checked while checking profile) */
-	for(ip_hdr_pos = 0;
-	    ip_hdr_pos < tcp_context->ip_contexts_nr && rohc_is_tunneling(next_proto);
-	    ip_hdr_pos++)
+	/* the IP headers were described and checked while checking profile */
+	assert(hdrs->is_complete);
+
+	/* the flow that created the context is recognized at once if its identity
+	 * covers all its IP headers */
+	if(tcp_context->ip_contexts_nr <= 2 &&
+	   net_pkt_flow_is_same(&context->flow, &packet->flow))
+	{
+		rohc_comp_debug(context, "  same flow identity");
+		return true;
+	}
+
+	if(hdrs->ip_nr < tcp_context->ip_contexts_nr)
+	{
+		rohc_comp_debug(context, "  less IP headers than context");
+		goto bad_context;
+	}
+	if(hdrs->ip_nr > tcp_context->ip_contexts_nr)
 	{
-		const struct ip_hdr *const ip = (struct ip_hdr *) remain_data;
+		rohc_comp_debug(context, "  more IP headers than context");
+		goto bad_context;
+	}
+
+	for(ip_hdr_pos = 0; ip_hdr_pos < tcp_context->ip_contexts_nr; ip_hdr_pos++)
+	{
+		const struct net_pkt_ip *const ip = &(hdrs->ip[ip_hdr_pos]);
 		const ip_context_t *const ip_context = &(tcp_context->ip_contexts[ip_hdr_pos]);
-		size_t ip_ext_pos;
 
-		/* retrieve IP version */
-		assert(remain_len >= sizeof(struct ip_hdr));
+		/* check IP version */
 		rohc_comp_debug(context, "found IPv%d", ip->version);
 		if(ip->version != ip_context->version)
 		{
@@ -1535,9 +1791,7 @@ static bool c_tcp_check_context(const struct rohc_comp_ctxt *const context,
 
 		if(ip->version == IPV4)
 		{
-			const struct ipv4_hdr *const ipv4 = (struct ipv4_hdr *) remain_data;
-
-			assert(remain_len >= sizeof(struct ipv4_hdr));
+			const struct ipv4_hdr *const ipv4 = (struct ipv4_hdr *) ip->data;
 
 			/* check source and destination addresses */
 			if(ipv4->saddr != ip_context->ctxt.v4.src_addr ||
@@ -1549,23 +1803,18 @@ static bool c_tcp_check_context(const struct rohc_comp_ctxt *const context,
 			rohc_comp_debug(context, "  same IPv4 addresses");
 
 			/* check transport protocol */
-			next_proto = ipv4->protocol;
-			if(next_proto != ip_context->ctxt.v4.protocol)
+			if(ip->next_proto != ip_context->ctxt.v4.protocol)
 			{
 				rohc_comp_debug(context, "  IPv4 not same protocol");
 				goto bad_context;
 			}
-			rohc_comp_debug(context, "  IPv4 same protocol %d", next_proto);
-
-			/* skip IPv4 header */
-			remain_data += sizeof(struct ipv4_hdr);
-			remain_len -= sizeof(struct ipv4_hdr);
+			rohc_comp_debug(context, "  IPv4 same protocol %d", ip->next_proto);
 		}
-		else if(ip->version == IPV6)
+		else
 		{
-			const struct ipv6_hdr *const ipv6 = (struct ipv6_hdr *) remain_data;
+			const struct ipv6_hdr *const ipv6 = (struct ipv6_hdr *) ip->data;
 
-			assert(remain_len >= sizeof(struct ipv6_hdr));
+			assert(ip->version == IPV6);
 
 			/* check source and destination addresses */
 			if(memcmp(&ipv6->saddr, ip_context->ctxt.v6.src_addr,
@@ -1582,58 +1831,22 @@ static bool c_tcp_check_context(const struct rohc_comp_ctxt *const context,
 			if(ipv6_get_flow_label(ipv6) != ip_context->ctxt.v6.flow_label)
 			{
 				rohc_comp_debug(context, "  not same IPv6 flow label");
-				goto bad_context;
-			}
-			rohc_comp_debug(context, "  same IPv6 flow label");
-
-			/* skip IPv6 base header */
-			remain_data += sizeof(struct ipv6_hdr);
-			remain_len -= sizeof(struct ipv6_hdr);
-
-			/* find transport header/protocol, skip any IPv6 extension headers */
-			next_proto = ipv6->nh;
-			for(ip_ext_pos = 0; rohc_is_ipv6_opt(next_proto); ip_ext_pos++)
-			{
-				const struct ipv6_opt *const ipv6_opt = (struct ipv6_opt *) remain_data;
-				size_t opt_len;
-				assert(remain_len >= sizeof(struct ipv6_opt));
-				opt_len = ipv6_opt_get_length(ipv6_opt);
-				remain_data += opt_len;
-				remain_len -= opt_len;
-				next_proto = ipv6_opt->next_header;
-			}
-
-			/* check transport header protocol */
-			if(next_proto != ip_context->ctxt.v6.next_header)
-			{
-				rohc_comp_debug(context, "  IPv6 not same protocol %u", next_proto);
-				goto bad_context;
-			}
-			rohc_comp_debug(context, "  IPv6 same protocol %u", next_proto);
-		}
-		else
-		{
-			rohc_comp_warn(context, "unsupported version %u for header #%zu",
-			               ip->version, ip_hdr_pos + 1);
-			assert(0);
-			goto bad_context;
-		}
-	}
-
-	if(ip_hdr_pos < tcp_context->ip_contexts_nr)
-	{
-		rohc_comp_debug(context, "  less IP headers than context");
-		goto bad_context;
-	}
+				goto bad_context;
+			}
+			rohc_comp_debug(context, "  same IPv6 flow label");
 
-	if(rohc_is_tunneling(next_proto))
-	{
-		rohc_comp_debug(context, "  more IP headers than context");
-		goto bad_context;
+			/* check transport header protocol, after any IPv6 extension headers */
+			if(ip->next_proto != ip_context->ctxt.v6.next_header)
+			{
+				rohc_comp_debug(context, "  IPv6 not same protocol %u", ip->next_proto);
+				goto bad_context;
+			}
+			rohc_comp_debug(context, "  IPv6 same protocol %u", ip->next_proto);
+		}
 	}
 
-	assert(remain_len >= sizeof(struct tcphdr));
-	tcp = (struct tcphdr *) remain_data;
+	assert(hdrs->transport_len >= sizeof(struct tcphdr));
+	tcp = (struct tcphdr *) hdrs->transport;
 	is_tcp_same = tcp_context->old_tcphdr.src_port == tcp->src_port &&
 	              tcp_context->old_tcphdr.dst_port == tcp->dst_port;
 	rohc_comp_debug(context, "  TCP %ssame Source and Destination ports",
@@ -1694,6 +1907,8 @@ static int c_tcp_encode(struct rohc_comp_ctxt *const context,
 	}
 
 	/* detect changes between new uncompressed packet and context */
+	rohc_cycles_begin(&context->compressor->stage_cycles,
+	                  ROHC_COMP_STAGE_CHANGES);
 	if(!tcp_detect_changes(context, uncomp_pkt, &ip_inner_context, &tcp))
 	{
 		rohc_comp_warn(context, "failed to detect changes in uncompressed packet");
@@ -1702,19 +1917,30 @@ static int c_tcp_encode(struct rohc_comp_ctxt *const context,
 
 	/* decide in which state to go */
 	tcp_decide_state(context);
+	rohc_cycles_end(&context->compressor->stage_cycles, ROHC_COMP_STAGE_CHANGES);
 
 	/* compute how many bits are needed to send header fields */
+	rohc_cycles_begin(&context->compressor->stage_cycles,
+	                  ROHC_COMP_STAGE_ENCODE_FIELDS);
 	if(!tcp_encode_uncomp_fields(context, uncomp_pkt, tcp))
 	{
 		rohc_comp_warn(context, "failed to compute how many bits are needed to "
 		               "transmit all changes in header fields");
 		goto error;
 	}
+	rohc_cycles_end(&context->compressor->stage_cycles,
+	                ROHC_COMP_STAGE_ENCODE_FIELDS);
 
 	/* decide which packet to send */
+	rohc_cycles_begin(&context->compressor->stage_cycles,
+	                  ROHC_COMP_STAGE_DECIDE_PKT);
 	*packet_type = tcp_decide_packet(context, ip_inner_context, tcp);
+	rohc_cycles_end(&context->compressor->stage_cycles,
+	                ROHC_COMP_STAGE_DECIDE_PKT);
 
 	/* code the chosen packet */
+	rohc_cycles_begin(&context->compressor->stage_cycles,
+	                  ROHC_COMP_STAGE_BUILD_HDR);
 	if((*packet_type) == ROHC_PACKET_UNKNOWN)
 	{
 		rohc_comp_warn(context, "failed to find the packet type to encode");
@@ -1724,7 +1950,7 @@ static int c_tcp_encode(struct rohc_comp_ctxt *const context,
 	        (*packet_type) != ROHC_PACKET_IR_DYN)
 	{
 		/* co_common, seq_X, or rnd_X */
-		counter = code_CO_packet(context, &uncomp_pkt->outer_ip, rohc_pkt,
+		counter = code_CO_packet(context, uncomp_pkt, rohc_pkt,
 		                         rohc_pkt_max_len, *packet_type, payload_offset);
 		if(counter < 0)
 		{
@@ -1737,7 +1963,7 @@ static int c_tcp_encode(struct rohc_comp_ctxt *const context,
 		assert((*packet_type) == ROHC_PACKET_IR ||
 		       (*packet_type) == ROHC_PACKET_IR_DYN);
 
-		counter = code_IR_packet(context, &uncomp_pkt->outer_ip, rohc_pkt,
+		counter = code_IR_packet(context, uncomp_pkt, rohc_pkt,
 		                         rohc_pkt_max_len, *packet_type, payload_offset);
 		if(counter < 0)
 		{
@@ -1745,11 +1971,15 @@ static int c_tcp_encode(struct rohc_comp_ctxt *const context,
 			goto error;
 		}
 	}
+	rohc_cycles_end(&context->compressor->stage_cycles,
+	                ROHC_COMP_STAGE_BUILD_HDR);
 	rohc_comp_dump_buf(context, "current ROHC packet", rohc_pkt, counter);
 
 	rohc_comp_debug(context, "payload_offset = %zu", *payload_offset);
 
 	rohc_comp_debug(context, "update context:");
+	rohc_cycles_begin(&context->compressor->stage_cycles,
+	                  ROHC_COMP_STAGE_UPDATE_CTXT);
 
 	/* update the context with the new numbers of IP extension headers */
 	{
@@ -1759,7 +1989,7 @@ static int c_tcp_encode(struct rohc_comp_ctxt *const context,
 			rohc_comp_debug(context, "  update context of IP header #%zu:",
 			                ip_hdr_pos + 1);
 			tcp_context->ip_contexts[ip_hdr_pos].opts_nr =
-				tcp_context->tmp.ip_exts_nr[ip_hdr_pos];
+				uncomp_pkt->hdrs->ip[ip_hdr_pos].exts_nr;
 			rohc_comp_debug(context, "    %zu extension headers",
 			                tcp_context->ip_contexts[ip_hdr_pos].opts_nr);
 		}
@@ -1792,6 +2022,8 @@ static int c_tcp_encode(struct rohc_comp_ctxt *const context,
 		                "times since the scaling factor or residue changed",
 		                tcp_context->ack_num_scaling_nr, ROHC_INIT_TS_STRIDE_MIN);
 	}
+	rohc_cycles_end(&context->compressor->stage_cycles,
+	                ROHC_COMP_STAGE_UPDATE_CTXT);
 
 	return counter;
 
@@ -1804,7 +2036,7 @@ error:
  * @brief Encode an IP/TCP packet as IR or IR-DYN packet
  *
  * @param context           The compression context
- * @param ip                The outer IP header
+ * @param uncomp_pkt        The uncompressed packet
  * @param rohc_pkt          OUT: The ROHC packet
  * @param rohc_pkt_max_len  The maximum length of the ROHC packet
  * @param packet_type       The type of ROHC packet that is created
@@ -1813,7 +2045,7 @@ error:
  *                          -1 otherwise
  */
 static int code_IR_packet(struct rohc_comp_ctxt *const context,
-                          const struct ip_packet *const ip,
+                          const struct net_pkt *const uncomp_pkt,
                           uint8_t *const rohc_pkt,
                           const size_t rohc_pkt_max_len,
                           const rohc_packet_t packet_type,
@@ -1823,6 +2055,7 @@ static int code_IR_packet(struct rohc_comp_ctxt *const context,
 	size_t rohc_remain_len = rohc_pkt_max_len;
 	size_t first_position;
 	size_t crc_position;
+	size_t static_chain_end = 0;
 	size_t rohc_hdr_len = 0;
 	int ret;
 
@@ -1830,9 +2063,8 @@ static int code_IR_packet(struct rohc_comp_ctxt *const context,
 	 *  - part 2 will be placed at 'first_position'
 	 *  - part 4 will start at 'counter'
 	 */
-	ret = code_cid_values(context->compressor->medium.cid_type,
-	                      context->cid, rohc_remain_data, rohc_remain_len,
-	                      &first_position);
+	ret = context->compressor->code_cid_values(context->cid, rohc_remain_data,
+	                                           rohc_remain_len, &first_position);
 	if(ret < 1)
 	{
 		rohc_comp_warn(context, "failed to encode %s CID %zu: maybe the %zu-byte "
@@ -1887,7 +2119,8 @@ static int code_IR_packet(struct rohc_comp_ctxt *const context,
 	/* add static chain for IR packet only */
 	if(packet_type == ROHC_PACKET_IR)
 	{
-		ret = tcp_code_static_part(context, ip, rohc_remain_data, rohc_remain_len);
+		ret = tcp_code_static_part(context, uncomp_pkt, rohc_remain_data,
+		                           rohc_remain_len);
 		if(ret < 0)
 		{
 			rohc_comp_warn(context, "failed to build the static chain of the "
@@ -1899,10 +2132,11 @@ static int code_IR_packet(struct rohc_comp_ctxt *const context,
 		rohc_hdr_len += ret;
 		rohc_comp_dump_buf(context, "current ROHC packet (with static part)",
 		                   rohc_pkt, rohc_hdr_len);
+		static_chain_end = rohc_hdr_len;
 	}
 
 	/* add dynamic chain */
-	ret = tcp_code_dyn_part(context, ip, rohc_remain_data,
+	ret = tcp_code_dyn_part(context, uncomp_pkt, rohc_remain_data,
 	                        rohc_remain_len, payload_offset);
 	if(ret < 0)
 	{
@@ -1918,10 +2152,21 @@ static int code_IR_packet(struct rohc_comp_ctxt *const context,
 	rohc_comp_dump_buf(context, "current ROHC packet (with dynamic part)",
 	                   rohc_pkt, rohc_hdr_len);
 
-	/* IR(-DYN) header was successfully built, compute the CRC */
-	rohc_pkt[crc_position] = crc_calculate(ROHC_CRC_TYPE_8, rohc_pkt,
-	                                       rohc_hdr_len, CRC_INIT_8,
-	                                       context->compressor->crc_table_8);
+	/* IR(-DYN) header was successfully built, compute the CRC (the CRC of the
+	 * IR header up to the end of the static chain is cached) */
+	rohc_cycles_crc_begin(&context->compressor->stage_cycles);
+	if(packet_type == ROHC_PACKET_IR)
+	{
+		rohc_pkt[crc_position] =
+			rohc_comp_ir_crc(context, rohc_pkt, static_chain_end, rohc_hdr_len);
+	}
+	else
+	{
+		rohc_pkt[crc_position] = crc_calculate(ROHC_CRC_TYPE_8, rohc_pkt,
+		                                       rohc_hdr_len, CRC_INIT_8,
+		                                       rohc_crc_table_8);
+	}
+	rohc_cycles_crc_end(&context->compressor->stage_cycles, ROHC_COMP_STAGE_CRC);
 	rohc_comp_debug(context, "CRC (header length = %zu, crc = 0x%x)",
 	                rohc_hdr_len, rohc_pkt[crc_position]);
 
@@ -1939,21 +2184,19 @@ error:
  * @brief Code the static part of an IR packet
  *
  * @param context           The compression context
- * @param ip                The outer IP header
+ * @param uncomp_pkt        The uncompressed packet
  * @param rohc_pkt          OUT: The ROHC packet
  * @param rohc_pkt_max_len  The maximum length of the ROHC packet
  * @return                  The length of the ROHC packet if successful,
  *                          -1 otherwise
  */
 static int tcp_code_static_part(struct rohc_comp_ctxt *const context,
-                                const struct ip_packet *const ip,
+                                const struct net_pkt *const uncomp_pkt,
                                 uint8_t *const rohc_pkt,
                                 const size_t rohc_pkt_max_len)
 {
 	struct sc_tcp_context *const tcp_context = context->specific;
-
-	const uint8_t *remain_data = ip->data;
-	size_t remain_len = ip->size;
+	const struct net_pkt_hdrs *const hdrs = uncomp_pkt->hdrs;
 
 	uint8_t *rohc_remain_data = rohc_pkt;
 	size_t rohc_remain_len = rohc_pkt_max_len;
@@ -1961,21 +2204,19 @@ static int tcp_code_static_part(struct rohc_comp_ctxt *const context,
 	size_t ip_hdr_pos;
 	int ret;
 
+	assert(hdrs->ip_nr == tcp_context->ip_contexts_nr);
+
 	/* add IP parts of static chain */
 	for(ip_hdr_pos = 0; ip_hdr_pos < tcp_context->ip_contexts_nr; ip_hdr_pos++)
 	{
-		const struct ip_hdr *const ip_hdr = (struct ip_hdr *) remain_data;
+		const struct net_pkt_ip *const ip = &(hdrs->ip[ip_hdr_pos]);
 		size_t ip_ext_pos;
 
-		/* retrieve IP version */
-		assert(remain_len >= sizeof(struct ip_hdr));
-		rohc_comp_debug(context, "found IPv%d", ip_hdr->version);
+		rohc_comp_debug(context, "found IPv%u", ip->version);
 
-		if(ip_hdr->version == IPV4)
+		if(ip->version == IPV4)
 		{
-			const struct ipv4_hdr *const ipv4 = (struct ipv4_hdr *) remain_data;
-
-			assert(remain_len >= sizeof(struct ipv4_hdr));
+			const struct ipv4_hdr *const ipv4 = (struct ipv4_hdr *) ip->data;
 
 			ret = tcp_code_static_ipv4_part(context, ipv4, rohc_remain_data,
 			                                rohc_remain_len);
@@ -1987,16 +2228,10 @@ static int tcp_code_static_part(struct rohc_comp_ctxt *const context,
 			}
 			rohc_remain_data += ret;
 			rohc_remain_len -= ret;
-
-			remain_data += sizeof(struct ipv4_hdr);
-			remain_len -= sizeof(struct ipv4_hdr);
 		}
-		else if(ip_hdr->version == IPV6)
+		else if(ip->version == IPV6)
 		{
-			const struct ipv6_hdr *const ipv6 = (struct ipv6_hdr *) remain_data;
-			uint8_t protocol;
-
-			assert(remain_len >= sizeof(struct ipv6_hdr));
+			const struct ipv6_hdr *const ipv6 = (struct ipv6_hdr *) ip->data;
 
 			ret = tcp_code_static_ipv6_part(context, ipv6, rohc_remain_data,
 			                                rohc_remain_len);
@@ -2009,20 +2244,16 @@ static int tcp_code_static_part(struct rohc_comp_ctxt *const context,
 			rohc_remain_data += ret;
 			rohc_remain_len -= ret;
 
-			protocol = ipv6->nh;
-			remain_data += sizeof(struct ipv6_hdr);
-			remain_len -= sizeof(struct ipv6_hdr);
-
-			for(ip_ext_pos = 0;
-			    ip_ext_pos < tcp_context->tmp.ip_exts_nr[ip_hdr_pos];
-			    ip_ext_pos++)
+			/* the extension headers were located once when the packet was parsed */
+			for(ip_ext_pos = 0; ip_ext_pos < ip->exts_nr; ip_ext_pos++)
 			{
-				const struct ipv6_opt *const ipv6_opt = (struct ipv6_opt *) remain_data;
-				const size_t opt_len = ipv6_opt_get_length(ipv6_opt);
+				const struct net_pkt_ext *const ext = &(ip->exts[ip_ext_pos]);
+				const struct ipv6_opt *const ipv6_opt =
+					(struct ipv6_opt *) (ip->data + ext->offset);
 
-				rohc_comp_debug(context, "IPv6 option #%zu: type %u / length %zu",
-				                ip_ext_pos + 1, protocol, opt_len);
-				ret = tcp_code_static_ipv6_opt_part(context, ipv6_opt, protocol,
+				rohc_comp_debug(context, "IPv6 option #%zu: type %u / length %u",
+				                ip_ext_pos + 1, ext->type, ext->len);
+				ret = tcp_code_static_ipv6_opt_part(context, ipv6_opt, ext->type,
 				                                    rohc_remain_data, rohc_remain_len);
 				if(ret < 0)
 				{
@@ -2032,15 +2263,11 @@ static int tcp_code_static_part(struct rohc_comp_ctxt *const context,
 				}
 				rohc_remain_data += ret;
 				rohc_remain_len -= ret;
-
-				protocol = ipv6_opt->next_header;
-				remain_data += opt_len;
-				remain_len -= opt_len;
 			}
 		}
 		else
 		{
-			rohc_comp_warn(context, "unexpected IP version %u", ip_hdr->version);
+			rohc_comp_warn(context, "unexpected IP version %u", ip->version);
 			assert(0);
 			goto error;
 		}
@@ -2048,9 +2275,9 @@ static int tcp_code_static_part(struct rohc_comp_ctxt *const context,
 
 	/* add TCP static part */
 	{
-		const struct tcphdr *const tcp = (struct tcphdr *) remain_data;
+		const struct tcphdr *const tcp = (struct tcphdr *) hdrs->transport;
 
-		assert(remain_len >= sizeof(struct tcphdr));
+		assert(hdrs->transport_len >= sizeof(struct tcphdr));
 
 		ret = tcp_code_static_tcp_part(context, tcp, rohc_remain_data, rohc_remain_len);
 		if(ret < 0)
@@ -2076,7 +2303,7 @@ error:
  * @brief Code the dynamic part of an IR or IR-DYN packet
  *
  * @param context           The compression context
- * @param ip                The outer IP header
+ * @param uncomp_pkt        The uncompressed packet
  * @param rohc_pkt          OUT: The ROHC packet
  * @param rohc_pkt_max_len  The maximum length of the ROHC packet
  * @param[out] parsed_len   The length of uncompressed data parsed
@@ -2084,17 +2311,15 @@ error:
  *                          -1 otherwise
  */
 static int tcp_code_dyn_part(struct rohc_comp_ctxt *const context,
-                             const struct ip_packet *const ip,
+                             const struct net_pkt *const uncomp_pkt,
                              uint8_t *const rohc_pkt,
                              const size_t rohc_pkt_max_len,
                              size_t *const parsed_len)
 {
 	struct sc_tcp_context *const tcp_context = context->specific;
+	const struct net_pkt_hdrs *const hdrs = uncomp_pkt->hdrs;
 	ip_context_t *inner_ip_context = NULL;
 
-	const uint8_t *remain_data = ip->data;
-	size_t remain_len = ip->size;
-
 	uint8_t *rohc_remain_data = rohc_pkt;
 	size_t rohc_remain_len = rohc_pkt_max_len;
 
@@ -2104,28 +2329,25 @@ static int tcp_code_dyn_part(struct rohc_comp_ctxt *const context,
 
 	/* there is at least one IP header otherwise it won't be the IP/TCP profile */
 	assert(tcp_context->ip_contexts_nr > 0);
+	assert(hdrs->ip_nr == tcp_context->ip_contexts_nr);
 
 	/* add dynamic chain for both IR and IR-DYN packet */
 	for(ip_hdr_pos = 0; ip_hdr_pos < tcp_context->ip_contexts_nr; ip_hdr_pos++)
 	{
-		const struct ip_hdr *const ip_hdr = (struct ip_hdr *) remain_data;
+		const struct net_pkt_ip *const ip = &(hdrs->ip[ip_hdr_pos]);
 		ip_context_t *const ip_context = &(tcp_context->ip_contexts[ip_hdr_pos]);
 		const bool is_inner = !!(ip_hdr_pos + 1 == tcp_context->ip_contexts_nr);
 		size_t ip_ext_pos;
 
 		/* the last IP header is the innermost one */
 		inner_ip_context = ip_context;
-		inner_ip_hdr = (struct ip_hdr *) remain_data;
+		inner_ip_hdr = (struct ip_hdr *) ip->data;
 
-		/* retrieve IP version */
-		assert(remain_len >= sizeof(struct ip_hdr));
-		rohc_comp_debug(context, "found IPv%d", ip_hdr->version);
+		rohc_comp_debug(context, "found IPv%u", ip->version);
 
-		if(ip_hdr->version == IPV4)
+		if(ip->version == IPV4)
 		{
-			const struct ipv4_hdr *const ipv4 = (struct ipv4_hdr *) remain_data;
-
-			assert(remain_len >= sizeof(struct ipv4_hdr));
+			const struct ipv4_hdr *const ipv4 = (struct ipv4_hdr *) ip->data;
 
 			ret = tcp_code_dynamic_ipv4_part(context, ip_context, ipv4, is_inner,
 			                                 rohc_remain_data, rohc_remain_len);
@@ -2137,16 +2359,10 @@ static int tcp_code_dyn_part(struct rohc_comp_ctxt *const context,
 			}
 			rohc_remain_data += ret;
 			rohc_remain_len -= ret;
-
-			remain_data += sizeof(struct ipv4_hdr);
-			remain_len -= sizeof(struct ipv4_hdr);
 		}
-		else if(ip_hdr->version == IPV6)
+		else if(ip->version == IPV6)
 		{
-			const struct ipv6_hdr *const ipv6 = (struct ipv6_hdr *) remain_data;
-			uint8_t protocol;
-
-			assert(remain_len >= sizeof(struct ipv6_hdr));
+			const struct ipv6_hdr *const ipv6 = (struct ipv6_hdr *) ip->data;
 
 			ret = tcp_code_dynamic_ipv6_part(context, ip_context, ipv6,
 			                                 rohc_remain_data, rohc_remain_len);
@@ -2159,19 +2375,14 @@ static int tcp_code_dyn_part(struct rohc_comp_ctxt *const context,
 			rohc_remain_data += ret;
 			rohc_remain_len -= ret;
 
-			protocol = ipv6->nh;
-			remain_data += sizeof(struct ipv6_hdr);
-			remain_len -= sizeof(struct ipv6_hdr);
-
-			for(ip_ext_pos = 0;
-			    ip_ext_pos < tcp_context->tmp.ip_exts_nr[ip_hdr_pos];
-			    ip_ext_pos++)
+			for(ip_ext_pos = 0; ip_ext_pos < ip->exts_nr; ip_ext_pos++)
 			{
-				const struct ipv6_opt *const ipv6_opt = (struct ipv6_opt *) remain_data;
-				const size_t opt_len = ipv6_opt_get_length(ipv6_opt);
+				const struct net_pkt_ext *const ext = &(ip->exts[ip_ext_pos]);
+				const struct ipv6_opt *const ipv6_opt =
+					(struct ipv6_opt *) (ip->data + ext->offset);
 
-				rohc_comp_debug(context, "IPv6 option %u", protocol);
-				ret = tcp_code_dynamic_ipv6_opt_part(context, ipv6_opt, protocol,
+				rohc_comp_debug(context, "IPv6 option %u", ext->type);
+				ret = tcp_code_dynamic_ipv6_opt_part(context, ipv6_opt, ext->type,
 				                                     rohc_remain_data, rohc_remain_len);
 				if(ret < 0)
 				{
@@ -2181,15 +2392,11 @@ static int tcp_code_dyn_part(struct rohc_comp_ctxt *const context,
 				}
 				rohc_remain_data += ret;
 				rohc_remain_len -= ret;
-
-				protocol = ipv6_opt->next_header;
-				remain_data += opt_len;
-				remain_len -= opt_len;
 			}
 		}
 		else
 		{
-			rohc_comp_warn(context, "unexpected IP version %u", ip_hdr->version);
+			rohc_comp_warn(context, "unexpected IP version %u", ip->version);
 			assert(0);
 			goto error;
 		}
@@ -2197,9 +2404,9 @@ static int tcp_code_dyn_part(struct rohc_comp_ctxt *const context,
 
 	/* handle TCP header */
 	{
-		const struct tcphdr *const tcp = (struct tcphdr *) remain_data;
+		const struct tcphdr *const tcp = (struct tcphdr *) hdrs->transport;
 
-		assert(remain_len >= sizeof(struct tcphdr));
+		assert(hdrs->transport_len >= sizeof(struct tcphdr));
 
 		/* add TCP dynamic part */
 		ret = tcp_code_dynamic_tcp_part(context, tcp, rohc_remain_data, rohc_remain_len);
@@ -2215,11 +2422,8 @@ static int tcp_code_dyn_part(struct rohc_comp_ctxt *const context,
 		rohc_remain_len -= ret;
 
 		/* skip TCP header and options */
-		remain_data += (tcp->data_offset << 2);
-#ifndef __clang_analyzer__ /* silent warning about dead in/decrement */
-		remain_len -= (tcp->data_offset << 2);
-#endif
-		*parsed_len = remain_data - ip->data;
+		*parsed_len = hdrs->transport + (tcp->data_offset << 2) -
+		              uncomp_pkt->outer_ip.data;
 	}
 
 	/* update context with new values (done at the very end to avoid wrongly
@@ -2703,7 +2907,7 @@ error:
  * @brief Code the irregular chain of one CO packet
  *
  * @param context           The compression context
- * @param ip                The outer IP header
+ * @param uncomp_pkt        The uncompressed packet
  * @param ip_inner_ecn      The ECN flags of the innermost IP header
  * @param tcp               The uncompressed TCP header
  * @param rohc_pkt          OUT: The ROHC packet
@@ -2712,16 +2916,14 @@ error:
  *                          -1 otherwise
  */
 static int tcp_code_irreg_chain(struct rohc_comp_ctxt *const context,
-                                const struct ip_packet *const ip,
+                                const struct net_pkt *const uncomp_pkt,
                                 const uint8_t ip_inner_ecn,
                                 const struct tcphdr *const tcp,
                                 uint8_t *const rohc_pkt,
                                 const size_t rohc_pkt_max_len)
 {
 	struct sc_tcp_context *const tcp_context = context->specific;
-
-	const uint8_t *remain_data = ip->data;
-	size_t remain_len = ip->size;
+	const struct net_pkt_hdrs *const hdrs = uncomp_pkt->hdrs;
 
 	uint8_t *rohc_remain_data = rohc_pkt;
 	size_t rohc_remain_len = rohc_pkt_max_len;
@@ -2729,22 +2931,20 @@ static int tcp_code_irreg_chain(struct rohc_comp_ctxt *const context,
 	size_t ip_hdr_pos;
 	int ret;
 
+	assert(hdrs->ip_nr == tcp_context->ip_contexts_nr);
+
 	for(ip_hdr_pos = 0; ip_hdr_pos < tcp_context->ip_contexts_nr; ip_hdr_pos++)
 	{
-		const struct ip_hdr *const ip_hdr = (struct ip_hdr *) remain_data;
+		const struct net_pkt_ip *const ip = &(hdrs->ip[ip_hdr_pos]);
 		ip_context_t *const ip_context = &(tcp_context->ip_contexts[ip_hdr_pos]);
 		const bool is_innermost = !!(ip_hdr_pos == (tcp_context->ip_contexts_nr - 1));
 
-		/* retrieve IP version */
-		assert(remain_len >= sizeof(struct ip_hdr));
-		rohc_comp_debug(context, "found IPv%d", ip_hdr->version);
+		rohc_comp_debug(context, "found IPv%u", ip->version);
 
 		/* irregular part for IP header */
-		if(ip_hdr->version == IPV4)
+		if(ip->version == IPV4)
 		{
-			const struct ipv4_hdr *const ipv4 = (struct ipv4_hdr *) remain_data;
-
-			assert(remain_len >= sizeof(struct ipv4_hdr));
+			const struct ipv4_hdr *const ipv4 = (struct ipv4_hdr *) ip->data;
 
 			ret = tcp_code_irregular_ipv4_part(context, ip_context, ipv4, is_innermost,
 			                                   tcp_context->ecn_used, ip_inner_ecn,
@@ -2758,18 +2958,12 @@ static int tcp_code_irreg_chain(struct rohc_comp_ctxt *const context,
 			}
 			rohc_remain_data += ret;
 			rohc_remain_len -= ret;
-
-			remain_data += sizeof(struct ipv4_hdr);
-			remain_len -= sizeof(struct ipv4_hdr);
 		}
-		else if(ip_hdr->version == IPV6)
+		else if(ip->version == IPV6)
 		{
-			const struct ipv6_hdr *const ipv6 = (struct ipv6_hdr *) remain_data;
-			uint8_t protocol;
+			const struct ipv6_hdr *const ipv6 = (struct ipv6_hdr *) ip->data;
 			size_t ip_ext_pos;
 
-			assert(remain_len >= sizeof(struct ipv6_hdr));
-
 			ret = tcp_code_irregular_ipv6_part(context, ip_context, ipv6, is_innermost,
 			                                   tcp_context->ecn_used, ip_inner_ecn,
 			                                   tcp_context->tmp.ttl_irreg_chain_flag,
@@ -2783,19 +2977,18 @@ static int tcp_code_irreg_chain(struct rohc_comp_ctxt *const context,
 			rohc_remain_data += ret;
 			rohc_remain_len -= ret;
 
-			protocol = ipv6->nh;
-			remain_data += sizeof(struct ipv6_hdr);
-			remain_len -= sizeof(struct ipv6_hdr);
-
 			/* irregular part for IPv6 extension headers */
-			for(ip_ext_pos = 0; ip_ext_pos < ip_context->opts_nr; ip_ext_pos++)
+			assert(ip->exts_nr == ip_context->opts_nr);
+			for(ip_ext_pos = 0; ip_ext_pos < ip->exts_nr; ip_ext_pos++)
 			{
-				const struct ipv6_opt *const ipv6_opt = (struct ipv6_opt *) remain_data;
+				const struct net_pkt_ext *const ext = &(ip->exts[ip_ext_pos]);
+				const struct ipv6_opt *const ipv6_opt =
+					(struct ipv6_opt *) (ip->data + ext->offset);
 				ip_option_context_t *const opt_ctxt =
 					&(ip_context->opts[ip_ext_pos]);
 
 				ret = tcp_code_irregular_ipv6_opt_part(context, opt_ctxt, ipv6_opt,
-				                                       protocol, rohc_remain_data,
+				                                       ext->type, rohc_remain_data,
 				                                       rohc_remain_len);
 				if(ret < 0)
 				{
@@ -2805,15 +2998,11 @@ static int tcp_code_irreg_chain(struct rohc_comp_ctxt *const context,
 				}
 				rohc_remain_data += ret;
 				rohc_remain_len -= ret;
-
-				protocol = ipv6_opt->next_header;
-				remain_data += opt_ctxt->generic.option_length;
-				remain_len -= opt_ctxt->generic.option_length;
 			}
 		}
 		else
 		{
-			rohc_comp_warn(context, "unexpected IP version %u", ip_hdr->version);
+			rohc_comp_warn(context, "unexpected IP version %u", ip->version);
 			assert(0);
 			goto error;
 		}
@@ -3394,7 +3583,7 @@ error:
 \endverbatim
  *
  * @param context           The compression context
- * @param ip                The outer IP header
+ * @param uncomp_pkt        The uncompressed packet
  * @param rohc_pkt          OUT: The ROHC packet
  * @param rohc_pkt_max_len  The maximum length of the ROHC packet
  * @param packet_type       The type of ROHC packet to create
@@ -3403,16 +3592,15 @@ error:
  *                          -1 otherwise
  */
 static int code_CO_packet(struct rohc_comp_ctxt *const context,
-                          const struct ip_packet *ip,
+                          const struct net_pkt *const uncomp_pkt,
                           uint8_t *const rohc_pkt,
                           const size_t rohc_pkt_max_len,
                           const rohc_packet_t packet_type,
                           size_t *const payload_offset)
 {
 	struct sc_tcp_context *const tcp_context = context->specific;
-
-	const uint8_t *remain_data = ip->data;
-	size_t remain_len = ip->size;
+	const struct net_pkt_hdrs *const hdrs = uncomp_pkt->hdrs;
+	const struct ip_packet *const ip = &(uncomp_pkt->outer_ip);
 
 	uint8_t *rohc_remain_data = rohc_pkt;
 	size_t rohc_remain_len = rohc_pkt_max_len;
@@ -3428,93 +3616,54 @@ static int code_CO_packet(struct rohc_comp_ctxt *const context,
 	size_t payload_size = 0;
 	uint8_t ip_inner_ecn = 0;
 	uint8_t crc_computed;
-	size_t ip_hdr_pos;
 	int ret;
 
 	rohc_comp_debug(context, "code CO packet (CID = %zu)", context->cid);
 
-	/* parse the IP headers and their extension headers */
-	rohc_comp_debug(context, "parse the %zu-byte IP packet", remain_len);
+	/* the IP headers and their extension headers were located once when the
+	 * packet was parsed, only the innermost one matters here */
+	rohc_comp_debug(context, "%zu-byte IP packet", ip->size);
 	assert(tcp_context->ip_contexts_nr > 0);
-	for(ip_hdr_pos = 0; ip_hdr_pos < tcp_context->ip_contexts_nr; ip_hdr_pos++)
+	assert(hdrs->ip_nr == tcp_context->ip_contexts_nr);
 	{
-		const struct ip_hdr *const ip_hdr = (struct ip_hdr *) remain_data;
-		ip_context_t *const ip_context = &(tcp_context->ip_contexts[ip_hdr_pos]);
-		uint8_t protocol;
-
-		/* retrieve IP version */
-		assert(remain_len >= sizeof(struct ip_hdr));
-		rohc_comp_debug(context, "found IPv%d", ip_hdr->version);
+		const struct net_pkt_ip *const inner_ip = &(hdrs->ip[hdrs->ip_nr - 1]);
 
-		inner_ip_hdr = (struct ip_hdr *) remain_data;
-		inner_ip_hdr_len = remain_len;
-		inner_ip_ctxt = ip_context;
+		inner_ip_hdr = (struct ip_hdr *) inner_ip->data;
+		inner_ip_hdr_len = inner_ip->len;
+		inner_ip_ctxt = &(tcp_context->ip_contexts[hdrs->ip_nr - 1]);
 
-		if(ip_hdr->version == IPV4)
+		if(inner_ip->version == IPV4)
 		{
-			const struct ipv4_hdr *const ipv4 = (struct ipv4_hdr *) remain_data;
-			size_t ipv4_hdr_len;
-
-			assert(remain_len >= sizeof(struct ipv4_hdr));
+			const struct ipv4_hdr *const ipv4 = (struct ipv4_hdr *) inner_ip->data;
 
-			protocol = ipv4->protocol;
 			ip_inner_ecn = ipv4->ecn;
-			ipv4_hdr_len = ipv4->ihl * sizeof(uint32_t);
-			payload_size = rohc_ntoh16(ipv4->tot_len) - ipv4_hdr_len;
-
-			/* skip IPv4 header */
-			rohc_comp_debug(context, "skip %zu-byte IPv4 header with "
-			                "Protocol 0x%02x", ipv4_hdr_len, protocol);
-			remain_data += ipv4_hdr_len;
-			remain_len -= ipv4_hdr_len;
+			payload_size = rohc_ntoh16(ipv4->tot_len) - inner_ip->hdr_len;
 		}
-		else if(ip_hdr->version == IPV6)
+		else if(inner_ip->version == IPV6)
 		{
-			const struct ipv6_hdr *const ipv6 = (struct ipv6_hdr *) remain_data;
-			size_t ip_ext_pos;
+			const struct ipv6_hdr *const ipv6 = (struct ipv6_hdr *) inner_ip->data;
 
-			assert(remain_len >= sizeof(struct ipv6_hdr));
-
-			protocol = ipv6->nh;
 			ip_inner_ecn = ipv6->ecn;
 			payload_size = rohc_ntoh16(ipv6->plen);
-
-			/* skip IPv6 header */
-			rohc_comp_debug(context, "skip %zu-byte IPv6 header with Next Header "
-			                "0x%02x", sizeof(struct ipv6_hdr), protocol);
-			remain_data += sizeof(struct ipv6_hdr);
-			remain_len -= sizeof(struct ipv6_hdr);
-
-			/* skip IPv6 extension headers */
-			for(ip_ext_pos = 0; ip_ext_pos < ip_context->opts_nr; ip_ext_pos++)
-			{
-				const struct ipv6_opt *const ipv6_opt = (struct ipv6_opt *) remain_data;
-				const ip_option_context_t *const opt_ctxt =
-					&(ip_context->opts[ip_ext_pos]);
-
-				protocol = ipv6_opt->next_header;
-				rohc_comp_debug(context, "skip %zu-byte IPv6 extension header "
-				                "with Next Header 0x%02x",
-				                opt_ctxt->generic.option_length, protocol);
-				remain_data += opt_ctxt->generic.option_length;
-				remain_len -= opt_ctxt->generic.option_length;
-			}
 		}
 		else
 		{
-			rohc_comp_warn(context, "unexpected IP version %u", ip_hdr->version);
+			rohc_comp_warn(context, "unexpected IP version %u", inner_ip->version);
 			assert(0);
 			goto error;
 		}
+		rohc_comp_debug(context, "skip %u bytes of IPv%u and extension headers "
+		                "up to the TCP header",
+		                (unsigned) (hdrs->transport - ip->data), inner_ip->version);
 	}
 
 	/* parse the TCP header */
-	assert(remain_len >= sizeof(struct tcphdr));
-	tcp = (struct tcphdr *) remain_data;
+	assert(hdrs->transport_len >= sizeof(struct tcphdr));
+	tcp = (struct tcphdr *) hdrs->transport;
 	{
 		const size_t tcp_data_offset = tcp->data_offset << 2;
 
-		assert(remain_len >= tcp_data_offset);
+		assert(hdrs->transport_len >= tcp_data_offset);
 		assert(payload_size >= tcp_data_offset);
 		payload_size -= tcp_data_offset;
 
@@ -3526,28 +3675,30 @@ static int code_CO_packet(struct rohc_comp_ctxt *const context,
 
 	/* we have just identified the IP and TCP headers (options included), so
 	 * let's compute the CRC on uncompressed headers */
+	rohc_cycles_crc_begin(&context->compressor->stage_cycles);
 	if(packet_type == ROHC_PACKET_TCP_SEQ_8 ||
 	   packet_type == ROHC_PACKET_TCP_RND_8 ||
 	   packet_type == ROHC_PACKET_TCP_CO_COMMON)
 	{
 		crc_computed = crc_calculate(ROHC_CRC_TYPE_7, ip->data, *payload_offset,
-		                             CRC_INIT_7, context->compressor->crc_table_7);
+		                             CRC_INIT_7, rohc_crc_table_7);
 		rohc_comp_debug(context, "CRC-7 on %zu-byte uncompressed header = 0x%x",
 		                *payload_offset, crc_computed);
 	}
 	else
 	{
 		crc_computed = crc_calculate(ROHC_CRC_TYPE_3, ip->data, *payload_offset,
-		                             CRC_INIT_3, context->compressor->crc_table_3);
+		                             CRC_INIT_3, rohc_crc_table_3);
 		rohc_comp_debug(context, "CRC-3 on %zu-byte uncompressed header = 0x%x",
 		                *payload_offset, crc_computed);
 	}
+	rohc_cycles_crc_end(&context->compressor->stage_cycles, ROHC_COMP_STAGE_CRC);
 
 	/* write Add-CID or large CID bytes: 'pos_1st_byte' indicates the location
 	 * where first header byte shall be written, 'pos_2nd_byte' indicates the
 	 * location where the next header bytes shall be written */
-	ret = code_cid_values(context->compressor->medium.cid_type, context->cid,
-	                      rohc_remain_data, rohc_remain_len, &pos_1st_byte);
+	ret = context->compressor->code_cid_values(context->cid, rohc_remain_data,
+	                                           rohc_remain_len, &pos_1st_byte);
 	if(ret < 1)
 	{
 		rohc_comp_warn(context, "failed to encode %s CID %zu: maybe the "
@@ -3586,7 +3737,7 @@ static int code_CO_packet(struct rohc_comp_ctxt *const context,
 	rohc_remain_len -= ret;
 
 	/* add irregular chain */
-	ret = tcp_code_irreg_chain(context, ip, ip_inner_ecn, tcp,
+	ret = tcp_code_irreg_chain(context, uncomp_pkt, ip_inner_ecn, tcp,
 	                           rohc_remain_data, rohc_remain_len);
 	if(ret < 0)
 	{
@@ -3793,26 +3944,24 @@ static int c_tcp_build_rnd_1(const struct rohc_comp_ctxt *const context,
                              uint8_t *const rohc_data,
                              const size_t rohc_max_len)
 {
-	rnd_1_t *const rnd1 = (rnd_1_t *) rohc_data;
+	struct rnd_1 rnd1;
 	uint32_t seq_num;
 
-	if(rohc_max_len < sizeof(rnd_1_t))
+	if(rohc_max_len < rnd_1_len)
 	{
 		rohc_comp_warn(context, "ROHC buffer too small for the rnd_1 header: "
-		               "%zu bytes required, but only %zu bytes available",
-		               sizeof(rnd_1_t), rohc_max_len);
+		               "%d bytes required, but only %zu bytes available",
+		               rnd_1_len, rohc_max_len);
 		goto error;
 	}
 
-	rnd1->discriminator = 0x2e; /* '101110' */
 	seq_num = rohc_ntoh32(tcp->seq_num) & 0x3ffff;
-	rnd1->seq_num1 = (seq_num >> 16) & 0x3;
-	rnd1->seq_num2 = rohc_hton16(seq_num & 0xffff);
-	rnd1->msn = tcp_context->msn & 0xf;
-	rnd1->psh_flag = tcp->psh_flag;
-	rnd1->header_crc = crc;
+	rnd1.seq_num = seq_num;
+	rnd1.msn = tcp_context->msn;
+	rnd1.psh_flag = tcp->psh_flag;
+	rnd1.header_crc = crc;
 
-	return sizeof(rnd_1_t);
+	return rnd_1_write(&rnd1, rohc_data);
 
 error:
 	return -1;
@@ -3841,23 +3990,22 @@ static int c_tcp_build_rnd_2(const struct rohc_comp_ctxt *const context,
                              uint8_t *const rohc_data,
                              const size_t rohc_max_len)
 {
-	rnd_2_t *const rnd2 = (rnd_2_t *) rohc_data;
+	struct rnd_2 rnd2;
 
-	if(rohc_max_len < sizeof(rnd_2_t))
+	if(rohc_max_len < rnd_2_len)
 	{
 		rohc_comp_warn(context, "ROHC buffer too small for the rnd_2 header: "
-		               "%zu bytes required, but only %zu bytes available",
-		               sizeof(rnd_2_t), rohc_max_len);
+		               "%d bytes required, but only %zu bytes available",
+		               rnd_2_len, rohc_max_len);
 		goto error;
 	}
 
-	rnd2->discriminator = 0x0c; /* '1100' */
-	rnd2->seq_num_scaled = tcp_context->seq_num_scaled & 0xf;
-	rnd2->msn = tcp_context->msn & 0xf;
-	rnd2->psh_flag = tcp->psh_flag;
-	rnd2->header_crc = crc;
+	rnd2.seq_num_scaled = tcp_context->seq_num_scaled;
+	rnd2.msn = tcp_context->msn;
+	rnd2.psh_flag = tcp->psh_flag;
+	rnd2.header_crc = crc;
 
-	return sizeof(rnd_2_t);
+	return rnd_2_write(&rnd2, rohc_data);
 
 error:
 	return -1;
@@ -3886,28 +4034,25 @@ static int c_tcp_build_rnd_3(const struct rohc_comp_ctxt *const context,
                              uint8_t *const rohc_data,
                              const size_t rohc_max_len)
 {
-	rnd_3_t *const rnd3 = (rnd_3_t *) rohc_data;
+	struct rnd_3 rnd3;
 	uint16_t ack_num;
 
-	if(rohc_max_len < sizeof(rnd_3_t))
+	if(rohc_max_len < rnd_3_len)
 	{
 		rohc_comp_warn(context, "ROHC buffer too small for the rnd_3 header: "
-		               "%zu bytes required, but only %zu bytes available",
-		               sizeof(rnd_3_t), rohc_max_len);
+		               "%d bytes required, but only %zu bytes available",
+		               rnd_3_len, rohc_max_len);
 		goto error;
 	}
 
-	rnd3->discriminator = 0x0; /* '0' */
 	ack_num = rohc_ntoh32(tcp->ack_num) & 0x7fff;
-	rnd3->ack_num1 = (ack_num >> 8) & 0x7f;
-	rnd3->ack_num2 = ack_num & 0xff;
-	rohc_comp_debug(context, "ack_number = 0x%04x (0x%02x 0x%02x)",
-	                ack_num, rnd3->ack_num1, rnd3->ack_num2);
-	rnd3->msn = tcp_context->msn & 0xf;
-	rnd3->psh_flag = tcp->psh_flag;
-	rnd3->header_crc = crc;
+	rohc_comp_debug(context, "ack_number = 0x%04x", ack_num);
+	rnd3.ack_num = ack_num;
+	rnd3.msn = tcp_context->msn;
+	rnd3.psh_flag = tcp->psh_flag;
+	rnd3.header_crc = crc;
 
-	return sizeof(rnd_3_t);
+	return rnd_3_write(&rnd3, rohc_data);
 
 error:
 	return -1;
@@ -3936,25 +4081,24 @@ static int c_tcp_build_rnd_4(const struct rohc_comp_ctxt *const context,
                              uint8_t *const rohc_data,
                              const size_t rohc_max_len)
 {
-	rnd_4_t *const rnd4 = (rnd_4_t *) rohc_data;
+	struct rnd_4 rnd4;
 
 	assert(tcp_context->ack_stride != 0);
 
-	if(rohc_max_len < sizeof(rnd_4_t))
+	if(rohc_max_len < rnd_4_len)
 	{
 		rohc_comp_warn(context, "ROHC buffer too small for the rnd_4 header: "
-		               "%zu bytes required, but only %zu bytes available",
-		               sizeof(rnd_4_t), rohc_max_len);
+		               "%d bytes required, but only %zu bytes available",
+		               rnd_4_len, rohc_max_len);
 		goto error;
 	}
 
-	rnd4->discriminator = 0x0d; /* '1101' */
-	rnd4->ack_num_scaled = tcp_context->ack_num_scaled & 0xf;
-	rnd4->msn = tcp_context->msn & 0xf;
-	rnd4->psh_flag = tcp->psh_flag;
-	rnd4->header_crc = crc;
+	rnd4.ack_num_scaled = tcp_context->ack_num_scaled;
+	rnd4.msn = tcp_context->msn;
+	rnd4.psh_flag = tcp->psh_flag;
+	rnd4.header_crc = crc;
 
-	return sizeof(rnd_4_t);
+	return rnd_4_write(&rnd4, rohc_data);
 
 error:
 	return -1;
@@ -3983,39 +4127,29 @@ static int c_tcp_build_rnd_5(const struct rohc_comp_ctxt *const context,
                              uint8_t *const rohc_data,
                              const size_t rohc_max_len)
 {
-	rnd_5_t *const rnd5 = (rnd_5_t *) rohc_data;
+	struct rnd_5 rnd5;
 	uint16_t seq_num;
 	uint16_t ack_num;
 
-	if(rohc_max_len < sizeof(rnd_5_t))
+	if(rohc_max_len < rnd_5_len)
 	{
 		rohc_comp_warn(context, "ROHC buffer too small for the rnd_5 header: "
-		               "%zu bytes required, but only %zu bytes available",
-		               sizeof(rnd_5_t), rohc_max_len);
+		               "%d bytes required, but only %zu bytes available",
+		               rnd_5_len, rohc_max_len);
 		goto error;
 	}
 
-	rnd5->discriminator = 0x04; /* '100' */
-	rnd5->psh_flag = tcp->psh_flag;
-	rnd5->msn = tcp_context->msn & 0xf;
-	rnd5->header_crc = crc;
-
-	/* sequence number */
 	seq_num = rohc_ntoh32(tcp->seq_num) & 0x3fff;
-	rnd5->seq_num1 = (seq_num >> 9) & 0x1f;
-	rnd5->seq_num2 = (seq_num >> 1) & 0xff;
-	rnd5->seq_num3 = seq_num & 0x01;
-	rohc_comp_debug(context, "seq_number = 0x%04x (0x%02x 0x%02x 0x%02x)",
-	                seq_num, rnd5->seq_num1, rnd5->seq_num2, rnd5->seq_num3);
-
-	/* ACK number */
+	rohc_comp_debug(context, "seq_number = 0x%04x", seq_num);
 	ack_num = rohc_ntoh32(tcp->ack_num) & 0x7fff;
-	rnd5->ack_num1 = (ack_num >> 8) & 0x7f;
-	rnd5->ack_num2 = ack_num & 0xff;
-	rohc_comp_debug(context, "ack_number = 0x%04x (0x%02x 0x%02x)",
-	                ack_num, rnd5->ack_num1, rnd5->ack_num2);
+	rohc_comp_debug(context, "ack_number = 0x%04x", ack_num);
+	rnd5.psh_flag = tcp->psh_flag;
+	rnd5.msn = tcp_context->msn;
+	rnd5.header_crc = crc;
+	rnd5.seq_num = seq_num;
+	rnd5.ack_num = ack_num;
 
-	return sizeof(rnd_5_t);
+	return rnd_5_write(&rnd5, rohc_data);
 
 error:
 	return -1;
@@ -4044,24 +4178,23 @@ static int c_tcp_build_rnd_6(const struct rohc_comp_ctxt *const context,
                              uint8_t *const rohc_data,
                              const size_t rohc_max_len)
 {
-	rnd_6_t *const rnd6 = (rnd_6_t *) rohc_data;
+	struct rnd_6 rnd6;
 
-	if(rohc_max_len < sizeof(rnd_6_t))
+	if(rohc_max_len < rnd_6_len)
 	{
 		rohc_comp_warn(context, "ROHC buffer too small for the rnd_6 header: "
-		               "%zu bytes required, but only %zu bytes available",
-		               sizeof(rnd_6_t), rohc_max_len);
+		               "%d bytes required, but only %zu bytes available",
+		               rnd_6_len, rohc_max_len);
 		goto error;
 	}
 
-	rnd6->discriminator = 0x0a; /* '1010' */
-	rnd6->header_crc = crc;
-	rnd6->psh_flag = tcp->psh_flag;
-	rnd6->ack_num = rohc_hton16(rohc_ntoh32(tcp->ack_num) & 0xffff);
-	rnd6->msn = tcp_context->msn & 0xf;
-	rnd6->seq_num_scaled = tcp_context->seq_num_scaled & 0xf;
+	rnd6.header_crc = crc;
+	rnd6.psh_flag = tcp->psh_flag;
+	rnd6.ack_num = rohc_ntoh32(tcp->ack_num);
+	rnd6.msn = tcp_context->msn;
+	rnd6.seq_num_scaled = tcp_context->seq_num_scaled;
 
-	return sizeof(rnd_6_t);
+	return rnd_6_write(&rnd6, rohc_data);
 
 error:
 	return -1;
@@ -4090,27 +4223,25 @@ static int c_tcp_build_rnd_7(const struct rohc_comp_ctxt *const context,
                              uint8_t *const rohc_data,
                              const size_t rohc_max_len)
 {
-	rnd_7_t *const rnd7 = (rnd_7_t *) rohc_data;
+	struct rnd_7 rnd7;
 	uint32_t ack_num;
 
-	if(rohc_max_len < sizeof(rnd_7_t))
+	if(rohc_max_len < rnd_7_len)
 	{
 		rohc_comp_warn(context, "ROHC buffer too small for the rnd_7 header: "
-		               "%zu bytes required, but only %zu bytes available",
-		               sizeof(rnd_7_t), rohc_max_len);
+		               "%d bytes required, but only %zu bytes available",
+		               rnd_7_len, rohc_max_len);
 		goto error;
 	}
 
-	rnd7->discriminator = 0x2f; /* '101111' */
 	ack_num = rohc_ntoh32(tcp->ack_num) & 0x3ffff;
-	rnd7->ack_num1 = (ack_num >> 16) & 0x03;
-	rnd7->ack_num2 = rohc_hton16(ack_num & 0xffff);
-	rnd7->window = tcp->window;
-	rnd7->msn = tcp_context->msn & 0xf;
-	rnd7->psh_flag = tcp->psh_flag;
-	rnd7->header_crc = crc;
+	rnd7.ack_num = ack_num;
+	rnd7.window = rohc_ntoh16(tcp->window);
+	rnd7.msn = tcp_context->msn;
+	rnd7.psh_flag = tcp->psh_flag;
+	rnd7.header_crc = crc;
 
-	return sizeof(rnd_7_t);
+	return rnd_7_write(&rnd7, rohc_data);
 
 error:
 	return -1;
@@ -4145,33 +4276,24 @@ static int c_tcp_build_rnd_8(const struct rohc_comp_ctxt *const context,
                              uint8_t *const rohc_data,
                              const size_t rohc_max_len)
 {
-	rnd_8_t *const rnd8 = (rnd_8_t *) rohc_data;
-	uint32_t seq_num;
+	struct rnd_8 rnd8;
 	size_t comp_opts_len;
 	uint8_t ttl_hl;
-	uint8_t msn;
 	int ret;
 
-	if(rohc_max_len < sizeof(rnd_8_t))
+	if(rohc_max_len < rnd_8_len)
 	{
 		rohc_comp_warn(context, "ROHC buffer too small for the rnd_8 header: "
-		               "%zu bytes required, but only %zu bytes available",
-		               sizeof(rnd_8_t), rohc_max_len);
+		               "%d bytes required, but only %zu bytes available",
+		               rnd_8_len, rohc_max_len);
 		goto error;
 	}
 
-	rnd8->discriminator = 0x16; /* '10110' */
-	rnd8->rsf_flags = rsf_index_enc(tcp->rsf_flags);
-	rnd8->list_present = 0; /* options are set later */
-	rnd8->header_crc = crc;
-	rohc_comp_debug(context, "CRC 0x%x", rnd8->header_crc);
-
-	/* MSN */
-	msn = tcp_context->msn & 0xf;
-	rnd8->msn1 = (msn >> 3) & 0x01;
-	rnd8->msn2 = msn & 0x07;
-
-	rnd8->psh_flag = tcp->psh_flag;
+	rnd8.rsf_flags = rsf_index_enc(tcp->rsf_flags);
+	rnd8.header_crc = crc;
+	rohc_comp_debug(context, "CRC 0x%x", rnd8.header_crc);
+	rnd8.msn = tcp_context->msn & 0xf;
+	rnd8.psh_flag = tcp->psh_flag;
 
 	/* TTL/HL */
 	assert(inner_ip_hdr_len >= 1);
@@ -4190,16 +4312,16 @@ static int c_tcp_build_rnd_8(const struct rohc_comp_ctxt *const context,
 		assert(inner_ip_ctxt->ctxt.vx.version == IPV6);
 		ttl_hl = ipv6->hl;
 	}
-	rnd8->ttl_hopl = ttl_hl & 0x7;
-	rnd8->ecn_used = GET_REAL(tcp_context->ecn_used);
+	rnd8.ttl_hopl = ttl_hl & 0x7;
+	rnd8.ecn_used = GET_REAL(tcp_context->ecn_used);
 
 	/* sequence number */
-	seq_num = rohc_ntoh32(tcp->seq_num) & 0xffff;
-	rnd8->seq_num = rohc_hton16(seq_num);
-	rohc_comp_debug(context, "16 bits of sequence number = 0x%04x", seq_num);
+	rnd8.seq_num = rohc_ntoh32(tcp->seq_num) & 0xffff;
+	rohc_comp_debug(context, "16 bits of sequence number = 0x%04x",
+	                rnd8.seq_num);
 
 	/* ACK number */
-	rnd8->ack_num = rohc_hton16(rohc_ntoh32(tcp->ack_num) & 0xffff);
+	rnd8.ack_num = rohc_ntoh32(tcp->ack_num) & 0xffff;
 
 	/* include the list of TCP options if the structure of the list changed
 	 * or if some static options changed (irregular chain cannot transmit
@@ -4209,11 +4331,11 @@ static int c_tcp_build_rnd_8(const struct rohc_comp_ctxt *const context,
 	{
 		/* the structure of the list of TCP options changed or at least one of
 		 * the static option changed, compress them */
-		rnd8->list_present = 1;
+		rnd8.list_present = 1;
 		ret = c_tcp_code_tcp_opts_list_item(context, tcp, tcp_context->msn,
 		                                    false, &tcp_context->tcp_opts,
-		                                    rnd8->options,
-		                                    rohc_max_len - sizeof(rnd_8_t));
+		                                    rohc_data + rnd_8_len,
+		                                    rohc_max_len - rnd_8_len);
 		if(ret < 0)
 		{
 			rohc_comp_warn(context, "failed to compress TCP options");
@@ -4225,11 +4347,12 @@ static int c_tcp_build_rnd_8(const struct rohc_comp_ctxt *const context,
 	{
 		/* the structure of the list of TCP options didn't change */
 		rohc_comp_debug(context, "compressed list of TCP options: list not present");
-		rnd8->list_present = 0;
+		rnd8.list_present = 0;
 		comp_opts_len = 0;
 	}
 
-	return (sizeof(rnd_8_t) + comp_opts_len);
+	/* the fixed part is written once the presence of the list is known */
+	return (rnd_8_write(&rnd8, rohc_data) + comp_opts_len);
 
 error:
 	return -1;
@@ -4264,31 +4387,31 @@ static int c_tcp_build_seq_1(const struct rohc_comp_ctxt *const context,
                              uint8_t *const rohc_data,
                              const size_t rohc_max_len)
 {
-	seq_1_t *const seq1 = (seq_1_t *) rohc_data;
+	struct seq_1 seq1;
 	uint32_t seq_num;
 
 	assert(inner_ip_ctxt->ctxt.vx.version == IPV4);
 	assert(inner_ip_hdr_len >= sizeof(struct ipv4_hdr));
 	assert(inner_ip_hdr->version == IPV4);
 
-	if(rohc_max_len < sizeof(seq_1_t))
+	if(rohc_max_len < seq_1_len)
 	{
 		rohc_comp_warn(context, "ROHC buffer too small for the seq_1 header: "
-		               "%zu bytes required, but only %zu bytes available",
-		               sizeof(seq_1_t), rohc_max_len);
+		               "%d bytes required, but only %zu bytes available",
+		               seq_1_len, rohc_max_len);
 		goto error;
 	}
 
-	seq1->discriminator = 0x0a; /* '1010' */
-	seq1->ip_id = tcp_context->tmp.ip_id_delta & 0x0f;
-	rohc_comp_debug(context, "4-bit IP-ID offset 0x%x", seq1->ip_id);
+	rohc_comp_debug(context, "4-bit IP-ID offset 0x%x",
+	                tcp_context->tmp.ip_id_delta & 0x0f);
 	seq_num = rohc_ntoh32(tcp->seq_num) & 0xffff;
-	seq1->seq_num = rohc_hton16(seq_num);
-	seq1->msn = tcp_context->msn & 0xf;
-	seq1->psh_flag = tcp->psh_flag;
-	seq1->header_crc = crc;
+	seq1.ip_id = tcp_context->tmp.ip_id_delta;
+	seq1.seq_num = seq_num;
+	seq1.msn = tcp_context->msn;
+	seq1.psh_flag = tcp->psh_flag;
+	seq1.header_crc = crc;
 
-	return sizeof(seq_1_t);
+	return seq_1_write(&seq1, rohc_data);
 
 error:
 	return -1;
@@ -4323,30 +4446,29 @@ static int c_tcp_build_seq_2(const struct rohc_comp_ctxt *const context,
                              uint8_t *const rohc_data,
                              const size_t rohc_max_len)
 {
-	seq_2_t *const seq2 = (seq_2_t *) rohc_data;
+	struct seq_2 seq2;
 
 	assert(inner_ip_ctxt->ctxt.vx.version == IPV4);
 	assert(inner_ip_hdr_len >= sizeof(struct ipv4_hdr));
 	assert(inner_ip_hdr->version == IPV4);
 
-	if(rohc_max_len < sizeof(seq_2_t))
+	if(rohc_max_len < seq_2_len)
 	{
 		rohc_comp_warn(context, "ROHC buffer too small for the seq_2 header: "
-		               "%zu bytes required, but only %zu bytes available",
-		               sizeof(seq_2_t), rohc_max_len);
+		               "%d bytes required, but only %zu bytes available",
+		               seq_2_len, rohc_max_len);
 		goto error;
 	}
 
-	seq2->discriminator = 0x1a; /* '11010' */
-	seq2->ip_id1 = (tcp_context->tmp.ip_id_delta >> 4) & 0x7;
-	seq2->ip_id2 = tcp_context->tmp.ip_id_delta & 0xf;
-	rohc_comp_debug(context, "7-bit IP-ID offset 0x%x%x", seq2->ip_id1, seq2->ip_id2);
-	seq2->seq_num_scaled = tcp_context->seq_num_scaled & 0xf;
-	seq2->msn = tcp_context->msn & 0xf;
-	seq2->psh_flag = tcp->psh_flag;
-	seq2->header_crc = crc;
+	rohc_comp_debug(context, "7-bit IP-ID offset 0x%x",
+	                tcp_context->tmp.ip_id_delta & 0x7f);
+	seq2.ip_id = tcp_context->tmp.ip_id_delta;
+	seq2.seq_num_scaled = tcp_context->seq_num_scaled;
+	seq2.msn = tcp_context->msn;
+	seq2.psh_flag = tcp->psh_flag;
+	seq2.header_crc = crc;
 
-	return sizeof(seq_2_t);
+	return seq_2_write(&seq2, rohc_data);
 
 error:
 	return -1;
@@ -4381,29 +4503,29 @@ static int c_tcp_build_seq_3(const struct rohc_comp_ctxt *const context,
                              uint8_t *const rohc_data,
                              const size_t rohc_max_len)
 {
-	seq_3_t *const seq3 = (seq_3_t *) rohc_data;
+	struct seq_3 seq3;
 
 	assert(inner_ip_ctxt->ctxt.vx.version == IPV4);
 	assert(inner_ip_hdr_len >= sizeof(struct ipv4_hdr));
 	assert(inner_ip_hdr->version == IPV4);
 
-	if(rohc_max_len < sizeof(seq_3_t))
+	if(rohc_max_len < seq_3_len)
 	{
 		rohc_comp_warn(context, "ROHC buffer too small for the seq_3 header: "
-		               "%zu bytes required, but only %zu bytes available",
-		               sizeof(seq_3_t), rohc_max_len);
+		               "%d bytes required, but only %zu bytes available",
+		               seq_3_len, rohc_max_len);
 		goto error;
 	}
 
-	seq3->discriminator = 0x09; /* '1001' */
-	seq3->ip_id = tcp_context->tmp.ip_id_delta & 0xf;
-	rohc_comp_debug(context, "4-bit IP-ID offset 0x%x", seq3->ip_id);
-	seq3->ack_num = rohc_hton16(rohc_ntoh32(tcp->ack_num) & 0xffff);
-	seq3->msn = tcp_context->msn & 0xf;
-	seq3->psh_flag = tcp->psh_flag;
-	seq3->header_crc = crc;
+	rohc_comp_debug(context, "4-bit IP-ID offset 0x%x",
+	                tcp_context->tmp.ip_id_delta & 0xf);
+	seq3.ip_id = tcp_context->tmp.ip_id_delta;
+	seq3.ack_num = rohc_ntoh32(tcp->ack_num);
+	seq3.msn = tcp_context->msn;
+	seq3.psh_flag = tcp->psh_flag;
+	seq3.header_crc = crc;
 
-	return sizeof(seq_3_t);
+	return seq_3_write(&seq3, rohc_data);
 
 error:
 	return -1;
@@ -4438,30 +4560,30 @@ static int c_tcp_build_seq_4(const struct rohc_comp_ctxt *const context,
                              uint8_t *const rohc_data,
                              const size_t rohc_max_len)
 {
-	seq_4_t *const seq4 = (seq_4_t *) rohc_data;
+	struct seq_4 seq4;
 
 	assert(inner_ip_ctxt->ctxt.vx.version == IPV4);
 	assert(inner_ip_hdr_len >= sizeof(struct ipv4_hdr));
 	assert(inner_ip_hdr->version == IPV4);
 	assert(tcp_context->ack_stride != 0);
 
-	if(rohc_max_len < sizeof(seq_4_t))
+	if(rohc_max_len < seq_4_len)
 	{
 		rohc_comp_warn(context, "ROHC buffer too small for the seq_4 header: "
-		               "%zu bytes required, but only %zu bytes available",
-		               sizeof(seq_4_t), rohc_max_len);
+		               "%d bytes required, but only %zu bytes available",
+		               seq_4_len, rohc_max_len);
 		goto error;
 	}
 
-	seq4->discriminator = 0x00; /* '0' */
-	seq4->ack_num_scaled = tcp_context->ack_num_scaled & 0xf;
-	seq4->ip_id = tcp_context->tmp.ip_id_delta & 0x7;
-	rohc_comp_debug(context, "3-bit IP-ID offset 0x%x", seq4->ip_id);
-	seq4->msn = tcp_context->msn & 0xf;
-	seq4->psh_flag = tcp->psh_flag;
-	seq4->header_crc = crc;
+	rohc_comp_debug(context, "3-bit IP-ID offset 0x%x",
+	                tcp_context->tmp.ip_id_delta & 0x7);
+	seq4.ack_num_scaled = tcp_context->ack_num_scaled;
+	seq4.ip_id = tcp_context->tmp.ip_id_delta;
+	seq4.msn = tcp_context->msn;
+	seq4.psh_flag = tcp->psh_flag;
+	seq4.header_crc = crc;
 
-	return sizeof(seq_4_t);
+	return seq_4_write(&seq4, rohc_data);
 
 error:
 	return -1;
@@ -4496,32 +4618,32 @@ static int c_tcp_build_seq_5(const struct rohc_comp_ctxt *const context,
                              uint8_t *const rohc_data,
                              const size_t rohc_max_len)
 {
-	seq_5_t *const seq5 = (seq_5_t *) rohc_data;
+	struct seq_5 seq5;
 	uint32_t seq_num;
 
 	assert(inner_ip_ctxt->ctxt.vx.version == IPV4);
 	assert(inner_ip_hdr_len >= sizeof(struct ipv4_hdr));
 	assert(inner_ip_hdr->version == IPV4);
 
-	if(rohc_max_len < sizeof(seq_5_t))
+	if(rohc_max_len < seq_5_len)
 	{
 		rohc_comp_warn(context, "ROHC buffer too small for the seq_5 header: "
-		               "%zu bytes required, but only %zu bytes available",
-		               sizeof(seq_5_t), rohc_max_len);
+		               "%d bytes required, but only %zu bytes available",
+		               seq_5_len, rohc_max_len);
 		goto error;
 	}
 
-	seq5->discriminator = 0x08; /* '1000' */
-	seq5->ip_id = tcp_context->tmp.ip_id_delta & 0xf;
-	rohc_comp_debug(context, "4-bit IP-ID offset 0x%x", seq5->ip_id);
-	seq5->ack_num = rohc_hton16(rohc_ntoh32(tcp->ack_num) & 0xffff);
+	rohc_comp_debug(context, "4-bit IP-ID offset 0x%x",
+	                tcp_context->tmp.ip_id_delta & 0xf);
 	seq_num = rohc_ntoh32(tcp->seq_num) & 0xffff;
-	seq5->seq_num = rohc_hton16(seq_num);
-	seq5->msn = tcp_context->msn & 0xf;
-	seq5->psh_flag = tcp->psh_flag;
-	seq5->header_crc = crc;
+	seq5.ip_id = tcp_context->tmp.ip_id_delta;
+	seq5.ack_num = rohc_ntoh32(tcp->ack_num);
+	seq5.seq_num = seq_num;
+	seq5.msn = tcp_context->msn;
+	seq5.psh_flag = tcp->psh_flag;
+	seq5.header_crc = crc;
 
-	return sizeof(seq_5_t);
+	return seq_5_write(&seq5, rohc_data);
 
 error:
 	return -1;
@@ -4555,37 +4677,30 @@ static int c_tcp_build_seq_6(const struct rohc_comp_ctxt *const context,
                              uint8_t *const rohc_data,
                              const size_t rohc_max_len)
 {
-	seq_6_t *const seq6 = (seq_6_t *) rohc_data;
-	uint8_t seq_num_scaled;
+	struct seq_6 seq6;
 
 	assert(inner_ip_ctxt->ctxt.vx.version == IPV4);
 	assert(inner_ip_hdr_len >= sizeof(struct ipv4_hdr));
 	assert(inner_ip_hdr->version == IPV4);
 
-	if(rohc_max_len < sizeof(seq_6_t))
+	if(rohc_max_len < seq_6_len)
 	{
 		rohc_comp_warn(context, "ROHC buffer too small for the seq_6 header: "
-		               "%zu bytes required, but only %zu bytes available",
-		               sizeof(seq_6_t), rohc_max_len);
+		               "%d bytes required, but only %zu bytes available",
+		               seq_6_len, rohc_max_len);
 		goto error;
 	}
 
-	seq6->discriminator = 0x1b; /* '11011' */
-
-	/* scaled sequence number */
-	seq_num_scaled = tcp_context->seq_num_scaled & 0xf;
-	seq6->seq_num_scaled1 = (seq_num_scaled >> 1) & 0x07;
-	seq6->seq_num_scaled2 = seq_num_scaled & 0x01;
-
-	/* IP-ID */
-	seq6->ip_id = tcp_context->tmp.ip_id_delta & 0x7f;
-	rohc_comp_debug(context, "7-bit IP-ID offset 0x%x", seq6->ip_id);
-	seq6->ack_num = rohc_hton16(rohc_ntoh32(tcp->ack_num) & 0xffff);
-	seq6->msn = tcp_context->msn & 0xf;
-	seq6->psh_flag = tcp->psh_flag;
-	seq6->header_crc = crc;
+	rohc_comp_debug(context, "7-bit IP-ID offset 0x%x",
+	                tcp_context->tmp.ip_id_delta & 0x7f);
+	seq6.seq_num_scaled = tcp_context->seq_num_scaled;
+	seq6.ip_id = tcp_context->tmp.ip_id_delta;
+	seq6.ack_num = rohc_ntoh32(tcp->ack_num);
+	seq6.msn = tcp_context->msn;
+	seq6.psh_flag = tcp->psh_flag;
+	seq6.header_crc = crc;
 
-	return sizeof(seq_6_t);
+	return seq_6_write(&seq6, rohc_data);
 
 error:
 	return -1;
@@ -4620,38 +4735,30 @@ static int c_tcp_build_seq_7(const struct rohc_comp_ctxt *const context,
                              uint8_t *const rohc_data,
                              const size_t rohc_max_len)
 {
-	seq_7_t *const seq7 = (seq_7_t *) rohc_data;
-	uint16_t window;
+	struct seq_7 seq7;
 
 	assert(inner_ip_ctxt->ctxt.vx.version == IPV4);
 	assert(inner_ip_hdr_len >= sizeof(struct ipv4_hdr));
 	assert(inner_ip_hdr->version == IPV4);
 
-	if(rohc_max_len < sizeof(seq_7_t))
+	if(rohc_max_len < seq_7_len)
 	{
 		rohc_comp_warn(context, "ROHC buffer too small for the seq_7 header: "
-		               "%zu bytes required, but only %zu bytes available",
-		               sizeof(seq_7_t), rohc_max_len);
+		               "%d bytes required, but only %zu bytes available",
+		               seq_7_len, rohc_max_len);
 		goto error;
 	}
 
-	seq7->discriminator = 0x0c; /* '1100' */
-
-	/* window */
-	window = rohc_ntoh16(tcp->window) & 0x7fff;
-	seq7->window1 = (window >> 11) & 0x0f;
-	seq7->window2 = (window >> 3) & 0xff;
-	seq7->window3 = window & 0x07;
-
-	/* IP-ID */
-	seq7->ip_id = tcp_context->tmp.ip_id_delta & 0x1f;
-	rohc_comp_debug(context, "5-bit IP-ID offset 0x%x", seq7->ip_id);
-	seq7->ack_num = rohc_hton16(rohc_ntoh32(tcp->ack_num) & 0xffff);
-	seq7->msn = tcp_context->msn & 0xf;
-	seq7->psh_flag = tcp->psh_flag;
-	seq7->header_crc = crc;
+	rohc_comp_debug(context, "5-bit IP-ID offset 0x%x",
+	                tcp_context->tmp.ip_id_delta & 0x1f);
+	seq7.window = rohc_ntoh16(tcp->window);
+	seq7.ip_id = tcp_context->tmp.ip_id_delta;
+	seq7.ack_num = rohc_ntoh32(tcp->ack_num);
+	seq7.msn = tcp_context->msn;
+	seq7.psh_flag = tcp->psh_flag;
+	seq7.header_crc = crc;
 
-	return sizeof(seq_7_t);
+	return seq_7_write(&seq7, rohc_data);
 
 error:
 	return -1;
@@ -4686,58 +4793,47 @@ static int c_tcp_build_seq_8(const struct rohc_comp_ctxt *const context,
                              uint8_t *const rohc_data,
                              const size_t rohc_max_len)
 {
-	seq_8_t *const seq8 = (seq_8_t *) rohc_data;
 	const struct ipv4_hdr *const ipv4 = (struct ipv4_hdr *) inner_ip_hdr;
+	struct seq_8 seq8;
 	size_t comp_opts_len;
-	uint16_t ack_num;
-	uint16_t seq_num;
 	int ret;
 
 	assert(inner_ip_ctxt->ctxt.vx.version == IPV4);
 	assert(inner_ip_hdr_len >= sizeof(struct ipv4_hdr));
 	assert(inner_ip_hdr->version == IPV4);
 
-	if(rohc_max_len < sizeof(seq_8_t))
+	if(rohc_max_len < seq_8_len)
 	{
 		rohc_comp_warn(context, "ROHC buffer too small for the seq_8 header: "
-		               "%zu bytes required, but only %zu bytes available",
-		               sizeof(seq_8_t), rohc_max_len);
+		               "%d bytes required, but only %zu bytes available",
+		               seq_8_len, rohc_max_len);
 		goto error;
 	}
 
-	seq8->discriminator = 0x0b; /* '1011' */
-
 	/* IP-ID */
-	seq8->ip_id = tcp_context->tmp.ip_id_delta & 0xf;
-	rohc_comp_debug(context, "4-bit IP-ID offset 0x%x", seq8->ip_id);
+	seq8.ip_id = tcp_context->tmp.ip_id_delta & 0xf;
+	rohc_comp_debug(context, "4-bit IP-ID offset 0x%x", seq8.ip_id);
 
-	seq8->list_present = 0; /* options are set later */
-	seq8->header_crc = crc;
-	rohc_comp_debug(context, "CRC = 0x%x", seq8->header_crc);
-	seq8->msn = tcp_context->msn & 0xf;
-	seq8->psh_flag = tcp->psh_flag;
+	seq8.header_crc = crc;
+	rohc_comp_debug(context, "CRC = 0x%x", seq8.header_crc);
+	seq8.msn = tcp_context->msn & 0xf;
+	seq8.psh_flag = tcp->psh_flag;
 
 	/* TTL/HL */
-	seq8->ttl_hopl = ipv4->ttl & 0x7;
+	seq8.ttl_hopl = ipv4->ttl & 0x7;
 
 	/* ecn_used */
-	seq8->ecn_used = GET_REAL(tcp_context->ecn_used);
+	seq8.ecn_used = GET_REAL(tcp_context->ecn_used);
 
 	/* ACK number */
-	ack_num = rohc_ntoh32(tcp->ack_num) & 0x7fff;
-	seq8->ack_num1 = (ack_num >> 8) & 0x7f;
-	seq8->ack_num2 = ack_num & 0xff;
-	rohc_comp_debug(context, "ack_number = 0x%04x (0x%02x 0x%02x)",
-	                ack_num, seq8->ack_num1, seq8->ack_num2);
+	seq8.ack_num = rohc_ntoh32(tcp->ack_num) & 0x7fff;
+	rohc_comp_debug(context, "ack_number = 0x%04x", seq8.ack_num);
 
-	seq8->rsf_flags = rsf_index_enc(tcp->rsf_flags);
+	seq8.rsf_flags = rsf_index_enc(tcp->rsf_flags);
 
 	/* sequence number */
-	seq_num = rohc_ntoh32(tcp->seq_num) & 0x3fff;
-	seq8->seq_num1 = (seq_num >> 8) & 0x3f;
-	seq8->seq_num2 = seq_num & 0xff;
-	rohc_comp_debug(context, "seq_number = 0x%04x (0x%02x 0x%02x)",
-	                seq_num, seq8->seq_num1, seq8->seq_num2);
+	seq8.seq_num = rohc_ntoh32(tcp->seq_num) & 0x3fff;
+	rohc_comp_debug(context, "seq_number = 0x%04x", seq8.seq_num);
 
 	/* include the list of TCP options if the structure of the list changed
 	 * or if some static options changed (irregular chain cannot transmit
@@ -4747,11 +4843,11 @@ static int c_tcp_build_seq_8(const struct rohc_comp_ctxt *const context,
 	{
 		/* the structure of the list of TCP options changed or at least one of
 		 * the static option changed, compress them */
-		seq8->list_present = 1;
+		seq8.list_present = 1;
 		ret = c_tcp_code_tcp_opts_list_item(context, tcp, tcp_context->msn,
 		                                    false, &tcp_context->tcp_opts,
-		                                    seq8->options,
-		                                    rohc_max_len - sizeof(rnd_8_t));
+		                                    rohc_data + seq_8_len,
+		                                    rohc_max_len - seq_8_len);
 		if(ret < 0)
 		{
 			rohc_comp_warn(context, "failed to compress TCP options");
@@ -4763,11 +4859,12 @@ static int c_tcp_build_seq_8(const struct rohc_comp_ctxt *const context,
 	{
 		/* the structure of the list of TCP options didn't change */
 		rohc_comp_debug(context, "compressed list of TCP options: list not present");
-		seq8->list_present = 0;
+		seq8.list_present = 0;
 		comp_opts_len = 0;
 	}
 
-	return (sizeof(seq_8_t) + comp_opts_len);
+	/* the fixed part is written once the presence of the list is known */
+	return (seq_8_write(&seq8, rohc_data) + comp_opts_len);
 
 error:
 	return -1;
@@ -4951,7 +5048,8 @@ static int c_tcp_build_co_common(const struct rohc_comp_ctxt *const context,
 	rohc_comp_debug(context, "urg_flag = %d", co_common->urg_flag);
 	/* urg_ptr */
 	ret = c_static_or_irreg16(tcp->urg_ptr,
-	                          !!(tcp_context->old_tcphdr.urg_ptr == tcp->urg_ptr),
+	                          !!((tcp_context->tmp.tcp_hdr_changed &
+	                              TCP_HDR_CHANGED_URG_PTR) == 0),
 	                          co_common_opt, rohc_remain_len, &indicator);
 	if(ret < 0)
 	{
@@ -5115,15 +5213,13 @@ static bool tcp_detect_changes(struct rohc_comp_ctxt *const context,
                                const struct tcphdr **const tcp)
 {
 	struct sc_tcp_context *const tcp_context = context->specific;
-	const uint8_t *remain_data = uncomp_pkt->outer_ip.data;
-	size_t remain_len = uncomp_pkt->outer_ip.size;
+	const struct net_pkt_hdrs *const hdrs = uncomp_pkt->hdrs;
 
 	const uint8_t *inner_ip_hdr = NULL;
 	ip_version inner_ip_version = IP_UNKNOWN;
 
-	size_t ip_hdrs_nr;
+	size_t ip_hdr_pos;
 	size_t hdrs_len;
-	uint8_t protocol;
 	size_t opts_len;
 	bool pkt_outer_dscp_changed;
 	bool last_pkt_outer_dscp_changed;
@@ -5133,104 +5229,57 @@ static bool tcp_detect_changes(struct rohc_comp_ctxt *const context,
 	tcp_context->tmp.is_ipv6_exts_list_static_changed = false;
 	tcp_context->tmp.is_ipv6_exts_list_dyn_changed = false;
 
-	hdrs_len = 0;
+	/* the IP headers were described while parsing the packet */
+	assert(hdrs->is_complete);
+	assert(hdrs->ip_nr == tcp_context->ip_contexts_nr);
+
 	pkt_outer_dscp_changed = 0;
 	last_pkt_outer_dscp_changed = false;
 	pkt_ecn_vals = 0;
-	ip_hdrs_nr = 0;
-	do
+	for(ip_hdr_pos = 0; ip_hdr_pos < hdrs->ip_nr; ip_hdr_pos++)
 	{
-		const struct ip_hdr *const ip = (struct ip_hdr *) remain_data;
-		ip_context_t *const ip_context = &(tcp_context->ip_contexts[ip_hdrs_nr]);
+		const struct net_pkt_ip *const ip = &(hdrs->ip[ip_hdr_pos]);
+		ip_context_t *const ip_context = &(tcp_context->ip_contexts[ip_hdr_pos]);
 
-		assert(remain_len >= sizeof(struct ip_hdr));
 		rohc_comp_debug(context, "found IPv%d header #%zu",
-		                ip->version, ip_hdrs_nr + 1);
+		                ip->version, ip_hdr_pos + 1);
 
 		pkt_outer_dscp_changed =
 			!!(pkt_outer_dscp_changed || last_pkt_outer_dscp_changed);
-		inner_ip_hdr = remain_data;
+		inner_ip_hdr = ip->data;
 		inner_ip_version = ip->version;
 		*ip_inner_ctxt = ip_context;
 
 		if(ip->version == IPV4)
 		{
-			const struct ipv4_hdr *const ipv4 = (struct ipv4_hdr *) remain_data;
+			const struct ipv4_hdr *const ipv4 = (struct ipv4_hdr *) ip->data;
 
-			if(remain_len < sizeof(struct ipv4_hdr))
-			{
-				rohc_comp_warn(context, "not enough data for IPv4 header #%zu",
-				               ip_hdrs_nr + 1);
-				goto error;
-			}
-
-			protocol = ipv4->protocol;
 			last_pkt_outer_dscp_changed = !!(ipv4->dscp != ip_context->ctxt.vx.dscp);
 			pkt_ecn_vals |= ipv4->ecn;
-
-			remain_data += sizeof(struct ipv4_hdr);
-			remain_len -= sizeof(struct ipv4_hdr);
-			hdrs_len += sizeof(struct ipv4_hdr);
 		}
-		else if(ip->version == IPV6)
+		else
 		{
-			const struct ipv6_hdr *const ipv6 = (struct ipv6_hdr *) remain_data;
-			uint8_t dscp;
-			size_t exts_nr;
-			size_t exts_len;
-
-			if(remain_len < sizeof(struct ipv6_hdr))
-			{
-				rohc_comp_warn(context, "not enough data for IPv6 header #%zu",
-				               ip_hdrs_nr + 1);
-				goto error;
-			}
+			const uint8_t dscp = (ip->data[1] >> 2) & 0x3f;
 
-			protocol = ipv6->nh;
-			dscp = (remain_data[1] >> 2) & 0x3f;
+			assert(ip->version == IPV6);
 			last_pkt_outer_dscp_changed = !!(dscp != ip_context->ctxt.vx.dscp);
-			pkt_ecn_vals |= remain_data[1] & 0x3;
-
-			remain_data += sizeof(struct ipv6_hdr);
-			remain_len -= sizeof(struct ipv6_hdr);
-			hdrs_len += sizeof(struct ipv6_hdr);
+			pkt_ecn_vals |= ip->data[1] & 0x3;
 
-			if(!tcp_detect_changes_ipv6_exts(context, ip_context, &protocol,
-			                                 remain_data, remain_len,
-			                                 &exts_nr, &exts_len))
-			{
-				rohc_comp_warn(context, "failed to detect changes in IPv6 extension headers");
-				goto error;
-			}
-			remain_data += exts_len;
-			remain_len -= exts_len;
-			tcp_context->tmp.ip_exts_nr[ip_hdrs_nr] = exts_nr;
-			hdrs_len += exts_len;
-		}
-		else
-		{
-			rohc_comp_warn(context, "unknown IP header with version %u", ip->version);
-			goto error;
+			tcp_detect_changes_ipv6_exts(context, ip_context, ip);
 		}
 		rohc_comp_debug(context, "  DSCP did%s change",
 		                last_pkt_outer_dscp_changed ? "" : "n't");
-
-		ip_hdrs_nr++;
 	}
-	while(protocol != ROHC_IPPROTO_TCP && hdrs_len < uncomp_pkt->outer_ip.size);
 
 	/* next header is the TCP header */
-	if(remain_len < sizeof(struct tcphdr))
+	if(hdrs->transport_len < sizeof(struct tcphdr))
 	{
 		rohc_comp_warn(context, "not enough data for TCP header");
 		goto error;
 	}
-	*tcp = (struct tcphdr *) remain_data;
+	*tcp = (struct tcphdr *) hdrs->transport;
+	hdrs_len = hdrs->transport - uncomp_pkt->outer_ip.data;
 	pkt_ecn_vals |= (*tcp)->ecn_flags;
-#ifndef __clang_analyzer__ /* silent warning about dead in/decrement */
-	remain_data += sizeof(struct tcphdr);
-	remain_len -= sizeof(struct tcphdr);
-#endif
 	hdrs_len += sizeof(struct tcphdr);
 
 	/* parse TCP options for changes */
@@ -5242,10 +5291,6 @@ static bool tcp_detect_changes(struct rohc_comp_ctxt *const context,
 	}
 	rohc_comp_debug(context, "%zu bytes of TCP options successfully parsed",
 	                opts_len);
-#ifndef __clang_analyzer__ /* silent warning about dead in/decrement */
-	remain_data += opts_len;
-	remain_len -= opts_len;
-#endif
 	hdrs_len += opts_len;
 
 	/* what value for ecn_used? */
@@ -5263,7 +5308,7 @@ static bool tcp_detect_changes(struct rohc_comp_ctxt *const context,
 		rohc_comp_debug(context, "IP-ID = 0x%04x -> 0x%04x",
 		                (*ip_inner_ctxt)->ctxt.v4.last_ip_id, ip_id);
 
-		if(context->num_sent_packets == 0)
+		if(context->num_sent_packets == 0 && !tcp_context->is_cloned)
 		{
 			/* first packet, be optimistic: choose sequential behavior */
 			(*ip_inner_ctxt)->ctxt.v4.ip_id_behavior = IP_ID_BEHAVIOR_SEQ;
@@ -5271,7 +5316,8 @@ static bool tcp_detect_changes(struct rohc_comp_ctxt *const context,
 		else
 		{
 			(*ip_inner_ctxt)->ctxt.v4.ip_id_behavior =
-				tcp_detect_ip_id_behavior((*ip_inner_ctxt)->ctxt.v4.last_ip_id, ip_id);
+				tcp_detect_ip_id_behavior((*ip_inner_ctxt)->ctxt.v4.ip_id_behavior,
+				                          (*ip_inner_ctxt)->ctxt.v4.last_ip_id, ip_id);
 		}
 		rohc_comp_debug(context, "IP-ID now behaves as %s",
 		                tcp_ip_id_behavior_get_descr((*ip_inner_ctxt)->ctxt.v4.ip_id_behavior));
@@ -5297,58 +5343,31 @@ error:
 /**
  * @brief Detect changes about IPv6 extension headers between packet and context
  *
- * @param context           The compression context to compare
- * @param ip_context        The specific IP compression context
- * @param[in,out] protocol  in: the protocol type of the first extension header
- *                          out: the protocol type of the transport header
- * @param exts              The beginning of the IPv6 extension headers
- * @param max_exts_len      The maximum length (in bytes) of the extension headers
- * @param[out] exts_nr      The number of IPv6 extension headers
- * @param[out] exts_len     The length (in bytes) of the IPv6 extension headers
- * @return                  true if changes were successfully detected,
- *                          false if a problem occurred
+ * The IPv6 extension headers were described and checked while parsing the
+ * packet and checking profile.
+ *
+ * @param context     The compression context to compare
+ * @param ip_context  The specific IP compression context
+ * @param ip          The IPv6 header described with its extension headers
  */
-static bool tcp_detect_changes_ipv6_exts(struct rohc_comp_ctxt *const context,
+static void tcp_detect_changes_ipv6_exts(struct rohc_comp_ctxt *const context,
                                          ip_context_t *const ip_context,
-                                         uint8_t *const protocol,
-                                         const uint8_t *const exts,
-                                         const size_t max_exts_len,
-                                         size_t *const exts_nr,
-                                         size_t *const exts_len)
+                                         const struct net_pkt_ip *const ip)
 {
 	struct sc_tcp_context *const tcp_context = context->specific;
-	const uint8_t *remain_data = exts;
-	size_t remain_len = max_exts_len;
 	size_t ext_pos;
 
-	(*exts_nr) = 0;
-	(*exts_len) = 0;
-
-	for(ext_pos = 0;
-	    rohc_is_ipv6_opt(*protocol) && ext_pos < ROHC_TCP_MAX_IP_EXT_HDRS;
-	    ext_pos++)
+	for(ext_pos = 0; ext_pos < ip->exts_nr; ext_pos++)
 	{
 		ip_option_context_t *const opt_ctxt = &(ip_context->opts[ext_pos]);
-		const struct ipv6_opt *const ext = (struct ipv6_opt *) remain_data;
-		size_t ext_len;
+		const uint8_t type = ip->exts[ext_pos].type;
+		const size_t ext_len = ip->exts[ext_pos].len;
+		const struct ipv6_opt *const ext =
+			(struct ipv6_opt *) (ip->data + ip->exts[ext_pos].offset);
 
-		rohc_comp_debug(context, "  found IP extension header %u", *protocol);
-
-		if(remain_len < (sizeof(struct ipv6_opt) - 1))
-		{
-			rohc_comp_warn(context, "malformed IPv6 extension header: remaining "
-			               "data too small for minimal IPv6 header");
-			goto error;
-		}
-		ext_len = ipv6_opt_get_length(ext);
-		if(remain_len < ext_len)
-		{
-			rohc_comp_warn(context, "malformed IPv6 extension header: remaining "
-			               "data too small for IPv6 header");
-			goto error;
-		}
+		rohc_comp_debug(context, "  found IP extension header %u", type);
 
-		switch(*protocol)
+		switch(type)
 		{
 			case ROHC_IPPROTO_HOPOPTS: /* IPv6 Hop-by-Hop option */
 			case ROHC_IPPROTO_ROUTING: /* IPv6 routing header */
@@ -5360,7 +5379,7 @@ static bool tcp_detect_changes_ipv6_exts(struct rohc_comp_ctxt *const context,
 				if(context->num_sent_packets == 0 ||
 				   ext_pos >= ip_context->opts_nr)
 				{
-					rohc_comp_debug(context, "  IPv6 option %u is new", *protocol);
+					rohc_comp_debug(context, "  IPv6 option %u is new", type);
 					tcp_context->tmp.is_ipv6_exts_list_static_changed = true;
 
 					/* record option in context */
@@ -5372,7 +5391,7 @@ static bool tcp_detect_changes_ipv6_exts(struct rohc_comp_ctxt *const context,
 				else if(ext_len != opt_ctxt->generic.option_length)
 				{
 					rohc_comp_debug(context, "  IPv6 option %u changed of length "
-					                "(%zu -> %zu bytes)", *protocol,
+					                "(%zu -> %zu bytes)", type,
 					                opt_ctxt->generic.option_length, ext_len);
 					tcp_context->tmp.is_ipv6_exts_list_static_changed = true;
 
@@ -5384,8 +5403,8 @@ static bool tcp_detect_changes_ipv6_exts(struct rohc_comp_ctxt *const context,
 				else if(memcmp(ext->value, opt_ctxt->generic.data, ext_len - 2) != 0)
 				{
 					rohc_comp_debug(context, "  IPv6 option %u changed of content",
-					                *protocol);
-					if((*protocol) == ROHC_IPPROTO_ROUTING)
+					                type);
+					if(type == ROHC_IPPROTO_ROUTING)
 					{
 						tcp_context->tmp.is_ipv6_exts_list_static_changed = true;
 					}
@@ -5402,7 +5421,7 @@ static bool tcp_detect_changes_ipv6_exts(struct rohc_comp_ctxt *const context,
 				else
 				{
 					rohc_comp_debug(context, "  IPv6 option %u did not change",
-					                *protocol);
+					                type);
 				}
 				break;
 			case ROHC_IPPROTO_GRE:  /* TODO: GRE not yet supported */
@@ -5412,28 +5431,19 @@ static bool tcp_detect_changes_ipv6_exts(struct rohc_comp_ctxt *const context,
 				assert(0);
 				break;
 		}
-		(*protocol) = ext->next_header;
-
-		remain_data += ext_len;
-		remain_len -= ext_len;
-
-		(*exts_nr)++;
-		(*exts_len) += ext_len;
 	}
-	assert(!rohc_is_ipv6_opt(*protocol));
-	assert((*exts_nr) <= ROHC_TCP_MAX_IP_EXT_HDRS);
 
 	/* more or less IP extension headers than previous packet? */
-	if(context->num_sent_packets == 0 || (*exts_nr) < ip_context->opts_nr)
+	if(context->num_sent_packets == 0 || ip->exts_nr < ip_context->opts_nr)
 	{
-		rohc_comp_debug(context, "  less IP extension headers (%zu) than "
-		                "context (%zu)", *exts_nr, ip_context->opts_nr);
+		rohc_comp_debug(context, "  less IP extension headers (%u) than "
+		                "context (%zu)", ip->exts_nr, ip_context->opts_nr);
 		tcp_context->tmp.is_ipv6_exts_list_static_changed = true;
 	}
-	else if((*exts_nr) > ip_context->opts_nr)
+	else if(ip->exts_nr > ip_context->opts_nr)
 	{
-		rohc_comp_debug(context, "  more IP extension headers (%zu+) than "
-		                "context (%zu)", *exts_nr, ip_context->opts_nr);
+		rohc_comp_debug(context, "  more IP extension headers (%u+) than "
+		                "context (%zu)", ip->exts_nr, ip_context->opts_nr);
 		tcp_context->tmp.is_ipv6_exts_list_static_changed = true;
 	}
 
@@ -5453,10 +5463,6 @@ static bool tcp_detect_changes_ipv6_exts(struct rohc_comp_ctxt *const context,
 		                "neither static nor dynamic chain is required");
 	}
 
-	return true;
-
-error:
-	return false;
 }
 
 
@@ -5604,109 +5610,52 @@ static bool tcp_encode_uncomp_ip_fields(struct rohc_comp_ctxt *const context,
                                         const struct net_pkt *const uncomp_pkt)
 {
 	struct sc_tcp_context *const tcp_context = context->specific;
-
-	const uint8_t *remain_data = uncomp_pkt->data;
-	size_t remain_len = uncomp_pkt->len;
+	const struct net_pkt_hdrs *const hdrs = uncomp_pkt->hdrs;
 
 	const ip_context_t *inner_ip_ctxt = NULL;
 	const uint8_t *inner_ip_hdr = NULL;
 	ip_version inner_ip_version = IP_UNKNOWN;
 
-	uint8_t protocol;
 	size_t ip_hdr_pos;
 
 	/* there is at least one IP header otherwise it won't be the IP/TCP profile */
 	assert(tcp_context->ip_contexts_nr > 0);
+	assert(hdrs->ip_nr == tcp_context->ip_contexts_nr);
 
-	/* parse IP headers */
+	/* walk the IP headers described while parsing the packet */
 	tcp_context->tmp.ttl_irreg_chain_flag = 0;
 	for(ip_hdr_pos = 0; ip_hdr_pos < tcp_context->ip_contexts_nr; ip_hdr_pos++)
 	{
-		const struct ip_hdr *const ip = (struct ip_hdr *) remain_data;
+		const struct net_pkt_ip *const ip = &(hdrs->ip[ip_hdr_pos]);
 		const ip_context_t *const ip_context = &(tcp_context->ip_contexts[ip_hdr_pos]);
 		const bool is_innermost = !!(ip_hdr_pos + 1 == tcp_context->ip_contexts_nr);
 		uint8_t ttl_hopl;
-		size_t ip_ext_pos;
 
-		/* retrieve IP version */
-		assert(remain_len >= sizeof(struct ip_hdr));
-		rohc_comp_debug(context, "found IPv%d", ip->version);
+		rohc_comp_debug(context, "found IPv%d with %u-byte header and %u-byte "
+		                "extension headers before protocol 0x%02x", ip->version,
+		                ip->hdr_len, ip->exts_len, ip->next_proto);
 
 		inner_ip_ctxt = ip_context;
-		inner_ip_hdr = remain_data;
+		inner_ip_hdr = ip->data;
 		inner_ip_version = ip->version;
 
+		/* irregular chain? */
 		if(ip->version == IPV4)
 		{
-			const struct ipv4_hdr *const ipv4 = (struct ipv4_hdr *) remain_data;
-			size_t ipv4_hdr_len;
-
-			assert(remain_len >= sizeof(struct ipv4_hdr));
-			ipv4_hdr_len = ipv4->ihl * sizeof(uint32_t);
-			assert(remain_len >= ipv4_hdr_len);
-
-			/* get the transport protocol */
-			protocol = ipv4->protocol;
-
-			/* irregular chain? */
-			ttl_hopl = ipv4->ttl;
-			if(!is_innermost && ttl_hopl != ip_context->ctxt.v4.ttl_hopl)
-			{
-				tcp_context->tmp.ttl_irreg_chain_flag |= 1;
-				rohc_comp_debug(context, "last ttl_hopl = 0x%02x, ttl_hopl = "
-				                "0x%02x, ttl_irreg_chain_flag = %d",
-				                ip_context->ctxt.v4.ttl_hopl, ttl_hopl,
-				                tcp_context->tmp.ttl_irreg_chain_flag);
-			}
-
-			/* skip IPv4 header */
-			rohc_comp_debug(context, "skip %zu-byte IPv4 header with "
-			                "Protocol 0x%02x", ipv4_hdr_len, protocol);
-			remain_data += ipv4_hdr_len;
-			remain_len -= ipv4_hdr_len;
+			ttl_hopl = ((const struct ipv4_hdr *) ip->data)->ttl;
 		}
-		else if(ip->version == IPV6)
+		else
 		{
-			const struct ipv6_hdr *const ipv6 = (struct ipv6_hdr *) remain_data;
-
-			assert(remain_len >= sizeof(struct ipv6_hdr));
-
-			/* get the transport protocol */
-			protocol = ipv6->nh;
-
-			/* irregular chain? */
-			ttl_hopl = ipv6->hl;
-			if(!is_innermost && ttl_hopl != ip_context->ctxt.v6.ttl_hopl)
-			{
-				tcp_context->tmp.ttl_irreg_chain_flag |= 1;
-				rohc_comp_debug(context, "last ttl_hopl = 0x%02x, ttl_hopl = "
-				                "0x%02x, ttl_irreg_chain_flag = %d",
-				                ip_context->ctxt.v6.ttl_hopl, ttl_hopl,
-				                tcp_context->tmp.ttl_irreg_chain_flag);
-			}
-
-			/* skip IPv6 header */
-			rohc_comp_debug(context, "skip %zd-byte IPv6 header with Next "
-			                "Header 0x%02x", sizeof(struct ipv6_hdr), protocol);
-			remain_data += sizeof(struct ipv6_hdr);
-			remain_len -= sizeof(struct ipv6_hdr);
-
-			/* skip IPv6 extension headers */
-			for(ip_ext_pos = 0; rohc_is_ipv6_opt(protocol); ip_ext_pos++)
-			{
-				const struct ipv6_opt *const ipv6_opt = (struct ipv6_opt *) remain_data;
-				const size_t opt_len = ipv6_opt_get_length(ipv6_opt);
-				rohc_comp_debug(context, "  skip %zu-byte IPv6 extension header "
-				                "with Next Header 0x%02x", opt_len, protocol);
-				remain_data += opt_len;
-				remain_len -= opt_len;
-				protocol = ipv6_opt->next_header;
-			}
+			assert(ip->version == IPV6);
+			ttl_hopl = ((const struct ipv6_hdr *) ip->data)->hl;
 		}
-		else
+		if(!is_innermost && ttl_hopl != ip_context->ctxt.vx.ttl_hopl)
 		{
-			assert(0);
-			goto error;
+			tcp_context->tmp.ttl_irreg_chain_flag |= 1;
+			rohc_comp_debug(context, "last ttl_hopl = 0x%02x, ttl_hopl = "
+			                "0x%02x, ttl_irreg_chain_flag = %d",
+			                ip_context->ctxt.vx.ttl_hopl, ttl_hopl,
+			                tcp_context->tmp.ttl_irreg_chain_flag);
 		}
 	}
 
@@ -5835,9 +5784,6 @@ static bool tcp_encode_uncomp_ip_fields(struct rohc_comp_ctxt *const context,
 	           tcp_context->tmp.ttl_hopl);
 
 	return true;
-
-error:
-	return false;
 }
 
 
@@ -5872,15 +5818,30 @@ static bool tcp_encode_uncomp_tcp_fields(struct rohc_comp_ctxt *const context,
 	                rohc_ntoh16(tcp->window), rohc_ntoh16(tcp->checksum),
 	                rohc_ntoh16(tcp->urg_ptr));
 
-	tcp_context->tmp.tcp_ack_flag_changed =
-		(tcp->ack_flag != tcp_context->old_tcphdr.ack_flag);
+	/* find all the 16-bit words of the TCP header that changed at once, the
+	 * flags are only inspected one by one if their word changed */
+	tcp_context->tmp.tcp_hdr_changed =
+		tcp_hdr_get_changes(&tcp_context->old_tcphdr, tcp);
+	rohc_comp_debug(context, "TCP header change mask = 0x%04x",
+	                tcp_context->tmp.tcp_hdr_changed);
+
+	if((tcp_context->tmp.tcp_hdr_changed & TCP_HDR_CHANGED_FLAGS) == 0)
+	{
+		tcp_context->tmp.tcp_ack_flag_changed = false;
+		tcp_context->tmp.tcp_urg_flag_changed = false;
+	}
+	else
+	{
+		tcp_context->tmp.tcp_ack_flag_changed =
+			(tcp->ack_flag != tcp_context->old_tcphdr.ack_flag);
+		tcp_context->tmp.tcp_urg_flag_changed =
+			(tcp->urg_flag != tcp_context->old_tcphdr.urg_flag);
+	}
 	tcp_field_descr_change(context, "ACK flag",
 	                       tcp_context->tmp.tcp_ack_flag_changed, 0);
 	tcp_context->tmp.tcp_urg_flag_present = (tcp->urg_flag != 0);
 	tcp_field_descr_present(context, "URG flag",
 	                        tcp_context->tmp.tcp_urg_flag_present);
-	tcp_context->tmp.tcp_urg_flag_changed =
-		(tcp->urg_flag != tcp_context->old_tcphdr.urg_flag);
 	tcp_field_descr_change(context, "URG flag",
 	                       tcp_context->tmp.tcp_urg_flag_changed, 0);
 	tcp_field_descr_change(context, "ECN flag",
@@ -5892,7 +5853,7 @@ static bool tcp_encode_uncomp_tcp_fields(struct rohc_comp_ctxt *const context,
 	}
 
 	/* how many bits are required to encode the new TCP window? */
-	if(tcp->window != tcp_context->old_tcphdr.window)
+	if((tcp_context->tmp.tcp_hdr_changed & TCP_HDR_CHANGED_WINDOW) != 0)
 	{
 		tcp_context->tmp.tcp_window_changed = true;
 		tcp_context->tcp_window_change_count = 0;
@@ -5965,7 +5926,9 @@ static bool tcp_encode_uncomp_tcp_fields(struct rohc_comp_ctxt *const context,
 		}
 		else
 		{
-			size_t ack_stride_count = 0;
+			const uint16_t old_ack_delta =
+				tcp_context->ack_deltas_width[tcp_context->ack_deltas_next];
+			size_t ack_stride_count = tcp_context->ack_stride_count;
 			size_t i;
 			size_t j;
 
@@ -5973,32 +5936,53 @@ static bool tcp_encode_uncomp_tcp_fields(struct rohc_comp_ctxt *const context,
 			tcp_context->ack_deltas_width[tcp_context->ack_deltas_next] = ack_delta;
 			tcp_context->ack_deltas_next = (tcp_context->ack_deltas_next + 1) % 20;
 
-			for(i = 0; i < 20; i++)
+			/* the ack_stride that is still used in more than half of the sliding
+			 * window is still the most used ACK delta: count the other ACK
+			 * deltas only if it is not */
+			if(old_ack_delta == tcp_context->ack_stride)
 			{
-				const uint16_t val =
-					tcp_context->ack_deltas_width[(tcp_context->ack_deltas_next + i) % 20];
-				size_t val_count = 1;
-
-				for(j = i + 1; j < 20; j++)
+				ack_stride_count--;
+			}
+			if(((uint16_t) ack_delta) == tcp_context->ack_stride)
+			{
+				ack_stride_count++;
+			}
+			if(ack_stride_count > (20/2))
+			{
+				ack_stride = tcp_context->ack_stride;
+			}
+			else
+			{
+				/* find the ACK delta that was most used over the sliding window */
+				ack_stride_count = 0;
+				for(i = 0; i < 20; i++)
 				{
-					if(val == tcp_context->ack_deltas_width[(tcp_context->ack_deltas_next + j) % 20])
+					const uint16_t val =
+						tcp_context->ack_deltas_width[(tcp_context->ack_deltas_next + i) % 20];
+					size_t val_count = 1;
+
+					for(j = i + 1; j < 20; j++)
 					{
-						val_count++;
+						if(val == tcp_context->ack_deltas_width[(tcp_context->ack_deltas_next + j) % 20])
+						{
+							val_count++;
+						}
 					}
-				}
 
-				if(val_count > ack_stride_count)
-				{
-					ack_stride = val;
-					ack_stride_count = val_count;
-					if(ack_stride_count > (20/2))
+					if(val_count > ack_stride_count)
 					{
-						break;
+						ack_stride = val;
+						ack_stride_count = val_count;
+						if(ack_stride_count > (20/2))
+						{
+							break;
+						}
 					}
 				}
 			}
 			rohc_comp_debug(context, "ack_stride 0x%04x was used %zu times in the "
 			                "last 20 packets", ack_stride, ack_stride_count);
+			tcp_context->ack_stride_count = ack_stride_count;
 		}
 
 		/* compute new scaled ACK number & residue */
@@ -6033,7 +6017,7 @@ static bool tcp_encode_uncomp_tcp_fields(struct rohc_comp_ctxt *const context,
 
 	/* how many bits are required to encode the new sequence number? */
 	tcp_context->tmp.tcp_seq_num_changed =
-		(tcp->seq_num != tcp_context->old_tcphdr.seq_num);
+		((tcp_context->tmp.tcp_hdr_changed & TCP_HDR_CHANGED_SEQ_NUM) != 0);
 	tcp_context->tmp.nr_seq_bits_65535 =
 		wlsb_get_kp_32bits(tcp_context->seq_wlsb, seq_num_hbo, 65535);
 	rohc_comp_debug(context, "%zd bits are required to encode new sequence "
@@ -6083,7 +6067,7 @@ static bool tcp_encode_uncomp_tcp_fields(struct rohc_comp_ctxt *const context,
 
 	/* how many bits are required to encode the new ACK number? */
 	tcp_context->tmp.tcp_ack_num_changed =
-		(tcp->ack_num != tcp_context->old_tcphdr.ack_num);
+		((tcp_context->tmp.tcp_hdr_changed & TCP_HDR_CHANGED_ACK_NUM) != 0);
 	tcp_context->tmp.nr_ack_bits_65535 =
 		wlsb_get_kp_32bits(tcp_context->ack_wlsb, ack_num_hbo, 65535);
 	rohc_comp_debug(context, "%zd bits are required to encode new ACK "
@@ -6233,6 +6217,56 @@ static bool tcp_encode_uncomp_tcp_fields(struct rohc_comp_ctxt *const context,
 }
 
 
+/**
+ * @brief Find the 16-bit words that changed between two TCP headers
+ *
+ * The fixed parts of the two TCP headers are XOR-ed together four 16-bit
+ * words at a time, then one bit is set in the change mask for every word
+ * that is not zero. The TCP_HDR_CHANGED_* masks tell which fields changed.
+ *
+ * @param old_tcp  The TCP header of the previous packet
+ * @param new_tcp  The TCP header of the current packet
+ * @return         The mask of the 16-bit words that changed
+ */
+static uint16_t tcp_hdr_get_changes(const struct tcphdr *const old_tcp,
+                                    const struct tcphdr *const new_tcp)
+{
+	uint16_t old_words[TCP_HDR_WORDS_NR + 2] = { 0 };
+	uint16_t new_words[TCP_HDR_WORDS_NR + 2] = { 0 };
+	uint16_t changed = 0;
+	size_t i;
+
+	/* copy the headers in aligned buffers padded to a multiple of 64 bits */
+	memcpy(old_words, old_tcp, sizeof(struct tcphdr));
+	memcpy(new_words, new_tcp, sizeof(struct tcphdr));
+
+	for(i = 0; i < (TCP_HDR_WORDS_NR + 2); i += 4)
+	{
+		uint64_t old_val;
+		uint64_t new_val;
+		uint64_t diff;
+		size_t j;
+
+		memcpy(&old_val, old_words + i, sizeof(uint64_t));
+		memcpy(&new_val, new_words + i, sizeof(uint64_t));
+		diff = old_val ^ new_val;
+		if(diff == 0)
+		{
+			continue;
+		}
+		for(j = 0; j < 4; j++)
+		{
+			if(old_words[i + j] != new_words[i + j])
+			{
+				changed |= (1U << (i + j));
+			}
+		}
+	}
+
+	return changed;
+}
+
+
 /**
  * @brief Decide which packet to send when in the different states.
  *
@@ -6385,13 +6419,19 @@ static rohc_packet_t tcp_decide_FO_SO_packet(const struct rohc_comp_ctxt *const
 	        tcp_context->tmp.tcp_ack_flag_changed ||
 	        tcp_context->tmp.tcp_urg_flag_present ||
 	        tcp_context->tmp.tcp_urg_flag_changed ||
-	        tcp_context->old_tcphdr.urg_ptr != tcp->urg_ptr ||
+	        (tcp_context->tmp.tcp_hdr_changed & TCP_HDR_CHANGED_URG_PTR) != 0 ||
 	        !tcp_is_ack_stride_static(tcp_context->ack_stride,
 	                                  tcp_context->ack_num_scaling_nr))
 	{
 		TRACE_GOTO_CHOICE;
 		packet_type = ROHC_PACKET_TCP_CO_COMMON;
 	}
+	else if((context->compressor->features & ROHC_COMP_FEATURE_CHEAP_PACKETS) != 0)
+	{
+		/* seq_1, rnd_1 or co_common packet types only */
+		packet_type =
+			tcp_decide_FO_SO_packet_cheap(context, ip_inner_context, tcp, crc7_at_least);
+	}
 	else if(tcp_context->tmp.ecn_used_changed ||
 	        tcp_context->tmp.ttl_hopl_changed)
 	{
@@ -6638,6 +6678,67 @@ static rohc_packet_t tcp_decide_FO_SO_packet_seq(const struct rohc_comp_ctxt *co
 }
 
 
+/**
+ * @brief Decide which packet to send when in FO or SO state if the packet
+ *        types are restricted to the cheapest ones to encode
+ *
+ * Only the seq_1 and rnd_1 packets are used when the sequence number is the
+ * only field of the TCP header that changed, co_common is used otherwise.
+ *
+ * @param context           The compression context
+ * @param ip_inner_context  The context of the inner IP header
+ * @param tcp               The TCP header to compress
+ * @param crc7_at_least     Whether packet types with CRC strictly smaller
+ *                          than 8 bits are allowed or not
+ * @return                  The packet type among ROHC_PACKET_TCP_SEQ_1,
+ *                          ROHC_PACKET_TCP_RND_1 and ROHC_PACKET_TCP_CO_COMMON
+ *
+ * @see ROHC_COMP_FEATURE_CHEAP_PACKETS
+ */
+static rohc_packet_t tcp_decide_FO_SO_packet_cheap(const struct rohc_comp_ctxt *const context,
+                                                   const ip_context_t *const ip_inner_context,
+                                                   const struct tcphdr *const tcp,
+                                                   const bool crc7_at_least)
+{
+	const struct sc_tcp_context *const tcp_context = context->specific;
+	rohc_packet_t packet_type;
+
+	if(crc7_at_least ||
+	   tcp->rsf_flags != 0 ||
+	   tcp_context->tcp_opts.tmp.do_list_struct_changed ||
+	   tcp_context->tcp_opts.tmp.do_list_static_changed ||
+	   tcp_context->tmp.ecn_used_changed ||
+	   tcp_context->tmp.ttl_hopl_changed ||
+	   tcp_context->tmp.tcp_window_changed)
+	{
+		TRACE_GOTO_CHOICE;
+		packet_type = ROHC_PACKET_TCP_CO_COMMON;
+	}
+	else if(ip_inner_context->ctxt.vx.ip_id_behavior <= IP_ID_BEHAVIOR_SEQ_SWAP &&
+	        (tcp->ack_flag == 0 || !tcp_context->tmp.tcp_ack_num_changed) &&
+	        tcp_context->tmp.nr_ip_id_bits_3 <= 4 &&
+	        tcp_context->tmp.nr_seq_bits_32767 <= 16)
+	{
+		TRACE_GOTO_CHOICE;
+		packet_type = ROHC_PACKET_TCP_SEQ_1;
+	}
+	else if(ip_inner_context->ctxt.vx.ip_id_behavior > IP_ID_BEHAVIOR_SEQ_SWAP &&
+	        !tcp_context->tmp.tcp_ack_num_changed &&
+	        tcp_context->tmp.nr_seq_bits_65535 <= 18)
+	{
+		TRACE_GOTO_CHOICE;
+		packet_type = ROHC_PACKET_TCP_RND_1;
+	}
+	else
+	{
+		TRACE_GOTO_CHOICE;
+		packet_type = ROHC_PACKET_TCP_CO_COMMON;
+	}
+
+	return packet_type;
+}
+
+
 /**
  * @brief Decide which rnd packet to send when in FO or SO state.
  *
@@ -6796,18 +6897,39 @@ static rohc_packet_t tcp_decide_FO_SO_packet_rnd(const struct rohc_comp_ctxt *co
 /**
  * @brief Detect the behavior of the IPv4 Identification field
  *
- * @param last_ip_id  The IP-ID value of the previous packet (in HBO)
- * @param new_ip_id   The IP-ID value of the current packet (in HBO)
- * @return            The IP-ID behavior among: IP_ID_BEHAVIOR_SEQ,
- *                    IP_ID_BEHAVIOR_SEQ_SWAP, IP_ID_BEHAVIOR_ZERO, or
- *                    IP_ID_BEHAVIOR_RAND
+ * The IP-ID behaves most of the time as it did for the previous packet: the
+ * behavior is kept without classifying the IP-ID again if the IP-ID has the
+ * value that behavior predicts.
+ *
+ * @param last_behavior  The IP-ID behavior of the previous packet
+ * @param last_ip_id     The IP-ID value of the previous packet (in HBO)
+ * @param new_ip_id      The IP-ID value of the current packet (in HBO)
+ * @return               The IP-ID behavior among: IP_ID_BEHAVIOR_SEQ,
+ *                       IP_ID_BEHAVIOR_SEQ_SWAP, IP_ID_BEHAVIOR_ZERO, or
+ *                       IP_ID_BEHAVIOR_RAND
  */
-static tcp_ip_id_behavior_t tcp_detect_ip_id_behavior(const uint16_t last_ip_id,
+static tcp_ip_id_behavior_t tcp_detect_ip_id_behavior(const tcp_ip_id_behavior_t last_behavior,
+                                                      const uint16_t last_ip_id,
                                                       const uint16_t new_ip_id)
 {
 	tcp_ip_id_behavior_t behavior;
 
-	if(is_ip_id_increasing(last_ip_id, new_ip_id))
+	if(last_behavior == IP_ID_BEHAVIOR_SEQ && is_ip_id_next(last_ip_id, new_ip_id))
+	{
+		behavior = IP_ID_BEHAVIOR_SEQ;
+	}
+	else if(last_behavior == IP_ID_BEHAVIOR_SEQ_SWAP &&
+	        !is_ip_id_next(last_ip_id, new_ip_id) &&
+	        is_ip_id_next(swab16(last_ip_id), swab16(new_ip_id)))
+	{
+		behavior = IP_ID_BEHAVIOR_SEQ_SWAP;
+	}
+	else if(last_behavior == IP_ID_BEHAVIOR_ZERO &&
+	        last_ip_id == 0 && new_ip_id == 0)
+	{
+		behavior = IP_ID_BEHAVIOR_ZERO;
+	}
+	else if(is_ip_id_increasing(last_ip_id, new_ip_id))
 	{
 		behavior = IP_ID_BEHAVIOR_SEQ;
 	}
@@ -7137,6 +7259,10 @@ static bool c_tcp_feedback_2(struct rohc_comp_ctxt *const context,
 
 			/* the compressor received a positive ACK */
 			c_tcp_feedback_ack(context, sn_bits, sn_bits_nr, sn_not_valid);
+			if(!sn_not_valid)
+			{
+				rohc_comp_wlsb_feedback(context, true);
+			}
 			break;
 		}
 		case ROHC_FEEDBACK_NACK:
@@ -7149,6 +7275,8 @@ static bool c_tcp_feedback_2(struct rohc_comp_ctxt *const context,
 			{
 				rohc_comp_change_state(context, ROHC_COMP_STATE_FO);
 			}
+			/* packets are lost, the W-LSB windows shall get wider */
+			rohc_comp_wlsb_feedback(context, false);
 			/* TODO: use the SN field to determine the latest packet successfully
 			 * decompressed and then determine what fields need to be updated */
 			break;
@@ -7160,6 +7288,8 @@ static bool c_tcp_feedback_2(struct rohc_comp_ctxt *const context,
 			          "STATIC-NACK received for CID %zu", context->cid);
 			/* the compressor transits back to the IR state */
 			rohc_comp_change_state(context, ROHC_COMP_STATE_IR);
+			/* packets are lost, the W-LSB windows shall get wider */
+			rohc_comp_wlsb_feedback(context, false);
 			/* TODO: use the SN field to determine the latest packet successfully
 			 * decompressed and then determine what fields need to be updated */
 			break;
@@ -7274,12 +7404,20 @@ const struct rohc_comp_profile c_tcp_profile =
 {
 	.id             = ROHC_PROFILE_TCP, /* profile ID (see 8 in RFC 3095) */
 	.protocol       = ROHC_IPPROTO_TCP, /* IP protocol */
+	.key_type       = ROHC_COMP_KEY_FLOW, /* fields of the context key */
 	.create         = c_tcp_create,     /* profile handlers */
+	.clone          = c_tcp_clone,
 	.destroy        = c_tcp_destroy,
+	.get_body_size  = c_tcp_get_body_size,
+	.body_only      = true,
+	.get_mem        = c_tcp_get_mem,
 	.check_profile  = c_tcp_check_profile,
 	.check_context  = c_tcp_check_context,
 	.encode         = c_tcp_encode,
 	.reinit_context = rohc_comp_reinit_context,
 	.feedback       = c_tcp_feedback,
+	.set_wlsb_width = c_tcp_set_wlsb_width,
+	.snapshot       = c_tcp_snapshot,
+	.restore        = c_tcp_restore,
 };
 
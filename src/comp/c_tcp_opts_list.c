@@ -65,6 +65,12 @@ static bool c_tcp_opt_get_type_len(const uint8_t *const opts_data,
                                    uint8_t *const opt_len)
 	__attribute__((warn_unused_result, nonnull(1, 3, 4)));
 
+static bool c_tcp_opts_only_ts_changed(const struct c_tcp_opts_ctxt *const opts_ctxt,
+                                       const size_t list_trans_nr,
+                                       const uint8_t *const opts,
+                                       const size_t opts_len)
+	__attribute__((warn_unused_result, nonnull(1, 3), pure));
+
 static bool c_tcp_opt_changed(const struct c_tcp_opts_ctxt *const opts_ctxt,
                               const uint8_t opt_idx,
                               const uint8_t *const pkt_opt,
@@ -488,21 +494,17 @@ bool tcp_detect_options_changes(struct rohc_comp_ctxt *const context,
 	uint8_t opt_len;
 	size_t opts_offset;
 	size_t opts_nr = 0;
+	size_t opts_ts_offset = 0;
 	uint8_t opt_idx;
 
 	assert(opts_ctxt->structure_nr <= ROHC_TCP_OPTS_MAX);
 
 	opts_ctxt->tmp.do_list_struct_changed = false;
 	opts_ctxt->tmp.do_list_static_changed = false;
-	opts_ctxt->tmp.opt_ts_present = false;
-	opts_ctxt->tmp.nr = 0;
-	opts_ctxt->tmp.idx_max = 0;
 
 	opts = ((uint8_t *) tcp) + sizeof(struct tcphdr);
 	*opts_len = (tcp->data_offset << 2) - sizeof(struct tcphdr);
 
-	rohc_comp_debug(context, "parse %zu-byte TCP options", *opts_len);
-
 	for(opt_idx = TCP_INDEX_GENERIC7; opt_idx <= MAX_TCP_OPTION_INDEX; opt_idx++)
 	{
 		if(opts_ctxt->list[opt_idx].used)
@@ -511,6 +513,47 @@ bool tcp_detect_options_changes(struct rohc_comp_ctxt *const context,
 		}
 	}
 
+	/* bulk TCP flows use the very same TCP options in every packet, only the
+	 * values of the TCP Timestamp option change: if so, skip the parsing of
+	 * the TCP options and keep the list computed for the previous packet */
+	if(c_tcp_opts_only_ts_changed(opts_ctxt, context->compressor->list_trans_nr,
+	                              opts, *opts_len))
+	{
+		const uint8_t *const opt_ts = opts + opts_ctxt->last_opts_ts_offset;
+
+		rohc_comp_debug(context, "%zu-byte TCP options are the same as in "
+		                "previous packet, except for the TCP Timestamp values",
+		                *opts_len);
+
+		memcpy(&opts_ctxt->tmp.ts_req, opt_ts + 2, sizeof(uint32_t));
+		opts_ctxt->tmp.ts_req = rohc_ntoh32(opts_ctxt->tmp.ts_req);
+		memcpy(&opts_ctxt->tmp.ts_reply, opt_ts + 6, sizeof(uint32_t));
+		opts_ctxt->tmp.ts_reply = rohc_ntoh32(opts_ctxt->tmp.ts_reply);
+		assert(opts_ctxt->tmp.opt_ts_present);
+
+		/* options of the packet were grown old with all the others, make them
+		 * grow young again */
+		for(opt_pos = 0; opt_pos < opts_ctxt->tmp.nr; opt_pos++)
+		{
+			opt_idx = opts_ctxt->tmp.position2index[opt_pos];
+			if(opts_ctxt->list[opt_idx].age > 0)
+			{
+				opts_ctxt->list[opt_idx].age--;
+			}
+		}
+
+		opts_nr = opts_ctxt->tmp.nr;
+		assert(opts_ctxt->structure_nr == opts_nr);
+		goto decide_list_trans;
+	}
+
+	opts_ctxt->tmp.opt_ts_present = false;
+	opts_ctxt->tmp.nr = 0;
+	opts_ctxt->tmp.idx_max = 0;
+	opts_ctxt->last_opts_len = 0;
+
+	rohc_comp_debug(context, "parse %zu-byte TCP options", *opts_len);
+
 	for(opt_pos = 0, opts_offset = 0;
 	    opt_pos < ROHC_TCP_OPTS_MAX && opts_offset < (*opts_len);
 	    opt_pos++, opts_offset += opt_len)
@@ -535,6 +578,7 @@ bool tcp_detect_options_changes(struct rohc_comp_ctxt *const context,
 			memcpy(&opts_ctxt->tmp.ts_reply, opts + opts_offset + 6, sizeof(uint32_t));
 			opts_ctxt->tmp.ts_reply = rohc_ntoh32(opts_ctxt->tmp.ts_reply);
 			opts_ctxt->tmp.opt_ts_present = true;
+			opts_ts_offset = opts_offset;
 		}
 
 		/* determine the index of the TCP option */
@@ -619,6 +663,7 @@ bool tcp_detect_options_changes(struct rohc_comp_ctxt *const context,
 		opts_ctxt->tmp.do_list_struct_changed = true;
 	}
 
+decide_list_trans:
 	if(opts_ctxt->tmp.do_list_struct_changed)
 	{
 		/* the new structure has never been transmitted yet */
@@ -658,6 +703,20 @@ bool tcp_detect_options_changes(struct rohc_comp_ctxt *const context,
 		                "base header, any content changes may be transmitted "
 		                "in the irregular chain");
 		assert(opts_ctxt->structure_nr == opts_nr);
+
+		/* the contexts of the TCP options now match the TCP options of the
+		 * packet: if the options were parsed and they contain one well-formed
+		 * TCP Timestamp option, record them for the fast path of the next
+		 * packet */
+		if(opts_ctxt->last_opts_len == 0 &&
+		   opts_ctxt->tmp.opt_ts_present &&
+		   opts_ts_offset + TCP_OLEN_TS <= (*opts_len) &&
+		   opts[opts_ts_offset + 1] == TCP_OLEN_TS)
+		{
+			memcpy(opts_ctxt->last_opts, opts, *opts_len);
+			opts_ctxt->last_opts_len = *opts_len;
+			opts_ctxt->last_opts_ts_offset = opts_ts_offset;
+		}
 	}
 
 	/* use 4-bit XI or 8-bit XI ? */
@@ -1122,6 +1181,41 @@ error:
 }
 
 
+/**
+ * @brief Are the TCP options the same as in the last packet but the TS values?
+ *
+ * Compare the TCP options of the packet with the ones of the last packet in
+ * one shot, the values of the TCP Timestamp option excepted. The comparison
+ * is possible only if the TCP options of the last packet were recorded, ie.
+ * only if the contexts of the TCP options were in steady state for the last
+ * packet: no change of structure or of static option, no transmission of the
+ * list still required.
+ *
+ * @param opts_ctxt      The compression context of the TCP options
+ * @param list_trans_nr  The number of times the list shall be transmitted
+ * @param opts           The TCP options as found in the TCP packet
+ * @param opts_len       The length of the TCP options as found in the TCP packet
+ * @return               true if the TCP options changed only for the TS values,
+ *                       false if they changed in another way or if there is no
+ *                       options recorded for the last packet
+ */
+static bool c_tcp_opts_only_ts_changed(const struct c_tcp_opts_ctxt *const opts_ctxt,
+                                       const size_t list_trans_nr,
+                                       const uint8_t *const opts,
+                                       const size_t opts_len)
+{
+	const size_t ts_values_offset = opts_ctxt->last_opts_ts_offset + 2;
+	const size_t ts_values_end = opts_ctxt->last_opts_ts_offset + TCP_OLEN_TS;
+
+	return (opts_ctxt->last_opts_len > 0 &&
+	        opts_ctxt->structure_nr_trans >= list_trans_nr &&
+	        opts_ctxt->last_opts_len == opts_len &&
+	        memcmp(opts_ctxt->last_opts, opts, ts_values_offset) == 0 &&
+	        memcmp(opts_ctxt->last_opts + ts_values_end, opts + ts_values_end,
+	               opts_len - ts_values_end) == 0);
+}
+
+
 /**
  * @brief Does the TCP option changed since last packets?
  *
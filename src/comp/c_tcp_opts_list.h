@@ -118,6 +118,16 @@ struct c_tcp_opts_ctxt
 	uint8_t structure[ROHC_TCP_OPTS_MAX];
 	struct c_tcp_opt_ctxt list[MAX_TCP_OPTION_INDEX + 1];
 
+	/** The TCP options of the last packet, recorded only if they contain one
+	 *  TCP Timestamp option and if the list did not need to be transmitted:
+	 *  packets with the very same options but the TS values may then skip the
+	 *  parsing of the TCP options */
+	uint8_t last_opts[MAX_TCP_OPT_SIZE];
+	/** The length of the TCP options of the last packet, 0 if not recorded */
+	size_t last_opts_len;
+	/** The offset of the TCP Timestamp option in the last TCP options */
+	size_t last_opts_ts_offset;
+
 	bool is_timestamp_init;
 	struct c_wlsb *ts_req_wlsb;
 	struct c_wlsb *ts_reply_wlsb;
@@ -88,6 +88,21 @@ static bool c_udp_create(struct rohc_comp_ctxt *const context,
                          const struct net_pkt *const packet)
 	__attribute__((warn_unused_result, nonnull(1, 2)));
 
+static size_t c_udp_get_body_size(const struct rohc_comp *const comp)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+static bool c_udp_restore(struct rohc_comp_ctxt *const context,
+                          const rohc_snapshot_read_t read_cb,
+                          void *const priv)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
+static void c_udp_init_handlers(struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt)
+	__attribute__((nonnull(1)));
+
+static void c_udp_get_mem(const struct rohc_comp_ctxt *const context,
+                          struct rohc_ctxt_mem *const mem)
+	__attribute__((nonnull(1, 2)));
+
 static void udp_decide_state(struct rohc_comp_ctxt *const context);
 
 static int c_udp_encode(struct rohc_comp_ctxt *const context,
@@ -145,15 +160,9 @@ static bool c_udp_create(struct rohc_comp_ctxt *const context,
 	assert(packet->transport->data != NULL);
 	udp = (struct udphdr *) packet->transport->data;
 
-	/* create the UDP part of the profile context */
-	udp_context = malloc(sizeof(struct sc_udp_context));
-	if(udp_context == NULL)
-	{
-		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
-		           "no memory for the UDP part of the profile context");
-		goto clean;
-	}
-	rfc3095_ctxt->specific = udp_context;
+	/* the UDP part of the profile context follows the generic part in
+	 * the body of the context */
+	udp_context = rfc3095_ctxt->specific;
 
 	/* initialize the UDP part of the profile context */
 	udp_context->udp_checksum_change_count = 0;
@@ -164,6 +173,46 @@ static bool c_udp_create(struct rohc_comp_ctxt *const context,
 
 	/* init the UDP-specific variables and functions */
 	rfc3095_ctxt->next_header_len = sizeof(struct udphdr);
+	rfc3095_ctxt->is_SO_decision_cacheable = true;
+	c_udp_init_handlers(rfc3095_ctxt);
+
+	return true;
+
+quit:
+	return false;
+}
+
+
+/**
+ * @brief Restore one UDP context from a snapshot
+ *
+ * @param context  The compression context
+ * @param read_cb  The callback used to read the snapshot
+ * @param priv     The private context given to the callback
+ * @return         true if the context was successfully restored,
+ *                 false if the snapshot does not match the context
+ */
+static bool c_udp_restore(struct rohc_comp_ctxt *const context,
+                          const rohc_snapshot_read_t read_cb,
+                          void *const priv)
+{
+	if(!rohc_comp_rfc3095_restore(context, read_cb, priv))
+	{
+		return false;
+	}
+	c_udp_init_handlers(context->specific);
+
+	return true;
+}
+
+
+/**
+ * @brief Set the UDP-specific handlers of one context
+ *
+ * @param rfc3095_ctxt  The generic part of the context
+ */
+static void c_udp_init_handlers(struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt)
+{
 	rfc3095_ctxt->decide_state = udp_decide_state;
 	rfc3095_ctxt->decide_FO_packet = c_ip_decide_FO_packet;
 	rfc3095_ctxt->decide_SO_packet = c_ip_decide_SO_packet;
@@ -177,13 +226,37 @@ static bool c_udp_create(struct rohc_comp_ctxt *const context,
 	rfc3095_ctxt->code_uo_remainder = udp_code_uo_remainder;
 	rfc3095_ctxt->compute_crc_static = udp_compute_crc_static;
 	rfc3095_ctxt->compute_crc_dynamic = udp_compute_crc_dynamic;
+}
 
-	return true;
 
-clean:
-	rohc_comp_rfc3095_destroy(context);
-quit:
-	return false;
+/**
+ * @brief Get the size of the body of one UDP context
+ *
+ * The body holds the generic part of the context followed by the
+ * UDP part.
+ *
+ * @param comp  The ROHC compressor
+ * @return      The size of the body of one UDP context
+ */
+static size_t c_udp_get_body_size(const struct rohc_comp *const comp)
+{
+	return (rohc_comp_rfc3095_get_body_size(comp) + sizeof(struct sc_udp_context));
+}
+
+
+/**
+ * @brief Get the memory used by one UDP context
+ *
+ * @param context   The compression context
+ * @param[out] mem  The memory used by the profile-specific part of the context
+ */
+static void c_udp_get_mem(const struct rohc_comp_ctxt *const context,
+                          struct rohc_ctxt_mem *const mem)
+{
+	rohc_comp_rfc3095_get_mem(context, mem);
+
+	/* the UDP-specific part of the context */
+	mem->bytes += sizeof(struct sc_udp_context);
 }
 
 
@@ -289,6 +362,12 @@ bool c_udp_check_context(const struct rohc_comp_ctxt *const context,
 		(struct sc_udp_context *) rfc3095_ctxt->specific;
 	const struct udphdr *const udp = (struct udphdr *) packet->transport->data;
 
+	/* the flow that created the context is recognized at once */
+	if(net_pkt_flow_is_same(&context->flow, &packet->flow))
+	{
+		return true;
+	}
+
 	/* first, check the same parameters as for the IP-only profile */
 	if(!c_ip_check_context(context, packet))
 	{
@@ -579,12 +658,19 @@ const struct rohc_comp_profile c_udp_profile =
 {
 	.id             = ROHC_PROFILE_UDP, /* profile ID (see 8 in RFC 3095) */
 	.protocol       = ROHC_IPPROTO_UDP, /* IP protocol */
+	.key_type       = ROHC_COMP_KEY_FLOW, /* fields of the context key */
 	.create         = c_udp_create,     /* profile handlers */
 	.destroy        = rohc_comp_rfc3095_destroy,
+	.get_body_size  = c_udp_get_body_size,
+	.body_only      = true,
+	.get_mem        = c_udp_get_mem,
 	.check_profile  = c_udp_check_profile,
 	.check_context  = c_udp_check_context,
 	.encode         = c_udp_encode,
 	.reinit_context = rohc_comp_reinit_context,
 	.feedback       = rohc_comp_rfc3095_feedback,
+	.set_wlsb_width = rohc_comp_rfc3095_set_wlsb_width,
+	.snapshot       = rohc_comp_rfc3095_snapshot,
+	.restore        = c_udp_restore,
 };
 
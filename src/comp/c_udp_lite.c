@@ -59,6 +59,9 @@ struct udp_lite_tmp_vars
 {
 	/// The size of the UDP-Lite packet (header + payload)
 	int udp_size;
+	/// Whether the CCE packet is sent for the packet or not, -1 if the
+	/// packet head was not built yet
+	int send_cce;
 };
 
 
@@ -112,6 +115,21 @@ static bool c_udp_lite_create(struct rohc_comp_ctxt *const context,
                               const struct net_pkt *const packet)
 	__attribute__((warn_unused_result, nonnull(1, 2)));
 
+static size_t c_udp_lite_get_body_size(const struct rohc_comp *const comp)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+static bool c_udp_lite_restore(struct rohc_comp_ctxt *const context,
+                               const rohc_snapshot_read_t read_cb,
+                               void *const priv)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
+static void c_udp_lite_init_handlers(struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt)
+	__attribute__((nonnull(1)));
+
+static void c_udp_lite_get_mem(const struct rohc_comp_ctxt *const context,
+                               struct rohc_ctxt_mem *const mem)
+	__attribute__((nonnull(1, 2)));
+
 static bool c_udp_lite_check_profile(const struct rohc_comp *const comp,
                                      const struct net_pkt *const packet)
 	__attribute__((warn_unused_result, nonnull(1, 2)));
@@ -193,15 +211,9 @@ static bool c_udp_lite_create(struct rohc_comp_ctxt *const context,
 	assert(packet->transport->data != NULL);
 	udp_lite = (struct udphdr *) packet->transport->data;
 
-	/* create the UDP-Lite part of the profile context */
-	udp_lite_context = malloc(sizeof(struct sc_udp_lite_context));
-	if(udp_lite_context == NULL)
-	{
-		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
-		           "no memory for the UDP-Lite part of the profile context");
-		goto clean;
-	}
-	rfc3095_ctxt->specific = udp_lite_context;
+	/* the UDP-Lite part of the profile context follows the generic part in
+	 * the body of the context */
+	udp_lite_context = rfc3095_ctxt->specific;
 
 	/* initialize the UDP-Lite part of the profile context */
 	udp_lite_context->cfp = 0;
@@ -216,9 +228,50 @@ static bool c_udp_lite_create(struct rohc_comp_ctxt *const context,
 
 	/* init the UDP-Lite-specific temporary variables */
 	udp_lite_context->tmp.udp_size = -1;
+	udp_lite_context->tmp.send_cce = -1;
 
 	/* init the UDP-Lite-specific variables and functions */
 	rfc3095_ctxt->next_header_len = sizeof(struct udphdr);
+	rfc3095_ctxt->is_SO_decision_cacheable = true;
+	c_udp_lite_init_handlers(rfc3095_ctxt);
+
+	return true;
+
+quit:
+	return false;
+}
+
+
+/**
+ * @brief Restore one UDP-Lite context from a snapshot
+ *
+ * @param context  The compression context
+ * @param read_cb  The callback used to read the snapshot
+ * @param priv     The private context given to the callback
+ * @return         true if the context was successfully restored,
+ *                 false if the snapshot does not match the context
+ */
+static bool c_udp_lite_restore(struct rohc_comp_ctxt *const context,
+                               const rohc_snapshot_read_t read_cb,
+                               void *const priv)
+{
+	if(!rohc_comp_rfc3095_restore(context, read_cb, priv))
+	{
+		return false;
+	}
+	c_udp_lite_init_handlers(context->specific);
+
+	return true;
+}
+
+
+/**
+ * @brief Set the UDP-Lite-specific handlers of one context
+ *
+ * @param rfc3095_ctxt  The generic part of the context
+ */
+static void c_udp_lite_init_handlers(struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt)
+{
 	rfc3095_ctxt->decide_state = rohc_comp_rfc3095_decide_state;
 	rfc3095_ctxt->decide_FO_packet = c_ip_decide_FO_packet;
 	rfc3095_ctxt->decide_SO_packet = c_ip_decide_SO_packet;
@@ -232,13 +285,37 @@ static bool c_udp_lite_create(struct rohc_comp_ctxt *const context,
 	rfc3095_ctxt->code_uo_remainder = udp_lite_code_uo_remainder;
 	rfc3095_ctxt->compute_crc_static = udp_compute_crc_static;
 	rfc3095_ctxt->compute_crc_dynamic = udp_compute_crc_dynamic;
+}
 
-	return true;
 
-clean:
-	rohc_comp_rfc3095_destroy(context);
-quit:
-	return false;
+/**
+ * @brief Get the size of the body of one UDP-Lite context
+ *
+ * The body holds the generic part of the context followed by the
+ * UDP-Lite part.
+ *
+ * @param comp  The ROHC compressor
+ * @return      The size of the body of one UDP-Lite context
+ */
+static size_t c_udp_lite_get_body_size(const struct rohc_comp *const comp)
+{
+	return (rohc_comp_rfc3095_get_body_size(comp) + sizeof(struct sc_udp_lite_context));
+}
+
+
+/**
+ * @brief Get the memory used by one UDP-Lite context
+ *
+ * @param context   The compression context
+ * @param[out] mem  The memory used by the profile-specific part of the context
+ */
+static void c_udp_lite_get_mem(const struct rohc_comp_ctxt *const context,
+                               struct rohc_ctxt_mem *const mem)
+{
+	rohc_comp_rfc3095_get_mem(context, mem);
+
+	/* the UDP-Lite-specific part of the context */
+	mem->bytes += sizeof(struct sc_udp_lite_context);
 }
 
 
@@ -334,6 +411,12 @@ static bool c_udp_lite_check_context(const struct rohc_comp_ctxt *const context,
 	(struct sc_udp_lite_context *) rfc3095_ctxt->specific;
 	const struct udphdr *const udp_lite = (struct udphdr *) packet->transport->data;
 
+	/* the flow that created the context is recognized at once */
+	if(net_pkt_flow_is_same(&context->flow, &packet->flow))
+	{
+		return true;
+	}
+
 	/* first, check the same parameters as for the IP-only profile */
 	if(!c_ip_check_context(context, packet))
 	{
@@ -389,6 +472,7 @@ static int c_udp_lite_encode(struct rohc_comp_ctxt *const context,
 	assert(uncomp_pkt->transport->data != NULL);
 	udp_lite = (struct udphdr *) uncomp_pkt->transport->data;
 	udp_lite_context->tmp.udp_size = uncomp_pkt->transport->len;
+	udp_lite_context->tmp.send_cce = -1;
 
 	/* encode the IP packet */
 	size = rohc_comp_rfc3095_encode(context, uncomp_pkt, rohc_pkt, rohc_pkt_max_len,
@@ -467,8 +551,10 @@ static size_t udp_lite_build_cce_packet(const struct rohc_comp_ctxt *const conte
 	udp_lite_context = (struct sc_udp_lite_context *) rfc3095_ctxt->specific;
 
 
-	/* do we need to add the CCE packet? */
+	/* do we need to add the CCE packet? the decision is kept for the UO
+	 * remainder of the same packet */
 	send_cce_packet = udp_lite_send_cce_packet(context, udp_lite);
+	udp_lite_context->tmp.send_cce = send_cce_packet;
 	if(send_cce_packet)
 	{
 		rohc_comp_debug(context, "adding CCE");
@@ -526,9 +612,12 @@ static size_t udp_lite_code_uo_remainder(const struct rohc_comp_ctxt *const cont
 	rfc3095_ctxt = (struct rohc_comp_rfc3095_ctxt *) context->specific;
 	udp_lite_context = (struct sc_udp_lite_context *) rfc3095_ctxt->specific;
 
-	/* part 1 */
+	/* part 1: the coverage decided along with the packet head is not
+	 * decided again */
 	if(udp_lite_context->cfp == 1 ||
-	   udp_lite_send_cce_packet(context, udp_lite))
+	   (udp_lite_context->tmp.send_cce < 0 ?
+	    udp_lite_send_cce_packet(context, udp_lite) :
+	    udp_lite_context->tmp.send_cce == 1))
 	{
 		rohc_comp_debug(context, "UDP-Lite checksum coverage = 0x%04x",
 		                rohc_ntoh16(udp_lite->len));
@@ -830,12 +919,19 @@ const struct rohc_comp_profile c_udp_lite_profile =
 {
 	.id             = ROHC_PROFILE_UDPLITE, /* profile ID (see 7 in RFC4019) */
 	.protocol       = ROHC_IPPROTO_UDPLITE, /* IP protocol */
+	.key_type       = ROHC_COMP_KEY_FLOW,   /* fields of the context key */
 	.create         = c_udp_lite_create,    /* profile handlers */
 	.destroy        = rohc_comp_rfc3095_destroy,
+	.get_body_size  = c_udp_lite_get_body_size,
+	.body_only      = true,
+	.get_mem        = c_udp_lite_get_mem,
 	.check_profile  = c_udp_lite_check_profile,
 	.check_context  = c_udp_lite_check_context,
 	.encode         = c_udp_lite_encode,
 	.reinit_context = rohc_comp_reinit_context,
 	.feedback       = rohc_comp_rfc3095_feedback,
+	.set_wlsb_width = rohc_comp_rfc3095_set_wlsb_width,
+	.snapshot       = rohc_comp_rfc3095_snapshot,
+	.restore        = c_udp_lite_restore,
 };
 
@@ -48,6 +48,16 @@ static bool c_uncompressed_check_profile(const struct rohc_comp *const comp,
                                          const struct net_pkt *const packet)
 	__attribute__((warn_unused_result, nonnull(1, 2)));
 
+/* save/restore context */
+static bool c_uncompressed_snapshot(const struct rohc_comp_ctxt *const context,
+                                    const rohc_snapshot_write_t write_cb,
+                                    void *const priv)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static bool c_uncompressed_restore(struct rohc_comp_ctxt *const context,
+                                   const rohc_snapshot_read_t read_cb,
+                                   void *const priv)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
 /* check whether a packet belongs to a context */
 static bool c_uncompressed_check_context(const struct rohc_comp_ctxt *const context,
                                          const struct net_pkt *const packet)
@@ -143,6 +153,42 @@ static void c_uncompressed_destroy(struct rohc_comp_ctxt *const context)
 }
 
 
+/**
+ * @brief Save the Uncompressed context in a snapshot
+ *
+ * The Uncompressed profile keeps no profile-specific data, so nothing but
+ * the generic part of the context is saved.
+ *
+ * @param context   The compression context
+ * @param write_cb  The callback used to write the snapshot
+ * @param priv      The private context given to the callback
+ * @return          Always true
+ */
+static bool c_uncompressed_snapshot(const struct rohc_comp_ctxt *const context __attribute__((unused)),
+                                    const rohc_snapshot_write_t write_cb __attribute__((unused)),
+                                    void *const priv __attribute__((unused)))
+{
+	return true;
+}
+
+
+/**
+ * @brief Restore the Uncompressed context from a snapshot
+ *
+ * @param context  The compression context
+ * @param read_cb  The callback used to read the snapshot
+ * @param priv     The private context given to the callback
+ * @return         Always true
+ */
+static bool c_uncompressed_restore(struct rohc_comp_ctxt *const context,
+                                   const rohc_snapshot_read_t read_cb __attribute__((unused)),
+                                   void *const priv __attribute__((unused)))
+{
+	context->specific = NULL;
+	return true;
+}
+
+
 /**
  * @brief Check if the given packet corresponds to the Uncompressed profile
  *
@@ -214,12 +260,19 @@ static int c_uncompressed_encode(struct rohc_comp_ctxt *const context,
 	int size;
 
 	/* STEP 1: decide state */
+	rohc_cycles_begin(&context->compressor->stage_cycles,
+	                  ROHC_COMP_STAGE_CHANGES);
 	uncompressed_decide_state(context, ip_get_version(&uncomp_pkt->outer_ip));
+	rohc_cycles_end(&context->compressor->stage_cycles, ROHC_COMP_STAGE_CHANGES);
 
 	/* STEP 2: Code packet */
+	rohc_cycles_begin(&context->compressor->stage_cycles,
+	                  ROHC_COMP_STAGE_BUILD_HDR);
 	size = uncompressed_code_packet(context, uncomp_pkt,
 	                                rohc_pkt, rohc_pkt_max_len,
 	                                packet_type, payload_offset);
+	rohc_cycles_end(&context->compressor->stage_cycles,
+	                ROHC_COMP_STAGE_BUILD_HDR);
 
 	return size;
 }
@@ -470,8 +523,8 @@ static int uncompressed_code_IR_packet(const struct rohc_comp_ctxt *context,
 	 *  - part 2 will be placed at 'first_position'
 	 *  - part 4 will start at 'counter'
 	 */
-	ret = code_cid_values(context->compressor->medium.cid_type, context->cid,
-	                      rohc_pkt, rohc_pkt_max_len, &first_position);
+	ret = context->compressor->code_cid_values(context->cid, rohc_pkt,
+	                                           rohc_pkt_max_len, &first_position);
 	if(ret < 1)
 	{
 		rohc_comp_warn(context, "failed to encode %s CID %zu: maybe the "
@@ -504,9 +557,11 @@ static int uncompressed_code_IR_packet(const struct rohc_comp_ctxt *context,
 
 	/* part 5 */
 	rohc_pkt[counter] = 0;
+	rohc_cycles_crc_begin(&context->compressor->stage_cycles);
 	rohc_pkt[counter] = crc_calculate(ROHC_CRC_TYPE_8, rohc_pkt, counter,
 	                                  CRC_INIT_8,
-	                                  context->compressor->crc_table_8);
+	                                  rohc_crc_table_8);
+	rohc_cycles_crc_end(&context->compressor->stage_cycles, ROHC_COMP_STAGE_CRC);
 	rohc_comp_debug(context, "CRC on %zu bytes = 0x%02x", counter,
 	                rohc_pkt[counter]);
 	counter++;
@@ -570,8 +625,8 @@ static int uncompressed_code_normal_packet(const struct rohc_comp_ctxt *context,
 	 *  - part 2 will be placed at 'first_position'
 	 *  - part 4 will start at 'counter'
 	 */
-	ret = code_cid_values(context->compressor->medium.cid_type, context->cid,
-	                      rohc_pkt, rohc_pkt_max_len, &first_position);
+	ret = context->compressor->code_cid_values(context->cid, rohc_pkt,
+	                                           rohc_pkt_max_len, &first_position);
 	if(ret < 1)
 	{
 		rohc_comp_warn(context, "failed to encode %s CID %zu: maybe the "
@@ -607,12 +662,16 @@ const struct rohc_comp_profile c_uncompressed_profile =
 {
 	.id             = ROHC_PROFILE_UNCOMPRESSED, /* profile ID (RFC3095, §8) */
 	.protocol       = 0,                         /* IP protocol */
+	.key_type       = ROHC_COMP_KEY_HOSTS,       /* fields of the context key */
 	.create         = c_uncompressed_create,     /* profile handlers */
 	.destroy        = c_uncompressed_destroy,
+	.body_only      = true,
 	.check_profile  = c_uncompressed_check_profile,
 	.check_context  = c_uncompressed_check_context,
 	.encode         = c_uncompressed_encode,
 	.reinit_context = c_uncompressed_reinit_context,
 	.feedback       = uncomp_feedback,
+	.snapshot       = c_uncompressed_snapshot,
+	.restore        = c_uncompressed_restore,
 };
 
@@ -45,6 +45,7 @@
 #include "rohc_traces.h"
 #include "rohc_traces_internal.h"
 #include "rohc_time_internal.h"
+#include "rohc_probes.h"
 #include "rohc_debug.h"
 #include "rohc_utils.h"
 #include "sdvl.h"
@@ -52,7 +53,10 @@
 #include "rohc_bit_ops.h"
 #include "ip.h"
 #include "crc.h"
+#include "rohc_cpu.h"
 #include "protocols/udp.h"
+#include "protocols/esp.h"
+#include "protocols/rtp.h"
 #include "protocols/ip_numbers.h"
 #include "feedback_parse.h"
 
@@ -84,19 +88,57 @@ extern const struct rohc_comp_profile c_rtp_profile,
  *
  * The order of profiles declaration is important: they are evaluated in that
  * order. The RTP profile shall be declared before the UDP one for example.
+ *
+ * Only the profiles built in the library are declared, see the
+ * --disable-profile-* options of the configure script.
  */
 static const struct rohc_comp_profile *const rohc_comp_profiles[C_NUM_PROFILES] =
 {
+#if ROHC_WITH_PROFILE_RTP == 1
 	&c_rtp_profile,
+#endif
+#if ROHC_WITH_PROFILE_UDP == 1
 	&c_udp_profile,  /* must be declared after RTP profile */
+#endif
+#if ROHC_WITH_PROFILE_UDPLITE == 1
 	&c_udp_lite_profile,
+#endif
+#if ROHC_WITH_PROFILE_ESP == 1
 	&c_esp_profile,
+#endif
+#if ROHC_WITH_PROFILE_TCP == 1
 	&c_tcp_profile,
+#endif
+#if ROHC_WITH_PROFILE_IP == 1
 	&c_ip_profile,  /* must be declared after all IP-based profiles */
+#endif
+#if ROHC_WITH_PROFILE_UNCOMPRESSED == 1
 	&c_uncompressed_profile, /* must be declared last */
+#endif
 };
 
 
+/** The cold context being revived */
+struct c_cold_cursor
+{
+	const struct rohc_comp_cold_ctxt *cold; /**< The cold context */
+	size_t pos;                             /**< The number of bytes already read */
+};
+
+
+/*
+ * Prototypes of private functions related to ROHC compressors
+ */
+
+static struct rohc_comp *
+	rohc_comp_new_on_node(const rohc_cid_type_t cid_type,
+	                      const rohc_cid_t max_cid,
+	                      const rohc_comp_random_cb_t rand_cb,
+	                      void *const rand_priv,
+	                      const int numa_node)
+	__attribute__((warn_unused_result));
+
+
 /*
  * Prototypes of private functions related to ROHC compression profiles
  */
@@ -106,10 +148,48 @@ static const struct rohc_comp_profile *
 	                         const rohc_profile_t profile_id)
 	__attribute__((warn_unused_result, nonnull(1)));
 
+static bool c_is_uncompressible(const struct net_pkt *const packet)
+	__attribute__((warn_unused_result, nonnull(1), pure));
 static const struct rohc_comp_profile *
-	c_get_profile_from_packet(const struct rohc_comp *const comp,
+	c_get_profile_from_packet(struct rohc_comp *const comp,
 	                          const struct net_pkt *const packet)
 	__attribute__((warn_unused_result, nonnull(1, 2)));
+static void c_profile_cache_del(struct rohc_comp *const comp,
+                                const struct rohc_comp_ctxt *const context)
+	__attribute__((nonnull(1, 2)));
+static void c_profile_cache_flush(struct rohc_comp *const comp)
+	__attribute__((nonnull(1)));
+static bool c_profile_alloc_allowed(const struct rohc_comp *const comp,
+                                    const struct rohc_comp_profile *const profile)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static bool c_profile_failed(const struct rohc_comp *const comp,
+                             const struct net_pkt *const packet,
+                             const struct rohc_ts now)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static void c_profile_failure_add(struct rohc_comp *const comp,
+                                  const struct net_pkt *const packet,
+                                  const struct rohc_ts now)
+	__attribute__((nonnull(1, 2)));
+static bool c_rtp_detect_alloc(struct rohc_comp *const comp)
+	__attribute__((warn_unused_result, nonnull(1)));
+static bool c_rtp_on_probation(const struct rohc_comp *const comp,
+                               const struct net_pkt *const packet)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static bool c_prealloc_ctxts(struct rohc_comp *const comp,
+                             const size_t profile_idx)
+	__attribute__((warn_unused_result, nonnull(1)));
+static bool c_prealloc_all_ctxts(struct rohc_comp *const comp)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+
+/*
+ * Prototypes of private functions related to shared configurations
+ */
+
+static bool rohc_comp_config_is_frozen(const struct rohc_comp_config *const config)
+	__attribute__((nonnull(1), warn_unused_result));
+static void rohc_comp_config_put(struct rohc_comp_config *const config)
+	__attribute__((nonnull(1)));
 
 
 /*
@@ -125,17 +205,181 @@ static struct rohc_comp_ctxt *
 	c_create_context(struct rohc_comp *const comp,
 	                 const struct rohc_comp_profile *const profile,
 	                 const struct net_pkt *const packet,
+	                 const rohc_cid_t cid,
 	                 const struct rohc_ts arrival_time)
 	__attribute__((nonnull(1, 2, 3), warn_unused_result));
+static const struct rohc_comp_ctxt *
+	c_find_clone_src(const struct rohc_comp *const comp,
+	                 const struct rohc_comp_profile *const profile,
+	                 const struct net_pkt *const packet)
+	__attribute__((nonnull(1, 2, 3), warn_unused_result));
 static struct rohc_comp_ctxt *
 	rohc_comp_find_ctxt(struct rohc_comp *const comp,
 	                    const struct net_pkt *const packet,
 	                    const int profile_id_hint,
 	                    const struct rohc_ts arrival_time)
 	__attribute__((nonnull(1, 2), warn_unused_result));
+static struct rohc_comp_ctxt *
+	rohc_comp_get_steered_ctxt(struct rohc_comp *const comp,
+	                           const struct net_pkt *const packet,
+	                           const rohc_cid_t cid,
+	                           const int profile_id_hint,
+	                           const struct rohc_ts arrival_time)
+	__attribute__((nonnull(1, 2), warn_unused_result));
 static struct rohc_comp_ctxt *
 	c_get_context(struct rohc_comp *const comp, const rohc_cid_t cid)
 	__attribute__((nonnull(1), warn_unused_result));
+static void c_release_context(struct rohc_comp *const comp,
+                              struct rohc_comp_ctxt *const context)
+	__attribute__((nonnull(1, 2)));
+static void c_detach_context(struct rohc_comp *const comp,
+                             struct rohc_comp_ctxt *const context)
+	__attribute__((nonnull(1, 2)));
+static void c_attach_context(struct rohc_comp *const comp,
+                             struct rohc_comp_ctxt *const context)
+	__attribute__((nonnull(1, 2)));
+static void c_take_free_cid(struct rohc_comp *const comp,
+                            const rohc_cid_t cid_idx)
+	__attribute__((nonnull(1)));
+
+static rohc_ctxt_key_t c_ctxt_key(const struct rohc_comp_profile *const profile,
+                                  const struct net_pkt *const packet)
+	__attribute__((warn_unused_result, nonnull(1, 2), pure));
+static size_t c_ctxt_index_hash(const struct rohc_comp *const comp,
+                                const rohc_profile_t profile_id,
+                                const rohc_ctxt_key_t key)
+	__attribute__((warn_unused_result, nonnull(1), pure));
+static void c_ctxt_index_add(struct rohc_comp *const comp,
+                             const struct rohc_comp_ctxt *const context)
+	__attribute__((nonnull(1, 2)));
+static void c_ctxt_index_del(struct rohc_comp *const comp,
+                             const struct rohc_comp_ctxt *const context)
+	__attribute__((nonnull(1, 2)));
+static void c_ctxt_lru_add(struct rohc_comp *const comp,
+                           struct rohc_comp_ctxt *const context)
+	__attribute__((nonnull(1, 2)));
+static void c_ctxt_lru_del(struct rohc_comp *const comp,
+                           struct rohc_comp_ctxt *const context)
+	__attribute__((nonnull(1, 2)));
+static void c_ctxt_expire_idle(struct rohc_comp *const comp,
+                               const struct rohc_ts now)
+	__attribute__((nonnull(1)));
+static bool c_cold_save(struct rohc_comp *const comp,
+                        struct rohc_comp_ctxt *const context)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static struct rohc_comp_ctxt *
+	c_cold_revive(struct rohc_comp *const comp,
+	              const struct rohc_comp_profile *const profile,
+	              const struct net_pkt *const packet)
+	__attribute__((nonnull(1, 2, 3), warn_unused_result));
+static void c_cold_drop(struct rohc_comp *const comp,
+                        struct rohc_comp_cold_ctxt *const cold)
+	__attribute__((nonnull(1, 2)));
+static void c_cold_flush(struct rohc_comp *const comp)
+	__attribute__((nonnull(1)));
+static bool c_cold_write(void *const priv,
+                         const uint8_t *const data,
+                         const size_t len)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static bool c_cold_read(void *const priv,
+                        uint8_t *const data,
+                        const size_t len)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static bool c_snapshot_ctxt(const struct rohc_comp_ctxt *const context,
+                            const rohc_snapshot_write_t write_cb,
+                            void *const priv)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static struct rohc_comp_ctxt *
+	c_restore_ctxt(struct rohc_comp *const comp,
+	               const struct rohc_comp_profile *const profile,
+	               const struct rohc_comp_snapshot_ctxt *const record,
+	               const rohc_snapshot_read_t read_cb,
+	               void *const priv)
+	__attribute__((nonnull(1, 2, 3, 4), warn_unused_result));
+static void c_ctxt_mem_add(struct rohc_comp *const comp,
+                           struct rohc_comp_ctxt *const context)
+	__attribute__((nonnull(1, 2)));
+static void c_ctxt_mem_del(struct rohc_comp *const comp,
+                           const struct rohc_comp_ctxt *const context)
+	__attribute__((nonnull(1, 2)));
+
+static void rohc_comp_reinit_next_ctxts(struct rohc_comp *const comp)
+	__attribute__((nonnull(1)));
+
+static void c_ctxt_periodic_counts(const struct rohc_comp_ctxt *const context,
+                                   size_t *const go_back_fo_count,
+                                   size_t *const go_back_ir_count)
+	__attribute__((nonnull(1, 2, 3)));
+static void c_ctxt_periodic_sync(struct rohc_comp_ctxt *const context)
+	__attribute__((nonnull(1)));
+static void c_ctxt_periodic_arm(struct rohc_comp_ctxt *const context)
+	__attribute__((nonnull(1)));
+static void c_ctxt_set_wlsb_width(struct rohc_comp_ctxt *const context,
+                                  const size_t width)
+	__attribute__((nonnull(1)));
+
+
+/*
+ * Prototypes of private functions related to ROHC compression
+ */
+
+static rohc_status_t __rohc_compress(struct rohc_comp *const comp,
+                                     const struct rohc_buf uncomp_iov[],
+                                     const size_t uncomp_iov_nr,
+                                     const rohc_cid_t cid,
+                                     struct rohc_buf *const rohc_packet)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
+static bool rohc_comp_hdrs_in_first_buf(struct rohc_comp *const comp,
+                                        const struct rohc_buf first_buf,
+                                        const size_t pkt_len)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+static struct rohc_comp_ctxt *
+	rohc_comp_encode_hdr(struct rohc_comp *const comp,
+	                     const struct rohc_buf uncomp_packet,
+	                     const rohc_cid_t cid,
+	                     struct net_pkt *const ip_pkt,
+	                     uint8_t *const rohc_hdr,
+	                     const size_t rohc_hdr_max_len,
+	                     rohc_packet_t *const packet_type,
+	                     int *const rohc_hdr_size,
+	                     size_t *const payload_offset)
+	__attribute__((warn_unused_result, nonnull(1, 4, 5, 7, 8, 9)));
+
+static void rohc_comp_update_stats(struct rohc_comp *const comp,
+                                   struct rohc_comp_ctxt *const context,
+                                   const rohc_packet_t packet_type,
+                                   const size_t uncomp_len,
+                                   const size_t rohc_len,
+                                   const size_t uncomp_hdr_len,
+                                   const size_t rohc_hdr_len)
+	__attribute__((nonnull(1, 2)));
+
+static void rohc_comp_copy_payload(uint8_t *const dst,
+                                   const struct rohc_buf uncomp_iov[],
+                                   const size_t uncomp_iov_nr,
+                                   size_t offset,
+                                   size_t len)
+	__attribute__((nonnull(1, 2)));
+static bool rohc_comp_rru_add_payload(struct rohc_comp_rru *const rru,
+                                      const struct rohc_buf uncomp_iov[],
+                                      const size_t uncomp_iov_nr,
+                                      size_t offset,
+                                      size_t len)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static struct rohc_comp_rru_piece rohc_comp_rru_pull(struct rohc_comp *const comp,
+                                                     const size_t max_len)
+	__attribute__((warn_unused_result, nonnull(1)));
+static void rohc_comp_rru_move(const struct rohc_comp *const comp,
+                               struct rohc_comp_rru *const rru,
+                               uint8_t *const new_data)
+	__attribute__((nonnull(1, 2, 3)));
+static void rohc_comp_rru_assign(struct rohc_comp *const comp,
+                                 uint8_t *const rru,
+                                 const size_t mrru,
+                                 const size_t slots_nr)
+	__attribute__((nonnull(1)));
 
 
 /*
@@ -146,6 +390,22 @@ static bool __rohc_comp_deliver_feedback(struct rohc_comp *const comp,
                                          const uint8_t *const packet,
                                          const size_t size)
 	__attribute__((warn_unused_result, nonnull(1, 2)));
+static bool rohc_comp_deliver_feedback_ctxt(struct rohc_comp *const comp,
+                                            struct rohc_comp_ctxt *const context,
+                                            const uint8_t *const packet,
+                                            const size_t size,
+                                            const size_t cid_len)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+
+static void rohc_comp_drain_feedback_queue(struct rohc_comp *const comp)
+	__attribute__((nonnull(1)));
+
+static void rohc_comp_record(struct rohc_comp *const comp,
+                             const enum rohc_record_event_type type,
+                             const struct rohc_buf input[],
+                             const size_t input_nr,
+                             const uint32_t cid)
+	__attribute__((nonnull(1, 3)));
 
 static bool rohc_comp_feedback_parse_cid(const struct rohc_comp *const comp,
                                          const uint8_t *const feedback,
@@ -233,7 +493,32 @@ struct rohc_comp * rohc_comp_new2(const rohc_cid_type_t cid_type,
                                   const rohc_comp_random_cb_t rand_cb,
                                   void *const rand_priv)
 {
-	const size_t wlsb_width = 4; /* default window width for W-LSB encoding */
+	return rohc_comp_new_on_node(cid_type, max_cid, rand_cb, rand_priv,
+	                             ROHC_NUMA_NO_NODE);
+}
+
+
+/**
+ * @brief Create a new ROHC compressor on the given NUMA node
+ *
+ * The compressor, its arrays of contexts and the bodies of its contexts are
+ * allocated on the given NUMA node.
+ *
+ * @param cid_type   The type of Context IDs (CID) that the compressor uses
+ * @param max_cid    The maximum value that the compressor uses for CIDs
+ * @param rand_cb    The random callback to set
+ * @param rand_priv  Private data that will be given to the callback
+ * @param numa_node  The NUMA node, \ref ROHC_NUMA_NO_NODE for any node
+ * @return           The created compressor if successful,
+ *                   NULL if creation failed
+ */
+static struct rohc_comp *
+	rohc_comp_new_on_node(const rohc_cid_type_t cid_type,
+	                      const rohc_cid_t max_cid,
+	                      const rohc_comp_random_cb_t rand_cb,
+	                      void *const rand_priv,
+	                      const int numa_node)
+{
 	struct rohc_comp *comp;
 	bool is_fine;
 	size_t i;
@@ -265,34 +550,56 @@ struct rohc_comp * rohc_comp_new2(const rohc_cid_type_t cid_type,
 		return NULL;
 	}
 
+	/* select the best implementations of the hot kernels for the CPU */
+	rohc_cpu_init();
+
 	/* allocate memory for the ROHC compressor */
-	comp = malloc(sizeof(struct rohc_comp));
+	comp = rohc_alloc_calloc_node(1, sizeof(struct rohc_comp), numa_node);
 	if(comp == NULL)
 	{
 		goto error;
 	}
-	memset(comp, 0, sizeof(struct rohc_comp));
 
+	comp->numa_node = numa_node;
 	comp->medium.cid_type = cid_type;
 	comp->medium.max_cid = max_cid;
+	if(cid_type == ROHC_SMALL_CID)
+	{
+		comp->code_cid_values = code_small_cid_values;
+	}
+	else
+	{
+		comp->code_cid_values = code_large_cid_values;
+	}
 	comp->mrru = 0; /* no segmentation by default */
+	comp->rru = NULL;
+	comp->rru_slots_nr = 1; /* one RRU at a time by default */
 	comp->random_cb = rand_cb;
 	comp->random_cb_ctxt = rand_priv;
 
-	/* all compression profiles are disabled by default */
+	/* all compression profiles are disabled by default, they are evaluated in
+	 * their order of declaration */
 	for(i = 0; i < C_NUM_PROFILES; i++)
 	{
+		comp->profiles[i] = rohc_comp_profiles[i];
+		comp->profiles_prio[i] = 0;
+		comp->profiles_order[i] = i;
 		comp->enabled_profiles[i] = false;
 	}
+	comp->profiles_nr = C_NUM_PROFILES;
 
 	/* reset statistics */
 	comp->num_packets = 0;
 	comp->total_compressed_size = 0;
 	comp->total_uncompressed_size = 0;
+	memset(&comp->pkt_stats, 0, sizeof(rohc_packet_stats_t));
+#ifdef ROHC_STAGE_CYCLES
+	memset(&comp->stage_cycles, 0, sizeof(comp->stage_cycles));
+#endif
 	comp->last_context = NULL;
 
 	/* set the default W-LSB window width */
-	is_fine = rohc_comp_set_wlsb_window_width(comp, wlsb_width);
+	is_fine = rohc_comp_set_wlsb_window_width(comp, ROHC_COMP_WLSB_WIDTH);
 	if(is_fine != true)
 	{
 		goto destroy_comp;
@@ -315,23 +622,6 @@ struct rohc_comp * rohc_comp_new2(const rohc_cid_type_t cid_type,
 		goto destroy_comp;
 	}
 
-	/* init the tables for fast CRC computation */
-	is_fine = rohc_crc_init_table(comp->crc_table_3, ROHC_CRC_TYPE_3);
-	if(is_fine != true)
-	{
-		goto destroy_comp;
-	}
-	is_fine = rohc_crc_init_table(comp->crc_table_7, ROHC_CRC_TYPE_7);
-	if(is_fine != true)
-	{
-		goto destroy_comp;
-	}
-	is_fine = rohc_crc_init_table(comp->crc_table_8, ROHC_CRC_TYPE_8);
-	if(is_fine != true)
-	{
-		goto destroy_comp;
-	}
-
 	/* create the MAX_CID + 1 contexts */
 	if(!c_create_contexts(comp))
 	{
@@ -374,11 +664,36 @@ void rohc_comp_free(struct rohc_comp *const comp)
 {
 	if(comp != NULL)
 	{
+		size_t i;
+
 		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 		           "free ROHC compressor");
 
-		/* free memory used by contexts */
+		/* free memory used by contexts, then the context bodies allocated in
+		 * advance */
 		c_destroy_contexts(comp);
+		for(i = 0; i < comp->profiles_nr; i++)
+		{
+			rohc_slab_fini(&comp->ctxt_slabs[i]);
+		}
+
+		/* free the RRU if segmentation was enabled */
+		zfree(comp->rru);
+
+		/* free the built-in RTP detection if configured */
+		zfree(comp->rtp_detect);
+
+		/* free the ring of binary traces if enabled */
+		rohc_trace_ring_free(&comp->trace_ring);
+
+		/* free the histograms of the processing time if enabled */
+		zfree(comp->latency);
+
+		/* release the shared configuration if any */
+		if(comp->config != NULL)
+		{
+			rohc_comp_config_put(comp->config);
+		}
 
 		/* free the compressor */
 		free(comp);
@@ -459,6 +774,148 @@ error:
 }
 
 
+/**
+ * @brief Set the lowest level of the traces of the compressor
+ *
+ * The traces below the given level are dropped before they are formatted,
+ * so they cost almost nothing. By default, traces of all levels are given
+ * to the trace callback.
+ *
+ * @warning The level can not be modified after library initialization
+ *
+ * @param comp   The ROHC compressor
+ * @param level  The lowest level of the traces to give to the callback
+ * @return       true on success, false otherwise
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_set_traces_cb2
+ */
+bool rohc_comp_set_trace_level(struct rohc_comp *const comp,
+                               const rohc_trace_level_t level)
+{
+	/* check compressor validity */
+	if(comp == NULL)
+	{
+		goto error;
+	}
+
+	/* check the trace level */
+	if(level >= ROHC_TRACE_LEVEL_MAX)
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "unknown trace level %d", level);
+		goto error;
+	}
+
+	/* refuse to change the trace level if compressor is in use, because the
+	 * contexts copied it at creation */
+	if(comp->num_packets > 0)
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "unable to "
+		           "modify the trace level after initialization");
+		goto error;
+	}
+
+	comp->trace_level = level;
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Enable or disable the ring of binary trace records of the compressor
+ *
+ * The compressor writes one fixed-size \ref rohc_trace_record in the ring
+ * for every compressed packet, every change of context state or mode, and
+ * every received feedback. Nothing is formatted, so the ring may stay enabled
+ * in production for post-mortem debugging. The oldest records are overwritten
+ * when the ring is full. Use \ref rohc_comp_get_trace_records to read them.
+ *
+ * @warning The ring can not be modified after library initialization
+ *
+ * @param comp        The ROHC compressor
+ * @param records_nr  The number of records of the ring (a power of 2),
+ *                    0 to disable the ring
+ * @return            true on success, false otherwise
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_get_trace_records
+ */
+bool rohc_comp_set_trace_ring(struct rohc_comp *const comp,
+                              const size_t records_nr)
+{
+	/* check compressor validity */
+	if(comp == NULL)
+	{
+		goto error;
+	}
+
+	/* refuse to change the ring if compressor is in use */
+	if(comp->num_packets > 0)
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "unable to "
+		           "modify the ring of binary traces after initialization");
+		goto error;
+	}
+
+	if(!rohc_trace_ring_init(&comp->trace_ring, records_nr))
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "failed to "
+		           "create a ring of %zu binary traces, the number shall be "
+		           "a power of 2", records_nr);
+		goto error;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get the most recent records of the ring of binary traces
+ *
+ * The function may be called from another thread than the one that
+ * compresses packets, without any lock. The records overwritten by the
+ * compressor during the copy are not returned.
+ *
+ * The \e app/traces/rohc_traces tool renders the records written in a file.
+ *
+ * @param comp             The ROHC compressor
+ * @param[out] records     The records, the oldest one first
+ * @param max_nr           The maximum number of records to get
+ * @param[out] records_nr  The number of records got
+ * @return                 true on success, false otherwise
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_set_trace_ring
+ */
+bool rohc_comp_get_trace_records(const struct rohc_comp *const comp,
+                                 struct rohc_trace_record *const records,
+                                 const size_t max_nr,
+                                 size_t *const records_nr)
+{
+	if(comp == NULL || records == NULL || records_nr == NULL)
+	{
+		goto error;
+	}
+
+	*records_nr = rohc_trace_ring_read(&comp->trace_ring, records, max_nr);
+
+	return true;
+
+error:
+	return false;
+}
+
+
 /**
  * @brief Compress the given uncompressed packet into a ROHC packet
  *
@@ -529,51 +986,296 @@ rohc_status_t rohc_compress4(struct rohc_comp *const comp,
                              const struct rohc_buf uncomp_packet,
                              struct rohc_buf *const rohc_packet)
 {
-	struct net_pkt ip_pkt;
-	struct rohc_comp_ctxt *c;
-	rohc_packet_t packet_type;
-	int rohc_hdr_size;
-	size_t payload_size;
-	size_t payload_offset;
+	/* check compressor validity */
+	if(comp == NULL)
+	{
+		return ROHC_STATUS_ERROR;
+	}
 
-	rohc_status_t status = ROHC_STATUS_ERROR; /* error status by default */
+	return __rohc_compress(comp, &uncomp_packet, 1, ROHC_COMP_CID_NONE,
+	                       rohc_packet);
+}
 
-	/* check inputs validity */
+
+/**
+ * @brief Compress a burst of uncompressed packets into ROHC packets
+ *
+ * Compress the \e pkts_nr given uncompressed packets into as many ROHC
+ * packets. Every packet is compressed as \ref rohc_compress4 would do, but
+ * the per-call overhead is paid once for the whole burst and the data of
+ * packet i + 1 is prefetched while packet i is being compressed.
+ *
+ * The status of the compression of every packet is stored in the
+ * \e statuses array. A failure to compress one packet does not stop the
+ * processing of the burst.
+ *
+ * The compressor stores only one ROHC packet waiting for segmentation at a
+ * time: the processing of the burst thus stops just after a packet that
+ * returns \ref ROHC_STATUS_SEGMENT, so that the ROHC segments can be
+ * retrieved with \ref rohc_comp_get_segment2 before the next packets are
+ * compressed. The remaining packets may then be compressed by a new call
+ * to the function.
+ *
+ * @param comp             The ROHC compressor
+ * @param uncomp_packets   The \e pkts_nr uncompressed packets to compress
+ * @param[out] rohc_packets  The \e pkts_nr resulting compressed ROHC packets,
+ *                           the buffers shall be empty
+ * @param[out] statuses    The \e pkts_nr statuses of the compression of
+ *                         every packet (see \ref rohc_compress4 for the
+ *                         possible values)
+ * @param pkts_nr          The number of packets in the burst
+ * @return                 The number of packets that were processed,
+ *                         less than \e pkts_nr if the processing stopped
+ *                         because of ROHC segmentation,
+ *                         0 if the given parameters are not valid
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_compress4
+ * @see rohc_comp_get_segment2
+ */
+size_t rohc_compress_batch(struct rohc_comp *const comp,
+                           const struct rohc_buf uncomp_packets[],
+                           struct rohc_buf rohc_packets[],
+                           rohc_status_t statuses[],
+                           const size_t pkts_nr)
+{
+	size_t i;
+
+	/* check inputs validity once for the whole burst */
 	if(comp == NULL)
 	{
 		goto error;
 	}
-	if(rohc_buf_is_malformed(uncomp_packet))
+	if(uncomp_packets == NULL || rohc_packets == NULL || statuses == NULL)
 	{
 		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "given uncomp_packet is malformed");
+		             "given arrays of packets and statuses cannot be NULL");
 		goto error;
 	}
-	if(rohc_buf_is_empty(uncomp_packet))
+
+	for(i = 0; i < pkts_nr; i++)
 	{
-		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "given uncomp_packet is empty");
-		goto error;
+		/* warm up the caches for the next packet while compressing the
+		 * current one */
+		if((i + 1) < pkts_nr && !rohc_buf_is_malformed(uncomp_packets[i + 1]))
+		{
+			__builtin_prefetch(rohc_buf_data(uncomp_packets[i + 1]), 0, 3);
+		}
+
+		statuses[i] = __rohc_compress(comp, &uncomp_packets[i], 1,
+		                              ROHC_COMP_CID_NONE, &rohc_packets[i]);
+
+		/* the RRU of the compressor shall be retrieved before the next
+		 * packets are compressed */
+		if(statuses[i] == ROHC_STATUS_SEGMENT)
+		{
+			i++;
+			break;
+		}
 	}
-	if(rohc_packet == NULL)
+
+	return i;
+
+error:
+	return 0;
+}
+
+
+/**
+ * @brief Compress an uncompressed packet made of several buffers
+ *
+ * Compress the uncompressed packet made of the \e uncomp_iov_nr given buffers
+ * as \ref rohc_compress4 would do for the concatenation of all the buffers.
+ * The packet does not need to be linearized first: the headers are parsed in
+ * the first buffer and the payload is copied from the different buffers
+ * directly into the ROHC packet.
+ *
+ * All the network headers of the packet (IP headers and their extension
+ * headers, transport header, RTP header) shall be contained in the first
+ * buffer, otherwise \ref ROHC_STATUS_ERROR is returned and no context is
+ * changed. The RTP detection callback reads the whole UDP payload, so the
+ * whole UDP payload shall also be contained in the first buffer if such a
+ * callback is set (see \ref rohc_comp_set_rtp_detection_cb).
+ *
+ * @param comp               The ROHC compressor
+ * @param uncomp_iov         The \e uncomp_iov_nr buffers of the uncompressed
+ *                           packet to compress
+ * @param uncomp_iov_nr      The number of buffers of the uncompressed packet
+ * @param[out] rohc_packet   The resulting compressed ROHC packet
+ * @return                   The same values as \ref rohc_compress4
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_compress4
+ */
+rohc_status_t rohc_compress_iov(struct rohc_comp *const comp,
+                                const struct rohc_buf uncomp_iov[],
+                                const size_t uncomp_iov_nr,
+                                struct rohc_buf *const rohc_packet)
+{
+	/* check compressor validity */
+	if(comp == NULL)
+	{
+		return ROHC_STATUS_ERROR;
+	}
+	if(uncomp_iov == NULL)
 	{
 		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "given rohc_packet is NULL");
+		             "given uncomp_iov is NULL");
+		return ROHC_STATUS_ERROR;
+	}
+
+	return __rohc_compress(comp, uncomp_iov, uncomp_iov_nr, ROHC_COMP_CID_NONE,
+	                       rohc_packet);
+}
+
+
+/**
+ * @brief Compress an uncompressed packet with the context of the given CID
+ *
+ * Compress the given uncompressed packet as \ref rohc_compress4 would do, but
+ * with the context of the given CID instead of the context that the
+ * compressor would find for the packet. The function is meant for the
+ * applications that track the flows themselves: the context is then reached
+ * directly from its CID, without any search among the contexts.
+ *
+ * The context of the CID is used as long as it compresses the flow of the
+ * packet. Otherwise, the context is released and a new context is created
+ * with the same CID and the best profile for the packet. The application
+ * shall thus give the same CID to all the packets of one flow, and different
+ * CIDs to different flows.
+ *
+ * @param comp              The ROHC compressor
+ * @param cid               The CID of the context to compress the packet
+ *                          with, between the first CID of the compressor and
+ *                          its MAX_CID
+ * @param uncomp_packet     The uncompressed packet to compress
+ * @param[out] rohc_packet  The resulting compressed ROHC packet
+ * @return                  The same values as \ref rohc_compress4
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_compress4
+ */
+rohc_status_t rohc_compress_with_cid(struct rohc_comp *const comp,
+                                     const rohc_cid_t cid,
+                                     const struct rohc_buf uncomp_packet,
+                                     struct rohc_buf *const rohc_packet)
+{
+	/* check compressor validity */
+	if(comp == NULL)
+	{
+		return ROHC_STATUS_ERROR;
+	}
+	if(cid < comp->cid_base || (cid - comp->cid_base) > comp->medium.max_cid)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "given CID %zu is not in the range [%zu, %zu] of the "
+		             "compressor", cid, comp->cid_base,
+		             comp->cid_base + comp->medium.max_cid);
+		return ROHC_STATUS_ERROR;
+	}
+
+	return __rohc_compress(comp, &uncomp_packet, 1, cid, rohc_packet);
+}
+
+
+/**
+ * @brief Compress the headers of the given uncompressed packet only
+ *
+ * Compress the given uncompressed packet as \ref rohc_compress4 would do, but
+ * write only the ROHC header in the given buffer: the payload is not copied.
+ * The offset and the length of the payload in the uncompressed packet are
+ * returned instead, so that the caller may transmit the ROHC header and the
+ * payload as two separate buffers (an iovec for example), or put the ROHC
+ * header in front of the payload in the same buffer.
+ *
+ * The ROHC packet is the ROHC header followed by the
+ * \e payload_len bytes found at \e payload_offset in \e uncomp_packet.
+ *
+ * ROHC segmentation is not supported by this function: the ROHC header and
+ * the payload are never stored altogether in the compressor.
+ *
+ * @param comp                 The ROHC compressor
+ * @param uncomp_packet        The uncompressed packet to compress
+ * @param[out] rohc_header     The resulting ROHC header, the buffer shall
+ *                             be empty
+ * @param[out] payload_offset  The offset of the payload in \e uncomp_packet
+ * @param[out] payload_len     The length of the payload
+ * @return                     Possible return values:
+ *                              \li \ref ROHC_STATUS_OK if a ROHC header is
+ *                                  produced
+ *                              \li \ref ROHC_STATUS_ERROR if an error occurred
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_compress4
+ */
+rohc_status_t rohc_compress_header(struct rohc_comp *const comp,
+                                   const struct rohc_buf uncomp_packet,
+                                   struct rohc_buf *const rohc_header,
+                                   size_t *const payload_offset,
+                                   size_t *const payload_len)
+{
+	struct net_pkt ip_pkt;
+	struct rohc_comp_ctxt *c;
+	rohc_packet_t packet_type;
+	int rohc_hdr_size;
+	size_t hdr_offset;
+
+	/* check inputs validity */
+	if(comp == NULL)
+	{
 		goto error;
 	}
-	if(rohc_buf_is_malformed(*rohc_packet))
+
+	/* deliver the feedback enqueued by other threads first */
+	rohc_comp_drain_feedback_queue(comp);
+	if(rohc_buf_is_malformed(uncomp_packet))
 	{
 		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "given rohc_packet is malformed");
+		             "given uncomp_packet is malformed");
 		goto error;
 	}
-	if(!rohc_buf_is_empty(*rohc_packet))
+	if(rohc_buf_is_empty(uncomp_packet))
 	{
 		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "given rohc_packet is not empty");
+		             "given uncomp_packet is empty");
+		goto error;
+	}
+	if(rohc_header == NULL)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "given rohc_header is NULL");
+		goto error;
+	}
+	if(rohc_buf_is_malformed(*rohc_header))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "given rohc_header is malformed");
+		goto error;
+	}
+	if(!rohc_buf_is_empty(*rohc_header))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "given rohc_header is not empty");
+		goto error;
+	}
+	if(payload_offset == NULL || payload_len == NULL)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "given payload_offset and payload_len cannot be NULL");
 		goto error;
 	}
 
+	/* record the packet for replay */
+	if(comp->recorder.write_cb != NULL)
+	{
+		rohc_comp_record(comp, ROHC_RECORD_PKT, &uncomp_packet, 1,
+		                 ROHC_RECORD_NO_CID);
+	}
+
 	/* print uncompressed bytes */
 	if((comp->features & ROHC_COMP_FEATURE_DUMP_PACKETS) != 0)
 	{
@@ -582,76 +1284,315 @@ rohc_status_t rohc_compress4(struct rohc_comp *const comp,
 		                 "uncompressed data, max 100 bytes", uncomp_packet);
 	}
 
-	/* parse the uncompressed packet */
-	if(!net_pkt_parse(&ip_pkt, uncomp_packet, comp->trace_callback,
-	                  comp->trace_callback_priv, ROHC_TRACE_COMP))
+	/* compress the headers of the packet */
+	c = rohc_comp_encode_hdr(comp, uncomp_packet, ROHC_COMP_CID_NONE, &ip_pkt,
+	                         rohc_buf_data(*rohc_header),
+	                         rohc_buf_avail_len(*rohc_header),
+	                         &packet_type, &rohc_hdr_size, &hdr_offset);
+	if(c == NULL)
 	{
-		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "failed to parse uncompressed packet");
 		goto error;
 	}
+	rohc_header->len = rohc_hdr_size;
 
-	/* find the best context for the packet */
-	c = rohc_comp_find_ctxt(comp, &ip_pkt, -1, uncomp_packet.time);
-	if(c == NULL)
+	/* the payload is left in the uncompressed packet */
+	*payload_offset = hdr_offset;
+	*payload_len = ip_pkt.len - hdr_offset;
+	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	           "ROHC size = %zu bytes (header = %d, payload = %zu at offset "
+	           "%zu, not copied)", rohc_hdr_size + (*payload_len),
+	           rohc_hdr_size, *payload_len, *payload_offset);
+
+	/* update some statistics */
+	rohc_comp_update_stats(comp, c, packet_type, uncomp_packet.len,
+	                       rohc_hdr_size + (*payload_len), hdr_offset,
+	                       rohc_hdr_size);
+
+	return ROHC_STATUS_OK;
+
+error:
+	return ROHC_STATUS_ERROR;
+}
+
+/**
+ * @brief Compress the given uncompressed packet in place
+ *
+ * Compress the given uncompressed packet as \ref rohc_compress_header would
+ * do, then write the ROHC header in the same buffer, just in front of the
+ * payload: the payload is neither copied nor moved. The network buffer is
+ * updated to describe the resulting ROHC packet.
+ *
+ * The free space at the beginning of the network buffer (the headroom, see
+ * \ref rohc_buf_push) is used to build the ROHC header before it is moved
+ * in front of the payload: the headroom shall be large enough for the ROHC
+ * header, otherwise the Uncompressed profile is tried as for any output
+ * buffer too small for the ROHC header.
+ *
+ * ROHC segmentation is not supported by this function.
+ *
+ * @param comp            The ROHC compressor
+ * @param[in,out] packet  IN:  The uncompressed packet to compress, with some
+ *                             free space at the beginning of the buffer
+ *                        OUT: The resulting ROHC packet, or the unchanged
+ *                             uncompressed packet in case of error (the
+ *                             content of the headroom is lost)
+ * @return                Possible return values:
+ *                         \li \ref ROHC_STATUS_OK if a ROHC packet is
+ *                             produced
+ *                         \li \ref ROHC_STATUS_ERROR if an error occurred
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_compress_header
+ */
+rohc_status_t rohc_compress_inplace(struct rohc_comp *const comp,
+                                    struct rohc_buf *const packet)
+{
+	struct net_pkt ip_pkt;
+	struct rohc_comp_ctxt *c;
+	rohc_packet_t packet_type;
+	int rohc_hdr_size;
+	size_t payload_offset;
+	size_t payload_size;
+	size_t rohc_offset;
+
+	/* check inputs validity */
+	if(comp == NULL)
+	{
+		goto error;
+	}
+
+	/* deliver the feedback enqueued by other threads first */
+	rohc_comp_drain_feedback_queue(comp);
+	if(packet == NULL)
 	{
 		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "failed to find a matching context or to create a new "
-		             "context");
+		             "given packet is NULL");
+		goto error;
+	}
+	if(rohc_buf_is_malformed(*packet))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "given packet is malformed");
+		goto error;
+	}
+	if(rohc_buf_is_empty(*packet))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "given packet is empty");
 		goto error;
 	}
 
-	/* create the ROHC packet: */
-	rohc_packet->len = 0;
+	/* record the packet for replay */
+	if(comp->recorder.write_cb != NULL)
+	{
+		rohc_comp_record(comp, ROHC_RECORD_PKT, packet, 1,
+		                 ROHC_RECORD_NO_CID);
+	}
 
-	/* use profile to compress packet */
+	/* print uncompressed bytes */
+	if((comp->features & ROHC_COMP_FEATURE_DUMP_PACKETS) != 0)
+	{
+		rohc_dump_packet(comp->trace_callback, comp->trace_callback_priv,
+		                 ROHC_TRACE_COMP, ROHC_TRACE_DEBUG,
+		                 "uncompressed data, max 100 bytes", *packet);
+	}
+
+	/* compress the headers of the packet, build the ROHC header in the
+	 * headroom since the uncompressed headers are still parsed */
+	c = rohc_comp_encode_hdr(comp, *packet, ROHC_COMP_CID_NONE, &ip_pkt,
+	                         packet->data, packet->offset, &packet_type,
+	                         &rohc_hdr_size, &payload_offset);
+	if(c == NULL)
+	{
+		goto error;
+	}
+	payload_size = ip_pkt.len - payload_offset;
+
+	/* move the ROHC header just in front of the payload, the headroom is
+	 * large enough since the ROHC header was built in it */
+	rohc_offset = packet->offset + payload_offset - rohc_hdr_size;
+	memmove(packet->data + rohc_offset, packet->data, rohc_hdr_size);
 	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-	           "compress the packet #%d", comp->num_packets + 1);
-	rohc_hdr_size =
-		c->profile->encode(c, &ip_pkt, rohc_buf_data(*rohc_packet),
-		                   rohc_buf_avail_len(*rohc_packet),
-		                   &packet_type, &payload_offset);
-	if(rohc_hdr_size < 0)
+	           "ROHC size = %zu bytes (header = %d, payload = %zu, in place)",
+	           rohc_hdr_size + payload_size, rohc_hdr_size, payload_size);
+
+	/* update some statistics */
+	rohc_comp_update_stats(comp, c, packet_type, packet->len,
+	                       rohc_hdr_size + payload_size, payload_offset,
+	                       rohc_hdr_size);
+
+	/* the network buffer now describes the ROHC packet */
+	packet->offset = rohc_offset;
+	packet->len = rohc_hdr_size + payload_size;
+
+	return ROHC_STATUS_OK;
+
+error:
+	return ROHC_STATUS_ERROR;
+}
+
+
+/**
+ * @brief Compress the given uncompressed packet into a ROHC packet
+ *
+ * The function is the common part of \ref rohc_compress4,
+ * \ref rohc_compress_batch and \ref rohc_compress_iov: the compressor shall
+ * be valid, the packets are checked.
+ *
+ * @param comp              The ROHC compressor
+ * @param uncomp_iov        The buffers of the uncompressed packet to
+ *                          compress, the first one holds the headers
+ * @param uncomp_iov_nr     The number of buffers of the uncompressed packet
+ * @param cid               The CID of the context to compress the packet
+ *                          with, ROHC_COMP_CID_NONE to find the context
+ * @param[out] rohc_packet  The resulting compressed ROHC packet
+ * @return                  The same values as \ref rohc_compress4
+ */
+static rohc_status_t __rohc_compress(struct rohc_comp *const comp,
+                                     const struct rohc_buf uncomp_iov[],
+                                     const size_t uncomp_iov_nr,
+                                     const rohc_cid_t cid,
+                                     struct rohc_buf *const rohc_packet)
+{
+	struct rohc_buf uncomp_packet;
+	struct net_pkt ip_pkt;
+	struct rohc_comp_ctxt *c;
+	rohc_packet_t packet_type;
+	int rohc_hdr_size;
+	size_t payload_size;
+	size_t payload_offset;
+	size_t i;
+
+	rohc_status_t status = ROHC_STATUS_ERROR; /* error status by default */
+	size_t piggyback_len = 0;
+	uint64_t start_ns = 0;
+
+	if((comp->features & ROHC_COMP_FEATURE_LATENCY) != 0)
 	{
-		/* error while compressing, use the Uncompressed profile */
-		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "error while compressing with the profile, using "
-		             "uncompressed profile");
+		start_ns = rohc_latency_now();
+	}
 
-		/* free context if it was just created */
-		if(c->num_sent_packets <= 1)
+	/* deliver the feedback enqueued by other threads first */
+	rohc_comp_drain_feedback_queue(comp);
+
+	/* check inputs validity */
+	if(uncomp_iov_nr == 0)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "given uncomp_packet has no buffer");
+		goto error;
+	}
+	for(i = 0; i < uncomp_iov_nr; i++)
+	{
+		if(rohc_buf_is_malformed(uncomp_iov[i]))
 		{
-			c->profile->destroy(c);
-			c->used = 0;
-			assert(comp->num_contexts_used > 0);
-			comp->num_contexts_used--;
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "given uncomp_packet is malformed");
+			goto error;
 		}
+	}
+	if(rohc_buf_is_empty(uncomp_iov[0]))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "given uncomp_packet is empty");
+		goto error;
+	}
+	if(rohc_packet == NULL)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "given rohc_packet is NULL");
+		goto error;
+	}
+	if(rohc_buf_is_malformed(*rohc_packet))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "given rohc_packet is malformed");
+		goto error;
+	}
+	if(!rohc_buf_is_empty(*rohc_packet))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "given rohc_packet is not empty");
+		goto error;
+	}
 
-		/* find the best context for the Uncompressed profile */
-		c = rohc_comp_find_ctxt(comp, &ip_pkt, ROHC_PROFILE_UNCOMPRESSED,
-		                        uncomp_packet.time);
-		if(c == NULL)
+	/* record the packet for replay */
+	if(comp->recorder.write_cb != NULL)
+	{
+		rohc_comp_record(comp, ROHC_RECORD_PKT, uncomp_iov, uncomp_iov_nr,
+		                 (cid == ROHC_COMP_CID_NONE ? ROHC_RECORD_NO_CID : cid));
+	}
+
+	/* print uncompressed bytes */
+	if((comp->features & ROHC_COMP_FEATURE_DUMP_PACKETS) != 0)
+	{
+		rohc_dump_packet(comp->trace_callback, comp->trace_callback_priv,
+		                 ROHC_TRACE_COMP, ROHC_TRACE_DEBUG,
+		                 "uncompressed data, max 100 bytes", uncomp_iov[0]);
+	}
+
+	/* piggyback the feedback of the attached decompressor in front of the
+	 * ROHC packet, then hide it */
+	if(comp->feedback_source.cb != NULL)
+	{
+		struct rohc_buf feedback = *rohc_packet;
+
+		feedback.max_len = feedback.offset +
+			rohc_min(rohc_buf_avail_len(feedback), ROHC_COMP_PIGGYBACK_MAX_LEN);
+		if(!comp->feedback_source.cb(comp->feedback_source.priv, &feedback))
 		{
 			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			             "failed to find a matching Uncompressed context or to "
-			             "create a new Uncompressed context");
-			goto error;
+			             "failed to retrieve the feedback of the attached "
+			             "decompressor");
+			feedback.len = 0;
 		}
+		piggyback_len = feedback.len;
+		rohc_packet->len = piggyback_len;
+		rohc_buf_pull(rohc_packet, piggyback_len);
+	}
 
-		/* use the Uncompressed profile to compress the packet */
-		rohc_hdr_size =
-			c->profile->encode(c, &ip_pkt, rohc_buf_data(*rohc_packet),
-			                   rohc_buf_avail_len(*rohc_packet),
-			                   &packet_type, &payload_offset);
-		if(rohc_hdr_size < 0)
+	/* the headers are parsed from the first buffer, the packet length is
+	 * the length of all the buffers */
+	uncomp_packet = uncomp_iov[0];
+	if(uncomp_iov_nr > 1)
+	{
+		uncomp_packet.data = rohc_buf_data(uncomp_iov[0]);
+		uncomp_packet.offset = 0;
+		for(i = 1; i < uncomp_iov_nr; i++)
+		{
+			uncomp_packet.len += uncomp_iov[i].len;
+		}
+		uncomp_packet.max_len = uncomp_packet.len;
+
+		/* reject the packet before any context is looked up or updated */
+		if(!rohc_comp_hdrs_in_first_buf(comp, uncomp_iov[0], uncomp_packet.len))
 		{
 			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			             "error while compressing with uncompressed profile, "
-			             "giving up");
-			goto error_free_new_context;
+			             "the uncompressed headers are not contained in the "
+			             "first %zu-byte buffer", uncomp_iov[0].len);
+			goto error;
 		}
 	}
-	rohc_packet->len += rohc_hdr_size;
+
+	/* compress the headers of the packet */
+	c = rohc_comp_encode_hdr(comp, uncomp_packet, cid, &ip_pkt,
+	                         rohc_buf_data(*rohc_packet),
+	                         rohc_buf_avail_len(*rohc_packet),
+	                         &packet_type, &rohc_hdr_size, &payload_offset);
+	if(c == NULL)
+	{
+		goto error;
+	}
+	rohc_packet->len = rohc_hdr_size;
+	if(payload_offset > uncomp_iov[0].len)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "the %zu-byte uncompressed headers are not contained in "
+		             "the first %zu-byte buffer", payload_offset,
+		             uncomp_iov[0].len);
+		goto error_free_new_context;
+	}
 
 	/* the payload starts after the header, skip it */
 	rohc_buf_pull(rohc_packet, rohc_hdr_size);
@@ -662,6 +1603,7 @@ rohc_status_t rohc_compress4(struct rohc_comp *const comp,
 	{
 		const size_t max_rohc_buf_len =
 			rohc_buf_avail_len(*rohc_packet) + rohc_hdr_size;
+		struct rohc_comp_rru *rru;
 		uint32_t rru_crc;
 
 		/* resulting ROHC packet too large, segmentation may be a solution */
@@ -675,7 +1617,7 @@ rohc_status_t rohc_compress4(struct rohc_comp *const comp,
 
 		/* in order to be segmented, a ROHC packet shall be <= MRRU
 		 * (remember that MRRU includes the CRC length) */
-		if((payload_size + CRC_FCS32_LEN) > comp->mrru)
+		if((rohc_hdr_size + payload_size + CRC_FCS32_LEN) > comp->mrru)
 		{
 			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 			             "%s ROHC packet cannot be segmented: too large (%d + "
@@ -691,38 +1633,72 @@ rohc_status_t rohc_compress4(struct rohc_comp *const comp,
 
 		/* store the whole ROHC packet in compressor (headers and payload only,
 		 * not feedbacks, feedbacks will be transmitted with the first segment
-		 * when rohc_comp_get_segment2() is called) */
-		if(comp->rru_len != 0)
+		 * when rohc_comp_get_segment2() is called) in the next slot of the
+		 * ring of RRUs */
+		if(comp->rru_count == comp->rru_slots_nr)
 		{
-			/* warn users about previous, not yet retrieved RRU */
+			/* warn users about the oldest, not yet retrieved RRU */
 			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 			             "erase the existing %zd-byte RRU that was not "
 			             "retrieved yet (call rohc_comp_get_segment2() to add "
 			             "support for ROHC segments in your application)",
-			             comp->rru_len);
+			             comp->rru_slots[comp->rru_first].len);
+			comp->rru_slots[comp->rru_first].len = 0;
+			comp->rru_first = (comp->rru_first + 1) % comp->rru_slots_nr;
+			comp->rru_count--;
 		}
-		comp->rru_len = 0;
-		comp->rru_off = 0;
+		rru = &comp->rru_slots[(comp->rru_first + comp->rru_count) %
+		                       comp->rru_slots_nr];
+		comp->rru_count++;
+		rru->pieces_nr = 0;
+		rru->piece_idx = 0;
 		/* ROHC header */
 		rohc_buf_push(rohc_packet, rohc_hdr_size);
-		memcpy(comp->rru + comp->rru_off, rohc_buf_data(*rohc_packet),
-		       rohc_hdr_size);
-		comp->rru_len += rohc_hdr_size;
-		/* ROHC payload */
-		memcpy(comp->rru + comp->rru_off + comp->rru_len,
-		       rohc_buf_data_at(uncomp_packet, payload_offset), payload_size);
-		comp->rru_len += payload_size;
-		/* compute FCS-32 CRC over header and payload (optional feedbacks and
-		   the CRC field itself are excluded) */
-		rru_crc = crc_calc_fcs32(comp->rru + comp->rru_off, comp->rru_len,
-		                         CRC_INIT_FCS32);
-		memcpy(comp->rru + comp->rru_off + comp->rru_len, &rru_crc,
-		       CRC_FCS32_LEN);
-		comp->rru_len += CRC_FCS32_LEN;
+		memcpy(rru->data, rohc_buf_data(*rohc_packet), rohc_hdr_size);
+		rru->pieces[0].data = rru->data;
+		rru->pieces[0].len = rohc_hdr_size;
+		rru->pieces_nr++;
+		rru->len = rohc_hdr_size;
+		/* ROHC payload: left in place if the segments may be given as views
+		 * and if the payload is not split into too many buffers */
+		rohc_cycles_begin(&comp->stage_cycles, ROHC_COMP_STAGE_PAYLOAD);
+		if((comp->features & ROHC_COMP_FEATURE_SEGMENT_VIEWS) != 0 &&
+		   rohc_comp_rru_add_payload(rru, uncomp_iov, uncomp_iov_nr,
+		                             payload_offset, payload_size))
+		{
+			rohc_cycles_end(&comp->stage_cycles, ROHC_COMP_STAGE_PAYLOAD);
+			rru->len += payload_size;
+			/* compute FCS-32 CRC over the header and payload pieces in place,
+			   the CRC is stored in the RRU buffer after the ROHC header */
+			rru_crc = CRC_INIT_FCS32;
+			for(i = 0; i < rru->pieces_nr; i++)
+			{
+				rru_crc = crc_calc_fcs32(rru->pieces[i].data, rru->pieces[i].len,
+				                         rru_crc);
+			}
+			memcpy(rru->data + rohc_hdr_size, &rru_crc, CRC_FCS32_LEN);
+			rru->pieces[rru->pieces_nr].data = rru->data + rohc_hdr_size;
+			rru->pieces[rru->pieces_nr].len = CRC_FCS32_LEN;
+			rru->pieces_nr++;
+		}
+		else
+		{
+			rohc_comp_copy_payload(rru->data + rru->len, uncomp_iov,
+			                       uncomp_iov_nr, payload_offset, payload_size);
+			rohc_cycles_end(&comp->stage_cycles, ROHC_COMP_STAGE_PAYLOAD);
+			rru->len += payload_size;
+			/* compute FCS-32 CRC over header and payload (optional feedbacks
+			   and the CRC field itself are excluded) */
+			rru_crc = crc_calc_fcs32(rru->data, rru->len, CRC_INIT_FCS32);
+			memcpy(rru->data + rru->len, &rru_crc, CRC_FCS32_LEN);
+			rru->pieces[0].len = rru->len + CRC_FCS32_LEN;
+			rru->pieces_nr = 1;
+		}
+		rru->len += CRC_FCS32_LEN;
 		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 		           "RRU 32-bit FCS CRC = 0x%08x", rohc_ntoh32(rru_crc));
 		/* computed RRU must be <= MRRU */
-		assert(comp->rru_len <= comp->mrru);
+		assert(rru->len <= comp->mrru);
 
 		/* reset the length of the ROHC packet: it shall be 0 for users */
 		rohc_packet->len = 0;
@@ -735,9 +1711,11 @@ rohc_status_t rohc_compress4(struct rohc_comp *const comp,
 		/* copy full payload after ROHC header */
 		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 		           "copy full %zd-byte payload", payload_size);
-		rohc_buf_append(rohc_packet,
-		                rohc_buf_data_at(uncomp_packet, payload_offset),
-		                payload_size);
+		rohc_cycles_begin(&comp->stage_cycles, ROHC_COMP_STAGE_PAYLOAD);
+		rohc_comp_copy_payload(rohc_buf_data(*rohc_packet), uncomp_iov,
+		                       uncomp_iov_nr, payload_offset, payload_size);
+		rohc_cycles_end(&comp->stage_cycles, ROHC_COMP_STAGE_PAYLOAD);
+		rohc_packet->len += payload_size;
 
 		/* unhide the ROHC header */
 		rohc_buf_push(rohc_packet, rohc_hdr_size);
@@ -750,26 +1728,25 @@ rohc_status_t rohc_compress4(struct rohc_comp *const comp,
 		status = ROHC_STATUS_OK;
 	}
 
-	/* update some statistics:
-	 *  - compressor statistics
-	 *  - context statistics (global + last packet + last 16 packets) */
-	comp->num_packets++;
-	comp->total_uncompressed_size += uncomp_packet.len;
-	comp->total_compressed_size += rohc_packet->len;
-	comp->last_context = c;
-
-	c->packet_type = packet_type;
-
-	c->total_uncompressed_size += uncomp_packet.len;
-	c->total_compressed_size += rohc_packet->len;
-	c->header_uncompressed_size += payload_offset;
-	c->header_compressed_size += rohc_hdr_size;
-	c->num_sent_packets++;
+	/* update some statistics */
+	rohc_comp_update_stats(comp, c, packet_type, uncomp_packet.len,
+	                       rohc_packet->len, payload_offset, rohc_hdr_size);
+	if((comp->features & ROHC_COMP_FEATURE_LATENCY) != 0)
+	{
+		rohc_latency_add(comp->latency, c->profile->id, packet_type,
+		                 rohc_latency_now() - start_ns);
+	}
 
-	c->total_last_uncompressed_size = uncomp_packet.len;
-	c->total_last_compressed_size = rohc_packet->len;
-	c->header_last_uncompressed_size = payload_offset;
-	c->header_last_compressed_size = rohc_hdr_size;
+	/* unhide the piggybacked feedback, it is lost if the ROHC packet is
+	 * to be segmented */
+	if(piggyback_len > 0)
+	{
+		rohc_buf_push(rohc_packet, piggyback_len);
+		if(status == ROHC_STATUS_SEGMENT)
+		{
+			rohc_packet->len = 0;
+		}
+	}
 
 	/* compression is successful */
 	return status;
@@ -778,18 +1755,529 @@ error_free_new_context:
 	/* free context if it was just created */
 	if(c->num_sent_packets <= 1)
 	{
-		c->profile->destroy(c);
-		c->used = 0;
-		assert(comp->num_contexts_used > 0);
-		comp->num_contexts_used--;
+		c_release_context(comp, c);
 	}
 error:
+	if(piggyback_len > 0)
+	{
+		rohc_buf_push(rohc_packet, piggyback_len);
+		rohc_packet->len = 0;
+	}
 	return ROHC_STATUS_ERROR;
 }
 
 
 /**
- * @brief Get the next ROHC segment if any
+ * @brief Are the headers of a packet split in several buffers contained in
+ *        the first buffer?
+ *
+ * The headers are parsed and encoded from the first buffer only, so all the
+ * headers that the profiles read shall be contained in it: the IP headers
+ * with their extension headers, the transport header, and the RTP header
+ * with its CSRC list if the UDP packet may be detected as RTP. The RTP
+ * detection callback is given the whole UDP payload, so the whole UDP
+ * payload shall be contained in the first buffer if such a callback is set.
+ * The packets that are not IP are not parsed.
+ *
+ * No context is looked up nor updated.
+ *
+ * @param comp       The ROHC compressor
+ * @param first_buf  The first buffer of the packet, not empty
+ * @param pkt_len    The length (in bytes) of the whole packet
+ * @return           true if the headers are contained in the first buffer,
+ *                   false otherwise
+ */
+static bool rohc_comp_hdrs_in_first_buf(struct rohc_comp *const comp,
+                                        const struct rohc_buf first_buf,
+                                        const size_t pkt_len)
+{
+	const uint8_t *const data = rohc_buf_data(first_buf);
+	struct net_pkt_hdrs *const hdrs = &comp->pkt_hdrs;
+	const uint8_t version = (data[0] >> 4) & 0x0f;
+	size_t transport_full_len;
+	size_t hdrs_len;
+
+	if(version != IPV4 && version != IPV6)
+	{
+		return true;
+	}
+
+	/* the IP headers and their extension headers */
+	net_pkt_parse_hdrs(hdrs, data, first_buf.len);
+	if(!hdrs->is_complete)
+	{
+		return false;
+	}
+	transport_full_len = pkt_len - (hdrs->transport - data);
+
+	/* the transport header, and the RTP header if the packet may be RTP */
+	switch(hdrs->transport_proto)
+	{
+		case ROHC_IPPROTO_UDP:
+			hdrs_len = sizeof(struct udphdr);
+			if(hdrs->transport_len < hdrs_len ||
+			   transport_full_len < (hdrs_len + sizeof(struct rtphdr)) ||
+			   !rohc_comp_profile_enabled(comp, ROHC_PROFILE_RTP))
+			{
+				break;
+			}
+			if(comp->rtp_callback != NULL)
+			{
+				hdrs_len = transport_full_len;
+			}
+			else if(comp->rtp_detect != NULL)
+			{
+				const struct udphdr *const udp =
+					(const struct udphdr *) hdrs->transport;
+				const uint16_t dport = rohc_ntoh16(udp->dest);
+
+				if((comp->rtp_detect->ports[dport / 64] &
+				    (((uint64_t) 1) << (dport % 64))) != 0)
+				{
+					hdrs_len += sizeof(struct rtphdr);
+					if(hdrs->transport_len >= hdrs_len)
+					{
+						const struct rtphdr *const rtp =
+							(const struct rtphdr *) (udp + 1);
+						hdrs_len += rtp->cc * sizeof(uint32_t);
+					}
+				}
+			}
+			break;
+		case ROHC_IPPROTO_UDPLITE:
+			hdrs_len = sizeof(struct udphdr);
+			break;
+		case ROHC_IPPROTO_ESP:
+			hdrs_len = sizeof(struct esphdr);
+			break;
+		case ROHC_IPPROTO_TCP:
+			hdrs_len = sizeof(struct tcphdr);
+			if(hdrs->transport_len >= hdrs_len)
+			{
+				const struct tcphdr *const tcp =
+					(const struct tcphdr *) hdrs->transport;
+				hdrs_len = rohc_max(hdrs_len, tcp->data_offset * sizeof(uint32_t));
+			}
+			break;
+		default:
+			hdrs_len = 0;
+			break;
+	}
+
+	/* the headers truncated in the whole packet are not read beyond it */
+	return (hdrs->transport_len >= rohc_min(hdrs_len, transport_full_len));
+}
+
+
+/**
+ * @brief Compress the headers of the given uncompressed packet
+ *
+ * Parse the uncompressed packet, find the best context for it (or create a
+ * new one) and encode its headers. The Uncompressed profile is used if the
+ * best profile fails to encode the packet.
+ *
+ * @param comp                The ROHC compressor
+ * @param uncomp_packet       The uncompressed packet to compress
+ * @param cid                 The CID of the context to compress the packet
+ *                            with, ROHC_COMP_CID_NONE to find the context
+ * @param[out] ip_pkt         The parsed uncompressed packet
+ * @param[out] rohc_hdr       The buffer where to write the ROHC header
+ * @param rohc_hdr_max_len    The maximum length of the ROHC header
+ * @param[out] packet_type    The type of ROHC packet that is created
+ * @param[out] rohc_hdr_size  The length of the ROHC header
+ * @param[out] payload_offset The offset of the payload in the uncompressed
+ *                            packet
+ * @return                    The context used to compress the packet,
+ *                            NULL in case of error
+ */
+static struct rohc_comp_ctxt *
+	rohc_comp_encode_hdr(struct rohc_comp *const comp,
+	                     const struct rohc_buf uncomp_packet,
+	                     const rohc_cid_t cid,
+	                     struct net_pkt *const ip_pkt,
+	                     uint8_t *const rohc_hdr,
+	                     const size_t rohc_hdr_max_len,
+	                     rohc_packet_t *const packet_type,
+	                     int *const rohc_hdr_size,
+	                     size_t *const payload_offset)
+{
+	struct rohc_comp_ctxt *c;
+
+	rohc_trace_ring_set_time(&comp->trace_ring, uncomp_packet.time);
+
+	/* spread the forced re-initializations of contexts over the packets */
+	if(comp->reinit_left_nr > 0)
+	{
+		rohc_comp_reinit_next_ctxts(comp);
+	}
+
+	/* parse the uncompressed packet */
+	rohc_cycles_begin(&comp->stage_cycles, ROHC_COMP_STAGE_PARSE);
+	if(!net_pkt_parse(ip_pkt, uncomp_packet, &comp->pkt_hdrs,
+	                  comp->trace_callback, comp->trace_callback_priv,
+	                  comp->trace_level, ROHC_TRACE_COMP))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "failed to parse uncompressed packet");
+		goto error;
+	}
+	rohc_cycles_end(&comp->stage_cycles, ROHC_COMP_STAGE_PARSE);
+
+	/* find the best context for the packet, the flows whose profile failed
+	 * recently go straight to the Uncompressed profile */
+	rohc_cycles_begin(&comp->stage_cycles, ROHC_COMP_STAGE_FIND_CTXT);
+	if(cid == ROHC_COMP_CID_NONE)
+	{
+		c = rohc_comp_find_ctxt(comp, ip_pkt,
+		                        c_profile_failed(comp, ip_pkt, uncomp_packet.time) ?
+		                        ROHC_PROFILE_UNCOMPRESSED : -1, uncomp_packet.time);
+	}
+	else
+	{
+		c = rohc_comp_get_steered_ctxt(comp, ip_pkt, cid,
+		                               c_profile_failed(comp, ip_pkt, uncomp_packet.time) ?
+		                               ROHC_PROFILE_UNCOMPRESSED : -1,
+		                               uncomp_packet.time);
+	}
+	rohc_cycles_end(&comp->stage_cycles, ROHC_COMP_STAGE_FIND_CTXT);
+	if(c == NULL)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "failed to find a matching context or to create a new "
+		             "context");
+		goto error;
+	}
+
+	/* use profile to compress packet */
+	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	           "compress the packet #%d", comp->num_packets + 1);
+	*rohc_hdr_size =
+		c->profile->encode(c, ip_pkt, rohc_hdr, rohc_hdr_max_len,
+		                   packet_type, payload_offset);
+	if((*rohc_hdr_size) < 0)
+	{
+		/* error while compressing, use the Uncompressed profile */
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "error while compressing with the profile, using "
+		             "uncompressed profile");
+
+		/* free context if it was just created */
+		if(c->num_sent_packets <= 1)
+		{
+			c_release_context(comp, c);
+		}
+
+		/* do not try the profile again for the next packets of the flow */
+		c_profile_failure_add(comp, ip_pkt, uncomp_packet.time);
+
+		/* find the best context for the Uncompressed profile */
+		if(cid == ROHC_COMP_CID_NONE)
+		{
+			c = rohc_comp_find_ctxt(comp, ip_pkt, ROHC_PROFILE_UNCOMPRESSED,
+			                        uncomp_packet.time);
+		}
+		else
+		{
+			c = rohc_comp_get_steered_ctxt(comp, ip_pkt, cid,
+			                               ROHC_PROFILE_UNCOMPRESSED,
+			                               uncomp_packet.time);
+		}
+		if(c == NULL)
+		{
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "failed to find a matching Uncompressed context or to "
+			             "create a new Uncompressed context");
+			goto error;
+		}
+
+		/* use the Uncompressed profile to compress the packet */
+		*rohc_hdr_size =
+			c->profile->encode(c, ip_pkt, rohc_hdr, rohc_hdr_max_len,
+			                   packet_type, payload_offset);
+		if((*rohc_hdr_size) < 0)
+		{
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "error while compressing with uncompressed profile, "
+			             "giving up");
+			goto free_new_context;
+		}
+	}
+
+	/* widen the W-LSB windows narrowed by feedback once no feedback was
+	 * received for a long time */
+	if(c->wlsb_width < comp->wlsb_window_width)
+	{
+		c->wlsb_silence_nr++;
+		if(c->wlsb_silence_nr >= ROHC_COMP_WLSB_SILENCE_NR)
+		{
+			c_ctxt_set_wlsb_width(c, rohc_min(c->wlsb_width * 2,
+			                                  comp->wlsb_window_width));
+		}
+	}
+
+	return c;
+
+free_new_context:
+	/* free context if it was just created */
+	if(c->num_sent_packets <= 1)
+	{
+		c_release_context(comp, c);
+	}
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Update the compressor and context statistics for one packet
+ *
+ * @param comp              The ROHC compressor
+ * @param context           The context used to compress the packet
+ * @param packet_type       The type of the ROHC packet
+ * @param uncomp_len        The length of the uncompressed packet
+ * @param rohc_len          The length of the ROHC packet
+ * @param uncomp_hdr_len    The length of the uncompressed headers
+ * @param rohc_hdr_len      The length of the ROHC header
+ */
+static void rohc_comp_update_stats(struct rohc_comp *const comp,
+                                   struct rohc_comp_ctxt *const context,
+                                   const rohc_packet_t packet_type,
+                                   const size_t uncomp_len,
+                                   const size_t rohc_len,
+                                   const size_t uncomp_hdr_len __attribute__((unused)),
+                                   const size_t rohc_hdr_len __attribute__((unused)))
+{
+	rohc_seqlock_write_begin(&comp->stats_seq);
+
+	/* compressor statistics */
+	comp->num_packets++;
+	comp->total_uncompressed_size += uncomp_len;
+	comp->total_compressed_size += rohc_len;
+	comp->last_context = context;
+	assert(context->profile->id < ROHC_PROFILE_MAX);
+	rohc_packet_counters_add(&comp->pkt_stats.profiles[context->profile->id],
+	                         uncomp_len, rohc_len);
+	assert(packet_type < ROHC_PACKET_MAX);
+	rohc_packet_counters_add(&comp->pkt_stats.packet_types[packet_type],
+	                         uncomp_len, rohc_len);
+
+	/* context statistics (global + last packet) */
+	context->packet_type = packet_type;
+	context->num_sent_packets++;
+
+#if ROHC_SMALL_CONTEXTS != 1
+	context->total_uncompressed_size += uncomp_len;
+	context->total_compressed_size += rohc_len;
+	context->header_uncompressed_size += uncomp_hdr_len;
+	context->header_compressed_size += rohc_hdr_len;
+	assert(context->state <= ROHC_COMP_STATE_SO);
+	context->state_packets_nr[context->state]++;
+
+	context->total_last_uncompressed_size = uncomp_len;
+	context->total_last_compressed_size = rohc_len;
+	context->header_last_uncompressed_size = uncomp_hdr_len;
+	context->header_last_compressed_size = rohc_hdr_len;
+#endif
+
+	rohc_seqlock_write_end(&comp->stats_seq);
+
+	rohc_trace_ring_add(&comp->trace_ring, ROHC_TRACE_EVENT_COMP_PKT,
+	                    context->cid, context->profile->id, packet_type,
+	                    context->num_sent_packets, rohc_len, uncomp_len,
+	                    context->state);
+}
+
+
+/**
+ * @brief Copy the payload of an uncompressed packet made of several buffers
+ *
+ * @param dst            The memory where to copy the payload
+ * @param uncomp_iov     The buffers of the uncompressed packet
+ * @param uncomp_iov_nr  The number of buffers of the uncompressed packet
+ * @param offset         The offset of the payload in the uncompressed packet
+ * @param len            The length of the payload
+ */
+static void rohc_comp_copy_payload(uint8_t *const dst,
+                                   const struct rohc_buf uncomp_iov[],
+                                   const size_t uncomp_iov_nr,
+                                   size_t offset,
+                                   size_t len)
+{
+	size_t copied_len = 0;
+	size_t i;
+
+	for(i = 0; i < uncomp_iov_nr && copied_len < len; i++)
+	{
+		size_t chunk_len;
+
+		/* skip the buffers before the payload */
+		if(offset >= uncomp_iov[i].len)
+		{
+			offset -= uncomp_iov[i].len;
+			continue;
+		}
+
+		chunk_len = rohc_min(uncomp_iov[i].len - offset, len - copied_len);
+		memcpy(dst + copied_len, rohc_buf_data_at(uncomp_iov[i], offset),
+		       chunk_len);
+		copied_len += chunk_len;
+		offset = 0;
+	}
+	assert(copied_len == len);
+}
+
+
+/**
+ * @brief Add the payload of an uncompressed packet to the RRU without copy
+ *
+ * The payload is added as pieces of the RRU that point to the buffers of the
+ * uncompressed packet.
+ *
+ * @param rru            The RRU being built
+ * @param uncomp_iov     The buffers of the uncompressed packet
+ * @param uncomp_iov_nr  The number of buffers of the uncompressed packet
+ * @param offset         The offset of the payload in the uncompressed packet
+ * @param len            The length of the payload
+ * @return               true if the payload was added,
+ *                       false if it is split into too many buffers
+ */
+static bool rohc_comp_rru_add_payload(struct rohc_comp_rru *const rru,
+                                      const struct rohc_buf uncomp_iov[],
+                                      const size_t uncomp_iov_nr,
+                                      size_t offset,
+                                      size_t len)
+{
+	size_t added_len = 0;
+	size_t i;
+
+	for(i = 0; i < uncomp_iov_nr && added_len < len; i++)
+	{
+		struct rohc_comp_rru_piece *const piece = &rru->pieces[rru->pieces_nr];
+
+		/* skip the buffers before the payload */
+		if(offset >= uncomp_iov[i].len)
+		{
+			offset -= uncomp_iov[i].len;
+			continue;
+		}
+
+		/* keep one piece for the CRC */
+		if((rru->pieces_nr + 1) >= ROHC_COMP_RRU_PIECES_MAX)
+		{
+			return false;
+		}
+		piece->data = rohc_buf_data_at(uncomp_iov[i], offset);
+		piece->len = rohc_min(uncomp_iov[i].len - offset, len - added_len);
+		rru->pieces_nr++;
+		added_len += piece->len;
+		offset = 0;
+	}
+	assert(added_len == len);
+
+	return true;
+}
+
+
+/**
+ * @brief Take the next bytes of the oldest RRU waiting to be split into
+ *        segments
+ *
+ * @param comp     The ROHC compressor, with some RRU waiting
+ * @param max_len  The maximum number of bytes to take, greater than 0
+ * @return         The next bytes of the RRU, contiguous in memory, at most
+ *                 \e max_len bytes
+ */
+static struct rohc_comp_rru_piece rohc_comp_rru_pull(struct rohc_comp *const comp,
+                                                     const size_t max_len)
+{
+	struct rohc_comp_rru *const rru = &comp->rru_slots[comp->rru_first];
+	struct rohc_comp_rru_piece *const piece = &rru->pieces[rru->piece_idx];
+	struct rohc_comp_rru_piece chunk;
+
+	assert(comp->rru_count > 0);
+	assert(rru->piece_idx < rru->pieces_nr);
+	assert(rru->len > 0);
+	assert(max_len > 0);
+
+	chunk.data = piece->data;
+	chunk.len = rohc_min(piece->len, max_len);
+	piece->data += chunk.len;
+	piece->len -= chunk.len;
+	if(piece->len == 0)
+	{
+		rru->piece_idx++;
+	}
+	rru->len -= chunk.len;
+
+	/* release the slot once all the bytes of the RRU were taken */
+	if(rru->len == 0)
+	{
+		rru->pieces_nr = 0;
+		rru->piece_idx = 0;
+		comp->rru_first = (comp->rru_first + 1) % comp->rru_slots_nr;
+		comp->rru_count--;
+	}
+
+	return chunk;
+}
+
+
+/**
+ * @brief Move the remaining bytes of one RRU into a new RRU buffer
+ *
+ * The pieces of the RRU that point to the buffers of the uncompressed packet
+ * are left unchanged.
+ *
+ * @param comp      The ROHC compressor
+ * @param rru       The RRU to move
+ * @param new_data  The new RRU buffer, large enough for the remaining bytes
+ */
+static void rohc_comp_rru_move(const struct rohc_comp *const comp,
+                               struct rohc_comp_rru *const rru,
+                               uint8_t *const new_data)
+{
+	size_t moved_len = 0;
+	size_t i;
+
+	for(i = rru->piece_idx; i < rru->pieces_nr; i++)
+	{
+		struct rohc_comp_rru_piece *const piece = &rru->pieces[i];
+
+		if(piece->data >= rru->data && piece->data < (rru->data + comp->mrru))
+		{
+			memcpy(new_data + moved_len, piece->data, piece->len);
+			piece->data = new_data + moved_len;
+			moved_len += piece->len;
+		}
+	}
+}
+
+
+/**
+ * @brief Assign the RRU buffers to the slots of the ring of RRUs
+ *
+ * @param comp      The ROHC compressor
+ * @param rru       The RRU buffers, \e mrru bytes per slot, NULL if
+ *                  segmentation is disabled
+ * @param mrru      The MRRU
+ * @param slots_nr  The number of slots of the ring of RRUs
+ */
+static void rohc_comp_rru_assign(struct rohc_comp *const comp,
+                                 uint8_t *const rru,
+                                 const size_t mrru,
+                                 const size_t slots_nr)
+{
+	size_t i;
+
+	for(i = 0; i < slots_nr; i++)
+	{
+		comp->rru_slots[i].data = (rru != NULL ? rru + i * mrru : NULL);
+	}
+}
+
+
+/**
+ * @brief Get the next ROHC segment if any
  *
  * Get the next ROHC segment if any.
  *
@@ -842,7 +2330,11 @@ rohc_status_t rohc_comp_get_segment2(struct rohc_comp *const comp,
 
 {
 	const size_t segment_type_len = 1; /* segment type byte */
+	struct rohc_comp_rru_piece chunk;
+	struct rohc_comp_rru *rru;
 	size_t max_data_len;
+	size_t copied_len;
+	bool is_final;
 	rohc_status_t status;
 
 	/* check input parameters */
@@ -873,12 +2365,13 @@ rohc_status_t rohc_comp_get_segment2(struct rohc_comp *const comp,
 	segment->len = 0;
 
 	/* abort if no RRU is available in the compressor */
-	if(comp->rru_len == 0)
+	if(comp->rru_count == 0)
 	{
 		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 		             "no RRU available in given compressor");
 		goto error;
 	}
+	rru = &comp->rru_slots[comp->rru_first];
 
 	/* abort is the given output buffer is too small for RRU */
 	if(rohc_buf_avail_len(*segment) <= segment_type_len)
@@ -891,30 +2384,31 @@ rohc_status_t rohc_comp_get_segment2(struct rohc_comp *const comp,
 
 	/* how many bytes of ROHC packet can we put in that new segment? */
 	max_data_len = rohc_min(rohc_buf_avail_len(*segment) - segment_type_len,
-	                        comp->rru_len);
+	                        rru->len);
 	assert(max_data_len > 0);
 	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 	           "copy %zd bytes of the remaining %zd bytes of ROHC packet and "
-	           "CRC in the segment", max_data_len, comp->rru_len);
+	           "CRC in the segment", max_data_len, rru->len);
 
 	/* set segment type with F bit set only for last segment */
-	rohc_buf_byte_at(*segment, 0) = 0xfe | (max_data_len == comp->rru_len);
+	is_final = (max_data_len == rru->len);
+	rohc_buf_byte_at(*segment, 0) = 0xfe | is_final;
 	segment->len++;
 	rohc_buf_pull(segment, 1);
 
 	/* copy remaining ROHC data (CRC included) */
-	rohc_buf_append(segment, comp->rru + comp->rru_off, max_data_len);
-	rohc_buf_pull(segment, max_data_len);
-	comp->rru_off += max_data_len;
-	comp->rru_len -= max_data_len;
+	for(copied_len = 0; copied_len < max_data_len; copied_len += chunk.len)
+	{
+		chunk = rohc_comp_rru_pull(comp, max_data_len - copied_len);
+		rohc_buf_append(segment, chunk.data, chunk.len);
+		rohc_buf_pull(segment, chunk.len);
+	}
 
 	/* set status wrt to (non-)final segment */
-	if(comp->rru_len == 0)
+	if(is_final)
 	{
 		/* final segment, no more segment available */
 		status = ROHC_STATUS_OK;
-		/* reset context for next RRU */
-		comp->rru_off = 0;
 	}
 	else
 	{
@@ -933,57 +2427,221 @@ error:
 
 
 /**
- * @brief Force the compressor to re-initialize all its contexts
+ * @brief Get the next ROHC segment if any, as views over the ROHC packet
  *
- * Make all contexts restart their initialization with decompressor, ie. they
- * go in the lowest compression state. This function can be used once the
- * ROHC channel is established again after an interruption.
+ * Get the next ROHC segment if any, like \ref rohc_comp_get_segment2 but
+ * without copying it: the segment is given as a list of buffers to be sent
+ * one after the other, for example with a scatter/gather I/O function. The
+ * first buffer holds the segment type, the next ones point to the ROHC
+ * header, to the payload and to the FCS-32 CRC of the segmented packet.
  *
- * The function implements the CONTEXT_REINITIALIZATION signal described by
- * RFC 3095 at §6.3.1 as:
- * \verbatim
-   CONTEXT_REINITIALIZATION -- signal
-   This parameter triggers a reinitialization of the entire context at
-   the decompressor, both the static and the dynamic part.  The
-   compressor MUST, when CONTEXT_REINITIALIZATION is triggered, back off
-   to the IR state and fully reinitialize the context by sending IR
-   packets with both the static and dynamic chains covering the entire
-   uncompressed headers until it is reasonably confident that the
-   decompressor contexts are reinitialized.  The context
-   reinitialization MUST be done for all contexts at the compressor.
-   This parameter may for instance be used to do context relocation at,
-   e.g., a cellular handover that results in a change of compression
-   point in the radio access network.
-\endverbatim
+ * If the \ref ROHC_COMP_FEATURE_SEGMENT_VIEWS feature is enabled, the
+ * payload is not copied at all: the buffers point to the payload of the
+ * uncompressed packet given to \ref rohc_compress4 and the FCS-32 CRC is
+ * computed in place. The uncompressed packet shall then remain unchanged
+ * until all its segments are retrieved. Otherwise, the buffers point to the
+ * copy of the ROHC packet kept by the compressor.
  *
- * @param comp  The ROHC compressor
- * @return      true in case of success, false otherwise
+ * The buffers are valid until the next call to the compressor.
+ *
+ * To get all the segments of one ROHC packet, call this function until
+ * \ref ROHC_STATUS_OK or \ref ROHC_STATUS_ERROR is returned.
+ *
+ * @param comp                    The ROHC compressor
+ * @param max_len                 The maximum length of the segment (in
+ *                                bytes), segment type included
+ * @param[out] segment_iov        The buffers of the ROHC segment
+ * @param[in,out] segment_iov_nr  In: the number of buffers in
+ *                                \e segment_iov, at least 2,
+ *                                out: the number of buffers of the segment
+ * @return                        Possible return values:
+ *                                 \li \ref ROHC_STATUS_SEGMENT if a ROHC
+ *                                     segment is returned and more segments
+ *                                     are available,
+ *                                 \li \ref ROHC_STATUS_OK if a ROHC segment
+ *                                     is returned and no more ROHC segment is
+ *                                     available
+ *                                 \li \ref ROHC_STATUS_ERROR if an error
+ *                                     occurred
  *
  * @ingroup rohc_comp
+ *
+ * @see rohc_comp_get_segment2
+ * @see rohc_comp_set_mrru
+ * @see rohc_compress4
  */
-bool rohc_comp_force_contexts_reinit(struct rohc_comp *const comp)
+rohc_status_t rohc_comp_get_segment_iov(struct rohc_comp *const comp,
+                                        const size_t max_len,
+                                        struct rohc_buf segment_iov[],
+                                        size_t *const segment_iov_nr)
 {
-	rohc_cid_t i;
+	const size_t segment_type_len = 1; /* segment type byte */
+	const struct rohc_ts unknown_time = { .sec = 0, .nsec = 0 };
+	struct rohc_comp_rru_piece chunk;
+	struct rohc_comp_rru *rru;
+	size_t max_data_len;
+	size_t reachable_len;
+	size_t data_len;
+	size_t iov_nr;
+	bool is_final;
+	size_t i;
 
+	/* check input parameters */
 	if(comp == NULL)
 	{
 		goto error;
 	}
-
-	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-	          "force re-initialization for all %zu contexts",
-	          comp->num_contexts_used);
-
-	for(i = 0; i <= comp->medium.max_cid; i++)
+	if(segment_iov == NULL || segment_iov_nr == NULL)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "given segment buffers cannot be NULL");
+		goto error;
+	}
+	if((*segment_iov_nr) < 2)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "at least 2 buffers are required for one segment, only "
+		             "%zu given", *segment_iov_nr);
+		goto error;
+	}
+
+	/* abort if no RRU is available in the compressor */
+	if(comp->rru_count == 0)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "no RRU available in given compressor");
+		goto error;
+	}
+	rru = &comp->rru_slots[comp->rru_first];
+
+	/* abort is the given maximum length is too small for RRU */
+	if(max_len <= segment_type_len)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "maximum length is too small for RRU, more than %zd bytes "
+		             "are required", segment_type_len);
+		goto error;
+	}
+
+	/* how many bytes of ROHC packet can we put in that new segment? the
+	 * number of given buffers limits it too */
+	reachable_len = 0;
+	for(i = rru->piece_idx;
+	    i < rru->pieces_nr && (i - rru->piece_idx) < (*segment_iov_nr - 1);
+	    i++)
+	{
+		reachable_len += rru->pieces[i].len;
+	}
+	max_data_len = rohc_min(max_len - segment_type_len, rru->len);
+	max_data_len = rohc_min(max_data_len, reachable_len);
+	assert(max_data_len > 0);
+	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	           "give %zd bytes of the remaining %zd bytes of ROHC packet and "
+	           "CRC in the segment", max_data_len, rru->len);
+
+	/* set segment type with F bit set only for last segment */
+	is_final = (max_data_len == rru->len);
+	comp->rru_seg_type = 0xfe | is_final;
+	segment_iov[0] = (struct rohc_buf)
+		rohc_buf_init_full(&comp->rru_seg_type, segment_type_len, unknown_time);
+	iov_nr = 1;
+
+	/* point to remaining ROHC data (CRC included) */
+	for(data_len = 0; data_len < max_data_len; data_len += chunk.len)
+	{
+		chunk = rohc_comp_rru_pull(comp, max_data_len - data_len);
+		segment_iov[iov_nr] = (struct rohc_buf)
+			rohc_buf_init_full(chunk.data, chunk.len, unknown_time);
+		iov_nr++;
+	}
+	*segment_iov_nr = iov_nr;
+
+	/* set status wrt to (non-)final segment */
+	return (is_final ? ROHC_STATUS_OK : ROHC_STATUS_SEGMENT);
+
+error:
+	return ROHC_STATUS_ERROR;
+}
+
+
+/**
+ * @brief Force the compressor to re-initialize all its contexts
+ *
+ * Make all contexts restart their initialization with decompressor, ie. they
+ * go in the lowest compression state. This function can be used once the
+ * ROHC channel is established again after an interruption.
+ *
+ * The function implements the CONTEXT_REINITIALIZATION signal described by
+ * RFC 3095 at §6.3.1 as:
+ * \verbatim
+   CONTEXT_REINITIALIZATION -- signal
+   This parameter triggers a reinitialization of the entire context at
+   the decompressor, both the static and the dynamic part.  The
+   compressor MUST, when CONTEXT_REINITIALIZATION is triggered, back off
+   to the IR state and fully reinitialize the context by sending IR
+   packets with both the static and dynamic chains covering the entire
+   uncompressed headers until it is reasonably confident that the
+   decompressor contexts are reinitialized.  The context
+   reinitialization MUST be done for all contexts at the compressor.
+   This parameter may for instance be used to do context relocation at,
+   e.g., a cellular handover that results in a change of compression
+   point in the radio access network.
+\endverbatim
+ *
+ * All contexts are re-initialized at once by default. Re-initializing
+ * thousands of contexts at once makes all of them send IR packets with their
+ * full static and dynamic chains at the same time: see
+ * \ref rohc_comp_set_reinit_pacing to spread the re-initializations over the
+ * next packets instead.
+ *
+ * @param comp  The ROHC compressor
+ * @return      true in case of success, false otherwise
+ *
+ * @ingroup rohc_comp
+ */
+bool rohc_comp_force_contexts_reinit(struct rohc_comp *const comp)
+{
+	struct rohc_comp_ctxt *context;
+
+	if(comp == NULL)
+	{
+		goto error;
+	}
+
+	/* the cold contexts cannot be revived anymore, their flows will start
+	 * again with IR packets */
+	c_cold_flush(comp);
+
+	/* re-initialize the contexts a few at a time before the next packets,
+	 * the most recently used ones first */
+	if(comp->reinit_pacing > 0)
+	{
+		rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		          "force re-initialization for all %zu contexts, %zu contexts "
+		          "per packet", comp->num_contexts_used, comp->reinit_pacing);
+		comp->reinit_left_nr = 0;
+		for(context = comp->lru_tail; context != NULL; context = context->lru_prev)
+		{
+			comp->reinit_cids[comp->reinit_left_nr] = context->cid - comp->cid_base;
+			comp->reinit_left_nr++;
+		}
+		return true;
+	}
+	comp->reinit_left_nr = 0;
+
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	          "force re-initialization for all %zu contexts",
+	          comp->num_contexts_used);
+
+	/* the contexts in use are all in the LRU list */
+	for(context = comp->lru_head; context != NULL; context = context->lru_next)
 	{
-		if(comp->contexts[i].used)
+		if(!context->profile->reinit_context(context))
 		{
-			if(!comp->contexts[i].profile->reinit_context(&(comp->contexts[i])))
-			{
-				rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-				             "failed to force re-initialization for CID %zu", i);
-				goto error;
-			}
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "failed to force re-initialization for CID %zu",
+			             context->cid);
+			goto error;
 		}
 	}
 
@@ -994,6 +2652,174 @@ error:
 }
 
 
+/**
+ * @brief Set how many contexts are re-initialized per packet
+ *
+ * By default, \ref rohc_comp_force_contexts_reinit re-initializes all the
+ * contexts at once: every context then sends IR packets for its next packets,
+ * so a compressor with thousands of contexts sees a burst of CPU usage and
+ * bandwidth. With a pacing, \ref rohc_comp_force_contexts_reinit only
+ * schedules the re-initializations: \e ctxts_nr contexts are re-initialized
+ * before every packet given to the compressor, the most recently used ones
+ * first, until all contexts were re-initialized.
+ *
+ * The pacing is 0 by default, ie. all contexts are re-initialized at once.
+ * It may be changed at any time, a re-initialization in progress then goes
+ * on at the new pace.
+ *
+ * @param comp      The ROHC compressor
+ * @param ctxts_nr  The number of contexts re-initialized before every
+ *                  packet, 0 to re-initialize all contexts at once
+ * @return          true in case of success, false in case of failure
+ *
+ * @ingroup rohc_comp
+ */
+bool rohc_comp_set_reinit_pacing(struct rohc_comp *const comp,
+                                 const size_t ctxts_nr)
+{
+	if(comp == NULL)
+	{
+		return false;
+	}
+
+	comp->reinit_pacing = ctxts_nr;
+
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "re-initialize "
+	          "%zu contexts per packet", ctxts_nr);
+
+	return true;
+}
+
+
+/**
+ * @brief Release all the compression contexts at once
+ *
+ * Reset the compressor to the state it had before its first packet, for
+ * example when the link it compresses for went down and up again: all the
+ * contexts are released at once, the RRUs not yet retrieved and the feedback
+ * not yet delivered are dropped. Unlike freeing the compressor and creating
+ * it again, the memory of the compressor is kept and so is its configuration
+ * (profiles, features, MAX_CID, W-LSB width, MRRU, callbacks...). The
+ * statistics of the compressor are also kept.
+ *
+ * The bodies of the contexts are given back to their profiles: the ones
+ * allocated in advance are kept for the next flows (see
+ * \ref rohc_comp_set_ctxts_prealloc). The cold contexts are dropped.
+ *
+ * @param comp  The ROHC compressor
+ * @return      true in case of success, false in case of failure
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_force_contexts_reinit
+ */
+bool rohc_comp_reset(struct rohc_comp *const comp)
+{
+	struct rohc_comp_ctxt *context;
+	size_t ctxts_nr;
+	size_t i;
+
+	if(comp == NULL)
+	{
+		goto error;
+	}
+	ctxts_nr = comp->num_contexts_used;
+
+	/* the cold contexts hold no profile-specific part */
+	c_cold_flush(comp);
+
+	/* the contexts in use are all in the LRU list, give their bodies back
+	 * to their profiles */
+	for(context = comp->lru_head; context != NULL; context = context->lru_next)
+	{
+		assert(context->used);
+		c_ctxt_mem_del(comp, context);
+		context->profile->destroy(context);
+		context->used = 0;
+	}
+	rohc_seqlock_write_begin(&comp->stats_seq);
+	comp->num_contexts_used = 0;
+	rohc_seqlock_write_end(&comp->stats_seq);
+
+	/* then forget all the contexts at once instead of removing them one by
+	 * one from the index, the LRU list and the cache of profiles */
+	memset(comp->contexts_hot, 0, (comp->medium.max_cid + 1) *
+	       sizeof(struct rohc_comp_ctxt_hot));
+	memset(comp->contexts_index, 0, (comp->contexts_index_mask + 1) *
+	       sizeof(uint16_t));
+	c_profile_cache_flush(comp);
+	if(comp->rtp_detect != NULL)
+	{
+		memset(comp->rtp_detect->probation, 0, (comp->contexts_index_mask + 1) *
+		       sizeof(struct rohc_comp_rtp_probation));
+	}
+	for(i = 0; i <= comp->medium.max_cid; i++)
+	{
+		comp->free_cids[i] = comp->medium.max_cid - i;
+	}
+	comp->free_cids_nr = comp->medium.max_cid + 1;
+	comp->lru_head = NULL;
+	comp->lru_tail = NULL;
+	comp->last_context = NULL;
+	comp->reinit_left_nr = 0;
+
+	/* the RRUs and the feedback are related to the released contexts */
+	for(i = 0; i < comp->rru_slots_nr; i++)
+	{
+		comp->rru_slots[i].len = 0;
+		comp->rru_slots[i].pieces_nr = 0;
+		comp->rru_slots[i].piece_idx = 0;
+	}
+	comp->rru_first = 0;
+	comp->rru_count = 0;
+	__atomic_store_n(&comp->feedback_queue.tail,
+	                 __atomic_load_n(&comp->feedback_queue.head, __ATOMIC_ACQUIRE),
+	                 __ATOMIC_RELEASE);
+
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	          "compressor reset, %zu contexts released", ctxts_nr);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Re-initialize the next contexts scheduled for re-initialization
+ *
+ * @param comp  The ROHC compressor
+ *
+ * @see rohc_comp_set_reinit_pacing
+ */
+static void rohc_comp_reinit_next_ctxts(struct rohc_comp *const comp)
+{
+	size_t reinit_nr = 0;
+
+	while(comp->reinit_left_nr > 0 &&
+	      (comp->reinit_pacing == 0 || reinit_nr < comp->reinit_pacing))
+	{
+		size_t i;
+
+		comp->reinit_left_nr--;
+		i = comp->reinit_cids[comp->reinit_left_nr];
+
+		/* the context might have been released since */
+		if(comp->contexts_hot[i].used)
+		{
+			if(!comp->contexts[i].profile->reinit_context(&(comp->contexts[i])))
+			{
+				rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+				             "failed to force re-initialization for CID %zu",
+				             comp->contexts[i].cid);
+			}
+			reinit_nr++;
+		}
+	}
+}
+
+
 /**
  * @brief Set the window width for the W-LSB encoding scheme
  *
@@ -1005,8 +2831,16 @@ error:
  *
  * @warning The value must be a power of 2
  *
+ * @warning The width is fixed to 2 if the library is built with the
+ *          --enable-small-contexts option
+ *
  * @warning The value can not be modified after library initialization
  *
+ * If the \ref ROHC_COMP_FEATURE_ADAPTIVE_WLSB feature is enabled, the width
+ * is the largest one of the windows of every context: the windows of one
+ * context are narrowed by every positive ACK in O-mode or R-mode, and they
+ * are widened back by NACKs or by a long time without any feedback.
+ *
  * @param comp   The ROHC compressor
  * @param width  The width of the W-LSB sliding window
  * @return       true in case of success, false in case of failure
@@ -1037,6 +2871,16 @@ bool rohc_comp_set_wlsb_window_width(struct rohc_comp *const comp,
 		             "must be a power of 2", width);
 		return false;
 	}
+#if ROHC_SMALL_CONTEXTS == 1
+	if(width != ROHC_COMP_WLSB_WIDTH)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "failed to "
+		             "set width of W-LSB sliding window to %zd: window width "
+		             "is fixed to %u with small contexts", width,
+		             ROHC_COMP_WLSB_WIDTH);
+		return false;
+	}
+#endif
 
 	/* refuse to set a value if compressor is in use */
 	if(comp->num_packets > 0)
@@ -1051,92 +2895,418 @@ bool rohc_comp_set_wlsb_window_width(struct rohc_comp *const comp,
 	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 	          "width of W-LSB sliding window set to %zd", width);
 
+	/* the size of the context bodies depends on the window width */
+	if(!c_prealloc_all_ctxts(comp))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "failed to "
+		             "allocate the context bodies in advance, they will be "
+		             "allocated when contexts are created");
+	}
+
 	return true;
 }
 
 
 /**
- * @brief Set the timeout values for IR and FO periodic refreshes
+ * @brief Set the number of contexts to allocate in advance for every profile
  *
- * Set the timeout values for IR and FO periodic refreshes. The IR timeout
- * shall be greater than the FO timeout. Both timeouts are expressed in
- * number of compressed packets.
+ * The body of one context (its profile-specific part, W-LSB encoding objects
+ * included) is allocated when the context is created for a new flow. The
+ * compressor may allocate the bodies of some contexts in advance for every
+ * enabled profile instead, so that creating the contexts of the expected
+ * flows costs no memory allocation. The bodies of the released contexts are
+ * kept for the next flows.
  *
- * The IR timeout is set to \ref CHANGE_TO_IR_COUNT by default.
- * The FO timeout is set to \ref CHANGE_TO_FO_COUNT by default.
+ * The bodies are allocated at once for the profiles already enabled, and
+ * when the other profiles are enabled. Keep the hint small for the TCP
+ * profile, its contexts are large.
  *
- * @warning The values can not be modified after library initialization
+ * No context body is allocated in advance by default.
  *
- * @param comp        The ROHC compressor
- * @param ir_timeout  The number of packets to compress before going back
- *                    to IR state to force a context refresh
- * @param fo_timeout  The number of packets to compress before going back
- *                    to FO state to force a context refresh
- * @return            true in case of success, false in case of failure
+ * @param comp      The ROHC compressor
+ * @param ctxts_nr  The number of contexts expected per profile, at most the
+ *                  number of contexts of the compressor, 0 to allocate the
+ *                  context bodies only when contexts are created
+ * @return          true if the context bodies were allocated,
+ *                  false if the hint is invalid or if memory ran out
  *
  * @ingroup rohc_comp
+ *
+ * @see rohc_comp_enable_profile
+ * @see rohc_comp_set_wlsb_window_width
  */
-bool rohc_comp_set_periodic_refreshes(struct rohc_comp *const comp,
-                                      const size_t ir_timeout,
-                                      const size_t fo_timeout)
+bool rohc_comp_set_ctxts_prealloc(struct rohc_comp *const comp,
+                                  const size_t ctxts_nr)
 {
-	/* we need a valid compressor, positive non-zero timeouts,
-	 * and IR timeout > FO timeout */
 	if(comp == NULL)
 	{
-		return false;
+		goto error;
 	}
-	if(ir_timeout == 0 || fo_timeout == 0 || ir_timeout <= fo_timeout)
+	if(ctxts_nr > (comp->medium.max_cid + 1))
 	{
-		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "invalid "
-		             "timeouts for context periodic refreshes (IR timeout = %zd, "
-		             "FO timeout = %zd)", ir_timeout, fo_timeout);
-		return false;
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "failed to "
+		             "allocate %zu contexts in advance: only %zu contexts may "
+		             "be used", ctxts_nr, comp->medium.max_cid + 1);
+		goto error;
 	}
 
-	/* refuse to set values if compressor is in use */
-	if(comp->num_packets > 0)
+	comp->ctxts_prealloc_nr = ctxts_nr;
+	if(!c_prealloc_all_ctxts(comp))
 	{
-		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "unable to modify the timeouts for periodic refreshes "
-		             "after initialization");
-		return false;
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "failed to "
+		             "allocate %zu context bodies in advance", ctxts_nr);
+		goto error;
 	}
 
-	comp->periodic_refreshes_ir_timeout = ir_timeout;
-	comp->periodic_refreshes_fo_timeout = fo_timeout;
-
-	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "IR timeout for "
-	          "context periodic refreshes set to %zd", ir_timeout);
-	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "FO timeout for "
-	          "context periodic refreshes set to %zd", fo_timeout);
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	          "%zu context bodies allocated in advance per profile", ctxts_nr);
 
 	return true;
+
+error:
+	return false;
 }
 
 
 /**
- * @brief Set the number of uncompressed transmissions for list compression
+ * @brief Prepare the bodies of contexts of one profile before the traffic
  *
- * Set the number of transmissions required for list compression. This matches
- * the L parameter described in RFC 3095 and 4815. The compressor sends the
- * list items uncompressed L times before compressing them. The compressor
- * also sends the list structure L times before compressing it out.
+ * Allocate in advance the bodies of the given number of contexts for the
+ * given profile, and fill them with zeroes so that their memory is mapped
+ * before it is used. Call the function once the profile is enabled and
+ * before the traffic starts, so that opening many flows at once (after a
+ * link comes up for example) costs neither memory allocation nor page fault.
  *
- * The L parameter is set to \ref ROHC_LIST_DEFAULT_L by default.
- *
- * @warning The value can not be modified after library initialization
+ * The compressor keeps up to that number of context bodies for the profile,
+ * the bodies of the released contexts included. The bodies of the profile
+ * are allocated again with the number given to
+ * \ref rohc_comp_set_ctxts_prealloc if the W-LSB window width changes.
  *
- * @param comp           The ROHC compressor
- * @param list_trans_nr  The number of times the list items or the list itself
- *                       are sent uncompressed before being sent compressed
- * @return               true if the new value is accepted,
- *                       false if the value is rejected
+ * @param comp      The ROHC compressor
+ * @param profile   The profile of the contexts, it shall be enabled
+ * @param ctxts_nr  The number of contexts to prepare, at most the number of
+ *                  contexts of the compressor
+ * @return          true if the context bodies were prepared,
+ *                  false if the profile is not enabled, if it does not
+ *                  support the preparation of its contexts, if the number
+ *                  is invalid or if memory ran out
  *
  * @ingroup rohc_comp
+ *
+ * @see rohc_comp_set_ctxts_prealloc
  */
-bool rohc_comp_set_list_trans_nr(struct rohc_comp *const comp,
-                                 const size_t list_trans_nr)
+bool rohc_comp_prewarm_ctxts(struct rohc_comp *const comp,
+                             const rohc_profile_t profile,
+                             const size_t ctxts_nr)
+{
+	const struct rohc_comp_profile *comp_profile;
+	size_t profile_idx;
+
+	if(comp == NULL)
+	{
+		goto error;
+	}
+	if(ctxts_nr > (comp->medium.max_cid + 1))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "failed to "
+		             "prepare %zu contexts: only %zu contexts may be used",
+		             ctxts_nr, comp->medium.max_cid + 1);
+		goto error;
+	}
+
+	comp_profile = rohc_get_profile_from_id(comp, profile);
+	if(comp_profile == NULL || comp_profile->get_body_size == NULL)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "failed to "
+		             "prepare contexts: profile 0x%04x is not enabled or does "
+		             "not support it", profile);
+		goto error;
+	}
+	for(profile_idx = 0; comp->profiles[profile_idx] != comp_profile;
+	    profile_idx++)
+	{
+	}
+
+	if(!rohc_slab_reserve(&comp->ctxt_slabs[profile_idx],
+	                      comp_profile->get_body_size(comp), ctxts_nr,
+	                      comp->numa_node))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, profile, "failed to prepare %zu "
+		             "context bodies", ctxts_nr);
+		goto error;
+	}
+
+	rohc_info(comp, ROHC_TRACE_COMP, profile, "%zu context bodies prepared",
+	          ctxts_nr);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Set the timeout values for IR and FO periodic refreshes
+ *
+ * Set the timeout values for IR and FO periodic refreshes. The IR timeout
+ * shall be greater than the FO timeout. Both timeouts are expressed in
+ * number of compressed packets.
+ *
+ * The IR timeout is set to \ref CHANGE_TO_IR_COUNT by default.
+ * The FO timeout is set to \ref CHANGE_TO_FO_COUNT by default.
+ *
+ * @warning The values can not be modified after library initialization
+ *
+ * @param comp        The ROHC compressor
+ * @param ir_timeout  The number of packets to compress before going back
+ *                    to IR state to force a context refresh
+ * @param fo_timeout  The number of packets to compress before going back
+ *                    to FO state to force a context refresh
+ * @return            true in case of success, false in case of failure
+ *
+ * @ingroup rohc_comp
+ */
+bool rohc_comp_set_periodic_refreshes(struct rohc_comp *const comp,
+                                      const size_t ir_timeout,
+                                      const size_t fo_timeout)
+{
+	/* we need a valid compressor, positive non-zero timeouts,
+	 * and IR timeout > FO timeout */
+	if(comp == NULL)
+	{
+		return false;
+	}
+	if(ir_timeout == 0 || fo_timeout == 0 || ir_timeout <= fo_timeout)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "invalid "
+		             "timeouts for context periodic refreshes (IR timeout = %zd, "
+		             "FO timeout = %zd)", ir_timeout, fo_timeout);
+		return false;
+	}
+
+	/* refuse to set values if compressor is in use */
+	if(comp->num_packets > 0)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "unable to modify the timeouts for periodic refreshes "
+		             "after initialization");
+		return false;
+	}
+
+	comp->periodic_refreshes_ir_timeout = ir_timeout;
+	comp->periodic_refreshes_fo_timeout = fo_timeout;
+
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "IR timeout for "
+	          "context periodic refreshes set to %zd", ir_timeout);
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "FO timeout for "
+	          "context periodic refreshes set to %zd", fo_timeout);
+
+	return true;
+}
+
+
+/**
+ * @brief Set the time-based timeouts for IR and FO periodic refreshes
+ *
+ * Set the timeout values for IR and FO periodic refreshes in addition to
+ * the timeouts in number of packets set by
+ * \ref rohc_comp_set_periodic_refreshes: a context goes back to FO state
+ * once \e fo_timeout milliseconds elapsed in SO state since its last change
+ * to FO state, and back to IR state once \e ir_timeout milliseconds elapsed
+ * since its last change to IR state, whatever the number of packets sent in
+ * the meantime. The IR timeout shall be greater than the FO timeout.
+ *
+ * The refreshes are checked when packets are compressed, at no cost for the
+ * idle contexts. They rely on the arrival times of the packets given to
+ * \ref rohc_compress4, so they are never triggered if the arrival times are
+ * unknown (set to 0).
+ *
+ * Both timeouts are 0 by default, ie. time-based periodic refreshes are
+ * disabled.
+ *
+ * @warning The values can not be modified after library initialization
+ *
+ * @param comp        The ROHC compressor
+ * @param ir_timeout  The time (in milliseconds) after which the context goes
+ *                    back to IR state to force a context refresh,
+ *                    0 to disable (then \e fo_timeout shall be 0 too)
+ * @param fo_timeout  The time (in milliseconds) after which the context goes
+ *                    back to FO state to force a context refresh,
+ *                    0 to disable
+ * @return            true in case of success, false in case of failure
+ *
+ * @ingroup rohc_comp
+ */
+bool rohc_comp_set_periodic_refreshes_time(struct rohc_comp *const comp,
+                                           const size_t ir_timeout,
+                                           const size_t fo_timeout)
+{
+	/* we need a valid compressor and IR timeout > FO timeout unless both
+	 * are disabled */
+	if(comp == NULL)
+	{
+		return false;
+	}
+	if(ir_timeout == 0 && fo_timeout != 0)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "invalid "
+		             "timeouts for context periodic refreshes: FO timeout "
+		             "(%zu ms) without IR timeout", fo_timeout);
+		return false;
+	}
+	if(ir_timeout != 0 && fo_timeout != 0 && ir_timeout <= fo_timeout)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "invalid "
+		             "timeouts for context periodic refreshes (IR timeout = "
+		             "%zu ms, FO timeout = %zu ms)",
+		             ir_timeout, fo_timeout);
+		return false;
+	}
+
+	/* refuse to set values if compressor is in use */
+	if(comp->num_packets > 0)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "unable to modify the timeouts for periodic refreshes "
+		             "after initialization");
+		return false;
+	}
+
+	comp->periodic_refreshes_ir_time = ir_timeout;
+	comp->periodic_refreshes_fo_time = fo_timeout;
+
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "IR timeout for "
+	          "context periodic refreshes set to %zu ms", ir_timeout);
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "FO timeout for "
+	          "context periodic refreshes set to %zu ms", fo_timeout);
+
+	return true;
+}
+
+
+/**
+ * @brief Set the time after which unused contexts are released
+ *
+ * By default, a context is kept until its CID is needed for a new context
+ * while all the CIDs are in use. With an idle timeout, a context that did
+ * not compress any packet for \e idle_timeout seconds is released, so that
+ * its CID and its memory are available again for the new flows.
+ *
+ * The contexts are kept ordered from the most to the least recently used
+ * one, so releasing the idle contexts costs nothing more than one check of
+ * the least recently used context per compressed packet. The idle timeout
+ * relies on the arrival times of the packets given to \ref rohc_compress4,
+ * so contexts are never released if the arrival times are unknown (set to 0).
+ *
+ * If the \ref ROHC_COMP_FEATURE_COLD_CTXTS feature is enabled, the idle
+ * contexts are moved to a cold store instead: they are saved in the compact
+ * format of snapshots (see \ref rohc_comp_snapshot), their profile-specific
+ * parts are released, but they keep their CIDs. When the flow of one cold
+ * context comes back, the context is revived from the cold store with its
+ * CID, its mode and its state, so the flow goes on without any IR packet
+ * and without re-building its context. The cold contexts give their CIDs
+ * up, the oldest one first, only once no CID is free anymore: the new flows
+ * then take the CIDs of the cold contexts before the CIDs of the contexts
+ * in use. The decompressor shall keep the contexts of the cold CIDs too: its
+ * idle timeout shall be longer, or its own cold store shall be enabled (see
+ * \ref ROHC_DECOMP_FEATURE_COLD_CTXTS). Only the contexts of the profiles
+ * that support snapshots are moved to the cold store, the other ones are
+ * released.
+ *
+ * The idle timeout is 0 by default, ie. the contexts are never released
+ * because of inactivity. It may be changed at any time.
+ *
+ * @param comp          The ROHC compressor
+ * @param idle_timeout  The time (in seconds) after which an unused context
+ *                      is released, 0 to disable
+ * @return              true in case of success, false in case of failure
+ *
+ * @ingroup rohc_comp
+ */
+bool rohc_comp_set_ctxt_idle_timeout(struct rohc_comp *const comp,
+                                     const size_t idle_timeout)
+{
+	if(comp == NULL)
+	{
+		return false;
+	}
+
+	comp->ctxt_idle_timeout = idle_timeout;
+
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "idle timeout for "
+	          "contexts set to %zu seconds", idle_timeout);
+
+	return true;
+}
+
+
+/**
+ * @brief Set how long a flow skips the profile that failed to compress it
+ *
+ * When the best profile for a packet fails to encode it, the packet is
+ * compressed with the Uncompressed profile instead. By default, the next
+ * packets of the flow are given to the failing profile again, so flows that
+ * the profile always rejects late cost two context searches and two
+ * encodings per packet. With a failure timeout, the next packets of the flow
+ * go straight to the Uncompressed profile for \e timeout seconds, then the
+ * profile is given another chance.
+ *
+ * The failures are remembered in the cache of the profiles that classified
+ * the flows, so one failure may be forgotten earlier if another flow takes
+ * its entry. The failure timeout relies on the arrival times of the packets
+ * given to \ref rohc_compress4, so failures are not remembered if the
+ * arrival times are unknown (set to 0).
+ *
+ * The failure timeout is 0 by default, ie. the failing profile is tried
+ * again for every packet. It may be changed at any time.
+ *
+ * @param comp     The ROHC compressor
+ * @param timeout  The time (in seconds) during which the packets of a flow
+ *                 skip the profile that failed, 0 to disable
+ * @return         true in case of success, false in case of failure
+ *
+ * @ingroup rohc_comp
+ */
+bool rohc_comp_set_profile_failure_timeout(struct rohc_comp *const comp,
+                                           const size_t timeout)
+{
+	if(comp == NULL)
+	{
+		return false;
+	}
+
+	comp->profile_failure_timeout = timeout;
+
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "flows skip their "
+	          "failing profile for %zu seconds", timeout);
+
+	return true;
+}
+
+
+/**
+ * @brief Set the number of uncompressed transmissions for list compression
+ *
+ * Set the number of transmissions required for list compression. This matches
+ * the L parameter described in RFC 3095 and 4815. The compressor sends the
+ * list items uncompressed L times before compressing them. The compressor
+ * also sends the list structure L times before compressing it out.
+ *
+ * The L parameter is set to \ref ROHC_LIST_DEFAULT_L by default.
+ *
+ * @warning The value can not be modified after library initialization
+ *
+ * @param comp           The ROHC compressor
+ * @param list_trans_nr  The number of times the list items or the list itself
+ *                       are sent uncompressed before being sent compressed
+ * @return               true if the new value is accepted,
+ *                       false if the value is rejected
+ *
+ * @ingroup rohc_comp
+ */
+bool rohc_comp_set_list_trans_nr(struct rohc_comp *const comp,
+                                 const size_t list_trans_nr)
 {
 	/* we need a valid compressor and a positive non-zero value for L */
 	if(comp == NULL)
@@ -1213,9 +3383,9 @@ bool rohc_comp_set_list_trans_nr(struct rohc_comp *const comp,
  * \snippet simple_rohc_program.c destroy ROHC compressor
  *
  * @see rohc_rtp_detection_callback_t
- * @see rohc_comp_add_rtp_port
- * @see rohc_comp_remove_rtp_port
- * @see rohc_comp_reset_rtp_ports
+ * @see rohc_comp_add_rtp_ports
+ * @see rohc_comp_remove_rtp_ports
+ * @see rohc_comp_set_rtp_min_sequential
  */
 bool rohc_comp_set_rtp_detection_cb(struct rohc_comp *const comp,
                                     rohc_rtp_detection_callback_t callback,
@@ -1230,59 +3400,110 @@ bool rohc_comp_set_rtp_detection_cb(struct rohc_comp *const comp,
 	/* set RTP detection callback */
 	comp->rtp_callback = callback;
 	comp->rtp_private = rtp_private;
+	c_profile_cache_flush(comp);
 
 	return true;
 }
 
 
 /**
- * @brief Is the given compression profile enabled for a compressor?
+ * @brief Add a range of UDP ports to the built-in RTP detection
  *
- * Is the given compression profile enabled or disabled for a compressor?
+ * When no RTP detection callback is set (see
+ * \ref rohc_comp_set_rtp_detection_cb), the UDP packets are detected as RTP
+ * by the library itself: the UDP destination port shall be one of the ports
+ * reserved for RTP, the RTP header shall be sane (version 2, not an RTCP
+ * packet multiplexed on the RTP port as in RFC 5761) and the RTP stream shall
+ * have received enough packets in sequence (see
+ * \ref rohc_comp_set_rtp_min_sequential).
  *
- * @param comp     The ROHC compressor
- * @param profile  The profile to ask status for
- * @return         Possible return values:
- *                  \li true if the profile exists and is enabled,
- *                  \li false if the compressor is not valid, the profile
- *                      does not exist, or the profile is disabled
+ * No port is reserved for RTP by default.
+ *
+ * @param comp      The ROHC compressor
+ * @param port_min  The first UDP port of the range
+ * @param port_max  The last UDP port of the range
+ * @return          true if the ports were added,
+ *                  false if the range is invalid or in case of memory error
  *
  * @ingroup rohc_comp
  *
- * @see rohc_comp_enable_profile
- * @see rohc_comp_enable_profiles
- * @see rohc_comp_disable_profile
- * @see rohc_comp_disable_profiles
+ * @see rohc_comp_remove_rtp_ports
+ * @see rohc_comp_set_rtp_min_sequential
+ * @see rohc_comp_set_rtp_detection_cb
  */
-bool rohc_comp_profile_enabled(const struct rohc_comp *const comp,
-                               const rohc_profile_t profile)
+bool rohc_comp_add_rtp_ports(struct rohc_comp *const comp,
+                             const uint16_t port_min,
+                             const uint16_t port_max)
 {
-	size_t i;
+	size_t port;
 
-	if(comp == NULL)
+	if(comp == NULL || port_min > port_max || !c_rtp_detect_alloc(comp))
 	{
 		goto error;
 	}
 
-	/* search the profile location */
-	for(i = 0; i < C_NUM_PROFILES; i++)
+	for(port = port_min; port <= port_max; port++)
 	{
-		if(rohc_comp_profiles[i]->id == profile)
+		const uint64_t bit = ((uint64_t) 1) << (port % 64);
+
+		if((comp->rtp_detect->ports[port / 64] & bit) == 0)
 		{
-			/* found */
-			break;
+			comp->rtp_detect->ports[port / 64] |= bit;
+			comp->rtp_detect->ports_nr++;
 		}
 	}
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	          "UDP ports %u-%u reserved for RTP (%zu ports in total)",
+	          port_min, port_max, comp->rtp_detect->ports_nr);
+	c_profile_cache_flush(comp);
+
+	return true;
+
+error:
+	return false;
+}
 
-	if(i == C_NUM_PROFILES)
+
+/**
+ * @brief Remove a range of UDP ports from the built-in RTP detection
+ *
+ * @param comp      The ROHC compressor
+ * @param port_min  The first UDP port of the range
+ * @param port_max  The last UDP port of the range
+ * @return          true if the ports were removed (or were not reserved),
+ *                  false if the range is invalid
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_add_rtp_ports
+ */
+bool rohc_comp_remove_rtp_ports(struct rohc_comp *const comp,
+                                const uint16_t port_min,
+                                const uint16_t port_max)
+{
+	size_t port;
+
+	if(comp == NULL || port_min > port_max)
 	{
-		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "unknown ROHC compression profile (ID = %d)", profile);
 		goto error;
 	}
 
-	/* return profile status */
-	return comp->enabled_profiles[i];
+	if(comp->rtp_detect != NULL)
+	{
+		for(port = port_min; port <= port_max; port++)
+		{
+			const uint64_t bit = ((uint64_t) 1) << (port % 64);
+
+			if((comp->rtp_detect->ports[port / 64] & bit) != 0)
+			{
+				comp->rtp_detect->ports[port / 64] &= ~bit;
+				comp->rtp_detect->ports_nr--;
+			}
+		}
+		c_profile_cache_flush(comp);
+	}
+
+	return true;
 
 error:
 	return false;
@@ -1290,20 +3511,303 @@ error:
 
 
 /**
- * @brief Enable a compression profile for a compressor
+ * @brief Set the number of packets in sequence required to detect RTP
  *
- * Enable a compression profiles for a compressor.
+ * With the built-in RTP detection, a new RTP stream is compressed with the
+ * UDP profile until it received the given number of packets with the same
+ * SSRC and consecutive sequence numbers, like the probation of new sources
+ * of RFC 3550. Once detected, the stream stays RTP as long as its SSRC does
+ * not change.
  *
- * The ROHC compressor does not use the compression profiles that are not
- * enabled. Thus not enabling a profile might affect compression performances.
- * Compression will fail if no profile at all is enabled.
+ * The default value is 1: the first packet of a stream is detected as RTP.
  *
- * If the profile is already enabled, nothing is performed and success is
- * reported.
+ * @param comp        The ROHC compressor
+ * @param packets_nr  The number of packets in sequence, in range [1, 65535]
+ * @return            true if the number was set,
+ *                    false if it is invalid or in case of memory error
  *
- * @param comp     The ROHC compressor
- * @param profile  The profile to enable
- * @return         true if the profile exists,
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_add_rtp_ports
+ */
+bool rohc_comp_set_rtp_min_sequential(struct rohc_comp *const comp,
+                                      const size_t packets_nr)
+{
+	if(comp == NULL || packets_nr < 1 || packets_nr > UINT16_MAX ||
+	   !c_rtp_detect_alloc(comp))
+	{
+		goto error;
+	}
+
+	comp->rtp_detect->min_sequential = packets_nr;
+	memset(comp->rtp_detect->probation, 0, (comp->contexts_index_mask + 1) *
+	       sizeof(struct rohc_comp_rtp_probation));
+	c_profile_cache_flush(comp);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Allocate the built-in RTP detection if not done yet
+ *
+ * @param comp  The ROHC compressor
+ * @return      true if the built-in RTP detection is allocated,
+ *              false in case of memory error
+ */
+static bool c_rtp_detect_alloc(struct rohc_comp *const comp)
+{
+	if(comp->rtp_detect == NULL)
+	{
+		comp->rtp_detect = calloc(1, sizeof(struct rohc_comp_rtp_detect) +
+		                          (comp->contexts_index_mask + 1) *
+		                          sizeof(struct rohc_comp_rtp_probation));
+		if(comp->rtp_detect == NULL)
+		{
+			rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			           "cannot allocate memory for the RTP detection");
+			goto error;
+		}
+		comp->rtp_detect->min_sequential = 1;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Detect RTP packets with the built-in RTP detection
+ *
+ * @param comp         The ROHC compressor
+ * @param packet       The UDP packet to check
+ * @param udp          The UDP header of the packet
+ * @param payload      The UDP payload of the packet
+ * @param payload_len  The length of the UDP payload
+ * @return             true if the packet is an RTP packet, false otherwise
+ *
+ * @see rohc_comp_add_rtp_ports
+ * @see rohc_comp_set_rtp_min_sequential
+ */
+bool rohc_comp_rtp_detect(const struct rohc_comp *const comp,
+                          const struct net_pkt *const packet,
+                          const uint8_t *const udp,
+                          const uint8_t *const payload,
+                          const size_t payload_len)
+{
+	struct rohc_comp_rtp_detect *const detect = comp->rtp_detect;
+	const struct rtphdr *const rtp = (const struct rtphdr *) payload;
+	struct rohc_comp_rtp_probation *entry;
+	uint16_t dport;
+	uint16_t sn;
+
+	assert(detect != NULL);
+
+	/* is the UDP destination port reserved for RTP? */
+	memcpy(&dport, udp + 2, sizeof(uint16_t));
+	dport = rohc_ntoh16(dport);
+	if((detect->ports[dport / 64] & (((uint64_t) 1) << (dport % 64))) == 0)
+	{
+		return false;
+	}
+
+	/* is the RTP header sane? RTCP packets multiplexed on the RTP port look
+	 * like RTP packets with payload types 72-76 (RFC 5761) */
+	if(payload_len < sizeof(struct rtphdr) || rtp->version != 2)
+	{
+		return false;
+	}
+	if(rtp->pt >= 72 && rtp->pt <= 76)
+	{
+		return false;
+	}
+
+	/* no probation for new streams? */
+	if(detect->min_sequential <= 1)
+	{
+		return true;
+	}
+
+	/* new streams are on probation until enough packets were received in
+	 * sequence, detected streams stay RTP as long as their SSRC is the same */
+	entry = &detect->probation[c_ctxt_index_hash(comp, ROHC_PROFILE_RTP,
+	                                             packet->key)];
+	sn = rohc_ntoh16(rtp->sn);
+	if(entry->count == 0 || entry->key != packet->key || entry->ssrc != rtp->ssrc)
+	{
+		entry->key = packet->key;
+		entry->ssrc = rtp->ssrc;
+		entry->count = 1;
+	}
+	else if(entry->count < detect->min_sequential)
+	{
+		if(sn == ((uint16_t) (entry->sn + 1)))
+		{
+			entry->count++;
+		}
+		else
+		{
+			entry->count = 1;
+		}
+	}
+	entry->sn = sn;
+
+	return (entry->count >= detect->min_sequential);
+}
+
+
+/**
+ * @brief Is the flow of the given packet on probation for RTP detection?
+ *
+ * @param comp    The ROHC compressor
+ * @param packet  The packet to check
+ * @return        true if the flow may be detected as RTP later,
+ *                false otherwise
+ */
+static bool c_rtp_on_probation(const struct rohc_comp *const comp,
+                               const struct net_pkt *const packet)
+{
+	const struct rohc_comp_rtp_detect *const detect = comp->rtp_detect;
+	const struct rohc_comp_rtp_probation *entry;
+
+	if(detect == NULL || detect->min_sequential <= 1 ||
+	   comp->rtp_callback != NULL)
+	{
+		return false;
+	}
+
+	entry = &detect->probation[c_ctxt_index_hash(comp, ROHC_PROFILE_RTP,
+	                                             packet->key)];
+	return (entry->count > 0 && entry->key == packet->key &&
+	        entry->count < detect->min_sequential);
+}
+
+
+/**
+ * @brief Allocate in advance the context bodies of one profile
+ *
+ * The bodies already allocated in advance are released first, since their
+ * size may have changed with the W-LSB window width.
+ *
+ * @param comp         The ROHC compressor
+ * @param profile_idx  The index of the profile
+ * @return             true if the bodies were allocated,
+ *                     false if memory ran out
+ */
+static bool c_prealloc_ctxts(struct rohc_comp *const comp,
+                             const size_t profile_idx)
+{
+	const struct rohc_comp_profile *const profile = comp->profiles[profile_idx];
+	struct rohc_slab *const slab = &comp->ctxt_slabs[profile_idx];
+
+	rohc_slab_fini(slab);
+	if(!comp->enabled_profiles[profile_idx] ||
+	   comp->ctxts_prealloc_nr == 0 ||
+	   profile->get_body_size == NULL)
+	{
+		return true;
+	}
+
+	return rohc_slab_init(slab, profile->get_body_size(comp),
+	                      comp->ctxts_prealloc_nr, comp->numa_node);
+}
+
+
+/**
+ * @brief Allocate in advance the context bodies of all the enabled profiles
+ *
+ * @param comp  The ROHC compressor
+ * @return      true if the bodies were allocated,
+ *              false if memory ran out
+ */
+static bool c_prealloc_all_ctxts(struct rohc_comp *const comp)
+{
+	bool is_fine = true;
+	size_t i;
+
+	for(i = 0; i < comp->profiles_nr; i++)
+	{
+		is_fine = c_prealloc_ctxts(comp, i) && is_fine;
+	}
+
+	return is_fine;
+}
+
+
+/**
+ * @brief Is the given compression profile enabled for a compressor?
+ *
+ * Is the given compression profile enabled or disabled for a compressor?
+ *
+ * @param comp     The ROHC compressor
+ * @param profile  The profile to ask status for
+ * @return         Possible return values:
+ *                  \li true if the profile exists and is enabled,
+ *                  \li false if the compressor is not valid, the profile
+ *                      does not exist, or the profile is disabled
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_enable_profile
+ * @see rohc_comp_enable_profiles
+ * @see rohc_comp_disable_profile
+ * @see rohc_comp_disable_profiles
+ */
+bool rohc_comp_profile_enabled(const struct rohc_comp *const comp,
+                               const rohc_profile_t profile)
+{
+	bool is_found = false;
+	size_t i;
+
+	if(comp == NULL)
+	{
+		goto error;
+	}
+
+	/* the profile is enabled if one of the profiles with its ID is */
+	for(i = 0; i < comp->profiles_nr; i++)
+	{
+		if(comp->profiles[i]->id == profile)
+		{
+			if(comp->enabled_profiles[i])
+			{
+				return true;
+			}
+			is_found = true;
+		}
+	}
+
+	if(!is_found)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "unknown ROHC compression profile (ID = %d)", profile);
+	}
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Enable a compression profile for a compressor
+ *
+ * Enable a compression profiles for a compressor.
+ *
+ * The ROHC compressor does not use the compression profiles that are not
+ * enabled. Thus not enabling a profile might affect compression performances.
+ * Compression will fail if no profile at all is enabled.
+ *
+ * If the profile is already enabled, nothing is performed and success is
+ * reported.
+ *
+ * @param comp     The ROHC compressor
+ * @param profile  The profile to enable
+ * @return         true if the profile exists,
  *                 false if the profile does not exist
  *
  * @ingroup rohc_comp
@@ -1325,6 +3829,7 @@ error:
 bool rohc_comp_enable_profile(struct rohc_comp *const comp,
                               const rohc_profile_t profile)
 {
+	bool is_found = false;
 	size_t i;
 
 	if(comp == NULL)
@@ -1332,25 +3837,37 @@ bool rohc_comp_enable_profile(struct rohc_comp *const comp,
 		goto error;
 	}
 
-	/* search the profile location */
-	for(i = 0; i < C_NUM_PROFILES; i++)
+	/* mark all the profiles with the ID as enabled, the built-in one and
+	 * the registered ones */
+	for(i = 0; i < comp->profiles_nr; i++)
 	{
-		if(rohc_comp_profiles[i]->id == profile)
+		bool was_enabled;
+
+		if(comp->profiles[i]->id != profile)
 		{
-			/* found */
-			break;
+			continue;
+		}
+		is_found = true;
+		was_enabled = comp->enabled_profiles[i];
+		comp->enabled_profiles[i] = true;
+
+		/* allocate the bodies of the expected contexts the first time the
+		 * profile is enabled */
+		if(!was_enabled && !c_prealloc_ctxts(comp, i))
+		{
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "failed to "
+			             "allocate context bodies in advance for profile 0x%04x",
+			             profile);
 		}
 	}
 
-	if(i == C_NUM_PROFILES)
+	if(!is_found)
 	{
 		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 		             "unknown ROHC compression profile (ID = %d)", profile);
 		goto error;
 	}
-
-	/* mark the profile as enabled */
-	comp->enabled_profiles[i] = true;
+	c_profile_cache_flush(comp);
 	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 	          "ROHC compression profile (ID = %d) enabled", profile);
 
@@ -1387,6 +3904,7 @@ error:
 bool rohc_comp_disable_profile(struct rohc_comp *const comp,
                                const rohc_profile_t profile)
 {
+	bool is_found = false;
 	size_t i;
 
 	if(comp == NULL)
@@ -1394,25 +3912,25 @@ bool rohc_comp_disable_profile(struct rohc_comp *const comp,
 		goto error;
 	}
 
-	/* search the profile location */
-	for(i = 0; i < C_NUM_PROFILES; i++)
+	/* mark all the profiles with the ID as disabled, and release the context
+	 * bodies allocated in advance */
+	for(i = 0; i < comp->profiles_nr; i++)
 	{
-		if(rohc_comp_profiles[i]->id == profile)
+		if(comp->profiles[i]->id == profile)
 		{
-			/* found */
-			break;
+			is_found = true;
+			comp->enabled_profiles[i] = false;
+			rohc_slab_fini(&comp->ctxt_slabs[i]);
 		}
 	}
 
-	if(i == C_NUM_PROFILES)
+	if(!is_found)
 	{
 		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 		             "unknown ROHC compression profile (ID = %d)", profile);
 		goto error;
 	}
-
-	/* mark the profile as disabled */
-	comp->enabled_profiles[i] = false;
+	c_profile_cache_flush(comp);
 	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 	          "ROHC compression profile (ID = %d) disabled", profile);
 
@@ -1549,6 +4067,129 @@ error:
 }
 
 
+/**
+ * @brief Register an additional compression profile in a compressor
+ *
+ * The profile is added to the profiles built in the library, for this
+ * compressor only. It is enabled once registered.
+ *
+ * The registered profiles are evaluated before the built-in ones, by
+ * decreasing priority, then in their order of registration. A registered
+ * profile may thus take the packets of one specific shape, and leave all
+ * the other packets to the generic profiles. It shall use the ID of one of
+ * the standard profiles since the decompressor identifies the profile with
+ * it. The profiles of one ID are enabled and disabled together, and the
+ * contexts restored from snapshots or from the cold store are given to the
+ * first enabled one: profiles that share one ID shall share the format of
+ * their snapshots, or not save their contexts at all.
+ *
+ * The profile shall be built against the internal headers of the very same
+ * version of the library, since its structure is private. The profile shall
+ * outlive the compressor.
+ *
+ * The profiles shall be registered before the first packet is compressed.
+ *
+ * @param comp      The ROHC compressor
+ * @param profile   The compression profile to register
+ * @param priority  The priority of the profile among the registered ones,
+ *                  the higher the sooner the profile is evaluated
+ * @return          true if the profile was registered,
+ *                  false if the profile is invalid, if the compressor
+ *                  already compressed packets, or if the compressor
+ *                  cannot accept more profiles
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_enable_profile
+ * @see rohc_comp_disable_profile
+ */
+bool rohc_comp_register_profile(struct rohc_comp *const comp,
+                                const struct rohc_comp_profile *const profile,
+                                const int priority)
+{
+	size_t registered_nr;
+	size_t idx;
+	size_t pos;
+	size_t i;
+
+	if(comp == NULL || profile == NULL)
+	{
+		goto error;
+	}
+	if(profile->id >= ROHC_PROFILE_MAX ||
+	   profile->create == NULL || profile->destroy == NULL ||
+	   profile->check_profile == NULL || profile->check_context == NULL ||
+	   profile->encode == NULL || profile->reinit_context == NULL ||
+	   profile->feedback == NULL)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "failed to register profile: invalid profile");
+		goto error;
+	}
+	if(comp->num_packets > 0 || comp->num_contexts_used > 0)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "failed to register profile 0x%04x: compressor already "
+		             "compressed packets", profile->id);
+		goto error;
+	}
+	if(comp->profiles_nr >= C_MAX_PROFILES)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "failed to register profile 0x%04x: no more than %u "
+		             "additional profiles", profile->id,
+		             ROHC_COMP_EXTRA_PROFILES_MAX);
+		goto error;
+	}
+	for(i = 0; i < comp->profiles_nr; i++)
+	{
+		if(comp->profiles[i] == profile)
+		{
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "failed to register profile 0x%04x: profile already "
+			             "registered", profile->id);
+			goto error;
+		}
+	}
+
+	/* add the profile after the other ones */
+	idx = comp->profiles_nr;
+	comp->profiles[idx] = profile;
+	comp->profiles_prio[idx] = priority;
+	comp->enabled_profiles[idx] = true;
+	comp->profiles_nr++;
+
+	/* evaluate the profile after the registered profiles of higher or same
+	 * priority, but before the other ones and before the built-in ones */
+	registered_nr = idx - C_NUM_PROFILES;
+	for(pos = 0; pos < registered_nr &&
+	             comp->profiles_prio[comp->profiles_order[pos]] >= priority; pos++)
+	{
+	}
+	for(i = idx; i > pos; i--)
+	{
+		comp->profiles_order[i] = comp->profiles_order[i - 1];
+	}
+	comp->profiles_order[pos] = idx;
+	c_profile_cache_flush(comp);
+
+	if(!c_prealloc_ctxts(comp, idx))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "failed to "
+		             "allocate context bodies in advance for profile 0x%04x",
+		             profile->id);
+	}
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "ROHC compression "
+	          "profile (ID = %d) registered with priority %d", profile->id,
+	          priority);
+
+	return true;
+
+error:
+	return false;
+}
+
+
 /**
  * @brief Set the Maximum Reconstructed Reception Unit (MRRU).
  *
@@ -1565,6 +4206,10 @@ error:
  * If set to 0, segmentation is disabled as no segment headers are allowed
  * on the channel. No segment will be generated.
  *
+ * The memory for the RRU is allocated with the MRRU size when segmentation
+ * is enabled, and freed when segmentation is disabled. The MRRU cannot be
+ * set lower than the RRU that was not retrieved yet.
+ *
  * If segmentation is enabled and used by the compressor, the function
  * \ref rohc_comp_get_segment2 can be used to retrieve ROHC segments.
  *
@@ -1592,6 +4237,8 @@ error:
 bool rohc_comp_set_mrru(struct rohc_comp *const comp,
                         const size_t mrru)
 {
+	size_t i;
+
 	/* compressor must be valid */
 	if(comp == NULL)
 	{
@@ -1608,6 +4255,47 @@ bool rohc_comp_set_mrru(struct rohc_comp *const comp,
 		goto error;
 	}
 
+	/* resize the RRU buffer to the new MRRU, but keep the RRU that is still
+	 * waiting to be split into segments */
+	if(mrru != comp->mrru)
+	{
+		uint8_t *new_rru = NULL;
+
+		for(i = 0; i < comp->rru_count; i++)
+		{
+			const size_t slot = (comp->rru_first + i) % comp->rru_slots_nr;
+
+			if(comp->rru_slots[slot].len > mrru)
+			{
+				rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+				             "cannot set MRRU to %zu bytes while the %zu-byte RRU "
+				             "was not retrieved yet", mrru,
+				             comp->rru_slots[slot].len);
+				goto error;
+			}
+		}
+		if(mrru > 0)
+		{
+			new_rru = malloc(mrru * comp->rru_slots_nr);
+			if(new_rru == NULL)
+			{
+				rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+				             "failed to allocate memory for the %zu-byte RRU",
+				             mrru);
+				goto error;
+			}
+			for(i = 0; i < comp->rru_count; i++)
+			{
+				const size_t slot = (comp->rru_first + i) % comp->rru_slots_nr;
+				rohc_comp_rru_move(comp, &comp->rru_slots[slot],
+				                   new_rru + slot * mrru);
+			}
+		}
+		zfree(comp->rru);
+		comp->rru = new_rru;
+		rohc_comp_rru_assign(comp, comp->rru, mrru, comp->rru_slots_nr);
+	}
+
 	/* set new MRRU */
 	comp->mrru = mrru;
 	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
@@ -1678,7 +4366,90 @@ error:
 
 
 /**
- * @brief Get the maximal CID value the compressor uses
+ * @brief Set the number of RRUs that may wait to be split into segments
+ *
+ * By default, the compressor keeps one Reconstructed Reception Unit (RRU)
+ * only: the segments of a segmented ROHC packet shall be retrieved with
+ * \ref rohc_comp_get_segment2 before the next packet that requires
+ * segmentation is compressed, otherwise the RRU not retrieved yet is lost.
+ *
+ * With several slots, several packets that require segmentation may be
+ * compressed in one burst, the segments being retrieved later: the RRUs are
+ * kept in a ring, and \ref rohc_comp_get_segment2 gives the segments of the
+ * oldest RRU first, \ref ROHC_STATUS_OK being returned for the final
+ * segment of every RRU. The segments of one RRU shall not be interleaved
+ * with the segments of another RRU on the channel, but they may be
+ * interleaved with non-segmented ROHC packets. If all the slots are used,
+ * the oldest RRU is lost.
+ *
+ * Every slot requires MRRU bytes of memory once segmentation is enabled
+ * (see \ref rohc_comp_set_mrru). The number of slots cannot be changed while
+ * some RRUs are waiting to be split into segments.
+ *
+ * @param comp      The ROHC compressor
+ * @param slots_nr  The number of RRU slots, in range [1, 16]
+ * @return          true if the number of slots was successfully set,
+ *                  false otherwise
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_set_mrru
+ * @see rohc_comp_get_segment2
+ */
+bool rohc_comp_set_rru_slots(struct rohc_comp *const comp,
+                             const size_t slots_nr)
+{
+	uint8_t *new_rru = NULL;
+
+	if(comp == NULL)
+	{
+		goto error;
+	}
+	if(slots_nr < 1 || slots_nr > ROHC_COMP_RRU_SLOTS_MAX)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "unexpected number of RRU slots: must be in range "
+		             "[1, %u]", ROHC_COMP_RRU_SLOTS_MAX);
+		goto error;
+	}
+	if(comp->rru_count > 0)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "cannot change the number of RRU slots while %zu RRUs "
+		             "were not retrieved yet", comp->rru_count);
+		goto error;
+	}
+
+	/* resize the RRU buffers if segmentation is enabled */
+	if(comp->mrru > 0 && slots_nr != comp->rru_slots_nr)
+	{
+		new_rru = malloc(comp->mrru * slots_nr);
+		if(new_rru == NULL)
+		{
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "failed to allocate memory for %zu RRUs of %zu bytes",
+			             slots_nr, comp->mrru);
+			goto error;
+		}
+		zfree(comp->rru);
+		comp->rru = new_rru;
+	}
+	rohc_comp_rru_assign(comp, comp->rru, comp->mrru, slots_nr);
+	comp->rru_slots_nr = slots_nr;
+	comp->rru_first = 0;
+
+	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	           "%zu RRU slots for segmentation", slots_nr);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get the maximal CID value the compressor uses
  *
  * Get the maximal CID value the compressor uses, ie. the \e MAX_CID parameter
  * defined in RFC 3095.
@@ -1760,7 +4531,14 @@ bool rohc_comp_set_features(struct rohc_comp *const comp,
 {
 	const rohc_comp_features_t all_features =
 		ROHC_COMP_FEATURE_NO_IP_CHECKSUMS |
-		ROHC_COMP_FEATURE_DUMP_PACKETS;
+		ROHC_COMP_FEATURE_DUMP_PACKETS |
+		ROHC_COMP_FEATURE_LATENCY |
+		ROHC_COMP_FEATURE_SEGMENT_VIEWS |
+		ROHC_COMP_FEATURE_ADAPTIVE_WLSB |
+		ROHC_COMP_FEATURE_CHEAP_PACKETS |
+		ROHC_COMP_FEATURE_CLONE_CTXTS |
+		ROHC_COMP_FEATURE_COLD_CTXTS |
+		ROHC_COMP_FEATURE_NO_ALLOC;
 
 	/* compressor must be valid */
 	if(comp == NULL)
@@ -1778,6 +4556,63 @@ bool rohc_comp_set_features(struct rohc_comp *const comp,
 		goto error;
 	}
 
+	/* the cold store allocates memory for every context it saves */
+	if((features & ROHC_COMP_FEATURE_NO_ALLOC) != 0 &&
+	   (features & ROHC_COMP_FEATURE_COLD_CTXTS) != 0)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "features NO_ALLOC and COLD_CTXTS cannot be enabled "
+		             "together");
+		goto error;
+	}
+
+	/* allocate the histograms of the processing time the first time they are
+	 * required, they are kept if the feature is disabled later */
+	if((features & ROHC_COMP_FEATURE_LATENCY) != 0 && comp->latency == NULL)
+	{
+		comp->latency = calloc(1, sizeof(struct rohc_latency));
+		if(comp->latency == NULL)
+		{
+			rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			           "failed to allocate memory for the histograms of the "
+			           "processing time");
+			goto error;
+		}
+	}
+
+	/* allocate the cold store the first time it is required, it is kept if
+	 * the feature is disabled later so that its contexts may be revived */
+	if((features & ROHC_COMP_FEATURE_COLD_CTXTS) != 0 && comp->cold_ctxts == NULL)
+	{
+		comp->cold_ctxts =
+			rohc_alloc_calloc_node(comp->medium.max_cid + 1,
+			                       sizeof(struct rohc_comp_cold_ctxt *),
+			                       comp->numa_node);
+		comp->cold_index =
+			rohc_alloc_calloc_node(comp->contexts_index_mask + 1,
+			                       sizeof(struct rohc_comp_cold_ctxt *),
+			                       comp->numa_node);
+		comp->cold_buf = malloc(ROHC_COMP_COLD_BUF_LEN);
+		if(comp->cold_ctxts == NULL || comp->cold_index == NULL ||
+		   comp->cold_buf == NULL)
+		{
+			rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			           "failed to allocate memory for the cold store");
+			zfree(comp->cold_buf);
+			zfree(comp->cold_index);
+			zfree(comp->cold_ctxts);
+			goto error;
+		}
+		comp->cold_buf_max_len = ROHC_COMP_COLD_BUF_LEN;
+	}
+
+	/* the profiles that allocate memory for their contexts are skipped
+	 * without allocation, so the flows shall be classified again */
+	if(((comp->features ^ features) & ROHC_COMP_FEATURE_NO_ALLOC) != 0)
+	{
+		c_profile_cache_flush(comp);
+	}
+
 	/* record new feature set */
 	comp->features = features;
 
@@ -1788,6 +4623,110 @@ error:
 }
 
 
+/**
+ * @brief Record the workload of the compressor
+ *
+ * Once the recorder is set, the compressor gives every input it receives to
+ * the callback: the packets to compress and the feedback delivered to it,
+ * with their arrival times. The recording starts with the configuration of
+ * the compressor at the time of the call, so the recorder shall be set once
+ * the compressor is configured. The recording may then be replayed against
+ * any build of the library with the rohc_replay tool, to reproduce a
+ * performance problem for example.
+ *
+ * The inputs may be truncated to their first bytes, for example to record
+ * the headers of the packets only: the replay fills the missing bytes with
+ * zeroes.
+ *
+ * The packets are recorded as they are given to the compressor: the replay
+ * compresses all of them with \ref rohc_compress4, or with
+ * \ref rohc_compress_with_cid if their CID was given.
+ *
+ * @param comp      The ROHC compressor
+ * @param write_cb  The callback that writes the recording,
+ *                  NULL to stop recording
+ * @param priv      The private context of the callback
+ * @param max_len   The maximum number of bytes recorded per input,
+ *                  0 to record the whole inputs
+ * @return          true if the recording started or stopped,
+ *                  false if the compressor is invalid, or if the
+ *                  configuration could not be written
+ *
+ * @ingroup rohc_comp
+ */
+bool rohc_comp_set_recorder(struct rohc_comp *const comp,
+                            const rohc_record_write_t write_cb,
+                            void *const priv,
+                            const size_t max_len)
+{
+	struct rohc_record_hdr hdr;
+	size_t i;
+
+	if(comp == NULL)
+	{
+		goto error;
+	}
+
+	/* stop the recording in progress if any */
+	comp->recorder.write_cb = NULL;
+	if(write_cb == NULL)
+	{
+		rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		          "recording stopped");
+		goto stopped;
+	}
+
+	/* start with the configuration of the compressor */
+	memset(&hdr, 0, sizeof(struct rohc_record_hdr));
+	hdr.magic = ROHC_RECORD_MAGIC;
+	hdr.version = ROHC_RECORD_VERSION;
+	hdr.entity = ROHC_RECORD_COMP;
+	hdr.cid_type = comp->medium.cid_type;
+	hdr.max_cid = comp->medium.max_cid;
+	hdr.param = comp->wlsb_window_width;
+	hdr.features = comp->features;
+	hdr.mrru = comp->mrru;
+	for(i = 0; i < comp->profiles_nr; i++)
+	{
+		const rohc_profile_t id = comp->profiles[i]->id;
+		size_t j;
+
+		if(!comp->enabled_profiles[i])
+		{
+			continue;
+		}
+		for(j = 0; j < hdr.profiles_nr && hdr.profiles[j] != id; j++)
+		{
+		}
+		if(j == hdr.profiles_nr && hdr.profiles_nr < ROHC_RECORD_PROFILES_MAX)
+		{
+			hdr.profiles[hdr.profiles_nr] = id;
+			hdr.profiles_nr++;
+		}
+	}
+	if(!write_cb(priv, (const uint8_t *) &hdr, sizeof(struct rohc_record_hdr)))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "failed to write the configuration of the compressor, "
+		             "recording not started");
+		goto error;
+	}
+
+	comp->recorder.write_cb = write_cb;
+	comp->recorder.priv = priv;
+	comp->recorder.max_len = max_len;
+
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	          "recording started");
+
+stopped:
+	return true;
+
+error:
+	return false;
+}
+
+
 /**
  * @brief Deliver a feedback packet to the compressor
  *
@@ -1805,9 +4744,6 @@ static bool __rohc_comp_deliver_feedback(struct rohc_comp *const comp,
                                          const size_t size)
 {
 	struct rohc_comp_ctxt *context;
-	const uint8_t *remain_data = packet;
-	size_t remain_len = size;
-	enum rohc_feedback_type feedback_type;
 	rohc_cid_t cid;
 	size_t cid_len;
 
@@ -1815,15 +4751,13 @@ static bool __rohc_comp_deliver_feedback(struct rohc_comp *const comp,
 	           "deliver %zu byte(s) of feedback to the right context", size);
 
 	/* extract the CID from feedback */
-	if(!rohc_comp_feedback_parse_cid(comp, remain_data, remain_len, &cid, &cid_len))
+	if(!rohc_comp_feedback_parse_cid(comp, packet, size, &cid, &cid_len))
 	{
 		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 		             "failed to deliver feedback: failed to extract CID from "
 		             "feedback");
 		goto error;
 	}
-	remain_data += cid_len;
-	remain_len -= cid_len;
 
 	/* find context */
 	context = c_get_context(comp, cid);
@@ -1838,6 +4772,35 @@ static bool __rohc_comp_deliver_feedback(struct rohc_comp *const comp,
 	assert(context->cid == cid);
 	assert(context->used == 1);
 
+	return rohc_comp_deliver_feedback_ctxt(comp, context, packet, size, cid_len);
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Deliver a feedback packet to the given compression context
+ *
+ * @param comp     The ROHC compressor
+ * @param context  The compression context the feedback is for
+ * @param packet   The feedback data
+ * @param size     The length of the feedback packet
+ * @param cid_len  The length of the CID bits at the beginning of the feedback
+ * @return         true if the feedback was successfully taken into account,
+ *                 false if the feedback could not be taken into account
+ */
+static bool rohc_comp_deliver_feedback_ctxt(struct rohc_comp *const comp,
+                                            struct rohc_comp_ctxt *const context,
+                                            const uint8_t *const packet,
+                                            const size_t size,
+                                            const size_t cid_len)
+{
+	const uint8_t *const remain_data = packet + cid_len;
+	const size_t remain_len = size - cid_len;
+	enum rohc_feedback_type feedback_type;
+	bool is_handled;
+
 	/* FEEDBACK-1 or FEEDBACK-2 ? */
 	if(remain_len == 0)
 	{
@@ -1855,8 +4818,15 @@ static bool __rohc_comp_deliver_feedback(struct rohc_comp *const comp,
 	}
 
 	/* deliver feedback to profile with the context */
-	if(!context->profile->feedback(context, feedback_type, packet, size,
-	                               remain_data, remain_len))
+	is_handled = context->profile->feedback(context, feedback_type, packet, size,
+	                                        remain_data, remain_len);
+	rohc_trace_ring_add(&comp->trace_ring, ROHC_TRACE_EVENT_COMP_FEEDBACK,
+	                    context->cid, context->profile->id, context->packet_type,
+	                    context->num_sent_packets, feedback_type, size,
+	                    is_handled);
+	rohc_probe5(comp_feedback, comp, context->cid, feedback_type, size,
+	            is_handled);
+	if(!is_handled)
 	{
 		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 		             "failed to deliver feedback: failed to handle FEEDBACK-%d",
@@ -1908,6 +4878,13 @@ bool rohc_comp_deliver_feedback2(struct rohc_comp *const comp,
 		goto error;
 	}
 
+	/* record the feedback for replay */
+	if(comp->recorder.write_cb != NULL && !rohc_buf_is_empty(remain_data))
+	{
+		rohc_comp_record(comp, ROHC_RECORD_FEEDBACK, &remain_data, 1,
+		                 ROHC_RECORD_NO_CID);
+	}
+
 	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 	           "deliver %zu byte(s) of feedback to the right context",
 	           remain_data.len);
@@ -1976,82 +4953,188 @@ error:
 
 
 /**
- * @brief Get some information about the last compressed packet
+ * @brief Deliver a batch of feedback packets to the compressor
  *
- * Get some information about the last compressed packet.
+ * Same as \ref rohc_comp_deliver_feedback2, but designed for feedback data
+ * that contains many concatenated feedback items, eg. when the remote
+ * decompressor coalesces its feedback.
  *
- * To use the function, call it with a pointer on a pre-allocated
- * \ref rohc_comp_last_packet_info2_t structure with the \e version_major and
- * \e version_minor fields set to one of the following supported versions:
- *  - Major 0, minor 0
+ * All the feedback headers are parsed first, then the feedback items are
+ * sorted by CID, so that every context is looked up once only. The relative
+ * order of the feedback items of one context is kept. A positive ACK that is
+ * followed by another positive ACK for the same context is not delivered:
+ * the latest ACK acknowledges the W-LSB window at least as far as the older
+ * ones. NACKs and STATIC-NACKs are always delivered.
  *
- * See the \ref rohc_comp_last_packet_info2_t structure for details about
- * fields that are supported in the above versions.
+ * Feedback items are sorted by groups of ROHC_COMP_FEEDBACK_BATCH_LEN items.
  *
- * @param comp          The ROHC compressor to get information from
- * @param[in,out] info  The structure where information will be stored
- * @return              true in case of success, false otherwise
+ * @param comp      The ROHC compressor
+ * @param feedback  The feedback data
+ * @return          true if the feedback was successfully taken into account,
+ *                  false if the feedback could not be taken into account
  *
  * @ingroup rohc_comp
  *
- * @see rohc_comp_last_packet_info2_t
+ * @see rohc_comp_deliver_feedback2
  */
-bool rohc_comp_get_last_packet_info2(const struct rohc_comp *const comp,
-                                     rohc_comp_last_packet_info2_t *const info)
+bool rohc_comp_deliver_feedback_batch(struct rohc_comp *const comp,
+                                      const struct rohc_buf feedback)
 {
+	struct rohc_comp_feedback_item items[ROHC_COMP_FEEDBACK_BATCH_LEN];
+	struct rohc_buf remain_data = feedback;
+	size_t feedbacks_nr = 0;
+	size_t nr_failures = 0;
+
+	/* sanity checks */
 	if(comp == NULL)
 	{
 		goto error;
 	}
-
-	if(comp->last_context == NULL)
+	if(rohc_buf_is_malformed(remain_data))
 	{
-		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		           "last context found in compressor is not valid");
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "failed to deliver feedback: feedback is malformed");
 		goto error;
 	}
 
-	if(info == NULL)
+	/* record the feedback for replay */
+	if(comp->recorder.write_cb != NULL && !rohc_buf_is_empty(remain_data))
 	{
-		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		           "structure for last packet information is not valid");
-		goto error;
+		rohc_comp_record(comp, ROHC_RECORD_FEEDBACK, &remain_data, 1,
+		                 ROHC_RECORD_NO_CID);
 	}
 
-	/* check compatibility version */
-	if(info->version_major == 0)
+	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	           "deliver a batch of %zu byte(s) of feedback", remain_data.len);
+
+	while(remain_data.len > 0 &&
+	      rohc_packet_is_feedback(rohc_buf_byte(remain_data)))
 	{
-		/* base fields for major version 0 */
-		info->context_id = comp->last_context->cid;
-		info->is_context_init = (comp->last_context->num_sent_packets == 1);
-		info->context_mode = comp->last_context->mode;
-		info->context_state = comp->last_context->state;
-		info->context_used = (comp->last_context->used ? true : false);
-		info->profile_id = comp->last_context->profile->id;
-		info->packet_type = comp->last_context->packet_type;
-		info->total_last_uncomp_size = comp->last_context->total_last_uncompressed_size;
-		info->header_last_uncomp_size = comp->last_context->header_last_uncompressed_size;
-		info->total_last_comp_size = comp->last_context->total_last_compressed_size;
-		info->header_last_comp_size = comp->last_context->header_last_compressed_size;
+		struct rohc_comp_ctxt *context = NULL;
+		size_t items_nr = 0;
+		size_t i;
+
+		/* parse the headers of as many feedback items as possible */
+		while(items_nr < ROHC_COMP_FEEDBACK_BATCH_LEN &&
+		      remain_data.len > 0 &&
+		      rohc_packet_is_feedback(rohc_buf_byte(remain_data)))
+		{
+			struct rohc_comp_feedback_item *const item = &items[items_nr];
+			size_t feedback_hdr_len;
+			size_t feedback_data_len;
 
-		/* new fields added by minor versions */
-		if(info->version_minor > 0)
+			feedbacks_nr++;
+
+			if(!rohc_feedback_get_size(remain_data, &feedback_hdr_len,
+			                           &feedback_data_len))
+			{
+				rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+				             "failed to parse a feedback item");
+				goto error;
+			}
+			if((feedback_hdr_len + feedback_data_len) > remain_data.len)
+			{
+				rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+				             "the %zu-byte feedback is too large for the %zu-byte "
+				             "remaining ROHC data", feedback_hdr_len +
+				             feedback_data_len, remain_data.len);
+				goto error;
+			}
+			rohc_buf_pull(&remain_data, feedback_hdr_len);
+
+			item->data = rohc_buf_data(remain_data);
+			item->len = feedback_data_len;
+			rohc_buf_pull(&remain_data, feedback_data_len);
+
+			if(!rohc_comp_feedback_parse_cid(comp, item->data, item->len,
+			                                 &item->cid, &item->cid_len) ||
+			   item->cid_len >= item->len)
+			{
+				rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+				             "failed to deliver feedback item #%zu: malformed CID "
+				             "or empty feedback data", feedbacks_nr);
+				nr_failures++;
+				continue;
+			}
+
+			/* FEEDBACK-1 is always a positive ACK, FEEDBACK-2 gives its type
+			 * in the 2 first bits */
+			item->is_ack =
+				((item->len - item->cid_len) == 1 ||
+				 (item->data[item->cid_len] >> 6) == ROHC_FEEDBACK_ACK);
+			item->is_subsumed = false;
+			items_nr++;
+		}
+
+		/* stable insertion sort by CID */
+		for(i = 1; i < items_nr; i++)
 		{
-			rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			           "unsupported minor version (%u) of the structure for "
-			           "last packet information", info->version_minor);
-			goto error;
+			const struct rohc_comp_feedback_item item = items[i];
+			size_t j = i;
+
+			while(j > 0 && items[j - 1].cid > item.cid)
+			{
+				items[j] = items[j - 1];
+				j--;
+			}
+			items[j] = item;
+		}
+
+		/* an ACK is subsumed by a later ACK for the same context */
+		for(i = items_nr; i > 0; i--)
+		{
+			struct rohc_comp_feedback_item *const item = &items[i - 1];
+			bool later_ack = false;
+			size_t j;
+
+			for(j = i; j < items_nr && items[j].cid == item->cid; j++)
+			{
+				if(items[j].is_ack)
+				{
+					later_ack = true;
+					break;
+				}
+			}
+			item->is_subsumed = (item->is_ack && later_ack);
+		}
+
+		/* deliver the remaining feedback items, context by context */
+		for(i = 0; i < items_nr; i++)
+		{
+			const struct rohc_comp_feedback_item *const item = &items[i];
+
+			if(item->is_subsumed)
+			{
+				rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+				           "skip ACK for CID %zu subsumed by a later ACK",
+				           item->cid);
+				continue;
+			}
+
+			if(context == NULL || context->cid != item->cid)
+			{
+				context = c_get_context(comp, item->cid);
+				if(context == NULL)
+				{
+					rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+					             "failed to deliver feedback: context with CID = %zu "
+					             "not found", item->cid);
+					nr_failures++;
+					continue;
+				}
+			}
+
+			if(!rohc_comp_deliver_feedback_ctxt(comp, context, item->data,
+			                                    item->len, item->cid_len))
+			{
+				rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+				             "failed to deliver feedback for CID %zu", item->cid);
+				nr_failures++;
+			}
 		}
-	}
-	else
-	{
-		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		           "unsupported major version (%u) of the structure for last "
-		           "packet information", info->version_major);
-		goto error;
 	}
 
-	return true;
+	return (nr_failures == 0);
 
 error:
 	return false;
@@ -2059,35 +5142,417 @@ error:
 
 
 /**
- * @brief Get some general information about the compressor
+ * @brief Enqueue a feedback packet for the compressor
  *
- * Get some general information about the compressor.
+ * Store a copy of the feedback data in the feedback queue of the compressor.
+ * The feedback is delivered to the contexts as \ref rohc_comp_deliver_feedback2
+ * would do, at the beginning of the next call to one of the compression
+ * functions.
  *
- * To use the function, call it with a pointer on a pre-allocated
- * \ref rohc_comp_general_info_t structure with the \e version_major and
- * \e version_minor fields set to one of the following supported versions:
- *  - Major 0, minor 0
+ * Contrary to \ref rohc_comp_deliver_feedback2, the function may be called
+ * from another thread than the one that compresses packets, without any
+ * lock: the queue is lock-free for one producer thread and the compressing
+ * thread. Several producer threads shall serialize their calls.
  *
- * See the \ref rohc_comp_general_info_t structure for details about fields
- * that are supported in the above versions.
+ * The function does not print any trace since the trace callback might not
+ * be thread-safe.
  *
- * @param comp          The ROHC compressor to get information from
- * @param[in,out] info  The structure where information will be stored
- * @return              true in case of success, false otherwise
+ * @param comp      The ROHC compressor
+ * @param feedback  The feedback data, at most
+ *                  ROHC_COMP_FEEDBACK_QUEUE_SLOT_LEN bytes long
+ * @return          true if the feedback was enqueued,
+ *                  false if the feedback is too large or the queue is full
  *
  * @ingroup rohc_comp
  *
- * @see rohc_comp_general_info_t
+ * @see rohc_comp_deliver_feedback2
  */
-bool rohc_comp_get_general_info(const struct rohc_comp *const comp,
-                                rohc_comp_general_info_t *const info)
+bool rohc_comp_enqueue_feedback(struct rohc_comp *const comp,
+                                const struct rohc_buf feedback)
 {
+	struct rohc_comp_feedback_queue *queue;
+	struct rohc_comp_feedback_slot *slot;
+	size_t head;
+	size_t tail;
+
 	if(comp == NULL)
 	{
 		goto error;
 	}
-
-	if(info == NULL)
+	if(rohc_buf_is_malformed(feedback) ||
+	   feedback.len > ROHC_COMP_FEEDBACK_QUEUE_SLOT_LEN)
+	{
+		goto error;
+	}
+	queue = &comp->feedback_queue;
+
+	/* only the producer writes the head index, only the compressor writes the
+	 * tail index: the acquire load of the tail ensures that the compressor is
+	 * done with the slot before it is overwritten */
+	head = queue->head;
+	tail = __atomic_load_n(&queue->tail, __ATOMIC_ACQUIRE);
+	if((head - tail) >= ROHC_COMP_FEEDBACK_QUEUE_LEN)
+	{
+		goto error;
+	}
+
+	slot = &queue->slots[head & (ROHC_COMP_FEEDBACK_QUEUE_LEN - 1)];
+	memcpy(slot->data, rohc_buf_data(feedback), feedback.len);
+	slot->len = feedback.len;
+
+	/* publish the slot to the compressor */
+	__atomic_store_n(&queue->head, head + 1, __ATOMIC_RELEASE);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Deliver the feedback enqueued by other threads to the contexts
+ *
+ * @param comp  The ROHC compressor
+ */
+static void rohc_comp_drain_feedback_queue(struct rohc_comp *const comp)
+{
+	struct rohc_comp_feedback_queue *const queue = &comp->feedback_queue;
+	const size_t head = __atomic_load_n(&queue->head, __ATOMIC_ACQUIRE);
+	size_t tail = queue->tail;
+
+	while(tail != head)
+	{
+		struct rohc_comp_feedback_slot *const slot =
+			&queue->slots[tail & (ROHC_COMP_FEEDBACK_QUEUE_LEN - 1)];
+		const struct rohc_ts no_time = { .sec = 0, .nsec = 0 };
+		const struct rohc_buf feedback =
+			rohc_buf_init_full(slot->data, slot->len, no_time);
+
+		if(!rohc_comp_deliver_feedback2(comp, feedback))
+		{
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "failed to deliver enqueued feedback");
+		}
+		tail++;
+
+		/* give the slot back to the producer */
+		__atomic_store_n(&queue->tail, tail, __ATOMIC_RELEASE);
+	}
+}
+
+
+/**
+ * @brief Record one input of the compressor
+ *
+ * The recording is stopped if the input cannot be written.
+ *
+ * @param comp      The ROHC compressor, it shall be recording
+ * @param type      The kind of input
+ * @param input     The buffers of the input
+ * @param input_nr  The number of buffers of the input
+ * @param cid       The CID chosen by the application for the packet,
+ *                  \ref ROHC_RECORD_NO_CID if none
+ */
+static void rohc_comp_record(struct rohc_comp *const comp,
+                             const enum rohc_record_event_type type,
+                             const struct rohc_buf input[],
+                             const size_t input_nr,
+                             const uint32_t cid)
+{
+	if(!rohc_record_event(&comp->recorder, type, cid, input, input_nr))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "failed to record one input, stop recording");
+		comp->recorder.write_cb = NULL;
+	}
+}
+
+
+/**
+ * @brief Set the source of the feedback piggybacked in the ROHC packets
+ *
+ * @param comp  The ROHC compressor
+ * @param cb    The callback that gives the feedback to piggyback,
+ *              NULL to piggyback no feedback
+ * @param priv  The private context of the callback
+ * @return      The private context of the previous source, NULL if none
+ */
+void * rohc_comp_set_feedback_source(struct rohc_comp *const comp,
+                                     const rohc_comp_feedback_source_t cb,
+                                     void *const priv)
+{
+	void *const old_priv = comp->feedback_source.priv;
+
+	comp->feedback_source.cb = cb;
+	comp->feedback_source.priv = priv;
+
+	return old_priv;
+}
+
+
+/**
+ * @brief Get some information about the last compressed packet
+ *
+ * Get some information about the last compressed packet.
+ *
+ * To use the function, call it with a pointer on a pre-allocated
+ * \ref rohc_comp_last_packet_info2_t structure with the \e version_major and
+ * \e version_minor fields set to one of the following supported versions:
+ *  - Major 0, minor 0
+ *
+ * See the \ref rohc_comp_last_packet_info2_t structure for details about
+ * fields that are supported in the above versions.
+ *
+ * @param comp          The ROHC compressor to get information from
+ * @param[in,out] info  The structure where information will be stored
+ * @return              true in case of success, false otherwise
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_last_packet_info2_t
+ */
+bool rohc_comp_get_last_packet_info2(const struct rohc_comp *const comp,
+                                     rohc_comp_last_packet_info2_t *const info)
+{
+	if(comp == NULL)
+	{
+		goto error;
+	}
+
+	if(comp->last_context == NULL)
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "last context found in compressor is not valid");
+		goto error;
+	}
+
+	if(info == NULL)
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "structure for last packet information is not valid");
+		goto error;
+	}
+
+	/* check compatibility version */
+	if(info->version_major == 0)
+	{
+		/* base fields for major version 0 */
+		info->context_id = comp->last_context->cid;
+		info->is_context_init = (comp->last_context->num_sent_packets == 1);
+		info->context_mode = comp->last_context->mode;
+		info->context_state = comp->last_context->state;
+		info->context_used = (comp->last_context->used ? true : false);
+		info->profile_id = comp->last_context->profile->id;
+		info->packet_type = comp->last_context->packet_type;
+#if ROHC_SMALL_CONTEXTS == 1
+		/* small contexts keep no statistics */
+		info->total_last_uncomp_size = 0;
+		info->header_last_uncomp_size = 0;
+		info->total_last_comp_size = 0;
+		info->header_last_comp_size = 0;
+#else
+		info->total_last_uncomp_size = comp->last_context->total_last_uncompressed_size;
+		info->header_last_uncomp_size = comp->last_context->header_last_uncompressed_size;
+		info->total_last_comp_size = comp->last_context->total_last_compressed_size;
+		info->header_last_comp_size = comp->last_context->header_last_compressed_size;
+#endif
+
+		/* new fields added by minor versions */
+		if(info->version_minor > 0)
+		{
+			rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			           "unsupported minor version (%u) of the structure for "
+			           "last packet information", info->version_minor);
+			goto error;
+		}
+	}
+	else
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "unsupported major version (%u) of the structure for last "
+		           "packet information", info->version_major);
+		goto error;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get some statistics about the next compression context in use
+ *
+ * Walk the compression contexts in use in increasing CID order: get the
+ * statistics of the first context in use whose CID is equal to or greater
+ * than the given CID. Call the function with a CID of 0 to get the first
+ * context, then with the CID of the previous context plus one to get the
+ * next one, until the function returns false. The contexts may be walked by
+ * another thread while packets are compressed:
+ *
+ * \code
+        rohc_comp_ctxt_stats_t stats;
+        rohc_cid_t cid = 0;
+
+        stats.version_major = 0;
+        stats.version_minor = 0;
+        while(rohc_comp_get_next_ctxt_stats(comp, &cid, &stats))
+        {
+                ...
+                cid++;
+        }
+ * \endcode
+ *
+ * To use the function, call it with a pointer on a pre-allocated
+ * \ref rohc_comp_ctxt_stats_t structure with the \e version_major and
+ * \e version_minor fields set to one of the following supported versions:
+ *  - Major 0, minor 0
+ *
+ * See the \ref rohc_comp_ctxt_stats_t structure for details about fields
+ * that are supported in the above versions.
+ *
+ * @param comp           The ROHC compressor to get statistics from
+ * @param[in,out] cid    IN:  The CID to start the search from
+ *                       OUT: The CID of the context found
+ * @param[in,out] stats  The structure where statistics will be stored
+ * @return               true if one context in use was found,
+ *                       false if no more context is in use or in case of
+ *                       error
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_ctxt_stats_t
+ */
+bool rohc_comp_get_next_ctxt_stats(const struct rohc_comp *const comp,
+                                   rohc_cid_t *const cid,
+                                   rohc_comp_ctxt_stats_t *const stats)
+{
+	const struct rohc_comp_ctxt *context = NULL;
+	rohc_seqlock_t seq;
+	rohc_cid_t i;
+
+	if(comp == NULL)
+	{
+		goto error;
+	}
+
+	if(cid == NULL)
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "CID to start the search from is not valid");
+		goto error;
+	}
+
+	if(stats == NULL)
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "structure for context statistics is not valid");
+		goto error;
+	}
+
+	/* check compatibility version */
+	if(stats->version_major != 0)
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "unsupported major version (%u) of the structure for "
+		           "context statistics", stats->version_major);
+		goto error;
+	}
+	if(stats->version_minor > 0)
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "unsupported minor version (%u) of the structure for "
+		           "context statistics", stats->version_minor);
+		goto error;
+	}
+
+	/* find the next context in use */
+	for(i = (*cid > comp->cid_base ? *cid - comp->cid_base : 0);
+	    i <= comp->medium.max_cid && context == NULL; i++)
+	{
+		if(comp->contexts_hot[i].used)
+		{
+			context = &comp->contexts[i];
+		}
+	}
+	if(context == NULL)
+	{
+		goto error;
+	}
+
+	/* base fields for major version 0 */
+	do
+	{
+		seq = rohc_seqlock_read_begin(&comp->stats_seq);
+		*cid = context->cid;
+		stats->context_id = context->cid;
+		stats->profile_id = context->profile->id;
+		stats->context_mode = context->mode;
+		stats->context_state = context->state;
+		stats->packets_nr = context->num_sent_packets;
+#if ROHC_SMALL_CONTEXTS == 1
+		/* small contexts keep no statistics */
+		stats->ir_packets_nr = 0;
+		stats->fo_packets_nr = 0;
+		stats->so_packets_nr = 0;
+		stats->header_uncomp_bytes_nr = 0;
+		stats->header_comp_bytes_nr = 0;
+#else
+		stats->ir_packets_nr = context->state_packets_nr[ROHC_COMP_STATE_IR];
+		stats->fo_packets_nr = context->state_packets_nr[ROHC_COMP_STATE_FO];
+		stats->so_packets_nr = context->state_packets_nr[ROHC_COMP_STATE_SO];
+		stats->header_uncomp_bytes_nr = context->header_uncompressed_size;
+		stats->header_comp_bytes_nr = context->header_compressed_size;
+#endif
+		stats->first_used = context->first_used;
+		stats->last_used = context->latest_used;
+	}
+	while(rohc_seqlock_read_retry(&comp->stats_seq, seq));
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get some general information about the compressor
+ *
+ * Get some general information about the compressor.
+ *
+ * The function may be called by another thread while the compressor
+ * compresses packets: the counters it gets are consistent with each other.
+ *
+ * To use the function, call it with a pointer on a pre-allocated
+ * \ref rohc_comp_general_info_t structure with the \e version_major and
+ * \e version_minor fields set to one of the following supported versions:
+ *  - Major 0, minor 0
+ *
+ * See the \ref rohc_comp_general_info_t structure for details about fields
+ * that are supported in the above versions.
+ *
+ * @param comp          The ROHC compressor to get information from
+ * @param[in,out] info  The structure where information will be stored
+ * @return              true in case of success, false otherwise
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_general_info_t
+ */
+bool rohc_comp_get_general_info(const struct rohc_comp *const comp,
+                                rohc_comp_general_info_t *const info)
+{
+	rohc_seqlock_t seq;
+
+	if(comp == NULL)
+	{
+		goto error;
+	}
+
+	if(info == NULL)
 	{
 		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 		           "structure for general information is not valid");
@@ -2098,10 +5563,15 @@ bool rohc_comp_get_general_info(const struct rohc_comp *const comp,
 	if(info->version_major == 0)
 	{
 		/* base fields for major version 0 */
-		info->contexts_nr = comp->num_contexts_used;
-		info->packets_nr = comp->num_packets;
-		info->uncomp_bytes_nr = comp->total_uncompressed_size;
-		info->comp_bytes_nr = comp->total_compressed_size;
+		do
+		{
+			seq = rohc_seqlock_read_begin(&comp->stats_seq);
+			info->contexts_nr = comp->num_contexts_used;
+			info->packets_nr = comp->num_packets;
+			info->uncomp_bytes_nr = comp->total_uncompressed_size;
+			info->comp_bytes_nr = comp->total_compressed_size;
+		}
+		while(rohc_seqlock_read_retry(&comp->stats_seq, seq));
 
 		/* new fields added by minor versions */
 		if(info->version_minor > 0)
@@ -2128,23 +5598,382 @@ error:
 
 
 /**
- * @brief Give a description for the given ROHC compression context state
+ * @brief Get the counters of packets per profile and per packet type
  *
- * Give a description for the given ROHC compression context state.
+ * Get the number of packets, uncompressed bytes and compressed bytes that
+ * every profile and every packet type accounted for since the compressor
+ * was created. Only the packets successfully compressed are counted.
+ * The counters may be read by another thread while packets are compressed.
  *
- * The descriptions are not part of the API. They may change between
- * releases without any warning. Do NOT use them for other means that
- * providing to users a textual description of compression context states
- * used by the library. If unsure, ask on the mailing list.
+ * To use the function, call it with a pointer on a pre-allocated
+ * \ref rohc_packet_stats_t structure with the \e version_major and
+ * \e version_minor fields set to one of the following supported versions:
+ *  - Major 0, minor 0
  *
- * @param state  The compression context state to get a description for
- * @return       A string that describes the given compression context state
+ * See the \ref rohc_packet_stats_t structure for details about fields that
+ * are supported in the above versions.
+ *
+ * @param comp           The ROHC compressor to get the counters from
+ * @param[in,out] stats  The structure where the counters will be stored
+ * @return               true in case of success, false otherwise
  *
  * @ingroup rohc_comp
+ *
+ * @see rohc_packet_stats_t
  */
-const char * rohc_comp_get_state_descr(const rohc_comp_state_t state)
+bool rohc_comp_get_packet_stats(const struct rohc_comp *const comp,
+                                rohc_packet_stats_t *const stats)
 {
-	switch(state)
+	rohc_seqlock_t seq;
+
+	if(comp == NULL)
+	{
+		goto error;
+	}
+
+	if(stats == NULL)
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "structure for packet statistics is not valid");
+		goto error;
+	}
+
+	/* check compatibility version */
+	if(stats->version_major == 0)
+	{
+		/* base fields for major version 0 */
+		do
+		{
+			seq = rohc_seqlock_read_begin(&comp->stats_seq);
+			memcpy(stats->profiles, comp->pkt_stats.profiles,
+			       sizeof(rohc_packet_counters_t) * ROHC_PROFILE_MAX);
+			memcpy(stats->packet_types, comp->pkt_stats.packet_types,
+			       sizeof(rohc_packet_counters_t) * ROHC_PACKET_MAX);
+		}
+		while(rohc_seqlock_read_retry(&comp->stats_seq, seq));
+
+		/* new fields added by minor versions */
+		if(stats->version_minor > 0)
+		{
+			rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			           "unsupported minor version (%u) of the structure for "
+			           "packet statistics", stats->version_minor);
+			goto error;
+		}
+	}
+	else
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "unsupported major version (%u) of the structure for "
+		           "packet statistics", stats->version_major);
+		goto error;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get the processing time of packets per profile and per packet type
+ *
+ * Get the number of packets, the mean, the maximum, and the 50th, 99th and
+ * 99.9th percentiles of the processing time of packets, for all packets and
+ * for every profile and every packet type. The processing time of one packet
+ * is measured from the entry of the compression function to its exit with the
+ * monotonic clock of the system.
+ *
+ * The processing times are recorded only while the \ref ROHC_COMP_FEATURE_LATENCY
+ * feature is enabled (see \ref rohc_comp_set_features), and only for the
+ * packets successfully compressed. All the counters are zero if the
+ * feature was never enabled.
+ *
+ * To use the function, call it with a pointer on a pre-allocated
+ * \ref rohc_latency_stats_t structure with the \e version_major and
+ * \e version_minor fields set to one of the following supported versions:
+ *  - Major 0, minor 0
+ *
+ * See the \ref rohc_latency_stats_t structure for details about fields that
+ * are supported in the above versions.
+ *
+ * @param comp           The ROHC compressor to get the processing times from
+ * @param[in,out] stats  The structure where to store the processing times
+ * @return               true in case of success, false otherwise
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_latency_stats_t
+ * @see ROHC_COMP_FEATURE_LATENCY
+ */
+bool rohc_comp_get_latency_stats(const struct rohc_comp *const comp,
+                                 rohc_latency_stats_t *const stats)
+{
+	if(comp == NULL)
+	{
+		goto error;
+	}
+
+	if(stats == NULL)
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "structure for latency statistics is not valid");
+		goto error;
+	}
+
+	/* check compatibility version */
+	if(stats->version_major == 0)
+	{
+		/* base fields for major version 0 */
+		rohc_latency_get_stats(comp->latency, stats);
+
+		/* new fields added by minor versions */
+		if(stats->version_minor > 0)
+		{
+			rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			           "unsupported minor version (%u) of the structure for "
+			           "latency statistics", stats->version_minor);
+			goto error;
+		}
+	}
+	else
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "unsupported major version (%u) of the structure for "
+		           "latency statistics", stats->version_major);
+		goto error;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get the CPU cycles spent in one stage of the compression
+ *
+ * Get the CPU cycles that the compressor spent in the given stage since its
+ * creation, for all the packets it compressed. The cycles are read from the
+ * time-stamp counter on x86 and from the virtual counter on ARM64; they are
+ * replaced by nanoseconds of the monotonic clock on the other architectures
+ * and in the Linux kernel. The cycles spent to compute CRCs are accounted in
+ * the \ref ROHC_COMP_STAGE_CRC stage only.
+ *
+ * The cycles are accounted only if the library was built with the
+ * --enable-stage-cycles option of the configure script.
+ *
+ * @param comp         The ROHC compressor to get the CPU cycles from
+ * @param stage        The stage of the compression
+ * @param[out] cycles  The CPU cycles spent in the stage
+ * @return             true in case of success,
+ *                     false if the library was built without the accounting
+ *                     of CPU cycles or if a parameter is invalid
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_stage_t
+ * @see rohc_comp_get_stage_descr
+ */
+bool rohc_comp_get_stage_cycles(const struct rohc_comp *const comp,
+                                const rohc_comp_stage_t stage,
+                                uint64_t *const cycles)
+{
+	if(comp == NULL)
+	{
+		goto error;
+	}
+
+	if(stage >= ROHC_COMP_STAGE_MAX)
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "unknown compression stage %d", stage);
+		goto error;
+	}
+
+	if(cycles == NULL)
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "location for CPU cycles is not valid");
+		goto error;
+	}
+
+#ifdef ROHC_STAGE_CYCLES
+	*cycles = comp->stage_cycles.total[stage];
+	return true;
+#else
+	rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	             "CPU cycles are not accounted: the library was built without "
+	             "the --enable-stage-cycles option");
+#endif
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Give a description for the given stage of the compression
+ *
+ * The descriptions are not part of the API. They may change between
+ * releases without any warning. Do NOT use them for other means that
+ * providing to users a textual description of the compression stages
+ * used by the library. If unsure, ask on the mailing list.
+ *
+ * @param stage  The compression stage to get a description for
+ * @return       A string that describes the given compression stage
+ *
+ * @ingroup rohc_comp
+ */
+const char * rohc_comp_get_stage_descr(const rohc_comp_stage_t stage)
+{
+	switch(stage)
+	{
+		case ROHC_COMP_STAGE_PARSE:
+			return "parse headers";
+		case ROHC_COMP_STAGE_FIND_CTXT:
+			return "find context";
+		case ROHC_COMP_STAGE_CHANGES:
+			return "detect changes";
+		case ROHC_COMP_STAGE_ENCODE_FIELDS:
+			return "encode fields";
+		case ROHC_COMP_STAGE_DECIDE_PKT:
+			return "decide packet";
+		case ROHC_COMP_STAGE_BUILD_HDR:
+			return "build header";
+		case ROHC_COMP_STAGE_CRC:
+			return "compute CRC";
+		case ROHC_COMP_STAGE_UPDATE_CTXT:
+			return "update context";
+		case ROHC_COMP_STAGE_PAYLOAD:
+			return "copy payload";
+		case ROHC_COMP_STAGE_MAX:
+		default:
+			return "no description";
+	}
+}
+
+
+/**
+ * @brief Get the memory used by the compressor
+ *
+ * Get the number of bytes that the compressor allocated for itself, for its
+ * contexts and for its Reconstructed Reception Unit. The array of contexts is
+ * allocated once for MAX_CID + 1 contexts, so it is a part of the bytes of the
+ * compressor itself: the bytes of the contexts are only the profile-specific
+ * parts of the contexts in use.
+ *
+ * To use the function, call it with a pointer on a pre-allocated
+ * \ref rohc_memory_usage_t structure with the \e version_major and
+ * \e version_minor fields set to one of the following supported versions:
+ *  - Major 0, minor 0
+ *
+ * @param comp         The ROHC compressor to get memory usage from
+ * @param[in,out] mem  The structure where memory usage will be stored
+ * @return             true in case of success, false otherwise
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_memory_usage_t
+ */
+bool rohc_comp_get_memory_usage(const struct rohc_comp *const comp,
+                                rohc_memory_usage_t *const mem)
+{
+	size_t i;
+
+	if(comp == NULL)
+	{
+		goto error;
+	}
+
+	if(mem == NULL)
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "structure for memory usage is not valid");
+		goto error;
+	}
+
+	/* check compatibility version */
+	if(mem->version_major != 0 || mem->version_minor != 0)
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "unsupported version (%u.%u) of the structure for memory "
+		           "usage", mem->version_major, mem->version_minor);
+		goto error;
+	}
+
+	/* the compressor, its array of contexts, its index of contexts, its
+	 * cache of profiles, its stack of free CIDs and its stack of CIDs to
+	 * re-initialize */
+	mem->instance_bytes = sizeof(struct rohc_comp) +
+		(comp->medium.max_cid + 1) * sizeof(struct rohc_comp_ctxt) +
+		(comp->contexts_index_mask + 1) * sizeof(uint16_t) +
+		(comp->contexts_index_mask + 1) *
+		sizeof(struct rohc_comp_profile_cache_entry) +
+		(comp->medium.max_cid + 1) * sizeof(uint16_t) * 2;
+	if(comp->latency != NULL)
+	{
+		mem->instance_bytes += sizeof(struct rohc_latency);
+	}
+	if(comp->rtp_detect != NULL)
+	{
+		mem->instance_bytes += sizeof(struct rohc_comp_rtp_detect) +
+			(comp->contexts_index_mask + 1) *
+			sizeof(struct rohc_comp_rtp_probation);
+	}
+	if(comp->cold_ctxts != NULL)
+	{
+		mem->instance_bytes += comp->cold_buf_max_len +
+			(comp->medium.max_cid + 1 + comp->contexts_index_mask + 1) *
+			sizeof(struct rohc_comp_cold_ctxt *);
+	}
+
+	/* the profile-specific parts of the contexts in use, and the contexts of
+	 * the cold store */
+	mem->contexts_nr = comp->num_contexts_used + comp->cold_ctxts_nr;
+	mem->contexts_bytes = 0;
+	mem->wlsb_bytes = 0;
+	mem->lists_bytes = 0;
+	for(i = 0; i < ROHC_PROFILE_MAX; i++)
+	{
+		mem->profiles_bytes[i] = comp->contexts_mem[i].bytes;
+		mem->contexts_bytes += comp->contexts_mem[i].bytes;
+		mem->wlsb_bytes += comp->contexts_mem[i].wlsb_bytes;
+		mem->lists_bytes += comp->contexts_mem[i].lists_bytes;
+	}
+
+	/* the Reconstructed Reception Unit */
+	mem->rru_bytes = (comp->rru != NULL ? comp->mrru * comp->rru_slots_nr : 0);
+
+	mem->total_bytes = mem->instance_bytes + mem->contexts_bytes + mem->rru_bytes;
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Give a description for the given ROHC compression context state
+ *
+ * Give a description for the given ROHC compression context state.
+ *
+ * The descriptions are not part of the API. They may change between
+ * releases without any warning. Do NOT use them for other means that
+ * providing to users a textual description of compression context states
+ * used by the library. If unsure, ask on the mailing list.
+ *
+ * @param state  The compression context state to get a description for
+ * @return       A string that describes the given compression context state
+ *
+ * @ingroup rohc_comp
+ */
+const char * rohc_comp_get_state_descr(const rohc_comp_state_t state)
+{
+	switch(state)
 	{
 		case ROHC_COMP_STATE_IR:
 			return "IR";
@@ -2159,357 +5988,2685 @@ const char * rohc_comp_get_state_descr(const rohc_comp_state_t state)
 }
 
 
-/*
- * Definitions of private functions
- */
+/**
+ * @brief Create a new group of ROHC compressors that share one CID space
+ *
+ * Create a group of \e shards_nr ROHC compressors (the shards) that serve one
+ * ROHC channel together. The CID range [0, \e max_cid] is split into
+ * contiguous ranges of the same length, one range per shard (the last shard
+ * also gets the remaining CIDs). Every shard is a complete ROHC compressor
+ * that owns the contexts of its CID range exclusively, so the shards may be
+ * run on different cores without any lock.
+ *
+ * The shards are configured one by one: retrieve them with
+ * \ref rohc_comp_group_get_shard, then enable profiles, set the trace
+ * callback... like for any other compressor. Use \ref rohc_comp_group_steer
+ * to know which shard shall compress a packet, and
+ * \ref rohc_comp_group_deliver_feedback to route feedback to the shards.
+ *
+ * @param cid_type   The type of CIDs the ROHC channel uses
+ * @param max_cid    The MAX_CID of the ROHC channel
+ * @param shards_nr  The number of shards, in range [1, \e max_cid + 1]
+ * @param rand_cb    The random callback given to every shard
+ * @param rand_priv  An optional private context for the random callback
+ * @return           The created group of compressors if successful,
+ *                   NULL if creation failed
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_group_free
+ * @see rohc_comp_group_get_shard
+ * @see rohc_comp_group_steer
+ * @see rohc_comp_group_deliver_feedback
+ */
+struct rohc_comp_group *
+	rohc_comp_group_new(const rohc_cid_type_t cid_type,
+	                    const rohc_cid_t max_cid,
+	                    const size_t shards_nr,
+	                    const rohc_comp_random_cb_t rand_cb,
+	                    void *const rand_priv)
+{
+	struct rohc_comp_group *group;
+	size_t i;
+
+	/* check input parameters, the CID type and the random callback are
+	 * checked by the creation of the shards */
+	if(shards_nr == 0 || shards_nr > (max_cid + 1))
+	{
+		goto error;
+	}
+	if((cid_type == ROHC_SMALL_CID && max_cid > ROHC_SMALL_CID_MAX) ||
+	   (cid_type == ROHC_LARGE_CID && max_cid > ROHC_LARGE_CID_MAX))
+	{
+		goto error;
+	}
+
+	group = calloc(1, sizeof(struct rohc_comp_group));
+	if(group == NULL)
+	{
+		goto error;
+	}
+	group->shards = calloc(shards_nr, sizeof(struct rohc_comp *));
+	if(group->shards == NULL)
+	{
+		goto free_group;
+	}
+	group->shards_nr = shards_nr;
+	group->shard_cids_nr = (max_cid + 1) / shards_nr;
+
+	/* create one compressor per range of CIDs */
+	for(i = 0; i < shards_nr; i++)
+	{
+		const rohc_cid_t cid_base = i * group->shard_cids_nr;
+		const rohc_cid_t cid_last =
+			((i + 1) == shards_nr ? max_cid : (cid_base + group->shard_cids_nr - 1));
+
+		group->shards[i] = rohc_comp_new2(cid_type, cid_last - cid_base,
+		                                  rand_cb, rand_priv);
+		if(group->shards[i] == NULL)
+		{
+			goto free_shards;
+		}
+		group->shards[i]->cid_base = cid_base;
+	}
+
+	return group;
+
+free_shards:
+	for(i = 0; i < shards_nr; i++)
+	{
+		rohc_comp_free(group->shards[i]);
+	}
+	free(group->shards);
+free_group:
+	free(group);
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Destroy the given group of ROHC compressors
+ *
+ * Destroy all the shards of the group, then the group itself.
+ *
+ * @param group  The group of ROHC compressors to destroy
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_group_new
+ */
+void rohc_comp_group_free(struct rohc_comp_group *const group)
+{
+	if(group != NULL)
+	{
+		size_t i;
+
+		for(i = 0; i < group->shards_nr; i++)
+		{
+			rohc_comp_free(group->shards[i]);
+		}
+		free(group->shards);
+		free(group);
+	}
+}
+
+
+/**
+ * @brief Get one shard of the given group of ROHC compressors
+ *
+ * The shard is a regular ROHC compressor: configure it and compress packets
+ * with it as usual. The shard shall not be freed with \ref rohc_comp_free,
+ * \ref rohc_comp_group_free does it.
+ *
+ * @param group      The group of ROHC compressors
+ * @param shard_idx  The index of the shard, in range [0, shards_nr - 1]
+ * @return           The shard if successful,
+ *                   NULL if the group or the index is invalid
+ *
+ * @ingroup rohc_comp
+ */
+struct rohc_comp *
+	rohc_comp_group_get_shard(const struct rohc_comp_group *const group,
+	                          const size_t shard_idx)
+{
+	if(group == NULL || shard_idx >= group->shards_nr)
+	{
+		return NULL;
+	}
+
+	return group->shards[shard_idx];
+}
+
+
+/**
+ * @brief Find out the shard that shall compress the given packet
+ *
+ * The packet is steered with the hash of its flow, ie. the key of the
+ * contexts, so that all the packets of one flow are given to the same shard
+ * and find their context there.
+ *
+ * The function does not modify the group, it may be called from any thread.
+ *
+ * @param group           The group of ROHC compressors
+ * @param uncomp_packet   The uncompressed packet to steer
+ * @param[out] shard_idx  The index of the shard that shall compress the packet
+ * @return                true if the packet was successfully steered,
+ *                        false if the packet is malformed
+ *
+ * @ingroup rohc_comp
+ */
+bool rohc_comp_group_steer(const struct rohc_comp_group *const group,
+                           const struct rohc_buf uncomp_packet,
+                           size_t *const shard_idx)
+{
+	struct net_pkt ip_pkt;
+
+	if(group == NULL || shard_idx == NULL)
+	{
+		goto error;
+	}
+	if(rohc_buf_is_malformed(uncomp_packet) || rohc_buf_is_empty(uncomp_packet))
+	{
+		goto error;
+	}
+
+	/* parse the packet without traces since the trace callbacks of the
+	 * shards might not be thread-safe */
+	if(!net_pkt_parse(&ip_pkt, uncomp_packet, NULL, NULL, NULL,
+	                  ROHC_TRACE_DEBUG, ROHC_TRACE_COMP))
+	{
+		goto error;
+	}
+	*shard_idx = ip_pkt.key % group->shards_nr;
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Deliver feedback to the shards of the given group of compressors
+ *
+ * Split the feedback data into feedback items, then enqueue every item in
+ * the feedback queue of the shard that owns its CID (see
+ * \ref rohc_comp_enqueue_feedback): the shard handles the feedback at the
+ * beginning of its next compression. The function may thus be called from
+ * another thread than the ones that run the shards, but only from one
+ * thread at a time.
+ *
+ * The traces about malformed feedback are printed through the trace
+ * callback of the first shard.
+ *
+ * @param group     The group of ROHC compressors
+ * @param feedback  The feedback data
+ * @return          true if all the feedback items were enqueued,
+ *                  false if one of the feedback items is malformed, targets
+ *                  a CID out of the CID space, or cannot be enqueued
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_enqueue_feedback
+ */
+bool rohc_comp_group_deliver_feedback(struct rohc_comp_group *const group,
+                                      const struct rohc_buf feedback)
+{
+	struct rohc_buf remain_data = feedback;
+	size_t nr_failures = 0;
+
+	if(group == NULL || rohc_buf_is_malformed(remain_data))
+	{
+		goto error;
+	}
+
+	/* parse as much feedback data as possible */
+	while(remain_data.len > 0 &&
+	      rohc_packet_is_feedback(rohc_buf_byte(remain_data)))
+	{
+		struct rohc_buf item = remain_data;
+		size_t feedback_hdr_len;
+		size_t feedback_data_len;
+		size_t shard_idx;
+		rohc_cid_t cid;
+		size_t cid_len;
+
+		if(!rohc_feedback_get_size(remain_data, &feedback_hdr_len,
+		                           &feedback_data_len) ||
+		   (feedback_hdr_len + feedback_data_len) > remain_data.len)
+		{
+			goto error;
+		}
+		item.len = feedback_hdr_len + feedback_data_len;
+
+		/* find the shard that owns the CID of the feedback item */
+		if(!rohc_comp_feedback_parse_cid(group->shards[0],
+		                                 rohc_buf_data_at(item, feedback_hdr_len),
+		                                 feedback_data_len, &cid, &cid_len))
+		{
+			goto error;
+		}
+		shard_idx = cid / group->shard_cids_nr;
+		if(shard_idx >= group->shards_nr)
+		{
+			shard_idx = group->shards_nr - 1;
+		}
+
+		/* the shard checks whether it owns a context with that CID */
+		if(cid > (group->shards[shard_idx]->cid_base +
+		          group->shards[shard_idx]->medium.max_cid))
+		{
+			rohc_warning(group->shards[0], ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "failed to deliver feedback: CID %zu is out of the CID "
+			             "space of the group", cid);
+			nr_failures++;
+		}
+		else if(!rohc_comp_enqueue_feedback(group->shards[shard_idx], item))
+		{
+			nr_failures++;
+		}
+
+		rohc_buf_pull(&remain_data, item.len);
+	}
+
+	return (nr_failures == 0);
+
+error:
+	return false;
+}
+
+/**
+ * @brief Create a new configuration to share between ROHC compressors
+ *
+ * Create a configuration with the given type of CIDs and MAX_CID, and the
+ * same defaults as \ref rohc_comp_new2: no profile enabled, a W-LSB window
+ * width of 4, the default timeouts for periodic refreshes, and no
+ * segmentation.
+ *
+ * Set up the configuration with the rohc_comp_config_* functions, then create
+ * as many compressors from it as needed with \ref rohc_comp_new_from_config.
+ * Creating a compressor from a configuration is cheaper than configuring
+ * every compressor one by one, and all the compressors get the very same
+ * settings. The configuration cannot be modified anymore once a compressor
+ * was created from it.
+ *
+ * @param cid_type  The type of Context IDs (CID) that the ROHC compressors
+ *                  shall operate with, see \ref rohc_comp_new2
+ * @param max_cid   The maximum value that the ROHC compressors should use for
+ *                  context IDs (CID), see \ref rohc_comp_new2
+ * @return          The created configuration if successful,
+ *                  NULL if creation failed
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_config_free
+ * @see rohc_comp_new_from_config
+ */
+struct rohc_comp_config *
+	rohc_comp_config_new(const rohc_cid_type_t cid_type,
+	                     const rohc_cid_t max_cid)
+{
+	struct rohc_comp_config *config;
+
+	if((cid_type != ROHC_SMALL_CID && cid_type != ROHC_LARGE_CID) ||
+	   (cid_type == ROHC_SMALL_CID && max_cid > ROHC_SMALL_CID_MAX) ||
+	   (cid_type == ROHC_LARGE_CID && max_cid > ROHC_LARGE_CID_MAX))
+	{
+		goto error;
+	}
+
+	config = calloc(1, sizeof(struct rohc_comp_config));
+	if(config == NULL)
+	{
+		goto error;
+	}
+	config->refs_nr = 1;
+	config->cid_type = cid_type;
+	config->max_cid = max_cid;
+	config->wlsb_window_width = ROHC_COMP_WLSB_WIDTH;
+	config->periodic_refreshes_ir_timeout = CHANGE_TO_IR_COUNT;
+	config->periodic_refreshes_fo_timeout = CHANGE_TO_FO_COUNT;
+	config->mrru = 0;
+	config->numa_node = ROHC_NUMA_NO_NODE;
+
+	return config;
+
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Release the given configuration of ROHC compressors
+ *
+ * Release the reference that the creator of the configuration holds. The
+ * configuration is destroyed once the compressors created from it are
+ * destroyed too, so it may be released as soon as the compressors are
+ * created.
+ *
+ * @param config  The configuration to release
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_config_new
+ */
+void rohc_comp_config_free(struct rohc_comp_config *const config)
+{
+	if(config != NULL)
+	{
+		rohc_comp_config_put(config);
+	}
+}
+
+
+/**
+ * @brief Enable a compression profile in the given configuration
+ *
+ * @param config   The configuration of ROHC compressors
+ * @param profile  The profile to enable
+ * @return         true if the profile was enabled,
+ *                 false if the profile does not exist or if the
+ *                 configuration is already in use
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_enable_profile
+ */
+bool rohc_comp_config_enable_profile(struct rohc_comp_config *const config,
+                                     const rohc_profile_t profile)
+{
+	size_t i;
+
+	if(config == NULL || rohc_comp_config_is_frozen(config))
+	{
+		goto error;
+	}
+
+	for(i = 0; i < C_NUM_PROFILES; i++)
+	{
+		if(rohc_comp_profiles[i]->id == profile)
+		{
+			config->enabled_profiles[i] = true;
+			return true;
+		}
+	}
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Set the W-LSB window width in the given configuration
+ *
+ * @param config  The configuration of ROHC compressors
+ * @param width   The width of the W-LSB sliding window, a power of 2,
+ *                always 2 if the library is built with small contexts
+ * @return        true if the width was set,
+ *                false if the width is invalid or if the configuration is
+ *                already in use
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_set_wlsb_window_width
+ */
+bool rohc_comp_config_set_wlsb_window_width(struct rohc_comp_config *const config,
+                                            const size_t width)
+{
+	if(config == NULL || rohc_comp_config_is_frozen(config))
+	{
+		goto error;
+	}
+	if(width == 0 || (width & (width - 1)) != 0)
+	{
+		goto error;
+	}
+#if ROHC_SMALL_CONTEXTS == 1
+	if(width != ROHC_COMP_WLSB_WIDTH)
+	{
+		goto error;
+	}
+#endif
+
+	config->wlsb_window_width = width;
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Set the number of contexts to allocate in advance in the given
+ *        configuration
+ *
+ * The compressors created from the configuration allocate the bodies of
+ * that many contexts for every enabled profile when they are created, at
+ * most the number of their own contexts.
+ *
+ * @param config    The configuration of ROHC compressors
+ * @param ctxts_nr  The number of contexts expected per profile, 0 to allocate
+ *                  the context bodies only when contexts are created
+ * @return          true if the number was set,
+ *                  false if the configuration is already in use
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_set_ctxts_prealloc
+ */
+bool rohc_comp_config_set_ctxts_prealloc(struct rohc_comp_config *const config,
+                                         const size_t ctxts_nr)
+{
+	if(config == NULL || rohc_comp_config_is_frozen(config))
+	{
+		goto error;
+	}
+
+	config->ctxts_prealloc_nr = ctxts_nr;
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Set the NUMA node of the compressors created from the given
+ *        configuration
+ *
+ * The compressors created from the configuration allocate themselves, their
+ * arrays of contexts and the bodies of their contexts on the given NUMA node.
+ * Give the node of the core that runs the compressor, so that the contexts
+ * are not accessed across sockets.
+ *
+ * The memory is really placed on the node by the Linux kernel module, or by
+ * the NUMA-aware allocation function of the custom allocator (see
+ * \ref rohc_alloc_set_numa_allocator). Otherwise the operating system
+ * places the memory on the node of the thread that touches it first.
+ *
+ * @param config     The configuration of ROHC compressors
+ * @param numa_node  The NUMA node, \ref ROHC_NUMA_NO_NODE for any node
+ * @return           true if the node was set,
+ *                   false if the node is invalid or if the configuration is
+ *                   already in use
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_config_new
+ * @see rohc_alloc_set_numa_allocator
+ */
+bool rohc_comp_config_set_numa_node(struct rohc_comp_config *const config,
+                                    const int numa_node)
+{
+	if(config == NULL || rohc_comp_config_is_frozen(config))
+	{
+		goto error;
+	}
+	if(numa_node < ROHC_NUMA_NO_NODE)
+	{
+		goto error;
+	}
+
+	config->numa_node = numa_node;
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Set the timeouts for periodic refreshes in the given configuration
+ *
+ * @param config      The configuration of ROHC compressors
+ * @param ir_timeout  The number of packets to compress before going back
+ *                    to IR state to force a context refresh
+ * @param fo_timeout  The number of packets to compress before going back
+ *                    to FO state to force a context refresh
+ * @return            true if the timeouts were set,
+ *                    false if the timeouts are invalid or if the
+ *                    configuration is already in use
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_set_periodic_refreshes
+ */
+bool rohc_comp_config_set_periodic_refreshes(struct rohc_comp_config *const config,
+                                             const size_t ir_timeout,
+                                             const size_t fo_timeout)
+{
+	if(config == NULL || rohc_comp_config_is_frozen(config))
+	{
+		goto error;
+	}
+	if(ir_timeout == 0 || fo_timeout == 0 || ir_timeout <= fo_timeout)
+	{
+		goto error;
+	}
+
+	config->periodic_refreshes_ir_timeout = ir_timeout;
+	config->periodic_refreshes_fo_timeout = fo_timeout;
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Set the MRRU in the given configuration
+ *
+ * @param config  The configuration of ROHC compressors
+ * @param mrru    The new MRRU value (in bytes), 0 to disable segmentation
+ * @return        true if the MRRU was set,
+ *                false if the MRRU is invalid or if the configuration is
+ *                already in use
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_set_mrru
+ */
+bool rohc_comp_config_set_mrru(struct rohc_comp_config *const config,
+                               const size_t mrru)
+{
+	if(config == NULL || rohc_comp_config_is_frozen(config))
+	{
+		goto error;
+	}
+	if(mrru > ROHC_MAX_MRRU)
+	{
+		goto error;
+	}
+
+	config->mrru = mrru;
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Set the RTP detection callback in the given configuration
+ *
+ * @param config       The configuration of ROHC compressors
+ * @param callback     The callback function used to detect RTP packets,
+ *                     NULL to deactivate it
+ * @param rtp_private  A pointer to an external memory area provided and used
+ *                     by the callback user, shared by all the compressors
+ * @return             true if the callback was set,
+ *                     false if the configuration is already in use
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_set_rtp_detection_cb
+ */
+bool rohc_comp_config_set_rtp_detection_cb(struct rohc_comp_config *const config,
+                                           rohc_rtp_detection_callback_t callback,
+                                           void *const rtp_private)
+{
+	if(config == NULL || rohc_comp_config_is_frozen(config))
+	{
+		return false;
+	}
+
+	config->rtp_callback = callback;
+	config->rtp_private = rtp_private;
+
+	return true;
+}
+
+
+/**
+ * @brief Create a new ROHC compressor from a shared configuration
+ *
+ * Create a new ROHC compressor with the settings of the given configuration.
+ * The compressor references the configuration until it is destroyed, the
+ * configuration cannot be modified anymore.
+ *
+ * Only the settings of the compressor are shared: its contexts, statistics
+ * and trace callback are its own, so every compressor created from the same
+ * configuration may be run on its own core.
+ *
+ * @param config     The configuration of the ROHC compressor
+ * @param rand_cb    The random callback to set
+ * @param rand_priv  Private data that will be given to the callback, may be
+ *                   used as a context by user
+ * @return           The created compressor if successful,
+ *                   NULL if creation failed
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_config_new
+ * @see rohc_comp_new2
+ * @see rohc_comp_free
+ */
+struct rohc_comp *
+	rohc_comp_new_from_config(struct rohc_comp_config *const config,
+	                          const rohc_comp_random_cb_t rand_cb,
+	                          void *const rand_priv)
+{
+	struct rohc_comp *comp;
+
+	if(config == NULL)
+	{
+		goto error;
+	}
+
+	comp = rohc_comp_new_on_node(config->cid_type, config->max_cid,
+	                             rand_cb, rand_priv, config->numa_node);
+	if(comp == NULL)
+	{
+		goto error;
+	}
+	if(config->mrru > 0 && !rohc_comp_set_mrru(comp, config->mrru))
+	{
+		goto destroy_comp;
+	}
+	memcpy(comp->enabled_profiles, config->enabled_profiles,
+	       sizeof(bool) * C_NUM_PROFILES);
+	comp->wlsb_window_width = config->wlsb_window_width;
+	comp->ctxts_prealloc_nr = rohc_min(config->ctxts_prealloc_nr,
+	                                   comp->medium.max_cid + 1);
+	if(!c_prealloc_all_ctxts(comp))
+	{
+		goto destroy_comp;
+	}
+	comp->periodic_refreshes_ir_timeout = config->periodic_refreshes_ir_timeout;
+	comp->periodic_refreshes_fo_timeout = config->periodic_refreshes_fo_timeout;
+	comp->rtp_callback = config->rtp_callback;
+	comp->rtp_private = config->rtp_private;
+
+	/* reference the configuration, freezing it */
+	__atomic_add_fetch(&config->refs_nr, 1, __ATOMIC_RELAXED);
+	comp->config = config;
+
+	return comp;
+
+destroy_comp:
+	rohc_comp_free(comp);
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Detach one context from the given ROHC compressor
+ *
+ * Detach the context with the given CID from the compressor, so that it may
+ * be attached to another compressor with \ref rohc_comp_ctxt_import. The
+ * whole context is moved, profile-specific part included (W-LSB windows,
+ * list tables, TCP options...), so that the other compressor goes on
+ * compressing the flow in the very same state without any new IR packet.
+ *
+ * The CID is given back to the source compressor: its next packet for the
+ * flow would create a new context.
+ *
+ * @param comp  The ROHC compressor to detach the context from
+ * @param cid   The CID of the context to detach
+ * @return      The detached context if successful,
+ *              NULL if the CID is not in use
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_ctxt_import
+ * @see rohc_comp_ctxt_export_free
+ */
+struct rohc_comp_ctxt_export *
+	rohc_comp_ctxt_export(struct rohc_comp *const comp,
+	                      const rohc_cid_t cid)
+{
+	struct rohc_comp_ctxt_export *export;
+	struct rohc_comp_ctxt *context;
+
+	if(comp == NULL)
+	{
+		goto error;
+	}
+
+	context = c_get_context(comp, cid);
+	if(context == NULL)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "cannot export context with CID %zu: context not in use",
+		             cid);
+		goto error;
+	}
+
+	export = malloc(sizeof(struct rohc_comp_ctxt_export));
+	if(export == NULL)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "failed to allocate memory to export context with CID %zu",
+		             cid);
+		goto error;
+	}
+
+	/* the profile-specific part now belongs to the exported context */
+	c_detach_context(comp, context);
+	memcpy(&export->ctxt, context, sizeof(struct rohc_comp_ctxt));
+	export->ctxt.compressor = NULL;
+	export->ctxt.lru_prev = NULL;
+	export->ctxt.lru_next = NULL;
+	export->wlsb_window_width = comp->wlsb_window_width;
+	export->list_trans_nr = comp->list_trans_nr;
+	export->trace_callback = comp->trace_callback;
+	export->trace_callback_priv = comp->trace_callback_priv;
+	export->trace_level = comp->trace_level;
+	context->specific = NULL;
+
+	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	           "context (CID = %zu) exported (num_used = %zu)", cid,
+	           comp->num_contexts_used);
+
+	return export;
+
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Attach one context detached from another ROHC compressor
+ *
+ * Attach the context detached by \ref rohc_comp_ctxt_export to the given
+ * compressor with the same CID. The context keeps its mode and its state.
+ *
+ * The compressor shall own the CID and shall not use it yet. It shall enable
+ * the profile of the context, and share the W-LSB window width, the number
+ * of uncompressed transmissions for list compression, and the trace callback
+ * of the source compressor, since the profile-specific part of the context
+ * was built with them. Compressors created from the same shared
+ * configuration fulfill all these requirements but the trace callback.
+ *
+ * The exported context is freed on success only.
+ *
+ * @param comp    The ROHC compressor to attach the context to
+ * @param export  The context detached from another compressor
+ * @return        true if the context was successfully attached,
+ *                false if the context cannot be attached to the compressor
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_ctxt_export
+ */
+bool rohc_comp_ctxt_import(struct rohc_comp *const comp,
+                           struct rohc_comp_ctxt_export *const export)
+{
+	const rohc_cid_t cid = (export != NULL ? export->ctxt.cid : 0);
+	struct rohc_comp_ctxt *context;
+
+	if(comp == NULL || export == NULL)
+	{
+		goto error;
+	}
+
+	/* the CID shall be owned by the compressor and shall be free */
+	if(cid < comp->cid_base || (cid - comp->cid_base) > comp->medium.max_cid)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "cannot import context with CID %zu: CID out of range "
+		             "[%zu, %zu]", cid, comp->cid_base,
+		             comp->cid_base + comp->medium.max_cid);
+		goto error;
+	}
+	context = &comp->contexts[cid - comp->cid_base];
+	if(context->used)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "cannot import context with CID %zu: CID already in use",
+		             cid);
+		goto error;
+	}
+
+	/* the context shall be compatible with the compressor */
+	if(rohc_get_profile_from_id(comp, export->ctxt.profile->id) == NULL)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "cannot import context with CID %zu: profile 0x%04x is "
+		             "not enabled", cid, export->ctxt.profile->id);
+		goto error;
+	}
+	if(export->wlsb_window_width != comp->wlsb_window_width ||
+	   export->list_trans_nr != comp->list_trans_nr ||
+	   export->trace_callback != comp->trace_callback ||
+	   export->trace_callback_priv != comp->trace_callback_priv ||
+	   export->trace_level != comp->trace_level)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "cannot import context with CID %zu: compressors do not "
+		             "share the same settings", cid);
+		goto error;
+	}
+
+	/* attach the context */
+	memcpy(context, &export->ctxt, sizeof(struct rohc_comp_ctxt));
+	c_take_free_cid(comp, cid - comp->cid_base);
+	c_attach_context(comp, context);
+	free(export);
+
+	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	           "context (CID = %zu) imported in state %s (num_used = %zu)",
+	           cid, rohc_comp_get_state_descr(context->state),
+	           comp->num_contexts_used);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Destroy a context that was detached but never attached again
+ *
+ * @param export  The context detached by \ref rohc_comp_ctxt_export
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_ctxt_export
+ */
+void rohc_comp_ctxt_export_free(struct rohc_comp_ctxt_export *const export)
+{
+	if(export != NULL)
+	{
+		export->ctxt.profile->destroy(&export->ctxt);
+		free(export);
+	}
+}
+
+
+/**
+ * @brief Save the contexts of the given ROHC compressor in a snapshot
+ *
+ * Write a binary snapshot of the contexts of the compressor, so that another
+ * compressor, possibly in another process, may go on compressing the same
+ * flows without re-establishing them with IR packets (warm restarts,
+ * active/standby failover...).
+ *
+ * The snapshot is written record by record with the given callback: one
+ * header, one record per context, then one end record. The snapshot is
+ * thus never held in memory as a whole. The snapshot is versioned and shall
+ * be restored by the same build of the library, see \ref rohc_comp_restore.
+ *
+ * The contexts of profiles that cannot be saved yet are skipped: their flows
+ * are re-established with IR packets once restored.
+ *
+ * @param comp      The ROHC compressor to save
+ * @param write_cb  The callback used to write the records of the snapshot
+ * @param priv      The private context given to the callback
+ * @return          true if the snapshot was successfully written,
+ *                  false if parameters are invalid or the callback failed
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_restore
+ */
+bool rohc_comp_snapshot(const struct rohc_comp *const comp,
+                        const rohc_snapshot_write_t write_cb,
+                        void *const priv)
+{
+	struct rohc_comp_snapshot_ctxt record;
+	struct rohc_snapshot_hdr hdr;
+	size_t saved_nr = 0;
+	size_t i;
+
+	if(comp == NULL || write_cb == NULL)
+	{
+		goto error;
+	}
+
+	memset(&hdr, 0, sizeof(struct rohc_snapshot_hdr));
+	hdr.magic = ROHC_SNAPSHOT_MAGIC;
+	hdr.version = ROHC_SNAPSHOT_VERSION;
+	hdr.entity = ROHC_SNAPSHOT_COMP;
+	hdr.cid_type = comp->medium.cid_type;
+	hdr.max_cid = comp->cid_base + comp->medium.max_cid;
+	if(!write_cb(priv, (uint8_t *) &hdr, sizeof(struct rohc_snapshot_hdr)))
+	{
+		goto error;
+	}
+
+	for(i = 0; i <= comp->medium.max_cid; i++)
+	{
+		const struct rohc_comp_ctxt *const context = &comp->contexts[i];
+
+		if(!comp->contexts_hot[i].used)
+		{
+			continue;
+		}
+		if(context->profile->snapshot == NULL)
+		{
+			rohc_debug(comp, ROHC_TRACE_COMP, context->profile->id,
+			           "skip context with CID %zu: profile cannot be saved",
+			           context->cid);
+			continue;
+		}
+
+		if(!c_snapshot_ctxt(context, write_cb, priv))
+		{
+			rohc_warning(comp, ROHC_TRACE_COMP, context->profile->id,
+			             "failed to save context with CID %zu", context->cid);
+			goto error;
+		}
+		saved_nr++;
+	}
+
+	/* end of snapshot */
+	memset(&record, 0, sizeof(struct rohc_comp_snapshot_ctxt));
+	record.profile_id = ROHC_SNAPSHOT_END;
+	if(!write_cb(priv, (uint8_t *) &record,
+	             sizeof(struct rohc_comp_snapshot_ctxt)))
+	{
+		goto error;
+	}
+
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	          "%zu contexts saved out of %zu", saved_nr,
+	          comp->num_contexts_used);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Restore the contexts of a ROHC compressor from a snapshot
+ *
+ * Read the binary snapshot written by \ref rohc_comp_snapshot and re-build
+ * its contexts in the given compressor. The contexts keep their mode and
+ * state, so that compression goes on without any IR packet.
+ *
+ * The compressor shall be configured like the saved one beforehand: same
+ * type of CIDs and MAX_CID, same W-LSB window width, and the profiles of
+ * the saved contexts enabled. The CIDs of the saved contexts shall not be
+ * in use yet. If the restoration fails, the contexts that were restored so
+ * far are kept.
+ *
+ * @param comp     The ROHC compressor to restore the contexts in
+ * @param read_cb  The callback used to read the records of the snapshot
+ * @param priv     The private context given to the callback
+ * @return         true if the snapshot was successfully restored,
+ *                 false if parameters are invalid, if the snapshot is
+ *                 malformed or does not match the compressor, or if the
+ *                 callback failed
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_snapshot
+ */
+bool rohc_comp_restore(struct rohc_comp *const comp,
+                       const rohc_snapshot_read_t read_cb,
+                       void *const priv)
+{
+	struct rohc_comp_snapshot_ctxt record;
+	struct rohc_snapshot_hdr hdr;
+	size_t restored_nr = 0;
+
+	if(comp == NULL || read_cb == NULL)
+	{
+		goto error;
+	}
+
+	if(!read_cb(priv, (uint8_t *) &hdr, sizeof(struct rohc_snapshot_hdr)))
+	{
+		goto error;
+	}
+	if(hdr.magic != ROHC_SNAPSHOT_MAGIC ||
+	   hdr.version != ROHC_SNAPSHOT_VERSION ||
+	   hdr.entity != ROHC_SNAPSHOT_COMP)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "snapshot is not a compressor snapshot in version %u",
+		             ROHC_SNAPSHOT_VERSION);
+		goto error;
+	}
+	if(hdr.cid_type != comp->medium.cid_type ||
+	   hdr.max_cid != (comp->cid_base + comp->medium.max_cid))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "snapshot was taken with another type of CIDs or "
+		             "MAX_CID");
+		goto error;
+	}
+
+	while(read_cb(priv, (uint8_t *) &record,
+	              sizeof(struct rohc_comp_snapshot_ctxt)))
+	{
+		const struct rohc_comp_profile *profile;
+		struct rohc_comp_ctxt *context;
+
+		if(record.profile_id == ROHC_SNAPSHOT_END)
+		{
+			rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			          "%zu contexts restored", restored_nr);
+			return true;
+		}
+
+		/* the profile shall be enabled and the CID shall be free */
+		profile = rohc_get_profile_from_id(comp, record.profile_id);
+		if(profile == NULL || profile->restore == NULL)
+		{
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "cannot restore context with CID %u: profile 0x%04x "
+			             "is not enabled or cannot be restored", record.cid,
+			             record.profile_id);
+			goto error;
+		}
+		if(record.cid < comp->cid_base ||
+		   (record.cid - comp->cid_base) > comp->medium.max_cid ||
+		   comp->contexts_hot[record.cid - comp->cid_base].used)
+		{
+			rohc_warning(comp, ROHC_TRACE_COMP, profile->id, "cannot restore "
+			             "context with CID %u: CID out of range or in use",
+			             record.cid);
+			goto error;
+		}
+
+		context = c_restore_ctxt(comp, profile, &record, read_cb, priv);
+		if(context == NULL)
+		{
+			rohc_warning(comp, ROHC_TRACE_COMP, profile->id,
+			             "failed to restore context with CID %u", record.cid);
+			goto error;
+		}
+		c_take_free_cid(comp, record.cid - comp->cid_base);
+		c_attach_context(comp, context);
+		restored_nr++;
+	}
+
+	rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	             "snapshot is truncated after %zu contexts", restored_nr);
+
+error:
+	return false;
+}
+
+
+/*
+ * Definitions of private functions
+ */
+
+
+/**
+ * @brief Is the given configuration of compressors already in use?
+ *
+ * @param config  The configuration of ROHC compressors
+ * @return        true if one compressor references the configuration,
+ *                false if only its creator does
+ */
+static bool rohc_comp_config_is_frozen(const struct rohc_comp_config *const config)
+{
+	return (__atomic_load_n(&config->refs_nr, __ATOMIC_ACQUIRE) > 1);
+}
+
+
+/**
+ * @brief Drop one reference to the given configuration of compressors
+ *
+ * The configuration is destroyed when its last reference is dropped.
+ *
+ * @param config  The configuration of ROHC compressors
+ */
+static void rohc_comp_config_put(struct rohc_comp_config *const config)
+{
+	if(__atomic_sub_fetch(&config->refs_nr, 1, __ATOMIC_ACQ_REL) == 0)
+	{
+		free(config);
+	}
+}
+
+
+/**
+ * @brief Find out a ROHC profile given a profile ID
+ *
+ * @param comp       The ROHC compressor
+ * @param profile_id The ID of the ROHC profile to find out
+ * @return           The ROHC profile if found, NULL otherwise
+ */
+static const struct rohc_comp_profile *
+	rohc_get_profile_from_id(const struct rohc_comp *comp,
+	                         const rohc_profile_t profile_id)
+{
+	size_t i;
+
+	/* test all compression profiles in their order of evaluation, so that
+	 * a registered profile takes precedence over the built-in one */
+	for(i = 0; i < comp->profiles_nr; i++)
+	{
+		const size_t idx = comp->profiles_order[i];
+
+		/* if the profile IDs match and the profile is enabled */
+		if(comp->profiles[idx]->id == profile_id && comp->enabled_profiles[idx])
+		{
+			return comp->profiles[idx];
+		}
+	}
+
+	return NULL;
+}
+
+
+/**
+ * @brief Is the packet compressible by the Uncompressed profile only?
+ *
+ * All the other profiles reject the packets whose outer IP header is neither
+ * IPv4 nor IPv6 (malformed) or is an IP fragment: there is no need to ask
+ * them one by one.
+ *
+ * @param packet  The packet to classify
+ * @return        true if only the Uncompressed profile accepts the packet,
+ *                false if the profiles shall be tested
+ */
+static bool c_is_uncompressible(const struct net_pkt *const packet)
+{
+	const ip_version version = ip_get_version(&packet->outer_ip);
+
+	return ((version != IPV4 && version != IPV6) ||
+	        ip_is_fragment(&packet->outer_ip));
+}
+
+
+/**
+ * @brief Find out a ROHC profile given an IP protocol ID
+ *
+ * The profile that classified the previous packets of the flow is cached:
+ * if it still accepts the packet, the other profiles are not tested. The
+ * cached profile is checked again for every packet, since some of the checks
+ * depend on the packet and not only on its flow (IP fragments, checksums...).
+ *
+ * A verdict is cached only if it is not the fallback of a profile dedicated
+ * to the transport protocol of the packet that rejected it (a malformed TCP
+ * segment compressed with the IP profile for example), so that one bad packet
+ * does not move the whole flow to a less efficient profile.
+ *
+ * @param comp    The ROHC compressor
+ * @param packet  The packet to find a compression profile for
+ * @return        The ROHC profile if found, NULL otherwise
+ */
+static const struct rohc_comp_profile *
+	c_get_profile_from_packet(struct rohc_comp *const comp,
+	                          const struct net_pkt *const packet)
+{
+	struct rohc_comp_profile_cache_entry *const entry =
+		&comp->profile_cache[c_ctxt_index_hash(comp, 0, packet->key)];
+	bool is_fallback = false;
+	bool cache_verdict = true;
+	size_t i;
+
+	/* packets that no profile but the Uncompressed one accepts skip the
+	 * classification, they do not change the verdict of their flow either */
+	if(c_is_uncompressible(packet))
+	{
+		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "outer IP header is neither IPv4 nor IPv6 or is fragmented, "
+		           "only the Uncompressed profile may compress the packet");
+		return rohc_get_profile_from_id(comp, ROHC_PROFILE_UNCOMPRESSED);
+	}
+
+	/* the flow was already classified? */
+	if(entry->profile_idx != 0 && entry->key == packet->key &&
+	   entry->proto == packet->transport->proto)
+	{
+		const struct rohc_comp_profile *const profile =
+			comp->profiles[entry->profile_idx - 1];
+
+		if(comp->enabled_profiles[entry->profile_idx - 1] &&
+		   c_profile_alloc_allowed(comp, profile) &&
+		   profile->check_profile(comp, packet))
+		{
+			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			           "profile '%s' (0x%04x) found in cache for packet",
+			           rohc_get_profile_descr(profile->id), profile->id);
+			return profile;
+		}
+
+		/* the packet is not like the previous ones of the flow, do not let
+		 * it change the verdict of the flow */
+		entry->profile_idx = 0;
+		cache_verdict = false;
+	}
+
+	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	           "try to find the best profile for packet with transport "
+	           "protocol %u", packet->transport->proto);
+
+	/* test all compression profiles in their order of evaluation */
+	for(i = 0; i < comp->profiles_nr; i++)
+	{
+		const size_t idx = comp->profiles_order[i];
+		const struct rohc_comp_profile *const profile = comp->profiles[idx];
+		bool check_profile;
+
+		/* skip profile if the profile is not enabled */
+		if(!comp->enabled_profiles[idx])
+		{
+			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			           "skip disabled profile '%s' (0x%04x)",
+			           rohc_get_profile_descr(profile->id), profile->id);
+			continue;
+		}
+
+		/* skip profile if it would allocate memory for its contexts */
+		if(!c_profile_alloc_allowed(comp, profile))
+		{
+			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			           "skip profile '%s' (0x%04x) that allocates memory for "
+			           "its contexts", rohc_get_profile_descr(profile->id),
+			           profile->id);
+			continue;
+		}
+
+		/* does the profile accept the packet? */
+		check_profile = profile->check_profile(comp, packet);
+		if(!check_profile)
+		{
+			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			           "skip profile '%s' (0x%04x) because it does not match "
+			           "packet", rohc_get_profile_descr(profile->id), profile->id);
+			if(profile->protocol == packet->transport->proto)
+			{
+				is_fallback = true;
+			}
+			continue;
+		}
+
+		/* the packet is compatible with the profile, let's go with it! */
+		if(cache_verdict &&
+		   (!is_fallback || profile->protocol == packet->transport->proto) &&
+		   !c_rtp_on_probation(comp, packet))
+		{
+			entry->key = packet->key;
+			entry->proto = packet->transport->proto;
+			entry->profile_idx = idx + 1;
+			entry->failed_until = 0;
+		}
+		return profile;
+	}
+
+	return NULL;
+}
+
+
+/**
+ * @brief Forget the profile that classified the flow of a context
+ *
+ * @param comp     The ROHC compressor
+ * @param context  The compression context that is destroyed
+ */
+static void c_profile_cache_del(struct rohc_comp *const comp,
+                                const struct rohc_comp_ctxt *const context)
+{
+	struct rohc_comp_profile_cache_entry *const entry =
+		&comp->profile_cache[c_ctxt_index_hash(comp, 0, context->key)];
+
+	if(entry->profile_idx != 0 && entry->key == context->key &&
+	   comp->profiles[entry->profile_idx - 1] == context->profile)
+	{
+		entry->profile_idx = 0;
+	}
+}
+
+
+/**
+ * @brief Did the profile of the flow of the packet fail recently?
+ *
+ * @param comp    The ROHC compressor
+ * @param packet  The packet to compress
+ * @param now     The arrival time of the packet
+ * @return        true if the packet shall go straight to the Uncompressed
+ *                profile, false if the profiles shall be tested
+ */
+static bool c_profile_failed(const struct rohc_comp *const comp,
+                             const struct net_pkt *const packet,
+                             const struct rohc_ts now)
+{
+	const struct rohc_comp_profile_cache_entry *entry;
+
+	if(comp->profile_failure_timeout == 0)
+	{
+		return false;
+	}
+	entry = &comp->profile_cache[c_ctxt_index_hash(comp, 0, packet->key)];
+
+	return (entry->failed_until != 0 && entry->key == packet->key &&
+	        entry->proto == packet->transport->proto &&
+	        now.sec < entry->failed_until);
+}
+
+
+/**
+ * @brief Remember that the profile of the flow of the packet failed
+ *
+ * The verdict cached for the flow is replaced by the failure, so that the
+ * flow is classified again once the failure timeout expires.
+ *
+ * @param comp    The ROHC compressor
+ * @param packet  The packet that the profile failed to compress
+ * @param now     The arrival time of the packet
+ */
+static void c_profile_failure_add(struct rohc_comp *const comp,
+                                  const struct net_pkt *const packet,
+                                  const struct rohc_ts now)
+{
+	struct rohc_comp_profile_cache_entry *const entry =
+		&comp->profile_cache[c_ctxt_index_hash(comp, 0, packet->key)];
+	const uint64_t failed_until = now.sec + comp->profile_failure_timeout;
+
+	if(comp->profile_failure_timeout == 0 || now.sec == 0)
+	{
+		return;
+	}
+
+	entry->key = packet->key;
+	entry->proto = packet->transport->proto;
+	entry->profile_idx = 0;
+	entry->failed_until = (failed_until > UINT32_MAX ? UINT32_MAX : failed_until);
+
+	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "the next packets "
+	           "of the flow go straight to the Uncompressed profile for %zu "
+	           "seconds", comp->profile_failure_timeout);
+}
+
+
+/**
+ * @brief Forget the profiles that classified all the flows
+ *
+ * The flows shall be classified again once the profiles or the RTP detection
+ * changed.
+ *
+ * @param comp  The ROHC compressor
+ */
+static void c_profile_cache_flush(struct rohc_comp *const comp)
+{
+	if(comp->profile_cache != NULL)
+	{
+		memset(comp->profile_cache, 0, (comp->contexts_index_mask + 1) *
+		       sizeof(struct rohc_comp_profile_cache_entry));
+	}
+}
+
+
+/**
+ * @brief May the profile create contexts with the allocations the compressor
+ *        allows?
+ *
+ * Without allocation (see \ref ROHC_COMP_FEATURE_NO_ALLOC), only the profiles
+ * that allocate nothing but the bodies of their contexts are allowed.
+ *
+ * @param comp     The ROHC compressor
+ * @param profile  The compression profile
+ * @return         true if the profile may create contexts, false otherwise
+ */
+static bool c_profile_alloc_allowed(const struct rohc_comp *const comp,
+                                    const struct rohc_comp_profile *const profile)
+{
+	return ((comp->features & ROHC_COMP_FEATURE_NO_ALLOC) == 0 ||
+	        profile->body_only);
+}
+
+
+/**
+ * @brief Create a compression context
+ *
+ * @param comp          The ROHC compressor
+ * @param profile       The profile to associate the context with
+ * @param packet        The packet to create a compression context for
+ * @param cid           The CID of the context to create, ROHC_COMP_CID_NONE
+ *                      to take any free CID; the context that uses the given
+ *                      CID if any is released first
+ * @param arrival_time  The time at which packet was received (0 if unknown,
+ *                      or to disable time-related features in ROHC protocol)
+ * @return              The compression context if successful, NULL otherwise
+ */
+static struct rohc_comp_ctxt *
+	c_create_context(struct rohc_comp *const comp,
+	                 const struct rohc_comp_profile *const profile,
+	                 const struct net_pkt *const packet,
+	                 const rohc_cid_t cid,
+	                 const struct rohc_ts arrival_time)
+{
+	const struct rohc_comp_ctxt *src_ctxt;
+	struct rohc_comp_ctxt *c;
+	rohc_cid_t cid_to_use;
+
+	assert(comp != NULL);
+	assert(profile != NULL);
+	assert(packet != NULL);
+
+	if(!c_profile_alloc_allowed(comp, profile))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, profile->id, "the profile cannot "
+		             "create contexts without allocating memory");
+		return NULL;
+	}
+
+	/* if the CID is given:
+	 *   => release the context that uses it if any, then take it
+	 * if at least one context in the array is not used:
+	 *   => pick the unused context on top of the stack of free CIDs
+	 * if the other contexts in the array are cold:
+	 *   => drop the oldest cold context to take its CID
+	 * if all the contexts in the array are used:
+	 *   => recycle the least recently used context to make room
+	 */
+	if(cid != ROHC_COMP_CID_NONE)
+	{
+		struct rohc_comp_ctxt *const old = c_get_context(comp, cid);
+
+		if(old != NULL)
+		{
+			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			           "recycle context (CID = %zu) for another flow", cid);
+			rohc_probe3(comp_ctxt_recycle, comp, old->cid, old->profile->id);
+			if(comp->last_context == old)
+			{
+				comp->last_context = NULL;
+			}
+			c_release_context(comp, old);
+			old->key = 0; /* reset context key */
+		}
+		cid_to_use = cid - comp->cid_base;
+		c_take_free_cid(comp, cid_to_use);
+	}
+	else if(comp->free_cids_nr == 0 && comp->cold_oldest != NULL)
+	{
+		/* the CIDs that are not used are all held by cold contexts, the oldest
+		 * cold context gives its CID up */
+		cid_to_use = comp->cold_oldest->cid_idx;
+		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "drop oldest cold context (CID = %zu)",
+		           comp->cid_base + cid_to_use);
+		c_cold_drop(comp, comp->cold_oldest);
+	}
+	else if(comp->free_cids_nr == 0)
+	{
+		/* all the contexts in the array were used, recycle the least recently
+		 * used context (the tail of the LRU list) to make some room */
+		struct rohc_comp_ctxt *const oldest = comp->lru_tail;
+
+		assert(comp->num_contexts_used > comp->medium.max_cid);
+		assert(oldest != NULL);
+
+		/* destroy the oldest context before replacing it with a new one */
+		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "recycle oldest context (CID = %zu)", oldest->cid);
+		rohc_probe3(comp_ctxt_recycle, comp, oldest->cid, oldest->profile->id);
+		c_release_context(comp, oldest);
+		oldest->key = 0; /* reset context key */
+		assert(comp->free_cids_nr == 1);
+		comp->free_cids_nr--;
+		cid_to_use = comp->free_cids[comp->free_cids_nr];
+	}
+	else
+	{
+		comp->free_cids_nr--;
+		cid_to_use = comp->free_cids[comp->free_cids_nr];
+	}
+	assert(comp->contexts[cid_to_use].used == 0);
+	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	           "take unused context (CID = %zu)", comp->cid_base + cid_to_use);
+
+	/* initialize the previously found context */
+	c = &comp->contexts[cid_to_use];
+
+	c->ir_count = 0;
+	c->fo_count = 0;
+	c->so_count = 0;
+	c->go_back_fo_count = 0;
+	c->go_back_ir_count = 0;
+	c->arrival_time = arrival_time;
+	c->go_back_fo_time = arrival_time;
+	c->go_back_ir_time = arrival_time;
+
+	c->num_sent_packets = 0;
+	c->wlsb_width = comp->wlsb_window_width;
+	c->wlsb_silence_nr = 0;
+#if ROHC_SMALL_CONTEXTS != 1
+	c->total_uncompressed_size = 0;
+	c->total_compressed_size = 0;
+	c->header_uncompressed_size = 0;
+	c->header_compressed_size = 0;
+
+	c->total_last_uncompressed_size = 0;
+	c->total_last_compressed_size = 0;
+	c->header_last_uncompressed_size = 0;
+	c->header_last_compressed_size = 0;
+
+	memset(c->state_packets_nr, 0, sizeof(unsigned long) * (ROHC_COMP_STATE_SO + 1));
+#endif
+
+	/* no CRC of IR header cached yet */
+	c->ir_crc_cache.len = 0;
+
+	c->cid = comp->cid_base + cid_to_use;
+	c->profile = profile;
+	c->key = c_ctxt_key(profile, packet);
+	c->flow = packet->flow;
+
+	c->mode = ROHC_U_MODE;
+	c->state = ROHC_COMP_STATE_IR;
+
+	c->compressor = comp;
+	c_ctxt_periodic_arm(c);
+
+	/* create profile-specific context, from the context of a recent flow
+	 * between the same hosts if possible */
+	src_ctxt = NULL;
+	if((comp->features & ROHC_COMP_FEATURE_CLONE_CTXTS) != 0 &&
+	   profile->clone != NULL)
+	{
+		src_ctxt = c_find_clone_src(comp, profile, packet);
+	}
+	if(src_ctxt != NULL && profile->clone(c, src_ctxt, packet))
+	{
+		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "context (CID = %zu) cloned from context (CID = %zu)",
+		           c->cid, src_ctxt->cid);
+	}
+	else if(!profile->create(c, packet))
+	{
+		/* give the CID back */
+		comp->free_cids[comp->free_cids_nr] = cid_to_use;
+		comp->free_cids_nr++;
+		return NULL;
+	}
+
+	/* if creation is successful, mark the context as used */
+	rohc_seqlock_write_begin(&comp->stats_seq);
+	c->used = 1;
+	c->first_used = arrival_time.sec;
+	c->latest_used = arrival_time.sec;
+	assert(comp->num_contexts_used <= comp->medium.max_cid);
+	comp->num_contexts_used++;
+	rohc_seqlock_write_end(&comp->stats_seq);
+	c_ctxt_index_add(comp, c);
+	c_ctxt_lru_add(comp, c);
+	c_ctxt_mem_add(comp, c);
+
+	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	           "context (CID = %zu) created (num_used = %zu)",
+	           c->cid, comp->num_contexts_used);
+	rohc_probe3(comp_ctxt_create, comp, c->cid, profile->id);
+	return c;
+}
+
+
+/**
+ * @brief Find the context to clone for a new flow
+ *
+ * Only the most recently used contexts are searched: the context to clone
+ * shall use the same profile and compress a flow between the same hosts.
+ *
+ * @param comp     The ROHC compressor
+ * @param profile  The profile of the new context
+ * @param packet   The packet to create the new context for
+ * @return         The context to clone, NULL if none was found
+ */
+static const struct rohc_comp_ctxt *
+	c_find_clone_src(const struct rohc_comp *const comp,
+	                 const struct rohc_comp_profile *const profile,
+	                 const struct net_pkt *const packet)
+{
+	const struct rohc_comp_ctxt *ctxt;
+	size_t searched_nr;
+
+	for(ctxt = comp->lru_head, searched_nr = 0;
+	    ctxt != NULL && searched_nr < ROHC_COMP_CLONE_SEARCH_NR;
+	    ctxt = ctxt->lru_next, searched_nr++)
+	{
+		if(ctxt->profile == profile &&
+		   net_pkt_flow_is_same_ip(&packet->flow, &ctxt->flow))
+		{
+			return ctxt;
+		}
+	}
+
+	return NULL;
+}
+
+
+/**
+ * @brief Find a compression context given an IP packet
+ *
+ * @param comp             The ROHC compressor
+ * @param packet           The packet to find a compression context for
+ * @param profile_id_hint  If positive, indicate the profile to use
+ * @param arrival_time     The time at which packet was received
+ *                         (0 if unknown, or to disable time-related features
+ *                          in the ROHC protocol)
+ * @return                 The context if found or successfully created,
+ *                         NULL if not found
+ */
+static struct rohc_comp_ctxt *
+	rohc_comp_find_ctxt(struct rohc_comp *const comp,
+	                    const struct net_pkt *const packet,
+	                    const int profile_id_hint,
+	                    const struct rohc_ts arrival_time)
+{
+	const struct rohc_comp_profile *profile;
+	struct rohc_comp_ctxt *context;
+	rohc_ctxt_key_t key;
+	size_t slot;
+
+	/* release the contexts that were not used for too long */
+	if(comp->ctxt_idle_timeout > 0)
+	{
+		c_ctxt_expire_idle(comp, arrival_time);
+	}
+
+	/* use the suggested profile if any, otherwise find the best profile for
+	 * the packet */
+	if(profile_id_hint < 0)
+	{
+		profile = c_get_profile_from_packet(comp, packet);
+	}
+	else
+	{
+		profile = rohc_get_profile_from_id(comp, profile_id_hint);
+	}
+	if(profile == NULL)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "no profile found for packet, giving up");
+		goto not_found;
+	}
+	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	           "using profile '%s' (0x%04x)",
+	           rohc_get_profile_descr(profile->id), profile->id);
+
+	/* get the context using help from the profile we just found: only the
+	 * contexts indexed with the same profile ID and key are candidates */
+	key = c_ctxt_key(profile, packet);
+	context = NULL;
+	for(slot = c_ctxt_index_hash(comp, profile->id, key);
+	    comp->contexts_index[slot] != 0;
+	    slot = (slot + 1) & comp->contexts_index_mask)
+	{
+		const size_t idx = comp->contexts_index[slot] - 1;
+		const struct rohc_comp_ctxt_hot *const hot = &comp->contexts_hot[idx];
+		struct rohc_comp_ctxt *candidate;
+
+		assert(hot->used);
+
+		/* don't look at contexts with the wrong profile or the wrong key */
+		if(hot->profile_id != profile->id || hot->key != key)
+		{
+			continue;
+		}
+		candidate = &comp->contexts[idx];
+		if(candidate->profile != profile)
+		{
+			/* another profile with the same ID, a registered one for example */
+			continue;
+		}
+
+		/* ask the profile whether the packet matches the context */
+		if(candidate->profile->check_context(candidate, packet))
+		{
+			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			           "using context CID = %zu", candidate->cid);
+			context = candidate;
+			break;
+		}
+	}
+	if(context == NULL && comp->cold_ctxts_nr > 0)
+	{
+		/* the flow may come back after its context went cold */
+		context = c_cold_revive(comp, profile, packet);
+	}
+	if(context == NULL)
+	{
+		/* context not found, create a new one */
+		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "no existing context found for packet, create a new one");
+		context = c_create_context(comp, profile, packet, ROHC_COMP_CID_NONE,
+		                           arrival_time);
+		if(context == NULL &&
+		   (comp->features & ROHC_COMP_FEATURE_NO_ALLOC) != 0 &&
+		   profile->id != ROHC_PROFILE_UNCOMPRESSED)
+		{
+			/* no prepared body left for the profile, the Uncompressed profile
+			 * allocates nothing: send the flow uncompressed for a while */
+			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			           "no memory for a new context without allocation, use "
+			           "the Uncompressed profile");
+			c_profile_failure_add(comp, packet, arrival_time);
+			return rohc_comp_find_ctxt(comp, packet, ROHC_PROFILE_UNCOMPRESSED,
+			                           arrival_time);
+		}
+		if(context == NULL)
+		{
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "failed to create a new context");
+			goto not_found;
+		}
+	}
+	else
+	{
+		/* matching context found, update use timestamp */
+		context->latest_used = arrival_time.sec;
+		context->arrival_time = arrival_time;
+		c_ctxt_lru_del(comp, context);
+		c_ctxt_lru_add(comp, context);
+	}
+
+	return context;
+
+not_found:
+	return NULL;
+}
+
+
+/**
+ * @brief Get the compression context of the given CID for an IP packet
+ *
+ * The CID was chosen by the application for the flow of the packet, so no
+ * context is searched for: the context with the given CID is used if it
+ * compresses the flow of the packet with the right profile, it is created
+ * otherwise (the context that used the CID before is then released).
+ *
+ * @param comp             The ROHC compressor
+ * @param packet           The packet to get a compression context for
+ * @param cid              The CID of the context
+ * @param profile_id_hint  If positive, indicate the profile to use
+ * @param arrival_time     The time at which packet was received
+ *                         (0 if unknown, or to disable time-related features
+ *                          in the ROHC protocol)
+ * @return                 The context if found or successfully created,
+ *                         NULL otherwise
+ */
+static struct rohc_comp_ctxt *
+	rohc_comp_get_steered_ctxt(struct rohc_comp *const comp,
+	                           const struct net_pkt *const packet,
+	                           const rohc_cid_t cid,
+	                           const int profile_id_hint,
+	                           const struct rohc_ts arrival_time)
+{
+	struct rohc_comp_ctxt *context;
+	const struct rohc_comp_profile *profile;
+
+	/* release the contexts that were not used for too long */
+	if(comp->ctxt_idle_timeout > 0)
+	{
+		c_ctxt_expire_idle(comp, arrival_time);
+	}
+
+	/* the context of the CID is used as long as it matches the packet */
+	context = c_get_context(comp, cid);
+	if(context != NULL &&
+	   (profile_id_hint < 0 ||
+	    context->profile->id == (rohc_profile_t) profile_id_hint) &&
+	   context->profile->check_context(context, packet))
+	{
+		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "using context CID = %zu given for packet", cid);
+		context->latest_used = arrival_time.sec;
+		context->arrival_time = arrival_time;
+		c_ctxt_lru_del(comp, context);
+		c_ctxt_lru_add(comp, context);
+		return context;
+	}
+
+	/* the flow is new on the CID: create a context with the best profile */
+	if(profile_id_hint < 0)
+	{
+		profile = c_get_profile_from_packet(comp, packet);
+	}
+	else
+	{
+		profile = rohc_get_profile_from_id(comp, profile_id_hint);
+	}
+	if(profile == NULL)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "no profile found for packet, giving up");
+		goto error;
+	}
+	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	           "create context CID = %zu given for packet with profile '%s' "
+	           "(0x%04x)", cid, rohc_get_profile_descr(profile->id),
+	           profile->id);
+	context = c_create_context(comp, profile, packet, cid, arrival_time);
+	if(context == NULL)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "failed to create a new context with CID %zu", cid);
+		goto error;
+	}
+
+	return context;
+
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Find out a context given its CID
+ *
+ * @param comp The ROHC compressor
+ * @param cid  The CID of the context to find
+ * @return     The context with the given CID if found, NULL otherwise
+ */
+static struct rohc_comp_ctxt *
+	c_get_context(struct rohc_comp *const comp, const rohc_cid_t cid)
+{
+	/* the CID must be in the range of the context array */
+	if(cid < comp->cid_base || (cid - comp->cid_base) > comp->medium.max_cid)
+	{
+		goto not_found;
+	}
+
+	/* the context with the given CID must be in use */
+	if(comp->contexts_hot[cid - comp->cid_base].used == 0)
+	{
+		goto not_found;
+	}
+
+	return &(comp->contexts[cid - comp->cid_base]);
+
+not_found:
+	return NULL;
+}
+
+
+/**
+ * @brief Release a compression context that is in use
+ *
+ * The profile-specific part of the context is destroyed, the context is
+ * removed from the index of contexts and from the LRU list, and its CID is
+ * made available again.
+ *
+ * @param comp     The ROHC compressor
+ * @param context  The compression context to release
+ */
+static void c_release_context(struct rohc_comp *const comp,
+                              struct rohc_comp_ctxt *const context)
+{
+	c_detach_context(comp, context);
+	context->profile->destroy(context);
+}
+
+
+/**
+ * @brief Detach a compression context that is in use from the compressor
+ *
+ * The context is removed from the index of contexts and from the LRU list,
+ * and its CID is made available again. The profile-specific part of the
+ * context is left untouched for the caller to destroy or move it.
+ *
+ * @param comp     The ROHC compressor
+ * @param context  The compression context to detach
+ */
+static void c_detach_context(struct rohc_comp *const comp,
+                             struct rohc_comp_ctxt *const context)
+{
+	assert(context->used);
+
+	c_ctxt_index_del(comp, context);
+	c_ctxt_lru_del(comp, context);
+	c_ctxt_mem_del(comp, context);
+	c_profile_cache_del(comp, context);
+	rohc_seqlock_write_begin(&comp->stats_seq);
+	context->used = 0;
+	assert(comp->num_contexts_used > 0);
+	comp->num_contexts_used--;
+	rohc_seqlock_write_end(&comp->stats_seq);
+
+	/* the CID may be used again for the next new context */
+	assert(comp->free_cids_nr <= comp->medium.max_cid);
+	comp->free_cids[comp->free_cids_nr] = context->cid - comp->cid_base;
+	comp->free_cids_nr++;
+}
+
+
+/**
+ * @brief Take the given CID out of the stack of free CIDs
+ *
+ * The cold context that holds the CID if any is dropped.
+ *
+ * @param comp     The ROHC compressor
+ * @param cid_idx  The index of the free CID in the array of contexts
+ */
+static void c_take_free_cid(struct rohc_comp *const comp,
+                            const rohc_cid_t cid_idx)
+{
+	size_t i;
+
+	/* the CID of a cold context is not in the stack: the cold context gives
+	 * its CID up */
+	if(comp->cold_ctxts != NULL && comp->cold_ctxts[cid_idx] != NULL)
+	{
+		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "drop cold context (CID = %zu) to re-use its CID",
+		           comp->cid_base + cid_idx);
+		c_cold_drop(comp, comp->cold_ctxts[cid_idx]);
+		return;
+	}
+
+	for(i = 0; i < comp->free_cids_nr && comp->free_cids[i] != cid_idx; i++)
+	{
+	}
+	assert(i < comp->free_cids_nr);
+	comp->free_cids_nr--;
+	comp->free_cids[i] = comp->free_cids[comp->free_cids_nr];
+}
+
+
+/**
+ * @brief Attach a compression context to the compressor
+ *
+ * The context shall be filled in the slot of its CID already, profile-specific
+ * part included, and its CID shall be taken already (see
+ * \ref c_take_free_cid). The context is added to the index of contexts and
+ * to the LRU list.
+ *
+ * @param comp     The ROHC compressor
+ * @param context  The compression context to attach
+ */
+static void c_attach_context(struct rohc_comp *const comp,
+                             struct rohc_comp_ctxt *const context)
+{
+	const rohc_cid_t cid_idx = context->cid - comp->cid_base;
+
+	assert(context == &comp->contexts[cid_idx]);
+
+	context->compressor = comp;
+	rohc_seqlock_write_begin(&comp->stats_seq);
+	context->used = 1;
+	assert(comp->num_contexts_used <= comp->medium.max_cid);
+	comp->num_contexts_used++;
+	rohc_seqlock_write_end(&comp->stats_seq);
+	c_ctxt_index_add(comp, context);
+	c_ctxt_lru_add(comp, context);
+	c_ctxt_mem_add(comp, context);
+}
+
+
+/**
+ * @brief Get the key of the context of the given packet for the given profile
+ *
+ * The key only hashes the fields that the profile compares to find the
+ * context of a packet, see \ref rohc_comp_key_type.
+ *
+ * @param profile  The profile of the packet
+ * @param packet   The packet to get the key of
+ * @return         The key of the context of the packet
+ */
+static rohc_ctxt_key_t c_ctxt_key(const struct rohc_comp_profile *const profile,
+                                  const struct net_pkt *const packet)
+{
+	switch(profile->key_type)
+	{
+		case ROHC_COMP_KEY_FLOW:
+			return packet->key;
+		case ROHC_COMP_KEY_IP:
+			return packet->ip_key;
+		case ROHC_COMP_KEY_HOSTS:
+		default:
+			return packet->hosts_key;
+	}
+}
+
+
+/**
+ * @brief Compute the slot of the context index for a profile ID and a key
+ *
+ * @param comp        The ROHC compressor
+ * @param profile_id  The profile ID of the context
+ * @param key         The key of the context
+ * @return            The first slot to probe in the context index
+ */
+static size_t c_ctxt_index_hash(const struct rohc_comp *const comp,
+                                const rohc_profile_t profile_id,
+                                const rohc_ctxt_key_t key)
+{
+	uint32_t hash = key ^ (((uint32_t) profile_id) * 0x9e3779b1U);
+
+	/* avalanche the bits so that close keys get spread over the index */
+	hash ^= hash >> 16;
+	hash *= 0x85ebca6bU;
+	hash ^= hash >> 13;
+	hash *= 0xc2b2ae35U;
+	hash ^= hash >> 16;
+
+	return (hash & comp->contexts_index_mask);
+}
+
+
+/**
+ * @brief Add a context in the index of contexts
+ *
+ * @param comp     The ROHC compressor
+ * @param context  The compression context to index
+ */
+static void c_ctxt_index_add(struct rohc_comp *const comp,
+                             const struct rohc_comp_ctxt *const context)
+{
+	const rohc_cid_t cid_idx = context->cid - comp->cid_base;
+	struct rohc_comp_ctxt_hot *const hot = &comp->contexts_hot[cid_idx];
+	size_t slot = c_ctxt_index_hash(comp, context->profile->id, context->key);
+
+	hot->key = context->key;
+	hot->profile_id = context->profile->id;
+	hot->used = 1;
+
+	/* the index is never full since it is twice as large as the number of
+	 * contexts */
+	while(comp->contexts_index[slot] != 0)
+	{
+		slot = (slot + 1) & comp->contexts_index_mask;
+	}
+	comp->contexts_index[slot] = cid_idx + 1;
+}
 
 
 /**
- * @brief Find out a ROHC profile given a profile ID
+ * @brief Remove a context from the index of contexts
  *
- * @param comp       The ROHC compressor
- * @param profile_id The ID of the ROHC profile to find out
- * @return           The ROHC profile if found, NULL otherwise
+ * The entries that follow the removed one in the same probe sequence are
+ * shifted backward, so that no tombstone is required.
+ *
+ * @param comp     The ROHC compressor
+ * @param context  The compression context to remove from the index
  */
-static const struct rohc_comp_profile *
-	rohc_get_profile_from_id(const struct rohc_comp *comp,
-	                         const rohc_profile_t profile_id)
+static void c_ctxt_index_del(struct rohc_comp *const comp,
+                             const struct rohc_comp_ctxt *const context)
 {
-	size_t i;
+	const size_t mask = comp->contexts_index_mask;
+	size_t hole = c_ctxt_index_hash(comp, context->profile->id, context->key);
+	size_t slot;
 
-	/* test all compression profiles */
-	for(i = 0; i < C_NUM_PROFILES; i++)
+	comp->contexts_hot[context->cid - comp->cid_base].used = 0;
+
+	/* find the slot of the context */
+	while(comp->contexts_index[hole] != (context->cid - comp->cid_base + 1))
 	{
-		/* if the profile IDs match and the profile is enabled */
-		if(rohc_comp_profiles[i]->id == profile_id && comp->enabled_profiles[i])
+		assert(comp->contexts_index[hole] != 0);
+		hole = (hole + 1) & mask;
+	}
+
+	/* free the slot, then move back the entries that cannot be found anymore
+	 * because of the new hole in their probe sequence */
+	comp->contexts_index[hole] = 0;
+	for(slot = (hole + 1) & mask;
+	    comp->contexts_index[slot] != 0;
+	    slot = (slot + 1) & mask)
+	{
+		const struct rohc_comp_ctxt_hot *const moved =
+			&comp->contexts_hot[comp->contexts_index[slot] - 1];
+		const size_t home =
+			c_ctxt_index_hash(comp, moved->profile_id, moved->key);
+
+		/* keep the entry in place if its home slot is cyclically located
+		 * in ]hole ; slot] */
+		if(((slot - home) & mask) < ((slot - hole) & mask))
 		{
-			return rohc_comp_profiles[i];
+			continue;
 		}
+
+		comp->contexts_index[hole] = comp->contexts_index[slot];
+		comp->contexts_index[slot] = 0;
+		hole = slot;
 	}
+}
 
-	return NULL;
+
+/**
+ * @brief Add a context at the head of the LRU list of contexts
+ *
+ * @param comp     The ROHC compressor
+ * @param context  The compression context that was just used
+ */
+static void c_ctxt_lru_add(struct rohc_comp *const comp,
+                           struct rohc_comp_ctxt *const context)
+{
+	context->lru_prev = NULL;
+	context->lru_next = comp->lru_head;
+	if(comp->lru_head != NULL)
+	{
+		comp->lru_head->lru_prev = context;
+	}
+	else
+	{
+		comp->lru_tail = context;
+	}
+	comp->lru_head = context;
 }
 
 
 /**
- * @brief Find out a ROHC profile given an IP protocol ID
+ * @brief Remove a context from the LRU list of contexts
  *
- * @param comp    The ROHC compressor
- * @param packet  The packet to find a compression profile for
- * @return        The ROHC profile if found, NULL otherwise
+ * @param comp     The ROHC compressor
+ * @param context  The compression context to remove from the LRU list
  */
-static const struct rohc_comp_profile *
-	c_get_profile_from_packet(const struct rohc_comp *const comp,
-	                          const struct net_pkt *const packet)
+static void c_ctxt_lru_del(struct rohc_comp *const comp,
+                           struct rohc_comp_ctxt *const context)
 {
-	size_t i;
+	if(context->lru_prev != NULL)
+	{
+		context->lru_prev->lru_next = context->lru_next;
+	}
+	else
+	{
+		assert(comp->lru_head == context);
+		comp->lru_head = context->lru_next;
+	}
+	if(context->lru_next != NULL)
+	{
+		context->lru_next->lru_prev = context->lru_prev;
+	}
+	else
+	{
+		assert(comp->lru_tail == context);
+		comp->lru_tail = context->lru_prev;
+	}
+	context->lru_prev = NULL;
+	context->lru_next = NULL;
+}
 
-	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-	           "try to find the best profile for packet with transport "
-	           "protocol %u", packet->transport->proto);
 
-	/* test all compression profiles */
-	for(i = 0; i < C_NUM_PROFILES; i++)
+/**
+ * @brief Release the contexts that were not used for too long
+ *
+ * The idle contexts are the least recently used ones, so they are released
+ * from the tail of the LRU list until one context was used recently enough.
+ * They are moved to the cold store if it is enabled.
+ *
+ * @param comp  The ROHC compressor
+ * @param now   The arrival time of the packet being compressed
+ */
+static void c_ctxt_expire_idle(struct rohc_comp *const comp,
+                               const struct rohc_ts now)
+{
+	while(comp->lru_tail != NULL &&
+	      (comp->lru_tail->latest_used + comp->ctxt_idle_timeout) <= now.sec)
 	{
-		bool check_profile;
+		struct rohc_comp_ctxt *const idle = comp->lru_tail;
 
-		/* skip profile if the profile is not enabled */
-		if(!comp->enabled_profiles[i])
+		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "release context (CID = %zu) unused for %zu seconds or more",
+		           idle->cid, comp->ctxt_idle_timeout);
+		rohc_probe3(comp_ctxt_recycle, comp, idle->cid, idle->profile->id);
+		if(comp->last_context == idle)
 		{
-			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			           "skip disabled profile '%s' (0x%04x)",
-			           rohc_get_profile_descr(rohc_comp_profiles[i]->id),
-			           rohc_comp_profiles[i]->id);
-			continue;
+			comp->last_context = NULL;
 		}
-
-		/* does the profile accept the packet? */
-		check_profile = rohc_comp_profiles[i]->check_profile(comp, packet);
-		if(!check_profile)
+		if(!c_cold_save(comp, idle))
 		{
-			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			           "skip profile '%s' (0x%04x) because it does not match "
-			           "packet",rohc_get_profile_descr(rohc_comp_profiles[i]->id),
-			           rohc_comp_profiles[i]->id);
-			continue;
+			c_release_context(comp, idle);
+			idle->key = 0; /* reset context key */
 		}
-
-		/* the packet is compatible with the profile, let's go with it! */
-		return rohc_comp_profiles[i];
 	}
-
-	return NULL;
 }
 
 
 /**
- * @brief Create a compression context
+ * @brief Move an idle context to the cold store
  *
- * @param comp          The ROHC compressor
- * @param profile       The profile to associate the context with
- * @param packet        The packet to create a compression context for
- * @param arrival_time  The time at which packet was received (0 if unknown,
- *                      or to disable time-related features in ROHC protocol)
- * @return              The compression context if successful, NULL otherwise
+ * The context is saved in the format of snapshots, then released. Its CID
+ * is not given back: the cold context keeps it, so that the context may be
+ * revived with the CID the decompressor knows it by.
+ *
+ * @param comp     The ROHC compressor
+ * @param context  The idle compression context
+ * @return         true if the context was moved to the cold store,
+ *                 false if it cannot be saved (it is left untouched)
  */
-static struct rohc_comp_ctxt *
-	c_create_context(struct rohc_comp *const comp,
-	                 const struct rohc_comp_profile *const profile,
-	                 const struct net_pkt *const packet,
-	                 const struct rohc_ts arrival_time)
+static bool c_cold_save(struct rohc_comp *const comp,
+                        struct rohc_comp_ctxt *const context)
 {
-	struct rohc_comp_ctxt *c;
-	rohc_cid_t cid_to_use;
-
-	assert(comp != NULL);
-	assert(profile != NULL);
-	assert(packet != NULL);
+	const rohc_cid_t cid_idx = context->cid - comp->cid_base;
+	struct rohc_comp_cold_ctxt *cold;
+	size_t slot;
 
-	cid_to_use = 0;
-
-	/* if all the contexts in the array are used:
-	 *   => recycle the oldest context to make room
-	 * if at least one context in the array is not used:
-	 *   => pick the first unused context
-	 */
-	if(comp->num_contexts_used > comp->medium.max_cid)
+	if((comp->features & ROHC_COMP_FEATURE_COLD_CTXTS) == 0 ||
+	   comp->cold_ctxts == NULL || context->profile->snapshot == NULL)
 	{
-		/* all the contexts in the array were used, recycle the oldest context
-		 * to make some room */
-
-		uint64_t oldest;
-		rohc_cid_t i;
-
-		/* find the oldest context */
-		oldest = 0xffffffff;
-		for(i = 0; i <= comp->medium.max_cid; i++)
-		{
-			if(comp->contexts[i].latest_used < oldest)
-			{
-				oldest = comp->contexts[i].latest_used;
-				cid_to_use = i;
-			}
-		}
+		goto error;
+	}
 
-		/* destroy the oldest context before replacing it with a new one */
-		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		           "recycle oldest context (CID = %zu)", cid_to_use);
-		comp->contexts[cid_to_use].profile->destroy(&comp->contexts[cid_to_use]);
-		comp->contexts[cid_to_use].key = 0; /* reset context key */
-		comp->contexts[cid_to_use].used = 0;
-		assert(comp->num_contexts_used > 0);
-		comp->num_contexts_used--;
+	/* save the context, then copy it in a cold context of the right size */
+	comp->cold_buf_len = 0;
+	if(!c_snapshot_ctxt(context, c_cold_write, comp))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, context->profile->id,
+		             "failed to save context with CID %zu in the cold store",
+		             context->cid);
+		goto error;
+	}
+	cold = malloc(sizeof(struct rohc_comp_cold_ctxt) + comp->cold_buf_len);
+	if(cold == NULL)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, context->profile->id,
+		             "no memory to move context with CID %zu in the cold store",
+		             context->cid);
+		goto error;
+	}
+	cold->key = context->key;
+	cold->profile_id = context->profile->id;
+	cold->cid_idx = cid_idx;
+	cold->len = comp->cold_buf_len;
+	memcpy(cold->record, comp->cold_buf, cold->len);
+
+	/* release the context, but take its CID back from the stack of free CIDs */
+	c_release_context(comp, context);
+	context->key = 0; /* reset context key */
+	assert(comp->free_cids_nr > 0);
+	assert(comp->free_cids[comp->free_cids_nr - 1] == cid_idx);
+	comp->free_cids_nr--;
+
+	/* index the cold context, and append it to the list of cold contexts */
+	slot = c_ctxt_index_hash(comp, cold->profile_id, cold->key);
+	cold->hash_next = comp->cold_index[slot];
+	comp->cold_index[slot] = cold;
+	cold->prev = comp->cold_newest;
+	cold->next = NULL;
+	if(comp->cold_newest != NULL)
+	{
+		comp->cold_newest->next = cold;
 	}
 	else
 	{
-		/* there was at least one unused context in the array, pick the first
-		 * unused context in the context array */
-
-		rohc_cid_t i;
+		comp->cold_oldest = cold;
+	}
+	comp->cold_newest = cold;
+	comp->cold_ctxts[cid_idx] = cold;
+	comp->cold_ctxts_nr++;
+	comp->contexts_mem[cold->profile_id].bytes +=
+		sizeof(struct rohc_comp_cold_ctxt) + cold->len;
 
-		/* find the first unused context */
-		for(i = 0; i <= comp->medium.max_cid; i++)
-		{
-			if(comp->contexts[i].used == 0)
-			{
-				cid_to_use = i;
-				break;
-			}
-		}
+	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	           "context (CID = %zu) moved to the cold store in %zu bytes "
+	           "(%zu cold contexts)", comp->cid_base + cid_idx, cold->len,
+	           comp->cold_ctxts_nr);
 
-		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		           "take the first unused context (CID = %zu)", cid_to_use);
-	}
+	return true;
 
-	/* initialize the previously found context */
-	c = &comp->contexts[cid_to_use];
+error:
+	return false;
+}
 
-	c->ir_count = 0;
-	c->fo_count = 0;
-	c->so_count = 0;
-	c->go_back_fo_count = 0;
-	c->go_back_ir_count = 0;
 
-	c->total_uncompressed_size = 0;
-	c->total_compressed_size = 0;
-	c->header_uncompressed_size = 0;
-	c->header_compressed_size = 0;
+/**
+ * @brief Revive the cold context of the flow of the given packet
+ *
+ * Only the cold contexts indexed with the same profile ID and key are
+ * candidates. The revived context takes its CID back with its mode and its
+ * state, as if it never left the array of contexts.
+ *
+ * @param comp     The ROHC compressor
+ * @param profile  The profile of the packet
+ * @param packet   The packet to find a cold context for
+ * @return         The revived context, NULL if no cold context matches
+ */
+static struct rohc_comp_ctxt *
+	c_cold_revive(struct rohc_comp *const comp,
+	              const struct rohc_comp_profile *const profile,
+	              const struct net_pkt *const packet)
+{
+	const rohc_ctxt_key_t key = c_ctxt_key(profile, packet);
+	const size_t slot = c_ctxt_index_hash(comp, profile->id, key);
+	struct rohc_comp_cold_ctxt *cold;
 
-	c->total_last_uncompressed_size = 0;
-	c->total_last_compressed_size = 0;
-	c->header_last_uncompressed_size = 0;
-	c->header_last_compressed_size = 0;
+	for(cold = comp->cold_index[slot]; cold != NULL; cold = cold->hash_next)
+	{
+		struct rohc_comp_snapshot_ctxt record;
+		struct rohc_comp_ctxt *context;
+		struct c_cold_cursor cursor;
 
-	c->num_sent_packets = 0;
+		if(cold->profile_id != profile->id || cold->key != key)
+		{
+			continue;
+		}
 
-	c->cid = cid_to_use;
-	c->profile = profile;
-	c->key = packet->key;
+		/* re-build the context in the slot of its CID */
+		cursor.cold = cold;
+		cursor.pos = 0;
+		context = NULL;
+		if(c_cold_read(&cursor, (uint8_t *) &record,
+		               sizeof(struct rohc_comp_snapshot_ctxt)))
+		{
+			context = c_restore_ctxt(comp, profile, &record, c_cold_read, &cursor);
+		}
+		if(context == NULL)
+		{
+			/* the compressor changed since the context went cold, eg. the
+			 * width of the W-LSB windows: give the CID up */
+			const rohc_cid_t cid_idx = cold->cid_idx;
+
+			rohc_warning(comp, ROHC_TRACE_COMP, profile->id, "failed to "
+			             "revive the cold context with CID %zu, drop it",
+			             comp->cid_base + cid_idx);
+			c_cold_drop(comp, cold);
+			comp->free_cids[comp->free_cids_nr] = cid_idx;
+			comp->free_cids_nr++;
+			break;
+		}
 
-	c->mode = ROHC_U_MODE;
-	c->state = ROHC_COMP_STATE_IR;
+		/* ask the profile whether the packet matches the context */
+		if(!profile->check_context(context, packet))
+		{
+			profile->destroy(context);
+			continue;
+		}
 
-	c->compressor = comp;
+		/* the context takes the CID of the cold context */
+		c_cold_drop(comp, cold);
+		c_attach_context(comp, context);
+		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "context (CID = %zu) revived from the cold store in state "
+		           "%s", context->cid, rohc_comp_get_state_descr(context->state));
 
-	/* create profile-specific context */
-	if(!profile->create(c, packet))
-	{
-		return NULL;
+		return context;
 	}
 
-	/* if creation is successful, mark the context as used */
-	c->used = 1;
-	c->first_used = arrival_time.sec;
-	c->latest_used = arrival_time.sec;
-	assert(comp->num_contexts_used <= comp->medium.max_cid);
-	comp->num_contexts_used++;
-
-	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-	           "context (CID = %zu) created (num_used = %zu)",
-	           c->cid, comp->num_contexts_used);
-	return c;
+	return NULL;
 }
 
 
 /**
- * @brief Find a compression context given an IP packet
+ * @brief Remove one context from the cold store and destroy it
  *
- * @param comp             The ROHC compressor
- * @param packet           The packet to find a compression context for
- * @param profile_id_hint  If positive, indicate the profile to use
- * @param arrival_time     The time at which packet was received
- *                         (0 if unknown, or to disable time-related features
- *                          in the ROHC protocol)
- * @return                 The context if found or successfully created,
- *                         NULL if not found
+ * The CID of the cold context is given to the caller.
+ *
+ * @param comp  The ROHC compressor
+ * @param cold  The cold context to drop
  */
-static struct rohc_comp_ctxt *
-	rohc_comp_find_ctxt(struct rohc_comp *const comp,
-	                    const struct net_pkt *const packet,
-	                    const int profile_id_hint,
-	                    const struct rohc_ts arrival_time)
+static void c_cold_drop(struct rohc_comp *const comp,
+                        struct rohc_comp_cold_ctxt *const cold)
 {
-	const struct rohc_comp_profile *profile;
-	struct rohc_comp_ctxt *context;
-	size_t num_used_ctxt_seen = 0;
-	rohc_cid_t i;
+	struct rohc_comp_cold_ctxt **link =
+		&comp->cold_index[c_ctxt_index_hash(comp, cold->profile_id, cold->key)];
 
-	/* use the suggested profile if any, otherwise find the best profile for
-	 * the packet */
-	if(profile_id_hint < 0)
+	/* remove the cold context from its chain in the index */
+	while((*link) != cold)
 	{
-		profile = c_get_profile_from_packet(comp, packet);
+		assert((*link) != NULL);
+		link = &((*link)->hash_next);
+	}
+	*link = cold->hash_next;
+
+	/* remove the cold context from the list of cold contexts */
+	if(cold->prev != NULL)
+	{
+		cold->prev->next = cold->next;
 	}
 	else
 	{
-		profile = rohc_get_profile_from_id(comp, profile_id_hint);
+		assert(comp->cold_oldest == cold);
+		comp->cold_oldest = cold->next;
 	}
-	if(profile == NULL)
+	if(cold->next != NULL)
 	{
-		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "no profile found for packet, giving up");
-		goto not_found;
+		cold->next->prev = cold->prev;
+	}
+	else
+	{
+		assert(comp->cold_newest == cold);
+		comp->cold_newest = cold->prev;
 	}
-	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-	           "using profile '%s' (0x%04x)",
-	           rohc_get_profile_descr(profile->id), profile->id);
 
-	/* get the context using help from the profile we just found */
-	for(i = 0; i <= comp->medium.max_cid; i++)
+	assert(comp->cold_ctxts[cold->cid_idx] == cold);
+	comp->cold_ctxts[cold->cid_idx] = NULL;
+	assert(comp->cold_ctxts_nr > 0);
+	comp->cold_ctxts_nr--;
+	assert(comp->contexts_mem[cold->profile_id].bytes >=
+	       (sizeof(struct rohc_comp_cold_ctxt) + cold->len));
+	comp->contexts_mem[cold->profile_id].bytes -=
+		sizeof(struct rohc_comp_cold_ctxt) + cold->len;
+	free(cold);
+}
+
+
+/**
+ * @brief Drop all the contexts of the cold store
+ *
+ * Their CIDs are made available again.
+ *
+ * @param comp  The ROHC compressor
+ */
+static void c_cold_flush(struct rohc_comp *const comp)
+{
+	while(comp->cold_oldest != NULL)
 	{
-		context = &comp->contexts[i];
+		const rohc_cid_t cid_idx = comp->cold_oldest->cid_idx;
 
-		/* don't even look at unused contexts */
-		if(!context->used)
-		{
-			continue;
-		}
-		num_used_ctxt_seen++;
+		c_cold_drop(comp, comp->cold_oldest);
+		assert(comp->free_cids_nr <= comp->medium.max_cid);
+		comp->free_cids[comp->free_cids_nr] = cid_idx;
+		comp->free_cids_nr++;
+	}
+}
 
-		/* don't look at contexts with the wrong profile */
-		if(context->profile->id != profile->id)
-		{
-			continue;
-		}
 
-		/* don't look at contexts with the wrong key */
-		if(packet->key != context->key)
-		{
-			continue;
-		}
+/**
+ * @brief Append bytes to the idle context being saved for the cold store
+ *
+ * The buffer is enlarged if it is too small.
+ *
+ * @param priv  The ROHC compressor
+ * @param data  The bytes to append
+ * @param len   The number of bytes to append
+ * @return      true if the bytes were appended,
+ *              false if the buffer failed to be enlarged
+ */
+static bool c_cold_write(void *const priv,
+                         const uint8_t *const data,
+                         const size_t len)
+{
+	struct rohc_comp *const comp = priv;
 
-		/* ask the profile whether the packet matches the context */
-		if(context->profile->check_context(context, packet))
-		{
-			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			           "using context CID = %zu", context->cid);
-			break;
-		}
+	if((comp->cold_buf_len + len) > comp->cold_buf_max_len)
+	{
+		size_t new_max_len = comp->cold_buf_max_len * 2;
+		uint8_t *new_buf;
 
-		/* if all used contexts were checked, no need go search further */
-		if(num_used_ctxt_seen >= comp->num_contexts_used)
+		while((comp->cold_buf_len + len) > new_max_len)
 		{
-			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			           "no context was found");
-			context = NULL;
-			break;
+			new_max_len *= 2;
 		}
-	}
-	if(context == NULL || i > comp->medium.max_cid)
-	{
-		/* context not found, create a new one */
-		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		           "no existing context found for packet, create a new one");
-		context = c_create_context(comp, profile, packet, arrival_time);
-		if(context == NULL)
+		new_buf = malloc(new_max_len);
+		if(new_buf == NULL)
 		{
-			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			             "failed to create a new context");
-			goto not_found;
+			return false;
 		}
+		memcpy(new_buf, comp->cold_buf, comp->cold_buf_len);
+		free(comp->cold_buf);
+		comp->cold_buf = new_buf;
+		comp->cold_buf_max_len = new_max_len;
 	}
-	else
+	memcpy(comp->cold_buf + comp->cold_buf_len, data, len);
+	comp->cold_buf_len += len;
+
+	return true;
+}
+
+
+/**
+ * @brief Read the next bytes of the cold context being revived
+ *
+ * @param priv  The cursor on the cold context
+ * @param data  OUT: The bytes read
+ * @param len   The number of bytes to read
+ * @return      true if the bytes were read,
+ *              false if the cold context is too short
+ */
+static bool c_cold_read(void *const priv,
+                        uint8_t *const data,
+                        const size_t len)
+{
+	struct c_cold_cursor *const cursor = priv;
+
+	if(len > (cursor->cold->len - cursor->pos))
 	{
-		/* matching context found, update use timestamp */
-		context->latest_used = arrival_time.sec;
+		return false;
 	}
+	memcpy(data, cursor->cold->record + cursor->pos, len);
+	cursor->pos += len;
 
-	return context;
+	return true;
+}
 
-not_found:
-	return NULL;
+
+/**
+ * @brief Save one compression context in a snapshot or in the cold store
+ *
+ * @param context   The compression context to save
+ * @param write_cb  The callback used to write the record
+ * @param priv      The private context given to the callback
+ * @return          true if the context was successfully saved,
+ *                  false if the callback failed
+ */
+static bool c_snapshot_ctxt(const struct rohc_comp_ctxt *const context,
+                            const rohc_snapshot_write_t write_cb,
+                            void *const priv)
+{
+	struct rohc_comp_snapshot_ctxt record;
+	size_t go_back_fo_count;
+	size_t go_back_ir_count;
+
+	assert(context->profile->snapshot != NULL);
+
+	memset(&record, 0, sizeof(struct rohc_comp_snapshot_ctxt));
+	record.profile_id = context->profile->id;
+	record.cid = context->cid;
+	record.mode = context->mode;
+	record.state = context->state;
+	record.key = context->key;
+	record.ir_count = context->ir_count;
+	record.fo_count = context->fo_count;
+	record.so_count = context->so_count;
+	c_ctxt_periodic_counts(context, &go_back_fo_count, &go_back_ir_count);
+	record.go_back_fo_count = go_back_fo_count;
+	record.go_back_ir_count = go_back_ir_count;
+	record.num_sent_packets = context->num_sent_packets;
+	record.first_used = context->first_used;
+	record.latest_used = context->latest_used;
+
+	return (write_cb(priv, (uint8_t *) &record,
+	                 sizeof(struct rohc_comp_snapshot_ctxt)) &&
+	        context->profile->snapshot(context, write_cb, priv));
 }
 
 
 /**
- * @brief Find out a context given its CID
+ * @brief Restore one compression context from a snapshot or the cold store
  *
- * @param comp The ROHC compressor
- * @param cid  The CID of the context to find
- * @return     The context with the given CID if found, NULL otherwise
+ * The context is re-built in the slot of its CID, but it is not attached to
+ * the compressor (see \ref c_attach_context).
+ *
+ * @param comp     The ROHC compressor
+ * @param profile  The profile of the context, enabled and able to restore
+ * @param record   The generic part of the context, already read
+ * @param read_cb  The callback used to read the profile-specific part
+ * @param priv     The private context given to the callback
+ * @return         The restored context if successful,
+ *                 NULL if the callback failed or if the profile-specific
+ *                 part does not match the compressor
  */
 static struct rohc_comp_ctxt *
-	c_get_context(struct rohc_comp *const comp, const rohc_cid_t cid)
+	c_restore_ctxt(struct rohc_comp *const comp,
+	               const struct rohc_comp_profile *const profile,
+	               const struct rohc_comp_snapshot_ctxt *const record,
+	               const rohc_snapshot_read_t read_cb,
+	               void *const priv)
 {
-	/* the CID must not be larger than the context array */
-	if(cid > comp->medium.max_cid)
+	struct rohc_comp_ctxt *const context =
+		&comp->contexts[record->cid - comp->cid_base];
+
+	assert(record->cid >= comp->cid_base);
+	assert((record->cid - comp->cid_base) <= comp->medium.max_cid);
+	assert(!comp->contexts_hot[record->cid - comp->cid_base].used);
+
+	memset(context, 0, sizeof(struct rohc_comp_ctxt));
+	context->profile = profile;
+	context->key = record->key;
+	context->compressor = comp;
+	context->cid = record->cid;
+	context->mode = record->mode;
+	context->state = record->state;
+	context->ir_count = record->ir_count;
+	context->fo_count = record->fo_count;
+	context->so_count = record->so_count;
+	context->go_back_fo_count = record->go_back_fo_count;
+	context->go_back_ir_count = record->go_back_ir_count;
+	c_ctxt_periodic_arm(context);
+	context->num_sent_packets = record->num_sent_packets;
+	context->first_used = record->first_used;
+	context->latest_used = record->latest_used;
+	if(!profile->restore(context, read_cb, priv))
 	{
-		goto not_found;
+		goto error;
 	}
 
-	/* the context with the given CID must be in use */
-	if(comp->contexts[cid].used == 0)
+	/* the W-LSB windows restart with their full width */
+	context->wlsb_width = comp->wlsb_window_width;
+	if(profile->set_wlsb_width != NULL)
 	{
-		goto not_found;
+		profile->set_wlsb_width(context, context->wlsb_width);
 	}
 
-	return &(comp->contexts[cid]);
+	return context;
 
-not_found:
+error:
 	return NULL;
 }
 
 
+/**
+ * @brief Account for the memory used by one new compression context
+ *
+ * @param comp     The ROHC compressor
+ * @param context  The new compression context
+ */
+static void c_ctxt_mem_add(struct rohc_comp *const comp,
+                           struct rohc_comp_ctxt *const context)
+{
+	struct rohc_ctxt_mem *const mem = &comp->contexts_mem[context->profile->id];
+
+	context->mem.bytes = 0;
+	context->mem.wlsb_bytes = 0;
+	context->mem.lists_bytes = 0;
+	if(context->profile->get_mem != NULL)
+	{
+		context->profile->get_mem(context, &context->mem);
+	}
+
+	mem->bytes += context->mem.bytes;
+	mem->wlsb_bytes += context->mem.wlsb_bytes;
+	mem->lists_bytes += context->mem.lists_bytes;
+}
+
+
+/**
+ * @brief Stop accounting for the memory used by one compression context
+ *
+ * @param comp     The ROHC compressor
+ * @param context  The compression context being released
+ */
+static void c_ctxt_mem_del(struct rohc_comp *const comp,
+                           const struct rohc_comp_ctxt *const context)
+{
+	struct rohc_ctxt_mem *const mem = &comp->contexts_mem[context->profile->id];
+
+	assert(mem->bytes >= context->mem.bytes);
+	mem->bytes -= context->mem.bytes;
+	mem->wlsb_bytes -= context->mem.wlsb_bytes;
+	mem->lists_bytes -= context->mem.lists_bytes;
+}
+
+
 /**
  * @brief Create the array of compression contexts
  *
@@ -2518,6 +8675,9 @@ not_found:
  */
 static bool c_create_contexts(struct rohc_comp *const comp)
 {
+	size_t index_len;
+	rohc_cid_t i;
+
 	assert(comp->contexts == NULL);
 
 	comp->num_contexts_used = 0;
@@ -2526,17 +8686,93 @@ static bool c_create_contexts(struct rohc_comp *const comp)
 	          "create enough room for %zu contexts (MAX_CID = %zu)",
 	          comp->medium.max_cid + 1, comp->medium.max_cid);
 
-	comp->contexts = calloc(comp->medium.max_cid + 1,
-	                        sizeof(struct rohc_comp_ctxt));
+	comp->contexts = rohc_alloc_calloc_node(comp->medium.max_cid + 1,
+	                                        sizeof(struct rohc_comp_ctxt),
+	                                        comp->numa_node);
 	if(comp->contexts == NULL)
 	{
 		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 		           "cannot allocate memory for contexts");
 		goto error;
 	}
+	comp->contexts_hot =
+		rohc_alloc_calloc_node(comp->medium.max_cid + 1,
+		                       sizeof(struct rohc_comp_ctxt_hot),
+		                       comp->numa_node);
+	if(comp->contexts_hot == NULL)
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "cannot allocate memory for the lookup fields of contexts");
+		goto free_contexts;
+	}
+
+	/* the hash index of contexts is kept at most half full, so that
+	 * linear probing stays short */
+	index_len = 2;
+	while(index_len < ((comp->medium.max_cid + 1) * 2))
+	{
+		index_len *= 2;
+	}
+	comp->contexts_index =
+		rohc_alloc_calloc_node(index_len, sizeof(uint16_t), comp->numa_node);
+	if(comp->contexts_index == NULL)
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "cannot allocate memory for the index of contexts");
+		goto free_hot;
+	}
+	comp->contexts_index_mask = index_len - 1;
+	comp->profile_cache =
+		rohc_alloc_calloc_node(index_len,
+		                       sizeof(struct rohc_comp_profile_cache_entry),
+		                       comp->numa_node);
+	if(comp->profile_cache == NULL)
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "cannot allocate memory for the cache of profiles");
+		goto free_index;
+	}
+
+	/* all CIDs are free at startup, the smallest ones are used first */
+	comp->free_cids = rohc_alloc_calloc_node(comp->medium.max_cid + 1,
+	                                         sizeof(uint16_t), comp->numa_node);
+	if(comp->free_cids == NULL)
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "cannot allocate memory for the stack of free CIDs");
+		goto free_profile_cache;
+	}
+	for(i = 0; i <= comp->medium.max_cid; i++)
+	{
+		comp->free_cids[i] = comp->medium.max_cid - i;
+	}
+	comp->free_cids_nr = comp->medium.max_cid + 1;
+	comp->lru_head = NULL;
+	comp->lru_tail = NULL;
+
+	/* no context to re-initialize at startup */
+	comp->reinit_cids = rohc_alloc_calloc_node(comp->medium.max_cid + 1,
+	                                           sizeof(uint16_t), comp->numa_node);
+	if(comp->reinit_cids == NULL)
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "cannot allocate memory for the stack of CIDs to re-initialize");
+		goto free_free_cids;
+	}
+	comp->reinit_left_nr = 0;
 
 	return true;
 
+free_free_cids:
+	zfree(comp->free_cids);
+free_profile_cache:
+	zfree(comp->profile_cache);
+free_index:
+	zfree(comp->contexts_index);
+free_hot:
+	zfree(comp->contexts_hot);
+free_contexts:
+	zfree(comp->contexts);
 error:
 	return false;
 }
@@ -2551,26 +8787,46 @@ error:
  */
 static void c_destroy_contexts(struct rohc_comp *const comp)
 {
-	rohc_cid_t i;
+	struct rohc_comp_ctxt *context;
 
 	assert(comp->contexts != NULL);
 
-	for(i = 0; i <= comp->medium.max_cid; i++)
+	/* the cold contexts hold no profile-specific part */
+	c_cold_flush(comp);
+	free(comp->cold_buf);
+	comp->cold_buf = NULL;
+	free(comp->cold_index);
+	comp->cold_index = NULL;
+	free(comp->cold_ctxts);
+	comp->cold_ctxts = NULL;
+
+	/* the contexts in use are all in the LRU list */
+	for(context = comp->lru_head; context != NULL; context = context->lru_next)
 	{
-		if(comp->contexts[i].used && comp->contexts[i].profile != NULL)
-		{
-			comp->contexts[i].profile->destroy(&comp->contexts[i]);
-		}
-
-		if(comp->contexts[i].used)
-		{
-			comp->contexts[i].used = 0;
-			assert(comp->num_contexts_used > 0);
-			comp->num_contexts_used--;
-		}
+		assert(context->used);
+		c_ctxt_mem_del(comp, context);
+		context->profile->destroy(context);
+		context->used = 0;
+		comp->contexts_hot[context->cid - comp->cid_base].used = 0;
+		assert(comp->num_contexts_used > 0);
+		comp->num_contexts_used--;
 	}
 	assert(comp->num_contexts_used == 0);
 
+	comp->lru_head = NULL;
+	comp->lru_tail = NULL;
+	free(comp->reinit_cids);
+	comp->reinit_cids = NULL;
+	comp->reinit_left_nr = 0;
+	free(comp->free_cids);
+	comp->free_cids = NULL;
+	comp->free_cids_nr = 0;
+	free(comp->profile_cache);
+	comp->profile_cache = NULL;
+	free(comp->contexts_index);
+	comp->contexts_index = NULL;
+	free(comp->contexts_hot);
+	comp->contexts_hot = NULL;
 	free(comp->contexts);
 	comp->contexts = NULL;
 }
@@ -2606,6 +8862,12 @@ void rohc_comp_change_mode(struct rohc_comp_ctxt *const context,
 		rohc_info(context->compressor, ROHC_TRACE_COMP, context->profile->id,
 		          "CID %zu: change from mode %d to mode %d",
 		          context->cid, context->mode, new_mode);
+		rohc_trace_ring_add(&context->compressor->trace_ring,
+		                    ROHC_TRACE_EVENT_COMP_MODE, context->cid,
+		                    context->profile->id, context->packet_type,
+		                    context->num_sent_packets, context->mode, new_mode, 0);
+		rohc_probe4(comp_mode_change, context->compressor, context->cid,
+		            context->mode, new_mode);
 		context->mode = new_mode;
 		rohc_comp_change_state(context, ROHC_COMP_STATE_IR);
 	}
@@ -2626,26 +8888,82 @@ void rohc_comp_change_state(struct rohc_comp_ctxt *const context,
 		rohc_info(context->compressor, ROHC_TRACE_COMP, context->profile->id,
 		          "CID %zu: change from state %d to state %d",
 		          context->cid, context->state, new_state);
+		rohc_trace_ring_add(&context->compressor->trace_ring,
+		                    ROHC_TRACE_EVENT_COMP_STATE, context->cid,
+		                    context->profile->id, context->packet_type,
+		                    context->num_sent_packets, context->state, new_state,
+		                    0);
+		rohc_probe4(comp_state_change, context->compressor, context->cid,
+		            context->state, new_state);
+
+		/* the packets counted down for the periodic refreshes were sent in
+		 * the previous state */
+		c_ctxt_periodic_sync(context);
 
 		/* reset counters */
 		context->ir_count = 0;
 		context->fo_count = 0;
 		context->so_count = 0;
 
+		/* restart the timers of the time-based periodic refreshes */
+		if(new_state == ROHC_COMP_STATE_IR)
+		{
+			context->go_back_ir_time = context->arrival_time;
+			context->go_back_fo_time = context->arrival_time;
+		}
+		else if(new_state == ROHC_COMP_STATE_FO)
+		{
+			context->go_back_fo_time = context->arrival_time;
+		}
+
 		/* change state */
 		context->state = new_state;
+		c_ctxt_periodic_arm(context);
 	}
 }
 
 
 /**
  * @brief Periodically change the context state after a certain number
- *        of packets.
+ *        of packets or a certain time.
+ *
+ * The packet-based refreshes are due at a packet that is known in advance
+ * as long as the state of the context does not change: most packets only
+ * count down to that packet, the counters are compared to the timeouts
+ * when the countdown ends or when the time-based refreshes are enabled.
  *
  * @param context The compression context
  */
 void rohc_comp_periodic_down_transition(struct rohc_comp_ctxt *const context)
 {
+	const struct rohc_comp *const comp = context->compressor;
+	bool fo_time_elapsed = false;
+	bool ir_time_elapsed = false;
+
+	/* no periodic refresh for this packet */
+	if(context->go_back_countdown > 1)
+	{
+		context->go_back_countdown--;
+		return;
+	}
+	c_ctxt_periodic_sync(context);
+
+	/* time-based periodic refreshes, if enabled and if the arrival times of
+	 * the packets are known */
+	if(comp->periodic_refreshes_ir_time > 0 && context->arrival_time.sec != 0)
+	{
+		const uint64_t ir_elapsed =
+			rohc_time_interval(context->go_back_ir_time, context->arrival_time);
+		const uint64_t fo_elapsed =
+			rohc_time_interval(context->go_back_fo_time, context->arrival_time);
+
+		ir_time_elapsed = (context->state != ROHC_COMP_STATE_IR &&
+		                   ir_elapsed >= comp->periodic_refreshes_ir_time * 1000U);
+		fo_time_elapsed = (context->state == ROHC_COMP_STATE_SO &&
+		                   comp->periodic_refreshes_fo_time > 0 &&
+		                   fo_elapsed >= comp->periodic_refreshes_fo_time * 1000U);
+	}
+
 	rohc_debug(context->compressor, ROHC_TRACE_COMP, context->profile->id,
 	           "CID %zu: timeouts for periodic refreshes: FO = %zu / %zu, "
 	           "IR = %zu / %zu", context->cid, context->go_back_fo_count,
@@ -2654,7 +8972,7 @@ void rohc_comp_periodic_down_transition(struct rohc_comp_ctxt *const context)
 	           context->compressor->periodic_refreshes_ir_timeout);
 
 	if(context->go_back_fo_count >=
-	   context->compressor->periodic_refreshes_fo_timeout)
+	   context->compressor->periodic_refreshes_fo_timeout || fo_time_elapsed)
 	{
 		rohc_info(context->compressor, ROHC_TRACE_COMP, context->profile->id,
 		          "CID %zu: periodic change to FO state", context->cid);
@@ -2662,7 +8980,7 @@ void rohc_comp_periodic_down_transition(struct rohc_comp_ctxt *const context)
 		rohc_comp_change_state(context, ROHC_COMP_STATE_FO);
 	}
 	else if(context->go_back_ir_count >=
-	        context->compressor->periodic_refreshes_ir_timeout)
+	        context->compressor->periodic_refreshes_ir_timeout || ir_time_elapsed)
 	{
 		rohc_info(context->compressor, ROHC_TRACE_COMP, context->profile->id,
 		          "CID %zu: periodic change to IR state", context->cid);
@@ -2679,6 +8997,157 @@ void rohc_comp_periodic_down_transition(struct rohc_comp_ctxt *const context)
 	{
 		context->go_back_ir_count++;
 	}
+	c_ctxt_periodic_arm(context);
+}
+
+
+/**
+ * @brief Get the counters of the periodic refreshes of the given context
+ *
+ * The counters include the packets counted down since the countdown was
+ * armed, they were all sent in the current state of the context.
+ *
+ * @param context                The compression context
+ * @param[out] go_back_fo_count  The number of packets sent in SO state
+ * @param[out] go_back_ir_count  The number of packets sent in FO or SO state
+ */
+static void c_ctxt_periodic_counts(const struct rohc_comp_ctxt *const context,
+                                   size_t *const go_back_fo_count,
+                                   size_t *const go_back_ir_count)
+{
+	const size_t counted_down =
+		context->go_back_countdown_init - context->go_back_countdown;
+
+	*go_back_fo_count = context->go_back_fo_count;
+	*go_back_ir_count = context->go_back_ir_count;
+	if(context->state == ROHC_COMP_STATE_SO)
+	{
+		*go_back_fo_count += counted_down;
+	}
+	if(context->state == ROHC_COMP_STATE_SO ||
+	   context->state == ROHC_COMP_STATE_FO)
+	{
+		*go_back_ir_count += counted_down;
+	}
+}
+
+
+/**
+ * @brief Add the packets counted down to the counters of the periodic
+ *        refreshes of the given context
+ *
+ * @param context  The compression context
+ */
+static void c_ctxt_periodic_sync(struct rohc_comp_ctxt *const context)
+{
+	c_ctxt_periodic_counts(context, &context->go_back_fo_count,
+	                       &context->go_back_ir_count);
+	context->go_back_countdown_init = context->go_back_countdown;
+}
+
+
+/**
+ * @brief Count down to the next periodic refresh of the given context
+ *
+ * The countdown ends at the first packet that shall compare the counters to
+ * the timeouts if the context stays in its current state: at the next
+ * packet if the time-based refreshes are enabled, never if the context is
+ * in IR state and no timeout is reached yet.
+ *
+ * @param context  The compression context, synchronized with
+ *                 \ref c_ctxt_periodic_sync
+ */
+static void c_ctxt_periodic_arm(struct rohc_comp_ctxt *const context)
+{
+	const struct rohc_comp *const comp = context->compressor;
+	const size_t fo_timeout = comp->periodic_refreshes_fo_timeout;
+	const size_t ir_timeout = comp->periodic_refreshes_ir_timeout;
+	size_t countdown = SIZE_MAX;
+
+	if(comp->periodic_refreshes_ir_time > 0 ||
+	   context->go_back_fo_count >= fo_timeout ||
+	   context->go_back_ir_count >= ir_timeout)
+	{
+		countdown = 1;
+	}
+	else
+	{
+		/* the counters grow by one with every packet sent in the states
+		 * they count */
+		if(context->state == ROHC_COMP_STATE_SO)
+		{
+			countdown = fo_timeout - context->go_back_fo_count + 1;
+		}
+		if(context->state == ROHC_COMP_STATE_SO ||
+		   context->state == ROHC_COMP_STATE_FO)
+		{
+			countdown = rohc_min(countdown,
+			                     ir_timeout - context->go_back_ir_count + 1);
+		}
+	}
+	context->go_back_countdown = countdown;
+	context->go_back_countdown_init = countdown;
+}
+
+
+/**
+ * @brief Adapt the W-LSB windows of the given context to one feedback
+ *
+ * Used if the \ref ROHC_COMP_FEATURE_ADAPTIVE_WLSB feature is enabled: a
+ * positive ACK in O-mode or R-mode shows that the packets of the context are
+ * reliably delivered, so the windows are halved down to
+ * \ref ROHC_COMP_WLSB_MIN_WIDTH entries. A NACK or a STATIC-NACK shows that
+ * packets are lost, so the windows get back their full width at once.
+ *
+ * @param context  The compression context that received the feedback
+ * @param is_ack   true for a positive ACK, false for a NACK or a STATIC-NACK
+ */
+void rohc_comp_wlsb_feedback(struct rohc_comp_ctxt *const context,
+                             const bool is_ack)
+{
+	const struct rohc_comp *const comp = context->compressor;
+
+	if((comp->features & ROHC_COMP_FEATURE_ADAPTIVE_WLSB) == 0 ||
+	   context->profile->set_wlsb_width == NULL)
+	{
+		return;
+	}
+
+	if(!is_ack)
+	{
+		c_ctxt_set_wlsb_width(context, comp->wlsb_window_width);
+	}
+	else if(context->mode != ROHC_U_MODE)
+	{
+		size_t width = context->wlsb_width / 2;
+
+		if(width < ROHC_COMP_WLSB_MIN_WIDTH)
+		{
+			width = rohc_min(context->wlsb_width, ROHC_COMP_WLSB_MIN_WIDTH);
+		}
+		c_ctxt_set_wlsb_width(context, width);
+	}
+}
+
+
+/**
+ * @brief Change the number of entries that the W-LSB windows of the given
+ *        context keep
+ *
+ * @param context  The compression context
+ * @param width    The new number of entries of the W-LSB windows
+ */
+static void c_ctxt_set_wlsb_width(struct rohc_comp_ctxt *const context,
+                                  const size_t width)
+{
+	context->wlsb_silence_nr = 0;
+	if(width != context->wlsb_width)
+	{
+		rohc_comp_debug(context, "CID %zu: W-LSB windows change from %zu to %zu "
+		                "entries", context->cid, context->wlsb_width, width);
+		context->wlsb_width = width;
+		context->profile->set_wlsb_width(context, width);
+	}
 }
 
 
@@ -2703,6 +9172,136 @@ bool rohc_comp_reinit_context(struct rohc_comp_ctxt *const context)
 }
 
 
+/**
+ * @brief Get the slab of the context bodies of the given context
+ *
+ * @param context  The compression context
+ * @return         The slab of the profile of the context, NULL if the context
+ *                 is detached from any compressor
+ */
+static struct rohc_slab *
+	rohc_comp_ctxt_slab(const struct rohc_comp_ctxt *const context)
+{
+	size_t i;
+
+	if(context->compressor == NULL)
+	{
+		return NULL;
+	}
+	for(i = 0; i < context->compressor->profiles_nr &&
+	           context->compressor->profiles[i] != context->profile; i++)
+	{
+	}
+	assert(i < context->compressor->profiles_nr);
+
+	return &context->compressor->ctxt_slabs[i];
+}
+
+
+/**
+ * @brief Allocate the body of one context
+ *
+ * The body is taken from the bodies allocated in advance for the profile of
+ * the context if any, it is allocated otherwise unless the compressor shall
+ * not allocate memory (see \ref ROHC_COMP_FEATURE_NO_ALLOC). Its content is
+ * undefined.
+ *
+ * @param context  The compression context
+ * @param size     The size of the body, see the get_body_size handler
+ * @return         The body, NULL if memory ran out or if no prepared body is
+ *                 left without allocation
+ */
+void * rohc_comp_ctxt_body_alloc(const struct rohc_comp_ctxt *const context,
+                                 const size_t size)
+{
+	const int numa_node = (context->compressor != NULL ?
+	                       context->compressor->numa_node : ROHC_NUMA_NO_NODE);
+	struct rohc_slab *const slab = rohc_comp_ctxt_slab(context);
+
+	/* without allocation, only the bodies allocated in advance are given */
+	if(context->compressor != NULL &&
+	   (context->compressor->features & ROHC_COMP_FEATURE_NO_ALLOC) != 0 &&
+	   (slab->free_objs == NULL || slab->obj_size != size))
+	{
+		rohc_warning(context->compressor, ROHC_TRACE_COMP, context->profile->id,
+		             "no prepared context body left, and memory shall not be "
+		             "allocated");
+		return NULL;
+	}
+
+	return rohc_slab_alloc(slab, size, numa_node);
+}
+
+
+/**
+ * @brief Release the body of one context
+ *
+ * The body is kept for the next contexts of the same profile if the
+ * compressor allocates context bodies in advance.
+ *
+ * @param context  The compression context
+ * @param body     The body given by \ref rohc_comp_ctxt_body_alloc
+ */
+void rohc_comp_ctxt_body_free(const struct rohc_comp_ctxt *const context,
+                              void *const body)
+{
+	rohc_slab_free(rohc_comp_ctxt_slab(context), body);
+}
+
+
+/**
+ * @brief Compute the CRC-8 of an IR header
+ *
+ * The CRC of the IR header bytes up to the end of the static chain is cached
+ * in the context, so that the periodic refreshes only compute the CRC of the
+ * dynamic chain. The cached CRC is used only if the bytes are unchanged.
+ *
+ * @param context           The compression context
+ * @param ir_hdr            The IR header with an empty CRC field
+ * @param static_chain_end  The offset of the end of the static chain
+ * @param ir_hdr_len        The length of the IR header
+ * @return                  The CRC-8 of the IR header
+ */
+uint8_t rohc_comp_ir_crc(struct rohc_comp_ctxt *const context,
+                         const uint8_t *const ir_hdr,
+                         const size_t static_chain_end,
+                         const size_t ir_hdr_len)
+{
+	struct rohc_comp_ir_crc_cache *const cache = &context->ir_crc_cache;
+	uint8_t crc;
+
+	assert(static_chain_end <= ir_hdr_len);
+
+	if(cache->len != 0 && cache->len == static_chain_end &&
+	   memcmp(cache->bytes, ir_hdr, static_chain_end) == 0)
+	{
+		rohc_comp_debug(context, "re-use the CRC of the %zu first bytes of the "
+		                "IR header", static_chain_end);
+		crc = cache->crc;
+	}
+	else
+	{
+		crc = crc_calculate(ROHC_CRC_TYPE_8, ir_hdr, static_chain_end,
+		                    CRC_INIT_8, rohc_crc_table_8);
+
+		/* cache the CRC for the next IR packets if the header is not too long */
+		if(static_chain_end <= ROHC_COMP_IR_CRC_CACHE_MAX_LEN)
+		{
+			memcpy(cache->bytes, ir_hdr, static_chain_end);
+			cache->len = static_chain_end;
+			cache->crc = crc;
+		}
+		else
+		{
+			cache->len = 0;
+		}
+	}
+
+	return crc_calculate(ROHC_CRC_TYPE_8, ir_hdr + static_chain_end,
+	                     ir_hdr_len - static_chain_end, crc, rohc_crc_table_8);
+}
+
+
 /**
  * @brief Parse ROHC feedback CID
  *
@@ -2897,12 +9496,12 @@ bool rohc_comp_feedback_parse_opts(const struct rohc_comp_ctxt *const context,
 		/* compute the CRC of the feedback packet (skip CRC byte) */
 		crc_computed = crc_calculate(ROHC_CRC_TYPE_8, packet,
 		                             packet_len - crc_pos_from_end, CRC_INIT_8,
-		                             context->compressor->crc_table_8);
+		                             rohc_crc_table_8);
 		crc_computed = crc_calculate(ROHC_CRC_TYPE_8, &zeroed_crc, zeroed_crc_len,
-		                             crc_computed, context->compressor->crc_table_8);
+		                             crc_computed, rohc_crc_table_8);
 		crc_computed = crc_calculate(ROHC_CRC_TYPE_8, packet + packet_len -
 		                             crc_pos_from_end + 1, crc_pos_from_end - 1,
-		                             crc_computed, context->compressor->crc_table_8);
+		                             crc_computed, rohc_crc_table_8);
 
 		/* ignore feedback in case of bad CRC */
 		if(crc_in_packet != crc_computed)
@@ -64,6 +64,41 @@ extern "C"
 
 struct rohc_comp;
 
+/*
+ * Declare the private structure of a group of ROHC compressors that is
+ * defined inside the library.
+ */
+
+struct rohc_comp_group;
+
+/*
+ * Declare the private structure of a configuration shared by several ROHC
+ * compressors that is defined inside the library.
+ */
+
+struct rohc_comp_config;
+
+/*
+ * Declare the private structure of a compression context detached from its
+ * compressor that is defined inside the library.
+ */
+
+struct rohc_comp_ctxt_export;
+
+/*
+ * Declare the private structure of a compression profile that is defined
+ * inside the library.
+ */
+
+struct rohc_comp_profile;
+
+/*
+ * Declare the private ROHC decompressor structure that is defined inside the
+ * library.
+ */
+
+struct rohc_decomp;
+
 
 /*
  * Public structures and types
@@ -163,6 +198,59 @@ typedef struct
 } __attribute__((packed)) rohc_comp_last_packet_info2_t;
 
 
+/**
+ * @brief Some statistics about one compression context
+ *
+ * The structure is used by the \ref rohc_comp_get_next_ctxt_stats function
+ * to walk all the contexts in use and report their efficiency. A context
+ * that keeps sending most of its packets in IR or FO states, or that saves
+ * few header bytes, may point at a flow that the compressor handles badly.
+ *
+ * Versioning works as for \ref rohc_comp_general_info_t.
+ *
+ * Supported versions:
+ *  - Major 0 / Minor 0 contains: version_major, version_minor, context_id,
+ *    profile_id, context_mode, context_state, packets_nr, ir_packets_nr,
+ *    fo_packets_nr, so_packets_nr, header_uncomp_bytes_nr,
+ *    header_comp_bytes_nr, first_used, and last_used
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_get_next_ctxt_stats
+ */
+typedef struct
+{
+	/** The major version of this structure */
+	unsigned short version_major;
+	/** The minor version of this structure */
+	unsigned short version_minor;
+	/** The Context ID (CID) */
+	unsigned int context_id;
+	/** The profile ID of the context */
+	int profile_id;
+	/** The current mode of the context */
+	rohc_mode_t context_mode;
+	/** The current state of the context */
+	rohc_comp_state_t context_state;
+	/** The number of packets compressed with the context */
+	unsigned long packets_nr;
+	/** The number of packets compressed in IR state */
+	unsigned long ir_packets_nr;
+	/** The number of packets compressed in FO state */
+	unsigned long fo_packets_nr;
+	/** The number of packets compressed in SO state */
+	unsigned long so_packets_nr;
+	/** The cumulative size (in bytes) of the uncompressed headers */
+	unsigned long header_uncomp_bytes_nr;
+	/** The cumulative size (in bytes) of the compressed headers */
+	unsigned long header_comp_bytes_nr;
+	/** The arrival time of the first packet of the context (in seconds) */
+	uint64_t first_used;
+	/** The arrival time of the last packet of the context (in seconds) */
+	uint64_t last_used;
+} __attribute__((packed)) rohc_comp_ctxt_stats_t;
+
+
 /**
  * @brief Some general information about the compressor
  *
@@ -234,10 +322,74 @@ typedef enum
 	ROHC_COMP_FEATURE_NO_IP_CHECKSUMS = (1 << 2),
 	/** Dump content of packets in traces (beware: performance impact) */
 	ROHC_COMP_FEATURE_DUMP_PACKETS    = (1 << 3),
+	/** Record the processing time of packets (see rohc_comp_get_latency_stats()) */
+	ROHC_COMP_FEATURE_LATENCY         = (1 << 4),
+	/** Do not copy the payload of the segmented packets, give the segments as
+	 *  views over the uncompressed packets (see rohc_comp_get_segment_iov()) */
+	ROHC_COMP_FEATURE_SEGMENT_VIEWS   = (1 << 5),
+	/** Adapt the width of the W-LSB windows of every context to the feedback
+	 *  received for it (see rohc_comp_set_wlsb_window_width()) */
+	ROHC_COMP_FEATURE_ADAPTIVE_WLSB   = (1 << 6),
+	/** Restrict the packet types to the cheapest ones to encode, at the cost
+	 *  of larger headers: IR-DYN instead of the extension 3 of the UO-1-ID and
+	 *  UOR-2 packets, only seq_1, rnd_1 and co_common packets for TCP */
+	ROHC_COMP_FEATURE_CHEAP_PACKETS   = (1 << 7),
+	/** Create the context of a new flow from the context of a recent flow
+	 *  between the same hosts, so that it starts with the behavior of the
+	 *  fields that flow already learned (TCP profile only) */
+	ROHC_COMP_FEATURE_CLONE_CTXTS     = (1 << 8),
+	/** Save the contexts released by the idle timeout in a cold store, and
+	 *  revive them without IR packets when their flows come back (see
+	 *  rohc_comp_set_ctxt_idle_timeout()) */
+	ROHC_COMP_FEATURE_COLD_CTXTS      = (1 << 9),
+	/** Never allocate memory while compressing: the contexts only take the
+	 *  bodies prepared in advance (see rohc_comp_set_ctxts_prealloc()), the
+	 *  flows that need more memory, like IPv6 extension headers or CSRC lists
+	 *  larger than the memory prepared in the bodies, are compressed with the
+	 *  Uncompressed profile */
+	ROHC_COMP_FEATURE_NO_ALLOC        = (1 << 10),
 
 } rohc_comp_features_t;
 
 
+/**
+ * @brief The stages of the compression of one packet
+ *
+ * The CPU cycles spent in every stage are accounted if the library was built
+ * with the --enable-stage-cycles option of the configure script. They can be
+ * retrieved with the function \ref rohc_comp_get_stage_cycles.
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_get_stage_cycles
+ * @see rohc_comp_get_stage_descr
+ */
+typedef enum
+{
+	/** Parse the uncompressed headers */
+	ROHC_COMP_STAGE_PARSE         = 0,
+	/** Find the compression context of the packet, or create it */
+	ROHC_COMP_STAGE_FIND_CTXT     = 1,
+	/** Detect the changes in the headers and decide the context state */
+	ROHC_COMP_STAGE_CHANGES       = 2,
+	/** Compute how many bits are needed to transmit the header fields */
+	ROHC_COMP_STAGE_ENCODE_FIELDS = 3,
+	/** Decide the type of ROHC packet to send */
+	ROHC_COMP_STAGE_DECIDE_PKT    = 4,
+	/** Build the ROHC header (without the CRC) */
+	ROHC_COMP_STAGE_BUILD_HDR     = 5,
+	/** Compute the CRC of the ROHC header */
+	ROHC_COMP_STAGE_CRC           = 6,
+	/** Update the compression context with the new headers */
+	ROHC_COMP_STAGE_UPDATE_CTXT   = 7,
+	/** Copy the payload after the ROHC header */
+	ROHC_COMP_STAGE_PAYLOAD       = 8,
+
+	ROHC_COMP_STAGE_MAX           = 9, /**< The number of compression stages */
+
+} rohc_comp_stage_t;
+
+
 /**
  * @brief The prototype of the RTP detection callback
  *
@@ -307,18 +459,75 @@ bool ROHC_EXPORT rohc_comp_set_traces_cb2(struct rohc_comp *const comp,
                                           void *const priv_ctxt)
 	__attribute__((warn_unused_result));
 
+bool ROHC_EXPORT rohc_comp_set_trace_level(struct rohc_comp *const comp,
+                                           const rohc_trace_level_t level)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_set_trace_ring(struct rohc_comp *const comp,
+                                          const size_t records_nr)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_get_trace_records(const struct rohc_comp *const comp,
+                                             struct rohc_trace_record *const records,
+                                             const size_t max_nr,
+                                             size_t *const records_nr)
+	__attribute__((warn_unused_result));
+
 rohc_status_t ROHC_EXPORT rohc_compress4(struct rohc_comp *const comp,
                                          const struct rohc_buf uncomp_packet,
                                          struct rohc_buf *const rohc_packet)
 	__attribute__((warn_unused_result));
 
+size_t ROHC_EXPORT rohc_compress_batch(struct rohc_comp *const comp,
+                                       const struct rohc_buf uncomp_packets[],
+                                       struct rohc_buf rohc_packets[],
+                                       rohc_status_t statuses[],
+                                       const size_t pkts_nr)
+	__attribute__((warn_unused_result));
+
+rohc_status_t ROHC_EXPORT rohc_compress_iov(struct rohc_comp *const comp,
+                                            const struct rohc_buf uncomp_iov[],
+                                            const size_t uncomp_iov_nr,
+                                            struct rohc_buf *const rohc_packet)
+	__attribute__((warn_unused_result));
+
+rohc_status_t ROHC_EXPORT rohc_compress_with_cid(struct rohc_comp *const comp,
+                                                 const rohc_cid_t cid,
+                                                 const struct rohc_buf uncomp_packet,
+                                                 struct rohc_buf *const rohc_packet)
+	__attribute__((warn_unused_result));
+
+rohc_status_t ROHC_EXPORT rohc_compress_header(struct rohc_comp *const comp,
+                                               const struct rohc_buf uncomp_packet,
+                                               struct rohc_buf *const rohc_header,
+                                               size_t *const payload_offset,
+                                               size_t *const payload_len)
+	__attribute__((warn_unused_result));
+
+rohc_status_t ROHC_EXPORT rohc_compress_inplace(struct rohc_comp *const comp,
+                                                struct rohc_buf *const packet)
+	__attribute__((warn_unused_result));
+
 rohc_status_t ROHC_EXPORT rohc_comp_get_segment2(struct rohc_comp *const comp,
                                                  struct rohc_buf *const segment)
 	__attribute__((warn_unused_result));
 
+rohc_status_t ROHC_EXPORT rohc_comp_get_segment_iov(struct rohc_comp *const comp,
+                                                    const size_t max_len,
+                                                    struct rohc_buf segment_iov[],
+                                                    size_t *const segment_iov_nr)
+	__attribute__((warn_unused_result));
+
 bool ROHC_EXPORT rohc_comp_force_contexts_reinit(struct rohc_comp *const comp)
 	__attribute__((warn_unused_result));
 
+bool ROHC_EXPORT rohc_comp_set_reinit_pacing(struct rohc_comp *const comp,
+                                             const size_t ctxts_nr)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_reset(struct rohc_comp *const comp)
+	__attribute__((warn_unused_result));
+
 
 /*
  * Prototypes of public functions related to user interaction
@@ -342,6 +551,11 @@ bool ROHC_EXPORT rohc_comp_disable_profiles(struct rohc_comp *const comp,
                                             ...)
 	__attribute__((warn_unused_result));
 
+bool ROHC_EXPORT rohc_comp_register_profile(struct rohc_comp *const comp,
+                                            const struct rohc_comp_profile *const profile,
+                                            const int priority)
+	__attribute__((warn_unused_result));
+
 bool ROHC_EXPORT rohc_comp_set_mrru(struct rohc_comp *const comp,
                                     const size_t mrru)
 	__attribute__((warn_unused_result));
@@ -349,6 +563,10 @@ bool ROHC_EXPORT rohc_comp_get_mrru(const struct rohc_comp *const comp,
                                     size_t *const mrru)
 	__attribute__((warn_unused_result));
 
+bool ROHC_EXPORT rohc_comp_set_rru_slots(struct rohc_comp *const comp,
+                                         const size_t slots_nr)
+	__attribute__((warn_unused_result));
+
 bool ROHC_EXPORT rohc_comp_get_max_cid(const struct rohc_comp *const comp,
                                        size_t *const max_cid)
 	__attribute__((warn_unused_result));
@@ -362,14 +580,46 @@ bool ROHC_EXPORT rohc_comp_set_rtp_detection_cb(struct rohc_comp *const comp,
                                                 void *const rtp_private)
 	__attribute__((warn_unused_result));
 
+bool ROHC_EXPORT rohc_comp_add_rtp_ports(struct rohc_comp *const comp,
+                                         const uint16_t port_min,
+                                         const uint16_t port_max)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_remove_rtp_ports(struct rohc_comp *const comp,
+                                            const uint16_t port_min,
+                                            const uint16_t port_max)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_set_rtp_min_sequential(struct rohc_comp *const comp,
+                                                  const size_t packets_nr)
+	__attribute__((warn_unused_result));
+
 bool ROHC_EXPORT rohc_comp_set_features(struct rohc_comp *const comp,
                                         const rohc_comp_features_t features)
 	__attribute__((warn_unused_result));
 
+bool ROHC_EXPORT rohc_comp_set_recorder(struct rohc_comp *const comp,
+                                        const rohc_record_write_t write_cb,
+                                        void *const priv,
+                                        const size_t max_len)
+	__attribute__((warn_unused_result));
+
 bool ROHC_EXPORT rohc_comp_deliver_feedback2(struct rohc_comp *const comp,
                                              const struct rohc_buf feedback)
 	__attribute__((warn_unused_result));
 
+bool ROHC_EXPORT rohc_comp_deliver_feedback_batch(struct rohc_comp *const comp,
+                                                  const struct rohc_buf feedback)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_enqueue_feedback(struct rohc_comp *const comp,
+                                            const struct rohc_buf feedback)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_attach_decomp(struct rohc_comp *const comp,
+                                         struct rohc_decomp *const decomp)
+	__attribute__((warn_unused_result));
+
 
 /*
  * Prototypes of public functions that configure robustness to packet
@@ -385,6 +635,28 @@ bool ROHC_EXPORT rohc_comp_set_periodic_refreshes(struct rohc_comp *const comp,
                                                   const size_t fo_timeout)
 	__attribute__((warn_unused_result));
 
+bool ROHC_EXPORT rohc_comp_set_periodic_refreshes_time(struct rohc_comp *const comp,
+                                                       const size_t ir_timeout,
+                                                       const size_t fo_timeout)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_set_ctxt_idle_timeout(struct rohc_comp *const comp,
+                                                 const size_t idle_timeout)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_set_profile_failure_timeout(struct rohc_comp *const comp,
+                                                       const size_t timeout)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_set_ctxts_prealloc(struct rohc_comp *const comp,
+                                              const size_t ctxts_nr)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_prewarm_ctxts(struct rohc_comp *const comp,
+                                         const rohc_profile_t profile,
+                                         const size_t ctxts_nr)
+	__attribute__((warn_unused_result));
+
 bool ROHC_EXPORT rohc_comp_set_list_trans_nr(struct rohc_comp *const comp,
                                              const size_t list_trans_nr)
 	__attribute__((warn_unused_result));
@@ -398,6 +670,31 @@ bool ROHC_EXPORT rohc_comp_get_general_info(const struct rohc_comp *const comp,
                                             rohc_comp_general_info_t *const info)
 	__attribute__((warn_unused_result));
 
+bool ROHC_EXPORT rohc_comp_get_next_ctxt_stats(const struct rohc_comp *const comp,
+                                               rohc_cid_t *const cid,
+                                               rohc_comp_ctxt_stats_t *const stats)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_get_packet_stats(const struct rohc_comp *const comp,
+                                            rohc_packet_stats_t *const stats)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_get_latency_stats(const struct rohc_comp *const comp,
+                                             rohc_latency_stats_t *const stats)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_get_stage_cycles(const struct rohc_comp *const comp,
+                                            const rohc_comp_stage_t stage,
+                                            uint64_t *const cycles)
+	__attribute__((warn_unused_result));
+
+const char * ROHC_EXPORT rohc_comp_get_stage_descr(const rohc_comp_stage_t stage)
+	__attribute__((warn_unused_result, const));
+
+bool ROHC_EXPORT rohc_comp_get_memory_usage(const struct rohc_comp *const comp,
+                                            rohc_memory_usage_t *const mem)
+	__attribute__((warn_unused_result));
+
 bool ROHC_EXPORT rohc_comp_get_last_packet_info2(const struct rohc_comp *const comp,
                                                  rohc_comp_last_packet_info2_t *const info)
 	__attribute__((warn_unused_result));
@@ -406,6 +703,124 @@ const char * ROHC_EXPORT rohc_comp_get_state_descr(const rohc_comp_state_t state
 	__attribute__((warn_unused_result, const));
 
 
+/*
+ * Prototypes of public functions related to groups of ROHC compressors
+ */
+
+struct rohc_comp_group * ROHC_EXPORT
+	rohc_comp_group_new(const rohc_cid_type_t cid_type,
+	                    const rohc_cid_t max_cid,
+	                    const size_t shards_nr,
+	                    const rohc_comp_random_cb_t rand_cb,
+	                    void *const rand_priv)
+	__attribute__((warn_unused_result));
+
+void ROHC_EXPORT rohc_comp_group_free(struct rohc_comp_group *const group);
+
+struct rohc_comp * ROHC_EXPORT
+	rohc_comp_group_get_shard(const struct rohc_comp_group *const group,
+	                          const size_t shard_idx)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_group_steer(const struct rohc_comp_group *const group,
+                                       const struct rohc_buf uncomp_packet,
+                                       size_t *const shard_idx)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT
+	rohc_comp_group_deliver_feedback(struct rohc_comp_group *const group,
+	                                 const struct rohc_buf feedback)
+	__attribute__((warn_unused_result));
+
+
+
+/*
+ * Prototypes of public functions related to shared configurations
+ */
+
+struct rohc_comp_config * ROHC_EXPORT
+	rohc_comp_config_new(const rohc_cid_type_t cid_type,
+	                     const rohc_cid_t max_cid)
+	__attribute__((warn_unused_result));
+
+void ROHC_EXPORT rohc_comp_config_free(struct rohc_comp_config *const config);
+
+bool ROHC_EXPORT
+	rohc_comp_config_enable_profile(struct rohc_comp_config *const config,
+	                                const rohc_profile_t profile)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT
+	rohc_comp_config_set_wlsb_window_width(struct rohc_comp_config *const config,
+	                                       const size_t width)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT
+	rohc_comp_config_set_ctxts_prealloc(struct rohc_comp_config *const config,
+	                                    const size_t ctxts_nr)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT
+	rohc_comp_config_set_numa_node(struct rohc_comp_config *const config,
+	                               const int numa_node)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT
+	rohc_comp_config_set_periodic_refreshes(struct rohc_comp_config *const config,
+	                                        const size_t ir_timeout,
+	                                        const size_t fo_timeout)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT
+	rohc_comp_config_set_mrru(struct rohc_comp_config *const config,
+	                          const size_t mrru)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT
+	rohc_comp_config_set_rtp_detection_cb(struct rohc_comp_config *const config,
+	                                      rohc_rtp_detection_callback_t callback,
+	                                      void *const rtp_private)
+	__attribute__((warn_unused_result));
+
+struct rohc_comp * ROHC_EXPORT
+	rohc_comp_new_from_config(struct rohc_comp_config *const config,
+	                          const rohc_comp_random_cb_t rand_cb,
+	                          void *const rand_priv)
+	__attribute__((warn_unused_result));
+
+
+/*
+ * Prototypes of public functions related to the migration of contexts
+ */
+
+struct rohc_comp_ctxt_export * ROHC_EXPORT
+	rohc_comp_ctxt_export(struct rohc_comp *const comp,
+	                      const rohc_cid_t cid)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT
+	rohc_comp_ctxt_import(struct rohc_comp *const comp,
+	                      struct rohc_comp_ctxt_export *const export)
+	__attribute__((warn_unused_result));
+
+void ROHC_EXPORT
+	rohc_comp_ctxt_export_free(struct rohc_comp_ctxt_export *const export);
+
+
+/*
+ * Prototypes of public functions related to snapshots
+ */
+
+bool ROHC_EXPORT rohc_comp_snapshot(const struct rohc_comp *const comp,
+                                    const rohc_snapshot_write_t write_cb,
+                                    void *const priv)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_restore(struct rohc_comp *const comp,
+                                   const rohc_snapshot_read_t read_cb,
+                                   void *const priv)
+	__attribute__((warn_unused_result));
+
 #undef ROHC_EXPORT /* do not pollute outside this header */
 
 #ifdef __cplusplus
@@ -27,13 +27,21 @@
 #ifndef ROHC_COMP_INTERNALS_H
 #define ROHC_COMP_INTERNALS_H
 
+#include "config.h" /* for ROHC_WITH_PROFILE_* */
 #include "rohc_internal.h"
 #include "rohc_traces_internal.h"
+#include "rohc_latency.h"
+#include "rohc_cycles.h"
 #include "rohc_packets.h"
 #include "rohc_comp.h"
 #include "schemes/comp_wlsb.h"
+#include "schemes/cid.h"
 #include "net_pkt.h"
 #include "feedback.h"
+#include "rohc_snapshot.h"
+#include "rohc_record.h"
+#include "rohc_slab.h"
+#include "rohc_seqlock.h"
 
 #ifdef __KERNEL__
 #  include <linux/types.h>
@@ -46,8 +54,19 @@
  * Constants and macros
  */
 
-/** The number of ROHC profiles ready to be used */
-#define C_NUM_PROFILES 7U
+/** The number of ROHC profiles ready to be used, ie. built in the library */
+#define C_NUM_PROFILES \
+	(0U + ROHC_WITH_PROFILE_RTP + ROHC_WITH_PROFILE_UDP + \
+	 ROHC_WITH_PROFILE_UDPLITE + ROHC_WITH_PROFILE_ESP + \
+	 ROHC_WITH_PROFILE_TCP + ROHC_WITH_PROFILE_IP + \
+	 ROHC_WITH_PROFILE_UNCOMPRESSED)
+
+/** The max number of profiles that one compressor accepts in addition to the
+ *  profiles built in the library (see rohc_comp_register_profile) */
+#define ROHC_COMP_EXTRA_PROFILES_MAX  4U
+
+/** The max number of profiles of one compressor */
+#define C_MAX_PROFILES  (C_NUM_PROFILES + ROHC_COMP_EXTRA_PROFILES_MAX)
 
 /** The default maximal number of packets sent in > IR states (= FO and SO
  *  states) before changing back the state to IR (periodic refreshes) */
@@ -57,6 +76,31 @@
  *  before changing back the state to FO (periodic refreshes) */
 #define CHANGE_TO_FO_COUNT  700
 
+/** The default width of the W-LSB sliding windows */
+#if ROHC_SMALL_CONTEXTS == 1
+/* small contexts keep the smallest windows that survive the loss of one
+ * packet, their width cannot be changed */
+#  define ROHC_COMP_WLSB_WIDTH  2U
+#else
+#  define ROHC_COMP_WLSB_WIDTH  4U
+#endif
+
+/** The smallest width of the W-LSB windows of one context, reached after
+ *  several ACKs when the W-LSB windows adapt to feedback */
+#define ROHC_COMP_WLSB_MIN_WIDTH  2U
+
+/** The number of packets without feedback after which the W-LSB windows of
+ *  one context are widened when they adapt to feedback */
+#define ROHC_COMP_WLSB_SILENCE_NR  64U
+
+/** The number of the most recently used contexts searched for a context to
+ *  clone when a new context is created */
+#define ROHC_COMP_CLONE_SEARCH_NR  8U
+
+/** The initial size (in bytes) of the buffer where idle contexts are saved
+ *  before they are moved in the cold store */
+#define ROHC_COMP_COLD_BUF_LEN  1024U
+
 /** The minimal number of packets that must be sent while in IR state before
  *  being able to switch to the FO state */
 #define MAX_IR_COUNT  3U
@@ -102,6 +146,33 @@
 	} while(0)
 
 
+/** The number of slots in the queue of feedback waiting for the compressor
+ *  (a power of 2) */
+#define ROHC_COMP_FEEDBACK_QUEUE_LEN  32U
+
+/** The maximum length of the feedback data stored in one slot of the queue
+ *  of feedback waiting for the compressor */
+#define ROHC_COMP_FEEDBACK_QUEUE_SLOT_LEN  64U
+
+/** The maximum number of feedback items sorted together by
+ *  \ref rohc_comp_deliver_feedback_batch */
+#define ROHC_COMP_FEEDBACK_BATCH_LEN  16U
+
+/** The maximum length of the feedback of the attached decompressor that is
+ *  piggybacked in front of one ROHC packet */
+#define ROHC_COMP_PIGGYBACK_MAX_LEN  32U
+
+/** The maximum number of pieces of one RRU: the ROHC header, the buffers of
+ *  the payload and the FCS-32 CRC */
+#define ROHC_COMP_RRU_PIECES_MAX  8U
+
+/** The maximum number of RRUs waiting to be split into segments */
+#define ROHC_COMP_RRU_SLOTS_MAX  16U
+
+/** No CID given for the packet: the compressor finds the context itself */
+#define ROHC_COMP_CID_NONE  ((rohc_cid_t) -1)
+
+
 /*
  * Declare ROHC compression structures that are defined at the end of this
  * file but used by other structures at the beginning of the file.
@@ -115,6 +186,221 @@ struct rohc_comp_ctxt;
  */
 
 
+/**
+ * @brief One feedback waiting in the queue of the compressor
+ */
+struct rohc_comp_feedback_slot
+{
+	/** The length of the feedback data */
+	size_t len;
+	/** The raw feedback data */
+	uint8_t data[ROHC_COMP_FEEDBACK_QUEUE_SLOT_LEN];
+};
+
+
+/**
+ * @brief The queue of feedback waiting for the compressor
+ *
+ * Single-producer, single-consumer ring: the producer only writes \e head,
+ * the compressor only writes \e tail. The indexes are free-running, the slot
+ * of an index is given by masking it with ROHC_COMP_FEEDBACK_QUEUE_LEN - 1.
+ */
+struct rohc_comp_feedback_queue
+{
+	/** The index of the next slot to fill, written by the producer only */
+	size_t head;
+	/** The index of the next slot to drain, written by the compressor only */
+	size_t tail;
+	/** The feedback waiting for the compressor */
+	struct rohc_comp_feedback_slot slots[ROHC_COMP_FEEDBACK_QUEUE_LEN];
+};
+
+
+/**
+ * @brief The prototype of the callback that gives the feedback to piggyback
+ *
+ * The callback appends the feedback to piggyback to the given buffer, as
+ * rohc_decomp_flush_feedback() does.
+ *
+ * @param priv          The private context of the callback
+ * @param[out] feedback  The buffer where to append the feedback
+ * @return              true if successful, false if a problem occurred
+ */
+typedef bool (*rohc_comp_feedback_source_t)(void *const priv,
+                                            struct rohc_buf *const feedback);
+
+
+/**
+ * @brief The source of the feedback piggybacked in the ROHC packets
+ *
+ * The source is the decompressor attached by rohc_comp_attach_decomp().
+ */
+struct rohc_comp_feedback_source
+{
+	/** The callback that gives the feedback to piggyback, NULL if none */
+	rohc_comp_feedback_source_t cb;
+	/** The private context of the callback */
+	void *priv;
+};
+
+
+/**
+ * @brief One feedback item pre-parsed by \ref rohc_comp_deliver_feedback_batch
+ */
+struct rohc_comp_feedback_item
+{
+	/** The feedback data with CID bits, without feedback header */
+	const uint8_t *data;
+	/** The length of the feedback data */
+	size_t len;
+	/** The CID of the feedback */
+	rohc_cid_t cid;
+	/** The length of the CID bits */
+	size_t cid_len;
+	/** Whether the feedback is a positive ACK */
+	bool is_ack;
+	/** Whether the feedback is a positive ACK followed by a later one */
+	bool is_subsumed;
+};
+
+
+/**
+ * @brief The fields of one compression context that the lookups read
+ *
+ * The fields are copied from the context in a packed array indexed like the
+ * array of contexts, so that the lookups check 8 contexts per cache line
+ * instead of loading one whole context and its profile for every candidate.
+ */
+struct rohc_comp_ctxt_hot
+{
+	/** The key of the context */
+	rohc_ctxt_key_t key;
+	/** The ID of the profile of the context */
+	uint16_t profile_id;
+	/** Whether the context is in use or not */
+	uint16_t used;
+};
+
+
+/**
+ * @brief One compression context of the cold store
+ *
+ * The context was idle for too long: it was saved in the format of
+ * snapshots, then released. It keeps its CID until its flow comes back or
+ * until the CID is needed for another flow.
+ */
+struct rohc_comp_cold_ctxt
+{
+	/** The next cold context in the same bucket of the cold index */
+	struct rohc_comp_cold_ctxt *hash_next;
+	/** The previous cold context, from the oldest to the newest one */
+	struct rohc_comp_cold_ctxt *prev;
+	/** The next cold context, from the oldest to the newest one */
+	struct rohc_comp_cold_ctxt *next;
+	/** The key of the context */
+	rohc_ctxt_key_t key;
+	/** The ID of the profile of the context */
+	uint16_t profile_id;
+	/** The index of the CID of the context in the array of contexts */
+	uint16_t cid_idx;
+	/** The length (in bytes) of the saved context */
+	size_t len;
+	/** The saved context: one context record of a snapshot */
+	uint8_t record[];
+};
+
+
+/**
+ * @brief One entry of the cache of the profiles that classified the flows
+ */
+struct rohc_comp_profile_cache_entry
+{
+	/** The key of the flow */
+	rohc_ctxt_key_t key;
+	/** The transport protocol of the flow */
+	uint8_t proto;
+	/** The index of the profile in the array of profiles plus one,
+	 *  or 0 if the entry is empty */
+	uint8_t profile_idx;
+	/** The time (in seconds) until which the packets of the flow go straight
+	 *  to the Uncompressed profile because its profile failed to encode one
+	 *  of them, 0 if the profile of the flow did not fail */
+	uint32_t failed_until;
+};
+
+
+/**
+ * @brief One piece of the RRU waiting to be split into segments
+ *
+ * The piece is either bytes of the RRU buffer of the compressor, or the
+ * payload of the segmented packet left in place in the buffers given by the
+ * application (see ROHC_COMP_FEATURE_SEGMENT_VIEWS).
+ */
+struct rohc_comp_rru_piece
+{
+	uint8_t *data;  /**< The remaining bytes of the piece */
+	size_t len;     /**< The number of remaining bytes of the piece */
+};
+
+
+/**
+ * @brief One RRU waiting to be split into segments
+ */
+struct rohc_comp_rru
+{
+	/** The RRU buffer of the slot, MRRU bytes */
+	uint8_t *data;
+	/** The remaining pieces of the RRU: the whole RRU buffer, or the ROHC
+	 *  header, the payload and the CRC if the payload is not copied */
+	struct rohc_comp_rru_piece pieces[ROHC_COMP_RRU_PIECES_MAX];
+	/** The number of pieces of the RRU */
+	size_t pieces_nr;
+	/** The index of the first remaining piece of the RRU */
+	size_t piece_idx;
+	/** The number of the remaining bytes of the RRU */
+	size_t len;
+};
+
+
+/**
+ * @brief The flow of one UDP stream on probation for the built-in RTP
+ *        detection
+ */
+struct rohc_comp_rtp_probation
+{
+	/** The key of the flow */
+	rohc_ctxt_key_t key;
+	/** The SSRC of the RTP stream (in network byte order) */
+	uint32_t ssrc;
+	/** The RTP sequence number of the latest packet */
+	uint16_t sn;
+	/** The number of packets received in sequence so far */
+	uint16_t count;
+};
+
+
+/**
+ * @brief The built-in RTP detection of the compressor
+ *
+ * The UDP packets sent to one of the configured destination ports are
+ * detected as RTP if their RTP header is sane (version 2, not a multiplexed
+ * RTCP packet) and once the RTP stream received the configured number of
+ * packets in sequence, like the probation of new sources of RFC 3550.
+ */
+struct rohc_comp_rtp_detect
+{
+	/** The bitmap of the UDP destination ports reserved for RTP */
+	uint64_t ports[65536 / 64];
+	/** The number of UDP destination ports reserved for RTP */
+	size_t ports_nr;
+	/** The number of packets in sequence required to detect an RTP stream */
+	size_t min_sequential;
+	/** The table of the RTP streams on probation, direct-mapped on the
+	 *  context key with as many entries as slots in the context index */
+	struct rohc_comp_rtp_probation probation[];
+};
+
+
 /**
  * @brief The ROHC compressor
  */
@@ -122,40 +408,147 @@ struct rohc_comp
 {
 	/** The medium associated with the decompressor */
 	struct rohc_medium medium;
+	/** The function that builds the CID part of the ROHC packets, selected
+	 *  for the type of CID of the medium */
+	code_cid_values_t code_cid_values;
 
 	/** Enabled/disabled features for the compressor */
 	rohc_comp_features_t features;
 
 	/** The array of compression contexts that use the compressor */
 	struct rohc_comp_ctxt *contexts;
+	/** The CID of the first context of the array: 0 for a standalone
+	 *  compressor, the first CID of its range for one shard of a group of
+	 *  compressors (the array then holds medium.max_cid + 1 contexts from
+	 *  that CID on) */
+	rohc_cid_t cid_base;
+	/** The fields of the contexts that the lookups read, indexed like the
+	 *  array of contexts and updated when contexts are indexed */
+	struct rohc_comp_ctxt_hot *contexts_hot;
 	/** The number of compression contexts in use in the array */
 	size_t num_contexts_used;
-
+	/** The hash index of the contexts in use, keyed on profile ID and context
+	 *  key (open addressing with linear probing): every slot stores the
+	 *  index of one context in the array plus one, or 0 if the slot is
+	 *  empty */
+	uint16_t *contexts_index;
+	/** The mask to apply on hashes to get a slot in the context index (the
+	 *  number of slots is a power of 2 at least twice the number of contexts) */
+	size_t contexts_index_mask;
+	/** The cache of the profiles that classified the flows, keyed on the
+	 *  context key only and direct-mapped with as many entries as slots in
+	 *  the context index: the packets of established flows are checked
+	 *  against the cached profile only instead of all the enabled profiles */
+	struct rohc_comp_profile_cache_entry *profile_cache;
+	/** The memory used by the profile-specific parts of the contexts in use,
+	 *  indexed by profile ID (see rohc_comp_get_memory_usage) */
+	struct rohc_ctxt_mem contexts_mem[ROHC_PROFILE_MAX];
+	/** The cold contexts indexed by CID, NULL if the cold store was never
+	 *  enabled (see ROHC_COMP_FEATURE_COLD_CTXTS) */
+	struct rohc_comp_cold_ctxt **cold_ctxts;
+	/** The hash index of the cold contexts, keyed like the index of contexts
+	 *  with one chain of cold contexts per slot */
+	struct rohc_comp_cold_ctxt **cold_index;
+	/** The oldest cold context, the first one to give its CID up */
+	struct rohc_comp_cold_ctxt *cold_oldest;
+	/** The newest cold context */
+	struct rohc_comp_cold_ctxt *cold_newest;
+	/** The number of cold contexts */
+	size_t cold_ctxts_nr;
+	/** The buffer where one idle context is saved before it is copied in
+	 *  the cold store, enlarged if a larger context is saved */
+	uint8_t *cold_buf;
+	/** The length (in bytes) of the context saved in the buffer */
+	size_t cold_buf_len;
+	/** The size (in bytes) of the buffer */
+	size_t cold_buf_max_len;
+	/** The stack of the CIDs that are neither in use nor held by cold
+	 *  contexts */
+	uint16_t *free_cids;
+	/** The number of CIDs in the stack of free CIDs */
+	size_t free_cids_nr;
+	/** The most recently used context (head of the LRU list of contexts) */
+	struct rohc_comp_ctxt *lru_head;
+	/** The least recently used context (tail of the LRU list of contexts) */
+	struct rohc_comp_ctxt *lru_tail;
+	/** The time (in seconds) after which an unused context is released, 0
+	 *  to release contexts only when their CIDs are needed for new contexts
+	 *  (see rohc_comp_set_ctxt_idle_timeout) */
+	size_t ctxt_idle_timeout;
+	/** The time (in seconds) during which the packets of one flow go straight
+	 *  to the Uncompressed profile once its profile failed to encode one of
+	 *  them, 0 to try the profile again for every packet
+	 *  (see rohc_comp_set_profile_failure_timeout) */
+	size_t profile_failure_timeout;
+	/** The number of contexts re-initialized before every packet once
+	 *  \ref rohc_comp_force_contexts_reinit was called, 0 to re-initialize
+	 *  all contexts at once (see rohc_comp_set_reinit_pacing) */
+	size_t reinit_pacing;
+	/** The stack of the CIDs of the contexts still to be re-initialized, the
+	 *  contexts that were in use when the re-initialization was forced */
+	uint16_t *reinit_cids;
+	/** The number of CIDs in the stack of CIDs to re-initialize */
+	size_t reinit_left_nr;
+
+	/** The profiles of the compressor: the profiles built in the library,
+	 *  then the profiles registered with \ref rohc_comp_register_profile */
+	const struct rohc_comp_profile *profiles[C_MAX_PROFILES];
+	/** The priorities of the registered profiles, indexed like the profiles */
+	int profiles_prio[C_MAX_PROFILES];
+	/** The number of profiles of the compressor */
+	size_t profiles_nr;
+	/** The indexes of the profiles in the order they are evaluated: the
+	 *  registered profiles by decreasing priority, then the built-in ones */
+	uint8_t profiles_order[C_MAX_PROFILES];
 	/** Which profiles are enabled and with one are not? */
-	bool enabled_profiles[C_NUM_PROFILES];
-
+	bool enabled_profiles[C_MAX_PROFILES];
+	/** The bodies of the contexts allocated in advance, one slab per profile
+	 *  (see rohc_comp_set_ctxts_prealloc) */
+	struct rohc_slab ctxt_slabs[C_MAX_PROFILES];
+	/** The number of context bodies allocated in advance for every enabled
+	 *  profile, 0 to allocate them only when contexts are created */
+	size_t ctxts_prealloc_nr;
+	/** The NUMA node of the contexts, ROHC_NUMA_NO_NODE for any node */
+	int numa_node;
 
-	/* CRC-related variables: */
-
-	/** The table to enable fast CRC-3 computation */
-	uint8_t crc_table_3[256];
-	/** The table to enable fast CRC-7 computation */
-	uint8_t crc_table_7[256];
-	/** The table to enable fast CRC-8 computation */
-	uint8_t crc_table_8[256];
+	/** The headers of the packet being compressed, described once while
+	 *  parsing it and read by the profiles (too large for the stack) */
+	struct net_pkt_hdrs pkt_hdrs;
 
 
 	/* segment-related variables */
 
 /** The maximal value for MRRU */
 #define ROHC_MAX_MRRU 65535
-	/** The remaining bytes of the Reconstructed Reception Unit (RRU) waiting
-	 *  to be split into segments */
-	uint8_t rru[ROHC_MAX_MRRU];
-	/** The offset of the remaining bytes in the RRU buffer */
-	size_t rru_off;
-	/** The number of the remaining bytes in the RRU buffer */
-	size_t rru_len;
+	/** The buffers of the Reconstructed Reception Units (RRU) waiting to be
+	 *  split into segments, allocated with MRRU bytes per slot only when
+	 *  segmentation is enabled */
+	uint8_t *rru;
+	/** The ring of RRUs waiting to be split into segments, in the order of
+	 *  the compressed packets */
+	struct rohc_comp_rru rru_slots[ROHC_COMP_RRU_SLOTS_MAX];
+	/** The number of slots in the ring of RRUs (see rohc_comp_set_rru_slots) */
+	size_t rru_slots_nr;
+	/** The index of the oldest RRU in the ring */
+	size_t rru_first;
+	/** The number of RRUs waiting in the ring */
+	size_t rru_count;
+	/** The type byte of the last segment given by rohc_comp_get_segment_iov */
+	uint8_t rru_seg_type;
+
+
+	/* feedback-related variables */
+
+	/** The feedback enqueued by another thread, delivered to the contexts at
+	 *  the beginning of the next compression */
+	struct rohc_comp_feedback_queue feedback_queue;
+
+	/** The source of the feedback piggybacked in front of the ROHC packets */
+	struct rohc_comp_feedback_source feedback_source;
+
+	/** The recorder of the inputs of the compressor, see
+	 *  rohc_comp_set_recorder() */
+	struct rohc_recorder recorder;
 
 
 	/* variables related to RTP detection */
@@ -164,16 +557,31 @@ struct rohc_comp
 	rohc_rtp_detection_callback_t rtp_callback;
 	/** Pointer to an external memory area provided/used by the callback user */
 	void *rtp_private;
+	/** The built-in RTP detection used when no callback is set, NULL if no
+	 *  UDP port is reserved for RTP */
+	struct rohc_comp_rtp_detect *rtp_detect;
 
 
 	/* some statistics about the compression process: */
 
+	/** The sequence lock that lets other threads read the statistics of the
+	 *  compressor and of its contexts while packets are compressed */
+	rohc_seqlock_t stats_seq;
 	/** The number of sent packets */
 	int num_packets;
 	/** The size of all the received uncompressed IP packets */
 	int total_uncompressed_size;
 	/** The size of all the sent compressed ROHC packets */
 	int total_compressed_size;
+	/** The counters of the sent packets, per profile and per packet type */
+	rohc_packet_stats_t pkt_stats;
+	/** The histograms of the processing time of the sent packets, NULL until
+	 *  the \ref ROHC_COMP_FEATURE_LATENCY feature is enabled */
+	struct rohc_latency *latency;
+#ifdef ROHC_STAGE_CYCLES
+	/** The CPU cycles spent in every stage of the compression */
+	ROHC_STAGE_CYCLES_DEFINE(ROHC_COMP_STAGE_MAX) stage_cycles;
+#endif
 
 	/** The last context used by the compressor */
 	struct rohc_comp_ctxt *last_context;
@@ -197,6 +605,12 @@ struct rohc_comp
 	/** The maximal number of packets sent in > FO states (= SO state)
 	 *  before changing back the state to FO (periodic refreshes) */
 	size_t periodic_refreshes_fo_timeout;
+	/** The maximal time (in milliseconds) spent in > IR states before
+	 *  changing back the state to IR (periodic refreshes), 0 if disabled */
+	size_t periodic_refreshes_ir_time;
+	/** The maximal time (in milliseconds) spent in > FO states before
+	 *  changing back the state to FO (periodic refreshes), 0 if disabled */
+	size_t periodic_refreshes_fo_time;
 	/** Maximum Reconstructed Reception Unit */
 	size_t mrru;
 	/** The connection type (currently not used) */
@@ -208,6 +622,97 @@ struct rohc_comp
 	rohc_trace_callback2_t trace_callback;
 	/** The private context of the callback function used to manage traces */
 	void *trace_callback_priv;
+	/** The lowest level of the traces passed to the callback function */
+	rohc_trace_level_t trace_level;
+	/** The ring of binary trace records, disabled by default */
+	struct rohc_trace_ring trace_ring;
+
+	/** The shared configuration the compressor was created from, NULL if the
+	 *  compressor was created with \ref rohc_comp_new2 */
+	struct rohc_comp_config *config;
+};
+
+
+/**
+ * @brief The configuration shared by several ROHC compressors
+ *
+ * The configuration is built once, then referenced by every compressor
+ * created from it with \ref rohc_comp_new_from_config. It becomes immutable
+ * as soon as one compressor references it, so that many compressors (one per
+ * core for example) may share it without any lock. The configuration is
+ * freed when its last reference is dropped.
+ */
+struct rohc_comp_config
+{
+	/** The number of references to the configuration: one for its creator
+	 *  plus one per compressor created from it */
+	size_t refs_nr;
+
+	/** The type of CIDs of the compressors */
+	rohc_cid_type_t cid_type;
+	/** The MAX_CID of the compressors */
+	rohc_cid_t max_cid;
+	/** Which profiles are enabled and with one are not? */
+	bool enabled_profiles[C_NUM_PROFILES];
+	/** The width of the W-LSB sliding window */
+	size_t wlsb_window_width;
+	/** The number of context bodies allocated in advance per profile */
+	size_t ctxts_prealloc_nr;
+	/** The NUMA node of the compressors */
+	int numa_node;
+	/** The timeout for IR periodic refreshes */
+	size_t periodic_refreshes_ir_timeout;
+	/** The timeout for FO periodic refreshes */
+	size_t periodic_refreshes_fo_timeout;
+	/** Maximum Reconstructed Reception Unit */
+	size_t mrru;
+	/** The callback function used to detect RTP packet */
+	rohc_rtp_detection_callback_t rtp_callback;
+	/** Pointer to an external memory area provided/used by the callback user */
+	void *rtp_private;
+};
+
+
+/**
+ * @brief A group of ROHC compressors that share one CID space
+ *
+ * The CID space [0, MAX_CID] is split into contiguous ranges, one range per
+ * shard: every shard is a complete ROHC compressor that owns the contexts of
+ * its range exclusively. The shards may thus be run on different cores
+ * without any lock as long as every packet of one flow is given to the same
+ * shard.
+ */
+struct rohc_comp_group
+{
+	/** The number of shards in the group */
+	size_t shards_nr;
+	/** The number of CIDs in the range of every shard, the last shard also
+	 *  gets the remaining CIDs */
+	size_t shard_cids_nr;
+	/** The shards of the group */
+	struct rohc_comp **shards;
+};
+
+
+/**
+ * @brief The fields of the packets that the key of the contexts of one
+ *        profile hashes
+ *
+ * The key only filters the contexts before the profile compares the packet
+ * with them, so it shall not hash more fields than the profile compares:
+ * a packet that the profile would give to a context shall always get the
+ * key of the context.
+ */
+enum rohc_comp_key_type
+{
+	/** The outer IP addresses in any order (see \ref net_pkt::hosts_key) */
+	ROHC_COMP_KEY_HOSTS = 0,
+	/** The addresses of all the IP headers and the transport protocol
+	 *  (see \ref net_pkt::ip_key) */
+	ROHC_COMP_KEY_IP    = 1,
+	/** The addresses of all the IP headers, the transport protocol, and the
+	 *  ports or the SPI (see \ref net_pkt::key) */
+	ROHC_COMP_KEY_FLOW  = 2,
 };
 
 
@@ -228,6 +733,12 @@ struct rohc_comp_profile
 	 */
 	const unsigned short protocol;
 
+	/**
+	 * @brief The fields of the packets that the key of the contexts hashes,
+	 *        the outer IP addresses only if not given
+	 */
+	const enum rohc_comp_key_type key_type;
+
 	/**
 	 * @brief The handler used to create the profile-specific part of the
 	 *        compression context
@@ -236,6 +747,16 @@ struct rohc_comp_profile
 	               const struct net_pkt *const packet)
 		__attribute__((warn_unused_result, nonnull(1, 2)));
 
+	/**
+	 * @brief The handler used to create the profile-specific part of the
+	 *        compression context from the context of another flow with the
+	 *        same IP headers, NULL if the profile cannot clone its contexts
+	 */
+	bool (*clone)(struct rohc_comp_ctxt *const context,
+	              const struct rohc_comp_ctxt *const src_ctxt,
+	              const struct net_pkt *const packet)
+		__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+
 	/**
 	 * @brief The handler used to destroy the profile-specific part of the
 	 *        compression context
@@ -243,6 +764,31 @@ struct rohc_comp_profile
 	void (*destroy)(struct rohc_comp_ctxt *const context)
 		__attribute__((nonnull(1)));
 
+	/**
+	 * @brief The handler used to get the size of the body of the contexts,
+	 *        i.e. the profile-specific part allocated in one single block
+	 *        with \ref rohc_comp_ctxt_body_alloc, NULL if the profile
+	 *        allocates no body for its contexts
+	 */
+	size_t (*get_body_size)(const struct rohc_comp *const comp)
+		__attribute__((warn_unused_result, nonnull(1)));
+
+	/**
+	 * @brief Whether the profile allocates nothing for its contexts but their
+	 *        body, so that its contexts may be created without allocating
+	 *        memory once their bodies are prepared
+	 */
+	const bool body_only;
+
+	/**
+	 * @brief The handler used to get the memory used by the profile-specific
+	 *        part of the compression context, NULL if the profile allocates
+	 *        nothing for its contexts
+	 */
+	void (*get_mem)(const struct rohc_comp_ctxt *const context,
+	                struct rohc_ctxt_mem *const mem)
+		__attribute__((nonnull(1, 2)));
+
 	/**
 	 * @brief The handler used to check whether an uncompressed IP packet
 	 *        fits the current profile or not
@@ -297,34 +843,87 @@ struct rohc_comp_profile
 	                 const uint8_t *const feedback_data,
 	                 const size_t feedback_data_len)
 		__attribute__((warn_unused_result, nonnull(1, 3, 5)));
+
+	/**
+	 * @brief The handler used to change the number of entries that the W-LSB
+	 *        windows of the context keep, NULL if the profile has no window
+	 *        to adapt (see \ref ROHC_COMP_FEATURE_ADAPTIVE_WLSB)
+	 */
+	void (*set_wlsb_width)(struct rohc_comp_ctxt *const context,
+	                       const size_t width)
+		__attribute__((nonnull(1)));
+
+	/**
+	 * @brief The handler used to write the profile-specific part of the
+	 *        context in a snapshot, NULL if the profile cannot be saved
+	 */
+	bool (*snapshot)(const struct rohc_comp_ctxt *const context,
+	                 const rohc_snapshot_write_t write_cb,
+	                 void *const priv)
+		__attribute__((warn_unused_result, nonnull(1, 2)));
+
+	/**
+	 * @brief The handler used to re-build the profile-specific part of the
+	 *        context from a snapshot, NULL if the profile cannot be restored
+	 */
+	bool (*restore)(struct rohc_comp_ctxt *const context,
+	                const rohc_snapshot_read_t read_cb,
+	                void *const priv)
+		__attribute__((warn_unused_result, nonnull(1, 2)));
+};
+
+
+/** The max length of the IR header part whose CRC may be cached */
+#define ROHC_COMP_IR_CRC_CACHE_MAX_LEN  128U
+
+/**
+ * @brief The CRC-8 of the IR header up to the end of the static chain
+ *
+ * The bytes of the IR header before the dynamic chain (CID, packet type,
+ * profile ID, empty CRC field and static chain) do not change between the
+ * periodic refreshes of one context, so their CRC may be computed only once.
+ * The bytes are kept to check that the cached CRC still matches them.
+ */
+struct rohc_comp_ir_crc_cache
+{
+	/** The IR header bytes up to the end of the static chain */
+	uint8_t bytes[ROHC_COMP_IR_CRC_CACHE_MAX_LEN];
+	/** The number of cached IR header bytes, 0 if no CRC is cached */
+	size_t len;
+	/** The CRC-8 computed over the cached IR header bytes */
+	uint8_t crc;
 };
 
 
 /**
  * @brief The ROHC compression context
+ *
+ * The fields are ordered by access frequency: the first cache line holds
+ * the fields that the context lookup and the compression of every packet
+ * read, the next ones hold the per-packet counters and statistics, and the
+ * rest is only used by IR packets or when the context is created.
  */
 struct rohc_comp_ctxt
 {
-	/** Whether the context is in use or not */
-	int used;
-	/** The time when the context was created (in seconds) */
-	uint64_t latest_used;
-	/** The time when the context was last used (in seconds) */
-	uint64_t first_used;
-
-	/** The context unique ID (CID) */
-	rohc_cid_t cid;
+	/* hot fields: read by every packet, the context lookup reads their copy
+	 * in the compressor (see struct rohc_comp_ctxt_hot) */
 
+	/** The associated profile */
+	const struct rohc_comp_profile *profile;
 	/** The key to help finding the context associated with a packet */
 	rohc_ctxt_key_t key; /* may not be unique */
-
+	/** The identity of the flow of the packet that created the context, for
+	 *  the profiles to recognize the packets of the context at once */
+	struct net_pkt_flow flow;
+	/** Whether the context is in use or not */
+	int used;
+	/** Profile-specific data, defined by the profiles */
+	void *specific;
 	/** The associated compressor */
 	struct rohc_comp *compressor;
 
-	/** The associated profile */
-	const struct rohc_comp_profile *profile;
-	/** Profile-specific data, defined by the profiles */
-	void *specific;
+	/** The context unique ID (CID) */
+	rohc_cid_t cid;
 
 	/** The operation mode in which the context operates among:
 	 *  ROHC_U_MODE, ROHC_O_MODE, ROHC_R_MODE */
@@ -332,11 +931,21 @@ struct rohc_comp_ctxt
 	/** The operation state in which the context operates: IR, FO, SO */
 	rohc_comp_state_t state;
 
-	/* below are some statistics */
-
 	/* The type of ROHC packet created for the last compressed packet */
 	rohc_packet_t packet_type;
 
+	/** The time when the context was last used (in seconds) */
+	uint64_t latest_used;
+	/** The arrival time of the packet being compressed with the context */
+	struct rohc_ts arrival_time;
+
+	/* warm fields: updated once by every packet */
+
+	/** The context used just before this one (LRU list of the compressor) */
+	struct rohc_comp_ctxt *lru_prev;
+	/** The context used just after this one (LRU list of the compressor) */
+	struct rohc_comp_ctxt *lru_next;
+
 	/** The number of packets sent while in Initialization & Refresh (IR) state */
 	size_t ir_count;
 	/** The number of packets sent while in First Order (FO) state */
@@ -356,6 +965,48 @@ struct rohc_comp_ctxt
 	 * @see rohc_comp_periodic_down_transition
 	 */
 	size_t go_back_ir_count;
+	/**
+	 * @brief The number of packets before the next periodic refresh is
+	 *        checked, so that most packets only decrement it
+	 * @see rohc_comp_periodic_down_transition
+	 */
+	size_t go_back_countdown;
+	/**
+	 * @brief The value of the countdown when it was armed: the packets counted
+	 *        down since then are not added to the two counters above yet
+	 */
+	size_t go_back_countdown_init;
+	/**
+	 * @brief The time of the last change to FO or IR state, used for the
+	 *        time-based periodic refreshes of the context
+	 * @see rohc_comp_periodic_down_transition
+	 */
+	struct rohc_ts go_back_fo_time;
+	/**
+	 * @brief The time of the last change to IR state, used for the
+	 *        time-based periodic refreshes of the context
+	 * @see rohc_comp_periodic_down_transition
+	 */
+	struct rohc_ts go_back_ir_time;
+
+	/** The number of sent packets */
+	int num_sent_packets;
+
+	/** The number of entries that the W-LSB windows of the context keep, less
+	 *  than the width set for the compressor once feedback showed that the
+	 *  packets of the context are reliably delivered */
+	size_t wlsb_width;
+	/** The number of packets sent since the W-LSB windows of the context were
+	 *  narrowed or widened, without any feedback meanwhile */
+	size_t wlsb_silence_nr;
+
+#if ROHC_SMALL_CONTEXTS != 1
+	/* below are some statistics, not kept by small contexts */
+
+	/** The number of packets sent in every state since the context was
+	 *  created, indexed by state (the counters above are reset upon every
+	 *  state change) */
+	unsigned long state_packets_nr[ROHC_COMP_STATE_SO + 1];
 
 	/** The average size of the uncompressed packets */
 	int total_uncompressed_size;
@@ -374,9 +1025,65 @@ struct rohc_comp_ctxt
 	int header_last_uncompressed_size;
 	/** The header size of the last compressed packet */
 	int header_last_compressed_size;
+#endif
 
-	/** The number of sent packets */
-	int num_sent_packets;
+	/* cold fields: IR packets and context creation */
+
+	/** The time when the context was created (in seconds) */
+	uint64_t first_used;
+
+	/** The memory used by the profile-specific part of the context */
+	struct rohc_ctxt_mem mem;
+
+	/** The CRC of the IR header up to the end of the static chain */
+	struct rohc_comp_ir_crc_cache ir_crc_cache;
+};
+
+
+/** The generic part of the record of one compression context in a snapshot,
+ *  followed by the profile-specific part */
+struct rohc_comp_snapshot_ctxt
+{
+	uint16_t profile_id;        /**< The profile of the context */
+	uint16_t cid;               /**< The CID of the context */
+	uint8_t mode;               /**< The operation mode of the context */
+	uint8_t state;              /**< The operation state of the context */
+	uint16_t reserved;          /**< Always 0 */
+	uint32_t key;               /**< The key of the context */
+	uint32_t ir_count;          /**< The number of packets sent in IR state */
+	uint32_t fo_count;          /**< The number of packets sent in FO state */
+	uint32_t so_count;          /**< The number of packets sent in SO state */
+	uint32_t go_back_fo_count;  /**< The counter for FO periodic refreshes */
+	uint32_t go_back_ir_count;  /**< The counter for IR periodic refreshes */
+	uint32_t num_sent_packets;  /**< The number of sent packets */
+	uint64_t first_used;        /**< When the context was created */
+	uint64_t latest_used;       /**< When the context was last used */
+} __attribute__((packed));
+
+
+/**
+ * @brief A compression context detached from its compressor
+ *
+ * The context is moved as a whole, profile-specific part included. The
+ * settings of the source compressor that the profile-specific part depends
+ * on are recorded to check that the destination compressor shares them.
+ */
+struct rohc_comp_ctxt_export
+{
+	/** The detached context, not linked to any compressor */
+	struct rohc_comp_ctxt ctxt;
+	/** The width of the W-LSB sliding window of the source compressor */
+	size_t wlsb_window_width;
+	/** The number of uncompressed transmissions for list compression of the
+	 *  source compressor */
+	size_t list_trans_nr;
+	/** The callback function used to manage traces of the source compressor */
+	rohc_trace_callback2_t trace_callback;
+	/** The private context of the callback function used to manage traces of
+	 *  the source compressor */
+	void *trace_callback_priv;
+	/** The lowest level of the traces of the source compressor */
+	rohc_trace_level_t trace_level;
 };
 
 
@@ -391,9 +1098,34 @@ void rohc_comp_change_state(struct rohc_comp_ctxt *const context,
 void rohc_comp_periodic_down_transition(struct rohc_comp_ctxt *const context)
 	__attribute__((nonnull(1)));
 
+void rohc_comp_wlsb_feedback(struct rohc_comp_ctxt *const context,
+                             const bool is_ack)
+	__attribute__((nonnull(1)));
+
 bool rohc_comp_reinit_context(struct rohc_comp_ctxt *const context)
 	__attribute__((warn_unused_result, nonnull(1)));
 
+void * rohc_comp_ctxt_body_alloc(const struct rohc_comp_ctxt *const context,
+                                 const size_t size)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+void rohc_comp_ctxt_body_free(const struct rohc_comp_ctxt *const context,
+                              void *const body)
+	__attribute__((nonnull(1)));
+
+bool rohc_comp_rtp_detect(const struct rohc_comp *const comp,
+                          const struct net_pkt *const packet,
+                          const uint8_t *const udp,
+                          const uint8_t *const payload,
+                          const size_t payload_len)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4)));
+
+uint8_t rohc_comp_ir_crc(struct rohc_comp_ctxt *const context,
+                         const uint8_t *const ir_hdr,
+                         const size_t static_chain_end,
+                         const size_t ir_hdr_len)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
 bool rohc_comp_feedback_parse_opts(const struct rohc_comp_ctxt *const context,
                                    const uint8_t *const packet,
                                    const size_t packet_len,
@@ -406,5 +1138,10 @@ bool rohc_comp_feedback_parse_opts(const struct rohc_comp_ctxt *const context,
                                    size_t crc_pos_from_end)
 	__attribute__((warn_unused_result, nonnull(1, 2, 4, 6, 7, 8)));
 
+void * rohc_comp_set_feedback_source(struct rohc_comp *const comp,
+                                     const rohc_comp_feedback_source_t cb,
+                                     void *const priv)
+	__attribute__((nonnull(1)));
+
 #endif
 
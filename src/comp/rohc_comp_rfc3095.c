@@ -69,27 +69,56 @@
 #define MOD_IPV6_EXT_LIST_CONTENT 0x0004
 /** A flag to indicate that an errror occurred */
 #define MOD_ERROR 0x0008
+/** A flag to indicate that the IPv4 Don't Fragment flag changed in IP header */
+#define MOD_DF        0x0040
+
+
+/**
+ * The bits of the fixed IPv4 header that are checked for change by
+ * \ref detect_changed_fields: TOS, DF, TTL and Protocol
+ */
+static const uint8_t rfc3095_ipv4_changed_mask[16] =
+{
+	0x00, 0xff, 0x00, 0x00, 0x00, 0x00, 0x40, 0x00,
+	0xff, 0xff, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+};
+
+/**
+ * The bits of the fixed IPv6 header that are checked for change by
+ * \ref detect_changed_fields: TC and Hop Limit
+ */
+static const uint8_t rfc3095_ipv6_changed_mask[8] =
+{
+	0x0f, 0xf0, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff
+};
 
 
 /*
  * Prototypes of main private functions
  */
 
-static bool ip_header_info_new(struct ip_header_info *const header_info,
+static void ip_header_info_new(struct ip_header_info *const header_info,
                                const struct ip_packet *const ip,
                                const size_t list_trans_nr,
                                const size_t wlsb_window_width,
+                               void *const ip_id_wlsb_mem,
                                rohc_trace_callback2_t trace_cb,
                                void *const trace_cb_priv,
+                               const rohc_trace_level_t trace_level,
                                const int profile_id)
-	__attribute__((warn_unused_result, nonnull(1, 2)));
+	__attribute__((nonnull(1, 2, 5)));
 static void ip_header_info_free(struct ip_header_info *const header_info)
 	__attribute__((nonnull(1)));
 
 static void c_init_tmp_variables(struct generic_tmp_vars *const tmp_vars);
 
+static void rohc_comp_rfc3095_init_handlers(struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt)
+	__attribute__((nonnull(1)));
+
 static rohc_packet_t decide_packet(struct rohc_comp_ctxt *const context)
 	__attribute__((warn_unused_result, nonnull(1)));
+static rohc_packet_t decide_SO_packet_cached(struct rohc_comp_ctxt *const context)
+	__attribute__((warn_unused_result, nonnull(1)));
 
 static rohc_ext_t decide_extension_uor2(const struct rohc_comp_ctxt *const context,
                                         const size_t nr_innermost_ip_id_bits,
@@ -309,12 +338,13 @@ static int header_fields(const struct rohc_comp_ctxt *const context,
                          int counter)
 	__attribute__((warn_unused_result, nonnull(1, 2, 4, 7)));
 
-static uint8_t compute_uo_crc(const struct rohc_comp_rfc3095_ctxt *rfc3095_ctxt,
+static uint8_t compute_uo_crc(struct rohc_comp_ctxt *const context,
                               const struct net_pkt *const uncomp_pkt,
+                              const bool crc_static_changed,
                               const rohc_crc_type_t crc_type,
                               const uint8_t crc_init,
                               const uint8_t *const crc_table)
-	__attribute__((warn_unused_result, nonnull(1, 2, 5)));
+	__attribute__((warn_unused_result, nonnull(1, 2, 6)));
 
 static void update_context(struct rohc_comp_ctxt *const context,
                            const struct net_pkt *const uncomp_pkt)
@@ -343,11 +373,17 @@ static int changed_dynamic_one_hdr(struct rohc_comp_ctxt *const context,
 	__attribute__((warn_unused_result, nonnull(1, 3, 4)));
 static unsigned short detect_changed_fields(const struct rohc_comp_ctxt *const context,
                                             struct ip_header_info *const header_info, /* TODO: add const */
-                                            const struct ip_packet *const ip)
+                                            const struct ip_packet *const ip,
+                                            const struct net_pkt_ip *const ip_desc)
 	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
 static bool is_field_changed(const unsigned short changed_fields,
                              const unsigned short check_field)
 	__attribute__((warn_unused_result, const));
+static bool rfc3095_are_hdrs_equal_masked(const uint8_t *const hdr1,
+                                           const uint8_t *const hdr2,
+                                           const uint8_t *const mask,
+                                           const size_t len)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3), pure));
 static void detect_ip_id_behaviours(struct rohc_comp_ctxt *const context,
                                     const struct net_pkt *const uncomp_pkt)
 	__attribute__((nonnull(1, 2)));
@@ -413,6 +449,43 @@ static bool is_field_changed(const unsigned short changed_fields,
 }
 
 
+/**
+ * @brief Compare two headers on the bits selected by a mask only
+ *
+ * The headers are compared 64 bits at a time.
+ *
+ * @param hdr1  The first header
+ * @param hdr2  The second header
+ * @param mask  The bits to compare, the \e len first bytes are used
+ * @param len   The number of bytes to compare, a multiple of 8
+ * @return      true if the selected bits are the same, false otherwise
+ */
+static bool rfc3095_are_hdrs_equal_masked(const uint8_t *const hdr1,
+                                           const uint8_t *const hdr2,
+                                           const uint8_t *const mask,
+                                           const size_t len)
+{
+	uint64_t diff = 0;
+	size_t i;
+
+	assert((len % sizeof(uint64_t)) == 0);
+
+	for(i = 0; i < len; i += sizeof(uint64_t))
+	{
+		uint64_t val1;
+		uint64_t val2;
+		uint64_t val_mask;
+
+		memcpy(&val1, hdr1 + i, sizeof(uint64_t));
+		memcpy(&val2, hdr2 + i, sizeof(uint64_t));
+		memcpy(&val_mask, mask + i, sizeof(uint64_t));
+		diff |= (val1 ^ val2) & val_mask;
+	}
+
+	return (diff == 0);
+}
+
+
 /**
  * @brief Initialize the IP header info stored in the context
  *
@@ -422,17 +495,21 @@ static bool is_field_changed(const unsigned short changed_fields,
  *                           list compression (L)
  * @param wlsb_window_width  The width of the W-LSB sliding window for IPv4
  *                           IP-ID (must be > 0)
+ * @param ip_id_wlsb_mem     The memory reserved for the W-LSB encoding object
+ *                           of the IPv4 IP-ID
  * @param trace_cb           The function to call for printing traces
  * @param trace_cb_priv      An optional private context, may be NULL
+ * @param trace_level        The lowest level of the traces to print
  * @param profile_id         The ID of the associated compression profile
- * @return                   true if successful, false otherwise
  */
-static bool ip_header_info_new(struct ip_header_info *const header_info,
+static void ip_header_info_new(struct ip_header_info *const header_info,
                                const struct ip_packet *const ip,
                                const size_t list_trans_nr,
                                const size_t wlsb_window_width,
+                               void *const ip_id_wlsb_mem,
                                rohc_trace_callback2_t trace_cb,
                                void *const trace_cb_priv,
+                               const rohc_trace_level_t trace_level,
                                const int profile_id)
 {
 	assert(header_info != NULL);
@@ -451,14 +528,8 @@ static bool ip_header_info_new(struct ip_header_info *const header_info,
 	{
 		/* init the parameters to encode the IP-ID with W-LSB encoding */
 		header_info->info.v4.ip_id_window =
-			c_create_wlsb(16, wlsb_window_width, ROHC_LSB_SHIFT_IP_ID);
-		if(header_info->info.v4.ip_id_window == NULL)
-		{
-			__rohc_print(trace_cb, trace_cb_priv, ROHC_TRACE_ERROR,
-			             ROHC_TRACE_COMP, profile_id,
-			             "no memory to allocate W-LSB encoding for IP-ID");
-			goto error;
-		}
+			c_init_wlsb(ip_id_wlsb_mem, 16, wlsb_window_width,
+			            ROHC_LSB_SHIFT_IP_ID);
 
 		/* init the thresholds the counters must reach before launching
 		 * an action */
@@ -473,14 +544,11 @@ static bool ip_header_info_new(struct ip_header_info *const header_info,
 	else
 	{
 		/* init the compression context for IPv6 extension header list */
-		rohc_comp_list_ipv6_new(&header_info->info.v6.ext_comp, list_trans_nr,
-		                        trace_cb, trace_cb_priv, profile_id);
+		rohc_comp_list_ipv6_new(&header_info->info.v6.ext_comp,
+		                        &header_info->info.v6.ext_mem, list_trans_nr,
+		                        trace_cb, trace_cb_priv, trace_level,
+		                        profile_id);
 	}
-
-	return true;
-
-error:
-	return false;
 }
 
 
@@ -491,14 +559,11 @@ error:
  */
 static void ip_header_info_free(struct ip_header_info *const header_info)
 {
-	if(header_info->version == IPV4)
+	/* IPv4: the W-LSB context for the IP-ID offset is stored in the memory
+	 *       block of the context, nothing to free
+	 * IPv6: destroy the list of IPv6 extension headers */
+	if(header_info->version != IPV4)
 	{
-		/* IPv4: destroy the W-LSB context for the IP-ID offset */
-		c_destroy_wlsb(header_info->info.v4.ip_id_window);
-	}
-	else
-	{
-		/* IPv6: destroy the list of IPv6 extension headers */
 		rohc_comp_list_ipv6_free(&header_info->info.v6.ext_comp);
 	}
 }
@@ -547,8 +612,11 @@ bool rohc_comp_rfc3095_create(struct rohc_comp_ctxt *const context,
 
 	rohc_comp_debug(context, "new generic context required for a new stream");
 
-	/* allocate memory for the generic part of the context */
-	rfc3095_ctxt = malloc(sizeof(struct rohc_comp_rfc3095_ctxt));
+	/* allocate memory for the generic part of the context, its W-LSB
+	 * encoding objects and the profile-specific part at once */
+	rfc3095_ctxt =
+		rohc_comp_ctxt_body_alloc(context,
+		                          context->profile->get_body_size(context->compressor));
 	if(rfc3095_ctxt == NULL)
 	{
 		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
@@ -569,38 +637,34 @@ bool rohc_comp_rfc3095_create(struct rohc_comp_ctxt *const context,
 	/* step 1 */
 	rohc_comp_debug(context, "use shift parameter %d for LSB-encoding of SN",
 	                sn_shift);
+	rfc3095_ctxt->wlsb_size =
+		c_wlsb_size(context->compressor->wlsb_window_width);
+	rfc3095_ctxt->wlsb_mem = (uint8_t *) (rfc3095_ctxt + 1);
 	rfc3095_ctxt->sn_window =
-		c_create_wlsb(16, context->compressor->wlsb_window_width, sn_shift);
-	if(rfc3095_ctxt->sn_window == NULL)
-	{
-		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
-		           "no memory to allocate W-LSB encoding for SN");
-		goto free_generic_context;
-	}
+		c_init_wlsb(rfc3095_ctxt->wlsb_mem, 16,
+		            context->compressor->wlsb_window_width, sn_shift);
 
 	/* step 3 */
-	if(!ip_header_info_new(&rfc3095_ctxt->outer_ip_flags,
-	                       &packet->outer_ip,
-	                       context->compressor->list_trans_nr,
-	                       context->compressor->wlsb_window_width,
-	                       context->compressor->trace_callback,
-	                       context->compressor->trace_callback_priv,
-	                       context->profile->id))
-	{
-		goto free_sn_window;
-	}
+	ip_header_info_new(&rfc3095_ctxt->outer_ip_flags,
+	                   &packet->outer_ip,
+	                   context->compressor->list_trans_nr,
+	                   context->compressor->wlsb_window_width,
+	                   rfc3095_ctxt->wlsb_mem + rfc3095_ctxt->wlsb_size,
+	                   context->compressor->trace_callback,
+	                   context->compressor->trace_callback_priv,
+	                   context->compressor->trace_level,
+	                   context->profile->id);
 	if(packet->ip_hdr_nr > 1)
 	{
-		if(!ip_header_info_new(&rfc3095_ctxt->inner_ip_flags,
-		                       &packet->inner_ip,
-		                       context->compressor->list_trans_nr,
-		                       context->compressor->wlsb_window_width,
-		                       context->compressor->trace_callback,
-		                       context->compressor->trace_callback_priv,
-		                       context->profile->id))
-		{
-			goto free_header_info;
-		}
+		ip_header_info_new(&rfc3095_ctxt->inner_ip_flags,
+		                   &packet->inner_ip,
+		                   context->compressor->list_trans_nr,
+		                   context->compressor->wlsb_window_width,
+		                   rfc3095_ctxt->wlsb_mem + rfc3095_ctxt->wlsb_size * 2,
+		                   context->compressor->trace_callback,
+		                   context->compressor->trace_callback_priv,
+		                   context->compressor->trace_level,
+		                   context->profile->id);
 		rfc3095_ctxt->ip_hdr_nr = 2;
 	}
 	else
@@ -611,10 +675,39 @@ bool rohc_comp_rfc3095_create(struct rohc_comp_ctxt *const context,
 	/* step 4 */
 	c_init_tmp_variables(&rfc3095_ctxt->tmp);
 
-	/* step 5 */
-	rfc3095_ctxt->specific = NULL;
+	/* step 5: the profile-specific part follows the W-LSB encoding objects */
+	if(context->profile->get_body_size(context->compressor) >
+	   rohc_comp_rfc3095_get_body_size(context->compressor))
+	{
+		rfc3095_ctxt->specific = rfc3095_ctxt->wlsb_mem + rfc3095_ctxt->wlsb_size * 3;
+	}
+	else
+	{
+		rfc3095_ctxt->specific = NULL;
+	}
 	rfc3095_ctxt->next_header_proto = packet->transport->proto;
 	rfc3095_ctxt->next_header_len = 0;
+	rfc3095_ctxt->is_SO_decision_cacheable = false;
+	rfc3095_ctxt->last_SO_decision.is_valid = false;
+	rohc_comp_rfc3095_init_handlers(rfc3095_ctxt);
+
+	return true;
+
+quit:
+	return false;
+}
+
+
+/**
+ * @brief Set the default handlers of the generic part of one context
+ *
+ * The profiles override the handlers they need.
+ *
+ * @param rfc3095_ctxt  The generic part of the context
+ */
+static void rohc_comp_rfc3095_init_handlers(struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt)
+{
+	rfc3095_ctxt->encode_uncomp_fields = NULL;
 	rfc3095_ctxt->decide_state = rohc_comp_rfc3095_decide_state;
 	rfc3095_ctxt->decide_FO_packet = NULL;
 	rfc3095_ctxt->decide_SO_packet = NULL;
@@ -623,20 +716,204 @@ bool rohc_comp_rfc3095_create(struct rohc_comp_ctxt *const context,
 	rfc3095_ctxt->get_next_sn = NULL;
 	rfc3095_ctxt->code_static_part = NULL;
 	rfc3095_ctxt->code_dynamic_part = NULL;
+	rfc3095_ctxt->code_ir_remainder = NULL;
 	rfc3095_ctxt->code_UO_packet_head = NULL;
 	rfc3095_ctxt->code_uo_remainder = NULL;
 	rfc3095_ctxt->compute_crc_static = compute_crc_static;
 	rfc3095_ctxt->compute_crc_dynamic = compute_crc_dynamic;
+}
+
+
+/**
+ * @brief Save the generic part of one context in a snapshot
+ *
+ * The body of the context is saved as it is in memory, preceded by the
+ * lengths of its generic part and of the whole body, so that a snapshot
+ * from another build or with another W-LSB window width is detected at
+ * restoration. The lists of IPv6 extension headers follow, list by list.
+ * The profiles shall save the lists of their specific part after.
+ *
+ * @param context   The compression context
+ * @param write_cb  The callback used to write the snapshot
+ * @param priv      The private context given to the callback
+ * @return          true if the context was successfully saved,
+ *                  false if the callback failed
+ */
+bool rohc_comp_rfc3095_snapshot(const struct rohc_comp_ctxt *const context,
+                                const rohc_snapshot_write_t write_cb,
+                                void *const priv)
+{
+	const struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt = context->specific;
+	const size_t body_size = context->profile->get_body_size(context->compressor);
+	const uint32_t lens[2] = { sizeof(struct rohc_comp_rfc3095_ctxt), body_size };
+
+	if(!write_cb(priv, (const uint8_t *) lens, sizeof(lens)) ||
+	   !write_cb(priv, (const uint8_t *) rfc3095_ctxt, body_size))
+	{
+		goto error;
+	}
+	if(rfc3095_ctxt->outer_ip_flags.version == IPV6 &&
+	   !rohc_comp_list_snapshot(&rfc3095_ctxt->outer_ip_flags.info.v6.ext_comp,
+	                            write_cb, priv))
+	{
+		goto error;
+	}
+	if(rfc3095_ctxt->ip_hdr_nr > 1 &&
+	   rfc3095_ctxt->inner_ip_flags.version == IPV6 &&
+	   !rohc_comp_list_snapshot(&rfc3095_ctxt->inner_ip_flags.info.v6.ext_comp,
+	                            write_cb, priv))
+	{
+		goto error;
+	}
 
 	return true;
 
-free_header_info:
-	ip_header_info_free(&rfc3095_ctxt->outer_ip_flags);
-free_sn_window:
-	c_destroy_wlsb(rfc3095_ctxt->sn_window);
-free_generic_context:
-	free(rfc3095_ctxt);
-quit:
+error:
+	return false;
+}
+
+
+/**
+ * @brief Restore the generic part of one context from a snapshot
+ *
+ * The W-LSB encoding objects of the saved context are moved to the new
+ * body, at the same offsets. Their windows are checked against the width
+ * configured for the compressor before they are used again. The handlers
+ * are reset to their defaults, the profiles shall set theirs again and
+ * restore the lists of their specific part after.
+ *
+ * @param context  The compression context
+ * @param read_cb  The callback used to read the snapshot
+ * @param priv     The private context given to the callback
+ * @return         true if the context was successfully restored,
+ *                 false if the snapshot does not match the context
+ */
+bool rohc_comp_rfc3095_restore(struct rohc_comp_ctxt *const context,
+                               const rohc_snapshot_read_t read_cb,
+                               void *const priv)
+{
+	const struct rohc_comp *const comp = context->compressor;
+	const size_t width = comp->wlsb_window_width;
+	const size_t body_size = context->profile->get_body_size(comp);
+	struct rohc_comp_rfc3095_ctxt *rfc3095_ctxt;
+	bool is_list_init[2] = { false, false };
+	uint32_t lens[2];
+	size_t i;
+
+	if(!read_cb(priv, (uint8_t *) lens, sizeof(lens)))
+	{
+		goto error;
+	}
+	if(lens[0] != sizeof(struct rohc_comp_rfc3095_ctxt) || lens[1] != body_size)
+	{
+		rohc_comp_warn(context, "context in snapshot does not match the "
+		               "compressor: %u/%u bytes instead of %zu/%zu bytes",
+		               lens[0], lens[1], sizeof(struct rohc_comp_rfc3095_ctxt),
+		               body_size);
+		goto error;
+	}
+
+	rfc3095_ctxt = rohc_comp_ctxt_body_alloc(context, body_size);
+	if(rfc3095_ctxt == NULL)
+	{
+		goto error;
+	}
+	if(!read_cb(priv, (uint8_t *) rfc3095_ctxt, body_size))
+	{
+		goto free_body;
+	}
+	if(rfc3095_ctxt->wlsb_size != c_wlsb_size(width) ||
+	   rfc3095_ctxt->ip_hdr_nr < 1 || rfc3095_ctxt->ip_hdr_nr > 2)
+	{
+		rohc_comp_warn(context, "malformed context in snapshot: %zu IP headers",
+		               rfc3095_ctxt->ip_hdr_nr);
+		goto free_body;
+	}
+
+	/* the W-LSB objects are at the same offsets in the new body as in
+	 * rohc_comp_rfc3095_create(), their windows shall match the configured
+	 * width */
+	rfc3095_ctxt->wlsb_mem = (uint8_t *) (rfc3095_ctxt + 1);
+	rfc3095_ctxt->sn_window = (struct c_wlsb *) rfc3095_ctxt->wlsb_mem;
+	if(!c_wlsb_relocate(rfc3095_ctxt->sn_window, width))
+	{
+		rohc_comp_warn(context, "malformed context in snapshot: W-LSB window "
+		               "for SN does not match its width of %zu entries", width);
+		goto free_body;
+	}
+	if(rfc3095_ctxt->ip_hdr_nr == 1)
+	{
+		memset(&rfc3095_ctxt->inner_ip_flags, 0, sizeof(struct ip_header_info));
+	}
+	for(i = 0; i < rfc3095_ctxt->ip_hdr_nr; i++)
+	{
+		struct ip_header_info *const ip_flags =
+			(i == 0 ? &rfc3095_ctxt->outer_ip_flags : &rfc3095_ctxt->inner_ip_flags);
+
+		if(ip_flags->version == IPV4)
+		{
+			ip_flags->info.v4.ip_id_window = (struct c_wlsb *)
+				(rfc3095_ctxt->wlsb_mem + rfc3095_ctxt->wlsb_size * (i + 1));
+			if(!c_wlsb_relocate(ip_flags->info.v4.ip_id_window, width))
+			{
+				rohc_comp_warn(context, "malformed context in snapshot: W-LSB "
+				               "window for IP-ID #%zu does not match its width of "
+				               "%zu entries", i + 1, width);
+				goto free_lists;
+			}
+		}
+		else if(ip_flags->version == IPV6)
+		{
+			rohc_comp_list_ipv6_new(&ip_flags->info.v6.ext_comp,
+			                        &ip_flags->info.v6.ext_mem,
+			                        comp->list_trans_nr, comp->trace_callback,
+			                        comp->trace_callback_priv, comp->trace_level,
+			                        context->profile->id);
+			is_list_init[i] = true;
+			ip_flags->info.v6.ext_comp.may_alloc =
+				((comp->features & ROHC_COMP_FEATURE_NO_ALLOC) == 0);
+			if(!rohc_comp_list_restore(&ip_flags->info.v6.ext_comp, read_cb, priv))
+			{
+				goto free_lists;
+			}
+		}
+		else
+		{
+			rohc_comp_warn(context, "malformed context in snapshot: IP header "
+			               "#%zu is neither IPv4 nor IPv6", i + 1);
+			goto free_lists;
+		}
+	}
+
+	c_init_tmp_variables(&rfc3095_ctxt->tmp);
+	rfc3095_ctxt->last_SO_decision.is_valid = false;
+	if(body_size > rohc_comp_rfc3095_get_body_size(comp))
+	{
+		rfc3095_ctxt->specific = rfc3095_ctxt->wlsb_mem + rfc3095_ctxt->wlsb_size * 3;
+	}
+	else
+	{
+		rfc3095_ctxt->specific = NULL;
+	}
+	rohc_comp_rfc3095_init_handlers(rfc3095_ctxt);
+
+	context->specific = rfc3095_ctxt;
+
+	return true;
+
+free_lists:
+	for(i = 0; i < 2; i++)
+	{
+		if(is_list_init[i])
+		{
+			rohc_comp_list_ipv6_free(i == 0 ?
+			                         &rfc3095_ctxt->outer_ip_flags.info.v6.ext_comp :
+			                         &rfc3095_ctxt->inner_ip_flags.info.v6.ext_comp);
+		}
+	}
+free_body:
+	rohc_comp_ctxt_body_free(context, rfc3095_ctxt);
+error:
 	return false;
 }
 
@@ -659,10 +936,76 @@ void rohc_comp_rfc3095_destroy(struct rohc_comp_ctxt *const context)
 	{
 		ip_header_info_free(&rfc3095_ctxt->inner_ip_flags);
 	}
-	c_destroy_wlsb(rfc3095_ctxt->sn_window);
+	rohc_comp_ctxt_body_free(context, rfc3095_ctxt);
+}
 
-	zfree(rfc3095_ctxt->specific);
-	free(rfc3095_ctxt);
+
+/**
+ * @brief Get the size of the generic part of the body of the contexts of the
+ *        RFC3095 profiles
+ *
+ * The body holds the generic part of the context and the W-LSB encoding
+ * objects for the SN and the IP-IDs. The profile-specific part follows them
+ * in the same body, the profiles shall add its size.
+ *
+ * @param comp  The ROHC compressor
+ * @return      The size of the body of one context
+ */
+size_t rohc_comp_rfc3095_get_body_size(const struct rohc_comp *const comp)
+{
+	return (sizeof(struct rohc_comp_rfc3095_ctxt) +
+	        c_wlsb_size(comp->wlsb_window_width) * 3);
+}
+
+
+/**
+ * @brief Get the memory used by the generic part of one context
+ *
+ * The profile-specific data are not accounted for, the profiles shall add
+ * them.
+ *
+ * @param context   The compression context
+ * @param[out] mem  The memory used by the generic part of the context
+ */
+void rohc_comp_rfc3095_get_mem(const struct rohc_comp_ctxt *const context,
+                               struct rohc_ctxt_mem *const mem)
+{
+	const struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt = context->specific;
+
+	/* the W-LSB encoding objects for the SN and the IP-IDs */
+	mem->wlsb_bytes = rfc3095_ctxt->wlsb_size * 3;
+
+	/* the list compressors and their memory are embedded in the context */
+	mem->lists_bytes = (sizeof(struct list_comp) + sizeof(struct list_comp_mem)) * 2;
+
+	mem->bytes = sizeof(struct rohc_comp_rfc3095_ctxt) + mem->wlsb_bytes;
+}
+
+
+/**
+ * @brief Change the number of entries that the W-LSB windows of the generic
+ *        part of one context keep
+ *
+ * The profiles with other W-LSB windows shall change them too.
+ *
+ * @param context  The compression context
+ * @param width    The new number of entries of the W-LSB windows
+ */
+void rohc_comp_rfc3095_set_wlsb_width(struct rohc_comp_ctxt *const context,
+                                      const size_t width)
+{
+	struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt = context->specific;
+
+	c_wlsb_set_width(rfc3095_ctxt->sn_window, width);
+	if(rfc3095_ctxt->outer_ip_flags.version == IPV4)
+	{
+		c_wlsb_set_width(rfc3095_ctxt->outer_ip_flags.info.v4.ip_id_window, width);
+	}
+	if(rfc3095_ctxt->ip_hdr_nr > 1 &&
+	   rfc3095_ctxt->inner_ip_flags.version == IPV4)
+	{
+		c_wlsb_set_width(rfc3095_ctxt->inner_ip_flags.info.v4.ip_id_window, width);
+	}
 }
 
 
@@ -841,6 +1184,8 @@ int rohc_comp_rfc3095_encode(struct rohc_comp_ctxt *const context,
 	rfc3095_ctxt->tmp.packet_type = ROHC_PACKET_UNKNOWN;
 
 	/* detect changes between new uncompressed packet and context */
+	rohc_cycles_begin(&context->compressor->stage_cycles,
+	                  ROHC_COMP_STAGE_CHANGES);
 	if(!rohc_comp_rfc3095_detect_changes(context, uncomp_pkt))
 	{
 		rohc_comp_warn(context, "failed to detect changes in uncompressed packet");
@@ -854,30 +1199,47 @@ int rohc_comp_rfc3095_encode(struct rohc_comp_ctxt *const context,
 	{
 		rohc_comp_periodic_down_transition(context);
 	}
+	rohc_cycles_end(&context->compressor->stage_cycles, ROHC_COMP_STAGE_CHANGES);
 
 	/* compute how many bits are needed to send header fields */
+	rohc_cycles_begin(&context->compressor->stage_cycles,
+	                  ROHC_COMP_STAGE_ENCODE_FIELDS);
 	if(!encode_uncomp_fields(context, uncomp_pkt))
 	{
 		rohc_comp_warn(context, "failed to compute how many bits are needed "
 		               "to send header fields");
 		goto error;
 	}
+	rohc_cycles_end(&context->compressor->stage_cycles,
+	                ROHC_COMP_STAGE_ENCODE_FIELDS);
 
 	/* decide which packet to send */
+	rohc_cycles_begin(&context->compressor->stage_cycles,
+	                  ROHC_COMP_STAGE_DECIDE_PKT);
 	rfc3095_ctxt->tmp.packet_type = decide_packet(context);
+	rohc_cycles_end(&context->compressor->stage_cycles,
+	                ROHC_COMP_STAGE_DECIDE_PKT);
 
 	/* code the ROHC header (and the extension if needed) */
+	rohc_cycles_begin(&context->compressor->stage_cycles,
+	                  ROHC_COMP_STAGE_BUILD_HDR);
 	size = code_packet(context, uncomp_pkt, rohc_pkt, rohc_pkt_max_len);
 	if(size < 0)
 	{
 		goto error;
 	}
+	rohc_cycles_end(&context->compressor->stage_cycles,
+	                ROHC_COMP_STAGE_BUILD_HDR);
 	/* determine the offset of the payload */
 	*payload_offset = net_pkt_get_payload_offset(uncomp_pkt);
 	*payload_offset += rfc3095_ctxt->next_header_len;
 
 	/* update the context with the new headers */
+	rohc_cycles_begin(&context->compressor->stage_cycles,
+	                  ROHC_COMP_STAGE_UPDATE_CTXT);
 	update_context(context, uncomp_pkt);
+	rohc_cycles_end(&context->compressor->stage_cycles,
+	                ROHC_COMP_STAGE_UPDATE_CTXT);
 
 	/* return the packet type */
 	*packet_type = rfc3095_ctxt->tmp.packet_type;
@@ -1049,6 +1411,10 @@ static bool rohc_comp_rfc3095_feedback_2(struct rohc_comp_ctxt *const context,
 
 			/* the compressor received a positive ACK */
 			rohc_comp_rfc3095_feedback_ack(context, sn_bits, sn_bits_nr, sn_not_valid);
+			if(!sn_not_valid)
+			{
+				rohc_comp_wlsb_feedback(context, true);
+			}
 			break;
 		}
 		case ROHC_FEEDBACK_NACK:
@@ -1061,6 +1427,8 @@ static bool rohc_comp_rfc3095_feedback_2(struct rohc_comp_ctxt *const context,
 			{
 				rohc_comp_change_state(context, ROHC_COMP_STATE_FO);
 			}
+			/* packets are lost, the W-LSB windows shall get wider */
+			rohc_comp_wlsb_feedback(context, false);
 			/* TODO: use the SN field to determine the latest packet successfully
 			 * decompressed and then determine what fields need to be updated */
 			break;
@@ -1072,6 +1440,8 @@ static bool rohc_comp_rfc3095_feedback_2(struct rohc_comp_ctxt *const context,
 			          "STATIC-NACK received for CID %zu", context->cid);
 			/* the compressor transits back to the IR state */
 			rohc_comp_change_state(context, ROHC_COMP_STATE_IR);
+			/* packets are lost, the W-LSB windows shall get wider */
+			rohc_comp_wlsb_feedback(context, false);
 			/* TODO: use the SN field to determine the latest packet successfully
 			 * decompressed and then determine what fields need to be updated */
 			break;
@@ -1247,15 +1617,19 @@ static bool rohc_comp_rfc3095_detect_changes(struct rohc_comp_ctxt *const contex
 		if(uncomp_pkt->ip_hdr_nr > 1)
 		{
 			rohc_comp_debug(context, "packet got one more IP header than context");
-			if(!ip_header_info_new(&rfc3095_ctxt->inner_ip_flags,
-			                       &uncomp_pkt->inner_ip,
-			                       context->compressor->list_trans_nr,
-			                       context->compressor->wlsb_window_width,
-			                       context->compressor->trace_callback,
-			                       context->compressor->trace_callback_priv,
-			                       context->profile->id))
+			ip_header_info_new(&rfc3095_ctxt->inner_ip_flags,
+			                   &uncomp_pkt->inner_ip,
+			                   context->compressor->list_trans_nr,
+			                   context->compressor->wlsb_window_width,
+			                   rfc3095_ctxt->wlsb_mem + rfc3095_ctxt->wlsb_size * 2,
+			                   context->compressor->trace_callback,
+			                   context->compressor->trace_callback_priv,
+			                   context->compressor->trace_level,
+			                   context->profile->id);
+			if(rfc3095_ctxt->inner_ip_flags.version == IPV4)
 			{
-				goto error;
+				c_wlsb_set_width(rfc3095_ctxt->inner_ip_flags.info.v4.ip_id_window,
+				                 context->wlsb_width);
 			}
 		}
 		else
@@ -1272,7 +1646,8 @@ static bool rohc_comp_rfc3095_detect_changes(struct rohc_comp_ctxt *const contex
 	/* find outer IP fields that changed */
 	rfc3095_ctxt->tmp.changed_fields =
 		detect_changed_fields(context, &rfc3095_ctxt->outer_ip_flags,
-		                      &uncomp_pkt->outer_ip);
+		                      &uncomp_pkt->outer_ip,
+		                      net_pkt_get_ip_desc(uncomp_pkt, 0));
 	if(rfc3095_ctxt->tmp.changed_fields & MOD_ERROR)
 	{
 		rohc_comp_warn(context, "failed to detect changed field in outer IP "
@@ -1285,7 +1660,8 @@ static bool rohc_comp_rfc3095_detect_changes(struct rohc_comp_ctxt *const contex
 	{
 		rfc3095_ctxt->tmp.changed_fields2 =
 			detect_changed_fields(context, &rfc3095_ctxt->inner_ip_flags,
-			                      &uncomp_pkt->inner_ip);
+			                      &uncomp_pkt->inner_ip,
+			                      net_pkt_get_ip_desc(uncomp_pkt, 1));
 		if(rfc3095_ctxt->tmp.changed_fields2  & MOD_ERROR)
 		{
 			rohc_comp_warn(context, "failed to detect changed field in inner IP "
@@ -1440,6 +1816,58 @@ void rohc_comp_rfc3095_decide_state(struct rohc_comp_ctxt *const context)
 }
 
 
+/**
+ * @brief Decide which packet to send in SO state, reusing the last decision
+ *        if possible
+ *
+ * Steady flows often need the same number of SN and IP-ID bits packet after
+ * packet. The SO decision handler is then only called when one of its inputs
+ * changed since the previous decision.
+ *
+ * @param context  The compression context
+ * @return         The packet type among ROHC_PACKET_UO_0, ROHC_PACKET_UO_1,
+ *                 ROHC_PACKET_UOR_2 and ROHC_PACKET_IR_DYN
+ */
+static rohc_packet_t decide_SO_packet_cached(struct rohc_comp_ctxt *const context)
+{
+	struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt =
+		(struct rohc_comp_rfc3095_ctxt *) context->specific;
+	struct rohc_comp_rfc3095_so_decision *const last = &rfc3095_ctxt->last_SO_decision;
+	struct rohc_comp_rfc3095_so_decision cur;
+
+	cur.ip_hdr_nr = rfc3095_ctxt->ip_hdr_nr;
+	cur.is_outer_ip_id_rnd = (rfc3095_ctxt->outer_ip_flags.version == IPV4 &&
+	                          rfc3095_ctxt->outer_ip_flags.info.v4.rnd == 1);
+	cur.is_inner_ip_id_rnd = (rfc3095_ctxt->ip_hdr_nr > 1 &&
+	                          rfc3095_ctxt->inner_ip_flags.version == IPV4 &&
+	                          rfc3095_ctxt->inner_ip_flags.info.v4.rnd == 1);
+	cur.nr_sn_bits_less_equal_than_4 = rfc3095_ctxt->tmp.nr_sn_bits_less_equal_than_4;
+	cur.nr_sn_bits_more_than_4 = rfc3095_ctxt->tmp.nr_sn_bits_more_than_4;
+	cur.nr_ip_id_bits = rfc3095_ctxt->tmp.nr_ip_id_bits;
+	cur.nr_ip_id_bits2 = (rfc3095_ctxt->ip_hdr_nr > 1 ? rfc3095_ctxt->tmp.nr_ip_id_bits2 : 0);
+
+	if(last->is_valid &&
+	   last->ip_hdr_nr == cur.ip_hdr_nr &&
+	   last->is_outer_ip_id_rnd == cur.is_outer_ip_id_rnd &&
+	   last->is_inner_ip_id_rnd == cur.is_inner_ip_id_rnd &&
+	   last->nr_sn_bits_less_equal_than_4 == cur.nr_sn_bits_less_equal_than_4 &&
+	   last->nr_sn_bits_more_than_4 == cur.nr_sn_bits_more_than_4 &&
+	   last->nr_ip_id_bits == cur.nr_ip_id_bits &&
+	   last->nr_ip_id_bits2 == cur.nr_ip_id_bits2)
+	{
+		rohc_comp_debug(context, "same inputs as the previous SO decision, "
+		                "re-use packet '%s'", rohc_get_packet_descr(last->packet));
+		return last->packet;
+	}
+
+	cur.packet = rfc3095_ctxt->decide_SO_packet(context);
+	cur.is_valid = true;
+	*last = cur;
+
+	return cur.packet;
+}
+
+
 /**
  * @brief Decide which packet to send when in the different states.
  *
@@ -1488,7 +1916,12 @@ static rohc_packet_t decide_packet(struct rohc_comp_ctxt *const context)
 		{
 			rohc_comp_debug(context, "decide packet in SO state");
 			context->so_count++;
-			if(rfc3095_ctxt->decide_SO_packet != NULL)
+			if(rfc3095_ctxt->decide_SO_packet != NULL &&
+			   rfc3095_ctxt->is_SO_decision_cacheable)
+			{
+				packet = decide_SO_packet_cached(context);
+			}
+			else if(rfc3095_ctxt->decide_SO_packet != NULL)
 			{
 				packet = rfc3095_ctxt->decide_SO_packet(context);
 			}
@@ -1536,6 +1969,20 @@ static rohc_packet_t decide_packet(struct rohc_comp_ctxt *const context)
 		/* TODO: could be UOR-2 with extension 3 and IPX2=1 */
 		packet = ROHC_PACKET_IR_DYN;
 	}
+	/* send IR-DYN packets instead of the packets with extension 3 if the
+	 * packet types are restricted to the cheapest ones to encode */
+	else if((context->compressor->features & ROHC_COMP_FEATURE_CHEAP_PACKETS) != 0 &&
+	        (packet == ROHC_PACKET_UO_1_ID || packet == ROHC_PACKET_UOR_2 ||
+	         packet == ROHC_PACKET_UOR_2_RTP || packet == ROHC_PACKET_UOR_2_TS ||
+	         packet == ROHC_PACKET_UOR_2_ID))
+	{
+		rfc3095_ctxt->tmp.packet_type = packet;
+		if(rfc3095_ctxt->decide_extension(context) == ROHC_EXT_3)
+		{
+			rohc_comp_debug(context, "force IR-DYN packet instead of extension 3");
+			packet = ROHC_PACKET_IR_DYN;
+		}
+	}
 
 	return packet;
 
@@ -1671,6 +2118,7 @@ static int code_IR_packet(struct rohc_comp_ctxt *const context,
 	uint8_t type;
 	size_t counter;
 	size_t first_position;
+	size_t static_chain_end;
 	int crc_position;
 	int ret;
 
@@ -1688,12 +2136,15 @@ static int code_IR_packet(struct rohc_comp_ctxt *const context,
 
 	rohc_comp_debug(context, "code IR packet (CID = %zu)", context->cid);
 
+	/* the CRC-STATIC fields may change with IR packets */
+	memset(&rfc3095_ctxt->crc_static, 0, sizeof(struct rohc_crc_static_cache));
+
 	/* parts 1 and 3:
 	 *  - part 2 will be placed at 'first_position'
 	 *  - part 4 will start at 'counter'
 	 */
-	ret = code_cid_values(context->compressor->medium.cid_type, context->cid,
-	                      rohc_pkt, rohc_pkt_max_len, &first_position);
+	ret = context->compressor->code_cid_values(context->cid, rohc_pkt,
+	                                           rohc_pkt_max_len, &first_position);
 	if(ret < 1)
 	{
 		rohc_comp_warn(context, "failed to encode %s CID %zu: maybe the "
@@ -1757,6 +2208,7 @@ static int code_IR_packet(struct rohc_comp_ctxt *const context,
 		goto error;
 	}
 	counter = ret;
+	static_chain_end = counter;
 
 	/* part 7: if we do not want dynamic part in IR packet, we should not
 	 * send the following */
@@ -1781,9 +2233,10 @@ static int code_IR_packet(struct rohc_comp_ctxt *const context,
 	}
 
 	/* part 5 */
-	rohc_pkt[crc_position] = crc_calculate(ROHC_CRC_TYPE_8, rohc_pkt, counter,
-	                                       CRC_INIT_8,
-	                                       context->compressor->crc_table_8);
+	rohc_cycles_crc_begin(&context->compressor->stage_cycles);
+	rohc_pkt[crc_position] =
+		rohc_comp_ir_crc(context, rohc_pkt, static_chain_end, counter);
+	rohc_cycles_crc_end(&context->compressor->stage_cycles, ROHC_COMP_STAGE_CRC);
 	rohc_comp_debug(context, "CRC (header length = %zu, crc = 0x%x)",
 	                counter, rohc_pkt[crc_position]);
 
@@ -1855,12 +2308,15 @@ static int code_IR_DYN_packet(struct rohc_comp_ctxt *const context,
 
 	rohc_comp_debug(context, "code IR-DYN packet (CID = %zu)", context->cid);
 
+	/* the CRC-STATIC fields may change with IR-DYN packets */
+	memset(&rfc3095_ctxt->crc_static, 0, sizeof(struct rohc_crc_static_cache));
+
 	/* parts 1 and 3:
 	 *  - part 2 will be placed at 'first_position'
 	 *  - part 4 will start at 'counter'
 	 */
-	ret = code_cid_values(context->compressor->medium.cid_type, context->cid,
-	                      rohc_pkt, rohc_pkt_max_len, &first_position);
+	ret = context->compressor->code_cid_values(context->cid, rohc_pkt,
+	                                           rohc_pkt_max_len, &first_position);
 	if(ret < 1)
 	{
 		rohc_comp_warn(context, "failed to encode %s CID %zu: maybe the "
@@ -1925,9 +2381,11 @@ static int code_IR_DYN_packet(struct rohc_comp_ctxt *const context,
 	}
 
 	/* part 5 */
+	rohc_cycles_crc_begin(&context->compressor->stage_cycles);
 	rohc_pkt[crc_position] = crc_calculate(ROHC_CRC_TYPE_8, rohc_pkt, counter,
 	                                       CRC_INIT_8,
-	                                       context->compressor->crc_table_8);
+	                                       rohc_crc_table_8);
+	rohc_cycles_crc_end(&context->compressor->stage_cycles, ROHC_COMP_STAGE_CRC);
 	rohc_comp_debug(context, "CRC (header length = %zu, crc = 0x%x)",
 	                counter, rohc_pkt[crc_position]);
 
@@ -2633,8 +3091,8 @@ static int code_UO0_packet(struct rohc_comp_ctxt *const context,
 	 *  - part 2 will be placed at 'first_position'
 	 *  - part 4 will start at 'counter'
 	 */
-	ret = code_cid_values(context->compressor->medium.cid_type, context->cid,
-	                      rohc_pkt, rohc_pkt_max_len, &first_position);
+	ret = context->compressor->code_cid_values(context->cid, rohc_pkt,
+	                                           rohc_pkt_max_len, &first_position);
 	if(ret < 1)
 	{
 		rohc_comp_warn(context, "failed to encode %s CID %zu: maybe the "
@@ -2655,13 +3113,11 @@ static int code_UO0_packet(struct rohc_comp_ctxt *const context,
 		                                            rohc_pkt, counter, &first_position);
 	}
 
-	/* part 2: SN + CRC
-	 * TODO: The CRC should be computed only on the CRC-DYNAMIC fields
-	 * if the CRC-STATIC fields did not change */
+	/* part 2: SN + CRC */
 	assert(rfc3095_ctxt->tmp.nr_sn_bits_less_equal_than_4 <= 4);
 	f_byte = (rfc3095_ctxt->sn & 0x0f) << 3;
-	crc = compute_uo_crc(rfc3095_ctxt, uncomp_pkt, ROHC_CRC_TYPE_3, CRC_INIT_3,
-	                     context->compressor->crc_table_3);
+	crc = compute_uo_crc(context, uncomp_pkt, false, ROHC_CRC_TYPE_3,
+	                     CRC_INIT_3, rohc_crc_table_3);
 	f_byte |= crc;
 	rohc_comp_debug(context, "first byte = 0x%02x (CRC = 0x%x)", f_byte, crc);
 	rohc_pkt[first_position] = f_byte;
@@ -2769,8 +3225,8 @@ static int rohc_comp_rfc3095_build_uo1_pkt(struct rohc_comp_ctxt *const context,
 	/* parts 1 and 3:
 	 *  - part 2 will be placed at 'first_position'
 	 *  - part 4 will start at 'counter' */
-	ret = code_cid_values(context->compressor->medium.cid_type, context->cid,
-	                      rohc_pkt, rohc_pkt_max_len, &first_position);
+	ret = context->compressor->code_cid_values(context->cid, rohc_pkt,
+	                                           rohc_pkt_max_len, &first_position);
 	if(ret < 1)
 	{
 		rohc_comp_warn(context, "failed to encode %s CID %zu: maybe the "
@@ -2795,16 +3251,14 @@ static int rohc_comp_rfc3095_build_uo1_pkt(struct rohc_comp_ctxt *const context,
 	rohc_pkt[first_position] = 0x80 | (innermost_ip_id_delta & 0x3f);
 	rohc_comp_debug(context, "1 0 + IP-ID = 0x%02x", rohc_pkt[first_position]);
 
-	/* part 4: SN + CRC
-	 * TODO: The CRC should be computed only on the CRC-DYNAMIC fields
-	 * if the CRC-STATIC fields did not change */
+	/* part 4: SN + CRC */
 	if((rohc_pkt_max_len - counter) < 1)
 	{
 		rohc_comp_warn(context, "ROHC packet is too small for SN/CRC byte");
 		goto error;
 	}
-	crc = compute_uo_crc(rfc3095_ctxt, uncomp_pkt, ROHC_CRC_TYPE_3, CRC_INIT_3,
-	                     context->compressor->crc_table_3);
+	crc = compute_uo_crc(context, uncomp_pkt, false, ROHC_CRC_TYPE_3,
+	                     CRC_INIT_3, rohc_crc_table_3);
 	rohc_pkt[counter] = ((rfc3095_ctxt->sn & 0x1f) << 3) | (crc & 0x07);
 	rohc_comp_debug(context, "SN (%d) + CRC (%x) = 0x%02x",
 	                rfc3095_ctxt->sn, crc, rohc_pkt[counter]);
@@ -2904,8 +3358,8 @@ static int rohc_comp_rfc3095_build_uo1rtp_pkt(struct rohc_comp_ctxt *const conte
 	/* parts 1 and 3:
 	 *  - part 2 will be placed at 'first_position'
 	 *  - part 4 will start at 'counter' */
-	ret = code_cid_values(context->compressor->medium.cid_type, context->cid,
-	                      rohc_pkt, rohc_pkt_max_len, &first_position);
+	ret = context->compressor->code_cid_values(context->cid, rohc_pkt,
+	                                           rohc_pkt_max_len, &first_position);
 	if(ret < 1)
 	{
 		rohc_comp_warn(context, "failed to encode %s CID %zu: maybe the "
@@ -2930,9 +3384,7 @@ static int rohc_comp_rfc3095_build_uo1rtp_pkt(struct rohc_comp_ctxt *const conte
 	rohc_pkt[first_position] = 0x80 | (rtp_context->tmp.ts_send & 0x3f);
 	rohc_comp_debug(context, "1 0 + TS = 0x%02x", rohc_pkt[first_position]);
 
-	/* part 4: M + SN + CRC
-	 * TODO: The CRC should be computed only on the CRC-DYNAMIC fields
-	 * if the CRC-STATIC fields did not change */
+	/* part 4: M + SN + CRC */
 	if((rohc_pkt_max_len - counter) < 1)
 	{
 		rohc_comp_warn(context, "ROHC packet is too small for SN/CRC byte");
@@ -2940,8 +3392,8 @@ static int rohc_comp_rfc3095_build_uo1rtp_pkt(struct rohc_comp_ctxt *const conte
 	}
 	rohc_pkt[counter] = ((!!rtp_context->tmp.is_marker_bit_set) & 0x01) << 7;
 	rohc_pkt[counter] |= (rfc3095_ctxt->sn & 0x0f) << 3;
-	crc = compute_uo_crc(rfc3095_ctxt, uncomp_pkt, ROHC_CRC_TYPE_3, CRC_INIT_3,
-	                     context->compressor->crc_table_3);
+	crc = compute_uo_crc(context, uncomp_pkt, false, ROHC_CRC_TYPE_3,
+	                     CRC_INIT_3, rohc_crc_table_3);
 	rohc_pkt[counter] |= crc & 0x07;
 	rohc_comp_debug(context, "M (%d) + SN (%d) + CRC (%x) = 0x%02x",
 	                !!rtp_context->tmp.is_marker_bit_set,
@@ -3053,8 +3505,8 @@ static int rohc_comp_rfc3095_build_uo1ts_pkt(struct rohc_comp_ctxt *const contex
 	/* parts 1 and 3:
 	 *  - part 2 will be placed at 'first_position'
 	 *  - part 4 will start at 'counter' */
-	ret = code_cid_values(context->compressor->medium.cid_type, context->cid,
-	                      rohc_pkt, rohc_pkt_max_len, &first_position);
+	ret = context->compressor->code_cid_values(context->cid, rohc_pkt,
+	                                           rohc_pkt_max_len, &first_position);
 	if(ret < 1)
 	{
 		rohc_comp_warn(context, "failed to encode %s CID %zu: maybe the "
@@ -3080,16 +3532,14 @@ static int rohc_comp_rfc3095_build_uo1ts_pkt(struct rohc_comp_ctxt *const contex
 	rohc_comp_debug(context, "1 0 + T = 1 + TS/IP-ID = 0x%02x",
 	                rohc_pkt[first_position]);
 
-	/* part 4: M + SN + CRC
-	 * TODO: The CRC should be computed only on the CRC-DYNAMIC fields
-	 * if the CRC-STATIC fields did not change */
+	/* part 4: M + SN + CRC */
 	if((rohc_pkt_max_len - counter) < 1)
 	{
 		rohc_comp_warn(context, "ROHC packet is too small for SN/CRC byte");
 		goto error;
 	}
-	crc = compute_uo_crc(rfc3095_ctxt, uncomp_pkt, ROHC_CRC_TYPE_3, CRC_INIT_3,
-	                     context->compressor->crc_table_3);
+	crc = compute_uo_crc(context, uncomp_pkt, false, ROHC_CRC_TYPE_3,
+	                     CRC_INIT_3, rohc_crc_table_3);
 	rohc_pkt[counter] = ((!!rtp_context->tmp.is_marker_bit_set) & 0x01) << 7;
 	rohc_pkt[counter] |= (rfc3095_ctxt->sn & 0x0f) << 3;
 	rohc_pkt[counter] |= crc & 0x07;
@@ -3212,8 +3662,8 @@ static int rohc_comp_rfc3095_build_uo1id_pkt(struct rohc_comp_ctxt *const contex
 	/* parts 1 and 3:
 	 *  - part 2 will be placed at 'first_position'
 	 *  - part 4 will start at 'counter' */
-	ret = code_cid_values(context->compressor->medium.cid_type, context->cid,
-	                      rohc_pkt, rohc_pkt_max_len, &first_position);
+	ret = context->compressor->code_cid_values(context->cid, rohc_pkt,
+	                                           rohc_pkt_max_len, &first_position);
 	if(ret < 1)
 	{
 		rohc_comp_warn(context, "failed to encode %s CID %zu: maybe the "
@@ -3351,16 +3801,14 @@ static int rohc_comp_rfc3095_build_uo1id_pkt(struct rohc_comp_ctxt *const contex
 	rohc_comp_debug(context, "1 0 + T = 0 + TS/IP-ID = 0x%02x",
 	                rohc_pkt[first_position]);
 
-	/* part 4: X + SN + CRC
-	 * TODO: The CRC should be computed only on the CRC-DYNAMIC fields
-	 * if the CRC-STATIC fields did not change */
+	/* part 4: X + SN + CRC */
 	if((rohc_pkt_max_len - counter) < 1)
 	{
 		rohc_comp_warn(context, "ROHC packet is too small for SN/CRC byte");
 		goto error;
 	}
-	crc = compute_uo_crc(rfc3095_ctxt, uncomp_pkt, ROHC_CRC_TYPE_3, CRC_INIT_3,
-	                     context->compressor->crc_table_3);
+	crc = compute_uo_crc(context, uncomp_pkt, (extension == ROHC_EXT_3),
+	                     ROHC_CRC_TYPE_3, CRC_INIT_3, rohc_crc_table_3);
 	s_byte = crc & 0x07;
 	switch(extension)
 	{
@@ -3608,8 +4056,8 @@ static int code_UO2_packet(struct rohc_comp_ctxt *const context,
 	 *  - part 2 will be placed at 'first_position'
 	 *  - parts 4/5 will start at 'counter'
 	 */
-	ret = code_cid_values(context->compressor->medium.cid_type, context->cid,
-	                      rohc_pkt, rohc_pkt_max_len, &first_position);
+	ret = context->compressor->code_cid_values(context->cid, rohc_pkt,
+	                                           rohc_pkt_max_len, &first_position);
 	if(ret < 1)
 	{
 		rohc_comp_warn(context, "failed to encode %s CID %zu: maybe the "
@@ -3641,13 +4089,8 @@ static int code_UO2_packet(struct rohc_comp_ctxt *const context,
 		counter++;
 	}
 
-	/* part 5: partially calculate the third byte, then remember the position
-	 *         of the third byte, its final value is currently unknown
-	 *
-	 * TODO: The CRC should be computed only on the CRC-DYNAMIC fields
-	 * if the CRC-STATIC fields did not change */
-	t_byte = compute_uo_crc(rfc3095_ctxt, uncomp_pkt, ROHC_CRC_TYPE_7, CRC_INIT_7,
-	                        context->compressor->crc_table_7);
+	/* part 5: remember the position of the third byte, its final value is
+	 *         currently unknown */
 	t_byte_position = counter;
 	counter++;
 
@@ -3661,6 +4104,11 @@ static int code_UO2_packet(struct rohc_comp_ctxt *const context,
 	rohc_comp_debug(context, "extension '%s' chosen",
 	                rohc_get_ext_descr(extension));
 
+	/* part 5: partially calculate the third byte with the CRC, the part on the
+	 *         CRC-STATIC fields cannot be re-used with extension 3 */
+	t_byte = compute_uo_crc(context, uncomp_pkt, (extension == ROHC_EXT_3),
+	                        ROHC_CRC_TYPE_7, CRC_INIT_7, rohc_crc_table_7);
+
 	/* parts 2, 4, 5: complete the three packet-specific bytes and copy them
 	 * in packet */
 	if(!code_bytes(context, extension, &f_byte, &s_byte, &t_byte))
@@ -4662,15 +5110,16 @@ static int code_EXT0_packet(const struct rohc_comp_ctxt *const context,
                             int counter)
 {
 	struct rohc_comp_rfc3095_ctxt *rfc3095_ctxt;
-	uint8_t f_byte;
+	struct rohc_bit_writer ext0;
 	rohc_packet_t packet_type;
 
 	rfc3095_ctxt = (struct rohc_comp_rfc3095_ctxt *) context->specific;
 	packet_type = rfc3095_ctxt->tmp.packet_type;
 
 	/* part 1: extension type + SN */
-	f_byte = 0;
-	f_byte |= (rfc3095_ctxt->sn & 0x07) << 3;
+	rohc_bit_writer_init(&ext0);
+	rohc_bit_writer_put(&ext0, 0x0, 2);
+	rohc_bit_writer_put(&ext0, rfc3095_ctxt->sn, 3);
 
 	/* part 1: IP-ID or TS ? */
 	switch(packet_type)
@@ -4679,7 +5128,7 @@ static int code_EXT0_packet(const struct rohc_comp_ctxt *const context,
 		case ROHC_PACKET_UOR_2_TS:
 		{
 			const struct sc_rtp_context *const rtp_context = rfc3095_ctxt->specific;
-			f_byte |= rtp_context->tmp.ts_send & 0x07;
+			rohc_bit_writer_put(&ext0, rtp_context->tmp.ts_send, 3);
 			break;
 		}
 
@@ -4699,7 +5148,7 @@ static int code_EXT0_packet(const struct rohc_comp_ctxt *const context,
 			                                &innermost_ip_id_delta);
 			assert(innermost_ip_hdr != ROHC_IP_HDR_NONE);
 
-			f_byte |= innermost_ip_id_delta & 0x07;
+			rohc_bit_writer_put(&ext0, innermost_ip_id_delta, 3);
 			break;
 		}
 
@@ -4711,8 +5160,7 @@ static int code_EXT0_packet(const struct rohc_comp_ctxt *const context,
 	}
 
 	/* part 1: write the byte in the extension */
-	dest[counter] = f_byte;
-	counter++;
+	counter += rohc_bit_writer_flush(&ext0, dest + counter);
 
 	return counter;
 
@@ -4764,15 +5212,15 @@ static int code_EXT1_packet(const struct rohc_comp_ctxt *const context,
 {
 	struct rohc_comp_rfc3095_ctxt *rfc3095_ctxt;
 	rohc_packet_t packet_type;
-	uint8_t f_byte;
-	uint8_t s_byte;
+	struct rohc_bit_writer ext1;
 
 	rfc3095_ctxt = (struct rohc_comp_rfc3095_ctxt *) context->specific;
 	packet_type = rfc3095_ctxt->tmp.packet_type;
 
 	/* part 1: extension type + SN */
-	f_byte = (rfc3095_ctxt->sn & 0x07) << 3;
-	f_byte |= 0x40;
+	rohc_bit_writer_init(&ext1);
+	rohc_bit_writer_put(&ext1, 0x1, 2);
+	rohc_bit_writer_put(&ext1, rfc3095_ctxt->sn, 3);
 
 	/* parts 1 & 2: IP-ID or TS ? */
 	switch(packet_type)
@@ -4791,20 +5239,16 @@ static int code_EXT1_packet(const struct rohc_comp_ctxt *const context,
 			                                &innermost_ip_id_delta);
 			assert(innermost_ip_hdr != ROHC_IP_HDR_NONE);
 
-			f_byte |= (innermost_ip_id_delta >> 8) & 0x07;
-			s_byte = innermost_ip_id_delta & 0xff;
+			rohc_bit_writer_put(&ext1, innermost_ip_id_delta, 11);
 			break;
 		}
 
 		case ROHC_PACKET_UOR_2_RTP:
 		{
 			const struct sc_rtp_context *const rtp_context = rfc3095_ctxt->specific;
-			f_byte |= (rtp_context->tmp.ts_send >> 8) & 0x07;
-			rohc_comp_debug(context, "3 bits of TS in 1st byte = 0x%x",
-			                f_byte & 0x07);
-			s_byte = rtp_context->tmp.ts_send & 0xff;
-			rohc_comp_debug(context, "8 bits of TS in 2nd byte = 0x%x",
-			                s_byte & 0xff);
+			rohc_bit_writer_put(&ext1, rtp_context->tmp.ts_send, 11);
+			rohc_comp_debug(context, "11 bits of TS = 0x%x",
+			                rtp_context->tmp.ts_send & 0x7ff);
 			break;
 		}
 
@@ -4823,10 +5267,10 @@ static int code_EXT1_packet(const struct rohc_comp_ctxt *const context,
 			                                &innermost_ip_id_delta);
 			assert(innermost_ip_hdr != ROHC_IP_HDR_NONE);
 
-			f_byte |= rtp_context->tmp.ts_send & 0x07;
+			rohc_bit_writer_put(&ext1, rtp_context->tmp.ts_send, 3);
 			rohc_comp_debug(context, "3 bits of TS in 1st byte = 0x%x",
-			                f_byte & 0x07);
-			s_byte = innermost_ip_id_delta & 0xff;
+			                rtp_context->tmp.ts_send & 0x07);
+			rohc_bit_writer_put(&ext1, innermost_ip_id_delta, 8);
 			break;
 		}
 
@@ -4846,12 +5290,12 @@ static int code_EXT1_packet(const struct rohc_comp_ctxt *const context,
 			                                &innermost_ip_id_delta);
 			assert(innermost_ip_hdr != ROHC_IP_HDR_NONE);
 
-			f_byte |= innermost_ip_id_delta & 0x07;
+			rohc_bit_writer_put(&ext1, innermost_ip_id_delta, 3);
 			rohc_comp_debug(context, "3 bits of inner IP-ID in 1st byte = "
-			                "0x%x", f_byte & 0x07);
-			s_byte = rtp_context->tmp.ts_send & 0xff;
+			                "0x%x", innermost_ip_id_delta & 0x07);
+			rohc_bit_writer_put(&ext1, rtp_context->tmp.ts_send, 8);
 			rohc_comp_debug(context, "8 bits of TS in 2nd byte = 0x%x",
-			                s_byte & 0xff);
+			                rtp_context->tmp.ts_send & 0xff);
 			break;
 		}
 
@@ -4863,10 +5307,7 @@ static int code_EXT1_packet(const struct rohc_comp_ctxt *const context,
 	}
 
 	/* write parts 1 & 2 in the packet */
-	dest[counter] = f_byte;
-	counter++;
-	dest[counter] = s_byte;
-	counter++;
+	counter += rohc_bit_writer_flush(&ext1, dest + counter);
 
 	return counter;
 
@@ -4924,16 +5365,15 @@ static int code_EXT2_packet(const struct rohc_comp_ctxt *const context,
 {
 	struct rohc_comp_rfc3095_ctxt *rfc3095_ctxt;
 	rohc_packet_t packet_type;
-	uint8_t f_byte;
-	uint8_t s_byte;
-	uint8_t t_byte;
+	struct rohc_bit_writer ext2;
 
 	rfc3095_ctxt = (struct rohc_comp_rfc3095_ctxt *) context->specific;
 	packet_type = rfc3095_ctxt->tmp.packet_type;
 
 	/* part 1: extension type + SN */
-	f_byte = (rfc3095_ctxt->sn & 0x07) << 3;
-	f_byte |= 0x80;
+	rohc_bit_writer_init(&ext2);
+	rohc_bit_writer_put(&ext2, 0x2, 2);
+	rohc_bit_writer_put(&ext2, rfc3095_ctxt->sn, 3);
 	rohc_comp_debug(context, "3 bits of SN = 0x%x", rfc3095_ctxt->sn & 0x07);
 
 	/* parts 1, 2 & 3: IP-ID or TS ? */
@@ -4956,15 +5396,12 @@ static int code_EXT2_packet(const struct rohc_comp_ctxt *const context,
 			       rfc3095_ctxt->inner_ip_flags.version == IPV4 &&
 			       rfc3095_ctxt->inner_ip_flags.info.v4.rnd == 0);
 
-			f_byte |= (rfc3095_ctxt->outer_ip_flags.info.v4.id_delta >> 8) & 0x07;
-			rohc_comp_debug(context, "3 bits of outer IP-ID = 0x%x",
-			                f_byte & 0x07);
-			s_byte = rfc3095_ctxt->outer_ip_flags.info.v4.id_delta & 0xff;
-			rohc_comp_debug(context, "8 bits of outer IP-ID = 0x%x",
-			                s_byte & 0xff);
-			t_byte = rfc3095_ctxt->inner_ip_flags.info.v4.id_delta & 0xff;
+			rohc_bit_writer_put(&ext2, rfc3095_ctxt->outer_ip_flags.info.v4.id_delta, 11);
+			rohc_comp_debug(context, "11 bits of outer IP-ID = 0x%x",
+			                rfc3095_ctxt->outer_ip_flags.info.v4.id_delta & 0x7ff);
+			rohc_bit_writer_put(&ext2, rfc3095_ctxt->inner_ip_flags.info.v4.id_delta, 8);
 			rohc_comp_debug(context, "8 bits of inner IP-ID = 0x%x",
-			                t_byte & 0xff);
+			                rfc3095_ctxt->inner_ip_flags.info.v4.id_delta & 0xff);
 			break;
 		}
 
@@ -4973,12 +5410,8 @@ static int code_EXT2_packet(const struct rohc_comp_ctxt *const context,
 			const struct sc_rtp_context *const rtp_context = rfc3095_ctxt->specific;
 			const uint32_t ts_send = rtp_context->tmp.ts_send;
 
-			f_byte |= (ts_send >> 16) & 0x07;
-			rohc_comp_debug(context, "3 bits of TS = 0x%x", f_byte & 0x07);
-			s_byte = (ts_send >> 8) & 0xff;
-			rohc_comp_debug(context, "8 bits of TS = 0x%x", s_byte & 0xff);
-			t_byte = ts_send & 0xff;
-			rohc_comp_debug(context, "8 bits of TS = 0x%x", t_byte & 0xff);
+			rohc_bit_writer_put(&ext2, ts_send, 19);
+			rohc_comp_debug(context, "19 bits of TS = 0x%x", ts_send & 0x7ffff);
 			break;
 		}
 
@@ -4998,13 +5431,11 @@ static int code_EXT2_packet(const struct rohc_comp_ctxt *const context,
 			                                &innermost_ip_id_delta);
 			assert(innermost_ip_hdr != ROHC_IP_HDR_NONE);
 
-			f_byte |= (ts_send >> 8) & 0x07;
-			rohc_comp_debug(context, "3 bits of TS = 0x%x", f_byte & 0x07);
-			s_byte = ts_send & 0xff;
-			rohc_comp_debug(context, "8 bits of TS = 0x%x", s_byte & 0xff);
-			t_byte = innermost_ip_id_delta & 0xff;
+			rohc_bit_writer_put(&ext2, ts_send, 11);
+			rohc_comp_debug(context, "11 bits of TS = 0x%x", ts_send & 0x7ff);
+			rohc_bit_writer_put(&ext2, innermost_ip_id_delta, 8);
 			rohc_comp_debug(context, "8 bits of innermost non-random "
-			                "IP-ID = 0x%x", t_byte & 0xff);
+			                "IP-ID = 0x%x", innermost_ip_id_delta & 0xff);
 			break;
 		}
 
@@ -5024,14 +5455,12 @@ static int code_EXT2_packet(const struct rohc_comp_ctxt *const context,
 			                                &innermost_ip_id_delta);
 			assert(innermost_ip_hdr != ROHC_IP_HDR_NONE);
 
-			f_byte |= (innermost_ip_id_delta >> 8) & 0x07;
-			rohc_comp_debug(context, "3 bits of innermost non-random IP-ID "
-			                "= 0x%x", f_byte & 0x07);
-			s_byte = innermost_ip_id_delta & 0xff;
-			rohc_comp_debug(context, "8 bits of innermost non-random IP-ID "
-			                "= 0x%x", s_byte & 0xff);
-			t_byte = rtp_context->tmp.ts_send & 0xff;
-			rohc_comp_debug(context, "8 bits of TS = 0x%x", t_byte & 0xff);
+			rohc_bit_writer_put(&ext2, innermost_ip_id_delta, 11);
+			rohc_comp_debug(context, "11 bits of innermost non-random IP-ID "
+			                "= 0x%x", innermost_ip_id_delta & 0x7ff);
+			rohc_bit_writer_put(&ext2, rtp_context->tmp.ts_send, 8);
+			rohc_comp_debug(context, "8 bits of TS = 0x%x",
+			                rtp_context->tmp.ts_send & 0xff);
 			break;
 		}
 
@@ -5043,14 +5472,9 @@ static int code_EXT2_packet(const struct rohc_comp_ctxt *const context,
 	}
 
 	/* write parts 1, 2 & 3 in the packet */
-	dest[counter] = f_byte;
-	counter++;
-	dest[counter] = s_byte;
-	counter++;
-	dest[counter] = t_byte;
-	counter++;
-	rohc_comp_debug(context, "extension 2: 0x%02x 0x%02x 0x%02x", f_byte,
-	                s_byte, t_byte);
+	counter += rohc_bit_writer_flush(&ext2, dest + counter);
+	rohc_comp_debug(context, "extension 2: 0x%02x 0x%02x 0x%02x",
+	                dest[counter - 3], dest[counter - 2], dest[counter - 1]);
 
 	return counter;
 
@@ -6000,24 +6424,34 @@ static int header_fields(const struct rohc_comp_ctxt *const context,
 /**
  * @brief Compute the CRC for a UO* packet
  *
- * @param rfc3095_ctxt   The generic compression context
- * @param uncomp_pkt  The uncompressed packet to encode
- * @param crc_type    The type of CRC to compute
- * @param crc_init    The initial value of the CRC
- * @param crc_table   The table of pre-computed CRC
- * @return            The computed CRC
+ * The part of the CRC on the CRC-STATIC fields is taken from the context if
+ * the CRC-STATIC fields did not change since it was computed.
+ *
+ * @param context             The compression context
+ * @param uncomp_pkt          The uncompressed packet to encode
+ * @param crc_static_changed  Whether the packet may transmit changes of the
+ *                            CRC-STATIC fields (extension 3) or not
+ * @param crc_type            The type of CRC to compute
+ * @param crc_init            The initial value of the CRC
+ * @param crc_table           The table of pre-computed CRC
+ * @return                    The computed CRC
  */
-static uint8_t compute_uo_crc(const struct rohc_comp_rfc3095_ctxt *rfc3095_ctxt,
+static uint8_t compute_uo_crc(struct rohc_comp_ctxt *const context,
                               const struct net_pkt *const uncomp_pkt,
+                              const bool crc_static_changed,
                               const rohc_crc_type_t crc_type,
                               const uint8_t crc_init,
                               const uint8_t *const crc_table)
 {
+	struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt = context->specific;
+	struct rohc_crc_static_cache *const crc_static = &rfc3095_ctxt->crc_static;
 	const uint8_t *outer_ip_hdr;
 	const uint8_t *inner_ip_hdr;
 	const uint8_t *next_header;
 	uint8_t crc = crc_init;
 
+	rohc_cycles_crc_begin(&context->compressor->stage_cycles);
+
 	outer_ip_hdr = ip_get_raw_data(&uncomp_pkt->outer_ip);
 	if(uncomp_pkt->ip_hdr_nr > 1)
 	{
@@ -6029,14 +6463,32 @@ static uint8_t compute_uo_crc(const struct rohc_comp_rfc3095_ctxt *rfc3095_ctxt,
 	}
 	next_header = uncomp_pkt->transport->data;
 
-	/* compute CRC on CRC-STATIC fields */
-	crc = rfc3095_ctxt->compute_crc_static(outer_ip_hdr, inner_ip_hdr, next_header,
-	                                       crc_type, crc, crc_table);
+	/* compute CRC on CRC-STATIC fields, or take it from the context if the
+	 * CRC-STATIC fields did not change since it was computed */
+	if(crc_static_changed)
+	{
+		memset(crc_static, 0, sizeof(struct rohc_crc_static_cache));
+		crc = rfc3095_ctxt->compute_crc_static(outer_ip_hdr, inner_ip_hdr, next_header,
+		                                       crc_type, crc, crc_table);
+	}
+	else if(crc_static->is_valid[crc_type])
+	{
+		crc = crc_static->crc[crc_type];
+	}
+	else
+	{
+		crc = rfc3095_ctxt->compute_crc_static(outer_ip_hdr, inner_ip_hdr, next_header,
+		                                       crc_type, crc, crc_table);
+		crc_static->crc[crc_type] = crc;
+		crc_static->is_valid[crc_type] = true;
+	}
 
 	/* compute CRC on CRC-DYNAMIC fields */
 	crc = rfc3095_ctxt->compute_crc_dynamic(outer_ip_hdr, inner_ip_hdr, next_header,
 	                                        crc_type, crc, crc_table);
 
+	rohc_cycles_crc_end(&context->compressor->stage_cycles, ROHC_COMP_STAGE_CRC);
+
 	return crc;
 }
 
@@ -6283,15 +6735,12 @@ static int changed_dynamic_one_hdr(struct rohc_comp_ctxt *const context,
 	if(ip_get_version(ip) == IPV4)
 	{
 		size_t nb_flags = 0; /* number of flags that changed */
-		uint8_t old_df;
-		uint8_t df;
 
 		/* check the Don't Fragment flag for change (IPv4 only) */
-		df = ipv4_get_df(ip);
-		old_df = header_info->info.v4.old_ip.df;
-		if(df != old_df || header_info->info.v4.df_count < MAX_FO_COUNT)
+		if(is_field_changed(changed_fields, MOD_DF) ||
+		   header_info->info.v4.df_count < MAX_FO_COUNT)
 		{
-			if(df != old_df)
+			if(is_field_changed(changed_fields, MOD_DF))
 			{
 				rohc_comp_debug(context, "DF changed in the current packet");
 				header_info->info.v4.df_count = 0;
@@ -6392,16 +6841,20 @@ static int changed_dynamic_one_hdr(struct rohc_comp_ctxt *const context,
  *
  * Only some fields are checked for change in the compression process, so
  * only check these ones to avoid useless work. The fields to check are:
- * TOS/TC, TTL/HL and Protocol/Next Header.
+ * TOS/TC, TTL/HL, Protocol/Next Header and the IPv4 DF flag. They are first
+ * compared all at once with a masked compare of the fixed header.
  *
  * @param context        The compression context
  * @param header_info    The header info stored in the profile
  * @param ip             The header of the new IP packet
+ * @param ip_desc        The description of the IP header made when the packet
+ *                       was parsed, NULL if not described
  * @return               The bitpattern that indicates which field changed
  */
 static unsigned short detect_changed_fields(const struct rohc_comp_ctxt *const context,
                                             struct ip_header_info *const header_info, /* TODO: add const */
-                                            const struct ip_packet *const ip)
+                                            const struct ip_packet *const ip,
+                                            const struct net_pkt_ip *const ip_desc)
 {
 	unsigned short ret_value = 0;
 	uint8_t old_tos;
@@ -6415,20 +6868,47 @@ static unsigned short detect_changed_fields(const struct rohc_comp_ctxt *const c
 	assert(header_info != NULL);
 	assert(ip != NULL);
 
+	/* compare the checked fields of the fixed header in one masked compare,
+	 * then look at every field only if something changed */
 	if(ip_get_version(ip) == IPV4)
 	{
-		const struct ipv4_hdr *old_ip;
+		const struct ipv4_hdr *const old_ip = &header_info->info.v4.old_ip;
+		const struct ipv4_hdr *const new_ip = ipv4_get_header(ip);
+
+		if(rfc3095_are_hdrs_equal_masked((const uint8_t *) old_ip,
+		                                 (const uint8_t *) new_ip,
+		                                 rfc3095_ipv4_changed_mask,
+		                                 sizeof(rfc3095_ipv4_changed_mask)))
+		{
+			goto ipv6_exts;
+		}
 
-		old_ip = &header_info->info.v4.old_ip;
 		old_tos = old_ip->tos;
 		old_ttl = old_ip->ttl;
 		old_protocol = old_ip->protocol;
+
+		if(new_ip->df != old_ip->df)
+		{
+			rohc_comp_debug(context, "DF changed from %u to %u",
+			                old_ip->df, new_ip->df);
+			ret_value |= MOD_DF;
+		}
 	}
 	else /* IPV6 */
 	{
-		const struct ipv6_hdr *old_ip;
+		const struct ipv6_hdr *const old_ip = &header_info->info.v6.old_ip;
+
+		/* the Next Header field of the context stores the protocol after the
+		 * extension headers, so it cannot be part of the masked compare */
+		if(rfc3095_are_hdrs_equal_masked((const uint8_t *) old_ip,
+		                                 (const uint8_t *) ipv6_get_header(ip),
+		                                 rfc3095_ipv6_changed_mask,
+		                                 sizeof(rfc3095_ipv6_changed_mask)) &&
+		   old_ip->nh == ip_get_protocol(ip))
+		{
+			goto ipv6_exts;
+		}
 
-		old_ip = &header_info->info.v6.old_ip;
 		old_tos = ipv6_get_tc(old_ip);
 		old_ttl = old_ip->hl;
 		old_protocol = old_ip->nh;
@@ -6458,13 +6938,16 @@ static unsigned short detect_changed_fields(const struct rohc_comp_ctxt *const c
 		ret_value |= MOD_PROTOCOL;
 	}
 
+ipv6_exts:
 	/* IPv6 extension headers */
 	if(ip_get_version(ip) == IPV6)
 	{
 		bool list_struct_changed;
 		bool list_content_changed;
 
-		if(!detect_ipv6_ext_changes(&header_info->info.v6.ext_comp, ip,
+		header_info->info.v6.ext_comp.may_alloc =
+			((context->compressor->features & ROHC_COMP_FEATURE_NO_ALLOC) == 0);
+		if(!detect_ipv6_ext_changes(&header_info->info.v6.ext_comp, ip, ip_desc,
 		                            &list_struct_changed, &list_content_changed))
 		{
 			goto error;
@@ -6572,7 +7055,20 @@ static void detect_ip_id_behaviour(const struct rohc_comp_ctxt *const context,
 		rohc_comp_debug(context, "1) old_id = 0x%04x new_id = 0x%04x",
 		                old_id, new_id);
 
-		if(new_id == old_id)
+		/* the IP-ID behaves most of the time as it did for the previous
+		 * header: keep the behaviour if the IP-ID has the value it predicts */
+		if(!header_info->info.v4.rnd && !header_info->info.v4.sid &&
+		   header_info->info.v4.nbo && is_ip_id_next(old_id, new_id))
+		{
+			rohc_comp_debug(context, "IP-ID is still increasing in NBO");
+		}
+		else if(!header_info->info.v4.rnd && !header_info->info.v4.sid &&
+		        !header_info->info.v4.nbo && !is_ip_id_next(old_id, new_id) &&
+		        is_ip_id_next(swab16(old_id), swab16(new_id)))
+		{
+			rohc_comp_debug(context, "IP-ID is still increasing in Little Endian");
+		}
+		else if(new_id == old_id)
 		{
 			/* previous and current IP-ID values are equal: IP-ID is constant */
 			rohc_comp_debug(context, "IP-ID is constant (SID detected)");
@@ -104,6 +104,8 @@ struct ipv6_header_info
 	struct ipv6_hdr old_ip;
 	/// The extension compressor
 	struct list_comp ext_comp;
+	/** The memory of the extension compressor */
+	struct list_comp_mem ext_mem;
 };
 
 
@@ -171,6 +173,35 @@ struct generic_tmp_vars
 };
 
 
+/**
+ * @brief The packet type decided in SO state for the previous packet
+ *
+ * The SO decision of the IP-only, UDP, UDP-Lite and ESP profiles only depends
+ * on the fields below, so the same inputs always give the same packet type.
+ */
+struct rohc_comp_rfc3095_so_decision
+{
+	/** Whether a decision was already recorded or not */
+	bool is_valid;
+	/** The number of IP headers */
+	size_t ip_hdr_nr;
+	/** Whether the outer IP header is an IPv4 header with random IP-ID */
+	bool is_outer_ip_id_rnd;
+	/** Whether the inner IP header is an IPv4 header with random IP-ID */
+	bool is_inner_ip_id_rnd;
+	/** The number of bits needed to encode the SN (<= 4 bits) */
+	size_t nr_sn_bits_less_equal_than_4;
+	/** The number of bits needed to encode the SN (> 4 bits) */
+	size_t nr_sn_bits_more_than_4;
+	/** The number of bits needed to encode the outer IP-ID */
+	size_t nr_ip_id_bits;
+	/** The number of bits needed to encode the inner IP-ID */
+	size_t nr_ip_id_bits2;
+	/** The packet type that was decided for those inputs */
+	rohc_packet_t packet;
+};
+
+
 /**
  * @brief The generic decompression context for RFC3095-based profiles
  *
@@ -185,6 +216,12 @@ struct rohc_comp_rfc3095_ctxt
 	/// A window used to encode the SN
 	struct c_wlsb *sn_window;
 
+	/** The memory block that stores the W-LSB encoding objects for the SN
+	 *  and the IP-IDs of the outer and inner IP headers, in that order */
+	uint8_t *wlsb_mem;
+	/** The size of one W-LSB encoding object in the memory block */
+	size_t wlsb_size;
+
 	/** The number of IP headers */
 	size_t ip_hdr_nr;
 	/// Information about the outer IP header
@@ -215,6 +252,11 @@ struct rohc_comp_rfc3095_ctxt
 	rohc_packet_t (*decide_FO_packet)(const struct rohc_comp_ctxt *context);
 	/** @brief The handler used to decide which packet to send in SO state */
 	rohc_packet_t (*decide_SO_packet)(const struct rohc_comp_ctxt *context);
+	/** Whether the decision of \ref decide_SO_packet only depends on the
+	 *  inputs recorded in \ref last_SO_decision, and may thus be reused */
+	bool is_SO_decision_cacheable;
+	/** The last decision of \ref decide_SO_packet */
+	struct rohc_comp_rfc3095_so_decision last_SO_decision;
 	/** The handler used to decide which extension to send */
 	rohc_ext_t (*decide_extension)(const struct rohc_comp_ctxt *context);
 
@@ -286,6 +328,9 @@ struct rohc_comp_rfc3095_ctxt
 	                               const uint8_t *const crc_table)
 		__attribute__((nonnull(1, 3, 6), warn_unused_result));
 
+	/** The CRC computed on the CRC-STATIC fields of the last UO* packets */
+	struct rohc_crc_static_cache crc_static;
+
 	/// Profile-specific data
 	void *specific;
 };
@@ -303,6 +348,25 @@ bool rohc_comp_rfc3095_create(struct rohc_comp_ctxt *const context,
 void rohc_comp_rfc3095_destroy(struct rohc_comp_ctxt *const context)
 	__attribute__((nonnull(1)));
 
+bool rohc_comp_rfc3095_snapshot(const struct rohc_comp_ctxt *const context,
+                                const rohc_snapshot_write_t write_cb,
+                                void *const priv)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+bool rohc_comp_rfc3095_restore(struct rohc_comp_ctxt *const context,
+                               const rohc_snapshot_read_t read_cb,
+                               void *const priv)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
+size_t rohc_comp_rfc3095_get_body_size(const struct rohc_comp *const comp)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+void rohc_comp_rfc3095_get_mem(const struct rohc_comp_ctxt *const context,
+                               struct rohc_ctxt_mem *const mem)
+	__attribute__((nonnull(1, 2)));
+void rohc_comp_rfc3095_set_wlsb_width(struct rohc_comp_ctxt *const context,
+                                      const size_t width)
+	__attribute__((nonnull(1)));
+
 bool rohc_comp_rfc3095_check_profile(const struct rohc_comp *const comp,
                                      const struct net_pkt *const packet)
 	__attribute__((warn_unused_result, nonnull(1, 2)));
@@ -38,13 +38,24 @@
 static uint8_t c_add_cid(const rohc_cid_t cid)
 	__attribute__((warn_unused_result, const));
 
+static inline int code_cid_values_tmpl(const rohc_cid_type_t cid_type,
+                                       const rohc_cid_t cid,
+                                       uint8_t *const dest,
+                                       const size_t dest_size,
+                                       size_t *const first_position)
+	__attribute__((warn_unused_result, nonnull(3, 5), always_inline));
+
 
 /*
  * Definitions of functions that may used by other ROHC modules
  */
 
 /**
- * @brief Build the CID part of the ROHC packets.
+ * @brief Build the CID part of the ROHC packets for one type of CID
+ *
+ * The type of CID is a constant in the callers generated by
+ * \ref CODE_CID_VALUES, so that the test on the type of CID is resolved
+ * at compile time.
  *
  * @param cid_type       The type of CID in use for the compression context:
  *                       ROHC_SMALL_CID or ROHC_LARGE_CID
@@ -56,11 +67,11 @@ static uint8_t c_add_cid(const rohc_cid_t cid)
  * @return               The position in the rohc-packet-under-build buffer
  *                       in case of success, -1 in case of error
  */
-int code_cid_values(const rohc_cid_type_t cid_type,
-                    const rohc_cid_t cid,
-                    uint8_t *const dest,
-                    const size_t dest_size,
-                    size_t *const first_position)
+static inline int code_cid_values_tmpl(const rohc_cid_type_t cid_type,
+                                       const rohc_cid_t cid,
+                                       uint8_t *const dest,
+                                       const size_t dest_size,
+                                       size_t *const first_position)
 {
 	size_t counter = 0;
 
@@ -117,6 +128,29 @@ error:
 }
 
 
+/**
+ * @brief Define the function that builds the CID part for one type of CID
+ *
+ * @param name      The name of the function to define
+ * @param cid_type  The type of CID the function handles
+ */
+#define CODE_CID_VALUES(name, cid_type) \
+	int name(const rohc_cid_t cid, \
+	         uint8_t *const dest, \
+	         const size_t dest_size, \
+	         size_t *const first_position) \
+	{ \
+		return code_cid_values_tmpl(cid_type, cid, dest, dest_size, \
+		                            first_position); \
+	}
+
+/** Build the Add-CID octet of the ROHC packets, if any */
+CODE_CID_VALUES(code_small_cid_values, ROHC_SMALL_CID)
+
+/** Build the large CID octets of the ROHC packets */
+CODE_CID_VALUES(code_large_cid_values, ROHC_LARGE_CID)
+
+
 /*
  * Definitions of private functions
  */
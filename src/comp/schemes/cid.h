@@ -35,12 +35,36 @@
  * Prototypes of functions that may used by other ROHC modules
  */
 
-int code_cid_values(const rohc_cid_type_t cid_type,
-                    const rohc_cid_t cid,
-                    uint8_t *const dest,
-                    const size_t dest_size,
-                    size_t *const first_position)
-	__attribute__((warn_unused_result, nonnull(3, 5)));
+/**
+ * @brief The function that builds the CID part of the ROHC packets
+ *
+ * One function exists for every type of CID, the compressor selects the one
+ * of its type of CID once at creation.
+ *
+ * @param cid            The value of the CID for the compression context
+ * @param dest           The rohc-packet-under-build buffer
+ * @param dest_size      The length of the rohc-packet-under-build buffer
+ * @param first_position OUT: The position of the first byte to be completed
+ *                       by other functions
+ * @return               The position in the rohc-packet-under-build buffer
+ *                       in case of success, -1 in case of error
+ */
+typedef int (*code_cid_values_t)(const rohc_cid_t cid,
+                                 uint8_t *const dest,
+                                 const size_t dest_size,
+                                 size_t *const first_position);
+
+int code_small_cid_values(const rohc_cid_t cid,
+                          uint8_t *const dest,
+                          const size_t dest_size,
+                          size_t *const first_position)
+	__attribute__((warn_unused_result, nonnull(2, 4)));
+
+int code_large_cid_values(const rohc_cid_t cid,
+                          uint8_t *const dest,
+                          const size_t dest_size,
+                          size_t *const first_position)
+	__attribute__((warn_unused_result, nonnull(2, 4)));
 
 
 #endif
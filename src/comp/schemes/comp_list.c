@@ -31,17 +31,19 @@
 #endif
 
 
-/** Print a warning trace for the given list compression context */
-#define rohc_comp_list_warn(list_ctxt, format, ...) \
-	rohc_warning(list_ctxt, ROHC_TRACE_COMP, (list_ctxt)->profile_id, \
-	             format, ##__VA_ARGS__)
-
-
-
 static bool build_ipv6_ext_pkt_list(struct list_comp *const comp,
                                     const struct ip_packet *const ip,
-                                    struct rohc_list *const pkt_list)
-	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+                                    const struct net_pkt_ip *const ip_desc,
+                                    struct rohc_list *const pkt_list,
+                                    bool *const items_changed)
+	__attribute__((warn_unused_result, nonnull(1, 2, 4, 5)));
+
+static const uint8_t * ipv6_ext_get_next(const struct ip_packet *const ip,
+                                         const struct net_pkt_ip *const ip_desc,
+                                         const uint8_t *const ext,
+                                         const size_t ext_pos,
+                                         uint8_t *const ext_type)
+	__attribute__((warn_unused_result, nonnull(1, 5)));
 
 static unsigned int rohc_list_get_nearest_list(const struct list_comp *const comp,
                                                const struct rohc_list *const pkt_list,
@@ -118,6 +120,347 @@ static int rohc_list_build_XIs_4(const struct list_comp *const comp,
                                  uint8_t *const first_4b_xi)
 	__attribute__((warn_unused_result, nonnull(1, 2, 4, 6)));
 
+static struct rohc_list * rohc_comp_list_new_list(struct list_comp *const comp)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+/** The state of one list compressor in a snapshot, followed by the items of
+ *  its translation table, then by its lists */
+struct rohc_comp_list_snapshot
+{
+	uint16_t ref_id;           /**< The ID of the reference list */
+	uint16_t cur_id;           /**< The ID of the current list */
+	uint16_t lists_nr;         /**< The number of lists that follow */
+	uint8_t is_ref_unchanged;  /**< See \ref list_comp::is_ref_unchanged */
+	uint8_t reserved;          /**< Always 0 */
+} __attribute__((packed));
+
+
+static size_t rohc_list_get_item_index(const struct list_comp *const comp,
+                                       const struct rohc_list_item *const item)
+	__attribute__((warn_unused_result, nonnull(1, 2), pure));
+
+
+/**
+ * @brief Initialize one list compressor
+ *
+ * The first lists and the data of the short items are stored in the given
+ * memory, the other ones are allocated when they are first used.
+ *
+ * @param comp            The list compressor to initialize
+ * @param mem             The memory for the first lists and the item data
+ * @param list_trans_nr   The number of uncompressed transmissions (L)
+ * @param trace_cb        The function to call for printing traces
+ * @param trace_cb_priv   An optional private context, may be NULL
+ * @param trace_level     The lowest level of the traces to print
+ * @param profile_id      The ID of the associated compression profile
+ */
+void rohc_comp_list_init(struct list_comp *const comp,
+                         struct list_comp_mem *const mem,
+                         const size_t list_trans_nr,
+                         rohc_trace_callback2_t trace_cb,
+                         void *const trace_cb_priv,
+                         const rohc_trace_level_t trace_level,
+                         const int profile_id)
+{
+	size_t i;
+
+	memset(comp, 0, sizeof(struct list_comp));
+
+	comp->ref_id = ROHC_LIST_GEN_ID_NONE;
+	comp->cur_id = ROHC_LIST_GEN_ID_NONE;
+	comp->is_ref_unchanged = false;
+
+	/* the lists are taken the first time their gen_id is used */
+	for(i = 0; i <= ROHC_LIST_COMP_GEN_ID_ANON; i++)
+	{
+		comp->lists[i] = NULL;
+	}
+	comp->mem = mem;
+	comp->mem_lists_nr = 0;
+	comp->may_alloc = true;
+
+	for(i = 0; i < ROHC_LIST_MAX_ITEM; i++)
+	{
+		rohc_list_item_reset(&comp->trans_table[i]);
+		comp->trans_table[i].data = mem->items_data[i];
+		comp->trans_table[i].data_max_len = ROHC_LIST_COMP_MEM_ITEM_LEN;
+	}
+
+	comp->list_trans_nr = list_trans_nr;
+
+	/* traces */
+	comp->trace_callback = trace_cb;
+	comp->trace_callback_priv = trace_cb_priv;
+	comp->trace_level = trace_level;
+	comp->profile_id = profile_id;
+}
+
+
+/**
+ * @brief Release the lists and the item data allocated by one list compressor
+ *
+ * @param comp  The list compressor
+ */
+void rohc_comp_list_fini(struct list_comp *const comp)
+{
+	const struct rohc_list *const mem_lists = comp->mem->lists;
+	size_t i;
+
+	for(i = 0; i <= ROHC_LIST_COMP_GEN_ID_ANON; i++)
+	{
+		if(comp->lists[i] < mem_lists ||
+		   comp->lists[i] >= (mem_lists + ROHC_LIST_COMP_MEM_LISTS))
+		{
+			free(comp->lists[i]);
+		}
+	}
+	for(i = 0; i < ROHC_LIST_MAX_ITEM; i++)
+	{
+		if(comp->trans_table[i].data == comp->mem->items_data[i])
+		{
+			comp->trans_table[i].data = NULL;
+		}
+		rohc_list_item_free(&comp->trans_table[i]);
+	}
+
+	memset(comp, 0, sizeof(struct list_comp));
+}
+
+
+/**
+ * @brief Save one list compressor in a snapshot
+ *
+ * The translation table and the lists are saved item by item and list by
+ * list, the lists refer to the items by their indexes.
+ *
+ * @param comp      The list compressor
+ * @param write_cb  The callback used to write the snapshot
+ * @param priv      The private context given to the callback
+ * @return          true if the list compressor was saved,
+ *                  false if the callback failed
+ */
+bool rohc_comp_list_snapshot(const struct list_comp *const comp,
+                             const rohc_snapshot_write_t write_cb,
+                             void *const priv)
+{
+	struct rohc_comp_list_snapshot record;
+	size_t i;
+
+	memset(&record, 0, sizeof(struct rohc_comp_list_snapshot));
+	record.ref_id = comp->ref_id;
+	record.cur_id = comp->cur_id;
+	record.is_ref_unchanged = comp->is_ref_unchanged;
+	for(i = 0; i <= ROHC_LIST_COMP_GEN_ID_ANON; i++)
+	{
+		if(comp->lists[i] != NULL)
+		{
+			record.lists_nr++;
+		}
+	}
+	if(!write_cb(priv, (uint8_t *) &record,
+	             sizeof(struct rohc_comp_list_snapshot)))
+	{
+		goto error;
+	}
+
+	for(i = 0; i < ROHC_LIST_MAX_ITEM; i++)
+	{
+		if(!rohc_list_item_snapshot(&comp->trans_table[i], write_cb, priv))
+		{
+			goto error;
+		}
+	}
+	for(i = 0; i <= ROHC_LIST_COMP_GEN_ID_ANON; i++)
+	{
+		if(comp->lists[i] != NULL &&
+		   !rohc_list_snapshot(comp->lists[i], comp->trans_table, write_cb, priv))
+		{
+			goto error;
+		}
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Restore one list compressor from a snapshot
+ *
+ * The list compressor shall be freshly initialized: its items and lists are
+ * taken from its memory first, then allocated like when they are used for
+ * the first time. On failure, the list compressor shall be released with
+ * \ref rohc_comp_list_fini.
+ *
+ * @param comp     The initialized list compressor
+ * @param read_cb  The callback used to read the snapshot
+ * @param priv     The private context given to the callback
+ * @return         true if the list compressor was restored,
+ *                 false if the snapshot is truncated or malformed, or if
+ *                 memory shall not or cannot be allocated
+ */
+bool rohc_comp_list_restore(struct list_comp *const comp,
+                            const rohc_snapshot_read_t read_cb,
+                            void *const priv)
+{
+	struct rohc_comp_list_snapshot record;
+	size_t i;
+
+	if(!read_cb(priv, (uint8_t *) &record,
+	            sizeof(struct rohc_comp_list_snapshot)))
+	{
+		goto error;
+	}
+
+	for(i = 0; i < ROHC_LIST_MAX_ITEM; i++)
+	{
+		struct rohc_list_item_snapshot item;
+
+		if(!read_cb(priv, (uint8_t *) &item,
+		            sizeof(struct rohc_list_item_snapshot)))
+		{
+			goto error;
+		}
+		if(item.length > ROHC_LIST_ITEM_DATA_MAX)
+		{
+			rohc_comp_list_warn(comp, "malformed list in snapshot: %u-byte "
+			                    "item #%zu", item.length, i);
+			goto error;
+		}
+		if(!rohc_comp_list_reserve_item(comp, i, item.length) ||
+		   !rohc_list_item_restore(&comp->trans_table[i], &item, read_cb, priv))
+		{
+			goto error;
+		}
+	}
+
+	for(i = 0; i < record.lists_nr; i++)
+	{
+		struct rohc_list_snapshot list;
+
+		if(!read_cb(priv, (uint8_t *) &list, sizeof(struct rohc_list_snapshot)))
+		{
+			goto error;
+		}
+		if(list.id > ROHC_LIST_COMP_GEN_ID_ANON || comp->lists[list.id] != NULL)
+		{
+			rohc_comp_list_warn(comp, "malformed list in snapshot: unexpected "
+			                    "list with gen_id %u", list.id);
+			goto error;
+		}
+		comp->lists[list.id] = rohc_comp_list_new_list(comp);
+		if(comp->lists[list.id] == NULL)
+		{
+			rohc_comp_list_warn(comp, "no memory for the list with gen_id %u",
+			                    list.id);
+			goto error;
+		}
+		if(!rohc_list_restore(comp->lists[list.id], comp->trans_table, &list))
+		{
+			rohc_comp_list_warn(comp, "malformed list in snapshot: list with "
+			                    "gen_id %u", list.id);
+			goto error;
+		}
+	}
+
+	/* the reference and current lists shall exist if any */
+	if((record.ref_id != ROHC_LIST_GEN_ID_NONE &&
+	    (record.ref_id > ROHC_LIST_COMP_GEN_ID_ANON ||
+	     comp->lists[record.ref_id] == NULL)) ||
+	   (record.cur_id != ROHC_LIST_GEN_ID_NONE &&
+	    (record.cur_id > ROHC_LIST_COMP_GEN_ID_ANON ||
+	     comp->lists[record.cur_id] == NULL)))
+	{
+		rohc_comp_list_warn(comp, "malformed list in snapshot: unknown "
+		                    "reference or current list");
+		goto error;
+	}
+	comp->ref_id = record.ref_id;
+	comp->cur_id = record.cur_id;
+	comp->is_ref_unchanged = !!record.is_ref_unchanged;
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Make room for the data of one item of the translation table
+ *
+ * The data that does not fit in the memory of the item is allocated, unless
+ * the list compressor shall not allocate memory.
+ *
+ * @param comp         The list compressor
+ * @param index_table  The index of the item in the translation table
+ * @param item_len     The length (in bytes) of the new data of the item
+ * @return             true if the item may hold the data,
+ *                     false if memory shall not or cannot be allocated
+ */
+bool rohc_comp_list_reserve_item(struct list_comp *const comp,
+                                 const size_t index_table,
+                                 const size_t item_len)
+{
+	struct rohc_list_item *const item = &(comp->trans_table[index_table]);
+	uint8_t *data;
+
+	if(item_len <= item->data_max_len || item_len > ROHC_LIST_ITEM_DATA_MAX)
+	{
+		return true;
+	}
+	if(!comp->may_alloc)
+	{
+		rohc_comp_list_warn(comp, "no memory for the %zu-byte item #%zu, and "
+		                    "memory shall not be allocated", item_len,
+		                    index_table);
+		return false;
+	}
+
+	/* keep the current data since the new data is compared with it */
+	data = malloc(item_len);
+	if(data == NULL)
+	{
+		return false;
+	}
+	memcpy(data, item->data, item->length);
+	if(item->data != comp->mem->items_data[index_table])
+	{
+		free(item->data);
+	}
+	item->data = data;
+	item->data_max_len = item_len;
+
+	return true;
+}
+
+
+/**
+ * @brief Get the memory for a new list
+ *
+ * The lists are taken from the memory given at creation first, then they
+ * are allocated unless the list compressor shall not allocate memory.
+ *
+ * @param comp  The list compressor
+ * @return      The memory for the new list, NULL if memory shall not or
+ *              cannot be allocated
+ */
+static struct rohc_list * rohc_comp_list_new_list(struct list_comp *const comp)
+{
+	if(comp->mem_lists_nr < ROHC_LIST_COMP_MEM_LISTS)
+	{
+		comp->mem_lists_nr++;
+		return &(comp->mem->lists[comp->mem_lists_nr - 1]);
+	}
+	if(!comp->may_alloc)
+	{
+		return NULL;
+	}
+
+	return malloc(sizeof(struct rohc_list));
+}
 
 
 /**
@@ -125,6 +468,9 @@ static int rohc_list_build_XIs_4(const struct list_comp *const comp,
  *
  * @param comp                       The list compressor
  * @param ip                         The IP packet to compress
+ * @param ip_desc                    The description of the IP header made
+ *                                   when the packet was parsed, NULL to walk
+ *                                   the extension headers again
  * @param[out] list_struct_changed   Whether the structure of the list changed
  * @param[out] list_content_changed  Whether the content of the list changed
  * @return                           true if no error occurred,
@@ -132,50 +478,105 @@ static int rohc_list_build_XIs_4(const struct list_comp *const comp,
  */
 bool detect_ipv6_ext_changes(struct list_comp *const comp,
                              const struct ip_packet *const ip,
+                             const struct net_pkt_ip *const ip_desc,
                              bool *const list_struct_changed,
                              bool *const list_content_changed)
 {
-	unsigned int new_cur_id = ROHC_LIST_GEN_ID_NONE;
 	struct rohc_list pkt_list;
-	bool is_new_list = false;
+	bool items_changed;
 
 	/* parse all extension headers:
 	 *  - update the related entries in the translation table,
 	 *  - create the list for the packet */
-	if(!build_ipv6_ext_pkt_list(comp, ip, &pkt_list))
+	if(!build_ipv6_ext_pkt_list(comp, ip, ip_desc, &pkt_list, &items_changed))
 	{
 		rohc_comp_list_warn(comp, "failed to build the list of extension headers "
 		                    "for the current packet");
 		goto error;
 	}
 
+	return rohc_list_detect_changes(comp, &pkt_list, items_changed,
+	                                list_struct_changed, list_content_changed);
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Detect changes between the list of the packet and the lists of the
+ *        list compressor
+ *
+ * The list of the packet references items of the translation table that
+ * were already updated with the items of the packet.
+ *
+ * @param comp                       The list compressor
+ * @param pkt_list                   The list of the current packet
+ * @param items_changed              Whether some items of the translation
+ *                                   table were updated for the packet
+ * @param[out] list_struct_changed   Whether the structure of the list changed
+ * @param[out] list_content_changed  Whether the content of the list changed
+ * @return                           true if no error occurred,
+ *                                   false if one error occurred
+ */
+bool rohc_list_detect_changes(struct list_comp *const comp,
+                              const struct rohc_list *const pkt_list,
+                              const bool items_changed,
+                              bool *const list_struct_changed,
+                              bool *const list_content_changed)
+{
+	unsigned int new_cur_id = ROHC_LIST_GEN_ID_NONE;
+	bool is_new_list = false;
+
 	/* now that translation table is updated and packet list is generated,
 	 * search for a context list with the same structure or use an anonymous
 	 * list */
-	new_cur_id = rohc_list_get_nearest_list(comp, &pkt_list, &is_new_list);
+	new_cur_id = rohc_list_get_nearest_list(comp, pkt_list, &is_new_list);
 	if(is_new_list)
 	{
+		/* the lists are taken the first time their gen_id is used */
+		if(comp->lists[new_cur_id] == NULL)
+		{
+			comp->lists[new_cur_id] = rohc_comp_list_new_list(comp);
+			if(comp->lists[new_cur_id] == NULL)
+			{
+				rohc_comp_list_warn(comp, "no memory for the list with gen_id %u",
+				                    new_cur_id);
+				goto error;
+			}
+			rohc_list_reset(comp->lists[new_cur_id]);
+			comp->lists[new_cur_id]->id = new_cur_id;
+		}
+
 		/* TODO: context should not be overwritten until compression is fully OK */
-		assert(comp->lists[new_cur_id].id == new_cur_id);
-		memcpy(comp->lists[new_cur_id].items, pkt_list.items,
+		assert(comp->lists[new_cur_id]->id == new_cur_id);
+		memcpy(comp->lists[new_cur_id]->items, pkt_list->items,
 		       ROHC_LIST_ITEMS_MAX * sizeof(struct rohc_list_item *));
-		comp->lists[new_cur_id].items_nr = pkt_list.items_nr;
-		comp->lists[new_cur_id].counter = 0;
+		comp->lists[new_cur_id]->items_nr = pkt_list->items_nr;
+		comp->lists[new_cur_id]->counter = 0;
 	}
 
 	/* do we need to send some bits of the compressed list? */
-	if(new_cur_id != comp->cur_id)
+	if(comp->is_ref_unchanged && new_cur_id == comp->cur_id &&
+	   new_cur_id == comp->ref_id && !items_changed)
+	{
+		/* same reference list as the last packet, all its items were already
+		 * known and none of them changed: no need to check the whole list
+		 * again, nothing of the list has to be transmitted */
+		*list_struct_changed = false;
+		*list_content_changed = false;
+	}
+	else if(new_cur_id != comp->cur_id)
 	{
-		rc_list_debug(comp, "send some bits for extension header list of the "
-		              "outer IPv6 header because it changed");
+		rc_list_debug(comp, "send some bits for the list because it changed");
 		*list_struct_changed = true;
 		*list_content_changed = true;
 	}
 	else if(new_cur_id != ROHC_LIST_GEN_ID_NONE &&
-	        comp->lists[new_cur_id].counter < comp->list_trans_nr)
+	        comp->lists[new_cur_id]->counter < comp->list_trans_nr)
 	{
-		rc_list_debug(comp, "send some bits for extension header list of the "
-		              "outer IPv6 header because it was not sent enough times");
+		rc_list_debug(comp, "send some bits for the list because it was not "
+		              "sent enough times");
 		*list_struct_changed = true;
 		*list_content_changed = false;
 	}
@@ -185,9 +586,9 @@ bool detect_ipv6_ext_changes(struct list_comp *const comp,
 
 		*list_struct_changed = false;
 		*list_content_changed = false;
-		for(i = 0; i < comp->lists[comp->cur_id].items_nr; i++)
+		for(i = 0; i < comp->lists[comp->cur_id]->items_nr; i++)
 		{
-			if(!comp->lists[comp->cur_id].items[i]->known)
+			if(!comp->lists[comp->cur_id]->items[i]->known)
 			{
 				*list_content_changed = true;
 				break;
@@ -195,14 +596,17 @@ bool detect_ipv6_ext_changes(struct list_comp *const comp,
 		}
 		if((*list_content_changed))
 		{
-			rc_list_debug(comp, "send some bits for extension header list of "
-			              "the outer IPv6 header because some of its items were "
-			              "not sent enough times");
+			rc_list_debug(comp, "send some bits for the list because some of its "
+			              "items were not sent enough times");
 		}
 	}
 
 	/* TODO: should not be overwritten until compression is fully OK */
 	comp->cur_id = new_cur_id;
+	comp->is_ref_unchanged = (new_cur_id != ROHC_LIST_GEN_ID_NONE &&
+	                          new_cur_id == comp->ref_id &&
+	                          !(*list_struct_changed) &&
+	                          !(*list_content_changed));
 
 	return true;
 
@@ -218,25 +622,34 @@ error:
  *  \li update the related entries in the translation table,
  *  \li create the list for the packet
  *
- * @param comp           The list compressor
- * @param ip             The IP packet to compress
- * @param[out] pkt_list  The list of extension headers for the current packet
- * @return               true if no error occurred,
- *                       false if one error occurred
+ * @param comp                The list compressor
+ * @param ip                  The IP packet to compress
+ * @param ip_desc             The description of the IP header made when the
+ *                            packet was parsed, NULL to walk the extension
+ *                            headers again
+ * @param[out] pkt_list       The list of extension headers for the current
+ *                            packet
+ * @param[out] items_changed  Whether some items of the translation table
+ *                            were updated
+ * @return                    true if no error occurred,
+ *                            false if one error occurred
  */
 static bool build_ipv6_ext_pkt_list(struct list_comp *const comp,
                                     const struct ip_packet *const ip,
-                                    struct rohc_list *const pkt_list)
+                                    const struct net_pkt_ip *const ip_desc,
+                                    struct rohc_list *const pkt_list,
+                                    bool *const items_changed)
 {
-	uint8_t ext_types_count[ROHC_IPPROTO_MAX + 1] = { 0 };
+	uint8_t ext_types_count[ROHC_IPPROTO_MAX + 1];
 	const uint8_t *ext;
 	uint8_t ext_type;
 
 	/* reset the list of the current packet */
 	rohc_list_reset(pkt_list);
+	*items_changed = false;
 
 	/* get the next known IP extension in packet */
-	ext = ip_get_next_ext_from_ip(ip, &ext_type);
+	ext = ipv6_ext_get_next(ip, ip_desc, NULL, 0, &ext_type);
 	if(ext == NULL)
 	{
 		/* there is no list of IPv6 extension headers in the current packet */
@@ -244,8 +657,10 @@ static bool build_ipv6_ext_pkt_list(struct list_comp *const comp,
 		goto skip;
 	}
 
-	/* there is one extension or more */
+	/* there is one extension or more, count them by type: most IPv6 packets
+	 * have no extension, so don't clear the counters for them */
 	rc_list_debug(comp, "there is at least one IPv6 extension in packet");
+	memset(ext_types_count, 0, sizeof(ext_types_count));
 
 	/* parse all extension headers:
 	 *  - update the related entries in the translation table,
@@ -277,6 +692,10 @@ static bool build_ipv6_ext_pkt_list(struct list_comp *const comp,
 		/* update item in translation table if it changed */
 		/* TODO: context should not be overwritten until compression is fully OK */
 		/* TODO: put comp const in params once context is not overwritten any more */
+		if(!rohc_comp_list_reserve_item(comp, index_table, comp->get_size(ext)))
+		{
+			goto error;
+		}
 		ret = rohc_list_item_update_if_changed(comp->cmp_item,
 		                                       &(comp->trans_table[index_table]),
 		                                       ext_type, ext, comp->get_size(ext));
@@ -292,6 +711,7 @@ static bool build_ipv6_ext_pkt_list(struct list_comp *const comp,
 			rc_list_debug(comp, "  entry #%d updated in translation table",
 			              index_table);
 			entry_changed = true;
+			*items_changed = true;
 		}
 
 		/* update current list in context */
@@ -305,7 +725,8 @@ static bool build_ipv6_ext_pkt_list(struct list_comp *const comp,
 		              comp->trans_table[index_table].known ? "known" : "not-yet-known",
 		              comp->trans_table[index_table].counter, comp->list_trans_nr);
 	}
-	while((ext = ip_get_next_ext_from_ext(ext, &ext_type)) != NULL &&
+	while((ext = ipv6_ext_get_next(ip, ip_desc, ext, pkt_list->items_nr,
+	                               &ext_type)) != NULL &&
 	      pkt_list->items_nr < ROHC_LIST_ITEMS_MAX);
 
 	/* too many extensions in packet? */
@@ -323,6 +744,47 @@ error:
 }
 
 
+/**
+ * @brief Get the next IPv6 extension header of the IP packet to compress
+ *
+ * The extension headers described when the packet was parsed are read from
+ * the description, the others are walked from the IP header.
+ *
+ * @param ip             The IP packet to compress
+ * @param ip_desc        The description of the IP header made when the packet
+ *                       was parsed, NULL to walk the extension headers again
+ * @param ext            The current extension header, NULL for the first one
+ * @param ext_pos        The position of the next extension header
+ * @param[out] ext_type  The type of the next extension header
+ * @return               The next extension header,
+ *                       NULL if there is no more extension
+ */
+static const uint8_t * ipv6_ext_get_next(const struct ip_packet *const ip,
+                                         const struct net_pkt_ip *const ip_desc,
+                                         const uint8_t *const ext,
+                                         const size_t ext_pos,
+                                         uint8_t *const ext_type)
+{
+	if(ip_desc != NULL)
+	{
+		if(ext_pos >= ip_desc->exts_nr)
+		{
+			return NULL;
+		}
+		*ext_type = ip_desc->exts[ext_pos].type;
+		return (ip_desc->data + ip_desc->exts[ext_pos].offset);
+	}
+	else if(ext == NULL)
+	{
+		return ip_get_next_ext_from_ip(ip, ext_type);
+	}
+	else
+	{
+		return ip_get_next_ext_from_ext(ext, ext_type);
+	}
+}
+
+
 /**
  * @brief Generic encoding of compressed list
  *
@@ -373,15 +835,15 @@ int rohc_list_encode(struct list_comp *const comp,
 		goto error;
 	}
 
-	if(comp->cur_id == ROHC_LIST_GEN_ID_ANON)
+	if(comp->cur_id == ROHC_LIST_COMP_GEN_ID_ANON)
 	{
 		rc_list_debug(comp, "send anonymous list for the #%zu time",
-		              comp->lists[comp->cur_id].counter + 1);
+		              comp->lists[comp->cur_id]->counter + 1);
 	}
 	else
 	{
 		rc_list_debug(comp, "send list with generation ID %u for the #%zu time",
-		              comp->cur_id, comp->lists[comp->cur_id].counter + 1);
+		              comp->cur_id, comp->lists[comp->cur_id]->counter + 1);
 	}
 
 	return counter;
@@ -412,14 +874,14 @@ void rohc_list_update_context(struct list_comp *const comp)
 
 	/* the items of the current list were sent once more, increment their
 	 * counters and check whether they are known or not */
-	for(i = 0; i < comp->lists[comp->cur_id].items_nr; i++)
+	for(i = 0; i < comp->lists[comp->cur_id]->items_nr; i++)
 	{
-		if(!comp->lists[comp->cur_id].items[i]->known)
+		if(!comp->lists[comp->cur_id]->items[i]->known)
 		{
-			comp->lists[comp->cur_id].items[i]->counter++;
-			if(comp->lists[comp->cur_id].items[i]->counter >= comp->list_trans_nr)
+			comp->lists[comp->cur_id]->items[i]->counter++;
+			if(comp->lists[comp->cur_id]->items[i]->counter >= comp->list_trans_nr)
 			{
-				comp->lists[comp->cur_id].items[i]->known = true;
+				comp->lists[comp->cur_id]->items[i]->known = true;
 			}
 		}
 	}
@@ -427,9 +889,9 @@ void rohc_list_update_context(struct list_comp *const comp)
 	/* current list was sent once more, do we update the reference list? */
 	if(comp->cur_id != comp->ref_id)
 	{
-		comp->lists[comp->cur_id].counter++;
-		if(comp->cur_id != ROHC_LIST_GEN_ID_ANON &&
-		   comp->lists[comp->cur_id].counter >= comp->list_trans_nr)
+		comp->lists[comp->cur_id]->counter++;
+		if(comp->cur_id != ROHC_LIST_COMP_GEN_ID_ANON &&
+		   comp->lists[comp->cur_id]->counter >= comp->list_trans_nr)
 		{
 			if(comp->ref_id != ROHC_LIST_GEN_ID_NONE)
 			{
@@ -477,7 +939,7 @@ static unsigned int rohc_list_get_nearest_list(const struct list_comp *const com
 
 	/* check the reference list first as it is probably the correct one */
 	if(comp->ref_id != ROHC_LIST_GEN_ID_NONE &&
-	   rohc_list_equal(pkt_list, &comp->lists[comp->ref_id]))
+	   rohc_list_equal(pkt_list, comp->lists[comp->ref_id]))
 	{
 		/* reference list matches, no need for a new list */
 		rc_list_debug(comp, "send reference list with gen_id = %u", comp->ref_id);
@@ -490,12 +952,12 @@ static unsigned int rohc_list_get_nearest_list(const struct list_comp *const com
 	/* search for an identified list that matches the packet one, avoid the
 	 * reference list that we already checked, stop on first unused list */
 	for(gen_id = 0; new_cur_id == ROHC_LIST_GEN_ID_NONE &&
-	                gen_id <= ROHC_LIST_GEN_ID_MAX &&
-	                comp->lists[gen_id].counter > 0; gen_id++)
+	                gen_id <= ROHC_LIST_COMP_GEN_ID_MAX &&
+	                comp->lists[gen_id] != NULL &&
+	                comp->lists[gen_id]->counter > 0; gen_id++)
 	{
 		if(gen_id != comp->ref_id &&
-		   comp->lists[gen_id].counter > 0 &&
-		   rohc_list_equal(pkt_list, &comp->lists[gen_id]))
+		   rohc_list_equal(pkt_list, comp->lists[gen_id]))
 		{
 			rc_list_debug(comp, "current list matches the existing list "
 			              "with gen_id %u", gen_id);
@@ -509,7 +971,7 @@ static unsigned int rohc_list_get_nearest_list(const struct list_comp *const com
 	{
 		rc_list_debug(comp, "send existing context list with gen_id %u "
 		              "(already sent %zu times)", new_cur_id,
-		              comp->lists[new_cur_id].counter);
+		              comp->lists[new_cur_id]->counter);
 		*is_new_list = false;
 		return new_cur_id;
 	}
@@ -529,27 +991,28 @@ static unsigned int rohc_list_get_nearest_list(const struct list_comp *const com
 	}
 
 	/* try to use an anonymous list */
-	if(comp->lists[ROHC_LIST_GEN_ID_ANON].counter == 0 ||
-	   !rohc_list_equal(pkt_list, &comp->lists[ROHC_LIST_GEN_ID_ANON]))
+	if(comp->lists[ROHC_LIST_COMP_GEN_ID_ANON] == NULL ||
+	   comp->lists[ROHC_LIST_COMP_GEN_ID_ANON]->counter == 0 ||
+	   !rohc_list_equal(pkt_list, comp->lists[ROHC_LIST_COMP_GEN_ID_ANON]))
 	{
 		/* new or changed anonymous list */
 		rc_list_debug(comp, "send current list as anonymous list (transmitted "
 		              "0 / %zu)", anon_thres);
 		*is_new_list = true;
-		return ROHC_LIST_GEN_ID_ANON;
+		return ROHC_LIST_COMP_GEN_ID_ANON;
 	}
 	rc_list_debug(comp, "current list matches last anonymous list");
 
 	/* anonymous list matches, either use it as an anonymous list another time
 	 * or promote it an identified list */
-	if((comp->lists[ROHC_LIST_GEN_ID_ANON].counter + 1) < anon_thres)
+	if((comp->lists[ROHC_LIST_COMP_GEN_ID_ANON]->counter + 1) < anon_thres)
 	{
 		/* too early to promote anonymous list to an identified list with a gen_id */
 		rc_list_debug(comp, "send current list as anonymous list (transmitted "
-		              "%zu / %zu)", comp->lists[ROHC_LIST_GEN_ID_ANON].counter,
+		              "%zu / %zu)", comp->lists[ROHC_LIST_COMP_GEN_ID_ANON]->counter,
 		              anon_thres);
 		*is_new_list = false;
-		return ROHC_LIST_GEN_ID_ANON;
+		return ROHC_LIST_COMP_GEN_ID_ANON;
 	}
 
 	/* promote anonymous list to an identified list with a gen_id:
@@ -557,25 +1020,26 @@ static unsigned int rohc_list_get_nearest_list(const struct list_comp *const com
 	 *  - if no unused list was found, get the next free gen_id
 	 *  - in all cases, avoid re-using ref_id */
 	for(gen_id = 0; new_cur_id == ROHC_LIST_GEN_ID_NONE &&
-	                gen_id <= ROHC_LIST_GEN_ID_MAX; gen_id++)
+	                gen_id <= ROHC_LIST_COMP_GEN_ID_MAX; gen_id++)
 	{
-		if(gen_id != comp->ref_id && comp->lists[gen_id].counter == 0)
+		if(gen_id != comp->ref_id &&
+		   (comp->lists[gen_id] == NULL || comp->lists[gen_id]->counter == 0))
 		{
 			new_cur_id = gen_id;
 		}
 	}
 	if(new_cur_id == ROHC_LIST_GEN_ID_NONE)
 	{
-		new_cur_id = gen_id % (ROHC_LIST_GEN_ID_MAX + 1);
+		new_cur_id = gen_id % (ROHC_LIST_COMP_GEN_ID_MAX + 1);
 		if(new_cur_id == comp->ref_id)
 		{
 			new_cur_id++;
-			new_cur_id %= (ROHC_LIST_GEN_ID_MAX + 1);
+			new_cur_id %= (ROHC_LIST_COMP_GEN_ID_MAX + 1);
 		}
 	}
 	rc_list_debug(comp, "the anonymous list is going to be transmitted for the "
 	              "%zu time, promote it to an identified list with gen_id = %u",
-	              comp->lists[ROHC_LIST_GEN_ID_ANON].counter + 1, new_cur_id);
+	              comp->lists[ROHC_LIST_COMP_GEN_ID_ANON]->counter + 1, new_cur_id);
 	*is_new_list = true;
 	return new_cur_id;
 }
@@ -602,7 +1066,7 @@ static int rohc_list_decide_type(struct list_comp *const comp)
 		              "reference list yet");
 		encoding_type = 0;
 	}
-	else if(comp->lists[comp->ref_id].items_nr == 0)
+	else if(comp->lists[comp->ref_id]->items_nr == 0)
 	{
 		/* empty reference list, so use encoding type 0 (RFC 4815, §5.7 reads
 		 * that encoding types 1, 2, and 3 must not be used with an empty
@@ -611,7 +1075,7 @@ static int rohc_list_decide_type(struct list_comp *const comp)
 		              "is the empty list");
 		encoding_type = 0;
 	}
-	else if(comp->lists[comp->cur_id].counter > 0)
+	else if(comp->lists[comp->cur_id]->counter > 0)
 	{
 		/* the structure of the list did not change, so use encoding type 0 */
 		rc_list_debug(comp, "use list encoding type 0 because the structure of "
@@ -619,14 +1083,14 @@ static int rohc_list_decide_type(struct list_comp *const comp)
 		              "changed)");
 		encoding_type = 0;
 	}
-	else if(comp->lists[comp->cur_id].items_nr <=
-	        comp->lists[comp->ref_id].items_nr)
+	else if(comp->lists[comp->cur_id]->items_nr <=
+	        comp->lists[comp->ref_id]->items_nr)
 	{
 		/* the structure of the list changed, there are fewer items in the
 		 * current list than in the reference list: are all the items of the
 		 * current list in the reference list? */
-		if(!rohc_list_supersede(&comp->lists[comp->ref_id],
-		                        &comp->lists[comp->cur_id]))
+		if(!rohc_list_supersede(comp->lists[comp->ref_id],
+		                        comp->lists[comp->cur_id]))
 		{
 			/* some items of the current list are not present in the reference
 			 * list, so the 'Remove Then Insert scheme' (type 3) is required
@@ -636,20 +1100,9 @@ static int rohc_list_decide_type(struct list_comp *const comp)
 		else
 		{
 			/* all the items of the current list are present in the reference
-			 * list, so the 'Removal Only scheme' (type 2) might be used to
-			 * encode the current list, but check before that all items of the
-			 * current list are known because encoding type 2 cannot update
-			 * items */
-			size_t k;
+			 * list, so the 'Removal Only scheme' (type 2) may be used to
+			 * encode the current list */
 			encoding_type = 2;
-			for(k = 0; k < comp->lists[comp->cur_id].items_nr; k++)
-			{
-				if(!comp->lists[comp->cur_id].items[k]->known)
-				{
-					encoding_type = 0;
-					break;
-				}
-			}
 		}
 	}
 	else
@@ -657,8 +1110,8 @@ static int rohc_list_decide_type(struct list_comp *const comp)
 		/* the structure of the list changed, there are more items in the
 		 * current list than in the reference list: are all the items of the
 		 * reference list in the current list? */
-		if(rohc_list_supersede(&comp->lists[comp->cur_id],
-		                       &comp->lists[comp->ref_id]))
+		if(rohc_list_supersede(comp->lists[comp->cur_id],
+		                       comp->lists[comp->ref_id]))
 		{
 			/* all the items of the reference list are present in the current
 			 * list, so the 'Insertion Only scheme' (type 1) may be used to
@@ -674,6 +1127,36 @@ static int rohc_list_decide_type(struct list_comp *const comp)
 		}
 	}
 
+	/* encoding types 1, 2 and 3 transmit neither the XI nor the content of
+	 * the items taken from the reference list, so check that all of them
+	 * are known because they cannot be updated */
+	if(encoding_type != 0)
+	{
+		const struct rohc_list *const cur_list = comp->lists[comp->cur_id];
+		const struct rohc_list *const ref_list = comp->lists[comp->ref_id];
+		size_t k;
+
+		for(k = 0; encoding_type != 0 && k < cur_list->items_nr; k++)
+		{
+			size_t ref_k;
+
+			if(cur_list->items[k]->known)
+			{
+				continue;
+			}
+			for(ref_k = 0; ref_k < ref_list->items_nr; ref_k++)
+			{
+				if(ref_list->items[ref_k] == cur_list->items[k])
+				{
+					rc_list_debug(comp, "use list encoding type 0 because item #%zu "
+					              "of the reference list is not known yet", ref_k);
+					encoding_type = 0;
+					break;
+				}
+			}
+		}
+	}
+
 	return encoding_type;
 }
 
@@ -751,14 +1234,12 @@ static int rohc_list_decide_type(struct list_comp *const comp)
  * @param comp     The list compressor
  * @param dest     The ROHC packet under build
  * @param counter  The current position in the rohc-packet-under-build buffer
- * @return         The new position in the rohc-packet-under-build buffer,
- *                 -1 in case of error
+ * @return         The new position in the rohc-packet-under-build buffer
  */
 static int rohc_list_encode_type_0(struct list_comp *const comp,
                                    uint8_t *const dest,
                                    int counter)
 {
-	uint8_t ext_types_count[ROHC_IPPROTO_MAX + 1] = { 0 };
 	const uint8_t et = 0; /* list encoding type 0 */
 	uint8_t gp;
 	size_t m; /* the number of elements in current list = number of XIs */
@@ -770,22 +1251,20 @@ static int rohc_list_encode_type_0(struct list_comp *const comp,
 	assert(dest != NULL);
 
 	/* retrieve the number of items in the current list */
-	m = comp->lists[comp->cur_id].items_nr;
+	m = comp->lists[comp->cur_id]->items_nr;
 	assert(m <= ROHC_LIST_ITEMS_MAX);
 
-	/* determine whether we should use 4-bit or 8-bit indexes */
+	/* determine whether we should use 4-bit or 8-bit indexes, every item of
+	 * the list is described by one XI */
 	{
-		uint8_t ins_mask[ROHC_LIST_ITEMS_MAX] = { 1 };
+		uint8_t ins_mask[ROHC_LIST_ITEMS_MAX];
 
-		ps = rohc_list_compute_ps(comp, &(comp->lists[comp->cur_id]), ins_mask, m);
-		if(ps != 0 && ps != 1)
-		{
-			goto error;
-		}
+		memset(ins_mask, 1, ROHC_LIST_ITEMS_MAX);
+		ps = rohc_list_compute_ps(comp, comp->lists[comp->cur_id], ins_mask, m);
 	}
 
 	/* part 1: ET, GP, PS, CC */
-	gp = (comp->cur_id != ROHC_LIST_GEN_ID_ANON);
+	gp = (comp->cur_id != ROHC_LIST_COMP_GEN_ID_ANON);
 	rc_list_debug(comp, "ET = %d, GP = %d, PS = %zu, CC = m = %zu",
 	              et, gp, ps, m);
 	dest[counter] = (et & 0x03) << 6;
@@ -811,21 +1290,8 @@ static int rohc_list_encode_type_0(struct list_comp *const comp,
 		/* write all XIs in packet */
 		for(k = 0; k < m; k++, counter++)
 		{
-			const struct rohc_list_item *const item = comp->lists[comp->cur_id].items[k];
-			int index_table;
-
-			/* one more occurrence of this item */
-			if(ext_types_count[item->type] >= 255)
-			{
-				rohc_comp_list_warn(comp, "too many IPv6 extension header of type 0x%02x",
-				                    item->type);
-				goto error;
-			}
-			ext_types_count[item->type]++;
-
-			index_table = comp->get_index_table(item->type, ext_types_count[item->type]);
-			assert(index_table >= 0);
-			assert(((size_t) index_table) < ROHC_LIST_MAX_ITEM);
+			const struct rohc_list_item *const item = comp->lists[comp->cur_id]->items[k];
+			const size_t index_table = rohc_list_get_item_index(comp, item);
 
 			dest[counter] = 0;
 			/* set the X bit if item is not already known */
@@ -848,21 +1314,8 @@ static int rohc_list_encode_type_0(struct list_comp *const comp,
 		/* write all XIs in packet 2 by 2 */
 		for(k = 0; k < m; k += 2, counter++)
 		{
-			const struct rohc_list_item *const item = comp->lists[comp->cur_id].items[k];
-			int index_table;
-
-			/* one more occurrence of this item */
-			if(ext_types_count[item->type] >= 255)
-			{
-				rohc_comp_list_warn(comp, "too many IPv6 extension header of type 0x%02x",
-				                    item->type);
-				goto error;
-			}
-			ext_types_count[item->type]++;
-
-			index_table = comp->get_index_table(item->type, ext_types_count[item->type]);
-			assert(index_table >= 0);
-			assert(((size_t) index_table) < ROHC_LIST_MAX_ITEM);
+			const struct rohc_list_item *const item = comp->lists[comp->cur_id]->items[k];
+			const size_t index_table = rohc_list_get_item_index(comp, item);
 
 			dest[counter] = 0;
 
@@ -883,22 +1336,8 @@ static int rohc_list_encode_type_0(struct list_comp *const comp,
 			if((k + 1) < m)
 			{
 				const struct rohc_list_item *const item2 =
-					comp->lists[comp->cur_id].items[k + 1];
-				int index_table2;
-
-				/* one more occurrence of this item */
-				if(ext_types_count[item2->type] >= 255)
-				{
-					rohc_comp_list_warn(comp, "too many IPv6 extension header of type "
-					                    "0x%02x", item2->type);
-					goto error;
-				}
-				ext_types_count[item2->type]++;
-
-				index_table2 =
-					comp->get_index_table(item2->type, ext_types_count[item2->type]);
-				assert(index_table2 >= 0);
-				assert(((size_t) index_table2) < ROHC_LIST_MAX_ITEM);
+					comp->lists[comp->cur_id]->items[k + 1];
+				const size_t index_table2 = rohc_list_get_item_index(comp, item2);
 
 				/* set the X bit if item is not already known */
 				if(!item2->known)
@@ -924,24 +1363,18 @@ static int rohc_list_encode_type_0(struct list_comp *const comp,
 	/* part 4: n items (only unknown items) */
 	for(k = 0; k < m; k++)
 	{
-		const struct rohc_list_item *const item = comp->lists[comp->cur_id].items[k];
+		const struct rohc_list_item *const item = comp->lists[comp->cur_id]->items[k];
 
 		/* copy the list element if not known yet */
 		if(!item->known)
 		{
 			rc_list_debug(comp, "add %zu-byte not-yet-known item #%zu in "
 			              "packet", item->length, k);
-			assert(item->length > 1);
-			dest[counter] = item->type & 0xff;
-			memcpy(dest + counter + 1, item->data + 1, item->length - 1);
-			counter += item->length;
+			counter += comp->write_item(item, dest + counter);
 		}
 	}
 
 	return counter;
-
-error:
-	return -1;
 }
 
 
@@ -1043,11 +1476,11 @@ static int rohc_list_encode_type_1(struct list_comp *const comp,
 	assert(dest != NULL);
 
 	/* retrieve the number of items in the current list */
-	m = comp->lists[comp->cur_id].items_nr;
+	m = comp->lists[comp->cur_id]->items_nr;
 	assert(m <= ROHC_LIST_ITEMS_MAX);
 
 	/* part 1: ET, GP (PS will be set later) */
-	gp = (comp->cur_id != ROHC_LIST_GEN_ID_ANON);
+	gp = (comp->cur_id != ROHC_LIST_COMP_GEN_ID_ANON);
 	rc_list_debug(comp, "ET = %d, GP = %d", et, gp);
 	dest[counter] = (et & 0x03) << 6;
 	dest[counter] |= (gp & 0x01) << 5;
@@ -1070,8 +1503,8 @@ static int rohc_list_encode_type_1(struct list_comp *const comp,
 
 	/* part 4: insertion mask */
 	ins_mask_len =
-		rohc_list_compute_ins_mask(comp, &(comp->lists[comp->ref_id]),
-		                           &(comp->lists[comp->cur_id]),
+		rohc_list_compute_ins_mask(comp, comp->lists[comp->ref_id],
+		                           comp->lists[comp->cur_id],
 		                           rem_mask, ins_mask,
 		                           dest + counter, 2 /* TODO */);
 	if(ins_mask_len != 1 && ins_mask_len != 2)
@@ -1082,17 +1515,13 @@ static int rohc_list_encode_type_1(struct list_comp *const comp,
 	counter += ins_mask_len;
 
 	/* determine whether we should use 4-bit or 8-bit indexes */
-	ps = rohc_list_compute_ps(comp, &(comp->lists[comp->cur_id]), ins_mask, m);
-	if(ps != 0 && ps != 1)
-	{
-		goto error;
-	}
+	ps = rohc_list_compute_ps(comp, comp->lists[comp->cur_id], ins_mask, m);
 
 	/* part 5: k XI (= X + Indexes) */
 	{
 		uint8_t first_4b_xi;
 
-		ret = rohc_list_build_XIs(comp, &(comp->lists[comp->cur_id]), ins_mask, ps,
+		ret = rohc_list_build_XIs(comp, comp->lists[comp->cur_id], ins_mask, ps,
 		                          dest + counter, m /* TODO */, &first_4b_xi);
 		if(ret < 0)
 		{
@@ -1104,13 +1533,17 @@ static int rohc_list_encode_type_1(struct list_comp *const comp,
 			assert((first_4b_xi & 0x0f) == first_4b_xi);
 			dest[ps_pos] |= first_4b_xi;
 		}
+		else
+		{
+			dest[ps_pos] |= (ps & 0x01) << 4;
+		}
 		counter += ret;
 	}
 
 	/* part 6: n items (only unknown items) */
 	for(k = 0; k < m; k++)
 	{
-		const struct rohc_list_item *const item = comp->lists[comp->cur_id].items[k];
+		const struct rohc_list_item *const item = comp->lists[comp->cur_id]->items[k];
 
 		/* skip element if it present in the reference list */
 		if(ins_mask[k] == 0 && item->known)
@@ -1125,10 +1558,7 @@ static int rohc_list_encode_type_1(struct list_comp *const comp,
 		{
 			rc_list_debug(comp, "add %zu-byte unknown item #%zu in packet",
 			              item->length, k);
-			assert(item->length > 1);
-			dest[counter] = item->type & 0xff;
-			memcpy(dest + counter + 1, item->data + 1, item->length - 1);
-			counter += item->length;
+			counter += comp->write_item(item, dest + counter);
 		}
 	}
 
@@ -1206,11 +1636,11 @@ static int rohc_list_encode_type_2(struct list_comp *const comp,
 	assert(dest != NULL);
 
 	/* retrieve the number of items in the reference list */
-	count = comp->lists[comp->ref_id].items_nr;
+	count = comp->lists[comp->ref_id]->items_nr;
 	assert(count <= ROHC_LIST_ITEMS_MAX);
 
 	/* part 1: ET, GP, res and Count */
-	gp = (comp->cur_id != ROHC_LIST_GEN_ID_ANON);
+	gp = (comp->cur_id != ROHC_LIST_COMP_GEN_ID_ANON);
 	rc_list_debug(comp, "ET = %d, GP = %d, Count = %zu", et, gp, count);
 	dest[counter] = (et & 0x03) << 6;
 	dest[counter] |= (gp & 0x01) << 5;
@@ -1233,8 +1663,8 @@ static int rohc_list_encode_type_2(struct list_comp *const comp,
 
 	/* part 4: removal mask */
 	rem_mask_len =
-		rohc_list_compute_rem_mask(comp, &(comp->lists[comp->ref_id]),
-		                           &(comp->lists[comp->cur_id]),
+		rohc_list_compute_rem_mask(comp, comp->lists[comp->ref_id],
+		                           comp->lists[comp->cur_id],
 		                           rem_mask, dest + counter, 2 /* TODO */);
 	if(rem_mask_len != 1 && rem_mask_len != 2)
 	{
@@ -1368,15 +1798,15 @@ static int rohc_list_encode_type_3(struct list_comp *const comp,
 	assert(dest != NULL);
 
 	/* retrieve the number of items in the reference list */
-	count = comp->lists[comp->ref_id].items_nr;
+	count = comp->lists[comp->ref_id]->items_nr;
 	assert(count <= ROHC_LIST_ITEMS_MAX);
 
 	/* retrieve the number of items in the current list */
-	m = comp->lists[comp->cur_id].items_nr;
+	m = comp->lists[comp->cur_id]->items_nr;
 	assert(m <= ROHC_LIST_ITEMS_MAX);
 
 	/* part 1: ET, GP (PS will be set later) */
-	gp = (comp->cur_id != ROHC_LIST_GEN_ID_ANON);
+	gp = (comp->cur_id != ROHC_LIST_COMP_GEN_ID_ANON);
 	rc_list_debug(comp, "ET = %d, GP = %d", et, gp);
 	dest[counter] = (et & 0x03) << 6;
 	dest[counter] |= (gp & 0x01) << 5;
@@ -1399,8 +1829,8 @@ static int rohc_list_encode_type_3(struct list_comp *const comp,
 
 	/* part 4: removal mask */
 	rem_mask_len =
-		rohc_list_compute_rem_mask(comp, &(comp->lists[comp->ref_id]),
-		                           &(comp->lists[comp->cur_id]),
+		rohc_list_compute_rem_mask(comp, comp->lists[comp->ref_id],
+		                           comp->lists[comp->cur_id],
 		                           rem_mask, dest + counter, 2 /* TODO */);
 	if(rem_mask_len != 1 && rem_mask_len != 2)
 	{
@@ -1411,8 +1841,8 @@ static int rohc_list_encode_type_3(struct list_comp *const comp,
 
 	/* part 5: insertion mask */
 	ins_mask_len =
-		rohc_list_compute_ins_mask(comp, &(comp->lists[comp->ref_id]),
-		                           &(comp->lists[comp->cur_id]),
+		rohc_list_compute_ins_mask(comp, comp->lists[comp->ref_id],
+		                           comp->lists[comp->cur_id],
 		                           rem_mask, ins_mask,
 		                           dest + counter, 2 /* TODO */);
 	if(ins_mask_len != 1 && ins_mask_len != 2)
@@ -1423,17 +1853,13 @@ static int rohc_list_encode_type_3(struct list_comp *const comp,
 	counter += ins_mask_len;
 
 	/* determine whether we should use 4-bit or 8-bit indexes */
-	ps = rohc_list_compute_ps(comp, &(comp->lists[comp->cur_id]), ins_mask, m);
-	if(ps != 0 && ps != 1)
-	{
-		goto error;
-	}
+	ps = rohc_list_compute_ps(comp, comp->lists[comp->cur_id], ins_mask, m);
 
 	/* part 6: k XI (= X + Indexes) */
 	{
 		uint8_t first_4b_xi;
 
-		ret = rohc_list_build_XIs(comp, &(comp->lists[comp->cur_id]), ins_mask, ps,
+		ret = rohc_list_build_XIs(comp, comp->lists[comp->cur_id], ins_mask, ps,
 		                          dest + counter, m /* TODO */, &first_4b_xi);
 		if(ret < 0)
 		{
@@ -1445,13 +1871,17 @@ static int rohc_list_encode_type_3(struct list_comp *const comp,
 			assert((first_4b_xi & 0x0f) == first_4b_xi);
 			dest[ps_pos] |= first_4b_xi;
 		}
+		else
+		{
+			dest[ps_pos] |= (ps & 0x01) << 4;
+		}
 		counter += ret;
 	}
 
 	/* part 7: n items (only unknown items) */
 	for(k = 0; k < m; k++)
 	{
-		const struct rohc_list_item *const item = comp->lists[comp->cur_id].items[k];
+		const struct rohc_list_item *const item = comp->lists[comp->cur_id]->items[k];
 
 		/* skip element if it present in the reference list */
 		if(ins_mask[k] == 0 && item->known)
@@ -1466,10 +1896,7 @@ static int rohc_list_encode_type_3(struct list_comp *const comp,
 		{
 			rc_list_debug(comp, "add %zu-byte unknown item #%zu in packet",
 			              item->length, k);
-			assert(item->length > 1);
-			dest[counter] = item->type & 0xff;
-			memcpy(dest + counter + 1, item->data + 1, item->length - 1);
-			counter += item->length;
+			counter += comp->write_item(item, dest + counter);
 		}
 	}
 
@@ -1668,7 +2095,7 @@ static size_t rohc_list_compute_rem_mask(const struct list_comp *const comp,
 	}
 
 	/* first byte of the removal mask */
-	for(k = 0, ref_k = 0; ref_k < ref_m && ref_k < 8; ref_k++)
+	for(k = 0, ref_k = 0; ref_k < ref_m && ref_k < 7; ref_k++)
 	{
 		if(k < m && ref_list->items[ref_k] == cur_list->items[k])
 		{
@@ -1738,41 +2165,20 @@ error:
  * @param mask  The insertion mask for the list
  * @param m     The number of elements in current list
  * @return      0 for 4-bit indexes,
- *              1 for 8-bit indexes,
- *              2 for error
+ *              1 for 8-bit indexes
  */
 static uint8_t rohc_list_compute_ps(const struct list_comp *const comp,
                                     const struct rohc_list *const list,
                                     const uint8_t mask[ROHC_LIST_ITEMS_MAX],
                                     const size_t m)
 {
-	uint8_t ext_types_count[ROHC_IPPROTO_MAX + 1] = { 0 };
 	uint8_t ps = 0; /* 4-bit indexes by default */
 	size_t k;
 
 	for(k = 0; k < m && ps == 0; k++)
 	{
 		const struct rohc_list_item *const item = list->items[k];
-		int index_table;
-
-		/* one more occurrence of this item */
-		if(ext_types_count[item->type] >= 255)
-		{
-			rohc_comp_list_warn(comp, "too many IPv6 extension header of type 0x%02x",
-			                    item->type);
-			goto error;
-		}
-		ext_types_count[item->type]++;
-
-		/* get the index corresponding to the item type and the number of
-		 * occurrences */
-		index_table = comp->get_index_table(item->type, ext_types_count[item->type]);
-		if(index_table < 0 || ((size_t) index_table) >= ROHC_LIST_MAX_ITEM)
-		{
-			rohc_comp_list_warn(comp, "failed to handle unknown IPv6 extension "
-			                    "header of type 0x%02x", item->type);
-			goto error;
-		}
+		const size_t index_table = rohc_list_get_item_index(comp, item);
 
 		if((mask[k] != 0 || !item->known) && index_table > 0x07)
 		{
@@ -1781,9 +2187,6 @@ static uint8_t rohc_list_compute_ps(const struct list_comp *const comp,
 	}
 
 	return ps;
-
-error:
-	return 2;
 }
 
 
@@ -1837,7 +2240,6 @@ static int rohc_list_build_XIs_8(const struct list_comp *const comp,
                                  uint8_t *const rohc_data,
                                  const size_t rohc_max_len)
 {
-	uint8_t ext_types_count[ROHC_IPPROTO_MAX + 1] = { 0 };
 	const size_t m = list->items_nr;
 	size_t xi_len = 0;
 	size_t k;
@@ -1847,20 +2249,7 @@ static int rohc_list_build_XIs_8(const struct list_comp *const comp,
 	for(k = 0; k < m; k++)
 	{
 		const struct rohc_list_item *const item = list->items[k];
-		int index_table;
-
-		/* one more occurrence of this item */
-		if(ext_types_count[item->type] >= 255)
-		{
-			rohc_comp_list_warn(comp, "too many IPv6 extension header of type 0x%02x",
-			                    item->type);
-			goto error;
-		}
-		ext_types_count[item->type]++;
-
-		index_table = comp->get_index_table(item->type, ext_types_count[item->type]);
-		assert(index_table >= 0);
-		assert(((size_t) index_table) < ROHC_LIST_MAX_ITEM);
+		const size_t index_table = rohc_list_get_item_index(comp, item);
 
 		/* skip element if it present in the reference list and compressor
 		 * is confident that item is known by decompressor */
@@ -1920,7 +2309,6 @@ static int rohc_list_build_XIs_4(const struct list_comp *const comp,
                                  const size_t rohc_max_len,
                                  uint8_t *const first_4b_xi)
 {
-	uint8_t ext_types_count[ROHC_IPPROTO_MAX + 1] = { 0 };
 	const size_t m = list->items_nr;
 	size_t xi_index = 0;
 	size_t xi_len = 0;
@@ -1931,20 +2319,7 @@ static int rohc_list_build_XIs_4(const struct list_comp *const comp,
 	for(k = 0; k < m; k++)
 	{
 		const struct rohc_list_item *const item = list->items[k];
-		int index_table;
-
-		/* one more occurrence of this item */
-		if(ext_types_count[item->type] >= 255)
-		{
-			rohc_comp_list_warn(comp, "too many IPv6 extension header of type 0x%02x",
-			                    item->type);
-			goto error;
-		}
-		ext_types_count[item->type]++;
-
-		index_table = comp->get_index_table(item->type, ext_types_count[item->type]);
-		assert(index_table >= 0);
-		assert(((size_t) index_table) < ROHC_LIST_MAX_ITEM);
+		const size_t index_table = rohc_list_get_item_index(comp, item);
 
 		/* skip element if it present in the reference list and compressor
 		 * is confident that item is known by decompressor */
@@ -2039,3 +2414,22 @@ error:
 	return -1;
 }
 
+
+/**
+ * @brief Get the index of the given item in the translation table
+ *
+ * The lists of the compressor only reference items of the translation table,
+ * so the index of one item is its position in the table.
+ *
+ * @param comp  The list compressor
+ * @param item  The item of the translation table
+ * @return      The index of the item in the translation table
+ */
+static size_t rohc_list_get_item_index(const struct list_comp *const comp,
+                                       const struct rohc_list_item *const item)
+{
+	assert(item >= comp->trans_table);
+	assert(item < (comp->trans_table + ROHC_LIST_MAX_ITEM));
+
+	return (item - comp->trans_table);
+}
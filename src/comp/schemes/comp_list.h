@@ -27,6 +27,7 @@
 #define ROHC_COMP_LIST_H
 
 #include "ip.h"
+#include "net_pkt.h"
 #include "rohc_list.h"
 #include "rohc_traces_internal.h"
 
@@ -35,6 +36,47 @@
 	rohc_debug(comp_list, ROHC_TRACE_COMP, (comp_list)->profile_id, \
 	           format, ##__VA_ARGS__)
 
+/** Print a warning trace for the given list compression context */
+#define rohc_comp_list_warn(list_ctxt, format, ...) \
+	rohc_warning(list_ctxt, ROHC_TRACE_COMP, (list_ctxt)->profile_id, \
+	             format, ##__VA_ARGS__)
+
+
+/** The largest gen_id given by the compressor to its lists, small contexts
+ *  cycle through a few identified lists only (the decompressor accepts any
+ *  gen_id) */
+#if ROHC_SMALL_CONTEXTS == 1
+#  define ROHC_LIST_COMP_GEN_ID_MAX  0x0fU
+#else
+#  define ROHC_LIST_COMP_GEN_ID_MAX  ROHC_LIST_GEN_ID_MAX
+#endif
+/** The slot of the anonymous list in the lists of the compressor */
+#define ROHC_LIST_COMP_GEN_ID_ANON  (ROHC_LIST_COMP_GEN_ID_MAX + 1)
+
+
+/** The number of lists held by the memory of a list compressor: the
+ *  identified lists with the first gen_ids used, and the anonymous list */
+#define ROHC_LIST_COMP_MEM_LISTS  3U
+/** The length (in bytes) of the item data held by the memory of a list
+ *  compressor for every entry of its translation table */
+#define ROHC_LIST_COMP_MEM_ITEM_LEN  32U
+
+
+/**
+ * @brief The memory given to a list compressor when it is created
+ *
+ * The memory lives in the body of the compression context, so that the list
+ * compressor does not allocate memory for its first lists nor for its short
+ * items.
+ */
+struct list_comp_mem
+{
+	/** The first lists used by the list compressor */
+	struct rohc_list lists[ROHC_LIST_COMP_MEM_LISTS];
+	/** The data of the items of the translation table */
+	uint8_t items_data[ROHC_LIST_MAX_ITEM][ROHC_LIST_COMP_MEM_ITEM_LEN];
+};
+
 
 /**
  * @brief The list compressor
@@ -44,18 +86,30 @@ struct list_comp
 	/** The translation table */
 	struct rohc_list_item trans_table[ROHC_LIST_MAX_ITEM];
 
-	/* All the possible named lists, indexed by gen_id */
-	struct rohc_list lists[ROHC_LIST_GEN_ID_MAX + 2];
+	/** All the possible named lists, indexed by gen_id, allocated the first
+	 *  time their gen_id is used (NULL before) */
+	struct rohc_list *lists[ROHC_LIST_COMP_GEN_ID_ANON + 1];
 
 	/** The ID of the reference list */
 	unsigned int ref_id;
 	/** The ID of the current list */
 	unsigned int cur_id; /* TODO: should not be overwritten until compression
 	                              is fully OK */
+	/** Whether the list of the last packet was the reference list with all
+	 *  its items known, ie. nothing of the list had to be transmitted */
+	bool is_ref_unchanged;
 
 	/** The number of uncompressed transmissions for list compression (L) */
 	size_t list_trans_nr;
 
+	/** The memory given at creation for the first lists and the item data */
+	struct list_comp_mem *mem;
+	/** The number of lists taken from the given memory */
+	size_t mem_lists_nr;
+	/** Whether the lists and the item data that do not fit in the given
+	 *  memory may be allocated (see \ref ROHC_COMP_FEATURE_NO_ALLOC) */
+	bool may_alloc;
+
 	/* Functions for handling the data to compress */
 
 	/// @brief the handler used to get the index of an item
@@ -68,22 +122,63 @@ struct list_comp
 	/** The handler used to compare two items */
 	rohc_list_item_cmp cmp_item;
 
+	/** The handler used to write one item in the compressed list */
+	size_t (*write_item)(const struct rohc_list_item *const item,
+	                     uint8_t *const dest);
+
 	/* Traces */
 
 	/** The callback function used to manage traces */
 	rohc_trace_callback2_t trace_callback;
 	/** The private context of the callback function used to manage traces */
 	void *trace_callback_priv;
+	/** The lowest level of the traces passed to the callback function */
+	rohc_trace_level_t trace_level;
 	/** The profile ID the compression list was created for */
 	int profile_id;
 };
 
 
+void rohc_comp_list_init(struct list_comp *const comp,
+                         struct list_comp_mem *const mem,
+                         const size_t list_trans_nr,
+                         rohc_trace_callback2_t trace_cb,
+                         void *const trace_cb_priv,
+                         const rohc_trace_level_t trace_level,
+                         const int profile_id)
+	__attribute__((nonnull(1, 2)));
+
+void rohc_comp_list_fini(struct list_comp *const comp)
+	__attribute__((nonnull(1)));
+
+bool rohc_comp_list_snapshot(const struct list_comp *const comp,
+                             const rohc_snapshot_write_t write_cb,
+                             void *const priv)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
+bool rohc_comp_list_restore(struct list_comp *const comp,
+                            const rohc_snapshot_read_t read_cb,
+                            void *const priv)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
+bool rohc_comp_list_reserve_item(struct list_comp *const comp,
+                                 const size_t index_table,
+                                 const size_t item_len)
+	__attribute__((warn_unused_result, nonnull(1)));
+
 bool detect_ipv6_ext_changes(struct list_comp *const comp,
                              const struct ip_packet *const ip,
+                             const struct net_pkt_ip *const ip_desc,
                              bool *const list_struct_changed,
                              bool *const list_content_changed)
-	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4)));
+	__attribute__((warn_unused_result, nonnull(1, 2, 4, 5)));
+
+bool rohc_list_detect_changes(struct list_comp *const comp,
+                              const struct rohc_list *const pkt_list,
+                              const bool items_changed,
+                              bool *const list_struct_changed,
+                              bool *const list_content_changed)
+	__attribute__((warn_unused_result, nonnull(1, 2, 4, 5)));
 
 int rohc_list_encode(struct list_comp *const comp,
                      uint8_t *const dest,
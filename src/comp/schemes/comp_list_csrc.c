@@ -0,0 +1,314 @@
+/*
+ * Copyright 2026 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   schemes/comp_list_csrc.c
+ * @brief  ROHC list compression of RTP CSRC identifiers
+ * @author Didier Barvaux <didier@barvaux.org>
+ *
+ * The CSRC identifiers have no type to derive their index in the translation
+ * table from: every CSRC identifier keeps the entry it was given the first
+ * time it was seen, as long as the entry is not needed for another one. The
+ * CSRC identifiers of a conference thus keep their indexes while speakers
+ * join and leave, and the lists are sent with their few changes only.
+ */
+
+#include "schemes/comp_list_csrc.h"
+#include "rohc_comp_internals.h"
+
+#ifndef __KERNEL__
+#  include <string.h>
+#endif
+#include <assert.h>
+
+
+static bool cmp_csrc(const struct rohc_list_item *const item,
+                     const uint8_t ext_type,
+                     const uint8_t *const ext_data,
+                     const size_t ext_len)
+	__attribute__((warn_unused_result, nonnull(1, 3)));
+
+static size_t write_csrc(const struct rohc_list_item *const item,
+                         uint8_t *const dest)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
+static size_t csrc_get_index_table(struct list_comp *const comp,
+                                   const struct rohc_list *const pkt_list,
+                                   const uint8_t *const csrc)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+
+static bool rohc_list_has_item(const struct rohc_list *const list,
+                               const struct rohc_list_item *const item)
+	__attribute__((warn_unused_result, nonnull(1, 2), pure));
+
+
+/**
+ * @brief Create one context for compressing lists of CSRC identifiers
+ *
+ * @param comp            The context to create
+ * @param mem             The memory for the first lists and the item data
+ * @param list_trans_nr   The number of uncompressed transmissions (L)
+ * @param trace_cb        The function to call for printing traces
+ * @param trace_cb_priv   An optional private context, may be NULL
+ * @param trace_level     The lowest level of the traces to print
+ * @param profile_id      The ID of the associated compression profile
+ */
+void rohc_comp_list_csrc_new(struct list_comp *const comp,
+                             struct list_comp_mem *const mem,
+                             const size_t list_trans_nr,
+                             rohc_trace_callback2_t trace_cb,
+                             void *const trace_cb_priv,
+                             const rohc_trace_level_t trace_level,
+                             const int profile_id)
+{
+	rohc_comp_list_init(comp, mem, list_trans_nr, trace_cb, trace_cb_priv,
+	                    trace_level, profile_id);
+
+	/* specific callbacks for CSRC identifiers, their indexes are not derived
+	 * from a type */
+	comp->get_size = NULL;
+	comp->get_index_table = NULL;
+	comp->cmp_item = cmp_csrc;
+	comp->write_item = write_csrc;
+}
+
+
+/**
+ * @brief Free one context for compressing lists of CSRC identifiers
+ *
+ * @param comp  The context to destroy
+ */
+void rohc_comp_list_csrc_free(struct list_comp *const comp)
+{
+	rohc_comp_list_fini(comp);
+}
+
+
+/**
+ * @brief Detect changes within the list of CSRC identifiers
+ *
+ * @param comp                       The list compressor
+ * @param rtp                        The RTP header followed by its CSRC
+ *                                   identifiers
+ * @param[out] list_struct_changed   Whether the structure of the list changed
+ * @param[out] list_content_changed  Whether the content of the list changed
+ * @return                           true if no error occurred,
+ *                                   false if one error occurred
+ */
+bool detect_csrc_changes(struct list_comp *const comp,
+                         const struct rtphdr *const rtp,
+                         bool *const list_struct_changed,
+                         bool *const list_content_changed)
+{
+	const uint8_t *const csrcs = (const uint8_t *) (rtp + 1);
+	struct rohc_list pkt_list;
+	bool items_changed = false;
+	size_t i;
+
+	assert(rtp->cc <= ROHC_LIST_MAX_ITEM);
+	assert(rtp->cc <= ROHC_LIST_ITEMS_MAX);
+
+	/* the flows without any CSRC identifier so far send no list at all */
+	if(rtp->cc == 0 && comp->cur_id == ROHC_LIST_GEN_ID_NONE)
+	{
+		*list_struct_changed = false;
+		*list_content_changed = false;
+		return true;
+	}
+
+	/* give every CSRC identifier its entry in the translation table and
+	 * create the list for the packet */
+	rohc_list_reset(&pkt_list);
+	for(i = 0; i < rtp->cc; i++)
+	{
+		const uint8_t *const csrc = csrcs + i * sizeof(uint32_t);
+		const size_t index_table = csrc_get_index_table(comp, &pkt_list, csrc);
+		int ret;
+
+		if(!rohc_comp_list_reserve_item(comp, index_table, sizeof(uint32_t)))
+		{
+			goto error;
+		}
+		ret = rohc_list_item_update_if_changed(comp->cmp_item,
+		                                       &(comp->trans_table[index_table]),
+		                                       0, csrc, sizeof(uint32_t));
+		if(ret < 0)
+		{
+			rohc_comp_list_warn(comp, "failed to update entry #%zu in translation "
+			                    "table with CSRC #%zu", index_table, i + 1);
+			goto error;
+		}
+		else if(ret == 1)
+		{
+			rc_list_debug(comp, "  entry #%zu updated in translation table",
+			              index_table);
+			items_changed = true;
+		}
+
+		pkt_list.items[pkt_list.items_nr] = &(comp->trans_table[index_table]);
+		pkt_list.items_nr++;
+
+		rc_list_debug(comp, "  CSRC #%zu uses entry #%zu in translation table "
+		              "(entry sent %zu/%zu times)", pkt_list.items_nr, index_table,
+		              comp->trans_table[index_table].counter, comp->list_trans_nr);
+	}
+
+	return rohc_list_detect_changes(comp, &pkt_list, items_changed,
+	                                list_struct_changed, list_content_changed);
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get the entry of the translation table for the given CSRC
+ *
+ * The entry that already holds the CSRC identifier is preferred (one CSRC
+ * identifier present twice in the packet uses two entries), then one unused
+ * entry, then one entry that neither the list of the packet nor the
+ * reference list use. If all the other entries are used by the reference
+ * list, the reference list is given up: the next list is then sent without
+ * reference.
+ *
+ * @param comp      The list compressor
+ * @param pkt_list  The list of the packet built so far
+ * @param csrc      The CSRC identifier
+ * @return          The index of the entry in the translation table
+ */
+static size_t csrc_get_index_table(struct list_comp *const comp,
+                                   const struct rohc_list *const pkt_list,
+                                   const uint8_t *const csrc)
+{
+	const struct rohc_list *const ref_list =
+		(comp->ref_id != ROHC_LIST_GEN_ID_NONE ? comp->lists[comp->ref_id] : NULL);
+	size_t index_table;
+
+	/* the entry that already holds the CSRC identifier, unless one previous
+	 * CSRC of the packet already uses it */
+	for(index_table = 0; index_table < ROHC_LIST_MAX_ITEM; index_table++)
+	{
+		if(comp->trans_table[index_table].length > 0 &&
+		   comp->cmp_item(&comp->trans_table[index_table], 0, csrc,
+		                  sizeof(uint32_t)) &&
+		   !rohc_list_has_item(pkt_list, &comp->trans_table[index_table]))
+		{
+			return index_table;
+		}
+	}
+
+	/* one unused entry */
+	for(index_table = 0; index_table < ROHC_LIST_MAX_ITEM; index_table++)
+	{
+		if(comp->trans_table[index_table].length == 0)
+		{
+			return index_table;
+		}
+	}
+
+	/* one entry that neither the packet list nor the reference list use */
+	for(index_table = 0; index_table < ROHC_LIST_MAX_ITEM; index_table++)
+	{
+		const struct rohc_list_item *const item = &comp->trans_table[index_table];
+
+		if(!rohc_list_has_item(pkt_list, item) &&
+		   (ref_list == NULL || !rohc_list_has_item(ref_list, item)))
+		{
+			return index_table;
+		}
+	}
+
+	/* one entry that the packet list does not use, the packet list holds
+	 * fewer items than the translation table */
+	for(index_table = 0; index_table < ROHC_LIST_MAX_ITEM; index_table++)
+	{
+		if(!rohc_list_has_item(pkt_list, &comp->trans_table[index_table]))
+		{
+			break;
+		}
+	}
+	assert(index_table < ROHC_LIST_MAX_ITEM);
+	rc_list_debug(comp, "translation table full, give up the reference list "
+	              "with gen_id %u to re-use entry #%zu", comp->ref_id, index_table);
+	comp->ref_id = ROHC_LIST_GEN_ID_NONE;
+	comp->is_ref_unchanged = false;
+
+	return index_table;
+}
+
+
+/**
+ * @brief Is the given item part of the given list?
+ *
+ * @param list  The list
+ * @param item  The item of the translation table
+ * @return      true if the list references the item, false otherwise
+ */
+static bool rohc_list_has_item(const struct rohc_list *const list,
+                               const struct rohc_list_item *const item)
+{
+	size_t i;
+
+	for(i = 0; i < list->items_nr; i++)
+	{
+		if(list->items[i] == item)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+/**
+ * @brief Compare two CSRC items
+ *
+ * @param item      The CSRC item to compare
+ * @param ext_type  The type of the item, unused for CSRC items
+ * @param ext_data  The CSRC identifier
+ * @param ext_len   The length (in bytes) of the CSRC identifier
+ * @return          true if the two items are equal,
+ *                  false if they are different
+ */
+static bool cmp_csrc(const struct rohc_list_item *const item,
+                     const uint8_t ext_type __attribute__((unused)),
+                     const uint8_t *const ext_data,
+                     const size_t ext_len)
+{
+	return (item->length == ext_len &&
+	        memcmp(item->data, ext_data, ext_len) == 0);
+}
+
+
+/**
+ * @brief Write one CSRC item in the compressed list
+ *
+ * @param item  The CSRC item to write
+ * @param dest  The compressed list under build
+ * @return      The length of the item in the compressed list
+ */
+static size_t write_csrc(const struct rohc_list_item *const item,
+                         uint8_t *const dest)
+{
+	assert(item->length == sizeof(uint32_t));
+	memcpy(dest, item->data, item->length);
+
+	return item->length;
+}
+
@@ -0,0 +1,51 @@
+/*
+ * Copyright 2026 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   schemes/comp_list_csrc.h
+ * @brief  ROHC list compression of RTP CSRC identifiers
+ * @author Didier Barvaux <didier@barvaux.org>
+ */
+
+#ifndef ROHC_COMP_LIST_CSRC_H
+#define ROHC_COMP_LIST_CSRC_H
+
+#include "schemes/comp_list.h"
+#include "protocols/rtp.h"
+
+
+void rohc_comp_list_csrc_new(struct list_comp *const comp,
+                             struct list_comp_mem *const mem,
+                             const size_t list_trans_nr,
+                             rohc_trace_callback2_t trace_cb,
+                             void *const trace_cb_priv,
+                             const rohc_trace_level_t trace_level,
+                             const int profile_id)
+	__attribute__((nonnull(1, 2)));
+
+void rohc_comp_list_csrc_free(struct list_comp *const comp)
+	__attribute__((nonnull(1)));
+
+bool detect_csrc_changes(struct list_comp *const comp,
+                         const struct rtphdr *const rtp,
+                         bool *const list_struct_changed,
+                         bool *const list_content_changed)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4)));
+
+#endif
+
@@ -24,6 +24,7 @@
  */
 
 #include "schemes/comp_list_ipv6.h"
+#include "rohc_alloc.h"
 
 #ifndef __KERNEL__
 #  include <string.h>
@@ -40,51 +41,38 @@ static bool cmp_ipv6_ext(const struct rohc_list_item *const item,
                          const size_t ext_len)
 	__attribute__((warn_unused_result, nonnull(1, 3)));
 
+static size_t write_ipv6_ext(const struct rohc_list_item *const item,
+                             uint8_t *const dest)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
 
 /**
  * @brief Create one context for compressing lists of IPv6 extension headers
  *
  * @param comp            The context to create
+ * @param mem             The memory for the first lists and the item data
  * @param list_trans_nr   The number of uncompressed transmissions (L)
  * @param trace_cb        The function to call for printing traces
  * @param trace_cb_priv   An optional private context, may be NULL
+ * @param trace_level     The lowest level of the traces to print
  * @param profile_id      The ID of the associated decompression profile
  */
 void rohc_comp_list_ipv6_new(struct list_comp *const comp,
+                             struct list_comp_mem *const mem,
                              const size_t list_trans_nr,
                              rohc_trace_callback2_t trace_cb,
                              void *const trace_cb_priv,
+                             const rohc_trace_level_t trace_level,
                              const int profile_id)
 {
-	size_t i;
-
-	memset(comp, 0, sizeof(struct list_comp));
-
-	comp->ref_id = ROHC_LIST_GEN_ID_NONE;
-	comp->cur_id = ROHC_LIST_GEN_ID_NONE;
-
-	for(i = 0; i <= ROHC_LIST_GEN_ID_ANON; i++)
-	{
-		rohc_list_reset(&comp->lists[i]);
-		comp->lists[i].id = i;
-	}
-
-	for(i = 0; i < ROHC_LIST_MAX_ITEM; i++)
-	{
-		rohc_list_item_reset(&comp->trans_table[i]);
-	}
-
-	comp->list_trans_nr = list_trans_nr;
+	rohc_comp_list_init(comp, mem, list_trans_nr, trace_cb, trace_cb_priv,
+	                    trace_level, profile_id);
 
 	/* specific callbacks for IPv6 extension headers */
 	comp->get_size = ip_get_extension_size;
 	comp->get_index_table = get_index_ipv6_table;
 	comp->cmp_item = cmp_ipv6_ext;
-
-	/* traces */
-	comp->trace_callback = trace_cb;
-	comp->trace_callback_priv = trace_cb_priv;
-	comp->profile_id = profile_id;
+	comp->write_item = write_ipv6_ext;
 }
 
 
@@ -95,7 +83,7 @@ void rohc_comp_list_ipv6_new(struct list_comp *const comp,
  */
 void rohc_comp_list_ipv6_free(struct list_comp *const comp)
 {
-	memset(comp, 0, sizeof(struct list_comp));
+	rohc_comp_list_fini(comp);
 }
 
 
@@ -109,6 +97,9 @@ void rohc_comp_list_ipv6_free(struct list_comp *const comp)
  *   http://www.iana.org/assignments/ipv6-parameters/ipv6-parameters.xhtml
  * Remember to update \ref rohc_is_ipv6_opt if you update the list.
  *
+ * The translation tables of small contexts hold \ref ROHC_LIST_MAX_ITEM
+ * items only: the indexes beyond are rejected by the caller.
+ *
  * @param next_header_type  The Next Header type to get an index for
  * @param occur_nr          The number of occurrence of the Extension Header
  *                          seen so far (current one included)
@@ -134,7 +125,11 @@ static int get_index_ipv6_table(const uint8_t next_header_type,
 			}
 			else
 			{
+#if ROHC_SMALL_CONTEXTS == 1
+				index_table = 3; /* slot of the unsupported AH header */
+#else
 				index_table = 13;
+#endif
 			}
 			break;
 		case ROHC_IPPROTO_ROUTING:
@@ -160,7 +155,11 @@ static int get_index_ipv6_table(const uint8_t next_header_type,
 			index_table = 7;
 			break;
 		case ROHC_IPPROTO_SHIM:
+#if ROHC_SMALL_CONTEXTS == 1
+			index_table = 5; /* slot of the unsupported ESP header */
+#else
 			index_table = 8;
+#endif
 			break;
 		case ROHC_IPPROTO_RESERVED1:
 			index_table = 9;
@@ -218,3 +217,23 @@ static bool cmp_ipv6_ext(const struct rohc_list_item *const item,
 	        memcmp(item->data + 1, ext_data + 1, item->length - 1) == 0);
 }
 
+
+/**
+ * @brief Write one IPv6 item in the compressed list
+ *
+ * The Next Header field of the extension header is replaced by the type of
+ * the extension header itself.
+ *
+ * @param item  The IPv6 item to write
+ * @param dest  The compressed list under build
+ * @return      The length of the item in the compressed list
+ */
+static size_t write_ipv6_ext(const struct rohc_list_item *const item,
+                             uint8_t *const dest)
+{
+	assert(item->length > 1);
+	dest[0] = item->type & 0xff;
+	memcpy(dest + 1, item->data + 1, item->length - 1);
+
+	return item->length;
+}
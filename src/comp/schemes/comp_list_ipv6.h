@@ -30,11 +30,13 @@
 
 
 void rohc_comp_list_ipv6_new(struct list_comp *const comp,
+                             struct list_comp_mem *const mem,
                              const size_t list_trans_nr,
                              rohc_trace_callback2_t trace_cb,
                              void *const trace_cb_priv,
+                             const rohc_trace_level_t trace_level,
                              const int profile_id)
-	__attribute__((nonnull(1)));
+	__attribute__((nonnull(1, 2)));
 
 void rohc_comp_list_ipv6_free(struct list_comp *const comp)
 	__attribute__((nonnull(1)));
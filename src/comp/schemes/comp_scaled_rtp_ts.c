@@ -39,6 +39,22 @@
 	           format, ##__VA_ARGS__)
 
 
+static void c_init_sc_vars(struct ts_sc_comp *const ts_sc,
+                           rohc_trace_callback2_t trace_cb,
+                           void *const trace_cb_priv,
+                           const rohc_trace_level_t trace_level)
+	__attribute__((nonnull(1)));
+
+static void c_ts_sc_set_stride(struct ts_sc_comp *const ts_sc,
+                               const uint32_t ts_stride)
+	__attribute__((nonnull(1)));
+
+static uint32_t c_ts_sc_div_stride(const struct ts_sc_comp *const ts_sc,
+                                   const uint32_t value,
+                                   uint32_t *const remainder)
+	__attribute__((warn_unused_result, nonnull(1, 3)));
+
+
 /**
  * @brief Create the ts_sc_comp object
  *
@@ -48,31 +64,19 @@
  * @param trace_cb           The trace callback
  * @param trace_cb_priv      An optional private context for the trace
  *                           callback, may be NULL
+ * @param trace_level        The lowest level of the traces to print
  * @return                   true if creation is successful, false otherwise
  */
 bool c_create_sc(struct ts_sc_comp *const ts_sc,
                  const size_t wlsb_window_width,
                  rohc_trace_callback2_t trace_cb,
-                 void *const trace_cb_priv)
+                 void *const trace_cb_priv,
+                 const rohc_trace_level_t trace_level)
 {
 	assert(ts_sc != NULL);
 	assert(wlsb_window_width > 0);
 
-	ts_sc->ts_stride = 0;
-	ts_sc->ts_scaled = 0;
-	ts_sc->ts_offset = 0;
-	ts_sc->old_ts = 0;
-	ts_sc->ts = 0;
-	ts_sc->ts_delta = 0;
-	ts_sc->old_sn = 0;
-	ts_sc->sn = 0;
-	ts_sc->is_deducible = false;
-	ts_sc->state = INIT_TS;
-	ts_sc->are_old_val_init = false;
-	ts_sc->nr_init_stride_packets = 0;
-
-	ts_sc->trace_callback = trace_cb;
-	ts_sc->trace_callback_priv = trace_cb_priv;
+	c_init_sc_vars(ts_sc, trace_cb, trace_cb_priv, trace_level);
 
 	/* W-LSB context for TS_SCALED */
 	ts_sc->ts_scaled_wlsb = c_create_wlsb(32, wlsb_window_width,
@@ -103,6 +107,138 @@ error:
 }
 
 
+/**
+ * @brief Initialize a ts_sc_comp object in the given memory
+ *
+ * The W-LSB encoding objects are stored in the given memory, that shall be
+ * \ref c_wlsb_size bytes long for each of them and suitably aligned (see
+ * \ref c_init_wlsb). The object shall not be destroyed with
+ * \ref c_destroy_sc, the memory shall be freed instead.
+ *
+ * @param ts_sc              The ts_sc_comp object to initialize
+ * @param wlsb_window_width  The width of the W-LSB sliding window to use
+ *                           for TS_STRIDE (must be > 0)
+ * @param wlsb_mem           The memory for the 2 W-LSB encoding objects
+ * @param trace_cb           The trace callback
+ * @param trace_cb_priv      An optional private context for the trace
+ *                           callback, may be NULL
+ * @param trace_level        The lowest level of the traces to print
+ */
+void c_init_sc(struct ts_sc_comp *const ts_sc,
+               const size_t wlsb_window_width,
+               uint8_t *const wlsb_mem,
+               rohc_trace_callback2_t trace_cb,
+               void *const trace_cb_priv,
+               const rohc_trace_level_t trace_level)
+{
+	assert(ts_sc != NULL);
+	assert(wlsb_window_width > 0);
+
+	c_init_sc_vars(ts_sc, trace_cb, trace_cb_priv, trace_level);
+
+	ts_sc->ts_scaled_wlsb =
+		c_init_wlsb(wlsb_mem, 32, wlsb_window_width, ROHC_LSB_SHIFT_RTP_TS);
+	ts_sc->ts_unscaled_wlsb =
+		c_init_wlsb(wlsb_mem + c_wlsb_size(wlsb_window_width), 32,
+		            wlsb_window_width, ROHC_LSB_SHIFT_RTP_TS);
+}
+
+
+/**
+ * @brief Restore a ts_sc_comp object whose bytes were read from a snapshot
+ *
+ * The W-LSB encoding objects are expected in the given memory at the same
+ * offsets as with \ref c_init_sc, their windows shall match the given width.
+ * The division by TS_STRIDE is prepared again.
+ *
+ * @param ts_sc              The ts_sc_comp object to restore
+ * @param wlsb_window_width  The width of the W-LSB sliding window to use
+ *                           for TS_STRIDE (must be > 0)
+ * @param wlsb_mem           The memory of the 2 W-LSB encoding objects
+ * @param trace_cb           The trace callback
+ * @param trace_cb_priv      An optional private context for the trace
+ *                           callback, may be NULL
+ * @param trace_level        The lowest level of the traces to print
+ * @return                   true if the object is consistent,
+ *                           false if it cannot be used
+ */
+bool c_restore_sc(struct ts_sc_comp *const ts_sc,
+                  const size_t wlsb_window_width,
+                  uint8_t *const wlsb_mem,
+                  rohc_trace_callback2_t trace_cb,
+                  void *const trace_cb_priv,
+                  const rohc_trace_level_t trace_level)
+{
+	assert(ts_sc != NULL);
+	assert(wlsb_window_width > 0);
+
+	ts_sc->trace_callback = trace_cb;
+	ts_sc->trace_callback_priv = trace_cb_priv;
+	ts_sc->trace_level = trace_level;
+
+	ts_sc->ts_scaled_wlsb = (struct c_wlsb *) wlsb_mem;
+	ts_sc->ts_unscaled_wlsb =
+		(struct c_wlsb *) (wlsb_mem + c_wlsb_size(wlsb_window_width));
+	if(!c_wlsb_relocate(ts_sc->ts_scaled_wlsb, wlsb_window_width) ||
+	   !c_wlsb_relocate(ts_sc->ts_unscaled_wlsb, wlsb_window_width))
+	{
+		return false;
+	}
+
+	/* TS_STRIDE is known in all states but INIT_TS */
+	if(ts_sc->state != INIT_TS && ts_sc->state != INIT_STRIDE &&
+	   ts_sc->state != SEND_SCALED)
+	{
+		return false;
+	}
+	if(ts_sc->ts_stride != 0)
+	{
+		c_ts_sc_set_stride(ts_sc, ts_sc->ts_stride);
+	}
+	else if(ts_sc->state != INIT_TS)
+	{
+		return false;
+	}
+
+	return true;
+}
+
+
+/**
+ * @brief Initialize the variables of a ts_sc_comp object
+ *
+ * @param ts_sc          The ts_sc_comp object to initialize
+ * @param trace_cb       The trace callback
+ * @param trace_cb_priv  An optional private context for the trace callback,
+ *                       may be NULL
+ * @param trace_level    The lowest level of the traces to print
+ */
+static void c_init_sc_vars(struct ts_sc_comp *const ts_sc,
+                           rohc_trace_callback2_t trace_cb,
+                           void *const trace_cb_priv,
+                           const rohc_trace_level_t trace_level)
+{
+	ts_sc->ts_stride = 0;
+	ts_sc->ts_stride_mul = 0;
+	ts_sc->ts_stride_shift = 0;
+	ts_sc->ts_scaled = 0;
+	ts_sc->ts_offset = 0;
+	ts_sc->old_ts = 0;
+	ts_sc->ts = 0;
+	ts_sc->ts_delta = 0;
+	ts_sc->old_sn = 0;
+	ts_sc->sn = 0;
+	ts_sc->is_deducible = false;
+	ts_sc->state = INIT_TS;
+	ts_sc->are_old_val_init = false;
+	ts_sc->nr_init_stride_packets = 0;
+
+	ts_sc->trace_callback = trace_cb;
+	ts_sc->trace_callback_priv = trace_cb_priv;
+	ts_sc->trace_level = trace_level;
+}
+
+
 /**
  * @brief Destroy the ts_sc_comp object
  *
@@ -211,25 +347,28 @@ void c_add_ts(struct ts_sc_comp *const ts_sc,
 		 * not transmitted enough times to the decompressor to be used */
 		ts_debug(ts_sc, "state INIT_STRIDE");
 
-		/* reset INIT_STRIDE counter if TS_STRIDE/TS_OFFSET changed */
-		if(ts_sc->ts_delta != ts_sc->ts_stride ||
-		   (ts_sc->ts % ts_sc->ts_delta) != ts_sc->ts_offset)
+		const uint32_t old_offset = ts_sc->ts_offset;
+
+		/* compute TS_STRIDE, TS_OFFSET and TS_SCALED */
+		if(ts_sc->ts_delta != ts_sc->ts_stride)
 		{
-			ts_debug(ts_sc, "TS_STRIDE and/or TS_OFFSET changed");
+			ts_debug(ts_sc, "TS_STRIDE changed");
 			ts_sc->nr_init_stride_packets = 0;
+			c_ts_sc_set_stride(ts_sc, ts_sc->ts_delta);
 		}
-
-		/* compute TS_STRIDE, TS_OFFSET and TS_SCALED */
-		ts_sc->ts_stride = ts_sc->ts_delta;
 		ts_debug(ts_sc, "TS_STRIDE = %u", ts_sc->ts_stride);
-		assert(ts_sc->ts_stride != 0);
-		ts_sc->ts_offset = ts_sc->ts % ts_sc->ts_stride;
+		ts_sc->ts_scaled = c_ts_sc_div_stride(ts_sc, ts_sc->ts, &ts_sc->ts_offset);
 		ts_debug(ts_sc, "TS_OFFSET = %u modulo %u = %u",
 		         ts_sc->ts, ts_sc->ts_stride, ts_sc->ts_offset);
-		assert(ts_sc->ts_stride != 0);
-		ts_sc->ts_scaled = (ts_sc->ts - ts_sc->ts_offset) / ts_sc->ts_stride;
 		ts_debug(ts_sc, "TS_SCALED = (%u - %u) / %u = %u", ts_sc->ts,
 		         ts_sc->ts_offset, ts_sc->ts_stride, ts_sc->ts_scaled);
+
+		/* reset INIT_STRIDE counter if TS_OFFSET changed */
+		if(ts_sc->ts_offset != old_offset)
+		{
+			ts_debug(ts_sc, "TS_OFFSET changed");
+			ts_sc->nr_init_stride_packets = 0;
+		}
 	}
 	else if(ts_sc->state == SEND_SCALED)
 	{
@@ -245,8 +384,11 @@ void c_add_ts(struct ts_sc_comp *const ts_sc,
 		ts_debug(ts_sc, "previous TS_STRIDE = %u", ts_sc->ts_stride);
 		if(ts_sc->ts_delta != ts_sc->ts_stride)
 		{
-			assert(ts_sc->ts_stride != 0);
-			if((ts_sc->ts_delta % ts_sc->ts_stride) != 0)
+			uint32_t ts_delta_remainder;
+			const uint32_t ts_delta_scaled =
+				c_ts_sc_div_stride(ts_sc, ts_sc->ts_delta, &ts_delta_remainder);
+
+			if(ts_delta_remainder != 0)
 			{
 				/* TS delta changed and is not a multiple of previous TS_STRIDE:
 				 * record the new value as TS_STRIDE and transmit it several
@@ -258,9 +400,9 @@ void c_add_ts(struct ts_sc_comp *const ts_sc,
 				ts_sc->state = INIT_STRIDE;
 				ts_sc->nr_init_stride_packets = 0;
 				ts_debug(ts_sc, "state -> INIT_STRIDE");
-				ts_sc->ts_stride = ts_sc->ts_delta;
+				c_ts_sc_set_stride(ts_sc, ts_sc->ts_delta);
 			}
-			else if((ts_sc->ts_delta / ts_sc->ts_stride) != sn_delta)
+			else if(ts_delta_scaled != sn_delta)
 			{
 				/* TS delta changed but is a multiple of previous TS_STRIDE:
 				 * do not change TS_STRIDE, but transmit all TS bits several
@@ -283,15 +425,10 @@ void c_add_ts(struct ts_sc_comp *const ts_sc,
 		}
 		ts_debug(ts_sc, "TS_STRIDE = %u", ts_sc->ts_stride);
 
-		/* update TS_OFFSET is needed */
-		assert(ts_sc->ts_stride != 0);
-		ts_sc->ts_offset = ts_sc->ts % ts_sc->ts_stride;
+		/* update TS_OFFSET is needed and compute TS_SCALED */
+		ts_sc->ts_scaled = c_ts_sc_div_stride(ts_sc, ts_sc->ts, &ts_sc->ts_offset);
 		ts_debug(ts_sc, "TS_OFFSET = %u modulo %u = %u",
 		         ts_sc->ts, ts_sc->ts_stride, ts_sc->ts_offset);
-
-		/* compute TS_SCALED */
-		assert(ts_sc->ts_stride != 0);
-		ts_sc->ts_scaled = (ts_sc->ts - ts_sc->ts_offset) / ts_sc->ts_stride;
 		ts_debug(ts_sc, "TS_SCALED = (%u - %u) / %u = %u", ts_sc->ts,
 		         ts_sc->ts_offset, ts_sc->ts_stride, ts_sc->ts_scaled);
 
@@ -503,3 +640,68 @@ bool rohc_ts_sc_is_deducible(const struct ts_sc_comp *const ts_sc)
 	return ts_sc->is_deducible;
 }
 
+
+/**
+ * @brief Change the TS_STRIDE value
+ *
+ * Dividing by TS_STRIDE is required for every packet, so the division is
+ * prepared once for all when TS_STRIDE changes: a shift if TS_STRIDE is a
+ * power of 2, a multiplication by its reciprocal otherwise (see "Division
+ * by Invariant Integers using Multiplication", Granlund and Montgomery).
+ *
+ * @param ts_sc      The ts_sc_comp object
+ * @param ts_stride  The new TS_STRIDE value
+ */
+static void c_ts_sc_set_stride(struct ts_sc_comp *const ts_sc,
+                               const uint32_t ts_stride)
+{
+	assert(ts_stride != 0);
+
+	ts_sc->ts_stride = ts_stride;
+	if((ts_stride & (ts_stride - 1)) == 0)
+	{
+		/* power of 2: shift only */
+		ts_sc->ts_stride_mul = 0;
+		ts_sc->ts_stride_shift = 31 - __builtin_clz(ts_stride);
+	}
+	else
+	{
+		/* l = ceil(log2(TS_STRIDE)), m = 2^32 * (2^l - TS_STRIDE) / TS_STRIDE + 1 */
+		const uint8_t l = 32 - __builtin_clz(ts_stride - 1);
+		const uint64_t gap = (((uint64_t) 1) << l) - ts_stride;
+		ts_sc->ts_stride_mul = ((gap << 32) / ts_stride) + 1;
+		ts_sc->ts_stride_shift = l;
+	}
+}
+
+
+/**
+ * @brief Divide the given value by TS_STRIDE
+ *
+ * @param ts_sc           The ts_sc_comp object
+ * @param value           The value to divide
+ * @param[out] remainder  The remainder of the division
+ * @return                The quotient of the division
+ */
+static uint32_t c_ts_sc_div_stride(const struct ts_sc_comp *const ts_sc,
+                                   const uint32_t value,
+                                   uint32_t *const remainder)
+{
+	uint32_t quotient;
+
+	assert(ts_sc->ts_stride != 0);
+
+	if(ts_sc->ts_stride_mul == 0)
+	{
+		quotient = value >> ts_sc->ts_stride_shift;
+	}
+	else
+	{
+		const uint32_t t = (((uint64_t) ts_sc->ts_stride_mul) * value) >> 32;
+		quotient = (t + ((value - t) >> 1)) >> (ts_sc->ts_stride_shift - 1);
+	}
+	*remainder = value - quotient * ts_sc->ts_stride;
+
+	return quotient;
+}
+
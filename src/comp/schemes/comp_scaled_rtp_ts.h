@@ -68,6 +68,10 @@ struct ts_sc_comp
 {
 	/// The TS_STRIDE value
 	uint32_t ts_stride;
+	/** The multiplier to divide by TS_STRIDE, 0 if TS_STRIDE is a power of 2 */
+	uint32_t ts_stride_mul;
+	/** The shift to divide by TS_STRIDE */
+	uint8_t ts_stride_shift;
 
 	/// The TS_SCALED value
 	uint32_t ts_scaled;
@@ -106,6 +110,8 @@ struct ts_sc_comp
 	rohc_trace_callback2_t trace_callback;
 	/** The private context of the callback function used to manage traces */
 	void *trace_callback_priv;
+	/** The lowest level of the traces passed to the callback function */
+	rohc_trace_level_t trace_level;
 };
 
 
@@ -117,8 +123,23 @@ struct ts_sc_comp
 bool c_create_sc(struct ts_sc_comp *const ts_sc,
                  const size_t wlsb_window_width,
                  rohc_trace_callback2_t trace_cb,
-                 void *const trace_cb_priv)
+                 void *const trace_cb_priv,
+                 const rohc_trace_level_t trace_level)
 	__attribute__((warn_unused_result));
+void c_init_sc(struct ts_sc_comp *const ts_sc,
+               const size_t wlsb_window_width,
+               uint8_t *const wlsb_mem,
+               rohc_trace_callback2_t trace_cb,
+               void *const trace_cb_priv,
+               const rohc_trace_level_t trace_level)
+	__attribute__((nonnull(1, 3)));
+bool c_restore_sc(struct ts_sc_comp *const ts_sc,
+                  const size_t wlsb_window_width,
+                  uint8_t *const wlsb_mem,
+                  rohc_trace_callback2_t trace_cb,
+                  void *const trace_cb_priv,
+                  const rohc_trace_level_t trace_level)
+	__attribute__((warn_unused_result, nonnull(1, 3)));
 void c_destroy_sc(struct ts_sc_comp *const ts_sc);
 
 void c_add_ts(struct ts_sc_comp *const ts_sc,
@@ -27,6 +27,7 @@
 
 #include "comp_wlsb.h"
 #include "interval.h" /* for the rohc_f_*bits() functions */
+#include "rohc_alloc.h"
 
 #ifndef __KERNEL__
 #  include <string.h>
@@ -38,24 +39,19 @@
  * Private structures and types
  */
 
-/**
- * @brief Define a W-LSB window entry
- */
-struct c_window
-{
-	uint32_t sn;     /**< The Sequence Number (SN) associated with the entry
-	                      (used to acknowledge the entry) */
-	uint32_t value;  /**< The value stored in the window entry */
-};
-
-
 /**
  * @brief Defines a W-LSB encoding object
+ *
+ * The SN and the values of the window entries are stored in two separate
+ * arrays, so that the loops on the window values run on contiguous memory.
  */
 struct c_wlsb
 {
-	/// The width of the window
-	size_t window_width; /* TODO: R-mode needs a non-fixed window width */
+	/// The width of the window, ie. the number of entries it may store
+	size_t window_width;
+	/** The number of entries that the window currently keeps, at most the
+	 *  width of the window (see \ref c_wlsb_set_width) */
+	size_t active_width;
 
 	/// The size of the window (power of 2) minus 1
 	size_t window_mask;
@@ -67,14 +63,32 @@ struct c_wlsb
 
 	/// Count of entries in the window
 	size_t count;
+	/** The number of newest entries whose SN follow each other by 1 */
+	size_t consecutive_sn_nr;
+	/** The difference between the two newest values */
+	uint32_t step;
+	/** The number of newest entries whose values follow each other by step */
+	size_t linear_nr;
 
 	/// The maximal number of bits for representing the value
 	size_t bits;
 	/// Shift parameter (see 4.5.2 in the RFC 3095)
 	rohc_lsb_shift_t p;
 
+	/** The value of the newest entry in the window */
+	uint32_t newest;
+	/** The lowest offset of the window values from the newest one */
+	int32_t min_offset;
+	/** The greatest offset of the window values from the newest one */
+	int32_t max_offset;
+
+	/** The Sequence Numbers (SN) associated with the window entries
+	 *  (used to acknowledge the entries) */
+	uint32_t *sns;
 	/** The window in which previous values of the encoded value are stored */
-	struct c_window window[1];
+	uint32_t *values;
+	/** The memory for the SN and the values of the window entries */
+	uint32_t entries[1];
 };
 
 
@@ -88,6 +102,17 @@ static size_t wlsb_get_next_older(const size_t entry, const size_t max)
 static size_t wlsb_ack_remove(struct c_wlsb *const wlsb, const size_t pos)
 	__attribute__((warn_unused_result, nonnull(1)));
 
+static void wlsb_update_bounds(struct c_wlsb *const wlsb)
+	__attribute__((nonnull(1)));
+
+static inline bool wlsb_get_minkp_bounds(const struct c_wlsb *const wlsb,
+                                         const uint32_t value,
+                                         const size_t min_k,
+                                         const rohc_lsb_shift_t p,
+                                         const size_t field_bits,
+                                         size_t *const bits_nr)
+	__attribute__((warn_unused_result, nonnull(1, 6)));
+
 static size_t rohc_g_8bits(const uint8_t v_ref,
                            const uint8_t v,
                            const rohc_lsb_shift_t p,
@@ -114,40 +139,138 @@ static size_t rohc_g_32bits(const uint32_t v_ref,
  */
 
 /**
- * @brief Create a new Window-based Least Significant Bits (W-LSB) encoding
- *        object
+ * @brief Get the memory size required by one W-LSB encoding object
+ *
+ * The size is rounded up so that several W-LSB objects may be stored one
+ * after the other in one memory block, see \ref c_init_wlsb.
+ *
+ * @param window_width The number of entries in the window (power of 2)
+ * @return             The size (in bytes) of the W-LSB encoding object
+ */
+size_t c_wlsb_size(const size_t window_width)
+{
+	const size_t align = __alignof__(struct c_wlsb);
+	const size_t size =
+		sizeof(struct c_wlsb) + (window_width * 2 - 1) * sizeof(uint32_t);
+
+	assert(window_width > 0);
+
+	return ((size + align - 1) & ~(align - 1));
+}
+
+
+/**
+ * @brief Initialize a W-LSB encoding object in the given memory
  *
+ * The memory shall be at least \ref c_wlsb_size bytes long and suitably
+ * aligned, ie. it shall come from malloc() or directly follow another
+ * W-LSB object in the same memory block. The W-LSB object shall not be
+ * destroyed with \ref c_destroy_wlsb, the memory block shall be freed
+ * instead.
+ *
+ * @param mem          The memory in which to store the W-LSB object
  * @param bits         The maximal number of bits for representing a value
  * @param window_width The number of entries in the window (power of 2)
  * @param p            Shift parameter (see 4.5.2 in the RFC 3095)
- * @return             The newly-created W-LSB encoding object
+ * @return             The initialized W-LSB encoding object
  */
-struct c_wlsb * c_create_wlsb(const size_t bits,
-                              const size_t window_width,
-                              const rohc_lsb_shift_t p)
+struct c_wlsb * c_init_wlsb(void *const mem,
+                            const size_t bits,
+                            const size_t window_width,
+                            const rohc_lsb_shift_t p)
 {
-	struct c_wlsb *wlsb;
+	struct c_wlsb *const wlsb = mem;
 
 	assert(bits > 0);
 	assert(window_width > 0);
 	/* window_width must be a power of 2! */
 	assert(window_width != 0 && (window_width & (window_width - 1)) == 0);
+	assert((((uintptr_t) mem) & (__alignof__(struct c_wlsb) - 1)) == 0);
 
-	wlsb = malloc(sizeof(struct c_wlsb) + (window_width - 1) * sizeof(struct c_window));
-	if(wlsb == NULL)
-	{
-		goto error;
-	}
+	wlsb->sns = wlsb->entries;
+	wlsb->values = wlsb->entries + window_width;
 
 	wlsb->oldest = 0;
 	wlsb->next = 0;
 	wlsb->count = 0;
+	wlsb->consecutive_sn_nr = 0;
+	wlsb->step = 0;
+	wlsb->linear_nr = 0;
 	wlsb->window_width = window_width;
+	wlsb->active_width = window_width;
 	wlsb->window_mask = window_width - 1;
 	wlsb->bits = bits;
 	wlsb->p = p;
+	wlsb->newest = 0;
+	wlsb->min_offset = 0;
+	wlsb->max_offset = 0;
 
 	return wlsb;
+}
+
+
+/**
+ * @brief Fix a W-LSB encoding object that was copied to another memory
+ *
+ * The window of the object lives in the object itself: once the bytes of
+ * the object are copied elsewhere, its internal references shall be fixed.
+ * The bytes may come from outside the library (a snapshot for example), so
+ * the positions in the window are checked against the expected width before
+ * the window is used again.
+ *
+ * @param wlsb          The W-LSB object at its new location
+ * @param window_width  The width the W-LSB object was created with
+ * @return              true if the object is consistent with the width,
+ *                      false if it cannot be used
+ */
+bool c_wlsb_relocate(struct c_wlsb *const wlsb, const size_t window_width)
+{
+	if(wlsb->window_width != window_width ||
+	   wlsb->window_mask != (window_width - 1) ||
+	   wlsb->active_width == 0 ||
+	   wlsb->active_width > window_width ||
+	   wlsb->oldest > wlsb->window_mask ||
+	   wlsb->next > wlsb->window_mask ||
+	   wlsb->count > wlsb->active_width ||
+	   wlsb->next != ((wlsb->oldest + wlsb->count) & wlsb->window_mask) ||
+	   wlsb->consecutive_sn_nr > wlsb->count)
+	{
+		wlsb->sns = NULL;
+		wlsb->values = NULL;
+		return false;
+	}
+
+	wlsb->sns = wlsb->entries;
+	wlsb->values = wlsb->entries + wlsb->window_width;
+
+	return true;
+}
+
+
+/**
+ * @brief Create a new Window-based Least Significant Bits (W-LSB) encoding
+ *        object
+ *
+ * @param bits         The maximal number of bits for representing a value
+ * @param window_width The number of entries in the window (power of 2)
+ * @param p            Shift parameter (see 4.5.2 in the RFC 3095)
+ * @return             The newly-created W-LSB encoding object
+ */
+struct c_wlsb * c_create_wlsb(const size_t bits,
+                              const size_t window_width,
+                              const rohc_lsb_shift_t p)
+{
+	void *mem;
+
+	assert(window_width > 0);
+
+	mem = malloc(c_wlsb_size(window_width));
+	if(mem == NULL)
+	{
+		goto error;
+	}
+
+	return c_init_wlsb(mem, bits, window_width, p);
 
 error:
 	return NULL;
@@ -168,6 +291,11 @@ void c_destroy_wlsb(struct c_wlsb *const wlsb)
 /**
  * @brief Add a value into a W-LSB encoding object
  *
+ * The values of steady streams (SN, scaled TS, IP-ID offset...) grow by the
+ * same step packet after packet: once the whole window follows that step,
+ * adding the next value of the stream only shifts the window, so the bounds
+ * of the window values relatively to the newest one do not change.
+ *
  * @param wlsb  The W-LSB object
  * @param sn    The Sequence Number (SN) for the new entry
  * @param value The value to base the LSB coding on
@@ -176,12 +304,46 @@ void c_add_wlsb(struct c_wlsb *const wlsb,
                 const uint32_t sn,
                 const uint32_t value)
 {
+	bool is_shift;
+
 	assert(wlsb != NULL);
-	assert(wlsb->window != NULL);
+	assert(wlsb->values != NULL);
 	assert(wlsb->next < wlsb->window_width);
 
-	/* if window is full, an entry is overwritten */
-	if(wlsb->count == wlsb->window_width)
+	/* does the new value follow the newest one by the same step as the
+	 * newest values of the window? */
+	if(wlsb->count > 0 && (value - wlsb->newest) == wlsb->step)
+	{
+		is_shift = (wlsb->count == wlsb->active_width &&
+		            wlsb->linear_nr >= wlsb->active_width);
+		if(wlsb->linear_nr < wlsb->active_width)
+		{
+			wlsb->linear_nr++;
+		}
+	}
+	else
+	{
+		is_shift = false;
+		wlsb->step = value - wlsb->newest;
+		wlsb->linear_nr = (wlsb->count > 0 ? 2 : 1);
+	}
+
+	/* does the new SN follow the SN of the newest entry? */
+	if(wlsb->count > 0 &&
+	   sn == (wlsb->sns[(wlsb->next - 1) & wlsb->window_mask] + 1))
+	{
+		if(wlsb->consecutive_sn_nr < wlsb->active_width)
+		{
+			wlsb->consecutive_sn_nr++;
+		}
+	}
+	else
+	{
+		wlsb->consecutive_sn_nr = 1;
+	}
+
+	/* if window is full, the oldest entry is forgotten */
+	if(wlsb->count == wlsb->active_width)
 	{
 		wlsb->oldest = (wlsb->oldest + 1) & wlsb->window_mask;
 	}
@@ -190,9 +352,51 @@ void c_add_wlsb(struct c_wlsb *const wlsb,
 		wlsb->count++;
 	}
 
-	wlsb->window[wlsb->next].sn = sn;
-	wlsb->window[wlsb->next].value = value;
+	wlsb->sns[wlsb->next] = sn;
+	wlsb->values[wlsb->next] = value;
 	wlsb->next = (wlsb->next + 1) & wlsb->window_mask;
+
+	wlsb->newest = value;
+	if(!is_shift)
+	{
+		wlsb_update_bounds(wlsb);
+	}
+}
+
+
+/**
+ * @brief Change the number of entries that a W-LSB encoding object keeps
+ *
+ * The memory of the object is not changed: the new width is limited to the
+ * width given at creation. When the window shrinks, its oldest entries are
+ * forgotten at once. When it grows, it keeps its entries and the next
+ * values are added without forgetting the oldest ones until it is full.
+ *
+ * @param wlsb   The W-LSB object
+ * @param width  The new number of entries of the window, at least 1
+ */
+void c_wlsb_set_width(struct c_wlsb *const wlsb, const size_t width)
+{
+	assert(width > 0);
+
+	wlsb->active_width = (width < wlsb->window_width ? width : wlsb->window_width);
+
+	/* forget the oldest entries that do not fit in the window anymore */
+	if(wlsb->count > wlsb->active_width)
+	{
+		wlsb->oldest =
+			(wlsb->oldest + wlsb->count - wlsb->active_width) & wlsb->window_mask;
+		wlsb->count = wlsb->active_width;
+		if(wlsb->consecutive_sn_nr > wlsb->count)
+		{
+			wlsb->consecutive_sn_nr = wlsb->count;
+		}
+		if(wlsb->linear_nr > wlsb->count)
+		{
+			wlsb->linear_nr = wlsb->count;
+		}
+		wlsb_update_bounds(wlsb);
+	}
 }
 
 
@@ -234,7 +438,7 @@ size_t wlsb_get_kp_8bits(const struct c_wlsb *const wlsb,
 	{
 		bits_nr = wlsb->bits;
 	}
-	else
+	else if(!wlsb_get_minkp_bounds(wlsb, value, 0, p, 8, &bits_nr))
 	{
 		size_t entry;
 		size_t i;
@@ -248,7 +452,7 @@ size_t wlsb_get_kp_8bits(const struct c_wlsb *const wlsb,
 		    i--, entry = (entry + 1) & wlsb->window_mask)
 		{
 			const size_t k =
-				rohc_g_8bits(wlsb->window[entry].value, value, p, wlsb->bits);
+				rohc_g_8bits(wlsb->values[entry], value, p, wlsb->bits);
 			if(k > bits_nr)
 			{
 				bits_nr = k;
@@ -341,7 +545,7 @@ size_t wlsb_get_minkp_16bits(const struct c_wlsb *const wlsb,
 	{
 		bits_nr = wlsb->bits;
 	}
-	else
+	else if(!wlsb_get_minkp_bounds(wlsb, value, min_k, p, 16, &bits_nr))
 	{
 		size_t entry;
 		size_t i;
@@ -355,7 +559,7 @@ size_t wlsb_get_minkp_16bits(const struct c_wlsb *const wlsb,
 		    i--, entry = (entry + 1) & wlsb->window_mask)
 		{
 			const size_t k =
-				rohc_g_16bits(wlsb->window[entry].value, value, min_k, p, wlsb->bits);
+				rohc_g_16bits(wlsb->values[entry], value, min_k, p, wlsb->bits);
 			if(k > bits_nr)
 			{
 				bits_nr = k;
@@ -443,7 +647,7 @@ size_t wlsb_get_minkp_32bits(const struct c_wlsb *const wlsb,
 {
 	size_t bits_nr;
 
-	assert(wlsb->window != NULL);
+	assert(wlsb->values != NULL);
 	assert(value <= 0xffffffff);
 
 	/* use all bits if the window contains no value */
@@ -451,7 +655,7 @@ size_t wlsb_get_minkp_32bits(const struct c_wlsb *const wlsb,
 	{
 		bits_nr = wlsb->bits;
 	}
-	else
+	else if(!wlsb_get_minkp_bounds(wlsb, value, min_k, p, 32, &bits_nr))
 	{
 		size_t entry;
 		size_t i;
@@ -465,7 +669,7 @@ size_t wlsb_get_minkp_32bits(const struct c_wlsb *const wlsb,
 		    i--, entry = (entry + 1) & wlsb->window_mask)
 		{
 			const size_t k =
-				rohc_g_32bits(wlsb->window[entry].value, value, min_k, p, wlsb->bits);
+				rohc_g_32bits(wlsb->values[entry], value, min_k, p, wlsb->bits);
 			if(k > bits_nr)
 			{
 				bits_nr = k;
@@ -507,12 +711,28 @@ size_t wlsb_ack(struct c_wlsb *const wlsb,
 	}
 	assert((sn_bits & sn_mask) == sn_bits);
 
+	/* if the newest entries have consecutive SN, the acknowledged entry is
+	 * directly found from its distance to the newest SN: no newer entry may
+	 * match the SN LSB since the distance is lower than 2^sn_bits_nr */
+	if(wlsb->count > 0)
+	{
+		const size_t newest_entry = (wlsb->next - 1) & wlsb->window_mask;
+		const uint32_t sn_dist = (wlsb->sns[newest_entry] - sn_bits) & sn_mask;
+
+		if(sn_dist < wlsb->consecutive_sn_nr)
+		{
+			entry = (newest_entry - sn_dist) & wlsb->window_mask;
+			assert((wlsb->sns[entry] & sn_mask) == sn_bits);
+			return wlsb_ack_remove(wlsb, entry);
+		}
+	}
+
 	/* search for the window entry that matches the given SN LSB
 	 * starting from the one */
 	for(i = 0; i < wlsb->count; i++)
 	{
 		entry = wlsb_get_next_older(entry, wlsb->window_mask);
-		if((wlsb->window[entry].sn & sn_mask) == sn_bits)
+		if((wlsb->sns[entry] & sn_mask) == sn_bits)
 		{
 			/* remove the window entry and all the older ones if found */
 			return wlsb_ack_remove(wlsb, entry);
@@ -550,20 +770,201 @@ static size_t wlsb_get_next_older(const size_t entry, const size_t max)
  */
 static size_t wlsb_ack_remove(struct c_wlsb *const wlsb, const size_t pos)
 {
-	size_t acked_nr = 0;
+	const size_t acked_nr = (pos - wlsb->oldest) & wlsb->window_mask;
 
-	while(wlsb->oldest != pos)
+	assert(acked_nr < wlsb->count);
+
+	/* remove the oldest entries at once */
+	wlsb->oldest = pos;
+	wlsb->count -= acked_nr;
+	if(wlsb->consecutive_sn_nr > wlsb->count)
 	{
-		/* remove the oldest entry */
-		wlsb->oldest = (wlsb->oldest + 1) & wlsb->window_mask;
-		wlsb->count--;
-		acked_nr++;
+		wlsb->consecutive_sn_nr = wlsb->count;
+	}
+	if(wlsb->linear_nr > wlsb->count)
+	{
+		wlsb->linear_nr = wlsb->count;
+	}
+	if(acked_nr > 0)
+	{
+		wlsb_update_bounds(wlsb);
 	}
 
 	return acked_nr;
 }
 
 
+/**
+ * @brief Update the bounds of the values in the W-LSB window
+ *
+ * The values are located relatively to the newest one, so that the bounds
+ * remain meaningful when the values wrap around. The bounds are updated
+ * every time the window changes, so that the lookup of k does not need to
+ * test every window entry for every value of k.
+ *
+ * @param wlsb  The W-LSB object
+ */
+static void wlsb_update_bounds(struct c_wlsb *const wlsb)
+{
+	const uint32_t newest = wlsb->newest;
+	int32_t min_offset = 0;
+	int32_t max_offset = 0;
+	size_t first_end;
+	size_t second_end;
+	size_t i;
+
+	/* the order of the entries does not matter, so walk the circular window
+	 * as one or two contiguous runs that the compiler may vectorize */
+	if((wlsb->oldest + wlsb->count) <= wlsb->window_width)
+	{
+		first_end = wlsb->oldest + wlsb->count;
+		second_end = 0;
+	}
+	else
+	{
+		first_end = wlsb->window_width;
+		second_end = wlsb->oldest + wlsb->count - wlsb->window_width;
+	}
+
+	for(i = wlsb->oldest; i < first_end; i++)
+	{
+		const int32_t offset = (int32_t) (wlsb->values[i] - newest);
+		min_offset = (offset < min_offset ? offset : min_offset);
+		max_offset = (offset > max_offset ? offset : max_offset);
+	}
+	for(i = 0; i < second_end; i++)
+	{
+		const int32_t offset = (int32_t) (wlsb->values[i] - newest);
+		min_offset = (offset < min_offset ? offset : min_offset);
+		max_offset = (offset > max_offset ? offset : max_offset);
+	}
+
+	wlsb->min_offset = min_offset;
+	wlsb->max_offset = max_offset;
+}
+
+
+/**
+ * @brief Find out the minimal number of bits of the to-be-encoded value
+ *        required to be able to uniquely recreate it given the window bounds
+ *
+ * The interpretation intervals grow with k, so all the window values may be
+ * used as reference if both the lowest and the greatest ones may. Only one
+ * interval test per k is thus required, whatever the width of the window.
+ *
+ * When the shift parameter does not depend on k, the window values are all
+ * in the interpretation interval if the lowest one is at most 2^k - 1 before
+ * v + p and the greatest one is not after v + p, so k is directly given by
+ * the position of the lowest value.
+ *
+ * The function is inlined in the functions dedicated to 8-bit, 16-bit and
+ * 32-bit fields, so that the field masks are constants.
+ *
+ * The function gives up if the window cannot be summarized by its bounds:
+ * the window values spread over more than half the field, or the shift
+ * parameter of RTP/ESP SN shrinks the intervals between k = 4 and k = 5 and
+ * the value just after the to-be-encoded value might be in the window.
+ *
+ * @param wlsb        The W-LSB object
+ * @param value       The value to encode using the LSB algorithm
+ * @param min_k       The minimum number of bits to find out
+ * @param p           The shift parameter p
+ * @param field_bits  The length of the field (8, 16 or 32 bits)
+ * @param[out] bits_nr  The number of bits required to uniquely recreate
+ *                      the value
+ * @return            true if the number of bits was found out,
+ *                    false if the window entries shall be tested one by one
+ */
+static inline bool wlsb_get_minkp_bounds(const struct c_wlsb *const wlsb,
+                                         const uint32_t value,
+                                         const size_t min_k,
+                                         const rohc_lsb_shift_t p,
+                                         const size_t field_bits,
+                                         size_t *const bits_nr)
+{
+	const uint32_t field_mask =
+		(field_bits == 32 ? 0xffffffffU : ((1U << field_bits) - 1));
+	const uint32_t span =
+		((uint32_t) wlsb->max_offset) - ((uint32_t) wlsb->min_offset);
+	const uint32_t lowest = (wlsb->newest + wlsb->min_offset) & field_mask;
+	size_t k;
+
+	assert(field_bits == 8 || field_bits == 16 || field_bits == 32);
+	assert(wlsb->bits <= field_bits);
+	assert(min_k <= wlsb->bits);
+	assert(p != ROHC_LSB_SHIFT_VAR);
+
+	/* window values shall be located relatively to the newest one */
+	if(field_bits < 32)
+	{
+		const int32_t half_field = (1 << (field_bits - 1));
+		if(wlsb->min_offset < (-half_field) || wlsb->max_offset >= half_field)
+		{
+			return false;
+		}
+	}
+
+	/* with RTP/ESP SN, the value just before a reference value may be
+	 * decoded with k = 4 but not with k = 5 */
+	if(p == ROHC_LSB_SHIFT_RTP_SN || p == ROHC_LSB_SHIFT_ESP_SN)
+	{
+		const uint32_t next_offset =
+			(value + 1 - (wlsb->newest + wlsb->min_offset)) & field_mask;
+		if(next_offset <= span)
+		{
+			return false;
+		}
+	}
+
+	/* the shift parameter is the same for all k for most fields */
+	if(p != ROHC_LSB_SHIFT_RTP_TS &&
+	   p != ROHC_LSB_SHIFT_RTP_SN &&
+	   p != ROHC_LSB_SHIFT_ESP_SN)
+	{
+		/* position of the lowest value before v + p */
+		const uint32_t lowest_dist = (value + p - lowest) & field_mask;
+
+		if(span > lowest_dist)
+		{
+			/* the greatest value is after v + p: no k is small enough */
+			k = wlsb->bits;
+		}
+		else
+		{
+			/* smallest k so that 2^k - 1 >= lowest_dist */
+			k = (lowest_dist == 0 ? 0 : (32 - __builtin_clz(lowest_dist)));
+			if(k < min_k)
+			{
+				k = min_k;
+			}
+			if(k > wlsb->bits)
+			{
+				k = wlsb->bits;
+			}
+		}
+		*bits_nr = k;
+		return true;
+	}
+
+	/* all window values shall be in [v + p - (2^k - 1), v + p] */
+	for(k = min_k; k < wlsb->bits; k++)
+	{
+		const uint32_t interval_width = (1U << k) - 1;
+		const uint32_t first_ref =
+			value + rohc_interval_compute_p(k, p) - interval_width;
+		const uint32_t lowest_pos = (lowest - first_ref) & field_mask;
+
+		if(lowest_pos <= interval_width && span <= (interval_width - lowest_pos))
+		{
+			break;
+		}
+	}
+	*bits_nr = k;
+
+	return true;
+}
+
+
 /**
  * @brief The g function as defined in LSB encoding for 8-bit fields
  *
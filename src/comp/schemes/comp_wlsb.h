@@ -48,10 +48,23 @@ struct c_wlsb * c_create_wlsb(const size_t bits,
 	__attribute__((warn_unused_result));
 void c_destroy_wlsb(struct c_wlsb *s);
 
+size_t c_wlsb_size(const size_t window_width)
+	__attribute__((warn_unused_result, const));
+struct c_wlsb * c_init_wlsb(void *const mem,
+                            const size_t bits,
+                            const size_t window_width,
+                            const rohc_lsb_shift_t p)
+	__attribute__((warn_unused_result, nonnull(1)));
+bool c_wlsb_relocate(struct c_wlsb *const wlsb, const size_t window_width)
+	__attribute__((warn_unused_result, nonnull(1)));
+
 void c_add_wlsb(struct c_wlsb *const wlsb,
                 const uint32_t sn,
                 const uint32_t value);
 
+void c_wlsb_set_width(struct c_wlsb *const wlsb, const size_t width)
+	__attribute__((nonnull(1)));
+
 size_t wlsb_get_k_8bits(const struct c_wlsb *const wlsb,
                         const uint8_t value)
 	__attribute__((warn_unused_result, nonnull(1)));
@@ -36,5 +36,22 @@
 bool is_ip_id_increasing(const uint16_t old_id, const uint16_t new_id)
 	__attribute__((warn_unused_result, const));
 
+
+/**
+ * @brief Whether the new IP-ID is the one a sequential IP-ID predicts
+ *
+ * A sequential IP-ID is most of the time incremented by one from one packet
+ * to the next one: such a new IP-ID is increasing for
+ * \ref is_ip_id_increasing and differs from the previous IP-ID.
+ *
+ * @param old_id  The IP-ID of the previous IPv4 header
+ * @param new_id  The IP-ID of the current IPv4 header
+ * @return        Whether the IP-ID was incremented by one
+ */
+static inline bool is_ip_id_next(const uint16_t old_id, const uint16_t new_id)
+{
+	return (new_id == ((uint16_t) (old_id + 1)));
+}
+
 #endif
 
@@ -24,20 +24,47 @@
 
 #include "tcp_sack.h"
 
+#include <assert.h>
 
-static int c_tcp_sack_code_block(const struct rohc_comp_ctxt *const context,
-                                 const uint32_t reference,
-                                 const sack_block_t *const sack_block,
-                                 uint8_t *const rohc_data,
-                                 const size_t rohc_max_len)
-	__attribute__((warn_unused_result, nonnull(1, 3, 4)));
 
-static int c_tcp_sack_code_pure_lsb(const struct rohc_comp_ctxt *const context,
-                                    const uint32_t base,
-                                    const uint32_t field,
-                                    uint8_t *const rohc_data,
-                                    const size_t rohc_max_len)
-	__attribute__((warn_unused_result, nonnull(1, 4)));
+/**
+ * @brief The length (in bytes) of one SACK field encoded with
+ *        sack_var_length_enc(), indexed by the number of bits of the field
+ *
+ * See RFC6846 page 67: 15 bits fit in 2 bytes, 22 bits fit in 3 bytes,
+ * 29 bits fit in 4 bytes, and 32 bits require 5 bytes.
+ */
+static const uint8_t c_tcp_sack_field_lens[32 + 1] =
+{
+	2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, /*  0-15 bits */
+	3, 3, 3, 3, 3, 3, 3,                            /* 16-22 bits */
+	4, 4, 4, 4, 4, 4, 4,                            /* 23-29 bits */
+	5, 5, 5                                         /* 30-32 bits */
+};
+
+
+/**
+ * @brief The discriminator of one SACK field encoded with
+ *        sack_var_length_enc(), indexed by the length (in bytes) of the
+ *        encoded field
+ */
+static const uint64_t c_tcp_sack_field_discrs[5 + 1] =
+{
+	0, 0,
+	0x0000,        /* 2 bytes with discriminator '0' */
+	0x800000,      /* 3 bytes with discriminator '10' */
+	0xc0000000,    /* 4 bytes with discriminator '110' */
+	0xff00000000   /* 5 bytes with discriminator '11111111' */
+};
+
+
+static inline uint8_t c_tcp_sack_field_len(const uint32_t sack_field)
+	__attribute__((warn_unused_result, const));
+
+static inline void c_tcp_sack_field_write(const uint32_t sack_field,
+                                          const uint8_t len,
+                                          uint8_t *const rohc_data)
+	__attribute__((nonnull(3)));
 
 
 /**
@@ -46,6 +73,11 @@ static int c_tcp_sack_code_pure_lsb(const struct rohc_comp_ctxt *const context,
  * See RFC6846 page 68
  * (and RFC2018 for Selective Acknowledgement option)
  *
+ * The SACK fields of all the blocks are computed first, then the length of
+ * every encoded field is taken in a lookup table, so that the ROHC buffer is
+ * checked only once and the fields are written without any branching on
+ * their values.
+ *
  * @param context         The compression context
  * @param ack_value       The ack value
  * @param sack_blocks     The SACK blocks to compress
@@ -65,12 +97,13 @@ int c_tcp_opt_sack_code(const struct rohc_comp_ctxt *const context,
                         uint8_t *const rohc_data,
                         const size_t rohc_max_len)
 {
-	uint8_t * rohc_remain_data = rohc_data;
-	size_t rohc_remain_len = rohc_max_len;
-	const sack_block_t *block;
+	uint32_t sack_fields[TCP_SACK_BLOCKS_MAX_NR * 2];
+	uint8_t sack_fields_lens[TCP_SACK_BLOCKS_MAX_NR * 2];
+	size_t sack_fields_nr;
+	size_t rohc_len;
+	uint32_t reference;
 	size_t blocks_nr;
 	size_t i;
-	int ret;
 
 	rohc_comp_debug(context, "%schanged TCP option SACK (reference ACK = 0x%08x)",
 	                (is_unchanged ? "un" : ""), ack_value);
@@ -87,45 +120,64 @@ int c_tcp_opt_sack_code(const struct rohc_comp_ctxt *const context,
 	/* the irregular chain supports a special encoding for unchanged option */
 	if(is_unchanged)
 	{
-		rohc_remain_data[0] = 0x00;
-		rohc_remain_data++;
-		rohc_remain_len--;
+		rohc_data[0] = 0x00;
+		return 1;
+	}
+
+	/* determine the number of SACK blocks
+	 * (integer division checked by \ref c_tcp_check_profile ) */
+	blocks_nr = length / sizeof(sack_block_t);
+	assert(blocks_nr <= TCP_SACK_BLOCKS_MAX_NR);
+	sack_fields_nr = blocks_nr * 2;
+
+	/* compute the SACK fields of all the blocks at once:
+	 *  - block_start =:= sack_var_length_enc(reference): the first block uses
+	 *    ACK as reference, next block uses previous block end as reference,
+	 *  - block_end =:= sack_var_length_enc(block_start)
+	 * if reference can be >= field, overflow is expected */
+	for(i = 0, reference = ack_value; i < blocks_nr; i++)
+	{
+		const uint32_t block_start = rohc_ntoh32(sack_blocks[i].block_start);
+		const uint32_t block_end = rohc_ntoh32(sack_blocks[i].block_end);
+
+		sack_fields[i * 2] = block_start - reference;
+		sack_fields[i * 2 + 1] = block_end - block_start;
+		reference = block_end;
+	}
+
+	/* length of every encoded field, and total length */
+	for(i = 0, rohc_len = 1; i < sack_fields_nr; i++)
+	{
+		sack_fields_lens[i] = c_tcp_sack_field_len(sack_fields[i]);
+		rohc_len += sack_fields_lens[i];
 	}
-	else
+	if(rohc_max_len < rohc_len)
 	{
-		uint32_t reference;
+		rohc_comp_warn(context, "ROHC buffer too small for the TCP option SACK: "
+		               "%zu bytes required for %zu blocks, but only %zu bytes "
+		               "available", rohc_len, blocks_nr, rohc_max_len);
+		goto error;
+	}
 
-		/* determine the number of SACK blocks
-		 * (integer division checked by \ref c_tcp_check_profile ) */
-		blocks_nr = length / sizeof(sack_block_t);
-		rohc_remain_data[0] = blocks_nr;
-		rohc_remain_data++;
-		rohc_remain_len--;
+	/* write the number of SACK blocks, then all the SACK fields */
+	rohc_data[0] = blocks_nr;
+	for(i = 0, rohc_len = 1; i < sack_fields_nr; i++)
+	{
+		c_tcp_sack_field_write(sack_fields[i], sack_fields_lens[i],
+		                       rohc_data + rohc_len);
+		rohc_len += sack_fields_lens[i];
+	}
 
-		/* compress every SACK block, one by one:
-		 *  - first block uses ACK as reference
-		 *  - next block uses current block end as reference */
-		for(i = 0, reference = ack_value, block = sack_blocks;
-		    i < blocks_nr;
-		    i++, reference = rohc_ntoh32(block->block_end), block++)
-		{
-			rohc_comp_debug(context, "block of SACK option: reference = 0x%08x, "
-			                "start = 0x%08x, end = 0x%08x", reference,
-			                rohc_ntoh32(block->block_start),
-			                rohc_ntoh32(block->block_end));
-			ret = c_tcp_sack_code_block(context, reference, block,
-			                            rohc_remain_data, rohc_remain_len);
-			if(ret < 0)
-			{
-				rohc_comp_warn(context, "failed to encode SACK block #%zu", i + 1);
-				goto error;
-			}
-			rohc_remain_data += ret;
-			rohc_remain_len -= ret;
-		}
+	for(i = 0; i < blocks_nr; i++)
+	{
+		rohc_comp_debug(context, "block #%zu of SACK option: start = 0x%08x, "
+		                "end = 0x%08x, encoded on %u + %u bytes", i + 1,
+		                rohc_ntoh32(sack_blocks[i].block_start),
+		                rohc_ntoh32(sack_blocks[i].block_end),
+		                sack_fields_lens[i * 2], sack_fields_lens[i * 2 + 1]);
 	}
 
-	return (rohc_max_len - rohc_remain_len);
+	return rohc_len;
 
 error:
 	return -1;
@@ -133,160 +185,43 @@ error:
 
 
 /**
- * @brief Compress one SACK block
+ * @brief Get the length of one SACK field encoded with sack_var_length_enc()
  *
- * See RFC6846 page 68
- * (and RFC2018 for Selective Acknowledgement option)
+ * See RFC6846 page 67
  *
- * @param context         The compression context
- * @param reference       The reference value
- * @param sack_block      The SACK block to compress
- * @param[out] rohc_data  The ROHC packet being built
- * @param rohc_max_len    The max remaining length in the ROHC buffer
- * @return                The length appended in the ROHC buffer if positive,
- *                        -1 in case of error
+ * @param sack_field  The SACK field to encode
+ * @return            The length (in bytes) of the encoded SACK field,
+ *                    discriminator included
  */
-static int c_tcp_sack_code_block(const struct rohc_comp_ctxt *const context,
-                                 const uint32_t reference,
-                                 const sack_block_t *const sack_block,
-                                 uint8_t *const rohc_data,
-                                 const size_t rohc_max_len)
+static inline uint8_t c_tcp_sack_field_len(const uint32_t sack_field)
 {
-	uint8_t *rohc_remain_data = rohc_data;
-	size_t rohc_remain_len = rohc_max_len;
-	int ret;
-
-	rohc_comp_debug(context, "reference = 0x%x, block_start = 0x%x, block_end "
-	                "= 0x%x", reference, rohc_ntoh32(sack_block->block_start),
-	                rohc_ntoh32(sack_block->block_end));
-
-	/* block_start =:= sack_var_length_enc(reference) */
-	ret = c_tcp_sack_code_pure_lsb(context, reference,
-	                               rohc_ntoh32(sack_block->block_start),
-	                               rohc_remain_data, rohc_remain_len);
-	if(ret < 0)
-	{
-		rohc_comp_warn(context, "failed to encode the SACK block start");
-		goto error;
-	}
-	rohc_remain_data += ret;
-	rohc_remain_len -= ret;
-
-	/* block_end =:= sack_var_length_enc(block_start) */
-	ret = c_tcp_sack_code_pure_lsb(context, rohc_ntoh32(sack_block->block_start),
-	                               rohc_ntoh32(sack_block->block_end),
-	                               rohc_remain_data, rohc_remain_len);
-	if(ret < 0)
-	{
-		rohc_comp_warn(context, "failed to encode the SACK block end");
-		goto error;
-	}
-#ifndef __clang_analyzer__ /* silent warning about dead in/decrement */
-	rohc_remain_data += ret;
-#endif
-	rohc_remain_len -= ret;
-
-	return (rohc_max_len - rohc_remain_len);
-
-error:
-	return -1;
+	return c_tcp_sack_field_lens[32 - __builtin_clz(sack_field | 1)];
 }
 
 
 /**
- * @brief Compress one SACK field value
+ * @brief Write one SACK field encoded with sack_var_length_enc()
  *
  * See RFC6846 page 67
  * (and RFC2018 for Selective Acknowledgement option)
  *
- * @param context         The compression context
- * @param base            The base value
- * @param field           The value to compress
- * @param[out] rohc_data  The ROHC packet being built
- * @param rohc_max_len    The max remaining length in the ROHC buffer
- * @return                The length appended in the ROHC buffer if positive,
- *                        -1 in case of error
+ * @param sack_field      The SACK field to encode
+ * @param len             The length of the encoded SACK field, as given by
+ *                        \ref c_tcp_sack_field_len
+ * @param[out] rohc_data  The ROHC packet being built, with at least \e len
+ *                        bytes available
  */
-static int c_tcp_sack_code_pure_lsb(const struct rohc_comp_ctxt *const context,
-                                    const uint32_t base,
-                                    const uint32_t field,
-                                    uint8_t *const rohc_data,
-                                    const size_t rohc_max_len)
+static inline void c_tcp_sack_field_write(const uint32_t sack_field,
+                                          const uint8_t len,
+                                          uint8_t *const rohc_data)
 {
-	/* if base can be >= field, overflow is expected */
-	const uint32_t sack_field = field - base;
-	size_t len;
+	const uint64_t encoded = c_tcp_sack_field_discrs[len] | sack_field;
+	uint8_t i;
 
-	if(sack_field < 0x8000)
-	{
-		/* 2 bytes with discriminator '0' */
-		len = 2;
-		if(rohc_max_len < len)
-		{
-			rohc_comp_warn(context, "ROHC buffer too small for the SACK pure LSB: "
-			               "%zu bytes required, but only %zu bytes available",
-			               len, rohc_max_len);
-			goto error;
-		}
-		rohc_data[0] = (sack_field >> 8) & 0x7f;
-		rohc_data[1] = sack_field & 0xff;
-	}
-	else if(sack_field < 0x400000)
-	{
-		/* 3 bytes with discriminator '10' */
-		len = 3;
-		if(rohc_max_len < len)
-		{
-			rohc_comp_warn(context, "ROHC buffer too small for the SACK pure LSB: "
-			               "%zu bytes required, but only %zu bytes available",
-			               len, rohc_max_len);
-			goto error;
-		}
-		rohc_data[0] = 0x80 | ((sack_field >> 16) & 0x3f);
-		rohc_data[1] = (sack_field >> 8) & 0xff;
-		rohc_data[2] = sack_field & 0xff;
-	}
-	else if(sack_field < 0x20000000)
-	{
-		/* 4 bytes with discriminator '110' */
-		len = 4;
-		if(rohc_max_len < len)
-		{
-			rohc_comp_warn(context, "ROHC buffer too small for the SACK pure LSB: "
-			               "%zu bytes required, but only %zu bytes available",
-			               len, rohc_max_len);
-			goto error;
-		}
-		rohc_data[0] = 0xc0 | ((sack_field >> 24) & 0x1f);
-		rohc_data[1] = (sack_field >> 16) & 0xff;
-		rohc_data[2] = (sack_field >> 8) & 0xff;
-		rohc_data[3] = sack_field & 0xff;
-	}
-	else
+	assert(len >= 2 && len <= 5);
+
+	for(i = 0; i < len; i++)
 	{
-		/* 5 bytes with discriminator '11111111' */
-		len = 5;
-		if(rohc_max_len < len)
-		{
-			rohc_comp_warn(context, "ROHC buffer too small for the SACK pure LSB: "
-			               "%zu bytes required, but only %zu bytes available",
-			               len, rohc_max_len);
-			goto error;
-		}
-		rohc_data[0] = 0xff;
-		rohc_data[1] = (sack_field >> 24) & 0xff;
-		rohc_data[2] = (sack_field >> 16) & 0xff;
-		rohc_data[3] = (sack_field >> 8) & 0xff;
-		rohc_data[4] = sack_field & 0xff;
+		rohc_data[i] = (encoded >> ((len - 1 - i) * 8)) & 0xff;
 	}
-
-	rohc_comp_debug(context, "sack_field = 0x%x (0x%x - 0x%x) encoded on %zu "
-	                "bytes (discriminator included)", sack_field, field,
-	                base, len);
-
-	return len;
-
-error:
-	return -1;
 }
-
@@ -26,6 +26,7 @@
 #include "rohc_comp.h"
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <stdbool.h>
 #include <string.h>
 #include <assert.h>
@@ -52,6 +53,41 @@ static int random_cb(const struct rohc_comp *const comp,
                      void *const user_context)
 	__attribute__((warn_unused_result));
 
+static bool rtp_detect_cb(const unsigned char *const ip,
+                          const unsigned char *const udp,
+                          const unsigned char *const payload,
+                          const unsigned int payload_size,
+                          void *const rtp_private)
+	__attribute__((warn_unused_result));
+
+/** A snapshot kept in memory */
+struct snapshot_buf
+{
+	uint8_t data[16384];  /**< The bytes of the snapshot */
+	size_t len;           /**< The number of bytes written */
+	size_t pos;           /**< The number of bytes read */
+};
+
+static bool snapshot_write_cb(void *const priv,
+                              const uint8_t *const data,
+                              const size_t len)
+	__attribute__((warn_unused_result));
+static bool snapshot_read_cb(void *const priv,
+                             uint8_t *const data,
+                             const size_t len)
+	__attribute__((warn_unused_result));
+
+/** The counters of a custom allocator */
+struct alloc_counters
+{
+	size_t allocs_nr;  /**< The number of memory allocations */
+	size_t frees_nr;   /**< The number of memory releases */
+};
+
+static void * test_malloc(const size_t size, void *const opaque)
+	__attribute__((warn_unused_result));
+static void test_free(void *const ptr, void *const opaque);
+
 
 /**
  * @brief Test the robustness of the compression API
@@ -121,6 +157,27 @@ int main(int argc, char *argv[])
 		CHECK(rohc_comp_set_traces_cb2(comp, fct, comp) == true);
 	}
 
+	/* rohc_comp_set_trace_level() */
+	CHECK(rohc_comp_set_trace_level(NULL, ROHC_TRACE_WARNING) == false);
+	CHECK(rohc_comp_set_trace_level(comp, ROHC_TRACE_LEVEL_MAX) == false);
+	CHECK(rohc_comp_set_trace_level(comp, ROHC_TRACE_WARNING) == true);
+	CHECK(rohc_comp_set_trace_level(comp, ROHC_TRACE_DEBUG) == true);
+
+	/* rohc_comp_set_trace_ring() and rohc_comp_get_trace_records() */
+	{
+		struct rohc_trace_record records[4];
+		size_t records_nr;
+
+		CHECK(rohc_comp_set_trace_ring(NULL, 4) == false);
+		CHECK(rohc_comp_set_trace_ring(comp, 3) == false);
+		CHECK(rohc_comp_set_trace_ring(comp, 4) == true);
+		CHECK(rohc_comp_get_trace_records(NULL, records, 4, &records_nr) == false);
+		CHECK(rohc_comp_get_trace_records(comp, NULL, 4, &records_nr) == false);
+		CHECK(rohc_comp_get_trace_records(comp, records, 4, NULL) == false);
+		CHECK(rohc_comp_get_trace_records(comp, records, 4, &records_nr) == true);
+		CHECK(records_nr == 0);
+	}
+
 	/* rohc_comp_profile_enabled() */
 	CHECK(rohc_comp_profile_enabled(NULL, ROHC_PROFILE_IP) == false);
 	CHECK(rohc_comp_profile_enabled(comp, ROHC_PROFILE_GENERAL) == false);
@@ -156,6 +213,10 @@ int main(int argc, char *argv[])
 	CHECK(rohc_comp_disable_profiles(comp, ROHC_PROFILE_UDP,
 	                                 ROHC_PROFILE_RTP, -1) == true);
 
+	/* rohc_comp_register_profile() */
+	CHECK(rohc_comp_register_profile(NULL, NULL, 0) == false);
+	CHECK(rohc_comp_register_profile(comp, NULL, 0) == false);
+
 	/* rohc_comp_profile_enabled() */
 	CHECK(rohc_comp_profile_enabled(comp, ROHC_PROFILE_UNCOMPRESSED) == false);
 	CHECK(rohc_comp_profile_enabled(comp, ROHC_PROFILE_RTP) == false);
@@ -185,16 +246,55 @@ int main(int argc, char *argv[])
 		CHECK(rohc_comp_get_segment2(comp, &pkt1) == ROHC_STATUS_ERROR);
 	}
 
+	/* rohc_comp_get_segment_iov() */
+	{
+		struct rohc_buf segment_iov[2];
+		size_t segment_iov_nr = 2;
+		CHECK(rohc_comp_get_segment_iov(NULL, 100, segment_iov,
+		                                &segment_iov_nr) == ROHC_STATUS_ERROR);
+		CHECK(rohc_comp_get_segment_iov(comp, 100, NULL,
+		                                &segment_iov_nr) == ROHC_STATUS_ERROR);
+		CHECK(rohc_comp_get_segment_iov(comp, 100, segment_iov,
+		                                NULL) == ROHC_STATUS_ERROR);
+		segment_iov_nr = 1;
+		CHECK(rohc_comp_get_segment_iov(comp, 100, segment_iov,
+		                                &segment_iov_nr) == ROHC_STATUS_ERROR);
+		segment_iov_nr = 2;
+		CHECK(rohc_comp_get_segment_iov(comp, 1, segment_iov,
+		                                &segment_iov_nr) == ROHC_STATUS_ERROR);
+		CHECK(rohc_comp_get_segment_iov(comp, 100, segment_iov,
+		                                &segment_iov_nr) == ROHC_STATUS_ERROR);
+	}
+
 	/* rohc_comp_force_contexts_reinit() */
 	CHECK(rohc_comp_force_contexts_reinit(NULL) == false);
 	CHECK(rohc_comp_force_contexts_reinit(comp) == true);
 
+	/* rohc_comp_set_reinit_pacing() */
+	CHECK(rohc_comp_set_reinit_pacing(NULL, 1) == false);
+	CHECK(rohc_comp_set_reinit_pacing(comp, 1) == true);
+	CHECK(rohc_comp_set_reinit_pacing(comp, 0) == true);
+
 	/* rohc_comp_set_wlsb_window_width() */
 	CHECK(rohc_comp_set_wlsb_window_width(NULL, 16) == false);
 	CHECK(rohc_comp_set_wlsb_window_width(comp, 0) == false);
 	CHECK(rohc_comp_set_wlsb_window_width(comp, 15) == false);
 	CHECK(rohc_comp_set_wlsb_window_width(comp, 16) == true);
 
+	/* rohc_comp_set_ctxts_prealloc() */
+	CHECK(rohc_comp_set_ctxts_prealloc(NULL, 1) == false);
+	CHECK(rohc_comp_set_ctxts_prealloc(comp, ROHC_SMALL_CID_MAX + 2) == false);
+	CHECK(rohc_comp_set_ctxts_prealloc(comp, ROHC_SMALL_CID_MAX + 1) == true);
+	CHECK(rohc_comp_set_ctxts_prealloc(comp, 0) == true);
+
+	/* rohc_comp_prewarm_ctxts() */
+	CHECK(rohc_comp_prewarm_ctxts(NULL, ROHC_PROFILE_IP, 1) == false);
+	CHECK(rohc_comp_prewarm_ctxts(comp, ROHC_PROFILE_TCP, 1) == false);
+	CHECK(rohc_comp_prewarm_ctxts(comp, ROHC_PROFILE_IP,
+	                              ROHC_SMALL_CID_MAX + 2) == false);
+	CHECK(rohc_comp_prewarm_ctxts(comp, ROHC_PROFILE_IP, 0) == true);
+	CHECK(rohc_comp_prewarm_ctxts(comp, ROHC_PROFILE_IP, 4) == true);
+
 	/* rohc_comp_set_periodic_refreshes() */
 	CHECK(rohc_comp_set_periodic_refreshes(NULL, 1700, 700) == false);
 	CHECK(rohc_comp_set_periodic_refreshes(comp, 0, 700) == false);
@@ -202,6 +302,25 @@ int main(int argc, char *argv[])
 	CHECK(rohc_comp_set_periodic_refreshes(comp, 5, 10) == false);
 	CHECK(rohc_comp_set_periodic_refreshes(comp, 10, 5) == true);
 
+	/* rohc_comp_set_periodic_refreshes_time() */
+	CHECK(rohc_comp_set_periodic_refreshes_time(NULL, 1000, 500) == false);
+	CHECK(rohc_comp_set_periodic_refreshes_time(comp, 0, 500) == false);
+	CHECK(rohc_comp_set_periodic_refreshes_time(comp, 500, 1000) == false);
+	CHECK(rohc_comp_set_periodic_refreshes_time(comp, 1000, 1000) == false);
+	CHECK(rohc_comp_set_periodic_refreshes_time(comp, 1000, 0) == true);
+	CHECK(rohc_comp_set_periodic_refreshes_time(comp, 1000, 500) == true);
+	CHECK(rohc_comp_set_periodic_refreshes_time(comp, 0, 0) == true);
+
+	/* rohc_comp_set_ctxt_idle_timeout() */
+	CHECK(rohc_comp_set_ctxt_idle_timeout(NULL, 30) == false);
+	CHECK(rohc_comp_set_ctxt_idle_timeout(comp, 30) == true);
+	CHECK(rohc_comp_set_ctxt_idle_timeout(comp, 0) == true);
+
+	/* rohc_comp_set_profile_failure_timeout() */
+	CHECK(rohc_comp_set_profile_failure_timeout(NULL, 10) == false);
+	CHECK(rohc_comp_set_profile_failure_timeout(comp, 10) == true);
+	CHECK(rohc_comp_set_profile_failure_timeout(comp, 0) == true);
+
 	/* rohc_comp_set_list_trans_nr() */
 	CHECK(rohc_comp_set_list_trans_nr(NULL, 5) == false);
 	CHECK(rohc_comp_set_list_trans_nr(comp, 0) == false);
@@ -216,6 +335,25 @@ int main(int argc, char *argv[])
 		CHECK(rohc_comp_set_rtp_detection_cb(comp, fct, NULL) == true);
 	}
 
+	/* rohc_comp_add_rtp_ports() */
+	CHECK(rohc_comp_add_rtp_ports(NULL, 5004, 5004) == false);
+	CHECK(rohc_comp_add_rtp_ports(comp, 5006, 5004) == false);
+	CHECK(rohc_comp_add_rtp_ports(comp, 5004, 5006) == true);
+	CHECK(rohc_comp_add_rtp_ports(comp, 0, 65535) == true);
+
+	/* rohc_comp_remove_rtp_ports() */
+	CHECK(rohc_comp_remove_rtp_ports(NULL, 5004, 5004) == false);
+	CHECK(rohc_comp_remove_rtp_ports(comp, 5006, 5004) == false);
+	CHECK(rohc_comp_remove_rtp_ports(comp, 0, 65535) == true);
+	CHECK(rohc_comp_remove_rtp_ports(comp, 0, 65535) == true);
+
+	/* rohc_comp_set_rtp_min_sequential() */
+	CHECK(rohc_comp_set_rtp_min_sequential(NULL, 2) == false);
+	CHECK(rohc_comp_set_rtp_min_sequential(comp, 0) == false);
+	CHECK(rohc_comp_set_rtp_min_sequential(comp, 65535 + 1) == false);
+	CHECK(rohc_comp_set_rtp_min_sequential(comp, 65535) == true);
+	CHECK(rohc_comp_set_rtp_min_sequential(comp, 1) == true);
+
 	/* rohc_comp_set_mrru() */
 	CHECK(rohc_comp_set_mrru(NULL, 10) == false);
 	CHECK(rohc_comp_set_mrru(comp, 65535 + 1) == false);
@@ -230,6 +368,14 @@ int main(int argc, char *argv[])
 		CHECK(rohc_comp_get_mrru(comp, &mrru) == true);
 		CHECK(mrru == 65535);
 	}
+
+	/* rohc_comp_set_rru_slots() */
+	CHECK(rohc_comp_set_rru_slots(NULL, 4) == false);
+	CHECK(rohc_comp_set_rru_slots(comp, 0) == false);
+	CHECK(rohc_comp_set_rru_slots(comp, 16 + 1) == false);
+	CHECK(rohc_comp_set_rru_slots(comp, 16) == true);
+	CHECK(rohc_comp_set_rru_slots(comp, 1) == true);
+
 	/* disable MRRU for next tests */
 	CHECK(rohc_comp_set_mrru(comp, 0) == true);
 
@@ -260,6 +406,9 @@ int main(int argc, char *argv[])
 		CHECK(rohc_comp_get_last_packet_info2(comp, &info) == false);
 	}
 
+	/* record the processing time of the next packets */
+	CHECK(rohc_comp_set_features(comp, ROHC_COMP_FEATURE_LATENCY) == true);
+
 	/* rohc_compress4() */
 	{
 		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
@@ -302,6 +451,143 @@ int main(int argc, char *argv[])
 		pkt2.offset = 0;
 		pkt2.len = 0;
 		CHECK(rohc_compress4(comp, pkt, &pkt2) == ROHC_STATUS_OK);
+
+		/* no allocation to compress with an existing context (only if the
+		 * library was built with --enable-alloc-check) */
+		if(rohc_alloc_set_steady_state(ROHC_ALLOC_STEADY_REPORT))
+		{
+			rohc_alloc_stats_t alloc_stats;
+			memset(&alloc_stats, 0, sizeof(rohc_alloc_stats_t));
+			pkt2.offset = 0;
+			pkt2.len = 0;
+			CHECK(rohc_compress4(comp, pkt, &pkt2) == ROHC_STATUS_OK);
+			CHECK(rohc_alloc_set_steady_state(ROHC_ALLOC_STEADY_OFF) == true);
+			CHECK(rohc_alloc_get_stats(&alloc_stats) == true);
+			CHECK(alloc_stats.steady_allocs_nr == 0);
+		}
+
+		/* rohc_compress_batch() */
+		{
+			struct rohc_buf in_pkts[3] = { pkt, pkt1, pkt };
+			uint8_t out_bufs[3][100];
+			struct rohc_buf out_pkts[3] =
+			{
+				rohc_buf_init_empty(out_bufs[0], 100),
+				rohc_buf_init_empty(out_bufs[1], 100),
+				rohc_buf_init_empty(out_bufs[2], 100),
+			};
+			rohc_status_t statuses[3];
+
+			CHECK(rohc_compress_batch(NULL, in_pkts, out_pkts, statuses, 3) == 0);
+			CHECK(rohc_compress_batch(comp, NULL, out_pkts, statuses, 3) == 0);
+			CHECK(rohc_compress_batch(comp, in_pkts, NULL, statuses, 3) == 0);
+			CHECK(rohc_compress_batch(comp, in_pkts, out_pkts, NULL, 3) == 0);
+			CHECK(rohc_compress_batch(comp, in_pkts, out_pkts, statuses, 0) == 0);
+			CHECK(rohc_compress_batch(comp, in_pkts, out_pkts, statuses, 3) == 3);
+			CHECK(statuses[0] == ROHC_STATUS_OK);
+			CHECK(statuses[1] == ROHC_STATUS_ERROR);
+			CHECK(statuses[2] == ROHC_STATUS_OK);
+		}
+
+		/* rohc_compress_iov() */
+		{
+			struct rohc_buf iov[2] =
+			{
+				rohc_buf_init_full(buf, 40, ts),
+				rohc_buf_init_full(buf + 40, sizeof(buf) - 40, ts),
+			};
+			uint8_t out_buf[100];
+			struct rohc_buf out_pkt = rohc_buf_init_empty(out_buf, 100);
+
+			CHECK(rohc_compress_iov(NULL, iov, 2, &out_pkt) == ROHC_STATUS_ERROR);
+			CHECK(rohc_compress_iov(comp, NULL, 2, &out_pkt) == ROHC_STATUS_ERROR);
+			CHECK(rohc_compress_iov(comp, iov, 0, &out_pkt) == ROHC_STATUS_ERROR);
+			CHECK(rohc_compress_iov(comp, iov, 2, NULL) == ROHC_STATUS_ERROR);
+			iov[1].len = sizeof(buf);
+			CHECK(rohc_compress_iov(comp, iov, 2, &out_pkt) == ROHC_STATUS_ERROR);
+			iov[1].len = sizeof(buf) - 40;
+			CHECK(rohc_compress_iov(comp, iov, 2, &out_pkt) == ROHC_STATUS_OK);
+			CHECK(out_pkt.len > 0);
+			CHECK(memcmp(out_buf + out_pkt.len - 4, buf + sizeof(buf) - 4, 4) == 0);
+		}
+
+		/* rohc_compress_with_cid() */
+		{
+			rohc_comp_last_packet_info2_t info;
+			uint8_t out_buf[100];
+			struct rohc_buf out_pkt = rohc_buf_init_empty(out_buf, 100);
+
+			memset(&info, 0, sizeof(rohc_comp_last_packet_info2_t));
+			CHECK(rohc_compress_with_cid(NULL, 3, pkt, &out_pkt) == ROHC_STATUS_ERROR);
+			CHECK(rohc_compress_with_cid(comp, ROHC_SMALL_CID_MAX + 1, pkt,
+			                             &out_pkt) == ROHC_STATUS_ERROR);
+			CHECK(rohc_compress_with_cid(comp, 3, pkt1, &out_pkt) == ROHC_STATUS_ERROR);
+			CHECK(rohc_compress_with_cid(comp, 3, pkt, NULL) == ROHC_STATUS_ERROR);
+			CHECK(rohc_compress_with_cid(comp, 3, pkt, &out_pkt) == ROHC_STATUS_OK);
+			CHECK(rohc_comp_get_last_packet_info2(comp, &info) == true);
+			CHECK(info.context_id == 3);
+			CHECK(info.is_context_init == true);
+			out_pkt.len = 0;
+			CHECK(rohc_compress_with_cid(comp, 3, pkt, &out_pkt) == ROHC_STATUS_OK);
+			CHECK(rohc_comp_get_last_packet_info2(comp, &info) == true);
+			CHECK(info.context_id == 3);
+			CHECK(info.is_context_init == false);
+		}
+
+		/* rohc_compress_header() */
+		{
+			uint8_t hdr_buf[100];
+			struct rohc_buf hdr = rohc_buf_init_empty(hdr_buf, 100);
+			size_t payload_offset;
+			size_t payload_len;
+
+			CHECK(rohc_compress_header(NULL, pkt, &hdr, &payload_offset,
+			                           &payload_len) == ROHC_STATUS_ERROR);
+			CHECK(rohc_compress_header(comp, pkt1, &hdr, &payload_offset,
+			                           &payload_len) == ROHC_STATUS_ERROR);
+			CHECK(rohc_compress_header(comp, pkt, NULL, &payload_offset,
+			                           &payload_len) == ROHC_STATUS_ERROR);
+			CHECK(rohc_compress_header(comp, pkt, &hdr, NULL,
+			                           &payload_len) == ROHC_STATUS_ERROR);
+			CHECK(rohc_compress_header(comp, pkt, &hdr, &payload_offset,
+			                           NULL) == ROHC_STATUS_ERROR);
+			hdr.max_len = 1;
+			CHECK(rohc_compress_header(comp, pkt, &hdr, &payload_offset,
+			                           &payload_len) == ROHC_STATUS_ERROR);
+			hdr.max_len = 100;
+			CHECK(rohc_compress_header(comp, pkt, &hdr, &payload_offset,
+			                           &payload_len) == ROHC_STATUS_OK);
+			CHECK(hdr.len > 0);
+			CHECK((payload_offset + payload_len) == pkt.len);
+		}
+
+		/* rohc_compress_inplace() */
+		{
+			uint8_t inplace_buf[100 + sizeof(buf)];
+			struct rohc_buf inplace_pkt =
+				rohc_buf_init_full(inplace_buf, sizeof(inplace_buf), ts);
+
+			memcpy(inplace_buf + 100, buf, sizeof(buf));
+			inplace_pkt.offset = 100;
+			inplace_pkt.len = sizeof(buf);
+			CHECK(rohc_compress_inplace(NULL, &inplace_pkt) == ROHC_STATUS_ERROR);
+			CHECK(rohc_compress_inplace(comp, NULL) == ROHC_STATUS_ERROR);
+			inplace_pkt.len = 0;
+			CHECK(rohc_compress_inplace(comp, &inplace_pkt) == ROHC_STATUS_ERROR);
+			inplace_pkt.len = sizeof(buf) + 1;
+			CHECK(rohc_compress_inplace(comp, &inplace_pkt) == ROHC_STATUS_ERROR);
+			/* no headroom for the ROHC header */
+			inplace_pkt.offset = 0;
+			inplace_pkt.len = sizeof(buf);
+			CHECK(rohc_compress_inplace(comp, &inplace_pkt) == ROHC_STATUS_ERROR);
+			memcpy(inplace_buf + 100, buf, sizeof(buf));
+			inplace_pkt.offset = 100;
+			inplace_pkt.len = sizeof(buf);
+			CHECK(rohc_compress_inplace(comp, &inplace_pkt) == ROHC_STATUS_OK);
+			CHECK((inplace_pkt.offset + inplace_pkt.len) <= sizeof(inplace_buf));
+			CHECK(memcmp(inplace_buf + sizeof(inplace_buf) - 4,
+			             buf + sizeof(buf) - 4, 4) == 0);
+		}
 	}
 
 	/* rohc_comp_get_last_packet_info2() */
@@ -334,6 +620,154 @@ int main(int argc, char *argv[])
 		CHECK(rohc_comp_get_general_info(comp, &info) == true);
 	}
 
+	/* rohc_comp_get_next_ctxt_stats() */
+	{
+		rohc_comp_general_info_t info;
+		rohc_comp_ctxt_stats_t stats;
+		rohc_cid_t cid = 0;
+		size_t contexts_nr = 0;
+		memset(&info, 0, sizeof(rohc_comp_general_info_t));
+		CHECK(rohc_comp_get_general_info(comp, &info) == true);
+		memset(&stats, 0, sizeof(rohc_comp_ctxt_stats_t));
+		CHECK(rohc_comp_get_next_ctxt_stats(NULL, &cid, &stats) == false);
+		CHECK(rohc_comp_get_next_ctxt_stats(comp, NULL, &stats) == false);
+		CHECK(rohc_comp_get_next_ctxt_stats(comp, &cid, NULL) == false);
+		stats.version_major = 0xffff;
+		CHECK(rohc_comp_get_next_ctxt_stats(comp, &cid, &stats) == false);
+		stats.version_major = 0;
+		stats.version_minor = 0xffff;
+		CHECK(rohc_comp_get_next_ctxt_stats(comp, &cid, &stats) == false);
+		stats.version_minor = 0;
+		while(rohc_comp_get_next_ctxt_stats(comp, &cid, &stats))
+		{
+			CHECK(stats.context_id == cid);
+			CHECK(stats.packets_nr > 0);
+			CHECK(stats.packets_nr == (stats.ir_packets_nr + stats.fo_packets_nr +
+			                           stats.so_packets_nr));
+			CHECK(stats.header_uncomp_bytes_nr > 0);
+			contexts_nr++;
+			cid++;
+		}
+		CHECK(contexts_nr > 0);
+		CHECK(contexts_nr == info.contexts_nr);
+		cid = ROHC_SMALL_CID_MAX + 1;
+		CHECK(rohc_comp_get_next_ctxt_stats(comp, &cid, &stats) == false);
+	}
+
+	/* rohc_comp_get_packet_stats() */
+	{
+		rohc_comp_general_info_t info;
+		rohc_packet_stats_t stats;
+		unsigned long profiles_packets = 0;
+		unsigned long profiles_bytes = 0;
+		unsigned long types_packets = 0;
+		unsigned long types_bytes = 0;
+		size_t i;
+		memset(&info, 0, sizeof(rohc_comp_general_info_t));
+		CHECK(rohc_comp_get_general_info(comp, &info) == true);
+		memset(&stats, 0, sizeof(rohc_packet_stats_t));
+		CHECK(rohc_comp_get_packet_stats(NULL, &stats) == false);
+		CHECK(rohc_comp_get_packet_stats(comp, NULL) == false);
+		stats.version_major = 0xffff;
+		CHECK(rohc_comp_get_packet_stats(comp, &stats) == false);
+		stats.version_major = 0;
+		stats.version_minor = 0xffff;
+		CHECK(rohc_comp_get_packet_stats(comp, &stats) == false);
+		stats.version_minor = 0;
+		CHECK(rohc_comp_get_packet_stats(comp, &stats) == true);
+		for(i = 0; i < ROHC_PROFILE_MAX; i++)
+		{
+			profiles_packets += stats.profiles[i].packets_nr;
+			profiles_bytes += stats.profiles[i].comp_bytes_nr;
+		}
+		for(i = 0; i < ROHC_PACKET_MAX; i++)
+		{
+			types_packets += stats.packet_types[i].packets_nr;
+			types_bytes += stats.packet_types[i].comp_bytes_nr;
+		}
+		CHECK(profiles_packets == types_packets);
+		CHECK(profiles_bytes == info.comp_bytes_nr);
+		CHECK(types_bytes == info.comp_bytes_nr);
+	}
+
+	/* rohc_comp_get_stage_cycles() and rohc_comp_get_stage_descr() */
+	{
+		uint64_t cycles;
+		int stage;
+		CHECK(rohc_comp_get_stage_cycles(NULL, ROHC_COMP_STAGE_PARSE, &cycles) == false);
+		CHECK(rohc_comp_get_stage_cycles(comp, ROHC_COMP_STAGE_MAX, &cycles) == false);
+		CHECK(rohc_comp_get_stage_cycles(comp, ROHC_COMP_STAGE_PARSE, NULL) == false);
+		for(stage = 0; stage < ROHC_COMP_STAGE_MAX; stage++)
+		{
+			/* false if the library was built without --enable-stage-cycles */
+			cycles = 0;
+			if(!rohc_comp_get_stage_cycles(comp, stage, &cycles))
+			{
+				CHECK(cycles == 0);
+			}
+			CHECK(strcmp(rohc_comp_get_stage_descr(stage), "no description") != 0);
+		}
+		CHECK(strcmp(rohc_comp_get_stage_descr(ROHC_COMP_STAGE_MAX),
+		             "no description") == 0);
+	}
+
+	/* rohc_comp_get_latency_stats() */
+	{
+		rohc_latency_stats_t stats;
+		unsigned long types_packets = 0;
+		size_t i;
+		memset(&stats, 0, sizeof(rohc_latency_stats_t));
+		CHECK(rohc_comp_get_latency_stats(NULL, &stats) == false);
+		CHECK(rohc_comp_get_latency_stats(comp, NULL) == false);
+		stats.version_major = 0xffff;
+		CHECK(rohc_comp_get_latency_stats(comp, &stats) == false);
+		stats.version_major = 0;
+		stats.version_minor = 0xffff;
+		CHECK(rohc_comp_get_latency_stats(comp, &stats) == false);
+		stats.version_minor = 0;
+		CHECK(rohc_comp_get_latency_stats(comp, &stats) == true);
+		CHECK(stats.all.packets_nr > 0);
+		CHECK(stats.all.p50_ns <= stats.all.p99_ns);
+		CHECK(stats.all.p99_ns <= stats.all.p999_ns);
+		CHECK(stats.all.p999_ns <= stats.all.max_ns);
+		CHECK(stats.all.max_ns <= stats.all.total_ns);
+		for(i = 0; i < ROHC_PACKET_MAX; i++)
+		{
+			types_packets += stats.packet_types[i].packets_nr;
+		}
+		CHECK(types_packets == stats.all.packets_nr);
+	}
+
+	/* rohc_comp_get_memory_usage() */
+	{
+		rohc_comp_general_info_t info;
+		rohc_memory_usage_t mem;
+		size_t profiles_bytes = 0;
+		size_t i;
+		memset(&info, 0, sizeof(rohc_comp_general_info_t));
+		CHECK(rohc_comp_get_general_info(comp, &info) == true);
+		memset(&mem, 0, sizeof(rohc_memory_usage_t));
+		CHECK(rohc_comp_get_memory_usage(NULL, &mem) == false);
+		CHECK(rohc_comp_get_memory_usage(comp, NULL) == false);
+		mem.version_major = 0xffff;
+		CHECK(rohc_comp_get_memory_usage(comp, &mem) == false);
+		mem.version_major = 0;
+		mem.version_minor = 0xffff;
+		CHECK(rohc_comp_get_memory_usage(comp, &mem) == false);
+		mem.version_minor = 0;
+		CHECK(rohc_comp_get_memory_usage(comp, &mem) == true);
+		CHECK(mem.instance_bytes > 0);
+		CHECK(mem.contexts_nr == info.contexts_nr);
+		for(i = 0; i < ROHC_PROFILE_MAX; i++)
+		{
+			profiles_bytes += mem.profiles_bytes[i];
+		}
+		CHECK(profiles_bytes == mem.contexts_bytes);
+		CHECK(mem.wlsb_bytes <= mem.contexts_bytes);
+		CHECK(mem.total_bytes ==
+		      (mem.instance_bytes + mem.contexts_bytes + mem.rru_bytes));
+	}
+
 	/* rohc_comp_get_state_descr() */
 	CHECK(strcmp(rohc_comp_get_state_descr(ROHC_COMP_STATE_IR), "IR") == 0);
 	CHECK(strcmp(rohc_comp_get_state_descr(ROHC_COMP_STATE_FO), "FO") == 0);
@@ -342,12 +776,34 @@ int main(int argc, char *argv[])
 
 	/* rohc_comp_force_contexts_reinit() with some contexts init'ed */
 	CHECK(rohc_comp_force_contexts_reinit(comp) == true);
+	CHECK(rohc_comp_set_reinit_pacing(comp, 1) == true);
+	CHECK(rohc_comp_force_contexts_reinit(comp) == true);
+	CHECK(rohc_comp_set_reinit_pacing(comp, 0) == true);
 
 	/* rohc_comp_set_features */
 	CHECK(rohc_comp_set_features(comp, ROHC_COMP_FEATURE_COMPAT_1_6_x) == false);
 	CHECK(rohc_comp_set_features(comp, ROHC_COMP_FEATURE_NO_IP_CHECKSUMS) == true);
+	CHECK(rohc_comp_set_features(comp, ROHC_COMP_FEATURE_SEGMENT_VIEWS) == true);
+	CHECK(rohc_comp_set_features(comp, ROHC_COMP_FEATURE_ADAPTIVE_WLSB) == true);
+	CHECK(rohc_comp_set_features(comp, ROHC_COMP_FEATURE_CHEAP_PACKETS) == true);
+	CHECK(rohc_comp_set_features(comp, ROHC_COMP_FEATURE_CLONE_CTXTS) == true);
+	CHECK(rohc_comp_set_features(comp, ROHC_COMP_FEATURE_COLD_CTXTS) == true);
+	CHECK(rohc_comp_set_features(comp, ROHC_COMP_FEATURE_NO_ALLOC |
+	                                   ROHC_COMP_FEATURE_COLD_CTXTS) == false);
+	CHECK(rohc_comp_set_features(comp, ROHC_COMP_FEATURE_NO_ALLOC) == true);
 	CHECK(rohc_comp_set_features(comp, ROHC_COMP_FEATURE_NONE) == true);
 
+	/* rohc_comp_set_recorder() */
+	{
+		struct snapshot_buf recording;
+
+		recording.len = 0;
+		CHECK(rohc_comp_set_recorder(NULL, snapshot_write_cb, &recording, 0) == false);
+		CHECK(rohc_comp_set_recorder(comp, snapshot_write_cb, &recording, 0) == true);
+		CHECK(recording.len > 0);
+		CHECK(rohc_comp_set_recorder(comp, NULL, NULL, 0) == true);
+	}
+
 	/* rohc_comp_deliver_feedback2() */
 	{
 		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
@@ -363,22 +819,670 @@ int main(int argc, char *argv[])
 		pkt.len = 5; CHECK(rohc_comp_deliver_feedback2(comp, pkt) == true);
 	}
 
+	/* rohc_comp_deliver_feedback_batch() */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t buf[] = {
+			0xf4, 0x20, 0x01, 0x11, 0x39,
+			0xf4, 0x20, 0x01, 0x11, 0x39,
+			0xf5, 0xe5, 0x20, 0x01, 0x11, 0x39,
+			0xf4, 0x20, 0x01, 0x11, 0x39,
+		};
+		struct rohc_buf pkt = rohc_buf_init_full(buf, 10, ts);
+
+		CHECK(rohc_comp_deliver_feedback_batch(NULL, pkt) == false);
+		pkt.len = 0; CHECK(rohc_comp_deliver_feedback_batch(comp, pkt) == true);
+		pkt.len = 7; CHECK(rohc_comp_deliver_feedback_batch(comp, pkt) == false);
+		pkt.len = 10; CHECK(rohc_comp_deliver_feedback_batch(comp, pkt) == true);
+		pkt.len = 21; CHECK(rohc_comp_deliver_feedback_batch(comp, pkt) == false);
+	}
+
+	/* rohc_comp_enqueue_feedback() */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t buf[65] = { 0xf4, 0x20, 0x01, 0x11, 0x39 };
+		struct rohc_buf pkt = rohc_buf_init_full(buf, 5, ts);
+		size_t i;
+
+		CHECK(rohc_comp_enqueue_feedback(NULL, pkt) == false);
+		pkt.len = 65; CHECK(rohc_comp_enqueue_feedback(comp, pkt) == false);
+		pkt.len = 5;
+		for(i = 0; i < 32; i++)
+		{
+			CHECK(rohc_comp_enqueue_feedback(comp, pkt) == true);
+		}
+		CHECK(rohc_comp_enqueue_feedback(comp, pkt) == false);
+	}
+
+	/* rohc_comp_get_trace_records() with some packets already compressed */
+	{
+		struct rohc_trace_record records[4];
+		size_t records_nr;
+
+		CHECK(rohc_comp_get_trace_records(comp, records, 4, &records_nr) == true);
+		CHECK(records_nr > 0);
+	}
+
 	/* several functions with some packets already compressed */
 	{
 		rohc_trace_callback2_t fct = (rohc_trace_callback2_t) NULL;
 		CHECK(rohc_comp_set_traces_cb2(comp, fct, comp) == false);
+		CHECK(rohc_comp_set_trace_level(comp, ROHC_TRACE_WARNING) == false);
+		CHECK(rohc_comp_set_trace_ring(comp, 8) == false);
 
 		CHECK(rohc_comp_set_wlsb_window_width(comp, 16) == false);
 
 		CHECK(rohc_comp_set_periodic_refreshes(comp, 10, 5) == false);
+		CHECK(rohc_comp_set_periodic_refreshes_time(comp, 1000, 500) == false);
 
 		CHECK(rohc_comp_set_list_trans_nr(comp, 5) == false);
+
+		/* the idle timeout may be changed at any time */
+		CHECK(rohc_comp_set_ctxt_idle_timeout(comp, 30) == true);
+		CHECK(rohc_comp_set_ctxt_idle_timeout(comp, 0) == true);
 	}
 
 	/* rohc_comp_free() */
 	rohc_comp_free(NULL);
 	rohc_comp_free(comp);
 
+	/* contexts released after the idle timeout */
+	{
+		struct rohc_ts ts = { .sec = 10, .nsec = 0 };
+		uint8_t buf1[] =
+		{
+			0x45, 0x00, 0x00, 0x1c,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x01, 0x93, 0x8a,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x05,  0x08, 0x00, 0xf7, 0xff,
+			0x00, 0x00, 0x00, 0x00
+		};
+		uint8_t buf2[] =
+		{
+			0x45, 0x00, 0x00, 0x1c,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x01, 0x93, 0x89,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x06,  0x08, 0x00, 0xf7, 0xff,
+			0x00, 0x00, 0x00, 0x00
+		};
+		struct rohc_buf pkt1 = rohc_buf_init_full(buf1, sizeof(buf1), ts);
+		struct rohc_buf pkt2 = rohc_buf_init_full(buf2, sizeof(buf2), ts);
+		uint8_t rohc_buf[100];
+		struct rohc_buf rohc_pkt = rohc_buf_init_empty(rohc_buf, 100);
+		rohc_comp_general_info_t info;
+
+		comp = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, random_cb, NULL);
+		CHECK(comp != NULL);
+		CHECK(rohc_comp_enable_profile(comp, ROHC_PROFILE_IP) == true);
+		CHECK(rohc_comp_set_ctxt_idle_timeout(comp, 30) == true);
+		memset(&info, 0, sizeof(rohc_comp_general_info_t));
+
+		/* one context per flow */
+		CHECK(rohc_compress4(comp, pkt1, &rohc_pkt) == ROHC_STATUS_OK);
+		pkt2.time.sec = 20;
+		rohc_pkt.len = 0;
+		CHECK(rohc_compress4(comp, pkt2, &rohc_pkt) == ROHC_STATUS_OK);
+		CHECK(rohc_comp_get_general_info(comp, &info) == true);
+		CHECK(info.contexts_nr == 2);
+
+		/* the 1st flow is idle for 30 seconds, not the 2nd one */
+		pkt2.time.sec = 40;
+		rohc_pkt.len = 0;
+		CHECK(rohc_compress4(comp, pkt2, &rohc_pkt) == ROHC_STATUS_OK);
+		CHECK(rohc_comp_get_general_info(comp, &info) == true);
+		CHECK(info.contexts_nr == 1);
+
+		/* unknown arrival times never release contexts */
+		pkt1.time.sec = 0;
+		rohc_pkt.len = 0;
+		CHECK(rohc_compress4(comp, pkt1, &rohc_pkt) == ROHC_STATUS_OK);
+		CHECK(rohc_comp_get_general_info(comp, &info) == true);
+		CHECK(info.contexts_nr == 2);
+
+		/* rohc_comp_reset() releases all contexts at once */
+		CHECK(rohc_comp_reset(NULL) == false);
+		CHECK(rohc_comp_reset(comp) == true);
+		CHECK(rohc_comp_get_general_info(comp, &info) == true);
+		CHECK(info.contexts_nr == 0);
+		rohc_pkt.len = 0;
+		CHECK(rohc_compress4(comp, pkt1, &rohc_pkt) == ROHC_STATUS_OK);
+		CHECK(rohc_comp_get_general_info(comp, &info) == true);
+		CHECK(info.contexts_nr == 1);
+
+		rohc_comp_free(comp);
+	}
+
+	/* headers split across the buffers of rohc_compress_iov() */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t buf[] =
+		{
+			/* IPv4 */
+			0x45, 0x00, 0x00, 0x30,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x11, 0x93, 0x66,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x05,
+			/* UDP */
+			0x04, 0xd2, 0x04, 0xd2,  0x00, 0x1c, 0x00, 0x00,
+			/* RTP */
+			0x80, 0x00, 0x00, 0x01,  0x00, 0x00, 0x00, 0xa0,
+			0x12, 0x34, 0x56, 0x78,
+			/* payload */
+			0x00, 0x01, 0x02, 0x03,  0x04, 0x05, 0x06, 0x07
+		};
+		const size_t splits[] = { 10, 24, 30, 36 };
+		struct rohc_comp *ref_comp;
+		rohc_comp_last_packet_info2_t last_info;
+		rohc_comp_general_info_t info;
+		size_t i;
+		size_t j;
+
+		comp = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, random_cb, NULL);
+		CHECK(comp != NULL);
+		ref_comp = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, random_cb, NULL);
+		CHECK(ref_comp != NULL);
+		CHECK(rohc_comp_enable_profiles(comp, ROHC_PROFILE_RTP, ROHC_PROFILE_UDP,
+		                                ROHC_PROFILE_IP, -1) == true);
+		CHECK(rohc_comp_enable_profiles(ref_comp, ROHC_PROFILE_RTP, ROHC_PROFILE_UDP,
+		                                ROHC_PROFILE_IP, -1) == true);
+		CHECK(rohc_comp_add_rtp_ports(comp, 1234, 1234) == true);
+		CHECK(rohc_comp_add_rtp_ports(ref_comp, 1234, 1234) == true);
+		CHECK(rohc_comp_set_rtp_min_sequential(comp, 1) == true);
+		CHECK(rohc_comp_set_rtp_min_sequential(ref_comp, 1) == true);
+
+		/* the reference compressor gets every packet in one buffer, the other
+		 * one gets it first with its IP/UDP/RTP headers split across two
+		 * buffers, then with its headers in the first buffer: the rejected
+		 * packets shall change no context */
+		for(i = 0; i < 3; i++)
+		{
+			uint8_t ref_out_buf[100];
+			struct rohc_buf ref_out_pkt = rohc_buf_init_empty(ref_out_buf, 100);
+			const struct rohc_buf ref_pkt = rohc_buf_init_full(buf, sizeof(buf), ts);
+			uint8_t out_buf[100];
+			struct rohc_buf out_pkt = rohc_buf_init_empty(out_buf, 100);
+
+			buf[31] = i + 1; /* RTP SN */
+			buf[35] = 0xa0 + i * 0xa0; /* RTP TS */
+
+			for(j = 0; j < (sizeof(splits) / sizeof(size_t)); j++)
+			{
+				const struct rohc_buf iov[2] =
+				{
+					rohc_buf_init_full(buf, splits[j], ts),
+					rohc_buf_init_full(buf + splits[j], sizeof(buf) - splits[j], ts),
+				};
+
+				CHECK(rohc_compress_iov(comp, iov, 2, &out_pkt) == ROHC_STATUS_ERROR);
+				CHECK(out_pkt.len == 0);
+				memset(&info, 0, sizeof(rohc_comp_general_info_t));
+				CHECK(rohc_comp_get_general_info(comp, &info) == true);
+				CHECK(info.contexts_nr == (i == 0 ? 0 : 1));
+			}
+
+			{
+				const struct rohc_buf iov[2] =
+				{
+					rohc_buf_init_full(buf, 40, ts),
+					rohc_buf_init_full(buf + 40, sizeof(buf) - 40, ts),
+				};
+
+				CHECK(rohc_compress_iov(comp, iov, 2, &out_pkt) == ROHC_STATUS_OK);
+			}
+			memset(&last_info, 0, sizeof(rohc_comp_last_packet_info2_t));
+			CHECK(rohc_comp_get_last_packet_info2(comp, &last_info) == true);
+			CHECK(last_info.profile_id == ROHC_PROFILE_RTP);
+			CHECK(rohc_compress4(ref_comp, ref_pkt, &ref_out_pkt) == ROHC_STATUS_OK);
+			CHECK(out_pkt.len == ref_out_pkt.len);
+			CHECK(memcmp(out_buf, ref_out_buf, out_pkt.len) == 0);
+		}
+		memset(&info, 0, sizeof(rohc_comp_general_info_t));
+		CHECK(rohc_comp_get_general_info(comp, &info) == true);
+		CHECK(info.contexts_nr == 1);
+		CHECK(info.packets_nr == 3);
+
+		rohc_comp_free(ref_comp);
+		rohc_comp_free(comp);
+	}
+
+	/* RFC 3095 profiles without allocation (ROHC_COMP_FEATURE_NO_ALLOC) */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t buf[] =
+		{
+			/* IPv4 */
+			0x45, 0x00, 0x00, 0x30,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x11, 0x93, 0x66,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x05,
+			/* UDP */
+			0x04, 0xd2, 0x04, 0xd2,  0x00, 0x1c, 0x00, 0x00,
+			/* RTP */
+			0x80, 0x00, 0x00, 0x01,  0x00, 0x00, 0x00, 0xa0,
+			0x12, 0x34, 0x56, 0x78,
+			/* payload */
+			0x00, 0x01, 0x02, 0x03,  0x04, 0x05, 0x06, 0x07
+		};
+		/* the RTP flow, one UDP flow, then one UDP flow that finds no
+		 * prepared body left */
+		const uint8_t dst_ports[] = { 0xd2, 0xd3, 0xd4 };
+		const rohc_profile_t profiles[] =
+			{ ROHC_PROFILE_RTP, ROHC_PROFILE_UDP, ROHC_PROFILE_UNCOMPRESSED };
+		rohc_comp_last_packet_info2_t last_info;
+		size_t i;
+		size_t j;
+
+		comp = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, random_cb, NULL);
+		CHECK(comp != NULL);
+		CHECK(rohc_comp_enable_profiles(comp, ROHC_PROFILE_RTP, ROHC_PROFILE_UDP,
+		                                ROHC_PROFILE_IP,
+		                                ROHC_PROFILE_UNCOMPRESSED, -1) == true);
+		CHECK(rohc_comp_add_rtp_ports(comp, 1234, 1234) == true);
+		CHECK(rohc_comp_set_rtp_min_sequential(comp, 1) == true);
+		CHECK(rohc_comp_set_ctxts_prealloc(comp, 1) == true);
+		CHECK(rohc_comp_set_features(comp, ROHC_COMP_FEATURE_NO_ALLOC) == true);
+
+		for(i = 0; i < (sizeof(dst_ports) / sizeof(uint8_t)); i++)
+		{
+			buf[23] = dst_ports[i];
+			for(j = 0; j < 3; j++)
+			{
+				const struct rohc_buf pkt = rohc_buf_init_full(buf, sizeof(buf), ts);
+				uint8_t out_buf[100];
+				struct rohc_buf out_pkt = rohc_buf_init_empty(out_buf, 100);
+
+				buf[31] = j + 1; /* RTP SN */
+				buf[35] = 0xa0 + j * 0xa0; /* RTP TS */
+
+				CHECK(rohc_compress4(comp, pkt, &out_pkt) == ROHC_STATUS_OK);
+				memset(&last_info, 0, sizeof(rohc_comp_last_packet_info2_t));
+				CHECK(rohc_comp_get_last_packet_info2(comp, &last_info) == true);
+				CHECK(last_info.profile_id == (int) profiles[i]);
+			}
+		}
+
+		rohc_comp_free(comp);
+	}
+
+	/* rohc_comp_group_new() */
+	CHECK(rohc_comp_group_new(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, 0,
+	                          random_cb, NULL) == NULL);
+	CHECK(rohc_comp_group_new(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX,
+	                          ROHC_SMALL_CID_MAX + 2, random_cb, NULL) == NULL);
+	CHECK(rohc_comp_group_new(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX + 1, 4,
+	                          random_cb, NULL) == NULL);
+	CHECK(rohc_comp_group_new(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, 4,
+	                          NULL, NULL) == NULL);
+	{
+		struct rohc_comp_group *group =
+			rohc_comp_group_new(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, 4,
+			                    random_cb, NULL);
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t buf[] =
+		{
+			0x45, 0x00, 0x00, 0x1c,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x01, 0x93, 0x52,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x05,  0x08, 0x00, 0xe9, 0xc2,
+			0x9b, 0x42, 0x00, 0x01
+		};
+		struct rohc_buf pkt = rohc_buf_init_full(buf, sizeof(buf), ts);
+		uint8_t fb_buf[] = { 0xf4, 0x20, 0x01, 0x11, 0x39, 0xf2, 0xef, 0x20 };
+		struct rohc_buf fb = rohc_buf_init_full(fb_buf, sizeof(fb_buf), ts);
+		size_t shard_idx;
+
+		CHECK(group != NULL);
+
+		/* rohc_comp_group_get_shard() */
+		CHECK(rohc_comp_group_get_shard(NULL, 0) == NULL);
+		CHECK(rohc_comp_group_get_shard(group, 4) == NULL);
+		CHECK(rohc_comp_group_get_shard(group, 3) != NULL);
+
+		/* rohc_comp_group_steer() */
+		CHECK(rohc_comp_group_steer(NULL, pkt, &shard_idx) == false);
+		CHECK(rohc_comp_group_steer(group, pkt, NULL) == false);
+		pkt.len = 0;
+		CHECK(rohc_comp_group_steer(group, pkt, &shard_idx) == false);
+		pkt.len = sizeof(buf);
+		CHECK(rohc_comp_group_steer(group, pkt, &shard_idx) == true);
+		CHECK(shard_idx < 4);
+
+		/* rohc_comp_group_deliver_feedback() */
+		CHECK(rohc_comp_group_deliver_feedback(NULL, fb) == false);
+		fb.len = 4;
+		CHECK(rohc_comp_group_deliver_feedback(group, fb) == false);
+		fb.len = sizeof(fb_buf);
+		CHECK(rohc_comp_group_deliver_feedback(group, fb) == true);
+
+		/* rohc_comp_group_free() */
+		rohc_comp_group_free(NULL);
+		rohc_comp_group_free(group);
+	}
+
+	/* rohc_comp_config_new() */
+	CHECK(rohc_comp_config_new(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX + 1) == NULL);
+	CHECK(rohc_comp_config_new(ROHC_LARGE_CID, ROHC_LARGE_CID_MAX + 1) == NULL);
+	CHECK(rohc_comp_config_new(ROHC_SMALL_CID + 1, ROHC_SMALL_CID_MAX) == NULL);
+	{
+		struct rohc_comp_config *config =
+			rohc_comp_config_new(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX);
+		struct rohc_comp *comp1;
+		struct rohc_comp *comp2;
+		size_t mrru;
+
+		CHECK(config != NULL);
+
+		/* rohc_comp_config_enable_profile() */
+		CHECK(rohc_comp_config_enable_profile(NULL, ROHC_PROFILE_IP) == false);
+		CHECK(rohc_comp_config_enable_profile(config, ROHC_PROFILE_GENERAL) == false);
+		CHECK(rohc_comp_config_enable_profile(config, ROHC_PROFILE_IP) == true);
+
+		/* rohc_comp_config_set_wlsb_window_width() */
+		CHECK(rohc_comp_config_set_wlsb_window_width(NULL, 16) == false);
+		CHECK(rohc_comp_config_set_wlsb_window_width(config, 0) == false);
+		CHECK(rohc_comp_config_set_wlsb_window_width(config, 5) == false);
+		CHECK(rohc_comp_config_set_wlsb_window_width(config, 16) == true);
+
+		/* rohc_comp_config_set_ctxts_prealloc() */
+		CHECK(rohc_comp_config_set_ctxts_prealloc(NULL, 1) == false);
+		CHECK(rohc_comp_config_set_ctxts_prealloc(config, 4) == true);
+
+		/* rohc_comp_config_set_numa_node() */
+		CHECK(rohc_comp_config_set_numa_node(NULL, 0) == false);
+		CHECK(rohc_comp_config_set_numa_node(config, ROHC_NUMA_NO_NODE - 1) == false);
+		CHECK(rohc_comp_config_set_numa_node(config, 0) == true);
+
+		/* rohc_comp_config_set_periodic_refreshes() */
+		CHECK(rohc_comp_config_set_periodic_refreshes(NULL, 10, 5) == false);
+		CHECK(rohc_comp_config_set_periodic_refreshes(config, 5, 10) == false);
+		CHECK(rohc_comp_config_set_periodic_refreshes(config, 10, 5) == true);
+
+		/* rohc_comp_config_set_mrru() */
+		CHECK(rohc_comp_config_set_mrru(NULL, 100) == false);
+		CHECK(rohc_comp_config_set_mrru(config, 65535 + 1) == false);
+		CHECK(rohc_comp_config_set_mrru(config, 100) == true);
+
+		/* rohc_comp_config_set_rtp_detection_cb() */
+		CHECK(rohc_comp_config_set_rtp_detection_cb(NULL, NULL, NULL) == false);
+		CHECK(rohc_comp_config_set_rtp_detection_cb(config, NULL, NULL) == true);
+
+		/* rohc_comp_new_from_config() */
+		CHECK(rohc_comp_new_from_config(NULL, random_cb, NULL) == NULL);
+		CHECK(rohc_comp_new_from_config(config, NULL, NULL) == NULL);
+		comp1 = rohc_comp_new_from_config(config, random_cb, NULL);
+		CHECK(comp1 != NULL);
+		comp2 = rohc_comp_new_from_config(config, random_cb, NULL);
+		CHECK(comp2 != NULL);
+		CHECK(rohc_comp_profile_enabled(comp2, ROHC_PROFILE_IP) == true);
+		CHECK(rohc_comp_profile_enabled(comp2, ROHC_PROFILE_UDP) == false);
+		CHECK(rohc_comp_get_mrru(comp2, &mrru) == true);
+		CHECK(mrru == 100);
+
+		/* the configuration is frozen once in use */
+		CHECK(rohc_comp_config_enable_profile(config, ROHC_PROFILE_UDP) == false);
+		CHECK(rohc_comp_config_set_mrru(config, 0) == false);
+
+		/* rohc_comp_config_free(), the compressors keep the configuration */
+		rohc_comp_config_free(NULL);
+		rohc_comp_config_free(config);
+		rohc_comp_free(comp1);
+		CHECK(rohc_comp_profile_enabled(comp2, ROHC_PROFILE_IP) == true);
+		rohc_comp_free(comp2);
+	}
+
+	/* rohc_comp_ctxt_export() / rohc_comp_ctxt_import() */
+	{
+		struct rohc_comp *comp1 =
+			rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, random_cb, NULL);
+		struct rohc_comp *comp2 =
+			rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, random_cb, NULL);
+		struct rohc_comp *comp3 =
+			rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, random_cb, NULL);
+		struct rohc_comp_ctxt_export *export;
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t buf[] =
+		{
+			0x45, 0x00, 0x00, 0x54,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x01, 0x93, 0x52,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x05,  0x08, 0x00, 0xe9, 0xc2,
+			0x9b, 0x42, 0x00, 0x01,  0x66, 0x15, 0xa6, 0x45,
+			0x77, 0x9b, 0x04, 0x00,  0x08, 0x09, 0x0a, 0x0b,
+			0x0c, 0x0d, 0x0e, 0x0f,  0x10, 0x11, 0x12, 0x13,
+			0x14, 0x15, 0x16, 0x17,  0x18, 0x19, 0x1a, 0x1b,
+			0x1c, 0x1d, 0x1e, 0x1f,  0x20, 0x21, 0x22, 0x23,
+			0x24, 0x25, 0x26, 0x27,  0x28, 0x29, 0x2a, 0x2b,
+			0x2c, 0x2d, 0x2e, 0x2f,  0x30, 0x31, 0x32, 0x33,
+			0x34, 0x35, 0x36, 0x37
+		};
+		struct rohc_buf pkt = rohc_buf_init_full(buf, sizeof(buf), ts);
+		uint8_t rohc_data[200];
+		struct rohc_buf rohc_pkt = rohc_buf_init_empty(rohc_data, 200);
+		rohc_comp_last_packet_info2_t info;
+		size_t i;
+
+		CHECK(comp1 != NULL);
+		CHECK(comp2 != NULL);
+		CHECK(comp3 != NULL);
+		CHECK(rohc_comp_enable_profile(comp1, ROHC_PROFILE_IP) == true);
+		CHECK(rohc_comp_enable_profile(comp2, ROHC_PROFILE_IP) == true);
+
+		/* establish the context on the first compressor */
+		for(i = 0; i < 5; i++)
+		{
+			rohc_pkt.len = 0;
+			CHECK(rohc_compress4(comp1, pkt, &rohc_pkt) == ROHC_STATUS_OK);
+		}
+
+		CHECK(rohc_comp_ctxt_export(NULL, 0) == NULL);
+		CHECK(rohc_comp_ctxt_export(comp1, 1) == NULL);
+		export = rohc_comp_ctxt_export(comp1, 0);
+		CHECK(export != NULL);
+		CHECK(rohc_comp_ctxt_export(comp1, 0) == NULL);
+
+		/* profile not enabled */
+		CHECK(rohc_comp_ctxt_import(NULL, export) == false);
+		CHECK(rohc_comp_ctxt_import(comp2, NULL) == false);
+		CHECK(rohc_comp_ctxt_import(comp3, export) == false);
+
+		/* the second compressor goes on without IR */
+		CHECK(rohc_comp_ctxt_import(comp2, export) == true);
+		rohc_pkt.len = 0;
+		CHECK(rohc_compress4(comp2, pkt, &rohc_pkt) == ROHC_STATUS_OK);
+		memset(&info, 0, sizeof(rohc_comp_last_packet_info2_t));
+		info.version_major = 0;
+		info.version_minor = 0;
+		CHECK(rohc_comp_get_last_packet_info2(comp2, &info) == true);
+		CHECK(info.context_id == 0);
+		CHECK(info.packet_type != ROHC_PACKET_IR);
+		CHECK(info.context_state != ROHC_COMP_STATE_IR);
+
+		/* the first compressor creates a new context */
+		export = rohc_comp_ctxt_export(comp2, 0);
+		CHECK(export != NULL);
+		rohc_comp_ctxt_export_free(NULL);
+		rohc_comp_ctxt_export_free(export);
+
+		rohc_comp_free(comp1);
+		rohc_comp_free(comp2);
+		rohc_comp_free(comp3);
+	}
+
+	/* rohc_comp_snapshot() / rohc_comp_restore() */
+	{
+		struct rohc_comp *comp1 =
+			rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, random_cb, NULL);
+		struct rohc_comp *comp2 =
+			rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, random_cb, NULL);
+		struct rohc_comp *comp3 =
+			rohc_comp_new2(ROHC_LARGE_CID, ROHC_SMALL_CID_MAX, random_cb, NULL);
+		struct rohc_comp *comp4 =
+			rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, random_cb, NULL);
+		struct snapshot_buf snapshot;
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t buf[] =
+		{
+			0x45, 0x00, 0x00, 0x54,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x01, 0x93, 0x52,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x05,  0x08, 0x00, 0xe9, 0xc2,
+			0x9b, 0x42, 0x00, 0x01,  0x66, 0x15, 0xa6, 0x45,
+			0x77, 0x9b, 0x04, 0x00,  0x08, 0x09, 0x0a, 0x0b,
+			0x0c, 0x0d, 0x0e, 0x0f,  0x10, 0x11, 0x12, 0x13,
+			0x14, 0x15, 0x16, 0x17,  0x18, 0x19, 0x1a, 0x1b,
+			0x1c, 0x1d, 0x1e, 0x1f,  0x20, 0x21, 0x22, 0x23,
+			0x24, 0x25, 0x26, 0x27,  0x28, 0x29, 0x2a, 0x2b,
+			0x2c, 0x2d, 0x2e, 0x2f,  0x30, 0x31, 0x32, 0x33,
+			0x34, 0x35, 0x36, 0x37
+		};
+		struct rohc_buf pkt = rohc_buf_init_full(buf, sizeof(buf), ts);
+		uint8_t rohc_data[200];
+		struct rohc_buf rohc_pkt = rohc_buf_init_empty(rohc_data, 200);
+		rohc_comp_last_packet_info2_t info;
+		size_t i;
+
+		CHECK(comp1 != NULL);
+		CHECK(comp2 != NULL);
+		CHECK(comp3 != NULL);
+		CHECK(comp4 != NULL);
+		CHECK(rohc_comp_enable_profile(comp1, ROHC_PROFILE_UNCOMPRESSED) == true);
+		CHECK(rohc_comp_enable_profile(comp2, ROHC_PROFILE_UNCOMPRESSED) == true);
+		CHECK(rohc_comp_enable_profile(comp3, ROHC_PROFILE_UNCOMPRESSED) == true);
+		CHECK(rohc_comp_enable_profile(comp4, ROHC_PROFILE_UNCOMPRESSED) == true);
+
+		/* establish the context on the first compressor */
+		for(i = 0; i < 5; i++)
+		{
+			rohc_pkt.len = 0;
+			CHECK(rohc_compress4(comp1, pkt, &rohc_pkt) == ROHC_STATUS_OK);
+		}
+
+		memset(&snapshot, 0, sizeof(struct snapshot_buf));
+		CHECK(rohc_comp_snapshot(NULL, snapshot_write_cb, &snapshot) == false);
+		CHECK(rohc_comp_snapshot(comp1, NULL, &snapshot) == false);
+		CHECK(rohc_comp_snapshot(comp1, snapshot_write_cb, &snapshot) == true);
+
+		CHECK(rohc_comp_restore(NULL, snapshot_read_cb, &snapshot) == false);
+		CHECK(rohc_comp_restore(comp2, NULL, &snapshot) == false);
+
+		/* other type of CID */
+		snapshot.pos = 0;
+		CHECK(rohc_comp_restore(comp3, snapshot_read_cb, &snapshot) == false);
+
+		/* truncated snapshot */
+		snapshot.pos = 0;
+		snapshot.len--;
+		CHECK(rohc_comp_restore(comp4, snapshot_read_cb, &snapshot) == false);
+		snapshot.len++;
+
+		/* the second compressor goes on without IR */
+		snapshot.pos = 0;
+		CHECK(rohc_comp_restore(comp2, snapshot_read_cb, &snapshot) == true);
+		CHECK(snapshot.pos == snapshot.len);
+		rohc_pkt.len = 0;
+		CHECK(rohc_compress4(comp2, pkt, &rohc_pkt) == ROHC_STATUS_OK);
+		memset(&info, 0, sizeof(rohc_comp_last_packet_info2_t));
+		info.version_major = 0;
+		info.version_minor = 0;
+		CHECK(rohc_comp_get_last_packet_info2(comp2, &info) == true);
+		CHECK(info.context_id == 0);
+		CHECK(info.packet_type != ROHC_PACKET_IR);
+
+		rohc_comp_free(comp1);
+		rohc_comp_free(comp2);
+		rohc_comp_free(comp3);
+		rohc_comp_free(comp4);
+	}
+
+	/* rohc_comp_snapshot() / rohc_comp_restore() with an RFC 3095 profile */
+	{
+		struct rohc_comp *comp1 =
+			rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, random_cb, NULL);
+		struct rohc_comp *comp2 =
+			rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, random_cb, NULL);
+		struct snapshot_buf snapshot;
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		/* IPv4/UDP/RTP with 2 CSRC identifiers */
+		uint8_t buf[] =
+		{
+			0x45, 0x00, 0x00, 0x34,  0x00, 0x00, 0x00, 0x00,
+			0x40, 0x11, 0xd3, 0x62,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x05,  0x04, 0xd2, 0x16, 0x2e,
+			0x00, 0x20, 0x00, 0x00,  0x82, 0x08, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00,  0x12, 0x34, 0x56, 0x78,
+			0x00, 0x00, 0x00, 0x01,  0x00, 0x00, 0x00, 0x02,
+			0x01, 0x02, 0x03, 0x04
+		};
+		struct rohc_buf pkt = rohc_buf_init_full(buf, sizeof(buf), ts);
+		uint8_t rohc_data1[200];
+		struct rohc_buf rohc_pkt1 = rohc_buf_init_empty(rohc_data1, 200);
+		uint8_t rohc_data2[200];
+		struct rohc_buf rohc_pkt2 = rohc_buf_init_empty(rohc_data2, 200);
+		rohc_comp_last_packet_info2_t info;
+		size_t i;
+
+		CHECK(comp1 != NULL);
+		CHECK(comp2 != NULL);
+		CHECK(rohc_comp_enable_profile(comp1, ROHC_PROFILE_RTP) == true);
+		CHECK(rohc_comp_enable_profile(comp2, ROHC_PROFILE_RTP) == true);
+		CHECK(rohc_comp_set_rtp_detection_cb(comp1, rtp_detect_cb, NULL) == true);
+		CHECK(rohc_comp_set_rtp_detection_cb(comp2, rtp_detect_cb, NULL) == true);
+
+		/* establish the context on the first compressor, then save it and
+		 * restore it on the second compressor */
+		for(i = 0; i < 20; i++)
+		{
+			if(i == 10)
+			{
+				memset(&snapshot, 0, sizeof(struct snapshot_buf));
+				CHECK(rohc_comp_snapshot(comp1, snapshot_write_cb, &snapshot) == true);
+				CHECK(rohc_comp_restore(comp2, snapshot_read_cb, &snapshot) == true);
+				CHECK(snapshot.pos == snapshot.len);
+			}
+
+			/* IP-ID, RTP SN and RTP TS increase regularly */
+			buf[5] = i;
+			buf[10] = (0xd362 - i) >> 8;
+			buf[11] = (0xd362 - i) & 0xff;
+			buf[31] = i;
+			buf[34] = (i * 160) >> 8;
+			buf[35] = (i * 160) & 0xff;
+
+			rohc_pkt1.len = 0;
+			CHECK(rohc_compress4(comp1, pkt, &rohc_pkt1) == ROHC_STATUS_OK);
+			if(i < 10)
+			{
+				continue;
+			}
+
+			/* the second compressor goes on exactly like the first one */
+			rohc_pkt2.len = 0;
+			CHECK(rohc_compress4(comp2, pkt, &rohc_pkt2) == ROHC_STATUS_OK);
+			CHECK(rohc_pkt2.len == rohc_pkt1.len);
+			CHECK(memcmp(rohc_buf_data(rohc_pkt2), rohc_buf_data(rohc_pkt1),
+			             rohc_pkt1.len) == 0);
+			memset(&info, 0, sizeof(rohc_comp_last_packet_info2_t));
+			info.version_major = 0;
+			info.version_minor = 0;
+			CHECK(rohc_comp_get_last_packet_info2(comp2, &info) == true);
+			CHECK(info.profile_id == ROHC_PROFILE_RTP);
+			CHECK(info.packet_type != ROHC_PACKET_IR);
+			CHECK(info.packet_type != ROHC_PACKET_IR_DYN);
+		}
+
+		rohc_comp_free(comp1);
+		rohc_comp_free(comp2);
+	}
+
+	/* rohc_alloc_set_allocator() */
+	{
+		struct alloc_counters counters = { .allocs_nr = 0, .frees_nr = 0 };
+
+		CHECK(rohc_alloc_set_allocator(test_malloc, NULL, test_free,
+		                               &counters) == true);
+		comp = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX,
+		                      random_cb, NULL);
+		CHECK(comp != NULL);
+		CHECK(rohc_comp_enable_profile(comp, ROHC_PROFILE_TCP) == true);
+		CHECK(counters.allocs_nr > 0);
+		rohc_comp_free(comp);
+		CHECK(counters.frees_nr == counters.allocs_nr);
+		CHECK(rohc_alloc_set_allocator(NULL, NULL, NULL, NULL) == true);
+	}
+
 	/* test succeeds */
 	trace(verbose, "all tests are successful\n");
 	is_failure = 0;
@@ -401,3 +1505,104 @@ static int random_cb(const struct rohc_comp *const comp __attribute__((unused)),
 	return 0; /* fake */
 }
 
+
+
+/**
+ * @brief Fake RTP detection callback: every UDP packet is an RTP packet
+ *
+ * @param ip            The innermost IP packet
+ * @param udp           The UDP header of the packet
+ * @param payload       The UDP payload of the packet
+ * @param payload_size  The size of the UDP payload (in bytes)
+ * @param rtp_private   Private data
+ * @return              Always true
+ */
+static bool rtp_detect_cb(const unsigned char *const ip __attribute__((unused)),
+                          const unsigned char *const udp __attribute__((unused)),
+                          const unsigned char *const payload __attribute__((unused)),
+                          const unsigned int payload_size __attribute__((unused)),
+                          void *const rtp_private __attribute__((unused)))
+{
+	return true;
+}
+
+
+/**
+ * @brief Write the given bytes at the end of the in-memory snapshot
+ *
+ * @param priv  The in-memory snapshot
+ * @param data  The bytes to write
+ * @param len   The number of bytes to write
+ * @return      true if the bytes were written, false if there is no room
+ */
+static bool snapshot_write_cb(void *const priv,
+                              const uint8_t *const data,
+                              const size_t len)
+{
+	struct snapshot_buf *const snapshot = priv;
+
+	if((snapshot->len + len) > sizeof(snapshot->data))
+	{
+		return false;
+	}
+	memcpy(snapshot->data + snapshot->len, data, len);
+	snapshot->len += len;
+
+	return true;
+}
+
+
+/**
+ * @brief Read the next bytes of the in-memory snapshot
+ *
+ * @param priv  The in-memory snapshot
+ * @param data  OUT: The bytes read
+ * @param len   The number of bytes to read
+ * @return      true if the bytes were read, false if the snapshot is too short
+ */
+static bool snapshot_read_cb(void *const priv,
+                             uint8_t *const data,
+                             const size_t len)
+{
+	struct snapshot_buf *const snapshot = priv;
+
+	if((snapshot->pos + len) > snapshot->len)
+	{
+		return false;
+	}
+	memcpy(data, snapshot->data + snapshot->pos, len);
+	snapshot->pos += len;
+
+	return true;
+}
+
+
+/**
+ * @brief Allocate memory and count the allocation
+ *
+ * @param size    The number of bytes to allocate
+ * @param opaque  The counters of the allocator
+ * @return        The allocated memory, NULL in case of failure
+ */
+static void * test_malloc(const size_t size, void *const opaque)
+{
+	struct alloc_counters *const counters = opaque;
+
+	counters->allocs_nr++;
+	return malloc(size);
+}
+
+
+/**
+ * @brief Release memory and count the release
+ *
+ * @param ptr     The memory to release
+ * @param opaque  The counters of the allocator
+ */
+static void test_free(void *const ptr, void *const opaque)
+{
+	struct alloc_counters *const counters = opaque;
+
+	counters->frees_nr++;
+	free(ptr);
+}
@@ -0,0 +1,285 @@
+/*
+ * Copyright 2026 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file    test_tcp_opts_list.c
+ * @brief   Test the detection of changes in the list of TCP options
+ * @author  Didier Barvaux <didier@barvaux.org>
+ *
+ * A TCP flow with MSS, NOP and TS options is compressed twice: once with the
+ * fast path that skips the parsing of the TCP options when only the TS values
+ * changed, once with that fast path disabled. The MSS value changes during
+ * the flow. Both runs shall transmit the list of TCP options in the very same
+ * packets.
+ */
+
+#include "c_tcp_opts_list.h"
+#include "rohc_comp_internals.h"
+#include "rohc_utils.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdarg.h>
+#include <string.h>
+#include <assert.h>
+
+
+/** Print trace on stdout only in verbose mode */
+#define trace(is_verbose, format, ...) \
+	do { \
+		if(is_verbose) { \
+			printf(format, ##__VA_ARGS__); \
+		} \
+	} while(0)
+
+/** Improved assert() */
+#define CHECK(condition) \
+	do { \
+		trace(verbose, "test '%s'\n", #condition); \
+		fflush(stdout); \
+		assert(condition); \
+	} while(0)
+
+/** The number of packets in the TCP flow */
+#define PKTS_NR  16U
+
+/** The packet of the TCP flow where the MSS value changes */
+#define PKT_MSS_CHANGE  4U
+
+/** The number of times the list shall be transmitted */
+#define LIST_TRANS_NR  3U
+
+/** The length of the TCP options: MSS, NOP, NOP, TS */
+#define OPTS_LEN  (TCP_OLEN_MSS + 2U + TCP_OLEN_TS)
+
+/** The results of the compression of one TCP flow */
+struct flow_results
+{
+	bool list_sent[PKTS_NR];       /**< Whether the list was required */
+	bool static_changed[PKTS_NR];  /**< Whether a static option changed */
+	bool opts_recorded;            /**< Whether the options were recorded */
+};
+
+static void run_flow(const bool verbose,
+                     const bool fast_path,
+                     const size_t list_trans_until,
+                     struct flow_results *const results);
+
+static void print_trace(void *const priv_ctxt,
+                        const rohc_trace_level_t level,
+                        const rohc_trace_entity_t entity,
+                        const int profile,
+                        const char *const format,
+                        ...)
+	__attribute__((format(printf, 5, 6)));
+
+
+/**
+ * @brief Test the detection of changes in the list of TCP options
+ *
+ * @param argc  The number of command line arguments
+ * @param argv  The command line arguments
+ * @return      0 if test succeeds, non-zero if test fails
+ */
+int main(int argc, char *argv[])
+{
+	struct flow_results fast;
+	struct flow_results slow;
+	bool verbose; /* whether to run in verbose mode or not */
+	size_t lists_nr;
+	size_t i;
+
+	/* do we run in verbose mode ? */
+	if(argc == 1)
+	{
+		/* no argument, run in silent mode */
+		verbose = false;
+	}
+	else if(argc == 2 && strcmp(argv[1], "verbose") == 0)
+	{
+		/* run in verbose mode */
+		verbose = true;
+	}
+	else
+	{
+		/* invalid usage */
+		printf("test the detection of changes in the list of TCP options\n");
+		printf("usage: %s [verbose]\n", argv[0]);
+		goto error;
+	}
+
+	/* the list is transmitted every time it is required: after the MSS
+	 * change, the list is sent once for the change, then repeated until it
+	 * was transmitted LIST_TRANS_NR times */
+	run_flow(verbose, true, PKTS_NR, &fast);
+	run_flow(verbose, false, PKTS_NR, &slow);
+	CHECK(fast.opts_recorded);
+	CHECK(!slow.opts_recorded);
+	for(i = 0; i < PKTS_NR; i++)
+	{
+		CHECK(fast.list_sent[i] == slow.list_sent[i]);
+		CHECK(fast.static_changed[i] == slow.static_changed[i]);
+	}
+	CHECK(fast.static_changed[PKT_MSS_CHANGE]);
+	for(i = PKT_MSS_CHANGE, lists_nr = 0; i < PKTS_NR; i++)
+	{
+		if(fast.list_sent[i])
+		{
+			lists_nr++;
+		}
+	}
+	CHECK(lists_nr == 1 + LIST_TRANS_NR);
+
+	/* the list is never transmitted after the MSS change, so the change is
+	 * detected again in every packet */
+	run_flow(verbose, true, PKT_MSS_CHANGE, &fast);
+	run_flow(verbose, false, PKT_MSS_CHANGE, &slow);
+	for(i = 0; i < PKTS_NR; i++)
+	{
+		CHECK(fast.list_sent[i] == slow.list_sent[i]);
+		CHECK(fast.static_changed[i] == slow.static_changed[i]);
+	}
+	for(i = PKT_MSS_CHANGE; i < PKTS_NR; i++)
+	{
+		CHECK(fast.list_sent[i]);
+		CHECK(fast.static_changed[i]);
+	}
+
+	trace(verbose, "all tests are successful\n");
+	return 0;
+
+error:
+	return 1;
+}
+
+
+/**
+ * @brief Compress the TCP options of one TCP flow
+ *
+ * @param verbose           Whether to print traces or not
+ * @param fast_path         Whether the fast path is allowed or not
+ * @param list_trans_until  The packet from which the list is not
+ *                          transmitted anymore even if required
+ * @param[out] results      The results of the compression of the flow
+ */
+static void run_flow(const bool verbose,
+                     const bool fast_path,
+                     const size_t list_trans_until,
+                     struct flow_results *const results)
+{
+	struct rohc_comp *const comp = calloc(1, sizeof(struct rohc_comp));
+	struct c_tcp_opts_ctxt *const opts_ctxt =
+		calloc(1, sizeof(struct c_tcp_opts_ctxt));
+	const struct rohc_comp_profile profile = { .id = ROHC_PROFILE_TCP };
+	struct rohc_comp_ctxt context = { .profile = &profile };
+	size_t i;
+
+	CHECK(comp != NULL);
+	CHECK(opts_ctxt != NULL);
+	comp->list_trans_nr = LIST_TRANS_NR;
+	comp->trace_level = ROHC_TRACE_DEBUG;
+	comp->trace_callback = (verbose ? print_trace : NULL);
+	context.compressor = comp;
+
+	opts_ctxt->ts_req_wlsb = c_create_wlsb(32, 4, ROHC_LSB_SHIFT_VAR);
+	CHECK(opts_ctxt->ts_req_wlsb != NULL);
+	opts_ctxt->ts_reply_wlsb = c_create_wlsb(32, 4, ROHC_LSB_SHIFT_VAR);
+	CHECK(opts_ctxt->ts_reply_wlsb != NULL);
+
+	memset(results, 0, sizeof(struct flow_results));
+
+	for(i = 0; i < PKTS_NR; i++)
+	{
+		uint8_t pkt[sizeof(struct tcphdr) + OPTS_LEN] = { 0 };
+		struct tcphdr *const tcp = (struct tcphdr *) pkt;
+		uint8_t *const opts = pkt + sizeof(struct tcphdr);
+		const uint16_t mss = (i < PKT_MSS_CHANGE ? 1460 : 1400);
+		const uint32_t ts_req = rohc_hton32(1000 + i);
+		const uint32_t ts_reply = rohc_hton32(500 + i);
+		uint8_t comp_opts[64];
+		size_t opts_len;
+
+		trace(verbose, "packet #%zu with MSS %u\n", i + 1, mss);
+
+		tcp->data_offset = sizeof(pkt) >> 2;
+		opts[0] = TCP_OPT_MSS;
+		opts[1] = TCP_OLEN_MSS;
+		opts[2] = (mss >> 8) & 0xff;
+		opts[3] = mss & 0xff;
+		opts[4] = TCP_OPT_NOP;
+		opts[5] = TCP_OPT_NOP;
+		opts[6] = TCP_OPT_TS;
+		opts[7] = TCP_OLEN_TS;
+		memcpy(opts + 8, &ts_req, sizeof(uint32_t));
+		memcpy(opts + 12, &ts_reply, sizeof(uint32_t));
+
+		if(!fast_path)
+		{
+			opts_ctxt->last_opts_len = 0;
+		}
+		else if(opts_ctxt->last_opts_len > 0)
+		{
+			results->opts_recorded = true;
+		}
+
+		CHECK(tcp_detect_options_changes(&context, tcp, opts_ctxt, &opts_len));
+		CHECK(opts_len == OPTS_LEN);
+
+		results->static_changed[i] = opts_ctxt->tmp.do_list_static_changed;
+		results->list_sent[i] = (opts_ctxt->tmp.do_list_struct_changed ||
+		                         opts_ctxt->tmp.do_list_static_changed);
+
+		/* transmit the list in the compressed base header if required */
+		if(results->list_sent[i] && i < list_trans_until)
+		{
+			CHECK(c_tcp_code_tcp_opts_list_item(&context, tcp, i, false, opts_ctxt,
+			                                    comp_opts, sizeof(comp_opts)) > 0);
+		}
+	}
+
+	c_destroy_wlsb(opts_ctxt->ts_reply_wlsb);
+	c_destroy_wlsb(opts_ctxt->ts_req_wlsb);
+	free(opts_ctxt);
+	free(comp);
+}
+
+
+/**
+ * @brief Print the traces of the library on stdout
+ *
+ * @param priv_ctxt  An optional private context, may be NULL
+ * @param level      The priority level of the trace
+ * @param entity     The entity that emitted the trace
+ * @param profile    The ID of the ROHC compression/decompression profile
+ *                   the trace is related to
+ * @param format     The format string of the trace
+ */
+static void print_trace(void *const priv_ctxt __attribute__((unused)),
+                        const rohc_trace_level_t level __attribute__((unused)),
+                        const rohc_trace_entity_t entity __attribute__((unused)),
+                        const int profile __attribute__((unused)),
+                        const char *const format,
+                        ...)
+{
+	va_list args;
+
+	va_start(args, format);
+	vprintf(format, args);
+	va_end(args);
+}
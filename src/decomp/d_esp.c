@@ -70,6 +70,20 @@ static void d_esp_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
                           const struct rohc_decomp_volat_ctxt *const volat_ctxt)
 	__attribute__((nonnull(1, 2)));
 
+static void d_esp_get_mem(const struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
+                          struct rohc_ctxt_mem *const mem)
+	__attribute__((nonnull(1, 2)));
+
+static bool d_esp_snapshot(const struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
+                           const rohc_snapshot_write_t write_cb,
+                           void *const priv)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
+static bool d_esp_restore(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
+                          const rohc_snapshot_read_t read_cb,
+                          void *const priv)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
 static int esp_parse_static_esp(const struct rohc_decomp_ctxt *const context,
                                 const uint8_t *packet,
                                 size_t length,
@@ -168,38 +182,15 @@ static bool d_esp_create(const struct rohc_decomp_ctxt *const context,
 	rfc3095_ctxt->compute_crc_dynamic = esp_compute_crc_dynamic;
 	rfc3095_ctxt->update_context = esp_update_context;
 
-	/* create the ESP-specific part of the header changes */
+	/* the ESP-specific part of the header changes is stored in the context */
 	rfc3095_ctxt->outer_ip_changes->next_header_len = sizeof(struct esphdr);
-	rfc3095_ctxt->outer_ip_changes->next_header = malloc(sizeof(struct esphdr));
-	if(rfc3095_ctxt->outer_ip_changes->next_header == NULL)
-	{
-		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
-		           "cannot allocate memory for the ESP-specific part of the "
-		           "outer IP header changes");
-		goto free_lsb_sn;
-	}
-	memset(rfc3095_ctxt->outer_ip_changes->next_header, 0, sizeof(struct esphdr));
-
 	rfc3095_ctxt->inner_ip_changes->next_header_len = sizeof(struct esphdr);
-	rfc3095_ctxt->inner_ip_changes->next_header = malloc(sizeof(struct esphdr));
-	if(rfc3095_ctxt->inner_ip_changes->next_header == NULL)
-	{
-		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
-		           "cannot allocate memory for the ESP-specific part of the "
-		           "inner IP header changes");
-		goto free_outer_ip_changes_next_header;
-	}
-	memset(rfc3095_ctxt->inner_ip_changes->next_header, 0, sizeof(struct esphdr));
 
 	/* set next header to ESP */
 	rfc3095_ctxt->next_header_proto = ROHC_IPPROTO_ESP;
 
 	return true;
 
-free_outer_ip_changes_next_header:
-	zfree(rfc3095_ctxt->outer_ip_changes->next_header);
-free_lsb_sn:
-	rohc_lsb_free(rfc3095_ctxt->sn_lsb_ctxt);
 free_esp_context:
 	zfree(esp_context);
 destroy_context:
@@ -221,12 +212,6 @@ quit:
 static void d_esp_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
                           const struct rohc_decomp_volat_ctxt *const volat_ctxt)
 {
-	/* clean ESP-specific memory */
-	assert(rfc3095_ctxt->outer_ip_changes != NULL);
-	zfree(rfc3095_ctxt->outer_ip_changes->next_header);
-	assert(rfc3095_ctxt->inner_ip_changes != NULL);
-	zfree(rfc3095_ctxt->inner_ip_changes->next_header);
-
 	/* destroy the LSB decoding context for SN */
 	rohc_lsb_free(rfc3095_ctxt->sn_lsb_ctxt);
 
@@ -235,6 +220,62 @@ static void d_esp_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
 }
 
 
+/**
+ * @brief Get the memory used by one ESP context
+ *
+ * @param rfc3095_ctxt  The persistent decompression context for the RFC3095 profiles
+ * @param[out] mem      The memory used by the context
+ */
+static void d_esp_get_mem(const struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
+                          struct rohc_ctxt_mem *const mem)
+{
+	rohc_decomp_rfc3095_get_mem(rfc3095_ctxt, mem);
+
+	/* the ESP-specific part of the context */
+	mem->bytes += sizeof(struct d_esp_context);
+}
+
+
+/**
+ * @brief Save one ESP context in a snapshot
+ *
+ * @param rfc3095_ctxt  The persistent decompression context for the RFC3095 profiles
+ * @param write_cb      The callback used to write the snapshot
+ * @param priv          The private context given to the callback
+ * @return              true if the context was successfully saved,
+ *                      false if the callback failed
+ */
+static bool d_esp_snapshot(const struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
+                           const rohc_snapshot_write_t write_cb,
+                           void *const priv)
+{
+	/* the ESP-specific part of the context holds no pointer */
+	return (rohc_decomp_rfc3095_snapshot(rfc3095_ctxt, write_cb, priv) &&
+	        write_cb(priv, rfc3095_ctxt->specific,
+	                 sizeof(struct d_esp_context)));
+}
+
+
+/**
+ * @brief Restore one ESP context from a snapshot
+ *
+ * @param rfc3095_ctxt  The persistent decompression context for the RFC3095 profiles
+ * @param read_cb       The callback used to read the snapshot
+ * @param priv          The private context given to the callback
+ * @return              true if the context was successfully restored,
+ *                      false if the snapshot does not match or the callback
+ *                      failed
+ */
+static bool d_esp_restore(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
+                          const rohc_snapshot_read_t read_cb,
+                          void *const priv)
+{
+	return (rohc_decomp_rfc3095_restore(rfc3095_ctxt, read_cb, priv) &&
+	        read_cb(priv, rfc3095_ctxt->specific,
+	                sizeof(struct d_esp_context)));
+}
+
+
 /**
  * @brief Parse the ESP static part of the ROHC packet
  *
@@ -441,8 +482,11 @@ const struct rohc_decomp_profile d_esp_profile =
 {
 	.id              = ROHC_PROFILE_ESP, /* profile ID (RFC 3095, §8) */
 	.msn_max_bits    = 32,
+	.extr_bits_size  = sizeof(struct rohc_extr_bits),
+	.decoded_values_size = sizeof(struct rohc_decoded_values),
 	.new_context     = (rohc_decomp_new_context_t) d_esp_create,
 	.free_context    = (rohc_decomp_free_context_t) d_esp_destroy,
+	.get_mem         = (rohc_decomp_get_mem_t) d_esp_get_mem,
 	.detect_pkt_type = ip_detect_packet_type,
 	.parse_pkt       = (rohc_decomp_parse_pkt_t) rfc3095_decomp_parse_pkt,
 	.decode_bits     = (rohc_decomp_decode_bits_t) rfc3095_decomp_decode_bits,
@@ -450,5 +494,7 @@ const struct rohc_decomp_profile d_esp_profile =
 	.update_ctxt     = (rohc_decomp_update_ctxt_t) rfc3095_decomp_update_ctxt,
 	.attempt_repair  = (rohc_decomp_attempt_repair_t) rfc3095_decomp_attempt_repair,
 	.get_sn          = rohc_decomp_rfc3095_get_sn,
+	.snapshot        = (rohc_decomp_snapshot_t) d_esp_snapshot,
+	.restore         = (rohc_decomp_restore_t) d_esp_restore,
 };
 
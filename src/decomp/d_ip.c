@@ -148,37 +148,12 @@ rohc_packet_t ip_detect_packet_type(const struct rohc_decomp_ctxt *const context
 		goto error;
 	}
 
-	if(rohc_decomp_packet_is_uo0(rohc_packet, rohc_length))
+	/* UO-0, UO-1, UOR-2, IR-DYN or IR packet */
+	type = rohc_decomp_packet_get_rfc3095_type(rohc_packet, rohc_length);
+	if(type == ROHC_PACKET_UNKNOWN)
 	{
-		/* UO-0 packet */
-		type = ROHC_PACKET_UO_0;
-	}
-	else if(rohc_decomp_packet_is_uo1(rohc_packet, rohc_length))
-	{
-		/* UO-1 packet */
-		type = ROHC_PACKET_UO_1;
-	}
-	else if(rohc_decomp_packet_is_uor2(rohc_packet, rohc_length))
-	{
-		/* UOR-2 packet */
-		type = ROHC_PACKET_UOR_2;
-	}
-	else if(rohc_decomp_packet_is_irdyn(rohc_packet, rohc_length))
-	{
-		/* IR-DYN packet */
-		type = ROHC_PACKET_IR_DYN;
-	}
-	else if(rohc_decomp_packet_is_ir(rohc_packet, rohc_length))
-	{
-		/* IR packet */
-		type = ROHC_PACKET_IR;
-	}
-	else
-	{
-		/* unknown packet */
 		rohc_decomp_warn(context, "failed to recognize the packet type in byte "
 		                 "0x%02x", rohc_packet[0]);
-		type = ROHC_PACKET_UNKNOWN;
 	}
 
 	return type;
@@ -779,8 +754,11 @@ const struct rohc_decomp_profile d_ip_profile =
 {
 	.id              = ROHC_PROFILE_IP, /* profile ID (see 5 in RFC 3843) */
 	.msn_max_bits    = 16,
+	.extr_bits_size  = sizeof(struct rohc_extr_bits),
+	.decoded_values_size = sizeof(struct rohc_decoded_values),
 	.new_context     = (rohc_decomp_new_context_t) d_ip_create,
 	.free_context    = (rohc_decomp_free_context_t) d_ip_destroy,
+	.get_mem         = (rohc_decomp_get_mem_t) rohc_decomp_rfc3095_get_mem,
 	.detect_pkt_type = ip_detect_packet_type,
 	.parse_pkt       = (rohc_decomp_parse_pkt_t) rfc3095_decomp_parse_pkt,
 	.decode_bits     = (rohc_decomp_decode_bits_t) rfc3095_decomp_decode_bits,
@@ -788,5 +766,7 @@ const struct rohc_decomp_profile d_ip_profile =
 	.update_ctxt     = (rohc_decomp_update_ctxt_t) rfc3095_decomp_update_ctxt,
 	.attempt_repair  = (rohc_decomp_attempt_repair_t) rfc3095_decomp_attempt_repair,
 	.get_sn          = rohc_decomp_rfc3095_get_sn,
+	.snapshot        = (rohc_decomp_snapshot_t) rohc_decomp_rfc3095_snapshot,
+	.restore         = (rohc_decomp_restore_t) rohc_decomp_rfc3095_restore,
 };
 
@@ -36,6 +36,7 @@
 #include "sdvl.h"
 #include "crc.h"
 #include "schemes/decomp_scaled_rtp_ts.h"
+#include "schemes/decomp_list_csrc.h"
 #include "rohc_decomp_detect_packet.h"
 #include "protocols/udp.h"
 #include "protocols/rtp.h"
@@ -62,6 +63,8 @@ struct d_rtp_context
 	rohc_tristate_t udp_check_present;
 	/** The scaled RTP Timestamp decoding context */
 	struct ts_sc_decomp *ts_scaled_ctxt;
+	/** The list decompressor of the CSRC identifiers */
+	struct list_decomp csrc_list;
 };
 
 
@@ -78,6 +81,20 @@ static void d_rtp_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
                           const struct rohc_decomp_volat_ctxt *const volat_ctxt)
 	__attribute__((nonnull(1, 2)));
 
+static void d_rtp_get_mem(const struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
+                          struct rohc_ctxt_mem *const mem)
+	__attribute__((nonnull(1, 2)));
+
+static bool d_rtp_snapshot(const struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
+                           const rohc_snapshot_write_t write_cb,
+                           void *const priv)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
+static bool d_rtp_restore(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
+                          const rohc_snapshot_read_t read_cb,
+                          void *const priv)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
 static rohc_packet_t rtp_detect_packet_type(const struct rohc_decomp_ctxt *const context,
                                             const uint8_t *const rohc_packet,
                                             const size_t rohc_length,
@@ -142,6 +159,21 @@ static void rtp_update_context(struct rohc_decomp_ctxt *const context,
                                const struct rohc_decoded_values *const decoded)
 	__attribute__((nonnull(1, 2)));
 
+static bool rtp_decode_tmpl_rtp(const struct rohc_decomp_ctxt *const context,
+                                const struct rohc_extr_bits *const bits,
+                                struct rohc_decoded_values *const decoded)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+
+static void rtp_patch_tmpl_rtp(const struct rohc_decomp_ctxt *const context,
+                               const struct rohc_decoded_values *const decoded,
+                               uint8_t *const next_hdr,
+                               const size_t payload_len)
+	__attribute__((nonnull(1, 2, 3)));
+
+static void rtp_update_tmpl_rtp(struct rohc_decomp_ctxt *const context,
+                                const struct rohc_decoded_values *const decoded)
+	__attribute__((nonnull(1, 2)));
+
 
 /*
  * Prototypes of private helper functions
@@ -204,6 +236,13 @@ static bool d_rtp_create(const struct rohc_decomp_ctxt *const context,
 	memset(rtp_context, 0, sizeof(struct d_rtp_context));
 	rfc3095_ctxt->specific = rtp_context;
 
+	/* init the context used to decompress the list of CSRC identifiers */
+	rohc_decomp_list_csrc_new(&rtp_context->csrc_list,
+	                          context->decompressor->trace_callback,
+	                          context->decompressor->trace_callback_priv,
+	                          context->decompressor->trace_level,
+	                          context->profile->id);
+
 	/* create the LSB decoding context for SN */
 	rfc3095_ctxt->sn_lsb_p = ROHC_LSB_SHIFT_RTP_SN;
 	rfc3095_ctxt->sn_lsb_ctxt = rohc_lsb_new(16);
@@ -229,29 +268,13 @@ static bool d_rtp_create(const struct rohc_decomp_ctxt *const context,
 	rfc3095_ctxt->compute_crc_static = rtp_compute_crc_static;
 	rfc3095_ctxt->compute_crc_dynamic = rtp_compute_crc_dynamic;
 	rfc3095_ctxt->update_context = rtp_update_context;
+	rfc3095_ctxt->decode_tmpl_next_hdr = rtp_decode_tmpl_rtp;
+	rfc3095_ctxt->patch_tmpl_next_hdr = rtp_patch_tmpl_rtp;
+	rfc3095_ctxt->update_tmpl_next_hdr = rtp_update_tmpl_rtp;
 
-	/* create the UDP-specific part of the header changes */
+	/* the RTP-specific part of the header changes is stored in the context */
 	rfc3095_ctxt->outer_ip_changes->next_header_len = nh_len;
-	rfc3095_ctxt->outer_ip_changes->next_header = malloc(nh_len);
-	if(rfc3095_ctxt->outer_ip_changes->next_header == NULL)
-	{
-		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
-		           "cannot allocate memory for the RTP-specific part of the "
-		           "outer IP header changes");
-		goto free_lsb_sn;
-	}
-	memset(rfc3095_ctxt->outer_ip_changes->next_header, 0, nh_len);
-
 	rfc3095_ctxt->inner_ip_changes->next_header_len = nh_len;
-	rfc3095_ctxt->inner_ip_changes->next_header = malloc(nh_len);
-	if(rfc3095_ctxt->inner_ip_changes->next_header == NULL)
-	{
-		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
-		           "cannot allocate memory for the RTP-specific part of the "
-		           "inner IP header changes");
-		goto free_outer_ip_changes_next_header;
-	}
-	memset(rfc3095_ctxt->inner_ip_changes->next_header, 0, nh_len);
 
 	/* set next header to UDP */
 	rfc3095_ctxt->next_header_proto = ROHC_IPPROTO_UDP;
@@ -259,20 +282,17 @@ static bool d_rtp_create(const struct rohc_decomp_ctxt *const context,
 	/* create the scaled RTP Timestamp decoding context */
 	rtp_context->ts_scaled_ctxt =
 		d_create_sc(context->decompressor->trace_callback,
-		            context->decompressor->trace_callback_priv);
+		            context->decompressor->trace_callback_priv,
+		            context->decompressor->trace_level);
 	if(rtp_context->ts_scaled_ctxt == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
 		           "cannot create the scaled RTP Timestamp decoding context");
-		goto free_inner_ip_changes_next_header;
+		goto free_lsb_sn;
 	}
 
 	return true;
 
-free_inner_ip_changes_next_header:
-	zfree(rfc3095_ctxt->inner_ip_changes->next_header);
-free_outer_ip_changes_next_header:
-	zfree(rfc3095_ctxt->outer_ip_changes->next_header);
 free_lsb_sn:
 	rohc_lsb_free(rfc3095_ctxt->sn_lsb_ctxt);
 free_rtp_context:
@@ -296,17 +316,14 @@ quit:
 static void d_rtp_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
                           const struct rohc_decomp_volat_ctxt *const volat_ctxt)
 {
-	const struct d_rtp_context *const rtp_context =
+	struct d_rtp_context *const rtp_context =
 		(struct d_rtp_context *) rfc3095_ctxt->specific;
 
 	/* destroy the scaled RTP Timestamp decoding object */
 	rohc_ts_scaled_free(rtp_context->ts_scaled_ctxt);
 
-	/* clean UDP-specific memory */
-	assert(rfc3095_ctxt->outer_ip_changes != NULL);
-	zfree(rfc3095_ctxt->outer_ip_changes->next_header);
-	assert(rfc3095_ctxt->inner_ip_changes != NULL);
-	zfree(rfc3095_ctxt->inner_ip_changes->next_header);
+	/* destroy the list decompressor of the CSRC identifiers */
+	rohc_decomp_list_csrc_free(&rtp_context->csrc_list);
 
 	/* destroy the LSB decoding context for SN */
 	rohc_lsb_free(rfc3095_ctxt->sn_lsb_ctxt);
@@ -316,6 +333,81 @@ static void d_rtp_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
 }
 
 
+/**
+ * @brief Get the memory used by one RTP context
+ *
+ * @param rfc3095_ctxt  The persistent decompression context for the RFC3095 profiles
+ * @param[out] mem      The memory used by the context
+ */
+static void d_rtp_get_mem(const struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
+                          struct rohc_ctxt_mem *const mem)
+{
+	rohc_decomp_rfc3095_get_mem(rfc3095_ctxt, mem);
+
+	/* the RTP-specific part of the context */
+	mem->bytes += sizeof(struct d_rtp_context);
+	/* the TS_SCALED decoding context */
+	mem->bytes += rohc_ts_scaled_get_mem_size();
+	mem->wlsb_bytes += 2 * rohc_lsb_get_mem_size();
+	/* the list decompressor of the CSRC identifiers */
+	mem->lists_bytes += sizeof(struct list_decomp);
+}
+
+
+/**
+ * @brief Save one RTP context in a snapshot
+ *
+ * The SSRC and the UDP checksum behaviour are followed by the scaled RTP
+ * Timestamp decoding context and by the list decompressor of the CSRC
+ * identifiers.
+ *
+ * @param rfc3095_ctxt  The persistent decompression context for the RFC3095 profiles
+ * @param write_cb      The callback used to write the snapshot
+ * @param priv          The private context given to the callback
+ * @return              true if the context was successfully saved,
+ *                      false if the callback failed
+ */
+static bool d_rtp_snapshot(const struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
+                           const rohc_snapshot_write_t write_cb,
+                           void *const priv)
+{
+	const struct d_rtp_context *const rtp_context = rfc3095_ctxt->specific;
+
+	return (rohc_decomp_rfc3095_snapshot(rfc3095_ctxt, write_cb, priv) &&
+	        write_cb(priv, (const uint8_t *) rtp_context,
+	                 offsetof(struct d_rtp_context, ts_scaled_ctxt)) &&
+	        d_sc_snapshot(rtp_context->ts_scaled_ctxt, write_cb, priv) &&
+	        rohc_decomp_list_snapshot(&rtp_context->csrc_list, write_cb, priv));
+}
+
+
+/**
+ * @brief Restore one RTP context from a snapshot
+ *
+ * The scaled RTP Timestamp decoding context allocated by \ref d_rtp_create
+ * is kept, only its content is restored.
+ *
+ * @param rfc3095_ctxt  The persistent decompression context for the RFC3095 profiles
+ * @param read_cb       The callback used to read the snapshot
+ * @param priv          The private context given to the callback
+ * @return              true if the context was successfully restored,
+ *                      false if the snapshot does not match or the callback
+ *                      failed
+ */
+static bool d_rtp_restore(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
+                          const rohc_snapshot_read_t read_cb,
+                          void *const priv)
+{
+	struct d_rtp_context *const rtp_context = rfc3095_ctxt->specific;
+
+	return (rohc_decomp_rfc3095_restore(rfc3095_ctxt, read_cb, priv) &&
+	        read_cb(priv, (uint8_t *) rtp_context,
+	                offsetof(struct d_rtp_context, ts_scaled_ctxt)) &&
+	        d_sc_restore(rtp_context->ts_scaled_ctxt, read_cb, priv) &&
+	        rohc_decomp_list_restore(&rtp_context->csrc_list, read_cb, priv));
+}
+
+
 /**
  * @brief Detect the type of ROHC packet for RTP profile
  *
@@ -339,38 +431,22 @@ static rohc_packet_t rtp_detect_packet_type(const struct rohc_decomp_ctxt *const
 		goto error;
 	}
 
-	if(rohc_decomp_packet_is_uo0(rohc_packet, rohc_length))
-	{
-		/* UO-0 packet */
-		type = ROHC_PACKET_UO_0;
-	}
-	else if(rohc_decomp_packet_is_uo1(rohc_packet, rohc_length))
+	type = rohc_decomp_packet_get_rfc3095_type(rohc_packet, rohc_length);
+	if(type == ROHC_PACKET_UO_1)
 	{
 		/* choose between the UO-1-RTP, UO-1-ID, and UO-1-TS variants */
 		type = rtp_choose_uo1_variant(context, rohc_packet, rohc_length);
 	}
-	else if(rohc_decomp_packet_is_uor2(rohc_packet, rohc_length))
+	else if(type == ROHC_PACKET_UOR_2)
 	{
 		/* choose between the UOR-2-RTP, UOR-2-ID, and UOR-2-TS variants */
 		type = rtp_choose_uor2_variant(context, rohc_packet, rohc_length,
 		                               large_cid_len);
 	}
-	else if(rohc_decomp_packet_is_irdyn(rohc_packet, rohc_length))
+	else if(type == ROHC_PACKET_UNKNOWN)
 	{
-		/* IR-DYN packet */
-		type = ROHC_PACKET_IR_DYN;
-	}
-	else if(rohc_decomp_packet_is_ir(rohc_packet, rohc_length))
-	{
-		/* IR packet */
-		type = ROHC_PACKET_IR;
-	}
-	else
-	{
-		/* unknown packet */
 		rohc_decomp_warn(context, "failed to recognize the packet type in byte "
 		                 "0x%02x", rohc_packet[0]);
-		type = ROHC_PACKET_UNKNOWN;
 	}
 
 	return type;
@@ -668,17 +744,18 @@ static int rtp_parse_dynamic_rtp(const struct rohc_decomp_ctxt *const context,
                                  struct rohc_extr_bits *const bits)
 {
 	const struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt = context->persist_ctxt;
-	const struct d_rtp_context *const rtp_context = rfc3095_ctxt->specific;
+	struct d_rtp_context *const rtp_context = rfc3095_ctxt->specific;
 	/* The size (in bytes) of the constant RTP dynamic part:
 	 *
 	 * According to RFC3095 section 5.7.7.6:
 	 *   1 (flags V, P, RX, CC) + 1 (flags M, PT) + 2 (RTP SN) +
 	 *   4 (RTP TS) + 1 (CSRC list) = 9 bytes
 	 *
-	 * The size of the Generic CSRC list field is considered constant because
-	 * generic CSRC list is not supported yet and thus 1 byte of zero is used.
+	 * The Generic CSRC list field is at least 1 byte long, its other bytes
+	 * are checked when the list is decoded.
 	 */
 	const size_t rtp_dyn_size = 9;
+	int csrc_list_len;
 	size_t remain_len = length;
 	int rx;
 
@@ -751,15 +828,17 @@ static int rtp_parse_dynamic_rtp(const struct rohc_decomp_ctxt *const context,
 	remain_len -= sizeof(uint32_t);
 	rohc_decomp_debug(context, "timestamp = 0x%08x", bits->ts);
 
-	/* part 6 is not supported yet, ignore the byte which should be set to 0 */
-	if(GET_BIT_0_7(packet) != 0x00)
+	/* part 6: Generic CSRC list */
+	csrc_list_len = rohc_list_decode_maybe(&rtp_context->csrc_list, packet,
+	                                       remain_len);
+	if(csrc_list_len < 0)
 	{
-		rohc_decomp_warn(context, "generic CSRC list not supported yet, but "
-		                 "first CSRC byte was set to 0x%02x", GET_BIT_0_7(packet));
+		rohc_decomp_warn(context, "failed to decode the list of CSRC identifiers");
 		goto error;
 	}
-	packet++;
-	remain_len--;
+	rohc_decomp_debug(context, "CSRC list = %d bytes", csrc_list_len);
+	packet += csrc_list_len;
+	remain_len -= csrc_list_len;
 
 	/* part 7 */
 	if(rx)
@@ -1688,6 +1767,16 @@ static bool rtp_decode_values_from_bits(const struct rohc_decomp_ctxt *context,
 	}
 	rohc_decomp_debug(context, "decoded CC = %u", decoded->rtp_cc);
 
+	/* the CSRC identifiers follow the RTP header */
+	if(rtp_context->csrc_list.pkt_list.items_nr != decoded->rtp_cc)
+	{
+		rohc_decomp_warn(context, "CC = %u does not match the %zu items of the "
+		                 "list of CSRC identifiers", decoded->rtp_cc,
+		                 rtp_context->csrc_list.pkt_list.items_nr);
+		goto error;
+	}
+	decoded->next_header_len += decoded->rtp_cc * sizeof(uint32_t);
+
 	/* decode RTP Marker (M) flag */
 	if(bits->rtp_m_nr > 0)
 	{
@@ -1808,18 +1897,21 @@ error:
  * @param context      The decompression context
  * @param decoded      The values decoded from the ROHC header
  * @param dest         The buffer to store the UDP/RTP header (MUST be at least
- *                     of sizeof(struct udphdr) + sizeof(struct rtphdr) length)
+ *                     of decoded->next_header_len length)
  * @param payload_len  The length of the UDP/RTP payload
- * @return             The length of the next header (ie. the UDP/RTP header),
- *                     -1 in case of error
+ * @return             The length of the next header (ie. the UDP/RTP header
+ *                     and its CSRC identifiers), -1 in case of error
  */
 static int rtp_build_uncomp_rtp(const struct rohc_decomp_ctxt *const context,
                                 const struct rohc_decoded_values *const decoded,
                                 uint8_t *const dest,
                                 const unsigned int payload_len)
 {
+	const struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt = context->persist_ctxt;
+	const struct d_rtp_context *const rtp_context = rfc3095_ctxt->specific;
 	struct udphdr *udp;
 	struct rtphdr *rtp;
+	size_t csrc_len;
 
 	assert(context != NULL);
 	assert(dest != NULL);
@@ -1834,8 +1926,7 @@ static int rtp_build_uncomp_rtp(const struct rohc_decomp_ctxt *const context,
 	udp->check = decoded->udp_check;
 
 	/* UDP interfered fields */
-	udp->len = rohc_hton16(payload_len + sizeof(struct udphdr) +
-	                       sizeof(struct rtphdr));
+	udp->len = rohc_hton16(payload_len + decoded->next_header_len);
 	rohc_decomp_debug(context, "UDP + RTP length = 0x%04x", rohc_ntoh16(udp->len));
 
 	/* RTP fields: version, R-P flag, R-X flag, M flag, R-PT, TS and SN */
@@ -1850,7 +1941,12 @@ static int rtp_build_uncomp_rtp(const struct rohc_decomp_ctxt *const context,
 	rtp->timestamp = rohc_hton32(decoded->ts);
 	rtp->ssrc = decoded->rtp_ssrc;
 
-	return sizeof(struct udphdr) + sizeof(struct rtphdr);
+	/* CSRC identifiers */
+	csrc_len = rtp_context->csrc_list.build_uncomp_item(&rtp_context->csrc_list,
+	                                                    0, (uint8_t *) (rtp + 1));
+	assert(csrc_len == decoded->rtp_cc * sizeof(uint32_t));
+
+	return sizeof(struct udphdr) + sizeof(struct rtphdr) + csrc_len;
 }
 
 
@@ -1897,6 +1993,126 @@ static void rtp_update_context(struct rohc_decomp_ctxt *const context,
 }
 
 
+/**
+ * @brief Decode the UDP/RTP fields of one UO* packet for the template of
+ *        headers
+ *
+ * The UDP checksum is transmitted in the UO* remainder if enabled, the TS is
+ * scaled since the packet carries no extension 3, and the M flag is zero if
+ * not transmitted.
+ *
+ * @param context  The decompression context
+ * @param bits     The bits extracted from the UO* packet
+ * @param decoded  OUT: The corresponding decoded values
+ * @return         true if decoding is successful, false otherwise
+ */
+static bool rtp_decode_tmpl_rtp(const struct rohc_decomp_ctxt *const context,
+                                const struct rohc_extr_bits *const bits,
+                                struct rohc_decoded_values *const decoded)
+{
+	const struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt = context->persist_ctxt;
+	const struct d_rtp_context *const rtp_context = rfc3095_ctxt->specific;
+
+	/* the UDP checksum behavior is known, otherwise the UO* remainder could
+	 * not be parsed */
+	if(rtp_context->udp_check_present == ROHC_TRISTATE_YES)
+	{
+		assert(bits->udp_check_nr == 16);
+		decoded->udp_check = bits->udp_check;
+	}
+	else
+	{
+		decoded->udp_check = 0;
+	}
+	rohc_decomp_debug(context, "decoded UDP checksum = 0x%04x",
+	                  rohc_ntoh16(decoded->udp_check));
+
+	/* TS is scaled, deduce it from SN if no TS_SCALED bit was transmitted */
+	assert(bits->is_ts_scaled);
+	if(bits->ts_nr == 0)
+	{
+		assert(decoded->sn <= 0xffff);
+		decoded->ts = ts_deduce_from_sn(rtp_context->ts_scaled_ctxt, decoded->sn);
+	}
+	else if(!ts_decode_scaled_bits(rtp_context->ts_scaled_ctxt, bits->ts,
+	                               bits->ts_nr, &decoded->ts))
+	{
+		rohc_decomp_debug(context, "failed to decode %zd-bit TS_SCALED 0x%x",
+		                  bits->ts_nr, bits->ts);
+		goto error;
+	}
+	rohc_decomp_debug(context, "decoded timestamp = %u / 0x%x (nr bits = %zd, "
+	                  "bits = %u / 0x%x)", decoded->ts, decoded->ts,
+	                  bits->ts_nr, bits->ts, bits->ts);
+
+	/* RFC 3095 §5.7 says that Context(M) is never updated */
+	if(bits->rtp_m_nr > 0)
+	{
+		assert(bits->rtp_m_nr == 1);
+		decoded->rtp_m = bits->rtp_m;
+	}
+	else
+	{
+		decoded->rtp_m = 0;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Patch the UDP/RTP header of the template of headers
+ *
+ * @param context      The decompression context
+ * @param decoded      The values decoded from the UO* packet
+ * @param next_hdr     The UDP/RTP header to patch
+ * @param payload_len  The length of the UDP/RTP payload
+ */
+static void rtp_patch_tmpl_rtp(const struct rohc_decomp_ctxt *const context,
+                               const struct rohc_decoded_values *const decoded,
+                               uint8_t *const next_hdr,
+                               const size_t payload_len)
+{
+	struct udphdr *const udp = (struct udphdr *) next_hdr;
+	struct rtphdr *const rtp = (struct rtphdr *) (udp + 1);
+
+	udp->check = decoded->udp_check;
+	udp->len = rohc_hton16(payload_len + sizeof(struct udphdr) +
+	                       sizeof(struct rtphdr) + rtp->cc * sizeof(uint32_t));
+	rohc_decomp_debug(context, "UDP + RTP length = 0x%04x", rohc_ntoh16(udp->len));
+
+	rtp->m = decoded->rtp_m;
+	assert(decoded->sn <= 0xffff);
+	rtp->sn = rohc_hton16((uint16_t) decoded->sn);
+	rtp->timestamp = rohc_hton32(decoded->ts);
+}
+
+
+/**
+ * @brief Update context with the UDP/RTP values of one UO* packet that
+ *        patched the template of headers
+ *
+ * @param context  The decompression context
+ * @param decoded  The decoded values to update in the context
+ */
+static void rtp_update_tmpl_rtp(struct rohc_decomp_ctxt *const context,
+                                const struct rohc_decoded_values *const decoded)
+{
+	struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt = context->persist_ctxt;
+	struct d_rtp_context *const rtp_context = rfc3095_ctxt->specific;
+	const struct udphdr *const udp =
+		(struct udphdr *) rfc3095_ctxt->outer_ip_changes->next_header;
+	struct rtphdr *const rtp = (struct rtphdr *) (udp + 1);
+
+	assert(decoded->sn <= 0xffff);
+	ts_update_context(rtp_context->ts_scaled_ctxt, decoded->ts, decoded->sn);
+	rtp->m = decoded->rtp_m;
+}
+
+
 /*
  * Private helper functions
  */
@@ -1958,8 +2174,11 @@ const struct rohc_decomp_profile d_rtp_profile =
 {
 	.id              = ROHC_PROFILE_RTP, /* profile ID (see 8 in RFC3095) */
 	.msn_max_bits    = 16,
+	.extr_bits_size  = sizeof(struct rohc_extr_bits),
+	.decoded_values_size = sizeof(struct rohc_decoded_values),
 	.new_context     = (rohc_decomp_new_context_t) d_rtp_create,
 	.free_context    = (rohc_decomp_free_context_t) d_rtp_destroy,
+	.get_mem         = (rohc_decomp_get_mem_t) d_rtp_get_mem,
 	.detect_pkt_type = rtp_detect_packet_type,
 	.parse_pkt       = (rohc_decomp_parse_pkt_t) rfc3095_decomp_parse_pkt,
 	.decode_bits     = (rohc_decomp_decode_bits_t) rfc3095_decomp_decode_bits,
@@ -1967,5 +2186,7 @@ const struct rohc_decomp_profile d_rtp_profile =
 	.update_ctxt     = (rohc_decomp_update_ctxt_t) rfc3095_decomp_update_ctxt,
 	.attempt_repair  = (rohc_decomp_attempt_repair_t) rfc3095_decomp_attempt_repair,
 	.get_sn          = rohc_decomp_rfc3095_get_sn,
+	.snapshot        = (rohc_decomp_snapshot_t) d_rtp_snapshot,
+	.restore         = (rohc_decomp_restore_t) d_rtp_restore,
 };
 
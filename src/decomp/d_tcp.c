@@ -53,6 +53,17 @@
 #  include <string.h>
 #endif
 #include <stdint.h>
+#include <stddef.h> /* for offsetof() */
+
+
+/**
+ * @brief The maximum length of the base header of a CO packet
+ *
+ * The co_common header is the largest one: its fixed part, the sequence and
+ * ACK numbers, the ACK stride, the window, the IP-ID, the URG pointer, the
+ * DSCP and the TTL/HL fields sum up to less than 32 bytes.
+ */
+#define D_TCP_CO_BASE_HDR_MAX_LEN  64U
 
 
 /*
@@ -68,6 +79,24 @@ static void d_tcp_destroy(struct d_tcp_context *const tcp_context,
                           const struct rohc_decomp_volat_ctxt *const volat_ctxt)
 	__attribute__((nonnull(1, 2)));
 
+static void d_tcp_get_mem(const struct d_tcp_context *const tcp_context,
+                          struct rohc_ctxt_mem *const mem)
+	__attribute__((nonnull(1, 2)));
+
+static bool d_tcp_snapshot(const struct d_tcp_context *const tcp_context,
+                           const rohc_snapshot_write_t write_cb,
+                           void *const priv)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static bool d_tcp_restore(struct d_tcp_context *const tcp_context,
+                          const rohc_snapshot_read_t read_cb,
+                          void *const priv)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
+static void d_tcp_reset(const struct rohc_decomp_ctxt *const context,
+                        struct d_tcp_context *const tcp_context,
+                        struct rohc_decomp_volat_ctxt *const volat_ctxt)
+	__attribute__((nonnull(1, 2, 3)));
+
 static rohc_packet_t tcp_detect_packet_type(const struct rohc_decomp_ctxt *const context,
                                             const uint8_t *const rohc_packet,
                                             const size_t rohc_length,
@@ -298,24 +327,28 @@ static void d_tcp_decode_opt_sack(const struct rohc_decomp_ctxt *const context,
 
 static bool d_tcp_build_ipv4_hdr(const struct rohc_decomp_ctxt *const context,
                                  const struct rohc_tcp_decoded_ip_values *const decoded,
+                                 const size_t ip_tot_len,
                                  struct rohc_buf *const uncomp_packet,
                                  size_t *const ip_hdr_len)
-	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4)));
+	__attribute__((warn_unused_result, nonnull(1, 2, 4, 5)));
 static bool d_tcp_build_ipv6_hdr(const struct rohc_decomp_ctxt *const context,
                                  const struct rohc_tcp_decoded_ip_values *const decoded,
+                                 const size_t ip_tot_len,
                                  struct rohc_buf *const uncomp_packet,
                                  size_t *const ip_hdr_len)
-	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4)));
+	__attribute__((warn_unused_result, nonnull(1, 2, 4, 5)));
 static bool d_tcp_build_ip_hdr(const struct rohc_decomp_ctxt *const context,
                                const struct rohc_tcp_decoded_ip_values *const decoded,
+                               const size_t ip_tot_len,
                                struct rohc_buf *const uncomp_packet,
                                size_t *const ip_hdr_len)
-	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4)));
+	__attribute__((warn_unused_result, nonnull(1, 2, 4, 5)));
 static bool d_tcp_build_ip_hdrs(const struct rohc_decomp_ctxt *const context,
                                 const struct rohc_tcp_decoded_values *const decoded,
+                                const size_t pkt_len,
                                 struct rohc_buf *const uncomp_packet,
                                 size_t *const ip_hdrs_len)
-	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4)));
+	__attribute__((warn_unused_result, nonnull(1, 2, 4, 5)));
 static bool d_tcp_build_tcp_hdr(const struct rohc_decomp_ctxt *const context,
                                 const struct rohc_tcp_decoded_values *const decoded,
                                 struct rohc_buf *const uncomp_packet,
@@ -330,12 +363,11 @@ static rohc_status_t d_tcp_build_hdrs(const struct rohc_decomp *const decomp,
                                       struct rohc_buf *const uncomp_hdrs,
                                       size_t *const uncomp_hdrs_len)
 	__attribute__((warn_unused_result, nonnull(1, 2, 4, 5, 7, 8)));
-static bool d_tcp_check_uncomp_crc(const struct rohc_decomp *const decomp,
-                                   const struct rohc_decomp_ctxt *const context,
+static bool d_tcp_check_uncomp_crc(const struct rohc_decomp_ctxt *const context,
                                    struct rohc_buf *const uncomp_hdrs,
                                    const rohc_crc_type_t crc_type,
                                    const uint8_t crc_packet)
-	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+	__attribute__((warn_unused_result, nonnull(1, 2)));
 
 /* CRC repair */
 static bool d_tcp_attempt_repair(const struct rohc_decomp *const decomp,
@@ -371,7 +403,8 @@ static bool d_tcp_create(const struct rohc_decomp_ctxt *const context,
 	struct d_tcp_context *tcp_context;
 
 	/* allocate memory for the context */
-	*persist_ctxt = malloc(sizeof(struct d_tcp_context));
+	*persist_ctxt = rohc_alloc_malloc_node(sizeof(struct d_tcp_context),
+	                                       context->decompressor->numa_node);
 	if((*persist_ctxt) == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -489,27 +522,9 @@ static bool d_tcp_create(const struct rohc_decomp_ctxt *const context,
 	/* volatile part of the decompression context */
 	volat_ctxt->crc.type = ROHC_CRC_TYPE_NONE;
 	volat_ctxt->crc.bits_nr = 0;
-	volat_ctxt->extr_bits = malloc(sizeof(struct rohc_tcp_extr_bits));
-	if(volat_ctxt->extr_bits == NULL)
-	{
-		rohc_decomp_warn(context, "failed to allocate memory for the volatile part "
-		                 "of one of the TCP decompression context");
-		goto free_lsb_ts_opt_rep;
-	}
-	volat_ctxt->decoded_values = malloc(sizeof(struct rohc_tcp_decoded_values));
-	if(volat_ctxt->decoded_values == NULL)
-	{
-		rohc_decomp_warn(context, "failed to allocate memory for the volatile part "
-		                 "of one of the TCP decompression context");
-		goto free_extr_bits;
-	}
 
 	return true;
 
-free_extr_bits:
-	zfree(volat_ctxt->extr_bits);
-free_lsb_ts_opt_rep:
-	rohc_lsb_free(tcp_context->opt_ts_rep_lsb_ctxt);
 free_lsb_ts_opt_req:
 	rohc_lsb_free(tcp_context->opt_ts_req_lsb_ctxt);
 free_lsb_scaled_ack:
@@ -545,7 +560,7 @@ quit:
  * @param volat_ctxt   The volatile decompression context
  */
 static void d_tcp_destroy(struct d_tcp_context *const tcp_context,
-                          const struct rohc_decomp_volat_ctxt *const volat_ctxt)
+                          const struct rohc_decomp_volat_ctxt *const volat_ctxt __attribute__((unused)))
 {
 	/* destroy the LSB decoding context for the TCP option Timestamp echo
 	 * request */
@@ -572,10 +587,302 @@ static void d_tcp_destroy(struct d_tcp_context *const tcp_context,
 
 	/* free the TCP decompression context itself */
 	free(tcp_context);
+}
 
-	/* free the volatile part of the decompression context */
-	free(volat_ctxt->decoded_values);
-	free(volat_ctxt->extr_bits);
+
+/**
+ * @brief Get the memory used by one TCP context
+ *
+ * @param tcp_context  The persistent decompression context for the TCP profile
+ * @param[out] mem     The memory used by the context
+ */
+static void d_tcp_get_mem(const struct d_tcp_context *const tcp_context __attribute__((unused)),
+                          struct rohc_ctxt_mem *const mem)
+{
+	/* the LSB decoding contexts for the MSN, the IP-ID, the TTL/HL, the
+	 * window, the sequence and ACK numbers (scaled or not) and the TS option */
+	mem->wlsb_bytes = 10 * rohc_lsb_get_mem_size();
+
+	/* the decoded TCP options are embedded in the context */
+	mem->lists_bytes = sizeof(struct d_tcp_opts_ctxt);
+
+	mem->bytes = sizeof(struct d_tcp_context) + mem->wlsb_bytes;
+}
+
+
+/**
+ * @brief Reset one released context for re-use.
+ *
+ * The persistent part of the context is reset as if it was just created by
+ * \ref d_tcp_create, but the LSB decoding contexts are kept instead of being
+ * allocated once more.
+ *
+ * @param context      The main decompression context
+ * @param tcp_context  The persistent decompression context for the TCP profile
+ * @param volat_ctxt   The volatile decompression context
+ */
+static void d_tcp_reset(const struct rohc_decomp_ctxt *const context,
+                        struct d_tcp_context *const tcp_context,
+                        struct rohc_decomp_volat_ctxt *const volat_ctxt)
+{
+	struct rohc_lsb_decode *const msn_lsb_ctxt = tcp_context->msn_lsb_ctxt;
+	struct rohc_lsb_decode *const ip_id_lsb_ctxt = tcp_context->ip_id_lsb_ctxt;
+	struct rohc_lsb_decode *const ttl_hl_lsb_ctxt = tcp_context->ttl_hl_lsb_ctxt;
+	struct rohc_lsb_decode *const window_lsb_ctxt = tcp_context->window_lsb_ctxt;
+	struct rohc_lsb_decode *const seq_lsb_ctxt = tcp_context->seq_lsb_ctxt;
+	struct rohc_lsb_decode *const seq_scaled_lsb_ctxt =
+		tcp_context->seq_scaled_lsb_ctxt;
+	struct rohc_lsb_decode *const ack_lsb_ctxt = tcp_context->ack_lsb_ctxt;
+	struct rohc_lsb_decode *const ack_scaled_lsb_ctxt =
+		tcp_context->ack_scaled_lsb_ctxt;
+	struct rohc_lsb_decode *const opt_ts_req_lsb_ctxt =
+		tcp_context->opt_ts_req_lsb_ctxt;
+	struct rohc_lsb_decode *const opt_ts_rep_lsb_ctxt =
+		tcp_context->opt_ts_rep_lsb_ctxt;
+
+	assert(context->profile->id == ROHC_PROFILE_TCP);
+
+	/* forget everything about the previous stream */
+	memset(tcp_context, 0, sizeof(struct d_tcp_context));
+
+	/* re-use the LSB decoding contexts, but forget their references */
+	tcp_context->msn_lsb_ctxt = msn_lsb_ctxt;
+	rohc_lsb_reset(tcp_context->msn_lsb_ctxt);
+	tcp_context->ip_id_lsb_ctxt = ip_id_lsb_ctxt;
+	rohc_lsb_reset(tcp_context->ip_id_lsb_ctxt);
+	tcp_context->ttl_hl_lsb_ctxt = ttl_hl_lsb_ctxt;
+	rohc_lsb_reset(tcp_context->ttl_hl_lsb_ctxt);
+	tcp_context->window_lsb_ctxt = window_lsb_ctxt;
+	rohc_lsb_reset(tcp_context->window_lsb_ctxt);
+	tcp_context->seq_lsb_ctxt = seq_lsb_ctxt;
+	rohc_lsb_reset(tcp_context->seq_lsb_ctxt);
+	tcp_context->seq_scaled_lsb_ctxt = seq_scaled_lsb_ctxt;
+	rohc_lsb_reset(tcp_context->seq_scaled_lsb_ctxt);
+	tcp_context->ack_lsb_ctxt = ack_lsb_ctxt;
+	rohc_lsb_reset(tcp_context->ack_lsb_ctxt);
+	tcp_context->ack_scaled_lsb_ctxt = ack_scaled_lsb_ctxt;
+	rohc_lsb_reset(tcp_context->ack_scaled_lsb_ctxt);
+	tcp_context->opt_ts_req_lsb_ctxt = opt_ts_req_lsb_ctxt;
+	rohc_lsb_reset(tcp_context->opt_ts_req_lsb_ctxt);
+	tcp_context->opt_ts_rep_lsb_ctxt = opt_ts_rep_lsb_ctxt;
+	rohc_lsb_reset(tcp_context->opt_ts_rep_lsb_ctxt);
+
+	/* the TCP source and destination ports will be initialized
+	 * with the IR packets */
+	tcp_context->tcp_src_port = 0xFFFF;
+	tcp_context->tcp_dst_port = 0xFFFF;
+
+	/* volatile part of the decompression context */
+	volat_ctxt->crc.type = ROHC_CRC_TYPE_NONE;
+	volat_ctxt->crc.bits_nr = 0;
+}
+
+
+/**
+ * @brief Save the persistent part of one TCP decompression context
+ *
+ * The sizes of the saved structures are written first, so that the
+ * restoration detects a snapshot written by another build of the library.
+ * Only the TCP options and the IP headers in use are saved, the record thus
+ * stays small enough to be written after every packet (see
+ * \ref rohc_decomp_set_journal_cb).
+ *
+ * @param tcp_context  The persistent decompression context for the TCP profile
+ * @param write_cb     The callback used to write the snapshot
+ * @param priv         The private context given to the callback
+ * @return             true if the context was successfully saved,
+ *                     false if the callback failed
+ */
+static bool d_tcp_snapshot(const struct d_tcp_context *const tcp_context,
+                           const rohc_snapshot_write_t write_cb,
+                           void *const priv)
+{
+	const struct rohc_lsb_decode *const lsb_ctxts[] = {
+		tcp_context->msn_lsb_ctxt, tcp_context->ip_id_lsb_ctxt,
+		tcp_context->ttl_hl_lsb_ctxt, tcp_context->seq_lsb_ctxt,
+		tcp_context->seq_scaled_lsb_ctxt, tcp_context->ack_lsb_ctxt,
+		tcp_context->ack_scaled_lsb_ctxt, tcp_context->window_lsb_ctxt,
+		tcp_context->opt_ts_req_lsb_ctxt, tcp_context->opt_ts_rep_lsb_ctxt,
+	};
+	const size_t lsb_ctxts_nr = sizeof(lsb_ctxts) / sizeof(lsb_ctxts[0]);
+	const uint32_t lens[3] = {
+		sizeof(struct d_tcp_context), rohc_lsb_get_mem_size(),
+		sizeof(ip_context_t)
+	};
+	uint32_t opts_used = 0;
+	size_t i;
+
+	/* the fields before the TCP options, then the list of TCP options and
+	 * the mask of the TCP options known by the context */
+	for(i = 0; i <= MAX_TCP_OPTION_INDEX; i++)
+	{
+		if(tcp_context->tcp_opts.bits[i].used)
+		{
+			opts_used |= (1U << i);
+		}
+	}
+	if(!write_cb(priv, (const uint8_t *) lens, sizeof(lens)) ||
+	   !write_cb(priv, (const uint8_t *) tcp_context,
+	             offsetof(struct d_tcp_context, tcp_opts)) ||
+	   !write_cb(priv, (const uint8_t *) &tcp_context->tcp_opts,
+	             offsetof(struct d_tcp_opts_ctxt, bits)) ||
+	   !write_cb(priv, (const uint8_t *) &opts_used, sizeof(uint32_t)))
+	{
+		return false;
+	}
+	for(i = 0; i <= MAX_TCP_OPTION_INDEX; i++)
+	{
+		if((opts_used & (1U << i)) != 0 &&
+		   !write_cb(priv, (const uint8_t *) &tcp_context->tcp_opts.bits[i],
+		             sizeof(struct d_tcp_opt_ctxt)))
+		{
+			return false;
+		}
+	}
+
+	/* the LSB decoding contexts hold no pointer */
+	for(i = 0; i < lsb_ctxts_nr; i++)
+	{
+		if(!write_cb(priv, (const uint8_t *) lsb_ctxts[i], lens[1]))
+		{
+			return false;
+		}
+	}
+
+	/* the SACK blocks, then the IP headers and their extension headers */
+	if(!write_cb(priv, (const uint8_t *) &tcp_context->opt_sack_blocks,
+	             sizeof(struct d_tcp_opt_sack)) ||
+	   !write_cb(priv, (const uint8_t *) &tcp_context->ip_contexts_nr,
+	             sizeof(size_t)))
+	{
+		return false;
+	}
+	for(i = 0; i < tcp_context->ip_contexts_nr; i++)
+	{
+		const ip_context_t *const ip_context = &tcp_context->ip_contexts[i];
+
+		if(!write_cb(priv, (const uint8_t *) ip_context,
+		             offsetof(ip_context_t, opts)) ||
+		   !write_cb(priv, (const uint8_t *) ip_context->opts,
+		             ip_context->opts_nr * sizeof(ip_option_context_t)))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+/**
+ * @brief Restore the persistent part of one TCP decompression context
+ *
+ * The LSB decoding contexts allocated by \ref d_tcp_create are kept, only
+ * their content is restored. The whole context is overwritten, so that the
+ * record may be applied on a context that already tracks the stream.
+ *
+ * @param tcp_context  The persistent decompression context for the TCP profile
+ * @param read_cb      The callback used to read the snapshot
+ * @param priv         The private context given to the callback
+ * @return             true if the context was successfully restored,
+ *                     false if the snapshot does not match or the callback
+ *                     failed
+ */
+static bool d_tcp_restore(struct d_tcp_context *const tcp_context,
+                          const rohc_snapshot_read_t read_cb,
+                          void *const priv)
+{
+	struct rohc_lsb_decode *const lsb_ctxts[] = {
+		tcp_context->msn_lsb_ctxt, tcp_context->ip_id_lsb_ctxt,
+		tcp_context->ttl_hl_lsb_ctxt, tcp_context->seq_lsb_ctxt,
+		tcp_context->seq_scaled_lsb_ctxt, tcp_context->ack_lsb_ctxt,
+		tcp_context->ack_scaled_lsb_ctxt, tcp_context->window_lsb_ctxt,
+		tcp_context->opt_ts_req_lsb_ctxt, tcp_context->opt_ts_rep_lsb_ctxt,
+	};
+	const size_t lsb_ctxts_nr = sizeof(lsb_ctxts) / sizeof(lsb_ctxts[0]);
+	uint32_t opts_used;
+	uint32_t lens[3];
+	size_t i;
+
+	if(!read_cb(priv, (uint8_t *) lens, sizeof(lens)) ||
+	   lens[0] != sizeof(struct d_tcp_context) ||
+	   lens[1] != rohc_lsb_get_mem_size() ||
+	   lens[2] != sizeof(ip_context_t))
+	{
+		goto error;
+	}
+
+	/* forget everything about the previous stream, the saved pointers are
+	 * meaningless: re-use the LSB decoding contexts */
+	memset(tcp_context, 0, sizeof(struct d_tcp_context));
+	if(!read_cb(priv, (uint8_t *) tcp_context,
+	            offsetof(struct d_tcp_context, tcp_opts)))
+	{
+		goto error;
+	}
+	tcp_context->msn_lsb_ctxt = lsb_ctxts[0];
+	tcp_context->ip_id_lsb_ctxt = lsb_ctxts[1];
+	tcp_context->ttl_hl_lsb_ctxt = lsb_ctxts[2];
+	tcp_context->seq_lsb_ctxt = lsb_ctxts[3];
+	tcp_context->seq_scaled_lsb_ctxt = lsb_ctxts[4];
+	tcp_context->ack_lsb_ctxt = lsb_ctxts[5];
+	tcp_context->ack_scaled_lsb_ctxt = lsb_ctxts[6];
+	tcp_context->window_lsb_ctxt = lsb_ctxts[7];
+	tcp_context->opt_ts_req_lsb_ctxt = lsb_ctxts[8];
+	tcp_context->opt_ts_rep_lsb_ctxt = lsb_ctxts[9];
+
+	/* the list of TCP options and the TCP options known by the context */
+	if(!read_cb(priv, (uint8_t *) &tcp_context->tcp_opts,
+	            offsetof(struct d_tcp_opts_ctxt, bits)) ||
+	   tcp_context->tcp_opts.nr > ROHC_TCP_OPTS_MAX ||
+	   !read_cb(priv, (uint8_t *) &opts_used, sizeof(uint32_t)))
+	{
+		goto error;
+	}
+	for(i = 0; i <= MAX_TCP_OPTION_INDEX; i++)
+	{
+		if((opts_used & (1U << i)) != 0 &&
+		   !read_cb(priv, (uint8_t *) &tcp_context->tcp_opts.bits[i],
+		            sizeof(struct d_tcp_opt_ctxt)))
+		{
+			goto error;
+		}
+	}
+
+	for(i = 0; i < lsb_ctxts_nr; i++)
+	{
+		if(!read_cb(priv, (uint8_t *) lsb_ctxts[i], lens[1]))
+		{
+			goto error;
+		}
+	}
+
+	/* the SACK blocks, then the IP headers and their extension headers */
+	if(!read_cb(priv, (uint8_t *) &tcp_context->opt_sack_blocks,
+	            sizeof(struct d_tcp_opt_sack)) ||
+	   !read_cb(priv, (uint8_t *) &tcp_context->ip_contexts_nr,
+	            sizeof(size_t)) ||
+	   tcp_context->ip_contexts_nr > ROHC_TCP_MAX_IP_HDRS)
+	{
+		goto error;
+	}
+	for(i = 0; i < tcp_context->ip_contexts_nr; i++)
+	{
+		ip_context_t *const ip_context = &tcp_context->ip_contexts[i];
+
+		if(!read_cb(priv, (uint8_t *) ip_context, offsetof(ip_context_t, opts)) ||
+		   ip_context->opts_nr > ROHC_TCP_MAX_IP_EXT_HDRS ||
+		   !read_cb(priv, (uint8_t *) ip_context->opts,
+		            ip_context->opts_nr * sizeof(ip_option_context_t)))
+		{
+			goto error;
+		}
+	}
+
+	return true;
+
+error:
+	return false;
 }
 
 
@@ -847,6 +1154,10 @@ static bool d_tcp_parse_ir(const struct rohc_decomp_ctxt *const context,
 	remain_data += static_chain_len;
 	remain_len -= static_chain_len;
 
+	/* the CRC of the IR header up to there may be re-used for the next IR
+	 * packets of the context */
+	extr_crc->static_len = remain_data - rohc_packet;
+
 	/* parse dynamic chain */
 	if(!tcp_parse_dyn_chain(context, remain_data, remain_len, bits, &dyn_chain_len))
 	{
@@ -981,8 +1292,6 @@ error:
  * @param[out] rohc_hdr_len  The length of the ROHC header (in bytes)
  * @return                   true if parsing was successful,
  *                           false if packet was malformed
- *
- * @todo TODO: avoid malloc/free of packed_rohc_packet
  */
 static bool d_tcp_parse_CO(const struct rohc_decomp_ctxt *const context,
                            const uint8_t *const rohc_packet,
@@ -993,11 +1302,14 @@ static bool d_tcp_parse_CO(const struct rohc_decomp_ctxt *const context,
                            struct rohc_tcp_extr_bits *const bits,
                            size_t *const rohc_hdr_len)
 {
-	const size_t packed_rohc_packet_max_len = 0xffff + 100;
-	uint8_t *packed_rohc_packet = malloc(packed_rohc_packet_max_len); // TODO: change that
 	const struct d_tcp_context *const tcp_context = context->persist_ctxt;
 	int ret;
 
+	/* the base header, made contiguous if a large CID follows its 1st byte */
+	uint8_t packed_base_hdr[D_TCP_CO_BASE_HDR_MAX_LEN];
+	const uint8_t *base_hdr;
+	size_t base_hdr_max_len;
+
 	/* remaining ROHC data not parsed yet */
 	const uint8_t *rohc_remain_data;
 	size_t rohc_remain_len;
@@ -1021,9 +1333,6 @@ static bool d_tcp_parse_CO(const struct rohc_decomp_ctxt *const context,
 	assert(large_cid_len <= 2);
 	assert(packet_type != ROHC_PACKET_UNKNOWN);
 
-#ifndef __clang_analyzer__ /* silent warning about value never read */
-	rohc_remain_data = (uint8_t *) rohc_packet;
-#endif
 	rohc_remain_len = rohc_length;
 
 	rohc_decomp_debug(context, "large_cid_len = %zu, rohc_length = %zu",
@@ -1042,18 +1351,24 @@ static bool d_tcp_parse_CO(const struct rohc_decomp_ctxt *const context,
 		goto error;
 	}
 
-	/* copy the first byte of header over the last byte of the large CID field
-	 * to be able to map packet strutures to the ROHC bytes */
-	if((rohc_remain_len - large_cid_len) > packed_rohc_packet_max_len)
+	/* packet structures are mapped onto the bytes of the base header: if a
+	 * large CID field is present, copy the first byte of header and the next
+	 * bytes of the base header in a small buffer, the rest of the packet is
+	 * parsed in place */
+	if(large_cid_len == 0)
 	{
-		rohc_decomp_warn(context, "internal problem: internal buffer too small");
-		goto error;
+		base_hdr = rohc_packet;
+		base_hdr_max_len = rohc_remain_len;
+	}
+	else
+	{
+		base_hdr_max_len =
+			rohc_min(rohc_remain_len - large_cid_len, D_TCP_CO_BASE_HDR_MAX_LEN);
+		packed_base_hdr[0] = rohc_packet[0];
+		memcpy(packed_base_hdr + 1, rohc_packet + 1 + large_cid_len,
+		       base_hdr_max_len - 1);
+		base_hdr = packed_base_hdr;
 	}
-	packed_rohc_packet[0] = rohc_packet[0];
-	memcpy(packed_rohc_packet + 1, rohc_packet + 1 + large_cid_len,
-	       rohc_remain_len - 1 - large_cid_len);
-	rohc_remain_data = packed_rohc_packet;
-	rohc_remain_len -= large_cid_len;
 	*rohc_hdr_len = 0;
 
 	/* parse the packet type we detected earlier */
@@ -1118,19 +1433,19 @@ static bool d_tcp_parse_CO(const struct rohc_decomp_ctxt *const context,
 	}
 	{
 		size_t co_pkt_len;
-		if(!parse_co_pkt(context, rohc_remain_data, rohc_remain_len,
+		if(!parse_co_pkt(context, base_hdr, base_hdr_max_len,
 		                 extr_crc, bits, &co_pkt_len, &has_opts_list))
 		{
 			rohc_decomp_warn(context, "failed to parse %s packet (type %d)",
 			                 rohc_get_packet_descr(packet_type), packet_type);
 			goto error;
 		}
-		rohc_remain_data += co_pkt_len;
-		rohc_remain_len -= co_pkt_len;
+		assert(co_pkt_len <= base_hdr_max_len);
+		rohc_remain_data = rohc_packet + large_cid_len + co_pkt_len;
+		rohc_remain_len -= large_cid_len + co_pkt_len;
 		(*rohc_hdr_len) += co_pkt_len;
 	}
-	rohc_decomp_dump_buf(context, "ROHC base header", packed_rohc_packet,
-	                     *rohc_hdr_len);
+	rohc_decomp_dump_buf(context, "ROHC base header", base_hdr, *rohc_hdr_len);
 
 	/* innermost IP-ID behavior */
 	if(inner_ip_bits->id_behavior_nr > 0)
@@ -1205,11 +1520,9 @@ static bool d_tcp_parse_CO(const struct rohc_decomp_ctxt *const context,
 	*rohc_hdr_len += large_cid_len;
 	assert((*rohc_hdr_len) <= rohc_length);
 
-	free(packed_rohc_packet);
 	return true;
 
 error:
-	free(packed_rohc_packet);
 	return false;
 }
 
@@ -1236,32 +1549,32 @@ static bool d_tcp_parse_rnd_1(const struct rohc_decomp_ctxt *const context,
                               size_t *const rohc_hdr_len,
                               bool *const has_opts_list)
 {
-	const rnd_1_t *const rnd_1 = (rnd_1_t *) rohc_packet;
+	struct rnd_1 rnd_1;
 
 	/* check packet usage */
 	assert(context->state == ROHC_DECOMP_STATE_FC);
 
 	/* check if the ROHC packet is large enough to parse rnd_1 */
-	if(rohc_length < sizeof(rnd_1_t))
+	if(rohc_length < rnd_1_len)
 	{
 		rohc_decomp_warn(context, "ROHC packet too small for rnd_1 (len = %zu)",
 		                 rohc_length);
 		goto error;
 	}
 
-	assert(rnd_1->discriminator == 0x2e); /* '101110' */
-	bits->seq.bits = (rnd_1->seq_num1 << 16) | rohc_ntoh16(rnd_1->seq_num2);
+	rnd_1_read(rohc_packet, &rnd_1);
+	bits->seq.bits = rnd_1.seq_num;
 	bits->seq.bits_nr = 18;
 	bits->seq.p = 65535;
-	bits->msn.bits = rnd_1->msn;
+	bits->msn.bits = rnd_1.msn;
 	bits->msn.bits_nr = 4;
-	bits->psh_flag_bits = rnd_1->psh_flag;
+	bits->psh_flag_bits = rnd_1.psh_flag;
 	bits->psh_flag_bits_nr = 1;
 	extr_crc->type = ROHC_CRC_TYPE_3;
-	extr_crc->bits = rnd_1->header_crc;
+	extr_crc->bits = rnd_1.header_crc;
 	extr_crc->bits_nr = 3;
 
-	*rohc_hdr_len = sizeof(rnd_1_t);
+	*rohc_hdr_len = rnd_1_len;
 	*has_opts_list = false;
 
 	return true;
@@ -1293,31 +1606,31 @@ static bool d_tcp_parse_rnd_2(const struct rohc_decomp_ctxt *const context,
                               size_t *const rohc_hdr_len,
                               bool *const has_opts_list)
 {
-	const rnd_2_t *const rnd_2 = (rnd_2_t *) rohc_packet;
+	struct rnd_2 rnd_2;
 
 	/* check packet usage */
 	assert(context->state == ROHC_DECOMP_STATE_FC);
 
 	/* check if the ROHC packet is large enough to parse rnd_2 */
-	if(rohc_length < sizeof(rnd_2_t))
+	if(rohc_length < rnd_2_len)
 	{
 		rohc_decomp_warn(context, "ROHC packet too small for rnd_2 (len = %zu)",
 		                 rohc_length);
 		goto error;
 	}
 
-	assert(rnd_2->discriminator == 0x0c); /* '1100' */
-	bits->seq_scaled.bits = rnd_2->seq_num_scaled;
+	rnd_2_read(rohc_packet, &rnd_2);
+	bits->seq_scaled.bits = rnd_2.seq_num_scaled;
 	bits->seq_scaled.bits_nr = 4;
-	bits->msn.bits = rnd_2->msn;
+	bits->msn.bits = rnd_2.msn;
 	bits->msn.bits_nr = 4;
-	bits->psh_flag_bits = rnd_2->psh_flag;
+	bits->psh_flag_bits = rnd_2.psh_flag;
 	bits->psh_flag_bits_nr = 1;
 	extr_crc->type = ROHC_CRC_TYPE_3;
-	extr_crc->bits = rnd_2->header_crc;
+	extr_crc->bits = rnd_2.header_crc;
 	extr_crc->bits_nr = 3;
 
-	*rohc_hdr_len = sizeof(rnd_2_t);
+	*rohc_hdr_len = rnd_2_len;
 	*has_opts_list = false;
 
 	return true;
@@ -1349,32 +1662,32 @@ static bool d_tcp_parse_rnd_3(const struct rohc_decomp_ctxt *const context,
                               size_t *const rohc_hdr_len,
                               bool *const has_opts_list)
 {
-	const rnd_3_t *const rnd_3 = (rnd_3_t *) rohc_packet;
+	struct rnd_3 rnd_3;
 
 	/* check packet usage */
 	assert(context->state == ROHC_DECOMP_STATE_FC);
 
 	/* check if the ROHC packet is large enough to parse rnd_3 */
-	if(rohc_length < sizeof(rnd_3_t))
+	if(rohc_length < rnd_3_len)
 	{
 		rohc_decomp_warn(context, "ROHC packet too small for rnd_3 (len = %zu)",
 		                 rohc_length);
 		goto error;
 	}
 
-	assert(rnd_3->discriminator == 0x00); /* '0' */
-	bits->ack.bits = (rnd_3->ack_num1 << 8) | rnd_3->ack_num2;
+	rnd_3_read(rohc_packet, &rnd_3);
+	bits->ack.bits = rnd_3.ack_num;
 	bits->ack.bits_nr = 15;
 	bits->ack.p = 8191;
-	bits->msn.bits = rnd_3->msn;
+	bits->msn.bits = rnd_3.msn;
 	bits->msn.bits_nr = 4;
-	bits->psh_flag_bits = rnd_3->psh_flag;
+	bits->psh_flag_bits = rnd_3.psh_flag;
 	bits->psh_flag_bits_nr = 1;
 	extr_crc->type = ROHC_CRC_TYPE_3;
-	extr_crc->bits = rnd_3->header_crc;
+	extr_crc->bits = rnd_3.header_crc;
 	extr_crc->bits_nr = 3;
 
-	*rohc_hdr_len = sizeof(rnd_3_t);
+	*rohc_hdr_len = rnd_3_len;
 	*has_opts_list = false;
 
 	return true;
@@ -1407,7 +1720,7 @@ static bool d_tcp_parse_rnd_4(const struct rohc_decomp_ctxt *const context,
                               bool *const has_opts_list)
 {
 	const struct d_tcp_context *const tcp_context = context->persist_ctxt;
-	const rnd_4_t *const rnd_4 = (rnd_4_t *) rohc_packet;
+	struct rnd_4 rnd_4;
 
 	/* check packet usage */
 	assert(context->state == ROHC_DECOMP_STATE_FC);
@@ -1422,25 +1735,25 @@ static bool d_tcp_parse_rnd_4(const struct rohc_decomp_ctxt *const context,
 	}
 
 	/* check if the ROHC packet is large enough to parse rnd_4 */
-	if(rohc_length < sizeof(rnd_4_t))
+	if(rohc_length < rnd_4_len)
 	{
 		rohc_decomp_warn(context, "ROHC packet too small for rnd_4 (len = %zu)",
 		                 rohc_length);
 		goto error;
 	}
 
-	assert(rnd_4->discriminator == 0x0d); /* '1101' */
-	bits->ack_scaled.bits = rnd_4->ack_num_scaled;
+	rnd_4_read(rohc_packet, &rnd_4);
+	bits->ack_scaled.bits = rnd_4.ack_num_scaled;
 	bits->ack_scaled.bits_nr = 4;
-	bits->msn.bits = rnd_4->msn;
+	bits->msn.bits = rnd_4.msn;
 	bits->msn.bits_nr = 4;
-	bits->psh_flag_bits = rnd_4->psh_flag;
+	bits->psh_flag_bits = rnd_4.psh_flag;
 	bits->psh_flag_bits_nr = 1;
 	extr_crc->type = ROHC_CRC_TYPE_3;
-	extr_crc->bits = rnd_4->header_crc;
+	extr_crc->bits = rnd_4.header_crc;
 	extr_crc->bits_nr = 3;
 
-	*rohc_hdr_len = sizeof(rnd_4_t);
+	*rohc_hdr_len = rnd_4_len;
 	*has_opts_list = false;
 
 	return true;
@@ -1472,36 +1785,35 @@ static bool d_tcp_parse_rnd_5(const struct rohc_decomp_ctxt *const context,
                               size_t *const rohc_hdr_len,
                               bool *const has_opts_list)
 {
-	const rnd_5_t *const rnd_5 = (rnd_5_t *) rohc_packet;
+	struct rnd_5 rnd_5;
 
 	/* check packet usage */
 	assert(context->state == ROHC_DECOMP_STATE_FC);
 
 	/* check if the ROHC packet is large enough to parse rnd_5 */
-	if(rohc_length < sizeof(rnd_5_t))
+	if(rohc_length < rnd_5_len)
 	{
 		rohc_decomp_warn(context, "ROHC packet too small for rnd_5 (len = %zu)",
 		                 rohc_length);
 		goto error;
 	}
 
-	assert(rnd_5->discriminator == 0x04); /* '100' */
-	bits->psh_flag_bits = rnd_5->psh_flag;
+	rnd_5_read(rohc_packet, &rnd_5);
+	bits->psh_flag_bits = rnd_5.psh_flag;
 	bits->psh_flag_bits_nr = 1;
-	bits->msn.bits = rnd_5->msn;
+	bits->msn.bits = rnd_5.msn;
 	bits->msn.bits_nr = 4;
 	extr_crc->type = ROHC_CRC_TYPE_3;
-	extr_crc->bits = rnd_5->header_crc;
+	extr_crc->bits = rnd_5.header_crc;
 	extr_crc->bits_nr = 3;
-	bits->seq.bits =
-		(rnd_5->seq_num1 << 9) | (rnd_5->seq_num2 << 1) | rnd_5->seq_num3;
+	bits->seq.bits = rnd_5.seq_num;
 	bits->seq.bits_nr = 14;
 	bits->seq.p = 8191;
-	bits->ack.bits = (rnd_5->ack_num1 << 8) | rnd_5->ack_num2;
+	bits->ack.bits = rnd_5.ack_num;
 	bits->ack.bits_nr = 15;
 	bits->ack.p = 8191;
 
-	*rohc_hdr_len = sizeof(rnd_5_t);
+	*rohc_hdr_len = rnd_5_len;
 	*has_opts_list = false;
 
 	return true;
@@ -1533,34 +1845,34 @@ static bool d_tcp_parse_rnd_6(const struct rohc_decomp_ctxt *const context,
                               size_t *const rohc_hdr_len,
                               bool *const has_opts_list)
 {
-	const rnd_6_t *const rnd_6 = (rnd_6_t *) rohc_packet;
+	struct rnd_6 rnd_6;
 
 	/* check packet usage */
 	assert(context->state == ROHC_DECOMP_STATE_FC);
 
 	/* check if the ROHC packet is large enough to parse rnd_6 */
-	if(rohc_length < sizeof(rnd_6_t))
+	if(rohc_length < rnd_6_len)
 	{
 		rohc_decomp_warn(context, "ROHC packet too small for rnd_6 (len = %zu)",
 		                 rohc_length);
 		goto error;
 	}
 
-	assert(rnd_6->discriminator == 0x0a); /* '1010' */
+	rnd_6_read(rohc_packet, &rnd_6);
 	extr_crc->type = ROHC_CRC_TYPE_3;
-	extr_crc->bits = rnd_6->header_crc;
+	extr_crc->bits = rnd_6.header_crc;
 	extr_crc->bits_nr = 3;
-	bits->psh_flag_bits = rnd_6->psh_flag;
+	bits->psh_flag_bits = rnd_6.psh_flag;
 	bits->psh_flag_bits_nr = 1;
-	bits->ack.bits = rohc_ntoh16(rnd_6->ack_num);
+	bits->ack.bits = rnd_6.ack_num;
 	bits->ack.bits_nr = 16;
 	bits->ack.p = 16383;
-	bits->msn.bits = rnd_6->msn;
+	bits->msn.bits = rnd_6.msn;
 	bits->msn.bits_nr = 4;
-	bits->seq_scaled.bits = rnd_6->seq_num_scaled;
+	bits->seq_scaled.bits = rnd_6.seq_num_scaled;
 	bits->seq_scaled.bits_nr = 4;
 
-	*rohc_hdr_len = sizeof(rnd_6_t);
+	*rohc_hdr_len = rnd_6_len;
 	*has_opts_list = false;
 
 	return true;
@@ -1592,34 +1904,34 @@ static bool d_tcp_parse_rnd_7(const struct rohc_decomp_ctxt *const context,
                               size_t *const rohc_hdr_len,
                               bool *const has_opts_list)
 {
-	const rnd_7_t *const rnd_7 = (rnd_7_t *) rohc_packet;
+	struct rnd_7 rnd_7;
 
 	/* check packet usage */
 	assert(context->state == ROHC_DECOMP_STATE_FC);
 
 	/* check if the ROHC packet is large enough to parse rnd_7 */
-	if(rohc_length < sizeof(rnd_7_t))
+	if(rohc_length < rnd_7_len)
 	{
 		rohc_decomp_warn(context, "ROHC packet too small for rnd_7 (len = %zu)",
 		                 rohc_length);
 		goto error;
 	}
 
-	assert(rnd_7->discriminator == 0x2f); /* '101111' */
-	bits->ack.bits = (rnd_7->ack_num1 << 16) | rohc_ntoh16(rnd_7->ack_num2);
+	rnd_7_read(rohc_packet, &rnd_7);
+	bits->ack.bits = rnd_7.ack_num;
 	bits->ack.bits_nr = 18;
 	bits->ack.p = 65535;
-	bits->window.bits = rohc_ntoh16(rnd_7->window);
+	bits->window.bits = rnd_7.window;
 	bits->window.bits_nr = 16;
-	bits->msn.bits = rnd_7->msn;
+	bits->msn.bits = rnd_7.msn;
 	bits->msn.bits_nr = 4;
-	bits->psh_flag_bits = rnd_7->psh_flag;
+	bits->psh_flag_bits = rnd_7.psh_flag;
 	bits->psh_flag_bits_nr = 1;
 	extr_crc->type = ROHC_CRC_TYPE_3;
-	extr_crc->bits = rnd_7->header_crc;
+	extr_crc->bits = rnd_7.header_crc;
 	extr_crc->bits_nr = 3;
 
-	*rohc_hdr_len = sizeof(rnd_7_t);
+	*rohc_hdr_len = rnd_7_len;
 	*has_opts_list = false;
 
 	return true;
@@ -1653,43 +1965,43 @@ static bool d_tcp_parse_rnd_8(const struct rohc_decomp_ctxt *const context,
 {
 	struct rohc_tcp_extr_ip_bits *const innermost_ip_bits =
 		&(bits->ip[bits->ip_nr - 1]);
-	const rnd_8_t *const rnd_8 = (rnd_8_t *) rohc_packet;
+	struct rnd_8 rnd_8;
 
 	/* check packet usage */
 	assert(context->state != ROHC_DECOMP_STATE_NC);
 
 	/* check if the ROHC packet is large enough to parse rnd_8 */
-	if(rohc_length < sizeof(rnd_8_t))
+	if(rohc_length < rnd_8_len)
 	{
 		rohc_decomp_warn(context, "ROHC packet too small for rnd_8 (len = %zu)",
 		                 rohc_length);
 		goto error;
 	}
 
-	assert(rnd_8->discriminator == 0x16); /* '10110' */
-	bits->rsf_flags_bits = rnd_8->rsf_flags;
+	rnd_8_read(rohc_packet, &rnd_8);
+	bits->rsf_flags_bits = rnd_8.rsf_flags;
 	bits->rsf_flags_bits_nr = 2;
-	(*has_opts_list) = !!rnd_8->list_present;
+	(*has_opts_list) = !!rnd_8.list_present;
 	extr_crc->type = ROHC_CRC_TYPE_7;
-	extr_crc->bits = rnd_8->header_crc;
+	extr_crc->bits = rnd_8.header_crc;
 	extr_crc->bits_nr = 7;
-	bits->msn.bits = (rnd_8->msn1 << 3) | rnd_8->msn2;
+	bits->msn.bits = rnd_8.msn;
 	bits->msn.bits_nr = 4;
-	bits->psh_flag_bits = rnd_8->psh_flag;
+	bits->psh_flag_bits = rnd_8.psh_flag;
 	bits->psh_flag_bits_nr = 1;
-	innermost_ip_bits->ttl_hl.bits = rnd_8->ttl_hopl;
+	innermost_ip_bits->ttl_hl.bits = rnd_8.ttl_hopl;
 	innermost_ip_bits->ttl_hl.bits_nr = 3;
-	bits->ecn_used_bits = rnd_8->ecn_used;
+	bits->ecn_used_bits = rnd_8.ecn_used;
 	bits->ecn_used_bits_nr = 1;
 	rohc_decomp_debug(context, "packet ecn_used = %d", bits->ecn_used_bits);
-	bits->seq.bits = rohc_ntoh16(rnd_8->seq_num);
+	bits->seq.bits = rnd_8.seq_num;
 	bits->seq.bits_nr = 16;
 	bits->seq.p = 65535;
-	bits->ack.bits = rohc_ntoh16(rnd_8->ack_num);
+	bits->ack.bits = rnd_8.ack_num;
 	bits->ack.bits_nr = 16;
 	bits->ack.p = 16383;
 
-	*rohc_hdr_len = sizeof(rnd_8_t);
+	*rohc_hdr_len = rnd_8_len;
 
 	return true;
 
@@ -1722,35 +2034,35 @@ static bool d_tcp_parse_seq_1(const struct rohc_decomp_ctxt *const context,
 {
 	struct rohc_tcp_extr_ip_bits *const innermost_ip_bits =
 		&(bits->ip[bits->ip_nr - 1]);
-	const seq_1_t *const seq_1 = (seq_1_t *) rohc_packet;
+	struct seq_1 seq_1;
 
 	/* check packet usage */
 	assert(context->state == ROHC_DECOMP_STATE_FC);
 
 	/* check if the ROHC packet is large enough to parse seq_1 */
-	if(rohc_length < sizeof(seq_1_t))
+	if(rohc_length < seq_1_len)
 	{
 		rohc_decomp_warn(context, "ROHC packet too small for seq_1 (len = %zu)",
 		                 rohc_length);
 		goto error;
 	}
 
-	assert(seq_1->discriminator == 0x0a); /* '1010' */
-	innermost_ip_bits->id.bits = seq_1->ip_id;
+	seq_1_read(rohc_packet, &seq_1);
+	innermost_ip_bits->id.bits = seq_1.ip_id;
 	innermost_ip_bits->id.bits_nr = 4;
 	innermost_ip_bits->id.p = 3;
-	bits->seq.bits = rohc_ntoh16(seq_1->seq_num);
+	bits->seq.bits = seq_1.seq_num;
 	bits->seq.bits_nr = 16;
 	bits->seq.p = 32767;
-	bits->msn.bits = seq_1->msn;
+	bits->msn.bits = seq_1.msn;
 	bits->msn.bits_nr = 4;
-	bits->psh_flag_bits = seq_1->psh_flag;
+	bits->psh_flag_bits = seq_1.psh_flag;
 	bits->psh_flag_bits_nr = 1;
 	extr_crc->type = ROHC_CRC_TYPE_3;
-	extr_crc->bits = seq_1->header_crc;
+	extr_crc->bits = seq_1.header_crc;
 	extr_crc->bits_nr = 3;
 
-	*rohc_hdr_len = sizeof(seq_1_t);
+	*rohc_hdr_len = seq_1_len;
 	*has_opts_list = false;
 
 	return true;
@@ -1784,34 +2096,34 @@ static bool d_tcp_parse_seq_2(const struct rohc_decomp_ctxt *const context,
 {
 	struct rohc_tcp_extr_ip_bits *const innermost_ip_bits =
 		&(bits->ip[bits->ip_nr - 1]);
-	const seq_2_t *const seq_2 = (seq_2_t *) rohc_packet;
+	struct seq_2 seq_2;
 
 	/* check packet usage */
 	assert(context->state == ROHC_DECOMP_STATE_FC);
 
 	/* check if the ROHC packet is large enough to parse seq_2 */
-	if(rohc_length < sizeof(seq_2_t))
+	if(rohc_length < seq_2_len)
 	{
 		rohc_decomp_warn(context, "ROHC packet too small for seq_2 (len = %zu)",
 		                 rohc_length);
 		goto error;
 	}
 
-	assert(seq_2->discriminator == 0x1a); /* '11010' */
-	innermost_ip_bits->id.bits = (seq_2->ip_id1 << 4) | seq_2->ip_id2;
+	seq_2_read(rohc_packet, &seq_2);
+	innermost_ip_bits->id.bits = seq_2.ip_id;
 	innermost_ip_bits->id.bits_nr = 7;
 	innermost_ip_bits->id.p = 3;
-	bits->seq_scaled.bits = seq_2->seq_num_scaled;
+	bits->seq_scaled.bits = seq_2.seq_num_scaled;
 	bits->seq_scaled.bits_nr = 4;
-	bits->msn.bits = seq_2->msn;
+	bits->msn.bits = seq_2.msn;
 	bits->msn.bits_nr = 4;
-	bits->psh_flag_bits = seq_2->psh_flag;
+	bits->psh_flag_bits = seq_2.psh_flag;
 	bits->psh_flag_bits_nr = 1;
 	extr_crc->type = ROHC_CRC_TYPE_3;
-	extr_crc->bits = seq_2->header_crc;
+	extr_crc->bits = seq_2.header_crc;
 	extr_crc->bits_nr = 3;
 
-	*rohc_hdr_len = sizeof(seq_2_t);
+	*rohc_hdr_len = seq_2_len;
 	*has_opts_list = false;
 
 	return true;
@@ -1845,35 +2157,35 @@ static bool d_tcp_parse_seq_3(const struct rohc_decomp_ctxt *const context,
 {
 	struct rohc_tcp_extr_ip_bits *const innermost_ip_bits =
 		&(bits->ip[bits->ip_nr - 1]);
-	const seq_3_t *const seq_3 = (seq_3_t *) rohc_packet;
+	struct seq_3 seq_3;
 
 	/* check packet usage */
 	assert(context->state == ROHC_DECOMP_STATE_FC);
 
 	/* check if the ROHC packet is large enough to parse seq_3 */
-	if(rohc_length < sizeof(seq_3_t))
+	if(rohc_length < seq_3_len)
 	{
 		rohc_decomp_warn(context, "ROHC packet too small for seq_3 (len = %zu)",
 		                 rohc_length);
 		goto error;
 	}
 
-	assert(seq_3->discriminator == 0x09); /* '1001' */
-	innermost_ip_bits->id.bits = seq_3->ip_id;
+	seq_3_read(rohc_packet, &seq_3);
+	innermost_ip_bits->id.bits = seq_3.ip_id;
 	innermost_ip_bits->id.bits_nr = 4;
 	innermost_ip_bits->id.p = 3;
-	bits->ack.bits = rohc_ntoh16(seq_3->ack_num);
+	bits->ack.bits = seq_3.ack_num;
 	bits->ack.bits_nr = 16;
 	bits->ack.p = 16383;
-	bits->msn.bits = seq_3->msn;
+	bits->msn.bits = seq_3.msn;
 	bits->msn.bits_nr = 4;
-	bits->psh_flag_bits = seq_3->psh_flag;
+	bits->psh_flag_bits = seq_3.psh_flag;
 	bits->psh_flag_bits_nr = 1;
 	extr_crc->type = ROHC_CRC_TYPE_3;
-	extr_crc->bits = seq_3->header_crc;
+	extr_crc->bits = seq_3.header_crc;
 	extr_crc->bits_nr = 3;
 
-	*rohc_hdr_len = sizeof(seq_3_t);
+	*rohc_hdr_len = seq_3_len;
 	*has_opts_list = false;
 
 	return true;
@@ -1908,7 +2220,7 @@ static bool d_tcp_parse_seq_4(const struct rohc_decomp_ctxt *const context,
 	const struct d_tcp_context *const tcp_context = context->persist_ctxt;
 	struct rohc_tcp_extr_ip_bits *const innermost_ip_bits =
 		&(bits->ip[bits->ip_nr - 1]);
-	const seq_4_t *const seq_4 = (seq_4_t *) rohc_packet;
+	struct seq_4 seq_4;
 
 	/* check packet usage */
 	assert(context->state == ROHC_DECOMP_STATE_FC);
@@ -1923,28 +2235,28 @@ static bool d_tcp_parse_seq_4(const struct rohc_decomp_ctxt *const context,
 	}
 
 	/* check if the ROHC packet is large enough to parse seq_4 */
-	if(rohc_length < sizeof(seq_4_t))
+	if(rohc_length < seq_4_len)
 	{
 		rohc_decomp_warn(context, "ROHC packet too small for seq_4 len = %zu)",
 		                 rohc_length);
 		goto error;
 	}
 
-	assert(seq_4->discriminator == 0x00); /* '0' */
-	bits->ack_scaled.bits = seq_4->ack_num_scaled;
+	seq_4_read(rohc_packet, &seq_4);
+	bits->ack_scaled.bits = seq_4.ack_num_scaled;
 	bits->ack_scaled.bits_nr = 4;
-	innermost_ip_bits->id.bits = seq_4->ip_id;
+	innermost_ip_bits->id.bits = seq_4.ip_id;
 	innermost_ip_bits->id.bits_nr = 3;
 	innermost_ip_bits->id.p = 1;
-	bits->msn.bits = seq_4->msn;
+	bits->msn.bits = seq_4.msn;
 	bits->msn.bits_nr = 4;
-	bits->psh_flag_bits = seq_4->psh_flag;
+	bits->psh_flag_bits = seq_4.psh_flag;
 	bits->psh_flag_bits_nr = 1;
 	extr_crc->type = ROHC_CRC_TYPE_3;
-	extr_crc->bits = seq_4->header_crc;
+	extr_crc->bits = seq_4.header_crc;
 	extr_crc->bits_nr = 3;
 
-	*rohc_hdr_len = sizeof(seq_4_t);
+	*rohc_hdr_len = seq_4_len;
 	*has_opts_list = false;
 
 	return true;
@@ -1978,38 +2290,38 @@ static bool d_tcp_parse_seq_5(const struct rohc_decomp_ctxt *const context,
 {
 	struct rohc_tcp_extr_ip_bits *const innermost_ip_bits =
 		&(bits->ip[bits->ip_nr - 1]);
-	const seq_5_t *const seq_5 = (seq_5_t *) rohc_packet;
+	struct seq_5 seq_5;
 
 	/* check packet usage */
 	assert(context->state == ROHC_DECOMP_STATE_FC);
 
 	/* check if the ROHC packet is large enough to parse seq_5 */
-	if(rohc_length < sizeof(seq_5_t))
+	if(rohc_length < seq_5_len)
 	{
 		rohc_decomp_warn(context, "ROHC packet too small for seq_5 (len = %zu)",
 		                 rohc_length);
 		goto error;
 	}
 
-	assert(seq_5->discriminator == 0x08); /* '1000' */
-	innermost_ip_bits->id.bits = seq_5->ip_id;
+	seq_5_read(rohc_packet, &seq_5);
+	innermost_ip_bits->id.bits = seq_5.ip_id;
 	innermost_ip_bits->id.bits_nr = 4;
 	innermost_ip_bits->id.p = 3;
-	bits->ack.bits = rohc_ntoh16(seq_5->ack_num);
+	bits->ack.bits = seq_5.ack_num;
 	bits->ack.bits_nr = 16;
 	bits->ack.p = 16383;
-	bits->seq.bits = rohc_ntoh16(seq_5->seq_num);
+	bits->seq.bits = seq_5.seq_num;
 	bits->seq.bits_nr = 16;
 	bits->seq.p = 32767;
-	bits->msn.bits = seq_5->msn;
+	bits->msn.bits = seq_5.msn;
 	bits->msn.bits_nr = 4;
-	bits->psh_flag_bits = seq_5->psh_flag;
+	bits->psh_flag_bits = seq_5.psh_flag;
 	bits->psh_flag_bits_nr = 1;
 	extr_crc->type = ROHC_CRC_TYPE_3;
-	extr_crc->bits = seq_5->header_crc;
+	extr_crc->bits = seq_5.header_crc;
 	extr_crc->bits_nr = 3;
 
-	*rohc_hdr_len = sizeof(seq_5_t);
+	*rohc_hdr_len = seq_5_len;
 	*has_opts_list = false;
 
 	return true;
@@ -2043,37 +2355,37 @@ static bool d_tcp_parse_seq_6(const struct rohc_decomp_ctxt *const context,
 {
 	struct rohc_tcp_extr_ip_bits *const innermost_ip_bits =
 		&(bits->ip[bits->ip_nr - 1]);
-	const seq_6_t *const seq_6 = (seq_6_t *) rohc_packet;
+	struct seq_6 seq_6;
 
 	/* check packet usage */
 	assert(context->state == ROHC_DECOMP_STATE_FC);
 
 	/* check if the ROHC packet is large enough to parse seq_6 */
-	if(rohc_length < sizeof(seq_6_t))
+	if(rohc_length < seq_6_len)
 	{
 		rohc_decomp_warn(context, "ROHC packet too small for seq_6 (len = %zu)",
 		                 rohc_length);
 		goto error;
 	}
 
-	assert(seq_6->discriminator == 0x1b); /* '11011' */
-	bits->seq_scaled.bits = (seq_6->seq_num_scaled1 << 1) | seq_6->seq_num_scaled2;
+	seq_6_read(rohc_packet, &seq_6);
+	bits->seq_scaled.bits = seq_6.seq_num_scaled;
 	bits->seq_scaled.bits_nr = 4;
-	innermost_ip_bits->id.bits = seq_6->ip_id;
+	innermost_ip_bits->id.bits = seq_6.ip_id;
 	innermost_ip_bits->id.bits_nr = 7;
 	innermost_ip_bits->id.p = 3;
-	bits->ack.bits = rohc_ntoh16(seq_6->ack_num);
+	bits->ack.bits = seq_6.ack_num;
 	bits->ack.bits_nr = 16;
 	bits->ack.p = 16383;
-	bits->msn.bits = seq_6->msn;
+	bits->msn.bits = seq_6.msn;
 	bits->msn.bits_nr = 4;
-	bits->psh_flag_bits = seq_6->psh_flag;
+	bits->psh_flag_bits = seq_6.psh_flag;
 	bits->psh_flag_bits_nr = 1;
 	extr_crc->type = ROHC_CRC_TYPE_3;
-	extr_crc->bits = seq_6->header_crc;
+	extr_crc->bits = seq_6.header_crc;
 	extr_crc->bits_nr = 3;
 
-	*rohc_hdr_len = sizeof(seq_6_t);
+	*rohc_hdr_len = seq_6_len;
 	*has_opts_list = false;
 
 	return true;
@@ -2107,39 +2419,38 @@ static bool d_tcp_parse_seq_7(const struct rohc_decomp_ctxt *const context,
 {
 	struct rohc_tcp_extr_ip_bits *const innermost_ip_bits =
 		&(bits->ip[bits->ip_nr - 1]);
-	const seq_7_t *const seq_7 = (seq_7_t *) rohc_packet;
+	struct seq_7 seq_7;
 
 	/* check packet usage */
 	assert(context->state == ROHC_DECOMP_STATE_FC);
 
 	/* check if the ROHC packet is large enough to parse seq_7 */
-	if(rohc_length < sizeof(seq_7_t))
+	if(rohc_length < seq_7_len)
 	{
 		rohc_decomp_warn(context, "ROHC packet too small for seq_7 (len = %zu)",
 		                 rohc_length);
 		goto error;
 	}
 
-	assert(seq_7->discriminator == 0x0c); /* '1100' */
-	bits->window.bits =
-		(seq_7->window1 << 11) | (seq_7->window2 << 3) | seq_7->window3;
+	seq_7_read(rohc_packet, &seq_7);
+	bits->window.bits = seq_7.window;
 	bits->window.bits_nr = 15;
 	bits->window.p = ROHC_LSB_SHIFT_TCP_WINDOW;
-	innermost_ip_bits->id.bits = seq_7->ip_id;
+	innermost_ip_bits->id.bits = seq_7.ip_id;
 	innermost_ip_bits->id.bits_nr = 5;
 	innermost_ip_bits->id.p = 3;
-	bits->ack.bits = rohc_ntoh16(seq_7->ack_num);
+	bits->ack.bits = seq_7.ack_num;
 	bits->ack.bits_nr = 16;
 	bits->ack.p = 32767;
-	bits->msn.bits = seq_7->msn;
+	bits->msn.bits = seq_7.msn;
 	bits->msn.bits_nr = 4;
-	bits->psh_flag_bits = seq_7->psh_flag;
+	bits->psh_flag_bits = seq_7.psh_flag;
 	bits->psh_flag_bits_nr = 1;
 	extr_crc->type = ROHC_CRC_TYPE_3;
-	extr_crc->bits = seq_7->header_crc;
+	extr_crc->bits = seq_7.header_crc;
 	extr_crc->bits_nr = 3;
 
-	*rohc_hdr_len = sizeof(seq_7_t);
+	*rohc_hdr_len = seq_7_len;
 	*has_opts_list = false;
 
 	return true;
@@ -2173,46 +2484,46 @@ static bool d_tcp_parse_seq_8(const struct rohc_decomp_ctxt *const context,
 {
 	struct rohc_tcp_extr_ip_bits *const innermost_ip_bits =
 		&(bits->ip[bits->ip_nr - 1]);
-	const seq_8_t *const seq_8 = (seq_8_t *) rohc_packet;
+	struct seq_8 seq_8;
 
 	/* check packet usage */
 	assert(context->state != ROHC_DECOMP_STATE_NC);
 
 	/* check if the ROHC packet is large enough to parse seq_8 */
-	if(rohc_length < sizeof(seq_8_t))
+	if(rohc_length < seq_8_len)
 	{
 		rohc_decomp_warn(context, "ROHC packet too small for seq_8 (len = %zu)",
 		                 rohc_length);
 		goto error;
 	}
 
-	assert(seq_8->discriminator == 0x0b); /* '1011' */
-	innermost_ip_bits->id.bits = seq_8->ip_id;
+	seq_8_read(rohc_packet, &seq_8);
+	innermost_ip_bits->id.bits = seq_8.ip_id;
 	innermost_ip_bits->id.bits_nr = 4;
 	innermost_ip_bits->id.p = 3;
-	(*has_opts_list) = !!seq_8->list_present;
+	(*has_opts_list) = !!seq_8.list_present;
 	extr_crc->type = ROHC_CRC_TYPE_7;
-	extr_crc->bits = seq_8->header_crc;
+	extr_crc->bits = seq_8.header_crc;
 	extr_crc->bits_nr = 7;
-	bits->msn.bits = seq_8->msn;
+	bits->msn.bits = seq_8.msn;
 	bits->msn.bits_nr = 4;
-	bits->psh_flag_bits = seq_8->psh_flag;
+	bits->psh_flag_bits = seq_8.psh_flag;
 	bits->psh_flag_bits_nr = 1;
-	innermost_ip_bits->ttl_hl.bits = seq_8->ttl_hopl;
+	innermost_ip_bits->ttl_hl.bits = seq_8.ttl_hopl;
 	innermost_ip_bits->ttl_hl.bits_nr = 3;
-	bits->ecn_used_bits = seq_8->ecn_used;
+	bits->ecn_used_bits = seq_8.ecn_used;
 	bits->ecn_used_bits_nr = 1;
 	rohc_decomp_debug(context, "packet ecn_used = %d", bits->ecn_used_bits);
-	bits->ack.bits = (seq_8->ack_num1 << 8) | seq_8->ack_num2;
+	bits->ack.bits = seq_8.ack_num;
 	bits->ack.bits_nr = 15;
 	bits->ack.p = 8191;
-	bits->rsf_flags_bits = seq_8->rsf_flags;
+	bits->rsf_flags_bits = seq_8.rsf_flags;
 	bits->rsf_flags_bits_nr = 2;
-	bits->seq.bits = (seq_8->seq_num1 << 8) | seq_8->seq_num2;
+	bits->seq.bits = seq_8.seq_num;
 	bits->seq.bits_nr = 14;
 	bits->seq.p = 8191;
 
-	*rohc_hdr_len = sizeof(seq_8_t);
+	*rohc_hdr_len = seq_8_len;
 
 	return true;
 
@@ -3576,10 +3887,13 @@ static void d_tcp_decode_opt_sack(const struct rohc_decomp_ctxt *const context,
  * @brief Build all of the uncompressed IP headers
  *
  * Build all of the uncompressed IP headers - IPv4 or IPv6 - from the context
- * and packet informations.
+ * and packet informations. The room for the IP headers shall be already
+ * counted in the \e uncomp_packet buffer.
  *
  * @param context             The decompression context
  * @param decoded             The values decoded from the ROHC packet
+ * @param pkt_len             The length of the packet from the outermost IP
+ *                            header (in bytes)
  * @param[out] uncomp_packet  The uncompressed packet being built
  * @param[out] ip_hdrs_len    The length of all the IP headers (in bytes)
  * @return                    true if IP headers were successfully built,
@@ -3588,6 +3902,7 @@ static void d_tcp_decode_opt_sack(const struct rohc_decomp_ctxt *const context,
  */
 static bool d_tcp_build_ip_hdrs(const struct rohc_decomp_ctxt *const context,
                                 const struct rohc_tcp_decoded_values *const decoded,
+                                const size_t pkt_len,
                                 struct rohc_buf *const uncomp_packet,
                                 size_t *const ip_hdrs_len)
 {
@@ -3604,7 +3919,9 @@ static bool d_tcp_build_ip_hdrs(const struct rohc_decomp_ctxt *const context,
 			&(decoded->ip[ip_hdr_nr]);
 		size_t ip_hdr_len = 0;
 
-		if(!d_tcp_build_ip_hdr(context, ip_decoded, uncomp_packet, &ip_hdr_len))
+		assert(pkt_len > (*ip_hdrs_len));
+		if(!d_tcp_build_ip_hdr(context, ip_decoded, pkt_len - (*ip_hdrs_len),
+		                       uncomp_packet, &ip_hdr_len))
 		{
 			rohc_decomp_warn(context, "failed to build uncompressed IP header #%zu",
 			                 ip_hdr_nr + 1);
@@ -3628,6 +3945,8 @@ error:
  *
  * @param context             The decompression context
  * @param decoded             The values decoded from the ROHC packet
+ * @param ip_tot_len          The length of the packet from the IP header
+ *                            (in bytes)
  * @param[out] uncomp_packet  The uncompressed packet being built
  * @param[out] ip_hdr_len     The length of the IP header (in bytes)
  * @return                    true if IP header was successfully built,
@@ -3636,12 +3955,14 @@ error:
  */
 static bool d_tcp_build_ip_hdr(const struct rohc_decomp_ctxt *const context,
                                const struct rohc_tcp_decoded_ip_values *const decoded,
+                               const size_t ip_tot_len,
                                struct rohc_buf *const uncomp_packet,
                                size_t *const ip_hdr_len)
 {
 	if(decoded->version == IPV4)
 	{
-		if(!d_tcp_build_ipv4_hdr(context, decoded, uncomp_packet, ip_hdr_len))
+		if(!d_tcp_build_ipv4_hdr(context, decoded, ip_tot_len, uncomp_packet,
+		                         ip_hdr_len))
 		{
 			rohc_decomp_warn(context, "failed to build uncompressed IPv4 header");
 			goto error;
@@ -3649,7 +3970,8 @@ static bool d_tcp_build_ip_hdr(const struct rohc_decomp_ctxt *const context,
 	}
 	else
 	{
-		if(!d_tcp_build_ipv6_hdr(context, decoded, uncomp_packet, ip_hdr_len))
+		if(!d_tcp_build_ipv6_hdr(context, decoded, ip_tot_len, uncomp_packet,
+		                         ip_hdr_len))
 		{
 			rohc_decomp_warn(context, "failed to build uncompressed IPv6 header");
 			goto error;
@@ -3671,6 +3993,8 @@ error:
  *
  * @param context             The decompression context
  * @param decoded             The values decoded from the ROHC packet
+ * @param ip_tot_len          The length of the packet from the IPv4 header
+ *                            (in bytes)
  * @param[out] uncomp_packet  The uncompressed packet being built
  * @param[out] ip_hdr_len     The length of the IPv4 header (in bytes)
  * @return                    true if IPv4 header was successfully built,
@@ -3679,6 +4003,7 @@ error:
  */
 static bool d_tcp_build_ipv4_hdr(const struct rohc_decomp_ctxt *const context,
                                  const struct rohc_tcp_decoded_ip_values *const decoded,
+                                 const size_t ip_tot_len,
                                  struct rohc_buf *const uncomp_packet,
                                  size_t *const ip_hdr_len)
 {
@@ -3717,10 +4042,19 @@ static bool d_tcp_build_ipv4_hdr(const struct rohc_decomp_ctxt *const context,
 	                  tcp_ip_id_behavior_get_descr(decoded->id_behavior),
 	                  rohc_ntoh16(ipv4->id));
 
-	/* length and checksums will be computed once all headers are built */
+	/* total length */
+	ipv4->tot_len = rohc_hton16(ip_tot_len);
+	rohc_decomp_debug(context, "    IP total length = 0x%04x (%zu)",
+	                  rohc_ntoh16(ipv4->tot_len), ip_tot_len);
+
+	/* the IPv4 checksum is always computed, even if the caller might compute
+	 * it again (eg. with checksum offload): the ROHC CRC covers it */
+	ipv4->check = 0;
+	ipv4->check = ip_fast_csum((uint8_t *) ipv4, ipv4->ihl);
+	rohc_decomp_debug(context, "    IP checksum = 0x%04x on %zu bytes",
+	                  rohc_ntoh16(ipv4->check), hdr_len);
 
 	/* skip IPv4 header */
-	uncomp_packet->len += hdr_len;
 	rohc_buf_pull(uncomp_packet, hdr_len);
 	*ip_hdr_len += hdr_len;
 
@@ -3739,6 +4073,8 @@ error:
  *
  * @param context             The decompression context
  * @param decoded             The values decoded from the ROHC packet
+ * @param ip_tot_len          The length of the packet from the IPv6 header
+ *                            (in bytes)
  * @param[out] uncomp_packet  The uncompressed packet being built
  * @param[out] ip_hdr_len     The length of the IPv6 header (in bytes)
  * @return                    true if IPv6 header was successfully built,
@@ -3747,6 +4083,7 @@ error:
  */
 static bool d_tcp_build_ipv6_hdr(const struct rohc_decomp_ctxt *const context,
                                  const struct rohc_tcp_decoded_ip_values *const decoded,
+                                 const size_t ip_tot_len,
                                  struct rohc_buf *const uncomp_packet,
                                  size_t *const ip_hdr_len)
 {
@@ -3784,10 +4121,13 @@ static bool d_tcp_build_ipv6_hdr(const struct rohc_decomp_ctxt *const context,
 	rohc_decomp_debug(context, "    DSCP = 0x%02x, ip_ecn_flags = %d, HL = %u",
 	                  decoded->dscp, decoded->ecn_flags, ipv6->hl);
 
-	/* total length will be computed once all headers are built */
+	/* payload length, extension headers included */
+	assert(ip_tot_len >= full_ipv6_len);
+	ipv6->plen = rohc_hton16(ip_tot_len - hdr_len);
+	rohc_decomp_debug(context, "    IPv6 payload length = %u",
+	                  rohc_ntoh16(ipv6->plen));
 
 	/* skip IPv6 header */
-	uncomp_packet->len += hdr_len;
 	rohc_buf_pull(uncomp_packet, hdr_len);
 	*ip_hdr_len += hdr_len;
 
@@ -3798,12 +4138,12 @@ static bool d_tcp_build_ipv6_hdr(const struct rohc_decomp_ctxt *const context,
 		const ip_option_context_t *const opt = &(decoded->opts[i]);
 		rohc_decomp_debug(context, "build %zu-byte IPv6 extension header #%zu",
 		                  opt->len, i + 1);
-		uncomp_packet->len += 2;
 		rohc_buf_byte_at(*uncomp_packet, 0) = opt->nh_proto;
 		assert((opt->len % 8) == 0);
 		assert((opt->len / 8) > 0);
 		rohc_buf_byte_at(*uncomp_packet, 1) = opt->len / 8 - 1;
-		rohc_buf_append(uncomp_packet, opt->generic.data, opt->len - 2);
+		memcpy(rohc_buf_data_at(*uncomp_packet, 2), opt->generic.data,
+		       opt->len - 2);
 		rohc_buf_pull(uncomp_packet, opt->len);
 		*ip_hdr_len += opt->len;
 		all_opts_len += opt->len;
@@ -3929,6 +4269,7 @@ static rohc_status_t d_tcp_build_hdrs(const struct rohc_decomp *const decomp,
                                       size_t *const uncomp_hdrs_len)
 {
 	size_t ip_hdrs_len = 0;
+	size_t ip_hdr_len = 0;
 	size_t tcp_hdr_len = 0;
 	size_t ip_hdr_nr;
 
@@ -3936,13 +4277,29 @@ static rohc_status_t d_tcp_build_hdrs(const struct rohc_decomp *const decomp,
 
 	*uncomp_hdrs_len = 0;
 
-	/* build IP headers */
-	if(!d_tcp_build_ip_hdrs(context, decoded, uncomp_hdrs, &ip_hdrs_len))
+	/* the IP headers are built after the TCP header, in one single pass with
+	 * their lengths and checksums: only the length of the TCP options is not
+	 * known in advance */
+	assert(decoded->ip_nr > 0);
+	for(ip_hdr_nr = 0; ip_hdr_nr < decoded->ip_nr; ip_hdr_nr++)
 	{
-		rohc_decomp_warn(context, "failed to build uncompressed IP headers");
+		if(decoded->ip[ip_hdr_nr].version == IPV4)
+		{
+			ip_hdrs_len += sizeof(struct ipv4_hdr);
+		}
+		else
+		{
+			ip_hdrs_len += sizeof(struct ipv6_hdr) + decoded->ip[ip_hdr_nr].opts_len;
+		}
+	}
+	if(rohc_buf_avail_len(*uncomp_hdrs) < ip_hdrs_len)
+	{
+		rohc_decomp_warn(context, "output buffer too small for the %zu bytes of "
+		                 "the %zu IP headers", ip_hdrs_len, decoded->ip_nr);
 		goto error_output_too_small;
 	}
-	*uncomp_hdrs_len += ip_hdrs_len;
+	uncomp_hdrs->len += ip_hdrs_len;
+	rohc_buf_pull(uncomp_hdrs, ip_hdrs_len);
 
 	/* build TCP header */
 	if(!d_tcp_build_tcp_hdr(context, decoded, uncomp_hdrs, &tcp_hdr_len))
@@ -3950,53 +4307,26 @@ static rohc_status_t d_tcp_build_hdrs(const struct rohc_decomp *const decomp,
 		rohc_decomp_warn(context, "failed to build uncompressed TCP header");
 		goto error_output_too_small;
 	}
-	*uncomp_hdrs_len += tcp_hdr_len;
-
-	/* unhide the IP/TCP headers */
-	rohc_buf_push(uncomp_hdrs, *uncomp_hdrs_len);
+	rohc_buf_push(uncomp_hdrs, ip_hdrs_len + tcp_hdr_len);
 
-	/* compute payload lengths and checksums for all IP headers */
-	rohc_decomp_debug(context, "compute lengths and checksums for the %zu IP "
-	                  "headers", decoded->ip_nr);
-	assert(decoded->ip_nr > 0);
-	for(ip_hdr_nr = 0; ip_hdr_nr < decoded->ip_nr; ip_hdr_nr++)
+	/* build IP headers */
+	if(!d_tcp_build_ip_hdrs(context, decoded,
+	                        ip_hdrs_len + tcp_hdr_len + payload_len,
+	                        uncomp_hdrs, &ip_hdr_len))
 	{
-		const struct rohc_tcp_decoded_ip_values *const ip_decoded =
-			&(decoded->ip[ip_hdr_nr]);
-
-		rohc_decomp_debug(context, "  IP header #%zu:", ip_hdr_nr + 1);
-		if(ip_decoded->version == IPV4)
-		{
-			const uint16_t ipv4_tot_len = uncomp_hdrs->len + payload_len;
-			struct ipv4_hdr *const ipv4 =
-				(struct ipv4_hdr *) rohc_buf_data(*uncomp_hdrs);
-			ipv4->tot_len = rohc_hton16(ipv4_tot_len);
-			rohc_decomp_debug(context, "    IP total length = 0x%04x (%u)",
-			                  ipv4_tot_len, ipv4_tot_len);
-			ipv4->check = 0;
-			ipv4->check =
-				ip_fast_csum(rohc_buf_data(*uncomp_hdrs), ipv4->ihl);
-			rohc_decomp_debug(context, "    IP checksum = 0x%04x on %zu bytes",
-			                  rohc_ntoh16(ipv4->check), ipv4->ihl * sizeof(uint32_t));
-			rohc_buf_pull(uncomp_hdrs, ipv4->ihl * sizeof(uint32_t));
-		}
-		else
-		{
-			struct ipv6_hdr *const ipv6 = (struct ipv6_hdr *) rohc_buf_data(*uncomp_hdrs);
-			rohc_buf_pull(uncomp_hdrs, sizeof(struct ipv6_hdr));
-			ipv6->plen = rohc_hton16(uncomp_hdrs->len + payload_len);
-			rohc_decomp_debug(context, "    IPv6 payload length = %u",
-			                  rohc_ntoh16(ipv6->plen));
-			rohc_buf_pull(uncomp_hdrs, ip_decoded->opts_len);
-		}
+		rohc_decomp_warn(context, "failed to build uncompressed IP headers");
+		goto error_output_too_small;
 	}
+	assert(ip_hdr_len == ip_hdrs_len);
+	*uncomp_hdrs_len = ip_hdrs_len + tcp_hdr_len;
+
 	/* unhide the IP headers */
 	rohc_buf_push(uncomp_hdrs, ip_hdrs_len);
 
 	/* compute CRC on uncompressed headers if asked */
 	if(extr_crc->type != ROHC_CRC_TYPE_NONE)
 	{
-		const bool crc_ok = d_tcp_check_uncomp_crc(decomp, context, uncomp_hdrs,
+		const bool crc_ok = d_tcp_check_uncomp_crc(context, uncomp_hdrs,
 		                                           extr_crc->type, extr_crc->bits);
 		if(!crc_ok)
 		{
@@ -4034,15 +4364,13 @@ error_output_too_small:
 /**
  * @brief Check whether the CRC on uncompressed header is correct or not
  *
- * @param decomp       The ROHC decompressor
  * @param context      The decompression context
  * @param uncomp_hdrs  The uncompressed headers
  * @param crc_type     The type of CRC
  * @param crc_packet   The CRC extracted from the ROHC header
  * @return             true if the CRC is correct, false otherwise
  */
-static bool d_tcp_check_uncomp_crc(const struct rohc_decomp *const decomp,
-                                   const struct rohc_decomp_ctxt *const context,
+static bool d_tcp_check_uncomp_crc(const struct rohc_decomp_ctxt *const context,
                                    struct rohc_buf *const uncomp_hdrs,
                                    const rohc_crc_type_t crc_type,
                                    const uint8_t crc_packet)
@@ -4055,11 +4383,11 @@ static bool d_tcp_check_uncomp_crc(const struct rohc_decomp *const decomp,
 	{
 		case ROHC_CRC_TYPE_3:
 			crc_computed = CRC_INIT_3;
-			crc_table = decomp->crc_table_3;
+			crc_table = rohc_crc_table_3;
 			break;
 		case ROHC_CRC_TYPE_7:
 			crc_computed = CRC_INIT_7;
-			crc_table = decomp->crc_table_7;
+			crc_table = rohc_crc_table_7;
 			break;
 		case ROHC_CRC_TYPE_8:
 			rohc_decomp_warn(context, "unexpected CRC type %d", crc_type);
@@ -4073,9 +4401,12 @@ static bool d_tcp_check_uncomp_crc(const struct rohc_decomp *const decomp,
 	}
 
 	/* compute the CRC from built uncompressed headers */
+	rohc_cycles_crc_begin(&context->decompressor->stage_cycles);
 	crc_computed =
 		crc_calculate(crc_type, rohc_buf_data(*uncomp_hdrs), uncomp_hdrs->len,
 		              crc_computed, crc_table);
+	rohc_cycles_crc_end(&context->decompressor->stage_cycles,
+	                    ROHC_DECOMP_STAGE_CRC);
 	rohc_decomp_debug(context, "CRC-%d on uncompressed header = 0x%x",
 	                  crc_type, crc_computed);
 
@@ -4357,14 +4688,20 @@ const struct rohc_decomp_profile d_tcp_profile =
 {
 	.id              = ROHC_PROFILE_TCP, /* profile ID (see 8 in RFC3095) */
 	.msn_max_bits    = 16,
+	.extr_bits_size  = sizeof(struct rohc_tcp_extr_bits),
+	.decoded_values_size = sizeof(struct rohc_tcp_decoded_values),
 	.new_context     = (rohc_decomp_new_context_t) d_tcp_create,
 	.free_context    = (rohc_decomp_free_context_t) d_tcp_destroy,
+	.get_mem         = (rohc_decomp_get_mem_t) d_tcp_get_mem,
+	.reset_context   = (rohc_decomp_reset_context_t) d_tcp_reset,
 	.detect_pkt_type = tcp_detect_packet_type,
 	.parse_pkt       = (rohc_decomp_parse_pkt_t) d_tcp_parse_packet,
 	.decode_bits     = (rohc_decomp_decode_bits_t) d_tcp_decode_bits,
 	.build_hdrs      = (rohc_decomp_build_hdrs_t) d_tcp_build_hdrs,
 	.update_ctxt     = (rohc_decomp_update_ctxt_t) d_tcp_update_ctxt,
 	.attempt_repair  = (rohc_decomp_attempt_repair_t) d_tcp_attempt_repair,
-	.get_sn          = d_tcp_get_msn
+	.get_sn          = d_tcp_get_msn,
+	.snapshot        = (rohc_decomp_snapshot_t) d_tcp_snapshot,
+	.restore         = (rohc_decomp_restore_t) d_tcp_restore,
 };
 
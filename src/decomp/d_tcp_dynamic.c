@@ -30,6 +30,7 @@
 
 #include "d_tcp_defines.h"
 #include "d_tcp_opts_list.h"
+#include "rohc_decomp_reader.h"
 #include "rohc_utils.h"
 #include "protocols/ip_numbers.h"
 #include "schemes/rfc4996.h"
@@ -361,24 +362,24 @@ static int tcp_parse_dynamic_tcp(const struct rohc_decomp_ctxt *const context,
                                  struct rohc_tcp_extr_bits *const bits)
 {
 	const tcp_dynamic_t *tcp_dynamic;
-	const uint8_t *remain_data = rohc_packet;
-	size_t remain_len = rohc_length;
+	struct rohc_reader reader;
+	size_t var_len;
 	int ret;
 
 	rohc_decomp_debug(context, "parse TCP dynamic part");
+	rohc_reader_init(&reader, rohc_packet, rohc_length);
 
 	/* check the minimal length to decode the TCP dynamic part */
-	if(remain_len < sizeof(tcp_dynamic_t))
+	if(!rohc_reader_has(&reader, sizeof(tcp_dynamic_t)))
 	{
 		rohc_decomp_warn(context, "malformed TCP dynamic part: only %zu bytes "
 		                 "available while at least %zu bytes required for "
 		                 "mandatory fields of the TCP dynamic part",
-		                 remain_len, sizeof(tcp_dynamic_t));
+		                 rohc_length, sizeof(tcp_dynamic_t));
 		goto error;
 	}
-	tcp_dynamic = (tcp_dynamic_t *) remain_data;
-	remain_data += sizeof(tcp_dynamic_t);
-	remain_len -= sizeof(tcp_dynamic_t);
+	tcp_dynamic = (tcp_dynamic_t *) reader.data;
+	rohc_reader_skip(&reader, sizeof(tcp_dynamic_t));
 
 	rohc_decomp_debug(context, "TCP res_flags = %d, ecn_flags = %d, "
 	                  "rsf_flags = %d, URG = %d, ACK = %d, PSH = %d, ack_zero = %u",
@@ -387,6 +388,22 @@ static int tcp_parse_dynamic_tcp(const struct rohc_decomp_ctxt *const context,
 	                  tcp_dynamic->ack_flag, tcp_dynamic->psh_flag,
 	                  tcp_dynamic->ack_zero);
 
+	/* the mandatory fields tell the length of the next fields up to the
+	 * compressed list of TCP options: ACK number, window, checksum, URG
+	 * pointer and ACK stride */
+	var_len = (tcp_dynamic->ack_zero == 1 ? 0 : sizeof(uint32_t)) +
+	          sizeof(uint16_t) + sizeof(uint16_t) +
+	          (tcp_dynamic->urp_zero == 1 ? 0 : sizeof(uint16_t)) +
+	          (tcp_dynamic->ack_stride_flag == 1 ? sizeof(uint16_t) : 0);
+	if(!rohc_reader_has(&reader, var_len))
+	{
+		rohc_decomp_warn(context, "malformed TCP dynamic part: only %zu bytes "
+		                 "available while at least %zu bytes required for the "
+		                 "ACK number, window, checksum, URG pointer and ACK "
+		                 "stride", reader.len, var_len);
+		goto error;
+	}
+
 	/* retrieve the TCP flags from the ROHC packet */
 	bits->ecn_used_bits = tcp_dynamic->ecn_used;
 	bits->ecn_used_bits_nr = 1;
@@ -423,18 +440,8 @@ static int tcp_parse_dynamic_tcp(const struct rohc_decomp_ctxt *const context,
 	}
 	else
 	{
-		if(remain_len < sizeof(uint32_t))
-		{
-			rohc_decomp_warn(context, "malformed TCP dynamic part: only %zu "
-			                 "bytes available while at least %zu bytes required "
-			                 "for the ACK number", remain_len, sizeof(uint32_t));
-			goto error;
-		}
-		memcpy(&(bits->ack.bits), remain_data, sizeof(uint32_t));
-		bits->ack.bits = rohc_ntoh32(bits->ack.bits);
+		bits->ack.bits = rohc_reader_u32(&reader);
 		bits->ack.bits_nr = 32;
-		remain_data += sizeof(uint32_t);
-		remain_len -= sizeof(uint32_t);
 
 		if(bits->ack_flag_bits == 0)
 		{
@@ -446,32 +453,12 @@ static int tcp_parse_dynamic_tcp(const struct rohc_decomp_ctxt *const context,
 	                  bits->seq.bits, bits->ack.bits);
 
 	/* window */
-	if(remain_len < sizeof(uint16_t))
-	{
-		rohc_decomp_warn(context, "malformed TCP dynamic part: only %zu bytes "
-		                 "available while at least %zu bytes required for the "
-		                 "window", remain_len, sizeof(uint16_t));
-		goto error;
-	}
-	memcpy(&(bits->window.bits), remain_data, sizeof(uint16_t));
-	bits->window.bits = rohc_ntoh16(bits->window.bits);
+	bits->window.bits = rohc_reader_u16(&reader);
 	bits->window.bits_nr = 16;
-	remain_data += sizeof(uint16_t);
-	remain_len -= sizeof(uint16_t);
 	rohc_decomp_debug(context, "TCP window = 0x%04x", bits->window.bits);
 
 	/* checksum */
-	if(remain_len < sizeof(uint16_t))
-	{
-		rohc_decomp_warn(context, "malformed TCP dynamic part: only %zu bytes "
-		                 "available while at least %zu bytes required for the "
-		                 "checksum", remain_len, sizeof(uint16_t));
-		goto error;
-	}
-	memcpy(&(bits->tcp_check), remain_data, sizeof(uint16_t));
-	bits->tcp_check = rohc_ntoh16(bits->tcp_check);
-	remain_data += sizeof(uint16_t);
-	remain_len -= sizeof(uint16_t);
+	bits->tcp_check = rohc_reader_u16(&reader);
 	rohc_decomp_debug(context, "TCP checksum = 0x%04x", bits->tcp_check);
 
 	/* URG pointer */
@@ -482,37 +469,26 @@ static int tcp_parse_dynamic_tcp(const struct rohc_decomp_ctxt *const context,
 	}
 	else
 	{
-		if(remain_len < sizeof(uint16_t))
-		{
-			rohc_decomp_warn(context, "malformed TCP dynamic part: only %zu "
-			                 "bytes available while at least %zu bytes required "
-			                 "for the URG pointer", remain_len, sizeof(uint16_t));
-			goto error;
-		}
-		memcpy(&(bits->urg_ptr.bits), remain_data, sizeof(uint16_t));
-		bits->urg_ptr.bits = rohc_ntoh16(bits->urg_ptr.bits);
+		bits->urg_ptr.bits = rohc_reader_u16(&reader);
 		bits->urg_ptr.bits_nr = 16;
-		remain_data += sizeof(uint16_t);
-		remain_len -= sizeof(uint16_t);
 	}
 	rohc_decomp_debug(context, "TCP urg_ptr = 0x%04x", bits->urg_ptr.bits);
 
-	/* ACK stride */
-	ret = d_static_or_irreg16(remain_data, remain_len, tcp_dynamic->ack_stride_flag,
-	                          &bits->ack_stride);
-	if(ret < 0)
+	/* ACK stride =:= static_or_irreg(ack_stride_flag.CVALUE, 16) */
+	if(tcp_dynamic->ack_stride_flag == 1)
 	{
-		rohc_decomp_warn(context, "malformed TCP dynamic part: "
-		                 "static_or_irreg(ack_stride) failed");
-		goto error;
+		bits->ack_stride.bits = rohc_reader_u16(&reader);
+		bits->ack_stride.bits_nr = 16;
 	}
-	rohc_decomp_debug(context, "found %zu bits of ACK stride encoded on "
-	                  "%d bytes", bits->ack_stride.bits_nr, ret);
-	remain_data += ret;
-	remain_len -= ret;
+	else
+	{
+		bits->ack_stride.bits_nr = 0;
+	}
+	rohc_decomp_debug(context, "found %zu bits of ACK stride",
+	                  bits->ack_stride.bits_nr);
 
 	/* parse the compressed list of TCP options */
-	ret = d_tcp_parse_tcp_opts_list_item(context, remain_data, remain_len, true,
+	ret = d_tcp_parse_tcp_opts_list_item(context, reader.data, reader.len, true,
 	                                     &bits->tcp_opts);
 	if(ret < 0)
 	{
@@ -521,17 +497,12 @@ static int tcp_parse_dynamic_tcp(const struct rohc_decomp_ctxt *const context,
 		goto error;
 	}
 	rohc_decomp_debug(context, "compressed list of TCP options = %d bytes", ret);
-#ifndef __clang_analyzer__ /* silent warning about dead in/decrement */
-	remain_data += ret;
-#endif
-	remain_len -= ret;
+	rohc_reader_skip(&reader, ret);
 
-	assert(remain_len <= rohc_length);
 	rohc_decomp_dump_buf(context, "TCP dynamic part",
-	                     (const uint8_t *const ) tcp_dynamic,
-	                     rohc_length - remain_len);
+	                     (const uint8_t *const ) tcp_dynamic, reader.read_len);
 
-	return (rohc_length - remain_len);
+	return reader.read_len;
 
 error:
 	return -1;
@@ -30,6 +30,7 @@
 
 #include "d_tcp_defines.h"
 #include "d_tcp_opts_list.h"
+#include "rohc_decomp_reader.h"
 #include "rohc_utils.h"
 
 #ifndef __KERNEL__
@@ -109,9 +110,24 @@ bool tcp_parse_irreg_chain(const struct rohc_decomp_ctxt *const context,
 	rohc_decomp_debug(context, "parse the irregular chain with ecn_used = %d",
 	                  d_tcp_is_ecn_used(*tcp_context, *bits));
 
+	/* the IP part of the irregular chain is empty for the usual IPv4/TCP and
+	 * IPv6/TCP streams: the innermost IP header transmits its ECN flags in the
+	 * TCP part, only a random IPv4 IP-ID remains */
+	if(tcp_context->ip_contexts_nr == 1 &&
+	   (tcp_context->ip_contexts[0].ctxt.vx.version != IPV4 ||
+	    innermost_ip_id_behavior != IP_ID_BEHAVIOR_RAND))
+	{
+		ip_inner_context = &(tcp_context->ip_contexts[0]);
+		ip_inner_bits = &(bits->ip[0]);
+		ip_contexts_nr = 1;
+	}
+	else
+	{
+		ip_contexts_nr = 0;
+	}
+
 	/* parse irregular IP part (IPv4/IPv6 headers and extension headers) */
-	for(ip_contexts_nr = 0; ip_contexts_nr < tcp_context->ip_contexts_nr;
-	    ip_contexts_nr++)
+	for(; ip_contexts_nr < tcp_context->ip_contexts_nr; ip_contexts_nr++)
 	{
 		const ip_context_t *const ip_context =
 			&(tcp_context->ip_contexts[ip_contexts_nr]);
@@ -250,32 +266,35 @@ static int tcp_parse_irregular_ipv4(const struct rohc_decomp_ctxt *const context
                                     struct rohc_tcp_extr_ip_bits *const ip_bits)
 {
 	const struct d_tcp_context *const tcp_context = context->persist_ctxt;
-	const uint8_t *remain_data;
-	size_t remain_len;
+	const bool is_ecn_used = d_tcp_is_ecn_used(*tcp_context, *bits);
+	struct rohc_reader reader;
+	size_t irreg_len = 0;
 
-	remain_data = rohc_data;
-	remain_len = rohc_data_len;
+	/* the length of the IPv4 part is given by the flags already known */
+	if(ip_id_behavior == IP_ID_BEHAVIOR_RAND)
+	{
+		irreg_len += sizeof(uint16_t);
+	}
+	if(!is_innermost)
+	{
+		irreg_len += (is_ecn_used ? 1 : 0) + (bits->ttl_irreg_chain_flag ? 1 : 0);
+	}
+	rohc_reader_init(&reader, rohc_data, rohc_data_len);
+	if(!rohc_reader_has(&reader, irreg_len))
+	{
+		rohc_decomp_warn(context, "packet too short for the IPv4 part of the "
+		                 "irregular chain: only %zu bytes available while at "
+		                 "least %zu bytes required", rohc_data_len, irreg_len);
+		goto error;
+	}
 
 	/* ip_id =:= ip_id_enc_irreg( ip_id_behavior.UVALUE ) */
 	if(ip_id_behavior == IP_ID_BEHAVIOR_RAND)
 	{
-		uint16_t ip_id;
-
-		if(remain_len < sizeof(uint16_t))
-		{
-			rohc_decomp_warn(context, "packet too short for random IP-ID: only "
-			                 "%zu bytes available while at least %zu bytes "
-			                 "required", remain_len, sizeof(uint16_t));
-			goto error;
-		}
-		memcpy(&ip_id, remain_data, sizeof(uint16_t));
-		remain_data += sizeof(uint16_t);
-		remain_len -= sizeof(uint16_t);
-		rohc_decomp_debug(context, "read ip_id = 0x%04x (ip_id_behavior = %d)",
-		                  ip_id, ip_id_behavior);
-		ip_bits->id.bits = rohc_ntoh16(ip_id);
+		ip_bits->id.bits = rohc_reader_u16(&reader);
 		ip_bits->id.bits_nr = 16;
-		rohc_decomp_debug(context, "new IP-ID = 0x%04x", ip_bits->id.bits);
+		rohc_decomp_debug(context, "new IP-ID = 0x%04x (ip_id_behavior = %d)",
+		                  ip_bits->id.bits, ip_id_behavior);
 	}
 
 	if(is_innermost)
@@ -288,20 +307,14 @@ static int tcp_parse_irregular_ipv4(const struct rohc_decomp_ctxt *const context
 	/* ipv4_outer_with_ttl_irregular or ipv4_outer_without_ttl_irregular */
 
 	/* parse DSCP and ECN flags if present */
-	if(d_tcp_is_ecn_used(*tcp_context, *bits))
+	if(is_ecn_used)
 	{
-		if(remain_len < 1)
-		{
-			rohc_decomp_warn(context, "packet too short for DSCP/ECN: only %zu bytes "
-			                 "available while at least 1 byte required", remain_len);
-			goto error;
-		}
-		ip_bits->dscp_bits = (remain_data[0] >> 2) & 0x3f;
+		const uint8_t dscp_ecn = rohc_reader_u8(&reader);
+
+		ip_bits->dscp_bits = (dscp_ecn >> 2) & 0x3f;
 		ip_bits->dscp_bits_nr = 6;
-		ip_bits->ecn_flags_bits = (remain_data[0] & 0x03);
+		ip_bits->ecn_flags_bits = (dscp_ecn & 0x03);
 		ip_bits->ecn_flags_bits_nr = 2;
-		remain_data++;
-		remain_len--;
 		rohc_decomp_debug(context, "read DSCP = 0x%x, ip_ecn_flags = %d",
 		                  ip_bits->dscp_bits, ip_bits->ecn_flags_bits);
 	}
@@ -309,21 +322,13 @@ static int tcp_parse_irregular_ipv4(const struct rohc_decomp_ctxt *const context
 	/* parse TTL/HL if present */
 	if(bits->ttl_irreg_chain_flag)
 	{
-		if(remain_len < 1)
-		{
-			rohc_decomp_warn(context, "packet too short for TTL/HL: only %zu bytes "
-			                 "available while at least 1 byte required", remain_len);
-			goto error;
-		}
-		ip_bits->ttl_hl.bits = remain_data[0];
+		ip_bits->ttl_hl.bits = rohc_reader_u8(&reader);
 		ip_bits->ttl_hl.bits_nr = 8;
-		remain_data++;
-		remain_len--;
 		rohc_decomp_debug(context, "ttl_hopl = 0x%02x", ip_bits->ttl_hl.bits);
 	}
 
 skip:
-	return (remain_data - rohc_data);
+	return reader.read_len;
 
 error:
 	return -1;
@@ -352,11 +357,11 @@ static int tcp_parse_irregular_ipv6(const struct rohc_decomp_ctxt *const context
                                     struct rohc_tcp_extr_ip_bits *const ip_bits)
 {
 	const struct d_tcp_context *const tcp_context = context->persist_ctxt;
-	const uint8_t *remain_data;
-	size_t remain_len;
+	const bool is_ecn_used = d_tcp_is_ecn_used(*tcp_context, *bits);
+	struct rohc_reader reader;
+	size_t irreg_len;
 
-	remain_data = rohc_data;
-	remain_len = rohc_data_len;
+	rohc_reader_init(&reader, rohc_data, rohc_data_len);
 
 	if(is_innermost)
 	{
@@ -367,21 +372,25 @@ static int tcp_parse_irregular_ipv6(const struct rohc_decomp_ctxt *const context
 
 	/* ipv6_outer_without_ttl_irregular or ipv6_outer_with_ttl_irregular */
 
+	/* the length of the IPv6 part is given by the flags already known */
+	irreg_len = (is_ecn_used ? 1 : 0) + (bits->ttl_irreg_chain_flag ? 1 : 0);
+	if(!rohc_reader_has(&reader, irreg_len))
+	{
+		rohc_decomp_warn(context, "packet too short for the IPv6 part of the "
+		                 "irregular chain: only %zu bytes available while at "
+		                 "least %zu bytes required", rohc_data_len, irreg_len);
+		goto error;
+	}
+
 	/* parse DSCP and ECN flags if present */
-	if(d_tcp_is_ecn_used(*tcp_context, *bits))
+	if(is_ecn_used)
 	{
-		if(remain_len < 1)
-		{
-			rohc_decomp_warn(context, "packet too short for DSCP/ECN: only %zu bytes "
-			                 "available while at least 1 byte required", remain_len);
-			goto error;
-		}
-		ip_bits->dscp_bits = (remain_data[0] >> 2) & 0x3f;
+		const uint8_t dscp_ecn = rohc_reader_u8(&reader);
+
+		ip_bits->dscp_bits = (dscp_ecn >> 2) & 0x3f;
 		ip_bits->dscp_bits_nr = 6;
-		ip_bits->ecn_flags_bits = (remain_data[0] & 0x03);
+		ip_bits->ecn_flags_bits = (dscp_ecn & 0x03);
 		ip_bits->ecn_flags_bits_nr = 2;
-		remain_data++;
-		remain_len--;
 		rohc_decomp_debug(context, "read DSCP = 0x%x, ip_ecn_flags = %d",
 		                  ip_bits->dscp_bits, ip_bits->ecn_flags_bits);
 	}
@@ -389,21 +398,13 @@ static int tcp_parse_irregular_ipv6(const struct rohc_decomp_ctxt *const context
 	/* parse TTL/HL if present */
 	if(bits->ttl_irreg_chain_flag)
 	{
-		if(remain_len < 1)
-		{
-			rohc_decomp_warn(context, "packet too short for TTL/HL: only %zu bytes "
-			                 "available while at least 1 byte required", remain_len);
-			goto error;
-		}
-		ip_bits->ttl_hl.bits = remain_data[0];
+		ip_bits->ttl_hl.bits = rohc_reader_u8(&reader);
 		ip_bits->ttl_hl.bits_nr = 8;
-		remain_data++;
-		remain_len--;
 		rohc_decomp_debug(context, "ttl_hopl = 0x%02x", ip_bits->ttl_hl.bits);
 	}
 
 skip:
-	return (remain_data - rohc_data);
+	return reader.read_len;
 
 error:
 	return -1;
@@ -432,54 +433,49 @@ static int tcp_parse_irregular_tcp(const struct rohc_decomp_ctxt *const context,
                                    struct rohc_tcp_extr_ip_bits *const ip_inner_bits)
 {
 	const struct d_tcp_context *const tcp_context = context->persist_ctxt;
-	const uint8_t *remain_data = rohc_data;
-	size_t remain_len = rohc_data_len;
+	const bool is_ecn_used = d_tcp_is_ecn_used(*tcp_context, *bits);
+	const size_t irreg_len = (is_ecn_used ? 1 : 0) + sizeof(uint16_t);
+	struct rohc_reader reader;
 	int ret;
 
 	rohc_decomp_debug(context, "decode TCP irregular chain");
 
+	/* the ECN flags and the TCP checksum come before the TCP options */
+	rohc_reader_init(&reader, rohc_data, rohc_data_len);
+	if(!rohc_reader_has(&reader, irreg_len))
+	{
+		rohc_decomp_warn(context, "packet too short for the TCP part of the "
+		                 "irregular chain: only %zu bytes available while at "
+		                 "least %zu bytes required", rohc_data_len, irreg_len);
+		goto error;
+	}
+
 	/* parse IP ECN flags, RES flags, and TCP ECN flags if present */
-	if(d_tcp_is_ecn_used(*tcp_context, *bits))
+	if(is_ecn_used)
 	{
-		if(remain_len < 1)
-		{
-			rohc_decomp_warn(context, "packet too short for ECN: only %zu bytes "
-			                 "available while at least 1 byte required", remain_len);
-			goto error;
-		}
+		const uint8_t ecn_flags = rohc_reader_u8(&reader);
+
 		/* innermost IP ECN flags */
-		ip_inner_bits->ecn_flags_bits = (remain_data[0] >> 6) & 0x3;
+		ip_inner_bits->ecn_flags_bits = (ecn_flags >> 6) & 0x3;
 		ip_inner_bits->ecn_flags_bits_nr = 2;
 		rohc_decomp_debug(context, "inner IP ECN flags = 0x%x",
 		                  ip_inner_bits->ecn_flags_bits);
 		/* TCP RES flags */
-		bits->res_flags_bits = (remain_data[0] >> 2) & 0x0f;
+		bits->res_flags_bits = (ecn_flags >> 2) & 0x0f;
 		bits->res_flags_bits_nr = 4;
 		rohc_decomp_debug(context, "TCP RES flags = 0x%x", bits->res_flags_bits);
 		/* TCP ECN flags */
-		bits->ecn_flags_bits = remain_data[0] & 0x03;
+		bits->ecn_flags_bits = ecn_flags & 0x03;
 		bits->ecn_flags_bits_nr = 2;
 		rohc_decomp_debug(context, "TCP ECN flags = 0x%x", bits->ecn_flags_bits);
-		remain_data++;
-		remain_len--;
 	}
 
 	/* parse TCP checksum */
-	if(remain_len < sizeof(uint16_t))
-	{
-		rohc_decomp_warn(context, "packet too short for TCP checksum: only %zu "
-		                 "bytes available while at least %zu bytes required",
-		                 remain_len, sizeof(uint16_t));
-		goto error;
-	}
-	memcpy(&bits->tcp_check, remain_data, sizeof(uint16_t));
-	bits->tcp_check = rohc_ntoh16(bits->tcp_check);
-	remain_data += sizeof(uint16_t);
-	remain_len -= sizeof(uint16_t);
+	bits->tcp_check = rohc_reader_u16(&reader);
 	rohc_decomp_debug(context, "TCP checksum = 0x%04x", bits->tcp_check);
 
 	/* complete TCP options with the irregular part */
-	ret = d_tcp_parse_tcp_opts_irreg(context, remain_data, remain_len,
+	ret = d_tcp_parse_tcp_opts_irreg(context, reader.data, reader.len,
 	                                 &bits->tcp_opts);
 	if(ret < 0)
 	{
@@ -488,15 +484,12 @@ static int tcp_parse_irregular_tcp(const struct rohc_decomp_ctxt *const context,
 		goto error;
 	}
 	rohc_decomp_debug(context, "compressed list of TCP options = %d bytes", ret);
-#ifndef __clang_analyzer__ /* silent warning about dead in/decrement */
-	remain_data += ret;
-#endif
-	remain_len -= ret;
+	rohc_reader_skip(&reader, ret);
 
 	rohc_decomp_dump_buf(context, "TCP irregular part", rohc_data,
-	                     rohc_data_len - remain_len);
+	                     reader.read_len);
 
-	return (rohc_data_len - remain_len);
+	return reader.read_len;
 
 error:
 	return -1;
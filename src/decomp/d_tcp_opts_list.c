@@ -49,12 +49,18 @@ struct d_tcp_opt_index /* TODO */
 };
 
 
-struct d_tcp_opt /* TODO */
+/**
+ * @brief The handlers of one TCP option index
+ *
+ * The handlers are found in one lookup in \ref d_tcp_opts for every option of
+ * the compressed list and the irregular chain, so keep the entries small.
+ */
+struct d_tcp_opt
 {
-	uint8_t index;
-	bool is_well_known;
-	uint8_t kind;
-	char descr[255];
+	uint8_t index;        /**< The index of the TCP option in the list */
+	bool is_well_known;   /**< Whether the index is for a well-known option */
+	uint8_t kind;         /**< The type of the well-known TCP option */
+	const char *descr;    /**< The description of the TCP option */
 	int (*parse_list_item)(const struct rohc_decomp_ctxt *const context,
 	                       const uint8_t *const data,
 	                       const size_t data_len,
@@ -255,8 +261,8 @@ static bool d_tcp_build_generic(const struct rohc_decomp_ctxt *const context,
 	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4, 5)));
 
 
-/* TODO */
-static struct d_tcp_opt d_tcp_opts[MAX_TCP_OPTION_INDEX + 1] =
+/** The handlers of the TCP options, indexed by their index in the list */
+static const struct d_tcp_opt d_tcp_opts[MAX_TCP_OPTION_INDEX + 1] =
 {
 	[TCP_INDEX_NOP]       = { TCP_INDEX_NOP, true, TCP_OPT_NOP,
 	                          "No Operation (NOP)",
@@ -69,6 +69,20 @@ static void d_udp_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
                           const struct rohc_decomp_volat_ctxt *const volat_ctxt)
 	__attribute__((nonnull(1, 2)));
 
+static void d_udp_get_mem(const struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
+                          struct rohc_ctxt_mem *const mem)
+	__attribute__((nonnull(1, 2)));
+
+static bool d_udp_snapshot(const struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
+                           const rohc_snapshot_write_t write_cb,
+                           void *const priv)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
+static bool d_udp_restore(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
+                          const rohc_snapshot_read_t read_cb,
+                          void *const priv)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
 static int udp_parse_dynamic_udp(const struct rohc_decomp_ctxt *const context,
                                  const uint8_t *packet,
                                  const size_t length,
@@ -93,6 +107,17 @@ static void udp_update_context(struct rohc_decomp_ctxt *const context,
                                const struct rohc_decoded_values *const decoded)
 	__attribute__((nonnull(1)));
 
+static bool udp_decode_tmpl_udp(const struct rohc_decomp_ctxt *const context,
+                                const struct rohc_extr_bits *const bits,
+                                struct rohc_decoded_values *const decoded)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+
+static void udp_patch_tmpl_udp(const struct rohc_decomp_ctxt *const context,
+                               const struct rohc_decoded_values *const decoded,
+                               uint8_t *const next_hdr,
+                               const size_t payload_len)
+	__attribute__((nonnull(1, 2, 3)));
+
 
 /**
  * @brief Create the UDP decompression context.
@@ -165,39 +190,18 @@ static bool d_udp_create(const struct rohc_decomp_ctxt *const context,
 	rfc3095_ctxt->compute_crc_static = udp_compute_crc_static;
 	rfc3095_ctxt->compute_crc_dynamic = udp_compute_crc_dynamic;
 	rfc3095_ctxt->update_context = udp_update_context;
+	rfc3095_ctxt->decode_tmpl_next_hdr = udp_decode_tmpl_udp;
+	rfc3095_ctxt->patch_tmpl_next_hdr = udp_patch_tmpl_udp;
 
-	/* create the UDP-specific part of the header changes */
+	/* the UDP-specific part of the header changes is stored in the context */
 	rfc3095_ctxt->outer_ip_changes->next_header_len = sizeof(struct udphdr);
-	rfc3095_ctxt->outer_ip_changes->next_header = malloc(sizeof(struct udphdr));
-	if(rfc3095_ctxt->outer_ip_changes->next_header == NULL)
-	{
-		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
-		           "cannot allocate memory for the UDP-specific part of the "
-		           "outer IP header changes");
-		goto free_lsb_sn;
-	}
-	memset(rfc3095_ctxt->outer_ip_changes->next_header, 0, sizeof(struct udphdr));
-
 	rfc3095_ctxt->inner_ip_changes->next_header_len = sizeof(struct udphdr);
-	rfc3095_ctxt->inner_ip_changes->next_header = malloc(sizeof(struct udphdr));
-	if(rfc3095_ctxt->inner_ip_changes->next_header == NULL)
-	{
-		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
-		           "cannot allocate memory for the UDP-specific part of the "
-		           "inner IP header changes");
-		goto free_outer_ip_changes_next_header;
-	}
-	memset(rfc3095_ctxt->inner_ip_changes->next_header, 0, sizeof(struct udphdr));
 
 	/* set next header to UDP */
 	rfc3095_ctxt->next_header_proto = ROHC_IPPROTO_UDP;
 
 	return true;
 
-free_outer_ip_changes_next_header:
-	zfree(rfc3095_ctxt->outer_ip_changes->next_header);
-free_lsb_sn:
-	rohc_lsb_free(rfc3095_ctxt->sn_lsb_ctxt);
 free_udp_context:
 	zfree(udp_context);
 destroy_context:
@@ -219,12 +223,6 @@ quit:
 static void d_udp_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
                           const struct rohc_decomp_volat_ctxt *const volat_ctxt)
 {
-	/* clean UDP-specific memory */
-	assert(rfc3095_ctxt->outer_ip_changes != NULL);
-	zfree(rfc3095_ctxt->outer_ip_changes->next_header);
-	assert(rfc3095_ctxt->inner_ip_changes != NULL);
-	zfree(rfc3095_ctxt->inner_ip_changes->next_header);
-
 	/* destroy the LSB decoding context for SN */
 	rohc_lsb_free(rfc3095_ctxt->sn_lsb_ctxt);
 
@@ -233,6 +231,62 @@ static void d_udp_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
 }
 
 
+/**
+ * @brief Get the memory used by one UDP context
+ *
+ * @param rfc3095_ctxt  The persistent decompression context for the RFC3095 profiles
+ * @param[out] mem      The memory used by the context
+ */
+static void d_udp_get_mem(const struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
+                          struct rohc_ctxt_mem *const mem)
+{
+	rohc_decomp_rfc3095_get_mem(rfc3095_ctxt, mem);
+
+	/* the UDP-specific part of the context */
+	mem->bytes += sizeof(struct d_udp_context);
+}
+
+
+/**
+ * @brief Save one UDP context in a snapshot
+ *
+ * @param rfc3095_ctxt  The persistent decompression context for the RFC3095 profiles
+ * @param write_cb      The callback used to write the snapshot
+ * @param priv          The private context given to the callback
+ * @return              true if the context was successfully saved,
+ *                      false if the callback failed
+ */
+static bool d_udp_snapshot(const struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
+                           const rohc_snapshot_write_t write_cb,
+                           void *const priv)
+{
+	/* the UDP-specific part of the context holds no pointer */
+	return (rohc_decomp_rfc3095_snapshot(rfc3095_ctxt, write_cb, priv) &&
+	        write_cb(priv, rfc3095_ctxt->specific,
+	                 sizeof(struct d_udp_context)));
+}
+
+
+/**
+ * @brief Restore one UDP context from a snapshot
+ *
+ * @param rfc3095_ctxt  The persistent decompression context for the RFC3095 profiles
+ * @param read_cb       The callback used to read the snapshot
+ * @param priv          The private context given to the callback
+ * @return              true if the context was successfully restored,
+ *                      false if the snapshot does not match or the callback
+ *                      failed
+ */
+static bool d_udp_restore(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
+                          const rohc_snapshot_read_t read_cb,
+                          void *const priv)
+{
+	return (rohc_decomp_rfc3095_restore(rfc3095_ctxt, read_cb, priv) &&
+	        read_cb(priv, rfc3095_ctxt->specific,
+	                sizeof(struct d_udp_context)));
+}
+
+
 /**
  * @brief Parse the UDP static part of the ROHC packet.
  *
@@ -449,7 +503,6 @@ static bool udp_decode_values_from_bits(const struct rohc_decomp_ctxt *context,
 	assert(decoded != NULL);
 
 	assert(rfc3095_ctxt->outer_ip_changes != NULL);
-	assert(rfc3095_ctxt->outer_ip_changes->next_header != NULL);
 	udp = (struct udphdr *) rfc3095_ctxt->outer_ip_changes->next_header;
 
 	/* decode UDP source port */
@@ -582,7 +635,6 @@ static void udp_update_context(struct rohc_decomp_ctxt *const context,
 	struct udphdr *udp;
 
 	assert(rfc3095_ctxt->outer_ip_changes != NULL);
-	assert(rfc3095_ctxt->outer_ip_changes->next_header != NULL);
 	udp = (struct udphdr *) rfc3095_ctxt->outer_ip_changes->next_header;
 	udp->source = decoded->udp_src;
 	udp->dest = decoded->udp_dst;
@@ -597,6 +649,61 @@ static void udp_update_context(struct rohc_decomp_ctxt *const context,
 }
 
 
+/**
+ * @brief Decode the UDP checksum of one UO* packet for the template of headers
+ *
+ * @param context  The decompression context
+ * @param bits     The bits extracted from the UO* packet
+ * @param decoded  OUT: The corresponding decoded values
+ * @return         true if decoding is successful, false otherwise
+ */
+static bool udp_decode_tmpl_udp(const struct rohc_decomp_ctxt *const context,
+                                const struct rohc_extr_bits *const bits,
+                                struct rohc_decoded_values *const decoded)
+{
+	const struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt =
+		context->persist_ctxt;
+	const struct d_udp_context *const udp_context = rfc3095_ctxt->specific;
+
+	/* the UDP checksum behavior is known, otherwise the UO* remainder could
+	 * not be parsed */
+	if(udp_context->udp_check_present == ROHC_TRISTATE_YES)
+	{
+		assert(bits->udp_check_nr == 16);
+		decoded->udp_check = bits->udp_check;
+	}
+	else
+	{
+		decoded->udp_check = 0;
+	}
+	rohc_decomp_debug(context, "decoded UDP checksum = 0x%04x",
+	                  rohc_ntoh16(decoded->udp_check));
+
+	return true;
+}
+
+
+/**
+ * @brief Patch the UDP header of the template of headers
+ *
+ * @param context      The decompression context
+ * @param decoded      The values decoded from the UO* packet
+ * @param next_hdr     The UDP header to patch
+ * @param payload_len  The length of the UDP payload
+ */
+static void udp_patch_tmpl_udp(const struct rohc_decomp_ctxt *const context,
+                               const struct rohc_decoded_values *const decoded,
+                               uint8_t *const next_hdr,
+                               const size_t payload_len)
+{
+	struct udphdr *const udp = (struct udphdr *) next_hdr;
+
+	udp->check = decoded->udp_check;
+	udp->len = rohc_hton16(payload_len + sizeof(struct udphdr));
+	rohc_decomp_debug(context, "UDP length = 0x%04x", rohc_ntoh16(udp->len));
+}
+
+
 /**
  * @brief Define the decompression part of the UDP profile as described
  *        in the RFC 3095.
@@ -605,8 +712,11 @@ const struct rohc_decomp_profile d_udp_profile =
 {
 	.id              = ROHC_PROFILE_UDP, /* profile ID (see 8 in RFC3095) */
 	.msn_max_bits    = 16,
+	.extr_bits_size  = sizeof(struct rohc_extr_bits),
+	.decoded_values_size = sizeof(struct rohc_decoded_values),
 	.new_context     = (rohc_decomp_new_context_t) d_udp_create,
 	.free_context    = (rohc_decomp_free_context_t) d_udp_destroy,
+	.get_mem         = (rohc_decomp_get_mem_t) d_udp_get_mem,
 	.detect_pkt_type = ip_detect_packet_type,
 	.parse_pkt       = (rohc_decomp_parse_pkt_t) rfc3095_decomp_parse_pkt,
 	.decode_bits     = (rohc_decomp_decode_bits_t) rfc3095_decomp_decode_bits,
@@ -614,5 +724,7 @@ const struct rohc_decomp_profile d_udp_profile =
 	.update_ctxt     = (rohc_decomp_update_ctxt_t) rfc3095_decomp_update_ctxt,
 	.attempt_repair  = (rohc_decomp_attempt_repair_t) rfc3095_decomp_attempt_repair,
 	.get_sn          = rohc_decomp_rfc3095_get_sn,
+	.snapshot        = (rohc_decomp_snapshot_t) d_udp_snapshot,
+	.restore         = (rohc_decomp_restore_t) d_udp_restore,
 };
 
@@ -80,6 +80,20 @@ static void d_udp_lite_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ct
                                const struct rohc_decomp_volat_ctxt *const volat_ctxt)
 	__attribute__((nonnull(1, 2)));
 
+static void d_udp_lite_get_mem(const struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
+                               struct rohc_ctxt_mem *const mem)
+	__attribute__((nonnull(1, 2)));
+
+static bool d_udp_lite_snapshot(const struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
+                                const rohc_snapshot_write_t write_cb,
+                                void *const priv)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
+static bool d_udp_lite_restore(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
+                               const rohc_snapshot_read_t read_cb,
+                               void *const priv)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
 static rohc_packet_t udp_lite_detect_packet_type(const struct rohc_decomp_ctxt *const context,
                                                  const uint8_t *const rohc_packet,
                                                  const size_t rohc_length,
@@ -197,38 +211,15 @@ static bool d_udp_lite_create(const struct rohc_decomp_ctxt *const context,
 	rfc3095_ctxt->compute_crc_dynamic = udp_compute_crc_dynamic;
 	rfc3095_ctxt->update_context = udp_lite_update_context;
 
-	/* create the UDP-Lite-specific part of the header changes */
+	/* the UDP-Lite-specific part of the header changes is stored in the context */
 	rfc3095_ctxt->outer_ip_changes->next_header_len = sizeof(struct udphdr);
-	rfc3095_ctxt->outer_ip_changes->next_header = malloc(sizeof(struct udphdr));
-	if(rfc3095_ctxt->outer_ip_changes->next_header == NULL)
-	{
-		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
-		           "cannot allocate memory for the UDP-Lite-specific part "
-		           "of the outer IP header changes");
-		goto free_lsb_sn;
-	}
-	memset(rfc3095_ctxt->outer_ip_changes->next_header, 0, sizeof(struct udphdr));
-
 	rfc3095_ctxt->inner_ip_changes->next_header_len = sizeof(struct udphdr);
-	rfc3095_ctxt->inner_ip_changes->next_header = malloc(sizeof(struct udphdr));
-	if(rfc3095_ctxt->inner_ip_changes->next_header == NULL)
-	{
-		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
-		           "cannot allocate memory for the UDP-Lite-specific part "
-		           "of the inner IP header changes");
-		goto free_outer_ip_changes_next_header;
-	}
-	memset(rfc3095_ctxt->inner_ip_changes->next_header, 0, sizeof(struct udphdr));
 
 	/* set next header to UDP-Lite */
 	rfc3095_ctxt->next_header_proto = ROHC_IPPROTO_UDPLITE;
 
 	return true;
 
-free_outer_ip_changes_next_header:
-	zfree(rfc3095_ctxt->outer_ip_changes->next_header);
-free_lsb_sn:
-	rohc_lsb_free(rfc3095_ctxt->sn_lsb_ctxt);
 free_udp_context:
 	zfree(udp_lite_context);
 destroy_context:
@@ -250,12 +241,6 @@ quit:
 static void d_udp_lite_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
                                const struct rohc_decomp_volat_ctxt *const volat_ctxt)
 {
-	/* clean UDP-specific memory */
-	assert(rfc3095_ctxt->outer_ip_changes != NULL);
-	zfree(rfc3095_ctxt->outer_ip_changes->next_header);
-	assert(rfc3095_ctxt->inner_ip_changes != NULL);
-	zfree(rfc3095_ctxt->inner_ip_changes->next_header);
-
 	/* destroy the LSB decoding context for SN */
 	rohc_lsb_free(rfc3095_ctxt->sn_lsb_ctxt);
 
@@ -264,6 +249,62 @@ static void d_udp_lite_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ct
 }
 
 
+/**
+ * @brief Get the memory used by one UDP-Lite context
+ *
+ * @param rfc3095_ctxt  The persistent decompression context for the RFC3095 profiles
+ * @param[out] mem      The memory used by the context
+ */
+static void d_udp_lite_get_mem(const struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
+                               struct rohc_ctxt_mem *const mem)
+{
+	rohc_decomp_rfc3095_get_mem(rfc3095_ctxt, mem);
+
+	/* the UDP-Lite-specific part of the context */
+	mem->bytes += sizeof(struct d_udp_lite_context);
+}
+
+
+/**
+ * @brief Save one UDP-Lite context in a snapshot
+ *
+ * @param rfc3095_ctxt  The persistent decompression context for the RFC3095 profiles
+ * @param write_cb      The callback used to write the snapshot
+ * @param priv          The private context given to the callback
+ * @return              true if the context was successfully saved,
+ *                      false if the callback failed
+ */
+static bool d_udp_lite_snapshot(const struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
+                                const rohc_snapshot_write_t write_cb,
+                                void *const priv)
+{
+	/* the UDP-Lite-specific part of the context holds no pointer */
+	return (rohc_decomp_rfc3095_snapshot(rfc3095_ctxt, write_cb, priv) &&
+	        write_cb(priv, rfc3095_ctxt->specific,
+	                 sizeof(struct d_udp_lite_context)));
+}
+
+
+/**
+ * @brief Restore one UDP-Lite context from a snapshot
+ *
+ * @param rfc3095_ctxt  The persistent decompression context for the RFC3095 profiles
+ * @param read_cb       The callback used to read the snapshot
+ * @param priv          The private context given to the callback
+ * @return              true if the context was successfully restored,
+ *                      false if the snapshot does not match or the callback
+ *                      failed
+ */
+static bool d_udp_lite_restore(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
+                               const rohc_snapshot_read_t read_cb,
+                               void *const priv)
+{
+	return (rohc_decomp_rfc3095_restore(rfc3095_ctxt, read_cb, priv) &&
+	        read_cb(priv, rfc3095_ctxt->specific,
+	                sizeof(struct d_udp_lite_context)));
+}
+
+
 /**
  * @brief Detect the type of ROHC packet for the UDP-Lite profile
  *
@@ -767,7 +808,6 @@ static void udp_lite_update_context(struct rohc_decomp_ctxt *const context,
 	struct udphdr *udp;
 
 	assert(rfc3095_ctxt->outer_ip_changes != NULL);
-	assert(rfc3095_ctxt->outer_ip_changes->next_header != NULL);
 	udp = (struct udphdr *) rfc3095_ctxt->outer_ip_changes->next_header;
 	udp->source = decoded->udp_src;
 	udp->dest = decoded->udp_dst;
@@ -796,8 +836,11 @@ const struct rohc_decomp_profile d_udplite_profile =
 {
 	.id              = ROHC_PROFILE_UDPLITE, /* profile ID (RFC 4019, §7) */
 	.msn_max_bits    = 16,
+	.extr_bits_size  = sizeof(struct rohc_extr_bits),
+	.decoded_values_size = sizeof(struct rohc_decoded_values),
 	.new_context     = (rohc_decomp_new_context_t) d_udp_lite_create,
 	.free_context    = (rohc_decomp_free_context_t) d_udp_lite_destroy,
+	.get_mem         = (rohc_decomp_get_mem_t) d_udp_lite_get_mem,
 	.detect_pkt_type = udp_lite_detect_packet_type,
 	.parse_pkt       = (rohc_decomp_parse_pkt_t) d_udp_lite_parse,
 	.decode_bits     = (rohc_decomp_decode_bits_t) rfc3095_decomp_decode_bits,
@@ -805,5 +848,7 @@ const struct rohc_decomp_profile d_udplite_profile =
 	.update_ctxt     = (rohc_decomp_update_ctxt_t) rfc3095_decomp_update_ctxt,
 	.attempt_repair  = (rohc_decomp_attempt_repair_t) rfc3095_decomp_attempt_repair,
 	.get_sn          = rohc_decomp_rfc3095_get_sn,
+	.snapshot        = (rohc_decomp_snapshot_t) d_udp_lite_snapshot,
+	.restore         = (rohc_decomp_restore_t) d_udp_lite_restore,
 };
 
@@ -69,6 +69,20 @@ static void uncomp_free_context(void *const persist_ctxt,
                                 const struct rohc_decomp_volat_ctxt *const volat_ctxt)
 	__attribute__((nonnull(2)));
 
+static void uncomp_reset_context(const struct rohc_decomp_ctxt *const context,
+                                 void *const persist_ctxt,
+                                 struct rohc_decomp_volat_ctxt *const volat_ctxt)
+	__attribute__((nonnull(1, 3)));
+
+static bool uncomp_snapshot(const void *const persist_ctxt,
+                            const rohc_snapshot_write_t write_cb,
+                            void *const priv)
+	__attribute__((warn_unused_result, nonnull(2)));
+static bool uncomp_restore(void *const persist_ctxt,
+                           const rohc_snapshot_read_t read_cb,
+                           void *const priv)
+	__attribute__((warn_unused_result, nonnull(2)));
+
 static rohc_packet_t uncomp_detect_pkt_type(const struct rohc_decomp_ctxt *const context,
                                             const uint8_t *const rohc_packet,
                                             const size_t rohc_length,
@@ -116,6 +130,14 @@ static rohc_status_t uncomp_build_hdrs(const struct rohc_decomp *const decomp,
                                        size_t *const uncomp_hdrs_len)
 	__attribute__((warn_unused_result, nonnull(1, 2, 4, 5, 7, 8)));
 
+static rohc_status_t uncomp_decode_normal(const struct rohc_decomp_ctxt *const context,
+                                          const struct rohc_buf rohc_packet,
+                                          const size_t large_cid_len,
+                                          struct rohc_buf *const uncomp_hdrs,
+                                          size_t *const rohc_hdr_len,
+                                          size_t *const uncomp_hdrs_len)
+	__attribute__((warn_unused_result, nonnull(1, 4, 5, 6)));
+
 static void uncomp_update_ctxt(struct rohc_decomp_ctxt *const context,
                                const struct rohc_uncomp_decoded *const decoded,
                                const size_t payload_len,
@@ -161,27 +183,8 @@ static bool uncomp_new_context(const struct rohc_decomp_ctxt *const context,
 	/* volatile part */
 	volat_ctxt->crc.type = ROHC_CRC_TYPE_NONE;
 	volat_ctxt->crc.bits_nr = 0;
-	volat_ctxt->extr_bits = malloc(sizeof(struct rohc_uncomp_extr_bits));
-	if(volat_ctxt->extr_bits == NULL)
-	{
-		rohc_decomp_warn(context, "failed to allocate memory for the volatile part "
-		                 "of the Uncompressed decompression profile");
-		goto error;
-	}
-	volat_ctxt->decoded_values = malloc(sizeof(struct rohc_uncomp_decoded));
-	if(volat_ctxt->decoded_values == NULL)
-	{
-		rohc_decomp_warn(context, "failed to allocate memory for the volatile part "
-		                 "of the Uncompressed decompression profile");
-		goto free_extr_bits;
-	}
 
 	return true;
-
-free_extr_bits:
-	free(volat_ctxt->extr_bits);
-error:
-	return false;
 }
 
 
@@ -196,11 +199,62 @@ error:
  * @param volat_ctxt    The volatile part of the decompression context
  */
 static void uncomp_free_context(void *const persist_ctxt,
-                                const struct rohc_decomp_volat_ctxt *const volat_ctxt)
+                                const struct rohc_decomp_volat_ctxt *const volat_ctxt __attribute__((unused)))
+{
+	assert(persist_ctxt == NULL);
+}
+
+
+/**
+ * @brief Reset profile-specific data of one released context for re-use,
+ *        nothing but the CRC to reset for the uncompressed profile.
+ *
+ * @param context       The decompression context
+ * @param persist_ctxt  The persistent part of the decompression context
+ * @param volat_ctxt    The volatile part of the decompression context
+ */
+static void uncomp_reset_context(const struct rohc_decomp_ctxt *const context,
+                                 void *const persist_ctxt,
+                                 struct rohc_decomp_volat_ctxt *const volat_ctxt)
 {
+	assert(context->profile->id == ROHC_PROFILE_UNCOMPRESSED);
 	assert(persist_ctxt == NULL);
-	free(volat_ctxt->extr_bits);
-	free(volat_ctxt->decoded_values);
+	volat_ctxt->crc.type = ROHC_CRC_TYPE_NONE;
+	volat_ctxt->crc.bits_nr = 0;
+}
+
+
+/**
+ * @brief Save the Uncompressed context, nothing to save
+ *
+ * @param persist_ctxt  The persistent part of the decompression context
+ * @param write_cb      The callback used to write the snapshot
+ * @param priv          The private context given to the callback
+ * @return              Always true
+ */
+static bool uncomp_snapshot(const void *const persist_ctxt,
+                            const rohc_snapshot_write_t write_cb __attribute__((unused)),
+                            void *const priv __attribute__((unused)))
+{
+	assert(persist_ctxt == NULL);
+	return true;
+}
+
+
+/**
+ * @brief Restore the Uncompressed context, nothing to restore
+ *
+ * @param persist_ctxt  The persistent part of the decompression context
+ * @param read_cb       The callback used to read the snapshot
+ * @param priv          The private context given to the callback
+ * @return              Always true
+ */
+static bool uncomp_restore(void *const persist_ctxt,
+                           const rohc_snapshot_read_t read_cb __attribute__((unused)),
+                           void *const priv __attribute__((unused)))
+{
+	assert(persist_ctxt == NULL);
+	return true;
 }
 
 
@@ -482,6 +536,68 @@ error_output_too_small:
 }
 
 
+/**
+ * @brief Decode one Normal packet for the Uncompressed profile
+ *
+ * The Normal packet carries the uncompressed packet with its first byte moved
+ * in front of the CID: there is nothing to decode, the first byte is copied
+ * back without going through the parse, decode and build steps.
+ *
+ * @param context               The decompression context
+ * @param rohc_packet           The ROHC packet to decode
+ * @param large_cid_len         The length of the optional large CID field
+ * @param[out] uncomp_hdrs      The uncompressed headers being built
+ * @param[out] rohc_hdr_len     The length of the ROHC header (in bytes)
+ * @param[out] uncomp_hdrs_len  The length of the uncompressed headers written
+ *                              into the buffer
+ * @return                      Possible values:
+ *                               \li ROHC_STATUS_OK if headers are built
+ *                                   successfully,
+ *                               \li ROHC_STATUS_MALFORMED if the packet is
+ *                                   malformed,
+ *                               \li ROHC_STATUS_OUTPUT_TOO_SMALL if
+ *                                   \e uncomp_hdrs is too small
+ */
+static rohc_status_t uncomp_decode_normal(const struct rohc_decomp_ctxt *const context,
+                                          const struct rohc_buf rohc_packet,
+                                          const size_t large_cid_len,
+                                          struct rohc_buf *const uncomp_hdrs,
+                                          size_t *const rohc_hdr_len,
+                                          size_t *const uncomp_hdrs_len)
+{
+	struct rohc_uncomp_extr_bits extr_bits;
+	struct rohc_decomp_crc extr_crc;
+
+	(*uncomp_hdrs_len) = 0;
+
+	if(!uncomp_parse_normal(context, rohc_packet, large_cid_len, &extr_crc,
+	                        &extr_bits, rohc_hdr_len))
+	{
+		rohc_decomp_warn(context, "failed to parse the Normal packet");
+		goto error_malformed;
+	}
+
+	/* copy the first byte of the ROHC packet to the decompressed packet */
+	if(rohc_buf_avail_len(*uncomp_hdrs) < 1)
+	{
+		rohc_decomp_warn(context, "uncompressed packet too small (%zu bytes "
+		                 "max) for the first byte of the payload",
+		                 rohc_buf_avail_len(*uncomp_hdrs));
+		goto error_output_too_small;
+	}
+	rohc_buf_byte(*uncomp_hdrs) = extr_bits.first_byte;
+	uncomp_hdrs->len++;
+	(*uncomp_hdrs_len)++;
+
+	return ROHC_STATUS_OK;
+
+error_malformed:
+	return ROHC_STATUS_MALFORMED;
+error_output_too_small:
+	return ROHC_STATUS_OUTPUT_TOO_SMALL;
+}
+
+
 /**
  * @brief Update the decompression context with the infos of current packet
  *
@@ -554,14 +670,20 @@ const struct rohc_decomp_profile d_uncomp_profile =
 {
 	.id              = ROHC_PROFILE_UNCOMPRESSED, /* profile ID (RFC3095 §8) */
 	.msn_max_bits    = 0, /* no MSN */
+	.extr_bits_size  = sizeof(struct rohc_uncomp_extr_bits),
+	.decoded_values_size = sizeof(struct rohc_uncomp_decoded),
 	.new_context     = uncomp_new_context,
 	.free_context    = uncomp_free_context,
+	.reset_context   = uncomp_reset_context,
 	.detect_pkt_type = uncomp_detect_pkt_type,
 	.parse_pkt       = (rohc_decomp_parse_pkt_t) uncomp_parse_pkt,
 	.decode_bits     = (rohc_decomp_decode_bits_t) uncomp_decode_bits,
 	.build_hdrs      = (rohc_decomp_build_hdrs_t) uncomp_build_hdrs,
+	.decode_normal   = uncomp_decode_normal,
 	.update_ctxt     = (rohc_decomp_update_ctxt_t) uncomp_update_ctxt,
 	.attempt_repair  = (rohc_decomp_attempt_repair_t) uncomp_attempt_repair,
 	.get_sn          = uncomp_get_sn,
+	.snapshot        = uncomp_snapshot,
+	.restore         = uncomp_restore,
 };
 
@@ -389,6 +389,9 @@ static bool f_append_cid(struct d_feedback *const feedback,
 /**
  * @brief Wrap the feedback packet and add a CRC option if specified.
  *
+ * The feedback packet is wrapped in place: the returned packet is the data of
+ * the given feedback, it stays valid as long as the feedback is not reused.
+ *
  * @warning CID may be greater than MAX_CID if the context was not found and
  *          generated a No Context feedback; it must however respect CID type
  *
@@ -401,14 +404,13 @@ static bool f_append_cid(struct d_feedback *const feedback,
  * @param final_size        OUT: The final size of the feedback packet
  * @return                  The feedback packet if successful, NULL otherwise
  */
-uint8_t * f_wrap_feedback(struct d_feedback *const feedback,
-                          const uint16_t cid,
-                          const rohc_cid_type_t cid_type,
-                          const rohc_feedback_crc_t protect_with_crc,
-                          const uint8_t *const crc_table,
-                          size_t *const final_size)
+const uint8_t * f_wrap_feedback(struct d_feedback *const feedback,
+                                const uint16_t cid,
+                                const rohc_cid_type_t cid_type,
+                                const rohc_feedback_crc_t protect_with_crc,
+                                const uint8_t *const crc_table,
+                                size_t *const final_size)
 {
-	uint8_t *feedback_packet;
 	size_t feedback_cid_len = 0;
 	size_t crc_pos = 0;
 	uint8_t crc;
@@ -449,28 +451,18 @@ uint8_t * f_wrap_feedback(struct d_feedback *const feedback,
 		goto error;
 	}
 
-	/* allocate memory for the feedback packet */
-	feedback_packet = (uint8_t *) malloc(feedback->size);
-	if(feedback_packet == NULL)
-	{
-		goto error;
-	}
-
-	/* duplicate the feedback packet */
-	memcpy(feedback_packet, feedback->data, feedback->size);
-
 	/* compute the CRC and store it in the feedback packet if specified */
 	if(protect_with_crc != ROHC_FEEDBACK_WITH_NO_CRC)
 	{
-		crc = crc_calculate(ROHC_CRC_TYPE_8, feedback_packet, feedback->size,
+		crc = crc_calculate(ROHC_CRC_TYPE_8, feedback->data, feedback->size,
 		                    CRC_INIT_8, crc_table);
-		feedback_packet[crc_pos] = crc & 0xff;
+		feedback->data[crc_pos] = crc & 0xff;
 	}
 
 	*final_size = feedback->size;
 	feedback->size = 0;
 
-	return feedback_packet;
+	return feedback->data;
 
 error:
 	feedback->size = 0;
@@ -41,6 +41,7 @@
 #include "rohc_decomp_internals.h"
 #include "rohc_traces_internal.h"
 #include "rohc_time_internal.h"
+#include "rohc_probes.h"
 #include "rohc_utils.h"
 #include "rohc_bit_ops.h"
 #include "rohc_debug.h"
@@ -50,6 +51,7 @@
 #include "rohc_add_cid.h"
 #include "rohc_decomp_detect_packet.h"
 #include "crc.h"
+#include "rohc_cpu.h"
 
 #ifndef __KERNEL__
 #  include <string.h>
@@ -69,16 +71,33 @@ extern const struct rohc_decomp_profile d_uncomp_profile,
 
 /**
  * @brief The decompression parts of the ROHC profiles.
+ *
+ * Only the profiles built in the library are declared, see the
+ * --disable-profile-* options of the configure script.
  */
 static const struct rohc_decomp_profile *const rohc_decomp_profiles[D_NUM_PROFILES] =
 {
+#if ROHC_WITH_PROFILE_UNCOMPRESSED == 1
 	&d_uncomp_profile,
+#endif
+#if ROHC_WITH_PROFILE_RTP == 1
 	&d_rtp_profile,
+#endif
+#if ROHC_WITH_PROFILE_UDP == 1
 	&d_udp_profile,
+#endif
+#if ROHC_WITH_PROFILE_ESP == 1
 	&d_esp_profile,
+#endif
+#if ROHC_WITH_PROFILE_IP == 1
 	&d_ip_profile,
+#endif
+#if ROHC_WITH_PROFILE_TCP == 1
 	&d_tcp_profile,
+#endif
+#if ROHC_WITH_PROFILE_UDPLITE == 1
 	&d_udplite_profile,
+#endif
 };
 
 
@@ -101,6 +120,18 @@ static const struct rohc_decomp_profile *const rohc_decomp_profiles[D_NUM_PROFIL
  *      decompressed packet
  *  \li the packet type if available
  */
+/** The ways to output the payload of the decompressed packets */
+typedef enum
+{
+	/** Copy the payload after the uncompressed headers */
+	ROHC_DECOMP_PAYLOAD_COPY,
+	/** Move the uncompressed headers in front of the payload */
+	ROHC_DECOMP_PAYLOAD_INPLACE,
+	/** Output the uncompressed headers only, leave the payload in place */
+	ROHC_DECOMP_PAYLOAD_NONE,
+} rohc_decomp_payload_t;
+
+
 struct rohc_decomp_stream
 {
 	rohc_cid_type_t cid_type;  /**< The CID type of the channel */
@@ -117,6 +148,16 @@ struct rohc_decomp_stream
 	size_t sn_bits_nr;         /**< The number of SN LSB bits (if context found) */
 	rohc_packet_t packet_type; /**< The type of the decompressed packet */
 	bool crc_failed;           /**< Whether the packet failed the CRC check or not */
+	size_t payload_len;        /**< The length of the payload (if decompressed) */
+};
+
+
+/** The journal record being applied on a standby decompressor */
+struct rohc_decomp_journal_cursor
+{
+	const uint8_t *data;  /**< The bytes of the journal record */
+	size_t len;           /**< The length (in bytes) of the journal record */
+	size_t pos;           /**< The number of bytes already read */
 };
 
 
@@ -127,6 +168,42 @@ struct rohc_decomp_stream
 static bool rohc_decomp_create_contexts(struct rohc_decomp *const decomp,
                                         const rohc_cid_t max_cid)
 	__attribute__((nonnull(1), warn_unused_result));
+static void rohc_decomp_destroy_contexts(struct rohc_decomp *const decomp)
+	__attribute__((nonnull(1)));
+static void rohc_decomp_assign_cid(struct rohc_decomp *const decomp,
+                                   struct rohc_decomp_ctxt *const context)
+	__attribute__((nonnull(1, 2)));
+static void rohc_decomp_lru_add(struct rohc_decomp *const decomp,
+                                struct rohc_decomp_ctxt *const context)
+	__attribute__((nonnull(1, 2)));
+static void rohc_decomp_lru_del(struct rohc_decomp *const decomp,
+                                struct rohc_decomp_ctxt *const context)
+	__attribute__((nonnull(1, 2)));
+static void rohc_decomp_expire_idle(struct rohc_decomp *const decomp,
+                                    const struct rohc_ts now)
+	__attribute__((nonnull(1)));
+static void rohc_decomp_cold_save(struct rohc_decomp *const decomp,
+                                  const struct rohc_decomp_ctxt *const context)
+	__attribute__((nonnull(1, 2)));
+static struct rohc_decomp_ctxt *
+	rohc_decomp_cold_revive(struct rohc_decomp *const decomp,
+	                        const rohc_cid_t cid)
+	__attribute__((nonnull(1), warn_unused_result));
+static void rohc_decomp_cold_drop(struct rohc_decomp *const decomp,
+                                  const rohc_cid_t cid)
+	__attribute__((nonnull(1)));
+static inline struct rohc_ts rohc_decomp_arrival_time(const struct rohc_decomp *const decomp,
+                                                      const struct rohc_ts pkt_time)
+	__attribute__((warn_unused_result, nonnull(1)));
+static inline void rohc_decomp_rru_reset(struct rohc_decomp *const decomp)
+	__attribute__((nonnull(1)));
+static bool rohc_decomp_find_frame(const struct rohc_decomp *const decomp,
+                                   const uint8_t *const data,
+                                   const size_t data_len,
+                                   size_t *const frame_len,
+                                   size_t *const rohc_offset,
+                                   size_t *const rohc_len)
+	__attribute__((warn_unused_result, nonnull(1, 2, 4, 5, 6)));
 
 static const struct rohc_decomp_profile *
 	find_profile(const struct rohc_decomp *const decomp,
@@ -142,21 +219,81 @@ static struct rohc_decomp_ctxt * find_context(const struct rohc_decomp *const de
 	__attribute__((nonnull(1), warn_unused_result));
 static void context_free(struct rohc_decomp_ctxt *const context)
 	__attribute__((nonnull(1)));
+static void context_destroy(struct rohc_decomp_ctxt *const context)
+	__attribute__((nonnull(1)));
+static void rohc_decomp_shrink_contexts_pool(struct rohc_decomp *const decomp,
+                                             const size_t contexts_nr)
+	__attribute__((nonnull(1)));
+static void rohc_decomp_ctxt_mem_add(struct rohc_decomp *const decomp,
+                                     struct rohc_decomp_ctxt *const context,
+                                     const size_t profile_idx)
+	__attribute__((nonnull(1, 2)));
+static void rohc_decomp_ctxt_mem_remove(struct rohc_decomp *const decomp,
+                                        const struct rohc_decomp_ctxt *const context)
+	__attribute__((nonnull(1, 2)));
+static size_t rohc_decomp_get_profile_index(const struct rohc_decomp *const decomp,
+                                            const struct rohc_decomp_profile *const profile)
+	__attribute__((warn_unused_result, nonnull(1, 2), pure));
+static bool rohc_decomp_alloc_per_pkt_data(struct rohc_decomp *const decomp)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+static rohc_status_t __rohc_decompress(struct rohc_decomp *const decomp,
+                                       struct rohc_buf rohc_packet,
+                                       struct rohc_buf *const uncomp_packet,
+                                       struct rohc_buf *const rcvd_feedback,
+                                       struct rohc_buf *const feedback_send,
+                                       const rohc_decomp_payload_t payload_mode,
+                                       size_t *const payload_len)
+	__attribute__((warn_unused_result, nonnull(1)));
 
 static rohc_status_t d_decode_header(struct rohc_decomp *decomp,
                                      const struct rohc_buf rohc_packet,
                                      struct rohc_buf *const uncomp_packet,
                                      struct rohc_buf *const rcvd_feedback,
+                                     const rohc_decomp_payload_t payload_mode,
                                      struct rohc_decomp_stream *const stream)
-	__attribute__((nonnull(1, 3, 5), warn_unused_result));
-
-static bool rohc_decomp_decode_cid(struct rohc_decomp *decomp,
-                                   const uint8_t *packet,
-                                   unsigned int len,
-                                   rohc_cid_t *const cid,
-                                   size_t *const add_cid_len,
-                                   size_t *const large_cid_len)
+	__attribute__((nonnull(1, 3, 6), warn_unused_result));
+
+static inline bool rohc_decomp_decode_cid_tmpl(const struct rohc_decomp *const decomp,
+                                               const rohc_cid_type_t cid_type,
+                                               const uint8_t *packet,
+                                               size_t len,
+                                               rohc_cid_t *const cid,
+                                               size_t *const add_cid_len,
+                                               size_t *const large_cid_len)
+	__attribute__((nonnull(1, 3, 5, 6, 7), warn_unused_result, always_inline));
+static bool rohc_decomp_decode_small_cid(const struct rohc_decomp *const decomp,
+                                         const uint8_t *packet,
+                                         size_t len,
+                                         rohc_cid_t *const cid,
+                                         size_t *const add_cid_len,
+                                         size_t *const large_cid_len)
 	__attribute__((nonnull(1, 2, 4, 5, 6), warn_unused_result));
+static bool rohc_decomp_decode_large_cid(const struct rohc_decomp *const decomp,
+                                         const uint8_t *packet,
+                                         size_t len,
+                                         rohc_cid_t *const cid,
+                                         size_t *const add_cid_len,
+                                         size_t *const large_cid_len)
+	__attribute__((nonnull(1, 2, 4, 5, 6), warn_unused_result));
+static bool rohc_decomp_peek_cid(const rohc_cid_type_t cid_type,
+                                 const uint8_t *const packet,
+                                 const size_t len,
+                                 rohc_cid_t *const cid)
+	__attribute__((nonnull(2, 4), warn_unused_result));
+static bool rohc_decomp_peek_pkt_cid(const struct rohc_decomp *const decomp,
+                                     const struct rohc_buf rohc_packet,
+                                     rohc_cid_t *const cid)
+	__attribute__((nonnull(1, 3), warn_unused_result));
+
+/** The max number of packets of one burst that are grouped by CID at once */
+#define ROHC_DECOMP_BATCH_SPAN_MAX  64U
+
+static size_t rohc_decomp_batch_order(const struct rohc_decomp *const decomp,
+                                      const struct rohc_buf rohc_packets[],
+                                      const size_t pkts_nr,
+                                      uint8_t order[ROHC_DECOMP_BATCH_SPAN_MAX])
+	__attribute__((nonnull(1, 2, 4), warn_unused_result));
 
 static void rohc_decomp_parse_padding(const struct rohc_decomp *const decomp,
                                       struct rohc_buf *const packet)
@@ -179,16 +316,30 @@ static rohc_status_t rohc_decomp_decode_pkt(struct rohc_decomp *const decomp,
                                             const size_t add_cid_len,
                                             const size_t large_cid_len,
                                             struct rohc_buf *const uncomp_packet,
+                                            const rohc_decomp_payload_t payload_mode,
                                             rohc_packet_t *const packet_type,
-                                            bool *const do_change_mode)
-	__attribute__((warn_unused_result, nonnull(1, 2, 6, 7, 8)));
+                                            bool *const do_change_mode,
+                                            size_t *const rohc_payload_len)
+	__attribute__((warn_unused_result, nonnull(1, 2, 6, 8, 9, 10)));
+static rohc_status_t rohc_decomp_decode_hdrs(struct rohc_decomp *const decomp,
+                                             struct rohc_decomp_ctxt *const context,
+                                             const struct rohc_buf rohc_packet,
+                                             const size_t add_cid_len,
+                                             const size_t large_cid_len,
+                                             struct rohc_buf *const uncomp_packet,
+                                             rohc_packet_t *const packet_type,
+                                             bool *const do_change_mode,
+                                             size_t *const rohc_hdr_len,
+                                             size_t *const uncomp_hdr_len)
+	__attribute__((warn_unused_result, nonnull(1, 2, 6, 7, 8, 9, 10)));
 
 static bool rohc_decomp_check_ir_crc(const struct rohc_decomp *const decomp,
-                                     const struct rohc_decomp_ctxt *const context,
+                                     struct rohc_decomp_ctxt *const context,
                                      const uint8_t *const rohc_hdr,
                                      const size_t rohc_hdr_len,
                                      const size_t add_cid_len,
                                      const size_t large_cid_len,
+                                     const size_t static_len,
                                      const uint8_t crc_packet)
 	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
 
@@ -197,6 +348,15 @@ static void rohc_decomp_stats_add_success(struct rohc_decomp_ctxt *const context
                                           const size_t uncomp_hdr_len)
 	__attribute__((nonnull(1)));
 
+static bool rohc_decomp_crc_repair_allowed(struct rohc_decomp *const decomp,
+                                           struct rohc_decomp_ctxt *const context,
+                                           const struct rohc_ts pkt_arrival_time)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static void rohc_decomp_crc_repair_budget_renew(struct rohc_decomp_crc_repair_budget *const budget,
+                                                const size_t window,
+                                                const struct rohc_ts pkt_arrival_time)
+	__attribute__((nonnull(1)));
+
 static void rohc_decomp_update_context(struct rohc_decomp_ctxt *const context,
                                        const void *const decoded_values,
                                        const size_t payload_len,
@@ -225,14 +385,73 @@ static bool rohc_decomp_feedback_nack(struct rohc_decomp *const decomp,
                                       struct rohc_buf *const feedback)
 	__attribute__((warn_unused_result, nonnull(1, 2)));
 
+static void rohc_decomp_feedback_stats_shift(uint32_t *const last_pkts_errors,
+                                             struct rohc_ack_stats *const stats,
+                                             const bool is_error)
+	__attribute__((nonnull(1, 2)));
+static size_t rohc_decomp_rate_limit_threshold(const size_t k, const size_t n)
+	__attribute__((warn_unused_result, const));
+static bool rohc_decomp_build_feedback(struct rohc_decomp *const decomp,
+                                       const struct rohc_decomp_feedback_intent *const intent,
+                                       struct rohc_buf *const feedback)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+static bool rohc_decomp_feedback_budget_take(struct rohc_decomp *const decomp,
+                                             const size_t feedback_len)
+	__attribute__((warn_unused_result, nonnull(1)));
+static void rohc_decomp_queue_feedback(struct rohc_decomp *const decomp,
+                                       const struct rohc_decomp_feedback_intent *const intent)
+	__attribute__((nonnull(1, 2)));
+static bool rohc_decomp_emit_feedback(struct rohc_decomp *const decomp,
+                                      const struct rohc_decomp_feedback_intent *const intent,
+                                      struct rohc_buf *const feedback)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static bool rohc_decomp_coalesce_feedback(struct rohc_decomp *const decomp,
+                                          const struct rohc_decomp_feedback_intent *const intent,
+                                          struct rohc_buf *const feedback)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static void rohc_decomp_coalesce_drop(struct rohc_decomp *const decomp,
+                                      const rohc_cid_t cid)
+	__attribute__((nonnull(1)));
+static bool rohc_decomp_coalesce_expire(struct rohc_decomp *const decomp,
+                                        struct rohc_buf *const feedback)
+	__attribute__((warn_unused_result, nonnull(1)));
+static bool rohc_decomp_coalesce_flush(struct rohc_decomp *const decomp,
+                                       struct rohc_buf *const feedback)
+	__attribute__((warn_unused_result, nonnull(1)));
+
 /* statistics-related functions */
 static void rohc_decomp_reset_stats(struct rohc_decomp *const decomp)
 	__attribute__((nonnull(1)));
 
+/* functions related to snapshots and to the journal of context updates */
+static bool rohc_decomp_snapshot_ctxt(const struct rohc_decomp_ctxt *const context,
+                                      const rohc_snapshot_write_t write_cb,
+                                      void *const priv)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static bool rohc_decomp_restore_ctxt(struct rohc_decomp *const decomp,
+                                     const struct rohc_decomp_snapshot_ctxt *const record,
+                                     const rohc_snapshot_read_t read_cb,
+                                     void *const priv)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+static void rohc_decomp_journal_ctxt(struct rohc_decomp *const decomp,
+                                     const struct rohc_decomp_ctxt *const context)
+	__attribute__((nonnull(1, 2)));
+static bool rohc_decomp_journal_write(void *const priv,
+                                      const uint8_t *const data,
+                                      const size_t len)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static bool rohc_decomp_journal_read(void *const priv,
+                                     uint8_t *const data,
+                                     const size_t len)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
 static bool rohc_decomp_packet_carry_static_info(const rohc_packet_t packet_type)
 	__attribute__((warn_unused_result, const));
 static bool rohc_decomp_packet_carry_crc_7_or_8(const rohc_packet_t packet_type)
 	__attribute__((warn_unused_result, const));
+static bool rohc_decomp_ctxt_is_damaged(const struct rohc_decomp *const decomp,
+                                        const struct rohc_decomp_ctxt *const context)
+	__attribute__((warn_unused_result, nonnull(1, 2), pure));
 
 
 
@@ -273,19 +492,44 @@ static struct rohc_decomp_ctxt * context_create(struct rohc_decomp *decomp,
                                                 const struct rohc_ts arrival_time)
 {
 	struct rohc_decomp_ctxt *context;
+	size_t profile_idx;
+	bool is_reused;
 
 	assert(decomp != NULL);
 	assert(cid <= ROHC_LARGE_CID_MAX);
 	assert(profile != NULL);
 
-	/* allocate memory for the decompression context */
-	context = (struct rohc_decomp_ctxt *) malloc(sizeof(struct rohc_decomp_ctxt));
-	if(context == NULL)
+	/* re-use one released context of the same profile if the pool of
+	 * contexts holds one, allocate memory for a new context otherwise */
+	profile_idx = rohc_decomp_get_profile_index(decomp, profile);
+	context = decomp->contexts_pool[profile_idx];
+	if(context != NULL)
+	{
+		decomp->contexts_pool[profile_idx] = context->pool_next;
+		assert(decomp->contexts_pool_nr > 0);
+		decomp->contexts_pool_nr--;
+		is_reused = true;
+	}
+	else if((decomp->features & ROHC_DECOMP_FEATURE_NO_ALLOC) != 0)
 	{
 		rohc_warning(decomp, ROHC_TRACE_DECOMP, profile->id,
-		             "cannot allocate memory for the contexts");
+		             "no prepared context left for the profile, and memory "
+		             "shall not be allocated");
 		goto error;
 	}
+	else
+	{
+		context = rohc_alloc_malloc_node(sizeof(struct rohc_decomp_ctxt),
+		                                 decomp->numa_node);
+		if(context == NULL)
+		{
+			rohc_warning(decomp, ROHC_TRACE_DECOMP, profile->id,
+			             "cannot allocate memory for the contexts");
+			goto error;
+		}
+		is_reused = false;
+	}
+	context->pool_next = NULL;
 
 	/* record the CID */
 	context->cid = cid;
@@ -313,14 +557,22 @@ static struct rohc_decomp_ctxt * context_create(struct rohc_decomp *decomp,
 	/* at the beginning, no attempt to correct CRC failure */
 	context->crc_corr.algo = ROHC_DECOMP_CRC_CORR_SN_NONE;
 	context->crc_corr.counter = 0;
+#if ROHC_SMALL_CONTEXTS != 1
 	/* arrival times for correction upon CRC failure */
 	memset(context->crc_corr.arrival_times, 0,
 	       sizeof(struct rohc_ts) * ROHC_MAX_ARRIVAL_TIMES);
 	context->crc_corr.arrival_times_nr = 0;
 	context->crc_corr.arrival_times_index = 0;
+#endif
+	/* no repair attempt yet */
+	context->crc_corr.budget.attempts_nr = 0;
+	context->crc_corr.budget.window_start.sec = 0;
+	context->crc_corr.budget.window_start.nsec = 0;
 
 	/* init some statistics */
+	rohc_seqlock_write_begin(&decomp->stats_seq);
 	context->num_recv_packets = 0;
+#if ROHC_SMALL_CONTEXTS != 1
 	context->total_uncompressed_size = 0;
 	context->total_compressed_size = 0;
 	context->header_uncompressed_size = 0;
@@ -328,27 +580,50 @@ static struct rohc_decomp_ctxt * context_create(struct rohc_decomp *decomp,
 	context->corrected_crc_failures = 0;
 	context->corrected_sn_wraparounds = 0;
 	context->corrected_wrong_sn_updates = 0;
+	context->skipped_crc_repairs = 0;
+	memset(context->packet_types_nr, 0, sizeof(context->packet_types_nr));
+	context->crc_failures = 0;
+	context->decode_cycles = 0;
+	context->ir_crc_cache.len = 0;
+#endif
 	context->nr_lost_packets = 0;
 	context->nr_misordered_packets = 0;
 	context->is_duplicated = 0;
 
 	context->first_used = arrival_time.sec;
 	context->latest_used = arrival_time.sec;
+	rohc_seqlock_write_end(&decomp->stats_seq);
 
-	/* create the profile-specific parts of the decompression context (performed
-	 * at the every end so that everything is initialized in context first) */
-	if(!profile->new_context(context, &context->persist_ctxt, &context->volat_ctxt))
+	/* create or reset the profile-specific parts of the decompression context
+	 * (performed at the every end so that everything is initialized in context
+	 * first) */
+	if(is_reused)
+	{
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, profile->id,
+		           "re-use one released context for CID %zu", cid);
+		profile->reset_context(context, context->persist_ctxt, &context->volat_ctxt);
+	}
+	else if(!profile->new_context(context, &context->persist_ctxt,
+	                              &context->volat_ctxt))
 	{
 		rohc_warning(decomp, ROHC_TRACE_DECOMP, profile->id,
 		             "failed to initialize the profile-specific parts of the "
 		             "decompression context");
 		goto destroy_context;
 	}
+	else
+	{
+		/* account for the memory of the new context */
+		rohc_decomp_ctxt_mem_add(decomp, context, profile_idx);
+	}
 
 	/* decompressor got one more context (for a short moment, decompressor
 	 * might have MAX_CID + 2 contexts) */
 	assert(decomp->num_contexts_used <= (decomp->medium.max_cid + 1));
+	rohc_seqlock_write_begin(&decomp->stats_seq);
 	decomp->num_contexts_used++;
+	rohc_seqlock_write_end(&decomp->stats_seq);
+	rohc_probe3(decomp_ctxt_create, decomp, cid, profile->id);
 
 	return context;
 
@@ -359,13 +634,57 @@ error:
 }
 
 
+/**
+ * @brief Release one decompression context
+ *
+ * The context is kept in the pool of contexts of the decompressor if the
+ * profile is able to re-use it and if the pool is not full yet. The context
+ * and the profile specific data associated with it are destroyed otherwise.
+ *
+ * @param context  The context to release
+ */
+static void context_free(struct rohc_decomp_ctxt *const context)
+{
+	struct rohc_decomp *const decomp = context->decompressor;
+
+	assert(decomp != NULL);
+	assert(context->profile != NULL);
+
+	/* decompressor got one less context */
+	assert(decomp->num_contexts_used > 0);
+	rohc_seqlock_write_begin(&decomp->stats_seq);
+	decomp->num_contexts_used--;
+	rohc_seqlock_write_end(&decomp->stats_seq);
+
+	/* without allocation, the pool shall keep all the prepared contexts */
+	if(context->profile->reset_context != NULL &&
+	   (decomp->contexts_pool_nr < decomp->contexts_pool_max ||
+	    (decomp->features & ROHC_DECOMP_FEATURE_NO_ALLOC) != 0))
+	{
+		const size_t profile_idx =
+			rohc_decomp_get_profile_index(decomp, context->profile);
+
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, context->profile->id,
+		           "keep context with CID %zu for re-use", context->cid);
+
+		context->pool_next = decomp->contexts_pool[profile_idx];
+		decomp->contexts_pool[profile_idx] = context;
+		decomp->contexts_pool_nr++;
+	}
+	else
+	{
+		context_destroy(context);
+	}
+}
+
+
 /**
  * @brief Destroy one decompression context and the profile specific data
  *        associated with it.
  *
  * @param context  The context to destroy
  */
-static void context_free(struct rohc_decomp_ctxt *const context)
+static void context_destroy(struct rohc_decomp_ctxt *const context)
 {
 	assert(context->decompressor != NULL);
 	assert(context->profile != NULL);
@@ -373,18 +692,177 @@ static void context_free(struct rohc_decomp_ctxt *const context)
 	rohc_debug(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
 	           "free context with CID %zu", context->cid);
 
+	/* the memory of the context is not used anymore */
+	rohc_decomp_ctxt_mem_remove(context->decompressor, context);
+
 	/* destroy the profile-specific data */
 	context->profile->free_context(context->persist_ctxt, &context->volat_ctxt);
 
-	/* decompressor got one more context */
-	assert(context->decompressor->num_contexts_used > 0);
-	context->decompressor->num_contexts_used--;
-
 	/* destroy the context itself */
 	free(context);
 }
 
 
+/**
+ * @brief Account for the memory used by one new decompression context
+ *
+ * @param decomp       The ROHC decompressor
+ * @param context      The new decompression context
+ * @param profile_idx  The index of the profile of the context
+ */
+static void rohc_decomp_ctxt_mem_add(struct rohc_decomp *const decomp,
+                                     struct rohc_decomp_ctxt *const context,
+                                     const size_t profile_idx)
+{
+	struct rohc_ctxt_mem *const mem = &decomp->contexts_mem[profile_idx];
+
+	context->mem.bytes = 0;
+	context->mem.wlsb_bytes = 0;
+	context->mem.lists_bytes = 0;
+	if(context->profile->get_mem != NULL)
+	{
+		context->profile->get_mem(context->persist_ctxt, &context->mem);
+	}
+	context->mem.bytes += sizeof(struct rohc_decomp_ctxt);
+
+	mem->bytes += context->mem.bytes;
+	mem->wlsb_bytes += context->mem.wlsb_bytes;
+	mem->lists_bytes += context->mem.lists_bytes;
+	decomp->contexts_mem_nr[profile_idx]++;
+}
+
+
+/**
+ * @brief Stop accounting for the memory used by one decompression context
+ *
+ * @param decomp   The ROHC decompressor
+ * @param context  The decompression context being destroyed
+ */
+static void rohc_decomp_ctxt_mem_remove(struct rohc_decomp *const decomp,
+                                        const struct rohc_decomp_ctxt *const context)
+{
+	const size_t profile_idx =
+		rohc_decomp_get_profile_index(decomp, context->profile);
+	struct rohc_ctxt_mem *const mem = &decomp->contexts_mem[profile_idx];
+
+	assert(decomp->contexts_mem_nr[profile_idx] > 0);
+	assert(mem->bytes >= context->mem.bytes);
+	mem->bytes -= context->mem.bytes;
+	mem->wlsb_bytes -= context->mem.wlsb_bytes;
+	mem->lists_bytes -= context->mem.lists_bytes;
+	decomp->contexts_mem_nr[profile_idx]--;
+}
+
+
+/**
+ * @brief Destroy the released contexts of the pool in excess
+ *
+ * @param decomp       The ROHC decompressor
+ * @param contexts_nr  The max number of released contexts to keep in the pool
+ */
+static void rohc_decomp_shrink_contexts_pool(struct rohc_decomp *const decomp,
+                                             const size_t contexts_nr)
+{
+	size_t i;
+
+	for(i = 0; i < decomp->profiles_nr && decomp->contexts_pool_nr > contexts_nr; i++)
+	{
+		while(decomp->contexts_pool[i] != NULL &&
+		      decomp->contexts_pool_nr > contexts_nr)
+		{
+			struct rohc_decomp_ctxt *const context = decomp->contexts_pool[i];
+			decomp->contexts_pool[i] = context->pool_next;
+			decomp->contexts_pool_nr--;
+			context_destroy(context);
+		}
+	}
+	assert(decomp->contexts_pool_nr <= contexts_nr);
+}
+
+
+/**
+ * @brief Get the index of the given profile in the list of profiles
+ *
+ * @param decomp   The ROHC decompressor
+ * @param profile  The decompression profile
+ * @return         The index of the profile in the profiles of the
+ *                 decompressor
+ */
+static size_t rohc_decomp_get_profile_index(const struct rohc_decomp *const decomp,
+                                            const struct rohc_decomp_profile *const profile)
+{
+	size_t i;
+
+	for(i = 0; i < decomp->profiles_nr && decomp->profiles[i] != profile; i++)
+	{
+	}
+	assert(i < decomp->profiles_nr);
+
+	return i;
+}
+
+
+/**
+ * @brief Allocate the data shared by all the contexts for decoding
+ *
+ * The bits extracted from ROHC packets and the decoded values are allocated
+ * once for all the contexts, large enough for the profile of the
+ * decompressor that needs the more room. The data allocated before, if any,
+ * is released once the new one is allocated.
+ *
+ * @param decomp  The ROHC decompressor
+ * @return        true if the data was allocated,
+ *                false if memory ran out
+ */
+static bool rohc_decomp_alloc_per_pkt_data(struct rohc_decomp *const decomp)
+{
+	size_t extr_bits_size = 0;
+	size_t decoded_values_size = 0;
+	void *extr_bits;
+	void *decoded_values;
+	size_t i;
+
+	for(i = 0; i < decomp->profiles_nr; i++)
+	{
+		assert(decomp->profiles[i]->extr_bits_size > 0);
+		assert(decomp->profiles[i]->decoded_values_size > 0);
+		if(decomp->profiles[i]->extr_bits_size > extr_bits_size)
+		{
+			extr_bits_size = decomp->profiles[i]->extr_bits_size;
+		}
+		if(decomp->profiles[i]->decoded_values_size > decoded_values_size)
+		{
+			decoded_values_size = decomp->profiles[i]->decoded_values_size;
+		}
+	}
+
+	extr_bits = malloc(extr_bits_size);
+	if(extr_bits == NULL)
+	{
+		goto error;
+	}
+	decoded_values = malloc(decoded_values_size);
+	if(decoded_values == NULL)
+	{
+		goto free_extr_bits;
+	}
+
+	free(decomp->extr_bits);
+	free(decomp->decoded_values);
+	decomp->extr_bits = extr_bits;
+	decomp->extr_bits_profile = NULL;
+	decomp->decoded_values = decoded_values;
+	decomp->per_pkt_data_size = extr_bits_size + decoded_values_size;
+
+	return true;
+
+free_extr_bits:
+	free(extr_bits);
+error:
+	return false;
+}
+
+
 /**
  * @brief Create a new ROHC decompressor
  *
@@ -441,12 +919,46 @@ static void context_free(struct rohc_decomp_ctxt *const context)
  * @see rohc_decomp_disable_profile
  * @see rohc_decomp_set_mrru
  * @see rohc_decomp_set_features
+ * @see rohc_decomp_new_on_node
  */
 struct rohc_decomp * rohc_decomp_new2(const rohc_cid_type_t cid_type,
                                       const rohc_cid_t max_cid,
                                       const rohc_mode_t mode)
 {
+	return rohc_decomp_new_on_node(cid_type, max_cid, mode, ROHC_NUMA_NO_NODE);
+}
 
+
+/**
+ * @brief Create a new ROHC decompressor on the given NUMA node
+ *
+ * Create a new ROHC decompressor as \ref rohc_decomp_new2 does. The
+ * decompressor, its arrays of contexts and its contexts are allocated on the
+ * given NUMA node. Give the node of the core that runs the decompressor, so
+ * that the contexts are not accessed across sockets.
+ *
+ * The memory is really placed on the node by the Linux kernel module, or by
+ * the NUMA-aware allocation function of the custom allocator (see
+ * \ref rohc_alloc_set_numa_allocator). Otherwise the operating system
+ * places the memory on the node of the thread that touches it first.
+ *
+ * @param cid_type   The type of Context IDs (CID), see \ref rohc_decomp_new2
+ * @param max_cid    The maximum value for CIDs, see \ref rohc_decomp_new2
+ * @param mode       The operational mode, see \ref rohc_decomp_new2
+ * @param numa_node  The NUMA node, \ref ROHC_NUMA_NO_NODE for any node
+ * @return           The created decompressor if successful,
+ *                   NULL if creation failed
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_new2
+ * @see rohc_alloc_set_numa_allocator
+ */
+struct rohc_decomp * rohc_decomp_new_on_node(const rohc_cid_type_t cid_type,
+                                             const rohc_cid_t max_cid,
+                                             const rohc_mode_t mode,
+                                             const int numa_node)
+{
 	struct rohc_decomp *decomp;
 	bool is_fine;
 	size_t i;
@@ -483,17 +995,72 @@ struct rohc_decomp * rohc_decomp_new2(const rohc_cid_type_t cid_type,
 		/* R-mode is not supported yet */
 		goto error;
 	}
+	if(numa_node < ROHC_NUMA_NO_NODE)
+	{
+		goto error;
+	}
+
+	/* select the best implementations of the hot kernels for the CPU */
+	rohc_cpu_init();
 
 	/* allocate memory for the decompressor */
-	decomp = (struct rohc_decomp *) malloc(sizeof(struct rohc_decomp));
+	decomp = rohc_alloc_malloc_node(sizeof(struct rohc_decomp), numa_node);
 	if(decomp == NULL)
 	{
 		goto error;
 	}
+	decomp->numa_node = numa_node;
 
 	/* no trace callback during decompressor creation */
 	decomp->trace_callback = NULL;
 	decomp->trace_callback_priv = NULL;
+	decomp->trace_level = ROHC_TRACE_DEBUG;
+
+	/* no binary trace record by default */
+	memset(&decomp->trace_ring, 0, sizeof(struct rohc_trace_ring));
+
+	/* no histogram of the processing time by default */
+	decomp->latency = NULL;
+
+	/* no feedback intent waiting for rohc_decomp_flush_feedback() */
+	decomp->feedback_intents.head = 0;
+	decomp->feedback_intents.tail = 0;
+	decomp->feedback_intents.dropped_nr = 0;
+
+	/* no coalescing of positive feedback by default */
+	decomp->feedback_coalescing.max_pkts = 0;
+	decomp->feedback_coalescing.max_delay = 0;
+	decomp->feedback_coalescing.pkts_nr = 0;
+	decomp->feedback_coalescing.pending_nr = 0;
+
+	/* no budget of feedback bytes by default */
+	decomp->feedback_budget.max_bytes = 0;
+	decomp->feedback_budget.bytes_nr = 0;
+	decomp->feedback_budget.window_start.sec = 0;
+	decomp->feedback_budget.window_start.nsec = 0;
+
+	/* received feedback is copied in the rcvd_feedback buffer by default */
+	decomp->feedback_cb = NULL;
+	decomp->feedback_cb_priv = NULL;
+
+	/* no journal of context updates by default */
+	decomp->journal_cb = NULL;
+	decomp->journal_cb_priv = NULL;
+	decomp->journal_buf = NULL;
+	decomp->journal_len = 0;
+	decomp->journal_max_len = 0;
+
+	/* no recording by default */
+	decomp->recorder.write_cb = NULL;
+	decomp->recorder.priv = NULL;
+	decomp->recorder.max_len = 0;
+
+	/* no framing of byte stream by default */
+	decomp->frame_cb = NULL;
+	decomp->frame_cb_priv = NULL;
+	decomp->stream_buf = NULL;
+	decomp->stream_len = 0;
+	decomp->stream_max_len = 0;
 
 	/* default feature set (empty for the moment) */
 	decomp->features = ROHC_DECOMP_FEATURE_NONE;
@@ -501,19 +1068,47 @@ struct rohc_decomp * rohc_decomp_new2(const rohc_cid_type_t cid_type,
 	/* init decompressor medium */
 	decomp->medium.cid_type = cid_type;
 	decomp->medium.max_cid = max_cid;
+	if(cid_type == ROHC_SMALL_CID)
+	{
+		decomp->decode_cid = rohc_decomp_decode_small_cid;
+	}
+	else
+	{
+		decomp->decode_cid = rohc_decomp_decode_large_cid;
+	}
 
 	/* all decompression profiles are disabled by default */
 	for(i = 0; i < D_NUM_PROFILES; i++)
 	{
+		decomp->profiles[i] = rohc_decomp_profiles[i];
+		decomp->profiles_prio[i] = 0;
+		decomp->profiles_order[i] = i;
 		decomp->enabled_profiles[i] = false;
 	}
+	decomp->profiles_nr = D_NUM_PROFILES;
 
 	/* the operational mode the decompressor shall target for all its contexts */
 	decomp->target_mode = mode;
 
 	/* initialize the array of decompression contexts to its minimal value */
 	decomp->contexts = NULL;
+	decomp->active_contexts = NULL;
+	decomp->active_contexts_nr = 0;
 	decomp->num_contexts_used = 0;
+	decomp->lru_head = NULL;
+	decomp->lru_tail = NULL;
+	decomp->ctxt_idle_timeout = 0;
+	decomp->clock = NULL;
+	for(i = 0; i < D_MAX_PROFILES; i++)
+	{
+		decomp->contexts_pool[i] = NULL;
+		decomp->contexts_mem_nr[i] = 0;
+		memset(&decomp->contexts_mem[i], 0, sizeof(struct rohc_ctxt_mem));
+	}
+	decomp->contexts_pool_nr = 0;
+	decomp->contexts_pool_max = 0;
+	decomp->cold_ctxts = NULL;
+	decomp->cold_ctxts_nr = 0;
 	is_fine = rohc_decomp_create_contexts(decomp, decomp->medium.max_cid);
 	if(!is_fine)
 	{
@@ -521,6 +1116,15 @@ struct rohc_decomp * rohc_decomp_new2(const rohc_cid_type_t cid_type,
 	}
 	decomp->last_context = NULL;
 
+	/* allocate the profile-specific data for bits extracted from ROHC packets
+	 * and for decoded values once for all the contexts */
+	decomp->extr_bits = NULL;
+	decomp->decoded_values = NULL;
+	if(!rohc_decomp_alloc_per_pkt_data(decomp))
+	{
+		goto destroy_contexts;
+	}
+
 	/* counters and thresholds for feedbacks and downward state transitions */
 	{
 		const size_t rtt = 1000U; /* conservative 1-second RTT */
@@ -539,35 +1143,29 @@ struct rohc_decomp * rohc_decomp_new2(const rohc_cid_type_t cid_type,
 		decomp->last_pkt_feedbacks[ROHC_FEEDBACK_STATIC_NACK].sent = 0;
 	}
 
+	/* no limit on CRC repair attempts by default */
+	is_fine = rohc_decomp_set_crc_repair_budget(decomp, 0, 0, 1000U);
+	assert(is_fine);
+	decomp->crc_repair_budget.attempts_nr = 0;
+	decomp->crc_repair_budget.window_start.sec = 0;
+	decomp->crc_repair_budget.window_start.nsec = 0;
+
+	/* late packets are repaired upon CRC failure by default */
+	decomp->reorder_window = 0;
+
 	/* no Reconstructed Reception Unit (RRU) at the moment */
-	decomp->rru_len = 0;
+	decomp->rru = NULL;
+	rohc_decomp_rru_reset(decomp);
 	/* no segmentation by default */
 	decomp->mrru = 0;
 
-	/* init the tables for fast CRC computation */
-	is_fine = rohc_crc_init_table(decomp->crc_table_3, ROHC_CRC_TYPE_3);
-	if(is_fine != true)
-	{
-		goto destroy_contexts;
-	}
-	is_fine = rohc_crc_init_table(decomp->crc_table_7, ROHC_CRC_TYPE_7);
-	if(is_fine != true)
-	{
-		goto destroy_contexts;
-	}
-	is_fine = rohc_crc_init_table(decomp->crc_table_8, ROHC_CRC_TYPE_8);
-	if(is_fine != true)
-	{
-		goto destroy_contexts;
-	}
-
 	/* reset the decompressor statistics */
 	rohc_decomp_reset_stats(decomp);
 
 	return decomp;
 
 destroy_contexts:
-	free(decomp->contexts);
+	rohc_decomp_destroy_contexts(decomp);
 destroy_decomp:
 	free(decomp);
 error:
@@ -601,7 +1199,7 @@ error:
  */
 void rohc_decomp_free(struct rohc_decomp *const decomp)
 {
-	rohc_cid_t i;
+	size_t i;
 
 	/* sanity check */
 	if(decomp == NULL)
@@ -614,15 +1212,48 @@ void rohc_decomp_free(struct rohc_decomp *const decomp)
 	           "free ROHC decompressor");
 
 	/* destroy all the contexts owned by the decompressor */
-	for(i = 0; i <= decomp->medium.max_cid; i++)
+	for(i = 0; i < decomp->active_contexts_nr; i++)
+	{
+		context_free(decomp->active_contexts[i]);
+	}
+	rohc_decomp_destroy_contexts(decomp);
+	assert(decomp->num_contexts_used == 0);
+
+	/* destroy all the released contexts kept for re-use */
+	rohc_decomp_shrink_contexts_pool(decomp, 0);
+
+	/* destroy the contexts of the cold store if it was enabled */
+	if(decomp->cold_ctxts != NULL)
 	{
-		if(decomp->contexts[i] != NULL)
+		for(i = 0; i <= decomp->medium.max_cid && decomp->cold_ctxts_nr > 0; i++)
 		{
-			context_free(decomp->contexts[i]);
+			if(decomp->cold_ctxts[i] != NULL)
+			{
+				rohc_decomp_cold_drop(decomp, i);
+			}
 		}
+		zfree(decomp->cold_ctxts);
 	}
-	zfree(decomp->contexts);
-	assert(decomp->num_contexts_used == 0);
+
+	/* free the data shared by all the contexts for decoding */
+	zfree(decomp->decoded_values);
+	zfree(decomp->extr_bits);
+
+	/* free the RRU if segmentation was enabled */
+	zfree(decomp->rru);
+
+	/* free the buffer for journal records if the journal or the cold store
+	 * was enabled */
+	zfree(decomp->journal_buf);
+
+	/* free the buffer for frames if the framing of byte stream was set */
+	zfree(decomp->stream_buf);
+
+	/* free the ring of binary traces if enabled */
+	rohc_trace_ring_free(&decomp->trace_ring);
+
+	/* free the histograms of the processing time if enabled */
+	zfree(decomp->latency);
 
 	/* destroy the decompressor itself */
 	free(decomp);
@@ -633,43 +1264,139 @@ error:
 
 
 /**
- * @brief Decompress the given ROHC packet into one uncompressed packet
+ * @brief Release all the decompression contexts at once
  *
- * Decompress the given ROHC packet into an uncompressed packet. The
- * decompression always returns ROHC_OK in case of success. The caller shall
- * however be ready to handle several cases:
- *  \li the uncompressed packet \e uncomp_packet might be empty if the ROHC
- *      packet contained only feedback data or if the ROHC packet was not a
- *      final segment
- *  \li the received feedback \e rcvd_feedback might be empty if the ROHC
- *      packet doesn't contain at least one feedback item
+ * Reset the decompressor to the state it had before its first packet, for
+ * example when the link it decompresses for went down and up again: all the
+ * contexts are released at once, the segments and the frame of byte stream
+ * received partially are dropped. Unlike freeing the decompressor and
+ * creating it again, the memory of the decompressor is kept and so is its
+ * configuration (profiles, features, MAX_CID, mode, MRRU, callbacks...). The
+ * statistics of the decompressor are also kept.
  *
- * If \e feedback_send is not NULL, the decompression may return some feedback
- * information on it. In such a case, the caller is responsible to send it to
- * the compressor through any feedback channel.
+ * The released contexts of the profiles able to re-use their contexts are all
+ * kept in the pool of contexts for the next flows, even beyond the size of
+ * the pool (see \ref rohc_decomp_set_contexts_pool). The other contexts and
+ * the cold contexts are destroyed.
  *
- * Time-related features in the ROHC protocol: set the \e rohc_packet.time
- * parameter to 0 if arrival time of the ROHC packet is unknown or to disable
- * the time-related features in the ROHC protocol.
+ * @param decomp  The ROHC decompressor
+ * @return        true in case of success, false in case of failure
  *
- * @param decomp              The ROHC decompressor
- * @param rohc_packet         The compressed packet to decompress
- * @param[out] uncomp_packet  The resulting uncompressed packet
- * @param[out] rcvd_feedback  The feedback received from the remote peer for
- *                            the same-side associated ROHC compressor through
- *                            the feedback channel:
- *                            \li If NULL, ignore the received feedback data
- *                            \li If not NULL, store the received feedback in
- *                                at the given address
- * @param[out] feedback_send  The feedback to be transmitted to the remote
- *                            compressor through the feedback channel:
- *                            \li If NULL, the decompression won't generate
- *                                feedback information for its compressor
- *                            \li If not NULL, may store the generated
- *                                feedback at the given address
- * @return                    Possible return values:
- *                            \li \ref ROHC_STATUS_OK if a decompressed packet
- *                                is returned
+ * @ingroup rohc_decomp
+ */
+bool rohc_decomp_reset(struct rohc_decomp *const decomp)
+{
+	size_t ctxts_nr;
+	size_t i;
+
+	if(decomp == NULL)
+	{
+		goto error;
+	}
+	ctxts_nr = decomp->active_contexts_nr;
+
+	/* keep all the contexts in use for re-use */
+	for(i = 0; i < decomp->active_contexts_nr; i++)
+	{
+		struct rohc_decomp_ctxt *const context = decomp->active_contexts[i];
+
+		if(context->profile->reset_context != NULL)
+		{
+			const size_t profile_idx =
+				rohc_decomp_get_profile_index(decomp, context->profile);
+
+			context->pool_next = decomp->contexts_pool[profile_idx];
+			decomp->contexts_pool[profile_idx] = context;
+			decomp->contexts_pool_nr++;
+		}
+		else
+		{
+			context_destroy(context);
+		}
+	}
+
+	/* then forget all the contexts at once */
+	rohc_seqlock_write_begin(&decomp->stats_seq);
+	memset(decomp->contexts, 0,
+	       (decomp->medium.max_cid + 1) * sizeof(struct rohc_decomp_ctxt *));
+	decomp->num_contexts_used = 0;
+	rohc_seqlock_write_end(&decomp->stats_seq);
+	decomp->active_contexts_nr = 0;
+	decomp->lru_head = NULL;
+	decomp->lru_tail = NULL;
+	decomp->last_context = NULL;
+
+	/* the cold contexts cannot be revived anymore */
+	if(decomp->cold_ctxts != NULL)
+	{
+		for(i = 0; i <= decomp->medium.max_cid && decomp->cold_ctxts_nr > 0; i++)
+		{
+			if(decomp->cold_ctxts[i] != NULL)
+			{
+				rohc_decomp_cold_drop(decomp, i);
+			}
+		}
+	}
+
+	/* the segments, the frame and the positive feedback waiting for the end
+	 * of the coalescing window are related to the released contexts */
+	rohc_decomp_rru_reset(decomp);
+	decomp->stream_len = 0;
+	decomp->feedback_coalescing.pkts_nr = 0;
+	decomp->feedback_coalescing.pending_nr = 0;
+	decomp->last_pkts_errors = 0;
+
+	rohc_info(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+	          "decompressor reset, %zu contexts released", ctxts_nr);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Decompress the given ROHC packet into one uncompressed packet
+ *
+ * Decompress the given ROHC packet into an uncompressed packet. The
+ * decompression always returns ROHC_OK in case of success. The caller shall
+ * however be ready to handle several cases:
+ *  \li the uncompressed packet \e uncomp_packet might be empty if the ROHC
+ *      packet contained only feedback data or if the ROHC packet was not a
+ *      final segment
+ *  \li the received feedback \e rcvd_feedback might be empty if the ROHC
+ *      packet doesn't contain at least one feedback item
+ *
+ * If \e feedback_send is not NULL, the decompression may return some feedback
+ * information on it. In such a case, the caller is responsible to send it to
+ * the compressor through any feedback channel.
+ *
+ * Time-related features in the ROHC protocol: set the \e rohc_packet.time
+ * parameter to 0 if arrival time of the ROHC packet is unknown or to disable
+ * the time-related features in the ROHC protocol.
+ *
+ * @param decomp              The ROHC decompressor
+ * @param rohc_packet         The compressed packet to decompress
+ * @param[out] uncomp_packet  The resulting uncompressed packet
+ * @param[out] rcvd_feedback  The feedback received from the remote peer for
+ *                            the same-side associated ROHC compressor through
+ *                            the feedback channel:
+ *                            \li If NULL, ignore the received feedback data
+ *                            \li If not NULL, store the received feedback in
+ *                                at the given address
+ *                            \li If a feedback callback is set, the received
+ *                                feedback is given to the callback instead
+ *                                (see \ref rohc_decomp_set_feedback_cb)
+ * @param[out] feedback_send  The feedback to be transmitted to the remote
+ *                            compressor through the feedback channel:
+ *                            \li If NULL, the decompression won't generate
+ *                                feedback information for its compressor
+ *                            \li If not NULL, may store the generated
+ *                                feedback at the given address
+ * @return                    Possible return values:
+ *                            \li \ref ROHC_STATUS_OK if a decompressed packet
+ *                                is returned
  *                            \li \ref ROHC_STATUS_NO_CONTEXT if no
  *                                 decompression context matches the CID
  *                                 stored in the given ROHC packet and the
@@ -705,1025 +1432,5000 @@ rohc_status_t rohc_decompress3(struct rohc_decomp *const decomp,
                                struct rohc_buf *const rcvd_feedback,
                                struct rohc_buf *const feedback_send)
 {
-	rohc_status_t status = ROHC_STATUS_ERROR; /* error status by default */
-	struct rohc_decomp_stream stream;
-
-	/* check inputs validity */
+	/* check decompressor validity */
 	if(decomp == NULL)
 	{
-		goto error;
-	}
-	if(rohc_buf_is_malformed(rohc_packet))
-	{
-		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-		             "given rohc_packet is malformed");
-		goto error;
+		return ROHC_STATUS_ERROR;
 	}
-	if(rohc_buf_is_empty(rohc_packet))
+
+	return __rohc_decompress(decomp, rohc_packet, uncomp_packet,
+	                         rcvd_feedback, feedback_send,
+	                         ROHC_DECOMP_PAYLOAD_COPY, NULL);
+}
+
+
+/**
+ * @brief Decompress a burst of ROHC packets into uncompressed packets
+ *
+ * Decompress the \e pkts_nr given ROHC packets into as many uncompressed
+ * packets. Every packet is decompressed as \ref rohc_decompress3 would do,
+ * but the per-call overhead is paid once for the whole burst and the context
+ * of packet i + 1 is prefetched (see \ref rohc_decomp_prefetch) while packet i
+ * is being decompressed.
+ *
+ * The status of the decompression of every packet is stored in the
+ * \e statuses array. A failure to decompress one packet does not stop the
+ * processing of the burst.
+ *
+ * The feedback received for the same-side associated compressor and the
+ * feedback generated for the remote compressor are not returned per packet:
+ * the feedback items of the whole burst are concatenated in \e rcvd_feedback
+ * and \e feedback_send, so that they may be delivered or sent at once.
+ *
+ * If the \ref ROHC_DECOMP_FEATURE_GROUP_BY_CID feature is enabled, the
+ * packets of the same CID are decompressed back to back, so that their
+ * context stays in the CPU caches: up to 64 consecutive packets at a time
+ * are grouped by CID in the order of the first packet of every CID, and the
+ * packets of one CID keep their order. The packets whose CID cannot be read
+ * without decompressing them, ie. feedback-only packets, ROHC segments and
+ * malformed packets, are not moved and packets are not moved across them.
+ * The results are still stored at the indexes of the given packets, but the
+ * feedback items follow the processing order.
+ *
+ * @param decomp              The ROHC decompressor
+ * @param rohc_packets        The \e pkts_nr ROHC packets to decompress
+ * @param[out] uncomp_packets The \e pkts_nr resulting uncompressed packets,
+ *                            the buffers shall be empty
+ * @param[out] statuses       The \e pkts_nr statuses of the decompression of
+ *                            every packet (see \ref rohc_decompress3 for the
+ *                            possible values)
+ * @param pkts_nr             The number of packets in the burst
+ * @param[out] rcvd_feedback  The feedback received from the remote peer for
+ *                            the same-side associated ROHC compressor for the
+ *                            whole burst, may be NULL to ignore it
+ * @param[out] feedback_send  The feedback to be transmitted to the remote
+ *                            compressor for the whole burst, may be NULL if
+ *                            no feedback shall be generated
+ * @return                    true if the burst was processed (see \e statuses
+ *                            for the result of every packet),
+ *                            false if the given parameters are not valid
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decompress3
+ */
+bool rohc_decompress_batch(struct rohc_decomp *const decomp,
+                           const struct rohc_buf rohc_packets[],
+                           struct rohc_buf uncomp_packets[],
+                           rohc_status_t statuses[],
+                           const size_t pkts_nr,
+                           struct rohc_buf *const rcvd_feedback,
+                           struct rohc_buf *const feedback_send)
+{
+	struct rohc_ts burst_time = { .sec = 0, .nsec = 0 };
+	uint8_t order[ROHC_DECOMP_BATCH_SPAN_MAX];
+	size_t span_first;
+	size_t span_len;
+	size_t k;
+
+	/* check inputs validity once for the whole burst */
+	if(decomp == NULL)
 	{
-		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-		             "given rohc_packet is empty");
 		goto error;
 	}
-	if(uncomp_packet == NULL)
+	if(rohc_packets == NULL || uncomp_packets == NULL || statuses == NULL)
 	{
 		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-		             "given uncomp_packet is NULL");
+		             "given arrays of packets and statuses cannot be NULL");
 		goto error;
 	}
-	if(rohc_buf_is_malformed(*uncomp_packet))
+	if(rcvd_feedback != NULL &&
+	   (rohc_buf_is_malformed(*rcvd_feedback) ||
+	    !rohc_buf_is_empty(*rcvd_feedback)))
 	{
 		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-		             "given uncomp_packet is malformed");
+		             "given rcvd_feedback is malformed or not empty");
 		goto error;
 	}
-	if(!rohc_buf_is_empty(*uncomp_packet))
+	if(feedback_send != NULL &&
+	   (rohc_buf_is_malformed(*feedback_send) ||
+	    !rohc_buf_is_empty(*feedback_send)))
 	{
 		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-		             "given uncomp_packet is not empty");
+		             "given feedback_send is malformed or not empty");
 		goto error;
 	}
-	if(rcvd_feedback != NULL)
-	{
-		if(rohc_buf_is_malformed(*rcvd_feedback))
-		{
-			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-			             "given rcvd_feedback is malformed");
-			goto error;
-		}
-		if(!rohc_buf_is_empty(*rcvd_feedback))
-		{
-			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-			             "given rcvd_feedback is not empty");
-			goto error;
-		}
-	}
-	if(feedback_send != NULL)
-	{
-		if(rohc_buf_is_malformed(*feedback_send))
-		{
-			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-			             "given feedback_send is malformed");
-			goto error;
-		}
-		if(!rohc_buf_is_empty(*feedback_send))
-		{
-			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-			             "given feedback_send is not empty");
-			goto error;
-		}
-	}
-
-	decomp->stats.received++;
-	rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-	           "decompress the %zu-byte packet #%lu", rohc_packet.len,
-	           decomp->stats.received);
 
-	/* print compressed bytes */
-	if((decomp->features & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0)
+	/* the packets of unknown arrival time share the arrival time of the
+	 * first packet of the burst, or the coarse clock read once */
+	if(pkts_nr > 0)
 	{
-		rohc_dump_packet(decomp->trace_callback, decomp->trace_callback_priv,
-		                 ROHC_TRACE_DECOMP, ROHC_TRACE_DEBUG,
-		                 "compressed data, max 100 bytes", rohc_packet);
+		burst_time = rohc_decomp_arrival_time(decomp, rohc_packets[0].time);
 	}
 
-	/* decode ROHC header */
-	status = d_decode_header(decomp, rohc_packet, uncomp_packet, rcvd_feedback,
-	                         &stream);
-	assert(status != ROHC_STATUS_SEGMENT);
-
-	/* handle mode transitions if context was found and it is still valid */
-	if(stream.context != NULL)
+	/* the burst is processed span by span, the packets of one span are
+	 * processed in the given order or grouped by CID */
+	for(span_first = 0; span_first < pkts_nr; span_first += span_len)
 	{
-		if(stream.context->mode == ROHC_U_MODE)
+		span_len = rohc_decomp_batch_order(decomp, rohc_packets + span_first,
+		                                   pkts_nr - span_first, order);
+		assert(span_len > 0);
+
+		for(k = 0; k < span_len; k++)
 		{
-			if(decomp->target_mode == ROHC_U_MODE)
+			/* the first packet of the next span is processed right after the
+			 * last packet of the current span */
+			const size_t i = span_first + order[k];
+			const size_t next1 =
+				span_first + ((k + 1) < span_len ? order[k + 1] : (k + 1));
+			const size_t next2 =
+				span_first + ((k + 2) < span_len ? order[k + 2] : (k + 2));
+			struct rohc_buf rohc_packet = rohc_packets[i];
+			const size_t rcvd_feedback_len =
+				(rcvd_feedback != NULL ? rcvd_feedback->len : 0);
+			const size_t feedback_send_len =
+				(feedback_send != NULL ? feedback_send->len : 0);
+
+			/* warm up the caches for the next packets while decompressing the
+			 * current one: the data of the packet after the next one and the
+			 * context of the next one, whose data was prefetched during the
+			 * previous iteration */
+			if(next2 < pkts_nr && !rohc_buf_is_malformed(rohc_packets[next2]))
 			{
-				rohc_debug(decomp, ROHC_TRACE_DECOMP, stream.profile_id,
-				           "stay in U-mode as requested by user");
+				__builtin_prefetch(rohc_buf_data(rohc_packets[next2]), 0, 3);
 			}
-			else if(decomp->target_mode == ROHC_O_MODE)
+			if(next1 < pkts_nr)
 			{
-				rohc_debug(decomp, ROHC_TRACE_DECOMP, stream.profile_id,
-				           "transit from U-mode to O-mode as requested by user");
-				stream.context->mode = ROHC_O_MODE;
-				/* ACK(O), NACK(O) or STATIC-NACK(O) will transmit the mode
-				 * transition to the remote compressor */
-				stream.mode = ROHC_O_MODE;
-				stream.do_change_mode = true;
+				(void) rohc_decomp_prefetch(decomp, rohc_packets[next1]);
 			}
-			else /* R-mode */
+
+			/* hide the feedback items of the previous packets, so that the
+			 * feedback items of the current packet are appended after them */
+			if(rcvd_feedback != NULL)
 			{
-				assert(0); /* TODO: R-mode not supported yet */
-				status = ROHC_STATUS_ERROR;
-				goto error;
+				rohc_buf_pull(rcvd_feedback, rcvd_feedback_len);
 			}
-		}
-		else if(stream.context->mode == ROHC_O_MODE)
-		{
-			if(decomp->target_mode == ROHC_U_MODE)
+			if(feedback_send != NULL)
 			{
-				assert(0); /* TODO: O- to U-mode transition not supported yet */
-				status = ROHC_STATUS_ERROR;
-				goto error;
+				rohc_buf_pull(feedback_send, feedback_send_len);
 			}
-			else if(decomp->target_mode == ROHC_O_MODE)
+
+			if(rohc_packet.time.sec == 0 && rohc_packet.time.nsec == 0)
 			{
-				rohc_debug(decomp, ROHC_TRACE_DECOMP, stream.profile_id,
-				           "stay in O-mode as requested by user");
+				rohc_packet.time = burst_time;
 			}
-			else /* R-mode */
+			statuses[i] = __rohc_decompress(decomp, rohc_packet,
+			                                &uncomp_packets[i], rcvd_feedback,
+			                                feedback_send,
+			                                ROHC_DECOMP_PAYLOAD_COPY, NULL);
+
+			/* unhide the feedback items of the previous packets */
+			if(rcvd_feedback != NULL)
 			{
-				assert(0); /* TODO: R-mode not supported yet */
-				status = ROHC_STATUS_ERROR;
-				goto error;
+				rohc_buf_push(rcvd_feedback, rcvd_feedback_len);
+			}
+			if(feedback_send != NULL)
+			{
+				rohc_buf_push(feedback_send, feedback_send_len);
 			}
 		}
-		else /* R-mode */
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Order the packets of the next span of a burst
+ *
+ * Without the \ref ROHC_DECOMP_FEATURE_GROUP_BY_CID feature, the packets
+ * are processed in the given order. Otherwise the packets of the span are
+ * grouped by CID in the order of the first packet of every CID, and the
+ * packets of one CID keep their order. The span stops before the first
+ * packet whose CID cannot be read, such a packet makes a span on its own.
+ *
+ * @param decomp        The ROHC decompressor
+ * @param rohc_packets  The packets of the burst from the start of the span
+ * @param pkts_nr       The number of packets left in the burst, at least 1
+ * @param[out] order    The indexes of the packets of the span, relative to
+ *                      the start of the span, in processing order
+ * @return              The number of packets in the span
+ */
+static size_t rohc_decomp_batch_order(const struct rohc_decomp *const decomp,
+                                      const struct rohc_buf rohc_packets[],
+                                      const size_t pkts_nr,
+                                      uint8_t order[ROHC_DECOMP_BATCH_SPAN_MAX])
+{
+	const size_t span_max = rohc_min(pkts_nr, ROHC_DECOMP_BATCH_SPAN_MAX);
+	rohc_cid_t cids[ROHC_DECOMP_BATCH_SPAN_MAX];
+	bool is_ordered[ROHC_DECOMP_BATCH_SPAN_MAX];
+	size_t span_len;
+	size_t order_nr;
+	size_t i;
+	size_t j;
+
+	assert(pkts_nr > 0);
+
+	/* keep the given order */
+	if((decomp->features & ROHC_DECOMP_FEATURE_GROUP_BY_CID) == 0)
+	{
+		for(i = 0; i < span_max; i++)
 		{
-			assert(0); /* TODO: R-mode not supported yet */
-			status = ROHC_STATUS_ERROR;
-			goto error;
+			order[i] = i;
 		}
+		return span_max;
 	}
 
-	/* update statistics and send feedback if needed */
-	if(status == ROHC_STATUS_OK)
+	/* the packets whose CID cannot be read are not moved */
+	for(span_len = 0; span_len < span_max; span_len++)
 	{
-		/* print a trace to report success (the context may be NULL if packet
-		 * was a feedback-only packet) */
-		rohc_debug(decomp, ROHC_TRACE_DECOMP, stream.profile_id,
-		           "packet decompression succeeded");
-
-		/* do not update statistics and build positive feedback for feedback-only
-		 * packets */
-		if(uncomp_packet->len > 0)
+		if(!rohc_decomp_peek_pkt_cid(decomp, rohc_packets[span_len],
+		                             &cids[span_len]))
 		{
-			/* update statistics */
-			rohc_debug(decomp, ROHC_TRACE_DECOMP, stream.profile_id,
-			           "update decompressor and context statistics");
-			assert(stream.context != NULL);
-			stream.context->num_recv_packets++;
-			stream.context->packet_type = stream.packet_type;
-			stream.context->total_uncompressed_size += uncomp_packet->len;
-			stream.context->total_compressed_size += rohc_packet.len;
-			decomp->stats.total_uncompressed_size += uncomp_packet->len;
-			decomp->stats.total_compressed_size += rohc_packet.len;
+			break;
+		}
+		is_ordered[span_len] = false;
+	}
+	if(span_len == 0)
+	{
+		order[0] = 0;
+		return 1;
+	}
 
-			/* build positive feedback if asked by user and if needed by decompressor */
-			if(!rohc_decomp_feedback_ack(decomp, &stream, feedback_send))
+	/* group the packets by CID, the first packet of every group comes first */
+	order_nr = 0;
+	for(i = 0; i < span_len; i++)
+	{
+		if(is_ordered[i])
+		{
+			continue;
+		}
+		for(j = i; j < span_len; j++)
+		{
+			if(!is_ordered[j] && cids[j] == cids[i])
 			{
-				rohc_warning(decomp, ROHC_TRACE_DECOMP, stream.profile_id,
-				             "failed to build positive feedback");
-				status = ROHC_STATUS_ERROR;
-				goto error;
+				order[order_nr] = j;
+				order_nr++;
+				is_ordered[j] = true;
 			}
 		}
 	}
-	else /* packet failed to be decompressed */
-	{
-		/* in case of failure, users shall get an empty decompressed packet */
-		uncomp_packet->len = 0;
+	assert(order_nr == span_len);
 
-		rohc_warning(decomp, ROHC_TRACE_DECOMP, stream.profile_id,
-		             "packet decompression failed: %s (%d)",
-		             rohc_strerror(status), status);
+	return span_len;
+}
 
-		/* update statistics */
-		if(stream.context != NULL)
-		{
-			stream.context->num_recv_packets++;
-		}
-		switch(status)
-		{
-			case ROHC_STATUS_MALFORMED:
-			case ROHC_STATUS_OUTPUT_TOO_SMALL:
-			case ROHC_STATUS_ERROR:
-				decomp->stats.failed_decomp++;
-				break;
-			case ROHC_STATUS_NO_CONTEXT:
-				decomp->stats.failed_no_context++;
-				break;
-			case ROHC_STATUS_BAD_CRC:
-				decomp->stats.failed_crc++;
-				break;
-			case ROHC_STATUS_OK: /* success codes shall not happen */
-			case ROHC_STATUS_SEGMENT:
-			default:
-				assert(0);
-				status = ROHC_STATUS_ERROR;
-				goto error;
-		}
 
-		/* build negative feedback if asked by user and if needed by decompressor */
-		if(!rohc_decomp_feedback_nack(decomp, &stream, feedback_send))
-		{
-			rohc_warning(decomp, ROHC_TRACE_DECOMP, stream.profile_id,
-			             "failed to build negative feedback");
-			status = ROHC_STATUS_ERROR;
-			goto error;
-		}
+/**
+ * @brief Prefetch the decompression context of the given ROHC packet
+ *
+ * Decode the CID of the given ROHC packet and warm up the caches with the
+ * decompression context it designates and with the profile-specific part of
+ * that context. Call it with the next ROHC packet while the previous one is
+ * still being processed, so that \ref rohc_decompress3 does not wait for the
+ * context to be fetched from memory.
+ *
+ * The function is only a hint: it does not modify the decompressor and it
+ * does not report malformed packets. Feedback-only packets and ROHC segments
+ * are not looked into.
+ *
+ * @param decomp       The ROHC decompressor
+ * @param rohc_packet  The ROHC packet to be decompressed next
+ * @return             true if the context of the packet was prefetched,
+ *                     false if the packet designates no context
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decompress3
+ * @see rohc_decompress_batch
+ */
+bool rohc_decomp_prefetch(const struct rohc_decomp *const decomp,
+                          const struct rohc_buf rohc_packet)
+{
+	const struct rohc_decomp_ctxt *context;
+	rohc_cid_t cid;
+
+	if(decomp == NULL ||
+	   !rohc_decomp_peek_pkt_cid(decomp, rohc_packet, &cid))
+	{
+		goto error;
+	}
+
+	/* the context and its profile-specific part are updated by the
+	 * decompression of the packet */
+	context = find_context(decomp, cid);
+	if(context == NULL)
+	{
+		goto error;
 	}
+	__builtin_prefetch(context, 1, 3);
+	__builtin_prefetch(context->persist_ctxt, 1, 3);
+
+	return true;
 
 error:
-	return status;
+	return false;
 }
 
 
 /**
- * @brief Decompress the compressed headers.
+ * @brief Decompress the given ROHC packet in place
+ *
+ * Decompress the given ROHC packet as \ref rohc_decompress3 would do, but
+ * rebuild the uncompressed headers in the same buffer, just in front of the
+ * payload: the payload is neither copied nor moved. The network buffer is
+ * updated to describe the resulting uncompressed packet.
+ *
+ * The free space at the beginning of the network buffer (the headroom, see
+ * \ref rohc_buf_push) is used to build the uncompressed headers before they
+ * are moved in front of the payload: the headroom shall be large enough for
+ * the uncompressed headers, otherwise \ref ROHC_STATUS_OUTPUT_TOO_SMALL is
+ * returned.
+ *
+ * The payload of a ROHC packet reassembled from ROHC segments cannot be
+ * reused, so in-place decompression of ROHC segments is not supported.
  *
  * @param decomp              The ROHC decompressor
- * @param rohc_packet         The ROHC packet to decode
- * @param[out] uncomp_packet  The uncompressed packet
+ * @param[in,out] packet      IN:  The ROHC packet to decompress, with some
+ *                                 free space at the beginning of the buffer
+ *                            OUT: The resulting uncompressed packet, empty
+ *                                 for a feedback-only packet, or the
+ *                                 unchanged ROHC packet in case of error
+ *                                 (the content of the buffer is lost)
  * @param[out] rcvd_feedback  The feedback received from the remote peer for
- *                            the same-side associated ROHC compressor through
- *                            the feedback channel:
- *                            \li If NULL, ignore the received feedback data
- *                            \li If not NULL, store the received feedback in
- *                                at the given address
- * @param[out] stream         The informations about the decompressed stream,
- *                            required for sending feedback to compressor
- * @return                    Possible return values:
- *                            \li ROHC_STATUS_OK if packet is successfully
- *                                decoded,
- *                            \li ROHC_STATUS_NO_CONTEXT if no matching
- *                                context was found and packet cannot create
- *                                a new context (or failed to do so),
- *                            \li ROHC_STATUS_MALFORMED if packet is
- *                                malformed,
- *                            \li ROHC_STATUS_BAD_CRC if a CRC error occurs,
- *                            \li ROHC_STATUS_ERROR if another error occurs
+ *                            the same-side associated ROHC compressor,
+ *                            may be NULL to ignore it
+ * @param[out] feedback_send  The feedback to be transmitted to the remote
+ *                            compressor, may be NULL if no feedback shall
+ *                            be generated
+ * @return                    The same values as \ref rohc_decompress3
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decompress3
  */
-static rohc_status_t d_decode_header(struct rohc_decomp *decomp,
-                                     const struct rohc_buf rohc_packet,
-                                     struct rohc_buf *const uncomp_packet,
-                                     struct rohc_buf *const rcvd_feedback,
-                                     struct rohc_decomp_stream *const stream)
+rohc_status_t rohc_decompress_inplace(struct rohc_decomp *const decomp,
+                                      struct rohc_buf *const packet,
+                                      struct rohc_buf *const rcvd_feedback,
+                                      struct rohc_buf *const feedback_send)
 {
-	const struct rohc_decomp_profile *profile;
-	bool is_new_context = false;
-	size_t sn_feedback_min_bits;
-	size_t add_cid_len;
-	size_t large_cid_len;
-
-	struct rohc_buf remain_rohc_data = rohc_packet;
-	const uint8_t *walk;
-	size_t remain_len;
-
+	struct rohc_buf uncomp_packet;
 	rohc_status_t status;
 
-	/* at the beginning, context is not found yet but channel CID type is known */
-	stream->profile_id = ROHC_PROFILE_GENERAL;
-	stream->cid_type = decomp->medium.cid_type;
-	stream->cid_found = false;
-	stream->cid = SIZE_MAX;
-	stream->context_found = false;
-	stream->context = NULL;
-	stream->mode = ROHC_UNKNOWN_MODE;
-	stream->state = ROHC_DECOMP_STATE_UNKNOWN;
-	stream->do_change_mode = false;
-	stream->sn_bits = 0; /* must be set to 0 until we get some bits */
-	stream->sn_bits_nr = 0;
-	stream->packet_type = ROHC_PACKET_UNKNOWN;
-	stream->crc_failed = false;
-
-	/* empty ROHC packets are not considered as valid */
-	if(remain_rohc_data.len < 1)
+	/* check inputs validity */
+	if(decomp == NULL)
+	{
+		goto error;
+	}
+	if(packet == NULL)
 	{
 		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-		             "ROHC packet too small (len = %zu, at least 1 byte "
-		             "required)", remain_rohc_data.len);
-		goto error_malformed;
+		             "given packet is NULL");
+		goto error;
+	}
+	if(packet->offset == 0)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "given packet has no headroom");
+		goto error;
 	}
 
-	/* skip padding bits if some are present */
-	rohc_decomp_parse_padding(decomp, &remain_rohc_data);
+	/* the uncompressed headers are built in the headroom of the packet */
+	uncomp_packet.time = packet->time;
+	uncomp_packet.data = packet->data;
+	uncomp_packet.max_len = packet->offset;
+	uncomp_packet.offset = 0;
+	uncomp_packet.len = 0;
 
-	/* padding-only packets are not allowed according to RFC 3095, §5.2:
-	 *   Padding is any number (zero or more) of padding octets.  Either of
-	 *   Feedback or Header must be present. */
-	if(remain_rohc_data.len == 0)
+	status = __rohc_decompress(decomp, *packet, &uncomp_packet, rcvd_feedback,
+	                           feedback_send, ROHC_DECOMP_PAYLOAD_INPLACE, NULL);
+	if(status == ROHC_STATUS_OK)
 	{
-		rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-		           "padding-only packet is not allowed");
-		goto error_malformed;
+		if(uncomp_packet.len > 0)
+		{
+			*packet = uncomp_packet;
+		}
+		else
+		{
+			/* feedback-only packet */
+			packet->len = 0;
+		}
 	}
 
-	/* extract feedback items if present */
-	if(!rohc_decomp_parse_feedbacks(decomp, &remain_rohc_data, rcvd_feedback))
+	return status;
+
+error:
+	return ROHC_STATUS_ERROR;
+}
+
+
+/**
+ * @brief Decompress the headers of the given ROHC packet only
+ *
+ * Decompress the given ROHC packet as \ref rohc_decompress3 would do, but
+ * write only the uncompressed headers in the given buffer: the payload is not
+ * copied. The offset and the length of the payload in the
+ * ROHC packet are returned instead, so that the caller may put the
+ * uncompressed headers in front of a payload that is stored elsewhere (the
+ * paged fragments of a network buffer for example).
+ *
+ * The uncompressed packet is the uncompressed headers followed by the
+ * \e payload_len bytes found at \e payload_offset in \e rohc_packet.
+ *
+ * The payload of a ROHC packet reassembled from ROHC segments is not stored
+ * in the given ROHC packet, so ROHC segments are not supported by this
+ * function.
+ *
+ * @param decomp               The ROHC decompressor
+ * @param rohc_packet          The ROHC packet to decompress
+ * @param[out] uncomp_header   The resulting uncompressed headers, the buffer
+ *                             shall be empty, it is empty for a
+ *                             feedback-only packet
+ * @param[out] payload_offset  The offset of the payload in \e rohc_packet
+ * @param[out] payload_len     The length of the payload
+ * @param[out] rcvd_feedback   The feedback received from the remote peer for
+ *                             the same-side associated ROHC compressor,
+ *                             may be NULL to ignore it
+ * @param[out] feedback_send   The feedback to be transmitted to the remote
+ *                             compressor, may be NULL if no feedback shall
+ *                             be generated
+ * @return                     The same values as \ref rohc_decompress3
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decompress3
+ * @see rohc_compress_header
+ */
+rohc_status_t rohc_decompress_header(struct rohc_decomp *const decomp,
+                                     const struct rohc_buf rohc_packet,
+                                     struct rohc_buf *const uncomp_header,
+                                     size_t *const payload_offset,
+                                     size_t *const payload_len,
+                                     struct rohc_buf *const rcvd_feedback,
+                                     struct rohc_buf *const feedback_send)
+{
+	rohc_status_t status;
+	size_t len = 0;
+
+	/* check inputs validity */
+	if(decomp == NULL)
 	{
-		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-		             "failed to decode feedback items at the beginning of the "
-		             "ROHC packet");
-		goto error_malformed;
+		goto error;
 	}
-	if(rcvd_feedback != NULL)
+	if(payload_offset == NULL || payload_len == NULL)
 	{
-		rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-		           "decompressor received %zu bytes of feedback for the "
-		           "same-side associated compressor", rcvd_feedback->len);
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "given payload_offset and payload_len cannot be NULL");
+		goto error;
 	}
-	walk = rohc_buf_data(remain_rohc_data);
-	remain_len = remain_rohc_data.len;
 
-	/* is there some data after feedback? */
-	if(remain_rohc_data.len == 0)
+	status = __rohc_decompress(decomp, rohc_packet, uncomp_header,
+	                           rcvd_feedback, feedback_send,
+	                           ROHC_DECOMP_PAYLOAD_NONE, &len);
+	if(status == ROHC_STATUS_OK)
 	{
-		rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-		           "feedback-only packet, stop decompression");
-		goto skip;
+		/* the payload is always the last part of the ROHC packet */
+		*payload_offset = rohc_packet.len - len;
+		*payload_len = len;
 	}
 
-	/* ROHC segment? */
-	if(rohc_decomp_packet_is_segment(walk))
-	{
-		const bool is_final = !!GET_REAL(GET_BIT_0(walk));
-		uint32_t crc_computed;
+	return status;
 
-		/* skip the segment type byte */
-		walk++;
-		remain_len--;
-		rohc_buf_pull(&remain_rohc_data, 1);
+error:
+	return ROHC_STATUS_ERROR;
+}
 
-		rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-		           "ROHC packet is a %zu-byte %s segment", remain_len,
-		           is_final ? "final" : "non-final");
 
-		/* store all the remaining ROHC data in RRU */
-		if((decomp->rru_len + remain_len) > decomp->mrru)
+/**
+ * @brief Set the framing of the byte stream given to \ref rohc_decompress_stream
+ *
+ * On links that deliver the ROHC packets as a byte stream, the application
+ * receives chunks of bytes that do not match the frames of the link. The
+ * given callback finds the frames in the stream and the ROHC packets they
+ * carry (see \ref rohc_decomp_frame_cb_t), so that the chunks may be given
+ * as is to \ref rohc_decompress_stream.
+ *
+ * A buffer of \e max_frame_len bytes is allocated to hold the frame that
+ * spans several chunks, if any. The ROHC packets larger than one frame may
+ * be transmitted as ROHC segments (see \ref rohc_decomp_set_mrru).
+ *
+ * The bytes of a frame that was not complete yet are dropped.
+ *
+ * @param decomp         The ROHC decompressor
+ * @param callback       The callback function that finds the frames,
+ *                       NULL to free the buffer for frames
+ * @param priv           The private context given to the callback function
+ * @param max_frame_len  The maximum length of one frame, framing included
+ * @return               true if the framing was successfully set,
+ *                       false if a problem occurred
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decompress_stream
+ */
+bool rohc_decomp_set_stream_framing(struct rohc_decomp *const decomp,
+                                    rohc_decomp_frame_cb_t callback,
+                                    void *const priv,
+                                    const size_t max_frame_len)
+{
+	uint8_t *new_buf = NULL;
+
+	if(decomp == NULL)
+	{
+		goto error;
+	}
+	if(callback != NULL && max_frame_len == 0)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "maximum length of frames shall not be zero");
+		goto error;
+	}
+
+	/* the buffer for frames is allocated once, not when packets arrive */
+	if(callback != NULL)
+	{
+		new_buf = malloc(max_frame_len);
+		if(new_buf == NULL)
 		{
 			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-			             "invalid RRU: received segment is too large for MRRU "
-			             "(%zu bytes already received, %zu bytes received, "
-			             "MRRU = %zu bytes", decomp->rru_len, remain_len,
-			             decomp->mrru);
-			/* dicard RRU */
-			decomp->rru_len = 0;
-			goto error_malformed;
+			             "failed to allocate memory for %zu-byte frames",
+			             max_frame_len);
+			goto error;
 		}
-		rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-		           "append new segment to the %zd bytes we already received",
-		           decomp->rru_len);
-		memcpy(decomp->rru + decomp->rru_len, walk, remain_len);
-		decomp->rru_len += remain_len;
+	}
+	zfree(decomp->stream_buf);
+	decomp->stream_buf = new_buf;
+	decomp->stream_len = 0;
+	decomp->stream_max_len = (callback != NULL ? max_frame_len : 0);
 
-		/* stop decoding here is not final segment */
-		if(!is_final)
-		{
-			rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-			           "%zd bytes of RRU already received, wait for more "
-			           "segments before decompressing RRU", decomp->rru_len);
-			goto skip;
-		}
+	decomp->frame_cb = callback;
+	decomp->frame_cb_priv = priv;
 
-		/* final segment received, let's check CRC */
-		if(decomp->rru_len <= 4)
-		{
-			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-			             "invalid %zd-byte RRU: should be more than 4-byte long",
-			             decomp->rru_len);
-			/* discard RRU */
-			decomp->rru_len = 0;
-			goto error_malformed;
-		}
-		decomp->rru_len -= 4;
-		rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-		           "final segment received, check the 4-byte CRC of the "
-		           "%zd-byte RRU", decomp->rru_len);
-		crc_computed = crc_calc_fcs32(decomp->rru, decomp->rru_len,
-		                              CRC_INIT_FCS32);
-		if(memcmp(&crc_computed, decomp->rru + decomp->rru_len, 4) != 0)
-		{
-			uint32_t crc_packet;
-			memcpy(&crc_packet, decomp->rru + decomp->rru_len, 4);
-			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-			             "invalid %zd-byte RRU: bad CRC (packet = 0x%08x, "
-			             "computed = 0x%08x)", decomp->rru_len,
-			             rohc_ntoh32(crc_packet), rohc_ntoh32(crc_computed));
-			/* discard RRU */
-			decomp->rru_len = 0;
-			goto error_crc;
-		}
+	return true;
 
-		/* CRC of segment is OK, let's decode RRU */
-		rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-		           "final segment received, decode the %zd-byte RRU",
-		           decomp->rru_len);
-		walk = decomp->rru;
-		remain_len = decomp->rru_len;
-		remain_rohc_data.offset = 0;
-		remain_rohc_data.data = decomp->rru;
-		remain_rohc_data.len = decomp->rru_len;
-		remain_rohc_data.max_len = decomp->rru_len;
+error:
+	return false;
+}
 
-		/* reset context for next RRU */
-		decomp->rru_len = 0;
-	}
 
-	/* decode small or large CID */
-	if(!rohc_decomp_decode_cid(decomp, walk, remain_len, &stream->cid,
-	                           &add_cid_len, &large_cid_len))
+/**
+ * @brief Decompress the next ROHC packet of a byte stream
+ *
+ * Find the next frame in the given chunk of the byte stream with the framing
+ * set by \ref rohc_decomp_set_stream_framing, then decompress the ROHC packet
+ * it carries as \ref rohc_decompress3 would do. The frame is consumed from
+ * the chunk, so that the function is called again and again until the chunk
+ * is empty:
+ * \code
+	while(chunk.len > 0)
 	{
-		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-		             "failed to decode small or large CID in packet");
-		goto error_malformed;
+		status = rohc_decompress_stream(decomp, &chunk, &uncomp_packet, NULL, NULL);
+		...
 	}
-	stream->cid_found = true;
+\endcode
+ *
+ * The ROHC packets of the frames that are complete in the chunk are
+ * decompressed from the chunk itself, without any copy. Only the frame that
+ * starts in one chunk and ends in the next ones is copied in the buffer of
+ * the decompressor. The bytes at the end of the chunk that do not complete a
+ * frame are consumed too: the function then returns \ref ROHC_STATUS_OK with
+ * an empty uncompressed packet.
+ *
+ * The frame is consumed whatever the result of the decompression, except
+ * \ref ROHC_STATUS_OUTPUT_TOO_SMALL: the decompression may then be retried
+ * with a larger output buffer, with an empty chunk if the frame was the last
+ * one of the chunk. If the framing is broken, the chunk is left
+ * unchanged, the bytes of the incomplete frame are dropped and
+ * \ref ROHC_STATUS_MALFORMED is returned: the application shall resynchronize
+ * on the stream before giving the next bytes.
+ *
+ * @param decomp              The ROHC decompressor
+ * @param[in,out] chunk       IN:  The next bytes of the stream
+ *                            OUT: The bytes that remain after the frame
+ * @param[out] uncomp_packet  The resulting uncompressed packet, empty if no
+ *                            complete frame was found in the chunk
+ * @param[out] rcvd_feedback  The feedback received from the remote peer for
+ *                            the same-side associated ROHC compressor,
+ *                            may be NULL to ignore it
+ * @param[out] feedback_send  The feedback to be transmitted to the remote
+ *                            compressor, may be NULL if no feedback shall
+ *                            be generated
+ * @return                    The same values as \ref rohc_decompress3
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_set_stream_framing
+ * @see rohc_decompress3
+ */
+rohc_status_t rohc_decompress_stream(struct rohc_decomp *const decomp,
+                                     struct rohc_buf *const chunk,
+                                     struct rohc_buf *const uncomp_packet,
+                                     struct rohc_buf *const rcvd_feedback,
+                                     struct rohc_buf *const feedback_send)
+{
+	struct rohc_buf rohc_packet;
+	size_t frame_len = 0;
+	size_t rohc_offset = 0;
+	size_t rohc_len = 0;
+	size_t copy_len;
+	rohc_status_t status;
 
-	/* check whether the decoded CID is allowed by the decompressor */
-	if(stream->cid > decomp->medium.max_cid)
+	/* check inputs validity */
+	if(decomp == NULL)
 	{
-		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-		             "unexpected CID %zu received: MAX_CID was set to %zu",
-		             stream->cid, decomp->medium.max_cid);
-		goto error_no_context;
+		goto error;
 	}
-
-	/* skip add-CID if present */
-	walk += add_cid_len;
-	remain_len -= add_cid_len;
-	rohc_buf_pull(&remain_rohc_data, add_cid_len);
-
-	/* find the context according to the CID found in CID,
-	 * create it if needed (and possible) */
-	status = rohc_decomp_find_context(decomp, walk, remain_len, stream->cid,
-	                                  large_cid_len, rohc_packet.time,
-	                                  &stream->profile_id, &stream->context,
-	                                  &is_new_context);
-	if(status == ROHC_STATUS_MALFORMED)
+	if(decomp->frame_cb == NULL)
 	{
-		/* no additional feedback information to collect */
-		goto error_malformed;
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "no framing set for the byte stream");
+		goto error;
 	}
-	else if(status == ROHC_STATUS_NO_CONTEXT)
+	if(chunk == NULL || rohc_buf_is_malformed(*chunk))
 	{
-		/* even if the context was not found/created, the profile ID might be available */
-		goto error_no_context;
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "given chunk is NULL or malformed");
+		goto error;
 	}
-	assert(status == ROHC_STATUS_OK);
-	profile = stream->context->profile;
-	decomp->last_context = stream->context;
-	sn_feedback_min_bits = rohc_min(decomp->sn_feedback_min_bits,
-	                                profile->msn_max_bits);
-
-	/* collect information for sending feedback to decompressor */
-	stream->context_found = true;
-	stream->mode = stream->context->mode;
-	stream->state = stream->context->state;
-	if(!is_new_context)
+	if(uncomp_packet == NULL)
 	{
-		stream->sn_bits = profile->get_sn(stream->context);
-		stream->sn_bits_nr = sn_feedback_min_bits;
-		rohc_decomp_debug(stream->context, "%zu bits required for SN in feedback "
-		                  "(%zu bits required for RTT, %zu max)",
-		                  sn_feedback_min_bits, decomp->sn_feedback_min_bits,
-		                  profile->msn_max_bits);
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "given uncomp_packet is NULL");
+		goto error;
 	}
 
-	/* detect the type of the ROHC packet */
-	stream->packet_type = profile->detect_pkt_type(stream->context, walk, remain_len,
-	                                               large_cid_len);
-	if(stream->packet_type == ROHC_PACKET_UNKNOWN)
+	if(decomp->stream_len == 0)
 	{
-		rohc_warning(decomp, ROHC_TRACE_DECOMP, profile->id,
-		             "failed to detect ROHC packet type");
-		if(is_new_context)
+		if(rohc_buf_is_empty(*chunk))
 		{
-			context_free(stream->context);
-			stream->context = NULL;
-			decomp->last_context = NULL;
+			uncomp_packet->len = 0;
+			return ROHC_STATUS_OK;
 		}
-		goto error_malformed;
-	}
-	rohc_decomp_debug(stream->context, "decode packet as '%s'",
-	                  rohc_get_packet_descr(stream->packet_type));
 
-	/* only packets that carry static informations can be received in the
-	 * No Context state, other cannot */
-	if(stream->state == ROHC_DECOMP_STATE_NC &&
-	   !rohc_decomp_packet_carry_static_info(stream->packet_type))
-	{
-		rohc_warning(decomp, ROHC_TRACE_DECOMP, profile->id,
-		             "packet '%s' (%d) does not carry static information, it cannot "
-		             "be received in No Context state",
-		             rohc_get_packet_descr(stream->packet_type),
-		             stream->packet_type);
-		if(is_new_context)
+		/* no frame in progress: decompress the frame from the chunk itself if
+		 * it is complete */
+		if(!rohc_decomp_find_frame(decomp, rohc_buf_data(*chunk), chunk->len,
+		                           &frame_len, &rohc_offset, &rohc_len))
 		{
-			context_free(stream->context);
-			stream->context = NULL;
-			decomp->last_context = NULL;
+			goto malformed;
 		}
-		goto error_malformed;
-	}
-	/* only packets carrying CRC-7 or CRC-8 can be received in the Static Context
-	 * state, other cannot */
-	else if(stream->state == ROHC_DECOMP_STATE_SC &&
-	        !rohc_decomp_packet_carry_crc_7_or_8(stream->packet_type))
-	{
-		rohc_warning(decomp, ROHC_TRACE_DECOMP, profile->id,
-		             "packet '%s' (%d) does not carry 7- or 8-bit CRC, it cannot "
-		             "be received in Static Context state",
-		             rohc_get_packet_descr(stream->packet_type),
-		             stream->packet_type);
-		if(is_new_context)
+		if(frame_len > 0 && frame_len <= chunk->len)
 		{
-			context_free(stream->context);
-			stream->context = NULL;
-			decomp->last_context = NULL;
+			rohc_packet = *chunk;
+			rohc_buf_pull(&rohc_packet, rohc_offset);
+			rohc_packet.len = rohc_len;
+
+			status = __rohc_decompress(decomp, rohc_packet, uncomp_packet,
+			                           rcvd_feedback, feedback_send,
+			                           ROHC_DECOMP_PAYLOAD_COPY, NULL);
+			if(status != ROHC_STATUS_OUTPUT_TOO_SMALL)
+			{
+				rohc_buf_pull(chunk, frame_len);
+			}
+			return status;
 		}
-		goto error_malformed;
 	}
-	/* all packet types are allowed in Full Context state */
-
-	/* only IR packet can create a new context */
-	assert(stream->packet_type == ROHC_PACKET_IR || !is_new_context);
-
-	/* decode the packet thanks to the profile-specific routines
-	 * (may change the initial assumption about the packet type) */
-	status = rohc_decomp_decode_pkt(decomp, stream->context, remain_rohc_data,
-	                                add_cid_len, large_cid_len, uncomp_packet,
-	                                &stream->packet_type, &stream->do_change_mode);
-	if(status != ROHC_STATUS_OK)
+	else if(!rohc_decomp_find_frame(decomp, decomp->stream_buf,
+	                                decomp->stream_len, &frame_len,
+	                                &rohc_offset, &rohc_len))
 	{
-		/* decompression failed, free ressources if necessary */
-		rohc_warning(decomp, ROHC_TRACE_DECOMP, profile->id,
-		             "failed to decompress packet (code = %d)", status);
-		if(is_new_context)
-		{
-			context_free(stream->context);
-			stream->context = NULL;
-			decomp->last_context = NULL;
-		}
-		goto error;
+		goto malformed;
 	}
 
-	/* decompression was successful, replace the existing context with the
-	 * new one if necessary */
-	if(is_new_context)
+	/* the frame is incomplete: copy the bytes of the chunk that belong to it,
+	 * all of them if its length is still unknown */
+	if(frame_len == 0)
 	{
-		if(decomp->contexts[stream->cid] != NULL)
+		copy_len = rohc_min(chunk->len, decomp->stream_max_len - decomp->stream_len);
+		memcpy(decomp->stream_buf + decomp->stream_len, rohc_buf_data(*chunk),
+		       copy_len);
+
+		/* the length of the frame may be known with the new bytes, the extra
+		 * bytes copied are then left in the chunk */
+		if(!rohc_decomp_find_frame(decomp, decomp->stream_buf,
+		                           decomp->stream_len + copy_len, &frame_len,
+		                           &rohc_offset, &rohc_len))
+		{
+			goto malformed;
+		}
+		if(frame_len == 0 &&
+		   (decomp->stream_len + copy_len) == decomp->stream_max_len)
+		{
+			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			             "no frame found in the first %zu bytes",
+			             decomp->stream_max_len);
+			goto malformed;
+		}
+		if(frame_len > 0 && frame_len < (decomp->stream_len + copy_len))
 		{
-			context_free(decomp->contexts[stream->cid]);
+			copy_len = frame_len - decomp->stream_len;
 		}
-		decomp->contexts[stream->cid] = stream->context;
+	}
+	else
+	{
+		copy_len = rohc_min(chunk->len, frame_len - decomp->stream_len);
+		memcpy(decomp->stream_buf + decomp->stream_len, rohc_buf_data(*chunk),
+		       copy_len);
+	}
+	decomp->stream_len += copy_len;
+	rohc_buf_pull(chunk, copy_len);
+	if(frame_len == 0 || decomp->stream_len < frame_len)
+	{
+		/* wait for the next chunk */
+		uncomp_packet->len = 0;
+		return ROHC_STATUS_OK;
 	}
 
-	/* get the SN of the latest packet successfully decompressed */
-	stream->sn_bits = profile->get_sn(stream->context);
-	stream->sn_bits_nr = sn_feedback_min_bits;
-	rohc_decomp_debug(stream->context, "%zu bits required for SN in feedback "
-	                  "(%zu bits required for RTT, %zu max)",
-	                  sn_feedback_min_bits, decomp->sn_feedback_min_bits,
-	                  profile->msn_max_bits);
+	/* the frame is complete in the buffer of the decompressor */
+	rohc_packet.time = chunk->time;
+	rohc_packet.data = decomp->stream_buf;
+	rohc_packet.max_len = frame_len;
+	rohc_packet.offset = rohc_offset;
+	rohc_packet.len = rohc_len;
+	status = __rohc_decompress(decomp, rohc_packet, uncomp_packet,
+	                           rcvd_feedback, feedback_send,
+	                           ROHC_DECOMP_PAYLOAD_COPY, NULL);
+	if(status != ROHC_STATUS_OUTPUT_TOO_SMALL)
+	{
+		decomp->stream_len = 0;
+	}
 
-skip:
-	return ROHC_STATUS_OK;
+	return status;
 
+malformed:
+	rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+	             "framing of the byte stream is broken, drop %zu bytes",
+	             decomp->stream_len);
+	decomp->stream_len = 0;
+	return ROHC_STATUS_MALFORMED;
 error:
-	stream->crc_failed = !!(status == ROHC_STATUS_BAD_CRC);
-	decomp->last_context = NULL;
-	return status;
+	return ROHC_STATUS_ERROR;
+}
 
-error_crc:
-	stream->crc_failed = true;
-	decomp->last_context = NULL;
-	return ROHC_STATUS_BAD_CRC;
 
-error_malformed:
-	decomp->last_context = NULL;
-	return ROHC_STATUS_MALFORMED;
+/**
+ * @brief Find the first frame of the byte stream with the framing callback
+ *
+ * @param decomp            The ROHC decompressor
+ * @param data              The first bytes of the stream
+ * @param data_len          The number of bytes
+ * @param[out] frame_len    The length of the first frame, 0 if unknown yet
+ * @param[out] rohc_offset  The offset of the ROHC packet in the frame
+ * @param[out] rohc_len     The length of the ROHC packet
+ * @return                  true if the frame is valid or unknown yet,
+ *                          false if the framing is broken
+ */
+static bool rohc_decomp_find_frame(const struct rohc_decomp *const decomp,
+                                   const uint8_t *const data,
+                                   const size_t data_len,
+                                   size_t *const frame_len,
+                                   size_t *const rohc_offset,
+                                   size_t *const rohc_len)
+{
+	if(!decomp->frame_cb(decomp->frame_cb_priv, data, data_len, frame_len,
+	                     rohc_offset, rohc_len))
+	{
+		goto error;
+	}
+	if((*frame_len) > decomp->stream_max_len)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "frame of %zu bytes is larger than the maximum length of "
+		             "%zu bytes", *frame_len, decomp->stream_max_len);
+		goto error;
+	}
+	if((*frame_len) > 0 &&
+	   ((*frame_len) < decomp->stream_len || (*rohc_len) == 0 ||
+	    (*rohc_offset) > (*frame_len) || (*rohc_len) > ((*frame_len) - (*rohc_offset))))
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "ROHC packet of %zu bytes at offset %zu does not fit in "
+		             "frame of %zu bytes", *rohc_len, *rohc_offset, *frame_len);
+		goto error;
+	}
 
-error_no_context:
-	decomp->last_context = NULL;
-	return ROHC_STATUS_NO_CONTEXT;
+	return true;
+
+error:
+	return false;
 }
 
 
 /**
- * @brief Decode one ROHC packet
- *
- * Steps:
- *  \li A. Parse the ROHC header
- *  \li B. For IR and IR-DYN packet, check for correct compressed header (CRC)
- *  \li C. Decode extracted bits
- *  \li D. Build uncompressed headers (and check for correct decompression
- *         for UO* packets)
- *  \li E. Copy the payload (if any)
- *  \li F. Update the compression context
+ * @brief Decompress the given ROHC packet into one uncompressed packet
  *
- * Steps C and D may be repeated if packet or context repair is attempted
- * upon CRC failure.
+ * The function is the common part of \ref rohc_decompress3 and
+ * \ref rohc_decompress_batch: the decompressor shall be valid, the packets
+ * and feedback buffers are checked.
  *
- * @param decomp               The ROHC decompressor
- * @param context              The decompression context
- * @param rohc_packet          The ROHC packet to decode
- * @param add_cid_len          The length of the optional Add-CID field
- * @param large_cid_len        The length of the optional large CID field
- * @param[out] uncomp_packet   The uncompressed packet
- * @param[in,out] packet_type  IN:  The type of the ROHC packet to parse
- *                             OUT: The type of the parsed ROHC packet
- * @param[out] do_change_mode  Whether the profile context wants to change
- *                             its operational mode or not
- * @return                     ROHC_STATUS_OK if packet is successfully decoded,
- *                             ROHC_STATUS_MALFORMED if packet is malformed,
- *                             ROHC_STATUS_BAD_CRC if a CRC error occurs,
- *                             ROHC_STATUS_ERROR if an error occurs
+ * @param decomp              The ROHC decompressor
+ * @param rohc_packet         The compressed packet to decompress
+ * @param[out] uncomp_packet  The resulting uncompressed packet
+ * @param[out] rcvd_feedback  The feedback received from the remote peer,
+ *                            may be NULL
+ * @param[out] feedback_send  The feedback to be transmitted to the remote
+ *                            compressor, may be NULL
+ * @param payload_mode        How to output the payload of the ROHC packet
+ * @param[out] payload_len    The length of the payload, may be NULL
+ * @return                    The same values as \ref rohc_decompress3
  */
-static rohc_status_t rohc_decomp_decode_pkt(struct rohc_decomp *const decomp,
-                                            struct rohc_decomp_ctxt *const context,
-                                            const struct rohc_buf rohc_packet,
-                                            const size_t add_cid_len,
-                                            const size_t large_cid_len,
-                                            struct rohc_buf *const uncomp_packet,
-                                            rohc_packet_t *const packet_type,
-                                            bool *const do_change_mode)
+static rohc_status_t __rohc_decompress(struct rohc_decomp *const decomp,
+                                       struct rohc_buf rohc_packet,
+                                       struct rohc_buf *const uncomp_packet,
+                                       struct rohc_buf *const rcvd_feedback,
+                                       struct rohc_buf *const feedback_send,
+                                       const rohc_decomp_payload_t payload_mode,
+                                       size_t *const payload_len)
 {
-	const struct rohc_decomp_profile *const profile = context->profile;
-	struct rohc_decomp_crc *const extr_crc_bits = &context->volat_ctxt.crc;
-	void *const extr_bits = context->volat_ctxt.extr_bits;
-	void *const decoded_values = context->volat_ctxt.decoded_values;
-
-	/* length of the parsed ROHC header and of the uncompressed headers */
-	size_t rohc_hdr_len;
-	size_t uncomp_hdr_len;
-
-	/* ROHC and uncompressed payloads (they are the same) */
-	const uint8_t *payload_data;
-	size_t payload_len;
-
-	/* Whether to attempt packet correction or not */
-	bool try_decoding_again;
-
-	/* helper variables for values returned by functions */
-	bool parsing_ok;
-	bool decode_ok;
-	rohc_status_t build_ret;
-
-	assert(add_cid_len == 0 || add_cid_len == 1);
-	assert(large_cid_len <= 2);
-	assert((*packet_type) != ROHC_PACKET_UNKNOWN);
-
-	/* A. Parse the ROHC header */
-
-	rohc_decomp_debug(context, "parse packet type '%s' (%d)",
-	                  rohc_get_packet_descr(*packet_type), *packet_type);
+	rohc_status_t status = ROHC_STATUS_ERROR; /* error status by default */
+	struct rohc_decomp_stream stream;
+	size_t uncomp_len;
+	uint64_t start_ns = 0;
 
-	/* let's parse the packet! */
-	parsing_ok = profile->parse_pkt(context, rohc_packet, large_cid_len,
-	                                packet_type, extr_crc_bits, extr_bits,
-	                                &rohc_hdr_len);
-	if(!parsing_ok)
+	if((decomp->features & ROHC_DECOMP_FEATURE_LATENCY) != 0)
 	{
-		rohc_decomp_warn(context, "failed to parse the %s header",
-		                 rohc_get_packet_descr(*packet_type));
-		goto error_malformed;
+		start_ns = rohc_latency_now();
 	}
 
-	/* ROHC base header and its optional extension is now fully parsed,
-	 * remaining data is the payload */
-	payload_data = rohc_buf_data(rohc_packet) + rohc_hdr_len;
-	payload_len = rohc_packet.len - rohc_hdr_len;
-	rohc_decomp_debug(context, "ROHC payload (length = %zu bytes) starts at "
-	                  "offset %zu", payload_len, rohc_hdr_len);
-
-
-	/*
-	 * B. Check for correct compressed header (CRC)
-	 *
-	 * Use the CRC on compressed headers to check whether IR header was
-	 * correctly received. The optional Add-CID is part of the CRC.
-	 */
+	/* packets of unknown arrival time are stamped with the coarse clock */
+	rohc_packet.time = rohc_decomp_arrival_time(decomp, rohc_packet.time);
 
-	if((*packet_type) == ROHC_PACKET_IR || (*packet_type) == ROHC_PACKET_IR_DYN)
+	/* check inputs validity */
+	if(rohc_buf_is_malformed(rohc_packet))
 	{
-		bool crc_ok;
-
-		assert(extr_crc_bits->type == ROHC_CRC_TYPE_NONE);
-		assert(extr_crc_bits->bits_nr == 8);
-
-		crc_ok = rohc_decomp_check_ir_crc(decomp, context,
-		                                  rohc_buf_data(rohc_packet) - add_cid_len,
-		                                  add_cid_len + rohc_hdr_len, large_cid_len,
-		                                  add_cid_len, extr_crc_bits->bits);
-		if(!crc_ok)
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "given rohc_packet is malformed");
+		goto error;
+	}
+	if(rohc_buf_is_empty(rohc_packet))
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "given rohc_packet is empty");
+		goto error;
+	}
+	if(uncomp_packet == NULL)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "given uncomp_packet is NULL");
+		goto error;
+	}
+	if(rohc_buf_is_malformed(*uncomp_packet))
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "given uncomp_packet is malformed");
+		goto error;
+	}
+	if(!rohc_buf_is_empty(*uncomp_packet))
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "given uncomp_packet is not empty");
+		goto error;
+	}
+	if(rcvd_feedback != NULL)
+	{
+		if(rohc_buf_is_malformed(*rcvd_feedback))
 		{
-			rohc_decomp_warn(context, "CRC detected a transmission failure for "
-			                 "%s packet", rohc_get_packet_descr(*packet_type));
-			if((decomp->features & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0)
-			{
-				rohc_dump_buf(decomp->trace_callback, decomp->trace_callback_priv,
-				              ROHC_TRACE_DECOMP, ROHC_TRACE_WARNING, "ROHC header",
-				              rohc_buf_data(rohc_packet) - add_cid_len,
-				              rohc_hdr_len + add_cid_len);
-			}
-#ifndef ROHC_NO_IR_CRC_CHECK
-			goto error_crc;
-#endif
+			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			             "given rcvd_feedback is malformed");
+			goto error;
+		}
+		if(!rohc_buf_is_empty(*rcvd_feedback))
+		{
+			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			             "given rcvd_feedback is not empty");
+			goto error;
 		}
-
-		/* reset the correction attempt */
-		context->crc_corr.counter = 0;
 	}
-
-
-	try_decoding_again = false;
-	do
+	if(feedback_send != NULL)
 	{
-		if(try_decoding_again)
+		if(rohc_buf_is_malformed(*feedback_send))
 		{
-			rohc_decomp_warn(context, "CID %zu: CRC repair: try decoding packet "
-			                 "again with new assumptions", context->cid);
+			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			             "given feedback_send is malformed");
+			goto error;
 		}
-
-
-		/* C. Decode extracted bits
-		 *
-		 * All bits are now extracted from the packet, let's decode them.
-		 */
-
-		decode_ok = profile->decode_bits(context, extr_bits, payload_len,
-		                                 decoded_values);
-		if(!decode_ok)
+		if(!rohc_buf_is_empty(*feedback_send))
 		{
-			rohc_decomp_warn(context, "failed to decode values from bits "
-			                 "extracted from ROHC header");
+			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			             "given feedback_send is not empty");
 			goto error;
 		}
+	}
 
+	rohc_seqlock_write_begin(&decomp->stats_seq);
+	decomp->stats.received++;
+	rohc_seqlock_write_end(&decomp->stats_seq);
+	rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+	           "decompress the %zu-byte packet #%lu", rohc_packet.len,
+	           decomp->stats.received);
+	decomp->feedback_coalescing.pkt_time = rohc_packet.time;
+	rohc_trace_ring_set_time(&decomp->trace_ring, rohc_packet.time);
 
-		/* D. Build uncompressed headers & check for correct decompression
-		 *
-		 * All fields are now decoded, let's build the uncompressed headers.
-		 *
-		 * Use the CRC on decompressed headers to check whether decompression was
-		 * correct.
-		 */
+	/* record the packet for replay */
+	if(decomp->recorder.write_cb != NULL &&
+	   !rohc_record_event(&decomp->recorder, ROHC_RECORD_PKT,
+	                      ROHC_RECORD_NO_CID, &rohc_packet, 1))
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "failed to record one packet, stop recording");
+		decomp->recorder.write_cb = NULL;
+	}
 
-		/* build the uncompressed headers */
-		build_ret = profile->build_hdrs(decomp, context, *packet_type, extr_crc_bits,
-		                                decoded_values, payload_len,
-		                                uncomp_packet, &uncomp_hdr_len);
-		if(build_ret == ROHC_STATUS_OK)
-		{
-			/* uncompressed headers successfully built and CRC is correct,
-			 * no need to try decoding with different values */
-			rohc_buf_pull(uncomp_packet, uncomp_hdr_len);
+	/* print compressed bytes */
+	if((decomp->features & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0)
+	{
+		rohc_dump_packet(decomp->trace_callback, decomp->trace_callback_priv,
+		                 ROHC_TRACE_DECOMP, ROHC_TRACE_DEBUG,
+		                 "compressed data, max 100 bytes", rohc_packet);
+	}
 
-			if(context->crc_corr.algo == ROHC_DECOMP_CRC_CORR_SN_NONE)
+	/* decode ROHC header */
+	status = d_decode_header(decomp, rohc_packet, uncomp_packet, rcvd_feedback,
+	                         payload_mode, &stream);
+	assert(status != ROHC_STATUS_SEGMENT);
+
+	/* handle mode transitions if context was found and it is still valid */
+	if(stream.context != NULL)
+	{
+		if(stream.context->mode == ROHC_U_MODE)
+		{
+			if(decomp->target_mode == ROHC_U_MODE)
 			{
-				rohc_decomp_debug(context, "CRC is correct");
+				rohc_debug(decomp, ROHC_TRACE_DECOMP, stream.profile_id,
+				           "stay in U-mode as requested by user");
 			}
-			else if((*packet_type) == ROHC_PACKET_IR)
+			else if(decomp->target_mode == ROHC_O_MODE)
 			{
-				rohc_decomp_debug(context, "CRC is correct, stop CRC repair");
-				context->crc_corr.algo = ROHC_DECOMP_CRC_CORR_SN_NONE;
-				context->crc_corr.counter = 0;
+				rohc_debug(decomp, ROHC_TRACE_DECOMP, stream.profile_id,
+				           "transit from U-mode to O-mode as requested by user");
+				stream.context->mode = ROHC_O_MODE;
+				/* ACK(O), NACK(O) or STATIC-NACK(O) will transmit the mode
+				 * transition to the remote compressor */
+				stream.mode = ROHC_O_MODE;
+				stream.do_change_mode = true;
 			}
-			else
+			else /* R-mode */
 			{
-				rohc_decomp_debug(context, "CID %zu: CRC repair: CRC is correct",
-				                  context->cid);
-				try_decoding_again = false;
+				assert(0); /* TODO: R-mode not supported yet */
+				status = ROHC_STATUS_ERROR;
+				goto error;
 			}
 		}
-		else if(build_ret == ROHC_STATUS_OUTPUT_TOO_SMALL)
-		{
-			rohc_decomp_warn(context, "CID %zu: failed to build uncompressed "
-			                 "headers: output buffer too small", context->cid);
-			goto error_output_too_small;
-		}
-		else if(build_ret != ROHC_STATUS_BAD_CRC)
+		else if(stream.context->mode == ROHC_O_MODE)
 		{
-			/* uncompressed headers cannot be built, stop decoding */
-			rohc_decomp_warn(context, "CID %zu: failed to build uncompressed "
-			                 "headers", context->cid);
-			if((decomp->features & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0)
+			if(decomp->target_mode == ROHC_U_MODE)
 			{
-				rohc_dump_packet(decomp->trace_callback, decomp->trace_callback_priv,
-				                 ROHC_TRACE_DECOMP, ROHC_TRACE_WARNING,
-				                 "compressed headers", rohc_packet);
+				assert(0); /* TODO: O- to U-mode transition not supported yet */
+				status = ROHC_STATUS_ERROR;
+				goto error;
+			}
+			else if(decomp->target_mode == ROHC_O_MODE)
+			{
+				rohc_debug(decomp, ROHC_TRACE_DECOMP, stream.profile_id,
+				           "stay in O-mode as requested by user");
+			}
+			else /* R-mode */
+			{
+				assert(0); /* TODO: R-mode not supported yet */
+				status = ROHC_STATUS_ERROR;
+				goto error;
 			}
-			goto error;
+		}
+		else /* R-mode */
+		{
+			assert(0); /* TODO: R-mode not supported yet */
+			status = ROHC_STATUS_ERROR;
+			goto error;
+		}
+	}
+
+	/* update statistics and send feedback if needed */
+	if(status == ROHC_STATUS_OK)
+	{
+		/* print a trace to report success (the context may be NULL if packet
+		 * was a feedback-only packet) */
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, stream.profile_id,
+		           "packet decompression succeeded");
+
+		/* do not update statistics and build positive feedback for feedback-only
+		 * packets */
+		if(uncomp_packet->len > 0)
+		{
+			/* the payload left in the ROHC packet is part of the uncompressed
+			 * packet too */
+			uncomp_len = uncomp_packet->len;
+			if(payload_mode == ROHC_DECOMP_PAYLOAD_NONE)
+			{
+				uncomp_len += stream.payload_len;
+			}
+
+			/* update statistics */
+			rohc_debug(decomp, ROHC_TRACE_DECOMP, stream.profile_id,
+			           "update decompressor and context statistics");
+			assert(stream.context != NULL);
+			rohc_seqlock_write_begin(&decomp->stats_seq);
+			stream.context->num_recv_packets++;
+			stream.context->packet_type = stream.packet_type;
+#if ROHC_SMALL_CONTEXTS != 1
+			stream.context->total_uncompressed_size += uncomp_len;
+			stream.context->total_compressed_size += rohc_packet.len;
+#endif
+			decomp->stats.total_uncompressed_size += uncomp_len;
+			decomp->stats.total_compressed_size += rohc_packet.len;
+			assert(stream.context->profile->id < ROHC_PROFILE_MAX);
+			rohc_packet_counters_add(&decomp->stats.pkt_stats.profiles[stream.context->profile->id],
+			                         uncomp_len, rohc_packet.len);
+			assert(stream.packet_type < ROHC_PACKET_MAX);
+			rohc_packet_counters_add(&decomp->stats.pkt_stats.packet_types[stream.packet_type],
+			                         uncomp_len, rohc_packet.len);
+			rohc_seqlock_write_end(&decomp->stats_seq);
+			rohc_trace_ring_add(&decomp->trace_ring, ROHC_TRACE_EVENT_DECOMP_PKT,
+			                    stream.cid, stream.context->profile->id,
+			                    stream.packet_type,
+			                    stream.sn_bits, rohc_packet.len,
+			                    uncomp_len, stream.context->state);
+
+			/* build positive feedback if asked by user and if needed by decompressor */
+			if(!rohc_decomp_feedback_ack(decomp, &stream, feedback_send))
+			{
+				rohc_warning(decomp, ROHC_TRACE_DECOMP, stream.profile_id,
+				             "failed to build positive feedback");
+				status = ROHC_STATUS_ERROR;
+				goto error;
+			}
+		}
+	}
+	else /* packet failed to be decompressed */
+	{
+		/* in case of failure, users shall get an empty decompressed packet */
+		uncomp_packet->len = 0;
+
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, stream.profile_id,
+		             "packet decompression failed: %s (%d)",
+		             rohc_strerror(status), status);
+
+		/* update statistics */
+		rohc_seqlock_write_begin(&decomp->stats_seq);
+		if(stream.context != NULL)
+		{
+			stream.context->num_recv_packets++;
+		}
+		switch(status)
+		{
+			case ROHC_STATUS_MALFORMED:
+			case ROHC_STATUS_OUTPUT_TOO_SMALL:
+			case ROHC_STATUS_ERROR:
+				decomp->stats.failed_decomp++;
+				break;
+			case ROHC_STATUS_NO_CONTEXT:
+				decomp->stats.failed_no_context++;
+				break;
+			case ROHC_STATUS_BAD_CRC:
+				decomp->stats.failed_crc++;
+#if ROHC_SMALL_CONTEXTS != 1
+				if(stream.context != NULL)
+				{
+					stream.context->crc_failures++;
+				}
+#endif
+				rohc_probe4(decomp_crc_failure, decomp, stream.cid,
+				            (stream.context != NULL ?
+				             stream.context->profile->id : stream.profile_id),
+				            stream.packet_type);
+				break;
+			case ROHC_STATUS_OK: /* success codes shall not happen */
+			case ROHC_STATUS_SEGMENT:
+			default:
+				assert(0);
+				rohc_seqlock_write_end(&decomp->stats_seq);
+				status = ROHC_STATUS_ERROR;
+				goto error;
+		}
+		rohc_seqlock_write_end(&decomp->stats_seq);
+		rohc_trace_ring_add(&decomp->trace_ring, ROHC_TRACE_EVENT_DECOMP_FAILURE,
+		                    stream.cid,
+		                    (stream.context != NULL ?
+		                     stream.context->profile->id : stream.profile_id),
+		                    stream.packet_type,
+		                    stream.sn_bits, status, rohc_packet.len,
+		                    stream.state);
+
+		/* build negative feedback if asked by user and if needed by decompressor */
+		if(!rohc_decomp_feedback_nack(decomp, &stream, feedback_send))
+		{
+			rohc_warning(decomp, ROHC_TRACE_DECOMP, stream.profile_id,
+			             "failed to build negative feedback");
+			status = ROHC_STATUS_ERROR;
+			goto error;
+		}
+	}
+
+	/* send the coalesced positive feedback if the window expired */
+	if(!rohc_decomp_coalesce_expire(decomp, feedback_send))
+	{
+		status = ROHC_STATUS_ERROR;
+		goto error;
+	}
+
+	/* report the updated context to the standby decompressor if any */
+	if(decomp->journal_cb != NULL && stream.context != NULL)
+	{
+		rohc_decomp_journal_ctxt(decomp, stream.context);
+	}
+
+	/* record the processing time of the decompressed packets, but not the
+	 * one of the feedback-only packets */
+	if((decomp->features & ROHC_DECOMP_FEATURE_LATENCY) != 0 &&
+	   status == ROHC_STATUS_OK && uncomp_packet->len > 0)
+	{
+		rohc_latency_add(decomp->latency, stream.context->profile->id,
+		                 stream.packet_type, rohc_latency_now() - start_ns);
+	}
+
+	if(payload_len != NULL)
+	{
+		*payload_len = (status == ROHC_STATUS_OK ? stream.payload_len : 0);
+	}
+
+error:
+	return status;
+}
+
+
+/**
+ * @brief Decompress the compressed headers.
+ *
+ * @param decomp              The ROHC decompressor
+ * @param rohc_packet         The ROHC packet to decode
+ * @param[out] uncomp_packet  The uncompressed packet
+ * @param[out] rcvd_feedback  The feedback received from the remote peer for
+ *                            the same-side associated ROHC compressor through
+ *                            the feedback channel:
+ *                            \li If NULL, ignore the received feedback data
+ *                            \li If not NULL, store the received feedback in
+ *                                at the given address
+ * @param payload_mode        How to output the payload of the ROHC packet
+ * @param[out] stream         The informations about the decompressed stream,
+ *                            required for sending feedback to compressor
+ * @return                    Possible return values:
+ *                            \li ROHC_STATUS_OK if packet is successfully
+ *                                decoded,
+ *                            \li ROHC_STATUS_NO_CONTEXT if no matching
+ *                                context was found and packet cannot create
+ *                                a new context (or failed to do so),
+ *                            \li ROHC_STATUS_MALFORMED if packet is
+ *                                malformed,
+ *                            \li ROHC_STATUS_BAD_CRC if a CRC error occurs,
+ *                            \li ROHC_STATUS_ERROR if another error occurs
+ */
+static rohc_status_t d_decode_header(struct rohc_decomp *decomp,
+                                     const struct rohc_buf rohc_packet,
+                                     struct rohc_buf *const uncomp_packet,
+                                     struct rohc_buf *const rcvd_feedback,
+                                     const rohc_decomp_payload_t payload_mode,
+                                     struct rohc_decomp_stream *const stream)
+{
+	const struct rohc_decomp_profile *profile;
+	bool is_new_context = false;
+	size_t sn_feedback_min_bits;
+	size_t add_cid_len;
+	size_t large_cid_len;
+
+	struct rohc_buf remain_rohc_data = rohc_packet;
+	const uint8_t *walk;
+	size_t remain_len;
+#if defined(ROHC_STAGE_CYCLES) && ROHC_SMALL_CONTEXTS != 1
+	uint64_t decode_start;
+#endif
+
+	rohc_status_t status;
+
+	/* at the beginning, context is not found yet but channel CID type is known */
+	stream->profile_id = ROHC_PROFILE_GENERAL;
+	stream->cid_type = decomp->medium.cid_type;
+	stream->cid_found = false;
+	stream->cid = SIZE_MAX;
+	stream->context_found = false;
+	stream->context = NULL;
+	stream->mode = ROHC_UNKNOWN_MODE;
+	stream->state = ROHC_DECOMP_STATE_UNKNOWN;
+	stream->do_change_mode = false;
+	stream->sn_bits = 0; /* must be set to 0 until we get some bits */
+	stream->sn_bits_nr = 0;
+	stream->packet_type = ROHC_PACKET_UNKNOWN;
+	stream->crc_failed = false;
+	stream->payload_len = 0;
+
+	/* empty ROHC packets are not considered as valid */
+	if(remain_rohc_data.len < 1)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "ROHC packet too small (len = %zu, at least 1 byte "
+		             "required)", remain_rohc_data.len);
+		goto error_malformed;
+	}
+
+	/* skip padding bits if some are present */
+	rohc_decomp_parse_padding(decomp, &remain_rohc_data);
+
+	/* padding-only packets are not allowed according to RFC 3095, §5.2:
+	 *   Padding is any number (zero or more) of padding octets.  Either of
+	 *   Feedback or Header must be present. */
+	if(remain_rohc_data.len == 0)
+	{
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "padding-only packet is not allowed");
+		goto error_malformed;
+	}
+
+	/* extract feedback items if present */
+	if(!rohc_decomp_parse_feedbacks(decomp, &remain_rohc_data, rcvd_feedback))
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "failed to decode feedback items at the beginning of the "
+		             "ROHC packet");
+		goto error_malformed;
+	}
+	if(rcvd_feedback != NULL)
+	{
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "decompressor received %zu bytes of feedback for the "
+		           "same-side associated compressor", rcvd_feedback->len);
+	}
+	walk = rohc_buf_data(remain_rohc_data);
+	remain_len = remain_rohc_data.len;
+
+	/* is there some data after feedback? */
+	if(remain_rohc_data.len == 0)
+	{
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "feedback-only packet, stop decompression");
+		goto skip;
+	}
+
+	/* ROHC segment? */
+	if(rohc_decomp_packet_is_segment(walk))
+	{
+		const bool is_final = !!GET_REAL(GET_BIT_0(walk));
+		uint32_t crc_computed;
+
+		/* skip the segment type byte */
+		walk++;
+		remain_len--;
+		rohc_buf_pull(&remain_rohc_data, 1);
+
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "ROHC packet is a %zu-byte %s segment", remain_len,
+		           is_final ? "final" : "non-final");
+
+		/* store all the remaining ROHC data in RRU */
+		if((decomp->rru_len + remain_len) > decomp->mrru)
+		{
+			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			             "invalid RRU: received segment is too large for MRRU "
+			             "(%zu bytes already received, %zu bytes received, "
+			             "MRRU = %zu bytes", decomp->rru_len, remain_len,
+			             decomp->mrru);
+			/* dicard RRU */
+			rohc_decomp_rru_reset(decomp);
+			goto error_malformed;
+		}
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "append new segment to the %zd bytes we already received",
+		           decomp->rru_len);
+		memcpy(decomp->rru + decomp->rru_len, walk, remain_len);
+		decomp->rru_len += remain_len;
+
+		/* compute the CRC of the new bytes while they are in cache, except
+		 * the last 4 bytes received so far that may be the CRC field */
+		if(decomp->rru_len > (decomp->rru_crc_len + CRC_FCS32_LEN))
+		{
+			const size_t crc_len =
+				decomp->rru_len - CRC_FCS32_LEN - decomp->rru_crc_len;
+			decomp->rru_crc = crc_calc_fcs32(decomp->rru + decomp->rru_crc_len,
+			                                 crc_len, decomp->rru_crc);
+			decomp->rru_crc_len += crc_len;
+		}
+
+		/* stop decoding here is not final segment */
+		if(!is_final)
+		{
+			rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			           "%zd bytes of RRU already received, wait for more "
+			           "segments before decompressing RRU", decomp->rru_len);
+			goto skip;
+		}
+
+		/* final segment received, let's check CRC */
+		if(decomp->rru_len <= CRC_FCS32_LEN)
+		{
+			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			             "invalid %zd-byte RRU: should be more than 4-byte long",
+			             decomp->rru_len);
+			/* discard RRU */
+			rohc_decomp_rru_reset(decomp);
+			goto error_malformed;
+		}
+		decomp->rru_len -= CRC_FCS32_LEN;
+		assert(decomp->rru_crc_len == decomp->rru_len);
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "final segment received, check the 4-byte CRC of the "
+		           "%zd-byte RRU", decomp->rru_len);
+		crc_computed = decomp->rru_crc;
+		if(memcmp(&crc_computed, decomp->rru + decomp->rru_len,
+		          CRC_FCS32_LEN) != 0)
+		{
+			uint32_t crc_packet;
+			memcpy(&crc_packet, decomp->rru + decomp->rru_len, CRC_FCS32_LEN);
+			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			             "invalid %zd-byte RRU: bad CRC (packet = 0x%08x, "
+			             "computed = 0x%08x)", decomp->rru_len,
+			             rohc_ntoh32(crc_packet), rohc_ntoh32(crc_computed));
+			/* discard RRU */
+			rohc_decomp_rru_reset(decomp);
+			goto error_crc;
+		}
+
+		/* CRC of segment is OK, let's decode RRU */
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "final segment received, decode the %zd-byte RRU",
+		           decomp->rru_len);
+		walk = decomp->rru;
+		remain_len = decomp->rru_len;
+		remain_rohc_data.offset = 0;
+		remain_rohc_data.data = decomp->rru;
+		remain_rohc_data.len = decomp->rru_len;
+		remain_rohc_data.max_len = decomp->rru_len;
+
+		/* reset context for next RRU */
+		rohc_decomp_rru_reset(decomp);
+	}
+
+	/* decode small or large CID */
+	if(!decomp->decode_cid(decomp, walk, remain_len, &stream->cid,
+	                       &add_cid_len, &large_cid_len))
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "failed to decode small or large CID in packet");
+		goto error_malformed;
+	}
+	stream->cid_found = true;
+
+	/* check whether the decoded CID is allowed by the decompressor */
+	if(stream->cid > decomp->medium.max_cid)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "unexpected CID %zu received: MAX_CID was set to %zu",
+		             stream->cid, decomp->medium.max_cid);
+		goto error_no_context;
+	}
+
+	/* skip add-CID if present */
+	walk += add_cid_len;
+	remain_len -= add_cid_len;
+	rohc_buf_pull(&remain_rohc_data, add_cid_len);
+
+	/* release the contexts that were not used for too long */
+	if(decomp->ctxt_idle_timeout > 0)
+	{
+		rohc_decomp_expire_idle(decomp, rohc_packet.time);
+	}
+
+	/* find the context according to the CID found in CID,
+	 * create it if needed (and possible) */
+	status = rohc_decomp_find_context(decomp, walk, remain_len, stream->cid,
+	                                  large_cid_len, rohc_packet.time,
+	                                  &stream->profile_id, &stream->context,
+	                                  &is_new_context);
+	if(status == ROHC_STATUS_MALFORMED)
+	{
+		/* no additional feedback information to collect */
+		goto error_malformed;
+	}
+	else if(status == ROHC_STATUS_NO_CONTEXT)
+	{
+		/* even if the context was not found/created, the profile ID might be available */
+		goto error_no_context;
+	}
+	assert(status == ROHC_STATUS_OK);
+	profile = stream->context->profile;
+	decomp->last_context = stream->context;
+	sn_feedback_min_bits = rohc_min(decomp->sn_feedback_min_bits,
+	                                profile->msn_max_bits);
+
+	/* collect information for sending feedback to decompressor */
+	stream->context_found = true;
+	stream->mode = stream->context->mode;
+	stream->state = stream->context->state;
+	if(!is_new_context)
+	{
+		stream->sn_bits = profile->get_sn(stream->context);
+		stream->sn_bits_nr = sn_feedback_min_bits;
+		rohc_decomp_debug(stream->context, "%zu bits required for SN in feedback "
+		                  "(%zu bits required for RTT, %zu max)",
+		                  sn_feedback_min_bits, decomp->sn_feedback_min_bits,
+		                  profile->msn_max_bits);
+	}
+
+	/* detect the type of the ROHC packet */
+	stream->packet_type = profile->detect_pkt_type(stream->context, walk, remain_len,
+	                                               large_cid_len);
+	if(stream->packet_type == ROHC_PACKET_UNKNOWN)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, profile->id,
+		             "failed to detect ROHC packet type");
+		if(is_new_context)
+		{
+			context_free(stream->context);
+			stream->context = NULL;
+			decomp->last_context = NULL;
+		}
+		goto error_malformed;
+	}
+	rohc_decomp_debug(stream->context, "decode packet as '%s'",
+	                  rohc_get_packet_descr(stream->packet_type));
+
+	/* only packets that carry static informations can be received in the
+	 * No Context state, other cannot */
+	if(stream->state == ROHC_DECOMP_STATE_NC &&
+	   !rohc_decomp_packet_carry_static_info(stream->packet_type))
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, profile->id,
+		             "packet '%s' (%d) does not carry static information, it cannot "
+		             "be received in No Context state",
+		             rohc_get_packet_descr(stream->packet_type),
+		             stream->packet_type);
+		if(is_new_context)
+		{
+			context_free(stream->context);
+			stream->context = NULL;
+			decomp->last_context = NULL;
+		}
+		goto error_malformed;
+	}
+	/* only packets carrying CRC-7 or CRC-8 can be received in the Static Context
+	 * state, other cannot */
+	else if(stream->state == ROHC_DECOMP_STATE_SC &&
+	        !rohc_decomp_packet_carry_crc_7_or_8(stream->packet_type))
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, profile->id,
+		             "packet '%s' (%d) does not carry 7- or 8-bit CRC, it cannot "
+		             "be received in Static Context state",
+		             rohc_get_packet_descr(stream->packet_type),
+		             stream->packet_type);
+		if(is_new_context)
+		{
+			context_free(stream->context);
+			stream->context = NULL;
+			decomp->last_context = NULL;
+		}
+		goto error_malformed;
+	}
+	/* all packet types are allowed in Full Context state, but the packets
+	 * with a 3-bit CRC cannot be decoded by a context damaged by the latest
+	 * failures: reject them at once without building the headers, the
+	 * negative feedback and the downward transition that follow repair the
+	 * context */
+	else if(stream->state == ROHC_DECOMP_STATE_FC &&
+	        profile->id != ROHC_PROFILE_UNCOMPRESSED &&
+	        !rohc_decomp_packet_carry_crc_7_or_8(stream->packet_type) &&
+	        rohc_decomp_ctxt_is_damaged(decomp, stream->context))
+	{
+		rohc_decomp_warn(stream->context, "CID %zu: packet '%s' (%d) does not "
+		                 "carry 7- or 8-bit CRC, it cannot be decoded by a "
+		                 "damaged context", stream->cid,
+		                 rohc_get_packet_descr(stream->packet_type),
+		                 stream->packet_type);
+		goto error_crc;
+	}
+
+	/* only IR packet can create a new context */
+	assert(stream->packet_type == ROHC_PACKET_IR || !is_new_context);
+
+	/* decode the packet thanks to the profile-specific routines
+	 * (may change the initial assumption about the packet type) */
+#if defined(ROHC_STAGE_CYCLES) && ROHC_SMALL_CONTEXTS != 1
+	decode_start = rohc_cycles_now();
+#endif
+	status = rohc_decomp_decode_pkt(decomp, stream->context, remain_rohc_data,
+	                                add_cid_len, large_cid_len, uncomp_packet,
+	                                payload_mode, &stream->packet_type,
+	                                &stream->do_change_mode,
+	                                &stream->payload_len);
+#if ROHC_SMALL_CONTEXTS != 1
+	assert(stream->packet_type < ROHC_PACKET_MAX);
+	rohc_seqlock_write_begin(&decomp->stats_seq);
+	stream->context->packet_types_nr[stream->packet_type]++;
+#  ifdef ROHC_STAGE_CYCLES
+	stream->context->decode_cycles += rohc_cycles_now() - decode_start;
+#  endif
+	rohc_seqlock_write_end(&decomp->stats_seq);
+#endif
+	if(status != ROHC_STATUS_OK)
+	{
+		/* decompression failed, free ressources if necessary */
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, profile->id,
+		             "failed to decompress packet (code = %d)", status);
+		if(is_new_context)
+		{
+			context_free(stream->context);
+			stream->context = NULL;
+			decomp->last_context = NULL;
+		}
+		goto error;
+	}
+
+	/* decompression was successful, replace the existing context with the
+	 * new one if necessary, the context is now the most recently used one */
+	stream->context->latest_used = rohc_packet.time.sec;
+	if(is_new_context)
+	{
+		rohc_decomp_assign_cid(decomp, stream->context);
+	}
+	else if(decomp->lru_head != stream->context)
+	{
+		rohc_decomp_lru_del(decomp, stream->context);
+		rohc_decomp_lru_add(decomp, stream->context);
+	}
+
+	/* get the SN of the latest packet successfully decompressed */
+	stream->sn_bits = profile->get_sn(stream->context);
+	stream->sn_bits_nr = sn_feedback_min_bits;
+	rohc_decomp_debug(stream->context, "%zu bits required for SN in feedback "
+	                  "(%zu bits required for RTT, %zu max)",
+	                  sn_feedback_min_bits, decomp->sn_feedback_min_bits,
+	                  profile->msn_max_bits);
+
+skip:
+	return ROHC_STATUS_OK;
+
+error:
+	stream->crc_failed = !!(status == ROHC_STATUS_BAD_CRC);
+	decomp->last_context = NULL;
+	return status;
+
+error_crc:
+	stream->crc_failed = true;
+	decomp->last_context = NULL;
+	return ROHC_STATUS_BAD_CRC;
+
+error_malformed:
+	decomp->last_context = NULL;
+	return ROHC_STATUS_MALFORMED;
+
+error_no_context:
+	decomp->last_context = NULL;
+	return ROHC_STATUS_NO_CONTEXT;
+}
+
+
+/**
+ * @brief Decode one ROHC packet
+ *
+ * Steps:
+ *  \li A. Parse the ROHC header
+ *  \li B. For IR and IR-DYN packet, check for correct compressed header (CRC)
+ *  \li C. Decode extracted bits
+ *  \li D. Build uncompressed headers (and check for correct decompression
+ *         for UO* packets)
+ *  \li E. Copy the payload (if any), or move the uncompressed headers in
+ *         front of the payload for in-place decompression, or leave the
+ *         payload in the ROHC packet for headers-only decompression
+ *  \li F. Update the compression context
+ *
+ * Steps C and D may be repeated if packet or context repair is attempted
+ * upon CRC failure. Steps A to D are done at once by the profile for Normal
+ * packets, which carry no compressed header.
+ *
+ * @param decomp               The ROHC decompressor
+ * @param context              The decompression context
+ * @param rohc_packet          The ROHC packet to decode
+ * @param add_cid_len          The length of the optional Add-CID field
+ * @param large_cid_len        The length of the optional large CID field
+ * @param[out] uncomp_packet   The uncompressed packet
+ * @param payload_mode         How to output the payload of the ROHC packet
+ * @param[in,out] packet_type  IN:  The type of the ROHC packet to parse
+ *                             OUT: The type of the parsed ROHC packet
+ * @param[out] do_change_mode  Whether the profile context wants to change
+ *                             its operational mode or not
+ * @param[out] rohc_payload_len  The length of the payload of the ROHC packet
+ * @return                     ROHC_STATUS_OK if packet is successfully decoded,
+ *                             ROHC_STATUS_MALFORMED if packet is malformed,
+ *                             ROHC_STATUS_BAD_CRC if a CRC error occurs,
+ *                             ROHC_STATUS_ERROR if an error occurs
+ */
+static rohc_status_t rohc_decomp_decode_pkt(struct rohc_decomp *const decomp,
+                                            struct rohc_decomp_ctxt *const context,
+                                            const struct rohc_buf rohc_packet,
+                                            const size_t add_cid_len,
+                                            const size_t large_cid_len,
+                                            struct rohc_buf *const uncomp_packet,
+                                            const rohc_decomp_payload_t payload_mode,
+                                            rohc_packet_t *const packet_type,
+                                            bool *const do_change_mode,
+                                            size_t *const rohc_payload_len)
+{
+	const struct rohc_decomp_profile *const profile = context->profile;
+	void *const decoded_values = decomp->decoded_values;
+
+	/* length of the parsed ROHC header and of the uncompressed headers */
+	size_t rohc_hdr_len;
+	size_t uncomp_hdr_len;
+
+	/* ROHC and uncompressed payloads (they are the same) */
+	const uint8_t *payload_data;
+	size_t payload_len;
+
+	rohc_status_t status;
+
+	assert(add_cid_len == 0 || add_cid_len == 1);
+	assert(large_cid_len <= 2);
+	assert((*packet_type) != ROHC_PACKET_UNKNOWN);
+
+	/* A to D. Get the uncompressed headers: Normal packets carry no compressed
+	 *         header, the profile copies them in one step */
+	if((*packet_type) == ROHC_PACKET_NORMAL && profile->decode_normal != NULL)
+	{
+		rohc_cycles_begin(&decomp->stage_cycles, ROHC_DECOMP_STAGE_BUILD_HDR);
+		status = profile->decode_normal(context, rohc_packet, large_cid_len,
+		                                uncomp_packet, &rohc_hdr_len,
+		                                &uncomp_hdr_len);
+		rohc_cycles_end(&decomp->stage_cycles, ROHC_DECOMP_STAGE_BUILD_HDR);
+		if(status == ROHC_STATUS_OK)
+		{
+			rohc_buf_pull(uncomp_packet, uncomp_hdr_len);
+		}
+	}
+	else
+	{
+		status = rohc_decomp_decode_hdrs(decomp, context, rohc_packet,
+		                                 add_cid_len, large_cid_len, uncomp_packet,
+		                                 packet_type, do_change_mode,
+		                                 &rohc_hdr_len, &uncomp_hdr_len);
+	}
+	if(status != ROHC_STATUS_OK)
+	{
+		goto error_hdrs;
+	}
+	payload_data = rohc_buf_data(rohc_packet) + rohc_hdr_len;
+	payload_len = rohc_packet.len - rohc_hdr_len;
+
+	/* E. Copy the payload (if any), reuse it in place, or leave it in the
+	 *    ROHC packet */
+
+	rohc_cycles_begin(&decomp->stage_cycles, ROHC_DECOMP_STAGE_PAYLOAD);
+	if((rohc_hdr_len + payload_len) != rohc_packet.len)
+	{
+		rohc_decomp_warn(context, "ROHC %s header (%zu bytes) and payload "
+		                 "(%zu bytes) do not match the full ROHC packet "
+		                 "(%zu bytes)", rohc_get_packet_descr(*packet_type),
+		                 rohc_hdr_len, payload_len, rohc_packet.len);
+		goto error;
+	}
+	if(payload_mode == ROHC_DECOMP_PAYLOAD_INPLACE)
+	{
+		/* the uncompressed headers were built in the headroom of the ROHC
+		 * packet, move them just in front of the payload (the payload of a
+		 * reassembled RRU is not in the ROHC packet, it cannot be reused) */
+		size_t uncomp_offset;
+
+		if(rohc_packet.data != uncomp_packet->data)
+		{
+			rohc_decomp_warn(context, "in-place decompression is not possible "
+			                 "for the %zu-byte payload of a reassembled RRU",
+			                 payload_len);
+			goto error;
+		}
+		uncomp_offset = payload_data - uncomp_packet->data - uncomp_hdr_len;
+		memmove(uncomp_packet->data + uncomp_offset,
+		        rohc_buf_data(*uncomp_packet) - uncomp_hdr_len, uncomp_hdr_len);
+		uncomp_packet->max_len = rohc_packet.max_len;
+		uncomp_packet->offset = uncomp_offset;
+		uncomp_packet->len = uncomp_hdr_len + payload_len;
+	}
+	else if(payload_mode == ROHC_DECOMP_PAYLOAD_NONE)
+	{
+		/* the payload of a reassembled RRU is not in the ROHC packet, its
+		 * offset in the ROHC packet cannot be given */
+		if(decomp->rru != NULL && rohc_packet.data == decomp->rru)
+		{
+			rohc_decomp_warn(context, "headers-only decompression is not "
+			                 "possible for the %zu-byte payload of a "
+			                 "reassembled RRU", payload_len);
+			goto error;
+		}
+		/* unhide the uncompressed headers only */
+		rohc_buf_push(uncomp_packet, uncomp_hdr_len);
+	}
+	else
+	{
+		if(rohc_buf_avail_len(*uncomp_packet) < payload_len)
+		{
+			rohc_decomp_warn(context, "uncompressed packet too small (%zu bytes "
+			                 "max) for the %zu-byte payload",
+			                 rohc_buf_avail_len(*uncomp_packet), payload_len);
+			goto error_output_too_small;
+		}
+		if(payload_len != 0)
+		{
+			rohc_buf_append(uncomp_packet, payload_data, payload_len);
+			rohc_buf_pull(uncomp_packet, payload_len);
+		}
+		/* unhide the uncompressed headers and payload */
+		rohc_buf_push(uncomp_packet, uncomp_hdr_len + payload_len);
+	}
+	rohc_cycles_end(&decomp->stage_cycles, ROHC_DECOMP_STAGE_PAYLOAD);
+	rohc_decomp_debug(context, "uncompressed packet length = %zu bytes",
+	                  uncomp_packet->len);
+	*rohc_payload_len = payload_len;
+
+
+	/* F. Update the compression context
+	 *
+	 * Once CRC check is done, update the compression context with the values
+	 * that were decoded earlier.
+	 *
+	 * TODO: check what fields shall be updated in the context
+	 */
+
+	/* we are either already in full context state or we can transit
+	 * through it */
+	if(context->state != ROHC_DECOMP_STATE_FC)
+	{
+		rohc_decomp_debug(context, "change from state %d to state %d",
+		                  context->state, ROHC_DECOMP_STATE_FC);
+		rohc_probe4(decomp_state_change, decomp, context->cid, context->state,
+		            ROHC_DECOMP_STATE_FC);
+		context->state = ROHC_DECOMP_STATE_FC;
+	}
+
+	/* update context with decoded values */
+	rohc_cycles_begin(&decomp->stage_cycles, ROHC_DECOMP_STAGE_UPDATE_CTXT);
+	rohc_decomp_update_context(context, decoded_values, payload_len,
+	                           rohc_packet.time, do_change_mode);
+	rohc_cycles_end(&decomp->stage_cycles, ROHC_DECOMP_STAGE_UPDATE_CTXT);
+
+	/* update statistics */
+	rohc_decomp_stats_add_success(context, rohc_hdr_len, uncomp_hdr_len);
+
+	/* decompression is successful */
+	return ROHC_STATUS_OK;
+
+error:
+	return ROHC_STATUS_ERROR;
+error_output_too_small:
+	return ROHC_STATUS_OUTPUT_TOO_SMALL;
+error_hdrs:
+	return status;
+}
+
+
+/**
+ * @brief Parse and decode one ROHC header, then build the uncompressed headers
+ *
+ * Steps A to D of \ref rohc_decomp_decode_pkt. The uncompressed headers are
+ * written in \e uncomp_packet, which is then pulled after them.
+ *
+ * @param decomp               The ROHC decompressor
+ * @param context              The decompression context
+ * @param rohc_packet          The ROHC packet to decode
+ * @param add_cid_len          The length of the optional Add-CID field
+ * @param large_cid_len        The length of the optional large CID field
+ * @param[out] uncomp_packet   The uncompressed packet
+ * @param[in,out] packet_type  IN:  The type of the ROHC packet to parse
+ *                             OUT: The type of the parsed ROHC packet
+ * @param[out] do_change_mode  Whether the profile context wants to change
+ *                             its operational mode or not
+ * @param[out] rohc_hdr_len    The length of the ROHC header
+ * @param[out] uncomp_hdr_len  The length of the uncompressed headers
+ * @return                     ROHC_STATUS_OK if the headers are decoded,
+ *                             ROHC_STATUS_MALFORMED if packet is malformed,
+ *                             ROHC_STATUS_BAD_CRC if a CRC error occurs,
+ *                             ROHC_STATUS_OUTPUT_TOO_SMALL if the output
+ *                             buffer is too small,
+ *                             ROHC_STATUS_ERROR if an error occurs
+ */
+static rohc_status_t rohc_decomp_decode_hdrs(struct rohc_decomp *const decomp,
+                                             struct rohc_decomp_ctxt *const context,
+                                             const struct rohc_buf rohc_packet,
+                                             const size_t add_cid_len,
+                                             const size_t large_cid_len,
+                                             struct rohc_buf *const uncomp_packet,
+                                             rohc_packet_t *const packet_type,
+                                             bool *const do_change_mode,
+                                             size_t *const rohc_hdr_len,
+                                             size_t *const uncomp_hdr_len)
+{
+	const struct rohc_decomp_profile *const profile = context->profile;
+	struct rohc_decomp_crc *const extr_crc_bits = &context->volat_ctxt.crc;
+	void *const extr_bits = decomp->extr_bits;
+	void *const decoded_values = decomp->decoded_values;
+
+	/* length of the ROHC payload */
+	size_t payload_len;
+
+	/* Whether to attempt packet correction or not */
+	bool try_decoding_again;
+
+	/* helper variables for values returned by functions */
+	bool parsing_ok;
+	bool decode_ok;
+	rohc_status_t build_ret;
+
+	/* A. Parse the ROHC header */
+
+	rohc_decomp_debug(context, "parse packet type '%s' (%d)",
+	                  rohc_get_packet_descr(*packet_type), *packet_type);
+
+	/* let's parse the packet! */
+	rohc_cycles_begin(&decomp->stage_cycles, ROHC_DECOMP_STAGE_PARSE);
+	extr_crc_bits->static_len = 0;
+	parsing_ok = profile->parse_pkt(context, rohc_packet, large_cid_len,
+	                                packet_type, extr_crc_bits, extr_bits,
+	                                rohc_hdr_len);
+	rohc_cycles_end(&decomp->stage_cycles, ROHC_DECOMP_STAGE_PARSE);
+	decomp->extr_bits_profile = profile;
+	if(!parsing_ok)
+	{
+		rohc_decomp_warn(context, "failed to parse the %s header",
+		                 rohc_get_packet_descr(*packet_type));
+		goto error_malformed;
+	}
+
+	/* ROHC base header and its optional extension is now fully parsed,
+	 * remaining data is the payload */
+	payload_len = rohc_packet.len - (*rohc_hdr_len);
+	rohc_decomp_debug(context, "ROHC payload (length = %zu bytes) starts at "
+	                  "offset %zu", payload_len, (*rohc_hdr_len));
+
+
+	/*
+	 * B. Check for correct compressed header (CRC)
+	 *
+	 * Use the CRC on compressed headers to check whether IR header was
+	 * correctly received. The optional Add-CID is part of the CRC.
+	 */
+
+	if((*packet_type) == ROHC_PACKET_IR || (*packet_type) == ROHC_PACKET_IR_DYN)
+	{
+		bool crc_ok;
+
+		assert(extr_crc_bits->type == ROHC_CRC_TYPE_NONE);
+		assert(extr_crc_bits->bits_nr == 8);
+
+		rohc_cycles_begin(&decomp->stage_cycles, ROHC_DECOMP_STAGE_CRC);
+		crc_ok = rohc_decomp_check_ir_crc(decomp, context,
+		                                  rohc_buf_data(rohc_packet) - add_cid_len,
+		                                  add_cid_len + (*rohc_hdr_len), add_cid_len,
+		                                  large_cid_len, extr_crc_bits->static_len,
+		                                  extr_crc_bits->bits);
+		rohc_cycles_end(&decomp->stage_cycles, ROHC_DECOMP_STAGE_CRC);
+		if(!crc_ok)
+		{
+			rohc_decomp_warn(context, "CRC detected a transmission failure for "
+			                 "%s packet", rohc_get_packet_descr(*packet_type));
+			if((decomp->features & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0)
+			{
+				rohc_dump_buf(decomp->trace_callback, decomp->trace_callback_priv,
+				              ROHC_TRACE_DECOMP, ROHC_TRACE_WARNING, "ROHC header",
+				              rohc_buf_data(rohc_packet) - add_cid_len,
+				              (*rohc_hdr_len) + add_cid_len);
+			}
+#ifndef ROHC_NO_IR_CRC_CHECK
+			goto error_crc;
+#endif
+		}
+
+		/* reset the correction attempt */
+		context->crc_corr.counter = 0;
+	}
+
+
+	try_decoding_again = false;
+	do
+	{
+		if(try_decoding_again)
+		{
+			rohc_decomp_warn(context, "CID %zu: CRC repair: try decoding packet "
+			                 "again with new assumptions", context->cid);
+		}
+
+
+		/* C. Decode extracted bits
+		 *
+		 * All bits are now extracted from the packet, let's decode them.
+		 */
+
+		rohc_cycles_begin(&decomp->stage_cycles, ROHC_DECOMP_STAGE_DECODE);
+		decode_ok = profile->decode_bits(context, extr_bits, payload_len,
+		                                 decoded_values);
+		rohc_cycles_end(&decomp->stage_cycles, ROHC_DECOMP_STAGE_DECODE);
+		if(!decode_ok)
+		{
+			rohc_decomp_warn(context, "failed to decode values from bits "
+			                 "extracted from ROHC header");
+			goto error;
+		}
+
+
+		/* D. Build uncompressed headers & check for correct decompression
+		 *
+		 * All fields are now decoded, let's build the uncompressed headers.
+		 *
+		 * Use the CRC on decompressed headers to check whether decompression was
+		 * correct.
+		 */
+
+		/* build the uncompressed headers */
+		rohc_cycles_begin(&decomp->stage_cycles, ROHC_DECOMP_STAGE_BUILD_HDR);
+		build_ret = profile->build_hdrs(decomp, context, *packet_type, extr_crc_bits,
+		                                decoded_values, payload_len,
+		                                uncomp_packet, uncomp_hdr_len);
+		rohc_cycles_end(&decomp->stage_cycles, ROHC_DECOMP_STAGE_BUILD_HDR);
+		if(build_ret == ROHC_STATUS_OK)
+		{
+			/* uncompressed headers successfully built and CRC is correct,
+			 * no need to try decoding with different values */
+			rohc_buf_pull(uncomp_packet, *uncomp_hdr_len);
+
+			if(context->crc_corr.algo == ROHC_DECOMP_CRC_CORR_SN_NONE)
+			{
+				rohc_decomp_debug(context, "CRC is correct");
+			}
+			else if((*packet_type) == ROHC_PACKET_IR)
+			{
+				rohc_decomp_debug(context, "CRC is correct, stop CRC repair");
+				context->crc_corr.algo = ROHC_DECOMP_CRC_CORR_SN_NONE;
+				context->crc_corr.counter = 0;
+			}
+			else
+			{
+				rohc_decomp_debug(context, "CID %zu: CRC repair: CRC is correct",
+				                  context->cid);
+				try_decoding_again = false;
+			}
+		}
+		else if(build_ret == ROHC_STATUS_OUTPUT_TOO_SMALL)
+		{
+			rohc_decomp_warn(context, "CID %zu: failed to build uncompressed "
+			                 "headers: output buffer too small", context->cid);
+			goto error_output_too_small;
+		}
+		else if(build_ret != ROHC_STATUS_BAD_CRC)
+		{
+			/* uncompressed headers cannot be built, stop decoding */
+			rohc_decomp_warn(context, "CID %zu: failed to build uncompressed "
+			                 "headers", context->cid);
+			if((decomp->features & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0)
+			{
+				rohc_dump_packet(decomp->trace_callback, decomp->trace_callback_priv,
+				                 ROHC_TRACE_DECOMP, ROHC_TRACE_WARNING,
+				                 "compressed headers", rohc_packet);
+			}
+			goto error;
+		}
+		else
+		{
+			/* uncompressed headers successfully built but CRC is incorrect,
+			 * try decoding with different values (repair) */
+
+			/* CRC for IR and IR-DYN packets checked before, so cannot fail here */
+			assert((*packet_type) != ROHC_PACKET_IR);
+			assert((*packet_type) != ROHC_PACKET_IR_DYN);
+
+			rohc_decomp_warn(context, "CID %zu: failed to build uncompressed "
+			                 "headers (CRC failure)", context->cid);
+
+			/* attempt a context/packet repair */
+			try_decoding_again =
+				profile->attempt_repair(decomp, context, rohc_packet.time,
+				                        &context->crc_corr, extr_bits);
+
+			/* do not decode the packet again if too many repairs were attempted
+			 * recently, the packet is then handled as a regular CRC failure;
+			 * decoding a packet that did not come late once more with ref 0 is
+			 * not a repair */
+			if(try_decoding_again &&
+			   context->crc_corr.algo != ROHC_DECOMP_CRC_CORR_SN_NONE &&
+			   !rohc_decomp_crc_repair_allowed(decomp, context, rohc_packet.time))
+			{
+				context->crc_corr.algo = ROHC_DECOMP_CRC_CORR_SN_NONE;
+				context->crc_corr.counter = 0;
+				try_decoding_again = false;
+			}
+
+			/* report CRC failure if attempt is not possible */
+			if(!try_decoding_again)
+			{
+				/* uncompressed headers successfully built, CRC is incorrect, repair
+				 * was disabled or attempted without any success, so give up */
+				rohc_decomp_warn(context, "CID %zu: failed to build uncompressed "
+				                 "headers (CRC failure)", context->cid);
+				if((decomp->features & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0)
+				{
+					rohc_dump_packet(decomp->trace_callback, decomp->trace_callback_priv,
+					                 ROHC_TRACE_DECOMP, ROHC_TRACE_WARNING,
+					                 "compressed headers", rohc_packet);
+				}
+				goto error_crc;
+			}
+		}
+	}
+	while(try_decoding_again);
+
+	/* after CRC failure, if the SN value seems to be correctly guessed, we must
+	 * wait for 3 CRC-valid packets before the correction is approved. Two
+	 * packets are therefore thrown away. */
+	if(context->crc_corr.algo != ROHC_DECOMP_CRC_CORR_SN_NONE)
+	{
+		if(context->crc_corr.counter > 1)
+		{
+			/* update context with decoded values even if we drop the packet */
+			rohc_decomp_update_context(context, decoded_values, payload_len,
+			                           rohc_packet.time, do_change_mode);
+
+			context->crc_corr.counter--;
+			rohc_decomp_warn(context, "CID %zu: CRC repair: throw away packet, "
+			                 "still %zu CRC-valid packets required",
+			                 context->cid, context->crc_corr.counter);
+
+			goto error_crc;
+		}
+		else if(context->crc_corr.counter == 1)
+		{
+			rohc_decomp_warn(context, "CID %zu: CRC repair: correction is "
+			                 "successful, keep packet", context->cid);
+			rohc_probe3(decomp_crc_repair, decomp, context->cid,
+			            context->crc_corr.algo);
+			switch(context->crc_corr.algo)
+			{
+				case ROHC_DECOMP_CRC_CORR_SN_WRAP:
+					rohc_seqlock_write_begin(&decomp->stats_seq);
+#if ROHC_SMALL_CONTEXTS != 1
+					context->corrected_crc_failures++;
+					context->corrected_sn_wraparounds++;
+#endif
+					decomp->stats.corrected_crc_failures++;
+					decomp->stats.corrected_sn_wraparounds++;
+					rohc_seqlock_write_end(&decomp->stats_seq);
+					break;
+				case ROHC_DECOMP_CRC_CORR_SN_UPDATES:
+					rohc_seqlock_write_begin(&decomp->stats_seq);
+#if ROHC_SMALL_CONTEXTS != 1
+					context->corrected_crc_failures++;
+					context->corrected_wrong_sn_updates++;
+#endif
+					decomp->stats.corrected_crc_failures++;
+					decomp->stats.corrected_wrong_sn_updates++;
+					rohc_seqlock_write_end(&decomp->stats_seq);
+					break;
+				case ROHC_DECOMP_CRC_CORR_SN_NONE:
+				default:
+					rohc_error(decomp, ROHC_TRACE_DECOMP, context->profile->id,
+					           "CID %zu: CRC repair: unsupported repair algorithm %d",
+					           context->cid, context->crc_corr.algo);
+					assert(0);
+					goto error;
+			}
+			context->crc_corr.algo = ROHC_DECOMP_CRC_CORR_SN_NONE;
+			context->crc_corr.counter--;
+		}
+	}
+
+
+	return ROHC_STATUS_OK;
+
+error:
+	return ROHC_STATUS_ERROR;
+error_output_too_small:
+	return ROHC_STATUS_OUTPUT_TOO_SMALL;
+error_crc:
+	return ROHC_STATUS_BAD_CRC;
+error_malformed:
+	return ROHC_STATUS_MALFORMED;
+}
+
+
+/**
+ * @brief Check whether the CRC on IR or IR-DYN header is correct or not
+ *
+ * The CRC for IR/IR-DYN headers is always CRC-8. It is computed on the
+ * whole compressed header (payload excluded, but any CID bits included).
+ *
+ * The IR headers of one context share their bytes up to the end of the
+ * static chain: the CRC of these bytes is cached in the context, so that the
+ * next IR headers only compute the CRC of their dynamic chain.
+ *
+ * @param decomp          The ROHC decompressor
+ * @param context         The decompression context
+ * @param rohc_hdr        The compressed IR or IR-DYN header
+ * @param rohc_hdr_len    The length (in bytes) of the compressed header
+ * @param add_cid_len     The length of the optional Add-CID field
+ * @param large_cid_len   The length of the optional large CID field
+ * @param static_len      The length of the header after the Add-CID field up
+ *                        to the end of the static chain, 0 if unknown
+ * @param crc_packet      The CRC extracted from the ROHC header
+ * @return                true if the CRC is correct, false otherwise
+ */
+static bool rohc_decomp_check_ir_crc(const struct rohc_decomp *const decomp,
+                                     struct rohc_decomp_ctxt *const context,
+                                     const uint8_t *const rohc_hdr,
+                                     const size_t rohc_hdr_len,
+                                     const size_t add_cid_len,
+                                     const size_t large_cid_len,
+                                     const size_t static_len,
+                                     const uint8_t crc_packet)
+{
+	const size_t crc_pos = add_cid_len + 2 + large_cid_len;
+	const uint8_t *crc_table;
+	const rohc_crc_type_t crc_type = ROHC_CRC_TYPE_8;
+	const uint8_t crc_zero[] = { 0x00 };
+	unsigned int crc_comp; /* computed CRC */
+
+	assert(decomp != NULL);
+	assert(rohc_hdr != NULL);
+	assert(rohc_hdr_len >= (crc_pos + 1));
+	assert(static_len == 0 ||
+	       (static_len >= (2 + large_cid_len + 1) &&
+	        (add_cid_len + static_len) <= rohc_hdr_len));
+
+	crc_table = rohc_crc_table_8;
+
+	/* all profiles but the Uncompressed profile compute their CRC through the
+	 * zeroed CRC field and the rest of the ROHC header */
+	if(context->profile->id != ROHC_PROFILE_UNCOMPRESSED)
+	{
+		/* the length of the header covered by the computed CRC */
+		size_t crc_len = crc_pos + 1;
+#if ROHC_SMALL_CONTEXTS != 1
+		struct rohc_decomp_ir_crc_cache *const cache = &context->ir_crc_cache;
+		const size_t static_end = add_cid_len + static_len;
+
+		if(static_len > 0 && cache->len == static_end &&
+		   memcmp(cache->bytes, rohc_hdr, crc_pos) == 0 &&
+		   memcmp(cache->bytes + crc_len, rohc_hdr + crc_len,
+		          static_end - crc_len) == 0)
+		{
+			rohc_decomp_debug(context, "re-use the CRC of the %zu first bytes of "
+			                  "the IR header", static_end);
+			crc_comp = cache->crc;
+			crc_len = static_end;
+		}
+		else
+#endif
+		{
+			/* ROHC header before CRC field:
+			 * optional Add-CID + IR type + Profile ID + optional large CID */
+			crc_comp = crc_calculate(crc_type, rohc_hdr, crc_pos, CRC_INIT_8,
+			                         crc_table);
+
+			/* zeroed CRC field */
+			crc_comp = crc_calculate(crc_type, crc_zero, 1, crc_comp, crc_table);
+
+#if ROHC_SMALL_CONTEXTS != 1
+			/* cache the CRC up to the end of the static chain for the next IR
+			 * packets if the header is not too long */
+			if(static_len > 0 && static_end <= ROHC_DECOMP_IR_CRC_CACHE_MAX_LEN)
+			{
+				crc_comp = crc_calculate(crc_type, rohc_hdr + crc_len,
+				                         static_end - crc_len, crc_comp, crc_table);
+				crc_len = static_end;
+				memcpy(cache->bytes, rohc_hdr, static_end);
+				cache->len = static_end;
+				cache->crc = crc_comp;
+			}
+#endif
+		}
+
+		/* ROHC header after CRC field (or after the static chain) */
+		crc_comp = crc_calculate(crc_type, rohc_hdr + crc_len,
+		                         rohc_hdr_len - crc_len, crc_comp, crc_table);
+	}
+	else
+	{
+		/* ROHC header before CRC field:
+		 * optional Add-CID + IR type + Profile ID + optional large CID */
+		crc_comp = crc_calculate(crc_type, rohc_hdr, crc_pos, CRC_INIT_8,
+		                         crc_table);
+	}
+
+	rohc_decomp_debug(context, "CRC-%d on compressed %zu-byte ROHC header = "
+	                  "0x%x", crc_type, rohc_hdr_len, crc_comp);
+
+	/* does the computed CRC match the one in packet? */
+	if(crc_comp != crc_packet)
+	{
+		rohc_decomp_warn(context, "CRC failure (computed = 0x%02x, packet = "
+		                 "0x%02x)", crc_comp, crc_packet);
+		goto error;
+	}
+
+	/* computed CRC matches the one in packet */
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Update context with decoded values
+ *
+ * @param context              The decompression context
+ * @param decoded              The decoded values to update in the context
+ * @param payload_len          The length of the packet payload
+ * @param pkt_arrival_time     The arrival time of the decoded ROHC packet
+ * @param[out] do_change_mode  Whether the context wants to change its
+ *                             operational mode or not
+ */
+static void rohc_decomp_update_context(struct rohc_decomp_ctxt *const context,
+                                       const void *const decoded,
+                                       const size_t payload_len,
+                                       const struct rohc_ts pkt_arrival_time __attribute__((unused)),
+                                       bool *const do_change_mode)
+{
+#if ROHC_SMALL_CONTEXTS != 1
+	struct rohc_decomp_crc_corr_ctxt *const crc_corr = &context->crc_corr;
+#endif
+
+	/* call the profile-specific callback */
+	context->profile->update_ctxt(context, decoded, payload_len, do_change_mode);
+
+#if ROHC_SMALL_CONTEXTS != 1
+	/* update arrival time */
+	crc_corr->arrival_times[crc_corr->arrival_times_index] = pkt_arrival_time;
+	crc_corr->arrival_times_index =
+		(crc_corr->arrival_times_index + 1) % ROHC_MAX_ARRIVAL_TIMES;
+	crc_corr->arrival_times_nr =
+		rohc_min(crc_corr->arrival_times_nr + 1, ROHC_MAX_ARRIVAL_TIMES);
+#endif
+}
+
+
+/**
+ * @brief Is a CRC repair attempt allowed by the budgets of repair attempts?
+ *
+ * The attempt is counted in the budgets of the context and decompressor if
+ * it is allowed, the skipped repair is counted in statistics otherwise.
+ *
+ * @param decomp            The ROHC decompressor
+ * @param context           The decompression context
+ * @param pkt_arrival_time  The arrival time of the ROHC packet that caused
+ *                          the CRC failure
+ * @return                  true if the repair may be attempted,
+ *                          false if one of the budgets is exhausted
+ */
+static bool rohc_decomp_crc_repair_allowed(struct rohc_decomp *const decomp,
+                                           struct rohc_decomp_ctxt *const context,
+                                           const struct rohc_ts pkt_arrival_time)
+{
+	struct rohc_decomp_crc_repair_budget *const ctxt_budget =
+		&context->crc_corr.budget;
+	struct rohc_decomp_crc_repair_budget *const decomp_budget =
+		&decomp->crc_repair_budget;
+
+	rohc_decomp_crc_repair_budget_renew(ctxt_budget, decomp->crc_repair_window,
+	                                    pkt_arrival_time);
+	rohc_decomp_crc_repair_budget_renew(decomp_budget, decomp->crc_repair_window,
+	                                    pkt_arrival_time);
+
+	if(decomp->crc_repair_ctxt_max != 0 &&
+	   ctxt_budget->attempts_nr >= decomp->crc_repair_ctxt_max)
+	{
+		rohc_decomp_warn(context, "CID %zu: CRC repair: skip repair, %zu repairs "
+		                 "already attempted by context in the last %zu ms",
+		                 context->cid, ctxt_budget->attempts_nr,
+		                 decomp->crc_repair_window);
+		goto skip;
+	}
+	if(decomp->crc_repair_decomp_max != 0 &&
+	   decomp_budget->attempts_nr >= decomp->crc_repair_decomp_max)
+	{
+		rohc_decomp_warn(context, "CID %zu: CRC repair: skip repair, %zu repairs "
+		                 "already attempted by decompressor in the last %zu ms",
+		                 context->cid, decomp_budget->attempts_nr,
+		                 decomp->crc_repair_window);
+		goto skip;
+	}
+
+	ctxt_budget->attempts_nr++;
+	decomp_budget->attempts_nr++;
+	return true;
+
+skip:
+	rohc_seqlock_write_begin(&decomp->stats_seq);
+#if ROHC_SMALL_CONTEXTS != 1
+	context->skipped_crc_repairs++;
+#endif
+	decomp->stats.skipped_crc_repairs++;
+	rohc_seqlock_write_end(&decomp->stats_seq);
+	return false;
+}
+
+
+/**
+ * @brief Start a new time window for repair attempts if the current one ended
+ *
+ * @param budget            The budget of repair attempts
+ * @param window            The duration of the time window (in ms)
+ * @param pkt_arrival_time  The arrival time of the current ROHC packet
+ */
+static void rohc_decomp_crc_repair_budget_renew(struct rohc_decomp_crc_repair_budget *const budget,
+                                                const size_t window,
+                                                const struct rohc_ts pkt_arrival_time)
+{
+	const uint64_t elapsed =
+		rohc_time_interval(budget->window_start, pkt_arrival_time);
+
+	/* a packet older than the time window also starts a new time window */
+	if(budget->attempts_nr == 0 || elapsed >= (window * 1000U))
+	{
+		budget->attempts_nr = 0;
+		budget->window_start = pkt_arrival_time;
+	}
+}
+
+
+/**
+ * @brief Shift the histories of errors and feedbacks for one more packet
+ *
+ * @param last_pkts_errors  The history of the decompression errors
+ * @param stats             The histories of the needed/sent feedbacks, one
+ *                          per type of feedback
+ * @param is_error          Whether the packet failed to be decompressed
+ */
+static void rohc_decomp_feedback_stats_shift(uint32_t *const last_pkts_errors,
+                                             struct rohc_ack_stats *const stats,
+                                             const bool is_error)
+{
+	size_t i;
+
+	*last_pkts_errors = ((*last_pkts_errors) << 1) | (is_error ? 1 : 0);
+	for(i = 0; i < ROHC_FEEDBACK_RESERVED; i++)
+	{
+		stats[i].needed <<= 1;
+		stats[i].sent <<= 1;
+	}
+}
+
+
+/**
+ * @brief Compute the threshold of one k/n rate-limit
+ *
+ * The rate-limits are checked against the number of bits set in the 32-bit
+ * histories of the last packets: the k/n ratio is turned once into the
+ * smallest number of packets out of 32 that reaches it.
+ *
+ * @param k  The k rate-limit parameter
+ * @param n  The n rate-limit parameter, shall not be zero
+ * @return   The threshold, in packets out of the last 32 packets
+ */
+static size_t rohc_decomp_rate_limit_threshold(const size_t k, const size_t n)
+{
+	/* the ratio is computed in hundredths of packet, then rounded up */
+	return ((k * 32 * 100 / n) + 99) / 100;
+}
+
+
+/**
+ * @brief Build a positive ACK feedback
+ *
+ * @param decomp         The ROHC decompressor
+ * @param infos          The information collected on the successfully
+ *                       decompressed packet
+ * @param[out] feedback  The feedback to be transmitted to the remote
+ *                       compressor through the feedback channel
+ * @return               true if the ACK feedback was successfully built
+ *                       (may be 0 byte), false if a problem occurred
+ */
+static bool rohc_decomp_feedback_ack(struct rohc_decomp *const decomp,
+                                     const struct rohc_decomp_stream *const infos,
+                                     struct rohc_buf *const feedback)
+{
+	struct rohc_decomp_feedback_intent intent;
+	bool do_build_ack = false;
+	size_t k;
+
+	assert(infos->cid_found);
+	assert(infos->context_found);
+
+	rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+	           "CID %zu: %s: %s state: %s packet successfully decompressed",
+	           infos->cid, rohc_get_mode_descr(infos->mode),
+	           rohc_decomp_get_state_descr(infos->state),
+	           rohc_get_packet_descr(infos->packet_type));
+
+	/* update all the stats about the feedbacks */
+	rohc_decomp_feedback_stats_shift(&decomp->last_pkts_errors,
+	                                 decomp->last_pkt_feedbacks, false);
+	rohc_decomp_feedback_stats_shift(&infos->context->last_pkts_errors,
+	                                 infos->context->last_pkt_feedbacks, false);
+
+	/* force sending an ACK if compressor/decompressor modes mismatch or
+	 * if decompressor just changed its operational mode */
+	if(infos->do_change_mode)
+	{
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+		           "force positive ACK because mode changed or compressor "
+		           "reported a different mode");
+		do_build_ack = true;
+	}
+	/* check if the decompressor shall build a positive feedback */
+	else if(infos->mode == ROHC_U_MODE)
+	{
+		/* send ACK(U) with rate-limiting as stated in RFC 3095, §5.3.1.3:
+		 *   To improve performance for the Unidirectional mode over a link that
+		 *   does have a feedback channel, the decompressor MAY send an
+		 *   acknowledgment when decompression succeeds.  Setting the mode
+		 *   parameter in the ACK packet to U indicates that the compressor is to
+		 *   stay in Unidirectional mode. [...] If IR packets continue to arrive,
+		 *   the decompressor MAY repeat the ACK(U), but it SHOULD NOT repeat the
+		 *   ACK(U) continuously.*/
+		do_build_ack = true;
+	}
+	else if(infos->mode == ROHC_O_MODE)
+	{
+		/* feedback logic for O-mode is described in RFC 3095, §5.4.2.2 */
+
+		/* all states: when an IR packet is correctly decompressed, send an ACK(O) */
+		if(infos->packet_type == ROHC_PACKET_IR)
+		{
+			do_build_ack = true;
+		}
+		/* SC state:
+		 *  - when a type 2 or an IR-DYN packet is correctly decompressed,
+		 *    optionally send an ACK(O)
+		 * FC state:
+		 *  - when a type 2 or an IR-DYN packet is correctly decompressed,
+		 *    optionally send an ACK(O)
+		 *  - when a type 0 or 1 packet is correctly decompressed, no
+		 *    feedback is sent */
+		else if(infos->state != ROHC_DECOMP_STATE_NC &&
+		        rohc_decomp_packet_carry_crc_7_or_8(infos->packet_type))
+		{
+			do_build_ack = true;
+		}
+	}
+	else /* R-mode */
+	{
+		assert(0); /* TODO: R-mode not implemented yet */
+		goto error;
+	}
+
+	/* stop now if no ACK is required */
+	if(!do_build_ack)
+	{
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+		           "no need to send a positive ACK");
+		goto skip;
+	}
+
+	/* rate-limit the ACKs */
+	decomp->last_pkt_feedbacks[ROHC_FEEDBACK_ACK].needed |= 1;
+	infos->context->last_pkt_feedbacks[ROHC_FEEDBACK_ACK].needed |= 1;
+	k = __builtin_popcount(infos->context->last_pkt_feedbacks[ROHC_FEEDBACK_ACK].sent);
+	if(k >= decomp->ack_rate_limits.speed.threshold)
+	{
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+		           "do not send a positive ACK because of rate-limiting (%zu of 32 "
+		           "with threshold %zu)", k, decomp->ack_rate_limits.speed.threshold);
+		goto skip;
+	}
+	rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+	           "should send a positive ACK now (CID = %zu, current mode = %d, "
+	           "target mode = %d, at least %zu bits of SN 0x%x, rate-limiting = "
+	           "%zu of 32 with threshold %zu)", infos->cid, infos->mode,
+	           decomp->target_mode, infos->sn_bits_nr, infos->sn_bits,
+	           k, decomp->ack_rate_limits.speed.threshold);
+	decomp->last_pkt_feedbacks[ROHC_FEEDBACK_ACK].sent |= 1;
+	infos->context->last_pkt_feedbacks[ROHC_FEEDBACK_ACK].sent |= 1;
+
+	/* prepare feedback packet if asked by user, now or later */
+	intent.cid = infos->cid;
+	intent.cid_type = infos->cid_type;
+	intent.profile_id = infos->profile_id;
+	intent.ack_type = ROHC_FEEDBACK_ACK;
+	intent.mode = infos->mode;
+	intent.sn_bits = infos->sn_bits;
+	intent.sn_bits_nr = infos->sn_bits_nr;
+	intent.do_change_mode = infos->do_change_mode;
+	if(decomp->feedback_coalescing.max_pkts > 0)
+	{
+		/* keep the latest ACK of the context until the window expires */
+		if(!rohc_decomp_coalesce_feedback(decomp, &intent, feedback))
+		{
+			goto error;
+		}
+	}
+	else if(!rohc_decomp_emit_feedback(decomp, &intent, feedback))
+	{
+		goto error;
+	}
+
+skip:
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Build a negative ACK feedback
+ *
+ * There are two types of negative feedback: NACK and STATIC-NACK.
+ *
+ * @param decomp         The ROHC decompressor
+ * @param infos          The information collected on the failed
+ *                       decompressed packet
+ * @param[out] feedback  The feedback to be transmitted to the remote
+ *                       compressor through the feedback channel (may be NULL)
+ * @return               true if the ACK feedback was successfully built
+ *                       (may be 0 byte), false if a problem occurred
+ */
+static bool rohc_decomp_feedback_nack(struct rohc_decomp *const decomp,
+                                      const struct rohc_decomp_stream *const infos,
+                                      struct rohc_buf *const feedback)
+{
+	struct rohc_decomp_feedback_intent intent;
+	bool do_downward_transition = false;
+	bool do_build_ack = false;
+	enum rohc_feedback_ack_type ack_type;
+	size_t threshold_too_quickly;
+	size_t k_too_quickly;
+	size_t k_too_many;
+
+	/* update all the stats about the feedbacks */
+	rohc_decomp_feedback_stats_shift(&decomp->last_pkts_errors,
+	                                 decomp->last_pkt_feedbacks, true);
+	if(infos->context != NULL)
+	{
+		rohc_decomp_feedback_stats_shift(&infos->context->last_pkts_errors,
+		                                 infos->context->last_pkt_feedbacks, true);
+	}
+
+	/* the decompressor cannot warn the compressor if the CID is not identified
+	 * (this happens only if packet is malformed) */
+	if(!infos->cid_found)
+	{
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+		           "do not perform downward state transition nor send negative "
+		           "feedback to compressor since CID was not identified");
+		goto skip;
+	}
+
+	if(infos->context_found)
+	{
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+		           "CID %zu: %s: %s state: %s packet %s", infos->cid,
+		           rohc_get_mode_descr(infos->mode),
+		           rohc_decomp_get_state_descr(infos->state),
+		           rohc_get_packet_descr(infos->packet_type),
+		           infos->crc_failed ? "failed the CRC check" : "received");
+	}
+	else
+	{
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+		           "CID %zu: packet failed to be parsed", infos->cid);
+	}
+
+	/* check if the decompressor shall build a negative feedback */
+	if(infos->profile_id == ROHC_PROFILE_UNCOMPRESSED)
+	{
+		/* the Uncompressed profile does not use negative feedback nor FEEDBACK-2 */
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+		           "do not perform downward state transition nor send negative "
+		           "feedback for the Uncompressed profile");
+		goto skip;
+	}
+	else if(!infos->context_found)
+	{
+		/* RFC says nothing about negative feedbacks for malformed packets, but
+		 * it seems useful to tell the compressor to got back to lower states
+		 * if a packet failed to be parsed */
+		ack_type = ROHC_FEEDBACK_STATIC_NACK;
+		do_downward_transition = false; /* impossible w/o context */
+		do_build_ack = !!(decomp->target_mode > ROHC_U_MODE);
+	}
+	else if(infos->mode == ROHC_U_MODE)
+	{
+		/* U-mode does not use negative feedback */
+		ack_type = ROHC_FEEDBACK_NACK;
+		do_downward_transition = true;
+		do_build_ack = false;
+	}
+	else if(infos->mode == ROHC_O_MODE)
+	{
+		/* feedback logic for O-mode is described in RFC 3095, §5.4.2.2 */
+
+		/* NC state: when receiving a type 0, 1, 2 or IR-DYN packet, or an IR
+		 * packet has failed the CRC check, send a STATIC-NACK(O), subject to the
+		 * considerations at the beginning of section 5.7.6 */
+		if(infos->state == ROHC_DECOMP_STATE_NC)
+		{
+			ack_type = ROHC_FEEDBACK_STATIC_NACK;
+			do_downward_transition = true;
+			do_build_ack = true;
+		}
+		/* SC state:
+		 *  - when a type 0 or 1 packet is received, treat it as a mismatching
+		 *    CRC and use the logic of section 5.3.2.2.3 to decide if a NACK(O)
+		 *    should be sent
+		 *  - when decompression of a type 2 packet, an IR-DYN packet or an
+		 *    IR packet has failed, use the logic of section 5.3.2.2.3 to
+		 *    decide if a STATIC-NACK(O) should be sent */
+		else if(infos->state == ROHC_DECOMP_STATE_SC)
+		{
+			if(!rohc_decomp_packet_carry_crc_7_or_8(infos->packet_type))
+			{
+				ack_type = ROHC_FEEDBACK_NACK;
+				do_downward_transition = true;
+				do_build_ack = true;
+			}
+			else
+			{
+				ack_type = ROHC_FEEDBACK_STATIC_NACK;
+				do_downward_transition = true;
+				do_build_ack = true;
+			}
+		}
+		/* FC state: when any packet fails the CRC check, use the logic of
+		 * 5.3.2.2.3 to decide if a NACK(O) should be sent */
+		else
+		{
+			ack_type = ROHC_FEEDBACK_NACK;
+			do_downward_transition = true;
+			do_build_ack = true;
+		}
+	}
+	else /* R-mode */
+	{
+		assert(0); /* TODO: R-mode not implemented yet */
+		goto error;
+	}
+
+	/* stop now if no downward state transition nor NACK is required */
+	if(!do_build_ack && !do_downward_transition)
+	{
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+		           "no need to perform a downward state transition nor send a "
+		           "negative ACK");
+		goto skip;
+	}
+	assert(ack_type == ROHC_FEEDBACK_NACK || ack_type == ROHC_FEEDBACK_STATIC_NACK);
+
+	/* rate-limit the downward state transitions and NACKs */
+	if(infos->context != NULL)
+	{
+		decomp->last_pkt_feedbacks[ack_type].needed |= 1;
+		infos->context->last_pkt_feedbacks[ack_type].needed |= 1;
+		k_too_quickly = __builtin_popcount(infos->context->last_pkts_errors);
+		k_too_many = __builtin_popcount(infos->context->last_pkt_feedbacks[ack_type].sent);
+	}
+	else
+	{
+		decomp->last_pkt_feedbacks[ack_type].needed |= 1;
+		k_too_quickly = __builtin_popcount(decomp->last_pkts_errors);
+		k_too_many = __builtin_popcount(decomp->last_pkt_feedbacks[ack_type].sent);
+	}
+	if(ack_type == ROHC_FEEDBACK_NACK)
+	{
+		threshold_too_quickly = decomp->ack_rate_limits.nack.threshold;
+	}
+	else
+	{
+		threshold_too_quickly = decomp->ack_rate_limits.static_nack.threshold;
+	}
+	if(k_too_quickly < threshold_too_quickly)
+	{
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+		           "avoid sending feedback too quickly (%zu of 32 with threshold %zu)",
+		           k_too_quickly, threshold_too_quickly);
+
+		/* force sending a negative ACK if compressor/decompressor modes mismatch
+		 * or if decompressor just changed its operational mode */
+		if(do_build_ack && infos->do_change_mode)
+		{
+			rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+			           "force negative ACK because mode changed or compressor "
+			           "reported a different mode");
+			do_build_ack = true;
+		}
+		else
+		{
+			do_build_ack = false;
+		}
+		do_downward_transition = false;
+	}
+	else if(k_too_quickly > threshold_too_quickly &&
+	        k_too_many >= decomp->ack_rate_limits.speed.threshold)
+	{
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+		           "rate-limiting successive feedbacks (%zu of 32 with threshold "
+		           "%zu)", k_too_many, decomp->ack_rate_limits.speed.threshold);
+
+		/* force sending a negative ACK if compressor/decompressor modes mismatch
+		 * or if decompressor just changed its operational mode */
+		if(do_build_ack && infos->do_change_mode)
+		{
+			rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+			           "force negative ACK because mode changed or compressor "
+			           "reported a different mode");
+			do_build_ack = true;
+		}
+		else
+		{
+			do_build_ack = false;
+		}
+		do_downward_transition = false;
+	}
+
+	/* update informations if feedback is sent or downward transition taken */
+	if(do_build_ack || do_downward_transition)
+	{
+		decomp->last_pkt_feedbacks[ack_type].sent |= 1;
+		if(infos->context != NULL)
+		{
+			infos->context->last_pkt_feedbacks[ack_type].sent |= 1;
+		}
+	}
+
+	/* prepare feedback packet if needed and asked by user */
+	if(!do_build_ack)
+	{
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+		           "do not send a negative ACK");
+	}
+	else
+	{
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+		           "should send a negative ACK (CID = %zu, NACK type = %d, current "
+		           "mode = %d, target mode = %d, at least %zu bits of SN 0x%x, "
+		           "rate-limiting = %zu of 32 with threshold %zu and %zu of 32 "
+		           "with threshold %zu)", infos->cid, ack_type, infos->mode,
+		           decomp->target_mode, infos->sn_bits_nr, infos->sn_bits,
+		           k_too_quickly, threshold_too_quickly,
+		           k_too_many, decomp->ack_rate_limits.speed.threshold);
+
+		/* prepare feedback packet if asked by user, now or later */
+		intent.cid = infos->cid;
+		intent.cid_type = infos->cid_type;
+		intent.profile_id = infos->profile_id;
+		intent.ack_type = ack_type;
+		intent.mode = infos->mode;
+		intent.sn_bits = infos->sn_bits;
+		intent.sn_bits_nr = infos->sn_bits_nr;
+		intent.do_change_mode = infos->do_change_mode;
+
+		/* the negative ACK is sent at once, it supersedes the ACK of the
+		 * context that waits in the coalescing window if any */
+		rohc_decomp_coalesce_drop(decomp, intent.cid);
+		if(!rohc_decomp_emit_feedback(decomp, &intent, feedback))
+		{
+			goto error;
+		}
+	}
+
+	/* upon decompression failure, perform downward transitions if context is
+	 * still available (new contexts are destroyed upon decompression error) */
+	if(!do_downward_transition || infos->context == NULL)
+	{
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+		           "do not perform a downward state transition");
+	}
+	else
+	{
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+		           "perform a downward state transition now (CID = %zu, NACK "
+		           "type = %d, current mode = %d, target mode = %d, rate-limiting "
+		           "= %zu of 32 with threshold %zu and %zu of 32 with "
+		           "threshold %zu)", infos->cid, ack_type, infos->mode,
+		           decomp->target_mode, k_too_quickly, threshold_too_quickly,
+		           k_too_many, decomp->ack_rate_limits.speed.threshold);
+
+		if(infos->state == ROHC_DECOMP_STATE_SC)
+		{
+			rohc_info(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+			          "change from state %d to state %d because of error(s)",
+			          infos->state, ROHC_DECOMP_STATE_NC);
+			rohc_probe4(decomp_state_change, decomp, infos->cid, infos->state,
+			            ROHC_DECOMP_STATE_NC);
+			infos->context->state = ROHC_DECOMP_STATE_NC;
+		}
+		else if(infos->state == ROHC_DECOMP_STATE_FC)
+		{
+			rohc_info(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+			          "change from state %d to state %d because of error(s)",
+			          infos->state, ROHC_DECOMP_STATE_SC);
+			rohc_probe4(decomp_state_change, decomp, infos->cid, infos->state,
+			            ROHC_DECOMP_STATE_SC);
+			infos->context->state = ROHC_DECOMP_STATE_SC;
+		}
+		else
+		{
+			rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+			           "stay in state %d because of error(s)", infos->context->state);
+		}
+	}
+
+skip:
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Update statistics upon successful decompression
+ *
+ * @param context         The decompression context
+ * @param comp_hdr_len    The length (in bytes) of the compressed header
+ * @param uncomp_hdr_len  The length (in bytes) of the uncompressed header
+ */
+static void rohc_decomp_stats_add_success(struct rohc_decomp_ctxt *const context __attribute__((unused)),
+                                          const size_t comp_hdr_len __attribute__((unused)),
+                                          const size_t uncomp_hdr_len __attribute__((unused)))
+{
+#if ROHC_SMALL_CONTEXTS != 1
+	rohc_seqlock_write_begin(&context->decompressor->stats_seq);
+	context->header_compressed_size += comp_hdr_len;
+	context->header_uncompressed_size += uncomp_hdr_len;
+	rohc_seqlock_write_end(&context->decompressor->stats_seq);
+#endif
+}
+
+
+/**
+ * @brief Reset all the statistics of the given ROHC decompressor
+ *
+ * @param decomp The ROHC decompressor
+ */
+static void rohc_decomp_reset_stats(struct rohc_decomp *const decomp)
+{
+	assert(decomp != NULL);
+	rohc_seqlock_write_begin(&decomp->stats_seq);
+	decomp->stats.received = 0;
+	decomp->stats.failed_crc = 0;
+	decomp->stats.failed_no_context = 0;
+	decomp->stats.failed_decomp = 0;
+	decomp->stats.total_compressed_size = 0;
+	decomp->stats.total_uncompressed_size = 0;
+	decomp->stats.corrected_crc_failures = 0;
+	decomp->stats.corrected_sn_wraparounds = 0;
+	decomp->stats.corrected_wrong_sn_updates = 0;
+	decomp->stats.skipped_crc_repairs = 0;
+	memset(&decomp->stats.pkt_stats, 0, sizeof(rohc_packet_stats_t));
+	rohc_seqlock_write_end(&decomp->stats_seq);
+#ifdef ROHC_STAGE_CYCLES
+	memset(&decomp->stage_cycles, 0, sizeof(decomp->stage_cycles));
+#endif
+}
+
+
+/**
+ * @brief Give a description for the given ROHC decompression context state
+ *
+ * Give a description for the given ROHC decompression context state.
+ *
+ * The descriptions are not part of the API. They may change between
+ * releases without any warning. Do NOT use them for other means that
+ * providing to users a textual description of decompression context states
+ * used by the library. If unsure, ask on the mailing list.
+ *
+ * @param state  The decompression context state to get a description for
+ * @return       A string that describes the given decompression context state
+ *
+ * @ingroup rohc_decomp
+ */
+const char * rohc_decomp_get_state_descr(const rohc_decomp_state_t state)
+{
+	switch(state)
+	{
+		case ROHC_DECOMP_STATE_NC:
+			return "No Context";
+		case ROHC_DECOMP_STATE_SC:
+			return "Static Context";
+		case ROHC_DECOMP_STATE_FC:
+			return "Full Context";
+		case ROHC_DECOMP_STATE_UNKNOWN:
+		default:
+			return "no description";
+	}
+}
+
+
+/**
+ * @brief Get some information about the last decompressed packet
+ *
+ * Get some information about the last decompressed packet.
+ *
+ * To use the function, call it with a pointer on a pre-allocated
+ * \ref rohc_decomp_last_packet_info_t structure with the \e version_major
+ * and \e version_minor fields set to one of the following supported
+ * versions:
+ *  - Major 0, minor 0
+ *  - Major 0, minor 1
+ *
+ * See \ref rohc_decomp_last_packet_info_t for details about fields that
+ * are supported in the above versions.
+ *
+ * @param decomp        The ROHC decompressor to get information from
+ * @param[in,out] info  The structure where information will be stored
+ * @return              true in case of success, false otherwise
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_last_packet_info_t
+ */
+bool rohc_decomp_get_last_packet_info(const struct rohc_decomp *const decomp,
+                                      rohc_decomp_last_packet_info_t *const info)
+{
+	if(decomp == NULL)
+	{
+		goto error;
+	}
+
+	if(decomp->last_context == NULL)
+	{
+		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "last context found in decompressor is not valid");
+		goto error;
+	}
+
+	if(info == NULL)
+	{
+		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "structure for last packet information is not valid");
+		goto error;
+	}
+
+	/* check compatibility version */
+	if(info->version_major == 0)
+	{
+		/* base fields for major version 0 */
+		info->context_mode = decomp->last_context->mode;
+		info->context_state = decomp->last_context->state;
+		info->profile_id = decomp->last_context->profile->id;
+		info->nr_lost_packets = decomp->last_context->nr_lost_packets;
+		info->nr_misordered_packets = decomp->last_context->nr_misordered_packets;
+		info->is_duplicated = decomp->last_context->is_duplicated;
+
+		/* new fields added by minor versions */
+		switch(info->version_minor)
+		{
+			case 0:
+				/* nothing to add */
+				break;
+			case 1:
+				/* new fields in 0.1 */
+#if ROHC_SMALL_CONTEXTS == 1
+				/* small contexts keep no statistics */
+				info->corrected_crc_failures = 0;
+				info->corrected_sn_wraparounds = 0;
+				info->corrected_wrong_sn_updates = 0;
+#else
+				info->corrected_crc_failures =
+					decomp->last_context->corrected_crc_failures;
+				info->corrected_sn_wraparounds =
+					decomp->last_context->corrected_sn_wraparounds;
+				info->corrected_wrong_sn_updates =
+					decomp->last_context->corrected_wrong_sn_updates;
+#endif
+				info->packet_type = decomp->last_context->packet_type;
+				break;
+			default:
+				rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+				           "unsupported minor version (%u) of the structure for "
+				           "last packet information", info->version_minor);
+				goto error;
+		}
+	}
+	else
+	{
+		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "unsupported major version (%u) of the structure for last "
+		           "packet information", info->version_major);
+		goto error;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get some information about the given decompression context
+ *
+ * Get some information about the given decompression context.
+ *
+ * The function may be called by another thread while the decompressor
+ * decompresses packets: the counters it gets are consistent with each other.
+ *
+ * To use the function, call it with a pointer on a pre-allocated
+ * \ref rohc_decomp_context_info_t structure with the \e version_major
+ * and \e version_minor fields set to one of the following supported
+ * versions:
+ *  - Major 0, minor 0
+ *  - Major 0, minor 1
+ *
+ * See \ref rohc_decomp_context_info_t for details about fields that
+ * are supported in the above versions.
+ *
+ * @param decomp        The ROHC decompressor to get information from
+ * @param cid           The Context ID to get information for
+ * @param[in,out] info  The structure where information will be stored
+ * @return              true in case of success, false otherwise
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_context_info_t
+ */
+bool rohc_decomp_get_context_info(const struct rohc_decomp *const decomp,
+                                  const rohc_cid_t cid,
+                                  rohc_decomp_context_info_t *const info)
+{
+	rohc_seqlock_t seq;
+
+	if(decomp == NULL)
+	{
+		goto error;
+	}
+
+	if(cid > decomp->medium.max_cid)
+	{
+		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "decompressor does not handle CID %zu since MAX_CID is %zu",
+		           cid, decomp->medium.max_cid);
+		goto error;
+	}
+
+	if(info == NULL)
+	{
+		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "structure for context information is not valid");
+		goto error;
+	}
+
+	/* check compatibility version */
+	if(info->version_major != 0)
+	{
+		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "unsupported major version (%u) of the structure for context"
+		           "information", info->version_major);
+		goto error;
+	}
+	if(info->version_minor > 2)
+	{
+		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "unsupported minor version (%u) of the structure for "
+		           "context information", info->version_minor);
+		goto error;
+	}
+
+	do
+	{
+		const struct rohc_decomp_ctxt *context;
+
+		seq = rohc_seqlock_read_begin(&decomp->stats_seq);
+		context = decomp->contexts[cid];
+
+		/* base fields for major version 0 */
+		if(context == NULL)
+		{
+			info->packets_nr = 0;
+			info->comp_bytes_nr = 0;
+			info->uncomp_bytes_nr = 0;
+			info->corrected_crc_failures = 0;
+			info->corrected_sn_wraparounds = 0;
+			info->corrected_wrong_sn_updates = 0;
 		}
 		else
 		{
-			/* uncompressed headers successfully built but CRC is incorrect,
-			 * try decoding with different values (repair) */
+			info->packets_nr = context->num_recv_packets;
+#if ROHC_SMALL_CONTEXTS == 1
+			/* small contexts keep no statistics */
+			info->comp_bytes_nr = 0;
+			info->uncomp_bytes_nr = 0;
+			info->corrected_crc_failures = 0;
+			info->corrected_sn_wraparounds = 0;
+			info->corrected_wrong_sn_updates = 0;
+#else
+			info->comp_bytes_nr = context->total_compressed_size;
+			info->uncomp_bytes_nr = context->total_uncompressed_size;
+			info->corrected_crc_failures = context->corrected_crc_failures;
+			info->corrected_sn_wraparounds = context->corrected_sn_wraparounds;
+			info->corrected_wrong_sn_updates = context->corrected_wrong_sn_updates;
+#endif
+		}
+
+		/* new fields in 0.1 */
+		if(info->version_minor >= 1)
+		{
+#if ROHC_SMALL_CONTEXTS == 1
+			info->skipped_crc_repairs = 0;
+#else
+			info->skipped_crc_repairs =
+				(context == NULL ? 0 : context->skipped_crc_repairs);
+#endif
+		}
+
+		/* new fields in 0.2 */
+		if(info->version_minor >= 2)
+		{
+			memset(info->packet_types_nr, 0, sizeof(info->packet_types_nr));
+			info->crc_failures = 0;
+			info->avg_decode_cycles = 0;
+#if ROHC_SMALL_CONTEXTS != 1
+			if(context != NULL)
+			{
+				unsigned long decoded_nr = 0;
+				size_t i;
+
+				for(i = 0; i < ROHC_PACKET_MAX; i++)
+				{
+					info->packet_types_nr[i] = context->packet_types_nr[i];
+					decoded_nr += context->packet_types_nr[i];
+				}
+				info->crc_failures = context->crc_failures;
+				if(decoded_nr > 0)
+				{
+					info->avg_decode_cycles = context->decode_cycles / decoded_nr;
+				}
+			}
+#endif
+		}
+	}
+	while(rohc_seqlock_read_retry(&decomp->stats_seq, seq));
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get some general information about the decompressor
+ *
+ * Get some general information about the decompressor.
+ *
+ * The function may be called by another thread while the decompressor
+ * decompresses packets: the counters it gets are consistent with each other.
+ *
+ * To use the function, call it with a pointer on a pre-allocated
+ * \ref rohc_decomp_general_info_t structure with the \e version_major and
+ * \e version_minor fields set to one of the following supported versions:
+ *  - Major 0, minor 0
+ *  - Major 0, minor 1
+ *  - Major 0, minor 2
+ *
+ * See the \ref rohc_decomp_general_info_t structure for details about fields
+ * that are supported in the above versions.
+ *
+ * @param decomp        The ROHC decompressor to get information from
+ * @param[in,out] info  The structure where information will be stored
+ * @return              true in case of success, false otherwise
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_general_info_t
+ */
+bool rohc_decomp_get_general_info(const struct rohc_decomp *const decomp,
+                                  rohc_decomp_general_info_t *const info)
+{
+	rohc_seqlock_t seq;
+
+	if(decomp == NULL)
+	{
+		goto error;
+	}
+
+	if(info == NULL)
+	{
+		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "structure for general information is not valid");
+		goto error;
+	}
+
+	/* check compatibility version */
+	if(info->version_major == 0)
+	{
+		/* base fields for major version 0 */
+		do
+		{
+			seq = rohc_seqlock_read_begin(&decomp->stats_seq);
+			info->contexts_nr = decomp->num_contexts_used;
+			info->packets_nr = decomp->stats.received;
+			info->comp_bytes_nr = decomp->stats.total_compressed_size;
+			info->uncomp_bytes_nr = decomp->stats.total_uncompressed_size;
+
+			/* new fields added by minor versions */
+			switch(info->version_minor)
+			{
+				case 0:
+					/* nothing to add */
+					break;
+				case 1:
+					/* new fields in 0.1 */
+					info->corrected_crc_failures = decomp->stats.corrected_crc_failures;
+					info->corrected_sn_wraparounds =
+						decomp->stats.corrected_sn_wraparounds;
+					info->corrected_wrong_sn_updates =
+						decomp->stats.corrected_wrong_sn_updates;
+					break;
+				case 2:
+					/* new fields in 0.1 */
+					info->corrected_crc_failures = decomp->stats.corrected_crc_failures;
+					info->corrected_sn_wraparounds =
+						decomp->stats.corrected_sn_wraparounds;
+					info->corrected_wrong_sn_updates =
+						decomp->stats.corrected_wrong_sn_updates;
+					/* new fields in 0.2 */
+					info->skipped_crc_repairs = decomp->stats.skipped_crc_repairs;
+					break;
+				default:
+					rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+					           "unsupported minor version (%u) of the structure for "
+					           "general information", info->version_minor);
+					goto error;
+			}
+		}
+		while(rohc_seqlock_read_retry(&decomp->stats_seq, seq));
+	}
+	else
+	{
+		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "unsupported major version (%u) of the structure for "
+		           "general information", info->version_major);
+		goto error;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get the counters of packets per profile and per packet type
+ *
+ * Get the number of packets, uncompressed bytes and compressed bytes that
+ * every profile and every packet type accounted for since the decompressor
+ * was created. Only the packets successfully decompressed are counted.
+ * The counters may be read by another thread while packets are decompressed.
+ *
+ * To use the function, call it with a pointer on a pre-allocated
+ * \ref rohc_packet_stats_t structure with the \e version_major and
+ * \e version_minor fields set to one of the following supported versions:
+ *  - Major 0, minor 0
+ *
+ * See the \ref rohc_packet_stats_t structure for details about fields that
+ * are supported in the above versions.
+ *
+ * @param decomp         The ROHC decompressor to get the counters from
+ * @param[in,out] stats  The structure where the counters will be stored
+ * @return               true in case of success, false otherwise
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_packet_stats_t
+ */
+bool rohc_decomp_get_packet_stats(const struct rohc_decomp *const decomp,
+                                  rohc_packet_stats_t *const stats)
+{
+	rohc_seqlock_t seq;
+
+	if(decomp == NULL)
+	{
+		goto error;
+	}
+
+	if(stats == NULL)
+	{
+		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "structure for packet statistics is not valid");
+		goto error;
+	}
+
+	/* check compatibility version */
+	if(stats->version_major == 0)
+	{
+		/* base fields for major version 0 */
+		do
+		{
+			seq = rohc_seqlock_read_begin(&decomp->stats_seq);
+			memcpy(stats->profiles, decomp->stats.pkt_stats.profiles,
+			       sizeof(rohc_packet_counters_t) * ROHC_PROFILE_MAX);
+			memcpy(stats->packet_types, decomp->stats.pkt_stats.packet_types,
+			       sizeof(rohc_packet_counters_t) * ROHC_PACKET_MAX);
+		}
+		while(rohc_seqlock_read_retry(&decomp->stats_seq, seq));
+
+		/* new fields added by minor versions */
+		if(stats->version_minor > 0)
+		{
+			rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			           "unsupported minor version (%u) of the structure for "
+			           "packet statistics", stats->version_minor);
+			goto error;
+		}
+	}
+	else
+	{
+		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "unsupported major version (%u) of the structure for "
+		           "packet statistics", stats->version_major);
+		goto error;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get the processing time of packets per profile and per packet type
+ *
+ * Get the number of packets, the mean, the maximum, and the 50th, 99th and
+ * 99.9th percentiles of the processing time of packets, for all packets and
+ * for every profile and every packet type. The processing time of one packet
+ * is measured from the entry of the decompression function to its exit with the
+ * monotonic clock of the system.
+ *
+ * The processing times are recorded only while the \ref ROHC_DECOMP_FEATURE_LATENCY
+ * feature is enabled (see \ref rohc_decomp_set_features), and only for the
+ * packets successfully decompressed. All the counters are zero if the
+ * feature was never enabled.
+ *
+ * To use the function, call it with a pointer on a pre-allocated
+ * \ref rohc_latency_stats_t structure with the \e version_major and
+ * \e version_minor fields set to one of the following supported versions:
+ *  - Major 0, minor 0
+ *
+ * See the \ref rohc_latency_stats_t structure for details about fields that
+ * are supported in the above versions.
+ *
+ * @param decomp         The ROHC decompressor to get the processing times from
+ * @param[in,out] stats  The structure where to store the processing times
+ * @return               true in case of success, false otherwise
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_latency_stats_t
+ * @see ROHC_DECOMP_FEATURE_LATENCY
+ */
+bool rohc_decomp_get_latency_stats(const struct rohc_decomp *const decomp,
+                                   rohc_latency_stats_t *const stats)
+{
+	if(decomp == NULL)
+	{
+		goto error;
+	}
+
+	if(stats == NULL)
+	{
+		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "structure for latency statistics is not valid");
+		goto error;
+	}
+
+	/* check compatibility version */
+	if(stats->version_major == 0)
+	{
+		/* base fields for major version 0 */
+		rohc_latency_get_stats(decomp->latency, stats);
+
+		/* new fields added by minor versions */
+		if(stats->version_minor > 0)
+		{
+			rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			           "unsupported minor version (%u) of the structure for "
+			           "latency statistics", stats->version_minor);
+			goto error;
+		}
+	}
+	else
+	{
+		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "unsupported major version (%u) of the structure for "
+		           "latency statistics", stats->version_major);
+		goto error;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get the CPU cycles spent in one stage of the decompression
+ *
+ * Get the CPU cycles that the decompressor spent in the given stage since its
+ * creation, for all the packets it decoded. The cycles are read from the
+ * time-stamp counter on x86 and from the virtual counter on ARM64; they are
+ * replaced by nanoseconds of the monotonic clock on the other architectures
+ * and in the Linux kernel. The cycles spent to compute CRCs are accounted in
+ * the \ref ROHC_DECOMP_STAGE_CRC stage only.
+ *
+ * The cycles are accounted only if the library was built with the
+ * --enable-stage-cycles option of the configure script.
+ *
+ * @param decomp       The ROHC decompressor to get the CPU cycles from
+ * @param stage        The stage of the decompression
+ * @param[out] cycles  The CPU cycles spent in the stage
+ * @return             true in case of success,
+ *                     false if the library was built without the accounting
+ *                     of CPU cycles or if a parameter is invalid
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_stage_t
+ * @see rohc_decomp_get_stage_descr
+ */
+bool rohc_decomp_get_stage_cycles(const struct rohc_decomp *const decomp,
+                                  const rohc_decomp_stage_t stage,
+                                  uint64_t *const cycles)
+{
+	if(decomp == NULL)
+	{
+		goto error;
+	}
+
+	if(stage >= ROHC_DECOMP_STAGE_MAX)
+	{
+		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "unknown decompression stage %d", stage);
+		goto error;
+	}
+
+	if(cycles == NULL)
+	{
+		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "location for CPU cycles is not valid");
+		goto error;
+	}
+
+#ifdef ROHC_STAGE_CYCLES
+	*cycles = decomp->stage_cycles.total[stage];
+	return true;
+#else
+	rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+	             "CPU cycles are not accounted: the library was built without "
+	             "the --enable-stage-cycles option");
+#endif
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Give a description for the given stage of the decompression
+ *
+ * The descriptions are not part of the API. They may change between
+ * releases without any warning. Do NOT use them for other means that
+ * providing to users a textual description of the decompression stages
+ * used by the library. If unsure, ask on the mailing list.
+ *
+ * @param stage  The decompression stage to get a description for
+ * @return       A string that describes the given decompression stage
+ *
+ * @ingroup rohc_decomp
+ */
+const char * rohc_decomp_get_stage_descr(const rohc_decomp_stage_t stage)
+{
+	switch(stage)
+	{
+		case ROHC_DECOMP_STAGE_PARSE:
+			return "parse header";
+		case ROHC_DECOMP_STAGE_DECODE:
+			return "decode fields";
+		case ROHC_DECOMP_STAGE_BUILD_HDR:
+			return "build headers";
+		case ROHC_DECOMP_STAGE_CRC:
+			return "check CRC";
+		case ROHC_DECOMP_STAGE_PAYLOAD:
+			return "copy payload";
+		case ROHC_DECOMP_STAGE_UPDATE_CTXT:
+			return "update context";
+		case ROHC_DECOMP_STAGE_MAX:
+		default:
+			return "no description";
+	}
+}
+
+
+/**
+ * @brief Get the memory used by the decompressor
+ *
+ * Get the number of bytes that the decompressor allocated for itself, for its
+ * contexts and for its Reconstructed Reception Unit. The released contexts
+ * kept for re-use (see \ref rohc_decomp_set_contexts_pool) are counted too.
+ *
+ * To use the function, call it with a pointer on a pre-allocated
+ * \ref rohc_memory_usage_t structure with the \e version_major and
+ * \e version_minor fields set to one of the following supported versions:
+ *  - Major 0, minor 0
+ *
+ * @param decomp       The ROHC decompressor to get memory usage from
+ * @param[in,out] mem  The structure where memory usage will be stored
+ * @return             true in case of success, false otherwise
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_memory_usage_t
+ */
+bool rohc_decomp_get_memory_usage(const struct rohc_decomp *const decomp,
+                                  rohc_memory_usage_t *const mem)
+{
+	size_t i;
+
+	if(decomp == NULL)
+	{
+		goto error;
+	}
+
+	if(mem == NULL)
+	{
+		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "structure for memory usage is not valid");
+		goto error;
+	}
+
+	/* check compatibility version */
+	if(mem->version_major != 0 || mem->version_minor != 0)
+	{
+		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "unsupported version (%u.%u) of the structure for memory "
+		           "usage", mem->version_major, mem->version_minor);
+		goto error;
+	}
+
+	/* the decompressor, its arrays of contexts and its per-packet buffers */
+	mem->instance_bytes = sizeof(struct rohc_decomp) +
+		2 * (decomp->medium.max_cid + 1) * sizeof(struct rohc_decomp_ctxt *) +
+		decomp->per_pkt_data_size;
+	if(decomp->latency != NULL)
+	{
+		mem->instance_bytes += sizeof(struct rohc_latency);
+	}
+	mem->instance_bytes += decomp->stream_max_len;
+	if(decomp->cold_ctxts != NULL)
+	{
+		mem->instance_bytes +=
+			(decomp->medium.max_cid + 1) * sizeof(struct rohc_decomp_cold_ctxt *);
+	}
+
+	/* the contexts of every profile */
+	mem->contexts_nr = 0;
+	mem->contexts_bytes = 0;
+	mem->wlsb_bytes = 0;
+	mem->lists_bytes = 0;
+	memset(mem->profiles_bytes, 0, sizeof(size_t) * ROHC_PROFILE_MAX);
+	for(i = 0; i < decomp->profiles_nr; i++)
+	{
+		const struct rohc_ctxt_mem *const ctxt_mem = &decomp->contexts_mem[i];
+		const rohc_profile_t profile_id = decomp->profiles[i]->id;
+
+		mem->contexts_nr += decomp->contexts_mem_nr[i];
+		mem->contexts_bytes += ctxt_mem->bytes;
+		mem->wlsb_bytes += ctxt_mem->wlsb_bytes;
+		mem->lists_bytes += ctxt_mem->lists_bytes;
+		assert(profile_id < ROHC_PROFILE_MAX);
+		mem->profiles_bytes[profile_id] += ctxt_mem->bytes;
+	}
+
+	/* the Reconstructed Reception Unit */
+	mem->rru_bytes = (decomp->rru != NULL ? decomp->mrru : 0);
+
+	mem->total_bytes = mem->instance_bytes + mem->contexts_bytes + mem->rru_bytes;
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get the CID type that the decompressor uses
+ *
+ * Get the CID type that the decompressor currently uses.
+ *
+ * @param decomp         The ROHC decompressor
+ * @param[out] cid_type  The current CID type among \ref ROHC_SMALL_CID and
+ *                       \ref ROHC_LARGE_CID
+ * @return               true if the CID type was successfully retrieved,
+ *                       false otherwise
+ *
+ * @ingroup rohc_decomp
+ */
+bool rohc_decomp_get_cid_type(const struct rohc_decomp *const decomp,
+                              rohc_cid_type_t *const cid_type)
+{
+	if(decomp == NULL || cid_type == NULL)
+	{
+		goto error;
+	}
+
+	*cid_type = decomp->medium.cid_type;
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get the maximal CID value the decompressor uses
+ *
+ * Get the maximal CID value the decompressor uses, ie. the \e MAX_CID
+ * parameter defined in RFC 3095.
+ *
+ * @param decomp        The ROHC decompressor
+ * @param[out] max_cid  The current maximal CID value
+ * @return              true if MAX_CID was successfully retrieved,
+ *                      false otherwise
+ *
+ * @ingroup rohc_decomp
+ */
+bool rohc_decomp_get_max_cid(const struct rohc_decomp *const decomp,
+                             size_t *const max_cid)
+{
+	if(decomp == NULL || max_cid == NULL)
+	{
+		goto error;
+	}
+
+	*max_cid = decomp->medium.max_cid;
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Set the Maximum Reconstructed Reception Unit (MRRU).
+ *
+ * Set the Maximum Reconstructed Reception Unit (MRRU).
+ *
+ * The MRRU is the largest cumulative length (in bytes) of the ROHC segments
+ * that are parts of the same ROHC packet. In short, the ROHC decompressor
+ * does not expect to reassemble ROHC segments whose total length is larger
+ * than MRRU. So, the ROHC compressor shall not segment ROHC packets greater
+ * than the MRRU.
+ *
+ * The MRRU value must be in range [0 ; \ref ROHC_MAX_MRRU]. Remember that the
+ * MRRU includes the 32-bit CRC that protects it.
+ * If set to 0, segmentation is disabled as no segment headers are allowed
+ * on the channel. Every received segment will be dropped.
+ *
+ * If segmentation is enabled and used by the compressor, the function
+ * \ref rohc_decompress3 will return ROHC_OK and one empty uncompressed packet
+ * upon decompression until the last segment is received (or a non-segment is
+ * received). Decompressed data will be returned at that time.
+ *
+ * The memory for the RRU is allocated with the MRRU size when segmentation
+ * is enabled, and freed when segmentation is disabled.
+ *
+ * @warning Changing the MRRU value while library is used may lead to
+ *          destruction of the current RRU.
+ *
+ * @param decomp  The ROHC decompressor
+ * @param mrru    The new MRRU value (in bytes)
+ * @return        true if the MRRU was successfully set, false otherwise
+ *
+ * @ingroup rohc_decomp
+ *
+ * \par Example:
+ * \snippet test_segment.c define ROHC decompressor
+ * \code
+        size_t mrru = 500;
+        ...
+\endcode
+ * \snippet test_segment.c create ROHC decompressor
+ * \code
+        ...
+\endcode
+ * \snippet test_segment.c set decompressor MRRU
+ * \code
+        ...
+\endcode
+ *
+ * @see rohc_decomp_get_mrru
+ * @see rohc_decompress3
+ * @see rohc_comp_set_mrru
+ * @see rohc_comp_get_mrru
+ */
+bool rohc_decomp_set_mrru(struct rohc_decomp *const decomp,
+                          const size_t mrru)
+{
+	/* decompressor must be valid */
+	if(decomp == NULL)
+	{
+		/* cannot print a trace without a valid decompressor */
+		goto error;
+	}
+
+	/* new MRRU value must be in range [0, ROHC_MAX_MRRU] */
+	if(mrru > ROHC_MAX_MRRU)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "unexpected MRRU value: must be in range [0, %d]",
+		             ROHC_MAX_MRRU);
+		goto error;
+	}
+
+	/* resize the RRU buffer to the new MRRU, keep the segments already
+	 * received if they fit in the new RRU */
+	if(mrru != decomp->mrru)
+	{
+		uint8_t *new_rru = NULL;
+
+		if(mrru > 0)
+		{
+			new_rru = malloc(mrru);
+			if(new_rru == NULL)
+			{
+				rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+				             "failed to allocate memory for the %zu-byte RRU",
+				             mrru);
+				goto error;
+			}
+		}
+		if(decomp->rru_len > mrru)
+		{
+			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			             "discard the %zu-byte RRU: too large for the new "
+			             "MRRU", decomp->rru_len);
+			rohc_decomp_rru_reset(decomp);
+		}
+		else if(decomp->rru_len > 0)
+		{
+			memcpy(new_rru, decomp->rru, decomp->rru_len);
+		}
+		zfree(decomp->rru);
+		decomp->rru = new_rru;
+	}
+
+	/* set new MRRU */
+	decomp->mrru = mrru;
+	rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+	           "MRRU is now set to %zd", decomp->mrru);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get the Maximum Reconstructed Reception Unit (MRRU).
+ *
+ * Get the current Maximum Reconstructed Reception Unit (MRRU).
+ *
+ * The MRRU is the largest cumulative length (in bytes) of the ROHC segments
+ * that are parts of the same ROHC packet. In short, the ROHC decompressor
+ * does not expect to reassemble ROHC segments whose total length is larger
+ * than MRRU. So, the ROHC compressor shall not segment ROHC packets greater
+ * than the MRRU.
+ *
+ * The MRRU value must be in range [0 ; \ref ROHC_MAX_MRRU]. Remember that the
+ * MRRU includes the 32-bit CRC that protects it.
+ * If MRRU value is 0, segmentation is disabled.
+ *
+ * If segmentation is enabled and used by the compressor, the function
+ * \ref rohc_decompress3 will return ROHC_OK and one empty uncompressed packet
+ * upon decompression until the last segment is received (or a non-segment is
+ * received). Decompressed data will be returned at that time.
+ *
+ * @param decomp     The ROHC decompressor
+ * @param[out] mrru  The current MRRU value (in bytes)
+ * @return           true if MRRU was successfully retrieved, false otherwise
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_set_mrru
+ * @see rohc_decompress3
+ * @see rohc_comp_set_mrru
+ * @see rohc_comp_get_mrru
+ */
+bool rohc_decomp_get_mrru(const struct rohc_decomp *const decomp,
+                          size_t *const mrru)
+{
+	if(decomp == NULL || mrru == NULL)
+	{
+		goto error;
+	}
+
+	*mrru = decomp->mrru;
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Set the number of packets sent during one Round-Trip Time (RTT).
+ *
+ * Set the maximum number of packets sent in worst case by the remote ROHC
+ * compressor for one given stream (ie. one compression/decompression context)
+ * during one Round-Trip Time (RTT).
+ *
+ * The number of packets sent by the remote ROHC compressor is used to estimate
+ * how many SN bits those feedbacks shall transmit to avoid any ambiguity at
+ * compressor about the ROHC packet that is (n)acknowledged by the decompressor.
+ *
+ * The pRTT value must be in range [0 ; SIZE_MAX/2[. If set to 0, all SN bits
+ * are always transmitted.
+ *
+ * The default value is 50 packets / RTT, ie. a RTT of 1 second with one packet
+ * transmitted every 20 milliseconds (classic VoIP stream). If your network
+ * streams and conditions differ, change the default value.
+ *
+ * @param decomp  The ROHC decompressor
+ * @param prtt    The number of packets sent during one RTT
+ * @return        true if the new value was successfully set, false otherwise
+ *
+ * @ingroup rohc_decomp
+ *
+ * \par Example:
+ * \snippet test_feedback2.c define ROHC decompressor
+ * \code
+        rohc_cid_type_t cid_type = ROHC_SMALL_CID;
+        rohc_cid_t max_cid = ROHC_SMALL_CID_MAX;
+        ...
+\endcode
+ * \snippet test_feedback2.c create ROHC decompressor
+ * \code
+        ...
+\endcode
+ * \snippet test_feedback2.c set decompressor pRTT
+ * \code
+        ...
+\endcode
+ *
+ * @see rohc_decomp_get_prtt
+ * @see rohc_decompress3
+ */
+bool rohc_decomp_set_prtt(struct rohc_decomp *const decomp,
+                          const size_t prtt)
+{
+	/* decompressor must be valid */
+	if(decomp == NULL)
+	{
+		/* cannot print a trace without a valid decompressor */
+		goto error;
+	}
+
+	/* new pRTT must be in range [0, SIZE_MAX] */
+	if(prtt >= (SIZE_MAX / 2))
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "unexpected pRTT value: must be in range [0, %zu]",
+		             SIZE_MAX);
+		goto error;
+	}
+
+	/* set new pRTT */
+	decomp->prtt = prtt;
+	rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+	           "pRTT is now set to %zu", decomp->prtt);
+
+	/* compute the minimum number of SN bits to transmit to the remote
+	 * compressor in the positive or negative feedbacks in order to avoid
+	 * any ambiguity at compressor about the ROHC packet that is
+	 * (n)acknowledged by the decompressor */
+	decomp->sn_feedback_min_bits = sizeof(uint32_t) * 8;
+	if(decomp->prtt != 0)
+	{
+		decomp->sn_feedback_min_bits -= __builtin_clz(decomp->prtt);
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get the number of packets sent during one Round-Trip Time (RTT).
+ *
+ * Get the maximum number of packets sent in worst case by the remote ROHC
+ * compressor for one given stream (ie. one compression/decompression context)
+ * during one Round-Trip Time (RTT).
+ *
+ * The number of packets sent by the remote ROHC compressor is used to estimate
+ * how many SN bits those feedbacks shall transmit to avoid any ambiguity at
+ * compressor about the ROHC packet that is (n)acknowledged by the decompressor.
+ *
+ * The pRTT value must be in range [0 ; SIZE_MAX/2[. If set to 0, all SN bits
+ * are always transmitted.
+ *
+ * The default value is 50 packets / RTT, ie. a RTT of 1 second with one packet
+ * transmitted every 20 milliseconds (classic VoIP stream). If your network
+ * streams and conditions differ, change the default value.
+ *
+ * @param decomp     The ROHC decompressor
+ * @param[out] prtt  The number of packets sent during one RTT
+ * @return           true if pRTT was successfully retrieved, false otherwise
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_set_prtt
+ * @see rohc_decompress3
+ */
+bool rohc_decomp_get_prtt(const struct rohc_decomp *const decomp,
+                          size_t *const prtt)
+{
+	if(decomp == NULL || prtt == NULL)
+	{
+		goto error;
+	}
+
+	*prtt = decomp->prtt;
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Set the rate limits for feedbacks
+ *
+ * Set the rate limits for positive feedbacks (ACK) and negative feedbacks (NACK
+ * and STATIC-NACK).
+ *
+ * There are 3 different rate limits:
+ *  \li the rate limit to avoid sending the same type of feedback too often:
+ *      it applies to all feedback types (ACK, NACK, STATIC-NACK) and it is
+ *      specified by the parameters \e k and \e n ;
+ *  \li the rate limit to avoid sending NACKs too quickly after a sporadic CRC
+ *      failure: it is specified by the parameters \e k_1 and \e n_1 ;
+ *  \li the rate limit to avoid sending STATIC-NACKs too quickly after a sporadic
+ *      CRC failure: it is specified by the parameters \e k_2 and \e n_2 ;
+ *
+ * In all 3 cases above, the \e k/k_1/k_2 and \e n/n_1/n_2 parameters define
+ * 3 ratios of packets:
+ *  \li a feedback is sent every \e k packets out of \e n packets that cause
+ *      the same feedback type to be sent ;
+ *  \li a NACK is not sent before \e k_1 packets out of \e n_1 packets failed
+ *      because of a CRC failure in the Full Context state ;
+ *  \li a STATIC-NACK is not sent before \e k_1 packets out of \e n_1 packets
+ *      failed because of a CRC failure in the Static Context state ;
+ *
+ * The default values are:
+ *  \li k   =  1 and n   = default pRTT (see rohc_decomp_set_prtt for details)
+ *  \li k_1 = 30 and n_1 = 100, ie. 30%
+ *  \li k_2 = 30 and n_2 = 100, ie. 30%
+ *
+ * If your network streams and conditions differ, change the default value.
+ *
+ * The n/n_1/n_2 values shall not be zero.
+ *
+ * @param decomp  The ROHC decompressor
+ * @param k       The k rate-limit parameter to avoid sending feedback too often
+ * @param n       The n rate-limit parameter to avoid sending feedback too often
+ * @param k_1     The k_1 rate-limit parameter to avoid sending NACKs too quickly
+ * @param n_1     The n_1 rate-limit parameter to avoid sending NACKs too quickly
+ * @param k_2     The k_2 rate-limit parameter to avoid sending STATIC-NACKs too quickly
+ * @param n_2     The n_2 rate-limit parameter to avoid sending STATIC-NACKs too quickly
+ * @return        true if the new values were successfully set, false otherwise
+ *
+ * @ingroup rohc_decomp
+ *
+ * \par Example:
+ * \snippet test_lost_packet.c define ROHC decompressor
+ * \code
+        ...
+\endcode
+ * \snippet test_lost_packet.c create ROHC decompressor
+ * \code
+        ...
+\endcode
+ * \snippet test_lost_packet.c set decompressor rate limits
+ * \code
+        ...
+\endcode
+ *
+ * @see rohc_decomp_get_rate_limits
+ * @see rohc_decomp_set_prtt
+ * @see rohc_decomp_get_prtt
+ * @see rohc_decompress3
+ */
+bool rohc_decomp_set_rate_limits(struct rohc_decomp *const decomp,
+                                 const size_t k, const size_t n,
+                                 const size_t k_1, const size_t n_1,
+                                 const size_t k_2, const size_t n_2)
+{
+	/* decompressor must be valid */
+	if(decomp == NULL)
+	{
+		/* cannot print a trace without a valid decompressor */
+		goto error;
+	}
+
+	/* n values are used as divisors */
+	if(n == 0 || n_1 == 0 || n_2 == 0)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "rate-limits n/n_1/n_2 shall not be 0");
+		goto error;
+	}
+
+	/* set new rate-limits */
+	decomp->ack_rate_limits.speed.k = k;
+	decomp->ack_rate_limits.speed.n = n;
+	decomp->ack_rate_limits.nack.k = k_1;
+	decomp->ack_rate_limits.nack.n = n_1;
+	decomp->ack_rate_limits.static_nack.k = k_2;
+	decomp->ack_rate_limits.static_nack.n = n_2;
+
+	/* compute the rate-limit thresholds */
+	decomp->ack_rate_limits.speed.threshold =
+		rohc_decomp_rate_limit_threshold(k, n);
+	decomp->ack_rate_limits.nack.threshold =
+		rohc_decomp_rate_limit_threshold(k_1, n_1);
+	decomp->ack_rate_limits.static_nack.threshold =
+		rohc_decomp_rate_limit_threshold(k_2, n_2);
+
+	rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+	           "rate-limits are now set to: %zu/%zu (all), %zu/%zu (NACK), "
+	           "%zu/%zu (STATIC-NACK)",
+	           decomp->ack_rate_limits.speed.k, decomp->ack_rate_limits.speed.n,
+	           decomp->ack_rate_limits.nack.k, decomp->ack_rate_limits.nack.n,
+	           decomp->ack_rate_limits.static_nack.k,
+	           decomp->ack_rate_limits.static_nack.n);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get the rate limits for feedbacks currently configured
+ *
+ * Get the rate limits for positive feedbacks (ACK) and negative feedbacks (NACK
+ * and STATIC-NACK).
+ *
+ * There are 3 different rate limits:
+ *  \li the rate limit to avoid sending the same type of feedback too often:
+ *      it applies to all feedback types (ACK, NACK, STATIC-NACK) and it is
+ *      specified by the parameters \e k and \e n ;
+ *  \li the rate limit to avoid sending NACKs too quickly after a sporadic CRC
+ *      failure: it is specified by the parameters \e k_1 and \e n_1 ;
+ *  \li the rate limit to avoid sending STATIC-NACKs too quickly after a sporadic
+ *      CRC failure: it is specified by the parameters \e k_2 and \e n_2 ;
+ *
+ * In all 3 cases above, the \e k/k_1/k_2 and \e n/n_1/n_2 parameters define
+ * 3 ratios of packets:
+ *  \li a feedback is sent every \e k packets out of \e n packets that cause
+ *      the same feedback type to be sent ;
+ *  \li a NACK is not sent before \e k_1 packets out of \e n_1 packets failed
+ *      because of a CRC failure in the Full Context state ;
+ *  \li a STATIC-NACK is not sent before \e k_1 packets out of \e n_1 packets
+ *      failed because of a CRC failure in the Static Context state ;
+ *
+ * The default values are:
+ *  \li k   =  1 and n   = default pRTT (see rohc_decomp_set_prtt for details)
+ *  \li k_1 = 30 and n_1 = 100, ie. 30%
+ *  \li k_2 = 30 and n_2 = 100, ie. 30%
+ *
+ * If your network streams and conditions differ, change the default value.
+ *
+ * @param decomp    The ROHC decompressor
+ * @param[out] k    The k rate-limit parameter to avoid sending feedback too often
+ * @param[out] n    The n rate-limit parameter to avoid sending feedback too often
+ * @param[out] k_1  The k_1 rate-limit param. to avoid sending NACKs too quickly
+ * @param[out] n_1  The n_1 rate-limit param. to avoid sending NACKs too quickly
+ * @param[out] k_2  The k_2 rate-limit param. to avoid sending STATIC-NACKs too quickly
+ * @param[out] n_2  The n_2 rate-limit param. to avoid sending STATIC-NACKs too quickly
+ * @return          true if rate-limits were successfully retrieved,
+ *                  false otherwise
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_set_rate_limits
+ * @see rohc_decomp_set_prtt
+ * @see rohc_decomp_get_prtt
+ * @see rohc_decompress3
+ */
+bool rohc_decomp_get_rate_limits(const struct rohc_decomp *const decomp,
+                                 size_t *const k, size_t *const n,
+                                 size_t *const k_1, size_t *const n_1,
+                                 size_t *const k_2, size_t *const n_2)
+{
+	if(decomp == NULL ||
+	   k == NULL || n == NULL ||
+	   k_1 == NULL || n_1 == NULL ||
+	   k_2 == NULL || n_2 == NULL)
+	{
+		goto error;
+	}
+
+	*k = decomp->ack_rate_limits.speed.k;
+	*n = decomp->ack_rate_limits.speed.n;
+	*k_1 = decomp->ack_rate_limits.nack.k;
+	*n_1 = decomp->ack_rate_limits.nack.n;
+	*n_2 = decomp->ack_rate_limits.static_nack.n;
+	*k_2 = decomp->ack_rate_limits.static_nack.k;
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Set the budgets of CRC repair attempts
+ *
+ * When the 
+ef ROHC_DECOMP_FEATURE_CRC_REPAIR feature is enabled, every CRC
+ * failure triggers a repair attempt that decodes the packet once more and
+ * computes its CRC once more. On lossy links, bursts of CRC failures thus
+ * multiply the decompression cost. The budgets limit the number of repair
+ * attempts during one time window:
+ *  \li \e ctxt_max repair attempts at most for every context ;
+ *  \li \e decomp_max repair attempts at most for all the contexts of the
+ *      decompressor.
+ *
+ * When one of the budgets is exhausted, the packets that fail the CRC check
+ * are handled as if the repair was not possible, and the skipped repair is
+ * counted in the \e skipped_crc_repairs statistics.
+ *
+ * The time windows are based on the arrival times of the ROHC packets given
+ * to 
+ef rohc_decompress3, so packets shall be given with their arrival
+ * times for the budgets to be renewed.
+ *
+ * The default values are:
+ *  \li ctxt_max = 0 and decomp_max = 0, ie. no limit ;
+ *  \li window = 1000 ms.
+ *
+ * @param decomp      The ROHC decompressor
+ * @param ctxt_max    The max number of repair attempts per context during
+ *                    one time window, 0 for no limit
+ * @param decomp_max  The max number of repair attempts for the decompressor
+ *                    during one time window, 0 for no limit
+ * @param window      The duration of the time window (in milliseconds),
+ *                    shall not be zero
+ * @return            true if the new values were successfully set,
+ *                    false otherwise
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_get_crc_repair_budget
+ * @see rohc_decomp_set_features
+ */
+bool rohc_decomp_set_crc_repair_budget(struct rohc_decomp *const decomp,
+                                       const size_t ctxt_max,
+                                       const size_t decomp_max,
+                                       const size_t window)
+{
+	/* decompressor must be valid */
+	if(decomp == NULL)
+	{
+		/* cannot print a trace without a valid decompressor */
+		goto error;
+	}
+
+	/* time window shall not be empty nor overflow once in microseconds */
+	if(window == 0 || window > (SIZE_MAX / 1000U))
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "unexpected time window for CRC repair budgets: must be "
+		             "in range [1, %zu] ms", SIZE_MAX / 1000U);
+		goto error;
+	}
+
+	/* set new budgets */
+	decomp->crc_repair_ctxt_max = ctxt_max;
+	decomp->crc_repair_decomp_max = decomp_max;
+	decomp->crc_repair_window = window;
+
+	rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+	           "CRC repair budgets are now set to %zu attempts per context and "
+	           "%zu attempts per decompressor every %zu ms", ctxt_max,
+	           decomp_max, window);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get the budgets of CRC repair attempts currently configured
+ *
+ * See 
+ef rohc_decomp_set_crc_repair_budget for details.
+ *
+ * @param decomp           The ROHC decompressor
+ * @param[out] ctxt_max    The max number of repair attempts per context
+ *                         during one time window, 0 for no limit
+ * @param[out] decomp_max  The max number of repair attempts for the
+ *                         decompressor during one time window, 0 for no limit
+ * @param[out] window      The duration of the time window (in milliseconds)
+ * @return                 true if the budgets were successfully retrieved,
+ *                         false otherwise
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_set_crc_repair_budget
+ */
+bool rohc_decomp_get_crc_repair_budget(const struct rohc_decomp *const decomp,
+                                       size_t *const ctxt_max,
+                                       size_t *const decomp_max,
+                                       size_t *const window)
+{
+	if(decomp == NULL || ctxt_max == NULL || decomp_max == NULL || window == NULL)
+	{
+		goto error;
+	}
+
+	*ctxt_max = decomp->crc_repair_ctxt_max;
+	*decomp_max = decomp->crc_repair_decomp_max;
+	*window = decomp->crc_repair_window;
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Set the reorder window of the contexts
+ *
+ * The SN of one packet that comes late on a link that reorders packets is
+ * often misinterpreted, the CRC then fails and the packet is decoded once
+ * more with the previous references of the context (ref -1) if the
+ * \ref ROHC_DECOMP_FEATURE_CRC_REPAIR feature is enabled. The repaired
+ * packet and the next one are then thrown away until the repair is
+ * confirmed.
+ *
+ * With a reorder window, one packet of the IP-only, UDP, UDP-Lite, RTP or
+ * ESP profiles whose SN decoded with ref -1 falls between ref -1 and ref 0,
+ * at most \e window SN values before ref 0, is deemed to come late: all its
+ * fields are decoded with ref -1 up front. If the CRC disagrees, the packet
+ * is decoded once more with ref 0 as usual, before any CRC repair.
+ *
+ * The default value is 0, ie. no reorder window.
+ *
+ * @param decomp  The ROHC decompressor
+ * @param window  The max number of SN values one packet may come late, in
+ *                range [0, 64], 0 to disable the reorder window
+ * @return        true if the new value was successfully set,
+ *                false otherwise
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_get_reorder_window
+ * @see rohc_decomp_set_features
+ */
+bool rohc_decomp_set_reorder_window(struct rohc_decomp *const decomp,
+                                    const size_t window)
+{
+	/* decompressor must be valid */
+	if(decomp == NULL)
+	{
+		/* cannot print a trace without a valid decompressor */
+		goto error;
+	}
+
+	if(window > ROHC_DECOMP_MAX_REORDER_WINDOW)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "unexpected reorder window %zu: must be in range [0, %u]",
+		             window, ROHC_DECOMP_MAX_REORDER_WINDOW);
+		goto error;
+	}
+
+	decomp->reorder_window = window;
+
+	rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+	           "reorder window is now set to %zu SN values", window);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get the reorder window of the contexts currently configured
+ *
+ * See \ref rohc_decomp_set_reorder_window for details.
+ *
+ * @param decomp       The ROHC decompressor
+ * @param[out] window  The max number of SN values one packet may come late,
+ *                     0 if there is no reorder window
+ * @return             true if the reorder window was successfully retrieved,
+ *                     false otherwise
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_set_reorder_window
+ */
+bool rohc_decomp_get_reorder_window(const struct rohc_decomp *const decomp,
+                                    size_t *const window)
+{
+	if(decomp == NULL || window == NULL)
+	{
+		goto error;
+	}
+
+	*window = decomp->reorder_window;
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Set the max number of released contexts kept for re-use
+ *
+ * Every time a stream ends or is replaced by another one on the same CID,
+ * its decompression context is released. The released contexts may be kept
+ * in one pool instead of being destroyed, so that the next contexts for the
+ * same profile re-use their memory instead of allocating it once more. This
+ * avoids the cost of memory allocations on links where streams are created
+ * at high rates.
+ *
+ * The pool is filled on demand with the released contexts, and it never
+ * holds more than \e contexts_nr contexts. Only the profiles that are able to
+ * reset their contexts (Uncompressed and TCP at the moment) put them in the
+ * pool, the contexts of the other profiles are always destroyed.
+ *
+ * The default value is 0, ie. no pool.
+ *
+ * @param decomp       The ROHC decompressor
+ * @param contexts_nr  The max number of released contexts kept for re-use,
+ *                     in range [0, MAX_CID + 1], 0 to disable the pool
+ * @return             true if the new value was successfully set,
+ *                     false otherwise
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_get_contexts_pool
+ */
+bool rohc_decomp_set_contexts_pool(struct rohc_decomp *const decomp,
+                                   const size_t contexts_nr)
+{
+	/* decompressor must be valid */
+	if(decomp == NULL)
+	{
+		/* cannot print a trace without a valid decompressor */
+		goto error;
+	}
+
+	/* the pool shall not be larger than the array of contexts */
+	if(contexts_nr > (decomp->medium.max_cid + 1))
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "unexpected size for the pool of contexts: must be in "
+		             "range [0, %zu]", decomp->medium.max_cid + 1);
+		goto error;
+	}
+
+	/* set the new size, destroy the released contexts in excess */
+	decomp->contexts_pool_max = contexts_nr;
+	rohc_decomp_shrink_contexts_pool(decomp, contexts_nr);
+
+	rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+	           "up to %zu released contexts are now kept for re-use",
+	           contexts_nr);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get the max number of released contexts kept for re-use
+ *
+ * See \ref rohc_decomp_set_contexts_pool for details.
+ *
+ * @param decomp            The ROHC decompressor
+ * @param[out] contexts_nr  The max number of released contexts kept for
+ *                          re-use, 0 if the pool is disabled
+ * @return                  true if the value was successfully retrieved,
+ *                          false otherwise
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_set_contexts_pool
+ */
+bool rohc_decomp_get_contexts_pool(const struct rohc_decomp *const decomp,
+                                   size_t *const contexts_nr)
+{
+	if(decomp == NULL || contexts_nr == NULL)
+	{
+		goto error;
+	}
+
+	*contexts_nr = decomp->contexts_pool_max;
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Prepare contexts of one profile before the traffic
+ *
+ * Create the given number of decompression contexts for the given profile
+ * and keep them in the pool of released contexts (see
+ * \ref rohc_decomp_set_contexts_pool), so that the IR packets received when
+ * many streams start at once (after a link comes up for example) only fill
+ * the contexts instead of allocating them. The pool is enlarged if needed.
+ *
+ * The contexts are not bound to any CID: the next new streams of the profile
+ * take them whatever their CIDs. Only the profiles that are able to reset
+ * their contexts (Uncompressed and TCP at the moment) support the
+ * preparation of contexts.
+ *
+ * @param decomp       The ROHC decompressor
+ * @param profile      The profile of the contexts, it shall be enabled
+ * @param contexts_nr  The number of contexts to prepare, the pool shall not
+ *                     hold more than MAX_CID + 1 contexts
+ * @return             true if the contexts were prepared,
+ *                     false if the profile is not enabled, if it does not
+ *                     support the preparation of its contexts, if the number
+ *                     is invalid or if memory ran out
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_set_contexts_pool
+ */
+bool rohc_decomp_prewarm_contexts(struct rohc_decomp *const decomp,
+                                  const rohc_profile_t profile,
+                                  const size_t contexts_nr)
+{
+	const struct rohc_decomp_profile *decomp_profile;
+	size_t profile_idx;
+	size_t i;
+
+	if(decomp == NULL)
+	{
+		goto error;
+	}
+	if(contexts_nr > (decomp->medium.max_cid + 1 - decomp->contexts_pool_nr))
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "failed to prepare %zu contexts: the pool of contexts "
+		             "cannot hold more than %zu contexts", contexts_nr,
+		             decomp->medium.max_cid + 1);
+		goto error;
+	}
+	decomp_profile = find_profile(decomp, profile);
+	if(decomp_profile == NULL || decomp_profile->reset_context == NULL)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "failed to prepare contexts: profile 0x%04x is not "
+		             "enabled or does not support it", profile);
+		goto error;
+	}
+	profile_idx = rohc_decomp_get_profile_index(decomp, decomp_profile);
+
+	/* make room in the pool */
+	decomp->contexts_pool_max =
+		rohc_max(decomp->contexts_pool_max, decomp->contexts_pool_nr + contexts_nr);
+
+	for(i = 0; i < contexts_nr; i++)
+	{
+		struct rohc_decomp_ctxt *const context =
+			rohc_alloc_malloc_node(sizeof(struct rohc_decomp_ctxt),
+			                       decomp->numa_node);
+
+		if(context == NULL)
+		{
+			goto error_mem;
+		}
+		context->cid = 0;
+		context->decompressor = decomp;
+		context->profile = decomp_profile;
+		if(!decomp_profile->new_context(context, &context->persist_ctxt,
+		                                &context->volat_ctxt))
+		{
+			free(context);
+			goto error_mem;
+		}
+		rohc_decomp_ctxt_mem_add(decomp, context, profile_idx);
 
-			/* CRC for IR and IR-DYN packets checked before, so cannot fail here */
-			assert((*packet_type) != ROHC_PACKET_IR);
-			assert((*packet_type) != ROHC_PACKET_IR_DYN);
+		context->pool_next = decomp->contexts_pool[profile_idx];
+		decomp->contexts_pool[profile_idx] = context;
+		decomp->contexts_pool_nr++;
+	}
 
-			rohc_decomp_warn(context, "CID %zu: failed to build uncompressed "
-			                 "headers (CRC failure)", context->cid);
+	rohc_info(decomp, ROHC_TRACE_DECOMP, profile, "%zu contexts prepared",
+	          contexts_nr);
 
-			/* attempt a context/packet repair */
-			try_decoding_again =
-				profile->attempt_repair(decomp, context, rohc_packet.time,
-				                        &context->crc_corr, extr_bits);
+	return true;
+
+error_mem:
+	rohc_warning(decomp, ROHC_TRACE_DECOMP, profile, "failed to prepare %zu "
+	             "contexts: only %zu contexts were prepared", contexts_nr, i);
+error:
+	return false;
+}
+
+
+/**
+ * @brief Set the time after which unused contexts are released
+ *
+ * By default, a decompression context is kept until the compressor re-uses
+ * its CID for another stream. With an idle timeout, a context that did not
+ * decompress any packet for \e idle_timeout seconds is released, so that
+ * its memory is available again (or kept in the pool of contexts, see
+ * \ref rohc_decomp_set_contexts_pool). The next packets for its CID are
+ * handled as if the context never existed.
+ *
+ * The contexts are kept ordered from the most to the least recently used
+ * one, so releasing the idle contexts costs nothing more than one check of
+ * the least recently used context per decompressed packet. The idle timeout
+ * relies on the arrival times of the packets given to
+ * \ref rohc_decompress3, so contexts are never released if the arrival
+ * times are unknown (set to 0).
+ *
+ * If the \ref ROHC_DECOMP_FEATURE_COLD_CTXTS feature is enabled, the idle
+ * contexts are moved to a cold store instead: they are saved in the compact
+ * format of snapshots (see \ref rohc_decomp_snapshot) before they are
+ * released. When the compressor uses the CID of one cold context again, the
+ * context is revived from the cold store by the first packet that is not an
+ * IR packet, so the flow goes on as if the context was never released. An
+ * IR packet creates a new context as usual, the cold context is dropped.
+ * The compressor may then revive its own cold contexts without IR packets
+ * (see \ref ROHC_COMP_FEATURE_COLD_CTXTS). Only the contexts of the profiles
+ * that support snapshots are moved to the cold store.
+ *
+ * The idle timeout is 0 by default, ie. the contexts are never released
+ * because of inactivity. It may be changed at any time.
+ *
+ * @param decomp        The ROHC decompressor
+ * @param idle_timeout  The time (in seconds) after which an unused context
+ *                      is released, 0 to disable
+ * @return              true if the new value was successfully set,
+ *                      false otherwise
+ *
+ * @ingroup rohc_decomp
+ */
+bool rohc_decomp_set_ctxt_idle_timeout(struct rohc_decomp *const decomp,
+                                       const size_t idle_timeout)
+{
+	if(decomp == NULL)
+	{
+		goto error;
+	}
+
+	decomp->ctxt_idle_timeout = idle_timeout;
+
+	rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+	           "idle timeout for contexts set to %zu seconds", idle_timeout);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Set the coarse clock that gives the arrival time of the packets
+ *
+ * The time-related features of the decompressor (the detection of SN
+ * wraparounds for CRC repairs, the idle timeout of the contexts...) rely on
+ * the arrival times of the ROHC packets. Reading the system clock for every
+ * packet is expensive: with a coarse clock, the ROHC packets may be given
+ * with an unknown arrival time (set to 0) and the decompressor reads the
+ * time from the given clock instead. The clock is typically updated by the
+ * event loop of the application, once per iteration.
+ *
+ * With 
+ef rohc_decompress_batch, the clock is read once for the whole
+ * burst. If the first packet of the burst is given with a known arrival
+ * time, the packets of the burst with an unknown arrival time share that
+ * time, so that the time may be set once per burst even without any coarse
+ * clock.
+ *
+ * The packets given with a known arrival time keep their time. There is no
+ * coarse clock by default. The clock may be changed at any time.
+ *
+ * @warning The clock shall not be updated while a packet is decompressed,
+ *          and it shall remain valid until it is replaced or the
+ *          decompressor is freed
+ *
+ * @param decomp  The ROHC decompressor
+ * @param clock   The coarse clock, NULL to remove it
+ * @return        true if the clock was successfully set,
+ *                false otherwise
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decompress3
+ * @see rohc_decompress_batch
+ */
+bool rohc_decomp_set_clock(struct rohc_decomp *const decomp,
+                           const struct rohc_ts *const clock)
+{
+	if(decomp == NULL)
+	{
+		goto error;
+	}
+
+	decomp->clock = clock;
+
+	rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+	           "coarse clock %s", (clock != NULL ? "set" : "removed"));
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Enable/disable features for ROHC decompressor
+ *
+ * Enable/disable features for ROHC decompressor. Features control whether
+ * mechanisms defined as optional by RFCs are enabled or not.
+ *
+ * Available features are listed by \ref rohc_decomp_features_t. They may be
+ * combined by XOR'ing them together.
+ *
+ * @warning Changing the feature set while library is used is not supported
+ *
+ * @param decomp    The ROHC decompressor
+ * @param features  The feature set to enable/disable
+ * @return          true if the feature set was successfully enabled/disabled,
+ *                  false if a problem occurred
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_features_t
+ */
+bool rohc_decomp_set_features(struct rohc_decomp *const decomp,
+                              const rohc_decomp_features_t features)
+{
+	const rohc_decomp_features_t all_features =
+		ROHC_DECOMP_FEATURE_CRC_REPAIR |
+		ROHC_DECOMP_FEATURE_DUMP_PACKETS |
+		ROHC_DECOMP_FEATURE_DEFERRED_FEEDBACK |
+		ROHC_DECOMP_FEATURE_LATENCY |
+		ROHC_DECOMP_FEATURE_COLD_CTXTS |
+		ROHC_DECOMP_FEATURE_GROUP_BY_CID |
+		ROHC_DECOMP_FEATURE_NO_ALLOC;
+
+	/* decompressor must be valid */
+	if(decomp == NULL)
+	{
+		/* cannot print a trace without a valid decompressor */
+		goto error;
+	}
+
+	/* reject unsupported features */
+	if((features & all_features) != features)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "feature set 0x%x is not supported (supported features "
+		             "set is 0x%x)", features, all_features);
+		goto error;
+	}
 
-			/* report CRC failure if attempt is not possible */
-			if(!try_decoding_again)
-			{
-				/* uncompressed headers successfully built, CRC is incorrect, repair
-				 * was disabled or attempted without any success, so give up */
-				rohc_decomp_warn(context, "CID %zu: failed to build uncompressed "
-				                 "headers (CRC failure)", context->cid);
-				if((decomp->features & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0)
-				{
-					rohc_dump_packet(decomp->trace_callback, decomp->trace_callback_priv,
-					                 ROHC_TRACE_DECOMP, ROHC_TRACE_WARNING,
-					                 "compressed headers", rohc_packet);
-				}
-				goto error_crc;
-			}
-		}
+	/* the cold store allocates memory for every context it saves */
+	if((features & ROHC_DECOMP_FEATURE_NO_ALLOC) != 0 &&
+	   (features & ROHC_DECOMP_FEATURE_COLD_CTXTS) != 0)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "features NO_ALLOC and COLD_CTXTS cannot be enabled "
+		             "together");
+		goto error;
 	}
-	while(try_decoding_again);
 
-	/* after CRC failure, if the SN value seems to be correctly guessed, we must
-	 * wait for 3 CRC-valid packets before the correction is approved. Two
-	 * packets are therefore thrown away. */
-	if(context->crc_corr.algo != ROHC_DECOMP_CRC_CORR_SN_NONE)
+	/* allocate the histograms of the processing time the first time they are
+	 * required, they are kept if the feature is disabled later */
+	if((features & ROHC_DECOMP_FEATURE_LATENCY) != 0 && decomp->latency == NULL)
 	{
-		if(context->crc_corr.counter > 1)
+		decomp->latency = calloc(1, sizeof(struct rohc_latency));
+		if(decomp->latency == NULL)
 		{
-			/* update context with decoded values even if we drop the packet */
-			rohc_decomp_update_context(context, decoded_values, payload_len,
-			                           rohc_packet.time, do_change_mode);
+			rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			           "failed to allocate memory for the histograms of the "
+			           "processing time");
+			goto error;
+		}
+	}
 
-			context->crc_corr.counter--;
-			rohc_decomp_warn(context, "CID %zu: CRC repair: throw away packet, "
-			                 "still %zu CRC-valid packets required",
-			                 context->cid, context->crc_corr.counter);
+	/* allocate the cold store the first time it is required, it is kept if
+	 * the feature is disabled later so that its contexts may be revived;
+	 * the idle contexts are saved in the buffer for journal records */
+	if((features & ROHC_DECOMP_FEATURE_COLD_CTXTS) != 0 &&
+	   decomp->cold_ctxts == NULL)
+	{
+		const size_t journal_max_len = 1024U;
 
-			goto error_crc;
-		}
-		else if(context->crc_corr.counter == 1)
+		if(decomp->journal_buf == NULL)
 		{
-			rohc_decomp_warn(context, "CID %zu: CRC repair: correction is "
-			                 "successful, keep packet", context->cid);
-			context->corrected_crc_failures++;
-			decomp->stats.corrected_crc_failures++;
-			switch(context->crc_corr.algo)
+			decomp->journal_buf = malloc(journal_max_len);
+			if(decomp->journal_buf == NULL)
 			{
-				case ROHC_DECOMP_CRC_CORR_SN_WRAP:
-					context->corrected_sn_wraparounds++;
-					decomp->stats.corrected_sn_wraparounds++;
-					break;
-				case ROHC_DECOMP_CRC_CORR_SN_UPDATES:
-					context->corrected_wrong_sn_updates++;
-					decomp->stats.corrected_wrong_sn_updates++;
-					break;
-				case ROHC_DECOMP_CRC_CORR_SN_NONE:
-				default:
-					rohc_error(decomp, ROHC_TRACE_DECOMP, context->profile->id,
-					           "CID %zu: CRC repair: unsupported repair algorithm %d",
-					           context->cid, context->crc_corr.algo);
-					assert(0);
-					goto error;
+				rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+				           "failed to allocate memory for the cold store");
+				goto error;
 			}
-			context->crc_corr.algo = ROHC_DECOMP_CRC_CORR_SN_NONE;
-			context->crc_corr.counter--;
+			decomp->journal_max_len = journal_max_len;
+		}
+		decomp->cold_ctxts =
+			rohc_alloc_calloc_node(decomp->medium.max_cid + 1,
+			                       sizeof(struct rohc_decomp_cold_ctxt *),
+			                       decomp->numa_node);
+		if(decomp->cold_ctxts == NULL)
+		{
+			rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			           "failed to allocate memory for the cold store");
+			goto error;
 		}
 	}
 
+	/* record new feature set */
+	decomp->features = features;
 
-	/* E. Copy the payload (if any) */
+	return true;
 
-	if((rohc_hdr_len + payload_len) != rohc_packet.len)
+error:
+	return false;
+}
+
+
+/**
+ * @brief Record the workload of the decompressor
+ *
+ * Once the recorder is set, the decompressor gives every ROHC packet it
+ * receives to the callback, with its arrival time. The recording starts
+ * with the configuration of the decompressor at the time of the call, so
+ * the recorder shall be set once the decompressor is configured. The
+ * recording may then be replayed against any build of the library with the
+ * rohc_replay tool, to reproduce a performance problem for example.
+ *
+ * The packets may be truncated to their first bytes, for example to record
+ * the ROHC headers only: the replay fills the missing bytes with zeroes.
+ *
+ * The packets are recorded in the order they are decompressed, so the
+ * packets of one batch are recorded in the order of the CIDs if
+ * \ref ROHC_DECOMP_FEATURE_GROUP_BY_CID is enabled; the replay decompresses
+ * all of them with \ref rohc_decompress3.
+ *
+ * @param decomp    The ROHC decompressor
+ * @param write_cb  The callback that writes the recording,
+ *                  NULL to stop recording
+ * @param priv      The private context of the callback
+ * @param max_len   The maximum number of bytes recorded per packet,
+ *                  0 to record the whole packets
+ * @return          true if the recording started or stopped,
+ *                  false if the decompressor is invalid, or if the
+ *                  configuration could not be written
+ *
+ * @ingroup rohc_decomp
+ */
+bool rohc_decomp_set_recorder(struct rohc_decomp *const decomp,
+                              const rohc_record_write_t write_cb,
+                              void *const priv,
+                              const size_t max_len)
+{
+	struct rohc_record_hdr hdr;
+	size_t i;
+
+	if(decomp == NULL)
 	{
-		rohc_decomp_warn(context, "ROHC %s header (%zu bytes) and payload "
-		                 "(%zu bytes) do not match the full ROHC packet "
-		                 "(%zu bytes)", rohc_get_packet_descr(*packet_type),
-		                 rohc_hdr_len, payload_len, rohc_packet.len);
 		goto error;
 	}
-	if(rohc_buf_avail_len(*uncomp_packet) < payload_len)
-	{
-		rohc_decomp_warn(context, "uncompressed packet too small (%zu bytes "
-		                 "max) for the %zu-byte payload",
-		                 rohc_buf_avail_len(*uncomp_packet), payload_len);
-		goto error_output_too_small;
-	}
-	if(payload_len != 0)
+
+	/* stop the recording in progress if any */
+	decomp->recorder.write_cb = NULL;
+	if(write_cb == NULL)
 	{
-		rohc_buf_append(uncomp_packet, payload_data, payload_len);
-		rohc_buf_pull(uncomp_packet, payload_len);
+		rohc_info(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		          "recording stopped");
+		goto stopped;
 	}
-	/* unhide the uncompressed headers and payload */
-	rohc_buf_push(uncomp_packet, uncomp_hdr_len + payload_len);
-	rohc_decomp_debug(context, "uncompressed packet length = %zu bytes",
-	                  uncomp_packet->len);
-
 
-	/* F. Update the compression context
-	 *
-	 * Once CRC check is done, update the compression context with the values
-	 * that were decoded earlier.
-	 *
-	 * TODO: check what fields shall be updated in the context
-	 */
+	/* start with the configuration of the decompressor */
+	memset(&hdr, 0, sizeof(struct rohc_record_hdr));
+	hdr.magic = ROHC_RECORD_MAGIC;
+	hdr.version = ROHC_RECORD_VERSION;
+	hdr.entity = ROHC_RECORD_DECOMP;
+	hdr.cid_type = decomp->medium.cid_type;
+	hdr.max_cid = decomp->medium.max_cid;
+	hdr.param = decomp->target_mode;
+	hdr.features = decomp->features;
+	hdr.mrru = decomp->mrru;
+	for(i = 0; i < decomp->profiles_nr; i++)
+	{
+		const rohc_profile_t id = decomp->profiles[i]->id;
+		size_t j;
 
-	/* we are either already in full context state or we can transit
-	 * through it */
-	if(context->state != ROHC_DECOMP_STATE_FC)
+		if(!decomp->enabled_profiles[i])
+		{
+			continue;
+		}
+		for(j = 0; j < hdr.profiles_nr && hdr.profiles[j] != id; j++)
+		{
+		}
+		if(j == hdr.profiles_nr && hdr.profiles_nr < ROHC_RECORD_PROFILES_MAX)
+		{
+			hdr.profiles[hdr.profiles_nr] = id;
+			hdr.profiles_nr++;
+		}
+	}
+	if(!write_cb(priv, (const uint8_t *) &hdr, sizeof(struct rohc_record_hdr)))
 	{
-		rohc_decomp_debug(context, "change from state %d to state %d",
-		                  context->state, ROHC_DECOMP_STATE_FC);
-		context->state = ROHC_DECOMP_STATE_FC;
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "failed to write the configuration of the decompressor, "
+		             "recording not started");
+		goto error;
 	}
 
-	/* update context with decoded values */
-	rohc_decomp_update_context(context, decoded_values, payload_len,
-	                           rohc_packet.time, do_change_mode);
+	decomp->recorder.write_cb = write_cb;
+	decomp->recorder.priv = priv;
+	decomp->recorder.max_len = max_len;
 
-	/* update statistics */
-	rohc_decomp_stats_add_success(context, rohc_hdr_len, uncomp_hdr_len);
+	rohc_info(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+	          "recording started");
 
-	/* decompression is successful */
-	return ROHC_STATUS_OK;
+stopped:
+	return true;
 
 error:
-	return ROHC_STATUS_ERROR;
-error_output_too_small:
-	return ROHC_STATUS_OUTPUT_TOO_SMALL;
-error_crc:
-	return ROHC_STATUS_BAD_CRC;
-error_malformed:
-	return ROHC_STATUS_MALFORMED;
+	return false;
 }
 
 
 /**
- * @brief Check whether the CRC on IR or IR-DYN header is correct or not
+ * @brief Is the given decompression profile enabled for a decompressor?
  *
- * The CRC for IR/IR-DYN headers is always CRC-8. It is computed on the
- * whole compressed header (payload excluded, but any CID bits included).
+ * Is the given decompression profile enabled or disabled for a decompressor?
  *
- * @param decomp          The ROHC decompressor
- * @param context         The decompression context
- * @param rohc_hdr        The compressed IR or IR-DYN header
- * @param rohc_hdr_len    The length (in bytes) of the compressed header
- * @param add_cid_len     The length of the optional Add-CID field
- * @param large_cid_len   The length of the optional large CID field
- * @param crc_packet      The CRC extracted from the ROHC header
- * @return                true if the CRC is correct, false otherwise
+ * @param decomp   The ROHC decompressor
+ * @param profile  The profile to ask status for
+ * @return         Possible return values:
+ *                  \li true if the profile exists and is enabled,
+ *                  \li false if the decompressor is not valid, the profile
+ *                      does not exist, or the profile is disabled
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_enable_profile
+ * @see rohc_decomp_enable_profiles
+ * @see rohc_decomp_disable_profile
+ * @see rohc_decomp_disable_profiles
  */
-static bool rohc_decomp_check_ir_crc(const struct rohc_decomp *const decomp,
-                                     const struct rohc_decomp_ctxt *const context,
-                                     const uint8_t *const rohc_hdr,
-                                     const size_t rohc_hdr_len,
-                                     const size_t add_cid_len,
-                                     const size_t large_cid_len,
-                                     const uint8_t crc_packet)
+bool rohc_decomp_profile_enabled(const struct rohc_decomp *const decomp,
+                                 const rohc_profile_t profile)
 {
-	const size_t rohc_hdr_full_len = add_cid_len + large_cid_len + rohc_hdr_len;
-	const uint8_t *crc_table;
-	const rohc_crc_type_t crc_type = ROHC_CRC_TYPE_8;
-	const uint8_t crc_zero[] = { 0x00 };
-	unsigned int crc_comp; /* computed CRC */
-
-	assert(decomp != NULL);
-	assert(rohc_hdr != NULL);
-	assert(rohc_hdr_len >= (add_cid_len + 2 + large_cid_len + 1));
-
-	crc_table = decomp->crc_table_8;
+	bool is_found = false;
+	size_t i;
 
-	/* ROHC header before CRC field:
-	 * optional Add-CID + IR type + Profile ID + optional large CID */
-	crc_comp = crc_calculate(crc_type, rohc_hdr,
-	                         add_cid_len + 2 + large_cid_len,
-	                         CRC_INIT_8, crc_table);
+	if(decomp == NULL)
+	{
+		goto error;
+	}
 
-	/* all profiles but the Uncompressed profile compute their CRC through the
-	 * zeroed CRC field and the rest of the ROHC header */
-	if(context->profile->id != ROHC_PROFILE_UNCOMPRESSED)
+	/* the profile is enabled if one of the profiles with its ID is */
+	for(i = 0; i < decomp->profiles_nr; i++)
 	{
-		/* zeroed CRC field */
-		crc_comp = crc_calculate(crc_type, crc_zero, 1, crc_comp, crc_table);
+		if(decomp->profiles[i]->id == profile)
+		{
+			if(decomp->enabled_profiles[i])
+			{
+				return true;
+			}
+			is_found = true;
+		}
+	}
 
-		/* ROHC header after CRC field */
-		crc_comp = crc_calculate(crc_type,
-		                         rohc_hdr + add_cid_len + 2 + large_cid_len + 1,
-		                         rohc_hdr_len - add_cid_len - 2 - large_cid_len - 1,
-		                         crc_comp, crc_table);
+	if(!is_found)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "unknown ROHC decompression profile (ID = %d)", profile);
 	}
 
-	rohc_decomp_debug(context, "CRC-%d on compressed %zu-byte ROHC header = "
-	                  "0x%x", crc_type, rohc_hdr_full_len, crc_comp);
+error:
+	return false;
+}
 
-	/* does the computed CRC match the one in packet? */
-	if(crc_comp != crc_packet)
+
+/**
+ * @brief Enable a decompression profile for a decompressor
+ *
+ * Enable a decompression profiles for a decompressor.
+ *
+ * The ROHC decompressor does not use the decompression profiles that are not
+ * enabled. Thus not enabling a profile might cause the decompressor to reject
+ * streams. Decompression will always fail if no profile at all is enabled.
+ *
+ * If the profile is already enabled, nothing is performed and success is
+ * reported.
+ *
+ * @param decomp   The ROHC decompressor
+ * @param profile  The profile to enable
+ * @return         true if the profile exists,
+ *                 false if the profile does not exist
+ *
+ * @ingroup rohc_decomp
+ *
+ * \par Example:
+ * \snippet example_rohc_decomp.c define ROHC decompressor
+ * \code
+        ...
+\endcode
+ * \snippet example_rohc_decomp.c enable ROHC decompression profile
+ * \code
+        ...
+\endcode
+ *
+ * @see rohc_decomp_enable_profiles
+ * @see rohc_decomp_disable_profile
+ * @see rohc_decomp_disable_profiles
+ */
+bool rohc_decomp_enable_profile(struct rohc_decomp *const decomp,
+                                const rohc_profile_t profile)
+{
+	bool is_found = false;
+	size_t i;
+
+	if(decomp == NULL)
+	{
+		goto error;
+	}
+
+	/* mark all the profiles with the ID as enabled, the built-in one and the
+	 * registered ones */
+	for(i = 0; i < decomp->profiles_nr; i++)
+	{
+		if(decomp->profiles[i]->id == profile)
+		{
+			decomp->enabled_profiles[i] = true;
+			is_found = true;
+		}
+	}
+
+	if(!is_found)
 	{
-		rohc_decomp_warn(context, "CRC failure (computed = 0x%02x, packet = "
-		                 "0x%02x)", crc_comp, crc_packet);
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "unknown ROHC decompression profile (ID = %d)", profile);
 		goto error;
 	}
+	rohc_info(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+	          "ROHC decompression profile (ID = %d) enabled", profile);
 
-	/* computed CRC matches the one in packet */
 	return true;
 
 error:
@@ -1732,251 +6434,186 @@ error:
 
 
 /**
- * @brief Update context with decoded values
+ * @brief Disable a decompression profile for a decompressor
  *
- * @param context              The decompression context
- * @param decoded              The decoded values to update in the context
- * @param payload_len          The length of the packet payload
- * @param pkt_arrival_time     The arrival time of the decoded ROHC packet
- * @param[out] do_change_mode  Whether the context wants to change its
- *                             operational mode or not
+ * Disable a decompression profiles for a decompressor.
+ *
+ * The ROHC decompressor does not use the decompression profiles that were
+ * disabled. Thus disabling a profile might cause the decompressor to reject
+ * streams. Decompression will always fail if no profile at all is enabled.
+ *
+ * If the profile is already disabled, nothing is performed and success is
+ * reported.
+ *
+ * @param decomp   The ROHC decompressor
+ * @param profile  The profile to disable
+ * @return         true if the profile exists,
+ *                 false if the profile does not exist
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_enable_profile
+ * @see rohc_decomp_enable_profiles
+ * @see rohc_decomp_disable_profiles
  */
-static void rohc_decomp_update_context(struct rohc_decomp_ctxt *const context,
-                                       const void *const decoded,
-                                       const size_t payload_len,
-                                       const struct rohc_ts pkt_arrival_time,
-                                       bool *const do_change_mode)
+bool rohc_decomp_disable_profile(struct rohc_decomp *const decomp,
+                                 const rohc_profile_t profile)
 {
-	struct rohc_decomp_crc_corr_ctxt *const crc_corr = &context->crc_corr;
+	bool is_found = false;
+	size_t i;
 
-	/* call the profile-specific callback */
-	context->profile->update_ctxt(context, decoded, payload_len, do_change_mode);
+	if(decomp == NULL)
+	{
+		goto error;
+	}
 
-	/* update arrival time */
-	crc_corr->arrival_times[crc_corr->arrival_times_index] = pkt_arrival_time;
-	crc_corr->arrival_times_index =
-		(crc_corr->arrival_times_index + 1) % ROHC_MAX_ARRIVAL_TIMES;
-	crc_corr->arrival_times_nr =
-		rohc_min(crc_corr->arrival_times_nr + 1, ROHC_MAX_ARRIVAL_TIMES);
+	/* mark all the profiles with the ID as disabled, the built-in one and the
+	 * registered ones */
+	for(i = 0; i < decomp->profiles_nr; i++)
+	{
+		if(decomp->profiles[i]->id == profile)
+		{
+			decomp->enabled_profiles[i] = false;
+			is_found = true;
+		}
+	}
+
+	if(!is_found)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "unknown ROHC decompression profile (ID = %d)", profile);
+		goto error;
+	}
+	rohc_info(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+	          "ROHC decompression profile (ID = %d) disabled", profile);
+
+	return true;
+
+error:
+	return false;
 }
 
 
 /**
- * @brief Build a positive ACK feedback
+ * @brief Enable several decompression profiles for a decompressor
  *
- * @param decomp         The ROHC decompressor
- * @param infos          The information collected on the successfully
- *                       decompressed packet
- * @param[out] feedback  The feedback to be transmitted to the remote
- *                       compressor through the feedback channel
- * @return               true if the ACK feedback was successfully built
- *                       (may be 0 byte), false if a problem occurred
+ * Enable several decompression profiles for a decompressor. The list of
+ * profiles to enable shall stop with -1.
+ *
+ * The ROHC decompressor does not use the decompression profiles that are not
+ * enabled. Thus not enabling a profile might cause the decompressor to reject
+ * streams. Decompression will always fail if no profile at all is enabled.
+ *
+ * If one or more of the profiles are already enabled, nothing is performed
+ * and success is reported.
+ *
+ * @param decomp  The ROHC decompressor
+ * @param ...     The sequence of decompression profiles to enable, the
+ *                sequence shall be terminated by -1
+ * @return        true if all of the profiles exist,
+ *                false if at least one of the profiles does not exist
+ *
+ * @ingroup rohc_decomp
+ *
+ * \par Example:
+ * \snippet example_rohc_decomp.c define ROHC decompressor
+ * \code
+        ...
+\endcode
+ * \snippet example_rohc_decomp.c enable ROHC decompression profiles
+ * \code
+        ...
+\endcode
+ *
+ * @see rohc_decomp_enable_profile
+ * @see rohc_decomp_disable_profile
+ * @see rohc_decomp_disable_profiles
  */
-static bool rohc_decomp_feedback_ack(struct rohc_decomp *const decomp,
-                                     const struct rohc_decomp_stream *const infos,
-                                     struct rohc_buf *const feedback)
+bool rohc_decomp_enable_profiles(struct rohc_decomp *const decomp,
+                                 ...)
 {
-	const char mode_short[ROHC_R_MODE + 1] = { '?', 'U', 'O', 'R' };
-	bool do_build_ack = false;
-	size_t k;
-
-	assert(infos->cid_found);
-	assert(infos->context_found);
-
-	rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-	           "CID %zu: %s: %s state: %s packet successfully decompressed",
-	           infos->cid, rohc_get_mode_descr(infos->mode),
-	           rohc_decomp_get_state_descr(infos->state),
-	           rohc_get_packet_descr(infos->packet_type));
-
-	/* update all the stats about the feedbacks */
-	decomp->last_pkts_errors <<= 1;
-	decomp->last_pkt_feedbacks[ROHC_FEEDBACK_ACK].needed <<= 1;
-	decomp->last_pkt_feedbacks[ROHC_FEEDBACK_ACK].sent <<= 1;
-	decomp->last_pkt_feedbacks[ROHC_FEEDBACK_NACK].needed <<= 1;
-	decomp->last_pkt_feedbacks[ROHC_FEEDBACK_NACK].sent <<= 1;
-	decomp->last_pkt_feedbacks[ROHC_FEEDBACK_STATIC_NACK].needed <<= 1;
-	decomp->last_pkt_feedbacks[ROHC_FEEDBACK_STATIC_NACK].sent <<= 1;
-	infos->context->last_pkts_errors <<= 1;
-	infos->context->last_pkt_feedbacks[ROHC_FEEDBACK_ACK].needed <<= 1;
-	infos->context->last_pkt_feedbacks[ROHC_FEEDBACK_ACK].sent <<= 1;
-	infos->context->last_pkt_feedbacks[ROHC_FEEDBACK_NACK].needed <<= 1;
-	infos->context->last_pkt_feedbacks[ROHC_FEEDBACK_NACK].sent <<= 1;
-	infos->context->last_pkt_feedbacks[ROHC_FEEDBACK_STATIC_NACK].needed <<= 1;
-	infos->context->last_pkt_feedbacks[ROHC_FEEDBACK_STATIC_NACK].sent <<= 1;
+	va_list profiles;
+	int profile_id;
+	size_t err_nr = 0;
+	bool is_ok;
 
-	/* force sending an ACK if compressor/decompressor modes mismatch or
-	 * if decompressor just changed its operational mode */
-	if(infos->do_change_mode)
-	{
-		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-		           "force positive ACK because mode changed or compressor "
-		           "reported a different mode");
-		do_build_ack = true;
-	}
-	/* check if the decompressor shall build a positive feedback */
-	else if(infos->mode == ROHC_U_MODE)
+	if(decomp == NULL)
 	{
-		/* send ACK(U) with rate-limiting as stated in RFC 3095, §5.3.1.3:
-		 *   To improve performance for the Unidirectional mode over a link that
-		 *   does have a feedback channel, the decompressor MAY send an
-		 *   acknowledgment when decompression succeeds.  Setting the mode
-		 *   parameter in the ACK packet to U indicates that the compressor is to
-		 *   stay in Unidirectional mode. [...] If IR packets continue to arrive,
-		 *   the decompressor MAY repeat the ACK(U), but it SHOULD NOT repeat the
-		 *   ACK(U) continuously.*/
-		do_build_ack = true;
+		goto error;
 	}
-	else if(infos->mode == ROHC_O_MODE)
-	{
-		/* feedback logic for O-mode is described in RFC 3095, §5.4.2.2 */
 
-		/* all states: when an IR packet is correctly decompressed, send an ACK(O) */
-		if(infos->packet_type == ROHC_PACKET_IR)
-		{
-			do_build_ack = true;
-		}
-		/* SC state:
-		 *  - when a type 2 or an IR-DYN packet is correctly decompressed,
-		 *    optionally send an ACK(O)
-		 * FC state:
-		 *  - when a type 2 or an IR-DYN packet is correctly decompressed,
-		 *    optionally send an ACK(O)
-		 *  - when a type 0 or 1 packet is correctly decompressed, no
-		 *    feedback is sent */
-		else if(infos->state != ROHC_DECOMP_STATE_NC &&
-		        rohc_decomp_packet_carry_crc_7_or_8(infos->packet_type))
+	va_start(profiles, decomp);
+
+	while((profile_id = va_arg(profiles, int)) >= 0)
+	{
+		is_ok = rohc_decomp_enable_profile(decomp, profile_id);
+		if(!is_ok)
 		{
-			do_build_ack = true;
+			err_nr++;
 		}
 	}
-	else /* R-mode */
-	{
-		assert(0); /* TODO: R-mode not implemented yet */
-		goto error;
-	}
 
-	/* stop now if no ACK is required */
-	if(!do_build_ack)
-	{
-		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-		           "no need to send a positive ACK");
-		goto skip;
-	}
+	va_end(profiles);
 
-	/* rate-limit the ACKs */
-	decomp->last_pkt_feedbacks[ROHC_FEEDBACK_ACK].needed |= 1;
-	infos->context->last_pkt_feedbacks[ROHC_FEEDBACK_ACK].needed |= 1;
-	k = __builtin_popcount(infos->context->last_pkt_feedbacks[ROHC_FEEDBACK_ACK].sent) * 100;
-	if(k >= decomp->ack_rate_limits.speed.threshold)
-	{
-		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-		           "do not send a positive ACK because of rate-limiting (%zu of 3200 "
-		           "with threshold %zu)", k, decomp->ack_rate_limits.speed.threshold);
-		goto skip;
-	}
-	rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-	           "should send a positive ACK now (CID = %zu, current mode = %d, "
-	           "target mode = %d, at least %zu bits of SN 0x%x, rate-limiting = "
-	           "%zu of 3200 with threshold %zu)", infos->cid, infos->mode,
-	           decomp->target_mode, infos->sn_bits_nr, infos->sn_bits,
-	           k, decomp->ack_rate_limits.speed.threshold);
-	decomp->last_pkt_feedbacks[ROHC_FEEDBACK_ACK].sent |= 1;
-	infos->context->last_pkt_feedbacks[ROHC_FEEDBACK_ACK].sent |= 1;
+	return (err_nr == 0);
 
-	/* prepare feedback packet if asked by user */
-	if(feedback == NULL)
-	{
-		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-		           "user choose not to use a feedback channel, do not build any "
-		           "feedback packet");
-	}
-	else
-	{
-		rohc_feedback_crc_t crc_present;
-		struct d_feedback sfeedback;
-		uint8_t *feedbackp;
-		size_t feedbacksize;
-		size_t feedback_hdr_len;
+error:
+	return false;
+}
 
-		/* FEEDBACK-1 or FEEDBACK-2 ? */
-		if(infos->profile_id == ROHC_PROFILE_UNCOMPRESSED ||
-		   (!infos->do_change_mode && infos->sn_bits_nr != 0 && infos->sn_bits_nr <= 8))
-		{
-			rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-			           "use FEEDBACK-1 as positive feedback");
-			f_feedback1(infos->sn_bits, &sfeedback);
-			crc_present = ROHC_FEEDBACK_WITH_NO_CRC;
-		}
-		else
-		{
-			rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-			           "use FEEDBACK-2 as positive ACK(%c) feedback",
-			           mode_short[infos->mode]);
-			if(!f_feedback2(infos->profile_id, ROHC_FEEDBACK_ACK, infos->mode,
-			                infos->sn_bits, infos->sn_bits_nr, &sfeedback))
-			{
-				rohc_warning(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-				             "failed to build the ACK feedback");
-				goto error;
-			}
 
-			/* use CRC option if mode change requested */
-			if(infos->profile_id == ROHC_PROFILE_TCP)
-			{
-				crc_present = ROHC_FEEDBACK_WITH_CRC_BASE;
-			}
-			else if(infos->do_change_mode)
-			{
-				crc_present = ROHC_FEEDBACK_WITH_CRC_OPT;
-			}
-			else
-			{
-				crc_present = ROHC_FEEDBACK_WITH_NO_CRC;
-			}
-		}
+/**
+ * @brief Disable several decompression profiles for a decompressor
+ *
+ * Disable several decompression profiles for a decompressor. The list of
+ * profiles to disable shall stop with -1.
+ *
+ * The ROHC decompressor does not use the decompression profiles that were
+ * disabled. Thus disabling a profile might cause the decompressor to reject
+ * streams. Decompression will always fail if no profile at all is enabled.
+ *
+ * If one or more of the profiles are already disabled, nothing is performed
+ * and success is reported.
+ *
+ * @param decomp  The ROHC decompressor
+ * @param ...     The sequence of decompression profiles to disable, the
+ *                sequence shall be terminated by -1
+ * @return        true if all of the profiles exist,
+ *                false if at least one of the profiles does not exist
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_enable_profile
+ * @see rohc_decomp_enable_profiles
+ * @see rohc_decomp_disable_profile
+ */
+bool rohc_decomp_disable_profiles(struct rohc_decomp *const decomp,
+                                  ...)
+{
+	va_list profiles;
+	int profile_id;
+	size_t err_nr = 0;
+	bool is_ok;
 
-		/* build the feedback packet */
-		feedbackp = f_wrap_feedback(&sfeedback, infos->cid, infos->cid_type,
-		                            crc_present, decomp->crc_table_8, &feedbacksize);
-		if(feedbackp == NULL)
-		{
-			rohc_warning(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-			             "failed to wrap the ACK feedback");
-			goto error;
-		}
+	if(decomp == NULL)
+	{
+		goto error;
+	}
 
-		/* copy the feedback to the buffer provided by the user */
-		/* TODO: build feedback directly into the provided buffer */
-		feedback_hdr_len = 1 + (feedbacksize < 8 ? 0 : 1);
-		if((feedback_hdr_len + feedbacksize) <= rohc_buf_avail_len(*feedback))
-		{
-			if(feedbacksize < 8)
-			{
-				rohc_buf_byte(*feedback) = 0xf0 | feedbacksize;
-			}
-			else
-			{
-				rohc_buf_byte(*feedback) = 0xf0;
-				rohc_buf_byte_at(*feedback, 1) = feedbacksize;
-			}
-			feedback->len += feedback_hdr_len;
-			rohc_buf_append(feedback, feedbackp, feedbacksize);
-		}
+	va_start(profiles, decomp);
 
-		if(feedback->len > 0)
+	while((profile_id = va_arg(profiles, int)) >= 0)
+	{
+		is_ok = rohc_decomp_disable_profile(decomp, profile_id);
+		if(!is_ok)
 		{
-			rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-			           "decompressor built a %zu-byte positive feedback",
-			           feedback->len);
+			err_nr++;
 		}
-
-		/* destroy the temporary feedback buffer */
-		free(feedbackp);
 	}
 
-skip:
-	return true;
+	va_end(profiles);
+
+	return (err_nr == 0);
 
 error:
 	return false;
@@ -1984,366 +6621,284 @@ error:
 
 
 /**
- * @brief Build a negative ACK feedback
+ * @brief Register an additional decompression profile in a decompressor
  *
- * There are two types of negative feedback: NACK and STATIC-NACK.
+ * The profile is added to the profiles built in the library, for this
+ * decompressor only. It is enabled once registered.
  *
- * @param decomp         The ROHC decompressor
- * @param infos          The information collected on the failed
- *                       decompressed packet
- * @param[out] feedback  The feedback to be transmitted to the remote
- *                       compressor through the feedback channel (may be NULL)
- * @return               true if the ACK feedback was successfully built
- *                       (may be 0 byte), false if a problem occurred
+ * The ROHC packets name their profile with its ID: the registered profiles
+ * are looked up before the built-in ones, by decreasing priority, then in
+ * their order of registration. A registered profile thus replaces the
+ * built-in profile with the same ID, unless it is disabled. The profiles of
+ * one ID are enabled and disabled together, and the contexts restored from
+ * snapshots are given to the first enabled one: profiles that share one ID
+ * shall share the format of their snapshots, or not save their contexts at
+ * all.
+ *
+ * The profile shall be built against the internal headers of the very same
+ * version of the library, since its structure is private. The profile shall
+ * outlive the decompressor.
+ *
+ * The profiles shall be registered before the first packet is decompressed.
+ *
+ * @param decomp    The ROHC decompressor
+ * @param profile   The decompression profile to register
+ * @param priority  The priority of the profile among the registered ones,
+ *                  the higher the sooner the profile is looked up
+ * @return          true if the profile was registered,
+ *                  false if the profile is invalid, if the decompressor
+ *                  already decompressed packets, if the decompressor cannot
+ *                  accept more profiles, or if memory ran out
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_enable_profile
+ * @see rohc_decomp_disable_profile
  */
-static bool rohc_decomp_feedback_nack(struct rohc_decomp *const decomp,
-                                      const struct rohc_decomp_stream *const infos,
-                                      struct rohc_buf *const feedback)
+bool rohc_decomp_register_profile(struct rohc_decomp *const decomp,
+                                  const struct rohc_decomp_profile *const profile,
+                                  const int priority)
 {
-	bool do_downward_transition = false;
-	bool do_build_ack = false;
-	enum rohc_feedback_ack_type ack_type;
-	size_t threshold_too_quickly;
-	size_t k_too_quickly;
-	size_t k_too_many;
-
-	/* update all the stats about the feedbacks */
-	decomp->last_pkts_errors <<= 1;
-	decomp->last_pkts_errors |= 1;
-	decomp->last_pkt_feedbacks[ROHC_FEEDBACK_ACK].needed <<= 1;
-	decomp->last_pkt_feedbacks[ROHC_FEEDBACK_ACK].sent <<= 1;
-	decomp->last_pkt_feedbacks[ROHC_FEEDBACK_NACK].needed <<= 1;
-	decomp->last_pkt_feedbacks[ROHC_FEEDBACK_NACK].sent <<= 1;
-	decomp->last_pkt_feedbacks[ROHC_FEEDBACK_STATIC_NACK].needed <<= 1;
-	decomp->last_pkt_feedbacks[ROHC_FEEDBACK_STATIC_NACK].sent <<= 1;
-	if(infos->context != NULL)
-	{
-		infos->context->last_pkts_errors <<= 1;
-		infos->context->last_pkts_errors |= 1;
-		infos->context->last_pkt_feedbacks[ROHC_FEEDBACK_ACK].needed <<= 1;
-		infos->context->last_pkt_feedbacks[ROHC_FEEDBACK_ACK].sent <<= 1;
-		infos->context->last_pkt_feedbacks[ROHC_FEEDBACK_NACK].needed <<= 1;
-		infos->context->last_pkt_feedbacks[ROHC_FEEDBACK_NACK].sent <<= 1;
-		infos->context->last_pkt_feedbacks[ROHC_FEEDBACK_STATIC_NACK].needed <<= 1;
-		infos->context->last_pkt_feedbacks[ROHC_FEEDBACK_STATIC_NACK].sent <<= 1;
-	}
-
-	/* the decompressor cannot warn the compressor if the CID is not identified
-	 * (this happens only if packet is malformed) */
-	if(!infos->cid_found)
-	{
-		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-		           "do not perform downward state transition nor send negative "
-		           "feedback to compressor since CID was not identified");
-		goto skip;
-	}
+	size_t registered_nr;
+	size_t idx;
+	size_t pos;
+	size_t i;
 
-	if(infos->context_found)
-	{
-		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-		           "CID %zu: %s: %s state: %s packet %s", infos->cid,
-		           rohc_get_mode_descr(infos->mode),
-		           rohc_decomp_get_state_descr(infos->state),
-		           rohc_get_packet_descr(infos->packet_type),
-		           infos->crc_failed ? "failed the CRC check" : "received");
-	}
-	else
+	if(decomp == NULL || profile == NULL)
 	{
-		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-		           "CID %zu: packet failed to be parsed", infos->cid);
+		goto error;
 	}
-
-	/* check if the decompressor shall build a negative feedback */
-	if(infos->profile_id == ROHC_PROFILE_UNCOMPRESSED)
+	if(profile->id >= ROHC_PROFILE_MAX ||
+	   profile->extr_bits_size == 0 || profile->decoded_values_size == 0 ||
+	   profile->new_context == NULL || profile->free_context == NULL ||
+	   profile->detect_pkt_type == NULL || profile->parse_pkt == NULL ||
+	   profile->decode_bits == NULL || profile->build_hdrs == NULL ||
+	   profile->update_ctxt == NULL || profile->attempt_repair == NULL ||
+	   profile->get_sn == NULL)
 	{
-		/* the Uncompressed profile does not use negative feedback nor FEEDBACK-2 */
-		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-		           "do not perform downward state transition nor send negative "
-		           "feedback for the Uncompressed profile");
-		goto skip;
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "failed to register profile: invalid profile");
+		goto error;
 	}
-	else if(!infos->context_found)
+	if(decomp->stats.received > 0 || decomp->num_contexts_used > 0)
 	{
-		/* RFC says nothing about negative feedbacks for malformed packets, but
-		 * it seems useful to tell the compressor to got back to lower states
-		 * if a packet failed to be parsed */
-		ack_type = ROHC_FEEDBACK_STATIC_NACK;
-		do_downward_transition = false; /* impossible w/o context */
-		do_build_ack = !!(decomp->target_mode > ROHC_U_MODE);
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "failed to register profile 0x%04x: decompressor already "
+		             "decompressed packets", profile->id);
+		goto error;
 	}
-	else if(infos->mode == ROHC_U_MODE)
+	if(decomp->profiles_nr >= D_MAX_PROFILES)
 	{
-		/* U-mode does not use negative feedback */
-		ack_type = ROHC_FEEDBACK_NACK;
-		do_downward_transition = true;
-		do_build_ack = false;
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "failed to register profile 0x%04x: no more than %u "
+		             "additional profiles", profile->id,
+		             ROHC_DECOMP_EXTRA_PROFILES_MAX);
+		goto error;
 	}
-	else if(infos->mode == ROHC_O_MODE)
+	for(i = 0; i < decomp->profiles_nr; i++)
 	{
-		/* feedback logic for O-mode is described in RFC 3095, §5.4.2.2 */
-
-		/* NC state: when receiving a type 0, 1, 2 or IR-DYN packet, or an IR
-		 * packet has failed the CRC check, send a STATIC-NACK(O), subject to the
-		 * considerations at the beginning of section 5.7.6 */
-		if(infos->state == ROHC_DECOMP_STATE_NC)
-		{
-			ack_type = ROHC_FEEDBACK_STATIC_NACK;
-			do_downward_transition = true;
-			do_build_ack = true;
-		}
-		/* SC state:
-		 *  - when a type 0 or 1 packet is received, treat it as a mismatching
-		 *    CRC and use the logic of section 5.3.2.2.3 to decide if a NACK(O)
-		 *    should be sent
-		 *  - when decompression of a type 2 packet, an IR-DYN packet or an
-		 *    IR packet has failed, use the logic of section 5.3.2.2.3 to
-		 *    decide if a STATIC-NACK(O) should be sent */
-		else if(infos->state == ROHC_DECOMP_STATE_SC)
-		{
-			if(!rohc_decomp_packet_carry_crc_7_or_8(infos->packet_type))
-			{
-				ack_type = ROHC_FEEDBACK_NACK;
-				do_downward_transition = true;
-				do_build_ack = true;
-			}
-			else
-			{
-				ack_type = ROHC_FEEDBACK_STATIC_NACK;
-				do_downward_transition = true;
-				do_build_ack = true;
-			}
-		}
-		/* FC state: when any packet fails the CRC check, use the logic of
-		 * 5.3.2.2.3 to decide if a NACK(O) should be sent */
-		else
+		if(decomp->profiles[i] == profile)
 		{
-			ack_type = ROHC_FEEDBACK_NACK;
-			do_downward_transition = true;
-			do_build_ack = true;
+			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			             "failed to register profile 0x%04x: profile already "
+			             "registered", profile->id);
+			goto error;
 		}
 	}
-	else /* R-mode */
-	{
-		assert(0); /* TODO: R-mode not implemented yet */
-		goto error;
-	}
 
-	/* stop now if no downward state transition nor NACK is required */
-	if(!do_build_ack && !do_downward_transition)
-	{
-		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-		           "no need to perform a downward state transition nor send a "
-		           "negative ACK");
-		goto skip;
-	}
-	assert(ack_type == ROHC_FEEDBACK_NACK || ack_type == ROHC_FEEDBACK_STATIC_NACK);
+	/* add the profile after the other ones */
+	idx = decomp->profiles_nr;
+	decomp->profiles[idx] = profile;
+	decomp->profiles_prio[idx] = priority;
+	decomp->profiles_nr++;
 
-	/* rate-limit the downward state transitions and NACKs */
-	if(infos->context != NULL)
-	{
-		decomp->last_pkt_feedbacks[ack_type].needed |= 1;
-		infos->context->last_pkt_feedbacks[ack_type].needed |= 1;
-		k_too_quickly = __builtin_popcount(infos->context->last_pkts_errors) * 100;
-		k_too_many = __builtin_popcount(infos->context->last_pkt_feedbacks[ack_type].sent) * 100;
-	}
-	else
+	/* the data shared by the contexts for decoding shall be large enough for
+	 * the new profile too */
+	if(!rohc_decomp_alloc_per_pkt_data(decomp))
 	{
-		decomp->last_pkt_feedbacks[ack_type].needed |= 1;
-		k_too_quickly = __builtin_popcount(decomp->last_pkts_errors) * 100;
-		k_too_many = __builtin_popcount(decomp->last_pkt_feedbacks[ack_type].sent) * 100;
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "failed to register profile 0x%04x: no memory for the "
+		             "decoding data", profile->id);
+		decomp->profiles_nr--;
+		goto error;
 	}
-	if(ack_type == ROHC_FEEDBACK_NACK)
+	decomp->enabled_profiles[idx] = true;
+
+	/* look up the profile after the registered profiles of higher or same
+	 * priority, but before the other ones and before the built-in ones */
+	registered_nr = idx - D_NUM_PROFILES;
+	for(pos = 0; pos < registered_nr &&
+	             decomp->profiles_prio[decomp->profiles_order[pos]] >= priority;
+	    pos++)
 	{
-		threshold_too_quickly = decomp->ack_rate_limits.nack.threshold;
 	}
-	else
+	for(i = idx; i > pos; i--)
 	{
-		threshold_too_quickly = decomp->ack_rate_limits.static_nack.threshold;
+		decomp->profiles_order[i] = decomp->profiles_order[i - 1];
 	}
-	if(k_too_quickly < threshold_too_quickly)
-	{
-		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-		           "avoid sending feedback too quickly (%zu of 3200 with threshold %zu)",
-		           k_too_quickly, threshold_too_quickly);
+	decomp->profiles_order[pos] = idx;
 
-		/* force sending a negative ACK if compressor/decompressor modes mismatch
-		 * or if decompressor just changed its operational mode */
-		if(do_build_ack && infos->do_change_mode)
-		{
-			rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-			           "force negative ACK because mode changed or compressor "
-			           "reported a different mode");
-			do_build_ack = true;
-		}
-		else
-		{
-			do_build_ack = false;
-		}
-		do_downward_transition = false;
-	}
-	else if(k_too_quickly >= (threshold_too_quickly + 100) &&
-	        k_too_many >= decomp->ack_rate_limits.speed.threshold)
+	rohc_info(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL, "ROHC "
+	          "decompression profile (ID = %d) registered with priority %d",
+	          profile->id, priority);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Set the callback function used to manage traces in decompressor
+ *
+ * Set the user-defined callback function used to manage traces in the
+ * decompressor.
+ *
+ * The function will be called by the ROHC library every time it wants to
+ * print something related to decompression, from errors to debug. User may
+ * thus decide what traces are interesting (filter on \e level, source
+ * \e entity, or \e profile) and what to do with them (print on console,
+ * storage in file, syslog...).
+ *
+ * @warning The callback can not be modified after library initialization
+ *
+ * @param decomp     The ROHC decompressor
+ * @param callback   Two possible cases:
+ *                     \li The callback function used to manage traces
+ *                     \li NULL to remove the previous callback
+ * @param priv_ctxt  An optional private context, may be NULL
+ * @return           true on success, false otherwise
+ *
+ * @ingroup rohc_decomp
+ */
+bool rohc_decomp_set_traces_cb2(struct rohc_decomp *decomp,
+                                rohc_trace_callback2_t callback,
+                                void *const priv_ctxt)
+{
+	/* check decompressor validity */
+	if(decomp == NULL)
 	{
-		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-		           "rate-limiting successive feedbacks (%zu of 3200 with threshold "
-		           "%zu)", k_too_many, decomp->ack_rate_limits.speed.threshold);
-
-		/* force sending a negative ACK if compressor/decompressor modes mismatch
-		 * or if decompressor just changed its operational mode */
-		if(do_build_ack && infos->do_change_mode)
-		{
-			rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-			           "force negative ACK because mode changed or compressor "
-			           "reported a different mode");
-			do_build_ack = true;
-		}
-		else
-		{
-			do_build_ack = false;
-		}
-		do_downward_transition = false;
+		/* cannot print a trace without a valid decompressor */
+		goto error;
 	}
 
-	/* update informations if feedback is sent or downward transition taken */
-	if(do_build_ack || do_downward_transition)
+	/* refuse to set a new trace callback if decompressor is in use */
+	if(decomp->stats.received > 0)
 	{
-		decomp->last_pkt_feedbacks[ack_type].sent |= 1;
-		if(infos->context != NULL)
-		{
-			infos->context->last_pkt_feedbacks[ack_type].sent |= 1;
-		}
+		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL, "unable to "
+		           "modify the trace callback after initialization");
+		goto error;
 	}
 
-	/* prepare feedback packet if needed and asked by user */
-	if(!do_build_ack)
+	/* replace current trace callback by the new one */
+	decomp->trace_callback = callback;
+	decomp->trace_callback_priv = priv_ctxt;
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Set the lowest level of the traces of the decompressor
+ *
+ * The traces below the given level are dropped before they are formatted,
+ * so they cost almost nothing. By default, traces of all levels are given
+ * to the trace callback.
+ *
+ * @warning The level can not be modified after library initialization
+ *
+ * @param decomp  The ROHC decompressor
+ * @param level   The lowest level of the traces to give to the callback
+ * @return        true on success, false otherwise
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_set_traces_cb2
+ */
+bool rohc_decomp_set_trace_level(struct rohc_decomp *const decomp,
+                                 const rohc_trace_level_t level)
+{
+	/* check decompressor validity */
+	if(decomp == NULL)
 	{
-		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-		           "do not send a negative ACK");
+		goto error;
 	}
-	else if(feedback == NULL)
+
+	/* check the trace level */
+	if(level >= ROHC_TRACE_LEVEL_MAX)
 	{
-		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-		           "user choose not to use a feedback channel, do not build any "
-		           "feedback packet");
+		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "unknown trace level %d", level);
+		goto error;
 	}
-	else
-	{
-		rohc_feedback_crc_t crc_present;
-		struct d_feedback sfeedback;
-		uint8_t *feedbackp;
-		size_t feedbacksize;
-		size_t feedback_hdr_len;
-
-		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-		           "should send a negative ACK (CID = %zu, NACK type = %d, current "
-		           "mode = %d, target mode = %d, at least %zu bits of SN 0x%x, "
-		           "rate-limiting = %zu of 3200 with threshold %zu and %zu of 3200 "
-		           "with threshold %zu)", infos->cid, ack_type, infos->mode,
-		           decomp->target_mode, infos->sn_bits_nr, infos->sn_bits,
-		           k_too_quickly, threshold_too_quickly,
-		           k_too_many, decomp->ack_rate_limits.speed.threshold);
 
-		/* prepare FEEDBACK-2 */
-		if(!f_feedback2(infos->profile_id, ack_type, infos->mode, infos->sn_bits,
-		                infos->sn_bits_nr, &sfeedback))
-		{
-			rohc_warning(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-			             "failed to build the (STATIC-)NACK feedback");
-			goto error;
-		}
+	/* refuse to change the trace level if decompressor is in use, because the
+	 * contexts copied it at creation */
+	if(decomp->stats.received > 0)
+	{
+		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL, "unable to "
+		           "modify the trace level after initialization");
+		goto error;
+	}
 
-		/* use CRC option if mode change requested */
-		if(infos->profile_id == ROHC_PROFILE_TCP)
-		{
-			crc_present = ROHC_FEEDBACK_WITH_CRC_BASE;
-		}
-		else if(infos->do_change_mode)
-		{
-			crc_present = ROHC_FEEDBACK_WITH_CRC_OPT;
-		}
-		else
-		{
-			crc_present = ROHC_FEEDBACK_WITH_NO_CRC;
-		}
+	decomp->trace_level = level;
 
-		/* build the feedback packet */
-		feedbackp = f_wrap_feedback(&sfeedback, infos->cid, infos->cid_type,
-		                            crc_present, decomp->crc_table_8, &feedbacksize);
-		if(feedbackp == NULL)
-		{
-			rohc_warning(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-			             "failed to wrap the (STATIC-)NACK feedback");
-			goto error;
-		}
+	return true;
 
-		/* copy the feedback to the buffer provided by the user */
-		/* TODO: build feedback directly into the provided buffer */
-		feedback_hdr_len = 1 + (feedbacksize < 8 ? 0 : 1);
-		if((feedback_hdr_len + feedbacksize) <= rohc_buf_avail_len(*feedback))
-		{
-			if(feedbacksize < 8)
-			{
-				rohc_buf_byte(*feedback) = 0xf0 | feedbacksize;
-			}
-			else
-			{
-				rohc_buf_byte(*feedback) = 0xf0;
-				rohc_buf_byte_at(*feedback, 1) = feedbacksize;
-			}
-			feedback->len += feedback_hdr_len;
-			rohc_buf_append(feedback, feedbackp, feedbacksize);
-		}
+error:
+	return false;
+}
 
-		if(feedback->len > 0)
-		{
-			rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-			           "decompressor built a %zu-byte negative feedback",
-			           feedback->len);
-		}
 
-		/* destroy the temporary feedback buffer */
-		free(feedbackp);
+/**
+ * @brief Enable or disable the ring of binary trace records of the decompressor
+ *
+ * The decompressor writes one fixed-size \ref rohc_trace_record in the ring
+ * for every decompressed packet and for every packet that failed to be
+ * decompressed. Nothing is formatted, so the ring may stay enabled
+ * in production for post-mortem debugging. The oldest records are overwritten
+ * when the ring is full. Use \ref rohc_decomp_get_trace_records to read them.
+ *
+ * @warning The ring can not be modified after library initialization
+ *
+ * @param decomp      The ROHC decompressor
+ * @param records_nr  The number of records of the ring (a power of 2),
+ *                    0 to disable the ring
+ * @return            true on success, false otherwise
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_get_trace_records
+ */
+bool rohc_decomp_set_trace_ring(struct rohc_decomp *const decomp,
+                                const size_t records_nr)
+{
+	/* check decompressor validity */
+	if(decomp == NULL)
+	{
+		goto error;
 	}
 
-	/* upon decompression failure, perform downward transitions if context is
-	 * still available (new contexts are destroyed upon decompression error) */
-	if(!do_downward_transition || infos->context == NULL)
+	/* refuse to change the ring if decompressor is in use */
+	if(decomp->stats.received > 0)
 	{
-		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-		           "do not perform a downward state transition");
+		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL, "unable to "
+		           "modify the ring of binary traces after initialization");
+		goto error;
 	}
-	else
-	{
-		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-		           "perform a downward state transition now (CID = %zu, NACK "
-		           "type = %d, current mode = %d, target mode = %d, rate-limiting "
-		           "= %zu of 3200 with threshold %zu and %zu of 3200 with "
-		           "threshold %zu)", infos->cid, ack_type, infos->mode,
-		           decomp->target_mode, k_too_quickly, threshold_too_quickly,
-		           k_too_many, decomp->ack_rate_limits.speed.threshold);
 
-		if(infos->state == ROHC_DECOMP_STATE_SC)
-		{
-			rohc_info(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-			          "change from state %d to state %d because of error(s)",
-			          infos->state, ROHC_DECOMP_STATE_NC);
-			infos->context->state = ROHC_DECOMP_STATE_NC;
-		}
-		else if(infos->state == ROHC_DECOMP_STATE_FC)
-		{
-			rohc_info(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-			          "change from state %d to state %d because of error(s)",
-			          infos->state, ROHC_DECOMP_STATE_SC);
-			infos->context->state = ROHC_DECOMP_STATE_SC;
-		}
-		else
-		{
-			rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-			           "stay in state %d because of error(s)", infos->context->state);
-		}
+	if(!rohc_trace_ring_init(&decomp->trace_ring, records_nr))
+	{
+		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL, "failed to "
+		           "create a ring of %zu binary traces, the number shall be "
+		           "a power of 2", records_nr);
+		goto error;
 	}
 
-skip:
 	return true;
 
 error:
@@ -2352,159 +6907,280 @@ error:
 
 
 /**
- * @brief Update statistics upon successful decompression
+ * @brief Get the most recent records of the ring of binary traces
  *
- * @param context         The decompression context
- * @param comp_hdr_len    The length (in bytes) of the compressed header
- * @param uncomp_hdr_len  The length (in bytes) of the uncompressed header
+ * The function may be called from another thread than the one that
+ * decompresses packets, without any lock. The records overwritten by the
+ * decompressor during the copy are not returned.
+ *
+ * The \e app/traces/rohc_traces tool renders the records written in a file.
+ *
+ * @param decomp           The ROHC decompressor
+ * @param[out] records     The records, the oldest one first
+ * @param max_nr           The maximum number of records to get
+ * @param[out] records_nr  The number of records got
+ * @return                 true on success, false otherwise
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_set_trace_ring
  */
-static void rohc_decomp_stats_add_success(struct rohc_decomp_ctxt *const context,
-                                          const size_t comp_hdr_len,
-                                          const size_t uncomp_hdr_len)
+bool rohc_decomp_get_trace_records(const struct rohc_decomp *const decomp,
+                                   struct rohc_trace_record *const records,
+                                   const size_t max_nr,
+                                   size_t *const records_nr)
 {
-	context->header_compressed_size += comp_hdr_len;
-	context->header_uncompressed_size += uncomp_hdr_len;
+	if(decomp == NULL || records == NULL || records_nr == NULL)
+	{
+		goto error;
+	}
+
+	*records_nr = rohc_trace_ring_read(&decomp->trace_ring, records, max_nr);
+
+	return true;
+
+error:
+	return false;
 }
 
 
 /**
- * @brief Reset all the statistics of the given ROHC decompressor
+ * @brief Create a new group of ROHC decompressors that share one CID space
+ *
+ * Create a group of \e workers_nr ROHC decompressors (the workers) that
+ * serve one ROHC channel together. Every worker owns the CIDs equal to its
+ * index modulo \e workers_nr, so the workers may be run on different cores
+ * without any lock:
+ *  \li one front-end thread classifies the ROHC packets by CID and hands
+ *      them to the workers with \ref rohc_decomp_group_push,
+ *  \li every worker thread decompresses the packets handed to it with
+ *      \ref rohc_decomp_group_decompress,
+ *  \li one thread collects the feedback generated by all the workers with
+ *      \ref rohc_decomp_group_pull_feedback.
+ *
+ * The workers are configured one by one: retrieve them with
+ * \ref rohc_decomp_group_get_worker, then enable profiles, set the trace
+ * callback... like for any other decompressor.
+ *
+ * ROHC segments carry no CID before they are reassembled, they are thus not
+ * supported by groups of decompressors.
+ *
+ * @param cid_type    The type of CIDs the ROHC channel uses
+ * @param max_cid     The MAX_CID of the ROHC channel
+ * @param mode        The operational mode that the workers shall target
+ * @param workers_nr  The number of workers, in range [1, \e max_cid + 1]
+ * @return            The created group of decompressors if successful,
+ *                    NULL if creation failed
  *
- * @param decomp The ROHC decompressor
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_group_free
+ * @see rohc_decomp_group_get_worker
+ * @see rohc_decomp_group_push
+ * @see rohc_decomp_group_decompress
+ * @see rohc_decomp_group_pull_feedback
  */
-static void rohc_decomp_reset_stats(struct rohc_decomp *const decomp)
+struct rohc_decomp_group *
+	rohc_decomp_group_new(const rohc_cid_type_t cid_type,
+	                      const rohc_cid_t max_cid,
+	                      const rohc_mode_t mode,
+	                      const size_t workers_nr)
 {
-	assert(decomp != NULL);
-	decomp->stats.received = 0;
-	decomp->stats.failed_crc = 0;
-	decomp->stats.failed_no_context = 0;
-	decomp->stats.failed_decomp = 0;
-	decomp->stats.total_compressed_size = 0;
-	decomp->stats.total_uncompressed_size = 0;
-	decomp->stats.corrected_crc_failures = 0;
-	decomp->stats.corrected_sn_wraparounds = 0;
-	decomp->stats.corrected_wrong_sn_updates = 0;
+	struct rohc_decomp_group *group;
+	size_t i;
+
+	/* the other parameters are checked by the creation of the workers */
+	if(workers_nr == 0 || workers_nr > (max_cid + 1))
+	{
+		goto error;
+	}
+
+	group = calloc(1, sizeof(struct rohc_decomp_group));
+	if(group == NULL)
+	{
+		goto error;
+	}
+	group->workers = calloc(workers_nr, sizeof(struct rohc_decomp_group_worker));
+	if(group->workers == NULL)
+	{
+		goto free_group;
+	}
+	group->cid_type = cid_type;
+	group->max_cid = max_cid;
+	group->workers_nr = workers_nr;
+	group->next_feedback_worker = 0;
+
+	/* every worker gets the whole CID space but only receives the packets of
+	 * the CIDs it owns */
+	for(i = 0; i < workers_nr; i++)
+	{
+		group->workers[i].decomp = rohc_decomp_new2(cid_type, max_cid, mode);
+		if(group->workers[i].decomp == NULL)
+		{
+			goto free_workers;
+		}
+	}
+
+	return group;
+
+free_workers:
+	for(i = 0; i < workers_nr; i++)
+	{
+		rohc_decomp_free(group->workers[i].decomp);
+	}
+	free(group->workers);
+free_group:
+	free(group);
+error:
+	return NULL;
 }
 
 
 /**
- * @brief Give a description for the given ROHC decompression context state
- *
- * Give a description for the given ROHC decompression context state.
+ * @brief Destroy the given group of ROHC decompressors
  *
- * The descriptions are not part of the API. They may change between
- * releases without any warning. Do NOT use them for other means that
- * providing to users a textual description of decompression context states
- * used by the library. If unsure, ask on the mailing list.
+ * Destroy all the workers of the group, then the group itself. The ROHC
+ * packets still waiting for the workers are dropped.
  *
- * @param state  The decompression context state to get a description for
- * @return       A string that describes the given decompression context state
+ * @param group  The group of ROHC decompressors to destroy
  *
  * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_group_new
  */
-const char * rohc_decomp_get_state_descr(const rohc_decomp_state_t state)
+void rohc_decomp_group_free(struct rohc_decomp_group *const group)
 {
-	switch(state)
+	if(group != NULL)
 	{
-		case ROHC_DECOMP_STATE_NC:
-			return "No Context";
-		case ROHC_DECOMP_STATE_SC:
-			return "Static Context";
-		case ROHC_DECOMP_STATE_FC:
-			return "Full Context";
-		case ROHC_DECOMP_STATE_UNKNOWN:
-		default:
-			return "no description";
+		size_t i;
+
+		for(i = 0; i < group->workers_nr; i++)
+		{
+			rohc_decomp_free(group->workers[i].decomp);
+		}
+		free(group->workers);
+		free(group);
+	}
+}
+
+
+/**
+ * @brief Get one worker of the given group of ROHC decompressors
+ *
+ * The worker is a regular ROHC decompressor: configure it as usual. Only
+ * decompress packets with \ref rohc_decomp_group_decompress, and do not
+ * free it with \ref rohc_decomp_free, \ref rohc_decomp_group_free does it.
+ *
+ * @param group       The group of ROHC decompressors
+ * @param worker_idx  The index of the worker, in range [0, workers_nr - 1]
+ * @return            The decompressor of the worker if successful,
+ *                    NULL if the group or the index is invalid
+ *
+ * @ingroup rohc_decomp
+ */
+struct rohc_decomp *
+	rohc_decomp_group_get_worker(const struct rohc_decomp_group *const group,
+	                             const size_t worker_idx)
+{
+	if(group == NULL || worker_idx >= group->workers_nr)
+	{
+		return NULL;
 	}
+
+	return group->workers[worker_idx].decomp;
 }
 
 
 /**
- * @brief Get some information about the last decompressed packet
+ * @brief Hand the given ROHC packet to the worker that owns its CID
  *
- * Get some information about the last decompressed packet.
+ * Decode the CID of the ROHC packet, then enqueue the packet for the worker
+ * that owns the CID. Feedback-only packets and packets whose CID cannot be
+ * decoded are given to the first worker, that reports them as usual.
  *
- * To use the function, call it with a pointer on a pre-allocated
- * \ref rohc_decomp_last_packet_info_t structure with the \e version_major
- * and \e version_minor fields set to one of the following supported
- * versions:
- *  - Major 0, minor 0
- *  - Major 0, minor 1
+ * Only the description of the packet is enqueued: the packet data shall stay
+ * valid until the worker returns the packet from
+ * \ref rohc_decomp_group_decompress.
  *
- * See \ref rohc_decomp_last_packet_info_t for details about fields that
- * are supported in the above versions.
+ * The function may be called from another thread than the ones that run
+ * the workers, but only from one thread at a time. It prints no trace since
+ * the trace callbacks of the workers might not be thread-safe.
  *
- * @param decomp        The ROHC decompressor to get information from
- * @param[in,out] info  The structure where information will be stored
- * @return              true in case of success, false otherwise
+ * @param group        The group of ROHC decompressors
+ * @param rohc_packet  The ROHC packet to decompress
+ * @return             true if the packet was handed to one worker,
+ *                     false if the packet is a ROHC segment or if the queue
+ *                     of the worker is full
  *
  * @ingroup rohc_decomp
- *
- * @see rohc_decomp_last_packet_info_t
  */
-bool rohc_decomp_get_last_packet_info(const struct rohc_decomp *const decomp,
-                                      rohc_decomp_last_packet_info_t *const info)
+bool rohc_decomp_group_push(struct rohc_decomp_group *const group,
+                            const struct rohc_buf rohc_packet)
 {
-	if(decomp == NULL)
+	struct rohc_buf remain_data = rohc_packet;
+	struct rohc_decomp_group_ring *ring;
+	size_t worker_idx = 0;
+	rohc_cid_t cid;
+	size_t head;
+	size_t tail;
+
+	if(group == NULL || rohc_buf_is_malformed(rohc_packet))
 	{
 		goto error;
 	}
 
-	if(decomp->last_context == NULL)
+	/* skip padding and feedback items to find the CID of the header */
+	while(remain_data.len > 0 &&
+	      rohc_decomp_packet_is_padding(rohc_buf_data(remain_data)))
 	{
-		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-		           "last context found in decompressor is not valid");
-		goto error;
+		rohc_buf_pull(&remain_data, 1);
 	}
-
-	if(info == NULL)
+	while(remain_data.len > 0 &&
+	      rohc_packet_is_feedback(rohc_buf_byte(remain_data)))
 	{
-		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-		           "structure for last packet information is not valid");
-		goto error;
+		size_t feedback_hdr_len;
+		size_t feedback_data_len;
+
+		if(!rohc_feedback_get_size(remain_data, &feedback_hdr_len,
+		                           &feedback_data_len) ||
+		   (feedback_hdr_len + feedback_data_len) > remain_data.len)
+		{
+			/* malformed feedback, let the first worker report it */
+			remain_data.len = 0;
+			break;
+		}
+		rohc_buf_pull(&remain_data, feedback_hdr_len + feedback_data_len);
 	}
 
-	/* check compatibility version */
-	if(info->version_major == 0)
+	/* steer the packet by CID */
+	if(remain_data.len > 0)
 	{
-		/* base fields for major version 0 */
-		info->context_mode = decomp->last_context->mode;
-		info->context_state = decomp->last_context->state;
-		info->profile_id = decomp->last_context->profile->id;
-		info->nr_lost_packets = decomp->last_context->nr_lost_packets;
-		info->nr_misordered_packets = decomp->last_context->nr_misordered_packets;
-		info->is_duplicated = decomp->last_context->is_duplicated;
-
-		/* new fields added by minor versions */
-		switch(info->version_minor)
+		if(rohc_decomp_packet_is_segment(rohc_buf_data(remain_data)))
 		{
-			case 0:
-				/* nothing to add */
-				break;
-			case 1:
-				/* new fields in 0.1 */
-				info->corrected_crc_failures =
-					decomp->last_context->corrected_crc_failures;
-				info->corrected_sn_wraparounds =
-					decomp->last_context->corrected_sn_wraparounds;
-				info->corrected_wrong_sn_updates =
-					decomp->last_context->corrected_wrong_sn_updates;
-				info->packet_type = decomp->last_context->packet_type;
-				break;
-			default:
-				rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-				           "unsupported minor version (%u) of the structure for "
-				           "last packet information", info->version_minor);
-				goto error;
+			goto error;
+		}
+		if(rohc_decomp_peek_cid(group->cid_type, rohc_buf_data(remain_data),
+		                        remain_data.len, &cid) &&
+		   cid <= group->max_cid)
+		{
+			worker_idx = cid % group->workers_nr;
 		}
 	}
-	else
+	ring = &group->workers[worker_idx].pkts;
+
+	/* only the front-end writes the head index, only the worker writes the
+	 * tail index: the acquire load of the tail ensures that the worker is
+	 * done with the slot before it is overwritten */
+	head = ring->head;
+	tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+	if((head - tail) >= ROHC_DECOMP_GROUP_RING_LEN)
 	{
-		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-		           "unsupported major version (%u) of the structure for last "
-		           "packet information", info->version_major);
 		goto error;
 	}
+	ring->pkts[head & (ROHC_DECOMP_GROUP_RING_LEN - 1)] = rohc_packet;
+
+	/* publish the slot to the worker */
+	__atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
 
 	return true;
 
@@ -2514,94 +7190,94 @@ error:
 
 
 /**
- * @brief Get some information about the given decompression context
- *
- * Get some information about the given decompression context.
+ * @brief Decompress the next ROHC packet handed to the given worker
  *
- * To use the function, call it with a pointer on a pre-allocated
- * \ref rohc_decomp_context_info_t structure with the \e version_major
- * and \e version_minor fields set to one of the following supported
- * versions:
- *  - Major 0, minor 0
+ * Dequeue the next ROHC packet handed to the worker by
+ * \ref rohc_decomp_group_push and decompress it as \ref rohc_decompress3
+ * would do. The feedback generated by the decompression is enqueued in the
+ * outbound feedback queue of the group (see
+ * \ref rohc_decomp_group_pull_feedback), it is dropped if the queue is full.
  *
- * See \ref rohc_decomp_context_info_t for details about fields that
- * are supported in the above versions.
+ * The function shall be called by one thread per worker only.
  *
- * @param decomp        The ROHC decompressor to get information from
- * @param cid           The Context ID to get information for
- * @param[in,out] info  The structure where information will be stored
- * @return              true in case of success, false otherwise
+ * @param group               The group of ROHC decompressors
+ * @param worker_idx          The index of the worker
+ * @param[out] rohc_packet    The ROHC packet that was dequeued, so that the
+ *                            caller may release it
+ * @param[out] uncomp_packet  The resulting uncompressed packet
+ * @param[out] rcvd_feedback  The feedback received from the remote peer for
+ *                            the same-side associated ROHC compressor, may
+ *                            be NULL to ignore it
+ * @param[out] status         The result of the decompression, see
+ *                            \ref rohc_decompress3
+ * @return                    true if one packet was dequeued and decompressed,
+ *                            false if no packet was waiting for the worker
+ *                            or if parameters are invalid
  *
  * @ingroup rohc_decomp
  *
- * @see rohc_decomp_context_info_t
+ * @see rohc_decompress3
  */
-bool rohc_decomp_get_context_info(const struct rohc_decomp *const decomp,
-                                  const rohc_cid_t cid,
-                                  rohc_decomp_context_info_t *const info)
+bool rohc_decomp_group_decompress(struct rohc_decomp_group *const group,
+                                  const size_t worker_idx,
+                                  struct rohc_buf *const rohc_packet,
+                                  struct rohc_buf *const uncomp_packet,
+                                  struct rohc_buf *const rcvd_feedback,
+                                  rohc_status_t *const status)
 {
-	if(decomp == NULL)
+	uint8_t feedback_send_data[ROHC_DECOMP_GROUP_FEEDBACK_SLOT_LEN];
+	struct rohc_buf feedback_send =
+		rohc_buf_init_empty(feedback_send_data,
+		                    ROHC_DECOMP_GROUP_FEEDBACK_SLOT_LEN);
+	struct rohc_decomp_group_worker *worker;
+	struct rohc_decomp_group_ring *ring;
+	size_t head;
+	size_t tail;
+
+	if(group == NULL || worker_idx >= group->workers_nr ||
+	   rohc_packet == NULL || status == NULL)
 	{
 		goto error;
 	}
+	worker = &group->workers[worker_idx];
+	ring = &worker->pkts;
 
-	if(cid > decomp->medium.max_cid)
+	/* dequeue the next packet, then give the slot back to the front-end */
+	tail = ring->tail;
+	head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+	if(tail == head)
 	{
-		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-		           "decompressor does not handle CID %zu since MAX_CID is %zu",
-		           cid, decomp->medium.max_cid);
 		goto error;
 	}
+	*rohc_packet = ring->pkts[tail & (ROHC_DECOMP_GROUP_RING_LEN - 1)];
+	__atomic_store_n(&ring->tail, tail + 1, __ATOMIC_RELEASE);
 
-	if(info == NULL)
-	{
-		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-		           "structure for context information is not valid");
-		goto error;
-	}
+	*status = rohc_decompress3(worker->decomp, *rohc_packet, uncomp_packet,
+	                           rcvd_feedback, &feedback_send);
 
-	/* check compatibility version */
-	if(info->version_major == 0)
+	/* enqueue the generated feedback for the consumer */
+	if(feedback_send.len > 0)
 	{
-		/* base fields for major version 0 */
-		if(decomp->contexts[cid] == NULL)
+		struct rohc_decomp_group_feedback_ring *const fb_ring = &worker->feedback;
+		const size_t fb_head = fb_ring->head;
+		const size_t fb_tail = __atomic_load_n(&fb_ring->tail, __ATOMIC_ACQUIRE);
+
+		if((fb_head - fb_tail) < ROHC_DECOMP_GROUP_FEEDBACK_LEN)
 		{
-			info->packets_nr = 0;
-			info->comp_bytes_nr = 0;
-			info->uncomp_bytes_nr = 0;
-			info->corrected_crc_failures = 0;
-			info->corrected_sn_wraparounds = 0;
-			info->corrected_wrong_sn_updates = 0;
+			struct rohc_decomp_group_feedback_slot *const slot =
+				&fb_ring->slots[fb_head & (ROHC_DECOMP_GROUP_FEEDBACK_LEN - 1)];
+
+			memcpy(slot->data, rohc_buf_data(feedback_send), feedback_send.len);
+			slot->len = feedback_send.len;
+			__atomic_store_n(&fb_ring->head, fb_head + 1, __ATOMIC_RELEASE);
 		}
 		else
 		{
-			info->packets_nr = decomp->contexts[cid]->num_recv_packets;
-			info->comp_bytes_nr = decomp->contexts[cid]->total_compressed_size;
-			info->uncomp_bytes_nr = decomp->contexts[cid]->total_uncompressed_size;
-			info->corrected_crc_failures =
-				decomp->contexts[cid]->corrected_crc_failures;
-			info->corrected_sn_wraparounds =
-				decomp->contexts[cid]->corrected_sn_wraparounds;
-			info->corrected_wrong_sn_updates =
-				decomp->contexts[cid]->corrected_wrong_sn_updates;
-		}
-
-		/* new fields added by minor versions */
-		if(info->version_minor > 0)
-		{
-			rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-			           "unsupported minor version (%u) of the structure for "
-			           "context information", info->version_minor);
-			goto error;
+			rohc_warning(worker->decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			             "outbound feedback queue is full, drop %zu bytes of "
+			             "feedback", feedback_send.len);
 		}
 	}
-	else
-	{
-		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-		           "unsupported major version (%u) of the structure for context"
-		           "information", info->version_major);
-		goto error;
-	}
 
 	return true;
 
@@ -2611,137 +7287,155 @@ error:
 
 
 /**
- * @brief Get some general information about the decompressor
- *
- * Get some general information about the decompressor.
+ * @brief Collect the feedback generated by the workers of the given group
  *
- * To use the function, call it with a pointer on a pre-allocated
- * \ref rohc_decomp_general_info_t structure with the \e version_major and
- * \e version_minor fields set to one of the following supported versions:
- *  - Major 0, minor 0
+ * Append to the given buffer as many feedback packets generated by the
+ * workers as the buffer can hold. The outbound queues of the workers are
+ * visited in turn, starting with a different worker at every call so that
+ * no worker starves the others.
  *
- * See the \ref rohc_decomp_general_info_t structure for details about fields
- * that are supported in the above versions.
+ * The function may be called from another thread than the ones that run
+ * the workers, but only from one thread at a time.
  *
- * @param decomp        The ROHC decompressor to get information from
- * @param[in,out] info  The structure where information will be stored
- * @return              true in case of success, false otherwise
+ * @param group          The group of ROHC decompressors
+ * @param[out] feedback  The buffer where to append the feedback to be
+ *                       transmitted to the remote compressors
+ * @return               true if the feedback waiting in the queues was
+ *                       appended (possibly none),
+ *                       false if parameters are invalid
  *
  * @ingroup rohc_decomp
- *
- * @see rohc_decomp_general_info_t
  */
-bool rohc_decomp_get_general_info(const struct rohc_decomp *const decomp,
-                                  rohc_decomp_general_info_t *const info)
+bool rohc_decomp_group_pull_feedback(struct rohc_decomp_group *const group,
+                                     struct rohc_buf *const feedback)
 {
-	if(decomp == NULL)
-	{
-		goto error;
-	}
+	size_t i;
 
-	if(info == NULL)
+	if(group == NULL || feedback == NULL || rohc_buf_is_malformed(*feedback))
 	{
-		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-		           "structure for general information is not valid");
 		goto error;
 	}
 
-	/* check compatibility version */
-	if(info->version_major == 0)
+	for(i = 0; i < group->workers_nr; i++)
 	{
-		/* base fields for major version 0 */
-		info->contexts_nr = decomp->num_contexts_used;
-		info->packets_nr = decomp->stats.received;
-		info->comp_bytes_nr = decomp->stats.total_compressed_size;
-		info->uncomp_bytes_nr = decomp->stats.total_uncompressed_size;
+		const size_t worker_idx =
+			(group->next_feedback_worker + i) % group->workers_nr;
+		struct rohc_decomp_group_feedback_ring *const fb_ring =
+			&group->workers[worker_idx].feedback;
+		const size_t fb_head = __atomic_load_n(&fb_ring->head, __ATOMIC_ACQUIRE);
+		size_t fb_tail = fb_ring->tail;
 
-		/* new fields added by minor versions */
-		switch(info->version_minor)
+		while(fb_tail != fb_head)
 		{
-			case 0:
-				/* nothing to add */
-				break;
-			case 1:
-				/* new fields in 0.1 */
-				info->corrected_crc_failures = decomp->stats.corrected_crc_failures;
-				info->corrected_sn_wraparounds =
-					decomp->stats.corrected_sn_wraparounds;
-				info->corrected_wrong_sn_updates =
-					decomp->stats.corrected_wrong_sn_updates;
-				break;
-			default:
-				rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-				           "unsupported minor version (%u) of the structure for "
-				           "general information", info->version_minor);
-				goto error;
+			const struct rohc_decomp_group_feedback_slot *const slot =
+				&fb_ring->slots[fb_tail & (ROHC_DECOMP_GROUP_FEEDBACK_LEN - 1)];
+
+			if(slot->len > rohc_buf_avail_len(*feedback))
+			{
+				/* no more room, keep the remaining feedback for next time */
+				goto full;
+			}
+			rohc_buf_append(feedback, slot->data, slot->len);
+			fb_tail++;
+
+			/* give the slot back to the worker */
+			__atomic_store_n(&fb_ring->tail, fb_tail, __ATOMIC_RELEASE);
 		}
 	}
-	else
-	{
-		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-		           "unsupported major version (%u) of the structure for "
-		           "general information", info->version_major);
-		goto error;
-	}
 
+full:
+	group->next_feedback_worker =
+		(group->next_feedback_worker + 1) % group->workers_nr;
 	return true;
 
 error:
 	return false;
 }
 
-
 /**
- * @brief Get the CID type that the decompressor uses
+ * @brief Save the contexts of the given ROHC decompressor in a snapshot
  *
- * Get the CID type that the decompressor currently uses.
+ * Write a binary snapshot of the contexts of the decompressor, so that
+ * another decompressor, possibly in another process, may go on decompressing
+ * the same flows without waiting for IR packets (warm restarts,
+ * active/standby failover...).
  *
- * @param decomp         The ROHC decompressor
- * @param[out] cid_type  The current CID type among \ref ROHC_SMALL_CID and
- *                       \ref ROHC_LARGE_CID
- * @return               true if the CID type was successfully retrieved,
- *                       false otherwise
+ * The snapshot is written record by record with the given callback: one
+ * header, one record per context, then one end record. The snapshot is
+ * thus never held in memory as a whole. The snapshot is versioned and shall
+ * be restored by the same build of the library, see \ref rohc_decomp_restore.
+ *
+ * The contexts of profiles that cannot be saved yet are skipped: their flows
+ * wait for the next IR packet once restored.
+ *
+ * @param decomp    The ROHC decompressor to save
+ * @param write_cb  The callback used to write the records of the snapshot
+ * @param priv      The private context given to the callback
+ * @return          true if the snapshot was successfully written,
+ *                  false if parameters are invalid or the callback failed
  *
  * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_restore
  */
-bool rohc_decomp_get_cid_type(const struct rohc_decomp *const decomp,
-                              rohc_cid_type_t *const cid_type)
+bool rohc_decomp_snapshot(const struct rohc_decomp *const decomp,
+                          const rohc_snapshot_write_t write_cb,
+                          void *const priv)
 {
-	if(decomp == NULL || cid_type == NULL)
+	struct rohc_decomp_snapshot_ctxt record;
+	struct rohc_snapshot_hdr hdr;
+	size_t saved_nr = 0;
+	size_t i;
+
+	if(decomp == NULL || write_cb == NULL)
 	{
 		goto error;
 	}
 
-	*cid_type = decomp->medium.cid_type;
-	return true;
+	memset(&hdr, 0, sizeof(struct rohc_snapshot_hdr));
+	hdr.magic = ROHC_SNAPSHOT_MAGIC;
+	hdr.version = ROHC_SNAPSHOT_VERSION;
+	hdr.entity = ROHC_SNAPSHOT_DECOMP;
+	hdr.cid_type = decomp->medium.cid_type;
+	hdr.max_cid = decomp->medium.max_cid;
+	if(!write_cb(priv, (uint8_t *) &hdr, sizeof(struct rohc_snapshot_hdr)))
+	{
+		goto error;
+	}
 
-error:
-	return false;
-}
+	for(i = 0; i < decomp->active_contexts_nr; i++)
+	{
+		const struct rohc_decomp_ctxt *const context = decomp->active_contexts[i];
 
+		if(context->profile->snapshot == NULL)
+		{
+			rohc_debug(decomp, ROHC_TRACE_DECOMP, context->profile->id,
+			           "skip context with CID %zu: profile cannot be saved",
+			           context->cid);
+			continue;
+		}
+		if(!rohc_decomp_snapshot_ctxt(context, write_cb, priv))
+		{
+			rohc_warning(decomp, ROHC_TRACE_DECOMP, context->profile->id,
+			             "failed to save context with CID %zu", context->cid);
+			goto error;
+		}
+		saved_nr++;
+	}
 
-/**
- * @brief Get the maximal CID value the decompressor uses
- *
- * Get the maximal CID value the decompressor uses, ie. the \e MAX_CID
- * parameter defined in RFC 3095.
- *
- * @param decomp        The ROHC decompressor
- * @param[out] max_cid  The current maximal CID value
- * @return              true if MAX_CID was successfully retrieved,
- *                      false otherwise
- *
- * @ingroup rohc_decomp
- */
-bool rohc_decomp_get_max_cid(const struct rohc_decomp *const decomp,
-                             size_t *const max_cid)
-{
-	if(decomp == NULL || max_cid == NULL)
+	/* end of snapshot */
+	memset(&record, 0, sizeof(struct rohc_decomp_snapshot_ctxt));
+	record.profile_id = ROHC_SNAPSHOT_END;
+	if(!write_cb(priv, (uint8_t *) &record,
+	             sizeof(struct rohc_decomp_snapshot_ctxt)))
 	{
 		goto error;
 	}
 
-	*max_cid = decomp->medium.max_cid;
+	rohc_info(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+	          "%zu contexts saved out of %zu", saved_nr,
+	          decomp->active_contexts_nr);
+
 	return true;
 
 error:
@@ -2749,81 +7443,83 @@ error:
 }
 
 
-/**
- * @brief Set the Maximum Reconstructed Reception Unit (MRRU).
- *
- * Set the Maximum Reconstructed Reception Unit (MRRU).
- *
- * The MRRU is the largest cumulative length (in bytes) of the ROHC segments
- * that are parts of the same ROHC packet. In short, the ROHC decompressor
- * does not expect to reassemble ROHC segments whose total length is larger
- * than MRRU. So, the ROHC compressor shall not segment ROHC packets greater
- * than the MRRU.
- *
- * The MRRU value must be in range [0 ; \ref ROHC_MAX_MRRU]. Remember that the
- * MRRU includes the 32-bit CRC that protects it.
- * If set to 0, segmentation is disabled as no segment headers are allowed
- * on the channel. Every received segment will be dropped.
+/**
+ * @brief Restore the contexts of a ROHC decompressor from a snapshot
  *
- * If segmentation is enabled and used by the compressor, the function
- * \ref rohc_decompress3 will return ROHC_OK and one empty uncompressed packet
- * upon decompression until the last segment is received (or a non-segment is
- * received). Decompressed data will be returned at that time.
+ * Read the binary snapshot written by \ref rohc_decomp_snapshot and re-build
+ * its contexts in the given decompressor. The contexts keep their mode and
+ * state, so that decompression goes on without waiting for IR packets.
  *
- * @warning Changing the MRRU value while library is used may lead to
- *          destruction of the current RRU.
+ * The decompressor shall be configured like the saved one beforehand: same
+ * type of CIDs and MAX_CID, and the profiles of the saved contexts enabled.
+ * The restored contexts replace the contexts with the same CIDs if any. If
+ * the restoration fails, the contexts that were restored so far are kept.
  *
- * @param decomp  The ROHC decompressor
- * @param mrru    The new MRRU value (in bytes)
- * @return        true if the MRRU was successfully set, false otherwise
+ * @param decomp   The ROHC decompressor to restore the contexts in
+ * @param read_cb  The callback used to read the records of the snapshot
+ * @param priv     The private context given to the callback
+ * @return         true if the snapshot was successfully restored,
+ *                 false if parameters are invalid, if the snapshot is
+ *                 malformed or does not match the decompressor, or if the
+ *                 callback failed
  *
  * @ingroup rohc_decomp
  *
- * \par Example:
- * \snippet test_segment.c define ROHC decompressor
- * \code
-        size_t mrru = 500;
-        ...
-\endcode
- * \snippet test_segment.c create ROHC decompressor
- * \code
-        ...
-\endcode
- * \snippet test_segment.c set decompressor MRRU
- * \code
-        ...
-\endcode
- *
- * @see rohc_decomp_get_mrru
- * @see rohc_decompress3
- * @see rohc_comp_set_mrru
- * @see rohc_comp_get_mrru
+ * @see rohc_decomp_snapshot
  */
-bool rohc_decomp_set_mrru(struct rohc_decomp *const decomp,
-                          const size_t mrru)
+bool rohc_decomp_restore(struct rohc_decomp *const decomp,
+                         const rohc_snapshot_read_t read_cb,
+                         void *const priv)
 {
-	/* decompressor must be valid */
-	if(decomp == NULL)
+	struct rohc_decomp_snapshot_ctxt record;
+	struct rohc_snapshot_hdr hdr;
+	size_t restored_nr = 0;
+
+	if(decomp == NULL || read_cb == NULL)
 	{
-		/* cannot print a trace without a valid decompressor */
 		goto error;
 	}
 
-	/* new MRRU value must be in range [0, ROHC_MAX_MRRU] */
-	if(mrru > ROHC_MAX_MRRU)
+	if(!read_cb(priv, (uint8_t *) &hdr, sizeof(struct rohc_snapshot_hdr)))
+	{
+		goto error;
+	}
+	if(hdr.magic != ROHC_SNAPSHOT_MAGIC ||
+	   hdr.version != ROHC_SNAPSHOT_VERSION ||
+	   hdr.entity != ROHC_SNAPSHOT_DECOMP)
 	{
 		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-		             "unexpected MRRU value: must be in range [0, %d]",
-		             ROHC_MAX_MRRU);
+		             "snapshot is not a decompressor snapshot in version %u",
+		             ROHC_SNAPSHOT_VERSION);
+		goto error;
+	}
+	if(hdr.cid_type != decomp->medium.cid_type ||
+	   hdr.max_cid != decomp->medium.max_cid)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "snapshot was taken with another type of CIDs or "
+		             "MAX_CID");
 		goto error;
 	}
 
-	/* set new MRRU */
-	decomp->mrru = mrru;
-	rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-	           "MRRU is now set to %zd", decomp->mrru);
+	while(read_cb(priv, (uint8_t *) &record,
+	              sizeof(struct rohc_decomp_snapshot_ctxt)))
+	{
+		if(record.profile_id == ROHC_SNAPSHOT_END)
+		{
+			rohc_info(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			          "%zu contexts restored", restored_nr);
+			return true;
+		}
+		if(!rohc_decomp_restore_ctxt(decomp, &record, read_cb, priv))
+		{
+			goto error;
+		}
+		restored_nr++;
+	}
 
-	return true;
+	rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+	             "snapshot is truncated after %zu contexts", restored_nr);
 
 error:
 	return false;
@@ -2831,45 +7527,63 @@ error:
 
 
 /**
- * @brief Get the Maximum Reconstructed Reception Unit (MRRU).
- *
- * Get the current Maximum Reconstructed Reception Unit (MRRU).
- *
- * The MRRU is the largest cumulative length (in bytes) of the ROHC segments
- * that are parts of the same ROHC packet. In short, the ROHC decompressor
- * does not expect to reassemble ROHC segments whose total length is larger
- * than MRRU. So, the ROHC compressor shall not segment ROHC packets greater
- * than the MRRU.
- *
- * The MRRU value must be in range [0 ; \ref ROHC_MAX_MRRU]. Remember that the
- * MRRU includes the 32-bit CRC that protects it.
- * If MRRU value is 0, segmentation is disabled.
- *
- * If segmentation is enabled and used by the compressor, the function
- * \ref rohc_decompress3 will return ROHC_OK and one empty uncompressed packet
- * upon decompression until the last segment is received (or a non-segment is
- * received). Decompressed data will be returned at that time.
+ * @brief Set the callback function for the journal of context updates
+ *
+ * Once set, the callback is called every time the decompression of one ROHC
+ * packet updated one decompression context, with one journal record that
+ * describes the updated context. The records are meant to be forwarded to a
+ * standby decompressor that applies them with \ref rohc_decomp_journal_apply,
+ * so that it tracks the decompression contexts of the active decompressor
+ * continuously: after a failover, the standby decompressor goes on without
+ * waiting for IR packets and without any period of context damage.
+ *
+ * One record holds the whole decompression context, so that the standby
+ * decompressor never depends on previous records: lost records are repaired
+ * by the next ones. Only the parts of the context in use are written, so
+ * that the records stay small. The records are in the format of snapshots
+ * (see \ref rohc_decomp_snapshot): they shall be applied by the same build of
+ * the library. The contexts of profiles that cannot be saved in snapshots
+ * are not journaled.
  *
- * @param decomp     The ROHC decompressor
- * @param[out] mrru  The current MRRU value (in bytes)
- * @return           true if MRRU was successfully retrieved, false otherwise
+ * @param decomp    The ROHC decompressor
+ * @param callback  The callback function that receives the journal records,
+ *                  NULL to disable the journal
+ * @param priv      The private context given to the callback function
+ * @return          true if the callback was successfully set,
+ *                  false if a problem occurred
  *
  * @ingroup rohc_decomp
  *
- * @see rohc_decomp_set_mrru
- * @see rohc_decompress3
- * @see rohc_comp_set_mrru
- * @see rohc_comp_get_mrru
+ * @see rohc_decomp_journal_apply
  */
-bool rohc_decomp_get_mrru(const struct rohc_decomp *const decomp,
-                          size_t *const mrru)
+bool rohc_decomp_set_journal_cb(struct rohc_decomp *const decomp,
+                                rohc_decomp_journal_cb_t callback,
+                                void *const priv)
 {
-	if(decomp == NULL || mrru == NULL)
+	if(decomp == NULL)
 	{
 		goto error;
 	}
 
-	*mrru = decomp->mrru;
+	/* allocate the buffer for journal records once, it grows if a larger
+	 * record is built later */
+	if(callback != NULL && decomp->journal_buf == NULL)
+	{
+		const size_t journal_max_len = 1024U;
+
+		decomp->journal_buf = malloc(journal_max_len);
+		if(decomp->journal_buf == NULL)
+		{
+			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			             "failed to allocate memory for journal records");
+			goto error;
+		}
+		decomp->journal_max_len = journal_max_len;
+	}
+
+	decomp->journal_cb = callback;
+	decomp->journal_cb_priv = priv;
+
 	return true;
 
 error:
@@ -2878,80 +7592,61 @@ error:
 
 
 /**
- * @brief Set the number of packets sent during one Round-Trip Time (RTT).
- *
- * Set the maximum number of packets sent in worst case by the remote ROHC
- * compressor for one given stream (ie. one compression/decompression context)
- * during one Round-Trip Time (RTT).
+ * @brief Apply one journal record on a standby ROHC decompressor
  *
- * The number of packets sent by the remote ROHC compressor is used to estimate
- * how many SN bits those feedbacks shall transmit to avoid any ambiguity at
- * compressor about the ROHC packet that is (n)acknowledged by the decompressor.
- *
- * The pRTT value must be in range [0 ; SIZE_MAX/2[. If set to 0, all SN bits
- * are always transmitted.
+ * Update the decompression context described by the given journal record,
+ * as built by the active decompressor (see \ref rohc_decomp_set_journal_cb).
+ * The context is created if the standby decompressor does not know it yet,
+ * it is replaced otherwise.
  *
- * The default value is 50 packets / RTT, ie. a RTT of 1 second with one packet
- * transmitted every 20 milliseconds (classic VoIP stream). If your network
- * streams and conditions differ, change the default value.
+ * The standby decompressor shall be configured like the active one: same
+ * type of CIDs and MAX_CID, and the same profiles enabled.
  *
- * @param decomp  The ROHC decompressor
- * @param prtt    The number of packets sent during one RTT
- * @return        true if the new value was successfully set, false otherwise
+ * @param decomp      The standby ROHC decompressor
+ * @param record      The journal record
+ * @param record_len  The length (in bytes) of the journal record
+ * @return            true if the record was successfully applied,
+ *                    false if parameters are invalid, if the record is
+ *                    malformed or does not match the decompressor
  *
  * @ingroup rohc_decomp
  *
- * \par Example:
- * \snippet test_feedback2.c define ROHC decompressor
- * \code
-        rohc_cid_type_t cid_type = ROHC_SMALL_CID;
-        rohc_cid_t max_cid = ROHC_SMALL_CID_MAX;
-        ...
-\endcode
- * \snippet test_feedback2.c create ROHC decompressor
- * \code
-        ...
-\endcode
- * \snippet test_feedback2.c set decompressor pRTT
- * \code
-        ...
-\endcode
- *
- * @see rohc_decomp_get_prtt
- * @see rohc_decompress3
+ * @see rohc_decomp_set_journal_cb
  */
-bool rohc_decomp_set_prtt(struct rohc_decomp *const decomp,
-                          const size_t prtt)
+bool rohc_decomp_journal_apply(struct rohc_decomp *const decomp,
+                               const uint8_t *const record,
+                               const size_t record_len)
 {
-	/* decompressor must be valid */
-	if(decomp == NULL)
+	struct rohc_decomp_journal_cursor cursor;
+	struct rohc_decomp_snapshot_ctxt ctxt_record;
+
+	if(decomp == NULL || record == NULL)
 	{
-		/* cannot print a trace without a valid decompressor */
 		goto error;
 	}
+	cursor.data = record;
+	cursor.len = record_len;
+	cursor.pos = 0;
 
-	/* new pRTT must be in range [0, SIZE_MAX] */
-	if(prtt >= (SIZE_MAX / 2))
+	if(!rohc_decomp_journal_read(&cursor, (uint8_t *) &ctxt_record,
+	                             sizeof(struct rohc_decomp_snapshot_ctxt)) ||
+	   ctxt_record.profile_id == ROHC_SNAPSHOT_END)
 	{
 		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-		             "unexpected pRTT value: must be in range [0, %zu]",
-		             SIZE_MAX);
+		             "malformed journal record of %zu bytes", record_len);
 		goto error;
 	}
-
-	/* set new pRTT */
-	decomp->prtt = prtt;
-	rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-	           "pRTT is now set to %zu", decomp->prtt);
-
-	/* compute the minimum number of SN bits to transmit to the remote
-	 * compressor in the positive or negative feedbacks in order to avoid
-	 * any ambiguity at compressor about the ROHC packet that is
-	 * (n)acknowledged by the decompressor */
-	decomp->sn_feedback_min_bits = sizeof(uint32_t) * 8;
-	if(decomp->prtt != 0)
+	if(!rohc_decomp_restore_ctxt(decomp, &ctxt_record, rohc_decomp_journal_read,
+	                             &cursor))
 	{
-		decomp->sn_feedback_min_bits -= __builtin_clz(decomp->prtt);
+		goto error;
+	}
+	if(cursor.pos != cursor.len)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "%zu unexpected bytes at the end of the journal record",
+		             cursor.len - cursor.pos);
+		goto error;
 	}
 
 	return true;
@@ -2962,41 +7657,72 @@ error:
 
 
 /**
- * @brief Get the number of packets sent during one Round-Trip Time (RTT).
- *
- * Get the maximum number of packets sent in worst case by the remote ROHC
- * compressor for one given stream (ie. one compression/decompression context)
- * during one Round-Trip Time (RTT).
- *
- * The number of packets sent by the remote ROHC compressor is used to estimate
- * how many SN bits those feedbacks shall transmit to avoid any ambiguity at
- * compressor about the ROHC packet that is (n)acknowledged by the decompressor.
+ * @brief Build the feedback that the decompressor deferred
  *
- * The pRTT value must be in range [0 ; SIZE_MAX/2[. If set to 0, all SN bits
- * are always transmitted.
+ * When the \ref ROHC_DECOMP_FEATURE_DEFERRED_FEEDBACK feature is enabled,
+ * \ref rohc_decompress3 does not build feedback packets while decompressing:
+ * it only decides which feedback is needed (rate-limiting and state
+ * transitions included) and records one feedback intent (CID, type of
+ * acknowledgement, mode, SN bits, mode change) in a queue. This function
+ * turns the recorded intents into feedback packets, in the order they were
+ * recorded.
  *
- * The default value is 50 packets / RTT, ie. a RTT of 1 second with one packet
- * transmitted every 20 milliseconds (classic VoIP stream). If your network
- * streams and conditions differ, change the default value.
+ * The function may be called from another thread than the one that
+ * decompresses packets, for example from a thread with a lower priority, but
+ * only from one thread at a time. Intents are dropped if the queue is full
+ * when they are recorded.
  *
- * @param decomp     The ROHC decompressor
- * @param[out] prtt  The number of packets sent during one RTT
- * @return           true if pRTT was successfully retrieved, false otherwise
+ * @param decomp         The ROHC decompressor
+ * @param[out] feedback  The buffer where to append the feedback to be
+ *                       transmitted to the remote compressor
+ * @return               true if the recorded intents were turned into
+ *                       feedback (possibly none, the intents that do not fit
+ *                       in the buffer are kept for the next call),
+ *                       false if parameters are invalid or if one feedback
+ *                       failed to be built
  *
  * @ingroup rohc_decomp
  *
- * @see rohc_decomp_set_prtt
- * @see rohc_decompress3
+ * @see ROHC_DECOMP_FEATURE_DEFERRED_FEEDBACK
  */
-bool rohc_decomp_get_prtt(const struct rohc_decomp *const decomp,
-                          size_t *const prtt)
+bool rohc_decomp_flush_feedback(struct rohc_decomp *const decomp,
+                                struct rohc_buf *const feedback)
 {
-	if(decomp == NULL || prtt == NULL)
+	struct rohc_decomp_feedback_intents *intents;
+	size_t head;
+	size_t tail;
+
+	if(decomp == NULL || feedback == NULL || rohc_buf_is_malformed(*feedback))
 	{
 		goto error;
 	}
+	intents = &decomp->feedback_intents;
+
+	/* only the decompression writes the head index, only the flush writes
+	 * the tail index */
+	head = __atomic_load_n(&intents->head, __ATOMIC_ACQUIRE);
+	tail = intents->tail;
+	while(tail != head)
+	{
+		const struct rohc_decomp_feedback_intent *const intent =
+			&intents->intents[tail & (ROHC_DECOMP_FEEDBACK_INTENTS_LEN - 1)];
+		const size_t feedback_len = feedback->len;
+
+		if(!rohc_decomp_build_feedback(decomp, intent, feedback))
+		{
+			goto error;
+		}
+		if(feedback->len == feedback_len)
+		{
+			/* no more room, keep the remaining intents for next time */
+			break;
+		}
+		tail++;
+
+		/* give the slot back to the decompression */
+		__atomic_store_n(&intents->tail, tail, __ATOMIC_RELEASE);
+	}
 
-	*prtt = decomp->prtt;
 	return true;
 
 error:
@@ -3005,112 +7731,52 @@ error:
 
 
 /**
- * @brief Set the rate limits for feedbacks
- *
- * Set the rate limits for positive feedbacks (ACK) and negative feedbacks (NACK
- * and STATIC-NACK).
- *
- * There are 3 different rate limits:
- *  \li the rate limit to avoid sending the same type of feedback too often:
- *      it applies to all feedback types (ACK, NACK, STATIC-NACK) and it is
- *      specified by the parameters \e k and \e n ;
- *  \li the rate limit to avoid sending NACKs too quickly after a sporadic CRC
- *      failure: it is specified by the parameters \e k_1 and \e n_1 ;
- *  \li the rate limit to avoid sending STATIC-NACKs too quickly after a sporadic
- *      CRC failure: it is specified by the parameters \e k_2 and \e n_2 ;
- *
- * In all 3 cases above, the \e k/k_1/k_2 and \e n/n_1/n_2 parameters define
- * 3 ratios of packets:
- *  \li a feedback is sent every \e k packets out of \e n packets that cause
- *      the same feedback type to be sent ;
- *  \li a NACK is not sent before \e k_1 packets out of \e n_1 packets failed
- *      because of a CRC failure in the Full Context state ;
- *  \li a STATIC-NACK is not sent before \e k_1 packets out of \e n_1 packets
- *      failed because of a CRC failure in the Static Context state ;
- *
- * The default values are:
- *  \li k   =  1 and n   = default pRTT (see rohc_decomp_set_prtt for details)
- *  \li k_1 = 30 and n_1 = 100, ie. 30%
- *  \li k_2 = 30 and n_2 = 100, ie. 30%
- *
- * If your network streams and conditions differ, change the default value.
- *
- * The n/n_1/n_2 values shall not be zero.
+ * @brief Set the window for the coalescing of positive feedback
  *
- * @param decomp  The ROHC decompressor
- * @param k       The k rate-limit parameter to avoid sending feedback too often
- * @param n       The n rate-limit parameter to avoid sending feedback too often
- * @param k_1     The k_1 rate-limit parameter to avoid sending NACKs too quickly
- * @param n_1     The n_1 rate-limit parameter to avoid sending NACKs too quickly
- * @param k_2     The k_2 rate-limit parameter to avoid sending STATIC-NACKs too quickly
- * @param n_2     The n_2 rate-limit parameter to avoid sending STATIC-NACKs too quickly
- * @return        true if the new values were successfully set, false otherwise
+ * With the O-mode and many contexts, the decompressor may send many small
+ * positive ACKs. When coalescing is enabled, the positive ACKs are not sent
+ * at once: only the latest ACK of every context is kept during the window,
+ * then the ACKs of all the contexts are sent together, as one aggregate of
+ * feedback elements (see RFC 3095, §5.2.2), in the \e feedback_send buffer
+ * given to the \ref rohc_decompress3 call that closes the window (or in the
+ * queue of deferred feedback, see \ref rohc_decomp_flush_feedback).
  *
- * @ingroup rohc_decomp
+ * The window begins with the first positive ACK kept. It ends after
+ * \e max_pkts ROHC packets or after \e max_delay milliseconds, whichever
+ * comes first, or earlier if too many contexts wait for an ACK. The delay
+ * is computed from the arrival times of the ROHC packets: if they are not
+ * given, only the number of packets ends the window.
  *
- * \par Example:
- * \snippet test_lost_packet.c define ROHC decompressor
- * \code
-        ...
-\endcode
- * \snippet test_lost_packet.c create ROHC decompressor
- * \code
-        ...
-\endcode
- * \snippet test_lost_packet.c set decompressor rate limits
- * \code
-        ...
-\endcode
+ * Negative ACKs are never delayed: they replace the positive ACK that waits
+ * for the same context, if any.
  *
- * @see rohc_decomp_get_rate_limits
- * @see rohc_decomp_set_prtt
- * @see rohc_decomp_get_prtt
- * @see rohc_decompress3
+ * @param decomp     The ROHC decompressor
+ * @param max_pkts   The max number of ROHC packets in the window,
+ *                   0 to disable coalescing (default)
+ * @param max_delay  The max duration of the window (in milliseconds),
+ *                   0 for no limit of time
+ * @return           true if the window was successfully set,
+ *                   false if parameters are invalid
+ *
+ * @ingroup rohc_decomp
  */
-bool rohc_decomp_set_rate_limits(struct rohc_decomp *const decomp,
-                                 const size_t k, const size_t n,
-                                 const size_t k_1, const size_t n_1,
-                                 const size_t k_2, const size_t n_2)
+bool rohc_decomp_set_feedback_coalescing(struct rohc_decomp *const decomp,
+                                         const size_t max_pkts,
+                                         const size_t max_delay)
 {
-	/* decompressor must be valid */
 	if(decomp == NULL)
 	{
-		/* cannot print a trace without a valid decompressor */
-		goto error;
-	}
-
-	/* n values are used as divisors */
-	if(n == 0 || n_1 == 0 || n_2 == 0)
-	{
-		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-		             "rate-limits n/n_1/n_2 shall not be 0");
 		goto error;
 	}
 
-	/* set new rate-limits */
-	decomp->ack_rate_limits.speed.k = k;
-	decomp->ack_rate_limits.speed.n = n;
-	decomp->ack_rate_limits.nack.k = k_1;
-	decomp->ack_rate_limits.nack.n = n_1;
-	decomp->ack_rate_limits.static_nack.k = k_2;
-	decomp->ack_rate_limits.static_nack.n = n_2;
-
-	/* compute the rate-limit thresholds */
-	decomp->ack_rate_limits.speed.threshold =
-		decomp->ack_rate_limits.speed.k * 32 * 100 / decomp->ack_rate_limits.speed.n;
-	decomp->ack_rate_limits.nack.threshold =
-		decomp->ack_rate_limits.nack.k * 32 * 100 / decomp->ack_rate_limits.nack.n;
-	decomp->ack_rate_limits.static_nack.threshold =
-		decomp->ack_rate_limits.static_nack.k * 32 * 100 /
-		decomp->ack_rate_limits.static_nack.n;
+	/* the ACKs that wait are sent by the next decompression if coalescing
+	 * gets disabled */
+	decomp->feedback_coalescing.max_pkts = max_pkts;
+	decomp->feedback_coalescing.max_delay = max_delay;
 
-	rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-	           "rate-limits are now set to: %zu/%zu (all), %zu/%zu (NACK), "
-	           "%zu/%zu (STATIC-NACK)",
-	           decomp->ack_rate_limits.speed.k, decomp->ack_rate_limits.speed.n,
-	           decomp->ack_rate_limits.nack.k, decomp->ack_rate_limits.nack.n,
-	           decomp->ack_rate_limits.static_nack.k,
-	           decomp->ack_rate_limits.static_nack.n);
+	rohc_info(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+	          "coalescing of positive feedback set to %zu packets and %zu ms",
+	          max_pkts, max_delay);
 
 	return true;
 
@@ -3120,72 +7786,44 @@ error:
 
 
 /**
- * @brief Get the rate limits for feedbacks currently configured
- *
- * Get the rate limits for positive feedbacks (ACK) and negative feedbacks (NACK
- * and STATIC-NACK).
- *
- * There are 3 different rate limits:
- *  \li the rate limit to avoid sending the same type of feedback too often:
- *      it applies to all feedback types (ACK, NACK, STATIC-NACK) and it is
- *      specified by the parameters \e k and \e n ;
- *  \li the rate limit to avoid sending NACKs too quickly after a sporadic CRC
- *      failure: it is specified by the parameters \e k_1 and \e n_1 ;
- *  \li the rate limit to avoid sending STATIC-NACKs too quickly after a sporadic
- *      CRC failure: it is specified by the parameters \e k_2 and \e n_2 ;
- *
- * In all 3 cases above, the \e k/k_1/k_2 and \e n/n_1/n_2 parameters define
- * 3 ratios of packets:
- *  \li a feedback is sent every \e k packets out of \e n packets that cause
- *      the same feedback type to be sent ;
- *  \li a NACK is not sent before \e k_1 packets out of \e n_1 packets failed
- *      because of a CRC failure in the Full Context state ;
- *  \li a STATIC-NACK is not sent before \e k_1 packets out of \e n_1 packets
- *      failed because of a CRC failure in the Static Context state ;
+ * @brief Set the budget of feedback bytes of the decompressor
  *
- * The default values are:
- *  \li k   =  1 and n   = default pRTT (see rohc_decomp_set_prtt for details)
- *  \li k_1 = 30 and n_1 = 100, ie. 30%
- *  \li k_2 = 30 and n_2 = 100, ie. 30%
+ * When the feedback channel is the bottleneck of the link, the feedback sent
+ * by all the contexts of the decompressor may be limited to a number of bytes
+ * per second. The feedback that would exceed the budget is not built: it is
+ * dropped if it is sent with \ref rohc_decompress3, it waits for the next
+ * calls if it is deferred (see \ref rohc_decomp_flush_feedback). The budget
+ * also applies to the negative feedback, that is otherwise rate-limited by
+ * \ref rohc_decomp_set_rate_limits.
  *
- * If your network streams and conditions differ, change the default value.
+ * The budget is renewed every second according to the arrival times of the
+ * ROHC packets given to \ref rohc_decompress3, so packets shall be given with
+ * their arrival times for the budget to be renewed. The budget shall be large
+ * enough for one feedback at least.
  *
- * @param decomp    The ROHC decompressor
- * @param[out] k    The k rate-limit parameter to avoid sending feedback too often
- * @param[out] n    The n rate-limit parameter to avoid sending feedback too often
- * @param[out] k_1  The k_1 rate-limit param. to avoid sending NACKs too quickly
- * @param[out] n_1  The n_1 rate-limit param. to avoid sending NACKs too quickly
- * @param[out] k_2  The k_2 rate-limit param. to avoid sending STATIC-NACKs too quickly
- * @param[out] n_2  The n_2 rate-limit param. to avoid sending STATIC-NACKs too quickly
- * @return          true if rate-limits were successfully retrieved,
- *                  false otherwise
+ * @param decomp     The ROHC decompressor
+ * @param max_bytes  The max number of feedback bytes per second,
+ *                   0 for no limit (default)
+ * @return           true if the budget was successfully set,
+ *                   false if parameters are invalid
  *
  * @ingroup rohc_decomp
  *
  * @see rohc_decomp_set_rate_limits
- * @see rohc_decomp_set_prtt
- * @see rohc_decomp_get_prtt
- * @see rohc_decompress3
  */
-bool rohc_decomp_get_rate_limits(const struct rohc_decomp *const decomp,
-                                 size_t *const k, size_t *const n,
-                                 size_t *const k_1, size_t *const n_1,
-                                 size_t *const k_2, size_t *const n_2)
+bool rohc_decomp_set_feedback_budget(struct rohc_decomp *const decomp,
+                                     const size_t max_bytes)
 {
-	if(decomp == NULL ||
-	   k == NULL || n == NULL ||
-	   k_1 == NULL || n_1 == NULL ||
-	   k_2 == NULL || n_2 == NULL)
+	if(decomp == NULL)
 	{
 		goto error;
 	}
 
-	*k = decomp->ack_rate_limits.speed.k;
-	*n = decomp->ack_rate_limits.speed.n;
-	*k_1 = decomp->ack_rate_limits.nack.k;
-	*n_1 = decomp->ack_rate_limits.nack.n;
-	*n_2 = decomp->ack_rate_limits.static_nack.n;
-	*k_2 = decomp->ack_rate_limits.static_nack.k;
+	decomp->feedback_budget.max_bytes = max_bytes;
+	decomp->feedback_budget.bytes_nr = 0;
+
+	rohc_info(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+	          "budget of feedback set to %zu bytes per second", max_bytes);
 
 	return true;
 
@@ -3195,50 +7833,39 @@ error:
 
 
 /**
- * @brief Enable/disable features for ROHC decompressor
- *
- * Enable/disable features for ROHC decompressor. Features control whether
- * mechanisms defined as optional by RFCs are enabled or not.
- *
- * Available features are listed by \ref rohc_decomp_features_t. They may be
- * combined by XOR'ing them together.
+ * @brief Set the callback function for the received feedback
  *
- * @warning Changing the feature set while library is used is not supported
+ * The ROHC packets may carry feedback for the same-side associated
+ * compressor. By default, the feedback items are copied in the
+ * \e rcvd_feedback buffer given to \ref rohc_decompress3, then the
+ * application gives that buffer to its compressor. Once the callback is set,
+ * every feedback item is given to the callback instead, as a view into the
+ * ROHC packet: no copy is performed, and the \e rcvd_feedback buffer is
+ * left empty. The callback may deliver the feedback directly to the
+ * compressor with \ref rohc_comp_deliver_feedback2.
  *
  * @param decomp    The ROHC decompressor
- * @param features  The feature set to enable/disable
- * @return          true if the feature set was successfully enabled/disabled,
+ * @param callback  The callback function that receives the feedback items,
+ *                  NULL to copy them in the \e rcvd_feedback buffer again
+ * @param priv      The private context given to the callback function
+ * @return          true if the callback was successfully set,
  *                  false if a problem occurred
  *
  * @ingroup rohc_decomp
  *
- * @see rohc_decomp_features_t
+ * @see rohc_decompress3
  */
-bool rohc_decomp_set_features(struct rohc_decomp *const decomp,
-                              const rohc_decomp_features_t features)
+bool rohc_decomp_set_feedback_cb(struct rohc_decomp *const decomp,
+                                 rohc_decomp_feedback_cb_t callback,
+                                 void *const priv)
 {
-	const rohc_decomp_features_t all_features =
-		ROHC_DECOMP_FEATURE_CRC_REPAIR |
-		ROHC_DECOMP_FEATURE_DUMP_PACKETS;
-
-	/* decompressor must be valid */
 	if(decomp == NULL)
 	{
-		/* cannot print a trace without a valid decompressor */
-		goto error;
-	}
-
-	/* reject unsupported features */
-	if((features & all_features) != features)
-	{
-		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-		             "feature set 0x%x is not supported (supported features "
-		             "set is 0x%x)", features, all_features);
 		goto error;
 	}
 
-	/* record new feature set */
-	decomp->features = features;
+	decomp->feedback_cb = callback;
+	decomp->feedback_cb_priv = priv;
 
 	return true;
 
@@ -3248,53 +7875,103 @@ error:
 
 
 /**
- * @brief Is the given decompression profile enabled for a decompressor?
+ * @brief Save one decompression context in a snapshot or a journal record
  *
- * Is the given decompression profile enabled or disabled for a decompressor?
- *
- * @param decomp   The ROHC decompressor
- * @param profile  The profile to ask status for
- * @return         Possible return values:
- *                  \li true if the profile exists and is enabled,
- *                  \li false if the decompressor is not valid, the profile
- *                      does not exist, or the profile is disabled
+ * @param context   The decompression context to save
+ * @param write_cb  The callback used to write the record
+ * @param priv      The private context given to the callback
+ * @return          true if the context was successfully saved,
+ *                  false if the callback failed
+ */
+static bool rohc_decomp_snapshot_ctxt(const struct rohc_decomp_ctxt *const context,
+                                      const rohc_snapshot_write_t write_cb,
+                                      void *const priv)
+{
+	struct rohc_decomp_snapshot_ctxt record;
+
+	assert(context->profile->snapshot != NULL);
+
+	memset(&record, 0, sizeof(struct rohc_decomp_snapshot_ctxt));
+	record.profile_id = context->profile->id;
+	record.cid = context->cid;
+	record.mode = context->mode;
+	record.state = context->state;
+	record.last_pkts_errors = context->last_pkts_errors;
+	record.first_used = context->first_used;
+	record.latest_used = context->latest_used;
+	record.num_recv_packets = context->num_recv_packets;
+#if ROHC_SMALL_CONTEXTS != 1
+	record.total_uncompressed_size = context->total_uncompressed_size;
+	record.total_compressed_size = context->total_compressed_size;
+	record.header_uncompressed_size = context->header_uncompressed_size;
+	record.header_compressed_size = context->header_compressed_size;
+#endif
+
+	return (write_cb(priv, (uint8_t *) &record,
+	                 sizeof(struct rohc_decomp_snapshot_ctxt)) &&
+	        context->profile->snapshot(context->persist_ctxt, write_cb, priv));
+}
+
+
+/**
+ * @brief Restore one decompression context from a snapshot or a journal record
  *
- * @ingroup rohc_decomp
+ * The restored context replaces the context with the same CID if any.
  *
- * @see rohc_decomp_enable_profile
- * @see rohc_decomp_enable_profiles
- * @see rohc_decomp_disable_profile
- * @see rohc_decomp_disable_profiles
+ * @param decomp   The ROHC decompressor
+ * @param record   The generic part of the context, already read
+ * @param read_cb  The callback used to read the profile-specific part
+ * @param priv     The private context given to the callback
+ * @return         true if the context was successfully restored,
+ *                 false if the record does not match the decompressor or
+ *                 the callback failed
  */
-bool rohc_decomp_profile_enabled(const struct rohc_decomp *const decomp,
-                                 const rohc_profile_t profile)
+static bool rohc_decomp_restore_ctxt(struct rohc_decomp *const decomp,
+                                     const struct rohc_decomp_snapshot_ctxt *const record,
+                                     const rohc_snapshot_read_t read_cb,
+                                     void *const priv)
 {
-	size_t i;
+	const struct rohc_ts first_used = { .sec = record->first_used, .nsec = 0 };
+	const struct rohc_decomp_profile *profile;
+	struct rohc_decomp_ctxt *context;
 
-	if(decomp == NULL)
+	/* the profile shall be enabled and the CID shall be valid */
+	profile = find_profile(decomp, record->profile_id);
+	if(profile == NULL || profile->restore == NULL ||
+	   record->cid > decomp->medium.max_cid)
 	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "cannot restore context with CID %u and profile 0x%04x",
+		             record->cid, record->profile_id);
 		goto error;
 	}
 
-	/* search the profile location */
-	for(i = 0; i < D_NUM_PROFILES; i++)
+	context = context_create(decomp, record->cid, profile, first_used);
+	if(context == NULL)
 	{
-		if(rohc_decomp_profiles[i]->id == profile)
-		{
-			/* found */
-			break;
-		}
+		goto error;
 	}
-
-	if(i == D_NUM_PROFILES)
+	context->mode = record->mode;
+	context->state = record->state;
+	context->last_pkts_errors = record->last_pkts_errors;
+	context->latest_used = record->latest_used;
+	context->num_recv_packets = record->num_recv_packets;
+#if ROHC_SMALL_CONTEXTS != 1
+	context->total_uncompressed_size = record->total_uncompressed_size;
+	context->total_compressed_size = record->total_compressed_size;
+	context->header_uncompressed_size = record->header_uncompressed_size;
+	context->header_compressed_size = record->header_compressed_size;
+#endif
+	if(!profile->restore(context->persist_ctxt, read_cb, priv))
 	{
-		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-		             "unknown ROHC decompression profile (ID = %d)", profile);
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, profile->id,
+		             "failed to restore context with CID %u", record->cid);
+		context_free(context);
 		goto error;
 	}
+	rohc_decomp_assign_cid(decomp, context);
 
-	/* return profile status */
-	return decomp->enabled_profiles[i];
+	return true;
 
 error:
 	return false;
@@ -3302,69 +7979,210 @@ error:
 
 
 /**
- * @brief Enable a decompression profile for a decompressor
- *
- * Enable a decompression profiles for a decompressor.
+ * @brief Give the journal record of one updated context to the user
  *
- * The ROHC decompressor does not use the decompression profiles that are not
- * enabled. Thus not enabling a profile might cause the decompressor to reject
- * streams. Decompression will always fail if no profile at all is enabled.
+ * @param decomp   The ROHC decompressor
+ * @param context  The decompression context updated by the last packet
+ */
+static void rohc_decomp_journal_ctxt(struct rohc_decomp *const decomp,
+                                     const struct rohc_decomp_ctxt *const context)
+{
+	if(context->profile->snapshot == NULL)
+	{
+		return;
+	}
+
+	decomp->journal_len = 0;
+	if(!rohc_decomp_snapshot_ctxt(context, rohc_decomp_journal_write, decomp))
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, context->profile->id,
+		             "failed to build the journal record of context with "
+		             "CID %zu", context->cid);
+		return;
+	}
+	decomp->journal_cb(decomp->journal_cb_priv, decomp->journal_buf,
+	                   decomp->journal_len);
+}
+
+
+/**
+ * @brief Append bytes to the journal record being built
  *
- * If the profile is already enabled, nothing is performed and success is
- * reported.
+ * The buffer for journal records is enlarged if it is too small.
  *
- * @param decomp   The ROHC decompressor
- * @param profile  The profile to enable
- * @return         true if the profile exists,
- *                 false if the profile does not exist
+ * @param priv  The ROHC decompressor
+ * @param data  The bytes to append
+ * @param len   The number of bytes to append
+ * @return      true if the bytes were appended,
+ *              false if the buffer failed to be enlarged
+ */
+static bool rohc_decomp_journal_write(void *const priv,
+                                      const uint8_t *const data,
+                                      const size_t len)
+{
+	struct rohc_decomp *const decomp = priv;
+
+	if((decomp->journal_len + len) > decomp->journal_max_len)
+	{
+		size_t new_max_len = decomp->journal_max_len * 2;
+		uint8_t *new_buf;
+
+		while((decomp->journal_len + len) > new_max_len)
+		{
+			new_max_len *= 2;
+		}
+		new_buf = malloc(new_max_len);
+		if(new_buf == NULL)
+		{
+			return false;
+		}
+		memcpy(new_buf, decomp->journal_buf, decomp->journal_len);
+		free(decomp->journal_buf);
+		decomp->journal_buf = new_buf;
+		decomp->journal_max_len = new_max_len;
+	}
+	memcpy(decomp->journal_buf + decomp->journal_len, data, len);
+	decomp->journal_len += len;
+
+	return true;
+}
+
+
+/**
+ * @brief Read the next bytes of the journal record being applied
  *
- * @ingroup rohc_decomp
+ * @param priv  The journal record being applied
+ * @param data  OUT: The bytes read
+ * @param len   The number of bytes to read
+ * @return      true if the bytes were read,
+ *              false if the journal record is too short
+ */
+static bool rohc_decomp_journal_read(void *const priv,
+                                     uint8_t *const data,
+                                     const size_t len)
+{
+	struct rohc_decomp_journal_cursor *const cursor = priv;
+
+	if(len > (cursor->len - cursor->pos))
+	{
+		return false;
+	}
+	memcpy(data, cursor->data + cursor->pos, len);
+	cursor->pos += len;
+
+	return true;
+}
+
+
+/**
+ * @brief Build the feedback packet described by the given feedback intent
  *
- * \par Example:
- * \snippet example_rohc_decomp.c define ROHC decompressor
- * \code
-        ...
-\endcode
- * \snippet example_rohc_decomp.c enable ROHC decompression profile
- * \code
-        ...
-\endcode
+ * FEEDBACK-1 is used for positive ACKs if the Uncompressed profile is used or
+ * if a few SN bits are enough, FEEDBACK-2 is used otherwise. The feedback is
+ * not appended if the buffer is too small or if the budget of feedback bytes
+ * is exhausted.
  *
- * @see rohc_decomp_enable_profiles
- * @see rohc_decomp_disable_profile
- * @see rohc_decomp_disable_profiles
+ * @param decomp         The ROHC decompressor
+ * @param intent         The feedback to build
+ * @param[out] feedback  The buffer where to append the feedback
+ * @return               true if the feedback was successfully built
+ *                       (may be 0 byte), false if a problem occurred
  */
-bool rohc_decomp_enable_profile(struct rohc_decomp *const decomp,
-                                const rohc_profile_t profile)
+static bool rohc_decomp_build_feedback(struct rohc_decomp *const decomp,
+                                       const struct rohc_decomp_feedback_intent *const intent,
+                                       struct rohc_buf *const feedback)
 {
-	size_t i;
+	const char mode_short[ROHC_R_MODE + 1] = { '?', 'U', 'O', 'R' };
+	rohc_feedback_crc_t crc_present;
+	struct d_feedback sfeedback;
+	const uint8_t *feedbackp;
+	size_t feedbacksize;
+	size_t feedback_hdr_len;
+
+	/* FEEDBACK-1 or FEEDBACK-2 ? */
+	if(intent->ack_type == ROHC_FEEDBACK_ACK &&
+	   (intent->profile_id == ROHC_PROFILE_UNCOMPRESSED ||
+	    (!intent->do_change_mode && intent->sn_bits_nr != 0 &&
+	     intent->sn_bits_nr <= 8)))
+	{
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, intent->profile_id,
+		           "use FEEDBACK-1 as positive feedback");
+		f_feedback1(intent->sn_bits, &sfeedback);
+		crc_present = ROHC_FEEDBACK_WITH_NO_CRC;
+	}
+	else
+	{
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, intent->profile_id,
+		           "use FEEDBACK-2 as %s(%c) feedback",
+		           (intent->ack_type == ROHC_FEEDBACK_ACK ? "positive ACK" :
+		            (intent->ack_type == ROHC_FEEDBACK_NACK ? "NACK" :
+		             "STATIC-NACK")), mode_short[intent->mode]);
+		if(!f_feedback2(intent->profile_id, intent->ack_type, intent->mode,
+		                intent->sn_bits, intent->sn_bits_nr, &sfeedback))
+		{
+			rohc_warning(decomp, ROHC_TRACE_DECOMP, intent->profile_id,
+			             "failed to build the FEEDBACK-2");
+			goto error;
+		}
+
+		/* use CRC option if mode change requested */
+		if(intent->profile_id == ROHC_PROFILE_TCP)
+		{
+			crc_present = ROHC_FEEDBACK_WITH_CRC_BASE;
+		}
+		else if(intent->do_change_mode)
+		{
+			crc_present = ROHC_FEEDBACK_WITH_CRC_OPT;
+		}
+		else
+		{
+			crc_present = ROHC_FEEDBACK_WITH_NO_CRC;
+		}
+	}
 
-	if(decomp == NULL)
+	/* build the feedback packet */
+	feedbackp = f_wrap_feedback(&sfeedback, intent->cid, intent->cid_type,
+	                            crc_present, rohc_crc_table_8, &feedbacksize);
+	if(feedbackp == NULL)
 	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, intent->profile_id,
+		             "failed to wrap the feedback");
 		goto error;
 	}
 
-	/* search the profile location */
-	for(i = 0; i < D_NUM_PROFILES; i++)
+	/* copy the feedback to the buffer provided by the user */
+	feedback_hdr_len = 1 + (feedbacksize < 8 ? 0 : 1);
+	if((feedback->len + feedback_hdr_len + feedbacksize) >
+	   rohc_buf_avail_len(*feedback))
 	{
-		if(rohc_decomp_profiles[i]->id == profile)
-		{
-			/* found */
-			break;
-		}
+		/* no room left in the buffer provided by the user */
 	}
-
-	if(i == D_NUM_PROFILES)
+	else if(!rohc_decomp_feedback_budget_take(decomp,
+	                                          feedback_hdr_len + feedbacksize))
 	{
-		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-		             "unknown ROHC decompression profile (ID = %d)", profile);
-		goto error;
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, intent->profile_id,
+		           "do not build the %zu-byte feedback because the budget of "
+		           "%zu feedback bytes per second is exhausted",
+		           feedback_hdr_len + feedbacksize,
+		           decomp->feedback_budget.max_bytes);
+	}
+	else
+	{
+		if(feedbacksize < 8)
+		{
+			rohc_buf_byte_at(*feedback, feedback->len) = 0xf0 | feedbacksize;
+		}
+		else
+		{
+			rohc_buf_byte_at(*feedback, feedback->len) = 0xf0;
+			rohc_buf_byte_at(*feedback, feedback->len + 1) = feedbacksize;
+		}
+		feedback->len += feedback_hdr_len;
+		rohc_buf_append(feedback, feedbackp, feedbacksize);
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, intent->profile_id,
+		           "decompressor built a %zu-byte feedback",
+		           feedback_hdr_len + feedbacksize);
 	}
-
-	/* mark the profile as enabled */
-	decomp->enabled_profiles[i] = true;
-	rohc_info(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-	          "ROHC decompression profile (ID = %d) enabled", profile);
 
 	return true;
 
@@ -3374,249 +8192,265 @@ error:
 
 
 /**
- * @brief Disable a decompression profile for a decompressor
- *
- * Disable a decompression profiles for a decompressor.
- *
- * The ROHC decompressor does not use the decompression profiles that were
- * disabled. Thus disabling a profile might cause the decompressor to reject
- * streams. Decompression will always fail if no profile at all is enabled.
- *
- * If the profile is already disabled, nothing is performed and success is
- * reported.
+ * @brief Take the given number of bytes from the budget of feedback bytes
  *
- * @param decomp   The ROHC decompressor
- * @param profile  The profile to disable
- * @return         true if the profile exists,
- *                 false if the profile does not exist
+ * The budget is renewed every second, according to the arrival times of the
+ * ROHC packets.
  *
- * @ingroup rohc_decomp
- *
- * @see rohc_decomp_enable_profile
- * @see rohc_decomp_enable_profiles
- * @see rohc_decomp_disable_profiles
+ * @param decomp        The ROHC decompressor
+ * @param feedback_len  The length of the feedback to send
+ * @return              true if the feedback fits in the budget,
+ *                      false if the budget is exhausted
  */
-bool rohc_decomp_disable_profile(struct rohc_decomp *const decomp,
-                                 const rohc_profile_t profile)
+static bool rohc_decomp_feedback_budget_take(struct rohc_decomp *const decomp,
+                                             const size_t feedback_len)
 {
-	size_t i;
+	struct rohc_decomp_feedback_budget *const budget = &decomp->feedback_budget;
+	const struct rohc_ts now = decomp->feedback_coalescing.pkt_time;
 
-	if(decomp == NULL)
+	if(budget->max_bytes == 0)
 	{
-		goto error;
+		return true;
 	}
 
-	/* search the profile location */
-	for(i = 0; i < D_NUM_PROFILES; i++)
+	/* a packet older than the current second also starts a new second */
+	if(budget->bytes_nr == 0 ||
+	   rohc_time_interval(budget->window_start, now) >= 1000000U)
 	{
-		if(rohc_decomp_profiles[i]->id == profile)
-		{
-			/* found */
-			break;
-		}
+		budget->bytes_nr = 0;
+		budget->window_start = now;
 	}
-
-	if(i == D_NUM_PROFILES)
+	if(feedback_len > (budget->max_bytes - budget->bytes_nr))
 	{
-		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-		             "unknown ROHC decompression profile (ID = %d)", profile);
-		goto error;
+		return false;
 	}
-
-	/* mark the profile as disabled */
-	decomp->enabled_profiles[i] = false;
-	rohc_info(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-	          "ROHC decompression profile (ID = %d) disabled", profile);
+	budget->bytes_nr += feedback_len;
 
 	return true;
-
-error:
-	return false;
 }
 
 
 /**
- * @brief Enable several decompression profiles for a decompressor
- *
- * Enable several decompression profiles for a decompressor. The list of
- * profiles to enable shall stop with -1.
- *
- * The ROHC decompressor does not use the decompression profiles that are not
- * enabled. Thus not enabling a profile might cause the decompressor to reject
- * streams. Decompression will always fail if no profile at all is enabled.
+ * @brief Record one feedback intent for \ref rohc_decomp_flush_feedback
  *
- * If one or more of the profiles are already enabled, nothing is performed
- * and success is reported.
+ * The intent is dropped if the queue is full.
  *
  * @param decomp  The ROHC decompressor
- * @param ...     The sequence of decompression profiles to enable, the
- *                sequence shall be terminated by -1
- * @return        true if all of the profiles exist,
- *                false if at least one of the profiles does not exist
- *
- * @ingroup rohc_decomp
- *
- * \par Example:
- * \snippet example_rohc_decomp.c define ROHC decompressor
- * \code
-        ...
-\endcode
- * \snippet example_rohc_decomp.c enable ROHC decompression profiles
- * \code
-        ...
-\endcode
- *
- * @see rohc_decomp_enable_profile
- * @see rohc_decomp_disable_profile
- * @see rohc_decomp_disable_profiles
+ * @param intent  The feedback to build later
  */
-bool rohc_decomp_enable_profiles(struct rohc_decomp *const decomp,
-                                 ...)
+static void rohc_decomp_queue_feedback(struct rohc_decomp *const decomp,
+                                       const struct rohc_decomp_feedback_intent *const intent)
 {
-	va_list profiles;
-	int profile_id;
-	size_t err_nr = 0;
-	bool is_ok;
+	struct rohc_decomp_feedback_intents *const intents =
+		&decomp->feedback_intents;
+	const size_t head = intents->head;
+	const size_t tail = __atomic_load_n(&intents->tail, __ATOMIC_ACQUIRE);
 
-	if(decomp == NULL)
+	if((head - tail) >= ROHC_DECOMP_FEEDBACK_INTENTS_LEN)
 	{
-		goto error;
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, intent->profile_id,
+		             "queue of feedback intents is full, drop feedback for "
+		             "CID %zu", intent->cid);
+		intents->dropped_nr++;
+		return;
 	}
+	intents->intents[head & (ROHC_DECOMP_FEEDBACK_INTENTS_LEN - 1)] = *intent;
 
-	va_start(profiles, decomp);
+	/* publish the intent to rohc_decomp_flush_feedback() */
+	__atomic_store_n(&intents->head, head + 1, __ATOMIC_RELEASE);
+	rohc_debug(decomp, ROHC_TRACE_DECOMP, intent->profile_id,
+	           "feedback for CID %zu deferred", intent->cid);
+}
 
-	while((profile_id = va_arg(profiles, int)) >= 0)
+
+/**
+ * @brief Send the given feedback now or defer it
+ *
+ * @param decomp         The ROHC decompressor
+ * @param intent         The feedback to send
+ * @param[out] feedback  The buffer where to append the feedback (may be NULL)
+ * @return               true if the feedback was successfully built or
+ *                       deferred, false if a problem occurred
+ */
+static bool rohc_decomp_emit_feedback(struct rohc_decomp *const decomp,
+                                      const struct rohc_decomp_feedback_intent *const intent,
+                                      struct rohc_buf *const feedback)
+{
+	if((decomp->features & ROHC_DECOMP_FEATURE_DEFERRED_FEEDBACK) != 0)
 	{
-		is_ok = rohc_decomp_enable_profile(decomp, profile_id);
-		if(!is_ok)
-		{
-			err_nr++;
-		}
+		rohc_decomp_queue_feedback(decomp, intent);
+	}
+	else if(feedback == NULL)
+	{
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, intent->profile_id,
+		           "user choose not to use a feedback channel, do not build any "
+		           "feedback packet");
+	}
+	else if(!rohc_decomp_build_feedback(decomp, intent, feedback))
+	{
+		return false;
 	}
 
-	va_end(profiles);
-
-	return (err_nr == 0);
-
-error:
-	return false;
+	return true;
 }
 
 
 /**
- * @brief Disable several decompression profiles for a decompressor
- *
- * Disable several decompression profiles for a decompressor. The list of
- * profiles to disable shall stop with -1.
- *
- * The ROHC decompressor does not use the decompression profiles that were
- * disabled. Thus disabling a profile might cause the decompressor to reject
- * streams. Decompression will always fail if no profile at all is enabled.
- *
- * If one or more of the profiles are already disabled, nothing is performed
- * and success is reported.
- *
- * @param decomp  The ROHC decompressor
- * @param ...     The sequence of decompression profiles to disable, the
- *                sequence shall be terminated by -1
- * @return        true if all of the profiles exist,
- *                false if at least one of the profiles does not exist
+ * @brief Keep the given positive feedback in the coalescing window
  *
- * @ingroup rohc_decomp
+ * The positive feedback replaces the one that waits for the same context if
+ * any. If too many contexts wait for feedback, the window is closed first.
  *
- * @see rohc_decomp_enable_profile
- * @see rohc_decomp_enable_profiles
- * @see rohc_decomp_disable_profile
+ * @param decomp         The ROHC decompressor
+ * @param intent         The positive feedback to keep
+ * @param[out] feedback  The buffer where to append the feedback if the
+ *                       window is closed (may be NULL)
+ * @return               true if the feedback was successfully kept,
+ *                       false if a problem occurred
  */
-bool rohc_decomp_disable_profiles(struct rohc_decomp *const decomp,
-                                  ...)
+static bool rohc_decomp_coalesce_feedback(struct rohc_decomp *const decomp,
+                                          const struct rohc_decomp_feedback_intent *const intent,
+                                          struct rohc_buf *const feedback)
 {
-	va_list profiles;
-	int profile_id;
-	size_t err_nr = 0;
-	bool is_ok;
-
-	if(decomp == NULL)
-	{
-		goto error;
-	}
+	struct rohc_decomp_feedback_coalescing *const coalescing =
+		&decomp->feedback_coalescing;
+	size_t i;
 
-	va_start(profiles, decomp);
+	assert(intent->ack_type == ROHC_FEEDBACK_ACK);
 
-	while((profile_id = va_arg(profiles, int)) >= 0)
+	/* replace the older ACK of the context, but keep advertising the change
+	 * of mode if the older ACK had to */
+	for(i = 0; i < coalescing->pending_nr; i++)
 	{
-		is_ok = rohc_decomp_disable_profile(decomp, profile_id);
-		if(!is_ok)
+		struct rohc_decomp_feedback_intent *const pending = &coalescing->pending[i];
+
+		if(pending->cid == intent->cid)
 		{
-			err_nr++;
+			const bool do_change_mode =
+				!!(pending->do_change_mode || intent->do_change_mode);
+
+			rohc_debug(decomp, ROHC_TRACE_DECOMP, intent->profile_id,
+			           "positive feedback for CID %zu replaces the previous one",
+			           intent->cid);
+			*pending = *intent;
+			pending->do_change_mode = do_change_mode;
+			return true;
 		}
 	}
 
-	va_end(profiles);
+	/* close the window if no more context may wait */
+	if(coalescing->pending_nr >= ROHC_DECOMP_FEEDBACK_COALESCING_MAX &&
+	   !rohc_decomp_coalesce_flush(decomp, feedback))
+	{
+		return false;
+	}
 
-	return (err_nr == 0);
+	/* open the window with the first ACK */
+	if(coalescing->pending_nr == 0)
+	{
+		coalescing->pkts_nr = 0;
+		coalescing->first_time = coalescing->pkt_time;
+	}
+	coalescing->pending[coalescing->pending_nr] = *intent;
+	coalescing->pending_nr++;
+	rohc_debug(decomp, ROHC_TRACE_DECOMP, intent->profile_id,
+	           "positive feedback for CID %zu delayed (%zu contexts wait)",
+	           intent->cid, coalescing->pending_nr);
 
-error:
-	return false;
+	return true;
 }
 
 
 /**
- * @brief Set the callback function used to manage traces in decompressor
- *
- * Set the user-defined callback function used to manage traces in the
- * decompressor.
+ * @brief Forget the positive feedback that waits for the given context
  *
- * The function will be called by the ROHC library every time it wants to
- * print something related to decompression, from errors to debug. User may
- * thus decide what traces are interesting (filter on \e level, source
- * \e entity, or \e profile) and what to do with them (print on console,
- * storage in file, syslog...).
- *
- * @warning The callback can not be modified after library initialization
+ * @param decomp  The ROHC decompressor
+ * @param cid     The CID of the context
+ */
+static void rohc_decomp_coalesce_drop(struct rohc_decomp *const decomp,
+                                      const rohc_cid_t cid)
+{
+	struct rohc_decomp_feedback_coalescing *const coalescing =
+		&decomp->feedback_coalescing;
+	size_t i;
+
+	for(i = 0; i < coalescing->pending_nr; i++)
+	{
+		if(coalescing->pending[i].cid == cid)
+		{
+			coalescing->pending_nr--;
+			coalescing->pending[i] = coalescing->pending[coalescing->pending_nr];
+			break;
+		}
+	}
+}
+
+
+/**
+ * @brief Send the coalesced positive feedback if the window expired
  *
- * @param decomp     The ROHC decompressor
- * @param callback   Two possible cases:
- *                     \li The callback function used to manage traces
- *                     \li NULL to remove the previous callback
- * @param priv_ctxt  An optional private context, may be NULL
- * @return           true on success, false otherwise
+ * Called once per ROHC packet. All the positive ACKs that wait are sent
+ * together if the window reached its maximum number of packets or its
+ * maximum duration, or if coalescing was disabled.
  *
- * @ingroup rohc_decomp
+ * @param decomp         The ROHC decompressor
+ * @param[out] feedback  The buffer where to append the feedback (may be NULL)
+ * @return               true if the window was successfully handled,
+ *                       false if a problem occurred
  */
-bool rohc_decomp_set_traces_cb2(struct rohc_decomp *decomp,
-                                rohc_trace_callback2_t callback,
-                                void *const priv_ctxt)
+static bool rohc_decomp_coalesce_expire(struct rohc_decomp *const decomp,
+                                        struct rohc_buf *const feedback)
 {
-	/* check decompressor validity */
-	if(decomp == NULL)
+	struct rohc_decomp_feedback_coalescing *const coalescing =
+		&decomp->feedback_coalescing;
+
+	if(coalescing->pending_nr == 0)
 	{
-		/* cannot print a trace without a valid decompressor */
-		goto error;
+		return true;
 	}
 
-	/* refuse to set a new trace callback if decompressor is in use */
-	if(decomp->stats.received > 0)
+	/* is the window still open? */
+	coalescing->pkts_nr++;
+	if(coalescing->max_pkts > 0 && coalescing->pkts_nr < coalescing->max_pkts &&
+	   (coalescing->max_delay == 0 ||
+	    rohc_time_interval(coalescing->first_time, coalescing->pkt_time) <
+	    (coalescing->max_delay * 1000U)))
 	{
-		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL, "unable to "
-		           "modify the trace callback after initialization");
-		goto error;
+		return true;
 	}
 
-	/* replace current trace callback by the new one */
-	decomp->trace_callback = callback;
-	decomp->trace_callback_priv = priv_ctxt;
-
-	return true;
-
-error:
-	return false;
+	return rohc_decomp_coalesce_flush(decomp, feedback);
 }
 
 
-/*
- * Private functions
+/**
+ * @brief Send all the positive feedback that waits in the coalescing window
+ *
+ * @param decomp         The ROHC decompressor
+ * @param[out] feedback  The buffer where to append the feedback (may be NULL)
+ * @return               true if the feedback was successfully sent,
+ *                       false if a problem occurred
  */
+static bool rohc_decomp_coalesce_flush(struct rohc_decomp *const decomp,
+                                       struct rohc_buf *const feedback)
+{
+	struct rohc_decomp_feedback_coalescing *const coalescing =
+		&decomp->feedback_coalescing;
+	bool is_fine = true;
+	size_t i;
+
+	rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+	           "send the positive feedback of %zu contexts after %zu packets",
+	           coalescing->pending_nr, coalescing->pkts_nr);
+	for(i = 0; is_fine && i < coalescing->pending_nr; i++)
+	{
+		is_fine = rohc_decomp_emit_feedback(decomp, &coalescing->pending[i],
+		                                    feedback);
+	}
+	coalescing->pending_nr = 0;
+
+	return is_fine;
+}
 
 
 /**
@@ -3630,41 +8464,54 @@ error:
 static const struct rohc_decomp_profile * find_profile(const struct rohc_decomp *const decomp,
                                                        const rohc_profile_t profile_id)
 {
+	bool is_found = false;
 	size_t i;
 
 	assert(decomp != NULL);
 
-	/* search for the profile within the enabled profiles */
-	for(i = 0;
-	    i < D_NUM_PROFILES && rohc_decomp_profiles[i]->id != profile_id;
-	    i++)
+	/* search for the profile within the enabled profiles, in their order of
+	 * look up so that a registered profile takes precedence over the
+	 * built-in one */
+	for(i = 0; i < decomp->profiles_nr; i++)
 	{
+		const size_t idx = decomp->profiles_order[i];
+
+		if(decomp->profiles[idx]->id == profile_id)
+		{
+			if(decomp->enabled_profiles[idx])
+			{
+				return decomp->profiles[idx];
+			}
+			is_found = true;
+		}
 	}
 
-	if(i >= D_NUM_PROFILES)
+	if(!is_found)
 	{
 		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
 		             "decompression profile with ID 0x%04x not found",
 		             profile_id);
-		return NULL;
 	}
-
-	if(!decomp->enabled_profiles[i])
+	else
 	{
 		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
 		             "decompression profile with ID 0x%04x disabled",
 		             profile_id);
-		return NULL;
 	}
 
-	return rohc_decomp_profiles[i];
+	return NULL;
 }
 
 
 /**
- * @brief Decode the CID of a packet
+ * @brief Decode the CID of a packet for one type of CID
+ *
+ * The type of CID is a constant in the callers generated by
+ * \ref ROHC_DECOMP_DECODE_CID, so that the tests on the type of CID are
+ * resolved at compile time.
  *
  * @param decomp              The ROHC decompressor
+ * @param cid_type            The type of CID the decompressor uses
  * @param packet              The ROHC packet to extract CID from
  * @param len                 The size of the ROHC packet
  * @param[out] cid            The Context ID (CID) extracted from the ROHC packet
@@ -3672,12 +8519,13 @@ static const struct rohc_decomp_profile * find_profile(const struct rohc_decomp
  * @param[out] large_cid_len  The length of large CID in ROHC packet
  * @return                    true in case of success, false in case of failure
  */
-static bool rohc_decomp_decode_cid(struct rohc_decomp *decomp,
-                                   const uint8_t *packet,
-                                   unsigned int len,
-                                   rohc_cid_t *const cid,
-                                   size_t *const add_cid_len,
-                                   size_t *const large_cid_len)
+static inline bool rohc_decomp_decode_cid_tmpl(const struct rohc_decomp *const decomp,
+                                               const rohc_cid_type_t cid_type,
+                                               const uint8_t *packet,
+                                               size_t len,
+                                               rohc_cid_t *const cid,
+                                               size_t *const add_cid_len,
+                                               size_t *const large_cid_len)
 {
 	/* is feedback data is large enough to read add-CID or first byte
 	   of large CID ? */
@@ -3688,7 +8536,7 @@ static bool rohc_decomp_decode_cid(struct rohc_decomp *decomp,
 		goto error;
 	}
 
-	if(decomp->medium.cid_type == ROHC_SMALL_CID)
+	if(cid_type == ROHC_SMALL_CID)
 	{
 		/* small CID */
 		*large_cid_len = 0;
@@ -3710,7 +8558,7 @@ static bool rohc_decomp_decode_cid(struct rohc_decomp *decomp,
 			*add_cid_len = 1;
 		}
 	}
-	else if(decomp->medium.cid_type == ROHC_LARGE_CID)
+	else if(cid_type == ROHC_LARGE_CID)
 	{
 		uint32_t large_cid;
 		size_t large_cid_bits_nr;
@@ -3751,24 +8599,181 @@ error:
 }
 
 
+/**
+ * @brief Define the function that decodes the CID of a packet for one type
+ *        of CID
+ *
+ * @param name      The name of the function to define
+ * @param cid_type  The type of CID the function handles
+ */
+#define ROHC_DECOMP_DECODE_CID(name, cid_type) \
+	static bool name(const struct rohc_decomp *const decomp, \
+	                 const uint8_t *packet, \
+	                 size_t len, \
+	                 rohc_cid_t *const cid, \
+	                 size_t *const add_cid_len, \
+	                 size_t *const large_cid_len) \
+	{ \
+		return rohc_decomp_decode_cid_tmpl(decomp, cid_type, packet, len, cid, \
+		                                   add_cid_len, large_cid_len); \
+	}
+
+/** Decode the add-CID of a packet, if any */
+ROHC_DECOMP_DECODE_CID(rohc_decomp_decode_small_cid, ROHC_SMALL_CID)
+
+/** Decode the large CID of a packet */
+ROHC_DECOMP_DECODE_CID(rohc_decomp_decode_large_cid, ROHC_LARGE_CID)
+
+
+/**
+ * @brief Decode the small or large CID of a ROHC packet without any trace
+ *
+ * Decode the CID as \ref rohc_decomp_decode_cid_tmpl does, but without any trace
+ * and without any decompressor, so that the function may be used to classify
+ * packets before handing them to a decompressor.
+ *
+ * @param cid_type  The type of CIDs the ROHC channel uses
+ * @param packet    The ROHC packet to decode, without padding nor feedback
+ * @param len       The length of the ROHC packet
+ * @param[out] cid  The decoded CID
+ * @return          true if the CID was successfully decoded,
+ *                  false if the packet is malformed
+ */
+static bool rohc_decomp_peek_cid(const rohc_cid_type_t cid_type,
+                                 const uint8_t *const packet,
+                                 const size_t len,
+                                 rohc_cid_t *const cid)
+{
+	if(len < 1)
+	{
+		goto error;
+	}
+
+	if(cid_type == ROHC_SMALL_CID)
+	{
+		*cid = rohc_add_cid_decode(packet, len);
+		if((*cid) == UINT8_MAX)
+		{
+			*cid = 0;
+		}
+	}
+	else
+	{
+		uint32_t large_cid;
+		size_t large_cid_bits_nr;
+		size_t large_cid_len;
+
+		large_cid_len = sdvl_decode(packet + 1, len - 1, &large_cid,
+		                            &large_cid_bits_nr);
+		if(large_cid_len != 1 && large_cid_len != 2)
+		{
+			goto error;
+		}
+		*cid = large_cid & 0xffff;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+/**
+ * @brief Decode the CID of the given ROHC packet without any trace
+ *
+ * Padding is skipped. Feedback-only packets, packets that start with
+ * feedback and ROHC segments are not looked into.
+ *
+ * @param decomp       The ROHC decompressor
+ * @param rohc_packet  The ROHC packet
+ * @param[out] cid     The CID of the packet
+ * @return             true if the CID was decoded,
+ *                     false if the packet designates no context
+ */
+static bool rohc_decomp_peek_pkt_cid(const struct rohc_decomp *const decomp,
+                                     const struct rohc_buf rohc_packet,
+                                     rohc_cid_t *const cid)
+{
+	const uint8_t *walk;
+	size_t remain_len;
+
+	if(rohc_buf_is_malformed(rohc_packet))
+	{
+		goto error;
+	}
+	walk = rohc_buf_data(rohc_packet);
+	remain_len = rohc_packet.len;
+
+	/* skip padding, ignore feedback-only packets and segments */
+	while(remain_len > 0 && rohc_decomp_packet_is_padding(walk))
+	{
+		walk++;
+		remain_len--;
+	}
+	if(remain_len < 1 ||
+	   rohc_packet_is_feedback(walk[0]) ||
+	   rohc_decomp_packet_is_segment(walk))
+	{
+		goto error;
+	}
+
+	/* decode the small or large CID */
+	if(!rohc_decomp_peek_cid(decomp->medium.cid_type, walk, remain_len, cid))
+	{
+		goto error;
+	}
+	if((*cid) > decomp->medium.max_cid)
+	{
+		goto error;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
 /**
  * @brief Parse padding bits if some are present
  *
+ * Most ROHC packets carry no padding at all. Link layers that pad to fixed
+ * cells may however put many padding octets in front of the packets: they
+ * are skipped 8 bytes at a time.
+ *
  * @param decomp       The ROHC decompressor
  * @param packet       The ROHC packet to parse
  */
 static void rohc_decomp_parse_padding(const struct rohc_decomp *const decomp,
                                       struct rohc_buf *const packet)
 {
+	const uint64_t padding_word = 0xe0e0e0e0e0e0e0e0ULL; /* 8 padding octets */
+	const uint8_t *const data = rohc_buf_data(*packet);
 	size_t padding_length = 0;
 
-	/* remove all padded bytes */
-	while(packet->len > 0 &&
-	      rohc_decomp_packet_is_padding(rohc_buf_data(*packet)))
+	/* fast path: the first byte is already a feedback or a packet type */
+	if(packet->len == 0 || !rohc_decomp_packet_is_padding(data))
+	{
+		return;
+	}
+
+	/* remove all padded bytes, 8 bytes at a time, then one by one */
+	while((padding_length + sizeof(uint64_t)) <= packet->len)
+	{
+		uint64_t word;
+		memcpy(&word, data + padding_length, sizeof(uint64_t));
+		if(word != padding_word)
+		{
+			break;
+		}
+		padding_length += sizeof(uint64_t);
+	}
+	while(padding_length < packet->len &&
+	      rohc_decomp_packet_is_padding(data + padding_length))
 	{
-		rohc_buf_pull(packet, 1);
 		padding_length++;
 	}
+	rohc_buf_pull(packet, padding_length);
 	rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
 	           "skip %zu byte(s) of padding", padding_length);
 }
@@ -3864,8 +8869,14 @@ static rohc_status_t rohc_decomp_find_context(struct rohc_decomp *const decomp,
 		           "profile ID 0x%04x found in IR(-DYN) packet", *profile_id);
 	}
 
-	/* find the context associated with the CID */
+	/* find the context associated with the CID, the flow of the CID may come
+	 * back after its context went cold */
 	*context = find_context(decomp, cid);
+	if((*context) == NULL && !is_packet_ir && decomp->cold_ctxts_nr > 0 &&
+	   decomp->cold_ctxts[cid] != NULL)
+	{
+		*context = rohc_decomp_cold_revive(decomp, cid);
+	}
 	if((*context) == NULL)
 	{
 		/* the decompression context did not exist yet */
@@ -4063,8 +9074,16 @@ static bool rohc_decomp_parse_feedback(struct rohc_decomp *const decomp,
 		goto error;
 	}
 
-	/* copy the feedback item in order to return it user if he/she asked for */
-	if(feedback != NULL)
+	/* give the feedback item to the callback without any copy, or copy it
+	 * in order to return it user if he/she asked for */
+	if(decomp->feedback_cb != NULL)
+	{
+		struct rohc_buf feedback_item = *rohc_data;
+
+		feedback_item.len = *feedback_len;
+		decomp->feedback_cb(decomp->feedback_cb_priv, feedback_item);
+	}
+	else if(feedback != NULL)
 	{
 		if((feedback->len + (*feedback_len)) > rohc_buf_avail_len(*feedback))
 		{
@@ -4105,17 +9124,359 @@ static bool rohc_decomp_create_contexts(struct rohc_decomp *const decomp,
 	assert(max_cid <= ROHC_LARGE_CID_MAX);
 
 	/* allocate memory for the new context array */
-	decomp->contexts = calloc(max_cid + 1, sizeof(struct rohc_decomp_ctxt *));
+	decomp->contexts = rohc_alloc_calloc_node(max_cid + 1,
+	                                          sizeof(struct rohc_decomp_ctxt *),
+	                                          decomp->numa_node);
 	if(decomp->contexts == NULL)
 	{
 		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
 		             "cannot allocate memory for the contexts");
-		return false;
+		goto error;
+	}
+
+	/* allocate memory for the array of active contexts */
+	decomp->active_contexts =
+		rohc_alloc_calloc_node(max_cid + 1, sizeof(struct rohc_decomp_ctxt *),
+		                       decomp->numa_node);
+	if(decomp->active_contexts == NULL)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "cannot allocate memory for the active contexts");
+		goto free_contexts;
 	}
+	decomp->active_contexts_nr = 0;
+
 	rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
 	           "room for %zu decompression contexts created", max_cid + 1);
 
 	return true;
+
+free_contexts:
+	zfree(decomp->contexts);
+error:
+	return false;
+}
+
+
+/**
+ * @brief Destroy the arrays of decompression contexts
+ *
+ * The contexts themselves shall be destroyed first.
+ *
+ * @param decomp  The ROHC decompressor
+ */
+static void rohc_decomp_destroy_contexts(struct rohc_decomp *const decomp)
+{
+	zfree(decomp->active_contexts);
+	decomp->active_contexts_nr = 0;
+	zfree(decomp->contexts);
+}
+
+
+/**
+ * @brief Assign the CID of the given context to it
+ *
+ * The context replaces the context previously assigned to the same CID if
+ * any, and takes its place in the array of active contexts. It is appended
+ * to the array of active contexts otherwise. The cold context of the CID if
+ * any is dropped.
+ *
+ * @param decomp   The ROHC decompressor
+ * @param context  The context to assign to its CID
+ */
+static void rohc_decomp_assign_cid(struct rohc_decomp *const decomp,
+                                   struct rohc_decomp_ctxt *const context)
+{
+	struct rohc_decomp_ctxt *const old_context = decomp->contexts[context->cid];
+
+	assert(context->cid <= decomp->medium.max_cid);
+
+	if(decomp->cold_ctxts != NULL && decomp->cold_ctxts[context->cid] != NULL)
+	{
+		rohc_decomp_cold_drop(decomp, context->cid);
+	}
+
+	if(old_context != NULL)
+	{
+		assert(old_context->active_idx < decomp->active_contexts_nr);
+		assert(decomp->active_contexts[old_context->active_idx] == old_context);
+		context->active_idx = old_context->active_idx;
+		rohc_decomp_lru_del(decomp, old_context);
+		context_free(old_context);
+	}
+	else
+	{
+		assert(decomp->active_contexts_nr <= decomp->medium.max_cid);
+		context->active_idx = decomp->active_contexts_nr;
+		decomp->active_contexts_nr++;
+	}
+	decomp->active_contexts[context->active_idx] = context;
+	rohc_seqlock_write_begin(&decomp->stats_seq);
+	decomp->contexts[context->cid] = context;
+	rohc_seqlock_write_end(&decomp->stats_seq);
+	rohc_decomp_lru_add(decomp, context);
+}
+
+
+/**
+ * @brief Add a context at the head of the LRU list of contexts
+ *
+ * @param decomp   The ROHC decompressor
+ * @param context  The decompression context that was just used
+ */
+static void rohc_decomp_lru_add(struct rohc_decomp *const decomp,
+                                struct rohc_decomp_ctxt *const context)
+{
+	context->lru_prev = NULL;
+	context->lru_next = decomp->lru_head;
+	if(decomp->lru_head != NULL)
+	{
+		decomp->lru_head->lru_prev = context;
+	}
+	else
+	{
+		decomp->lru_tail = context;
+	}
+	decomp->lru_head = context;
+}
+
+
+/**
+ * @brief Remove a context from the LRU list of contexts
+ *
+ * @param decomp   The ROHC decompressor
+ * @param context  The decompression context to remove from the LRU list
+ */
+static void rohc_decomp_lru_del(struct rohc_decomp *const decomp,
+                                struct rohc_decomp_ctxt *const context)
+{
+	if(context->lru_prev != NULL)
+	{
+		context->lru_prev->lru_next = context->lru_next;
+	}
+	else
+	{
+		assert(decomp->lru_head == context);
+		decomp->lru_head = context->lru_next;
+	}
+	if(context->lru_next != NULL)
+	{
+		context->lru_next->lru_prev = context->lru_prev;
+	}
+	else
+	{
+		assert(decomp->lru_tail == context);
+		decomp->lru_tail = context->lru_prev;
+	}
+	context->lru_prev = NULL;
+	context->lru_next = NULL;
+}
+
+
+/**
+ * @brief Release the contexts that were not used for too long
+ *
+ * The idle contexts are the least recently used ones, so they are released
+ * from the tail of the LRU list until one context was used recently enough.
+ * Their CIDs are given back: the next packets for them are handled as if the
+ * contexts never existed, unless the contexts are revived from the cold
+ * store.
+ *
+ * @param decomp  The ROHC decompressor
+ * @param now     The arrival time of the packet being decompressed
+ */
+static void rohc_decomp_expire_idle(struct rohc_decomp *const decomp,
+                                    const struct rohc_ts now)
+{
+	while(decomp->lru_tail != NULL &&
+	      (decomp->lru_tail->latest_used + decomp->ctxt_idle_timeout) <= now.sec)
+	{
+		struct rohc_decomp_ctxt *const idle = decomp->lru_tail;
+		struct rohc_decomp_ctxt *const last_active =
+			decomp->active_contexts[decomp->active_contexts_nr - 1];
+
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, idle->profile->id,
+		           "release context with CID %zu unused for %zu seconds or more",
+		           idle->cid, decomp->ctxt_idle_timeout);
+
+		/* give the CID back, keep the active contexts packed */
+		assert(decomp->contexts[idle->cid] == idle);
+		rohc_seqlock_write_begin(&decomp->stats_seq);
+		decomp->contexts[idle->cid] = NULL;
+		rohc_seqlock_write_end(&decomp->stats_seq);
+		decomp->active_contexts[idle->active_idx] = last_active;
+		last_active->active_idx = idle->active_idx;
+		decomp->active_contexts_nr--;
+
+		rohc_decomp_lru_del(decomp, idle);
+		if(decomp->last_context == idle)
+		{
+			decomp->last_context = NULL;
+		}
+		rohc_decomp_cold_save(decomp, idle);
+		context_free(idle);
+	}
+}
+
+
+/**
+ * @brief Save an idle context in the cold store before it is released
+ *
+ * The context is saved in the format of snapshots. Nothing is saved if the
+ * cold store is disabled, if the profile cannot save its contexts, or if
+ * memory ran out.
+ *
+ * @param decomp   The ROHC decompressor
+ * @param context  The idle decompression context
+ */
+static void rohc_decomp_cold_save(struct rohc_decomp *const decomp,
+                                  const struct rohc_decomp_ctxt *const context)
+{
+	struct rohc_decomp_cold_ctxt *cold;
+	size_t profile_idx;
+
+	if((decomp->features & ROHC_DECOMP_FEATURE_COLD_CTXTS) == 0 ||
+	   decomp->cold_ctxts == NULL || context->profile->snapshot == NULL)
+	{
+		return;
+	}
+	assert(decomp->cold_ctxts[context->cid] == NULL);
+
+	/* save the context, then copy it in a cold context of the right size */
+	decomp->journal_len = 0;
+	if(!rohc_decomp_snapshot_ctxt(context, rohc_decomp_journal_write, decomp))
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, context->profile->id,
+		             "failed to save context with CID %zu in the cold store",
+		             context->cid);
+		return;
+	}
+	cold = malloc(sizeof(struct rohc_decomp_cold_ctxt) + decomp->journal_len);
+	if(cold == NULL)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, context->profile->id,
+		             "no memory to move context with CID %zu in the cold "
+		             "store", context->cid);
+		return;
+	}
+	profile_idx = rohc_decomp_get_profile_index(decomp, context->profile);
+	cold->profile_idx = profile_idx;
+	cold->len = decomp->journal_len;
+	memcpy(cold->record, decomp->journal_buf, cold->len);
+
+	decomp->cold_ctxts[context->cid] = cold;
+	decomp->cold_ctxts_nr++;
+	decomp->contexts_mem[profile_idx].bytes +=
+		sizeof(struct rohc_decomp_cold_ctxt) + cold->len;
+	decomp->contexts_mem_nr[profile_idx]++;
+
+	rohc_debug(decomp, ROHC_TRACE_DECOMP, context->profile->id,
+	           "context with CID %zu moved to the cold store in %zu bytes "
+	           "(%zu cold contexts)", context->cid, cold->len,
+	           decomp->cold_ctxts_nr);
+}
+
+
+/**
+ * @brief Revive the cold context of the given CID
+ *
+ * The cold context is dropped once revived, or if it cannot be revived.
+ *
+ * @param decomp  The ROHC decompressor
+ * @param cid     The CID of the cold context
+ * @return        The revived context,
+ *                NULL if the cold context does not match the decompressor
+ *                anymore
+ */
+static struct rohc_decomp_ctxt *
+	rohc_decomp_cold_revive(struct rohc_decomp *const decomp,
+	                        const rohc_cid_t cid)
+{
+	const struct rohc_decomp_cold_ctxt *const cold = decomp->cold_ctxts[cid];
+	struct rohc_decomp_journal_cursor cursor;
+	struct rohc_decomp_snapshot_ctxt record;
+
+	cursor.data = cold->record;
+	cursor.len = cold->len;
+	cursor.pos = 0;
+
+	/* the restored context takes the CID, so the cold context is dropped */
+	if(!rohc_decomp_journal_read(&cursor, (uint8_t *) &record,
+	                             sizeof(struct rohc_decomp_snapshot_ctxt)) ||
+	   !rohc_decomp_restore_ctxt(decomp, &record, rohc_decomp_journal_read,
+	                             &cursor))
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "failed to revive the cold context with CID %zu, drop it",
+		             cid);
+		rohc_decomp_cold_drop(decomp, cid);
+		goto error;
+	}
+	assert(decomp->cold_ctxts[cid] == NULL);
+	assert(decomp->contexts[cid] != NULL);
+
+	rohc_debug(decomp, ROHC_TRACE_DECOMP, decomp->contexts[cid]->profile->id,
+	           "context with CID %zu revived from the cold store", cid);
+
+	return decomp->contexts[cid];
+
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Remove the context of the given CID from the cold store
+ *
+ * @param decomp  The ROHC decompressor
+ * @param cid     The CID of the cold context
+ */
+static void rohc_decomp_cold_drop(struct rohc_decomp *const decomp,
+                                  const rohc_cid_t cid)
+{
+	struct rohc_decomp_cold_ctxt *const cold = decomp->cold_ctxts[cid];
+	struct rohc_ctxt_mem *const mem = &decomp->contexts_mem[cold->profile_idx];
+
+	assert(decomp->cold_ctxts_nr > 0);
+	assert(decomp->contexts_mem_nr[cold->profile_idx] > 0);
+	assert(mem->bytes >= (sizeof(struct rohc_decomp_cold_ctxt) + cold->len));
+	mem->bytes -= sizeof(struct rohc_decomp_cold_ctxt) + cold->len;
+	decomp->contexts_mem_nr[cold->profile_idx]--;
+	decomp->cold_ctxts_nr--;
+	decomp->cold_ctxts[cid] = NULL;
+	free(cold);
+}
+
+
+/**
+ * @brief Discard the Reconstructed Reception Unit (RRU) and its CRC
+ *
+ * @param decomp  The ROHC decompressor
+ */
+static inline void rohc_decomp_rru_reset(struct rohc_decomp *const decomp)
+{
+	decomp->rru_len = 0;
+	decomp->rru_crc = CRC_INIT_FCS32;
+	decomp->rru_crc_len = 0;
+}
+
+
+/**
+ * @brief Get the arrival time of the packet being decompressed
+ *
+ * @param decomp    The ROHC decompressor
+ * @param pkt_time  The arrival time given with the packet, 0 if unknown
+ * @return          The arrival time given with the packet if known, the time
+ *                  of the coarse clock otherwise (0 if there is none)
+ */
+static inline struct rohc_ts rohc_decomp_arrival_time(const struct rohc_decomp *const decomp,
+                                                      const struct rohc_ts pkt_time)
+{
+	if((pkt_time.sec != 0 || pkt_time.nsec != 0) || decomp->clock == NULL)
+	{
+		return pkt_time;
+	}
+	return (*decomp->clock);
 }
 
 
@@ -4188,3 +9549,26 @@ static bool rohc_decomp_packet_carry_crc_7_or_8(const rohc_packet_t packet_type)
 	return carry_crc_7_or_8;
 }
 
+
+/**
+ * @brief Is the context damaged by the latest decompression failures?
+ *
+ * The context is damaged if the last packet failed to be decompressed and if
+ * enough of the last 32 packets failed for a NACK to be sent, ie. if the
+ * context would already be in the Static Context state without the
+ * rate-limiting of the downward transitions. The CRC repair was already
+ * attempted on those failures.
+ *
+ * @param decomp   The ROHC decompressor
+ * @param context  The decompression context
+ * @return         true if the context is damaged, false if it is not
+ */
+static bool rohc_decomp_ctxt_is_damaged(const struct rohc_decomp *const decomp,
+                                        const struct rohc_decomp_ctxt *const context)
+{
+	const size_t errors_nr = __builtin_popcount(context->last_pkts_errors);
+
+	return ((context->last_pkts_errors & 1) != 0 &&
+	        errors_nr >= decomp->ack_rate_limits.nack.threshold);
+}
+
@@ -54,6 +54,20 @@ extern "C"
 
 struct rohc_decomp;
 
+/*
+ * Declare the private structure of a group of ROHC decompressors that is
+ * defined inside the library.
+ */
+
+struct rohc_decomp_group;
+
+/*
+ * Declare the private structure of a decompression profile that is defined
+ * inside the library.
+ */
+
+struct rohc_decomp_profile;
+
 
 
 /*
@@ -84,6 +98,38 @@ typedef enum
 } rohc_decomp_state_t;
 
 
+/**
+ * @brief The stages of the decompression of one packet
+ *
+ * The CPU cycles spent in every stage are accounted if the library was built
+ * with the --enable-stage-cycles option of the configure script. They can be
+ * retrieved with the function \ref rohc_decomp_get_stage_cycles.
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_get_stage_cycles
+ * @see rohc_decomp_get_stage_descr
+ */
+typedef enum
+{
+	/** Parse the ROHC header */
+	ROHC_DECOMP_STAGE_PARSE       = 0,
+	/** Decode the header fields from the bits extracted from the ROHC header */
+	ROHC_DECOMP_STAGE_DECODE      = 1,
+	/** Build the uncompressed headers (without the CRC check) */
+	ROHC_DECOMP_STAGE_BUILD_HDR   = 2,
+	/** Check the CRC of the IR header or of the uncompressed headers */
+	ROHC_DECOMP_STAGE_CRC         = 3,
+	/** Copy the payload after the uncompressed headers */
+	ROHC_DECOMP_STAGE_PAYLOAD     = 4,
+	/** Update the decompression context with the decoded values */
+	ROHC_DECOMP_STAGE_UPDATE_CTXT = 5,
+
+	ROHC_DECOMP_STAGE_MAX         = 6, /**< The number of decompression stages */
+
+} rohc_decomp_stage_t;
+
+
 /**
  * @brief Some information about the last decompressed packet
  *
@@ -182,6 +228,9 @@ typedef struct
  *  - Major 0 / Minor 0 contains: version_major, version_minor, packets_nr,
  *    comp_bytes_nr, uncomp_bytes_nr, corrected_crc_failures,
  *    corrected_sn_wraparounds, and corrected_wrong_sn_updates.
+ *  - Major 0 / Minor 1 added: skipped_crc_repairs
+ *  - Major 0 / Minor 2 added: packet_types_nr, crc_failures, and
+ *    avg_decode_cycles
  *
  * @ingroup rohc_decomp
  *
@@ -207,6 +256,21 @@ typedef struct
 	 *  failure */
 	unsigned long corrected_wrong_sn_updates;
 
+	/* added in 0.1 */
+	/** The number of CRC repairs skipped because the budget of repair attempts
+	 *  was exhausted */
+	unsigned long skipped_crc_repairs;
+
+	/* added in 0.2 */
+	/** The number of packets decoded by the context, successfully or not,
+	 *  indexed by packet type */
+	unsigned long packet_types_nr[ROHC_PACKET_MAX];
+	/** The number of packets that failed the CRC check */
+	unsigned long crc_failures;
+	/** The average number of CPU cycles spent to decode one packet, always 0
+	 *  if the library was built without the --enable-stage-cycles option */
+	unsigned long avg_decode_cycles;
+
 } __attribute__((packed)) rohc_decomp_context_info_t;
 
 
@@ -238,6 +302,9 @@ typedef struct
  * Supported versions:
  *  - major 0 and minor = 0 contains: version_major, version_minor,
  *    contexts_nr, packets_nr, comp_bytes_nr, and uncomp_bytes_nr.
+ *  - major 0 and minor = 1 added: corrected_crc_failures,
+ *    corrected_sn_wraparounds, and corrected_wrong_sn_updates.
+ *  - major 0 and minor = 2 added: skipped_crc_repairs.
  *
  * @ingroup rohc_decomp
  *
@@ -268,6 +335,11 @@ typedef struct
 	 *  upon CRC failure */
 	unsigned long corrected_wrong_sn_updates;
 
+	/* added in 0.2 */
+	/** The cumulative number of CRC repairs skipped because the budget of
+	 *  repair attempts was exhausted */
+	unsigned long skipped_crc_repairs;
+
 } __attribute__((packed)) rohc_decomp_general_info_t;
 
 
@@ -292,10 +364,98 @@ typedef enum
 	ROHC_DECOMP_FEATURE_COMPAT_1_6_x = (1 << 1),
 	/** Dump content of packets in traces (beware: performance impact) */
 	ROHC_DECOMP_FEATURE_DUMP_PACKETS = (1 << 3),
+	/** Defer the building of feedback to rohc_decomp_flush_feedback() */
+	ROHC_DECOMP_FEATURE_DEFERRED_FEEDBACK = (1 << 4),
+	/** Record the processing time of packets (see rohc_decomp_get_latency_stats()) */
+	ROHC_DECOMP_FEATURE_LATENCY      = (1 << 5),
+	/** Save the contexts released by the idle timeout in a cold store, and
+	 *  revive them when their CIDs are used again (see
+	 *  rohc_decomp_set_ctxt_idle_timeout()) */
+	ROHC_DECOMP_FEATURE_COLD_CTXTS   = (1 << 6),
+	/** Decompress the packets of one burst grouped by CID (see
+	 *  rohc_decompress_batch()) */
+	ROHC_DECOMP_FEATURE_GROUP_BY_CID = (1 << 7),
+	/** Never allocate memory while decompressing: the new contexts are only
+	 *  taken from the contexts prepared in advance (see
+	 *  rohc_decomp_prewarm_contexts()), the IR packets of the profiles that
+	 *  have no prepared context left are rejected */
+	ROHC_DECOMP_FEATURE_NO_ALLOC     = (1 << 8),
 
 } rohc_decomp_features_t;
 
 
+/**
+ * @brief The prototype of the callback for the journal of context updates
+ *
+ * The callback is called with one journal record every time the
+ * decompression of one ROHC packet updated one decompression context. The
+ * record shall be given to \ref rohc_decomp_journal_apply on the standby
+ * decompressor. The record is only valid during the call.
+ *
+ * @param priv        The private context given with the callback
+ * @param record      The journal record
+ * @param record_len  The length (in bytes) of the journal record
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_set_journal_cb
+ */
+typedef void (*rohc_decomp_journal_cb_t)(void *const priv,
+                                         const uint8_t *const record,
+                                         const size_t record_len);
+
+
+/**
+ * @brief The prototype of the callback for the received feedback
+ *
+ * The callback is called with every feedback item piggybacked in the ROHC
+ * packets, header and data included. The feedback item is not copied: it
+ * points into the ROHC packet given to \ref rohc_decompress3, so it is only
+ * valid during the call. It may be given as is to the same-side associated
+ * compressor with \ref rohc_comp_deliver_feedback2.
+ *
+ * @param priv      The private context given with the callback
+ * @param feedback  The feedback item received from the remote peer
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_set_feedback_cb
+ */
+typedef void (*rohc_decomp_feedback_cb_t)(void *const priv,
+                                          const struct rohc_buf feedback);
+
+
+/**
+ * @brief The prototype of the callback that finds the frames in a byte stream
+ *
+ * The callback is called with the first bytes of the stream that were not
+ * decompressed yet. It parses the framing of the link to find the first
+ * frame and the ROHC packet it carries. If the given bytes are not enough to
+ * know the length of the frame, the callback shall set \e frame_len to 0:
+ * it is called again once more bytes are received.
+ *
+ * @param priv              The private context given with the callback
+ * @param data              The first bytes of the stream
+ * @param data_len          The number of bytes (at least 1)
+ * @param[out] frame_len    The length of the first frame, framing included,
+ *                          0 if more bytes are required to find it
+ * @param[out] rohc_offset  The offset of the ROHC packet in the frame
+ * @param[out] rohc_len     The length of the ROHC packet
+ * @return                  true if the frame was found or more bytes are
+ *                          required, false if the stream is corrupted
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_set_stream_framing
+ */
+typedef bool (*rohc_decomp_frame_cb_t)(void *const priv,
+                                       const uint8_t *const data,
+                                       const size_t data_len,
+                                       size_t *const frame_len,
+                                       size_t *const rohc_offset,
+                                       size_t *const rohc_len);
+
+
 
 /*
  * Functions related to decompressor:
@@ -306,8 +466,18 @@ struct rohc_decomp * ROHC_EXPORT rohc_decomp_new2(const rohc_cid_type_t cid_type
                                                   const rohc_mode_t mode)
 	__attribute__((warn_unused_result));
 
+struct rohc_decomp * ROHC_EXPORT
+	rohc_decomp_new_on_node(const rohc_cid_type_t cid_type,
+	                        const rohc_cid_t max_cid,
+	                        const rohc_mode_t mode,
+	                        const int numa_node)
+	__attribute__((warn_unused_result));
+
 void ROHC_EXPORT rohc_decomp_free(struct rohc_decomp *const decomp);
 
+bool ROHC_EXPORT rohc_decomp_reset(struct rohc_decomp *const decomp)
+	__attribute__((warn_unused_result));
+
 rohc_status_t ROHC_EXPORT rohc_decompress3(struct rohc_decomp *const decomp,
                                            const struct rohc_buf rohc_packet,
                                            struct rohc_buf *const uncomp_packet,
@@ -315,6 +485,46 @@ rohc_status_t ROHC_EXPORT rohc_decompress3(struct rohc_decomp *const decomp,
                                            struct rohc_buf *const feedback_send)
 	__attribute__((warn_unused_result));
 
+bool ROHC_EXPORT rohc_decompress_batch(struct rohc_decomp *const decomp,
+                                       const struct rohc_buf rohc_packets[],
+                                       struct rohc_buf uncomp_packets[],
+                                       rohc_status_t statuses[],
+                                       const size_t pkts_nr,
+                                       struct rohc_buf *const rcvd_feedback,
+                                       struct rohc_buf *const feedback_send)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_decomp_prefetch(const struct rohc_decomp *const decomp,
+                                      const struct rohc_buf rohc_packet);
+
+rohc_status_t ROHC_EXPORT rohc_decompress_inplace(struct rohc_decomp *const decomp,
+                                                  struct rohc_buf *const packet,
+                                                  struct rohc_buf *const rcvd_feedback,
+                                                  struct rohc_buf *const feedback_send)
+	__attribute__((warn_unused_result));
+
+rohc_status_t ROHC_EXPORT rohc_decompress_header(struct rohc_decomp *const decomp,
+                                                 const struct rohc_buf rohc_packet,
+                                                 struct rohc_buf *const uncomp_header,
+                                                 size_t *const payload_offset,
+                                                 size_t *const payload_len,
+                                                 struct rohc_buf *const rcvd_feedback,
+                                                 struct rohc_buf *const feedback_send)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_decomp_set_stream_framing(struct rohc_decomp *const decomp,
+                                                rohc_decomp_frame_cb_t callback,
+                                                void *const priv,
+                                                const size_t max_frame_len)
+	__attribute__((warn_unused_result));
+
+rohc_status_t ROHC_EXPORT rohc_decompress_stream(struct rohc_decomp *const decomp,
+                                                 struct rohc_buf *const chunk,
+                                                 struct rohc_buf *const uncomp_packet,
+                                                 struct rohc_buf *const rcvd_feedback,
+                                                 struct rohc_buf *const feedback_send)
+	__attribute__((warn_unused_result));
+
 
 
 /*
@@ -328,6 +538,26 @@ bool ROHC_EXPORT rohc_decomp_get_general_info(const struct rohc_decomp *const de
                                               rohc_decomp_general_info_t *const info)
 	__attribute__((warn_unused_result));
 
+bool ROHC_EXPORT rohc_decomp_get_packet_stats(const struct rohc_decomp *const decomp,
+                                              rohc_packet_stats_t *const stats)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_decomp_get_latency_stats(const struct rohc_decomp *const decomp,
+                                               rohc_latency_stats_t *const stats)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_decomp_get_stage_cycles(const struct rohc_decomp *const decomp,
+                                              const rohc_decomp_stage_t stage,
+                                              uint64_t *const cycles)
+	__attribute__((warn_unused_result));
+
+const char * ROHC_EXPORT rohc_decomp_get_stage_descr(const rohc_decomp_stage_t stage)
+	__attribute__((warn_unused_result, const));
+
+bool ROHC_EXPORT rohc_decomp_get_memory_usage(const struct rohc_decomp *const decomp,
+                                              rohc_memory_usage_t *const mem)
+	__attribute__((warn_unused_result));
+
 bool ROHC_EXPORT rohc_decomp_get_context_info(const struct rohc_decomp *const decomp,
                                               const rohc_cid_t cid,
                                               rohc_decomp_context_info_t *const info)
@@ -386,12 +616,65 @@ bool ROHC_EXPORT rohc_decomp_get_rate_limits(const struct rohc_decomp *const dec
                                              size_t *const k_2, size_t *const n_2)
 	__attribute__((warn_unused_result));
 
+/* budgets of CRC repair attempts */
+
+bool ROHC_EXPORT rohc_decomp_set_crc_repair_budget(struct rohc_decomp *const decomp,
+                                                   const size_t ctxt_max,
+                                                   const size_t decomp_max,
+                                                   const size_t window)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_decomp_get_crc_repair_budget(const struct rohc_decomp *const decomp,
+                                                   size_t *const ctxt_max,
+                                                   size_t *const decomp_max,
+                                                   size_t *const window)
+	__attribute__((warn_unused_result));
+
+/* reorder window */
+
+bool ROHC_EXPORT rohc_decomp_set_reorder_window(struct rohc_decomp *const decomp,
+                                                const size_t window)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_decomp_get_reorder_window(const struct rohc_decomp *const decomp,
+                                                size_t *const window)
+	__attribute__((warn_unused_result));
+
+/* pool of released contexts */
+
+bool ROHC_EXPORT rohc_decomp_set_contexts_pool(struct rohc_decomp *const decomp,
+                                               const size_t contexts_nr)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_decomp_get_contexts_pool(const struct rohc_decomp *const decomp,
+                                               size_t *const contexts_nr)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_decomp_prewarm_contexts(struct rohc_decomp *const decomp,
+                                              const rohc_profile_t profile,
+                                              const size_t contexts_nr)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_decomp_set_ctxt_idle_timeout(struct rohc_decomp *const decomp,
+                                                   const size_t idle_timeout)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_decomp_set_clock(struct rohc_decomp *const decomp,
+                                       const struct rohc_ts *const clock)
+	__attribute__((warn_unused_result));
+
 /* decompression library features */
 
 bool ROHC_EXPORT rohc_decomp_set_features(struct rohc_decomp *const decomp,
                                           const rohc_decomp_features_t features)
 	__attribute__((warn_unused_result));
 
+bool ROHC_EXPORT rohc_decomp_set_recorder(struct rohc_decomp *const decomp,
+                                          const rohc_record_write_t write_cb,
+                                          void *const priv,
+                                          const size_t max_len)
+	__attribute__((warn_unused_result));
+
 
 /*
  * Functions related to decompression profiles
@@ -417,6 +700,11 @@ bool ROHC_EXPORT rohc_decomp_disable_profiles(struct rohc_decomp *const decomp,
                                               ...)
 	__attribute__((warn_unused_result));
 
+bool ROHC_EXPORT rohc_decomp_register_profile(struct rohc_decomp *const decomp,
+                                              const struct rohc_decomp_profile *const profile,
+                                              const int priority)
+	__attribute__((warn_unused_result));
+
 
 /*
  * Functions related to traces
@@ -427,6 +715,108 @@ bool ROHC_EXPORT rohc_decomp_set_traces_cb2(struct rohc_decomp *const decomp,
                                             void *const priv_ctxt)
 	__attribute__((warn_unused_result));
 
+bool ROHC_EXPORT rohc_decomp_set_trace_level(struct rohc_decomp *const decomp,
+                                             const rohc_trace_level_t level)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_decomp_set_trace_ring(struct rohc_decomp *const decomp,
+                                            const size_t records_nr)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_decomp_get_trace_records(const struct rohc_decomp *const decomp,
+                                               struct rohc_trace_record *const records,
+                                               const size_t max_nr,
+                                               size_t *const records_nr)
+	__attribute__((warn_unused_result));
+
+
+/*
+ * Functions related to groups of decompressors
+ */
+
+struct rohc_decomp_group * ROHC_EXPORT
+	rohc_decomp_group_new(const rohc_cid_type_t cid_type,
+	                      const rohc_cid_t max_cid,
+	                      const rohc_mode_t mode,
+	                      const size_t workers_nr)
+	__attribute__((warn_unused_result));
+
+void ROHC_EXPORT rohc_decomp_group_free(struct rohc_decomp_group *const group);
+
+struct rohc_decomp * ROHC_EXPORT
+	rohc_decomp_group_get_worker(const struct rohc_decomp_group *const group,
+	                             const size_t worker_idx)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_decomp_group_push(struct rohc_decomp_group *const group,
+                                        const struct rohc_buf rohc_packet)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT
+	rohc_decomp_group_decompress(struct rohc_decomp_group *const group,
+	                             const size_t worker_idx,
+	                             struct rohc_buf *const rohc_packet,
+	                             struct rohc_buf *const uncomp_packet,
+	                             struct rohc_buf *const rcvd_feedback,
+	                             rohc_status_t *const status)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT
+	rohc_decomp_group_pull_feedback(struct rohc_decomp_group *const group,
+	                                struct rohc_buf *const feedback)
+	__attribute__((warn_unused_result));
+
+
+
+/*
+ * Functions related to snapshots
+ */
+
+bool ROHC_EXPORT rohc_decomp_snapshot(const struct rohc_decomp *const decomp,
+                                      const rohc_snapshot_write_t write_cb,
+                                      void *const priv)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_decomp_restore(struct rohc_decomp *const decomp,
+                                     const rohc_snapshot_read_t read_cb,
+                                     void *const priv)
+	__attribute__((warn_unused_result));
+
+/*
+ * Functions related to deferred and coalesced feedback
+ */
+
+bool ROHC_EXPORT rohc_decomp_flush_feedback(struct rohc_decomp *const decomp,
+                                            struct rohc_buf *const feedback)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_decomp_set_feedback_coalescing(struct rohc_decomp *const decomp,
+                                                     const size_t max_pkts,
+                                                     const size_t max_delay)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_decomp_set_feedback_budget(struct rohc_decomp *const decomp,
+                                                 const size_t max_bytes)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_decomp_set_feedback_cb(struct rohc_decomp *const decomp,
+                                             rohc_decomp_feedback_cb_t callback,
+                                             void *const priv)
+	__attribute__((warn_unused_result));
+
+/*
+ * Functions related to the journal of context updates
+ */
+
+bool ROHC_EXPORT rohc_decomp_set_journal_cb(struct rohc_decomp *const decomp,
+                                            rohc_decomp_journal_cb_t callback,
+                                            void *const priv)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_decomp_journal_apply(struct rohc_decomp *const decomp,
+                                           const uint8_t *const record,
+                                           const size_t record_len)
+	__attribute__((warn_unused_result));
 
 #undef ROHC_EXPORT /* do not pollute outside this header */
 
@@ -41,6 +41,55 @@
 #define D_IR_DYN_PACKET  0xf8
 
 
+/** 16 entries of the same packet type in \ref rohc_decomp_rfc3095_pkt_types */
+#define RFC3095_PKT_TYPES_16(type) \
+	type, type, type, type, type, type, type, type, \
+	type, type, type, type, type, type, type, type
+
+
+/**
+ * @brief The packet types of RFC 3095 profiles, indexed by the first byte
+ *
+ * Built from the same magic bits as the rohc_decomp_packet_is_*() functions:
+ * UO-0 is 0xxxxxxx, UO-1* is 10xxxxxx, UOR-2* is 110xxxxx, IR-DYN is 0xf8
+ * and IR is 1111110x. Padding, feedback and segments are never seen there.
+ */
+const uint8_t rohc_decomp_rfc3095_pkt_types[256] =
+{
+	/* 0x00 to 0x7f: UO-0 */
+	RFC3095_PKT_TYPES_16(ROHC_PACKET_UO_0),
+	RFC3095_PKT_TYPES_16(ROHC_PACKET_UO_0),
+	RFC3095_PKT_TYPES_16(ROHC_PACKET_UO_0),
+	RFC3095_PKT_TYPES_16(ROHC_PACKET_UO_0),
+	RFC3095_PKT_TYPES_16(ROHC_PACKET_UO_0),
+	RFC3095_PKT_TYPES_16(ROHC_PACKET_UO_0),
+	RFC3095_PKT_TYPES_16(ROHC_PACKET_UO_0),
+	RFC3095_PKT_TYPES_16(ROHC_PACKET_UO_0),
+	/* 0x80 to 0xbf: UO-1* */
+	RFC3095_PKT_TYPES_16(ROHC_PACKET_UO_1),
+	RFC3095_PKT_TYPES_16(ROHC_PACKET_UO_1),
+	RFC3095_PKT_TYPES_16(ROHC_PACKET_UO_1),
+	RFC3095_PKT_TYPES_16(ROHC_PACKET_UO_1),
+	/* 0xc0 to 0xdf: UOR-2* */
+	RFC3095_PKT_TYPES_16(ROHC_PACKET_UOR_2),
+	RFC3095_PKT_TYPES_16(ROHC_PACKET_UOR_2),
+	/* 0xe0 to 0xef: padding and unused */
+	RFC3095_PKT_TYPES_16(ROHC_PACKET_UNKNOWN),
+	/* 0xf0 to 0xf7: feedback */
+	ROHC_PACKET_UNKNOWN, ROHC_PACKET_UNKNOWN, ROHC_PACKET_UNKNOWN,
+	ROHC_PACKET_UNKNOWN, ROHC_PACKET_UNKNOWN, ROHC_PACKET_UNKNOWN,
+	ROHC_PACKET_UNKNOWN, ROHC_PACKET_UNKNOWN,
+	/* 0xf8: IR-DYN */
+	ROHC_PACKET_IR_DYN,
+	/* 0xf9 to 0xfb: CCE of the UDP-Lite profile */
+	ROHC_PACKET_UNKNOWN, ROHC_PACKET_UNKNOWN, ROHC_PACKET_UNKNOWN,
+	/* 0xfc and 0xfd: IR */
+	ROHC_PACKET_IR, ROHC_PACKET_IR,
+	/* 0xfe and 0xff: segment */
+	ROHC_PACKET_UNKNOWN, ROHC_PACKET_UNKNOWN,
+};
+
+
 /**
  * @brief Find out whether the field is a segment field or not
  *
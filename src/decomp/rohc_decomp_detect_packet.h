@@ -35,6 +35,13 @@
 #  include <stdbool.h>
 #endif
 
+#include "rohc_packets.h"
+
+
+/** The packet types of RFC 3095 profiles, indexed by the first byte of the
+ *  ROHC packet (UO-1* and UOR-2* variants of the RTP profile excluded) */
+extern const uint8_t rohc_decomp_rfc3095_pkt_types[256];
+
 
 /*
  * Function prototypes.
@@ -72,5 +79,22 @@ bool rohc_decomp_packet_is_uor2_ts(const uint8_t *const data,
                                    const size_t large_cid_len)
 	__attribute__((warn_unused_result, nonnull(1), pure));
 
+
+/**
+ * @brief Find out the type of a ROHC packet for the RFC 3095 profiles
+ *
+ * The UO-1* and UOR-2* packets of the RTP profile are reported as UO-1 and
+ * UOR-2 packets, the profile shall then choose the right variant.
+ *
+ * @param data  The ROHC packet to analyze
+ * @param len   The length of the ROHC packet
+ * @return      The packet type, ROHC_PACKET_UNKNOWN if not recognized
+ */
+static inline rohc_packet_t rohc_decomp_packet_get_rfc3095_type(const uint8_t *const data,
+                                                                const size_t len)
+{
+	return (len > 0 ? rohc_decomp_rfc3095_pkt_types[data[0]] : ROHC_PACKET_UNKNOWN);
+}
+
 #endif
 
@@ -27,11 +27,17 @@
 #ifndef ROHC_DECOMP_INTERNALS_H
 #define ROHC_DECOMP_INTERNALS_H
 
+#include "config.h" /* for ROHC_WITH_PROFILE_* */
 #include "rohc_internal.h"
 #include "rohc_decomp.h"
 #include "rohc_traces_internal.h"
+#include "rohc_latency.h"
+#include "rohc_cycles.h"
 #include "feedback_create.h"
 #include "crc.h"
+#include "rohc_snapshot.h"
+#include "rohc_record.h"
+#include "rohc_seqlock.h"
 
 
 /*
@@ -39,8 +45,18 @@
  */
 
 
-/** The number of ROHC profiles ready to be used */
-#define D_NUM_PROFILES 7U
+/** The number of ROHC profiles ready to be used, ie. built in the library */
+#define D_NUM_PROFILES \
+	(0U + ROHC_WITH_PROFILE_UNCOMPRESSED + ROHC_WITH_PROFILE_RTP + \
+	 ROHC_WITH_PROFILE_UDP + ROHC_WITH_PROFILE_ESP + ROHC_WITH_PROFILE_IP + \
+	 ROHC_WITH_PROFILE_TCP + ROHC_WITH_PROFILE_UDPLITE)
+
+/** The max number of profiles that one decompressor accepts in addition to
+ *  the profiles built in the library (see rohc_decomp_register_profile) */
+#define ROHC_DECOMP_EXTRA_PROFILES_MAX  4U
+
+/** The max number of profiles of one decompressor */
+#define D_MAX_PROFILES  (D_NUM_PROFILES + ROHC_DECOMP_EXTRA_PROFILES_MAX)
 
 
 /** Print a warning trace for the given decompression context */
@@ -99,6 +115,22 @@ struct d_statistics
 	/** The cumulative number of successful corrections of incorrect SN updates
 	 *  upon CRC failure */
 	unsigned long corrected_wrong_sn_updates;
+	/** The cumulative number of CRC repairs skipped because the budget of
+	 *  repair attempts was exhausted */
+	unsigned long skipped_crc_repairs;
+	/** The counters of the decompressed packets, per profile and per
+	 *  packet type */
+	rohc_packet_stats_t pkt_stats;
+};
+
+
+/** The budget of CRC repair attempts for one time window */
+struct rohc_decomp_crc_repair_budget
+{
+	/** The number of repair attempts in the current time window */
+	size_t attempts_nr;
+	/** The beginning of the current time window */
+	struct rohc_ts window_start;
 };
 
 
@@ -112,7 +144,8 @@ struct rohc_ack_rate_limit
 {
 	size_t k;          /**< The k rate-limit parameter */
 	size_t n;          /**< The n rate-limit parameter */
-	size_t threshold;  /**< The computed k/n ratio */
+	size_t threshold;  /**< The computed k/n ratio, in packets out of the
+	                        last 32 packets */
 };
 
 
@@ -136,6 +169,99 @@ struct rohc_ack_stats
 };
 
 
+/** The number of feedback intents that may wait for
+ *  rohc_decomp_flush_feedback(), must be a power of 2 */
+#define ROHC_DECOMP_FEEDBACK_INTENTS_LEN 64U
+
+
+/** One feedback that the decompressor decided to send but did not build yet */
+struct rohc_decomp_feedback_intent
+{
+	rohc_cid_t cid;              /**< The CID of the context */
+	rohc_cid_type_t cid_type;    /**< The type of CID of the channel */
+	rohc_profile_t profile_id;   /**< The profile of the context */
+	enum rohc_feedback_ack_type ack_type; /**< ACK, NACK or STATIC-NACK */
+	rohc_mode_t mode;            /**< The mode of the context */
+	uint32_t sn_bits;            /**< The SN bits to acknowledge */
+	size_t sn_bits_nr;           /**< The number of SN bits to acknowledge */
+	bool do_change_mode;         /**< Whether the mode shall be advertised */
+};
+
+
+/**
+ * @brief The feedback intents waiting for rohc_decomp_flush_feedback()
+ *
+ * Single-producer, single-consumer ring: the decompression only writes
+ * \e head, rohc_decomp_flush_feedback() only writes \e tail.
+ */
+struct rohc_decomp_feedback_intents
+{
+	/** The index of the next slot to fill, written by the decompression only */
+	size_t head;
+	/** The index of the next slot to drain, written by the flush only */
+	size_t tail;
+	/** The number of intents dropped because the ring was full */
+	size_t dropped_nr;
+	/** The feedback intents */
+	struct rohc_decomp_feedback_intent intents[ROHC_DECOMP_FEEDBACK_INTENTS_LEN];
+};
+
+
+/** The max number of contexts that may wait for positive feedback in the
+ *  coalescing window */
+#define ROHC_DECOMP_FEEDBACK_COALESCING_MAX 32U
+
+
+/** The positive feedback kept until the coalescing window expires */
+struct rohc_decomp_feedback_coalescing
+{
+	/** The max number of ROHC packets in the window, 0 if disabled */
+	size_t max_pkts;
+	/** The max duration of the window (in milliseconds), 0 for no limit */
+	size_t max_delay;
+	/** The number of ROHC packets received since the window began */
+	size_t pkts_nr;
+	/** The arrival time of the packet that began the window */
+	struct rohc_ts first_time;
+	/** The arrival time of the ROHC packet being decompressed */
+	struct rohc_ts pkt_time;
+	/** The number of contexts that wait for positive feedback */
+	size_t pending_nr;
+	/** The latest positive feedback of every context that waits */
+	struct rohc_decomp_feedback_intent pending[ROHC_DECOMP_FEEDBACK_COALESCING_MAX];
+};
+
+
+/** The budget of feedback bytes for the feedback channel */
+struct rohc_decomp_feedback_budget
+{
+	/** The max number of feedback bytes per second, 0 for no limit */
+	size_t max_bytes;
+	/** The number of feedback bytes built in the current second */
+	size_t bytes_nr;
+	/** The beginning of the current second */
+	struct rohc_ts window_start;
+};
+
+
+/**
+ * @brief One decompression context of the cold store
+ *
+ * The context was idle for too long: it was saved in the format of
+ * snapshots, then released. It is revived if its CID is used again by a
+ * packet that is not an IR packet.
+ */
+struct rohc_decomp_cold_ctxt
+{
+	/** The index of the profile of the context */
+	size_t profile_idx;
+	/** The length (in bytes) of the saved context */
+	size_t len;
+	/** The saved context: one context record of a snapshot */
+	uint8_t record[];
+};
+
+
 /**
  * @brief The ROHC decompressor
  */
@@ -143,22 +269,90 @@ struct rohc_decomp
 {
 	/** The medium associated with the decompressor */
 	struct rohc_medium medium;
+	/** Decode the CID of one ROHC packet, selected for the type of CID of the
+	 *  medium */
+	bool (*decode_cid)(const struct rohc_decomp *const decomp,
+	                   const uint8_t *packet,
+	                   size_t len,
+	                   rohc_cid_t *const cid,
+	                   size_t *const add_cid_len,
+	                   size_t *const large_cid_len)
+		__attribute__((nonnull(1, 2, 4, 5, 6), warn_unused_result));
 
 	/** Enabled/disabled features for the decompressor */
 	rohc_decomp_features_t features;
 
+	/** The profiles of the decompressor: the profiles built in the library,
+	 *  then the profiles registered with \ref rohc_decomp_register_profile */
+	const struct rohc_decomp_profile *profiles[D_MAX_PROFILES];
+	/** The priorities of the registered profiles, indexed like the profiles */
+	int profiles_prio[D_MAX_PROFILES];
+	/** The number of profiles of the decompressor */
+	size_t profiles_nr;
+	/** The indexes of the profiles in the order they are looked up: the
+	 *  registered profiles by decreasing priority, then the built-in ones */
+	uint8_t profiles_order[D_MAX_PROFILES];
 	/** Which profiles are enabled and with one are not? */
-	bool enabled_profiles[D_NUM_PROFILES];
+	bool enabled_profiles[D_MAX_PROFILES];
 
 	/** The operation mode that the contexts shall target */
 	rohc_mode_t target_mode;
 
-	/** The array of decompression contexts that use the decompressor */
+	/** The array of decompression contexts that use the decompressor,
+	 *  indexed by CID */
 	struct rohc_decomp_ctxt **contexts;
+	/** The decompression contexts assigned to one CID, packed at the
+	 *  beginning of the array so that they may be walked without walking all
+	 *  the CIDs */
+	struct rohc_decomp_ctxt **active_contexts;
+	/** The number of decompression contexts in active_contexts */
+	size_t active_contexts_nr;
 	/** The number of decompression contexts in use */
 	size_t num_contexts_used;
 	/** The last decompression context used by the decompressor */
 	struct rohc_decomp_ctxt *last_context;
+	/** The most recently used context (head of the LRU list of contexts) */
+	struct rohc_decomp_ctxt *lru_head;
+	/** The least recently used context (tail of the LRU list of contexts) */
+	struct rohc_decomp_ctxt *lru_tail;
+	/** The time (in seconds) after which an unused context is released, 0
+	 *  to keep contexts until their CIDs are re-used by the compressor
+	 *  (see rohc_decomp_set_ctxt_idle_timeout) */
+	size_t ctxt_idle_timeout;
+	/** The coarse clock that gives the arrival time of the packets whose
+	 *  arrival time is unknown, NULL if none (see rohc_decomp_set_clock) */
+	const struct rohc_ts *clock;
+	/** The NUMA node of the contexts, ROHC_NUMA_NO_NODE for any node (see
+	 *  rohc_decomp_new_on_node) */
+	int numa_node;
+	/** The released decompression contexts kept for re-use, one list per
+	 *  profile (see rohc_decomp_set_contexts_pool) */
+	struct rohc_decomp_ctxt *contexts_pool[D_MAX_PROFILES];
+	/** The number of released decompression contexts kept for re-use */
+	size_t contexts_pool_nr;
+	/** The max number of released decompression contexts kept for re-use */
+	size_t contexts_pool_max;
+	/** The number of allocated contexts of every profile, in use or kept for
+	 *  re-use (see rohc_decomp_get_memory_usage) */
+	size_t contexts_mem_nr[D_MAX_PROFILES];
+	/** The memory used by the allocated contexts of every profile */
+	struct rohc_ctxt_mem contexts_mem[D_MAX_PROFILES];
+	/** The cold contexts indexed by CID, NULL if the cold store was never
+	 *  enabled (see ROHC_DECOMP_FEATURE_COLD_CTXTS) */
+	struct rohc_decomp_cold_ctxt **cold_ctxts;
+	/** The number of cold contexts */
+	size_t cold_ctxts_nr;
+
+	/** The bits extracted from the ROHC packet being decompressed, shared by
+	 *  all the contexts since only one packet is decompressed at a time */
+	void *extr_bits;
+	/** The profile that parsed the last ROHC packet in \e extr_bits */
+	const struct rohc_decomp_profile *extr_bits_profile;
+	/** The values decoded from the ROHC packet being decompressed, shared by
+	 *  all the contexts since only one packet is decompressed at a time */
+	void *decoded_values;
+	/** The sizes (in bytes) of \e extr_bits and \e decoded_values */
+	size_t per_pkt_data_size;
 
 
 	/* feedback-related variables */
@@ -173,37 +367,210 @@ struct rohc_decomp
 	uint32_t last_pkts_errors;
 	/** The informations for feedback rate-limiting */
 	struct rohc_ack_stats last_pkt_feedbacks[ROHC_FEEDBACK_RESERVED];
+	/** The feedback intents waiting to be built, see
+	 *  ROHC_DECOMP_FEATURE_DEFERRED_FEEDBACK */
+	struct rohc_decomp_feedback_intents feedback_intents;
+	/** The positive feedback kept until the coalescing window expires */
+	struct rohc_decomp_feedback_coalescing feedback_coalescing;
+	/** The budget of feedback bytes shared by all the contexts */
+	struct rohc_decomp_feedback_budget feedback_budget;
+	/** The callback function that receives the piggybacked feedback, NULL
+	 *  to copy it in the rcvd_feedback buffer (see rohc_decomp_set_feedback_cb) */
+	rohc_decomp_feedback_cb_t feedback_cb;
+	/** The private context of the feedback callback function */
+	void *feedback_cb_priv;
+
+
+	/* CRC repair-related variables */
+
+	/** The max number of repair attempts per context and time window */
+	size_t crc_repair_ctxt_max;
+	/** The max number of repair attempts per decompressor and time window */
+	size_t crc_repair_decomp_max;
+	/** The duration of the time window for repair attempts (in ms) */
+	size_t crc_repair_window;
+	/** The repair attempts performed by all the contexts */
+	struct rohc_decomp_crc_repair_budget crc_repair_budget;
+/** The max number of SN values a packet may come late within the reorder
+ *  window */
+#define ROHC_DECOMP_MAX_REORDER_WINDOW  64U
+	/** The max number of SN values a packet may come late to be decoded with
+	 *  ref -1 up front, 0 to wait for a CRC failure (see
+	 *  rohc_decomp_set_reorder_window) */
+	size_t reorder_window;
 
 
 	/* segment-related variables */
 
 /** The maximal value for MRRU */
 #define ROHC_MAX_MRRU 65535
-	/** The Reconstructed Reception Unit */
-	uint8_t rru[ROHC_MAX_MRRU];
+	/** The Reconstructed Reception Unit, allocated with MRRU bytes only when
+	 *  segmentation is enabled */
+	uint8_t *rru;
 	/** The length (in bytes) of the Reconstructed Reception Unit */
 	size_t rru_len;
+	/** The FCS-32 CRC of the first bytes of the RRU, computed segment after
+	 *  segment while the received bytes are in cache */
+	uint32_t rru_crc;
+	/** The number of bytes of the RRU covered by rru_crc: all but the last 4
+	 *  bytes received so far, that may be the CRC field */
+	size_t rru_crc_len;
 	/** The Maximum Reconstructed Reception Unit (MRRU) */
 	size_t mrru;
 
 
-	/* CRC-related variables: */
+	/* journal-related variables */
 
-	/** The table to enable fast CRC-3 computation */
-	uint8_t crc_table_3[256];
-	/** The table to enable fast CRC-7 computation */
-	uint8_t crc_table_7[256];
-	/** The table to enable fast CRC-8 computation */
-	uint8_t crc_table_8[256];
+	/** The callback function that receives the journal records, NULL if
+	 *  the journal is disabled (see rohc_decomp_set_journal_cb) */
+	rohc_decomp_journal_cb_t journal_cb;
+	/** The private context of the journal callback function */
+	void *journal_cb_priv;
+	/** The buffer in which one journal record is built, or one idle context
+	 *  is saved before it is copied in the cold store */
+	uint8_t *journal_buf;
+	/** The length (in bytes) of the journal record being built */
+	size_t journal_len;
+	/** The size (in bytes) of the buffer for journal records */
+	size_t journal_max_len;
+
+	/** The recorder of the inputs of the decompressor, see
+	 *  rohc_decomp_set_recorder() */
+	struct rohc_recorder recorder;
+
+
+	/* byte stream-related variables */
+
+	/** The callback function that finds the frames in the byte stream, NULL
+	 *  if not set (see rohc_decomp_set_stream_framing) */
+	rohc_decomp_frame_cb_t frame_cb;
+	/** The private context of the frame callback function */
+	void *frame_cb_priv;
+	/** The buffer for the frame that spans several chunks of the stream */
+	uint8_t *stream_buf;
+	/** The number of bytes of that frame received so far */
+	size_t stream_len;
+	/** The size (in bytes) of the buffer, the maximum length of one frame */
+	size_t stream_max_len;
 
 
 	/** Some statistics about the decompression processes */
 	struct d_statistics stats;
+	/** The sequence lock that lets other threads read the statistics of the
+	 *  decompressor and of its contexts while packets are decompressed */
+	rohc_seqlock_t stats_seq;
 
 	/** The callback function used to manage traces */
 	rohc_trace_callback2_t trace_callback;
 	/** The private context of the callback function used to manage traces */
 	void *trace_callback_priv;
+	/** The lowest level of the traces passed to the callback function */
+	rohc_trace_level_t trace_level;
+	/** The ring of binary trace records, disabled by default */
+	struct rohc_trace_ring trace_ring;
+
+	/** The histograms of the processing time of the decompressed packets,
+	 *  NULL until the \ref ROHC_DECOMP_FEATURE_LATENCY feature is enabled */
+	struct rohc_latency *latency;
+#ifdef ROHC_STAGE_CYCLES
+	/** The CPU cycles spent in every stage of the decompression */
+	ROHC_STAGE_CYCLES_DEFINE(ROHC_DECOMP_STAGE_MAX) stage_cycles;
+#endif
+};
+
+
+/** The number of ROHC packets that may wait for one worker of a group of
+ *  decompressors, must be a power of 2 */
+#define ROHC_DECOMP_GROUP_RING_LEN 256U
+
+/** The number of feedback packets that may wait in the outbound queue of one
+ *  worker of a group of decompressors, must be a power of 2 */
+#define ROHC_DECOMP_GROUP_FEEDBACK_LEN 32U
+
+/** The maximum length (in bytes) of one feedback packet generated by one
+ *  worker of a group of decompressors */
+#define ROHC_DECOMP_GROUP_FEEDBACK_SLOT_LEN 64U
+
+
+/**
+ * @brief The ROHC packets waiting for one worker of a group of decompressors
+ *
+ * Single-producer, single-consumer ring: the front-end only writes \e head,
+ * the worker only writes \e tail. The indexes are free-running, the slot of
+ * an index is given by masking it with ROHC_DECOMP_GROUP_RING_LEN - 1. The
+ * ring stores the descriptions of the packets, not their data.
+ */
+struct rohc_decomp_group_ring
+{
+	/** The index of the next slot to fill, written by the front-end only */
+	size_t head;
+	/** The index of the next slot to drain, written by the worker only */
+	size_t tail;
+	/** The ROHC packets waiting for the worker */
+	struct rohc_buf pkts[ROHC_DECOMP_GROUP_RING_LEN];
+};
+
+
+/** One feedback packet generated by one worker of a group of decompressors */
+struct rohc_decomp_group_feedback_slot
+{
+	/** The length of the feedback data */
+	size_t len;
+	/** The raw feedback data */
+	uint8_t data[ROHC_DECOMP_GROUP_FEEDBACK_SLOT_LEN];
+};
+
+
+/**
+ * @brief The feedback generated by one worker of a group of decompressors
+ *
+ * Single-producer, single-consumer ring: the worker only writes \e head,
+ * the consumer of the outbound feedback only writes \e tail.
+ */
+struct rohc_decomp_group_feedback_ring
+{
+	/** The index of the next slot to fill, written by the worker only */
+	size_t head;
+	/** The index of the next slot to drain, written by the consumer only */
+	size_t tail;
+	/** The feedback waiting to be sent */
+	struct rohc_decomp_group_feedback_slot slots[ROHC_DECOMP_GROUP_FEEDBACK_LEN];
+};
+
+
+/** One worker of a group of decompressors */
+struct rohc_decomp_group_worker
+{
+	/** The decompressor of the worker */
+	struct rohc_decomp *decomp;
+	/** The ROHC packets waiting to be decompressed by the worker */
+	struct rohc_decomp_group_ring pkts;
+	/** The feedback generated by the worker, waiting to be sent */
+	struct rohc_decomp_group_feedback_ring feedback;
+};
+
+
+/**
+ * @brief A group of ROHC decompressors that share one CID space
+ *
+ * Every worker is a complete ROHC decompressor that owns the CIDs equal to
+ * its index modulo the number of workers. The front-end decodes the CID of
+ * every ROHC packet and hands the packet to the worker that owns the CID,
+ * so the workers may be run on different cores without any lock.
+ */
+struct rohc_decomp_group
+{
+	/** The type of CIDs the ROHC channel uses */
+	rohc_cid_type_t cid_type;
+	/** The MAX_CID of the ROHC channel */
+	rohc_cid_t max_cid;
+	/** The number of workers in the group */
+	size_t workers_nr;
+	/** The workers of the group */
+	struct rohc_decomp_group_worker *workers;
+	/** The worker to look at first for outbound feedback, so that no worker
+	 *  starves the others */
+	size_t next_feedback_worker;
 };
 
 
@@ -226,14 +593,20 @@ struct rohc_decomp_crc_corr_ctxt
 	rohc_decomp_crc_corr_t algo;
 	/** Correction counter (see e and f in 5.3.2.2.4 of the RFC 3095) */
 	size_t counter;
-/** The number of last packets to record arrival times for */
-#define ROHC_MAX_ARRIVAL_TIMES  10U
-	/** The arrival times for the last packets */
-	struct rohc_ts arrival_times[ROHC_MAX_ARRIVAL_TIMES];
+#if ROHC_SMALL_CONTEXTS != 1
+	/* small contexts record no arrival times, so they cannot detect SN
+	 * wraparounds */
 	/** The number of arrival times in arrival_times */
 	size_t arrival_times_nr;
 	/** The index for the arrival time of the next packet */
 	size_t arrival_times_index;
+/** The number of last packets to record arrival times for */
+#define ROHC_MAX_ARRIVAL_TIMES  10U
+	/** The arrival times for the last packets */
+	struct rohc_ts arrival_times[ROHC_MAX_ARRIVAL_TIMES];
+#endif
+	/** The repair attempts performed by the context */
+	struct rohc_decomp_crc_repair_budget budget;
 };
 
 
@@ -243,46 +616,76 @@ struct rohc_decomp_crc
 	rohc_crc_type_t type;  /**< The type of CRC that protects the ROHC header */
 	uint8_t bits;          /**< The CRC bits found in ROHC header */
 	size_t bits_nr;        /**< The number of CRC bits found in ROHC header */
+	/** The length of the IR header up to the end of its static chain (large
+	 *  CID included), 0 if the profile does not tell */
+	size_t static_len;
 };
 
 
+#if ROHC_SMALL_CONTEXTS != 1
+
+/** The max length of the IR header part whose CRC may be cached */
+#define ROHC_DECOMP_IR_CRC_CACHE_MAX_LEN  128U
+
+/**
+ * @brief The CRC-8 of the IR header up to the end of the static chain
+ *
+ * The bytes of the IR headers of one context before the dynamic chain (CID,
+ * packet type, profile ID and static chain) do not change, so their CRC may
+ * be computed only once. The bytes are kept to check that the cached CRC
+ * still matches them, the CRC field excepted.
+ */
+struct rohc_decomp_ir_crc_cache
+{
+	/** The IR header bytes up to the end of the static chain */
+	uint8_t bytes[ROHC_DECOMP_IR_CRC_CACHE_MAX_LEN];
+	/** The number of cached IR header bytes, 0 if no CRC is cached */
+	size_t len;
+	/** The CRC-8 computed over the cached IR header bytes, with a zeroed
+	 *  CRC field */
+	uint8_t crc;
+};
+
+#endif
+
+
 /**
  * @brief The volatile part of the ROHC decompression context
  *
  * The volatile part of the ROHC decompression context lasts only one single
  * packet. Between two ROHC packets, the volatile part of the context is
  * erased.
+ *
+ * The profile-specific data for the bits extracted from the ROHC packet and
+ * for the values decoded from them are not part of the context: they are
+ * shared by all the contexts of the decompressor (see the extr_bits_size and
+ * decoded_values_size fields of the profiles).
  */
 struct rohc_decomp_volat_ctxt
 {
 	/** The CRC information extracted from the ROHC packet being parsed */
 	struct rohc_decomp_crc crc;
-
-	/** The profile-specific data for bits extracted from the ROHC packet,
-	 * defined by the profiles */
-	void *extr_bits;
-
-	/** The profile-specific data for values decoded from persistent context
-	 * and bits extracted from the ROHC packet, defined by the profiles */
-	void *decoded_values;
 };
 
 
 /**
  * @brief The ROHC decompression context
+ *
+ * The fields are ordered by access frequency: the first cache line holds
+ * the fields that every packet reads to be decoded, the second one holds the
+ * per-packet bookkeeping, and the rest is only used for CRC repair, for
+ * statistics or when the context is created or released.
  */
 struct rohc_decomp_ctxt
 {
-	/** The Context IDentifier (CID) */
-	rohc_cid_t cid;
-
-	/** The associated decompressor */
-	struct rohc_decomp *decompressor;
+	/* hot fields: read by every packet to be decoded */
 
 	/** The associated profile */
 	const struct rohc_decomp_profile *profile;
 	/** The persistent profile-specific data, defined by the profiles */
 	void *persist_ctxt;
+	/** The associated decompressor */
+	struct rohc_decomp *decompressor;
 	/** The volatile data, erased between two ROHC packets */
 	struct rohc_decomp_volat_ctxt volat_ctxt;
 
@@ -291,24 +694,22 @@ struct rohc_decomp_ctxt
 	/** The operation state in which the context operates */
 	rohc_decomp_state_t state;
 
-	/** Usage timestamp */
-	unsigned int latest_used;
-	/** Usage timestamp */
-	unsigned int first_used;
+	/** The Context IDentifier (CID) */
+	rohc_cid_t cid;
 
+	/** The type of the last decompressed ROHC packet */
+	rohc_packet_t packet_type;
 	/** Whether the last decompressed packets failed or not */
 	uint32_t last_pkts_errors;
-	/** The informations for feedback rate-limiting */
-	struct rohc_ack_stats last_pkt_feedbacks[ROHC_FEEDBACK_RESERVED];
-
-	/** The context for corrections upon CRC failure */
-	struct rohc_decomp_crc_corr_ctxt crc_corr;
 
-	/* below are some statistics */
+	/* warm fields: updated once by every packet */
 
-	/** The type of the last decompressed ROHC packet */
-	rohc_packet_t packet_type;
+	/** The informations for feedback rate-limiting */
+	struct rohc_ack_stats last_pkt_feedbacks[ROHC_FEEDBACK_RESERVED];
 
+	/* The number of received packets */
+	unsigned long num_recv_packets;
+#if ROHC_SMALL_CONTEXTS != 1
 	/** The average size of the uncompressed packets */
 	unsigned long total_uncompressed_size;
 	/** The average size of the compressed packets */
@@ -317,9 +718,23 @@ struct rohc_decomp_ctxt
 	unsigned long header_uncompressed_size;
 	/** The average size of the compressed headers */
 	unsigned long header_compressed_size;
+#endif
+
+	/** The number of (possible) lost packet(s) before last packet */
+	unsigned long nr_lost_packets;
+	/** The number of packet(s) before the last packet if late */
+	unsigned long nr_misordered_packets;
+	/** Is last packet a (possible) duplicated packet? */
+	bool is_duplicated;
+
+	/* cold fields: CRC repair, statistics and context management */
+
+	/** The context for corrections upon CRC failure */
+	struct rohc_decomp_crc_corr_ctxt crc_corr;
+
+#if ROHC_SMALL_CONTEXTS != 1
+	/* statistics, not kept by small contexts */
 
-	/* The number of received packets */
-	unsigned long num_recv_packets;
 	/** The number of successful corrections upon CRC failure */
 	unsigned long corrected_crc_failures;
 	/** The number of successful corrections of SN wraparound upon CRC failure */
@@ -327,13 +742,37 @@ struct rohc_decomp_ctxt
 	/** The number of successful corrections of incorrect SN updates upon CRC
 	 *  failure */
 	unsigned long corrected_wrong_sn_updates;
+	/** The number of CRC repairs skipped because the budget of repair
+	 *  attempts was exhausted */
+	unsigned long skipped_crc_repairs;
+	/** The number of packets decoded by the context, successfully or not,
+	 *  per packet type */
+	unsigned long packet_types_nr[ROHC_PACKET_MAX];
+	/** The number of packets that failed the CRC check */
+	unsigned long crc_failures;
+	/** The CPU cycles spent to decode the packets counted in
+	 *  \e packet_types_nr, only with the --enable-stage-cycles option */
+	uint64_t decode_cycles;
+
+	/** The CRC of the IR header up to the end of the static chain */
+	struct rohc_decomp_ir_crc_cache ir_crc_cache;
+#endif
 
-	/** The number of (possible) lost packet(s) before last packet */
-	unsigned long nr_lost_packets;
-	/** The number of packet(s) before the last packet if late */
-	unsigned long nr_misordered_packets;
-	/** Is last packet a (possible) duplicated packet? */
-	bool is_duplicated;
+	/** Usage timestamp */
+	unsigned int latest_used;
+	/** Usage timestamp */
+	unsigned int first_used;
+
+	/** The memory used by the context, profile-specific parts included */
+	struct rohc_ctxt_mem mem;
+	/** The next released context in the pool of the decompressor */
+	struct rohc_decomp_ctxt *pool_next;
+	/** The index of the context in the active contexts of the decompressor */
+	size_t active_idx;
+	/** The context used just before this one (LRU list of the decompressor) */
+	struct rohc_decomp_ctxt *lru_prev;
+	/** The context used just after this one (LRU list of the decompressor) */
+	struct rohc_decomp_ctxt *lru_next;
 };
 
 
@@ -346,6 +785,25 @@ typedef void (*rohc_decomp_free_context_t)(void *const persist_ctxt,
                                            const struct rohc_decomp_volat_ctxt *const volat_ctxt)
 	__attribute__((nonnull(2)));
 
+typedef void (*rohc_decomp_reset_context_t)(const struct rohc_decomp_ctxt *const context,
+                                            void *const persist_ctxt,
+                                            struct rohc_decomp_volat_ctxt *const volat_ctxt)
+	__attribute__((nonnull(1, 3)));
+
+typedef void (*rohc_decomp_get_mem_t)(const void *const persist_ctxt,
+                                      struct rohc_ctxt_mem *const mem)
+	__attribute__((nonnull(1, 2)));
+
+typedef bool (*rohc_decomp_snapshot_t)(const void *const persist_ctxt,
+                                      const rohc_snapshot_write_t write_cb,
+                                      void *const priv)
+	__attribute__((warn_unused_result, nonnull(2)));
+
+typedef bool (*rohc_decomp_restore_t)(void *const persist_ctxt,
+                                     const rohc_snapshot_read_t read_cb,
+                                     void *const priv)
+	__attribute__((warn_unused_result, nonnull(2)));
+
 typedef rohc_packet_t (*rohc_decomp_detect_pkt_type_t) (const struct rohc_decomp_ctxt *const context,
                                                         const uint8_t *const rohc_packet,
                                                         const size_t rohc_length,
@@ -377,6 +835,14 @@ typedef rohc_status_t (*rohc_decomp_build_hdrs_t)(const struct rohc_decomp *cons
                                                   size_t *const uncomp_hdrs_len)
 	__attribute__((warn_unused_result, nonnull(1, 2, 4, 5, 7, 8)));
 
+typedef rohc_status_t (*rohc_decomp_decode_normal_t)(const struct rohc_decomp_ctxt *const context,
+                                                     const struct rohc_buf rohc_packet,
+                                                     const size_t large_cid_len,
+                                                     struct rohc_buf *const uncomp_hdrs,
+                                                     size_t *const rohc_hdr_len,
+                                                     size_t *const uncomp_hdrs_len)
+	__attribute__((warn_unused_result, nonnull(1, 4, 5, 6)));
+
 typedef void (*rohc_decomp_update_ctxt_t)(struct rohc_decomp_ctxt *const context,
                                           const void *const decoded_values,
                                           const size_t payload_len,
@@ -398,7 +864,8 @@ typedef uint32_t (*rohc_decomp_get_sn_t)(const struct rohc_decomp_ctxt *const co
  * @brief The ROHC decompression profile.
  *
  * The object defines a ROHC profile. Each field must be filled in
- * for each new profile.
+ * for each new profile, except the optional reset_context, get_mem and
+ * decode_normal handlers.
  */
 struct rohc_decomp_profile
 {
@@ -408,6 +875,13 @@ struct rohc_decomp_profile
 	/** The maximum number of bits of the Master Sequence Number (MSN) */
 	const size_t msn_max_bits;
 
+	/** The size (in bytes) of the profile-specific data for bits extracted
+	 *  from one ROHC packet */
+	const size_t extr_bits_size;
+	/** The size (in bytes) of the profile-specific data for values decoded
+	 *  from persistent context and bits extracted from one ROHC packet */
+	const size_t decoded_values_size;
+
 	/** @brief The handler used to create the profile-specific part of the
 	 *         decompression context */
 	rohc_decomp_new_context_t new_context;
@@ -416,6 +890,16 @@ struct rohc_decomp_profile
 	 *         decompression context */
 	rohc_decomp_free_context_t free_context;
 
+	/** @brief The handler used to reset the profile-specific part of one
+	 *         released decompression context for re-use, NULL if the
+	 *         profile cannot re-use its contexts */
+	rohc_decomp_reset_context_t reset_context;
+
+	/** @brief The handler used to get the memory used by the profile-specific
+	 *         part of one decompression context, NULL if the profile
+	 *         allocates nothing for its contexts */
+	rohc_decomp_get_mem_t get_mem;
+
 	/** The handler used to detect the type of the ROHC packet */
 	rohc_decomp_detect_pkt_type_t detect_pkt_type;
 
@@ -428,6 +912,11 @@ struct rohc_decomp_profile
 	/* The handler used to build the uncompressed packet after decoding */
 	rohc_decomp_build_hdrs_t build_hdrs;
 
+	/** @brief The handler used to parse a Normal packet and build its
+	 *         uncompressed headers in one step, NULL if the profile has
+	 *         no Normal packet */
+	rohc_decomp_decode_normal_t decode_normal;
+
 	/* The handler used to update the context after successful decompression */
 	rohc_decomp_update_ctxt_t update_ctxt;
 
@@ -436,7 +925,37 @@ struct rohc_decomp_profile
 
 	/* The handler used to retrieve the Sequence Number (SN) */
 	rohc_decomp_get_sn_t get_sn;
+
+	/** @brief The handler used to write the profile-specific part of one
+	 *         decompression context in a snapshot, NULL if the profile
+	 *         cannot be saved */
+	rohc_decomp_snapshot_t snapshot;
+
+	/** @brief The handler used to restore the profile-specific part of one
+	 *         new decompression context from a snapshot, NULL if the
+	 *         profile cannot be restored */
+	rohc_decomp_restore_t restore;
 };
 
+
+/** The generic part of the record of one decompression context in a
+ *  snapshot, followed by the profile-specific part */
+struct rohc_decomp_snapshot_ctxt
+{
+	uint16_t profile_id;         /**< The profile of the context */
+	uint16_t cid;                /**< The CID of the context */
+	uint8_t mode;                /**< The operation mode of the context */
+	uint8_t state;               /**< The operation state of the context */
+	uint16_t reserved;           /**< Always 0 */
+	uint32_t last_pkts_errors;   /**< Whether the last packets failed or not */
+	uint32_t first_used;         /**< When the context was created */
+	uint32_t latest_used;        /**< When the context was last used */
+	uint64_t num_recv_packets;   /**< The number of received packets */
+	uint64_t total_uncompressed_size;   /**< The size of uncompressed packets */
+	uint64_t total_compressed_size;     /**< The size of compressed packets */
+	uint64_t header_uncompressed_size;  /**< The size of uncompressed headers */
+	uint64_t header_compressed_size;    /**< The size of compressed headers */
+} __attribute__((packed));
+
 #endif
 
@@ -0,0 +1,149 @@
+/*
+ * Copyright 2026 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   rohc_decomp_reader.h
+ * @brief  Read the fields of ROHC packets
+ * @author Didier Barvaux <didier@barvaux.org>
+ *
+ * The ROHC formats are fixed up to their variable parts: the parsers compute
+ * the length of one format from the flags they already read, check it once
+ * with \ref rohc_reader_has, then read the fields without any further check.
+ * The reads are only asserted in debug builds.
+ */
+
+#ifndef ROHC_DECOMP_READER_H
+#define ROHC_DECOMP_READER_H
+
+#include "rohc_utils.h"
+
+#ifndef __KERNEL__
+#  include <string.h>
+#endif
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <assert.h>
+
+
+/** The reader of the fields of one ROHC packet */
+struct rohc_reader
+{
+	const uint8_t *data;  /**< The next byte to read */
+	size_t len;           /**< The number of bytes left to read */
+	size_t read_len;      /**< The number of bytes already read */
+};
+
+
+/**
+ * @brief Start reading the given ROHC data
+ *
+ * @param[out] reader  The reader
+ * @param data         The ROHC data to read
+ * @param len          The length of the ROHC data
+ */
+static inline void rohc_reader_init(struct rohc_reader *const reader,
+                                    const uint8_t *const data,
+                                    const size_t len)
+{
+	reader->data = data;
+	reader->len = len;
+	reader->read_len = 0;
+}
+
+
+/**
+ * @brief Is there enough ROHC data left to read the given length?
+ *
+ * @param reader  The reader
+ * @param len     The length of the fields to read
+ * @return        true if the fields may be read without any further check,
+ *                false if the ROHC data is too short
+ */
+static inline bool rohc_reader_has(const struct rohc_reader *const reader,
+                                   const size_t len)
+{
+	return (reader->len >= len);
+}
+
+
+/**
+ * @brief Skip the given length of ROHC data
+ *
+ * @param reader  The reader, checked for the given length
+ * @param len     The length to skip
+ */
+static inline void rohc_reader_skip(struct rohc_reader *const reader,
+                                    const size_t len)
+{
+	assert(reader->len >= len);
+	reader->data += len;
+	reader->len -= len;
+	reader->read_len += len;
+}
+
+
+/**
+ * @brief Read one byte of ROHC data
+ *
+ * @param reader  The reader, checked for 1 byte
+ * @return        The byte
+ */
+static inline uint8_t rohc_reader_u8(struct rohc_reader *const reader)
+{
+	const uint8_t value = reader->data[0];
+
+	rohc_reader_skip(reader, 1);
+	return value;
+}
+
+
+/**
+ * @brief Read one 16-bit field of ROHC data in network byte order
+ *
+ * @param reader  The reader, checked for 2 bytes
+ * @return        The field in host byte order
+ */
+static inline uint16_t rohc_reader_u16(struct rohc_reader *const reader)
+{
+	uint16_t value;
+
+	assert(reader->len >= sizeof(uint16_t));
+	memcpy(&value, reader->data, sizeof(uint16_t));
+	rohc_reader_skip(reader, sizeof(uint16_t));
+	return rohc_ntoh16(value);
+}
+
+
+/**
+ * @brief Read one 32-bit field of ROHC data in network byte order
+ *
+ * @param reader  The reader, checked for 4 bytes
+ * @return        The field in host byte order
+ */
+static inline uint32_t rohc_reader_u32(struct rohc_reader *const reader)
+{
+	uint32_t value;
+
+	assert(reader->len >= sizeof(uint32_t));
+	memcpy(&value, reader->data, sizeof(uint32_t));
+	rohc_reader_skip(reader, sizeof(uint32_t));
+	return rohc_ntoh32(value);
+}
+
+#endif
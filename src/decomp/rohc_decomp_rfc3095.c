@@ -36,6 +36,7 @@
 #include "rohc_bit_ops.h"
 #include "rohc_decomp_internals.h"
 #include "rohc_decomp_detect_packet.h"
+#include "rohc_decomp_reader.h"
 #include "schemes/decomp_wlsb.h"
 #include "schemes/decomp_list_ipv6.h"
 #include "sdvl.h"
@@ -233,6 +234,32 @@ static bool parse_uor2ts_once(const struct rohc_decomp_ctxt *const context,
                               bool *const need_reparse)
 	__attribute__((warn_unused_result, nonnull(1, 2, 8, 9, 10, 11)));
 
+/** The function that parses one type of IR, IR-DYN or UO* packet */
+typedef bool (*rfc3095_parse_pkt_t)(const struct rohc_decomp_ctxt *const context,
+                                    const uint8_t *const rohc_packet,
+                                    const size_t rohc_length,
+                                    const size_t large_cid_len,
+                                    rohc_packet_t *const packet_type,
+                                    struct rohc_decomp_crc *const extr_crc,
+                                    struct rohc_extr_bits *const bits,
+                                    size_t *const rohc_hdr_len);
+
+/** The parsing functions indexed by packet type, NULL if not supported */
+static const rfc3095_parse_pkt_t rfc3095_parse_pkt_fcts[ROHC_PACKET_MAX] =
+{
+	[ROHC_PACKET_IR]        = parse_ir,
+	[ROHC_PACKET_IR_DYN]    = parse_irdyn,
+	[ROHC_PACKET_UO_0]      = parse_uo0,
+	[ROHC_PACKET_UO_1]      = parse_uo1,
+	[ROHC_PACKET_UO_1_RTP]  = parse_uo1rtp,
+	[ROHC_PACKET_UO_1_ID]   = parse_uo1id,
+	[ROHC_PACKET_UO_1_TS]   = parse_uo1ts,
+	[ROHC_PACKET_UOR_2]     = parse_uor2,
+	[ROHC_PACKET_UOR_2_RTP] = parse_uor2rtp,
+	[ROHC_PACKET_UOR_2_TS]  = parse_uor2ts,
+	[ROHC_PACKET_UOR_2_ID]  = parse_uor2id,
+};
+
 static bool parse_uo_remainder(const struct rohc_decomp_ctxt *const context,
                                const uint8_t *const rohc_packet,
                                const size_t rohc_length,
@@ -280,15 +307,19 @@ static bool build_uncomp_ip(const struct rohc_decomp_ctxt *const context,
                             const size_t uncomp_hdrs_max_len,
                             size_t *const uncomp_hdrs_len,
                             const size_t payload_size,
-                            const struct list_decomp *const list_decomp)
-	__attribute__((warn_unused_result, nonnull(1, 3, 5)));
+                            const struct list_decomp *const list_decomp,
+                            struct rohc_decomp_rfc3095_changes *const ip_changes,
+                            const bool ip_fields_changed)
+	__attribute__((warn_unused_result, nonnull(1, 3, 5, 8)));
 static bool build_uncomp_ipv4(const struct rohc_decomp_ctxt *const context,
                               const struct rohc_decoded_ip_values decoded,
                               uint8_t *const dest,
                               const size_t uncomp_hdrs_max_len,
                               size_t *const uncomp_hdrs_len,
-                              const size_t payload_size)
-	__attribute__((warn_unused_result, nonnull(1, 3, 5)));
+                              const size_t payload_size,
+                              struct rohc_decomp_rfc3095_changes *const ip_changes,
+                              const bool ip_fields_changed)
+	__attribute__((warn_unused_result, nonnull(1, 3, 5, 7)));
 static bool build_uncomp_ipv6(const struct rohc_decomp_ctxt *const context,
                               const struct rohc_decoded_ip_values decoded,
                               uint8_t *const dest,
@@ -298,6 +329,16 @@ static bool build_uncomp_ipv6(const struct rohc_decomp_ctxt *const context,
                               const struct list_decomp *const list_decomp)
 	__attribute__((warn_unused_result, nonnull(1, 3, 5, 7)));
 
+static rohc_status_t build_hdrs_from_tmpl(const struct rohc_decomp *const decomp,
+                                          const struct rohc_decomp_ctxt *const context,
+                                          const rohc_packet_t packet_type,
+                                          const struct rohc_decomp_crc *const extr_crc,
+                                          const struct rohc_decoded_values *const decoded,
+                                          const size_t payload_len,
+                                          struct rohc_buf *const uncomp_hdrs,
+                                          size_t *const uncomp_hdrs_len)
+	__attribute__((warn_unused_result, nonnull(1, 2, 4, 5, 7, 8)));
+
 
 /*
  * Private function prototypes for decoding the extracted bits
@@ -314,6 +355,11 @@ static bool decode_ip_values_from_bits(const struct rohc_decomp_ctxt *const cont
                                        struct rohc_decoded_ip_values *const decoded)
 	__attribute__((warn_unused_result, nonnull(1, 2, 3, 6, 7, 9)));
 
+static bool decode_bits_for_tmpl(const struct rohc_decomp_ctxt *const context,
+                                 const struct rohc_extr_bits *const bits,
+                                 struct rohc_decoded_values *const decoded)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+
 
 /*
  * Private function prototypes for miscellaneous functions
@@ -325,9 +371,11 @@ static bool check_uncomp_crc(const struct rohc_decomp *const decomp,
                              const uint8_t *const inner_ip_hdr,
                              const uint8_t *const next_header,
                              const rohc_crc_type_t crc_type,
-                             const uint8_t crc_packet)
+                             const uint8_t crc_packet,
+                             const bool crc_static_changed)
 	__attribute__((warn_unused_result, nonnull(1, 2, 3, 5)));
 
+#if ROHC_SMALL_CONTEXTS != 1
 static bool is_sn_wraparound(const struct rohc_ts cur_arrival_time,
                              const struct rohc_ts arrival_times[ROHC_MAX_ARRIVAL_TIMES],
                              const size_t arrival_times_nr,
@@ -335,11 +383,20 @@ static bool is_sn_wraparound(const struct rohc_ts cur_arrival_time,
                              const size_t k,
                              const rohc_lsb_shift_t p)
 	__attribute__((warn_unused_result, pure));
+#endif
 
 static void reset_extr_bits(const struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
                             struct rohc_extr_bits *const bits)
 	__attribute__((nonnull(1, 2)));
 
+static bool is_sn_late(const struct rohc_decomp_ctxt *const context,
+                       const struct rohc_extr_bits *const bits)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
+static void reset_extr_bits_uo0_fast(const struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
+                                     struct rohc_extr_bits *const bits)
+	__attribute__((nonnull(1, 2)));
+
 
 
 /*
@@ -371,7 +428,8 @@ bool rohc_decomp_rfc3095_create(const struct rohc_decomp_ctxt *const context,
 	struct rohc_decomp_rfc3095_ctxt *rfc3095_ctxt;
 
 	/* allocate memory for the generic context */
-	*persist_ctxt = malloc(sizeof(struct rohc_decomp_rfc3095_ctxt));
+	*persist_ctxt = rohc_alloc_malloc_node(sizeof(struct rohc_decomp_rfc3095_ctxt),
+	                                       context->decompressor->numa_node);
 	if((*persist_ctxt) == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -422,9 +480,11 @@ bool rohc_decomp_rfc3095_create(const struct rohc_decomp_ctxt *const context,
 	/* init the context used to compress the list of IPv6 extension headers
 	 * for the outer and inner IP headers */
 	rohc_decomp_list_ipv6_new(&rfc3095_ctxt->list_decomp1,
-	                          trace_cb, trace_cb_priv, profile_id);
+	                          trace_cb, trace_cb_priv,
+	                          context->decompressor->trace_level, profile_id);
 	rohc_decomp_list_ipv6_new(&rfc3095_ctxt->list_decomp2,
-	                          trace_cb, trace_cb_priv, profile_id);
+	                          trace_cb, trace_cb_priv,
+	                          context->decompressor->trace_level, profile_id);
 
 	/* no default next header */
 	rfc3095_ctxt->next_header_proto = 0;
@@ -436,27 +496,9 @@ bool rohc_decomp_rfc3095_create(const struct rohc_decomp_ctxt *const context,
 	/* volatile part of the decompression context */
 	volat_ctxt->crc.type = ROHC_CRC_TYPE_NONE;
 	volat_ctxt->crc.bits_nr = 0;
-	volat_ctxt->extr_bits = malloc(sizeof(struct rohc_extr_bits));
-	if(volat_ctxt->extr_bits == NULL)
-	{
-		rohc_decomp_warn(context, "failed to allocate memory for the volatile part "
-		                 "of one of the RFC3095 decompression context");
-		goto free_inner_ip_changes;
-	}
-	volat_ctxt->decoded_values = malloc(sizeof(struct rohc_decoded_values));
-	if(volat_ctxt->decoded_values == NULL)
-	{
-		rohc_decomp_warn(context, "failed to allocate memory for the volatile part "
-		                 "of one of the RFC3095 decompression context");
-		goto free_extr_bits;
-	}
 
 	return rfc3095_ctxt;
 
-free_extr_bits:
-	zfree(volat_ctxt->extr_bits);
-free_inner_ip_changes:
-	zfree(rfc3095_ctxt->inner_ip_changes);
 free_outer_ip_changes:
 	zfree(rfc3095_ctxt->outer_ip_changes);
 free_inner_ip_id_offset_ctxt:
@@ -480,12 +522,8 @@ quit:
  * @param volat_ctxt    The volatile part of the decompression context
  */
 void rohc_decomp_rfc3095_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
-                                 const struct rohc_decomp_volat_ctxt *const volat_ctxt)
+                                 const struct rohc_decomp_volat_ctxt *const volat_ctxt __attribute__((unused)))
 {
-	/* free the volatile part of the decompression context */
-	free(volat_ctxt->decoded_values);
-	free(volat_ctxt->extr_bits);
-
 	/* destroy Offset IP-ID decoding contexts */
 	ip_id_offset_free(rfc3095_ctxt->outer_ip_id_offset_ctxt);
 	ip_id_offset_free(rfc3095_ctxt->inner_ip_id_offset_ctxt);
@@ -507,6 +545,146 @@ void rohc_decomp_rfc3095_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_
 }
 
 
+/**
+ * @brief Get the memory used by the generic part of one context
+ *
+ * The profile-specific data are not accounted for, the profiles shall add
+ * them.
+ *
+ * @param rfc3095_ctxt  The generic decompression context
+ * @param[out] mem      The memory used by the generic part of the context
+ */
+void rohc_decomp_rfc3095_get_mem(const struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt __attribute__((unused)),
+                                 struct rohc_ctxt_mem *const mem)
+{
+	/* the LSB decoding contexts for the SN and the IP-IDs */
+	const size_t wlsb_bytes = rohc_lsb_get_mem_size() +
+	                          2 * ip_id_offset_get_mem_size();
+
+	mem->bytes = sizeof(struct rohc_decomp_rfc3095_ctxt) + wlsb_bytes +
+		2 * sizeof(struct rohc_decomp_rfc3095_changes);
+	mem->wlsb_bytes = wlsb_bytes;
+
+	/* the list decompressors are embedded in the context */
+	mem->lists_bytes = sizeof(struct list_decomp) * 2;
+}
+
+
+/**
+ * @brief Save the generic part of one RFC3095-based decompression context
+ *
+ * The sizes of the saved structures are written first, so that the
+ * restoration detects a snapshot written by another build of the library.
+ * The next header parameters and the handlers are set by the profile when
+ * the context is created, they are not saved. The templates of uncompressed
+ * headers are not saved either, they are rebuilt by the next packet.
+ *
+ * @param rfc3095_ctxt  The generic decompression context
+ * @param write_cb      The callback used to write the snapshot
+ * @param priv          The private context given to the callback
+ * @return              true if the context was successfully saved,
+ *                      false if the callback failed
+ */
+bool rohc_decomp_rfc3095_snapshot(const struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
+                                  const rohc_snapshot_write_t write_cb,
+                                  void *const priv)
+{
+	const uint32_t lens[2] = {
+		sizeof(struct rohc_decomp_rfc3095_changes), rohc_lsb_get_mem_size()
+	};
+
+	/* the LSB decoding contexts hold no pointer, the pointers of the IP
+	 * headers are not used once the context is updated */
+	return (write_cb(priv, (const uint8_t *) lens, sizeof(lens)) &&
+	        write_cb(priv, (const uint8_t *) &rfc3095_ctxt->multiple_ip,
+	                 sizeof(int)) &&
+	        write_cb(priv, (const uint8_t *) rfc3095_ctxt->outer_ip_changes,
+	                 lens[0]) &&
+	        write_cb(priv, (const uint8_t *) rfc3095_ctxt->inner_ip_changes,
+	                 lens[0]) &&
+	        write_cb(priv, (const uint8_t *) rfc3095_ctxt->sn_lsb_ctxt,
+	                 lens[1]) &&
+	        ip_id_offset_snapshot(rfc3095_ctxt->outer_ip_id_offset_ctxt,
+	                              write_cb, priv) &&
+	        ip_id_offset_snapshot(rfc3095_ctxt->inner_ip_id_offset_ctxt,
+	                              write_cb, priv) &&
+	        rohc_decomp_list_snapshot(&rfc3095_ctxt->list_decomp1,
+	                                  write_cb, priv) &&
+	        rohc_decomp_list_snapshot(&rfc3095_ctxt->list_decomp2,
+	                                  write_cb, priv));
+}
+
+
+/**
+ * @brief Restore the generic part of one RFC3095-based decompression context
+ *
+ * The objects allocated by \ref rohc_decomp_rfc3095_create and by the profile
+ * are kept, only their content is restored. The cached CRC-STATIC and
+ * the templates of uncompressed headers are invalidated.
+ *
+ * @param rfc3095_ctxt  The generic decompression context
+ * @param read_cb       The callback used to read the snapshot
+ * @param priv          The private context given to the callback
+ * @return              true if the context was successfully restored,
+ *                      false if the snapshot does not match or the callback
+ *                      failed
+ */
+bool rohc_decomp_rfc3095_restore(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
+                                 const rohc_snapshot_read_t read_cb,
+                                 void *const priv)
+{
+	struct rohc_decomp_rfc3095_changes *const ip_changes[2] = {
+		rfc3095_ctxt->outer_ip_changes, rfc3095_ctxt->inner_ip_changes
+	};
+	uint32_t lens[2];
+	size_t i;
+
+	if(!read_cb(priv, (uint8_t *) lens, sizeof(lens)) ||
+	   lens[0] != sizeof(struct rohc_decomp_rfc3095_changes) ||
+	   lens[1] != rohc_lsb_get_mem_size() ||
+	   !read_cb(priv, (uint8_t *) &rfc3095_ctxt->multiple_ip, sizeof(int)))
+	{
+		goto error;
+	}
+
+	for(i = 0; i < 2; i++)
+	{
+		struct ip_packet *const ip = &ip_changes[i]->ip;
+
+		if(!read_cb(priv, (uint8_t *) ip_changes[i], lens[0]) ||
+		   ip_changes[i]->next_header_len > ROHC_DECOMP_NEXT_HDR_MAX_LEN ||
+		   (ip->version != IP_UNKNOWN && ip->version != IPV4 &&
+		    ip->version != IPV6))
+		{
+			goto error;
+		}
+		ip->data = NULL;
+		ip->nh.data = NULL;
+		ip->nl.data = NULL;
+	}
+
+	if(!read_cb(priv, (uint8_t *) rfc3095_ctxt->sn_lsb_ctxt, lens[1]) ||
+	   !ip_id_offset_restore(rfc3095_ctxt->outer_ip_id_offset_ctxt,
+	                         read_cb, priv) ||
+	   !ip_id_offset_restore(rfc3095_ctxt->inner_ip_id_offset_ctxt,
+	                         read_cb, priv) ||
+	   !rohc_decomp_list_restore(&rfc3095_ctxt->list_decomp1, read_cb, priv) ||
+	   !rohc_decomp_list_restore(&rfc3095_ctxt->list_decomp2, read_cb, priv))
+	{
+		goto error;
+	}
+
+	memset(&rfc3095_ctxt->crc_static, 0, sizeof(struct rohc_crc_static_cache));
+	rfc3095_ctxt->hdrs_tmpl.len = 0;
+	rfc3095_ctxt->hdrs_tmpl_next.len = 0;
+
+	return true;
+
+error:
+	return false;
+}
+
+
 /**
  * @brief Parse one IR, IR-DYN, UO-0, UO-1*, or UOR-2* packet
  *
@@ -541,98 +719,156 @@ bool rfc3095_decomp_parse_pkt(const struct rohc_decomp_ctxt *const context,
                               struct rohc_extr_bits *const bits,
                               size_t *const rohc_hdr_len)
 {
+	const struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt =
+		context->persist_ctxt;
 	const uint8_t *const rohc_packet_data = rohc_buf_data(rohc_packet);
 	const size_t rohc_length = rohc_packet.len;
 
-	bool (*parse)(const struct rohc_decomp_ctxt *const _context,
-	              const uint8_t *const _rohc_packet,
-	              const size_t _rohc_length,
-	              const size_t _large_cid_len,
-	              rohc_packet_t *const _packet_type,
-	              struct rohc_decomp_crc *const _extr_crc,
-	              struct rohc_extr_bits *const _bits,
-	              size_t *const _rohc_hdr_len)
-		__attribute__((warn_unused_result, nonnull(1, 2, 5, 6, 7, 8)));
+	rfc3095_parse_pkt_t parse;
+	bool is_chains;
+	bool is_parsed;
 
 	assert(context != NULL);
 	assert(packet_type != NULL);
 	assert(bits != NULL);
 	assert(rohc_hdr_len != NULL);
 
+	is_chains = ((*packet_type) == ROHC_PACKET_IR ||
+	             (*packet_type) == ROHC_PACKET_IR_DYN);
+
 	/* what function to call for parsing the packet? */
-	switch(*packet_type)
+	assert((*packet_type) < ROHC_PACKET_MAX);
+	parse = rfc3095_parse_pkt_fcts[*packet_type];
+	if(parse == NULL)
 	{
-		case ROHC_PACKET_IR:
-		{
-			parse = parse_ir;
-			break;
-		}
-		case ROHC_PACKET_IR_DYN:
-		{
-			parse = parse_irdyn;
-			break;
-		}
-		case ROHC_PACKET_UO_0:
-		{
-			parse = parse_uo0;
-			break;
-		}
-		case ROHC_PACKET_UO_1:
-		{
-			parse = parse_uo1;
-			break;
-		}
-		case ROHC_PACKET_UO_1_RTP:
-		{
-			parse = parse_uo1rtp;
-			break;
-		}
-		case ROHC_PACKET_UO_1_ID:
-		{
-			parse = parse_uo1id;
-			break;
-		}
-		case ROHC_PACKET_UO_1_TS:
-		{
-			parse = parse_uo1ts;
-			break;
-		}
-		case ROHC_PACKET_UOR_2:
-		{
-			parse = parse_uor2;
-			break;
-		}
-		case ROHC_PACKET_UOR_2_RTP:
-		{
-			parse = parse_uor2rtp;
-			break;
-		}
-		case ROHC_PACKET_UOR_2_TS:
-		{
-			parse = parse_uor2ts;
-			break;
-		}
-		case ROHC_PACKET_UOR_2_ID:
-		{
-			parse = parse_uor2id;
-			break;
-		}
-		default:
-		{
-			rohc_decomp_warn(context, "unknown packet type (%d)", *packet_type);
-			goto error;
-		}
+		rohc_decomp_warn(context, "unknown packet type (%d)", *packet_type);
+		goto error;
+	}
+
+	/* the bits left by another profile may be anything, reset them all */
+	if(context->decompressor->extr_bits_profile != context->profile)
+	{
+		bits->dirty_groups = ROHC_EXTR_BITS_ALL;
 	}
 
 	/* let's parse the packet! */
-	return parse(context, rohc_packet_data, rohc_length, large_cid_len, packet_type,
-	             extr_crc, bits, rohc_hdr_len);
+	is_parsed = parse(context, rohc_packet_data, rohc_length, large_cid_len,
+	                  packet_type, extr_crc, bits, rohc_hdr_len);
+
+	/* record the groups of bits the packet may have written, even if parsing
+	 * failed halfway, so that the next reset clears them */
+	if(is_chains)
+	{
+		bits->dirty_groups |= ROHC_EXTR_BITS_CHAINS;
+	}
+	else if(bits->is_ext3)
+	{
+		bits->dirty_groups |= ROHC_EXTR_BITS_EXT3;
+	}
+	if(!is_parsed)
+	{
+		goto error;
+	}
+
+	/* UO* packets without extension 3 patch the template of headers if the
+	 * context holds one */
+	bits->use_hdrs_tmpl = (rfc3095_ctxt->hdrs_tmpl.len > 0 &&
+	                       (*packet_type) != ROHC_PACKET_IR &&
+	                       (*packet_type) != ROHC_PACKET_IR_DYN &&
+	                       !bits->is_ext3);
+
+	/* within the reorder window, the packets that seem to come late are
+	 * decoded with ref -1 up front instead of after one CRC failure */
+	if(!is_chains && context->decompressor->reorder_window > 0 &&
+	   context->crc_corr.algo == ROHC_DECOMP_CRC_CORR_SN_NONE &&
+	   is_sn_late(context, bits))
+	{
+		bits->is_sn_late = true;
+		bits->lsb_ref_type = ROHC_LSB_REF_MINUS_1;
+	}
+
+	return true;
 
 error:
 	return false;
 }
 
 
+/**
+ * @brief Whether the packet seems to come late within the reorder window
+ *
+ * The packet seems to come late if its SN decoded with ref -1 falls between
+ * ref -1 and ref 0, at most reorder_window SN values before ref 0, while its
+ * SN decoded with ref 0 is either the same one or does not fall within the
+ * reorder window after ref 0.
+ *
+ * @param context  The decompression context
+ * @param bits     The bits extracted from the UO* packet
+ * @return         true if the packet seems to come late,
+ *                 false if the packet shall be decoded with ref 0
+ */
+static bool is_sn_late(const struct rohc_decomp_ctxt *const context,
+                       const struct rohc_extr_bits *const bits)
+{
+	const struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt =
+		context->persist_ctxt;
+	const size_t window = context->decompressor->reorder_window;
+	const uint32_t sn_mask =
+		(context->profile->id == ROHC_PROFILE_ESP ? 0xffffffff : 0xffff);
+	uint32_t sn_ref_0;
+	uint32_t sn_ref_minus_1;
+	uint32_t sn_gap;
+	uint32_t sn_0;
+	uint32_t sn_minus_1;
+	uint32_t sn_late;
+
+	if(!bits->is_sn_enc || bits->sn_nr == 0)
+	{
+		return false;
+	}
+
+	/* ref -1 shall be older than ref 0 */
+	sn_ref_0 = rohc_lsb_get_ref(rfc3095_ctxt->sn_lsb_ctxt, ROHC_LSB_REF_0);
+	sn_ref_minus_1 = rohc_lsb_get_ref(rfc3095_ctxt->sn_lsb_ctxt,
+	                                  ROHC_LSB_REF_MINUS_1);
+	sn_gap = (sn_ref_0 - sn_ref_minus_1) & sn_mask;
+	if(sn_gap <= 1)
+	{
+		return false;
+	}
+
+	/* the SN decoded with ref -1 shall fall between ref -1 and ref 0 */
+	if(!rohc_lsb_decode(rfc3095_ctxt->sn_lsb_ctxt, ROHC_LSB_REF_MINUS_1, 0,
+	                    bits->sn, bits->sn_nr, rfc3095_ctxt->sn_lsb_p,
+	                    &sn_minus_1))
+	{
+		return false;
+	}
+	sn_late = (sn_ref_0 - sn_minus_1) & sn_mask;
+	if(sn_late == 0 || sn_late >= sn_gap || sn_late > window)
+	{
+		return false;
+	}
+
+	/* the SN decoded with ref 0 shall not be a likely SN after ref 0 */
+	if(!rohc_lsb_decode(rfc3095_ctxt->sn_lsb_ctxt, ROHC_LSB_REF_0, 0,
+	                    bits->sn, bits->sn_nr, rfc3095_ctxt->sn_lsb_p, &sn_0))
+	{
+		return false;
+	}
+	if(sn_0 != sn_minus_1 && ((sn_0 - sn_ref_0) & sn_mask) <= window)
+	{
+		return false;
+	}
+
+	rohc_decomp_debug(context, "packet seems to come late (SN 0x%x is %u "
+	                  "before ref 0 = 0x%x), decode it with ref -1 = 0x%x",
+	                  sn_minus_1, sn_late, sn_ref_0, sn_ref_minus_1);
+
+	return true;
+}
+
+
 /**
  * @brief Parse one IR packet
  *
@@ -861,6 +1097,10 @@ static bool parse_ir(const struct rohc_decomp_ctxt *const context,
 		*rohc_hdr_len += size;
 	}
 
+	/* the CRC of the IR header up to there may be re-used for the next IR
+	 * packets of the context */
+	extr_crc->static_len = *rohc_hdr_len;
+
 	/* decode the dynamic part of the ROHC packet */
 	if(dynamic_present)
 	{
@@ -1468,8 +1708,17 @@ static bool parse_uo0(const struct rohc_decomp_ctxt *const context,
 	rohc_remain_len = rohc_length;
 	*rohc_hdr_len = 0;
 
-	/* reset all extracted bits */
-	reset_extr_bits(rfc3095_ctxt, bits);
+	/* reset the extracted bits: if the template of headers is available, it
+	 * is patched and only the few bits that one UO-0 packet may carry are
+	 * reset */
+	if(rfc3095_ctxt->hdrs_tmpl.len > 0)
+	{
+		reset_extr_bits_uo0_fast(rfc3095_ctxt, bits);
+	}
+	else
+	{
+		reset_extr_bits(rfc3095_ctxt, bits);
+	}
 
 	/* check packet usage */
 	assert(context->state == ROHC_DECOMP_STATE_FC);
@@ -2234,6 +2483,7 @@ static bool parse_uo1id(const struct rohc_decomp_ctxt *const context,
 
 			case ROHC_EXT_3:
 			{
+				bits->is_ext3 = true;
 				/* decode the extension */
 				ext_size = rfc3095_ctxt->parse_ext3(context, rohc_remain_data,
 				                                    rohc_remain_len, *packet_type,
@@ -2756,6 +3006,7 @@ static bool parse_uor2(const struct rohc_decomp_ctxt *const context,
 
 			case ROHC_EXT_3:
 			{
+				bits->is_ext3 = true;
 				/* decode the extension */
 				ext_size = rfc3095_ctxt->parse_ext3(context, rohc_remain_data,
 				                                    rohc_remain_len, *packet_type,
@@ -3209,6 +3460,7 @@ static bool parse_uor2rtp_once(const struct rohc_decomp_ctxt *const context,
 
 			case ROHC_EXT_3:
 			{
+				bits->is_ext3 = true;
 				/* decode the extension */
 				ext_size = rfc3095_ctxt->parse_ext3(context, rohc_remain_data,
 				                                    rohc_remain_len, packet_type,
@@ -3675,6 +3927,7 @@ static bool parse_uor2id_once(const struct rohc_decomp_ctxt *const context,
 
 			case ROHC_EXT_3:
 			{
+				bits->is_ext3 = true;
 				/* decode the extension */
 				ext_size = rfc3095_ctxt->parse_ext3(context, rohc_remain_data,
 				                                    rohc_remain_len, packet_type,
@@ -4144,6 +4397,7 @@ static bool parse_uor2ts_once(const struct rohc_decomp_ctxt *const context,
 
 			case ROHC_EXT_3:
 			{
+				bits->is_ext3 = true;
 				/* decode the extension */
 				ext_size = rfc3095_ctxt->parse_ext3(context, rohc_remain_data,
 				                                    rohc_remain_len, packet_type,
@@ -4285,34 +4539,33 @@ static bool parse_uo_remainder(const struct rohc_decomp_ctxt *const context,
                                size_t *const rohc_hdr_len)
 {
 	const struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt = context->persist_ctxt;
-
-	/* remaining ROHC data not parsed yet and the length of the ROHC headers
-	   (will be computed during parsing) */
-	const uint8_t *rohc_remain_data;
-	size_t rohc_remain_len;
+	const bool is_outer_id_rnd = is_ipv4_rnd_pkt(&bits->outer_ip);
+	const bool is_inner_id_rnd =
+		(bits->multiple_ip && is_ipv4_rnd_pkt(&bits->inner_ip));
+	const size_t ip_ids_len =
+		(is_outer_id_rnd ? 2U : 0U) + (is_inner_id_rnd ? 2U : 0U);
+	struct rohc_reader reader;
 
 	assert(rohc_packet != NULL);
 	assert(bits != NULL);
 	assert(rohc_hdr_len != NULL);
 
-	rohc_remain_data = rohc_packet;
-	rohc_remain_len = rohc_length;
-	*rohc_hdr_len = 0;
+	rohc_reader_init(&reader, rohc_packet, rohc_length);
+
+	/* check if the ROHC packet is large enough to read the random IP-IDs */
+	if(!rohc_reader_has(&reader, ip_ids_len))
+	{
+		rohc_decomp_warn(context, "ROHC packet too small for random IP-ID bits "
+		                 "(len = %zu)", rohc_length);
+		goto error;
+	}
 
 	/* part 6: extract 16 outer IP-ID bits in case the outer IP-ID is random */
-	if(is_ipv4_rnd_pkt(&bits->outer_ip))
+	if(is_outer_id_rnd)
 	{
 		/* outer IP-ID is random, read its full 16-bit value and ignore any
 		   previous bits we may have read (they should be filled with zeroes) */
 
-		/* check if the ROHC packet is large enough to read the outer IP-ID */
-		if(rohc_remain_len < 2)
-		{
-			rohc_decomp_warn(context, "ROHC packet too small for random outer "
-			                 "IP-ID bits (len = %zu)", rohc_remain_len);
-			goto error;
-		}
-
 		/* sanity check: all bits that are above 16 bits should be zero */
 		if(bits->outer_ip.id_nr > 0 && bits->outer_ip.id != 0)
 		{
@@ -4322,7 +4575,7 @@ static bool parse_uo_remainder(const struct rohc_decomp_ctxt *const context,
 		}
 
 		/* retrieve the full outer IP-ID value */
-		bits->outer_ip.id = rohc_ntoh16(GET_NEXT_16_BITS(rohc_remain_data));
+		bits->outer_ip.id = rohc_reader_u16(&reader);
 		bits->outer_ip.id_nr = 16;
 		bits->outer_ip.is_id_enc = true;
 
@@ -4330,28 +4583,16 @@ static bool parse_uo_remainder(const struct rohc_decomp_ctxt *const context,
 		                  "with the ones found at the end of the UO* packet "
 		                  "(0x%x on %zd bits)", bits->outer_ip.id,
 		                  bits->outer_ip.id_nr);
-
-		rohc_remain_data += 2;
-		rohc_remain_len -= 2;
-		*rohc_hdr_len += 2;
 	}
 
 	/* parts 7 and 8: not supported */
 
 	/* part 9: extract 16 inner IP-ID bits in case the inner IP-ID is random */
-	if(bits->multiple_ip && is_ipv4_rnd_pkt(&bits->inner_ip))
+	if(is_inner_id_rnd)
 	{
 		/* inner IP-ID is random, read its full 16-bit value and ignore any
 		   previous bits we may have read (they should be filled with zeroes) */
 
-		/* check if the ROHC packet is large enough to read the inner IP-ID */
-		if(rohc_remain_len < 2)
-		{
-			rohc_decomp_warn(context, "ROHC packet too small for random inner "
-			                 "IP-ID bits (len = %zu)", rohc_remain_len);
-			goto error;
-		}
-
 		/* sanity check: all bits that are above 16 bits should be zero */
 		if(bits->inner_ip.id_nr > 0 && bits->inner_ip.id != 0)
 		{
@@ -4361,7 +4602,7 @@ static bool parse_uo_remainder(const struct rohc_decomp_ctxt *const context,
 		}
 
 		/* retrieve the full inner IP-ID value */
-		bits->inner_ip.id = rohc_ntoh16(GET_NEXT_16_BITS(rohc_remain_data));
+		bits->inner_ip.id = rohc_reader_u16(&reader);
 		bits->inner_ip.id_nr = 16;
 		bits->inner_ip.is_id_enc = true;
 
@@ -4369,10 +4610,6 @@ static bool parse_uo_remainder(const struct rohc_decomp_ctxt *const context,
 		                  "with the ones found at the end of the UO* packet "
 		                  "(0x%x on %zd bits)", bits->inner_ip.id,
 		                  bits->inner_ip.id_nr);
-
-		rohc_remain_data += 2;
-		rohc_remain_len -= 2;
-		*rohc_hdr_len += 2;
 	}
 
 	/* parts 10, 11 and 12: not supported */
@@ -4382,19 +4619,16 @@ static bool parse_uo_remainder(const struct rohc_decomp_ctxt *const context,
 	{
 		int size;
 
-		size = rfc3095_ctxt->parse_uo_remainder(context, rohc_remain_data,
-		                                        rohc_remain_len, bits);
+		size = rfc3095_ctxt->parse_uo_remainder(context, reader.data, reader.len,
+		                                        bits);
 		if(size < 0)
 		{
 			rohc_decomp_warn(context, "cannot decode the remainder of UO* packet");
 			goto error;
 		}
-#ifndef __clang_analyzer__ /* silent warning about dead in/decrement */
-		rohc_remain_data += size;
-		rohc_remain_len -= size;
-#endif
-		*rohc_hdr_len += size;
+		rohc_reader_skip(&reader, size);
 	}
+	*rohc_hdr_len = reader.read_len;
 
 	/* sanity checks */
 	assert((*rohc_hdr_len) <= rohc_length);
@@ -4968,6 +5202,9 @@ rohc_status_t rfc3095_decomp_build_hdrs(const struct rohc_decomp *const decomp,
                                         size_t *const uncomp_hdrs_len)
 {
 	struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt = context->persist_ctxt;
+	const bool crc_static_changed = (packet_type == ROHC_PACKET_IR ||
+	                                 packet_type == ROHC_PACKET_IR_DYN ||
+	                                 decoded->is_ext3);
 	uint8_t *uncomp_hdrs_data = rohc_buf_data(*uncomp_hdrs);
 	size_t uncomp_hdrs_max_len = rohc_buf_avail_len(*uncomp_hdrs);
 	uint8_t *outer_ip_hdr;
@@ -4977,6 +5214,14 @@ rohc_status_t rfc3095_decomp_build_hdrs(const struct rohc_decomp *const decomp,
 
 	*uncomp_hdrs_len = 0;
 
+	/* UO* packets without extension 3 patch the template of headers */
+	if(decoded->use_hdrs_tmpl)
+	{
+		return build_hdrs_from_tmpl(decomp, context, packet_type, extr_crc,
+		                            decoded, payload_len, uncomp_hdrs,
+		                            uncomp_hdrs_len);
+	}
+
 	/* build the IP headers */
 	if(decoded->multiple_ip)
 	{
@@ -5013,15 +5258,16 @@ rohc_status_t rfc3095_decomp_build_hdrs(const struct rohc_decomp *const decomp,
 		                  "header = %zd bytes", inner_ip_ext_hdrs_len);
 		ip_payload_len += inner_ip_ext_hdrs_len;
 
-		rohc_decomp_debug(context, "length of transport header = %u bytes",
-		                  rfc3095_ctxt->outer_ip_changes->next_header_len);
-		ip_payload_len += rfc3095_ctxt->outer_ip_changes->next_header_len;
+		rohc_decomp_debug(context, "length of transport header = %zu bytes",
+		                  decoded->next_header_len);
+		ip_payload_len += decoded->next_header_len;
 		ip_payload_len += payload_len;
 
 		/* build the outer IP header */
 		if(!build_uncomp_ip(context, decoded->outer_ip, uncomp_hdrs_data,
 		                    uncomp_hdrs_max_len, &outer_ip_hdr_len,
-		                    ip_payload_len, &rfc3095_ctxt->list_decomp1))
+		                    ip_payload_len, &rfc3095_ctxt->list_decomp1,
+		                    rfc3095_ctxt->outer_ip_changes, crc_static_changed))
 		{
 			rohc_decomp_warn(context, "failed to build the outer IP header");
 			goto error_output_too_small;
@@ -5036,7 +5282,8 @@ rohc_status_t rfc3095_decomp_build_hdrs(const struct rohc_decomp *const decomp,
 		ip_payload_len -= inner_ip_hdr_len + inner_ip_ext_hdrs_len;
 		if(!build_uncomp_ip(context, decoded->inner_ip, uncomp_hdrs_data,
 		                    uncomp_hdrs_max_len, &inner_ip_hdr_len,
-		                    ip_payload_len, &rfc3095_ctxt->list_decomp2))
+		                    ip_payload_len, &rfc3095_ctxt->list_decomp2,
+		                    rfc3095_ctxt->inner_ip_changes, crc_static_changed))
 		{
 			rohc_decomp_warn(context, "failed to build the inner IP header");
 			goto error_output_too_small;
@@ -5044,24 +5291,23 @@ rohc_status_t rfc3095_decomp_build_hdrs(const struct rohc_decomp *const decomp,
 		inner_ip_hdr = uncomp_hdrs_data;
 		uncomp_hdrs_data += inner_ip_hdr_len;
 		*uncomp_hdrs_len += inner_ip_hdr_len;
-#ifndef __clang_analyzer__ /* silent warning about dead in/decrement */
 		uncomp_hdrs_max_len -= inner_ip_hdr_len;
-#endif
 		uncomp_hdrs->len += inner_ip_hdr_len;
 	}
 	else
 	{
 		size_t ip_hdr_len;
 
-		rohc_decomp_debug(context, "length of transport header = %u bytes",
-		                  rfc3095_ctxt->outer_ip_changes->next_header_len);
-		ip_payload_len += rfc3095_ctxt->outer_ip_changes->next_header_len;
+		rohc_decomp_debug(context, "length of transport header = %zu bytes",
+		                  decoded->next_header_len);
+		ip_payload_len += decoded->next_header_len;
 		ip_payload_len += payload_len;
 
 		/* build the single IP header */
 		if(!build_uncomp_ip(context, decoded->outer_ip, uncomp_hdrs_data,
 		                    uncomp_hdrs_max_len, &ip_hdr_len, ip_payload_len,
-		                    &rfc3095_ctxt->list_decomp1))
+		                    &rfc3095_ctxt->list_decomp1,
+		                    rfc3095_ctxt->outer_ip_changes, crc_static_changed))
 		{
 			rohc_decomp_warn(context, "failed to build the IP header");
 			goto error_output_too_small;
@@ -5070,9 +5316,7 @@ rohc_status_t rfc3095_decomp_build_hdrs(const struct rohc_decomp *const decomp,
 		inner_ip_hdr = NULL;
 		uncomp_hdrs_data += ip_hdr_len;
 		*uncomp_hdrs_len += ip_hdr_len;
-#ifndef __clang_analyzer__ /* silent warning about dead in/decrement */
 		uncomp_hdrs_max_len -= ip_hdr_len;
-#endif
 		uncomp_hdrs->len += ip_hdr_len;
 	}
 
@@ -5080,9 +5324,17 @@ rohc_status_t rfc3095_decomp_build_hdrs(const struct rohc_decomp *const decomp,
 	next_header = uncomp_hdrs_data;
 	if(rfc3095_ctxt->build_next_header != NULL)
 	{
-		/* TODO: check uncomp_hdrs max size */
-		size_t size = rfc3095_ctxt->build_next_header(context, decoded,
-		                                              uncomp_hdrs_data, payload_len);
+		size_t size;
+
+		if(uncomp_hdrs_max_len < decoded->next_header_len)
+		{
+			rohc_decomp_warn(context, "output buffer too small for the %zu-byte "
+			                 "next header", decoded->next_header_len);
+			goto error_output_too_small;
+		}
+		size = rfc3095_ctxt->build_next_header(context, decoded,
+		                                       uncomp_hdrs_data, payload_len);
+		assert(size == decoded->next_header_len);
 #ifndef __clang_analyzer__ /* silent warning about dead in/decrement */
 		uncomp_hdrs_data += size;
 #endif
@@ -5093,6 +5345,14 @@ rohc_status_t rfc3095_decomp_build_hdrs(const struct rohc_decomp *const decomp,
 		uncomp_hdrs->len += size;
 	}
 
+	/* the CRC-STATIC fields may change with IR, IR-DYN packets and with
+	 * extension 3, so the CRC computed on the CRC-STATIC fields of the
+	 * context cannot be trusted anymore */
+	if(crc_static_changed)
+	{
+		memset(&rfc3095_ctxt->crc_static, 0, sizeof(struct rohc_crc_static_cache));
+	}
+
 	/* compute CRC on uncompressed headers if asked */
 	if(extr_crc->type != ROHC_CRC_TYPE_NONE)
 	{
@@ -5101,7 +5361,8 @@ rohc_status_t rfc3095_decomp_build_hdrs(const struct rohc_decomp *const decomp,
 		assert(extr_crc->bits_nr > 0);
 
 		crc_ok = check_uncomp_crc(decomp, context, outer_ip_hdr, inner_ip_hdr,
-		                          next_header, extr_crc->type, extr_crc->bits);
+		                          next_header, extr_crc->type, extr_crc->bits,
+		                          crc_static_changed);
 		if(!crc_ok)
 		{
 			rohc_decomp_warn(context, "CRC detected a decompression failure for "
@@ -5119,6 +5380,24 @@ rohc_status_t rfc3095_decomp_build_hdrs(const struct rohc_decomp *const decomp,
 		}
 	}
 
+	/* keep the uncompressed headers as template for the next UO* packets if
+	 * they are made of one single IP header without extension headers and of
+	 * the next header that the profile is able to patch */
+	if(!decoded->multiple_ip && rfc3095_ctxt->patch_tmpl_next_hdr != NULL &&
+	   (size_t) (next_header - outer_ip_hdr) ==
+	   (decoded->outer_ip.version == IPV4 ?
+	    sizeof(struct ipv4_hdr) : sizeof(struct ipv6_hdr)) &&
+	   (*uncomp_hdrs_len) <= ROHC_HDRS_TMPL_MAX_LEN)
+	{
+		memcpy(rfc3095_ctxt->hdrs_tmpl_next.data, outer_ip_hdr, *uncomp_hdrs_len);
+		rfc3095_ctxt->hdrs_tmpl_next.len = *uncomp_hdrs_len;
+		rfc3095_ctxt->hdrs_tmpl_next.ip_hdr_len = next_header - outer_ip_hdr;
+	}
+	else
+	{
+		rfc3095_ctxt->hdrs_tmpl_next.len = 0;
+	}
+
 	return ROHC_STATUS_OK;
 
 error_crc:
@@ -5138,6 +5417,9 @@ error_output_too_small:
  * @param[out] uncomp_hdrs_len  The length of the IPv4 header
  * @param payload_size          The length of the IP payload
  * @param list_decomp           The list decompressor (IPv6 only)
+ * @param ip_changes            The context of the IP header
+ * @param ip_fields_changed     Whether the fields that are not transmitted in
+ *                              UO* packets may differ from the context
  * @return                      true if the IP header is successfully built,
  *                              false if an error occurs
  */
@@ -5147,14 +5429,17 @@ static bool build_uncomp_ip(const struct rohc_decomp_ctxt *const context,
                             const size_t uncomp_hdrs_max_len,
                             size_t *const uncomp_hdrs_len,
                             const size_t payload_size,
-                            const struct list_decomp *const list_decomp)
+                            const struct list_decomp *const list_decomp,
+                            struct rohc_decomp_rfc3095_changes *const ip_changes,
+                            const bool ip_fields_changed)
 {
 	bool is_ok;
 
 	if(decoded.version == IPV4)
 	{
 		is_ok = build_uncomp_ipv4(context, decoded, dest, uncomp_hdrs_max_len,
-		                          uncomp_hdrs_len, payload_size);
+		                          uncomp_hdrs_len, payload_size, ip_changes,
+		                          ip_fields_changed);
 	}
 	else
 	{
@@ -5169,12 +5454,23 @@ static bool build_uncomp_ip(const struct rohc_decomp_ctxt *const context,
 /**
  * @brief Build an uncompressed IPv4 header.
  *
+ * The IPv4 checksum is computed incrementally (RFC 1624): the sum of the
+ * fields that cannot change with UO* packets is computed once and kept in
+ * the context, then only the Total Length and IP-ID fields are added to it.
+ *
+ * The IPv4 checksum cannot be left to the caller (eg. for NICs with checksum
+ * offload): it is one of the CRC-DYNAMIC fields, so it is required to check
+ * the CRC of the ROHC packet.
+ *
  * @param context               The decompression context
  * @param decoded               The decoded IPv4 fields
  * @param dest                  The buffer to store the IPv4 header
  * @param uncomp_hdrs_max_len   The max length of the IPv4 header
  * @param[out] uncomp_hdrs_len  The length of the IPv4 header
  * @param payload_size          The length of the IPv4 payload
+ * @param ip_changes            The context of the IPv4 header
+ * @param ip_fields_changed     Whether the fields that are not transmitted in
+ *                              UO* packets may differ from the context
  * @return                      true if the IPv4 header is successfully built,
  *                              false if an error occurs
  */
@@ -5183,9 +5479,12 @@ static bool build_uncomp_ipv4(const struct rohc_decomp_ctxt *const context,
                               uint8_t *const dest,
                               const size_t uncomp_hdrs_max_len,
                               size_t *const uncomp_hdrs_len,
-                              const size_t payload_size)
+                              const size_t payload_size,
+                              struct rohc_decomp_rfc3095_changes *const ip_changes,
+                              const bool ip_fields_changed)
 {
 	struct ipv4_hdr *const ip = (struct ipv4_hdr *) dest;
+	uint32_t csum;
 
 	if(uncomp_hdrs_max_len < sizeof(struct ipv4_hdr))
 	{
@@ -5218,8 +5517,30 @@ static bool build_uncomp_ipv4(const struct rohc_decomp_ctxt *const context,
 	ip->tot_len = rohc_hton16(payload_size + ip->ihl * 4);
 	rohc_decomp_debug(context, "Total Length = 0x%04x (IHL * 4 + %zu)",
 	                  rohc_ntoh16(ip->tot_len), payload_size);
-	ip->check = 0;
-	ip->check = ip_fast_csum(dest, ip->ihl);
+
+	/* compute the sum of the fields that are not transmitted in UO* packets
+	 * if they changed or if the sum was not computed yet */
+	if(ip_fields_changed || !ip_changes->is_ipv4_csum_partial_valid)
+	{
+		const uint16_t tot_len = ip->tot_len;
+		const uint16_t id = ip->id;
+
+		ip->tot_len = 0;
+		ip->id = 0;
+		ip->check = 0;
+		ip_changes->ipv4_csum_partial = ~ip_fast_csum(dest, ip->ihl);
+		ip_changes->is_ipv4_csum_partial_valid = !ip_fields_changed;
+		ip->tot_len = tot_len;
+		ip->id = id;
+	}
+
+	/* add the Total Length and IP-ID fields to the sum of the other fields */
+	csum = ip_changes->ipv4_csum_partial;
+	csum += ip->tot_len;
+	csum += ip->id;
+	csum = (csum & 0xffff) + (csum >> 16);
+	csum = (csum & 0xffff) + (csum >> 16);
+	ip->check = ~csum;
 	rohc_decomp_debug(context, "IP checksum = 0x%04x",
 	                  rohc_ntoh16(ip->check));
 
@@ -5310,20 +5631,150 @@ error:
 }
 
 
+/**
+ * @brief Build the uncompressed headers from the template of the context
+ *
+ * The uncompressed headers of the last packet are copied from the context,
+ * then the fields that may change with one UO* packet without extension 3
+ * are patched in place: the IP length and checksum, the IP-ID and the fields
+ * of the next header that depend on the SN or on the payload length.
+ *
+ * @param decomp                The ROHC decompressor
+ * @param context               The decompression context
+ * @param packet_type           The type of ROHC packet
+ * @param extr_crc              The CRC bits extracted from the UO* header
+ * @param decoded               The values decoded from the UO* header
+ * @param payload_len           The length of the packet payload
+ * @param[out] uncomp_hdrs      The uncompressed headers being built
+ * @param[out] uncomp_hdrs_len  The length of the uncompressed headers
+ * @return                      ROHC_STATUS_OK if headers are built
+ *                              successfully,
+ *                              ROHC_STATUS_BAD_CRC if headers do not match
+ *                              CRC,
+ *                              ROHC_STATUS_OUTPUT_TOO_SMALL if
+ *                              \e uncomp_packet is too small
+ */
+static rohc_status_t build_hdrs_from_tmpl(const struct rohc_decomp *const decomp,
+                                          const struct rohc_decomp_ctxt *const context,
+                                          const rohc_packet_t packet_type,
+                                          const struct rohc_decomp_crc *const extr_crc,
+                                          const struct rohc_decoded_values *const decoded,
+                                          const size_t payload_len,
+                                          struct rohc_buf *const uncomp_hdrs,
+                                          size_t *const uncomp_hdrs_len)
+{
+	struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt = context->persist_ctxt;
+	const struct rohc_decomp_hdrs_tmpl *const hdrs = &rfc3095_ctxt->hdrs_tmpl;
+	uint8_t *const ip_hdr = rohc_buf_data(*uncomp_hdrs);
+	uint8_t *const next_header = ip_hdr + hdrs->ip_hdr_len;
+
+	assert(hdrs->len > 0);
+	assert(extr_crc->type != ROHC_CRC_TYPE_NONE);
+
+	if(rohc_buf_avail_len(*uncomp_hdrs) < hdrs->len)
+	{
+		rohc_decomp_warn(context, "uncompressed packet too small for the %zu "
+		                 "bytes of headers", hdrs->len);
+		goto error_output_too_small;
+	}
+
+	/* start from the uncompressed headers of the last packet */
+	memcpy(ip_hdr, hdrs->data, hdrs->len);
+
+	/* patch the IP fields inferred from the SN and the payload length */
+	if(decoded->outer_ip.version == IPV4)
+	{
+		struct rohc_decomp_rfc3095_changes *const ip_changes =
+			rfc3095_ctxt->outer_ip_changes;
+		struct ipv4_hdr *const ip = (struct ipv4_hdr *) ip_hdr;
+
+		ip->tot_len = rohc_hton16(hdrs->len + payload_len);
+		ip->id = rohc_hton16(decoded->outer_ip.id);
+		if(!decoded->outer_ip.nbo)
+		{
+			ip->id = swab16(ip->id);
+		}
+
+		/* add the Total Length and IP-ID fields to the sum of the other fields
+		 * if it was computed, compute the full checksum otherwise */
+		if(ip_changes->is_ipv4_csum_partial_valid)
+		{
+			uint32_t csum = ip_changes->ipv4_csum_partial;
+			csum += ip->tot_len;
+			csum += ip->id;
+			csum = (csum & 0xffff) + (csum >> 16);
+			csum = (csum & 0xffff) + (csum >> 16);
+			ip->check = ~csum;
+		}
+		else
+		{
+			ip->check = 0;
+			ip->check = ip_fast_csum(ip_hdr, ip->ihl);
+		}
+	}
+	else
+	{
+		struct ipv6_hdr *const ip = (struct ipv6_hdr *) ip_hdr;
+
+		ip->plen = rohc_hton16(hdrs->len - hdrs->ip_hdr_len + payload_len);
+	}
+
+	/* patch the fields of the next header */
+	rfc3095_ctxt->patch_tmpl_next_hdr(context, decoded, next_header, payload_len);
+
+	*uncomp_hdrs_len = hdrs->len;
+	uncomp_hdrs->len += hdrs->len;
+	rohc_decomp_debug(context, "%zu bytes of uncompressed headers patched "
+	                  "from template", hdrs->len);
+
+	/* check the CRC on the patched headers */
+	if(!check_uncomp_crc(decomp, context, ip_hdr, NULL, next_header,
+	                     extr_crc->type, extr_crc->bits, false))
+	{
+		rohc_decomp_warn(context, "CRC detected a decompression failure for "
+		                 "packet of type %s in state %s and mode %s",
+		                 rohc_get_packet_descr(packet_type),
+		                 rohc_decomp_get_state_descr(context->state),
+		                 rohc_get_mode_descr(context->mode));
+		if((decomp->features & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0)
+		{
+			rohc_dump_buf(decomp->trace_callback, decomp->trace_callback_priv,
+			              ROHC_TRACE_DECOMP, ROHC_TRACE_WARNING,
+			              "uncompressed headers", ip_hdr, *uncomp_hdrs_len);
+		}
+		goto error_crc;
+	}
+
+	/* the patched headers are the template for the next UO* packets */
+	memcpy(rfc3095_ctxt->hdrs_tmpl_next.data, ip_hdr, hdrs->len);
+	rfc3095_ctxt->hdrs_tmpl_next.len = hdrs->len;
+	rfc3095_ctxt->hdrs_tmpl_next.ip_hdr_len = hdrs->ip_hdr_len;
+
+	return ROHC_STATUS_OK;
+
+error_crc:
+	return ROHC_STATUS_BAD_CRC;
+error_output_too_small:
+	return ROHC_STATUS_OUTPUT_TOO_SMALL;
+}
+
+
 /**
  * @brief Check whether the CRC on uncompressed header is correct or not
  *
- * TODO: The CRC should be computed only on the CRC-DYNAMIC fields
- *       if the CRC-STATIC fields did not change.
+ * The part of the CRC on the CRC-STATIC fields is taken from the context if
+ * the CRC-STATIC fields did not change since it was computed.
  *
- * @param decomp        The ROHC decompressor
- * @param context       The decompression context
- * @param outer_ip_hdr  The outer IP header
- * @param inner_ip_hdr  The inner IP header if it exists, NULL otherwise
- * @param next_header   The transport header, eg. UDP
- * @param crc_type      The type of CRC
- * @param crc_packet    The CRC extracted from the ROHC header
- * @return              true if the CRC is correct, false otherwise
+ * @param decomp              The ROHC decompressor
+ * @param context             The decompression context
+ * @param outer_ip_hdr        The outer IP header
+ * @param inner_ip_hdr        The inner IP header if it exists, NULL otherwise
+ * @param next_header         The transport header, eg. UDP
+ * @param crc_type            The type of CRC
+ * @param crc_packet          The CRC extracted from the ROHC header
+ * @param crc_static_changed  Whether the CRC-STATIC fields may differ from
+ *                            the ones of the context or not
+ * @return                    true if the CRC is correct, false otherwise
  */
 static bool check_uncomp_crc(const struct rohc_decomp *const decomp,
                              const struct rohc_decomp_ctxt *const context,
@@ -5331,7 +5782,8 @@ static bool check_uncomp_crc(const struct rohc_decomp *const decomp,
                              const uint8_t *const inner_ip_hdr,
                              const uint8_t *const next_header,
                              const rohc_crc_type_t crc_type,
-                             const uint8_t crc_packet)
+                             const uint8_t crc_packet,
+                             const bool crc_static_changed)
 {
 	struct rohc_decomp_rfc3095_ctxt *rfc3095_ctxt;
 	const uint8_t *crc_table;
@@ -5350,15 +5802,15 @@ static bool check_uncomp_crc(const struct rohc_decomp *const decomp,
 	{
 		case ROHC_CRC_TYPE_3:
 			crc_computed = CRC_INIT_3;
-			crc_table = decomp->crc_table_3;
+			crc_table = rohc_crc_table_3;
 			break;
 		case ROHC_CRC_TYPE_7:
 			crc_computed = CRC_INIT_7;
-			crc_table = decomp->crc_table_7;
+			crc_table = rohc_crc_table_7;
 			break;
 		case ROHC_CRC_TYPE_8:
 			crc_computed = CRC_INIT_8;
-			crc_table = decomp->crc_table_8;
+			crc_table = rohc_crc_table_8;
 			break;
 		case ROHC_CRC_TYPE_NONE:
 		default:
@@ -5367,13 +5819,33 @@ static bool check_uncomp_crc(const struct rohc_decomp *const decomp,
 			goto error;
 	}
 
-	/* compute the CRC from built uncompressed headers */
-	crc_computed = rfc3095_ctxt->compute_crc_static(outer_ip_hdr, inner_ip_hdr,
-	                                                next_header, crc_type,
-	                                                crc_computed, crc_table);
+	/* compute the CRC from built uncompressed headers: the part on the
+	 * CRC-STATIC fields is taken from the context if the CRC-STATIC fields
+	 * of the built headers are the ones of the context */
+	rohc_cycles_crc_begin(&context->decompressor->stage_cycles);
+	if(crc_static_changed)
+	{
+		crc_computed = rfc3095_ctxt->compute_crc_static(outer_ip_hdr, inner_ip_hdr,
+		                                                next_header, crc_type,
+		                                                crc_computed, crc_table);
+	}
+	else if(rfc3095_ctxt->crc_static.is_valid[crc_type])
+	{
+		crc_computed = rfc3095_ctxt->crc_static.crc[crc_type];
+	}
+	else
+	{
+		crc_computed = rfc3095_ctxt->compute_crc_static(outer_ip_hdr, inner_ip_hdr,
+		                                                next_header, crc_type,
+		                                                crc_computed, crc_table);
+		rfc3095_ctxt->crc_static.crc[crc_type] = crc_computed;
+		rfc3095_ctxt->crc_static.is_valid[crc_type] = true;
+	}
 	crc_computed = rfc3095_ctxt->compute_crc_dynamic(outer_ip_hdr, inner_ip_hdr,
 	                                                 next_header, crc_type,
 	                                                 crc_computed, crc_table);
+	rohc_cycles_crc_end(&context->decompressor->stage_cycles,
+	                    ROHC_DECOMP_STAGE_CRC);
 	rohc_decomp_debug(context, "CRC-%d on uncompressed header = 0x%x",
 	                  crc_type, crc_computed);
 
@@ -5406,7 +5878,7 @@ error:
  */
 bool rfc3095_decomp_attempt_repair(const struct rohc_decomp *const decomp,
                                    const struct rohc_decomp_ctxt *const context,
-                                   const struct rohc_ts pkt_arrival_time,
+                                   const struct rohc_ts pkt_arrival_time __attribute__((unused)),
                                    struct rohc_decomp_crc_corr_ctxt *const crc_corr,
                                    struct rohc_extr_bits *const extr_bits)
 {
@@ -5417,6 +5889,17 @@ bool rfc3095_decomp_attempt_repair(const struct rohc_decomp *const decomp,
 	                                                 ROHC_LSB_REF_MINUS_1);
 	bool verdict = false;
 
+	/* the packet seemed to come late but the CRC disagrees: decode it once
+	 * more with ref 0 as usual, it is not a repair of the context */
+	if(extr_bits->is_sn_late && extr_bits->lsb_ref_type == ROHC_LSB_REF_MINUS_1)
+	{
+		rohc_decomp_warn(context, "CID %zu: packet did not come late, decode it "
+		                 "with ref 0 (%u)", context->cid, sn_ref_0);
+		extr_bits->lsb_ref_type = ROHC_LSB_REF_0;
+		verdict = true;
+		goto skip;
+	}
+
 	/* do not try to repair packet/context if feature is disabled */
 	if((decomp->features & ROHC_DECOMP_FEATURE_CRC_REPAIR) == 0)
 	{
@@ -5448,7 +5931,10 @@ bool rfc3095_decomp_attempt_repair(const struct rohc_decomp *const decomp,
 	 * step c of RFC3095, §5.3.2.2.4. Correction of SN LSB wraparound:
 	 *   If wraparound has occurred, INTERVAL will correspond to at least
 	 *   2^k inter-packet times, where k is the number of SN bits in the
-	 *   current header. */
+	 *   current header.
+	 *
+	 * Small contexts record no arrival times, they skip that step. */
+#if ROHC_SMALL_CONTEXTS != 1
 	if(is_sn_wraparound(pkt_arrival_time, crc_corr->arrival_times,
 	                    crc_corr->arrival_times_nr, crc_corr->arrival_times_index,
 	                    extr_bits->sn_nr, rfc3095_ctxt->sn_lsb_p))
@@ -5467,7 +5953,9 @@ bool rfc3095_decomp_attempt_repair(const struct rohc_decomp *const decomp,
 		                 "= %u to reference SN (ref 0 = %u)", context->cid,
 		                 extr_bits->sn_nr, extr_bits->sn_ref_offset, sn_ref_0);
 	}
-	else if(sn_ref_0 != sn_ref_minus_1)
+	else
+#endif
+	if(sn_ref_0 != sn_ref_minus_1 && !extr_bits->is_sn_late)
 	{
 		rohc_decomp_warn(context, "CID %zu: CRC repair: CRC failure seems to "
 		                 "be caused by an incorrect SN update", context->cid);
@@ -5489,7 +5977,9 @@ bool rfc3095_decomp_attempt_repair(const struct rohc_decomp *const decomp,
 		/* step e of RFC3095, §5.3.2.2.5. Repair of incorrect SN updates:
 		 *   If the decompressed header generated in b. does not pass the CRC
 		 *   test and SN curr2 is the same as SN curr1, an additional
-		 *   decompression attempt is not useful and is not attempted. */
+		 *   decompression attempt is not useful and is not attempted.
+		 *
+		 * ref -1 was also tried already if the packet seemed to come late */
 		rohc_decomp_warn(context, "CID %zu: CRC repair: repair is not useful",
 		                 context->cid);
 		goto skip;
@@ -5505,6 +5995,7 @@ skip:
 }
 
 
+#if ROHC_SMALL_CONTEXTS != 1
 /**
  * @brief Is SN wraparound possible?
  *
@@ -5579,6 +6070,7 @@ static bool is_sn_wraparound(const struct rohc_ts cur_arrival_time,
 error:
 	return false;
 }
+#endif
 
 
 /**
@@ -5609,7 +6101,16 @@ bool rfc3095_decomp_decode_bits(const struct rohc_decomp_ctxt *const context,
 	const struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt = context->persist_ctxt;
 	bool decode_ok;
 
+	/* UO* packets without extension 3 patch the template of headers, so
+	 * only a few fields are decoded */
+	if(bits->use_hdrs_tmpl)
+	{
+		return decode_bits_for_tmpl(context, bits, decoded);
+	}
+	decoded->use_hdrs_tmpl = false;
+
 	decoded->is_context_reused = bits->is_context_reused;
+	decoded->is_ext3 = bits->is_ext3;
 
 	/* decode context mode */
 	if(bits->mode_nr > 0 && bits->mode != 0)
@@ -5694,6 +6195,7 @@ bool rfc3095_decomp_decode_bits(const struct rohc_decomp_ctxt *const context,
 	}
 
 	/* decode fields of next header if required */
+	decoded->next_header_len = rfc3095_ctxt->outer_ip_changes->next_header_len;
 	if(rfc3095_ctxt->decode_values_from_bits != NULL)
 	{
 		decode_ok = rfc3095_ctxt->decode_values_from_bits(context, bits, decoded);
@@ -6089,6 +6591,94 @@ error:
 }
 
 
+/**
+ * @brief Decode values from extracted bits for the template of headers
+ *
+ * Only the values that one UO* packet without extension 3 may change are
+ * decoded: the SN, the IP-ID of the outer IPv4 header and the fields of the
+ * next header inferred from or transmitted with them. The other fields are
+ * taken from the template of uncompressed headers.
+ *
+ * @param context       The decompression context
+ * @param bits          The bits extracted from the UO* packet
+ * @param[out] decoded  The corresponding decoded values
+ * @return              true if decoding is successful, false otherwise
+ */
+static bool decode_bits_for_tmpl(const struct rohc_decomp_ctxt *const context,
+                                 const struct rohc_extr_bits *const bits,
+                                 struct rohc_decoded_values *const decoded)
+{
+	const struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt = context->persist_ctxt;
+	const struct rohc_decomp_rfc3095_changes *const ip_changes =
+		rfc3095_ctxt->outer_ip_changes;
+
+	decoded->use_hdrs_tmpl = true;
+	decoded->is_context_reused = false;
+	decoded->is_ext3 = false;
+	decoded->mode = context->mode;
+	decoded->multiple_ip = false;
+
+	/* decode SN from packet bits and context */
+	if(!rohc_lsb_decode(rfc3095_ctxt->sn_lsb_ctxt, bits->lsb_ref_type,
+	                    bits->sn_ref_offset, bits->sn, bits->sn_nr,
+	                    rfc3095_ctxt->sn_lsb_p, &decoded->sn))
+	{
+		rohc_decomp_warn(context, "failed to decode %zu SN bits 0x%x",
+		                 bits->sn_nr, bits->sn);
+		goto error;
+	}
+	rohc_decomp_debug(context, "decoded SN = %u / 0x%x (nr bits = %zd, "
+	                  "bits = %u / 0x%x)", decoded->sn, decoded->sn,
+	                  bits->sn_nr, bits->sn, bits->sn);
+
+	/* decode the IP-ID of the outer IPv4 header */
+	decoded->outer_ip.version = ip_get_version(&ip_changes->ip);
+	if(decoded->outer_ip.version == IPV4)
+	{
+		decoded->outer_ip.nbo = ip_changes->nbo;
+		decoded->outer_ip.rnd = ip_changes->rnd;
+		decoded->outer_ip.sid = ip_changes->sid;
+		if(decoded->outer_ip.rnd)
+		{
+			/* random IP-ID is transmitted in the UO* remainder */
+			assert(bits->outer_ip.id_nr == 16);
+			decoded->outer_ip.id = bits->outer_ip.id;
+		}
+		else if(decoded->outer_ip.sid)
+		{
+			/* static IP-ID is taken from the context */
+			decoded->outer_ip.id = ipv4_get_id(&ip_changes->ip);
+		}
+		else if(!ip_id_offset_decode(rfc3095_ctxt->outer_ip_id_offset_ctxt,
+		                             bits->lsb_ref_type, bits->outer_ip.id,
+		                             bits->outer_ip.id_nr, decoded->sn,
+		                             &decoded->outer_ip.id))
+		{
+			rohc_decomp_warn(context, "failed to decode %zu outer IP-ID bits "
+			                 "0x%x", bits->outer_ip.id_nr, bits->outer_ip.id);
+			goto error;
+		}
+		rohc_decomp_debug(context, "decoded outer IP-ID = 0x%04x (rnd = %d, "
+		                  "nbo = %d, sid = %d, nr bits = %zd, bits = 0x%x)",
+		                  decoded->outer_ip.id, decoded->outer_ip.rnd,
+		                  decoded->outer_ip.nbo, decoded->outer_ip.sid,
+		                  bits->outer_ip.id_nr, bits->outer_ip.id);
+	}
+
+	/* decode the fields of the next header */
+	if(!rfc3095_ctxt->decode_tmpl_next_hdr(context, bits, decoded))
+	{
+		rohc_decomp_warn(context, "failed to decode fields of the next header");
+		goto error;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
 /**
  * @brief Update context with decoded values
  *
@@ -6231,6 +6821,28 @@ void rfc3095_decomp_update_ctxt(struct rohc_decomp_ctxt *const context,
 	/* update SN */
 	rohc_lsb_set_ref(rfc3095_ctxt->sn_lsb_ctxt, decoded->sn, keep_ref_minus_1);
 
+	/* the uncompressed headers of the packet (if they were kept) are the
+	 * template for the next UO* packets */
+	rfc3095_ctxt->hdrs_tmpl = rfc3095_ctxt->hdrs_tmpl_next;
+
+	/* UO* packets that patched the template change only the IP-ID and the
+	 * fields of the next header that are inferred from or transmitted with
+	 * the SN */
+	if(decoded->use_hdrs_tmpl)
+	{
+		if(decoded->outer_ip.version == IPV4)
+		{
+			ipv4_set_id(&rfc3095_ctxt->outer_ip_changes->ip, decoded->outer_ip.id);
+			ip_id_offset_set_ref(rfc3095_ctxt->outer_ip_id_offset_ctxt,
+			                     decoded->outer_ip.id, decoded->sn, keep_ref_minus_1);
+		}
+		if(rfc3095_ctxt->update_tmpl_next_hdr != NULL)
+		{
+			rfc3095_ctxt->update_tmpl_next_hdr(context, decoded);
+		}
+		return;
+	}
+
 	/* maybe current packet changed the number of IP headers */
 	rfc3095_ctxt->multiple_ip = decoded->multiple_ip;
 
@@ -6293,6 +6905,10 @@ void rfc3095_decomp_update_ctxt(struct rohc_decomp_ctxt *const context,
 /**
  * @brief Reset the extracted bits for next parsing
  *
+ * The whole structure is cleared only if one group of bits was written since
+ * the last full reset (see rohc_extr_bits_group_t), the bits of UO* packets
+ * are reset otherwise.
+ *
  * @param rfc3095_ctxt  The generic decompression context
  * @param[out] bits     The extracted bits to reset
  */
@@ -6302,8 +6918,11 @@ static void reset_extr_bits(const struct rohc_decomp_rfc3095_ctxt *const rfc3095
 	assert(rfc3095_ctxt != NULL);
 	assert(bits != NULL);
 
-	/* set every bits and sizes to 0 except for CCE-related variables */
+	if(bits->dirty_groups != 0)
 	{
+		/* the static/dynamic chains or the extension 3 of the previous packet
+		 * were parsed: set every bits and sizes to 0 except for CCE-related
+		 * variables */
 		const rohc_packet_cce_t cce_pkt = bits->cce_pkt;
 		const rohc_tristate_t cfp = bits->cfp;
 		const rohc_tristate_t cfi = bits->cfi;
@@ -6312,6 +6931,36 @@ static void reset_extr_bits(const struct rohc_decomp_rfc3095_ctxt *const rfc3095
 		bits->cfp = cfp;
 		bits->cfi = cfi;
 	}
+	else
+	{
+		/* the bits of the chains and of the extension 3 are still 0, only
+		 * reset the bits that UO* base headers, extensions 0 to 2 and UO*
+		 * remainders carry */
+		bits->use_hdrs_tmpl = false;
+		bits->sn = 0;
+		bits->sn_nr = 0;
+		bits->is_sn_enc = false;
+		bits->outer_ip.id = 0;
+		bits->outer_ip.id_nr = 0;
+		bits->outer_ip.rnd_nr = 0;
+		bits->inner_ip.version = 0;
+		bits->inner_ip.id = 0;
+		bits->inner_ip.id_nr = 0;
+		bits->inner_ip.is_id_enc = false;
+		bits->inner_ip.nbo = 0;
+		bits->inner_ip.rnd = 0;
+		bits->inner_ip.rnd_nr = 0;
+		bits->ext_flag = 0;
+		bits->is_ext3 = false;
+		bits->udp_check = 0;
+		bits->udp_check_nr = 0;
+		bits->udp_lite_cc = 0;
+		bits->udp_lite_cc_nr = 0;
+		bits->rtp_m = 0;
+		bits->rtp_m_nr = 0;
+		bits->ts = 0;
+		bits->ts_nr = 0;
+	}
 
 	/* by default, use ref 0 for LSB decoding (ref -1 will be used only for
 	 * correction upon CRC failure) */
@@ -6319,6 +6968,7 @@ static void reset_extr_bits(const struct rohc_decomp_rfc3095_ctxt *const rfc3095
 	/* by default, do not apply any offset on reference SN (it will be applied
 	 * only for correction upon CRC failure) */
 	bits->sn_ref_offset = 0;
+	bits->is_sn_late = false;
 
 	/* by default context is not re-used */
 	bits->is_context_reused = false;
@@ -6353,3 +7003,46 @@ static void reset_extr_bits(const struct rohc_decomp_rfc3095_ctxt *const rfc3095
 	bits->is_ts_scaled = true;
 }
 
+
+/**
+ * @brief Reset the extracted bits for the next UO-0 packet that patches the
+ *        template of headers
+ *
+ * Only the bits that one UO-0 packet may carry are reset, the other ones are
+ * not used when the template of headers is patched.
+ *
+ * @param rfc3095_ctxt  The generic decompression context
+ * @param[out] bits     The extracted bits to reset
+ */
+static void reset_extr_bits_uo0_fast(const struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
+                                     struct rohc_extr_bits *const bits)
+{
+	assert(!rfc3095_ctxt->multiple_ip);
+
+	bits->is_context_reused = false;
+	bits->is_ext3 = false;
+
+	/* use ref 0 for LSB decoding and no offset on reference SN by default */
+	bits->lsb_ref_type = ROHC_LSB_REF_0;
+	bits->sn_ref_offset = 0;
+	bits->is_sn_late = false;
+
+	/* same single IP header as in previous packets */
+	bits->multiple_ip = false;
+	bits->outer_ip.version = ip_get_version(&rfc3095_ctxt->outer_ip_changes->ip);
+	bits->outer_ip.nbo = rfc3095_ctxt->outer_ip_changes->nbo;
+	bits->outer_ip.rnd = rfc3095_ctxt->outer_ip_changes->rnd;
+	bits->outer_ip.is_id_enc = true;
+	bits->outer_ip.id = 0;
+	bits->outer_ip.id_nr = 0;
+
+	/* no TS bits and no M flag for RTP */
+	bits->ts = 0;
+	bits->ts_nr = 0;
+	bits->is_ts_scaled = true;
+	bits->rtp_m_nr = 0;
+
+	/* optional UDP checksum in the UO* remainder */
+	bits->udp_check = 0;
+	bits->udp_check_nr = 0;
+}
@@ -38,6 +38,7 @@
 #include "schemes/ip_id_offset.h"
 #include "schemes/decomp_list.h"
 #include "protocols/udp_lite.h"
+#include "protocols/rtp.h"
 #include "ip.h"
 #include "crc.h"
 
@@ -103,6 +104,25 @@ struct rohc_extr_ip_bits
 };
 
 
+/**
+ * @brief The groups of extracted bits that only some packets write
+ *
+ * The fields of these groups are not reset for every packet: the parser only
+ * records that a group was written, and the next reset clears it.
+ *
+ * @see reset_extr_bits
+ */
+typedef enum
+{
+	/** The static and dynamic chains of IR and IR-DYN packets */
+	ROHC_EXTR_BITS_CHAINS = (1U << 0),
+	/** The extension 3 of UO* packets */
+	ROHC_EXTR_BITS_EXT3   = (1U << 1),
+	/** All the groups, e.g. when the bits were written by another profile */
+	ROHC_EXTR_BITS_ALL    = (ROHC_EXTR_BITS_CHAINS | ROHC_EXTR_BITS_EXT3),
+} rohc_extr_bits_group_t;
+
+
 /**
  * @brief The bits extracted from ROHC UO* base headers
  *
@@ -112,7 +132,11 @@ struct rohc_extr_ip_bits
  */
 struct rohc_extr_bits
 {
+	uint8_t dirty_groups;   /**< The groups of bits written since the last
+	                             full reset, see rohc_extr_bits_group_t */
 	bool is_context_reused; /**< Whether the context is re-used or not */
+	bool use_hdrs_tmpl;     /**< Whether the uncompressed headers are patched
+	                             from the template of the context */
 
 	/* SN */
 	uint32_t sn;         /**< The SN bits found in ROHC header */
@@ -122,6 +146,8 @@ struct rohc_extr_bits
 	                                  (used for context repair after CRC failure) */
 	bool sn_ref_offset;         /**< Optional offset to add to the reference SN
 	                                 (used for context repair after CRC failure) */
+	bool is_sn_late;            /**< Whether the packet seemed to come late, so
+	                                 that ref -1 was chosen up front */
 
 	/** Whether there are multiple IP headers or only one single IP header */
 	bool multiple_ip;
@@ -134,6 +160,7 @@ struct rohc_extr_bits
 
 	/* X (extension) flag */
 	uint8_t ext_flag:1;     /**< X (extension) flag */
+	bool is_ext3;           /**< Whether the extension is extension 3 */
 
 	/* Mode bits */
 	uint8_t mode:2;         /**< The Mode bits found in ROHC header */
@@ -256,6 +283,11 @@ struct rohc_decoded_ip_values
 struct rohc_decoded_values
 {
 	bool is_context_reused; /**< Whether the context is re-used or not */
+	bool is_ext3;           /**< Whether the packet carries extension 3 */
+	bool use_hdrs_tmpl;     /**< Whether the uncompressed headers are patched
+	                             from the template of the context, only SN,
+	                             IP-ID, TS, M and UDP checksum are then
+	                             decoded */
 
 	uint32_t sn;  /**< The decoded SN value */
 
@@ -267,6 +299,9 @@ struct rohc_decoded_values
 	struct rohc_decoded_ip_values outer_ip;
 	/** The decoded values for the inner IP header */
 	struct rohc_decoded_ip_values inner_ip;
+	/** The length of the next header, the RTP header is followed by a
+	 *  variable number of CSRC identifiers */
+	size_t next_header_len;
 
 	/* bits below are for UDP-based profile only
 	   @todo TODO should be moved in d_udp.c */
@@ -300,6 +335,33 @@ struct rohc_decoded_values
 };
 
 
+/** The max length of the template of uncompressed headers */
+#define ROHC_HDRS_TMPL_MAX_LEN \
+	(sizeof(struct ipv6_hdr) + sizeof(struct udphdr) + sizeof(struct rtphdr))
+
+
+/** The max length of the next header stored in the context (UDP/RTP) */
+#define ROHC_DECOMP_NEXT_HDR_MAX_LEN \
+	(sizeof(struct udphdr) + sizeof(struct rtphdr))
+
+
+/**
+ * @brief The template of uncompressed headers of one decompression context
+ *
+ * UO* packets without extension 3 only change the SN and the fields that are
+ * inferred from or transmitted with it (IP-ID, RTP TS and M, UDP checksum), so
+ * the uncompressed headers of the last packet are patched instead of being
+ * built again field by field. Only the headers made of one single IP header
+ * without IPv6 extension headers and one next header are cached.
+ */
+struct rohc_decomp_hdrs_tmpl
+{
+	uint8_t data[ROHC_HDRS_TMPL_MAX_LEN]; /**< The uncompressed headers */
+	size_t len;         /**< The length of the headers, 0 if not cached */
+	size_t ip_hdr_len;  /**< The length of the IP header */
+};
+
+
 /**
  * @brief Store information about an IP header between the different
  *        decompressions of IP packets.
@@ -320,8 +382,15 @@ struct rohc_decomp_rfc3095_changes
 	/// Whether the IP-ID is considered as static or not (IPv4 only)
 	int sid;
 
-	/// The next header located after the IP header(s)
-	void *next_header;
+	/** The one's complement sum of the IPv4 header without the Total Length,
+	 *  IP-ID and checksum fields (IPv4 only) */
+	uint16_t ipv4_csum_partial;
+	/** Whether the partial IPv4 checksum is valid or not (IPv4 only) */
+	bool is_ipv4_csum_partial_valid;
+
+	/** The next header located after the IP header(s), stored in the context
+	 *  so that updating it costs no indirection */
+	uint8_t next_header[ROHC_DECOMP_NEXT_HDR_MAX_LEN] __attribute__((aligned(4)));
 	/// The length of the next header
 	unsigned int next_header_len;
 };
@@ -440,6 +509,36 @@ struct rohc_decomp_rfc3095_ctxt
 	                       const struct rohc_decoded_values *const decoded)
 		__attribute__((nonnull(1, 2)));
 
+	/** The handler used to decode the next header fields of the UO* packets
+	 *  that patch the template of headers, NULL if the profile does not use
+	 *  any template */
+	bool (*decode_tmpl_next_hdr)(const struct rohc_decomp_ctxt *const context,
+	                             const struct rohc_extr_bits *const bits,
+	                             struct rohc_decoded_values *const decoded)
+		__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+
+	/** The handler used to patch the next header of the template of headers */
+	void (*patch_tmpl_next_hdr)(const struct rohc_decomp_ctxt *const context,
+	                            const struct rohc_decoded_values *const decoded,
+	                            uint8_t *const next_hdr,
+	                            const size_t payload_len)
+		__attribute__((nonnull(1, 2, 3)));
+
+	/** The handler used to update context with the next header fields of the
+	 *  UO* packets that patch the template of headers (optional) */
+	void (*update_tmpl_next_hdr)(struct rohc_decomp_ctxt *const context,
+	                             const struct rohc_decoded_values *const decoded)
+		__attribute__((nonnull(1, 2)));
+
+	/** The CRC computed on the CRC-STATIC fields of the last UO* packets */
+	struct rohc_crc_static_cache crc_static;
+
+	/** The uncompressed headers of the last packet, patched by UO* packets */
+	struct rohc_decomp_hdrs_tmpl hdrs_tmpl;
+	/** The uncompressed headers of the packet being decompressed, they replace
+	 *  the template once the context is updated */
+	struct rohc_decomp_hdrs_tmpl hdrs_tmpl_next;
+
 	/// Profile-specific data
 	void *specific;
 };
@@ -461,6 +560,20 @@ void rohc_decomp_rfc3095_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_
                                  const struct rohc_decomp_volat_ctxt *const volat_ctxt)
 	__attribute__((nonnull(1, 2)));
 
+void rohc_decomp_rfc3095_get_mem(const struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
+                                 struct rohc_ctxt_mem *const mem)
+	__attribute__((nonnull(1, 2)));
+
+bool rohc_decomp_rfc3095_snapshot(const struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
+                                  const rohc_snapshot_write_t write_cb,
+                                  void *const priv)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
+bool rohc_decomp_rfc3095_restore(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
+                                 const rohc_snapshot_read_t read_cb,
+                                 void *const priv)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
 bool rfc3095_decomp_parse_pkt(const struct rohc_decomp_ctxt *const context,
                               const struct rohc_buf rohc_packet,
                               const size_t large_cid_len,
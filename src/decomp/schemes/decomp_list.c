@@ -26,6 +26,8 @@
 #include "schemes/decomp_list.h"
 
 #include "rohc_bit_ops.h"
+#include "rohc_alloc.h"
+#include "rohc_debug.h" /* for zfree() */
 
 #ifndef __KERNEL__
 #  include <string.h>
@@ -304,27 +306,43 @@ static int rohc_list_decode(struct list_decomp *decomp,
 		 * window of lists */
 		rd_list_debug(decomp, "anonymous list was received");
 	}
-	else if(decomp->lists[gen_id].counter > 0)
+	else if(decomp->lists[gen_id] != NULL &&
+	        decomp->lists[gen_id]->counter > 0 &&
+	        rohc_list_equal(decomp->lists[gen_id], &decomp->pkt_list))
 	{
 		/* list is identified by a gen_id, but the sliding window of lists
 		 * already contain a list with that generation identifier, so do
 		 * not update the sliding window of lists */
-		decomp->lists[gen_id].counter++;
+		decomp->lists[gen_id]->counter++;
 		rd_list_debug(decomp, "list with gen_id %u is already present in "
 		              "reference lists (received for the #%zu times)",
-		              gen_id, decomp->lists[gen_id].counter);
+		              gen_id, decomp->lists[gen_id]->counter);
 	}
 	else
 	{
 		/* list is identified by a gen_id and the sliding window of lists does
 		 * not contain a list with that generation identifier yet, so update
-		 * the sliding window of lists */
+		 * the sliding window of lists; the older lists are not removed from
+		 * the window, so a list with the same gen_id but another structure
+		 * means that the compressor re-used the generation identifier */
 		rd_list_debug(decomp, "list with gen_id %u is not present yet in "
 		              "reference lists, add it", gen_id);
-		memcpy(decomp->lists[gen_id].items, decomp->pkt_list.items,
+		/* the lists are allocated the first time their gen_id is used */
+		if(decomp->lists[gen_id] == NULL)
+		{
+			decomp->lists[gen_id] = malloc(sizeof(struct rohc_list));
+			if(decomp->lists[gen_id] == NULL)
+			{
+				rd_list_warn(decomp, "failed to allocate memory for the list with "
+				             "gen_id %u", gen_id);
+				goto error;
+			}
+			rohc_list_reset(decomp->lists[gen_id]);
+		}
+		memcpy(decomp->lists[gen_id]->items, decomp->pkt_list.items,
 		       ROHC_LIST_ITEMS_MAX * sizeof(struct decomp_list *));
-		decomp->lists[gen_id].items_nr = decomp->pkt_list.items_nr;
-		decomp->lists[gen_id].counter = 1;
+		decomp->lists[gen_id]->items_nr = decomp->pkt_list.items_nr;
+		decomp->lists[gen_id]->counter = 1;
 		/* TODO: remove all lists with gen_id < ref_id */
 	}
 
@@ -406,6 +424,192 @@ error:
 }
 
 
+/**
+ * @brief Save one list decompressor in a snapshot
+ *
+ * The translation table is saved item by item, then the number of lists
+ * known by the list decompressor is written before the lists themselves.
+ * Every list is preceded by its gen_id since the decompressor does not
+ * record it in the list. The last decoded list comes at the end. The lists
+ * refer to the items by their indexes.
+ *
+ * @param decomp    The list decompressor
+ * @param write_cb  The callback used to write the snapshot
+ * @param priv      The private context given to the callback
+ * @return          true if the list decompressor was saved,
+ *                  false if the callback failed
+ */
+bool rohc_decomp_list_snapshot(const struct list_decomp *const decomp,
+                               const rohc_snapshot_write_t write_cb,
+                               void *const priv)
+{
+	uint16_t lists_nr = 0;
+	size_t i;
+
+	for(i = 0; i < ROHC_LIST_MAX_ITEM; i++)
+	{
+		if(!rohc_list_item_snapshot(&decomp->trans_table[i], write_cb, priv))
+		{
+			goto error;
+		}
+	}
+
+	for(i = 0; i <= ROHC_LIST_GEN_ID_MAX; i++)
+	{
+		if(decomp->lists[i] != NULL)
+		{
+			lists_nr++;
+		}
+	}
+	if(!write_cb(priv, (uint8_t *) &lists_nr, sizeof(uint16_t)))
+	{
+		goto error;
+	}
+	for(i = 0; i <= ROHC_LIST_GEN_ID_MAX; i++)
+	{
+		const uint16_t gen_id = i;
+
+		if(decomp->lists[i] != NULL &&
+		   (!write_cb(priv, (uint8_t *) &gen_id, sizeof(uint16_t)) ||
+		    !rohc_list_snapshot(decomp->lists[i], decomp->trans_table,
+		                        write_cb, priv)))
+		{
+			goto error;
+		}
+	}
+
+	/* the last list is re-used when a packet does not transmit any list */
+	if(!rohc_list_snapshot(&decomp->pkt_list, decomp->trans_table,
+	                       write_cb, priv))
+	{
+		goto error;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Restore one list decompressor from a snapshot
+ *
+ * The lists known by the list decompressor are forgotten first. The memory
+ * of the items is kept and enlarged only if the saved data is larger, the
+ * lists are allocated like when their gen_id is used for the first time.
+ *
+ * @param decomp   The list decompressor
+ * @param read_cb  The callback used to read the snapshot
+ * @param priv     The private context given to the callback
+ * @return         true if the list decompressor was restored,
+ *                 false if the snapshot is truncated or malformed, or if
+ *                 memory cannot be allocated
+ */
+bool rohc_decomp_list_restore(struct list_decomp *const decomp,
+                              const rohc_snapshot_read_t read_cb,
+                              void *const priv)
+{
+	uint16_t lists_nr;
+	size_t i;
+
+	for(i = 0; i <= ROHC_LIST_GEN_ID_MAX; i++)
+	{
+		zfree(decomp->lists[i]);
+	}
+
+	for(i = 0; i < ROHC_LIST_MAX_ITEM; i++)
+	{
+		struct rohc_list_item *const list_item = &decomp->trans_table[i];
+		struct rohc_list_item_snapshot item;
+
+		if(!read_cb(priv, (uint8_t *) &item,
+		            sizeof(struct rohc_list_item_snapshot)))
+		{
+			goto error;
+		}
+		if(item.length > ROHC_LIST_ITEM_DATA_MAX)
+		{
+			rd_list_warn(decomp, "malformed list in snapshot: %u-byte item "
+			             "#%zu", item.length, i);
+			goto error;
+		}
+		if(item.length > list_item->data_max_len)
+		{
+			uint8_t *const data = malloc(item.length);
+			if(data == NULL)
+			{
+				rd_list_warn(decomp, "no memory for the %u-byte item #%zu",
+				             item.length, i);
+				goto error;
+			}
+			free(list_item->data);
+			list_item->data = data;
+			list_item->data_max_len = item.length;
+		}
+		if(!rohc_list_item_restore(list_item, &item, read_cb, priv))
+		{
+			goto error;
+		}
+	}
+
+	if(!read_cb(priv, (uint8_t *) &lists_nr, sizeof(uint16_t)))
+	{
+		goto error;
+	}
+	for(i = 0; i < lists_nr; i++)
+	{
+		struct rohc_list_snapshot list;
+		uint16_t gen_id;
+
+		if(!read_cb(priv, (uint8_t *) &gen_id, sizeof(uint16_t)) ||
+		   !read_cb(priv, (uint8_t *) &list, sizeof(struct rohc_list_snapshot)))
+		{
+			goto error;
+		}
+		if(gen_id > ROHC_LIST_GEN_ID_MAX || decomp->lists[gen_id] != NULL)
+		{
+			rd_list_warn(decomp, "malformed list in snapshot: unexpected list "
+			             "with gen_id %u", gen_id);
+			goto error;
+		}
+		decomp->lists[gen_id] = malloc(sizeof(struct rohc_list));
+		if(decomp->lists[gen_id] == NULL)
+		{
+			rd_list_warn(decomp, "no memory for the list with gen_id %u", gen_id);
+			goto error;
+		}
+		if(!rohc_list_restore(decomp->lists[gen_id], decomp->trans_table,
+		                      &list))
+		{
+			rd_list_warn(decomp, "malformed list in snapshot: list with gen_id "
+			             "%u", gen_id);
+			goto error;
+		}
+	}
+
+	/* the last list */
+	{
+		struct rohc_list_snapshot list;
+
+		if(!read_cb(priv, (uint8_t *) &list, sizeof(struct rohc_list_snapshot)))
+		{
+			goto error;
+		}
+		if(!rohc_list_restore(&decomp->pkt_list, decomp->trans_table, &list))
+		{
+			rd_list_warn(decomp, "malformed list in snapshot: last list");
+			goto error;
+		}
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
 /**
  * @brief Decode an extension list type 0
  *
@@ -625,7 +829,7 @@ static int rohc_list_decode_type_1(struct list_decomp *const decomp,
 		goto error;
 	}
 	/* reference list must not be empty (RFC 4815, §5.7) */
-	if(decomp->lists[ref_id].items_nr == 0)
+	if(decomp->lists[ref_id]->items_nr == 0)
 	{
 		rd_list_warn(decomp, "list encoding type 1 must not be used with an "
 		             "empty reference list, discard packet");
@@ -634,7 +838,7 @@ static int rohc_list_decode_type_1(struct list_decomp *const decomp,
 
 	/* insertion scheme */
 	ret = rohc_list_parse_insertion_scheme(decomp, packet, packet_len, ps, xi_1, 0,
-	                                       &(decomp->lists[ref_id]),
+	                                       decomp->lists[ref_id],
 	                                       &decomp->pkt_list);
 	if(ret < 0)
 	{
@@ -712,7 +916,7 @@ static int rohc_list_decode_type_2(struct list_decomp *const decomp,
 		goto error;
 	}
 	/* reference list must not be empty (RFC 4815, §5.7) */
-	if(decomp->lists[ref_id].items_nr == 0)
+	if(decomp->lists[ref_id]->items_nr == 0)
 	{
 		rd_list_warn(decomp, "list encoding type 2 must not be used with an "
 		             "empty reference list, discard packet");
@@ -721,7 +925,7 @@ static int rohc_list_decode_type_2(struct list_decomp *const decomp,
 
 	/* removal scheme */
 	ret = rohc_list_parse_removal_scheme(decomp, packet, packet_len,
-	                                     &(decomp->lists[ref_id]),
+	                                     decomp->lists[ref_id],
 	                                     &(decomp->pkt_list));
 	if(ret < 0)
 	{
@@ -815,7 +1019,7 @@ static int rohc_list_decode_type_3(struct list_decomp *const decomp,
 		goto error;
 	}
 	/* reference list must not be empty (RFC 4815, §5.7) */
-	if(decomp->lists[ref_id].items_nr == 0)
+	if(decomp->lists[ref_id]->items_nr == 0)
 	{
 		rd_list_warn(decomp, "list encoding type 3 must not be used with an "
 		             "empty reference list, discard packet");
@@ -825,7 +1029,7 @@ static int rohc_list_decode_type_3(struct list_decomp *const decomp,
 	/* removal scheme */
 	rohc_list_reset(&removal_list);
 	ret = rohc_list_parse_removal_scheme(decomp, packet, packet_len,
-	                                     &(decomp->lists[ref_id]), &removal_list);
+	                                     decomp->lists[ref_id], &removal_list);
 	if(ret < 0)
 	{
 		if(gen_id == ROHC_LIST_GEN_ID_ANON)
@@ -886,7 +1090,8 @@ static bool rohc_list_is_gen_id_known(const struct list_decomp *const decomp,
                                       const unsigned int gen_id)
 {
 	return (gen_id <= ROHC_LIST_GEN_ID_MAX &&
-	        decomp->lists[gen_id].counter > 0);
+	        decomp->lists[gen_id] != NULL &&
+	        decomp->lists[gen_id]->counter > 0);
 }
 
 
@@ -1305,7 +1510,7 @@ static size_t rohc_list_get_xi_nr(const uint8_t ins_mask[2],
 	}
 	for(j = ins_mask_len - 8; j >= 0; j--)
 	{
-		if(rohc_get_bit(ins_mask[0], j))
+		if(rohc_get_bit(ins_mask[1], j))
 		{
 			xi_nr++;
 		}
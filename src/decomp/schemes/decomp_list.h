@@ -53,8 +53,9 @@ struct list_decomp
 	/** The translation table */
 	struct rohc_list_item trans_table[ROHC_LIST_MAX_ITEM];
 
-	/** All the possible named lists, indexed by gen_id */
-	struct rohc_list lists[ROHC_LIST_GEN_ID_MAX + 1];
+	/** All the possible named lists, indexed by gen_id, allocated the first
+	 *  time their gen_id is used (NULL before) */
+	struct rohc_list *lists[ROHC_LIST_GEN_ID_MAX + 1];
 
 	/** The temporary packet list (not persistent across packets) */
 	struct rohc_list pkt_list;
@@ -90,6 +91,8 @@ struct list_decomp
 	rohc_trace_callback2_t trace_callback;
 	/** The private context of the callback function used to manage traces */
 	void *trace_callback_priv;
+	/** The lowest level of the traces passed to the callback function */
+	rohc_trace_level_t trace_level;
 	/** The profile ID the decompression list was created for */
 	int profile_id;
 };
@@ -113,5 +116,15 @@ bool rohc_decomp_list_create_item(struct list_decomp *const decomp,
                                   size_t *const item_length)
 	__attribute__((warn_unused_result, nonnull(1, 4, 6)));
 
+bool rohc_decomp_list_snapshot(const struct list_decomp *const decomp,
+                               const rohc_snapshot_write_t write_cb,
+                               void *const priv)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
+bool rohc_decomp_list_restore(struct list_decomp *const decomp,
+                              const rohc_snapshot_read_t read_cb,
+                              void *const priv)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
 #endif
 
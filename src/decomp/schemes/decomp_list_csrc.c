@@ -0,0 +1,252 @@
+/*
+ * Copyright 2026 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   schemes/decomp_list_csrc.c
+ * @brief  ROHC list decompression of RTP CSRC identifiers
+ * @author Didier Barvaux <didier@barvaux.org>
+ */
+
+#include "schemes/decomp_list_csrc.h"
+
+#include "rohc_traces_internal.h"
+
+#ifndef __KERNEL__
+#  include <string.h>
+#endif
+#include <stdlib.h>
+
+
+static bool check_csrc_item(const struct list_decomp *const decomp,
+                            const size_t index_table)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+static int get_csrc_size(const uint8_t *const data,
+                         const size_t data_len)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+static bool cmp_csrc(const struct rohc_list_item *const item,
+                     const uint8_t ext_type,
+                     const uint8_t *const ext_data,
+                     const size_t ext_len)
+	__attribute__((warn_unused_result, nonnull(1, 3)));
+
+static bool create_csrc_item(const uint8_t *const data,
+                             const size_t length,
+                             const size_t index_table,
+                             struct list_decomp *const decomp)
+	__attribute__((warn_unused_result, nonnull(1, 4)));
+
+static size_t rohc_build_csrc_list(const struct list_decomp *const decomp,
+                                   const uint8_t ip_nh_type,
+                                   uint8_t *const dest)
+	__attribute__((warn_unused_result, nonnull(1, 3)));
+
+
+
+/**
+ * @brief Create one context for decompressing lists of CSRC identifiers
+ *
+ * @param decomp         The context to create
+ * @param trace_cb       The function to call for printing traces
+ * @param trace_cb_priv  An optional private context, may be NULL
+ * @param trace_level    The lowest level of the traces to print
+ * @param profile_id     The ID of the associated decompression profile
+ */
+void rohc_decomp_list_csrc_new(struct list_decomp *const decomp,
+                               rohc_trace_callback2_t trace_cb,
+                               void *const trace_cb_priv,
+                               const rohc_trace_level_t trace_level,
+                               const int profile_id)
+{
+	memset(decomp, 0, sizeof(struct list_decomp));
+
+	/* specific callbacks for CSRC identifiers */
+	decomp->check_item = check_csrc_item;
+	decomp->get_item_size = get_csrc_size;
+	decomp->cmp_item = cmp_csrc;
+	decomp->create_item = create_csrc_item;
+	decomp->build_uncomp_item = rohc_build_csrc_list;
+
+	/* traces */
+	decomp->trace_callback = trace_cb;
+	decomp->trace_callback_priv = trace_cb_priv;
+	decomp->trace_level = trace_level;
+	decomp->profile_id = profile_id;
+}
+
+
+/**
+ * @brief Free one context for decompressing lists of CSRC identifiers
+ *
+ * @param decomp  The context to destroy
+ */
+void rohc_decomp_list_csrc_free(struct list_decomp *const decomp)
+{
+	size_t i;
+
+	for(i = 0; i <= ROHC_LIST_GEN_ID_MAX; i++)
+	{
+		free(decomp->lists[i]);
+	}
+	for(i = 0; i < ROHC_LIST_MAX_ITEM; i++)
+	{
+		rohc_list_item_free(&decomp->trans_table[i]);
+	}
+
+	memset(decomp, 0, sizeof(struct list_decomp));
+}
+
+
+/**
+ * @brief Check if the item is correct in CSRC table
+ *
+ * @param decomp       The list decompressor
+ * @param index_table  The index of the item to check the presence
+ * @return             true if item is found, false if not
+ */
+static bool check_csrc_item(const struct list_decomp *const decomp,
+                            const size_t index_table)
+{
+	if(index_table >= ROHC_LIST_MAX_ITEM)
+	{
+		rd_list_debug(decomp, "no item in based table at position %zu",
+		              index_table);
+		goto error;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get the size (in bytes) of the CSRC identifier
+ *
+ * @param data      The CSRC data
+ * @param data_len  The length (in bytes) of the CSRC data
+ * @return          The size of the CSRC identifier in case of success,
+ *                  -1 otherwise
+ */
+static int get_csrc_size(const uint8_t *const data __attribute__((unused)),
+                         const size_t data_len)
+{
+	if(data_len < sizeof(uint32_t))
+	{
+		/* too few data for one 32-bit CSRC identifier */
+		goto error;
+	}
+
+	return sizeof(uint32_t);
+
+error:
+	return -1;
+}
+
+
+/**
+ * @brief Compare two CSRC items
+ *
+ * @param item      The CSRC item to compare
+ * @param ext_type  The type of the item, unused for CSRC items
+ * @param ext_data  The CSRC identifier
+ * @param ext_len   The length (in bytes) of the CSRC identifier
+ * @return          true if the two items are equal,
+ *                  false if they are different
+ */
+static bool cmp_csrc(const struct rohc_list_item *const item,
+                     const uint8_t ext_type __attribute__((unused)),
+                     const uint8_t *const ext_data,
+                     const size_t ext_len)
+{
+	return (item->length == ext_len &&
+	        memcmp(item->data, ext_data, ext_len) == 0);
+}
+
+
+/**
+ * @brief Create a CSRC item
+ *
+ * @param data         The data in the item
+ * @param length       The length of the item
+ * @param index_table  The index of the item in based table
+ * @param decomp       The list decompressor
+ * @return             true in case of success, false otherwise
+ */
+static bool create_csrc_item(const uint8_t *const data,
+                             const size_t length,
+                             const size_t index_table,
+                             struct list_decomp *const decomp)
+{
+	int ret;
+
+	if(length != sizeof(uint32_t))
+	{
+		rd_list_warn(decomp, "CSRC item shall be 4-byte long, %zu bytes given",
+		             length);
+		goto error;
+	}
+
+	ret = rohc_list_item_update_if_changed(decomp->cmp_item,
+	                                       &decomp->trans_table[index_table],
+	                                       0, data, length);
+	if(ret < 0)
+	{
+		rd_list_warn(decomp, "failed to update the list item #%zu in "
+		             "translation table", index_table);
+		goto error;
+	}
+
+	/* on decompressor, an item is considered known upon first reception */
+	decomp->trans_table[index_table].known = true;
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Build the CSRC identifiers of the RTP header
+ *
+ * @param decomp      The list decompressor
+ * @param ip_nh_type  Unused for CSRC identifiers
+ * @param dest        The buffer to store the CSRC identifiers
+ * @return            The size of the list
+ */
+static size_t rohc_build_csrc_list(const struct list_decomp *const decomp,
+                                   const uint8_t ip_nh_type __attribute__((unused)),
+                                   uint8_t *const dest)
+{
+	size_t size = 0;
+	size_t i;
+
+	for(i = 0; i < decomp->pkt_list.items_nr; i++)
+	{
+		memcpy(dest + size, decomp->pkt_list.items[i]->data, sizeof(uint32_t));
+		size += sizeof(uint32_t);
+	}
+	rd_list_debug(decomp, "build %zu CSRC identifiers",
+	              decomp->pkt_list.items_nr);
+
+	return size;
+}
+
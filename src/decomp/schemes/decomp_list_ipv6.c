@@ -26,6 +26,7 @@
 #include "schemes/decomp_list_ipv6.h"
 
 #include "rohc_traces_internal.h"
+#include "rohc_alloc.h"
 
 #ifndef __KERNEL__
 #  include <string.h>
@@ -65,11 +66,13 @@ static size_t rohc_build_ip6_extension(const struct list_decomp *const decomp,
  * @param decomp         The context to create
  * @param trace_cb       The function to call for printing traces
  * @param trace_cb_priv  An optional private context, may be NULL
+ * @param trace_level    The lowest level of the traces to print
  * @param profile_id     The ID of the associated decompression profile
  */
 void rohc_decomp_list_ipv6_new(struct list_decomp *const decomp,
                                rohc_trace_callback2_t trace_cb,
                                void *const trace_cb_priv,
+                               const rohc_trace_level_t trace_level,
                                const int profile_id)
 {
 	memset(decomp, 0, sizeof(struct list_decomp));
@@ -84,6 +87,7 @@ void rohc_decomp_list_ipv6_new(struct list_decomp *const decomp,
 	/* traces */
 	decomp->trace_callback = trace_cb;
 	decomp->trace_callback_priv = trace_cb_priv;
+	decomp->trace_level = trace_level;
 	decomp->profile_id = profile_id;
 }
 
@@ -95,6 +99,17 @@ void rohc_decomp_list_ipv6_new(struct list_decomp *const decomp,
  */
 void rohc_decomp_list_ipv6_free(struct list_decomp *const decomp)
 {
+	size_t i;
+
+	for(i = 0; i <= ROHC_LIST_GEN_ID_MAX; i++)
+	{
+		free(decomp->lists[i]);
+	}
+	for(i = 0; i < ROHC_LIST_MAX_ITEM; i++)
+	{
+		rohc_list_item_free(&decomp->trans_table[i]);
+	}
+
 	memset(decomp, 0, sizeof(struct list_decomp));
 }
 
@@ -109,7 +124,7 @@ void rohc_decomp_list_ipv6_free(struct list_decomp *const decomp)
 static bool check_ip6_item(const struct list_decomp *const decomp,
                            const size_t index_table)
 {
-	if(index_table > ROHC_LIST_MAX_ITEM)
+	if(index_table >= ROHC_LIST_MAX_ITEM)
 	{
 		rd_list_debug(decomp, "no item in based table at position %zu",
 		              index_table);
@@ -29,7 +29,11 @@
 #include "decomp_scaled_rtp_ts.h"
 #include "decomp_wlsb.h"
 #include "rohc_traces_internal.h"
+#include "rohc_alloc.h"
 
+#ifndef __KERNEL__
+#  include <string.h>
+#endif
 #include <assert.h>
 
 
@@ -89,10 +93,30 @@ struct ts_sc_decomp
 	rohc_trace_callback2_t trace_callback;
 	/** The private context of the callback function used to manage traces */
 	void *trace_callback_priv;
+	/** The lowest level of the traces passed to the callback function */
+	rohc_trace_level_t trace_level;
 };
 
 
 
+/** The scaled RTP Timestamp decoding context in a snapshot, followed by its
+ *  LSB decoding contexts for TS_SCALED and for the unscaled TS */
+struct ts_sc_decomp_snapshot
+{
+	uint32_t ts_stride;      /**< The validated TS_STRIDE value */
+	uint32_t ts_scaled;      /**< The validated TS_SCALED value */
+	uint32_t ts_offset;      /**< The validated TS_OFFSET value */
+	uint32_t ts;             /**< The last TS value */
+	uint32_t old_ts;         /**< The previous TS value */
+	uint32_t new_ts_stride;  /**< The TS_STRIDE value not validated yet */
+	uint32_t new_ts_scaled;  /**< The TS_SCALED value not validated yet */
+	uint32_t new_ts_offset;  /**< The TS_OFFSET value not validated yet */
+	uint16_t sn;             /**< The SN */
+	uint16_t old_sn;         /**< The previous SN */
+} __attribute__((packed));
+
+
+
 /*
  * Public functions
  */
@@ -102,11 +126,13 @@ struct ts_sc_decomp
  *
  * @param trace_cb       The trace callback
  * @param trace_cb_priv  An optional private context for the trace
+ * @param trace_level    The lowest level of the traces to print
  * @return               The scaled RTP Timestamp decoding context in case of
  *                       success, NULL otherwise
  */
 struct ts_sc_decomp * d_create_sc(rohc_trace_callback2_t trace_cb,
-                                  void *const trace_cb_priv)
+                                  void *const trace_cb_priv,
+                                  const rohc_trace_level_t trace_level)
 {
 	struct ts_sc_decomp *ts_sc;
 
@@ -143,6 +169,7 @@ struct ts_sc_decomp * d_create_sc(rohc_trace_callback2_t trace_cb,
 
 	ts_sc->trace_callback = trace_cb;
 	ts_sc->trace_callback_priv = trace_cb_priv;
+	ts_sc->trace_level = trace_level;
 
 	return ts_sc;
 
@@ -168,6 +195,96 @@ void rohc_ts_scaled_free(struct ts_sc_decomp *const ts_sc)
 }
 
 
+/**
+ * @brief Get the memory used by one ts_sc_decomp object
+ *
+ * @return  The number of bytes allocated by \ref d_create_sc, including its
+ *          two LSB decoding contexts
+ */
+size_t rohc_ts_scaled_get_mem_size(void)
+{
+	return sizeof(struct ts_sc_decomp) + 2 * rohc_lsb_get_mem_size();
+}
+
+
+/**
+ * @brief Save one ts_sc_decomp object in a snapshot
+ *
+ * @param ts_sc     The ts_sc_decomp object to save
+ * @param write_cb  The callback used to write the snapshot
+ * @param priv      The private context given to the callback
+ * @return          true if the object was saved, false if the callback failed
+ */
+bool d_sc_snapshot(const struct ts_sc_decomp *const ts_sc,
+                   const rohc_snapshot_write_t write_cb,
+                   void *const priv)
+{
+	struct ts_sc_decomp_snapshot record;
+
+	memset(&record, 0, sizeof(struct ts_sc_decomp_snapshot));
+	record.ts_stride = ts_sc->ts_stride;
+	record.ts_scaled = ts_sc->ts_scaled;
+	record.ts_offset = ts_sc->ts_offset;
+	record.ts = ts_sc->ts;
+	record.old_ts = ts_sc->old_ts;
+	record.new_ts_stride = ts_sc->new_ts_stride;
+	record.new_ts_scaled = ts_sc->new_ts_scaled;
+	record.new_ts_offset = ts_sc->new_ts_offset;
+	record.sn = ts_sc->sn;
+	record.old_sn = ts_sc->old_sn;
+
+	/* the LSB decoding contexts hold no pointer */
+	return (write_cb(priv, (uint8_t *) &record,
+	                 sizeof(struct ts_sc_decomp_snapshot)) &&
+	        write_cb(priv, (const uint8_t *) ts_sc->lsb_ts_scaled,
+	                 rohc_lsb_get_mem_size()) &&
+	        write_cb(priv, (const uint8_t *) ts_sc->lsb_ts_unscaled,
+	                 rohc_lsb_get_mem_size()));
+}
+
+
+/**
+ * @brief Restore one ts_sc_decomp object from a snapshot
+ *
+ * The LSB decoding contexts allocated by \ref d_create_sc and the traces
+ * are kept, only their content is restored.
+ *
+ * @param ts_sc    The ts_sc_decomp object to restore
+ * @param read_cb  The callback used to read the snapshot
+ * @param priv     The private context given to the callback
+ * @return         true if the object was restored, false if the callback
+ *                 failed
+ */
+bool d_sc_restore(struct ts_sc_decomp *const ts_sc,
+                  const rohc_snapshot_read_t read_cb,
+                  void *const priv)
+{
+	struct ts_sc_decomp_snapshot record;
+
+	if(!read_cb(priv, (uint8_t *) &record,
+	            sizeof(struct ts_sc_decomp_snapshot)) ||
+	   !read_cb(priv, (uint8_t *) ts_sc->lsb_ts_scaled,
+	            rohc_lsb_get_mem_size()) ||
+	   !read_cb(priv, (uint8_t *) ts_sc->lsb_ts_unscaled,
+	            rohc_lsb_get_mem_size()))
+	{
+		return false;
+	}
+	ts_sc->ts_stride = record.ts_stride;
+	ts_sc->ts_scaled = record.ts_scaled;
+	ts_sc->ts_offset = record.ts_offset;
+	ts_sc->ts = record.ts;
+	ts_sc->old_ts = record.old_ts;
+	ts_sc->new_ts_stride = record.new_ts_stride;
+	ts_sc->new_ts_scaled = record.new_ts_scaled;
+	ts_sc->new_ts_offset = record.new_ts_offset;
+	ts_sc->sn = record.sn;
+	ts_sc->old_sn = record.old_sn;
+
+	return true;
+}
+
+
 /**
  * @brief Store a new timestamp
  *
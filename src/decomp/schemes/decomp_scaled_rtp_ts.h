@@ -29,6 +29,7 @@
 #ifndef ROHC_DECOMP_SCHEMES_SCALED_RTP_TS_H
 #define ROHC_DECOMP_SCHEMES_SCALED_RTP_TS_H
 
+#include "rohc.h" /* for rohc_snapshot_write_t and rohc_snapshot_read_t */
 #include "rohc_traces.h"
 
 #include <stdlib.h>
@@ -49,10 +50,22 @@ struct ts_sc_decomp;
  */
 
 struct ts_sc_decomp * d_create_sc(rohc_trace_callback2_t trace_cb,
-                                  void *const trace_cb_priv)
+                                  void *const trace_cb_priv,
+                                  const rohc_trace_level_t trace_level)
 	__attribute__((warn_unused_result));
 void rohc_ts_scaled_free(struct ts_sc_decomp *const ts_scaled)
 	__attribute__((nonnull(1)));
+size_t rohc_ts_scaled_get_mem_size(void)
+	__attribute__((warn_unused_result, const));
+
+bool d_sc_snapshot(const struct ts_sc_decomp *const ts_sc,
+                   const rohc_snapshot_write_t write_cb,
+                   void *const priv)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+bool d_sc_restore(struct ts_sc_decomp *const ts_sc,
+                  const rohc_snapshot_read_t read_cb,
+                  void *const priv)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
 
 void ts_update_context(struct ts_sc_decomp *const ts_sc,
                        const uint32_t ts,
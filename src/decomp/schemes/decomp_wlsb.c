@@ -25,7 +25,8 @@
  */
 
 #include "decomp_wlsb.h"
-#include "interval.h" /* for the rohc_f_32bits() function */
+#include "interval.h" /* for the rohc_interval_compute_p() function */
+#include "rohc_alloc.h"
 
 #ifndef __KERNEL__
 #  include <string.h>
@@ -49,6 +50,11 @@ struct rohc_lsb_decode
 
 	/** The reference values (ref -1 and ref 0) */
 	uint32_t v_ref_d[ROHC_LSB_REF_MAX];
+
+	/** The number of reference updates with the value just after ref 0 */
+	unsigned long in_order_hits;
+	/** The number of reference updates with any other value */
+	unsigned long in_order_misses;
 };
 
 
@@ -108,6 +114,8 @@ struct rohc_lsb_decode * rohc_lsb_new(const size_t max_len)
 	{
 		lsb->max_len = max_len;
 		lsb->is_init = false;
+		lsb->in_order_hits = 0;
+		lsb->in_order_misses = 0;
 	}
 
 	return lsb;
@@ -127,6 +135,35 @@ void rohc_lsb_free(struct rohc_lsb_decode *const lsb)
 }
 
 
+/**
+ * @brief Get the memory used by one Least Significant Bits (LSB) decoding
+ *        context
+ *
+ * @return  The number of bytes allocated by \ref rohc_lsb_new
+ */
+size_t rohc_lsb_get_mem_size(void)
+{
+	return sizeof(struct rohc_lsb_decode);
+}
+
+
+/**
+ * @brief Reset a given Least Significant Bits (LSB) decoding context
+ *
+ * The reference value is forgotten, so the context shall be initialized
+ * again before decoding any value. Used to re-use one LSB decoding context
+ * for a new decompression context.
+ *
+ * @param lsb  The LSB decoding context to reset
+ */
+void rohc_lsb_reset(struct rohc_lsb_decode *const lsb)
+{
+	lsb->is_init = false;
+	lsb->in_order_hits = 0;
+	lsb->in_order_misses = 0;
+}
+
+
 /**
  * @brief Is the LSB decoding context ready to decode a compressed value
  *
@@ -238,11 +275,11 @@ static bool rohc_lsb_decode32(const struct rohc_lsb_decode *const lsb,
                               const rohc_lsb_shift_t p,
                               uint32_t *const decoded)
 {
-	struct rohc_interval32 interval;
+	const uint32_t v_ref_d = lsb->v_ref_d[ref_type] + v_ref_d_offset;
+	int32_t computed_p;
+	uint32_t interval_min;
 	uint32_t decoded_value;
-	uint32_t try;
 	uint32_t mask;
-	bool is_found = false;
 
 	/* compute the mask for k bits (and avoid integer overflow) */
 	if(k == 32)
@@ -255,56 +292,30 @@ static bool rohc_lsb_decode32(const struct rohc_lsb_decode *const lsb,
 	}
 	assert((m & mask) == m);
 
-	/* determine the interval in which the decoded value should be present */
-	interval = rohc_f_32bits(lsb->v_ref_d[ref_type] + v_ref_d_offset, k, p);
+	/* determine the interval in which the decoded value should be present:
+	 * [v_ref_d - p, v_ref_d - p + 2^k - 1] */
+	computed_p = rohc_interval_compute_p(k, p);
 
-	/* search the value that matches the k lower bits of the value m to decode */
-	if(interval.min <= interval.max)
+	/* most packets are received in order: the decoded value is v_ref_d + 1
+	 * if it has the same k LSB bits as m and if it belongs to the interval,
+	 * ie. if its offset p + 1 from the minimum value is lower than 2^k */
+	if(((v_ref_d + 1) & mask) == m && ((uint32_t) (computed_p + 1)) <= mask)
 	{
-		/* the interpretation interval does not straddle the field boundaries */
-
-		/* find the minimum value in the interval [min ; max] with the same k LSB
-		 * bits as m */
-		try = (interval.min & (~mask)) | m;
-		if((interval.min & mask) > m)
-		{
-			/* value is not in the interval (lower than min), try next value */
-			try += mask + 1;
-		}
-		if(try >= interval.min && try <= interval.max)
-		{
-			/* value is in the interval: corresponding value found */
-			is_found = true;
-			decoded_value = try;
-		}
+		decoded_value = v_ref_d + 1;
 	}
 	else
 	{
-		/* the interpretation interval does straddle the field boundaries */
-
-		/* find the first value in the interval [min ; max] with the same
-		 * k LSB bits as m */
-		try = (interval.min & (~mask)) | m;
-		if((interval.min & mask) > m)
-		{
-			/* value is not in the interval (lower than min), try next value */
-			try += mask + 1;
-		}
-		if(try >= interval.min || try <= interval.max)
-		{
-			/* value is in the interval: corresponding value found */
-			is_found = true;
-			decoded_value = try;
-		}
-	}
-
-	if(is_found)
-	{
-		assert((decoded_value & mask) == m);
-		memcpy(decoded, &decoded_value, sizeof(uint32_t));
+		/* the interval contains 2^k consecutive values, so exactly one of them
+		 * has the same k LSB bits as m: the one at offset (m - min) mod 2^k
+		 * from the minimum value, even if the interval straddles the field
+		 * boundaries */
+		interval_min = v_ref_d - computed_p;
+		decoded_value = interval_min + ((m - interval_min) & mask);
 	}
+	assert((decoded_value & mask) == m);
+	memcpy(decoded, &decoded_value, sizeof(uint32_t));
 
-	return is_found;
+	return true;
 }
 
 
@@ -408,6 +419,23 @@ void rohc_lsb_set_ref(struct rohc_lsb_decode *const lsb,
                       const uint32_t v_ref_d,
                       const bool keep_ref_minus_1)
 {
+	/* count the values received in order, ie. the values that the fast path
+	 * of \ref rohc_lsb_decode32 decodes (modulo the field length) */
+	if(lsb->is_init)
+	{
+		const uint32_t field_mask =
+			(lsb->max_len == 32 ? 0xffffffff : ((1U << lsb->max_len) - 1));
+
+		if(((v_ref_d - lsb->v_ref_d[ROHC_LSB_REF_0] - 1) & field_mask) == 0)
+		{
+			lsb->in_order_hits++;
+		}
+		else
+		{
+			lsb->in_order_misses++;
+		}
+	}
+
 	/* replace ref -1 by ref 0 if not doing context repair */
 	if(!keep_ref_minus_1)
 	{
@@ -437,3 +465,23 @@ uint32_t rohc_lsb_get_ref(const struct rohc_lsb_decode *const lsb,
 	return lsb->v_ref_d[ref_type];
 }
 
+
+/**
+ * @brief Get the statistics about the values received in order
+ *
+ * A value is received in order if it is the value just after the ref 0
+ * value when it becomes the new reference value. Such values are decoded
+ * by the fast path of \ref rohc_lsb_decode.
+ *
+ * @param lsb           The LSB object
+ * @param[out] hits     The number of values received in order
+ * @param[out] misses   The number of values not received in order
+ */
+void rohc_lsb_get_in_order_stats(const struct rohc_lsb_decode *const lsb,
+                                 unsigned long *const hits,
+                                 unsigned long *const misses)
+{
+	*hits = lsb->in_order_hits;
+	*misses = lsb->in_order_misses;
+}
+
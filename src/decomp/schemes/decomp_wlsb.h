@@ -90,6 +90,12 @@ struct rohc_lsb_decode * rohc_lsb_new(const size_t max_len)
 void rohc_lsb_free(struct rohc_lsb_decode *const lsb)
 	__attribute__((nonnull(1)));
 
+size_t rohc_lsb_get_mem_size(void)
+	__attribute__((warn_unused_result, const));
+
+void rohc_lsb_reset(struct rohc_lsb_decode *const lsb)
+	__attribute__((nonnull(1)));
+
 bool rohc_lsb_is_ready(const struct rohc_lsb_decode *const lsb)
 	__attribute__((warn_unused_result, nonnull(1), pure));
 
@@ -111,5 +117,10 @@ uint32_t rohc_lsb_get_ref(const struct rohc_lsb_decode *const lsb,
                           const rohc_lsb_ref_t ref_type)
 	__attribute__((nonnull(1), warn_unused_result));
 
+void rohc_lsb_get_in_order_stats(const struct rohc_lsb_decode *const lsb,
+                                 unsigned long *const hits,
+                                 unsigned long *const misses)
+	__attribute__((nonnull(1, 2, 3)));
+
 #endif
 
@@ -25,6 +25,7 @@
  */
 
 #include "ip_id_offset.h"
+#include "rohc_alloc.h"
 
 #include <stdlib.h>
 #include <assert.h>
@@ -97,6 +98,51 @@ void ip_id_offset_free(struct ip_id_offset_decode *const ipid)
 }
 
 
+/**
+ * @brief Get the memory used by one Offset IP-ID decoding context
+ *
+ * @return  The number of bytes allocated by \ref ip_id_offset_new
+ */
+size_t ip_id_offset_get_mem_size(void)
+{
+	return sizeof(struct ip_id_offset_decode) + rohc_lsb_get_mem_size();
+}
+
+
+/**
+ * @brief Save one Offset IP-ID decoding context in a snapshot
+ *
+ * @param ipid      The Offset IP-ID decoding context to save
+ * @param write_cb  The callback used to write the snapshot
+ * @param priv      The private context given to the callback
+ * @return          true if the context was saved, false if the callback failed
+ */
+bool ip_id_offset_snapshot(const struct ip_id_offset_decode *const ipid,
+                           const rohc_snapshot_write_t write_cb,
+                           void *const priv)
+{
+	/* the LSB decoding context holds no pointer */
+	return write_cb(priv, (const uint8_t *) ipid->lsb, rohc_lsb_get_mem_size());
+}
+
+
+/**
+ * @brief Restore one Offset IP-ID decoding context from a snapshot
+ *
+ * @param ipid     The Offset IP-ID decoding context to restore
+ * @param read_cb  The callback used to read the snapshot
+ * @param priv     The private context given to the callback
+ * @return         true if the context was restored, false if the callback
+ *                 failed
+ */
+bool ip_id_offset_restore(struct ip_id_offset_decode *const ipid,
+                          const rohc_snapshot_read_t read_cb,
+                          void *const priv)
+{
+	return read_cb(priv, (uint8_t *) ipid->lsb, rohc_lsb_get_mem_size());
+}
+
+
 /**
  * @brief Decode the given IP-ID offset
  *
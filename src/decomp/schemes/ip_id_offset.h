@@ -28,6 +28,7 @@
 #define ROHC_DECOMP_IP_ID_OFFSET_H
 
 #include "decomp_wlsb.h"
+#include "rohc.h" /* for rohc_snapshot_write_t and rohc_snapshot_read_t */
 
 #include <stdint.h>
 #include <stdlib.h>
@@ -51,6 +52,19 @@ struct ip_id_offset_decode * ip_id_offset_new(void);
 void ip_id_offset_free(struct ip_id_offset_decode *const ipid)
 	__attribute__((nonnull(1)));
 
+size_t ip_id_offset_get_mem_size(void)
+	__attribute__((warn_unused_result, const));
+
+bool ip_id_offset_snapshot(const struct ip_id_offset_decode *const ipid,
+                           const rohc_snapshot_write_t write_cb,
+                           void *const priv)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
+bool ip_id_offset_restore(struct ip_id_offset_decode *const ipid,
+                          const rohc_snapshot_read_t read_cb,
+                          void *const priv)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
 bool ip_id_offset_decode(const struct ip_id_offset_decode *const ipid,
                          const rohc_lsb_ref_t ref_type,
                          const uint16_t m,
@@ -47,6 +47,36 @@
 	} while(0)
 
 
+/** A snapshot kept in memory */
+struct snapshot_buf
+{
+	uint8_t data[4096];  /**< The bytes of the snapshot */
+	size_t len;          /**< The number of bytes written */
+	size_t pos;          /**< The number of bytes read */
+};
+
+static bool snapshot_write_cb(void *const priv,
+                              const uint8_t *const data,
+                              const size_t len)
+	__attribute__((warn_unused_result));
+static bool snapshot_read_cb(void *const priv,
+                             uint8_t *const data,
+                             const size_t len)
+	__attribute__((warn_unused_result));
+static void journal_cb(void *const priv,
+                       const uint8_t *const record,
+                       const size_t record_len);
+static void feedback_cb(void *const priv,
+                        const struct rohc_buf feedback);
+static bool frame_cb(void *const priv,
+                     const uint8_t *const data,
+                     const size_t data_len,
+                     size_t *const frame_len,
+                     size_t *const rohc_offset,
+                     size_t *const rohc_len)
+	__attribute__((warn_unused_result));
+
+
 /**
  * @brief Test the robustness of the decompression API
  *
@@ -96,6 +126,15 @@ int main(int argc, char *argv[])
 	CHECK(decomp != NULL);
 	rohc_decomp_free(decomp);
 	CHECK(rohc_decomp_new2(ROHC_LARGE_CID, ROHC_LARGE_CID_MAX + 1, ROHC_U_MODE) == NULL);
+
+	/* rohc_decomp_new_on_node() */
+	CHECK(rohc_decomp_new_on_node(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX,
+	                              ROHC_U_MODE, ROHC_NUMA_NO_NODE - 1) == NULL);
+	decomp = rohc_decomp_new_on_node(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX,
+	                                 ROHC_U_MODE, 0);
+	CHECK(decomp != NULL);
+	rohc_decomp_free(decomp);
+
 	decomp = rohc_decomp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, ROHC_U_MODE);
 	CHECK(decomp != NULL);
 	rohc_decomp_free(decomp);
@@ -111,6 +150,27 @@ int main(int argc, char *argv[])
 		CHECK(rohc_decomp_set_traces_cb2(decomp, fct, decomp) == true);
 	}
 
+	/* rohc_decomp_set_trace_level() */
+	CHECK(rohc_decomp_set_trace_level(NULL, ROHC_TRACE_WARNING) == false);
+	CHECK(rohc_decomp_set_trace_level(decomp, ROHC_TRACE_LEVEL_MAX) == false);
+	CHECK(rohc_decomp_set_trace_level(decomp, ROHC_TRACE_WARNING) == true);
+	CHECK(rohc_decomp_set_trace_level(decomp, ROHC_TRACE_DEBUG) == true);
+
+	/* rohc_decomp_set_trace_ring() and rohc_decomp_get_trace_records() */
+	{
+		struct rohc_trace_record records[4];
+		size_t records_nr;
+
+		CHECK(rohc_decomp_set_trace_ring(NULL, 4) == false);
+		CHECK(rohc_decomp_set_trace_ring(decomp, 3) == false);
+		CHECK(rohc_decomp_set_trace_ring(decomp, 4) == true);
+		CHECK(rohc_decomp_get_trace_records(NULL, records, 4, &records_nr) == false);
+		CHECK(rohc_decomp_get_trace_records(decomp, NULL, 4, &records_nr) == false);
+		CHECK(rohc_decomp_get_trace_records(decomp, records, 4, NULL) == false);
+		CHECK(rohc_decomp_get_trace_records(decomp, records, 4, &records_nr) == true);
+		CHECK(records_nr == 0);
+	}
+
 	/* rohc_decomp_profile_enabled() */
 	CHECK(rohc_decomp_profile_enabled(NULL, ROHC_PROFILE_IP) == false);
 	CHECK(rohc_decomp_profile_enabled(decomp, ROHC_PROFILE_GENERAL) == false);
@@ -146,6 +206,10 @@ int main(int argc, char *argv[])
 	CHECK(rohc_decomp_disable_profiles(decomp, ROHC_PROFILE_UDP,
 	                                   ROHC_PROFILE_RTP, -1) == true);
 
+	/* rohc_decomp_register_profile() */
+	CHECK(rohc_decomp_register_profile(NULL, NULL, 0) == false);
+	CHECK(rohc_decomp_register_profile(decomp, NULL, 0) == false);
+
 	/* rohc_decomp_profile_enabled() */
 	CHECK(rohc_decomp_profile_enabled(decomp, ROHC_PROFILE_UNCOMPRESSED) == false);
 	CHECK(rohc_decomp_profile_enabled(decomp, ROHC_PROFILE_RTP) == false);
@@ -232,11 +296,107 @@ int main(int argc, char *argv[])
 		CHECK(n_2 == 102);
 	}
 
+	/* rohc_decomp_set_crc_repair_budget() */
+	CHECK(rohc_decomp_set_crc_repair_budget(NULL,   10, 100, 1000) == false);
+	CHECK(rohc_decomp_set_crc_repair_budget(decomp, 10, 100, 0) == false);
+	CHECK(rohc_decomp_set_crc_repair_budget(decomp, 10, 100, SIZE_MAX) == false);
+	CHECK(rohc_decomp_set_crc_repair_budget(decomp,  0,   0, 1000) == true);
+	CHECK(rohc_decomp_set_crc_repair_budget(decomp, 10, 100, 500) == true);
+
+	/* rohc_decomp_get_crc_repair_budget() */
+	{
+		size_t ctxt_max;
+		size_t decomp_max;
+		size_t window;
+		CHECK(rohc_decomp_get_crc_repair_budget(NULL,   &ctxt_max, &decomp_max, &window) == false);
+		CHECK(rohc_decomp_get_crc_repair_budget(decomp, NULL,      &decomp_max, &window) == false);
+		CHECK(rohc_decomp_get_crc_repair_budget(decomp, &ctxt_max, NULL,        &window) == false);
+		CHECK(rohc_decomp_get_crc_repair_budget(decomp, &ctxt_max, &decomp_max, NULL) == false);
+		CHECK(rohc_decomp_get_crc_repair_budget(decomp, &ctxt_max, &decomp_max, &window) == true);
+		CHECK(ctxt_max == 10);
+		CHECK(decomp_max == 100);
+		CHECK(window == 500);
+	}
+
+	/* rohc_decomp_set_reorder_window() */
+	CHECK(rohc_decomp_set_reorder_window(NULL, 2) == false);
+	CHECK(rohc_decomp_set_reorder_window(decomp, 65) == false);
+	CHECK(rohc_decomp_set_reorder_window(decomp, 0) == true);
+	CHECK(rohc_decomp_set_reorder_window(decomp, 2) == true);
+
+	/* rohc_decomp_get_reorder_window() */
+	{
+		size_t window;
+		CHECK(rohc_decomp_get_reorder_window(NULL, &window) == false);
+		CHECK(rohc_decomp_get_reorder_window(decomp, NULL) == false);
+		CHECK(rohc_decomp_get_reorder_window(decomp, &window) == true);
+		CHECK(window == 2);
+	}
+
+	/* rohc_decomp_set_contexts_pool() */
+	CHECK(rohc_decomp_set_contexts_pool(NULL, 10) == false);
+	CHECK(rohc_decomp_set_contexts_pool(decomp, ROHC_SMALL_CID_MAX + 2) == false);
+	CHECK(rohc_decomp_set_contexts_pool(decomp, ROHC_SMALL_CID_MAX + 1) == true);
+	CHECK(rohc_decomp_set_contexts_pool(decomp, 0) == true);
+	CHECK(rohc_decomp_set_contexts_pool(decomp, 10) == true);
+
+	/* rohc_decomp_get_contexts_pool() */
+	{
+		size_t contexts_nr;
+		CHECK(rohc_decomp_get_contexts_pool(NULL, &contexts_nr) == false);
+		CHECK(rohc_decomp_get_contexts_pool(decomp, NULL) == false);
+		CHECK(rohc_decomp_get_contexts_pool(decomp, &contexts_nr) == true);
+		CHECK(contexts_nr == 10);
+	}
+
+	/* rohc_decomp_prewarm_contexts() */
+	CHECK(rohc_decomp_prewarm_contexts(NULL, ROHC_PROFILE_UNCOMPRESSED, 1) == false);
+	CHECK(rohc_decomp_prewarm_contexts(decomp, ROHC_PROFILE_UNCOMPRESSED, 1) == false);
+	CHECK(rohc_decomp_prewarm_contexts(decomp, ROHC_PROFILE_IP, 1) == false);
+	CHECK(rohc_decomp_enable_profile(decomp, ROHC_PROFILE_UNCOMPRESSED) == true);
+	CHECK(rohc_decomp_prewarm_contexts(decomp, ROHC_PROFILE_UNCOMPRESSED,
+	                                   ROHC_SMALL_CID_MAX + 2) == false);
+	CHECK(rohc_decomp_prewarm_contexts(decomp, ROHC_PROFILE_UNCOMPRESSED, 0) == true);
+	CHECK(rohc_decomp_prewarm_contexts(decomp, ROHC_PROFILE_UNCOMPRESSED, 4) == true);
+	CHECK(rohc_decomp_disable_profile(decomp, ROHC_PROFILE_UNCOMPRESSED) == true);
+
+	/* rohc_decomp_set_ctxt_idle_timeout() */
+	CHECK(rohc_decomp_set_ctxt_idle_timeout(NULL, 30) == false);
+	CHECK(rohc_decomp_set_ctxt_idle_timeout(decomp, 30) == true);
+	CHECK(rohc_decomp_set_ctxt_idle_timeout(decomp, 0) == true);
+
+	/* rohc_decomp_set_clock() */
+	{
+		const struct rohc_ts clock = { .sec = 10, .nsec = 0 };
+		CHECK(rohc_decomp_set_clock(NULL, &clock) == false);
+		CHECK(rohc_decomp_set_clock(decomp, &clock) == true);
+		CHECK(rohc_decomp_set_clock(decomp, NULL) == true);
+	}
+
 	/* rohc_decomp_set_features */
 	CHECK(rohc_decomp_set_features(decomp, ROHC_DECOMP_FEATURE_COMPAT_1_6_x) == false);
 	CHECK(rohc_decomp_set_features(decomp, ROHC_DECOMP_FEATURE_CRC_REPAIR) == true);
+	CHECK(rohc_decomp_set_features(decomp, ROHC_DECOMP_FEATURE_COLD_CTXTS) == true);
+	CHECK(rohc_decomp_set_features(decomp, ROHC_DECOMP_FEATURE_GROUP_BY_CID) == true);
+	CHECK(rohc_decomp_set_features(decomp, ROHC_DECOMP_FEATURE_NO_ALLOC |
+	                                       ROHC_DECOMP_FEATURE_COLD_CTXTS) == false);
+	CHECK(rohc_decomp_set_features(decomp, ROHC_DECOMP_FEATURE_NO_ALLOC) == true);
 	CHECK(rohc_decomp_set_features(decomp, ROHC_DECOMP_FEATURE_NONE) == true);
 
+	/* rohc_decomp_set_recorder() */
+	{
+		struct snapshot_buf recording;
+
+		recording.len = 0;
+		CHECK(rohc_decomp_set_recorder(NULL, snapshot_write_cb, &recording, 0) == false);
+		CHECK(rohc_decomp_set_recorder(decomp, snapshot_write_cb, &recording, 0) == true);
+		CHECK(recording.len > 0);
+		CHECK(rohc_decomp_set_recorder(decomp, NULL, NULL, 0) == true);
+	}
+
+	/* record the processing time of the next packets */
+	CHECK(rohc_decomp_set_features(decomp, ROHC_DECOMP_FEATURE_LATENCY) == true);
+
 	/* rohc_decompress3() */
 	{
 		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
@@ -290,6 +450,20 @@ int main(int argc, char *argv[])
 		CHECK(rohc_decompress3(decomp, pkt, &pkt2, NULL, NULL) == ROHC_STATUS_OK);
 		CHECK(pkt2.len > 0);
 
+		/* no allocation to decompress with an existing context (only if the
+		 * library was built with --enable-alloc-check) */
+		if(rohc_alloc_set_steady_state(ROHC_ALLOC_STEADY_REPORT))
+		{
+			rohc_alloc_stats_t alloc_stats;
+			memset(&alloc_stats, 0, sizeof(rohc_alloc_stats_t));
+			pkt2.offset = 0;
+			pkt2.len = 0;
+			CHECK(rohc_decompress3(decomp, pkt, &pkt2, NULL, NULL) == ROHC_STATUS_OK);
+			CHECK(rohc_alloc_set_steady_state(ROHC_ALLOC_STEADY_OFF) == true);
+			CHECK(rohc_alloc_get_stats(&alloc_stats) == true);
+			CHECK(alloc_stats.steady_allocs_nr == 0);
+		}
+
 		{
 			uint8_t buf_full[100];
 			struct rohc_buf pkt_full = rohc_buf_init_full(buf_full, 100, ts);
@@ -308,6 +482,158 @@ int main(int argc, char *argv[])
 			CHECK(rohc_decompress3(decomp, pkt, &pkt2, NULL, &pkt_malformed) == ROHC_STATUS_ERROR);
 			CHECK(rohc_decompress3(decomp, pkt, &pkt2, NULL, &pkt_full) == ROHC_STATUS_ERROR);
 		}
+
+		/* rohc_decompress_inplace() */
+		{
+			uint8_t inplace_buf[100 + sizeof(buf)];
+			struct rohc_buf inplace_pkt =
+				rohc_buf_init_full(inplace_buf, sizeof(inplace_buf), ts);
+
+			memcpy(inplace_buf + 100, buf, sizeof(buf));
+			inplace_pkt.offset = 100;
+			inplace_pkt.len = sizeof(buf);
+			CHECK(rohc_decompress_inplace(NULL, &inplace_pkt, NULL, NULL) == ROHC_STATUS_ERROR);
+			CHECK(rohc_decompress_inplace(decomp, NULL, NULL, NULL) == ROHC_STATUS_ERROR);
+			inplace_pkt.len = 0;
+			CHECK(rohc_decompress_inplace(decomp, &inplace_pkt, NULL, NULL) == ROHC_STATUS_ERROR);
+			inplace_pkt.len = sizeof(buf) + 1;
+			CHECK(rohc_decompress_inplace(decomp, &inplace_pkt, NULL, NULL) == ROHC_STATUS_ERROR);
+			/* no headroom for the uncompressed headers */
+			inplace_pkt.offset = 0;
+			inplace_pkt.len = sizeof(buf);
+			CHECK(rohc_decompress_inplace(decomp, &inplace_pkt, NULL, NULL) == ROHC_STATUS_ERROR);
+			inplace_pkt.offset = 100;
+			inplace_pkt.len = sizeof(buf);
+			CHECK(rohc_decompress_inplace(decomp, &inplace_pkt, NULL, NULL) == ROHC_STATUS_OK);
+			CHECK(inplace_pkt.len > 0);
+			CHECK((inplace_pkt.offset + inplace_pkt.len) == sizeof(inplace_buf));
+		}
+
+		/* rohc_decompress_header() */
+		{
+			uint8_t hdr_buf[100];
+			struct rohc_buf hdr = rohc_buf_init_empty(hdr_buf, sizeof(hdr_buf));
+			size_t payload_offset;
+			size_t payload_len;
+
+			CHECK(rohc_decompress_header(NULL, pkt, &hdr, &payload_offset,
+			                             &payload_len, NULL, NULL) == ROHC_STATUS_ERROR);
+			CHECK(rohc_decompress_header(decomp, pkt, NULL, &payload_offset,
+			                             &payload_len, NULL, NULL) == ROHC_STATUS_ERROR);
+			CHECK(rohc_decompress_header(decomp, pkt, &hdr, NULL,
+			                             &payload_len, NULL, NULL) == ROHC_STATUS_ERROR);
+			CHECK(rohc_decompress_header(decomp, pkt, &hdr, &payload_offset,
+			                             NULL, NULL, NULL) == ROHC_STATUS_ERROR);
+			/* too small for the uncompressed headers */
+			hdr.max_len = 10;
+			CHECK(rohc_decompress_header(decomp, pkt, &hdr, &payload_offset,
+			                             &payload_len, NULL, NULL) == ROHC_STATUS_OUTPUT_TOO_SMALL);
+			CHECK(hdr.len == 0);
+			/* the payload is not copied after the uncompressed headers */
+			hdr.max_len = sizeof(hdr_buf);
+			CHECK(rohc_decompress_header(decomp, pkt, &hdr, &payload_offset,
+			                             &payload_len, NULL, NULL) == ROHC_STATUS_OK);
+			CHECK(hdr.len > 0);
+			CHECK(payload_len > 0);
+			CHECK((payload_offset + payload_len) == pkt.len);
+			rohc_buf_reset(&pkt2);
+			CHECK(rohc_decompress3(decomp, pkt, &pkt2, NULL, NULL) == ROHC_STATUS_OK);
+			CHECK(pkt2.len == (hdr.len + payload_len));
+			CHECK(memcmp(rohc_buf_data(pkt2), rohc_buf_data(hdr), hdr.len) == 0);
+			CHECK(memcmp(rohc_buf_data(pkt2) + hdr.len,
+			             rohc_buf_data(pkt) + payload_offset, payload_len) == 0);
+		}
+
+		/* rohc_decompress_stream() */
+		{
+			uint8_t stream[2 * (1 + sizeof(buf))];
+			struct rohc_buf chunk = rohc_buf_init_full(stream, sizeof(stream), ts);
+			uint8_t out_buf[100];
+			struct rohc_buf out = rohc_buf_init_empty(out_buf, sizeof(out_buf));
+
+			/* 2 frames with a 1-byte length in front of the ROHC packet */
+			stream[0] = sizeof(buf);
+			memcpy(stream + 1, buf, sizeof(buf));
+			memcpy(stream + 1 + sizeof(buf), stream, 1 + sizeof(buf));
+
+			CHECK(rohc_decompress_stream(NULL, &chunk, &out, NULL, NULL) == ROHC_STATUS_ERROR);
+			/* no framing set */
+			CHECK(rohc_decompress_stream(decomp, &chunk, &out, NULL, NULL) == ROHC_STATUS_ERROR);
+			CHECK(rohc_decomp_set_stream_framing(NULL, frame_cb, NULL, 100) == false);
+			CHECK(rohc_decomp_set_stream_framing(decomp, frame_cb, NULL, 0) == false);
+			CHECK(rohc_decomp_set_stream_framing(decomp, frame_cb, NULL, 100) == true);
+			CHECK(rohc_decompress_stream(decomp, NULL, &out, NULL, NULL) == ROHC_STATUS_ERROR);
+			CHECK(rohc_decompress_stream(decomp, &chunk, NULL, NULL, NULL) == ROHC_STATUS_ERROR);
+
+			/* the first frame is complete in the chunk, the second one is not */
+			chunk.len = 1 + sizeof(buf) + 3;
+			CHECK(rohc_decompress_stream(decomp, &chunk, &out, NULL, NULL) == ROHC_STATUS_OK);
+			CHECK(out.len > 0);
+			CHECK(chunk.len == 3);
+			rohc_buf_reset(&out);
+			CHECK(rohc_decompress_stream(decomp, &chunk, &out, NULL, NULL) == ROHC_STATUS_OK);
+			CHECK(out.len == 0);
+			CHECK(chunk.len == 0);
+			/* the next chunks complete the second frame */
+			chunk.len = sizeof(buf) - 3;
+			CHECK(rohc_decompress_stream(decomp, &chunk, &out, NULL, NULL) == ROHC_STATUS_OK);
+			CHECK(out.len == 0);
+			CHECK(chunk.len == 0);
+			chunk.len = 1;
+			CHECK(rohc_decompress_stream(decomp, &chunk, &out, NULL, NULL) == ROHC_STATUS_OK);
+			CHECK(out.len > 0);
+			CHECK(chunk.len == 0);
+			CHECK(memcmp(rohc_buf_data(out), rohc_buf_data(pkt2), out.len) == 0);
+			/* frame larger than the maximum length */
+			CHECK(rohc_decomp_set_stream_framing(decomp, frame_cb, NULL, sizeof(buf)) == true);
+			chunk.offset = 0;
+			chunk.len = 1 + sizeof(buf);
+			CHECK(rohc_decompress_stream(decomp, &chunk, &out, NULL, NULL) == ROHC_STATUS_MALFORMED);
+			CHECK(chunk.len == 1 + sizeof(buf));
+			CHECK(rohc_decomp_set_stream_framing(decomp, NULL, NULL, 0) == true);
+		}
+
+		/* rohc_decompress_batch() */
+		{
+			struct rohc_buf in_pkts[2] = { pkt1, pkt };
+			uint8_t out_bufs[2][100];
+			struct rohc_buf out_pkts[2] =
+			{
+				rohc_buf_init_empty(out_bufs[0], 100),
+				rohc_buf_init_empty(out_bufs[1], 100),
+			};
+			rohc_status_t statuses[2];
+			uint8_t buf_full[100];
+			struct rohc_buf pkt_full = rohc_buf_init_full(buf_full, 100, ts);
+			uint8_t buf_fb[100];
+			struct rohc_buf pkt_fb = rohc_buf_init_empty(buf_fb, 100);
+
+			CHECK(rohc_decompress_batch(NULL, in_pkts, out_pkts, statuses, 2, NULL, NULL) == false);
+			CHECK(rohc_decompress_batch(decomp, NULL, out_pkts, statuses, 2, NULL, NULL) == false);
+			CHECK(rohc_decompress_batch(decomp, in_pkts, NULL, statuses, 2, NULL, NULL) == false);
+			CHECK(rohc_decompress_batch(decomp, in_pkts, out_pkts, NULL, 2, NULL, NULL) == false);
+			CHECK(rohc_decompress_batch(decomp, in_pkts, out_pkts, statuses, 2, &pkt_full, NULL) == false);
+			CHECK(rohc_decompress_batch(decomp, in_pkts, out_pkts, statuses, 2, NULL, &pkt_full) == false);
+			CHECK(rohc_decompress_batch(decomp, in_pkts, out_pkts, statuses, 2, NULL, &pkt_fb) == true);
+			CHECK(statuses[0] != ROHC_STATUS_OK);
+			CHECK(out_pkts[0].len == 0);
+			CHECK(statuses[1] == ROHC_STATUS_OK);
+			CHECK(out_pkts[1].len > 0);
+		}
+
+		/* rohc_decomp_prefetch() */
+		{
+			uint8_t buf_empty[100];
+			struct rohc_buf pkt_empty = rohc_buf_init_empty(buf_empty, 100);
+			uint8_t buf_other_cid[] = { 0x00, 0x05 };
+			struct rohc_buf pkt_other_cid =
+				rohc_buf_init_full(buf_other_cid, sizeof(buf_other_cid), ts);
+
+			CHECK(rohc_decomp_prefetch(NULL, pkt) == false);
+			CHECK(rohc_decomp_prefetch(decomp, pkt_empty) == false);
+			CHECK(rohc_decomp_prefetch(decomp, pkt_other_cid) == false);
+			CHECK(rohc_decomp_prefetch(decomp, pkt) == true);
+		}
 	}
 
 	/* rohc_decomp_get_last_packet_info() */
@@ -342,6 +668,151 @@ int main(int argc, char *argv[])
 		CHECK(rohc_decomp_get_general_info(decomp, &info) == true);
 		info.version_minor = 1;
 		CHECK(rohc_decomp_get_general_info(decomp, &info) == true);
+		info.version_minor = 2;
+		CHECK(rohc_decomp_get_general_info(decomp, &info) == true);
+		CHECK(info.skipped_crc_repairs == 0);
+	}
+
+	/* rohc_decomp_get_context_info() */
+	{
+		rohc_decomp_context_info_t info;
+		unsigned long types_packets = 0;
+		size_t i;
+		memset(&info, 0, sizeof(rohc_decomp_context_info_t));
+		CHECK(rohc_decomp_get_context_info(NULL, 0, &info) == false);
+		CHECK(rohc_decomp_get_context_info(decomp, 0, NULL) == false);
+		CHECK(rohc_decomp_get_context_info(decomp, ROHC_SMALL_CID_MAX + 1, &info) == false);
+		info.version_major = 0xffff;
+		CHECK(rohc_decomp_get_context_info(decomp, 0, &info) == false);
+		info.version_major = 0;
+		info.version_minor = 0xffff;
+		CHECK(rohc_decomp_get_context_info(decomp, 0, &info) == false);
+		info.version_minor = 0;
+		CHECK(rohc_decomp_get_context_info(decomp, 0, &info) == true);
+		info.version_minor = 1;
+		CHECK(rohc_decomp_get_context_info(decomp, 0, &info) == true);
+		info.version_minor = 2;
+		CHECK(rohc_decomp_get_context_info(decomp, 0, &info) == true);
+		for(i = 0; i < ROHC_PACKET_MAX; i++)
+		{
+			types_packets += info.packet_types_nr[i];
+		}
+		CHECK(types_packets <= info.packets_nr);
+		CHECK(info.crc_failures <= types_packets);
+	}
+
+	/* rohc_decomp_get_packet_stats() */
+	{
+		rohc_decomp_general_info_t info;
+		rohc_packet_stats_t stats;
+		unsigned long profiles_packets = 0;
+		unsigned long profiles_bytes = 0;
+		unsigned long types_packets = 0;
+		unsigned long types_bytes = 0;
+		size_t i;
+		memset(&info, 0, sizeof(rohc_decomp_general_info_t));
+		CHECK(rohc_decomp_get_general_info(decomp, &info) == true);
+		memset(&stats, 0, sizeof(rohc_packet_stats_t));
+		CHECK(rohc_decomp_get_packet_stats(NULL, &stats) == false);
+		CHECK(rohc_decomp_get_packet_stats(decomp, NULL) == false);
+		stats.version_major = 0xffff;
+		CHECK(rohc_decomp_get_packet_stats(decomp, &stats) == false);
+		stats.version_major = 0;
+		stats.version_minor = 0xffff;
+		CHECK(rohc_decomp_get_packet_stats(decomp, &stats) == false);
+		stats.version_minor = 0;
+		CHECK(rohc_decomp_get_packet_stats(decomp, &stats) == true);
+		for(i = 0; i < ROHC_PROFILE_MAX; i++)
+		{
+			profiles_packets += stats.profiles[i].packets_nr;
+			profiles_bytes += stats.profiles[i].comp_bytes_nr;
+		}
+		for(i = 0; i < ROHC_PACKET_MAX; i++)
+		{
+			types_packets += stats.packet_types[i].packets_nr;
+			types_bytes += stats.packet_types[i].comp_bytes_nr;
+		}
+		CHECK(profiles_packets == types_packets);
+		CHECK(profiles_bytes == info.comp_bytes_nr);
+		CHECK(types_bytes == info.comp_bytes_nr);
+	}
+
+	/* rohc_decomp_get_stage_cycles() and rohc_decomp_get_stage_descr() */
+	{
+		uint64_t cycles;
+		int stage;
+		CHECK(rohc_decomp_get_stage_cycles(NULL, ROHC_DECOMP_STAGE_PARSE, &cycles) == false);
+		CHECK(rohc_decomp_get_stage_cycles(decomp, ROHC_DECOMP_STAGE_MAX, &cycles) == false);
+		CHECK(rohc_decomp_get_stage_cycles(decomp, ROHC_DECOMP_STAGE_PARSE, NULL) == false);
+		for(stage = 0; stage < ROHC_DECOMP_STAGE_MAX; stage++)
+		{
+			/* false if the library was built without --enable-stage-cycles */
+			cycles = 0;
+			if(!rohc_decomp_get_stage_cycles(decomp, stage, &cycles))
+			{
+				CHECK(cycles == 0);
+			}
+			CHECK(strcmp(rohc_decomp_get_stage_descr(stage), "no description") != 0);
+		}
+		CHECK(strcmp(rohc_decomp_get_stage_descr(ROHC_DECOMP_STAGE_MAX),
+		             "no description") == 0);
+	}
+
+	/* rohc_decomp_get_latency_stats() */
+	{
+		rohc_latency_stats_t stats;
+		unsigned long types_packets = 0;
+		size_t i;
+		memset(&stats, 0, sizeof(rohc_latency_stats_t));
+		CHECK(rohc_decomp_get_latency_stats(NULL, &stats) == false);
+		CHECK(rohc_decomp_get_latency_stats(decomp, NULL) == false);
+		stats.version_major = 0xffff;
+		CHECK(rohc_decomp_get_latency_stats(decomp, &stats) == false);
+		stats.version_major = 0;
+		stats.version_minor = 0xffff;
+		CHECK(rohc_decomp_get_latency_stats(decomp, &stats) == false);
+		stats.version_minor = 0;
+		CHECK(rohc_decomp_get_latency_stats(decomp, &stats) == true);
+		CHECK(stats.all.packets_nr > 0);
+		CHECK(stats.all.p50_ns <= stats.all.p99_ns);
+		CHECK(stats.all.p99_ns <= stats.all.p999_ns);
+		CHECK(stats.all.p999_ns <= stats.all.max_ns);
+		CHECK(stats.all.max_ns <= stats.all.total_ns);
+		for(i = 0; i < ROHC_PACKET_MAX; i++)
+		{
+			types_packets += stats.packet_types[i].packets_nr;
+		}
+		CHECK(types_packets == stats.all.packets_nr);
+	}
+
+	/* rohc_decomp_get_memory_usage() */
+	{
+		rohc_decomp_general_info_t info;
+		rohc_memory_usage_t mem;
+		size_t profiles_bytes = 0;
+		size_t i;
+		memset(&info, 0, sizeof(rohc_decomp_general_info_t));
+		CHECK(rohc_decomp_get_general_info(decomp, &info) == true);
+		memset(&mem, 0, sizeof(rohc_memory_usage_t));
+		CHECK(rohc_decomp_get_memory_usage(NULL, &mem) == false);
+		CHECK(rohc_decomp_get_memory_usage(decomp, NULL) == false);
+		mem.version_major = 0xffff;
+		CHECK(rohc_decomp_get_memory_usage(decomp, &mem) == false);
+		mem.version_major = 0;
+		mem.version_minor = 0xffff;
+		CHECK(rohc_decomp_get_memory_usage(decomp, &mem) == false);
+		mem.version_minor = 0;
+		CHECK(rohc_decomp_get_memory_usage(decomp, &mem) == true);
+		CHECK(mem.instance_bytes > 0);
+		CHECK(mem.contexts_nr >= info.contexts_nr);
+		for(i = 0; i < ROHC_PROFILE_MAX; i++)
+		{
+			profiles_bytes += mem.profiles_bytes[i];
+		}
+		CHECK(profiles_bytes == mem.contexts_bytes);
+		CHECK(mem.wlsb_bytes <= mem.contexts_bytes);
+		CHECK(mem.total_bytes ==
+		      (mem.instance_bytes + mem.contexts_bytes + mem.rru_bytes));
 	}
 
 	/* rohc_decomp_get_state_descr() */
@@ -350,16 +821,489 @@ int main(int argc, char *argv[])
 	CHECK(strcmp(rohc_decomp_get_state_descr(ROHC_DECOMP_STATE_FC), "Full Context") == 0);
 	CHECK(strcmp(rohc_decomp_get_state_descr(ROHC_DECOMP_STATE_FC + 1), "no description") == 0);
 
+	/* rohc_decomp_get_trace_records() with some packets already decompressed */
+	{
+		struct rohc_trace_record records[4];
+		size_t records_nr;
+
+		CHECK(rohc_decomp_get_trace_records(decomp, records, 4, &records_nr) == true);
+		CHECK(records_nr > 0);
+	}
+
 	/* several functions with some packets already compressed */
 	{
 		rohc_trace_callback2_t fct = (rohc_trace_callback2_t) NULL;
 		CHECK(rohc_decomp_set_traces_cb2(decomp, fct, decomp) == false);
+		CHECK(rohc_decomp_set_trace_level(decomp, ROHC_TRACE_WARNING) == false);
+		CHECK(rohc_decomp_set_trace_ring(decomp, 8) == false);
+	}
+
+	/* rohc_decomp_reset() */
+	{
+		rohc_decomp_general_info_t info;
+		memset(&info, 0, sizeof(rohc_decomp_general_info_t));
+		CHECK(rohc_decomp_reset(NULL) == false);
+		CHECK(rohc_decomp_get_general_info(decomp, &info) == true);
+		CHECK(info.contexts_nr > 0);
+		CHECK(rohc_decomp_reset(decomp) == true);
+		CHECK(rohc_decomp_get_general_info(decomp, &info) == true);
+		CHECK(info.contexts_nr == 0);
 	}
 
 	/* rohc_decomp_free() */
 	rohc_decomp_free(NULL);
 	rohc_decomp_free(decomp);
 
+	/* rohc_decomp_group_new() */
+	CHECK(rohc_decomp_group_new(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX,
+	                            ROHC_U_MODE, 0) == NULL);
+	CHECK(rohc_decomp_group_new(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX,
+	                            ROHC_U_MODE, ROHC_SMALL_CID_MAX + 2) == NULL);
+	CHECK(rohc_decomp_group_new(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX + 1,
+	                            ROHC_U_MODE, 4) == NULL);
+	{
+		struct rohc_decomp_group *group =
+			rohc_decomp_group_new(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX,
+			                      ROHC_U_MODE, 4);
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t buf_cid5[] = { 0xe5, 0x00, 0x05 };
+		struct rohc_buf pkt_cid5 =
+			rohc_buf_init_full(buf_cid5, sizeof(buf_cid5), ts);
+		uint8_t buf_segment[] = { 0xfe, 0x00 };
+		struct rohc_buf pkt_segment =
+			rohc_buf_init_full(buf_segment, sizeof(buf_segment), ts);
+		uint8_t buf_uncomp[100];
+		struct rohc_buf uncomp = rohc_buf_init_empty(buf_uncomp, 100);
+		uint8_t buf_fb[100];
+		struct rohc_buf fb = rohc_buf_init_empty(buf_fb, 100);
+		struct rohc_buf popped;
+		rohc_status_t status;
+		size_t i;
+
+		CHECK(group != NULL);
+
+		/* rohc_decomp_group_get_worker() */
+		CHECK(rohc_decomp_group_get_worker(NULL, 0) == NULL);
+		CHECK(rohc_decomp_group_get_worker(group, 4) == NULL);
+		CHECK(rohc_decomp_group_get_worker(group, 3) != NULL);
+
+		/* rohc_decomp_group_push() */
+		CHECK(rohc_decomp_group_push(NULL, pkt_cid5) == false);
+		CHECK(rohc_decomp_group_push(group, pkt_segment) == false);
+		for(i = 0; i < 256; i++)
+		{
+			CHECK(rohc_decomp_group_push(group, pkt_cid5) == true);
+		}
+		CHECK(rohc_decomp_group_push(group, pkt_cid5) == false);
+
+		/* rohc_decomp_group_decompress() */
+		CHECK(rohc_decomp_group_decompress(NULL, 1, &popped, &uncomp, NULL,
+		                                   &status) == false);
+		CHECK(rohc_decomp_group_decompress(group, 4, &popped, &uncomp, NULL,
+		                                   &status) == false);
+		CHECK(rohc_decomp_group_decompress(group, 1, NULL, &uncomp, NULL,
+		                                   &status) == false);
+		CHECK(rohc_decomp_group_decompress(group, 1, &popped, &uncomp, NULL,
+		                                   NULL) == false);
+		CHECK(rohc_decomp_group_decompress(group, 0, &popped, &uncomp, NULL,
+		                                   &status) == false);
+		CHECK(rohc_decomp_group_decompress(group, 1, &popped, &uncomp, NULL,
+		                                   &status) == true);
+		CHECK(popped.data == buf_cid5);
+		CHECK(status == ROHC_STATUS_NO_CONTEXT);
+
+		/* rohc_decomp_group_pull_feedback() */
+		CHECK(rohc_decomp_group_pull_feedback(NULL, &fb) == false);
+		CHECK(rohc_decomp_group_pull_feedback(group, NULL) == false);
+		CHECK(rohc_decomp_group_pull_feedback(group, &fb) == true);
+
+		/* rohc_decomp_group_free() */
+		rohc_decomp_group_free(NULL);
+		rohc_decomp_group_free(group);
+	}
+
+	/* rohc_decomp_snapshot() / rohc_decomp_restore() */
+	{
+		struct rohc_decomp *decomp1 =
+			rohc_decomp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, ROHC_U_MODE);
+		struct rohc_decomp *decomp2 =
+			rohc_decomp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, ROHC_U_MODE);
+		struct rohc_decomp *decomp3 =
+			rohc_decomp_new2(ROHC_SMALL_CID, 5, ROHC_U_MODE);
+		struct snapshot_buf snapshot;
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t buf_ir[] =
+		{
+			0xfc, 0x00, 0xb7,
+			0x45, 0x00, 0x00, 0x1c,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x01, 0x00, 0x00,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x05,  0x08, 0x00, 0xf7, 0xff,
+			0x00, 0x00, 0x00, 0x00
+		};
+		struct rohc_buf pkt_ir = rohc_buf_init_full(buf_ir, sizeof(buf_ir), ts);
+		/* Normal packet: the IP packet without the IR header */
+		struct rohc_buf pkt_normal =
+			rohc_buf_init_full(buf_ir + 3, sizeof(buf_ir) - 3, ts);
+		uint8_t buf_uncomp[100];
+		struct rohc_buf uncomp = rohc_buf_init_empty(buf_uncomp, 100);
+
+		CHECK(decomp1 != NULL);
+		CHECK(decomp2 != NULL);
+		CHECK(decomp3 != NULL);
+		CHECK(rohc_decomp_enable_profile(decomp1, ROHC_PROFILE_UNCOMPRESSED) == true);
+		CHECK(rohc_decomp_enable_profile(decomp2, ROHC_PROFILE_UNCOMPRESSED) == true);
+		CHECK(rohc_decomp_enable_profile(decomp3, ROHC_PROFILE_UNCOMPRESSED) == true);
+
+		/* establish the context on the first decompressor */
+		CHECK(rohc_decompress3(decomp1, pkt_ir, &uncomp, NULL, NULL) == ROHC_STATUS_OK);
+
+		memset(&snapshot, 0, sizeof(struct snapshot_buf));
+		CHECK(rohc_decomp_snapshot(NULL, snapshot_write_cb, &snapshot) == false);
+		CHECK(rohc_decomp_snapshot(decomp1, NULL, &snapshot) == false);
+		CHECK(rohc_decomp_snapshot(decomp1, snapshot_write_cb, &snapshot) == true);
+
+		CHECK(rohc_decomp_restore(NULL, snapshot_read_cb, &snapshot) == false);
+		CHECK(rohc_decomp_restore(decomp2, NULL, &snapshot) == false);
+
+		/* other MAX_CID */
+		snapshot.pos = 0;
+		CHECK(rohc_decomp_restore(decomp3, snapshot_read_cb, &snapshot) == false);
+
+		/* truncated snapshot */
+		snapshot.pos = 0;
+		snapshot.len--;
+		CHECK(rohc_decomp_restore(decomp2, snapshot_read_cb, &snapshot) == false);
+		snapshot.len++;
+
+		/* the second decompressor goes on without IR */
+		snapshot.pos = 0;
+		CHECK(rohc_decomp_restore(decomp2, snapshot_read_cb, &snapshot) == true);
+		CHECK(snapshot.pos == snapshot.len);
+		uncomp.len = 0;
+		CHECK(rohc_decompress3(decomp2, pkt_normal, &uncomp, NULL, NULL) == ROHC_STATUS_OK);
+		CHECK(uncomp.len == pkt_normal.len);
+
+		rohc_decomp_free(decomp1);
+		rohc_decomp_free(decomp2);
+		rohc_decomp_free(decomp3);
+	}
+
+	/* rohc_decomp_snapshot() / rohc_decomp_restore() with an RFC 3095 profile */
+	{
+		struct rohc_decomp *decomp1 =
+			rohc_decomp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, ROHC_U_MODE);
+		struct rohc_decomp *decomp2 =
+			rohc_decomp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, ROHC_U_MODE);
+		struct snapshot_buf snapshot;
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		/* IR packet for IPv4/UDP/RTP with 2 CSRC identifiers, RTP SN 4 */
+		uint8_t buf_ir[] =
+		{
+			0xfd, 0x01, 0xcd, 0x40,  0x11, 0xc0, 0xa8, 0x13,
+			0x01, 0xc0, 0xa8, 0x13,  0x05, 0x04, 0xd2, 0x16,
+			0x2e, 0x12, 0x34, 0x56,  0x78, 0x00, 0x40, 0x00,
+			0x04, 0x20, 0x00, 0x00,  0x00, 0x92, 0x08, 0x00,
+			0x04, 0x00, 0x00, 0x02,  0x80, 0x22, 0x00, 0x89,
+			0x00, 0x00, 0x00, 0x01,  0x00, 0x00, 0x00, 0x02,
+			0x05, 0x80, 0xa0, 0x01,  0x02, 0x03, 0x04
+		};
+		struct rohc_buf pkt_ir = rohc_buf_init_full(buf_ir, sizeof(buf_ir), ts);
+		/* UO-0 packets for RTP SN 7 to 10 */
+		uint8_t buf_uo0[][5] =
+		{
+			{ 0x3b, 0x01, 0x02, 0x03, 0x04 },
+			{ 0x47, 0x01, 0x02, 0x03, 0x04 },
+			{ 0x4a, 0x01, 0x02, 0x03, 0x04 },
+			{ 0x53, 0x01, 0x02, 0x03, 0x04 },
+		};
+		/* the expected IPv4/UDP/RTP packet */
+		uint8_t buf_ip[] =
+		{
+			0x45, 0x00, 0x00, 0x34,  0x00, 0x00, 0x00, 0x00,
+			0x40, 0x11, 0x00, 0x00,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x05,  0x04, 0xd2, 0x16, 0x2e,
+			0x00, 0x20, 0x00, 0x00,  0x82, 0x08, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00,  0x12, 0x34, 0x56, 0x78,
+			0x00, 0x00, 0x00, 0x01,  0x00, 0x00, 0x00, 0x02,
+			0x01, 0x02, 0x03, 0x04
+		};
+		uint8_t buf_uncomp1[100];
+		struct rohc_buf uncomp1 = rohc_buf_init_empty(buf_uncomp1, 100);
+		uint8_t buf_uncomp2[100];
+		struct rohc_buf uncomp2 = rohc_buf_init_empty(buf_uncomp2, 100);
+		size_t i;
+
+		CHECK(decomp1 != NULL);
+		CHECK(decomp2 != NULL);
+		CHECK(rohc_decomp_enable_profile(decomp1, ROHC_PROFILE_RTP) == true);
+		CHECK(rohc_decomp_enable_profile(decomp2, ROHC_PROFILE_RTP) == true);
+
+		/* establish the context on the first decompressor, then save it and
+		 * restore it on the second decompressor */
+		CHECK(rohc_decompress3(decomp1, pkt_ir, &uncomp1, NULL, NULL) == ROHC_STATUS_OK);
+		memset(&snapshot, 0, sizeof(struct snapshot_buf));
+		CHECK(rohc_decomp_snapshot(decomp1, snapshot_write_cb, &snapshot) == true);
+		CHECK(rohc_decomp_restore(decomp2, snapshot_read_cb, &snapshot) == true);
+		CHECK(snapshot.pos == snapshot.len);
+
+		/* both decompressors rebuild the very same packets from the UO-0
+		 * packets: the CSRC list and the TS_STRIDE were restored */
+		for(i = 0; i < 4; i++)
+		{
+			const struct rohc_buf pkt_uo0 =
+				rohc_buf_init_full(buf_uo0[i], sizeof(buf_uo0[i]), ts);
+			const uint8_t sn = 7 + i;
+
+			buf_ip[5] = sn;
+			buf_ip[10] = (0xd362 - sn) >> 8;
+			buf_ip[11] = (0xd362 - sn) & 0xff;
+			buf_ip[31] = sn;
+			buf_ip[34] = (sn * 160) >> 8;
+			buf_ip[35] = (sn * 160) & 0xff;
+
+			uncomp1.len = 0;
+			CHECK(rohc_decompress3(decomp1, pkt_uo0, &uncomp1, NULL, NULL) == ROHC_STATUS_OK);
+			uncomp2.len = 0;
+			CHECK(rohc_decompress3(decomp2, pkt_uo0, &uncomp2, NULL, NULL) == ROHC_STATUS_OK);
+			CHECK(uncomp1.len == sizeof(buf_ip));
+			CHECK(uncomp2.len == sizeof(buf_ip));
+			CHECK(memcmp(rohc_buf_data(uncomp1), buf_ip, sizeof(buf_ip)) == 0);
+			CHECK(memcmp(rohc_buf_data(uncomp2), buf_ip, sizeof(buf_ip)) == 0);
+		}
+
+		rohc_decomp_free(decomp1);
+		rohc_decomp_free(decomp2);
+	}
+
+	/* rohc_decomp_set_journal_cb() / rohc_decomp_journal_apply() */
+	{
+		struct rohc_decomp *decomp1 =
+			rohc_decomp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, ROHC_U_MODE);
+		struct rohc_decomp *decomp2 =
+			rohc_decomp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, ROHC_U_MODE);
+		struct snapshot_buf journal;
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t buf_ir[] =
+		{
+			0xfc, 0x00, 0xb7,
+			0x45, 0x00, 0x00, 0x1c,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x01, 0x00, 0x00,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x05,  0x08, 0x00, 0xf7, 0xff,
+			0x00, 0x00, 0x00, 0x00
+		};
+		struct rohc_buf pkt_ir = rohc_buf_init_full(buf_ir, sizeof(buf_ir), ts);
+		struct rohc_buf pkt_normal =
+			rohc_buf_init_full(buf_ir + 3, sizeof(buf_ir) - 3, ts);
+		uint8_t buf_uncomp[100];
+		struct rohc_buf uncomp = rohc_buf_init_empty(buf_uncomp, 100);
+
+		CHECK(decomp1 != NULL);
+		CHECK(decomp2 != NULL);
+		CHECK(rohc_decomp_enable_profile(decomp1, ROHC_PROFILE_UNCOMPRESSED) == true);
+
+		memset(&journal, 0, sizeof(struct snapshot_buf));
+		CHECK(rohc_decomp_set_journal_cb(NULL, journal_cb, &journal) == false);
+		CHECK(rohc_decomp_set_journal_cb(decomp1, journal_cb, &journal) == true);
+
+		/* the IR packet creates one context, hence one journal record */
+		CHECK(rohc_decompress3(decomp1, pkt_ir, &uncomp, NULL, NULL) == ROHC_STATUS_OK);
+		CHECK(journal.len > 0);
+
+		CHECK(rohc_decomp_journal_apply(NULL, journal.data, journal.len) == false);
+		CHECK(rohc_decomp_journal_apply(decomp2, NULL, journal.len) == false);
+		CHECK(rohc_decomp_journal_apply(decomp2, journal.data, 1) == false);
+
+		/* profile not enabled */
+		CHECK(rohc_decomp_journal_apply(decomp2, journal.data, journal.len) == false);
+		CHECK(rohc_decomp_enable_profile(decomp2, ROHC_PROFILE_UNCOMPRESSED) == true);
+
+		/* trailing bytes */
+		CHECK(rohc_decomp_journal_apply(decomp2, journal.data, journal.len + 1) == false);
+
+		/* the standby decompressor goes on without IR */
+		CHECK(rohc_decomp_journal_apply(decomp2, journal.data, journal.len) == true);
+		uncomp.len = 0;
+		CHECK(rohc_decompress3(decomp2, pkt_normal, &uncomp, NULL, NULL) == ROHC_STATUS_OK);
+
+		/* the journal is disabled */
+		CHECK(rohc_decomp_set_journal_cb(decomp1, NULL, NULL) == true);
+		journal.len = 0;
+		uncomp.len = 0;
+		CHECK(rohc_decompress3(decomp1, pkt_normal, &uncomp, NULL, NULL) == ROHC_STATUS_OK);
+		CHECK(journal.len == 0);
+
+		rohc_decomp_free(decomp1);
+		rohc_decomp_free(decomp2);
+	}
+
+	/* rohc_decomp_flush_feedback() */
+	{
+		struct rohc_decomp *decomp1 =
+			rohc_decomp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, ROHC_U_MODE);
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t buf_ir[] =
+		{
+			0xfc, 0x00, 0xb7,
+			0x45, 0x00, 0x00, 0x1c,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x01, 0x00, 0x00,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x05,  0x08, 0x00, 0xf7, 0xff,
+			0x00, 0x00, 0x00, 0x00
+		};
+		struct rohc_buf pkt_ir = rohc_buf_init_full(buf_ir, sizeof(buf_ir), ts);
+		uint8_t buf_uncomp[100];
+		struct rohc_buf uncomp = rohc_buf_init_empty(buf_uncomp, 100);
+		uint8_t buf_fb[100];
+		struct rohc_buf fb = rohc_buf_init_empty(buf_fb, 100);
+		struct rohc_buf fb_small = rohc_buf_init_empty(buf_fb, 1);
+
+		CHECK(decomp1 != NULL);
+		CHECK(rohc_decomp_enable_profile(decomp1, ROHC_PROFILE_UNCOMPRESSED) == true);
+		CHECK(rohc_decomp_set_features(decomp1, ROHC_DECOMP_FEATURE_DEFERRED_FEEDBACK) == true);
+
+		/* the feedback is not built during decompression */
+		CHECK(rohc_decompress3(decomp1, pkt_ir, &uncomp, NULL, &fb) == ROHC_STATUS_OK);
+		CHECK(fb.len == 0);
+
+		CHECK(rohc_decomp_flush_feedback(NULL, &fb) == false);
+		CHECK(rohc_decomp_flush_feedback(decomp1, NULL) == false);
+
+		/* no room: the feedback is kept for later */
+		CHECK(rohc_decomp_flush_feedback(decomp1, &fb_small) == true);
+		CHECK(fb_small.len == 0);
+
+		/* the ACK is built now, then nothing remains */
+		CHECK(rohc_decomp_flush_feedback(decomp1, &fb) == true);
+		CHECK(fb.len > 0);
+		rohc_buf_reset(&fb);
+		CHECK(rohc_decomp_flush_feedback(decomp1, &fb) == true);
+		CHECK(fb.len == 0);
+
+		rohc_decomp_free(decomp1);
+	}
+
+	/* rohc_decomp_set_feedback_coalescing() */
+	{
+		struct rohc_decomp *decomp1 =
+			rohc_decomp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, ROHC_U_MODE);
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t buf_ir[] =
+		{
+			0xfc, 0x00, 0xb7,
+			0x45, 0x00, 0x00, 0x1c,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x01, 0x00, 0x00,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x05,  0x08, 0x00, 0xf7, 0xff,
+			0x00, 0x00, 0x00, 0x00
+		};
+		struct rohc_buf pkt_ir = rohc_buf_init_full(buf_ir, sizeof(buf_ir), ts);
+		uint8_t buf_uncomp[100];
+		struct rohc_buf uncomp = rohc_buf_init_empty(buf_uncomp, 100);
+		uint8_t buf_fb[100];
+		struct rohc_buf fb = rohc_buf_init_empty(buf_fb, 100);
+		size_t i;
+
+		CHECK(decomp1 != NULL);
+		CHECK(rohc_decomp_enable_profile(decomp1, ROHC_PROFILE_UNCOMPRESSED) == true);
+
+		CHECK(rohc_decomp_set_feedback_coalescing(NULL, 3, 0) == false);
+		CHECK(rohc_decomp_set_feedback_coalescing(decomp1, 3, 0) == true);
+
+		/* the ACKs of the first 2 packets wait, the 3rd packet closes the
+		 * window and sends the latest ACK only */
+		for(i = 0; i < 2; i++)
+		{
+			rohc_buf_reset(&uncomp);
+			CHECK(rohc_decompress3(decomp1, pkt_ir, &uncomp, NULL, &fb) == ROHC_STATUS_OK);
+			CHECK(fb.len == 0);
+		}
+		rohc_buf_reset(&uncomp);
+		CHECK(rohc_decompress3(decomp1, pkt_ir, &uncomp, NULL, &fb) == ROHC_STATUS_OK);
+		CHECK(fb.len == 2); /* one FEEDBACK-1 */
+
+		rohc_decomp_free(decomp1);
+	}
+
+	/* rohc_decomp_set_feedback_budget() */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t buf_ir[] =
+		{
+			0xfc, 0x00, 0xb7,
+			0x45, 0x00, 0x00, 0x1c,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x01, 0x00, 0x00,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x05,  0x08, 0x00, 0xf7, 0xff,
+			0x00, 0x00, 0x00, 0x00
+		};
+		struct rohc_buf pkt_ir = rohc_buf_init_full(buf_ir, sizeof(buf_ir), ts);
+		uint8_t buf_uncomp[100];
+		struct rohc_buf uncomp = rohc_buf_init_empty(buf_uncomp, 100);
+		uint8_t buf_fb[100];
+		struct rohc_buf fb = rohc_buf_init_empty(buf_fb, 100);
+		size_t budget;
+
+		CHECK(rohc_decomp_set_feedback_budget(NULL, 2) == false);
+
+		/* a 1-byte budget is too small for the 2-byte FEEDBACK-1 */
+		for(budget = 1; budget <= 2; budget++)
+		{
+			struct rohc_decomp *decomp1 =
+				rohc_decomp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, ROHC_U_MODE);
+
+			CHECK(decomp1 != NULL);
+			CHECK(rohc_decomp_enable_profile(decomp1, ROHC_PROFILE_UNCOMPRESSED) == true);
+			CHECK(rohc_decomp_set_feedback_budget(decomp1, budget) == true);
+
+			rohc_buf_reset(&uncomp);
+			rohc_buf_reset(&fb);
+			CHECK(rohc_decompress3(decomp1, pkt_ir, &uncomp, NULL, &fb) == ROHC_STATUS_OK);
+			CHECK(fb.len == (budget - 1) * 2);
+
+			rohc_decomp_free(decomp1);
+		}
+	}
+
+	/* rohc_decomp_set_feedback_cb() */
+	{
+		struct rohc_decomp *decomp1 =
+			rohc_decomp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, ROHC_U_MODE);
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t buf_ir[] =
+		{
+			0xf1, 0x42, /* one piggybacked FEEDBACK-1 */
+			0xfc, 0x00, 0xb7,
+			0x45, 0x00, 0x00, 0x1c,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x01, 0x00, 0x00,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x05,  0x08, 0x00, 0xf7, 0xff,
+			0x00, 0x00, 0x00, 0x00
+		};
+		struct rohc_buf pkt_ir = rohc_buf_init_full(buf_ir, sizeof(buf_ir), ts);
+		uint8_t buf_uncomp[100];
+		struct rohc_buf uncomp = rohc_buf_init_empty(buf_uncomp, 100);
+		uint8_t buf_rcvd[100];
+		struct rohc_buf rcvd = rohc_buf_init_empty(buf_rcvd, 100);
+		struct rohc_buf rcvd_item = rohc_buf_init_empty(buf_rcvd, 0);
+
+		CHECK(decomp1 != NULL);
+		CHECK(rohc_decomp_enable_profile(decomp1, ROHC_PROFILE_UNCOMPRESSED) == true);
+
+		CHECK(rohc_decomp_set_feedback_cb(NULL, feedback_cb, &rcvd_item) == false);
+		CHECK(rohc_decomp_set_feedback_cb(decomp1, feedback_cb, &rcvd_item) == true);
+
+		/* the feedback item points into the ROHC packet, nothing is copied */
+		CHECK(rohc_decompress3(decomp1, pkt_ir, &uncomp, &rcvd, NULL) == ROHC_STATUS_OK);
+		CHECK(rcvd.len == 0);
+		CHECK(rcvd_item.len == 2);
+		CHECK(rohc_buf_data(rcvd_item) == buf_ir);
+
+		/* the feedback item is copied again once the callback is removed */
+		CHECK(rohc_decomp_set_feedback_cb(decomp1, NULL, NULL) == true);
+		rohc_buf_reset(&uncomp);
+		CHECK(rohc_decompress3(decomp1, pkt_ir, &uncomp, &rcvd, NULL) == ROHC_STATUS_OK);
+		CHECK(rcvd.len == 2);
+		CHECK(rohc_buf_byte_at(rcvd, 1) == 0x42);
+
+		rohc_decomp_free(decomp1);
+	}
+
 	/* test succeeds */
 	trace(verbose, "all tests are successful\n");
 	is_failure = 0;
@@ -368,3 +1312,114 @@ error:
 	return is_failure;
 }
 
+
+
+/**
+ * @brief Write the given bytes at the end of the in-memory snapshot
+ *
+ * @param priv  The in-memory snapshot
+ * @param data  The bytes to write
+ * @param len   The number of bytes to write
+ * @return      true if the bytes were written, false if there is no room
+ */
+static bool snapshot_write_cb(void *const priv,
+                              const uint8_t *const data,
+                              const size_t len)
+{
+	struct snapshot_buf *const snapshot = priv;
+
+	if((snapshot->len + len) > sizeof(snapshot->data))
+	{
+		return false;
+	}
+	memcpy(snapshot->data + snapshot->len, data, len);
+	snapshot->len += len;
+
+	return true;
+}
+
+
+/**
+ * @brief Read the next bytes of the in-memory snapshot
+ *
+ * @param priv  The in-memory snapshot
+ * @param data  OUT: The bytes read
+ * @param len   The number of bytes to read
+ * @return      true if the bytes were read, false if the snapshot is too short
+ */
+static bool snapshot_read_cb(void *const priv,
+                             uint8_t *const data,
+                             const size_t len)
+{
+	struct snapshot_buf *const snapshot = priv;
+
+	if((snapshot->pos + len) > snapshot->len)
+	{
+		return false;
+	}
+	memcpy(data, snapshot->data + snapshot->pos, len);
+	snapshot->pos += len;
+
+	return true;
+}
+
+
+/**
+ * @brief Keep the last journal record in memory
+ *
+ * @param priv        The in-memory journal record
+ * @param record      The journal record
+ * @param record_len  The length of the journal record
+ */
+static void journal_cb(void *const priv,
+                       const uint8_t *const record,
+                       const size_t record_len)
+{
+	struct snapshot_buf *const journal = priv;
+
+	assert(record_len < sizeof(journal->data));
+	memcpy(journal->data, record, record_len);
+	journal->len = record_len;
+}
+
+
+/**
+ * @brief Keep the last received feedback item in memory
+ *
+ * @param priv      The received feedback item
+ * @param feedback  The feedback item
+ */
+static void feedback_cb(void *const priv,
+                        const struct rohc_buf feedback)
+{
+	struct rohc_buf *const rcvd = priv;
+
+	*rcvd = feedback;
+}
+
+
+/**
+ * @brief Find the frames with a 1-byte length in front of the ROHC packet
+ *
+ * @param priv              Unused
+ * @param data              The first bytes of the stream
+ * @param data_len          The number of bytes
+ * @param[out] frame_len    The length of the first frame
+ * @param[out] rohc_offset  The offset of the ROHC packet in the frame
+ * @param[out] rohc_len     The length of the ROHC packet
+ * @return                  Always true
+ */
+static bool frame_cb(void *const priv __attribute__((unused)),
+                     const uint8_t *const data,
+                     const size_t data_len,
+                     size_t *const frame_len,
+                     size_t *const rohc_offset,
+                     size_t *const rohc_len)
+{
+	assert(data_len > 0);
+	*frame_len = 1 + data[0];
+	*rohc_offset = 1;
+	*rohc_len = data[0];
+
+	return true;
+}
@@ -0,0 +1,441 @@
+/*
+ * Copyright 2026 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file    test_decomp_batch.c
+ * @brief   Test the order of the decompression of a burst of ROHC packets
+ * @author  Didier Barvaux <didier@barvaux.org>
+ *
+ * A burst of ROHC packets of the Uncompressed profile that interleaves 3
+ * CIDs, a feedback-only packet and a non-final ROHC segment is decompressed
+ * twice: once in the given order, once grouped by CID. The decompressor
+ * records the packets in the order it processes them, so the recording tells
+ * whether the packets of every CID were processed back to back in their given
+ * order and whether the feedback-only packet and the segment were not moved.
+ * Both runs shall store the very same results at the indexes of the given
+ * packets.
+ */
+
+#include "rohc_decomp.h"
+#include "crc.h"
+#include "rohc_record.h"
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdarg.h>
+#include <string.h>
+#include <assert.h>
+
+
+/** Print trace on stdout only in verbose mode */
+#define trace(is_verbose, format, ...) \
+	do { \
+		if(is_verbose) { \
+			printf(format, ##__VA_ARGS__); \
+		} \
+	} while(0)
+
+/** Improved assert() */
+#define CHECK(condition) \
+	do { \
+		trace(verbose, "test '%s'\n", #condition); \
+		fflush(stdout); \
+		assert(condition); \
+	} while(0)
+
+/** The number of packets in the burst */
+#define PKTS_NR  13U
+
+/** The CID of the packets that carry no ROHC header */
+#define NO_CID  0xffU
+
+/** The length of the IPv4 packets of the burst */
+#define IP_PKT_LEN  24U
+
+/** The maximum length of one ROHC packet of the burst */
+#define ROHC_PKT_MAX_LEN  (1U + 3U + IP_PKT_LEN)
+
+/** The recording of the packets given to the decompressor */
+struct recording
+{
+	uint8_t data[2048];  /**< The bytes of the recording */
+	size_t len;          /**< The number of bytes written */
+};
+
+/** The ROHC packets of the burst, the feedback-only packet and the segment
+ *  carry no CID */
+static const struct
+{
+	uint8_t cid;   /**< The CID of the packet */
+	bool is_ir;    /**< Whether the packet is an IR packet */
+} burst[PKTS_NR] =
+{
+	{ 1, true }, { 2, true }, { 1, false }, { 3, true }, { 2, false },
+	{ 1, false }, { NO_CID, false }, { 3, false }, { 2, false },
+	{ NO_CID, false }, { 1, false }, { 3, false }, { 1, false },
+};
+
+/** The index of the feedback-only packet in the burst */
+#define PKT_FEEDBACK_ONLY  6U
+
+/** The index of the ROHC segment in the burst */
+#define PKT_SEGMENT  9U
+
+/** The order of the processing of the packets grouped by CID: the
+ *  feedback-only packet and the segment split the burst in 3 spans */
+static const size_t grouped_order[PKTS_NR] =
+{
+	0, 2, 5, 1, 4, 3, PKT_FEEDBACK_ONLY, 7, 8, PKT_SEGMENT, 10, 12, 11
+};
+
+/** The results of the decompression of one burst */
+struct burst_results
+{
+	rohc_status_t statuses[PKTS_NR];           /**< The statuses */
+	uint8_t uncomp_data[PKTS_NR][IP_PKT_LEN];  /**< The packets */
+	size_t uncomp_lens[PKTS_NR];               /**< Their lengths */
+	size_t order[PKTS_NR];                     /**< The processing order */
+};
+
+static void build_ip_pkt(const size_t index, uint8_t ip_pkt[IP_PKT_LEN]);
+static size_t build_rohc_pkt(const size_t index,
+                             uint8_t rohc_pkt[ROHC_PKT_MAX_LEN]);
+static void run_burst(const bool verbose,
+                      const bool group_by_cid,
+                      struct burst_results *const results);
+static bool record_write_cb(void *const priv,
+                            const uint8_t *const data,
+                            const size_t len)
+	__attribute__((warn_unused_result));
+
+static void print_trace(void *const priv_ctxt,
+                        const rohc_trace_level_t level,
+                        const rohc_trace_entity_t entity,
+                        const int profile,
+                        const char *const format,
+                        ...)
+	__attribute__((format(printf, 5, 6)));
+
+
+/**
+ * @brief Test the order of the decompression of a burst of ROHC packets
+ *
+ * @param argc  The number of command line arguments
+ * @param argv  The command line arguments
+ * @return      0 if test succeeds, non-zero if test fails
+ */
+int main(int argc, char *argv[])
+{
+	struct burst_results given;
+	struct burst_results grouped;
+	bool verbose; /* whether to run in verbose mode or not */
+	size_t i;
+	size_t j;
+
+	/* do we run in verbose mode ? */
+	if(argc == 1)
+	{
+		/* no argument, run in silent mode */
+		verbose = false;
+	}
+	else if(argc == 2 && strcmp(argv[1], "verbose") == 0)
+	{
+		/* run in verbose mode */
+		verbose = true;
+	}
+	else
+	{
+		/* invalid usage */
+		printf("test the order of the decompression of a burst of ROHC "
+		       "packets\n");
+		printf("usage: %s [verbose]\n", argv[0]);
+		goto error;
+	}
+
+	run_burst(verbose, false, &given);
+	run_burst(verbose, true, &grouped);
+
+	/* without grouping, the packets are processed in the given order */
+	for(i = 0; i < PKTS_NR; i++)
+	{
+		CHECK(given.order[i] == i);
+	}
+
+	/* with grouping, the packets of one CID are processed back to back in
+	 * their given order, the packets without CID are not moved */
+	for(i = 0; i < PKTS_NR; i++)
+	{
+		CHECK(grouped.order[i] == grouped_order[i]);
+		for(j = 0; j < i; j++)
+		{
+			if(burst[grouped.order[j]].cid == burst[grouped.order[i]].cid)
+			{
+				CHECK(grouped.order[j] < grouped.order[i]);
+			}
+		}
+	}
+	CHECK(grouped.order[PKT_FEEDBACK_ONLY] == PKT_FEEDBACK_ONLY);
+	CHECK(grouped.order[PKT_SEGMENT] == PKT_SEGMENT);
+
+	/* both runs store the same results at the indexes of the given packets */
+	for(i = 0; i < PKTS_NR; i++)
+	{
+		uint8_t ip_pkt[IP_PKT_LEN];
+
+		CHECK(given.statuses[i] == ROHC_STATUS_OK);
+		CHECK(grouped.statuses[i] == ROHC_STATUS_OK);
+		if(burst[i].cid == NO_CID)
+		{
+			CHECK(given.uncomp_lens[i] == 0);
+			CHECK(grouped.uncomp_lens[i] == 0);
+		}
+		else
+		{
+			build_ip_pkt(i, ip_pkt);
+			CHECK(given.uncomp_lens[i] == IP_PKT_LEN);
+			CHECK(grouped.uncomp_lens[i] == IP_PKT_LEN);
+			CHECK(memcmp(given.uncomp_data[i], ip_pkt, IP_PKT_LEN) == 0);
+			CHECK(memcmp(grouped.uncomp_data[i], ip_pkt, IP_PKT_LEN) == 0);
+		}
+	}
+
+	trace(verbose, "all tests are successful\n");
+	return 0;
+
+error:
+	return 1;
+}
+
+
+/**
+ * @brief Build the IPv4 packet of the given packet of the burst
+ *
+ * The IP-ID and the payload of the IPv4 packet are the index of the packet in
+ * the burst, so that the decompressed packets cannot be mixed up.
+ *
+ * @param index        The index of the packet in the burst
+ * @param[out] ip_pkt  The IPv4 packet
+ */
+static void build_ip_pkt(const size_t index, uint8_t ip_pkt[IP_PKT_LEN])
+{
+	const uint8_t ip_hdr[] = {
+		0x45, 0x00, 0x00, IP_PKT_LEN, 0x00, 0x00, 0x00, 0x00,
+		0x40, 0xfd, 0x00, 0x00, 0xc0, 0xa8, 0x00, 0x01,
+		0xc0, 0xa8, 0x00, 0x02
+	};
+
+	memcpy(ip_pkt, ip_hdr, sizeof(ip_hdr));
+	ip_pkt[5] = index;
+	memset(ip_pkt + sizeof(ip_hdr), index, IP_PKT_LEN - sizeof(ip_hdr));
+}
+
+
+/**
+ * @brief Build the ROHC packet of the given packet of the burst
+ *
+ * The ROHC packet is a feedback-only packet, a non-final ROHC segment, or an
+ * IR or a Normal packet of the Uncompressed profile with an Add-CID octet.
+ *
+ * @param index          The index of the packet in the burst
+ * @param[out] rohc_pkt  The ROHC packet
+ * @return               The length of the ROHC packet
+ */
+static size_t build_rohc_pkt(const size_t index,
+                             uint8_t rohc_pkt[ROHC_PKT_MAX_LEN])
+{
+	size_t len = 0;
+
+	if(index == PKT_FEEDBACK_ONLY)
+	{
+		/* feedback item: code 1 means 1 byte of feedback data */
+		rohc_pkt[len++] = 0xf1;
+		rohc_pkt[len++] = index;
+		return len;
+	}
+	if(index == PKT_SEGMENT)
+	{
+		/* non-final segment, the RRU is never completed */
+		rohc_pkt[len++] = 0xfe;
+		rohc_pkt[len++] = 0x00;
+		rohc_pkt[len++] = 0x01;
+		return len;
+	}
+
+	/* Add-CID octet */
+	rohc_pkt[len++] = 0xe0 | burst[index].cid;
+	if(burst[index].is_ir)
+	{
+		/* IR type, profile ID and CRC-8 computed on the Add-CID octet, the IR
+		 * type and the profile ID */
+		rohc_pkt[len++] = 0xfc;
+		rohc_pkt[len++] = ROHC_PROFILE_UNCOMPRESSED;
+		rohc_pkt[len] = crc_calculate(ROHC_CRC_TYPE_8, rohc_pkt + len - 3, 3,
+		                              CRC_INIT_8, rohc_crc_table_8);
+		len++;
+	}
+	build_ip_pkt(index, rohc_pkt + len);
+	len += IP_PKT_LEN;
+
+	return len;
+}
+
+
+/**
+ * @brief Decompress the burst of ROHC packets
+ *
+ * @param verbose       Whether to print traces or not
+ * @param group_by_cid  Whether the packets are grouped by CID or not
+ * @param[out] results  The results of the decompression of the burst
+ */
+static void run_burst(const bool verbose,
+                      const bool group_by_cid,
+                      struct burst_results *const results)
+{
+	uint8_t rohc_data[PKTS_NR][ROHC_PKT_MAX_LEN];
+	struct rohc_buf rohc_pkts[PKTS_NR];
+	struct rohc_buf uncomp_pkts[PKTS_NR];
+	uint8_t feedback_data[ROHC_PKT_MAX_LEN];
+	struct rohc_buf rcvd_feedback =
+		rohc_buf_init_empty(feedback_data, ROHC_PKT_MAX_LEN);
+	struct recording recording = { .len = 0 };
+	struct rohc_record_event event;
+	struct rohc_decomp *decomp;
+	size_t pos;
+	size_t i;
+	size_t j;
+
+	trace(verbose, "decompress the burst %s\n",
+	      group_by_cid ? "grouped by CID" : "in the given order");
+
+	decomp = rohc_decomp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, ROHC_U_MODE);
+	CHECK(decomp != NULL);
+	if(verbose)
+	{
+		CHECK(rohc_decomp_set_traces_cb2(decomp, print_trace, NULL));
+	}
+	CHECK(rohc_decomp_enable_profile(decomp, ROHC_PROFILE_UNCOMPRESSED));
+	CHECK(rohc_decomp_set_mrru(decomp, 100));
+	CHECK(rohc_decomp_set_features(decomp, group_by_cid ?
+	                               ROHC_DECOMP_FEATURE_GROUP_BY_CID :
+	                               ROHC_DECOMP_FEATURE_NONE));
+	CHECK(rohc_decomp_set_recorder(decomp, record_write_cb, &recording, 0));
+
+	for(i = 0; i < PKTS_NR; i++)
+	{
+		const size_t len = build_rohc_pkt(i, rohc_data[i]);
+		const struct rohc_ts arrival_time = { .sec = 0, .nsec = 0 };
+		const struct rohc_buf rohc_pkt =
+			rohc_buf_init_full(rohc_data[i], len, arrival_time);
+		const struct rohc_buf uncomp_pkt =
+			rohc_buf_init_empty(results->uncomp_data[i], IP_PKT_LEN);
+
+		rohc_pkts[i] = rohc_pkt;
+		uncomp_pkts[i] = uncomp_pkt;
+	}
+
+	CHECK(rohc_decompress_batch(decomp, rohc_pkts, uncomp_pkts,
+	                            results->statuses, PKTS_NR, &rcvd_feedback,
+	                            NULL));
+
+	/* the feedback-only packet was delivered */
+	CHECK(rcvd_feedback.len == 2);
+	CHECK(rohc_buf_byte_at(rcvd_feedback, 1) == PKT_FEEDBACK_ONLY);
+	for(i = 0; i < PKTS_NR; i++)
+	{
+		results->uncomp_lens[i] = uncomp_pkts[i].len;
+	}
+
+	/* the packets were recorded in processing order, find them back in the
+	 * burst */
+	CHECK(recording.len >= sizeof(struct rohc_record_hdr));
+	pos = sizeof(struct rohc_record_hdr);
+	for(i = 0; i < PKTS_NR; i++)
+	{
+		CHECK((pos + sizeof(struct rohc_record_event)) <= recording.len);
+		memcpy(&event, recording.data + pos, sizeof(struct rohc_record_event));
+		pos += sizeof(struct rohc_record_event);
+		CHECK(event.type == ROHC_RECORD_PKT);
+		CHECK((pos + event.len) <= recording.len);
+		for(j = 0; j < PKTS_NR; j++)
+		{
+			if(event.len == rohc_pkts[j].len &&
+			   memcmp(recording.data + pos, rohc_data[j], event.len) == 0)
+			{
+				break;
+			}
+		}
+		CHECK(j < PKTS_NR);
+		pos += event.len;
+		results->order[i] = j;
+		trace(verbose, "packet #%zu processed at position %zu\n", j, i);
+	}
+	CHECK(pos == recording.len);
+
+	rohc_decomp_free(decomp);
+}
+
+
+/**
+ * @brief Append the given bytes to the recording kept in memory
+ *
+ * @param priv  The recording
+ * @param data  The bytes to append
+ * @param len   The number of bytes to append
+ * @return      true if the bytes were appended,
+ *              false if the recording is full
+ */
+static bool record_write_cb(void *const priv,
+                            const uint8_t *const data,
+                            const size_t len)
+{
+	struct recording *const recording = priv;
+
+	if((recording->len + len) > sizeof(recording->data))
+	{
+		return false;
+	}
+	memcpy(recording->data + recording->len, data, len);
+	recording->len += len;
+
+	return true;
+}
+
+
+/**
+ * @brief Print the traces of the library on stdout
+ *
+ * @param priv_ctxt  An optional private context, may be NULL
+ * @param level      The priority level of the trace
+ * @param entity     The entity that emitted the trace
+ * @param profile    The ID of the ROHC compression/decompression profile
+ *                   the trace is related to
+ * @param format     The format string of the trace
+ */
+static void print_trace(void *const priv_ctxt __attribute__((unused)),
+                        const rohc_trace_level_t level __attribute__((unused)),
+                        const rohc_trace_entity_t entity __attribute__((unused)),
+                        const int profile __attribute__((unused)),
+                        const char *const format,
+                        ...)
+{
+	va_list args;
+
+	va_start(args, format);
+	vprintf(format, args);
+	va_end(args);
+}
@@ -0,0 +1,138 @@
+/*
+ * Copyright 2026 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   rohc_attach.c
+ * @brief  Exchange the feedback between a compressor and a decompressor
+ * @author Didier Barvaux <didier@barvaux.org>
+ *
+ * The compression and decompression libraries do not depend on each other:
+ * the compressor and the decompressor of one side of a bidirectional link
+ * are coupled here, through their feedback callbacks.
+ */
+
+#include "rohc_comp_internals.h"
+#include "rohc_decomp.h"
+
+
+/**
+ * @brief Give the feedback of the attached decompressor to piggyback
+ *
+ * @param priv          The attached decompressor
+ * @param[out] feedback  The buffer where to append the feedback
+ * @return              true if successful, false if a problem occurred
+ */
+static bool rohc_attach_flush_feedback(void *const priv,
+                                       struct rohc_buf *const feedback)
+{
+	struct rohc_decomp *const decomp = priv;
+
+	return rohc_decomp_flush_feedback(decomp, feedback);
+}
+
+
+/**
+ * @brief Deliver the feedback received by the attached decompressor
+ *
+ * @param priv      The compressor
+ * @param feedback  The feedback item received by the decompressor
+ */
+static void rohc_attach_deliver_feedback(void *const priv,
+                                         const struct rohc_buf feedback)
+{
+	struct rohc_comp *const comp = priv;
+
+	if(!rohc_comp_deliver_feedback2(comp, feedback))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "failed to deliver the feedback received by the attached "
+		             "decompressor");
+	}
+}
+
+
+/**
+ * @brief Attach a decompressor to the compressor of the same side of a link
+ *
+ * On a bidirectional link, the compressor and the decompressor of one side
+ * exchange feedback: the decompressor sends its feedback to the remote
+ * compressor in the ROHC packets of the local compressor, and the local
+ * compressor receives its feedback in the ROHC packets of the decompressor.
+ * Once attached, the pair exchanges that feedback without the application:
+ *  \li the feedback built by the decompressor is piggybacked in front of the
+ *      next ROHC packet built by \ref rohc_compress4, up to 32 bytes of
+ *      feedback per ROHC packet; the \ref ROHC_DECOMP_FEATURE_DEFERRED_FEEDBACK
+ *      feature shall be enabled on the decompressor for its feedback to wait
+ *      for the next ROHC packet;
+ *  \li the feedback received by the decompressor is delivered to the
+ *      compressor directly from the ROHC packet, without any copy (see
+ *      \ref rohc_decomp_set_feedback_cb).
+ *
+ * The piggybacked feedback takes room in the output buffer of the compressor.
+ * It is lost if the ROHC packet is segmented or cannot be compressed.
+ *
+ * The compressor and the decompressor shall be used by the same thread. The
+ * decompressor shall be detached before the compressor or the decompressor
+ * is destroyed.
+ *
+ * @param comp    The ROHC compressor
+ * @param decomp  The ROHC decompressor to attach,
+ *                NULL to detach the decompressor attached before
+ * @return        true if the decompressor was successfully attached,
+ *                false if a problem occurred
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_decomp_flush_feedback
+ * @see rohc_decomp_set_feedback_cb
+ */
+bool rohc_comp_attach_decomp(struct rohc_comp *const comp,
+                             struct rohc_decomp *const decomp)
+{
+	struct rohc_decomp *old_decomp;
+
+	if(comp == NULL)
+	{
+		goto error;
+	}
+
+	/* detach the decompressor attached before if any */
+	old_decomp = rohc_comp_set_feedback_source(comp, NULL, NULL);
+	if(old_decomp != NULL && !rohc_decomp_set_feedback_cb(old_decomp, NULL, NULL))
+	{
+		goto error;
+	}
+
+	/* exchange the feedback with the new decompressor */
+	if(decomp != NULL)
+	{
+		if(!rohc_decomp_set_feedback_cb(decomp, rohc_attach_deliver_feedback, comp))
+		{
+			goto error;
+		}
+		rohc_comp_set_feedback_source(comp, rohc_attach_flush_feedback, decomp);
+		rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		          "decompressor attached to exchange feedback");
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
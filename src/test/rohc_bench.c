@@ -0,0 +1,721 @@
+/*
+ * Copyright 2016 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file    rohc_bench.c
+ * @brief   Measure the performances of the building blocks of the library
+ * @author  Didier Barvaux <didier@barvaux.org>
+ *
+ * Every benchmark is run once to calibrate the number of iterations that last
+ * at least the minimum measurement time, then it is run several times with
+ * that number of iterations. The median and minimum times per operation are
+ * reported, one line per benchmark with tab-separated columns, so that the
+ * results of two library versions can be compared by scripts.
+ *
+ * Run with 'make bench'.
+ */
+
+#include "crc.h"
+#include "rohc_cpu.h"
+#include "sdvl.h"
+#include "interval.h"
+#include "schemes/comp_wlsb.h"
+#include "schemes/decomp_wlsb.h"
+#include "comp/schemes/tcp_sack.h"
+#include "decomp/schemes/tcp_sack.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#if defined(__i386__) || defined(__x86_64__)
+#  include <x86intrin.h>
+#endif
+
+
+/** The default number of measurements for every benchmark */
+#define BENCH_REPS_DEFAULT      7U
+/** The max number of measurements for every benchmark */
+#define BENCH_REPS_MAX          101U
+/** The default minimum duration of one measurement (in ms) */
+#define BENCH_MIN_TIME_DEFAULT  20U
+
+/** The size of the data the CRCs are computed on */
+#define BENCH_DATA_LEN          1500U
+/** The number of different values used by the encoding benchmarks */
+#define BENCH_VALUES_NR         256U
+/** The number of different TCP SACK options used by the SACK benchmarks */
+#define BENCH_SACK_NR           256U
+/** The max length of one compressed TCP SACK option */
+#define BENCH_SACK_ROHC_MAX     (1U + TCP_SACK_BLOCKS_MAX_NR * 2U * 5U)
+
+
+/** The data shared by all the benchmarks */
+struct bench_data
+{
+	uint8_t buf[BENCH_DATA_LEN];       /**< Some pseudo-random bytes */
+	uint32_t values[BENCH_VALUES_NR];  /**< Some increasing values */
+	uint8_t sdvl[BENCH_VALUES_NR][5];  /**< The values encoded with SDVL */
+	struct c_wlsb *wlsb16;             /**< A full 16-bit W-LSB window */
+	struct c_wlsb *wlsb32;             /**< A full 32-bit W-LSB window */
+	struct rohc_lsb_decode *lsb;       /**< A 32-bit LSB decoding context */
+
+	/** Some TCP SACK options as seen on a lossy link */
+	sack_block_t sack_blocks[BENCH_SACK_NR][TCP_SACK_BLOCKS_MAX_NR];
+	uint32_t sack_acks[BENCH_SACK_NR];  /**< The ACK numbers of the options */
+	uint8_t sack_lens[BENCH_SACK_NR];   /**< The lengths of the SACK blocks */
+	/** The TCP SACK options compressed */
+	uint8_t sack_rohc[BENCH_SACK_NR][BENCH_SACK_ROHC_MAX];
+	size_t sack_rohc_lens[BENCH_SACK_NR]; /**< The compressed lengths */
+};
+
+
+/** One benchmark */
+struct bench
+{
+	const char *name;  /**< The name of the benchmark */
+	/** The function that runs the given number of iterations */
+	uint32_t (*run)(const struct bench_data *const data, const size_t iters);
+};
+
+
+/** Prevent the compiler from optimizing benchmark loops away */
+static volatile uint32_t bench_sink;
+
+/** The compression context the TCP SACK options are compressed with */
+static struct rohc_comp bench_comp = { .trace_callback = NULL };
+static struct rohc_comp_profile bench_comp_profile = { .id = ROHC_PROFILE_TCP };
+static const struct rohc_comp_ctxt bench_comp_ctxt =
+	{ .compressor = &bench_comp, .profile = &bench_comp_profile };
+
+/** The decompression context the TCP SACK options are decoded with */
+static struct rohc_decomp bench_decomp = { .trace_callback = NULL };
+static struct rohc_decomp_profile bench_decomp_profile = { .id = ROHC_PROFILE_TCP };
+static const struct rohc_decomp_ctxt bench_decomp_ctxt =
+	{ .decompressor = &bench_decomp, .profile = &bench_decomp_profile };
+
+
+static uint32_t bench_crc3_40(const struct bench_data *const data,
+                              const size_t iters);
+static uint32_t bench_crc7_40(const struct bench_data *const data,
+                              const size_t iters);
+static uint32_t bench_crc8_40(const struct bench_data *const data,
+                              const size_t iters);
+static uint32_t bench_crc8_128(const struct bench_data *const data,
+                               const size_t iters);
+static uint32_t bench_fcs32_64(const struct bench_data *const data,
+                               const size_t iters);
+static uint32_t bench_fcs32_1500(const struct bench_data *const data,
+                                 const size_t iters);
+static uint32_t bench_sdvl_encode(const struct bench_data *const data,
+                                  const size_t iters);
+static uint32_t bench_sdvl_decode(const struct bench_data *const data,
+                                  const size_t iters);
+static uint32_t bench_f_16bits(const struct bench_data *const data,
+                               const size_t iters);
+static uint32_t bench_f_32bits(const struct bench_data *const data,
+                               const size_t iters);
+static uint32_t bench_wlsb_get_k_16bits(const struct bench_data *const data,
+                                        const size_t iters);
+static uint32_t bench_wlsb_get_k_32bits(const struct bench_data *const data,
+                                        const size_t iters);
+static uint32_t bench_lsb_decode(const struct bench_data *const data,
+                                 const size_t iters);
+static uint32_t bench_sack_encode(const struct bench_data *const data,
+                                  const size_t iters);
+static uint32_t bench_sack_decode(const struct bench_data *const data,
+                                  const size_t iters);
+
+static bool bench_data_init(struct bench_data *const data)
+	__attribute__((warn_unused_result, nonnull(1)));
+static void bench_data_free(struct bench_data *const data)
+	__attribute__((nonnull(1)));
+static void bench_measure(const struct bench *const bench,
+                          const struct bench_data *const data,
+                          const size_t reps,
+                          const uint64_t min_time)
+	__attribute__((nonnull(1, 2)));
+static uint64_t bench_now_ns(void)
+	__attribute__((warn_unused_result));
+static uint64_t bench_now_cycles(void)
+	__attribute__((warn_unused_result));
+static int bench_cmp_u64(const void *const a, const void *const b)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
+
+/** All the benchmarks */
+static const struct bench benches[] =
+{
+	{ "crc3_40B",          bench_crc3_40 },
+	{ "crc7_40B",          bench_crc7_40 },
+	{ "crc8_40B",          bench_crc8_40 },
+	{ "crc8_128B",         bench_crc8_128 },
+	{ "fcs32_64B",         bench_fcs32_64 },
+	{ "fcs32_1500B",       bench_fcs32_1500 },
+	{ "sdvl_encode",       bench_sdvl_encode },
+	{ "sdvl_decode",       bench_sdvl_decode },
+	{ "f_16bits",          bench_f_16bits },
+	{ "f_32bits",          bench_f_32bits },
+	{ "wlsb_get_k_16bits", bench_wlsb_get_k_16bits },
+	{ "wlsb_get_k_32bits", bench_wlsb_get_k_32bits },
+	{ "lsb_decode_32bits", bench_lsb_decode },
+	{ "tcp_sack_encode",   bench_sack_encode },
+	{ "tcp_sack_decode",   bench_sack_decode },
+};
+
+
+/**
+ * @brief Run the benchmarks
+ *
+ * @param argc  The number of program arguments
+ * @param argv  The program arguments
+ * @return      The unix return code:
+ *               \li 0 in case of success,
+ *               \li 1 in case of failure
+ */
+int main(int argc, char *argv[])
+{
+	size_t reps = BENCH_REPS_DEFAULT;
+	size_t min_time = BENCH_MIN_TIME_DEFAULT;
+	const char *filter = NULL;
+	struct bench_data data;
+	int is_failure = 1;
+	int arg;
+
+	/* parse program arguments */
+	for(arg = 1; arg < argc; arg++)
+	{
+		if(strcmp(argv[arg], "--reps") == 0 && (arg + 1) < argc)
+		{
+			reps = strtoul(argv[++arg], NULL, 10);
+		}
+		else if(strcmp(argv[arg], "--min-time") == 0 && (arg + 1) < argc)
+		{
+			min_time = strtoul(argv[++arg], NULL, 10);
+		}
+		else if(argv[arg][0] != '-' && filter == NULL)
+		{
+			filter = argv[arg];
+		}
+		else
+		{
+			printf("measure the performances of the building blocks of the "
+			       "ROHC library\n\n");
+			printf("usage: %s [--reps NUM] [--min-time MS] [FILTER]\n\n",
+			       argv[0]);
+			printf("  --reps NUM      the number of measurements for every "
+			       "benchmark (default: %u)\n", BENCH_REPS_DEFAULT);
+			printf("  --min-time MS   the minimum duration of one measurement "
+			       "(default: %u ms)\n", BENCH_MIN_TIME_DEFAULT);
+			printf("  FILTER          run only the benchmarks whose names "
+			       "contain FILTER\n");
+			goto error;
+		}
+	}
+	if(reps == 0 || reps > BENCH_REPS_MAX || min_time == 0)
+	{
+		printf("the number of measurements shall be in range [1, %u] and the "
+		       "minimum duration shall not be zero\n", BENCH_REPS_MAX);
+		goto error;
+	}
+
+	/* use the best implementations for the CPU like the library does */
+	rohc_cpu_init();
+
+	if(!bench_data_init(&data))
+	{
+		printf("failed to initialize the benchmark data\n");
+		goto error;
+	}
+
+	printf("# benchmark\titerations\tns_per_op\tns_per_op_min\tcycles_per_op\n");
+	for(size_t i = 0; i < (sizeof(benches) / sizeof(benches[0])); i++)
+	{
+		if(filter == NULL || strstr(benches[i].name, filter) != NULL)
+		{
+			bench_measure(&benches[i], &data, reps, min_time * 1000000U);
+		}
+	}
+
+	bench_data_free(&data);
+	is_failure = 0;
+
+error:
+	return is_failure;
+}
+
+
+/**
+ * @brief Measure the time per operation of one benchmark
+ *
+ * One line is printed with the number of iterations of every measurement,
+ * the median and minimum times per operation, and the median number of CPU
+ * cycles per operation (or '-' if not available on the CPU).
+ *
+ * @param bench     The benchmark to run
+ * @param data      The data shared by all benchmarks
+ * @param reps      The number of measurements
+ * @param min_time  The minimum duration of one measurement (in ns)
+ */
+static void bench_measure(const struct bench *const bench,
+                          const struct bench_data *const data,
+                          const size_t reps,
+                          const uint64_t min_time)
+{
+	uint64_t durations[BENCH_REPS_MAX];
+	uint64_t cycles[BENCH_REPS_MAX];
+	size_t iters = 1;
+
+	/* warm up and find how many iterations last the minimum time */
+	while(1)
+	{
+		const uint64_t begin = bench_now_ns();
+		bench_sink = bench->run(data, iters);
+		if((bench_now_ns() - begin) >= min_time || iters >= (SIZE_MAX / 2))
+		{
+			break;
+		}
+		iters *= 2;
+	}
+
+	/* measure */
+	for(size_t rep = 0; rep < reps; rep++)
+	{
+		const uint64_t begin = bench_now_ns();
+		const uint64_t begin_cycles = bench_now_cycles();
+		bench_sink = bench->run(data, iters);
+		cycles[rep] = bench_now_cycles() - begin_cycles;
+		durations[rep] = bench_now_ns() - begin;
+	}
+	qsort(durations, reps, sizeof(uint64_t), bench_cmp_u64);
+	qsort(cycles, reps, sizeof(uint64_t), bench_cmp_u64);
+
+	printf("%s\t%zu\t%.3f\t%.3f\t", bench->name, iters,
+	       ((double) durations[reps / 2]) / iters,
+	       ((double) durations[0]) / iters);
+	if(cycles[reps / 2] != 0)
+	{
+		printf("%.3f\n", ((double) cycles[reps / 2]) / iters);
+	}
+	else
+	{
+		printf("-\n");
+	}
+	fflush(stdout);
+}
+
+
+/**
+ * @brief Initialize the data shared by all the benchmarks
+ *
+ * @param data  The data to initialize
+ * @return      true if the data was successfully initialized, false otherwise
+ */
+static bool bench_data_init(struct bench_data *const data)
+{
+	uint32_t seed = 0x12345678;
+
+	for(size_t i = 0; i < BENCH_DATA_LEN; i++)
+	{
+		seed = seed * 1103515245 + 12345;
+		data->buf[i] = (seed >> 16) & 0xff;
+	}
+
+	/* values with SDVL encodings of 1 to 4 bytes */
+	for(size_t i = 0; i < BENCH_VALUES_NR; i++)
+	{
+		size_t len;
+
+		data->values[i] = (i * 2654435761U) >> (i % 4) * 8;
+		data->values[i] &= (1U << 29) - 1;
+		if(!sdvl_encode_full(data->sdvl[i], 5, &len, data->values[i]))
+		{
+			goto error;
+		}
+	}
+
+	/* W-LSB windows of compressor, filled with 4 recent values */
+	data->wlsb16 = c_create_wlsb(16, 4, ROHC_LSB_SHIFT_SN);
+	if(data->wlsb16 == NULL)
+	{
+		goto error;
+	}
+	data->wlsb32 = c_create_wlsb(32, 4, ROHC_LSB_SHIFT_SN);
+	if(data->wlsb32 == NULL)
+	{
+		goto free_wlsb16;
+	}
+	for(uint32_t sn = 1000; sn < 1004; sn++)
+	{
+		c_add_wlsb(data->wlsb16, sn, sn);
+		c_add_wlsb(data->wlsb32, sn, sn * 160);
+	}
+
+	/* LSB context of decompressor */
+	data->lsb = rohc_lsb_new(32);
+	if(data->lsb == NULL)
+	{
+		goto free_wlsb32;
+	}
+	rohc_lsb_set_ref(data->lsb, 1000, false);
+
+	/* TCP SACK options as seen on a lossy link: mostly 1 or 2 blocks a few
+	 * segments after the ACK number, sometimes up to 4 blocks or blocks far
+	 * away after a burst of losses */
+	for(size_t i = 0; i < BENCH_SACK_NR; i++)
+	{
+		const size_t mss = 1448;
+		const size_t blocks_nr = 1 + ((i % 20) >= 10) + ((i % 20) >= 15) +
+		                         ((i % 20) >= 18);
+		uint32_t reference;
+		int ret;
+
+		seed = seed * 1103515245 + 12345;
+		data->sack_acks[i] = seed;
+		reference = data->sack_acks[i];
+		for(size_t j = 0; j < blocks_nr; j++)
+		{
+			size_t hole_segs;
+			size_t block_segs;
+
+			seed = seed * 1103515245 + 12345;
+			hole_segs = 1 + ((seed >> 16) % 4);
+			if(((seed >> 8) & 0x0f) == 0)
+			{
+				hole_segs *= 512;
+			}
+			block_segs = 1 + ((seed >> 20) % 16);
+			reference += hole_segs * mss;
+			data->sack_blocks[i][j].block_start = rohc_hton32(reference);
+			reference += block_segs * mss;
+			data->sack_blocks[i][j].block_end = rohc_hton32(reference);
+		}
+		data->sack_lens[i] = blocks_nr * sizeof(sack_block_t);
+
+		ret = c_tcp_opt_sack_code(&bench_comp_ctxt, data->sack_acks[i],
+		                          data->sack_blocks[i], data->sack_lens[i], false,
+		                          data->sack_rohc[i], BENCH_SACK_ROHC_MAX);
+		if(ret < 0)
+		{
+			goto free_lsb;
+		}
+		data->sack_rohc_lens[i] = ret;
+	}
+
+	return true;
+
+free_lsb:
+	rohc_lsb_free(data->lsb);
+
+free_wlsb32:
+	c_destroy_wlsb(data->wlsb32);
+free_wlsb16:
+	c_destroy_wlsb(data->wlsb16);
+error:
+	return false;
+}
+
+
+/**
+ * @brief Release the data shared by all the benchmarks
+ *
+ * @param data  The data to release
+ */
+static void bench_data_free(struct bench_data *const data)
+{
+	rohc_lsb_free(data->lsb);
+	c_destroy_wlsb(data->wlsb32);
+	c_destroy_wlsb(data->wlsb16);
+}
+
+
+/** Benchmark CRC-3 on a 40-byte header */
+static uint32_t bench_crc3_40(const struct bench_data *const data,
+                              const size_t iters)
+{
+	uint8_t crc = CRC_INIT_3;
+	for(size_t i = 0; i < iters; i++)
+	{
+		crc = crc_calculate(ROHC_CRC_TYPE_3, data->buf + (i & 7), 40, crc,
+		                    rohc_crc_table_3);
+	}
+	return crc;
+}
+
+
+/** Benchmark CRC-7 on a 40-byte header */
+static uint32_t bench_crc7_40(const struct bench_data *const data,
+                              const size_t iters)
+{
+	uint8_t crc = CRC_INIT_7;
+	for(size_t i = 0; i < iters; i++)
+	{
+		crc = crc_calculate(ROHC_CRC_TYPE_7, data->buf + (i & 7), 40, crc,
+		                    rohc_crc_table_7);
+	}
+	return crc;
+}
+
+
+/** Benchmark CRC-8 on a 40-byte header */
+static uint32_t bench_crc8_40(const struct bench_data *const data,
+                              const size_t iters)
+{
+	uint8_t crc = CRC_INIT_8;
+	for(size_t i = 0; i < iters; i++)
+	{
+		crc = crc_calculate(ROHC_CRC_TYPE_8, data->buf + (i & 7), 40, crc,
+		                    rohc_crc_table_8);
+	}
+	return crc;
+}
+
+
+/** Benchmark CRC-8 on a 128-byte IR header */
+static uint32_t bench_crc8_128(const struct bench_data *const data,
+                               const size_t iters)
+{
+	uint8_t crc = CRC_INIT_8;
+	for(size_t i = 0; i < iters; i++)
+	{
+		crc = crc_calculate(ROHC_CRC_TYPE_8, data->buf + (i & 7), 128, crc,
+		                    rohc_crc_table_8);
+	}
+	return crc;
+}
+
+
+/** Benchmark FCS-32 on a 64-byte segment */
+static uint32_t bench_fcs32_64(const struct bench_data *const data,
+                               const size_t iters)
+{
+	uint32_t crc = CRC_INIT_FCS32;
+	for(size_t i = 0; i < iters; i++)
+	{
+		crc = crc_calc_fcs32(data->buf + (i & 7), 64, crc);
+	}
+	return crc;
+}
+
+
+/** Benchmark FCS-32 on a 1500-byte segment */
+static uint32_t bench_fcs32_1500(const struct bench_data *const data,
+                                 const size_t iters)
+{
+	uint32_t crc = CRC_INIT_FCS32;
+	for(size_t i = 0; i < iters; i++)
+	{
+		crc = crc_calc_fcs32(data->buf, BENCH_DATA_LEN - (i & 7), crc);
+	}
+	return crc;
+}
+
+
+/** Benchmark SDVL encoding of values encoded on 1 to 4 bytes */
+static uint32_t bench_sdvl_encode(const struct bench_data *const data,
+                                  const size_t iters)
+{
+	uint32_t sum = 0;
+	for(size_t i = 0; i < iters; i++)
+	{
+		uint8_t buf[5];
+		size_t len;
+		if(sdvl_encode_full(buf, 5, &len, data->values[i % BENCH_VALUES_NR]))
+		{
+			sum += buf[0] + len;
+		}
+	}
+	return sum;
+}
+
+
+/** Benchmark SDVL decoding of values encoded on 1 to 4 bytes */
+static uint32_t bench_sdvl_decode(const struct bench_data *const data,
+                                  const size_t iters)
+{
+	uint32_t sum = 0;
+	for(size_t i = 0; i < iters; i++)
+	{
+		uint32_t value;
+		size_t bits_nr;
+		sum += sdvl_decode(data->sdvl[i % BENCH_VALUES_NR], 5, &value, &bits_nr);
+		sum += value;
+	}
+	return sum;
+}
+
+
+/** Benchmark the interpretation interval of 16-bit values */
+static uint32_t bench_f_16bits(const struct bench_data *const data,
+                               const size_t iters)
+{
+	uint32_t sum = 0;
+	for(size_t i = 0; i < iters; i++)
+	{
+		const struct rohc_interval16 interval =
+			rohc_f_16bits(data->values[i % BENCH_VALUES_NR], 1 + (i & 15),
+			              ROHC_LSB_SHIFT_SN);
+		sum += interval.min ^ interval.max;
+	}
+	return sum;
+}
+
+
+/** Benchmark the interpretation interval of 32-bit values */
+static uint32_t bench_f_32bits(const struct bench_data *const data,
+                               const size_t iters)
+{
+	uint32_t sum = 0;
+	for(size_t i = 0; i < iters; i++)
+	{
+		const struct rohc_interval32 interval =
+			rohc_f_32bits(data->values[i % BENCH_VALUES_NR], 1 + (i & 31),
+			              ROHC_LSB_SHIFT_SN);
+		sum += interval.min ^ interval.max;
+	}
+	return sum;
+}
+
+
+/** Benchmark the number of bits required for a 16-bit W-LSB field (SN) */
+static uint32_t bench_wlsb_get_k_16bits(const struct bench_data *const data,
+                                        const size_t iters)
+{
+	uint32_t sum = 0;
+	for(size_t i = 0; i < iters; i++)
+	{
+		sum += wlsb_get_k_16bits(data->wlsb16, 1004 + (i & 63));
+	}
+	return sum;
+}
+
+
+/** Benchmark the number of bits required for a 32-bit W-LSB field (TS) */
+static uint32_t bench_wlsb_get_k_32bits(const struct bench_data *const data,
+                                        const size_t iters)
+{
+	uint32_t sum = 0;
+	for(size_t i = 0; i < iters; i++)
+	{
+		sum += wlsb_get_k_32bits(data->wlsb32, (1004 + (i & 63)) * 160);
+	}
+	return sum;
+}
+
+
+/** Benchmark the LSB decoding of a 32-bit field with 4 to 16 bits */
+static uint32_t bench_lsb_decode(const struct bench_data *const data,
+                                 const size_t iters)
+{
+	uint32_t sum = 0;
+	for(size_t i = 0; i < iters; i++)
+	{
+		const size_t k = 4 + (i % 13);
+		const uint32_t value = 1001 + (i & 7);
+		uint32_t decoded;
+		if(rohc_lsb_decode(data->lsb, ROHC_LSB_REF_0, 0,
+		                   value & ((1U << k) - 1), k, ROHC_LSB_SHIFT_SN,
+		                   &decoded))
+		{
+			sum += decoded;
+		}
+	}
+	return sum;
+}
+
+
+/** Benchmark the compression of TCP SACK options with 1 to 4 blocks */
+static uint32_t bench_sack_encode(const struct bench_data *const data,
+                                  const size_t iters)
+{
+	uint32_t sum = 0;
+	for(size_t i = 0; i < iters; i++)
+	{
+		const size_t n = i % BENCH_SACK_NR;
+		uint8_t buf[BENCH_SACK_ROHC_MAX];
+		const int ret =
+			c_tcp_opt_sack_code(&bench_comp_ctxt, data->sack_acks[n],
+			                    data->sack_blocks[n], data->sack_lens[n], false,
+			                    buf, BENCH_SACK_ROHC_MAX);
+		sum += ret + buf[1];
+	}
+	return sum;
+}
+
+
+/** Benchmark the decoding of TCP SACK options with 1 to 4 blocks */
+static uint32_t bench_sack_decode(const struct bench_data *const data,
+                                  const size_t iters)
+{
+	uint32_t sum = 0;
+	for(size_t i = 0; i < iters; i++)
+	{
+		const size_t n = i % BENCH_SACK_NR;
+		struct d_tcp_opt_sack sack;
+		const int ret = d_tcp_sack_parse(&bench_decomp_ctxt, data->sack_rohc[n],
+		                                 data->sack_rohc_lens[n], &sack);
+		sum += ret + sack.blocks[0].block_start;
+	}
+	return sum;
+}
+
+
+/**
+ * @brief Get the current time in nanoseconds
+ *
+ * @return  The time of a monotonic clock (in ns)
+ */
+static uint64_t bench_now_ns(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return ((uint64_t) now.tv_sec) * 1000000000U + now.tv_nsec;
+}
+
+
+/**
+ * @brief Get the current number of CPU cycles
+ *
+ * @return  The Time Stamp Counter on x86 CPUs, 0 on other CPUs
+ */
+static uint64_t bench_now_cycles(void)
+{
+#if defined(__i386__) || defined(__x86_64__)
+	return __rdtsc();
+#else
+	return 0;
+#endif
+}
+
+
+/**
+ * @brief Compare two 64-bit unsigned values for qsort()
+ *
+ * @param a  The first value
+ * @param b  The second value
+ * @return   -1, 0 or 1 if a is lower, equal or greater than b
+ */
+static int bench_cmp_u64(const void *const a, const void *const b)
+{
+	const uint64_t val_a = *((const uint64_t *) a);
+	const uint64_t val_b = *((const uint64_t *) b);
+	return (val_a > val_b) - (val_a < val_b);
+}
+
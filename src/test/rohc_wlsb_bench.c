@@ -0,0 +1,543 @@
+/*
+ * Copyright 2016 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file    rohc_wlsb_bench.c
+ * @brief   Measure the W-LSB encoding and LSB decoding on lossy channels
+ * @author  Didier Barvaux <didier@barvaux.org>
+ *
+ * Synthetic sequences of SN, TS and IP-ID values are W-LSB encoded, sent
+ * through a channel that loses and reorders packets, then LSB decoded. The
+ * decompressor updates its reference value with correctly decoded values,
+ * as it would after a CRC success. After a wrong decoding, it gets the
+ * correct value as a context repair or an IR packet would do, so that the
+ * failures count the damaged packets. The sequences start close to the end
+ * of the field range, so that they wrap around in the middle of the run.
+ *
+ * For every field and every window width, one line is printed with
+ * tab-separated columns: the number of bits sent per packet, the number of
+ * wrongly decoded packets, and the median times to select k and to decode
+ * one packet. The results help choosing the W-LSB window width with
+ * rohc_comp_set_wlsb_window_width().
+ *
+ * Run with 'make bench'.
+ */
+
+#include "interval.h"
+#include "schemes/comp_wlsb.h"
+#include "schemes/decomp_wlsb.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+
+
+/** The default number of packets of every sequence */
+#define WLSB_BENCH_PACKETS_DEFAULT  100000U
+/** The default number of measurements for every field and window width */
+#define WLSB_BENCH_REPS_DEFAULT     5U
+/** The max number of measurements for every field and window width */
+#define WLSB_BENCH_REPS_MAX         101U
+/** The default max width of the W-LSB window */
+#define WLSB_BENCH_WIDTH_DEFAULT    64U
+
+
+/** One field encoded with W-LSB */
+struct wlsb_bench_field
+{
+	const char *name;     /**< The name of the field */
+	size_t bits;          /**< The length of the field (16 or 32 bits) */
+	rohc_lsb_shift_t p;   /**< The shift parameter of the field */
+	uint32_t step;        /**< The increment of the field between 2 packets */
+	bool is_jittered;     /**< Whether the increment is sometimes larger */
+};
+
+
+/** The parameters of the channel between compressor and decompressor */
+struct wlsb_bench_channel
+{
+	size_t packets_nr;    /**< The number of packets of every sequence */
+	double loss;          /**< The probability that a loss burst starts */
+	size_t burst_max;     /**< The max number of packets lost in one burst */
+	double reorder;       /**< The probability to swap 2 consecutive packets */
+	uint32_t seed;        /**< The seed of the pseudo-random generator */
+};
+
+
+/** The result of one run of one sequence */
+struct wlsb_bench_result
+{
+	size_t delivered_nr;  /**< The number of packets received */
+	size_t bits_nr;       /**< The total number of LSB bits received */
+	size_t failures_nr;   /**< The number of wrongly decoded packets */
+	uint64_t enc_time;    /**< The time spent to select k and update (in ns) */
+	uint64_t dec_time;    /**< The time spent to decode (in ns) */
+};
+
+
+/** All the measured fields */
+static const struct wlsb_bench_field fields[] =
+{
+	{ "sn_16bits",      16, ROHC_LSB_SHIFT_SN,      1, false },
+	{ "rtp_sn_16bits",  16, ROHC_LSB_SHIFT_RTP_SN,  1, false },
+	{ "tcp_msn_16bits", 16, ROHC_LSB_SHIFT_TCP_SN,  1, false },
+	{ "ip_id_16bits",   16, ROHC_LSB_SHIFT_IP_ID,   1, true  },
+	{ "rtp_ts_32bits",  32, ROHC_LSB_SHIFT_RTP_TS,  160, false },
+};
+
+
+static bool wlsb_bench_run(const struct wlsb_bench_field *const field,
+                           const size_t width,
+                           const struct wlsb_bench_channel *const channel,
+                           const uint32_t *const values,
+                           uint8_t *const ks,
+                           const size_t *const order,
+                           const size_t order_nr,
+                           struct wlsb_bench_result *const result)
+	__attribute__((warn_unused_result, nonnull(1, 3, 4, 5, 6, 8)));
+static void wlsb_bench_gen_values(const struct wlsb_bench_field *const field,
+                                  const struct wlsb_bench_channel *const channel,
+                                  uint32_t *const values)
+	__attribute__((nonnull(1, 2, 3)));
+static size_t wlsb_bench_gen_order(const struct wlsb_bench_channel *const channel,
+                                   size_t *const order)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static uint32_t wlsb_bench_rand(uint32_t *const seed)
+	__attribute__((warn_unused_result, nonnull(1)));
+static bool wlsb_bench_rand_is(uint32_t *const seed, const double probability)
+	__attribute__((warn_unused_result, nonnull(1)));
+static uint64_t wlsb_bench_now_ns(void)
+	__attribute__((warn_unused_result));
+static int wlsb_bench_cmp_u64(const void *const a, const void *const b)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
+
+/**
+ * @brief Run the W-LSB benchmarks
+ *
+ * @param argc  The number of program arguments
+ * @param argv  The program arguments
+ * @return      The unix return code:
+ *               \li 0 in case of success,
+ *               \li 1 in case of failure
+ */
+int main(int argc, char *argv[])
+{
+	struct wlsb_bench_channel channel =
+	{
+		.packets_nr = WLSB_BENCH_PACKETS_DEFAULT,
+		.loss = 0.01,
+		.burst_max = 3,
+		.reorder = 0.01,
+		.seed = 0x12345678,
+	};
+	size_t reps = WLSB_BENCH_REPS_DEFAULT;
+	size_t max_width = WLSB_BENCH_WIDTH_DEFAULT;
+	const char *filter = NULL;
+	uint32_t *values;
+	uint8_t *ks;
+	size_t *order;
+	size_t order_nr;
+	int is_failure = 1;
+	int arg;
+
+	/* parse program arguments */
+	for(arg = 1; arg < argc; arg++)
+	{
+		if(strcmp(argv[arg], "--packets") == 0 && (arg + 1) < argc)
+		{
+			channel.packets_nr = strtoul(argv[++arg], NULL, 10);
+		}
+		else if(strcmp(argv[arg], "--loss") == 0 && (arg + 1) < argc)
+		{
+			channel.loss = strtod(argv[++arg], NULL) / 100;
+		}
+		else if(strcmp(argv[arg], "--burst") == 0 && (arg + 1) < argc)
+		{
+			channel.burst_max = strtoul(argv[++arg], NULL, 10);
+		}
+		else if(strcmp(argv[arg], "--reorder") == 0 && (arg + 1) < argc)
+		{
+			channel.reorder = strtod(argv[++arg], NULL) / 100;
+		}
+		else if(strcmp(argv[arg], "--seed") == 0 && (arg + 1) < argc)
+		{
+			channel.seed = strtoul(argv[++arg], NULL, 0);
+		}
+		else if(strcmp(argv[arg], "--max-width") == 0 && (arg + 1) < argc)
+		{
+			max_width = strtoul(argv[++arg], NULL, 10);
+		}
+		else if(strcmp(argv[arg], "--reps") == 0 && (arg + 1) < argc)
+		{
+			reps = strtoul(argv[++arg], NULL, 10);
+		}
+		else if(argv[arg][0] != '-' && filter == NULL)
+		{
+			filter = argv[arg];
+		}
+		else
+		{
+			printf("measure the W-LSB encoding and LSB decoding of the ROHC "
+			       "library on lossy channels\n\n");
+			printf("usage: %s [OPTIONS] [FILTER]\n\n", argv[0]);
+			printf("  --packets NUM    the number of packets of every sequence "
+			       "(default: %u)\n", WLSB_BENCH_PACKETS_DEFAULT);
+			printf("  --loss PCT       the probability (in %%) that a loss "
+			       "burst starts (default: 1)\n");
+			printf("  --burst NUM      the max number of packets lost in one "
+			       "burst (default: 3)\n");
+			printf("  --reorder PCT    the probability (in %%) that 2 "
+			       "consecutive packets are swapped (default: 1)\n");
+			printf("  --seed NUM       the seed of the pseudo-random generator\n");
+			printf("  --max-width NUM  the max width of the W-LSB window, "
+			       "widths 1, 2, 4... are measured (default: %u)\n",
+			       WLSB_BENCH_WIDTH_DEFAULT);
+			printf("  --reps NUM       the number of measurements for every "
+			       "field and width (default: %u)\n", WLSB_BENCH_REPS_DEFAULT);
+			printf("  FILTER           run only the fields whose names contain "
+			       "FILTER\n");
+			goto error;
+		}
+	}
+	if(channel.packets_nr == 0 || channel.burst_max == 0 ||
+	   channel.loss < 0 || channel.loss > 1 ||
+	   channel.reorder < 0 || channel.reorder > 1 ||
+	   reps == 0 || reps > WLSB_BENCH_REPS_MAX || max_width == 0)
+	{
+		printf("the number of packets, the burst length and the window width "
+		       "shall not be zero, the probabilities shall be in range [0, 100] "
+		       "and the number of measurements in range [1, %u]\n",
+		       WLSB_BENCH_REPS_MAX);
+		goto error;
+	}
+
+	values = malloc(channel.packets_nr * sizeof(uint32_t));
+	if(values == NULL)
+	{
+		printf("failed to allocate memory for the values\n");
+		goto error;
+	}
+	ks = malloc(channel.packets_nr * sizeof(uint8_t));
+	if(ks == NULL)
+	{
+		printf("failed to allocate memory for the numbers of bits\n");
+		goto free_values;
+	}
+	order = malloc(channel.packets_nr * sizeof(size_t));
+	if(order == NULL)
+	{
+		printf("failed to allocate memory for the order of packets\n");
+		goto free_ks;
+	}
+
+	/* the same packets are lost and reordered for all fields and widths */
+	order_nr = wlsb_bench_gen_order(&channel, order);
+
+	printf("# field\twidth\tpackets\tdelivered\tbits_per_pkt\tfailures\t"
+	       "enc_ns_per_pkt\tdec_ns_per_pkt\n");
+	for(size_t i = 0; i < (sizeof(fields) / sizeof(fields[0])); i++)
+	{
+		if(filter != NULL && strstr(fields[i].name, filter) == NULL)
+		{
+			continue;
+		}
+
+		wlsb_bench_gen_values(&fields[i], &channel, values);
+
+		for(size_t width = 1; width <= max_width; width *= 2)
+		{
+			uint64_t enc_times[WLSB_BENCH_REPS_MAX];
+			uint64_t dec_times[WLSB_BENCH_REPS_MAX];
+			struct wlsb_bench_result result;
+
+			for(size_t rep = 0; rep < reps; rep++)
+			{
+				if(!wlsb_bench_run(&fields[i], width, &channel, values, ks,
+				                   order, order_nr, &result))
+				{
+					printf("failed to run benchmark for field %s with window "
+					       "width %zu\n", fields[i].name, width);
+					goto free_order;
+				}
+				enc_times[rep] = result.enc_time;
+				dec_times[rep] = result.dec_time;
+			}
+			qsort(enc_times, reps, sizeof(uint64_t), wlsb_bench_cmp_u64);
+			qsort(dec_times, reps, sizeof(uint64_t), wlsb_bench_cmp_u64);
+
+			printf("%s\t%zu\t%zu\t%zu\t%.3f\t%zu\t%.3f\t%.3f\n", fields[i].name,
+			       width, channel.packets_nr, result.delivered_nr,
+			       result.delivered_nr == 0 ? 0.0 :
+			       ((double) result.bits_nr) / result.delivered_nr,
+			       result.failures_nr,
+			       ((double) enc_times[reps / 2]) / channel.packets_nr,
+			       result.delivered_nr == 0 ? 0.0 :
+			       ((double) dec_times[reps / 2]) / result.delivered_nr);
+			fflush(stdout);
+		}
+	}
+
+	is_failure = 0;
+
+free_order:
+	free(order);
+free_ks:
+	free(ks);
+free_values:
+	free(values);
+error:
+	return is_failure;
+}
+
+
+/**
+ * @brief Encode, transmit and decode one sequence of values
+ *
+ * @param field     The field to encode
+ * @param width     The width of the W-LSB window
+ * @param channel   The parameters of the channel
+ * @param values    The values of the field in every packet
+ * @param ks        The numbers of bits of every packet, set by encoding
+ * @param order     The indexes of the packets in the order they are received
+ * @param order_nr  The number of received packets
+ * @param result    OUT: The result of the run
+ * @return          true if the run succeeded, false otherwise
+ */
+static bool wlsb_bench_run(const struct wlsb_bench_field *const field,
+                           const size_t width,
+                           const struct wlsb_bench_channel *const channel,
+                           const uint32_t *const values,
+                           uint8_t *const ks,
+                           const size_t *const order,
+                           const size_t order_nr,
+                           struct wlsb_bench_result *const result)
+{
+	struct c_wlsb *wlsb;
+	struct rohc_lsb_decode *lsb;
+	uint64_t begin;
+
+	wlsb = c_create_wlsb(field->bits, width, field->p);
+	if(wlsb == NULL)
+	{
+		goto error;
+	}
+	lsb = rohc_lsb_new(field->bits);
+	if(lsb == NULL)
+	{
+		goto destroy_wlsb;
+	}
+
+	/* the first value is sent uncompressed, as in IR packets */
+	c_add_wlsb(wlsb, 0, values[0]);
+	rohc_lsb_set_ref(lsb, values[0], false);
+
+	/* compressor: select the number of bits, then update the window */
+	begin = wlsb_bench_now_ns();
+	if(field->bits == 16)
+	{
+		for(size_t i = 1; i < channel->packets_nr; i++)
+		{
+			ks[i] = wlsb_get_k_16bits(wlsb, values[i]);
+			c_add_wlsb(wlsb, i, values[i]);
+		}
+	}
+	else
+	{
+		for(size_t i = 1; i < channel->packets_nr; i++)
+		{
+			ks[i] = wlsb_get_k_32bits(wlsb, values[i]);
+			c_add_wlsb(wlsb, i, values[i]);
+		}
+	}
+	result->enc_time = wlsb_bench_now_ns() - begin;
+
+	/* decompressor: decode the received packets, then update the reference
+	 * value with the correct value, as a CRC check then a context repair or
+	 * an IR packet would do */
+	result->delivered_nr = order_nr;
+	result->bits_nr = 0;
+	result->failures_nr = 0;
+	begin = wlsb_bench_now_ns();
+	for(size_t i = 0; i < order_nr; i++)
+	{
+		const size_t pkt = order[i];
+		const size_t k = ks[pkt];
+		const uint32_t mask = (k == 32 ? 0xffffffff : ((1U << k) - 1));
+		uint32_t decoded;
+
+		result->bits_nr += k;
+		if(!rohc_lsb_decode(lsb, ROHC_LSB_REF_0, 0, values[pkt] & mask, k,
+		                    field->p, &decoded) ||
+		   decoded != values[pkt])
+		{
+			result->failures_nr++;
+		}
+		rohc_lsb_set_ref(lsb, values[pkt], false);
+	}
+	result->dec_time = wlsb_bench_now_ns() - begin;
+
+	rohc_lsb_free(lsb);
+	c_destroy_wlsb(wlsb);
+	return true;
+
+destroy_wlsb:
+	c_destroy_wlsb(wlsb);
+error:
+	return false;
+}
+
+
+/**
+ * @brief Generate the values of one field for all the packets
+ *
+ * The values start so that they wrap around in the middle of the sequence.
+ *
+ * @param field    The field to generate values for
+ * @param channel  The parameters of the channel
+ * @param values   OUT: The values of the field in every packet
+ */
+static void wlsb_bench_gen_values(const struct wlsb_bench_field *const field,
+                                  const struct wlsb_bench_channel *const channel,
+                                  uint32_t *const values)
+{
+	const uint32_t mask = (field->bits == 32 ? 0xffffffff :
+	                       ((1U << field->bits) - 1));
+	uint32_t seed = channel->seed ^ field->step;
+	uint32_t value;
+
+	value = 0U - ((uint32_t) (channel->packets_nr / 2)) * field->step;
+	for(size_t i = 0; i < channel->packets_nr; i++)
+	{
+		values[i] = value & mask;
+		value += field->step;
+
+		/* IP-ID: the IP stack sometimes sends packets of other flows */
+		if(field->is_jittered && (wlsb_bench_rand(&seed) % 4) == 0)
+		{
+			value += 1 + (wlsb_bench_rand(&seed) % 3);
+		}
+	}
+}
+
+
+/**
+ * @brief Generate the order in which packets are received
+ *
+ * The first packet is never lost nor reordered, since it initializes the
+ * decompressor.
+ *
+ * @param channel  The parameters of the channel
+ * @param order    OUT: The indexes of the packets in the order they are
+ *                 received
+ * @return         The number of received packets
+ */
+static size_t wlsb_bench_gen_order(const struct wlsb_bench_channel *const channel,
+                                   size_t *const order)
+{
+	uint32_t seed = channel->seed;
+	size_t order_nr = 0;
+	size_t i = 1;
+
+	while(i < channel->packets_nr)
+	{
+		if(wlsb_bench_rand_is(&seed, channel->loss))
+		{
+			/* lose a burst of packets */
+			i += 1 + (wlsb_bench_rand(&seed) % channel->burst_max);
+		}
+		else
+		{
+			order[order_nr] = i;
+			order_nr++;
+			i++;
+		}
+	}
+
+	/* swap some consecutive received packets */
+	for(size_t j = 1; j < order_nr; j++)
+	{
+		if(wlsb_bench_rand_is(&seed, channel->reorder))
+		{
+			const size_t pkt = order[j - 1];
+			order[j - 1] = order[j];
+			order[j] = pkt;
+			j++;
+		}
+	}
+
+	return order_nr;
+}
+
+
+/**
+ * @brief Get one pseudo-random number
+ *
+ * @param seed  The state of the pseudo-random generator
+ * @return      A pseudo-random number in range [0, 32767]
+ */
+static uint32_t wlsb_bench_rand(uint32_t *const seed)
+{
+	*seed = (*seed) * 1103515245 + 12345;
+	return ((*seed) >> 16) & 0x7fff;
+}
+
+
+/**
+ * @brief Get whether one event of the given probability happens
+ *
+ * @param seed         The state of the pseudo-random generator
+ * @param probability  The probability of the event in range [0, 1]
+ * @return             true if the event happens, false otherwise
+ */
+static bool wlsb_bench_rand_is(uint32_t *const seed, const double probability)
+{
+	return (wlsb_bench_rand(seed) < (probability * 32768));
+}
+
+
+/**
+ * @brief Get the current time in nanoseconds
+ *
+ * @return  The time of a monotonic clock (in ns)
+ */
+static uint64_t wlsb_bench_now_ns(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return ((uint64_t) now.tv_sec) * 1000000000U + now.tv_nsec;
+}
+
+
+/**
+ * @brief Compare two 64-bit unsigned values for qsort()
+ *
+ * @param a  The first value
+ * @param b  The second value
+ * @return   -1, 0 or 1 if a is lower, equal or greater than b
+ */
+static int wlsb_bench_cmp_u64(const void *const a, const void *const b)
+{
+	const uint64_t val_a = *((const uint64_t *) a);
+	const uint64_t val_b = *((const uint64_t *) b);
+	return (val_a > val_b) - (val_a < val_b);
+}
+
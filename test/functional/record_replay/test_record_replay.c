@@ -0,0 +1,770 @@
+/*
+ * Copyright 2026 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   test_record_replay.c
+ * @brief  Check that a recorded workload replays to the very same packets
+ * @author Didier Barvaux <didier@barvaux.org>
+ *
+ * The application compresses IP packets from a source PCAP file while the
+ * compressor records its workload. The ROHC packets are decompressed, and the
+ * feedback of the decompressor is delivered back to the compressor, so that
+ * the recording holds feedback too. The recording is then parsed and replayed
+ * against a new compressor created with the recorded configuration: every
+ * replayed packet shall be compressed in the very same ROHC packet as during
+ * the recording.
+ */
+
+#include "test.h"
+#include "config.h" /* for HAVE_*_H */
+
+/* system includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <stdarg.h>
+
+/* include for the PCAP library */
+#if HAVE_PCAP_PCAP_H == 1
+#  include <pcap/pcap.h>
+#elif HAVE_PCAP_H == 1
+#  include <pcap.h>
+#else
+#  error "pcap.h header not found, did you specified --enable-rohc-tests \
+for ./configure ? If yes, check configure output and config.log"
+#endif
+
+/* ROHC includes */
+#include <rohc.h>
+#include <rohc_comp.h>
+#include <rohc_decomp.h>
+#include <rohc_record.h>
+
+
+/** A growing buffer in memory */
+struct test_buf
+{
+	uint8_t *data;   /**< The bytes of the buffer */
+	size_t len;      /**< The number of bytes used */
+	size_t max_len;  /**< The number of bytes allocated */
+};
+
+
+/* prototypes of private functions */
+static void usage(void);
+static int test_record_replay(const char *const filename);
+static int test_replay(const struct test_buf *const recording,
+                       const struct test_buf *const rohc_pkts,
+                       const size_t *const rohc_lens,
+                       const size_t rohc_pkts_nr);
+static struct rohc_comp * create_comp(void)
+	__attribute__((warn_unused_result));
+static struct rohc_comp *
+	create_comp_from_record(const struct rohc_record_hdr *const hdr)
+	__attribute__((warn_unused_result, nonnull(1)));
+static rohc_status_t compress_all(struct rohc_comp *const comp,
+                                  const struct rohc_buf ip_packet,
+                                  const uint32_t cid,
+                                  struct test_buf *const output)
+	__attribute__((warn_unused_result, nonnull(1, 4)));
+static bool test_buf_append(struct test_buf *const buf,
+                            const uint8_t *const data,
+                            const size_t len)
+	__attribute__((warn_unused_result, nonnull(1)));
+static bool record_cb(void *const priv,
+                      const uint8_t *const data,
+                      const size_t len)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static void print_rohc_traces(void *const priv_ctxt,
+                              const rohc_trace_level_t level,
+                              const rohc_trace_entity_t entity,
+                              const int profile,
+                              const char *const format,
+                              ...)
+	__attribute__((format(printf, 5, 6), nonnull(5)));
+static int gen_false_random_num(const struct rohc_comp *const comp,
+                                void *const user_context)
+	__attribute__((nonnull(1)));
+
+
+/**
+ * @brief Check that the workload recorded while compressing the IP packets
+ *        of the capture replays to the very same ROHC packets
+ *
+ * @param argc The number of program arguments
+ * @param argv The program arguments
+ * @return     The unix return code:
+ *              \li 0 in case of success,
+ *              \li 1 in case of failure
+ */
+int main(int argc, char *argv[])
+{
+	char *filename = NULL;
+	int args_read;
+	int status = 1;
+
+	/* parse program arguments, print the help message in case of failure */
+	if(argc <= 1)
+	{
+		usage();
+		goto error;
+	}
+
+	for(argc--, argv++; argc > 0; argc -= args_read, argv += args_read)
+	{
+		if(!strcmp(*argv, "-h"))
+		{
+			/* print help */
+			usage();
+			goto error;
+		}
+		else if(filename == NULL)
+		{
+			/* get the name of the file that contains the packets to compress */
+			filename = argv[0];
+			args_read = 1;
+		}
+		else
+		{
+			/* do not accept more than one argument without option name */
+			usage();
+			goto error;
+		}
+	}
+
+	/* the source filename is mandatory */
+	if(filename == NULL)
+	{
+		usage();
+		goto error;
+	}
+
+	/* record the compression of the packets from the file, then replay it */
+	status = test_record_replay(filename);
+
+error:
+	return status;
+}
+
+
+/**
+ * @brief Print usage of the application
+ */
+static void usage(void)
+{
+	fprintf(stderr,
+	        "Check that a recorded workload replays to the very same packets\n"
+	        "\n"
+	        "usage: test_record_replay [OPTIONS] FLOW\n"
+	        "\n"
+	        "with:\n"
+	        "  FLOW         The flow of Ethernet frames to compress\n"
+	        "               (in PCAP format)\n"
+	        "\n"
+	        "options:\n"
+	        "  -h           Print this usage and exit\n");
+}
+
+
+/**
+ * @brief Compress the IP packets of the capture while recording, then
+ *        replay the recording
+ *
+ * @param filename  The name of the PCAP file that contains the IP packets
+ * @return          0 in case of success,
+ *                  1 in case of failure
+ */
+static int test_record_replay(const char *const filename)
+{
+	char errbuf[PCAP_ERRBUF_SIZE];
+	pcap_t *handle;
+	int link_layer_type;
+	size_t link_len;
+
+	struct rohc_comp *comp;
+	struct rohc_decomp *decomp;
+
+	struct test_buf recording = { .data = NULL, .len = 0, .max_len = 0 };
+	struct test_buf rohc_pkts = { .data = NULL, .len = 0, .max_len = 0 };
+	size_t *rohc_lens = NULL;
+	size_t rohc_pkts_nr = 0;
+	size_t feedbacks_nr = 0;
+
+	uint8_t feedback_buffer[MAX_ROHC_SIZE];
+	struct rohc_buf feedback_send =
+		rohc_buf_init_empty(feedback_buffer, MAX_ROHC_SIZE);
+
+	struct pcap_pkthdr header;
+	unsigned char *packet;
+
+	int is_failure = 1;
+
+	/* open the source dump file */
+	handle = pcap_open_offline(filename, errbuf);
+	if(handle == NULL)
+	{
+		fprintf(stderr, "failed to open the source pcap file: %s\n", errbuf);
+		goto error;
+	}
+
+	/* link layer in the source dump must be Ethernet */
+	link_layer_type = pcap_datalink(handle);
+	if(link_layer_type == DLT_EN10MB)
+	{
+		link_len = ETHER_HDR_LEN;
+	}
+	else if(link_layer_type == DLT_LINUX_SLL)
+	{
+		link_len = LINUX_COOKED_HDR_LEN;
+	}
+	else if(link_layer_type == DLT_RAW)
+	{
+		link_len = 0;
+	}
+	else
+	{
+		fprintf(stderr, "link layer type %d not supported in source dump "
+		        "(supported = %d, %d, %d)\n", link_layer_type,
+		        DLT_EN10MB, DLT_LINUX_SLL, DLT_RAW);
+		goto close_input;
+	}
+
+	/* create the ROHC compressor, then record its workload */
+	comp = create_comp();
+	if(comp == NULL)
+	{
+		goto close_input;
+	}
+	if(!rohc_comp_set_recorder(comp, record_cb, &recording, 0))
+	{
+		fprintf(stderr, "failed to set the recorder of the compressor\n");
+		goto destroy_comp;
+	}
+
+	/* create the ROHC decompressor in bi-directional mode */
+	decomp = rohc_decomp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, ROHC_O_MODE);
+	if(decomp == NULL)
+	{
+		fprintf(stderr, "failed to create the ROHC decompressor\n");
+		goto destroy_comp;
+	}
+	if(!rohc_decomp_set_traces_cb2(decomp, print_rohc_traces, NULL))
+	{
+		fprintf(stderr, "cannot set trace callback for decompressor\n");
+		goto destroy_decomp;
+	}
+	if(!rohc_decomp_enable_profiles(decomp, ROHC_PROFILE_UNCOMPRESSED,
+	                                ROHC_PROFILE_UDP, ROHC_PROFILE_IP,
+	                                ROHC_PROFILE_UDPLITE, ROHC_PROFILE_ESP,
+	                                ROHC_PROFILE_TCP, -1))
+	{
+		fprintf(stderr, "failed to enable the decompression profiles\n");
+		goto destroy_decomp;
+	}
+
+	/* for each packet in the dump */
+	while((packet = (unsigned char *) pcap_next(handle, &header)) != NULL)
+	{
+		const struct rohc_ts arrival_time = {
+			.sec = header.ts.tv_sec,
+			.nsec = header.ts.tv_usec * 1000
+		};
+		struct rohc_buf ip_packet =
+			rohc_buf_init_full(packet, header.caplen, arrival_time);
+		uint8_t decomp_buffer[MAX_ROHC_SIZE];
+		struct rohc_buf decomp_packet =
+			rohc_buf_init_empty(decomp_buffer, MAX_ROHC_SIZE);
+		size_t *new_lens;
+		const size_t rohc_pkts_len = rohc_pkts.len;
+		rohc_status_t status;
+
+		fprintf(stderr, "packet #%zu:\n", rohc_pkts_nr + 1);
+
+		/* check the length of the link layer header/frame */
+		if(header.len <= link_len || header.len != header.caplen)
+		{
+			fprintf(stderr, "\ttruncated packet in capture (len = %u, "
+			        "caplen = %u)\n", header.len, header.caplen);
+			goto destroy_decomp;
+		}
+
+		/* skip the link layer header */
+		rohc_buf_pull(&ip_packet, link_len);
+
+		/* deliver the feedback of the previous packet to the compressor */
+		if(feedback_send.len > 0)
+		{
+			if(!rohc_comp_deliver_feedback2(comp, feedback_send))
+			{
+				fprintf(stderr, "\tfailed to deliver feedback to compressor\n");
+				goto destroy_decomp;
+			}
+			feedbacks_nr++;
+			feedback_send.len = 0;
+		}
+
+		/* compress the IP packet and keep the ROHC packet for the replay */
+		status = compress_all(comp, ip_packet, ROHC_RECORD_NO_CID, &rohc_pkts);
+		if(status != ROHC_STATUS_OK)
+		{
+			fprintf(stderr, "\tfailed to compress IP packet: %s\n",
+			        rohc_strerror(status));
+			goto destroy_decomp;
+		}
+		new_lens = realloc(rohc_lens, (rohc_pkts_nr + 1) * sizeof(size_t));
+		if(new_lens == NULL)
+		{
+			fprintf(stderr, "\tno memory for the ROHC packet\n");
+			goto destroy_decomp;
+		}
+		rohc_lens = new_lens;
+		rohc_lens[rohc_pkts_nr] = rohc_pkts.len - rohc_pkts_len;
+		rohc_pkts_nr++;
+		fprintf(stderr, "\tcompression is successful\n");
+
+		/* decompress the ROHC packet to get the feedback for the compressor */
+		{
+			const struct rohc_buf rohc_packet =
+				rohc_buf_init_full(rohc_pkts.data + rohc_pkts_len,
+				                   rohc_pkts.len - rohc_pkts_len, arrival_time);
+			status = rohc_decompress3(decomp, rohc_packet, &decomp_packet,
+			                          NULL, &feedback_send);
+		}
+		if(status != ROHC_STATUS_OK)
+		{
+			fprintf(stderr, "\tfailed to decompress ROHC packet: %s\n",
+			        rohc_strerror(status));
+			goto destroy_decomp;
+		}
+		fprintf(stderr, "\tdecompression is successful\n");
+	}
+	fprintf(stderr, "%zu packets compressed, %zu feedbacks delivered, "
+	        "%zu bytes recorded\n", rohc_pkts_nr, feedbacks_nr, recording.len);
+
+	/* stop recording, the compressor may then be destroyed */
+	if(!rohc_comp_set_recorder(comp, NULL, NULL, 0))
+	{
+		fprintf(stderr, "failed to stop the recorder of the compressor\n");
+		goto destroy_decomp;
+	}
+
+	/* replay the recording against a new compressor */
+	is_failure = test_replay(&recording, &rohc_pkts, rohc_lens, rohc_pkts_nr);
+
+destroy_decomp:
+	rohc_decomp_free(decomp);
+destroy_comp:
+	rohc_comp_free(comp);
+	free(rohc_lens);
+	free(rohc_pkts.data);
+	free(recording.data);
+close_input:
+	pcap_close(handle);
+error:
+	return is_failure;
+}
+
+
+/**
+ * @brief Replay the recording and compare with the recorded ROHC packets
+ *
+ * @param recording     The recording of the workload of the compressor
+ * @param rohc_pkts     The ROHC packets compressed during the recording
+ * @param rohc_lens     The lengths of the ROHC packets
+ * @param rohc_pkts_nr  The number of ROHC packets
+ * @return              0 in case of success,
+ *                      1 in case of failure
+ */
+static int test_replay(const struct test_buf *const recording,
+                       const struct test_buf *const rohc_pkts,
+                       const size_t *const rohc_lens,
+                       const size_t rohc_pkts_nr)
+{
+	struct rohc_record_hdr hdr;
+	struct rohc_comp *comp;
+	struct test_buf replayed = { .data = NULL, .len = 0, .max_len = 0 };
+	size_t rohc_pkts_offset = 0;
+	size_t pkts_nr = 0;
+	size_t feedbacks_nr = 0;
+	size_t pos;
+	int is_failure = 1;
+
+	/* check the header of the recording */
+	if(recording->len < sizeof(struct rohc_record_hdr))
+	{
+		fprintf(stderr, "recording too short for its header\n");
+		goto error;
+	}
+	memcpy(&hdr, recording->data, sizeof(struct rohc_record_hdr));
+	if(hdr.magic != ROHC_RECORD_MAGIC ||
+	   hdr.version != ROHC_RECORD_VERSION ||
+	   hdr.entity != ROHC_RECORD_COMP ||
+	   hdr.profiles_nr > ROHC_RECORD_PROFILES_MAX)
+	{
+		fprintf(stderr, "malformed header of recording\n");
+		goto error;
+	}
+	pos = sizeof(struct rohc_record_hdr);
+
+	/* create a new compressor with the recorded configuration */
+	comp = create_comp_from_record(&hdr);
+	if(comp == NULL)
+	{
+		goto error;
+	}
+
+	/* replay every input in order */
+	while(pos < recording->len)
+	{
+		struct rohc_record_event event;
+		struct rohc_ts arrival_time;
+		struct rohc_buf input = rohc_buf_init_empty(NULL, 0);
+
+		if((recording->len - pos) < sizeof(struct rohc_record_event))
+		{
+			fprintf(stderr, "recording truncated in the middle of an event\n");
+			goto destroy_comp;
+		}
+		memcpy(&event, recording->data + pos, sizeof(struct rohc_record_event));
+		pos += sizeof(struct rohc_record_event);
+		if(event.len != event.orig_len || event.flags != 0 ||
+		   (recording->len - pos) < event.len)
+		{
+			fprintf(stderr, "malformed or truncated input in recording\n");
+			goto destroy_comp;
+		}
+		arrival_time.sec = event.sec;
+		arrival_time.nsec = event.nsec;
+		input.time = arrival_time;
+		input.data = recording->data + pos;
+		input.max_len = event.len;
+		input.len = event.len;
+		pos += event.len;
+
+		if(event.type == ROHC_RECORD_FEEDBACK)
+		{
+			if(!rohc_comp_deliver_feedback2(comp, input))
+			{
+				fprintf(stderr, "failed to replay feedback #%zu\n",
+				        feedbacks_nr + 1);
+				goto destroy_comp;
+			}
+			feedbacks_nr++;
+		}
+		else if(event.type == ROHC_RECORD_PKT)
+		{
+			rohc_status_t status;
+
+			if(pkts_nr >= rohc_pkts_nr)
+			{
+				fprintf(stderr, "more packets replayed than compressed\n");
+				goto destroy_comp;
+			}
+
+			replayed.len = 0;
+			status = compress_all(comp, input, event.cid, &replayed);
+			if(status != ROHC_STATUS_OK)
+			{
+				fprintf(stderr, "failed to replay packet #%zu: %s\n",
+				        pkts_nr + 1, rohc_strerror(status));
+				goto destroy_comp;
+			}
+
+			/* the replay shall give the very same ROHC packet */
+			if(replayed.len != rohc_lens[pkts_nr] ||
+			   memcmp(replayed.data, rohc_pkts->data + rohc_pkts_offset,
+			          replayed.len) != 0)
+			{
+				fprintf(stderr, "replayed packet #%zu does not match the "
+				        "recorded one (%zu bytes instead of %zu)\n", pkts_nr + 1,
+				        replayed.len, rohc_lens[pkts_nr]);
+				goto destroy_comp;
+			}
+			rohc_pkts_offset += rohc_lens[pkts_nr];
+			pkts_nr++;
+		}
+		else
+		{
+			fprintf(stderr, "unknown type %u of input\n", event.type);
+			goto destroy_comp;
+		}
+	}
+	if(pkts_nr != rohc_pkts_nr)
+	{
+		fprintf(stderr, "%zu packets replayed but %zu packets compressed\n",
+		        pkts_nr, rohc_pkts_nr);
+		goto destroy_comp;
+	}
+	fprintf(stderr, "%zu packets and %zu feedbacks replayed, all ROHC packets "
+	        "match\n", pkts_nr, feedbacks_nr);
+
+	/* everything went fine */
+	is_failure = 0;
+
+destroy_comp:
+	rohc_comp_free(comp);
+	free(replayed.data);
+error:
+	return is_failure;
+}
+
+
+/**
+ * @brief Create the ROHC compressor whose workload is recorded
+ *
+ * @return  The compressor, NULL in case of failure
+ */
+static struct rohc_comp * create_comp(void)
+{
+	struct rohc_comp *comp;
+
+	comp = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX,
+	                      gen_false_random_num, NULL);
+	if(comp == NULL)
+	{
+		fprintf(stderr, "failed to create the ROHC compressor\n");
+		goto error;
+	}
+	if(!rohc_comp_set_traces_cb2(comp, print_rohc_traces, NULL))
+	{
+		fprintf(stderr, "failed to set the callback for traces on "
+		        "compressor\n");
+		goto destroy_comp;
+	}
+	if(!rohc_comp_enable_profiles(comp, ROHC_PROFILE_UNCOMPRESSED,
+	                              ROHC_PROFILE_UDP, ROHC_PROFILE_IP,
+	                              ROHC_PROFILE_UDPLITE, ROHC_PROFILE_ESP,
+	                              ROHC_PROFILE_TCP, -1))
+	{
+		fprintf(stderr, "failed to enable the compression profiles\n");
+		goto destroy_comp;
+	}
+
+	return comp;
+
+destroy_comp:
+	rohc_comp_free(comp);
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Create a ROHC compressor with the recorded configuration
+ *
+ * @param hdr  The header of the recording
+ * @return     The compressor, NULL in case of failure
+ */
+static struct rohc_comp *
+	create_comp_from_record(const struct rohc_record_hdr *const hdr)
+{
+	struct rohc_comp *comp;
+	size_t i;
+
+	comp = rohc_comp_new2(hdr->cid_type, hdr->max_cid, gen_false_random_num,
+	                      NULL);
+	if(comp == NULL)
+	{
+		fprintf(stderr, "failed to create the ROHC compressor for replay\n");
+		goto error;
+	}
+	if(!rohc_comp_set_traces_cb2(comp, print_rohc_traces, NULL))
+	{
+		fprintf(stderr, "failed to set the callback for traces on "
+		        "compressor\n");
+		goto destroy_comp;
+	}
+	for(i = 0; i < hdr->profiles_nr; i++)
+	{
+		if(!rohc_comp_enable_profile(comp, hdr->profiles[i]))
+		{
+			fprintf(stderr, "failed to enable the compression profile "
+			        "0x%04x\n", hdr->profiles[i]);
+			goto destroy_comp;
+		}
+	}
+	if(!rohc_comp_set_features(comp, hdr->features))
+	{
+		fprintf(stderr, "failed to enable the compression features 0x%x\n",
+		        hdr->features);
+		goto destroy_comp;
+	}
+	if(!rohc_comp_set_wlsb_window_width(comp, hdr->param))
+	{
+		fprintf(stderr, "failed to set the W-LSB window width %u\n",
+		        hdr->param);
+		goto destroy_comp;
+	}
+	if(!rohc_comp_set_mrru(comp, hdr->mrru))
+	{
+		fprintf(stderr, "failed to set the MRRU %u\n", hdr->mrru);
+		goto destroy_comp;
+	}
+
+	return comp;
+
+destroy_comp:
+	rohc_comp_free(comp);
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Compress one IP packet and append the ROHC packet to a buffer
+ *
+ * The segments of the packets too large for the MRRU are appended too.
+ *
+ * @param comp       The ROHC compressor
+ * @param ip_packet  The IP packet to compress
+ * @param cid        The CID for the packet, ROHC_RECORD_NO_CID if none
+ * @param output     The buffer the ROHC packet is appended to
+ * @return           The status of the compression
+ */
+static rohc_status_t compress_all(struct rohc_comp *const comp,
+                                  const struct rohc_buf ip_packet,
+                                  const uint32_t cid,
+                                  struct test_buf *const output)
+{
+	uint8_t rohc_buffer[MAX_ROHC_SIZE];
+	struct rohc_buf rohc_packet =
+		rohc_buf_init_empty(rohc_buffer, MAX_ROHC_SIZE);
+	rohc_status_t status;
+
+	if(cid == ROHC_RECORD_NO_CID)
+	{
+		status = rohc_compress4(comp, ip_packet, &rohc_packet);
+	}
+	else
+	{
+		status = rohc_compress_with_cid(comp, cid, ip_packet, &rohc_packet);
+	}
+	while(status == ROHC_STATUS_SEGMENT)
+	{
+		if(!test_buf_append(output, rohc_buf_data(rohc_packet), rohc_packet.len))
+		{
+			return ROHC_STATUS_ERROR;
+		}
+		rohc_packet.offset = 0;
+		rohc_packet.len = 0;
+		status = rohc_comp_get_segment2(comp, &rohc_packet);
+	}
+	if(status == ROHC_STATUS_OK &&
+	   !test_buf_append(output, rohc_buf_data(rohc_packet), rohc_packet.len))
+	{
+		return ROHC_STATUS_ERROR;
+	}
+
+	return status;
+}
+
+
+/**
+ * @brief Append bytes to a growing buffer
+ *
+ * @param buf   The buffer
+ * @param data  The bytes to append
+ * @param len   The number of bytes to append
+ * @return      true if the bytes were appended, false if out of memory
+ */
+static bool test_buf_append(struct test_buf *const buf,
+                            const uint8_t *const data,
+                            const size_t len)
+{
+	if((buf->len + len) > buf->max_len)
+	{
+		const size_t new_max_len = (buf->len + len) * 2;
+		uint8_t *const new_data = realloc(buf->data, new_max_len);
+		if(new_data == NULL)
+		{
+			return false;
+		}
+		buf->data = new_data;
+		buf->max_len = new_max_len;
+	}
+	if(len > 0)
+	{
+		memcpy(buf->data + buf->len, data, len);
+		buf->len += len;
+	}
+
+	return true;
+}
+
+
+/**
+ * @brief Write the recording of the compressor in memory
+ *
+ * @param priv  The buffer that holds the recording
+ * @param data  The bytes of the recording to write
+ * @param len   The number of bytes to write
+ * @return      true if all the bytes were written, false otherwise
+ */
+static bool record_cb(void *const priv,
+                      const uint8_t *const data,
+                      const size_t len)
+{
+	return test_buf_append(priv, data, len);
+}
+
+
+/**
+ * @brief Callback to print traces of the ROHC library
+ *
+ * @param priv_ctxt  An optional private context, may be NULL
+ * @param level      The priority level of the trace
+ * @param entity     The entity that emitted the trace among:
+ *                    \li ROHC_TRACE_COMP
+ *                    \li ROHC_TRACE_DECOMP
+ * @param profile    The ID of the ROHC compression/decompression profile
+ *                   the trace is related to
+ * @param format     The format string of the trace
+ */
+static void print_rohc_traces(void *const priv_ctxt __attribute__((unused)),
+                              const rohc_trace_level_t level,
+                              const rohc_trace_entity_t entity,
+                              const int profile,
+                              const char *const format,
+                              ...)
+{
+	va_list args;
+
+	va_start(args, format);
+	vfprintf(stdout, format, args);
+	va_end(args);
+}
+
+
+/**
+ * @brief Generate a false random number for recording and replaying
+ *
+ * The replay uses the same constant, the Sequence Numbers of the new flows
+ * are so the same in the recording and in the replay.
+ *
+ * @param comp          The ROHC compressor
+ * @param user_context  Should always be NULL
+ * @return              Always 0
+ */
+static int gen_false_random_num(const struct rohc_comp *const comp,
+                                void *const user_context)
+{
+	assert(comp != NULL);
+	assert(user_context == NULL);
+	return 0;
+}
@@ -0,0 +1 @@
+test_record_replay.sh
\ No newline at end of file
@@ -57,13 +57,22 @@
 /** The max size */
 #define TEST_MAX_ROHC_SIZE  (5U * 1024U)
 
+/** The max number of buffers of one ROHC segment given as views */
+#define TEST_MAX_SEGMENT_IOV  4U
+
 
 /* prototypes of private functions */
 static void usage(void);
 static int test_comp_and_decomp(const size_t ip_packet_len,
                                 const size_t mrru,
                                 const bool is_comp_expected_ok,
-                                const size_t expected_segments_nr);
+                                const size_t expected_segments_nr,
+                                const bool use_views);
+static rohc_status_t get_segment_views(struct rohc_comp *const comp,
+                                       struct rohc_buf *const segment)
+	__attribute__((nonnull(1, 2)));
+static int test_rru_slots(const size_t slots_nr,
+                          const size_t expected_pkts_nr);
 static void print_rohc_traces(void *const priv_ctxt,
                               const rohc_trace_level_t level,
                               const rohc_trace_entity_t entity,
@@ -90,6 +99,7 @@ static int gen_random_num(const struct rohc_comp *const comp,
 int main(int argc, char *argv[])
 {
 	int status = 1;
+	size_t i;
 
 	/* parse program arguments, print the help message in case of failure */
 	if(argc != 1)
@@ -98,44 +108,69 @@ int main(int argc, char *argv[])
 		goto error;
 	}
 
-	/* test ROHC segments with small packet (wrt output buffer) and large MRRU
-	 * => no segmentation needed */
-	status = test_comp_and_decomp(100, TEST_MAX_ROHC_SIZE * 2, true, 0);
-	if(status != 0)
+	/* test with ROHC segments copied, then given as views */
+	for(i = 0; i < 2; i++)
 	{
-		goto error;
-	}
+		const bool use_views = (i == 1);
 
-	/* test ROHC segments with large packet (wrt output buffer) and large MRRU,
-	 * => segmentation needed */
-	status |= test_comp_and_decomp(TEST_MAX_ROHC_SIZE,
-	                               TEST_MAX_ROHC_SIZE * 2, true, 2);
-	if(status != 0)
-	{
-		goto error;
-	}
+		/* test ROHC segments with small packet (wrt output buffer) and large
+		 * MRRU => no segmentation needed */
+		status = test_comp_and_decomp(100, TEST_MAX_ROHC_SIZE * 2, true, 0,
+		                              use_views);
+		if(status != 0)
+		{
+			goto error;
+		}
 
-	/* test ROHC segments with large packet (wrt output buffer) and MRRU = 0,
-	 * ie. segments disabled => segmentation needed but impossible */
-	status |= test_comp_and_decomp(TEST_MAX_ROHC_SIZE, 0, false, 0);
-	if(status != 0)
-	{
-		goto error;
+		/* test ROHC segments with large packet (wrt output buffer) and large
+		 * MRRU, => segmentation needed */
+		status |= test_comp_and_decomp(TEST_MAX_ROHC_SIZE,
+		                               TEST_MAX_ROHC_SIZE * 2, true, 2,
+		                               use_views);
+		if(status != 0)
+		{
+			goto error;
+		}
+
+		/* test ROHC segments with large packet (wrt output buffer) and
+		 * MRRU = 0, ie. segments disabled => segmentation needed but
+		 * impossible */
+		status |= test_comp_and_decomp(TEST_MAX_ROHC_SIZE, 0, false, 0,
+		                               use_views);
+		if(status != 0)
+		{
+			goto error;
+		}
+
+		/* test ROHC segments with very large packet (wrt output buffer) and
+		 * large MRRU => segmentation needed, more than 2 segments expected */
+		status |= test_comp_and_decomp(TEST_MAX_ROHC_SIZE * 2,
+		                               TEST_MAX_ROHC_SIZE * 3, true, 3,
+		                               use_views);
+		if(status != 0)
+		{
+			goto error;
+		}
+
+		/* test ROHC segments with very large packet (wrt output buffer) and
+		 * large MRRU (but not large enough) => segmentation needed, but MRRU
+		 * forbids it */
+		status |= test_comp_and_decomp(TEST_MAX_ROHC_SIZE * 2,
+		                               TEST_MAX_ROHC_SIZE, false, 0, use_views);
+		if(status != 0)
+		{
+			goto error;
+		}
 	}
 
-	/* test ROHC segments with very large packet (wrt output buffer) and large
-	 * MRRU => segmentation needed, more than 2 segments expected */
-	status |= test_comp_and_decomp(TEST_MAX_ROHC_SIZE * 2,
-	                               TEST_MAX_ROHC_SIZE * 3, true, 3);
+	/* test 2 segmented packets in a burst with one RRU slot => the first
+	 * RRU is lost, then with 2 RRU slots => both RRUs are retrieved */
+	status |= test_rru_slots(1, 1);
 	if(status != 0)
 	{
 		goto error;
 	}
-
-	/* test ROHC segments with very large packet (wrt output buffer) and large
-	 * MRRU (but not large enough) => segmentation needed, but MRRU forbids it */
-	status |= test_comp_and_decomp(TEST_MAX_ROHC_SIZE * 2, TEST_MAX_ROHC_SIZE,
-	                               false, 0);
+	status |= test_rru_slots(2, 2);
 	if(status != 0)
 	{
 		goto error;
@@ -172,13 +207,16 @@ static void usage(void)
  *                              successful or not?
  * @parma expected_segments_nr  The number of ROHC segments that we expect
  *                              for the test
+ * @param use_views             Whether the ROHC segments are given as views
+ *                              over the uncompressed packet or copied
  * @return                      0 in case of success,
  *                              1 in case of failure
  */
 static int test_comp_and_decomp(const size_t ip_packet_len,
                                 const size_t mrru,
                                 const bool is_comp_expected_ok,
-                                const size_t expected_segments_nr)
+                                const size_t expected_segments_nr,
+                                const bool use_views)
 {
 //! [define ROHC compressor]
 	struct rohc_comp *comp;
@@ -207,7 +245,8 @@ static int test_comp_and_decomp(const size_t ip_packet_len,
 	size_t i;
 
 	fprintf(stderr, "test ROHC segments with %zu-byte IP packet and "
-	        "MMRU = %zu bytes\n", ip_packet_len, mrru);
+	        "MMRU = %zu bytes (segments %s)\n", ip_packet_len, mrru,
+	        (use_views ? "given as views" : "copied"));
 
 	/* check that buffer for IP packet is large enough */
 	if(ip_packet_len > TEST_MAX_ROHC_SIZE * 3)
@@ -255,6 +294,14 @@ static int test_comp_and_decomp(const size_t ip_packet_len,
 	}
 //! [set compressor MRRU]
 
+	/* do not copy the payload of the segmented packet if requested */
+	if(use_views &&
+	   !rohc_comp_set_features(comp, ROHC_COMP_FEATURE_SEGMENT_VIEWS))
+	{
+		fprintf(stderr, "failed to enable the segments as views\n");
+		goto destroy_comp;
+	}
+
 //! [create ROHC decompressor]
 	/* create the ROHC decompressor in uni-directional mode */
 	decomp = rohc_decomp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, ROHC_U_MODE);
@@ -342,7 +389,9 @@ static int test_comp_and_decomp(const size_t ip_packet_len,
 
 //! [segment ROHC packet #2]
 		/* get the segments */
-		while((status = rohc_comp_get_segment2(comp, &rohc_packet)) == ROHC_STATUS_SEGMENT)
+		while((status = (use_views ?
+		                 get_segment_views(comp, &rohc_packet) :
+		                 rohc_comp_get_segment2(comp, &rohc_packet))) == ROHC_STATUS_SEGMENT)
 		{
 			/* new ROHC segment retrieved */
 //! [segment ROHC packet #2]
@@ -469,6 +518,192 @@ error:
 }
 
 
+/**
+ * @brief Test the ROHC library with 2 segmented packets compressed in a burst
+ *
+ * @param slots_nr          The number of RRU slots of the compressor
+ * @param expected_pkts_nr  The number of packets that we expect to be
+ *                          decompressed from the segments
+ * @return                  0 in case of success,
+ *                          1 in case of failure
+ */
+static int test_rru_slots(const size_t slots_nr,
+                          const size_t expected_pkts_nr)
+{
+	const size_t ip_packet_len = TEST_MAX_ROHC_SIZE;
+	const size_t mrru = TEST_MAX_ROHC_SIZE * 2;
+	struct rohc_comp *comp;
+	struct rohc_decomp *decomp;
+
+	struct ipv4_hdr *ip_header;
+	uint8_t ip_buffer[TEST_MAX_ROHC_SIZE];
+	struct rohc_buf ip_packet =
+		rohc_buf_init_empty(ip_buffer, TEST_MAX_ROHC_SIZE);
+
+	uint8_t rohc_buffer[TEST_MAX_ROHC_SIZE];
+	struct rohc_buf rohc_packet =
+		rohc_buf_init_empty(rohc_buffer, TEST_MAX_ROHC_SIZE);
+
+	uint8_t uncomp_buffer[TEST_MAX_ROHC_SIZE];
+	struct rohc_buf uncomp_packet =
+		rohc_buf_init_empty(uncomp_buffer, TEST_MAX_ROHC_SIZE);
+
+	size_t pkts_nr = 0;
+	int is_failure = 1;
+	rohc_status_t status;
+	size_t i;
+
+	fprintf(stderr, "test 2 segmented packets in a burst with %zu RRU "
+	        "slot(s)\n", slots_nr);
+
+	/* create the ROHC compressor and decompressor with segmentation */
+	comp = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX,
+	                      gen_random_num, NULL);
+	if(comp == NULL)
+	{
+		fprintf(stderr, "failed to create the ROHC compressor\n");
+		goto error;
+	}
+	if(!rohc_comp_set_traces_cb2(comp, print_rohc_traces, NULL) ||
+	   !rohc_comp_enable_profile(comp, ROHC_PROFILE_IP) ||
+	   !rohc_comp_set_mrru(comp, mrru) ||
+	   !rohc_comp_set_rru_slots(comp, slots_nr))
+	{
+		fprintf(stderr, "failed to configure the ROHC compressor\n");
+		goto destroy_comp;
+	}
+	decomp = rohc_decomp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, ROHC_U_MODE);
+	if(decomp == NULL)
+	{
+		fprintf(stderr, "failed to create the ROHC decompressor\n");
+		goto destroy_comp;
+	}
+	if(!rohc_decomp_set_traces_cb2(decomp, print_rohc_traces, NULL) ||
+	   !rohc_decomp_enable_profile(decomp, ROHC_PROFILE_IP) ||
+	   !rohc_decomp_set_mrru(decomp, mrru))
+	{
+		fprintf(stderr, "failed to configure the ROHC decompressor\n");
+		goto destroy_decomp;
+	}
+
+	/* generate the IP packet */
+	ip_packet.len = ip_packet_len;
+	ip_header = (struct ipv4_hdr *) rohc_buf_data(ip_packet);
+	ip_header->version = 4;
+	ip_header->ihl = 5;
+	ip_header->tos = 0;
+	ip_header->tot_len = htons(ip_packet_len);
+	ip_header->id = 0;
+	ip_header->frag_off = 0;
+	ip_header->ttl = 1;
+	ip_header->protocol = 134;
+	ip_header->check = htons(0x9565);
+	ip_header->saddr = htonl(0x01020304);
+	ip_header->daddr = htonl(0x05060708);
+	for(i = sizeof(struct ipv4_hdr); i < ip_packet_len; i++)
+	{
+		rohc_buf_byte_at(ip_packet, i) = i & 0xff;
+	}
+
+	/* compress the IP packet twice before retrieving any segment */
+	for(i = 0; i < 2; i++)
+	{
+		status = rohc_compress4(comp, ip_packet, &rohc_packet);
+		if(status != ROHC_STATUS_SEGMENT)
+		{
+			fprintf(stderr, "\tfailed to compress IP packet #%zu in ROHC "
+			        "segments\n", i + 1);
+			goto destroy_decomp;
+		}
+	}
+
+	/* retrieve and decompress the segments of all the RRUs */
+	while((status = rohc_comp_get_segment2(comp, &rohc_packet)) != ROHC_STATUS_ERROR)
+	{
+		fprintf(stderr, "\t%zu-byte %s ROHC segment generated\n",
+		        rohc_packet.len, status == ROHC_STATUS_OK ? "final" : "non-final");
+		if(rohc_decompress3(decomp, rohc_packet, &uncomp_packet,
+		                    NULL, NULL) != ROHC_STATUS_OK)
+		{
+			fprintf(stderr, "\tfailed to decompress ROHC segment\n");
+			goto destroy_decomp;
+		}
+		if(status == ROHC_STATUS_OK)
+		{
+			if(uncomp_packet.len != ip_packet.len ||
+			   memcmp(rohc_buf_data(ip_packet), rohc_buf_data(uncomp_packet),
+			          ip_packet.len) != 0)
+			{
+				fprintf(stderr, "\tdecompressed packet does not match the "
+				        "original IP packet\n");
+				goto destroy_decomp;
+			}
+			pkts_nr++;
+		}
+		rohc_packet.len = 0;
+		uncomp_packet.len = 0;
+	}
+
+	/* check the number of decompressed packets */
+	if(pkts_nr != expected_pkts_nr)
+	{
+		fprintf(stderr, "\t%zu packet(s) decompressed while %zu expected\n",
+		        pkts_nr, expected_pkts_nr);
+		goto destroy_decomp;
+	}
+	fprintf(stderr, "\t%zu packet(s) decompressed as expected\n\n", pkts_nr);
+	is_failure = 0;
+
+destroy_decomp:
+	rohc_decomp_free(decomp);
+destroy_comp:
+	rohc_comp_free(comp);
+error:
+	return is_failure;
+}
+
+
+/**
+ * @brief Get the next ROHC segment as views, and gather them in one buffer
+ *
+ * @param comp          The ROHC compressor
+ * @param[out] segment  The buffer where to gather the ROHC segment
+ * @return              The same values as \ref rohc_comp_get_segment_iov
+ */
+static rohc_status_t get_segment_views(struct rohc_comp *const comp,
+                                       struct rohc_buf *const segment)
+{
+	struct rohc_buf segment_iov[TEST_MAX_SEGMENT_IOV];
+	size_t segment_iov_nr = TEST_MAX_SEGMENT_IOV;
+	rohc_status_t status;
+	size_t i;
+
+	status = rohc_comp_get_segment_iov(comp, rohc_buf_avail_len(*segment),
+	                                   segment_iov, &segment_iov_nr);
+	if(status == ROHC_STATUS_ERROR)
+	{
+		goto error;
+	}
+	fprintf(stderr, "\tROHC segment given as %zu views\n", segment_iov_nr);
+
+	/* the segment type shall be given apart */
+	if(segment_iov_nr < 2 || segment_iov[0].len != 1)
+	{
+		fprintf(stderr, "\tmalformed views of ROHC segment\n");
+		goto error;
+	}
+	for(i = 0; i < segment_iov_nr; i++)
+	{
+		rohc_buf_append_buf(segment, segment_iov[i]);
+	}
+
+	return status;
+
+error:
+	return ROHC_STATUS_ERROR;
+}
+
+
 /**
  * @brief Callback to print traces of the ROHC library
  *
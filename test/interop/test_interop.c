@@ -24,6 +24,11 @@
  *
  * Test the ROHC decompression performed by the ROHC library with a flow of
  * ROHC packets that were generated by another ROHC implementation.
+ *
+ * With the --throughput option, the flow is then decompressed again and
+ * again to measure the number of packets decompressed per second: the other
+ * implementations use other packet types than the ROHC library, so they
+ * exercise other paths of the decompressor.
  */
 
 #include "test.h"
@@ -43,6 +48,7 @@
 #include <errno.h>
 #include <assert.h>
 #include <stdarg.h>
+#include <time.h> /* for clock_gettime(2) */
 
 /* includes for network headers */
 #include <protocols/ipv4.h>
@@ -64,6 +70,9 @@ for ./configure ? If yes, check configure output and config.log"
 #include <rohc_comp.h>
 #include <rohc_decomp.h>
 
+/* for replaying the captures in memory */
+#include "pcap_mmap.h"
+
 
 /* prototypes of private functions */
 static void usage(void);
@@ -80,6 +89,11 @@ static int test_decomp_one(struct rohc_decomp *const decomp,
                            const unsigned char *const cmp_packet,
                            const size_t cmp_size,
                            const size_t link_len_cmp);
+static int test_decomp_throughput(const rohc_cid_type_t cid_type,
+                                  const size_t max_contexts,
+                                  const char *const src_filename,
+                                  const size_t loops_nr)
+	__attribute__((warn_unused_result, nonnull(3)));
 
 static struct rohc_decomp * create_decompressor(const rohc_cid_type_t cid_type,
                                                 const size_t max_contexts)
@@ -127,6 +141,7 @@ int main(int argc, char *argv[])
 	char *cmp_filename = NULL;
 	int max_contexts = ROHC_SMALL_CID_MAX + 1;
 	int wlsb_width = 4;
+	int loops_nr = 0;
 	int status = 1;
 	rohc_cid_type_t cid_type;
 	int args_used;
@@ -199,6 +214,19 @@ int main(int argc, char *argv[])
 			wlsb_width = atoi(argv[1]);
 			args_used++;
 		}
+		else if(!strcmp(*argv, "--throughput"))
+		{
+			/* get the number of times the flow is decompressed to measure the
+			 * throughput of the decompressor */
+			if(argc <= 1)
+			{
+				fprintf(stderr, "option --throughput takes one argument\n\n");
+				usage();
+				goto error;
+			}
+			loops_nr = atoi(argv[1]);
+			args_used++;
+		}
 		else if(cid_type_name == NULL)
 		{
 			/* get the type of CID to use within the ROHC library */
@@ -265,6 +293,14 @@ int main(int argc, char *argv[])
 		goto error;
 	}
 
+	/* check the number of loops for the throughput */
+	if(loops_nr < 0)
+	{
+		fprintf(stderr, "invalid number of loops %d: should be positive or "
+		        "zero\n", loops_nr);
+		goto error;
+	}
+
 	/* the source filename is mandatory */
 	if(src_filename == NULL)
 	{
@@ -277,6 +313,13 @@ int main(int argc, char *argv[])
 	status = test_decomp_all(cid_type, wlsb_width, max_contexts,
 	                         src_filename, cmp_filename);
 
+	/* then measure the throughput of the decompressor if asked */
+	if(status == 0 && loops_nr > 0)
+	{
+		status = test_decomp_throughput(cid_type, max_contexts, src_filename,
+		                                loops_nr);
+	}
+
 error:
 	return status;
 }
@@ -307,6 +350,9 @@ static void usage(void)
 	        "  --max-contexts NUM      The maximum number of ROHC contexts to\n"
 	        "                          simultaneously use during the test\n"
 	        "  --wlsb-width NUM        The width of the WLSB window to use\n"
+	        "  --throughput NUM        Then decompress the flow NUM times and\n"
+	        "                          print the number of packets decompressed\n"
+	        "                          per second\n"
 	        "  -v, --verbose           Run the test in verbose mode\n");
 }
 
@@ -736,6 +782,147 @@ error:
 }
 
 
+/**
+ * @brief Measure the throughput of the ROHC decompression with a flow of ROHC
+ *        packets generated by another ROHC implementation
+ *
+ * The flow is mapped in memory, then decompressed \e loops_nr times by the
+ * same decompressor. The first packet of every context is an IR packet, as
+ * checked by the correctness test: every loop thus decompresses the flow as
+ * the first one did. Only the decompression of the packets is timed.
+ *
+ * @param cid_type      The type of CIDs the decompressor shall use
+ * @param max_contexts  The maximum number of ROHC contexts to use
+ * @param src_filename  The name of the PCAP file that contains the ROHC
+ *                      packets to decompress
+ * @param loops_nr      The number of times the flow is decompressed
+ * @return              0 in case of success,
+ *                      1 in case of failure
+ */
+static int test_decomp_throughput(const rohc_cid_type_t cid_type,
+                                  const size_t max_contexts,
+                                  const char *const src_filename,
+                                  const size_t loops_nr)
+{
+	const struct rohc_ts arrival_time = { .sec = 0, .nsec = 0 };
+	char errbuf[PCAP_MMAP_ERRBUF_SIZE];
+	struct pcap_mmap capture;
+	size_t link_len;
+	uint8_t uncomp_buffer[MAX_ROHC_SIZE];
+	struct rohc_decomp *decomp;
+	uint64_t total_ns = 0;
+	uint64_t best_ns = 0;
+	size_t packets_nr = 0;
+	size_t loop;
+	int status = 1;
+
+	printf("=== throughput:\n");
+
+	/* map the source dump file in memory */
+	if(!pcap_mmap_open(&capture, src_filename, errbuf))
+	{
+		printf("failed to map the source pcap file: %s\n", errbuf);
+		goto error;
+	}
+	if(capture.linktype == PCAP_MMAP_LINKTYPE_ETHERNET)
+	{
+		link_len = ETHER_HDR_LEN;
+	}
+	else if(capture.linktype == PCAP_MMAP_LINKTYPE_LINUX_SLL)
+	{
+		link_len = LINUX_COOKED_HDR_LEN;
+	}
+	else if(capture.linktype == PCAP_MMAP_LINKTYPE_NULL)
+	{
+		link_len = BSD_LOOPBACK_HDR_LEN;
+	}
+	else if(capture.linktype == PCAP_MMAP_LINKTYPE_RAW)
+	{
+		link_len = 0;
+	}
+	else
+	{
+		printf("link layer type %u not supported in source dump\n",
+		       capture.linktype);
+		goto close_input;
+	}
+
+	/* the debug traces of the library shall not be timed */
+	decomp = create_decompressor(cid_type, max_contexts);
+	if(decomp == NULL)
+	{
+		goto close_input;
+	}
+	if(!rohc_decomp_set_trace_level(decomp, ROHC_TRACE_WARNING))
+	{
+		printf("failed to set the level of traces\n");
+		goto free_decomp;
+	}
+
+	for(loop = 0; loop < loops_nr; loop++)
+	{
+		struct rohc_buf rohc_packet;
+		struct timespec start;
+		struct timespec end;
+		uint64_t loop_ns;
+		size_t wire_len;
+
+		/* decompress all the packets of the flow */
+		capture.offset = PCAP_MMAP_FILE_HDR_LEN;
+		packets_nr = 0;
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		while(pcap_mmap_next(&capture, &rohc_packet, &wire_len))
+		{
+			struct rohc_buf uncomp_packet =
+				rohc_buf_init_empty(uncomp_buffer, MAX_ROHC_SIZE);
+
+			packets_nr++;
+			if(rohc_packet.len <= link_len)
+			{
+				printf("packet #%zu: too small for link header\n", packets_nr);
+				goto free_decomp;
+			}
+			rohc_buf_pull(&rohc_packet, link_len);
+			rohc_packet.time = arrival_time;
+
+			if(rohc_decompress3(decomp, rohc_packet, &uncomp_packet,
+			                    NULL, NULL) != ROHC_STATUS_OK)
+			{
+				printf("packet #%zu: failed to decompress the ROHC packet\n",
+				       packets_nr);
+				goto free_decomp;
+			}
+		}
+		clock_gettime(CLOCK_MONOTONIC, &end);
+
+		loop_ns = (end.tv_sec - start.tv_sec) * 1000000000ULL +
+		          end.tv_nsec - start.tv_nsec;
+		total_ns += loop_ns;
+		if(loop == 0 || loop_ns < best_ns)
+		{
+			best_ns = loop_ns;
+		}
+	}
+
+	/* packets per microsecond are millions of packets per second */
+	printf("===\tpackets:   %zu per loop, %zu loops\n", packets_nr, loops_nr);
+	printf("===\tmean:      %.3f Mpps\n", total_ns == 0 ? 0.0 :
+	       ((double) packets_nr * loops_nr * 1000) / total_ns);
+	printf("===\tbest loop: %.3f Mpps\n", best_ns == 0 ? 0.0 :
+	       ((double) packets_nr * 1000) / best_ns);
+	printf("\n");
+
+	status = 0;
+
+free_decomp:
+	rohc_decomp_free(decomp);
+close_input:
+	pcap_mmap_close(&capture);
+error:
+	return status;
+}
+
+
 /**
  * @brief Create and configure a ROHC decompressor
  *
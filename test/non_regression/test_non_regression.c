@@ -80,9 +80,20 @@
  * comparison and shutdown).
  *
  * The program optionally outputs the ROHC packets in a PCAP packet.
+ *
+ * Timing
+ * ------
+ *
+ * The program optionally measures the CPU cycles spent to compress and
+ * decompress every packet. It replays the flow several times and keeps the
+ * best run to reduce the noise. The cycles per packet may be appended to a
+ * file, and compared with the ones stored in a baseline file generated on
+ * the same machine: the test fails if the capture regressed beyond the given
+ * tolerance.
  */
 
 #include "test.h"
+#include "pcap_mmap.h"
 #include "config.h" /* for HAVE_*_H */
 
 /* system includes */
@@ -99,6 +110,11 @@
 #include <errno.h>
 #include <assert.h>
 #include <stdarg.h>
+#include <inttypes.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#  include <x86intrin.h> /* for __rdtsc() */
+#endif
 
 /* includes for network headers */
 #include <protocols/ipv4.h>
@@ -123,6 +139,12 @@ for ./configure ? If yes, check configure output and config.log"
 /** The maximum number of source PCAP dump files */
 #define SRC_FILENAMES_MAX_NR  2U
 
+/** The default number of runs in timing mode */
+#define TIMING_RUNS_DEFAULT  5U
+
+/** The default tolerance (in percent) with the timing baseline */
+#define TIMING_TOLERANCE_DEFAULT  10U
+
 /** print text on console if not in quiet mode */
 #define trace(format, ...) \
 	do { \
@@ -188,9 +210,13 @@ static bool rohc_comp_rtp_cb(const unsigned char *const ip,
                              void *const rtp_private)
 	__attribute__((warn_unused_result));
 
-static pcap_t * open_pcap_file(const char *const filename, size_t *const link_len)
-	__attribute__((nonnull(1, 2), warn_unused_result));
-static bool get_next_packet(pcap_t **const pcap_handle,
+static bool open_pcap_file(const char *const filename,
+                           struct pcap_mmap *const capture,
+                           size_t *const link_len)
+	__attribute__((nonnull(1, 2, 3), warn_unused_result));
+static int linktype_to_dlt(const uint32_t linktype)
+	__attribute__((warn_unused_result, const));
+static bool get_next_packet(struct pcap_mmap *const capture,
                             const char *const src_filenames[],
                             const size_t src_filenames_nr,
                             size_t *const src_filenames_id,
@@ -217,6 +243,17 @@ static void show_rohc_decomp_profile(const struct rohc_decomp *const decomp,
 static int compare_packets(unsigned char *pkt1, int pkt1_size,
                            unsigned char *pkt2, int pkt2_size);
 
+static uint64_t timing_now(void);
+static bool timing_write(const char *const filename,
+                         const char *const name,
+                         const double cycles_per_packet)
+	__attribute__((nonnull(1, 2), warn_unused_result));
+static bool timing_compare(const char *const filename,
+                           const char *const name,
+                           const double cycles_per_packet,
+                           const unsigned int tolerance)
+	__attribute__((nonnull(1, 2), warn_unused_result));
+
 
 /** Whether the application runs in verbose mode or not */
 static enum
@@ -229,6 +266,13 @@ static enum
 /** The number of warnings emitted by the ROHC library */
 static size_t nr_rohc_warnings = 0;
 
+/** Whether the CPU cycles spent per packet are measured or not */
+static bool timing_enabled = false;
+/** The CPU cycles spent to compress and decompress packets in current run */
+static uint64_t timing_cycles = 0;
+/** The number of packets compressed and decompressed in current run */
+static unsigned long timing_packets = 0;
+
 
 /**
  * @brief Main function for the ROHC test program
@@ -253,9 +297,17 @@ int main(int argc, char *argv[])
 	bool no_comparison = false;
 	bool ignore_malformed = false;
 	bool assert_on_error = false;
+	char *timing_ofilename = NULL;
+	char *timing_baseline = NULL;
+	char *timing_name = NULL;
+	int timing_tolerance = TIMING_TOLERANCE_DEFAULT;
+	int timing_runs = TIMING_RUNS_DEFAULT;
+	int saved_verbosity;
+	double best_cycles_per_packet = 0;
 	int status = 1;
 	rohc_cid_type_t cid_type;
 	int args_used;
+	int run;
 
 	/* set to quiet mode by default */
 	verbosity = VERBOSITY_NORMAL;
@@ -372,6 +424,66 @@ int main(int argc, char *argv[])
 			wlsb_width = atoi(argv[1]);
 			args_used++;
 		}
+		else if(!strcmp(*argv, "--timing-output"))
+		{
+			/* get the name of the file to append the cycles per packet to */
+			if(argc <= 1)
+			{
+				fprintf(stderr, "option --timing-output takes one argument\n\n");
+				usage();
+				goto error;
+			}
+			timing_ofilename = argv[1];
+			args_used++;
+		}
+		else if(!strcmp(*argv, "--timing-baseline"))
+		{
+			/* get the name of the file with the reference cycles per packet */
+			if(argc <= 1)
+			{
+				fprintf(stderr, "option --timing-baseline takes one argument\n\n");
+				usage();
+				goto error;
+			}
+			timing_baseline = argv[1];
+			args_used++;
+		}
+		else if(!strcmp(*argv, "--timing-tolerance"))
+		{
+			/* get the regression tolerated with the baseline (in percent) */
+			if(argc <= 1)
+			{
+				fprintf(stderr, "option --timing-tolerance takes one argument\n\n");
+				usage();
+				goto error;
+			}
+			timing_tolerance = atoi(argv[1]);
+			args_used++;
+		}
+		else if(!strcmp(*argv, "--timing-name"))
+		{
+			/* get the name of the capture in the timing files */
+			if(argc <= 1)
+			{
+				fprintf(stderr, "option --timing-name takes one argument\n\n");
+				usage();
+				goto error;
+			}
+			timing_name = argv[1];
+			args_used++;
+		}
+		else if(!strcmp(*argv, "--timing-runs"))
+		{
+			/* get the number of times the flow is replayed in timing mode */
+			if(argc <= 1)
+			{
+				fprintf(stderr, "option --timing-runs takes one argument\n\n");
+				usage();
+				goto error;
+			}
+			timing_runs = atoi(argv[1]);
+			args_used++;
+		}
 		else if(cid_type_name == NULL)
 		{
 			/* get the type of CID to use within the ROHC library */
@@ -455,12 +567,88 @@ int main(int argc, char *argv[])
 		goto error;
 	}
 
-	/* test ROHC compression/decompression with the packets from the file */
-	status = test_comp_and_decomp(cid_type, wlsb_width, max_contexts,
-	                              no_comparison, ignore_malformed,
-	                              (const char *const *) src_filenames, src_filenames_nr,
-	                              ofilename, cmp_filename,
-	                              rohc_size_ofilename);
+	/* check timing parameters */
+	timing_enabled = (timing_ofilename != NULL || timing_baseline != NULL);
+	if(timing_tolerance < 0)
+	{
+		fprintf(stderr, "invalid timing tolerance %d%%: should be positive or "
+		        "zero\n", timing_tolerance);
+		goto error;
+	}
+	if(timing_runs <= 0)
+	{
+		fprintf(stderr, "invalid number of timing runs %d: should be strictly "
+		        "positive\n", timing_runs);
+		goto error;
+	}
+	if(!timing_enabled)
+	{
+		timing_runs = 1;
+	}
+	if(timing_name == NULL)
+	{
+		timing_name = src_filenames[0];
+	}
+	if(strpbrk(timing_name, " \t\n") != NULL)
+	{
+		fprintf(stderr, "invalid timing name '%s': should not contain any "
+		        "whitespace\n", timing_name);
+		goto error;
+	}
+
+	/* test ROHC compression/decompression with the packets from the file,
+	 * several times in timing mode to keep the best run */
+	saved_verbosity = verbosity;
+	for(run = 0; run < timing_runs; run++)
+	{
+		double cycles_per_packet;
+
+		timing_cycles = 0;
+		timing_packets = 0;
+
+		status = test_comp_and_decomp(cid_type, wlsb_width, max_contexts,
+		                              no_comparison, ignore_malformed,
+		                              (const char *const *) src_filenames, src_filenames_nr,
+		                              ofilename, cmp_filename,
+		                              rohc_size_ofilename);
+		if(status != 0 || !timing_enabled)
+		{
+			break;
+		}
+
+		cycles_per_packet = (timing_packets == 0 ? 0 :
+		                     ((double) timing_cycles) / timing_packets);
+		if(run == 0 || cycles_per_packet < best_cycles_per_packet)
+		{
+			best_cycles_per_packet = cycles_per_packet;
+		}
+
+		/* print the traces of the first run only */
+		if(run == 0 && timing_runs > 1)
+		{
+			trace("=== timing: replay the flow %d more times\n", timing_runs - 1);
+			verbosity = VERBOSITY_NONE;
+		}
+	}
+	verbosity = saved_verbosity;
+
+	/* record and check the cycles spent per packet if asked */
+	if(timing_enabled && status == 0)
+	{
+		trace("=== timing: %.1f cycles per packet for '%s' (best of %d runs)\n",
+		      best_cycles_per_packet, timing_name, timing_runs);
+		if(timing_ofilename != NULL &&
+		   !timing_write(timing_ofilename, timing_name, best_cycles_per_packet))
+		{
+			status = 1;
+		}
+		if(timing_baseline != NULL &&
+		   !timing_compare(timing_baseline, timing_name, best_cycles_per_packet,
+		                   timing_tolerance))
+		{
+			status = 1;
+		}
+	}
 
 	trace("=== number of warnings/errors emitted by the library: %zu\n",
 	      nr_rohc_warnings);
@@ -512,8 +700,25 @@ static void usage(void)
 	        "  --no-comparison         Is comparison with ROHC reference optional for test\n"
 	        "  --ignore-malformed      Ignore malformed packets for test\n"
 	        "  --assert-on-error       Stop the test after the very first encountered error\n"
+	        "  --timing-output FILE    Measure the CPU cycles per packet and append\n"
+	        "                          them to FILE\n"
+	        "  --timing-baseline FILE  Measure the CPU cycles per packet and fail\n"
+	        "                          if they regressed compared to FILE\n"
+	        "  --timing-tolerance NUM  The regression tolerated with the timing\n"
+	        "                          baseline (in percent, default: %u)\n"
+	        "  --timing-name NAME      The name of the flow in timing files\n"
+	        "                          (default: the first FLOW)\n"
+	        "  --timing-runs NUM       The number of times the flow is replayed\n"
+	        "                          in timing mode, the best run is kept\n"
+	        "                          (default: %u)\n"
 	        "  --verbose               Run the test in verbose mode\n"
-	        "  --quiet                 Run the test in silent mode\n");
+	        "  --quiet                 Run the test in silent mode\n"
+	        "\n"
+	        "The timing files contain one 'NAME CYCLES_PER_PACKET' line per flow.\n"
+	        "Lines starting with '#' are ignored. The cycles are only comparable\n"
+	        "on the same machine: generate the baseline with --timing-output\n"
+	        "on the machine that runs the test with --timing-baseline.\n",
+	        TIMING_TOLERANCE_DEFAULT, TIMING_RUNS_DEFAULT);
 }
 
 
@@ -923,7 +1128,17 @@ static int compress_decompress(struct rohc_comp *comp,
 
 	/* compress the IP packet into a ROHC packet */
 	trace("=== ROHC compression: start\n");
-	ret = rohc_compress4(comp, ip_packet, &rohc_packet);
+	if(timing_enabled)
+	{
+		const uint64_t start = timing_now();
+		ret = rohc_compress4(comp, ip_packet, &rohc_packet);
+		timing_cycles += timing_now() - start;
+		timing_packets++;
+	}
+	else
+	{
+		ret = rohc_compress4(comp, ip_packet, &rohc_packet);
+	}
 	if(ret != ROHC_STATUS_OK)
 	{
 		trace("=== ROHC compression: failure\n");
@@ -1008,8 +1223,18 @@ static int compress_decompress(struct rohc_comp *comp,
 
 	/* decompress the ROHC packet */
 	trace("=== ROHC decompression: start\n");
-	ret = rohc_decompress3(decomp, rohc_packet, &decomp_packet,
-	                       &rcvd_feedback, feedback_send_by_other);
+	if(timing_enabled)
+	{
+		const uint64_t start = timing_now();
+		ret = rohc_decompress3(decomp, rohc_packet, &decomp_packet,
+		                       &rcvd_feedback, feedback_send_by_other);
+		timing_cycles += timing_now() - start;
+	}
+	else
+	{
+		ret = rohc_decompress3(decomp, rohc_packet, &decomp_packet,
+		                       &rcvd_feedback, feedback_send_by_other);
+	}
 	if(ret != ROHC_STATUS_OK)
 	{
 		size_t i;
@@ -1101,20 +1326,22 @@ static int test_comp_and_decomp(const rohc_cid_type_t cid_type,
                                 char *cmp_filename,
                                 const char *rohc_size_ofilename)
 {
-	char errbuf[PCAP_ERRBUF_SIZE];
 	size_t src_filenames_id = 0;
-	pcap_t *handle;
-	pcap_t *cmp_handle;
+	struct pcap_mmap capture;
+	struct pcap_mmap cmp_capture;
+	pcap_t *dumper_handle;
 	pcap_dumper_t *dumper;
 	size_t link_len_src = 0;
 	size_t link_len_cmp = 0;
 	struct pcap_pkthdr header;
-	struct pcap_pkthdr cmp_header;
+	size_t cmp_len;
 
 	FILE *rohc_size_output_file;
 
 	const uint8_t *packet;
 	unsigned char *cmp_packet;
+	struct rohc_buf cmp_frame;
+	size_t cmp_wire_len;
 
 	int counter;
 
@@ -1139,35 +1366,44 @@ static int test_comp_and_decomp(const rohc_cid_type_t cid_type,
 
 	trace("=== initialization:\n");
 
-	/* open the source dump file */
-	handle = open_pcap_file(src_filenames[0], &link_len_src);
-	if(handle == NULL)
+	/* map the source dump file in memory */
+	if(!open_pcap_file(src_filenames[0], &capture, &link_len_src))
 	{
 		status = 77; /* skip test */
 		goto error;
 	}
 
-	/* open the network dump file for ROHC storage if asked */
+	/* open the network dump file for ROHC storage if asked, with the same
+	 * link layer as the source dump file */
 	if(ofilename != NULL)
 	{
-		dumper = pcap_dump_open(handle, ofilename);
+		dumper_handle = pcap_open_dead(linktype_to_dlt(capture.linktype),
+		                               capture.snaplen);
+		if(dumper_handle == NULL)
+		{
+			trace("failed to create the handle for the dump file\n");
+			status = 77; /* skip test */
+			goto close_input;
+		}
+		dumper = pcap_dump_open(dumper_handle, ofilename);
 		if(dumper == NULL)
 		{
-			trace("failed to open dump file: %s\n", errbuf);
+			trace("failed to open dump file: %s\n", pcap_geterr(dumper_handle));
+			pcap_close(dumper_handle);
 			status = 77; /* skip test */
 			goto close_input;
 		}
 	}
 	else
 	{
+		dumper_handle = NULL;
 		dumper = NULL;
 	}
 
-	/* open the ROHC comparison dump file if asked */
+	/* map the ROHC comparison dump file in memory if asked */
 	if(cmp_filename != NULL)
 	{
-		cmp_handle = open_pcap_file(cmp_filename, &link_len_cmp);
-		if(cmp_handle == NULL)
+		if(!open_pcap_file(cmp_filename, &cmp_capture, &link_len_cmp))
 		{
 			status = 77; /* skip test */
 			goto close_output;
@@ -1175,7 +1411,7 @@ static int test_comp_and_decomp(const rohc_cid_type_t cid_type,
 	}
 	else
 	{
-		cmp_handle = NULL;
+		cmp_capture.data = NULL;
 	}
 
 	/* open the file in which to write the sizes of the ROHC packets if asked */
@@ -1231,20 +1467,22 @@ static int test_comp_and_decomp(const rohc_cid_type_t cid_type,
 
 	/* for each packet in the dump */
 	counter = 0;
-	while(get_next_packet(&handle, src_filenames, src_filenames_nr,
+	while(get_next_packet(&capture, src_filenames, src_filenames_nr,
 	                      &src_filenames_id, &header, &link_len_src, &packet))
 	{
 		counter++;
 
 		/* get next ROHC packet from the comparison dump file if asked */
-		if(cmp_handle != NULL)
+		if(cmp_capture.data != NULL &&
+		   pcap_mmap_next(&cmp_capture, &cmp_frame, &cmp_wire_len))
 		{
-			cmp_packet = (unsigned char *) pcap_next(cmp_handle, &cmp_header);
+			cmp_packet = rohc_buf_data(cmp_frame);
+			cmp_len = cmp_frame.len;
 		}
 		else
 		{
 			cmp_packet = NULL;
-			cmp_header.caplen = 0;
+			cmp_len = 0;
 		}
 
 		/* compress & decompress from compressor 1 to decompressor 1 */
@@ -1252,7 +1490,7 @@ static int test_comp_and_decomp(const rohc_cid_type_t cid_type,
 		                          header, packet, link_len_src,
 		                          no_comparison, ignore_malformed,
 		                          dumper,
-		                          cmp_packet, cmp_header.caplen, link_len_cmp,
+		                          cmp_packet, cmp_len, link_len_cmp,
 		                          rohc_size_output_file,
 		                          feedback2_data, &feedback1_data);
 		if(ret == -1)
@@ -1281,14 +1519,16 @@ static int test_comp_and_decomp(const rohc_cid_type_t cid_type,
 		rohc_buf_reset(&feedback2_data);
 
 		/* get next ROHC packet from the comparison dump file if asked */
-		if(cmp_handle != NULL)
+		if(cmp_capture.data != NULL &&
+		   pcap_mmap_next(&cmp_capture, &cmp_frame, &cmp_wire_len))
 		{
-			cmp_packet = (unsigned char *) pcap_next(cmp_handle, &cmp_header);
+			cmp_packet = rohc_buf_data(cmp_frame);
+			cmp_len = cmp_frame.len;
 		}
 		else
 		{
 			cmp_packet = NULL;
-			cmp_header.caplen = 0;
+			cmp_len = 0;
 		}
 
 		/* compress & decompress from compressor 2 to decompressor 2 */
@@ -1296,7 +1536,7 @@ static int test_comp_and_decomp(const rohc_cid_type_t cid_type,
 		                          header, packet, link_len_src,
 		                          no_comparison, ignore_malformed,
 		                          dumper,
-		                          cmp_packet, cmp_header.caplen, link_len_cmp,
+		                          cmp_packet, cmp_len, link_len_cmp,
 		                          rohc_size_output_file,
 		                          feedback1_data, &feedback2_data);
 		if(ret == -1)
@@ -1361,19 +1601,20 @@ close_output_size:
 		fclose(rohc_size_output_file);
 	}
 close_comparison:
-	if(cmp_handle != NULL)
+	if(cmp_capture.data != NULL)
 	{
-		pcap_close(cmp_handle);
+		pcap_mmap_close(&cmp_capture);
 	}
 close_output:
 	if(dumper != NULL)
 	{
 		pcap_dump_close(dumper);
+		pcap_close(dumper_handle);
 	}
 close_input:
-	if(handle != NULL)
+	if(capture.data != NULL)
 	{
-		pcap_close(handle);
+		pcap_mmap_close(&capture);
 	}
 error:
 	return status;
@@ -1608,70 +1849,92 @@ static bool rohc_comp_rtp_cb(const unsigned char *const ip __attribute__((unused
 
 
 /**
- * @brief Open a PCAP dump file
+ * @brief Map a PCAP dump file in memory
  *
- * @param filename  The file name of the PCAP dump file to open
- * @return          The handle on the opened PCAP dump file in case of success,
- *                  NULL in case of error
+ * @param filename      The file name of the PCAP dump file to open
+ * @param[out] capture  The PCAP dump file mapped in memory
+ * @param[out] link_len The length of the link layer header
+ * @return              true in case of success, false in case of error
  */
-static pcap_t * open_pcap_file(const char *const filename, size_t *const link_len)
+static bool open_pcap_file(const char *const filename,
+                           struct pcap_mmap *const capture,
+                           size_t *const link_len)
 {
-	char errbuf[PCAP_ERRBUF_SIZE];
-	int link_layer_type;
-	pcap_t *handle;
+	char errbuf[PCAP_MMAP_ERRBUF_SIZE];
 
-	/* open the source dump file */
-	handle = pcap_open_offline(filename, errbuf);
-	if(handle == NULL)
+	/* map the source dump file */
+	if(!pcap_mmap_open(capture, filename, errbuf))
 	{
 		trace("failed to open the source pcap file: %s\n", errbuf);
 		goto error;
 	}
 
 	/* link layer in the source dump must be Ethernet */
-	link_layer_type = pcap_datalink(handle);
-	if(link_layer_type != DLT_EN10MB &&
-	   link_layer_type != DLT_LINUX_SLL &&
-	   link_layer_type != DLT_RAW &&
-	   link_layer_type != DLT_NULL)
-	{
-		trace("link layer type %d not supported in source dump (supported = "
-		      "%d, %d, %d, %d)\n", link_layer_type, DLT_EN10MB,
-		      DLT_LINUX_SLL, DLT_RAW, DLT_NULL);
-		goto close_input;
-	}
-
-	if(link_layer_type == DLT_EN10MB)
+	if(capture->linktype == PCAP_MMAP_LINKTYPE_ETHERNET)
 	{
 		*link_len = ETHER_HDR_LEN;
 	}
-	else if(link_layer_type == DLT_LINUX_SLL)
+	else if(capture->linktype == PCAP_MMAP_LINKTYPE_LINUX_SLL)
 	{
 		*link_len = LINUX_COOKED_HDR_LEN;
 	}
-	else if(link_layer_type == DLT_NULL)
+	else if(capture->linktype == PCAP_MMAP_LINKTYPE_NULL)
 	{
 		*link_len = BSD_LOOPBACK_HDR_LEN;
 	}
-	else /* DLT_RAW */
+	else if(capture->linktype == PCAP_MMAP_LINKTYPE_RAW)
 	{
 		*link_len = 0;
 	}
+	else
+	{
+		trace("link layer type %u not supported in source dump (supported = "
+		      "%u, %u, %u, %u)\n", capture->linktype,
+		      PCAP_MMAP_LINKTYPE_ETHERNET, PCAP_MMAP_LINKTYPE_LINUX_SLL,
+		      PCAP_MMAP_LINKTYPE_RAW, PCAP_MMAP_LINKTYPE_NULL);
+		goto close_input;
+	}
 
-	return handle;
+	return true;
 
 close_input:
-	pcap_close(handle);
+	pcap_mmap_close(capture);
 error:
-	return NULL;
+	return false;
+}
+
+
+/**
+ * @brief Get the libpcap link layer type for the link layer of a PCAP file
+ *
+ * @param linktype  The link layer stored in the PCAP file
+ * @return          The link layer type for libpcap
+ */
+static int linktype_to_dlt(const uint32_t linktype)
+{
+	if(linktype == PCAP_MMAP_LINKTYPE_ETHERNET)
+	{
+		return DLT_EN10MB;
+	}
+	else if(linktype == PCAP_MMAP_LINKTYPE_LINUX_SLL)
+	{
+		return DLT_LINUX_SLL;
+	}
+	else if(linktype == PCAP_MMAP_LINKTYPE_NULL)
+	{
+		return DLT_NULL;
+	}
+	return DLT_RAW;
 }
 
 
 /**
  * @brief Get the next packet from source captures
  *
+ * The packet points into the mapping of the current source capture, it is
+ * valid until the next call.
  */
-static bool get_next_packet(pcap_t **const pcap_handle,
+static bool get_next_packet(struct pcap_mmap *const capture,
                             const char *const src_filenames[],
                             const size_t src_filenames_nr,
                             size_t *const src_filenames_id,
@@ -1679,17 +1942,16 @@ static bool get_next_packet(pcap_t **const pcap_handle,
                             size_t *const link_len,
                             const uint8_t **const packet)
 {
-	assert((*pcap_handle) != NULL);
+	struct rohc_buf frame;
+	size_t wire_len;
 
-	/* get the next packet in the current PCAP dump */
-	*packet = (const uint8_t *) pcap_next(*pcap_handle, header);
+	assert(capture->data != NULL);
 
-	/* if there is no more packet in the current PCAP dump file, try next one */
-	if((*packet) == NULL)
+	/* get the next packet in the current PCAP dump */
+	if(!pcap_mmap_next(capture, &frame, &wire_len))
 	{
-		/* close current PCAP dump file */
-		pcap_close(*pcap_handle);
-		*pcap_handle = NULL;
+		/* no more packet in the current PCAP dump file, try next one */
+		pcap_mmap_close(capture);
 
 		/* is there another PCAP dump file? */
 		(*src_filenames_id)++;
@@ -1698,21 +1960,25 @@ static bool get_next_packet(pcap_t **const pcap_handle,
 			goto no_more_packet;
 		}
 
-		/* open next PCAP dump file */
-		*pcap_handle = open_pcap_file(src_filenames[*src_filenames_id], link_len);
-		if((*pcap_handle) == NULL)
+		/* map next PCAP dump file */
+		if(!open_pcap_file(src_filenames[*src_filenames_id], capture, link_len))
 		{
 			goto error;
 		}
 
 		/* get the next packet in the current PCAP dump */
-		*packet = (const uint8_t *) pcap_next(*pcap_handle, header);
-		if((*packet) == NULL)
+		if(!pcap_mmap_next(capture, &frame, &wire_len))
 		{
 			goto no_more_packet;
 		}
 	}
 
+	header->ts.tv_sec = frame.time.sec;
+	header->ts.tv_usec = frame.time.nsec / 1000;
+	header->caplen = frame.len;
+	header->len = wire_len;
+	*packet = rohc_buf_data(frame);
+
 	return true;
 
 no_more_packet:
@@ -1818,3 +2084,150 @@ skip:
 	return valid;
 }
 
+
+
+/**
+ * @brief Get the current value of the CPU cycle counter
+ *
+ * @return  The current value of the time-stamp counter on x86,
+ *          the current time of the monotonic clock (in nanoseconds)
+ *          on the other architectures
+ */
+static uint64_t timing_now(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#else
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return ((uint64_t) now.tv_sec) * 1000000000U + now.tv_nsec;
+#endif
+}
+
+
+/**
+ * @brief Append the cycles spent per packet for one flow to a timing file
+ *
+ * @param filename           The name of the timing file
+ * @param name               The name of the flow
+ * @param cycles_per_packet  The cycles spent per packet
+ * @return                   true if the cycles were successfully written,
+ *                           false otherwise
+ */
+static bool timing_write(const char *const filename,
+                         const char *const name,
+                         const double cycles_per_packet)
+{
+	FILE *file;
+
+	/* append so that all the flows of the test suite share the same file */
+	file = fopen(filename, "a");
+	if(file == NULL)
+	{
+		fprintf(stderr, "failed to open timing file '%s': %s (%d)\n",
+		        filename, strerror(errno), errno);
+		goto error;
+	}
+	fprintf(file, "%s %.1f\n", name, cycles_per_packet);
+	if(fclose(file) != 0)
+	{
+		fprintf(stderr, "failed to write timing file '%s': %s (%d)\n",
+		        filename, strerror(errno), errno);
+		goto error;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Compare the cycles spent per packet for one flow with a baseline
+ *
+ * A flow that is not listed in the baseline is not considered as a
+ * regression. If the flow is listed several times, the last line wins.
+ *
+ * @param filename           The name of the timing baseline file
+ * @param name               The name of the flow
+ * @param cycles_per_packet  The cycles spent per packet
+ * @param tolerance          The regression tolerated (in percent)
+ * @return                   true if the flow did not regress,
+ *                           false if it regressed or in case of error
+ */
+static bool timing_compare(const char *const filename,
+                           const char *const name,
+                           const double cycles_per_packet,
+                           const unsigned int tolerance)
+{
+	char line[1024];
+	double baseline = -1;
+	double max_cycles;
+	FILE *file;
+
+	file = fopen(filename, "r");
+	if(file == NULL)
+	{
+		fprintf(stderr, "failed to open timing baseline '%s': %s (%d)\n",
+		        filename, strerror(errno), errno);
+		goto error;
+	}
+	while(fgets(line, sizeof(line), file) != NULL)
+	{
+		char *line_name;
+		char *line_cycles;
+		char *end;
+		double value;
+
+		line_name = strtok(line, " \t\r\n");
+		if(line_name == NULL || line_name[0] == '#' || strcmp(line_name, name))
+		{
+			continue;
+		}
+		line_cycles = strtok(NULL, " \t\r\n");
+		if(line_cycles == NULL)
+		{
+			fprintf(stderr, "malformed timing baseline '%s': no cycles for "
+			        "'%s'\n", filename, name);
+			goto close_file;
+		}
+		value = strtod(line_cycles, &end);
+		if(end == line_cycles || (*end) != '\0' || value < 0)
+		{
+			fprintf(stderr, "malformed timing baseline '%s': invalid cycles "
+			        "'%s' for '%s'\n", filename, line_cycles, name);
+			goto close_file;
+		}
+		baseline = value;
+	}
+	fclose(file);
+
+	if(baseline < 0)
+	{
+		trace("=== timing: no baseline for '%s', nothing to compare\n", name);
+		goto skip;
+	}
+
+	max_cycles = baseline * (100 + tolerance) / 100;
+	trace("=== timing: baseline is %.1f cycles per packet, up to %.1f tolerated "
+	      "(+%u%%)\n", baseline, max_cycles, tolerance);
+	if(cycles_per_packet > max_cycles)
+	{
+		fprintf(stderr, "timing regression for '%s': %.1f cycles per packet "
+		        "instead of %.1f (+%.1f%%, tolerance is %u%%)\n", name,
+		        cycles_per_packet, baseline,
+		        (cycles_per_packet - baseline) * 100 / baseline, tolerance);
+		goto error;
+	}
+
+skip:
+	return true;
+
+close_file:
+	fclose(file);
+error:
+	return false;
+}
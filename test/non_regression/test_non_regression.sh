@@ -41,6 +41,12 @@
 # Environment variables:
 #    USE_VALGRIND=yes|no   run the tests within Valgrind or not
 #    USE_PYTHON=<version>  run the tests of the Python binding or not
+#    TIMING_OUTPUT=<file>  append the CPU cycles per packet of every test
+#                          to the given file (generate a timing baseline)
+#    TIMING_BASELINE=<file>  fail the tests whose CPU cycles per packet
+#                            regressed compared to the given baseline
+#    TIMING_TOLERANCE=<N>  the regression tolerated with the baseline
+#                          (in percent)
 #
 
 # skip test in case of cross-compilation
@@ -132,6 +138,23 @@ else
 	CMD_PYTHON="${CMD_PYTHON} ${CMD_PARAMS} -c ${CAPTURE_COMPARE}"
 fi
 
+# measure the CPU cycles per packet if asked (not within Valgrind)
+CMD_TIMING=""
+if [ -z "${KERNEL_SUFFIX}" ] && [ "${VERBOSE}" != "generate" ] ; then
+	if [ -n "${TIMING_OUTPUT}" ] ; then
+		CMD_TIMING="${CMD_TIMING} --timing-output ${TIMING_OUTPUT}"
+	fi
+	if [ -n "${TIMING_BASELINE}" ] ; then
+		CMD_TIMING="${CMD_TIMING} --timing-baseline ${TIMING_BASELINE}"
+	fi
+	if [ -n "${TIMING_TOLERANCE}" ] ; then
+		CMD_TIMING="${CMD_TIMING} --timing-tolerance ${TIMING_TOLERANCE}"
+	fi
+	if [ -n "${CMD_TIMING}" ] ; then
+		CMD_TIMING="${CMD_TIMING} --timing-name ${PARAMS}"
+	fi
+fi
+
 # source valgrind-related functions
 . ${BASEDIR}/../../valgrind.sh
 
@@ -140,7 +163,7 @@ if [ -z "${USE_PYTHON}" ] ; then
 	# run C tests
 
 	# run without valgrind
-	run_test_without_valgrind ${CMD} || exit $?
+	run_test_without_valgrind ${CMD} ${CMD_TIMING} || exit $?
 
 	[ "${VERBOSE}" = "generate" ] && exit 77
 
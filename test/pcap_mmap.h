@@ -0,0 +1,254 @@
+/*
+ * Copyright 2026 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   pcap_mmap.h
+ * @brief  Replay a PCAP capture mapped in memory
+ * @author Didier Barvaux <didier@barvaux.org>
+ *
+ * The whole PCAP file is mapped in memory and walked in place: the packets
+ * are given as network buffers that point into the mapping, so replaying
+ * even huge captures costs page faults only, neither allocations nor copies.
+ *
+ * The mapping is private: the packets may be modified in place, the file is
+ * left unchanged. Only the classic PCAP format is supported (microsecond or
+ * nanosecond timestamps, any byte order), not the PCAPNG format.
+ */
+
+#ifndef ROHC_TEST_PCAP_MMAP__H
+#define ROHC_TEST_PCAP_MMAP__H
+
+#include <rohc/rohc_buf.h>
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+
+/** The size of the buffer for the error messages */
+#define PCAP_MMAP_ERRBUF_SIZE  256U
+
+/** The link layers of the captures, as stored in the PCAP files */
+#define PCAP_MMAP_LINKTYPE_NULL       0U
+#define PCAP_MMAP_LINKTYPE_ETHERNET   1U
+#define PCAP_MMAP_LINKTYPE_RAW      101U
+#define PCAP_MMAP_LINKTYPE_LINUX_SLL 113U
+
+/** The length of the global header of a PCAP file */
+#define PCAP_MMAP_FILE_HDR_LEN  24U
+/** The length of the header of every packet record of a PCAP file */
+#define PCAP_MMAP_REC_HDR_LEN   16U
+
+
+/** A PCAP capture mapped in memory */
+struct pcap_mmap
+{
+	uint8_t *data;      /**< The mapping of the whole file */
+	size_t len;         /**< The length of the file */
+	size_t offset;      /**< The offset of the next packet record */
+	bool swapped;       /**< Whether the file is in the other byte order */
+	bool nsec;          /**< Whether the timestamps are in nanoseconds */
+	uint32_t linktype;  /**< The link layer of the capture */
+	uint32_t snaplen;   /**< The maximum length of the captured packets */
+};
+
+
+/**
+ * @brief Read one 32-bit field of a PCAP file
+ *
+ * @param pcap  The PCAP capture
+ * @param data  The field, maybe unaligned
+ * @return      The value of the field in host byte order
+ */
+static inline uint32_t pcap_mmap_read32(const struct pcap_mmap *const pcap,
+                                        const uint8_t *const data)
+{
+	uint32_t value;
+
+	memcpy(&value, data, sizeof(uint32_t));
+	return (pcap->swapped ? __builtin_bswap32(value) : value);
+}
+
+
+/**
+ * @brief Map a PCAP file in memory
+ *
+ * @param[out] pcap    The PCAP capture, to release with \ref pcap_mmap_close
+ * @param filename     The name of the PCAP file
+ * @param[out] errbuf  The error message in case of failure, at least
+ *                     \ref PCAP_MMAP_ERRBUF_SIZE bytes
+ * @return             true if the file is mapped, false otherwise
+ */
+static inline bool pcap_mmap_open(struct pcap_mmap *const pcap,
+                                  const char *const filename,
+                                  char *const errbuf)
+{
+	struct stat st;
+	uint32_t magic;
+	int fd;
+
+	memset(pcap, 0, sizeof(struct pcap_mmap));
+
+	fd = open(filename, O_RDONLY);
+	if(fd < 0)
+	{
+		snprintf(errbuf, PCAP_MMAP_ERRBUF_SIZE, "%s: %s (%d)", filename,
+		         strerror(errno), errno);
+		goto error;
+	}
+	if(fstat(fd, &st) != 0)
+	{
+		snprintf(errbuf, PCAP_MMAP_ERRBUF_SIZE, "%s: failed to get the size "
+		         "of the file: %s (%d)", filename, strerror(errno), errno);
+		goto close_file;
+	}
+	if(st.st_size < (off_t) PCAP_MMAP_FILE_HDR_LEN)
+	{
+		snprintf(errbuf, PCAP_MMAP_ERRBUF_SIZE, "%s: file too short for a "
+		         "PCAP capture", filename);
+		goto close_file;
+	}
+	pcap->len = st.st_size;
+
+	/* private mapping: the packets may be modified without changing the file */
+	pcap->data = mmap(NULL, pcap->len, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+	                  fd, 0);
+	if(pcap->data == MAP_FAILED)
+	{
+		snprintf(errbuf, PCAP_MMAP_ERRBUF_SIZE, "%s: failed to map the file: "
+		         "%s (%d)", filename, strerror(errno), errno);
+		goto close_file;
+	}
+	close(fd);
+	madvise(pcap->data, pcap->len, MADV_SEQUENTIAL);
+
+	/* the magic number tells the byte order and the timestamp precision */
+	memcpy(&magic, pcap->data, sizeof(uint32_t));
+	if(magic == 0xa1b2c3d4 || magic == 0xa1b23c4d)
+	{
+		pcap->swapped = false;
+	}
+	else if(magic == 0xd4c3b2a1 || magic == 0x4d3cb2a1)
+	{
+		pcap->swapped = true;
+		magic = __builtin_bswap32(magic);
+	}
+	else
+	{
+		snprintf(errbuf, PCAP_MMAP_ERRBUF_SIZE, "%s: unknown magic number "
+		         "0x%08x, not a PCAP capture", filename, magic);
+		goto unmap;
+	}
+	pcap->nsec = (magic == 0xa1b23c4d);
+	pcap->snaplen = pcap_mmap_read32(pcap, pcap->data + 16);
+	pcap->linktype = pcap_mmap_read32(pcap, pcap->data + 20) & 0x03ffffff;
+
+	/* raw IP is stored with value 12 by some old versions of libpcap */
+	if(pcap->linktype == 12)
+	{
+		pcap->linktype = PCAP_MMAP_LINKTYPE_RAW;
+	}
+
+	pcap->offset = PCAP_MMAP_FILE_HDR_LEN;
+
+	return true;
+
+unmap:
+	munmap(pcap->data, pcap->len);
+	pcap->data = NULL;
+	return false;
+close_file:
+	close(fd);
+error:
+	pcap->data = NULL;
+	return false;
+}
+
+
+/**
+ * @brief Unmap a PCAP capture
+ *
+ * The packets given by \ref pcap_mmap_next are no longer valid.
+ *
+ * @param pcap  The PCAP capture
+ */
+static inline void pcap_mmap_close(struct pcap_mmap *const pcap)
+{
+	munmap(pcap->data, pcap->len);
+	pcap->data = NULL;
+	pcap->len = 0;
+}
+
+
+/**
+ * @brief Get the next packet of a PCAP capture
+ *
+ * The packet points into the mapping: it is valid until the capture is
+ * unmapped. Its arrival time is the timestamp of the capture.
+ *
+ * @param pcap          The PCAP capture
+ * @param[out] packet   The captured packet
+ * @param[out] wire_len The length of the packet on the wire, greater than the
+ *                      length of the captured packet if it was truncated
+ * @return              true if one packet is given,
+ *                      false at the end of the capture or if the last packet
+ *                      record is truncated
+ */
+static inline bool pcap_mmap_next(struct pcap_mmap *const pcap,
+                                  struct rohc_buf *const packet,
+                                  size_t *const wire_len)
+{
+	const uint8_t *rec_hdr;
+	struct rohc_ts arrival_time;
+	uint32_t caplen;
+
+	if((pcap->len - pcap->offset) < PCAP_MMAP_REC_HDR_LEN)
+	{
+		return false;
+	}
+	rec_hdr = pcap->data + pcap->offset;
+	caplen = pcap_mmap_read32(pcap, rec_hdr + 8);
+	if((pcap->len - pcap->offset - PCAP_MMAP_REC_HDR_LEN) < caplen)
+	{
+		return false;
+	}
+
+	arrival_time.sec = pcap_mmap_read32(pcap, rec_hdr);
+	arrival_time.nsec = pcap_mmap_read32(pcap, rec_hdr + 4);
+	if(!pcap->nsec)
+	{
+		arrival_time.nsec *= 1000;
+	}
+	*packet = (struct rohc_buf)
+		rohc_buf_init_full(pcap->data + pcap->offset + PCAP_MMAP_REC_HDR_LEN,
+		                   caplen, arrival_time);
+	*wire_len = pcap_mmap_read32(pcap, rec_hdr + 12);
+
+	pcap->offset += PCAP_MMAP_REC_HDR_LEN + caplen;
+
+	return true;
+}
+
+#endif
+
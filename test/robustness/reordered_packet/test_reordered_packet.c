@@ -71,7 +71,8 @@ for ./configure ? If yes, check configure output and config.log"
 /* prototypes of private functions */
 static void usage(void);
 static int test_comp_and_decomp(const char *const filename,
-                                const unsigned int packet_to_reorder);
+                                const unsigned int packet_to_reorder,
+                                const size_t reorder_window);
 static void print_rohc_traces(void *const priv_ctxt,
                               const rohc_trace_level_t level,
                               const rohc_trace_entity_t entity,
@@ -104,6 +105,7 @@ int main(int argc, char *argv[])
 	char *filename = NULL;
 	char *packet_to_reorder_param = NULL;
 	int packet_to_reorder;
+	int reorder_window = 0;
 	int status = 1;
 
 	/* parse program arguments, print the help message in case of failure */
@@ -121,6 +123,25 @@ int main(int argc, char *argv[])
 			usage();
 			goto error;
 		}
+		else if(!strcmp(*argv, "--reorder-window"))
+		{
+			/* get the reorder window of the decompressor */
+			if(argc <= 1)
+			{
+				fprintf(stderr, "option --reorder-window takes one argument\n\n");
+				usage();
+				goto error;
+			}
+			reorder_window = atoi(argv[1]);
+			if(reorder_window <= 0)
+			{
+				fprintf(stderr, "bad reorder window '%s'\n\n", argv[1]);
+				usage();
+				goto error;
+			}
+			argc--;
+			argv++;
+		}
 		else if(filename == NULL)
 		{
 			/* get the name of the file that contains the packets to
@@ -162,7 +183,7 @@ int main(int argc, char *argv[])
 	srand(5);
 
 	/* test ROHC compression/decompression with the packets from the file */
-	status = test_comp_and_decomp(filename, packet_to_reorder);
+	status = test_comp_and_decomp(filename, packet_to_reorder, reorder_window);
 
 error:
 	return status;
@@ -185,7 +206,10 @@ static void usage(void)
 	        "  PACKET_NUM   The firpacket # to reorder\n"
 	        "\n"
 	        "options:\n"
-	        "  -h, --help   Print this usage and exit\n");
+	        "  --reorder-window NUM  Decode the packets that come late by at\n"
+	        "                        most NUM SN values up front, so that no\n"
+	        "                        packet shall fail\n"
+	        "  -h, --help            Print this usage and exit\n");
 }
 
 
@@ -196,11 +220,14 @@ static void usage(void)
  * @param filename           The name of the PCAP file that contains the
  *                           IP packets
  * @param packet_to_reorder  The first packet # to reorder
+ * @param reorder_window     The reorder window of the decompressor,
+ *                           0 to rely on CRC repair
  * @return                   0 in case of success,
  *                           1 in case of failure
  */
 static int test_comp_and_decomp(const char *const filename,
-                                const unsigned int packet_to_reorder)
+                                const unsigned int packet_to_reorder,
+                                const size_t reorder_window)
 {
 	struct rohc_ts arrival_time = { .sec = 4242, .nsec = 4242 };
 
@@ -327,6 +354,13 @@ static int test_comp_and_decomp(const char *const filename,
 		goto destroy_decomp;
 	}
 
+	/* decode the late packets up front if asked to */
+	if(!rohc_decomp_set_reorder_window(decomp, reorder_window))
+	{
+		fprintf(stderr, "failed to set the reorder window\n");
+		goto destroy_decomp;
+	}
+
 	/* for each packet in the dump */
 	counter = 0;
 	while((packet = (unsigned char *) pcap_next(handle, &header)) != NULL)
@@ -425,7 +459,8 @@ static int test_comp_and_decomp(const char *const filename,
 		/* decompress the generated ROHC packet with the ROHC decompressor */
 		status = rohc_decompress3(decomp, rohc_packet, &decomp_packet,
 		                          NULL, NULL);
-		if(counter > packet_to_reorder + 1 && counter < packet_to_reorder + 1 + 2)
+		if(reorder_window == 0 &&
+		   counter > packet_to_reorder + 1 && counter < packet_to_reorder + 1 + 2)
 		{
 			/* reordered packet and the next one shall fail */
 			if(status == ROHC_STATUS_OK)
@@ -464,8 +499,19 @@ static int test_comp_and_decomp(const char *const filename,
 			rohc_buf_reset(&decomp_packet);
 			status = rohc_decompress3(decomp, late_rohc_packet, &decomp_packet,
 			                          NULL, NULL);
+			/* reordered packet shall succeed within the reorder window */
+			if(reorder_window > 0)
+			{
+				if(status != ROHC_STATUS_OK)
+				{
+					fprintf(stderr, "\tunexpected failure to decompress reordered "
+					        "ROHC packet within the reorder window\n");
+					goto destroy_decomp;
+				}
+				fprintf(stderr, "\texpected successful decompression\n");
+			}
 			/* reordered packet and the next one shall fail */
-			if(status == ROHC_STATUS_OK)
+			else if(status == ROHC_STATUS_OK)
 			{
 				/* success is NOT expected */
 				fprintf(stderr, "\tunexpected success to decompress reordered "
@@ -481,8 +527,15 @@ static int test_comp_and_decomp(const char *const filename,
 	}
 
 	/* everything went fine */
-	fprintf(stderr, "all packets were successfully decompressed except the "
-	        "reordered one and the next one\n");
+	if(reorder_window > 0)
+	{
+		fprintf(stderr, "all packets were successfully decompressed\n");
+	}
+	else
+	{
+		fprintf(stderr, "all packets were successfully decompressed except the "
+		        "reordered one and the next one\n");
+	}
 	is_failure = 0;
 
 destroy_decomp:
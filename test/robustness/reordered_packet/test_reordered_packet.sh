@@ -25,7 +25,8 @@
 #              Didier Barvaux <didier@barvaux.org>
 #
 # This script may be used by creating a link "test_reordered_packet_NUM_CAPTURE.sh"
-# where:
+# or "test_reordered_packet_window_NUM_CAPTURE.sh" where:
+#    window   asks the decompressor to decode the late packets up front
 #    NUM      is the packet # to reorder
 #    CAPTURE  is the source capture to use for the test
 #
@@ -60,6 +61,16 @@ else
 	APP="${BASEDIR}/test_reordered_packet${CROSS_COMPILATION_EXEEXT}"
 fi
 
+# decode the late packets up front if the name of the script asks for it
+REORDER_WINDOW_OPT=""
+case "${SCRIPT}" in
+	*/test_reordered_packet_window_*)
+		REORDER_WINDOW_OPT="--reorder-window 2"
+		SCRIPT=$( echo "${SCRIPT}" | \
+		          ${SED} -e 's#/test_reordered_packet_window_#/test_reordered_packet_#' )
+		;;
+esac
+
 # extract the packet to reorder and source capture from the name of the script
 PACKET_TO_REORDER=$( echo "${SCRIPT}" | \
                      ${SED} -e 's#^.*/test_reordered_packet_\([0-9-]*\)_.*#\1#' -e 's#\.sh$##' )
@@ -79,7 +90,7 @@ if [ -z "${PACKET_TO_REORDER}" ] ; then
 	exit 1
 fi
 
-CMD="${CROSS_COMPILATION_EMULATOR} ${APP} ${CAPTURE_SOURCE} ${PACKET_TO_REORDER}"
+CMD="${CROSS_COMPILATION_EMULATOR} ${APP} ${REORDER_WINDOW_OPT} ${CAPTURE_SOURCE} ${PACKET_TO_REORDER}"
 
 # source valgrind-related functions
 . ${BASEDIR}/../../valgrind.sh
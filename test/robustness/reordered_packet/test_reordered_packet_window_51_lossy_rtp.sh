@@ -0,0 +1 @@
+test_reordered_packet.sh
\ No newline at end of file